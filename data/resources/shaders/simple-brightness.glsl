@@ -1,6 +1,8 @@
 /*
 [configuration]
 
+[Fusable]
+
 [OptionRangeFloat]
 GUIName = Brightness Scale
 OptionName = BRIGHTNESS_SCALE
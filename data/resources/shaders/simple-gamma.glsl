@@ -1,6 +1,8 @@
 /*
 [configuration]
 
+[Fusable]
+
 [OptionRangeFloat]
 GUIName = Gamma In
 OptionName = GAMMA_IN
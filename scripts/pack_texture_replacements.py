@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+# SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+# SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+# Packs a directory of texture replacements into a single replacements.pack file, which is used instead of the loose
+# files when it is present in the replacement directory. Images are stored as-is, so DDS files keep their compressed
+# formats. config.yaml is not packed, and should stay next to the pack.
+
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = 0x50527344
+VERSION = 1
+HEADER_FORMAT = "<IIII"
+ENTRY_FORMAT = "<QQII"
+PACK_FILENAME = "replacements.pack"
+EXTENSIONS = (".png", ".jpg", ".webp", ".dds")
+DATA_ALIGNMENT = 16
+
+
+def find_replacements(source_dir):
+    names = []
+    for root, dirs, files in os.walk(source_dir):
+        for filename in files:
+            # everything is packed, since aliases can refer to any filename
+            if not filename.lower().endswith(EXTENSIONS):
+                continue
+
+            path = os.path.join(root, filename)
+            names.append(os.path.relpath(path, source_dir).replace(os.sep, "/"))
+
+    # the emulator binary searches on the raw bytes
+    names.sort(key=lambda name: name.encode("utf-8"))
+    return names
+
+
+def write_pack(source_dir, output_path, names):
+    encoded_names = [name.encode("utf-8") for name in names]
+    names_size = sum(len(name) for name in encoded_names)
+    index_size = struct.calcsize(HEADER_FORMAT) + len(names) * struct.calcsize(ENTRY_FORMAT) + names_size
+
+    entries = []
+    data_offset = (index_size + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1)
+    name_offset = 0
+    for name, encoded_name in zip(names, encoded_names):
+        size = os.path.getsize(os.path.join(source_dir, name))
+        entries.append((data_offset, size, name_offset, len(encoded_name)))
+        data_offset = (data_offset + size + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1)
+        name_offset += len(encoded_name)
+
+    with open(output_path, "wb") as f:
+        f.write(struct.pack(HEADER_FORMAT, MAGIC, VERSION, len(names), names_size))
+        for entry in entries:
+            f.write(struct.pack(ENTRY_FORMAT, *entry))
+        for encoded_name in encoded_names:
+            f.write(encoded_name)
+
+        for name, entry in zip(names, entries):
+            f.write(b"\0" * (entry[0] - f.tell()))
+            with open(os.path.join(source_dir, name), "rb") as src:
+                f.write(src.read())
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Packs a texture replacement directory into a single file.")
+    parser.add_argument("source_dir", help="Replacement directory, e.g. textures/SLUS-00000/replacements")
+    parser.add_argument("-o", "--output", help="Output file, defaults to replacements.pack in the source directory")
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.source_dir):
+        print("Source directory does not exist: %s" % args.source_dir)
+        sys.exit(1)
+
+    output_path = args.output if args.output else os.path.join(args.source_dir, PACK_FILENAME)
+    names = find_replacements(args.source_dir)
+    if len(names) == 0:
+        print("No replacements found in %s" % args.source_dir)
+        sys.exit(1)
+
+    write_pack(args.source_dir, output_path, names)
+    print("Packed %u replacements into %s" % (len(names), output_path))
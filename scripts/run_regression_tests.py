@@ -30,7 +30,27 @@ def run_regression_test(runner, destdir, dump_interval, frames, renderer, cargs,
     return os.path.basename(gamepath)
 
 
-def run_regression_tests(runner, gamedirs, destdir, dump_interval, frames, parallel, renderer, cargs):
+def run_batch_regression_tests(runner, destdir, dump_interval, frames, parallel, renderer, cargs, gamepaths):
+    listpath = os.path.join(destdir, "batch.txt")
+    with open(listpath, "w") as f:
+        f.write("\n".join(gamepaths) + "\n")
+
+    args = [runner,
+            "-log", "error",
+            "-dumpdir", destdir,
+            "-dumpinterval", str(dump_interval),
+            "-frames", str(frames),
+            "-renderer", ("Software" if renderer is None else renderer),
+            "-batch", listpath,
+            "-jobs", str(max(parallel, 1)),
+    ]
+    args += cargs
+
+    print("Processing %u games in batch mode with %u workers" % (len(gamepaths), max(parallel, 1)))
+    return subprocess.run(args).returncode == 0
+
+
+def run_regression_tests(runner, gamedirs, destdir, dump_interval, frames, parallel, renderer, cargs, batch):
     paths = []
     for gamedir in gamedirs:
         paths += glob.glob(os.path.realpath(gamedir) + "/*.*", recursive=True)
@@ -46,7 +66,10 @@ def run_regression_tests(runner, gamedirs, destdir, dump_interval, frames, paral
 
     print("Found %u games" % len(gamepaths))
 
-    if parallel <= 1:
+    if batch:
+        # Failures are reported by the runner, same as the per-process mode.
+        run_batch_regression_tests(runner, destdir, dump_interval, frames, parallel, renderer, cargs, gamepaths)
+    elif parallel <= 1:
         for game in gamepaths:
             run_regression_test(runner, destdir, dump_interval, frames, renderer, cargs, game)
     else:
@@ -76,6 +99,7 @@ if __name__ == "__main__":
     parser.add_argument("-pgxp", action="store_true", help="Enable PGXP")
     parser.add_argument("-pgxpcpu", action="store_true", help="Enable PGXP CPU mode")
     parser.add_argument("-cpu", action="store", help="CPU execution mode")
+    parser.add_argument("-batch", action="store_true", help="Run all games in one runner process per worker")
 
     args = parser.parse_args()
     cargs = []
@@ -88,7 +112,7 @@ if __name__ == "__main__":
     if (args.cpu is not None):
         cargs += ["-cpu", args.cpu]
 
-    if not run_regression_tests(args.runner, args.gamedir, os.path.realpath(args.destdir), args.dumpinterval, args.frames, args.parallel, args.renderer, cargs):
+    if not run_regression_tests(args.runner, args.gamedir, os.path.realpath(args.destdir), args.dumpinterval, args.frames, args.parallel, args.renderer, cargs, args.batch):
         sys.exit(1)
     else:
         sys.exit(0)
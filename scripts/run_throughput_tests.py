@@ -0,0 +1,128 @@
+import argparse
+import glob
+import json
+import sys
+import os
+import subprocess
+import tempfile
+
+def is_game_path(path:str):
+    lpath = path.lower()
+    for extension in ["cue", "chd", "psxgpu", "psxgpu.zst", "psxgpu.xz"]:
+        if lpath.endswith(extension):
+            return True
+    return False
+
+
+def run_throughput_test(runner, warmup, frames, renderer, cargs, gamepath):
+    # Results go to a temporary file, stdout has the log output mixed in.
+    fd, result_path = tempfile.mkstemp(suffix=".json")
+    os.close(fd)
+
+    args = [runner,
+            "-log", "error",
+            "-throughput", result_path,
+            "-warmup", str(warmup),
+            "-frames", str(frames),
+            "-renderer", ("Software" if renderer is None else renderer),
+    ]
+    args += cargs
+    args += ["--", gamepath]
+
+    try:
+        subprocess.run(args)
+        with open(result_path, "r") as f:
+            return json.load(f)
+    except (OSError, ValueError):
+        return None
+    finally:
+        os.remove(result_path)
+
+
+def compare_results(results, baseline, threshold):
+    regressions = 0
+    for name, result in results.items():
+        if name not in baseline:
+            continue
+
+        for key in ["vps", "fps"]:
+            old = baseline[name].get(key, 0)
+            new = result.get(key, 0)
+            if old <= 0:
+                continue
+
+            change = (new - old) * 100.0 / old
+            if change < -threshold:
+                print("REGRESSION: %s %s %.2f -> %.2f (%.1f%%)" % (name, key, old, new, change))
+                regressions += 1
+
+    return regressions
+
+
+def run_throughput_tests(runner, gamedirs, output, warmup, frames, renderer, cargs, baseline, threshold):
+    paths = []
+    for gamedir in gamedirs:
+        paths += glob.glob(os.path.realpath(gamedir) + "/*.*", recursive=True)
+    gamepaths = list(filter(is_game_path, paths))
+    gamepaths.sort(key=lambda x: os.path.basename(x))
+
+    print("Found %u games" % len(gamepaths))
+
+    # Games are run one at a time, running them in parallel would skew the timings.
+    results = {}
+    for i, game in enumerate(gamepaths):
+        name = os.path.basename(game)
+        result = run_throughput_test(runner, warmup, frames, renderer, cargs, game)
+        if result is None:
+            print("[%u/%u] %s: FAILED" % (i + 1, len(gamepaths), name))
+            continue
+
+        print("[%u/%u] %s: %.2f VPS, %.2f FPS, %.1f%% speed" % (i + 1, len(gamepaths), name, result["vps"],
+                                                              result["fps"], result["speed"]))
+        results[name] = result
+
+    if output is not None:
+        with open(output, "w") as f:
+            json.dump(results, f, indent=2)
+
+    if baseline is not None:
+        with open(baseline, "r") as f:
+            regressions = compare_results(results, json.load(f), threshold)
+        print("%u regressions" % regressions)
+        if regressions > 0:
+            return False
+
+    return len(results) == len(gamepaths)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Measure emulation throughput across a set of games")
+    parser.add_argument("-runner", action="store", required=True, help="Path to DuckStation regression test runner")
+    parser.add_argument("-gamedir", action="append", required=True, help="Directory containing game images")
+    parser.add_argument("-output", action="store", help="File to write the combined results to")
+    parser.add_argument("-baseline", action="store", help="Results from a previous run to compare against")
+    parser.add_argument("-threshold", action="store", type=float, default=5.0, help="Percentage drop to report")
+    parser.add_argument("-warmup", action="store", type=int, default=600, help="Number of frames to run first")
+    parser.add_argument("-frames", action="store", type=int, default=3600, help="Number of frames to measure")
+    parser.add_argument("-renderer", action="store", type=str, help="Renderer to use")
+    parser.add_argument("-upscale", action="store", type=int, help="Upscale multiplier")
+    parser.add_argument("-pgxp", action="store_true", help="Enable PGXP")
+    parser.add_argument("-pgxpcpu", action="store_true", help="Enable PGXP CPU mode")
+    parser.add_argument("-cpu", action="store", help="CPU execution mode")
+
+    args = parser.parse_args()
+    cargs = []
+    if (args.upscale is not None):
+        cargs += ["-upscale", str(args.upscale)]
+    if (args.pgxp):
+        cargs += ["-pgxp"]
+    if (args.pgxpcpu):
+        cargs += ["-pgxp-cpu"]
+    if (args.cpu is not None):
+        cargs += ["-cpu", args.cpu]
+
+    if not run_throughput_tests(args.runner, args.gamedir, args.output, args.warmup, args.frames, args.renderer, cargs,
+                                args.baseline, args.threshold):
+        sys.exit(1)
+    else:
+        sys.exit(0)
@@ -27,3 +27,164 @@ TEST(FileSystem, GetWin32Path)
 }
 
 #endif
+
+#ifndef __ANDROID__
+
+#include "common/directory_watcher.h"
+#include "common/path.h"
+
+#include "fmt/format.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <vector>
+
+TEST(FileSystem, EnumerateFilesMatchesFindFiles)
+{
+#ifdef _WIN32
+  const char* temp_root = std::getenv("TEMP");
+#else
+  const char* temp_root = std::getenv("TMPDIR");
+  temp_root = temp_root ? temp_root : "/tmp";
+#endif
+  ASSERT_NE(temp_root, nullptr);
+
+  const std::string root = Path::Combine(temp_root, "duckstation-enumerate-files-test");
+  FileSystem::RecursiveDeleteDirectory(root.c_str());
+
+  // Enough files in one directory to be split across several stat batches.
+  for (u32 dir = 0; dir < 4; dir++)
+  {
+    const std::string dir_path = Path::Combine(root, fmt::format("dir{}/sub", dir));
+    ASSERT_TRUE(FileSystem::CreateDirectory(dir_path.c_str(), true));
+    for (u32 file = 0; file < ((dir == 0) ? 300 : 5); file++)
+    {
+      ASSERT_TRUE(FileSystem::WriteStringToFile(Path::Combine(dir_path, fmt::format("file{}.bin", file)).c_str(),
+                                                "data"));
+    }
+  }
+
+  const u32 flags = FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_FOLDERS | FILESYSTEM_FIND_RECURSIVE;
+  for (const u32 extra_flags : {0u, static_cast<u32>(FILESYSTEM_FIND_RELATIVE_PATHS)})
+  {
+    FileSystem::FindResultsArray expected;
+    ASSERT_TRUE(FileSystem::FindFiles(root.c_str(), "*", flags | extra_flags, &expected));
+
+    FileSystem::FindResultsArray actual;
+    ASSERT_TRUE(FileSystem::EnumerateFiles(root.c_str(), "*", flags | extra_flags, [&actual](FILESYSTEM_FIND_DATA& fd) {
+      actual.push_back(std::move(fd));
+      return true;
+    }));
+
+    std::vector<std::string> expected_names, actual_names;
+    for (const FILESYSTEM_FIND_DATA& fd : expected)
+      expected_names.push_back(fmt::format("{}:{}:{}", fd.FileName, fd.Size, fd.Attributes));
+    for (const FILESYSTEM_FIND_DATA& fd : actual)
+      actual_names.push_back(fmt::format("{}:{}:{}", fd.FileName, fd.Size, fd.Attributes));
+    std::sort(expected_names.begin(), expected_names.end());
+    std::sort(actual_names.begin(), actual_names.end());
+    ASSERT_EQ(actual_names.size(), 300u + 3 * 5 + 4 * 2);
+    ASSERT_EQ(actual_names, expected_names);
+  }
+
+  // Stopping early shouldn't hang, or deliver anything else.
+  u32 count = 0;
+  FileSystem::EnumerateFiles(root.c_str(), "*.bin", FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_RECURSIVE,
+                             [&count](FILESYSTEM_FIND_DATA&) { return (++count < 10); });
+  ASSERT_EQ(count, 10u);
+
+  FileSystem::RecursiveDeleteDirectory(root.c_str());
+}
+
+TEST(FileSystem, MapBinaryFile)
+{
+#ifdef _WIN32
+  const char* temp_root = std::getenv("TEMP");
+#else
+  const char* temp_root = "/tmp";
+#endif
+  ASSERT_NE(temp_root, nullptr);
+
+  const std::string path = Path::Combine(temp_root, "duckstation-map-file-test.bin");
+  std::vector<u8> data(100000);
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = static_cast<u8>(i * 7);
+  ASSERT_TRUE(FileSystem::WriteBinaryFile(path.c_str(), data));
+
+  {
+    std::optional<FileSystem::MappedFile> mapped = FileSystem::MapBinaryFile(path.c_str());
+    ASSERT_TRUE(mapped.has_value());
+    ASSERT_EQ(mapped->size(), data.size());
+    ASSERT_TRUE(std::equal(data.begin(), data.end(), mapped->cspan().begin()));
+
+    // Moving keeps the same view.
+    const u8* const ptr = mapped->data();
+    FileSystem::MappedFile moved = std::move(mapped.value());
+    ASSERT_EQ(moved.data(), ptr);
+    ASSERT_TRUE(mapped->empty());
+  }
+
+  ASSERT_TRUE(FileSystem::WriteBinaryFile(path.c_str(), std::span<const u8>()));
+  {
+    std::optional<FileSystem::MappedFile> mapped = FileSystem::MapBinaryFile(path.c_str());
+    ASSERT_TRUE(mapped.has_value());
+    ASSERT_TRUE(mapped->empty());
+  }
+
+  ASSERT_TRUE(FileSystem::DeleteFile(path.c_str()));
+  ASSERT_FALSE(FileSystem::MapBinaryFile(path.c_str()).has_value());
+}
+
+TEST(FileSystem, DirectoryWatcher)
+{
+  if (!DirectoryWatcher::IsSupported())
+    GTEST_SKIP();
+
+#ifdef _WIN32
+  const char* temp_root = std::getenv("TEMP");
+#else
+  const char* temp_root = "/tmp";
+#endif
+  ASSERT_NE(temp_root, nullptr);
+
+  const std::string root = Path::Combine(temp_root, "duckstation-directory-watcher-test");
+  FileSystem::RecursiveDeleteDirectory(root.c_str());
+  ASSERT_TRUE(FileSystem::CreateDirectory(Path::Combine(root, "sub").c_str(), true));
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool notified = false;
+
+  DirectoryWatcher watcher;
+  watcher.AddDirectory(root, true);
+  ASSERT_TRUE(watcher.Start(
+    [&]() {
+      std::unique_lock lock(mutex);
+      notified = true;
+      cv.notify_one();
+    },
+    [](const std::string& path) { return !path.ends_with(".txt"); }, nullptr));
+
+  // Existing subdirectories should be watched too, and filtered paths dropped.
+  const std::string file_in_subdir = Path::Combine(root, "sub" FS_OSPATH_SEPARATOR_STR "game.bin");
+  ASSERT_TRUE(FileSystem::WriteStringToFile(file_in_subdir.c_str(), "data"));
+  ASSERT_TRUE(FileSystem::WriteStringToFile(Path::Combine(root, "notes.txt").c_str(), "data"));
+
+  {
+    std::unique_lock lock(mutex);
+    ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(10), [&notified]() { return notified; }));
+  }
+
+  std::vector<std::string> changes;
+  ASSERT_TRUE(watcher.TakeChanges(&changes));
+  ASSERT_EQ(changes, std::vector<std::string>{file_in_subdir});
+
+  watcher.Stop();
+  FileSystem::RecursiveDeleteDirectory(root.c_str());
+}
+
+#endif
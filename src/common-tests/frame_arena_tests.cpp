@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "common/frame_arena.h"
+#include "common/string_util.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+
+TEST(FrameArena, AllocationsAreAligned)
+{
+  FrameArena arena;
+  for (size_t alignment = 1; alignment <= 256; alignment *= 2)
+  {
+    arena.Allocate(1, 1);
+    void* const ptr = arena.Allocate(7, alignment);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignment, 0u);
+  }
+}
+
+TEST(FrameArena, ResetReusesBlocks)
+{
+  FrameArena arena;
+  void* const first = arena.Allocate(16);
+  arena.Allocate(FrameArena::BLOCK_SIZE / 8);
+  arena.Allocate(FrameArena::BLOCK_SIZE / 8);
+  ASSERT_GT(arena.GetBytesUsed(), FrameArena::BLOCK_SIZE / 4);
+
+  arena.Reset();
+  ASSERT_EQ(arena.GetBytesUsed(), 0u);
+  ASSERT_GT(arena.GetPeakBytesUsed(), FrameArena::BLOCK_SIZE / 4);
+  ASSERT_EQ(arena.Allocate(16), first);
+}
+
+TEST(FrameArena, LargeAllocations)
+{
+  FrameArena arena;
+  u8* const small = static_cast<u8*>(arena.Allocate(16));
+  u8* const large = static_cast<u8*>(arena.Allocate(FrameArena::BLOCK_SIZE * 2, 64));
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(large) % 64, 0u);
+  std::memset(large, 0xAB, FrameArena::BLOCK_SIZE * 2);
+
+  // Shouldn't have moved on from the current block.
+  u8* const next = static_cast<u8*>(arena.Allocate(16));
+  ASSERT_EQ(next, small + 16);
+}
+
+TEST(FrameArena, Strings)
+{
+  FrameArena arena;
+  const std::string_view copy = arena.CopyString("hello");
+  ASSERT_EQ(copy, "hello");
+  ASSERT_EQ(copy.data()[copy.size()], '\0');
+
+  const std::string_view formatted = arena.Format("{} {}", 12, "abc");
+  ASSERT_EQ(formatted, "12 abc");
+  ASSERT_EQ(formatted.data()[formatted.size()], '\0');
+}
+
+TEST(FrameArena, FrameVector)
+{
+  FrameArena arena;
+  FrameVector<std::string_view> parts{FrameAllocator<std::string_view>(arena)};
+  StringUtil::SplitStringInto(parts, "a & b&&c ", '&', true);
+  ASSERT_EQ(parts.size(), 3u);
+  ASSERT_EQ(parts[0], "a");
+  ASSERT_EQ(parts[1], "b");
+  ASSERT_EQ(parts[2], "c");
+  ASSERT_GT(arena.GetBytesUsed(), 0u);
+}
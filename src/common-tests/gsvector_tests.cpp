@@ -763,6 +763,11 @@ TEST(GSVector4iTest, Type64BitConversions)
   EXPECT_EQ(s8to64_result.S64[0], 0x12);
   EXPECT_EQ(s8to64_result.S64[1], 0x34);
 
+  // Test u8to64
+  auto u8to64_result = v1.u8to64();
+  EXPECT_EQ(u8to64_result.U64[0], 0x12u);
+  EXPECT_EQ(u8to64_result.U64[1], 0x34u);
+
   // Test u16to64
   auto u16to64_result = v1.u16to64();
   EXPECT_EQ(u16to64_result.U64[0], 0x3412u); // Little endian 16-bit
@@ -856,6 +861,20 @@ TEST(GSVector4iTest, Eq64Operations)
   EXPECT_EQ(eq64_result.S64[1], 0);  // Not equal
 }
 
+TEST(GSVector4iTest, Add64Operations)
+{
+  GSVector4i v1;
+  GSVector4i v2;
+  v1.S64[0] = 0x00000000FFFFFFFFLL;
+  v1.S64[1] = -0x0000080000000000LL;
+  v2.S64[0] = 1;                     // Carries into the upper half
+  v2.S64[1] = -0x0000000000000001LL; // Borrows from the upper half
+
+  auto add64_result = v1.add64(v2);
+  EXPECT_EQ(add64_result.S64[0], 0x0000000100000000LL);
+  EXPECT_EQ(add64_result.S64[1], -0x0000080000000001LL);
+}
+
 TEST(GSVector4iTest, InsertExtract64Bit)
 {
   GSVector4i v1(0x12345678, 0x9ABCDEF0, 0x11111111, 0x22222222);
@@ -1246,6 +1265,181 @@ TEST(GSVector4Test, FloatToDoubleConversions)
   EXPECT_EQ(i32.S32[1], -2);
 }
 
+// GSVector8i Tests
+// Native with AVX2, NEON and no-SIMD builds emulate it with two 128-bit halves.
+#if !defined(CPU_ARCH_SSE) || defined(GSVECTOR_HAS_256)
+
+TEST(GSVector8iTest, ConstructionAndHalves)
+{
+  constexpr GSVector8i v1 = GSVector8i::cxpr(1, 2, 3, 4, 5, 6, 7, 8);
+  for (int i = 0; i < 8; i++)
+    EXPECT_EQ(v1.S32[i], i + 1);
+
+  GSVector8i v2(42);
+  for (int i = 0; i < 8; i++)
+    EXPECT_EQ(v2.S32[i], 42);
+
+  GSVector8i v3(GSVector4i::cxpr(10, 20, 30, 40), GSVector4i::cxpr(50, 60, 70, 80));
+  EXPECT_EQ(v3.S32[0], 10);
+  EXPECT_EQ(v3.S32[3], 40);
+  EXPECT_EQ(v3.S32[4], 50);
+  EXPECT_EQ(v3.S32[7], 80);
+  EXPECT_TRUE(v3.low128().eq(GSVector4i::cxpr(10, 20, 30, 40)));
+  EXPECT_TRUE(v3.high128().eq(GSVector4i::cxpr(50, 60, 70, 80)));
+
+  GSVector8i v4 = GSVector8i::broadcast128(GSVector4i::cxpr(1, 2, 3, 4));
+  EXPECT_TRUE(v4.eq(GSVector8i::cxpr(1, 2, 3, 4, 1, 2, 3, 4)));
+
+  GSVector8i v5 = GSVector8i::zext32(123);
+  EXPECT_TRUE(v5.eq(GSVector8i::cxpr(123, 0, 0, 0, 0, 0, 0, 0)));
+  EXPECT_TRUE(GSVector8i::zero().allfalse());
+}
+
+TEST(GSVector8iTest, LoadStore)
+{
+  alignas(32) s32 data[8] = {1, -2, 3, -4, 5, -6, 7, -8};
+  GSVector8i v1 = GSVector8i::load<true>(data);
+  for (int i = 0; i < 8; i++)
+    EXPECT_EQ(v1.S32[i], data[i]);
+
+  alignas(32) s32 out[8] = {};
+  GSVector8i::store<true>(out, v1.add32(GSVector8i::cxpr(10)));
+  for (int i = 0; i < 8; i++)
+    EXPECT_EQ(out[i], data[i] + 10);
+
+  u8 unaligned[33] = {};
+  GSVector8i::store<false>(&unaligned[1], v1);
+  EXPECT_TRUE(GSVector8i::load<false>(&unaligned[1]).eq(v1));
+}
+
+TEST(GSVector8iTest, Arithmetic)
+{
+  GSVector8i v1 = GSVector8i::cxpr(1, 2, 3, 4, 5, 6, 7, 8);
+  GSVector8i v2 = GSVector8i::cxpr(8, 7, 6, 5, 4, 3, 2, 1);
+
+  EXPECT_TRUE(v1.add32(v2).eq(GSVector8i::cxpr(9)));
+  EXPECT_TRUE(v1.sub32(v2).eq(GSVector8i::cxpr(-7, -5, -3, -1, 1, 3, 5, 7)));
+  EXPECT_TRUE(v1.mul32l(v2).eq(GSVector8i::cxpr(8, 14, 18, 20, 20, 18, 14, 8)));
+  EXPECT_TRUE(v1.min_s32(v2).eq(GSVector8i::cxpr(1, 2, 3, 4, 4, 3, 2, 1)));
+  EXPECT_TRUE(v1.max_s32(v2).eq(GSVector8i::cxpr(8, 7, 6, 5, 5, 6, 7, 8)));
+
+  GSVector8i v3 = GSVector8i::cxpr16(32000);
+  GSVector8i v4 = v3.adds16(GSVector8i::cxpr16(1000));
+  for (int i = 0; i < 16; i++)
+    EXPECT_EQ(v4.S16[i], 32767);
+}
+
+TEST(GSVector8iTest, Shifts)
+{
+  GSVector8i v1 = GSVector8i::cxpr(1, 2, 4, 8, -16, -32, -64, -128);
+  EXPECT_TRUE(v1.sll32<2>().eq(GSVector8i::cxpr(4, 8, 16, 32, -64, -128, -256, -512)));
+  EXPECT_TRUE(v1.sra32<2>().eq(GSVector8i::cxpr(0, 0, 1, 2, -4, -8, -16, -32)));
+
+  GSVector8i v2 = GSVector8i::cxpr(0x100);
+  GSVector8i shifts = GSVector8i::cxpr(0, 1, 2, 3, 4, 5, 6, 7);
+  EXPECT_TRUE(v2.srlv32(shifts).eq(GSVector8i::cxpr(0x100, 0x80, 0x40, 0x20, 0x10, 0x8, 0x4, 0x2)));
+  EXPECT_TRUE(v2.sllv32(shifts).eq(GSVector8i::cxpr(0x100, 0x200, 0x400, 0x800, 0x1000, 0x2000, 0x4000, 0x8000)));
+
+  // Byte shifts don't cross the 128-bit halves.
+  GSVector8i v3 = GSVector8i::cxpr(1, 2, 3, 4, 5, 6, 7, 8);
+  EXPECT_TRUE(v3.srl<4>().eq(GSVector8i::cxpr(2, 3, 4, 0, 6, 7, 8, 0)));
+  EXPECT_TRUE(v3.sll<4>().eq(GSVector8i::cxpr(0, 1, 2, 3, 0, 5, 6, 7)));
+}
+
+TEST(GSVector8iTest, PerLaneUnpackAndShuffle)
+{
+  GSVector8i v1 = GSVector8i::cxpr(1, 2, 3, 4, 5, 6, 7, 8);
+  GSVector8i v2 = GSVector8i::cxpr(11, 12, 13, 14, 15, 16, 17, 18);
+  EXPECT_TRUE(v1.upl32(v2).eq(GSVector8i::cxpr(1, 11, 2, 12, 5, 15, 6, 16)));
+  EXPECT_TRUE(v1.uph32(v2).eq(GSVector8i::cxpr(3, 13, 4, 14, 7, 17, 8, 18)));
+  EXPECT_TRUE(v1.upl64(v2).eq(GSVector8i::cxpr(1, 2, 11, 12, 5, 6, 15, 16)));
+
+  GSVector8i v3 = GSVector8i::cxpr(-1, 70000, 100, 200, 300, -70000, 400, 500);
+  GSVector8i packed = v3.ps32(v3);
+  EXPECT_EQ(packed.S16[0], -1);
+  EXPECT_EQ(packed.S16[1], 32767);
+  EXPECT_EQ(packed.S16[8], 300);
+  EXPECT_EQ(packed.S16[9], -32768);
+
+  // Reverse the dwords within each half.
+  GSVector4i reverse = GSVector4i::cxpr8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+  EXPECT_TRUE(v1.shuffle8(GSVector8i::broadcast128(reverse)).eq(GSVector8i::cxpr(4, 3, 2, 1, 8, 7, 6, 5)));
+}
+
+TEST(GSVector8iTest, WideningConversions)
+{
+  GSVector4i v1 = GSVector4i::cxpr16(1, -2, 3, -4, 5, -6, 7, -8);
+  EXPECT_TRUE(GSVector8i::s16to32(v1).eq(GSVector8i::cxpr(1, -2, 3, -4, 5, -6, 7, -8)));
+  EXPECT_TRUE(GSVector8i::u16to32(v1).eq(GSVector8i::cxpr(1, 0xFFFE, 3, 0xFFFC, 5, 0xFFFA, 7, 0xFFF8)));
+
+  GSVector4i v2 = GSVector4i::cxpr8(1, 2, 3, 4, 5, 6, 7, s8t(0xFF), 9, 10, 11, 12, 13, 14, 15, 16);
+  EXPECT_TRUE(GSVector8i::u8to32(v2).eq(GSVector8i::cxpr(1, 2, 3, 4, 5, 6, 7, 0xFF)));
+  EXPECT_TRUE(GSVector8i::s8to32(v2).eq(GSVector8i::cxpr(1, 2, 3, 4, 5, 6, 7, -1)));
+
+  GSVector8i v3 = GSVector8i::u8to16(v2);
+  EXPECT_EQ(v3.U16[7], 0xFF);
+  EXPECT_EQ(v3.U16[15], 16);
+}
+
+TEST(GSVector8iTest, ComparisonsAndMasks)
+{
+  GSVector8i v1 = GSVector8i::cxpr(1, 5, 3, 7, 2, 6, 4, 8);
+  GSVector8i v2 = GSVector8i::cxpr(4);
+
+  GSVector8i gt = v1.gt32(v2);
+  EXPECT_TRUE(gt.eq(GSVector8i::cxpr(0, -1, 0, -1, 0, -1, 0, -1)));
+  EXPECT_EQ(gt.mask(), 0xF0F0F0F0u);
+  EXPECT_TRUE(gt.anytrue());
+  EXPECT_FALSE(gt.alltrue());
+  EXPECT_TRUE(v1.ge32(v2).eq(GSVector8i::cxpr(0, -1, 0, -1, 0, -1, -1, -1)));
+  EXPECT_TRUE(v1.le32(v2).eq(GSVector8i::cxpr(-1, 0, -1, 0, -1, 0, -1, 0)));
+  EXPECT_TRUE(v1.eq32(v1).alltrue());
+  EXPECT_TRUE(v1.neq32(v1).allfalse());
+
+  GSVector8i v3 = GSVector8i::cxpr16(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16);
+  GSVector8i ge16 = v3.ge16(GSVector8i::cxpr16(8));
+  for (int i = 0; i < 16; i++)
+    EXPECT_EQ(ge16.U16[i], (i >= 7) ? 0xFFFFu : 0u);
+
+  EXPECT_TRUE(v1.blend(v2, gt).eq(GSVector8i::cxpr(1, 4, 3, 4, 2, 4, 4, 4)));
+  EXPECT_TRUE(v1.blend32<0xF0>(v2).eq(GSVector8i::cxpr(1, 5, 3, 7, 4, 4, 4, 4)));
+  EXPECT_TRUE(v1.blend32<0x21>(v2).eq(GSVector8i::cxpr(4, 5, 3, 7, 2, 4, 4, 8)));
+}
+
+TEST(GSVector8iTest, InsertExtract)
+{
+  GSVector8i v1 = GSVector8i::zero();
+  v1 = v1.insert32<1>(11).insert32<6>(66);
+  EXPECT_EQ(v1.extract32<1>(), 11);
+  EXPECT_EQ(v1.extract32<6>(), 66);
+  EXPECT_TRUE(v1.eq(GSVector8i::cxpr(0, 11, 0, 0, 0, 0, 66, 0)));
+
+  v1 = v1.insert16<15>(0x1234);
+  EXPECT_EQ(v1.extract16<15>(), 0x1234);
+  v1 = v1.insert8<20>(0x56);
+  EXPECT_EQ(v1.extract8<20>(), 0x56);
+  EXPECT_EQ(v1.U8[20], 0x56);
+
+  v1 = v1.insert64<3>(static_cast<s64>(0x0123456789ABCDEFLL));
+  EXPECT_EQ(v1.extract64<3>(), static_cast<s64>(0x0123456789ABCDEFLL));
+}
+
+TEST(GSVector8iTest, BitwiseOperations)
+{
+  GSVector8i v1 = GSVector8i::cxpr(0x0F0F0F0F);
+  GSVector8i v2 = GSVector8i::cxpr(0x00FF00FF, 0, 0, 0, 0, 0, 0, 0x00FF00FF);
+
+  EXPECT_TRUE((v1 & v2).eq(GSVector8i::cxpr(0x000F000F, 0, 0, 0, 0, 0, 0, 0x000F000F)));
+  EXPECT_TRUE((v1 | v2).eq(GSVector8i::cxpr(0x0FFF0FFF, 0x0F0F0F0F, 0x0F0F0F0F, 0x0F0F0F0F, 0x0F0F0F0F, 0x0F0F0F0F,
+                                            0x0F0F0F0F, 0x0FFF0FFF)));
+  EXPECT_TRUE((v1 ^ v1).allfalse());
+  EXPECT_TRUE((~GSVector8i::zero()).alltrue());
+  EXPECT_TRUE(v1.andnot(v2).eq(GSVector8i::cxpr(0x0F000F00, 0x0F0F0F0F, 0x0F0F0F0F, 0x0F0F0F0F, 0x0F0F0F0F,
+                                                0x0F0F0F0F, 0x0F0F0F0F, 0x0F000F00)));
+}
+
+#endif
+
 // Cross-class conversion tests
 TEST(GSVectorTest, ConversionsGSVector2iGSVector2)
 {
@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "core/gpu_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+// Deterministic pseudo-random fill, so every bit pattern shows up across a few vectors.
+template<typename T, size_t N>
+static void FillTestData(std::array<T, N>& data)
+{
+  u32 seed = 0x12345678u;
+  for (T& value : data)
+  {
+    seed = seed * 1103515245u + 12345u;
+    value = static_cast<T>(seed >> 16);
+  }
+}
+
+#ifdef CPU_ARCH_SIMD
+
+template<GPUTextureFormat format>
+static void Test15BitConversion()
+{
+  static constexpr u32 NUM_PIXELS = 256;
+
+  std::array<u16, NUM_PIXELS> src;
+  FillTestData(src);
+
+  std::array<u8, NUM_PIXELS * sizeof(u32)> vector_out = {};
+  std::array<u8, NUM_PIXELS * sizeof(u32)> scalar_out = {};
+
+  u8* vector_ptr = vector_out.data();
+  for (u32 i = 0; i < NUM_PIXELS; i += 8)
+    ConvertVRAMPixels<format>(vector_ptr, GSVector4i::load<false>(&src[i]));
+
+  u8* scalar_ptr = scalar_out.data();
+  for (u32 i = 0; i < NUM_PIXELS; i++)
+    ConvertVRAMPixel<format>(scalar_ptr, src[i]);
+
+  ASSERT_EQ(vector_ptr - vector_out.data(), scalar_ptr - scalar_out.data());
+  EXPECT_EQ(vector_out, scalar_out);
+}
+
+TEST(GSVector, VRAM15BitToRGBA8)
+{
+  Test15BitConversion<GPUTextureFormat::RGBA8>();
+}
+
+TEST(GSVector, VRAM15BitToRGB5A1)
+{
+  Test15BitConversion<GPUTextureFormat::RGB5A1>();
+}
+
+TEST(GSVector, VRAM15BitToA1BGR5)
+{
+  Test15BitConversion<GPUTextureFormat::A1BGR5>();
+}
+
+TEST(GSVector, VRAM15BitToRGB565)
+{
+  Test15BitConversion<GPUTextureFormat::RGB565>();
+}
+
+TEST(GSVector, VRAM24BitToRGBA8)
+{
+  static constexpr u32 NUM_PIXELS = 256;
+
+  // Over-read slack for the final vector load.
+  std::array<u8, NUM_PIXELS * 3 + 4> src;
+  FillTestData(src);
+
+  // Start from every byte offset within a pixel pair, since 24-bit scanlines can begin at an odd halfword.
+  for (u32 offset = 0; offset < 4; offset++)
+  {
+    static constexpr u32 CONVERT_PIXELS = NUM_PIXELS - 4;
+
+    std::array<u8, CONVERT_PIXELS * sizeof(u32)> vector_out = {};
+    std::array<u8, CONVERT_PIXELS * sizeof(u32)> scalar_out = {};
+
+    const u8* vector_src = src.data() + offset;
+    u8* vector_ptr = vector_out.data();
+    for (u32 i = 0; i < CONVERT_PIXELS; i += 4)
+      ConvertVRAM24BitPixels(vector_ptr, vector_src);
+
+    const u8* scalar_src = src.data() + offset;
+    u8* scalar_ptr = scalar_out.data();
+    for (u32 i = 0; i < CONVERT_PIXELS; i++)
+      ConvertVRAM24BitPixel(scalar_ptr, scalar_src);
+
+    ASSERT_EQ(vector_src, scalar_src);
+    EXPECT_EQ(vector_out, scalar_out);
+  }
+}
+
+#endif
+
+TEST(GSVector, VRAM24BitToRGBA8_Scalar)
+{
+  static constexpr std::array<u8, 6> src = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66};
+
+  std::array<u32, 2> out = {};
+  const u8* src_ptr = src.data();
+  u8* dst_ptr = reinterpret_cast<u8*>(out.data());
+  ConvertVRAM24BitPixel(dst_ptr, src_ptr);
+  ConvertVRAM24BitPixel(dst_ptr, src_ptr);
+
+  EXPECT_EQ(out[0], 0xFF332211u);
+  EXPECT_EQ(out[1], 0xFF665544u);
+}
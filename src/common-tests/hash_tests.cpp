@@ -1,12 +1,16 @@
 // SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
 // SPDX-License-Identifier: CC-BY-NC-ND-4.0
 
+#include "common/fast_hash.h"
 #include "common/md5_digest.h"
 #include "common/sha1_digest.h"
 #include "common/sha256_digest.h"
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <vector>
+
 TEST(SHA256Digest, Simple)
 {
   // https://github.com/B-Con/crypto-algorithms/blob/master/sha256_test.c
@@ -372,3 +376,111 @@ TEST(MD5Digest, BinaryData)
 
   EXPECT_EQ(result1, result2);
 }
+
+// Fast hash tests
+static std::vector<u8> MakeTestData(size_t size)
+{
+  std::vector<u8> data(size);
+  u32 value = 0x12345678u;
+  for (u8& byte : data)
+  {
+    value = value * 1664525u + 1013904223u;
+    byte = static_cast<u8>(value >> 24);
+  }
+  return data;
+}
+
+TEST(FastHash, Hash64KnownValues)
+{
+  static constexpr const char text[] = "The quick brown fox jumps over the lazy dog";
+
+  EXPECT_EQ(FastHash::Hash64(nullptr, 0), 0x2D06800538D394C2ULL);
+  EXPECT_EQ(FastHash::Hash64(text, std::size(text) - 1), 0xCE7D19A5418FB365ULL);
+  EXPECT_NE(FastHash::Hash64(text, std::size(text) - 1, 1), FastHash::Hash64(text, std::size(text) - 1));
+}
+
+TEST(FastHash, Hash128KnownValues)
+{
+  static constexpr const char text[] = "The quick brown fox jumps over the lazy dog";
+
+  const FastHash::Hash128 hash = FastHash::Hash128Bits(text, std::size(text) - 1);
+  EXPECT_EQ(hash.low, 0x24A1CC2E3A8A7651ULL);
+  EXPECT_EQ(hash.high, 0xDDD650205CA3E7FAULL);
+}
+
+TEST(FastHash, StreamingMatchesOneShot)
+{
+  // Covers the short, medium and long input paths, split at awkward points.
+  const std::vector<u8> data = MakeTestData(5000);
+  for (const size_t size : {0, 3, 16, 17, 128, 129, 240, 241, 1024, 5000})
+  {
+    for (const size_t chunk : {1, 7, 64, 1000})
+    {
+      FastHash::Hasher64 hasher64(42);
+      FastHash::Hasher128 hasher128(42);
+      for (size_t offset = 0; offset < size; offset += chunk)
+      {
+        const std::span<const u8> part(data.data() + offset, std::min(chunk, size - offset));
+        hasher64.Update(part);
+        hasher128.Update(part);
+      }
+
+      EXPECT_EQ(hasher64.Final(), FastHash::Hash64(data.data(), size, 42)) << size << " " << chunk;
+      EXPECT_EQ(hasher128.Final(), FastHash::Hash128Bits(data.data(), size, 42)) << size << " " << chunk;
+    }
+  }
+}
+
+TEST(FastHash, HasherReset)
+{
+  const std::vector<u8> data = MakeTestData(300);
+
+  FastHash::Hasher64 hasher;
+  hasher.Update(data.data(), 100);
+  hasher.Reset();
+  hasher.Update(data);
+  EXPECT_EQ(hasher.Final(), FastHash::Hash64(data));
+}
+
+TEST(FastHash, CRC32CKnownValues)
+{
+  static constexpr const char text[] = "123456789";
+  static constexpr u8 zeros[32] = {};
+
+  EXPECT_EQ(FastHash::CRC32C(nullptr, 0), 0u);
+  EXPECT_EQ(FastHash::CRC32C(text, std::size(text) - 1), 0xE3069283u);
+  EXPECT_EQ(FastHash::CRC32C(zeros, sizeof(zeros)), 0x8A9136AAu);
+  EXPECT_EQ(FastHash::CRC32CSoftware(text, std::size(text) - 1), 0xE3069283u);
+  EXPECT_EQ(FastHash::CRC32CSoftware(zeros, sizeof(zeros)), 0x8A9136AAu);
+}
+
+TEST(FastHash, CRC32CHardwareMatchesSoftware)
+{
+  // Unaligned starts and odd lengths, so both the wide and byte loops get exercised.
+  const std::vector<u8> data = MakeTestData(1100);
+  for (size_t offset = 0; offset < 8; offset++)
+  {
+    for (size_t size = 0; size < 80; size++)
+    {
+      ASSERT_EQ(FastHash::CRC32C(&data[offset], size), FastHash::CRC32CSoftware(&data[offset], size))
+        << offset << " " << size;
+    }
+  }
+
+  EXPECT_EQ(FastHash::CRC32C(&data[3], 1097), FastHash::CRC32CSoftware(&data[3], 1097));
+}
+
+TEST(FastHash, CRC32CChaining)
+{
+  const std::vector<u8> data = MakeTestData(1000);
+  const u32 whole = FastHash::CRC32C(data);
+
+  u32 crc = 0;
+  crc = FastHash::CRC32C(data.data(), 333, crc);
+  crc = FastHash::CRC32C(data.data() + 333, 667, crc);
+  EXPECT_EQ(crc, whole);
+
+  u32 soft_crc = FastHash::CRC32CSoftware(data.data(), 5);
+  soft_crc = FastHash::CRC32CSoftware(data.data() + 5, 995, soft_crc);
+  EXPECT_EQ(soft_crc, whole);
+}
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "common/lru_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+
+TEST(LRUCache, EvictsLeastRecentlyUsed)
+{
+  LRUCache<int, int> cache(3);
+  cache.Insert(1, 10);
+  cache.Insert(2, 20);
+  cache.Insert(3, 30);
+
+  // Touching 1 makes 2 the oldest.
+  ASSERT_NE(cache.Lookup(1), nullptr);
+  cache.Insert(4, 40);
+
+  ASSERT_EQ(cache.GetSize(), 3u);
+  ASSERT_EQ(cache.Lookup(2), nullptr);
+  ASSERT_EQ(*cache.Lookup(1), 10);
+  ASSERT_EQ(*cache.Lookup(3), 30);
+  ASSERT_EQ(*cache.Lookup(4), 40);
+}
+
+TEST(LRUCache, ReplaceDoesNotEvict)
+{
+  LRUCache<int, int> cache(2);
+  cache.Insert(1, 10);
+  cache.Insert(2, 20);
+  cache.Insert(2, 21);
+
+  ASSERT_EQ(cache.GetSize(), 2u);
+  ASSERT_EQ(*cache.Lookup(1), 10);
+  ASSERT_EQ(*cache.Lookup(2), 21);
+}
+
+TEST(LRUCache, StringKeysLookupWithoutAllocation)
+{
+  LRUCache<std::string, int> cache(4);
+  cache.Insert("foo", 1);
+  cache.Insert("bar", 2);
+
+  ASSERT_EQ(*cache.Lookup(std::string_view("foo")), 1);
+  ASSERT_TRUE(cache.Remove(std::string_view("bar")));
+  ASSERT_FALSE(cache.Remove(std::string_view("bar")));
+  ASSERT_EQ(cache.GetSize(), 1u);
+}
+
+TEST(LRUCache, ByteBudget)
+{
+  LRUCache<int, int> cache(100);
+  cache.SetMaxBytes(100);
+  cache.Insert(1, 10, 40);
+  cache.Insert(2, 20, 40);
+  ASSERT_EQ(cache.GetSizeInBytes(), 80u);
+
+  cache.Insert(3, 30, 40);
+  ASSERT_EQ(cache.Lookup(1), nullptr);
+  ASSERT_EQ(cache.GetSizeInBytes(), 80u);
+
+  // Growing an item evicts others, but never the item itself.
+  cache.Insert(3, 31, 90);
+  ASSERT_EQ(cache.GetSize(), 1u);
+  ASSERT_EQ(cache.GetSizeInBytes(), 90u);
+
+  cache.SetMaxBytes(50);
+  ASSERT_EQ(cache.GetSize(), 0u);
+  ASSERT_EQ(cache.GetSizeInBytes(), 0u);
+}
+
+TEST(LRUCache, ManualEvictKeepsItemsUntilRequested)
+{
+  LRUCache<int, int> cache(2, true);
+  int* first = cache.Insert(1, 10);
+  cache.Insert(2, 20);
+  cache.Insert(3, 30);
+
+  // Pointers handed out earlier have to stay valid until the owner evicts.
+  ASSERT_EQ(cache.GetSize(), 3u);
+  ASSERT_EQ(*first, 10);
+
+  cache.ManualEvict();
+  ASSERT_EQ(cache.GetSize(), 2u);
+  ASSERT_EQ(cache.Lookup(1), nullptr);
+}
+
+TEST(LRUCache, RemoveMatchingItems)
+{
+  LRUCache<std::string, int> cache(8);
+  cache.Insert("a/1", 1);
+  cache.Insert("a/2", 2);
+  cache.Insert("b/1", 3);
+
+  ASSERT_EQ(cache.RemoveMatchingItems([](const std::string& key) { return key.starts_with("a/"); }), 2u);
+  ASSERT_EQ(cache.GetSize(), 1u);
+
+  // List must still be consistent after removing from the middle.
+  cache.Insert("c/1", 4);
+  cache.Evict(2);
+  ASSERT_EQ(cache.GetSize(), 0u);
+}
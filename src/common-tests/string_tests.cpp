@@ -5,6 +5,8 @@
 #include "common/string_util.h"
 
 #include <gtest/gtest.h>
+#include <cstring>
+#include <string>
 #include <string_view>
 #include <tuple>
 
@@ -271,6 +273,77 @@ TEST(StringUtil, ContainsNoCase)
   ASSERT_FALSE(StringUtil::ContainsNoCase("test", "testing"));
 }
 
+TEST(StringUtil, NoCaseLongStrings)
+{
+  // Long enough to go through the vector paths, with differences either side of the 16 byte boundaries.
+  const std::string base = "Final Fantasy VII (USA) (Disc 1) [SCUS-94163] @[\\]^_`{|}~\x7F\x80\xC0\xFF";
+  std::string upper = base;
+  for (char& ch : upper)
+    ch = StringUtil::ToUpper(ch);
+
+  ASSERT_TRUE(StringUtil::EqualNoCase(base, upper));
+  ASSERT_EQ(StringUtil::CompareNoCase(base, upper), 0);
+  ASSERT_TRUE(StringUtil::StartsWithNoCase(upper, base.substr(0, 40)));
+  ASSERT_TRUE(StringUtil::EndsWithNoCase(upper, base.substr(20)));
+
+  // '@' is just before 'A', and '[' just after 'Z', so they must not be folded.
+  ASSERT_FALSE(StringUtil::EqualNoCase("@@@@@@@@@@@@@@@@@@", "``````````````````"));
+  ASSERT_FALSE(StringUtil::EqualNoCase("[[[[[[[[[[[[[[[[[[", "{{{{{{{{{{{{{{{{{{"));
+
+  for (size_t i = 0; i < base.size(); i++)
+  {
+    std::string changed = upper;
+    changed[i] = '\x01';
+    ASSERT_FALSE(StringUtil::EqualNoCase(base, changed));
+    ASSERT_GT(StringUtil::CompareNoCase(base, changed), 0);
+    ASSERT_LT(StringUtil::CompareNoCase(changed, base), 0);
+
+    // Bytes above 0x7F sort after ASCII.
+    changed[i] = '\xFE';
+    if (static_cast<u8>(base[i]) < 0xFE)
+    {
+      ASSERT_LT(StringUtil::CompareNoCase(base, changed), 0);
+    }
+  }
+
+  for (size_t start = 0; start < base.size(); start++)
+  {
+    for (size_t len = 1; (start + len) <= base.size(); len += 3)
+    {
+      ASSERT_TRUE(StringUtil::ContainsNoCase(upper, base.substr(start, len)));
+      ASSERT_TRUE(StringUtil::ContainsNoCase(base, upper.substr(start, len)));
+    }
+  }
+
+  ASSERT_FALSE(StringUtil::ContainsNoCase(upper, "Final Fantasy VIII"));
+  ASSERT_FALSE(StringUtil::ContainsNoCase(upper, "xfinal"));
+  ASSERT_TRUE(StringUtil::ContainsNoCase("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab", "AAB"));
+}
+
+TEST(StringUtil, GetNoCaseSortKey)
+{
+  static constexpr const char* strings[] = {"",         "a",        "A1",         "ab",          "abcdefgh",
+                                            "ABCDEFGH", "abcdefghi", "abcdefghij", "Abcdefgz",   "b",
+                                            "Zebra",    "zebras",    "\xC0" "abc",    "{bracket}", "_under"};
+  for (const char* lhs : strings)
+  {
+    for (const char* rhs : strings)
+    {
+      const u64 lkey = StringUtil::GetNoCaseSortKey(lhs);
+      const u64 rkey = StringUtil::GetNoCaseSortKey(rhs);
+      const int res = StringUtil::CompareNoCase(lhs, rhs);
+      if (lkey != rkey)
+      {
+        ASSERT_EQ(lkey < rkey, res < 0) << lhs << " vs " << rhs;
+      }
+      else if (res != 0)
+      {
+        ASSERT_TRUE(std::strlen(lhs) > 8 || std::strlen(rhs) > 8) << lhs << " vs " << rhs;
+      }
+    }
+  }
+}
+
 TEST(StringUtil, FromCharsIntegral)
 {
   // Test integers
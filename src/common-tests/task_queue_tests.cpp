@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "common/task_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST(TaskQueue, RunsAllTasks)
+{
+  TaskQueue queue;
+  queue.SetWorkerCount(4);
+
+  std::atomic<u32> count{0};
+  for (u32 i = 0; i < 1000; i++)
+    queue.SubmitTask([&count]() { count.fetch_add(1, std::memory_order_relaxed); });
+
+  queue.WaitForAll();
+  ASSERT_EQ(count.load(), 1000u);
+}
+
+TEST(TaskQueue, NoWorkersRunsOnWaitingThread)
+{
+  TaskQueue queue;
+
+  const std::thread::id caller = std::this_thread::get_id();
+  bool ran_on_caller = false;
+  queue.SubmitTask([&]() { ran_on_caller = (std::this_thread::get_id() == caller); });
+  queue.WaitForAll();
+  ASSERT_TRUE(ran_on_caller);
+}
+
+TEST(TaskQueue, InteractiveBeforeBackground)
+{
+  // With no workers, everything runs in priority order once we wait.
+  TaskQueue queue;
+
+  std::vector<int> order;
+  queue.SubmitTask([&order]() { order.push_back(1); }, TaskQueue::Priority::Background);
+  queue.SubmitTask([&order]() { order.push_back(2); }, TaskQueue::Priority::Interactive);
+  queue.SubmitTask([&order]() { order.push_back(3); }, TaskQueue::Priority::Background);
+  queue.WaitForAll();
+  ASSERT_EQ(order, (std::vector<int>{2, 1, 3}));
+}
+
+TEST(TaskQueue, WaitForGroup)
+{
+  TaskQueue queue;
+  queue.SetWorkerCount(2);
+
+  TaskQueue::Group group;
+  std::atomic<u32> count{0};
+  for (u32 i = 0; i < 100; i++)
+    queue.SubmitTask([&count]() { count.fetch_add(1, std::memory_order_relaxed); }, TaskQueue::Priority::Background,
+                     &group);
+
+  queue.WaitForAll(group);
+  ASSERT_TRUE(group.IsDone());
+  ASSERT_EQ(count.load(), 100u);
+}
+
+TEST(TaskQueue, NestedSubmitFromWorker)
+{
+  TaskQueue queue;
+  queue.SetWorkerCount(3);
+
+  TaskQueue::Group group;
+  std::atomic<u32> count{0};
+  for (u32 i = 0; i < 16; i++)
+  {
+    queue.SubmitTask(
+      [&queue, &group, &count]() {
+        for (u32 j = 0; j < 16; j++)
+          queue.SubmitTask([&count]() { count.fetch_add(1, std::memory_order_relaxed); },
+                           TaskQueue::Priority::Interactive, &group);
+      },
+      TaskQueue::Priority::Interactive, &group);
+  }
+
+  queue.WaitForAll(group);
+  ASSERT_EQ(count.load(), 256u);
+}
+
+TEST(TaskQueue, ContinuationRunsAfterGroup)
+{
+  TaskQueue queue;
+  queue.SetWorkerCount(2);
+
+  TaskQueue::Group group;
+  std::atomic<u32> count{0};
+  std::atomic<u32> count_at_continuation{0};
+  for (u32 i = 0; i < 50; i++)
+    queue.SubmitTask([&count]() { count.fetch_add(1, std::memory_order_relaxed); }, TaskQueue::Priority::Interactive,
+                     &group);
+  queue.SubmitContinuation(group, [&]() { count_at_continuation.store(count.load()); });
+
+  queue.WaitForAll();
+  ASSERT_EQ(count_at_continuation.load(), 50u);
+
+  // Already done, so this one is queued immediately.
+  bool ran = false;
+  queue.SubmitContinuation(group, [&ran]() { ran = true; });
+  queue.WaitForAll();
+  ASSERT_TRUE(ran);
+}
+
+TEST(TaskQueue, WaiterRunsTasksQueuedWhileBlocked)
+{
+  // The only worker is stuck until the second task runs, so the waiting thread has to pick it up.
+  TaskQueue queue;
+  queue.SetWorkerCount(1);
+
+  TaskQueue::Group group;
+  std::atomic<bool> released{false};
+  queue.SubmitTask(
+    [&queue, &released]() {
+      queue.SubmitTask([&released]() { released.store(true, std::memory_order_release); });
+      while (!released.load(std::memory_order_acquire))
+        std::this_thread::yield();
+    },
+    TaskQueue::Priority::Interactive, &group);
+
+  queue.WaitForAll(group);
+  ASSERT_TRUE(released.load());
+}
+
+TEST(TaskQueue, GroupDestroyedAfterWait)
+{
+  TaskQueue queue;
+  queue.SetWorkerCount(4);
+
+  std::atomic<u32> count{0};
+  for (u32 i = 0; i < 1000; i++)
+  {
+    TaskQueue::Group group;
+    queue.SubmitTask([&count]() { count.fetch_add(1, std::memory_order_relaxed); }, TaskQueue::Priority::Interactive,
+                     &group);
+    queue.SubmitContinuation(group, [&count]() { count.fetch_add(1, std::memory_order_relaxed); });
+    queue.WaitForAll(group);
+  }
+
+  queue.WaitForAll();
+  ASSERT_EQ(count.load(), 2000u);
+}
+
+TEST(TaskQueue, LargeCapturesAreHeapAllocated)
+{
+  TaskQueue queue;
+
+  std::array<u8, 256> data = {};
+  data[255] = 42;
+  auto owned = std::make_unique<int>(7);
+  int result = 0;
+  queue.SubmitTask([data, &result, owned = std::move(owned)]() { result = data[255] + *owned; });
+  queue.WaitForAll();
+  ASSERT_EQ(result, 49);
+}
@@ -0,0 +1,488 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "directory_watcher.h"
+#include "assert.h"
+#include "error.h"
+#include "file_system.h"
+#include "log.h"
+#include "path.h"
+#include "threading.h"
+
+#include "fmt/format.h"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+#include "string_util.h"
+#include "windows_headers.h"
+#elif defined(__linux__)
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+LOG_CHANNEL(FileSystem);
+
+// Events tend to come in bursts, e.g. while a file is being copied, so wait for them to stop before notifying.
+static constexpr u32 SETTLE_TIME_MS = 1000;
+
+struct DirectoryWatcher::Directory
+{
+  std::string path;
+  bool recursive;
+
+#ifdef _WIN32
+  HANDLE handle = INVALID_HANDLE_VALUE;
+  OVERLAPPED overlapped = {};
+
+  // Can't be any larger than this for network shares.
+  alignas(DWORD) u8 buffer[64 * 1024];
+#endif
+};
+
+DirectoryWatcher::DirectoryWatcher() = default;
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+  Stop();
+}
+
+void DirectoryWatcher::AddDirectory(std::string path, bool recursive)
+{
+  DebugAssert(!m_thread.joinable());
+
+  std::unique_ptr<Directory>& dir = m_directories.emplace_back(std::make_unique<Directory>());
+  dir->path = std::move(path);
+  dir->recursive = recursive;
+}
+
+bool DirectoryWatcher::TakeChanges(std::vector<std::string>* paths)
+{
+  std::unique_lock lock(m_changes_mutex);
+  std::sort(m_changes.begin(), m_changes.end());
+  m_changes.erase(std::unique(m_changes.begin(), m_changes.end()), m_changes.end());
+  paths->swap(m_changes);
+  m_changes.clear();
+
+  const bool changes_lost = m_changes_lost;
+  m_changes_lost = false;
+  return !changes_lost;
+}
+
+bool DirectoryWatcher::AddChange(std::string path)
+{
+  if (m_filter && !m_filter(path))
+    return false;
+
+  std::unique_lock lock(m_changes_mutex);
+  m_changes.push_back(std::move(path));
+  return true;
+}
+
+#if defined(_WIN32)
+
+static bool IssueDirectoryRead(HANDLE handle, OVERLAPPED* overlapped, u8* buffer, DWORD buffer_size, bool recursive)
+{
+  ResetEvent(overlapped->hEvent);
+  return ReadDirectoryChangesW(handle, buffer, buffer_size, recursive,
+                               FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |
+                                 FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+                               nullptr, overlapped, nullptr);
+}
+
+bool DirectoryWatcher::IsSupported()
+{
+  return true;
+}
+
+bool DirectoryWatcher::Start(ChangeCallback callback, PathFilter filter, Error* error)
+{
+  DebugAssert(!m_thread.joinable());
+
+  // One event per directory, plus the stop event.
+  if (m_directories.size() >= MAXIMUM_WAIT_OBJECTS)
+  {
+    Error::SetStringFmt(error, "Too many directories to watch ({})", m_directories.size());
+    return false;
+  }
+
+  m_stop_event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+  if (!m_stop_event)
+  {
+    Error::SetWin32(error, "CreateEventW() failed: ", GetLastError());
+    return false;
+  }
+
+  for (const std::unique_ptr<Directory>& dir : m_directories)
+  {
+    dir->handle = CreateFileW(FileSystem::GetWin32Path(dir->path).c_str(), FILE_LIST_DIRECTORY,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (dir->handle == INVALID_HANDLE_VALUE)
+    {
+      Error::SetWin32(error, fmt::format("CreateFileW() for '{}' failed: ", dir->path), GetLastError());
+      Stop();
+      return false;
+    }
+
+    dir->overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!dir->overlapped.hEvent ||
+        !IssueDirectoryRead(dir->handle, &dir->overlapped, dir->buffer, sizeof(dir->buffer), dir->recursive))
+    {
+      Error::SetWin32(error, fmt::format("ReadDirectoryChangesW() for '{}' failed: ", dir->path), GetLastError());
+      Stop();
+      return false;
+    }
+  }
+
+  m_callback = std::move(callback);
+  m_filter = std::move(filter);
+  m_thread = std::thread(&DirectoryWatcher::ThreadEntryPoint, this);
+  return true;
+}
+
+void DirectoryWatcher::Stop()
+{
+  if (m_thread.joinable())
+  {
+    SetEvent(m_stop_event);
+    m_thread.join();
+  }
+
+  for (const std::unique_ptr<Directory>& dir : m_directories)
+  {
+    if (dir->handle != INVALID_HANDLE_VALUE)
+    {
+      // The buffer has to stay around until the read has actually been cancelled.
+      DWORD bytes;
+      if (CancelIoEx(dir->handle, &dir->overlapped))
+        GetOverlappedResult(dir->handle, &dir->overlapped, &bytes, TRUE);
+
+      CloseHandle(dir->handle);
+      dir->handle = INVALID_HANDLE_VALUE;
+    }
+
+    if (dir->overlapped.hEvent)
+    {
+      CloseHandle(dir->overlapped.hEvent);
+      dir->overlapped.hEvent = nullptr;
+    }
+  }
+
+  if (m_stop_event)
+  {
+    CloseHandle(m_stop_event);
+    m_stop_event = nullptr;
+  }
+}
+
+void DirectoryWatcher::ThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Directory Watcher");
+
+  std::vector<HANDLE> handles;
+  handles.reserve(m_directories.size() + 1);
+  for (const std::unique_ptr<Directory>& dir : m_directories)
+    handles.push_back(dir->overlapped.hEvent);
+  handles.push_back(m_stop_event);
+
+  bool has_pending_changes = false;
+  for (;;)
+  {
+    const DWORD res = WaitForMultipleObjects(static_cast<DWORD>(handles.size()), handles.data(), FALSE,
+                                             has_pending_changes ? SETTLE_TIME_MS : INFINITE);
+    if (res == WAIT_TIMEOUT)
+    {
+      has_pending_changes = false;
+      m_callback();
+      continue;
+    }
+    else if (res < WAIT_OBJECT_0 || res >= (WAIT_OBJECT_0 + m_directories.size()))
+    {
+      // stop event, or the wait failed
+      break;
+    }
+
+    Directory* dir = m_directories[res - WAIT_OBJECT_0].get();
+    DWORD bytes;
+    if (!GetOverlappedResult(dir->handle, &dir->overlapped, &bytes, FALSE) || bytes == 0)
+    {
+      // zero bytes means the buffer overflowed
+      WARNING_LOG("Lost change notifications for '{}'", dir->path);
+      std::unique_lock lock(m_changes_mutex);
+      m_changes_lost = true;
+      has_pending_changes = true;
+    }
+    else
+    {
+      for (const u8* ptr = dir->buffer;;)
+      {
+        const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(ptr);
+        has_pending_changes |= AddChange(Path::Combine(
+          dir->path, StringUtil::WideStringToUTF8String(
+                       std::wstring_view(info->FileName, info->FileNameLength / sizeof(WCHAR)))));
+        if (info->NextEntryOffset == 0)
+          break;
+
+        ptr += info->NextEntryOffset;
+      }
+    }
+
+    if (!IssueDirectoryRead(dir->handle, &dir->overlapped, dir->buffer, sizeof(dir->buffer), dir->recursive))
+    {
+      // No more notifications for this directory, so the caller can't trust the changes any more. The event was
+      // reset before the read was issued, so it won't fire again.
+      ERROR_LOG("ReadDirectoryChangesW() for '{}' failed: {}", dir->path, GetLastError());
+
+      std::unique_lock lock(m_changes_mutex);
+      m_changes_lost = true;
+      has_pending_changes = true;
+    }
+  }
+}
+
+#elif defined(__linux__)
+
+bool DirectoryWatcher::IsSupported()
+{
+  return true;
+}
+
+bool DirectoryWatcher::AddWatch(const std::string& path, Directory* root)
+{
+  static constexpr u32 WATCH_MASK = IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO |
+                                    IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+  const int wd = inotify_add_watch(m_inotify_fd, path.c_str(), WATCH_MASK);
+  if (wd < 0)
+    return false;
+
+  // same directory reached through another path, e.g. a symlink
+  const auto iter = std::find_if(m_watches.begin(), m_watches.end(), [wd](const Watch& w) { return (w.wd == wd); });
+  if (iter != m_watches.end())
+    return true;
+
+  m_watches.push_back(Watch{wd, path, root});
+  return true;
+}
+
+void DirectoryWatcher::AddWatchesForSubdirectories(const std::string& path, Directory* root)
+{
+  FileSystem::EnumerateFiles(path.c_str(), "*",
+                             FILESYSTEM_FIND_FOLDERS | FILESYSTEM_FIND_RECURSIVE | FILESYSTEM_FIND_HIDDEN_FILES,
+                             [this, root](FILESYSTEM_FIND_DATA& ffd) {
+                               if (!AddWatch(ffd.FileName, root))
+                               {
+                                 // out of watches, so we'll miss changes
+                                 WARNING_LOG("inotify_add_watch() for '{}' failed: {}", ffd.FileName, errno);
+                                 std::unique_lock lock(m_changes_mutex);
+                                 m_changes_lost = true;
+                               }
+
+                               return true;
+                             });
+}
+
+bool DirectoryWatcher::Start(ChangeCallback callback, PathFilter filter, Error* error)
+{
+  DebugAssert(!m_thread.joinable());
+
+  m_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_inotify_fd < 0)
+  {
+    Error::SetErrno(error, "inotify_init1() failed: ", errno);
+    return false;
+  }
+
+  m_stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (m_stop_fd < 0)
+  {
+    Error::SetErrno(error, "eventfd() failed: ", errno);
+    Stop();
+    return false;
+  }
+
+  for (const std::unique_ptr<Directory>& dir : m_directories)
+  {
+    if (!AddWatch(dir->path, dir.get()))
+    {
+      Error::SetErrno(error, fmt::format("inotify_add_watch() for '{}' failed: ", dir->path), errno);
+      Stop();
+      return false;
+    }
+
+    if (dir->recursive)
+      AddWatchesForSubdirectories(dir->path, dir.get());
+  }
+
+  {
+    std::unique_lock lock(m_changes_mutex);
+    if (m_changes_lost)
+    {
+      Error::SetStringView(error, "Not enough inotify watches available.");
+      lock.unlock();
+      Stop();
+      return false;
+    }
+  }
+
+  m_callback = std::move(callback);
+  m_filter = std::move(filter);
+  m_thread = std::thread(&DirectoryWatcher::ThreadEntryPoint, this);
+  return true;
+}
+
+void DirectoryWatcher::Stop()
+{
+  if (m_thread.joinable())
+  {
+    const u64 value = 1;
+    if (write(m_stop_fd, &value, sizeof(value)) != sizeof(value))
+      ERROR_LOG("Failed to signal directory watcher thread: {}", errno);
+
+    m_thread.join();
+  }
+
+  m_watches.clear();
+
+  if (m_stop_fd >= 0)
+  {
+    close(m_stop_fd);
+    m_stop_fd = -1;
+  }
+
+  if (m_inotify_fd >= 0)
+  {
+    close(m_inotify_fd);
+    m_inotify_fd = -1;
+  }
+}
+
+void DirectoryWatcher::ThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Directory Watcher");
+
+  alignas(inotify_event) char buffer[16 * 1024];
+  bool has_pending_changes = false;
+  for (;;)
+  {
+    pollfd fds[2] = {{m_inotify_fd, POLLIN, 0}, {m_stop_fd, POLLIN, 0}};
+    const int res = poll(fds, std::size(fds), has_pending_changes ? static_cast<int>(SETTLE_TIME_MS) : -1);
+    if (res < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      ERROR_LOG("poll() failed: {}", errno);
+      break;
+    }
+    else if (fds[1].revents != 0)
+    {
+      break;
+    }
+    else if (res == 0)
+    {
+      has_pending_changes = false;
+      m_callback();
+      continue;
+    }
+
+    ssize_t len;
+    while ((len = read(m_inotify_fd, buffer, sizeof(buffer))) > 0)
+    {
+      for (ssize_t pos = 0; pos < len;)
+      {
+        const inotify_event* ev = reinterpret_cast<const inotify_event*>(&buffer[pos]);
+        pos += sizeof(inotify_event) + ev->len;
+
+        if (ev->mask & IN_Q_OVERFLOW)
+        {
+          WARNING_LOG("inotify queue overflowed, changes were lost");
+          std::unique_lock lock(m_changes_mutex);
+          m_changes_lost = true;
+          has_pending_changes = true;
+          continue;
+        }
+
+        const auto iter =
+          std::find_if(m_watches.begin(), m_watches.end(), [ev](const Watch& w) { return (w.wd == ev->wd); });
+        if (iter == m_watches.end())
+          continue;
+
+        if (ev->mask & IN_IGNORED)
+        {
+          // directory was removed, the parent reports it
+          m_watches.erase(iter);
+          continue;
+        }
+        else if (ev->len == 0)
+        {
+          // event on the directory itself
+          has_pending_changes |= AddChange(iter->path);
+          continue;
+        }
+
+        Directory* const root = iter->root;
+        std::string path = Path::Combine(iter->path, ev->name);
+        if (ev->mask & IN_ISDIR)
+        {
+          if ((ev->mask & IN_MOVED_FROM) && root->recursive)
+          {
+            // anything reported from the old location would be under the wrong path
+            for (auto it = m_watches.begin(); it != m_watches.end();)
+            {
+              if (it->path.starts_with(path) && (it->path.length() == path.length() || it->path[path.length()] == '/'))
+              {
+                inotify_rm_watch(m_inotify_fd, it->wd);
+                it = m_watches.erase(it);
+              }
+              else
+              {
+                ++it;
+              }
+            }
+          }
+          else if ((ev->mask & (IN_CREATE | IN_MOVED_TO)) && root->recursive)
+          {
+            if (!AddWatch(path, root))
+            {
+              WARNING_LOG("inotify_add_watch() for '{}' failed: {}", path, errno);
+              std::unique_lock lock(m_changes_mutex);
+              m_changes_lost = true;
+            }
+
+            AddWatchesForSubdirectories(path, root);
+          }
+        }
+
+        has_pending_changes |= AddChange(std::move(path));
+      }
+    }
+  }
+}
+
+#else
+
+bool DirectoryWatcher::IsSupported()
+{
+  return false;
+}
+
+bool DirectoryWatcher::Start(ChangeCallback callback, PathFilter filter, Error* error)
+{
+  Error::SetStringView(error, "Directory watching is not supported on this platform.");
+  return false;
+}
+
+void DirectoryWatcher::Stop()
+{
+}
+
+void DirectoryWatcher::ThreadEntryPoint()
+{
+}
+
+#endif
@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#pragma once
+
+#include "types.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Error;
+
+/// Reports files being added, removed, renamed or modified under a set of directories, using the OS's change
+/// notifications (inotify on Linux, ReadDirectoryChangesW on Windows). Events are collected on a background thread.
+class DirectoryWatcher
+{
+public:
+  /// Called on the watcher thread once changes have settled, i.e. nothing new has arrived for a short while.
+  using ChangeCallback = std::function<void()>;
+
+  /// Called on the watcher thread for each changed path, changes are dropped if it returns false.
+  using PathFilter = std::function<bool(const std::string& path)>;
+
+  DirectoryWatcher();
+  ~DirectoryWatcher();
+
+  DirectoryWatcher(const DirectoryWatcher&) = delete;
+  DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+  /// Returns false if the platform has no change notifications, in which case callers have to rescan instead.
+  static bool IsSupported();
+
+  /// Adds a directory to be watched. Must be called before Start().
+  void AddDirectory(std::string path, bool recursive);
+
+  /// Starts watching the added directories. The filter is optional.
+  bool Start(ChangeCallback callback, PathFilter filter, Error* error);
+  void Stop();
+
+  /// Returns the full paths of everything that has changed since the last call. Directories which were created,
+  /// moved or deleted as a whole are reported as the directory itself. Returns false if any events were lost, in
+  /// which case the caller should rescan everything.
+  bool TakeChanges(std::vector<std::string>* paths);
+
+private:
+  struct Directory;
+
+  void ThreadEntryPoint();
+  bool AddChange(std::string path);
+
+  std::vector<std::unique_ptr<Directory>> m_directories;
+  ChangeCallback m_callback;
+  PathFilter m_filter;
+  std::thread m_thread;
+
+  std::mutex m_changes_mutex;
+  std::vector<std::string> m_changes;
+  bool m_changes_lost = false;
+
+#if defined(_WIN32)
+  void* m_stop_event = nullptr;
+#elif defined(__linux__)
+  bool AddWatch(const std::string& path, Directory* root);
+  void AddWatchesForSubdirectories(const std::string& path, Directory* root);
+
+  struct Watch
+  {
+    int wd;
+    std::string path;
+    Directory* root;
+  };
+
+  std::vector<Watch> m_watches;
+  int m_inotify_fd = -1;
+  int m_stop_fd = -1;
+#endif
+};
@@ -0,0 +1,258 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "event_trace.h"
+#include "error.h"
+#include "file_system.h"
+
+#include "fmt/format.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace EventTrace {
+namespace {
+
+enum class EventType : u32
+{
+  Span,
+  Instant,
+  Counter,
+};
+
+struct Event
+{
+  Timer::Value time;
+  u64 data; // duration for spans, value for counters
+  const char* name;
+  EventType type;
+};
+
+// 2MB per thread that records. Once full, the oldest events are overwritten.
+static constexpr u32 EVENTS_PER_THREAD = 65536;
+
+struct ThreadBuffer
+{
+  std::string name;
+  u32 index = 0;
+  std::atomic_bool exited{false};
+
+  // Only touched by the owning thread, other than the exporter reading behind write_pos.
+  std::atomic<u32> generation{0};
+  std::unique_ptr<Event[]> events;
+  std::atomic<u64> write_pos{0};
+};
+
+// Lets the buffer be dropped at the next recording once the thread is gone.
+struct ThreadBufferOwner
+{
+  ThreadBuffer* buffer = nullptr;
+
+  ~ThreadBufferOwner()
+  {
+    if (buffer)
+      buffer->exited.store(true, std::memory_order_release);
+  }
+};
+
+struct State
+{
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+  u32 next_thread_index = 1;
+  std::atomic<u32> generation{0};
+  Timer::Value start_time = 0;
+};
+
+} // namespace
+
+static ThreadBuffer* GetThreadBuffer();
+static void RecordEvent(EventType type, const char* name, Timer::Value time, u64 data);
+static void AppendEscapedString(std::string& out, std::string_view str);
+
+static State s_state;
+static thread_local ThreadBufferOwner s_thread_buffer;
+
+} // namespace EventTrace
+
+std::atomic_bool EventTrace::Internal::g_recording{false};
+
+EventTrace::ThreadBuffer* EventTrace::GetThreadBuffer()
+{
+  if (s_thread_buffer.buffer) [[likely]]
+    return s_thread_buffer.buffer;
+
+  std::unique_lock lock(s_state.mutex);
+  std::unique_ptr<ThreadBuffer>& buffer = s_state.buffers.emplace_back(std::make_unique<ThreadBuffer>());
+  buffer->index = s_state.next_thread_index++;
+  s_thread_buffer.buffer = buffer.get();
+  return buffer.get();
+}
+
+void EventTrace::RecordEvent(EventType type, const char* name, Timer::Value time, u64 data)
+{
+  ThreadBuffer* const buffer = GetThreadBuffer();
+
+  // Threads start over on their first event after a new recording starts, so StartRecording() doesn't have to touch
+  // buffers that other threads are writing to.
+  const u32 generation = s_state.generation.load(std::memory_order_acquire);
+  if (buffer->generation.load(std::memory_order_relaxed) != generation) [[unlikely]]
+  {
+    if (!buffer->events)
+      buffer->events = std::make_unique<Event[]>(EVENTS_PER_THREAD);
+    buffer->write_pos.store(0, std::memory_order_release);
+    buffer->generation.store(generation, std::memory_order_release);
+  }
+
+  const u64 pos = buffer->write_pos.load(std::memory_order_relaxed);
+  Event& ev = buffer->events[pos % EVENTS_PER_THREAD];
+  ev.time = time;
+  ev.data = data;
+  ev.name = name;
+  ev.type = type;
+  buffer->write_pos.store(pos + 1, std::memory_order_release);
+}
+
+void EventTrace::Internal::RecordSpan(const char* name, Timer::Value start_time, Timer::Value end_time)
+{
+  RecordEvent(EventType::Span, name, start_time, end_time - start_time);
+}
+
+void EventTrace::Internal::RecordInstant(const char* name, Timer::Value time)
+{
+  RecordEvent(EventType::Instant, name, time, 0);
+}
+
+void EventTrace::Internal::RecordCounter(const char* name, Timer::Value time, s64 value)
+{
+  RecordEvent(EventType::Counter, name, time, static_cast<u64>(value));
+}
+
+void EventTrace::StartRecording()
+{
+  std::unique_lock lock(s_state.mutex);
+
+  // Nothing can write to the buffers of threads that have exited.
+  s_state.buffers.erase(std::remove_if(s_state.buffers.begin(), s_state.buffers.end(),
+                                       [](const std::unique_ptr<ThreadBuffer>& buffer) {
+                                         return buffer->exited.load(std::memory_order_acquire);
+                                       }),
+                        s_state.buffers.end());
+
+  s_state.start_time = Timer::GetCurrentValue();
+  s_state.generation.fetch_add(1, std::memory_order_release);
+  Internal::g_recording.store(true, std::memory_order_release);
+}
+
+void EventTrace::StopRecording()
+{
+  Internal::g_recording.store(false, std::memory_order_release);
+}
+
+void EventTrace::SetThreadName(const char* name)
+{
+  // Only the owning thread writes the name, so it can be compared without the lock.
+  ThreadBuffer* const buffer = GetThreadBuffer();
+  if (buffer->name == name)
+    return;
+
+  std::unique_lock lock(s_state.mutex);
+  buffer->name = name;
+}
+
+void EventTrace::AppendEscapedString(std::string& out, std::string_view str)
+{
+  for (const char ch : str)
+  {
+    if (ch == '"' || ch == '\\')
+      out.push_back('\\');
+    if (static_cast<unsigned char>(ch) >= 0x20)
+      out.push_back(ch);
+  }
+}
+
+bool EventTrace::ExportChromeTrace(const char* path, Error* error)
+{
+  std::string json;
+  json.reserve(1024 * 1024);
+  json.append("{\"traceEvents\":[");
+
+  bool first = true;
+  const auto begin_event = [&json, &first]() {
+    if (!first)
+      json.push_back(',');
+    json.append("\n{");
+    first = false;
+  };
+
+  std::unique_lock lock(s_state.mutex);
+  const u32 generation = s_state.generation.load(std::memory_order_acquire);
+  const Timer::Value start_time = s_state.start_time;
+  const auto to_us = [start_time](Timer::Value time) {
+    return (time > start_time) ? (Timer::ConvertValueToNanoseconds(time - start_time) / 1000.0) : 0.0;
+  };
+
+  std::vector<Event> events;
+  for (const std::unique_ptr<ThreadBuffer>& buffer : s_state.buffers)
+  {
+    begin_event();
+    fmt::format_to(std::back_inserter(json),
+                   "\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"", buffer->index);
+    if (!buffer->name.empty())
+      AppendEscapedString(json, buffer->name);
+    else
+      fmt::format_to(std::back_inserter(json), "Thread {}", buffer->index);
+    json.append("\"}}");
+
+    // Events are copied out while the thread may still be writing. Anything that was overwritten during the copy is
+    // dropped afterwards, and a thread that restarted for a newer recording is skipped entirely.
+    const u64 end_pos = buffer->write_pos.load(std::memory_order_acquire);
+    if (buffer->generation.load(std::memory_order_acquire) != generation || end_pos == 0)
+      continue;
+
+    const u64 start_pos = (end_pos > EVENTS_PER_THREAD) ? (end_pos - EVENTS_PER_THREAD) : 0;
+    events.clear();
+    for (u64 pos = start_pos; pos < end_pos; pos++)
+      events.push_back(buffer->events[pos % EVENTS_PER_THREAD]);
+
+    const u64 new_end_pos = buffer->write_pos.load(std::memory_order_acquire);
+    if (new_end_pos < end_pos)
+      continue;
+    const u64 valid_start_pos = (new_end_pos > EVENTS_PER_THREAD) ? (new_end_pos - EVENTS_PER_THREAD) : 0;
+    const size_t skip = static_cast<size_t>(std::min<u64>(std::max(valid_start_pos, start_pos) - start_pos,
+                                                          events.size()));
+
+    for (size_t i = skip; i < events.size(); i++)
+    {
+      const Event& ev = events[i];
+      begin_event();
+      json.append("\"name\":\"");
+      AppendEscapedString(json, ev.name);
+      fmt::format_to(std::back_inserter(json), "\",\"pid\":1,\"tid\":{},\"ts\":{:.3f}", buffer->index, to_us(ev.time));
+      switch (ev.type)
+      {
+        case EventType::Span:
+          fmt::format_to(std::back_inserter(json), ",\"ph\":\"X\",\"dur\":{:.3f}}}",
+                         Timer::ConvertValueToNanoseconds(ev.data) / 1000.0);
+          break;
+
+        case EventType::Instant:
+          json.append(",\"ph\":\"i\",\"s\":\"t\"}");
+          break;
+
+        case EventType::Counter:
+          fmt::format_to(std::back_inserter(json), ",\"ph\":\"C\",\"args\":{{\"value\":{}}}}}",
+                         static_cast<s64>(ev.data));
+          break;
+      }
+    }
+  }
+
+  lock.unlock();
+
+  json.append("\n],\"displayTimeUnit\":\"ms\"}\n");
+  return FileSystem::WriteStringToFile(path, json, error);
+}
@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#pragma once
+
+#include "timer.h"
+#include "types.h"
+
+#include <atomic>
+
+class Error;
+
+/// Timeline recorder for spans, instant events and counters, exported in the Chrome trace event format. Each thread
+/// records into its own ring buffer without taking locks, and nothing past a relaxed load happens while not recording.
+/// Event names are stored by pointer, so they must be string literals.
+namespace EventTrace {
+
+namespace Internal {
+extern std::atomic_bool g_recording;
+
+void RecordSpan(const char* name, Timer::Value start_time, Timer::Value end_time);
+void RecordInstant(const char* name, Timer::Value time);
+void RecordCounter(const char* name, Timer::Value time, s64 value);
+} // namespace Internal
+
+ALWAYS_INLINE bool IsRecording()
+{
+  return Internal::g_recording.load(std::memory_order_relaxed);
+}
+
+/// Starts a new recording, discarding any events from the previous one.
+void StartRecording();
+void StopRecording();
+
+/// Names the calling thread in the exported trace. Threading::SetNameOfCurrentThread() calls this.
+void SetThreadName(const char* name);
+
+/// Writes the events from the current or last recording. Each thread keeps its most recent events if it filled its
+/// buffer. The JSON can be loaded in chrome://tracing or ui.perfetto.dev.
+bool ExportChromeTrace(const char* path, Error* error);
+
+ALWAYS_INLINE void Span(const char* name, Timer::Value start_time, Timer::Value end_time)
+{
+  if (IsRecording())
+    Internal::RecordSpan(name, start_time, end_time);
+}
+
+ALWAYS_INLINE void Instant(const char* name)
+{
+  if (IsRecording())
+    Internal::RecordInstant(name, Timer::GetCurrentValue());
+}
+
+ALWAYS_INLINE void Counter(const char* name, s64 value)
+{
+  if (IsRecording())
+    Internal::RecordCounter(name, Timer::GetCurrentValue(), value);
+}
+
+/// Records a span covering the lifetime of the object.
+class ScopedSpan
+{
+public:
+  ALWAYS_INLINE explicit ScopedSpan(const char* name)
+    : m_name(name), m_start_time(IsRecording() ? Timer::GetCurrentValue() : 0)
+  {
+  }
+
+  ALWAYS_INLINE ~ScopedSpan()
+  {
+    if (m_start_time != 0 && IsRecording())
+      Internal::RecordSpan(m_name, m_start_time, Timer::GetCurrentValue());
+  }
+
+  ScopedSpan(const ScopedSpan&) = delete;
+  ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+private:
+  const char* m_name;
+  Timer::Value m_start_time;
+};
+
+} // namespace EventTrace
@@ -0,0 +1,239 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "fast_hash.h"
+#include "intrin.h"
+
+#ifndef XXH_STATIC_LINKING_ONLY
+#define XXH_STATIC_LINKING_ONLY
+#endif
+#include "xxhash.h"
+#ifdef CPU_ARCH_SSE
+#include "xxh_x86dispatch.h"
+#endif
+
+#include <array>
+#include <cstring>
+
+#if defined(CPU_ARCH_X64)
+#define HAS_HARDWARE_CRC32C 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+#define CRC32C_TARGET __attribute__((target("sse4.2")))
+#else
+#define CRC32C_TARGET
+#endif
+#elif defined(CPU_ARCH_ARM64) && (defined(__GNUC__) || defined(__clang__))
+#define HAS_HARDWARE_CRC32C 1
+#include <arm_acle.h>
+#if defined(__ARM_FEATURE_CRC32)
+#define CRC32C_TARGET
+#elif defined(__clang__)
+#define CRC32C_TARGET __attribute__((target("crc")))
+#else
+#define CRC32C_TARGET __attribute__((target("+crc")))
+#endif
+#if defined(_WIN32)
+#include "windows_headers.h"
+#elif defined(__linux__)
+#include <sys/auxv.h>
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1 << 7)
+#endif
+#endif
+#endif
+
+static_assert(sizeof(XXH3_state_t) <= FastHash::STATE_SIZE && alignof(XXH3_state_t) <= FastHash::STATE_ALIGNMENT,
+              "XXH3 state fits in storage");
+
+namespace FastHash {
+static constexpr u32 CRC32C_POLYNOMIAL = 0x82F63B78u; // Reflected.
+
+// Slicing-by-8 tables, row N advances a byte's contribution through N further bytes.
+static constexpr std::array<std::array<u32, 256>, 8> s_crc32c_tables = []() {
+  std::array<std::array<u32, 256>, 8> tables = {};
+  for (u32 i = 0; i < 256; i++)
+  {
+    u32 crc = i;
+    for (u32 j = 0; j < 8; j++)
+      crc = (crc >> 1) ^ (CRC32C_POLYNOMIAL & (0u - (crc & 1u)));
+    tables[0][i] = crc;
+  }
+  for (u32 i = 0; i < 256; i++)
+  {
+    for (u32 j = 1; j < 8; j++)
+      tables[j][i] = (tables[j - 1][i] >> 8) ^ tables[0][tables[j - 1][i] & 0xFFu];
+  }
+  return tables;
+}();
+
+#ifdef HAS_HARDWARE_CRC32C
+static bool DetectHardwareCRC32C();
+CRC32C_TARGET static u32 UpdateCRC32CHardware(const u8* data, size_t size, u32 crc);
+
+static const bool s_has_hardware_crc32c = DetectHardwareCRC32C();
+#endif
+
+ALWAYS_INLINE static XXH3_state_t* GetState(u8* storage)
+{
+  return reinterpret_cast<XXH3_state_t*>(storage);
+}
+ALWAYS_INLINE static const XXH3_state_t* GetState(const u8* storage)
+{
+  return reinterpret_cast<const XXH3_state_t*>(storage);
+}
+} // namespace FastHash
+
+u64 FastHash::Hash64(const void* data, size_t size, u64 seed)
+{
+  return (seed == 0) ? XXH3_64bits(data, size) : XXH3_64bits_withSeed(data, size, seed);
+}
+
+FastHash::Hash128 FastHash::Hash128Bits(const void* data, size_t size, u64 seed)
+{
+  const XXH128_hash_t hash = (seed == 0) ? XXH3_128bits(data, size) : XXH3_128bits_withSeed(data, size, seed);
+  return Hash128{hash.low64, hash.high64};
+}
+
+FastHash::Hasher64::Hasher64(u64 seed)
+{
+  Reset(seed);
+}
+
+void FastHash::Hasher64::Reset(u64 seed)
+{
+  XXH3_64bits_reset_withSeed(GetState(m_state), seed);
+}
+
+void FastHash::Hasher64::Update(const void* data, size_t size)
+{
+  XXH3_64bits_update(GetState(m_state), data, size);
+}
+
+u64 FastHash::Hasher64::Final() const
+{
+  return XXH3_64bits_digest(GetState(m_state));
+}
+
+FastHash::Hasher128::Hasher128(u64 seed)
+{
+  Reset(seed);
+}
+
+void FastHash::Hasher128::Reset(u64 seed)
+{
+  XXH3_128bits_reset_withSeed(GetState(m_state), seed);
+}
+
+void FastHash::Hasher128::Update(const void* data, size_t size)
+{
+  XXH3_128bits_update(GetState(m_state), data, size);
+}
+
+FastHash::Hash128 FastHash::Hasher128::Final() const
+{
+  const XXH128_hash_t hash = XXH3_128bits_digest(GetState(m_state));
+  return Hash128{hash.low64, hash.high64};
+}
+
+#ifdef HAS_HARDWARE_CRC32C
+
+bool FastHash::DetectHardwareCRC32C()
+{
+#if defined(CPU_ARCH_X64)
+  // SSE4.2, CPUID leaf 1, ECX bit 20.
+#ifdef _MSC_VER
+  int regs[4];
+  __cpuid(regs, 1);
+  return ((static_cast<u32>(regs[2]) & (1u << 20)) != 0);
+#else
+  unsigned int eax, ebx, ecx, edx;
+  return (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & (1u << 20)) != 0);
+#endif
+#elif defined(__ARM_FEATURE_CRC32)
+  return true;
+#elif defined(_WIN32)
+  return IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE);
+#elif defined(__linux__)
+  return ((getauxval(AT_HWCAP) & HWCAP_CRC32) != 0);
+#else
+  return false;
+#endif
+}
+
+u32 FastHash::UpdateCRC32CHardware(const u8* data, size_t size, u32 crc)
+{
+#if defined(CPU_ARCH_X64)
+  u64 crc64 = crc;
+  for (; size >= sizeof(u64); size -= sizeof(u64), data += sizeof(u64))
+  {
+    u64 value;
+    std::memcpy(&value, data, sizeof(value));
+    crc64 = _mm_crc32_u64(crc64, value);
+  }
+
+  crc = static_cast<u32>(crc64);
+  for (; size > 0; size--)
+    crc = _mm_crc32_u8(crc, *(data++));
+#else
+  for (; size >= sizeof(u64); size -= sizeof(u64), data += sizeof(u64))
+  {
+    u64 value;
+    std::memcpy(&value, data, sizeof(value));
+    crc = __crc32cd(crc, value);
+  }
+
+  for (; size > 0; size--)
+    crc = __crc32cb(crc, *(data++));
+#endif
+
+  return crc;
+}
+
+#endif
+
+u32 FastHash::CRC32C(const void* data, size_t size, u32 crc)
+{
+#ifdef HAS_HARDWARE_CRC32C
+  if (s_has_hardware_crc32c) [[likely]]
+    return ~UpdateCRC32CHardware(static_cast<const u8*>(data), size, ~crc);
+#endif
+
+  return CRC32CSoftware(data, size, crc);
+}
+
+u32 FastHash::CRC32CSoftware(const void* data, size_t size, u32 crc)
+{
+  const auto& tables = s_crc32c_tables;
+  const u8* ptr = static_cast<const u8*>(data);
+  crc = ~crc;
+
+  for (; size >= 8; size -= 8, ptr += 8)
+  {
+    u32 low, high;
+    std::memcpy(&low, ptr, sizeof(low));
+    std::memcpy(&high, ptr + 4, sizeof(high));
+    low ^= crc;
+    crc = tables[7][low & 0xFFu] ^ tables[6][(low >> 8) & 0xFFu] ^ tables[5][(low >> 16) & 0xFFu] ^
+          tables[4][low >> 24] ^ tables[3][high & 0xFFu] ^ tables[2][(high >> 8) & 0xFFu] ^
+          tables[1][(high >> 16) & 0xFFu] ^ tables[0][high >> 24];
+  }
+
+  for (; size > 0; size--)
+    crc = (crc >> 8) ^ tables[0][(crc ^ *(ptr++)) & 0xFFu];
+
+  return ~crc;
+}
+
+bool FastHash::HasHardwareCRC32C()
+{
+#ifdef HAS_HARDWARE_CRC32C
+  return s_has_hardware_crc32c;
+#else
+  return false;
+#endif
+}
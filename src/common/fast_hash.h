@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#pragma once
+
+#include "types.h"
+
+#include <cstddef>
+#include <span>
+
+/// Non-cryptographic hashing, for cache keys, change detection and identifying content. Much faster than the digest
+/// classes, but offers no resistance to deliberate collisions, so use SHA256Digest when that matters.
+///
+/// Hashes are XXH3, using the widest vector unit the CPU supports on x86. Results are stable across platforms and
+/// versions, so they can be stored.
+namespace FastHash {
+
+struct Hash128
+{
+  u64 low;
+  u64 high;
+
+  bool operator==(const Hash128& rhs) const = default;
+};
+
+/// Storage for the streaming state, kept opaque so that xxhash.h stays out of the header.
+inline constexpr size_t STATE_SIZE = 576;
+inline constexpr size_t STATE_ALIGNMENT = 64;
+
+u64 Hash64(const void* data, size_t size, u64 seed = 0);
+Hash128 Hash128Bits(const void* data, size_t size, u64 seed = 0);
+
+ALWAYS_INLINE static u64 Hash64(std::span<const u8> data, u64 seed = 0)
+{
+  return Hash64(data.data(), data.size(), seed);
+}
+ALWAYS_INLINE static Hash128 Hash128Bits(std::span<const u8> data, u64 seed = 0)
+{
+  return Hash128Bits(data.data(), data.size(), seed);
+}
+
+/// Streaming XXH3-64. Final() gives the same result as Hash64() over everything passed to Update().
+class Hasher64
+{
+public:
+  explicit Hasher64(u64 seed = 0);
+
+  void Reset(u64 seed = 0);
+  void Update(const void* data, size_t size);
+  void Update(std::span<const u8> data) { Update(data.data(), data.size()); }
+  u64 Final() const;
+
+private:
+  alignas(STATE_ALIGNMENT) u8 m_state[STATE_SIZE];
+};
+
+/// Streaming XXH3-128. Final() gives the same result as Hash128Bits() over everything passed to Update().
+class Hasher128
+{
+public:
+  explicit Hasher128(u64 seed = 0);
+
+  void Reset(u64 seed = 0);
+  void Update(const void* data, size_t size);
+  void Update(std::span<const u8> data) { Update(data.data(), data.size()); }
+  Hash128 Final() const;
+
+private:
+  alignas(STATE_ALIGNMENT) u8 m_state[STATE_SIZE];
+};
+
+/// CRC-32C (Castagnoli), as used by iSCSI/ext4/etc. Pass the previous result as crc to continue a checksum.
+/// Uses the SSE4.2 or ARMv8 CRC instructions when the CPU has them.
+u32 CRC32C(const void* data, size_t size, u32 crc = 0);
+ALWAYS_INLINE static u32 CRC32C(std::span<const u8> data, u32 crc = 0)
+{
+  return CRC32C(data.data(), data.size(), crc);
+}
+
+/// Table-driven CRC-32C, which CRC32C() falls back to without hardware support. Exposed for testing.
+u32 CRC32CSoftware(const void* data, size_t size, u32 crc = 0);
+
+/// Returns true if CRC32C() is using the CPU's CRC instructions.
+bool HasHardwareCRC32C();
+
+} // namespace FastHash
@@ -5,17 +5,22 @@
 #include "assert.h"
 #include "error.h"
 #include "log.h"
+#include "memmap.h"
 #include "path.h"
 #include "string_util.h"
+#include "task_queue.h"
 #include "timer.h"
 
 #include "fmt/format.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstring>
 #include <iterator>
 #include <limits>
+#include <mutex>
 #include <numeric>
 #include <utility>
 
@@ -45,6 +50,9 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
 #endif
 
 LOG_CHANNEL(FileSystem);
@@ -1615,6 +1623,90 @@ std::optional<DynamicHeapArray<u8>> FileSystem::ReadBinaryFile(std::FILE* fp, Er
   return ret;
 }
 
+FileSystem::MappedFile::MappedFile() = default;
+
+FileSystem::MappedFile::MappedFile(MappedFile&& move)
+  : m_data(std::exchange(move.m_data, nullptr)), m_size(std::exchange(move.m_size, 0))
+{
+}
+
+FileSystem::MappedFile::~MappedFile()
+{
+  Unmap();
+}
+
+FileSystem::MappedFile& FileSystem::MappedFile::operator=(MappedFile&& move)
+{
+  if (this != &move)
+  {
+    Unmap();
+    m_data = std::exchange(move.m_data, nullptr);
+    m_size = std::exchange(move.m_size, 0);
+  }
+
+  return *this;
+}
+
+bool FileSystem::MappedFile::Map(std::FILE* fp, Error* error)
+{
+  Unmap();
+
+  const s64 size = FSize64(fp, error);
+  if (size < 0) [[unlikely]]
+    return false;
+
+  if constexpr (sizeof(s64) != sizeof(size_t))
+  {
+    if (size > static_cast<s64>(std::numeric_limits<size_t>::max())) [[unlikely]]
+    {
+      Error::SetStringFmt(error, "File size of {} is too large to map on this platform.", size);
+      return false;
+    }
+  }
+
+  // Zero-length mappings aren't allowed.
+  if (size == 0)
+    return true;
+
+  const void* ptr = MemMap::MapFileReadOnly(fp, static_cast<size_t>(size), error);
+  if (!ptr)
+    return false;
+
+  m_data = static_cast<const u8*>(ptr);
+  m_size = static_cast<size_t>(size);
+  return true;
+}
+
+void FileSystem::MappedFile::Unmap()
+{
+  if (m_data)
+    MemMap::UnmapFile(m_data, m_size);
+
+  m_data = nullptr;
+  m_size = 0;
+}
+
+std::optional<FileSystem::MappedFile> FileSystem::MapBinaryFile(const char* path, Error* error)
+{
+  std::optional<MappedFile> ret;
+
+  ManagedCFilePtr fp = OpenManagedCFile(path, "rb", error);
+  if (!fp)
+    return ret;
+
+  ret = MapBinaryFile(fp.get(), error);
+  return ret;
+}
+
+std::optional<FileSystem::MappedFile> FileSystem::MapBinaryFile(std::FILE* fp, Error* error)
+{
+  std::optional<MappedFile> ret = MappedFile();
+  if (!ret->Map(fp, error))
+    ret.reset();
+
+  return ret;
+}
+
 std::optional<std::string> FileSystem::ReadFileToString(const char* path, Error* error)
 {
   std::optional<std::string> ret;
@@ -1822,6 +1914,144 @@ bool FileSystem::CopyFilePath(const char* source, const char* destination, bool
 #endif
 }
 
+#ifndef __ANDROID__
+
+namespace {
+struct ParallelFindState
+{
+  // Directory reads and stats are mostly waiting on the filesystem, so use more threads than there are cores.
+  static constexpr u32 NUM_WORKERS = 8;
+
+  // Number of entries stat'ed by each task.
+  static constexpr u32 STAT_BATCH_SIZE = 64;
+
+  const char* origin_path;
+  const char* pattern;
+  u32 flags;
+  bool has_wildcards;
+  bool wildcard_match_all;
+
+  TaskQueue queue;
+  std::atomic_bool cancelled{false};
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<FILESYSTEM_FIND_DATA> results;
+  u32 outstanding_tasks = 0;
+
+  std::mutex visited_mutex;
+  std::vector<std::string> visited;
+};
+} // namespace
+
+static void FindFilesInDirectory(ParallelFindState& state, std::string relative_dir);
+
+static bool MatchFindPattern(const ParallelFindState& state, const char* filename)
+{
+  if (state.has_wildcards)
+    return (state.wildcard_match_all || StringUtil::WildcardMatch(filename, state.pattern));
+  else
+    return (std::strcmp(filename, state.pattern) == 0);
+}
+
+static void PushFindResults(ParallelFindState& state, std::vector<FILESYSTEM_FIND_DATA>& results, bool task_done)
+{
+  {
+    std::unique_lock lock(state.mutex);
+    if (!state.cancelled.load(std::memory_order_relaxed))
+      std::move(results.begin(), results.end(), std::back_inserter(state.results));
+    if (task_done)
+      state.outstanding_tasks--;
+  }
+
+  results.clear();
+  state.cv.notify_one();
+}
+
+static void QueueFindTask(ParallelFindState& state, TaskQueue::Task task)
+{
+  {
+    std::unique_lock lock(state.mutex);
+    state.outstanding_tasks++;
+  }
+
+  state.queue.SubmitTask(std::move(task));
+}
+
+static void QueueFindDirectory(ParallelFindState& state, const std::string& full_path, std::string relative_dir)
+{
+  // check that we're not following an infinite symbolic link loop
+  if (std::string real_dir = Path::RealPath(full_path); !real_dir.empty())
+  {
+    std::unique_lock lock(state.visited_mutex);
+    if (std::find(state.visited.begin(), state.visited.end(), real_dir) != state.visited.end())
+      return;
+
+    state.visited.push_back(std::move(real_dir));
+  }
+
+  QueueFindTask(state, [&state, relative_dir = std::move(relative_dir)]() mutable {
+    FindFilesInDirectory(state, std::move(relative_dir));
+  });
+}
+
+bool FileSystem::EnumerateFiles(const char* path, const char* pattern, u32 flags, const FindFilesCallback& callback)
+{
+  ParallelFindState state;
+  state.origin_path = path;
+  state.pattern = pattern;
+  state.flags = flags;
+  state.has_wildcards = (std::strpbrk(pattern, "*?") != nullptr);
+  state.wildcard_match_all = (std::strcmp(pattern, "*") == 0);
+  state.queue.SetWorkerCount(ParallelFindState::NUM_WORKERS);
+
+  // add self if recursive, we don't want to visit it twice
+  if (flags & FILESYSTEM_FIND_RECURSIVE)
+  {
+    std::string real_path = Path::RealPath(path);
+    if (!real_path.empty())
+      state.visited.push_back(std::move(real_path));
+  }
+
+  QueueFindTask(state, [&state]() { FindFilesInDirectory(state, std::string()); });
+
+  // Hand results over as they arrive, so the caller can work while the rest of the tree is still being read.
+  bool found_any = false;
+  std::vector<FILESYSTEM_FIND_DATA> batch;
+  std::unique_lock lock(state.mutex);
+  for (;;)
+  {
+    state.cv.wait(lock, [&state]() { return (!state.results.empty() || state.outstanding_tasks == 0); });
+    if (state.results.empty())
+      break;
+
+    batch.swap(state.results);
+    lock.unlock();
+
+    for (FILESYSTEM_FIND_DATA& fd : batch)
+    {
+      found_any = true;
+      if (!callback(fd))
+      {
+        // Let anything in flight finish, but don't start any more work.
+        state.cancelled.store(true, std::memory_order_relaxed);
+        break;
+      }
+    }
+    batch.clear();
+
+    lock.lock();
+    if (state.cancelled.load(std::memory_order_relaxed))
+      state.results.clear();
+  }
+  lock.unlock();
+
+  state.queue.WaitForAll();
+  return found_any;
+}
+
+#endif // __ANDROID__
+
 #ifdef _WIN32
 
 static u32 TranslateWin32Attributes(u32 w32attrs)
@@ -2006,6 +2236,80 @@ bool FileSystem::FindFiles(const char* path, const char* pattern, u32 flags, Fin
   return true;
 }
 
+static void FindFilesInDirectory(ParallelFindState& state, std::string relative_dir)
+{
+  // Results are handed over in chunks, so that huge directories still stream.
+  static constexpr size_t PUSH_BATCH_SIZE = 256;
+
+  std::vector<FILESYSTEM_FIND_DATA> results;
+  if (state.cancelled.load(std::memory_order_relaxed))
+  {
+    PushFindResults(state, results, true);
+    return;
+  }
+
+  const std::string dir_path =
+    relative_dir.empty() ? std::string(state.origin_path) : fmt::format("{}\\{}", state.origin_path, relative_dir);
+
+  // Basic info skips looking up short names, and large fetch reads more entries per call, which makes a big
+  // difference on network shares.
+  WIN32_FIND_DATAW wfd;
+  const HANDLE hFind =
+    FindFirstFileExW(FileSystem::GetWin32Path(fmt::format("{}\\*", dir_path)).c_str(), FindExInfoBasic, &wfd,
+                     FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+  if (hFind != INVALID_HANDLE_VALUE)
+  {
+    std::string utf8_filename;
+    do
+    {
+      if (wfd.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN && !(state.flags & FILESYSTEM_FIND_HIDDEN_FILES))
+        continue;
+
+      if (wfd.cFileName[0] == L'.')
+      {
+        if (wfd.cFileName[1] == L'\0' || (wfd.cFileName[1] == L'.' && wfd.cFileName[2] == L'\0'))
+          continue;
+      }
+
+      if (!StringUtil::WideStringToUTF8String(utf8_filename, wfd.cFileName))
+        continue;
+
+      std::string full_path = fmt::format("{}\\{}", dir_path, utf8_filename);
+      std::string relative_path =
+        relative_dir.empty() ? utf8_filename : fmt::format("{}\\{}", relative_dir, utf8_filename);
+
+      if (wfd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+      {
+        if (state.flags & FILESYSTEM_FIND_RECURSIVE)
+          QueueFindDirectory(state, full_path, relative_path);
+
+        if (!(state.flags & FILESYSTEM_FIND_FOLDERS))
+          continue;
+      }
+      else
+      {
+        if (!(state.flags & FILESYSTEM_FIND_FILES))
+          continue;
+      }
+
+      if (!MatchFindPattern(state, utf8_filename.c_str()))
+        continue;
+
+      FILESYSTEM_FIND_DATA& fd = results.emplace_back();
+      fd.FileName = (state.flags & FILESYSTEM_FIND_RELATIVE_PATHS) ? std::move(relative_path) : std::move(full_path);
+      fd.Attributes = TranslateWin32Attributes(wfd.dwFileAttributes);
+      fd.CreationTime = ConvertFileTimeToUnixTime(wfd.ftCreationTime);
+      fd.ModificationTime = ConvertFileTimeToUnixTime(wfd.ftLastWriteTime);
+      fd.Size = (static_cast<u64>(wfd.nFileSizeHigh) << 32) | static_cast<u64>(wfd.nFileSizeLow);
+      if (results.size() >= PUSH_BATCH_SIZE)
+        PushFindResults(state, results, false);
+    } while (!state.cancelled.load(std::memory_order_relaxed) && FindNextFileW(hFind, &wfd) == TRUE);
+    FindClose(hFind);
+  }
+
+  PushFindResults(state, results, true);
+}
+
 static void TranslateStat64(struct stat* st, const struct _stat64& st64)
 {
   static constexpr __int64 MAX_SIZE = static_cast<__int64>(std::numeric_limits<decltype(st->st_size)>::max());
@@ -2620,6 +2924,187 @@ bool FileSystem::FindFiles(const char* path, const char* pattern, u32 flags, Fin
   return true;
 }
 
+namespace {
+struct FindDirectoryEntry
+{
+  std::string name;
+  u8 type;
+};
+
+/// Shared by the tasks stat'ing a directory's entries, the handle is closed once they're all done.
+struct FindDirectory
+{
+  int fd = -1;
+  std::string full_path;
+  std::string relative_dir;
+  std::vector<FindDirectoryEntry> entries;
+
+  ~FindDirectory()
+  {
+    if (fd >= 0)
+      close(fd);
+  }
+};
+} // namespace
+
+static bool ReadFindDirectoryEntries(const ParallelFindState& state, FindDirectory& dir)
+{
+  const auto add_entry = [&state, &dir](const char* name, u8 type) {
+    if (name[0] == '.')
+    {
+      if (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))
+        return;
+
+      if (!(state.flags & FILESYSTEM_FIND_HIDDEN_FILES))
+        return;
+    }
+
+    dir.entries.push_back(FindDirectoryEntry{name, type});
+  };
+
+#ifdef __linux__
+  // Use getdents64() directly, with a much larger buffer than readdir() uses. Fewer calls means fewer round trips
+  // on network filesystems.
+  struct linux_dirent64
+  {
+    u64 d_ino;
+    s64 d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+  };
+
+  static constexpr size_t BUFFER_SIZE = 256 * 1024;
+  const std::unique_ptr<u8[]> buffer = std::make_unique<u8[]>(BUFFER_SIZE);
+  for (;;)
+  {
+    const long bytes = syscall(SYS_getdents64, dir.fd, buffer.get(), BUFFER_SIZE);
+    if (bytes <= 0)
+      return (bytes == 0);
+
+    for (long pos = 0; pos < bytes;)
+    {
+      const linux_dirent64* de = reinterpret_cast<const linux_dirent64*>(buffer.get() + pos);
+      add_entry(de->d_name, de->d_type);
+      pos += de->d_reclen;
+    }
+  }
+#else
+  // fdopendir() takes ownership of the descriptor, but we still need ours for fstatat().
+  const int dup_fd = dup(dir.fd);
+  DIR* const pDir = (dup_fd >= 0) ? fdopendir(dup_fd) : nullptr;
+  if (!pDir)
+  {
+    if (dup_fd >= 0)
+      close(dup_fd);
+    return false;
+  }
+
+  struct dirent* pDirEnt;
+  while ((pDirEnt = readdir(pDir)) != nullptr)
+    add_entry(pDirEnt->d_name, pDirEnt->d_type);
+
+  closedir(pDir);
+  return true;
+#endif
+}
+
+static void StatFindDirectoryEntries(ParallelFindState& state, const FindDirectory& dir, size_t start, size_t end)
+{
+  std::vector<FILESYSTEM_FIND_DATA> results;
+  for (size_t i = start; i < end && !state.cancelled.load(std::memory_order_relaxed); i++)
+  {
+    const FindDirectoryEntry& entry = dir.entries[i];
+    const u32 flags = state.flags;
+
+    // Skip the stat entirely when the type alone tells us the entry isn't wanted.
+    if (entry.type == DT_REG && (!(flags & FILESYSTEM_FIND_FILES) || !MatchFindPattern(state, entry.name.c_str())))
+      continue;
+
+    std::string full_path = fmt::format("{}/{}", dir.full_path, entry.name);
+    std::string relative_path =
+      dir.relative_dir.empty() ? entry.name : fmt::format("{}/{}", dir.relative_dir, entry.name);
+    if (entry.type == DT_DIR && !(flags & FILESYSTEM_FIND_FOLDERS))
+    {
+      if (flags & FILESYSTEM_FIND_RECURSIVE)
+        QueueFindDirectory(state, full_path, std::move(relative_path));
+      continue;
+    }
+
+    struct stat st;
+    bool is_link = (entry.type == DT_LNK);
+    if (entry.type == DT_UNKNOWN)
+    {
+      if (fstatat(dir.fd, entry.name.c_str(), &st, AT_SYMLINK_NOFOLLOW) < 0)
+        continue;
+
+      is_link = S_ISLNK(st.st_mode);
+      if (is_link && fstatat(dir.fd, entry.name.c_str(), &st, 0) < 0)
+        continue;
+    }
+    else if (fstatat(dir.fd, entry.name.c_str(), &st, 0) < 0)
+    {
+      continue;
+    }
+
+    if (S_ISDIR(st.st_mode))
+    {
+      if (flags & FILESYSTEM_FIND_RECURSIVE)
+        QueueFindDirectory(state, full_path, relative_path);
+
+      if (!(flags & FILESYSTEM_FIND_FOLDERS))
+        continue;
+    }
+    else
+    {
+      if (!(flags & FILESYSTEM_FIND_FILES))
+        continue;
+    }
+
+    if (!MatchFindPattern(state, entry.name.c_str()))
+      continue;
+
+    FILESYSTEM_FIND_DATA& fd = results.emplace_back();
+    fd.FileName = (flags & FILESYSTEM_FIND_RELATIVE_PATHS) ? std::move(relative_path) : std::move(full_path);
+    fd.Attributes = (S_ISDIR(st.st_mode) ? FILESYSTEM_FILE_ATTRIBUTE_DIRECTORY : 0) |
+                    (is_link ? FILESYSTEM_FILE_ATTRIBUTE_LINK : 0);
+    fd.Size = static_cast<u64>(st.st_size);
+    fd.CreationTime = st.st_ctime;
+    fd.ModificationTime = st.st_mtime;
+  }
+
+  PushFindResults(state, results, true);
+}
+
+static void FindFilesInDirectory(ParallelFindState& state, std::string relative_dir)
+{
+  std::shared_ptr<FindDirectory> dir = std::make_shared<FindDirectory>();
+  dir->full_path =
+    relative_dir.empty() ? std::string(state.origin_path) : fmt::format("{}/{}", state.origin_path, relative_dir);
+  dir->relative_dir = std::move(relative_dir);
+  if (state.cancelled.load(std::memory_order_relaxed) ||
+      (dir->fd = open(dir->full_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)) < 0 ||
+      !ReadFindDirectoryEntries(state, *dir))
+  {
+    std::vector<FILESYSTEM_FIND_DATA> no_results;
+    PushFindResults(state, no_results, true);
+    return;
+  }
+
+  // Spread the stats over the pool, so that large flat directories don't stall on one thread. The last batch is
+  // done here, and completes this task.
+  const size_t count = dir->entries.size();
+  size_t start = 0;
+  for (; (count - start) > ParallelFindState::STAT_BATCH_SIZE; start += ParallelFindState::STAT_BATCH_SIZE)
+  {
+    QueueFindTask(state, [&state, dir, start]() {
+      StatFindDirectoryEntries(state, *dir, start, start + ParallelFindState::STAT_BATCH_SIZE);
+    });
+  }
+
+  StatFindDirectoryEntries(state, *dir, start, count);
+}
+
 bool FileSystem::StatFile(const char* path, struct stat* st, Error* error)
 {
   if (stat(path, st) != 0)
@@ -8,10 +8,12 @@
 
 #include <cstdio>
 #include <ctime>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <span>
 #include <string>
+#include <string_view>
 #include <sys/stat.h>
 #include <vector>
 
@@ -65,6 +67,14 @@ std::vector<std::string> GetRootDirectoryList();
 /// Search for files
 bool FindFiles(const char* path, const char* pattern, u32 flags, FindResultsArray* results);
 
+/// Callback for EnumerateFiles(). Return false to stop the search.
+using FindFilesCallback = std::function<bool(FILESYSTEM_FIND_DATA& data)>;
+
+/// Search for files, reading directories and stat'ing entries on several threads. Results are passed to the callback
+/// on the calling thread as soon as they're found, in no particular order, so FILESYSTEM_FIND_SORT_BY_NAME and
+/// FILESYSTEM_FIND_KEEP_ARRAY have no effect. Returns false if nothing was found.
+bool EnumerateFiles(const char* path, const char* pattern, u32 flags, const FindFilesCallback& callback);
+
 /// Stat file
 bool StatFile(const char* path, struct stat* st, Error* error = nullptr);
 bool StatFile(std::FILE* fp, struct stat* st, Error* error = nullptr);
@@ -220,6 +230,42 @@ std::optional<DynamicHeapArray<u8>> ReadBinaryFile(const char* path, Error* erro
 std::optional<DynamicHeapArray<u8>> ReadBinaryFile(std::FILE* fp, Error* error = nullptr);
 std::optional<std::string> ReadFileToString(const char* path, Error* error = nullptr);
 std::optional<std::string> ReadFileToString(std::FILE* fp, Error* error = nullptr);
+/// Read-only view of a whole file, backed by a memory mapping instead of a copy in a heap buffer. Pages are only read
+/// in when they're touched, and the view remains valid after the file has been closed. Empty files aren't mapped, and
+/// give an empty view.
+class MappedFile
+{
+public:
+  MappedFile();
+  MappedFile(MappedFile&& move);
+  MappedFile(const MappedFile&) = delete;
+  ~MappedFile();
+
+  MappedFile& operator=(MappedFile&& move);
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ALWAYS_INLINE const u8* data() const { return m_data; }
+  ALWAYS_INLINE size_t size() const { return m_size; }
+  ALWAYS_INLINE bool empty() const { return (m_size == 0); }
+  ALWAYS_INLINE std::span<const u8> cspan() const { return std::span<const u8>(m_data, m_size); }
+  ALWAYS_INLINE std::string_view cview() const
+  {
+    return std::string_view(reinterpret_cast<const char*>(m_data), m_size);
+  }
+
+  /// Maps the whole of an open file, replacing any existing mapping.
+  bool Map(std::FILE* fp, Error* error);
+  void Unmap();
+
+private:
+  const u8* m_data = nullptr;
+  size_t m_size = 0;
+};
+
+/// Alternatives to ReadBinaryFile() for data which is only parsed, avoiding the copy.
+std::optional<MappedFile> MapBinaryFile(const char* path, Error* error = nullptr);
+std::optional<MappedFile> MapBinaryFile(std::FILE* fp, Error* error = nullptr);
+
 bool WriteBinaryFile(const char* path, const void* data, size_t data_length, Error* error = nullptr);
 bool WriteBinaryFile(const char* path, const std::span<const u8> data, Error* error = nullptr);
 bool WriteStringToFile(const char* path, std::string_view sv, Error* error = nullptr);
@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "frame_arena.h"
+#include "assert.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+// Allocations bigger than this get their own block, so that they don't waste the rest of a regular one.
+static constexpr size_t LARGE_ALLOCATION_THRESHOLD = FrameArena::BLOCK_SIZE / 4;
+
+FrameArena::FrameArena() = default;
+
+FrameArena::~FrameArena() = default;
+
+FrameArena& FrameArena::GetForCurrentThread()
+{
+  static thread_local FrameArena arena;
+  return arena;
+}
+
+void* FrameArena::AllocateSlow(size_t size, size_t alignment)
+{
+  DebugAssert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+  const size_t padded_size = std::max<size_t>(size, 1) + alignment - 1;
+  if (padded_size > LARGE_ALLOCATION_THRESHOLD)
+  {
+    Block& block = m_large_blocks.emplace_back(Block{std::make_unique_for_overwrite<u8[]>(padded_size), padded_size});
+    m_bytes_used += padded_size;
+    return reinterpret_cast<u8*>(Common::AlignUpPow2(reinterpret_cast<uintptr_t>(block.data.get()),
+                                                     static_cast<unsigned int>(alignment)));
+  }
+
+  // Account for the unused tail of the previous block, it's gone until the next reset.
+  m_bytes_used += static_cast<size_t>(m_end - m_current);
+
+  if (m_next_block == m_blocks.size())
+    m_blocks.emplace_back(Block{std::make_unique_for_overwrite<u8[]>(BLOCK_SIZE), BLOCK_SIZE});
+
+  Block& block = m_blocks[m_next_block++];
+  m_current = block.data.get();
+  m_end = m_current + block.size;
+
+  // Fresh block, so this can't fail.
+  return Allocate(size, alignment);
+}
+
+std::string_view FrameArena::CopyString(std::string_view str)
+{
+  char* const ptr = AllocateArray<char>(str.length() + 1);
+  if (!str.empty())
+    std::memcpy(ptr, str.data(), str.length());
+  ptr[str.length()] = '\0';
+  return std::string_view(ptr, str.length());
+}
+
+std::string_view FrameArena::VFormat(fmt::string_view fmt, fmt::format_args args)
+{
+  // Format to the stack first, we only know how much to allocate afterwards.
+  fmt::memory_buffer buffer;
+  fmt::vformat_to(std::back_inserter(buffer), fmt, args);
+  return CopyString(std::string_view(buffer.data(), buffer.size()));
+}
+
+void FrameArena::Reset()
+{
+  m_peak_bytes_used = std::max(m_peak_bytes_used, m_bytes_used);
+  m_bytes_used = 0;
+
+#ifdef _DEBUG
+  // Catch anything still holding on to last frame's allocations.
+  for (size_t i = 0; i < m_next_block; i++)
+    std::memset(m_blocks[i].data.get(), 0xCD, m_blocks[i].size);
+#endif
+
+  m_large_blocks.clear();
+  m_next_block = 0;
+  m_current = nullptr;
+  m_end = nullptr;
+}
@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#pragma once
+
+#include "align.h"
+#include "types.h"
+
+#include "fmt/format.h"
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/// Bump allocator for short-lived allocations, which are all released at once when the arena is reset.
+///
+/// Each thread with a frame loop owns one arena, which it resets once per frame, so anything allocated from it is
+/// only valid until the end of the frame it was allocated in. Memory is taken from a list of blocks which are kept
+/// across resets, so once the arena has grown to the frame's working set, allocating is just a pointer bump.
+class FrameArena
+{
+public:
+  static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+  FrameArena();
+  ~FrameArena();
+
+  FrameArena(const FrameArena&) = delete;
+  FrameArena& operator=(const FrameArena&) = delete;
+
+  /// Returns the arena for the calling thread.
+  static FrameArena& GetForCurrentThread();
+
+  /// Returns the number of bytes allocated since the last reset, and the most that was allocated in any one frame.
+  size_t GetBytesUsed() const { return m_bytes_used; }
+  size_t GetPeakBytesUsed() const { return m_peak_bytes_used; }
+
+  /// Allocates uninitialized memory. Never returns null. Alignment must be a power of two.
+  ALWAYS_INLINE void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+  {
+    u8* const ptr = reinterpret_cast<u8*>(
+      Common::AlignUpPow2(reinterpret_cast<uintptr_t>(m_current), static_cast<unsigned int>(alignment)));
+    if (!m_current || ptr > m_end || size > static_cast<size_t>(m_end - ptr)) [[unlikely]]
+      return AllocateSlow(size, alignment);
+
+    m_bytes_used += static_cast<size_t>(ptr + size - m_current);
+    m_current = ptr + size;
+    return ptr;
+  }
+
+  /// Allocates uninitialized storage for count objects of type T. No constructors are run, nor destructors later.
+  template<typename T>
+  T* AllocateArray(size_t count)
+  {
+    static_assert(std::is_trivially_destructible_v<T>, "Arena objects are never destroyed");
+    return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+  }
+
+  /// Copies a string into the arena. The copy is null-terminated, for passing to C APIs.
+  std::string_view CopyString(std::string_view str);
+
+  /// Formats a string into the arena. The result is null-terminated.
+  template<typename... T>
+  std::string_view Format(fmt::format_string<T...> fmt, T&&... args)
+  {
+    return VFormat(fmt, fmt::make_format_args(args...));
+  }
+  std::string_view VFormat(fmt::string_view fmt, fmt::format_args args);
+
+  /// Releases everything allocated since the last reset. Oversized allocations are freed, regular blocks are kept.
+  void Reset();
+
+private:
+  struct Block
+  {
+    std::unique_ptr<u8[]> data;
+    size_t size;
+  };
+
+  void* AllocateSlow(size_t size, size_t alignment);
+
+  u8* m_current = nullptr;
+  u8* m_end = nullptr;
+  size_t m_next_block = 0;
+  size_t m_bytes_used = 0;
+  size_t m_peak_bytes_used = 0;
+
+  std::vector<Block> m_blocks;
+  std::vector<Block> m_large_blocks;
+};
+
+/// Standard allocator over the calling thread's frame arena. Deallocation is a no-op, so containers using it must not
+/// outlive the frame, and shouldn't be grown repeatedly, since old storage isn't reused until the arena is reset.
+template<typename T>
+class FrameAllocator
+{
+public:
+  using value_type = T;
+
+  FrameAllocator() noexcept : m_arena(&FrameArena::GetForCurrentThread()) {}
+  explicit FrameAllocator(FrameArena& arena) noexcept : m_arena(&arena) {}
+
+  template<typename U>
+  FrameAllocator(const FrameAllocator<U>& other) noexcept : m_arena(other.GetArena())
+  {
+  }
+
+  FrameArena* GetArena() const noexcept { return m_arena; }
+
+  T* allocate(size_t count) { return static_cast<T*>(m_arena->Allocate(sizeof(T) * count, alignof(T))); }
+  void deallocate(T*, size_t) noexcept {}
+
+  template<typename U>
+  bool operator==(const FrameAllocator<U>& rhs) const noexcept
+  {
+    return (m_arena == rhs.GetArena());
+  }
+
+private:
+  FrameArena* m_arena;
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
@@ -1910,6 +1910,11 @@ public:
 
   ALWAYS_INLINE GSVector4i add32(const GSVector4i& v) const { return GSVector4i(vaddq_s32(v4s, v.v4s)); }
 
+  ALWAYS_INLINE GSVector4i add64(const GSVector4i& v) const
+  {
+    return GSVector4i(vreinterpretq_s32_s64(vaddq_s64(vreinterpretq_s64_s32(v4s), vreinterpretq_s64_s32(v.v4s))));
+  }
+
   ALWAYS_INLINE GSVector4i adds8(const GSVector4i& v) const
   {
     return GSVector4i(vreinterpretq_s32_s8(vqaddq_s8(vreinterpretq_s8_s32(v4s), vreinterpretq_s8_s32(v.v4s))));
@@ -3417,3 +3422,492 @@ ALWAYS_INLINE GSVector4 GSVector4::cast(const GSVector4i& v)
 {
   return GSVector4(vreinterpretq_f32_s32(v.v4s));
 }
+
+// 256-bit integer vector, emulated with a pair of 128-bit vectors. Byte shifts, shuffles, packs and unpacks operate
+// on each 128-bit half independently, matching the AVX2 implementation.
+
+#define UNARY_HALVES(op) return GSVector8i(low128().op, high128().op)
+#define BINARY_HALVES(op) return GSVector8i(low128().op(v.low128()), high128().op(v.high128()))
+
+class alignas(32) GSVector8i
+{
+  struct cxpr_init_tag
+  {
+  };
+  static constexpr cxpr_init_tag cxpr_init{};
+
+  constexpr GSVector8i(cxpr_init_tag, s32 x0, s32 y0, s32 z0, s32 w0, s32 x1, s32 y1, s32 z1, s32 w1)
+    : S32{x0, y0, z0, w0, x1, y1, z1, w1}
+  {
+  }
+
+  constexpr GSVector8i(cxpr_init_tag, s16 s0, s16 s1, s16 s2, s16 s3, s16 s4, s16 s5, s16 s6, s16 s7, s16 s8, s16 s9,
+                       s16 s10, s16 s11, s16 s12, s16 s13, s16 s14, s16 s15)
+    : S16{s0, s1, s2, s3, s4, s5, s6, s7, s8, s9, s10, s11, s12, s13, s14, s15}
+  {
+  }
+
+public:
+  union
+  {
+    struct
+    {
+      s32 x0, y0, z0, w0, x1, y1, z1, w1;
+    };
+    struct
+    {
+      s32 r0, g0, b0, a0, r1, g1, b1, a1;
+    };
+
+    float F32[8];
+    s8 S8[32];
+    s16 S16[16];
+    s32 S32[8];
+    s64 S64[4];
+    u8 U8[32];
+    u16 U16[16];
+    u32 U32[8];
+    u64 U64[4];
+    int32x4_t v4s[2];
+  };
+
+  GSVector8i() = default;
+
+  ALWAYS_INLINE constexpr static GSVector8i cxpr(s32 x0, s32 y0, s32 z0, s32 w0, s32 x1, s32 y1, s32 z1, s32 w1)
+  {
+    return GSVector8i(cxpr_init, x0, y0, z0, w0, x1, y1, z1, w1);
+  }
+  ALWAYS_INLINE constexpr static GSVector8i cxpr(s32 x) { return GSVector8i(cxpr_init, x, x, x, x, x, x, x, x); }
+
+  ALWAYS_INLINE constexpr static GSVector8i cxpr16(s16 x)
+  {
+    return GSVector8i(cxpr_init, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x);
+  }
+  ALWAYS_INLINE constexpr static GSVector8i cxpr16(s16 s0, s16 s1, s16 s2, s16 s3, s16 s4, s16 s5, s16 s6, s16 s7,
+                                                   s16 s8, s16 s9, s16 s10, s16 s11, s16 s12, s16 s13, s16 s14, s16 s15)
+  {
+    return GSVector8i(cxpr_init, s0, s1, s2, s3, s4, s5, s6, s7, s8, s9, s10, s11, s12, s13, s14, s15);
+  }
+
+  ALWAYS_INLINE explicit GSVector8i(s32 i) { *this = i; }
+
+  ALWAYS_INLINE GSVector8i(const GSVector4i& lo, const GSVector4i& hi) : v4s{lo.v4s, hi.v4s} {}
+
+  ALWAYS_INLINE GSVector8i& operator=(s32 i)
+  {
+    const GSVector4i v(i);
+    *this = GSVector8i(v, v);
+    return *this;
+  }
+
+  ALWAYS_INLINE GSVector8i min_s8(const GSVector8i& v) const { BINARY_HALVES(min_s8); }
+  ALWAYS_INLINE GSVector8i max_s8(const GSVector8i& v) const { BINARY_HALVES(max_s8); }
+  ALWAYS_INLINE GSVector8i min_s16(const GSVector8i& v) const { BINARY_HALVES(min_s16); }
+  ALWAYS_INLINE GSVector8i max_s16(const GSVector8i& v) const { BINARY_HALVES(max_s16); }
+  ALWAYS_INLINE GSVector8i min_s32(const GSVector8i& v) const { BINARY_HALVES(min_s32); }
+  ALWAYS_INLINE GSVector8i max_s32(const GSVector8i& v) const { BINARY_HALVES(max_s32); }
+
+  ALWAYS_INLINE GSVector8i min_u8(const GSVector8i& v) const { BINARY_HALVES(min_u8); }
+  ALWAYS_INLINE GSVector8i max_u8(const GSVector8i& v) const { BINARY_HALVES(max_u8); }
+  ALWAYS_INLINE GSVector8i min_u16(const GSVector8i& v) const { BINARY_HALVES(min_u16); }
+  ALWAYS_INLINE GSVector8i max_u16(const GSVector8i& v) const { BINARY_HALVES(max_u16); }
+  ALWAYS_INLINE GSVector8i min_u32(const GSVector8i& v) const { BINARY_HALVES(min_u32); }
+  ALWAYS_INLINE GSVector8i max_u32(const GSVector8i& v) const { BINARY_HALVES(max_u32); }
+
+  ALWAYS_INLINE GSVector8i madd_s16(const GSVector8i& v) const { BINARY_HALVES(madd_s16); }
+
+  ALWAYS_INLINE GSVector8i clamp8() const { return pu16().upl8(); }
+
+  ALWAYS_INLINE GSVector8i blend8(const GSVector8i& v, const GSVector8i& mask) const
+  {
+    return GSVector8i(low128().blend8(v.low128(), mask.low128()), high128().blend8(v.high128(), mask.high128()));
+  }
+
+  template<s32 mask>
+  ALWAYS_INLINE GSVector8i blend16(const GSVector8i& v) const
+  {
+    BINARY_HALVES(template blend16<mask>);
+  }
+
+  template<s32 mask>
+  ALWAYS_INLINE GSVector8i blend32(const GSVector8i& v) const
+  {
+    return GSVector8i(low128().template blend32<mask & 0xF>(v.low128()),
+                      high128().template blend32<(mask >> 4) & 0xF>(v.high128()));
+  }
+
+  ALWAYS_INLINE GSVector8i blend(const GSVector8i& v, const GSVector8i& mask) const
+  {
+    return GSVector8i(low128().blend(v.low128(), mask.low128()), high128().blend(v.high128(), mask.high128()));
+  }
+
+  ALWAYS_INLINE GSVector8i shuffle8(const GSVector8i& mask) const
+  {
+    return GSVector8i(low128().shuffle8(mask.low128()), high128().shuffle8(mask.high128()));
+  }
+
+  ALWAYS_INLINE GSVector8i ps16(const GSVector8i& v) const { BINARY_HALVES(ps16); }
+  ALWAYS_INLINE GSVector8i ps16() const { UNARY_HALVES(ps16()); }
+  ALWAYS_INLINE GSVector8i pu16(const GSVector8i& v) const { BINARY_HALVES(pu16); }
+  ALWAYS_INLINE GSVector8i pu16() const { UNARY_HALVES(pu16()); }
+  ALWAYS_INLINE GSVector8i ps32(const GSVector8i& v) const { BINARY_HALVES(ps32); }
+  ALWAYS_INLINE GSVector8i ps32() const { UNARY_HALVES(ps32()); }
+  ALWAYS_INLINE GSVector8i pu32(const GSVector8i& v) const { BINARY_HALVES(pu32); }
+  ALWAYS_INLINE GSVector8i pu32() const { UNARY_HALVES(pu32()); }
+
+  ALWAYS_INLINE GSVector8i upl8(const GSVector8i& v) const { BINARY_HALVES(upl8); }
+  ALWAYS_INLINE GSVector8i uph8(const GSVector8i& v) const { BINARY_HALVES(uph8); }
+  ALWAYS_INLINE GSVector8i upl16(const GSVector8i& v) const { BINARY_HALVES(upl16); }
+  ALWAYS_INLINE GSVector8i uph16(const GSVector8i& v) const { BINARY_HALVES(uph16); }
+  ALWAYS_INLINE GSVector8i upl32(const GSVector8i& v) const { BINARY_HALVES(upl32); }
+  ALWAYS_INLINE GSVector8i uph32(const GSVector8i& v) const { BINARY_HALVES(uph32); }
+  ALWAYS_INLINE GSVector8i upl64(const GSVector8i& v) const { BINARY_HALVES(upl64); }
+  ALWAYS_INLINE GSVector8i uph64(const GSVector8i& v) const { BINARY_HALVES(uph64); }
+
+  ALWAYS_INLINE GSVector8i upl8() const { UNARY_HALVES(upl8()); }
+  ALWAYS_INLINE GSVector8i uph8() const { UNARY_HALVES(uph8()); }
+
+  ALWAYS_INLINE GSVector8i upl16() const { UNARY_HALVES(upl16()); }
+  ALWAYS_INLINE GSVector8i uph16() const { UNARY_HALVES(uph16()); }
+
+  ALWAYS_INLINE GSVector8i upl32() const { UNARY_HALVES(upl32()); }
+
+  ALWAYS_INLINE GSVector8i uph32() const { UNARY_HALVES(uph32()); }
+  ALWAYS_INLINE GSVector8i upl64() const { UNARY_HALVES(upl64()); }
+  ALWAYS_INLINE GSVector8i uph64() const { UNARY_HALVES(uph64()); }
+
+  // Widening conversions read from the low 128 bits, like their AVX2 counterparts.
+  ALWAYS_INLINE GSVector8i s8to16() const { return s8to16(low128()); }
+  ALWAYS_INLINE GSVector8i s8to32() const { return s8to32(low128()); }
+  ALWAYS_INLINE GSVector8i s8to64() const { return s8to64(low128()); }
+
+  ALWAYS_INLINE GSVector8i s16to32() const { return s16to32(low128()); }
+  ALWAYS_INLINE GSVector8i s16to64() const { return s16to64(low128()); }
+  ALWAYS_INLINE GSVector8i s32to64() const { return s32to64(low128()); }
+  ALWAYS_INLINE GSVector8i u8to16() const { return u8to16(low128()); }
+  ALWAYS_INLINE GSVector8i u8to32() const { return u8to32(low128()); }
+  ALWAYS_INLINE GSVector8i u8to64() const { return u8to64(low128()); }
+  ALWAYS_INLINE GSVector8i u16to32() const { return u16to32(low128()); }
+  ALWAYS_INLINE GSVector8i u16to64() const { return u16to64(low128()); }
+  ALWAYS_INLINE GSVector8i u32to64() const { return u32to64(low128()); }
+
+  ALWAYS_INLINE static GSVector8i s8to16(const GSVector4i& v) { return GSVector8i(v.s8to16(), v.srl<8>().s8to16()); }
+  ALWAYS_INLINE static GSVector8i s8to32(const GSVector4i& v) { return GSVector8i(v.s8to32(), v.srl<4>().s8to32()); }
+  ALWAYS_INLINE static GSVector8i s8to64(const GSVector4i& v) { return GSVector8i(v.s8to64(), v.srl<2>().s8to64()); }
+
+  ALWAYS_INLINE static GSVector8i s16to32(const GSVector4i& v) { return GSVector8i(v.s16to32(), v.srl<8>().s16to32()); }
+  ALWAYS_INLINE static GSVector8i s16to64(const GSVector4i& v) { return GSVector8i(v.s16to64(), v.srl<4>().s16to64()); }
+  ALWAYS_INLINE static GSVector8i s32to64(const GSVector4i& v) { return GSVector8i(v.s32to64(), v.srl<8>().s32to64()); }
+  ALWAYS_INLINE static GSVector8i u8to16(const GSVector4i& v) { return GSVector8i(v.u8to16(), v.srl<8>().u8to16()); }
+  ALWAYS_INLINE static GSVector8i u8to32(const GSVector4i& v) { return GSVector8i(v.u8to32(), v.srl<4>().u8to32()); }
+  ALWAYS_INLINE static GSVector8i u8to64(const GSVector4i& v) { return GSVector8i(v.u8to64(), v.srl<2>().u8to64()); }
+  ALWAYS_INLINE static GSVector8i u16to32(const GSVector4i& v) { return GSVector8i(v.u16to32(), v.srl<8>().u16to32()); }
+  ALWAYS_INLINE static GSVector8i u16to64(const GSVector4i& v) { return GSVector8i(v.u16to64(), v.srl<4>().u16to64()); }
+  ALWAYS_INLINE static GSVector8i u32to64(const GSVector4i& v) { return GSVector8i(v.u32to64(), v.srl<8>().u32to64()); }
+
+  template<s32 i>
+  ALWAYS_INLINE GSVector8i srl() const
+  {
+    UNARY_HALVES(template srl<i>());
+  }
+
+  template<s32 i>
+  ALWAYS_INLINE GSVector8i srl(const GSVector8i& v)
+  {
+    BINARY_HALVES(template srl<i>);
+  }
+
+  template<s32 i>
+  ALWAYS_INLINE GSVector8i sll() const
+  {
+    UNARY_HALVES(template sll<i>());
+  }
+
+  template<s32 i>
+  ALWAYS_INLINE GSVector8i sll16() const
+  {
+    UNARY_HALVES(template sll16<i>());
+  }
+
+  ALWAYS_INLINE GSVector8i sll16(s32 i) const { UNARY_HALVES(sll16(i)); }
+  ALWAYS_INLINE GSVector8i sllv16(const GSVector8i& v) const { BINARY_HALVES(sllv16); }
+
+  template<s32 i>
+  ALWAYS_INLINE GSVector8i srl16() const
+  {
+    UNARY_HALVES(template srl16<i>());
+  }
+
+  ALWAYS_INLINE GSVector8i srl16(s32 i) const { UNARY_HALVES(srl16(i)); }
+  ALWAYS_INLINE GSVector8i srlv16(const GSVector8i& v) const { BINARY_HALVES(srlv16); }
+
+  template<s32 i>
+  ALWAYS_INLINE GSVector8i sra16() const
+  {
+    UNARY_HALVES(template sra16<i>());
+  }
+
+  ALWAYS_INLINE GSVector8i sra16(s32 i) const { UNARY_HALVES(sra16(i)); }
+  ALWAYS_INLINE GSVector8i srav16(const GSVector8i& v) const { BINARY_HALVES(srav16); }
+
+  template<s32 i>
+  ALWAYS_INLINE GSVector8i sll32() const
+  {
+    UNARY_HALVES(template sll32<i>());
+  }
+
+  ALWAYS_INLINE GSVector8i sll32(s32 i) const { UNARY_HALVES(sll32(i)); }
+  ALWAYS_INLINE GSVector8i sllv32(const GSVector8i& v) const { BINARY_HALVES(sllv32); }
+
+  template<s32 i>
+  ALWAYS_INLINE GSVector8i srl32() const
+  {
+    UNARY_HALVES(template srl32<i>());
+  }
+
+  ALWAYS_INLINE GSVector8i srl32(s32 i) const { UNARY_HALVES(srl32(i)); }
+  ALWAYS_INLINE GSVector8i srlv32(const GSVector8i& v) const { BINARY_HALVES(srlv32); }
+
+  template<s32 i>
+  ALWAYS_INLINE GSVector8i sra32() const
+  {
+    UNARY_HALVES(template sra32<i>());
+  }
+
+  ALWAYS_INLINE GSVector8i sra32(s32 i) const { UNARY_HALVES(sra32(i)); }
+  ALWAYS_INLINE GSVector8i srav32(const GSVector8i& v) const { BINARY_HALVES(srav32); }
+
+  template<s64 i>
+  ALWAYS_INLINE GSVector8i sll64() const
+  {
+    UNARY_HALVES(template sll64<i>());
+  }
+
+  ALWAYS_INLINE GSVector8i sll64(s32 i) const { UNARY_HALVES(sll64(i)); }
+  ALWAYS_INLINE GSVector8i sllv64(const GSVector8i& v) const { BINARY_HALVES(sllv64); }
+
+  template<s64 i>
+  ALWAYS_INLINE GSVector8i srl64() const
+  {
+    UNARY_HALVES(template srl64<i>());
+  }
+
+  ALWAYS_INLINE GSVector8i srl64(s32 i) const { UNARY_HALVES(srl64(i)); }
+  ALWAYS_INLINE GSVector8i srlv64(const GSVector8i& v) const { BINARY_HALVES(srlv64); }
+
+  ALWAYS_INLINE GSVector8i add8(const GSVector8i& v) const { BINARY_HALVES(add8); }
+  ALWAYS_INLINE GSVector8i add16(const GSVector8i& v) const { BINARY_HALVES(add16); }
+  ALWAYS_INLINE GSVector8i add32(const GSVector8i& v) const { BINARY_HALVES(add32); }
+  ALWAYS_INLINE GSVector8i adds8(const GSVector8i& v) const { BINARY_HALVES(adds8); }
+  ALWAYS_INLINE GSVector8i adds16(const GSVector8i& v) const { BINARY_HALVES(adds16); }
+  ALWAYS_INLINE GSVector8i hadds16(const GSVector8i& v) const { BINARY_HALVES(hadds16); }
+  ALWAYS_INLINE GSVector8i addus8(const GSVector8i& v) const { BINARY_HALVES(addus8); }
+  ALWAYS_INLINE GSVector8i addus16(const GSVector8i& v) const { BINARY_HALVES(addus16); }
+
+  ALWAYS_INLINE GSVector8i sub8(const GSVector8i& v) const { BINARY_HALVES(sub8); }
+  ALWAYS_INLINE GSVector8i sub16(const GSVector8i& v) const { BINARY_HALVES(sub16); }
+  ALWAYS_INLINE GSVector8i sub32(const GSVector8i& v) const { BINARY_HALVES(sub32); }
+  ALWAYS_INLINE GSVector8i subs8(const GSVector8i& v) const { BINARY_HALVES(subs8); }
+  ALWAYS_INLINE GSVector8i subs16(const GSVector8i& v) const { BINARY_HALVES(subs16); }
+  ALWAYS_INLINE GSVector8i subus8(const GSVector8i& v) const { BINARY_HALVES(subus8); }
+  ALWAYS_INLINE GSVector8i subus16(const GSVector8i& v) const { BINARY_HALVES(subus16); }
+
+  ALWAYS_INLINE GSVector8i mul16hs(const GSVector8i& v) const { BINARY_HALVES(mul16hs); }
+  ALWAYS_INLINE GSVector8i mul16l(const GSVector8i& v) const { BINARY_HALVES(mul16l); }
+  ALWAYS_INLINE GSVector8i mul16hrs(const GSVector8i& v) const { BINARY_HALVES(mul16hrs); }
+  ALWAYS_INLINE GSVector8i mul32l(const GSVector8i& v) const { BINARY_HALVES(mul32l); }
+
+  ALWAYS_INLINE bool eq(const GSVector8i& v) const { return low128().eq(v.low128()) && high128().eq(v.high128()); }
+
+  ALWAYS_INLINE GSVector8i eq8(const GSVector8i& v) const { BINARY_HALVES(eq8); }
+  ALWAYS_INLINE GSVector8i eq16(const GSVector8i& v) const { BINARY_HALVES(eq16); }
+  ALWAYS_INLINE GSVector8i eq32(const GSVector8i& v) const { BINARY_HALVES(eq32); }
+  ALWAYS_INLINE GSVector8i eq64(const GSVector8i& v) const { BINARY_HALVES(eq64); }
+
+  ALWAYS_INLINE GSVector8i neq8(const GSVector8i& v) const { return ~eq8(v); }
+  ALWAYS_INLINE GSVector8i neq16(const GSVector8i& v) const { return ~eq16(v); }
+  ALWAYS_INLINE GSVector8i neq32(const GSVector8i& v) const { return ~eq32(v); }
+
+  ALWAYS_INLINE GSVector8i gt8(const GSVector8i& v) const { BINARY_HALVES(gt8); }
+  ALWAYS_INLINE GSVector8i gt16(const GSVector8i& v) const { BINARY_HALVES(gt16); }
+  ALWAYS_INLINE GSVector8i gt32(const GSVector8i& v) const { BINARY_HALVES(gt32); }
+
+  ALWAYS_INLINE GSVector8i ge8(const GSVector8i& v) const { BINARY_HALVES(ge8); }
+  ALWAYS_INLINE GSVector8i ge16(const GSVector8i& v) const { BINARY_HALVES(ge16); }
+  ALWAYS_INLINE GSVector8i ge32(const GSVector8i& v) const { BINARY_HALVES(ge32); }
+
+  ALWAYS_INLINE GSVector8i lt8(const GSVector8i& v) const { BINARY_HALVES(lt8); }
+  ALWAYS_INLINE GSVector8i lt16(const GSVector8i& v) const { BINARY_HALVES(lt16); }
+  ALWAYS_INLINE GSVector8i lt32(const GSVector8i& v) const { BINARY_HALVES(lt32); }
+
+  ALWAYS_INLINE GSVector8i le8(const GSVector8i& v) const { BINARY_HALVES(le8); }
+  ALWAYS_INLINE GSVector8i le16(const GSVector8i& v) const { BINARY_HALVES(le16); }
+  ALWAYS_INLINE GSVector8i le32(const GSVector8i& v) const { BINARY_HALVES(le32); }
+
+  ALWAYS_INLINE GSVector8i andnot(const GSVector8i& v) const { BINARY_HALVES(andnot); }
+
+  ALWAYS_INLINE u32 mask() const
+  {
+    return static_cast<u32>(low128().mask()) | (static_cast<u32>(high128().mask()) << 16);
+  }
+
+  ALWAYS_INLINE bool alltrue() const { return low128().alltrue() && high128().alltrue(); }
+  ALWAYS_INLINE bool anytrue() const { return (low128() | high128()).anytrue(); }
+  ALWAYS_INLINE bool allfalse() const { return (low128() | high128()).allfalse(); }
+
+  template<s32 i>
+  ALWAYS_INLINE GSVector8i insert8(s32 a) const
+  {
+    if constexpr (i < 16)
+      return GSVector8i(low128().template insert8<i>(a), high128());
+    else
+      return GSVector8i(low128(), high128().template insert8<i - 16>(a));
+  }
+
+  template<s32 i>
+  ALWAYS_INLINE s32 extract8() const
+  {
+    if constexpr (i < 16)
+      return low128().template extract8<i>();
+    else
+      return high128().template extract8<i - 16>();
+  }
+
+  template<s32 i>
+  ALWAYS_INLINE GSVector8i insert16(s32 a) const
+  {
+    if constexpr (i < 8)
+      return GSVector8i(low128().template insert16<i>(a), high128());
+    else
+      return GSVector8i(low128(), high128().template insert16<i - 8>(a));
+  }
+
+  template<s32 i>
+  ALWAYS_INLINE s32 extract16() const
+  {
+    if constexpr (i < 8)
+      return low128().template extract16<i>();
+    else
+      return high128().template extract16<i - 8>();
+  }
+
+  template<s32 i>
+  ALWAYS_INLINE GSVector8i insert32(s32 a) const
+  {
+    if constexpr (i < 4)
+      return GSVector8i(low128().template insert32<i>(a), high128());
+    else
+      return GSVector8i(low128(), high128().template insert32<i - 4>(a));
+  }
+
+  template<s32 i>
+  ALWAYS_INLINE s32 extract32() const
+  {
+    if constexpr (i < 4)
+      return low128().template extract32<i>();
+    else
+      return high128().template extract32<i - 4>();
+  }
+
+  template<s32 i>
+  ALWAYS_INLINE GSVector8i insert64(s64 a) const
+  {
+    if constexpr (i < 2)
+      return GSVector8i(low128().template insert64<i>(a), high128());
+    else
+      return GSVector8i(low128(), high128().template insert64<i - 2>(a));
+  }
+
+  template<s32 i>
+  ALWAYS_INLINE s64 extract64() const
+  {
+    if constexpr (i < 2)
+      return low128().template extract64<i>();
+    else
+      return high128().template extract64<i - 2>();
+  }
+
+  ALWAYS_INLINE static GSVector8i zext32(s32 v) { return GSVector8i(GSVector4i::zext32(v), GSVector4i::zero()); }
+
+  ALWAYS_INLINE static GSVector8i loadnt(const void* p)
+  {
+    return GSVector8i(GSVector4i::loadnt(p), GSVector4i::loadnt(static_cast<const u8*>(p) + 16));
+  }
+
+  template<bool aligned>
+  ALWAYS_INLINE static GSVector8i load(const void* p)
+  {
+    return GSVector8i(GSVector4i::load<aligned>(p), GSVector4i::load<aligned>(static_cast<const u8*>(p) + 16));
+  }
+
+  ALWAYS_INLINE static void storent(void* p, const GSVector8i& v)
+  {
+    GSVector4i::storent(p, v.low128());
+    GSVector4i::storent(static_cast<u8*>(p) + 16, v.high128());
+  }
+
+  template<bool aligned>
+  ALWAYS_INLINE static void store(void* p, const GSVector8i& v)
+  {
+    GSVector4i::store<aligned>(p, v.low128());
+    GSVector4i::store<aligned>(static_cast<u8*>(p) + 16, v.high128());
+  }
+
+  template<bool aligned>
+  ALWAYS_INLINE static void storel(void* p, const GSVector8i& v)
+  {
+    GSVector4i::store<aligned>(p, v.low128());
+  }
+
+  ALWAYS_INLINE GSVector8i& operator&=(const GSVector8i& v)
+  {
+    *this = *this & v;
+    return *this;
+  }
+  ALWAYS_INLINE GSVector8i& operator|=(const GSVector8i& v)
+  {
+    *this = *this | v;
+    return *this;
+  }
+  ALWAYS_INLINE GSVector8i& operator^=(const GSVector8i& v)
+  {
+    *this = *this ^ v;
+    return *this;
+  }
+
+  ALWAYS_INLINE friend GSVector8i operator&(const GSVector8i& v1, const GSVector8i& v2)
+  {
+    return GSVector8i(v1.low128() & v2.low128(), v1.high128() & v2.high128());
+  }
+
+  ALWAYS_INLINE friend GSVector8i operator|(const GSVector8i& v1, const GSVector8i& v2)
+  {
+    return GSVector8i(v1.low128() | v2.low128(), v1.high128() | v2.high128());
+  }
+
+  ALWAYS_INLINE friend GSVector8i operator^(const GSVector8i& v1, const GSVector8i& v2)
+  {
+    return GSVector8i(v1.low128() ^ v2.low128(), v1.high128() ^ v2.high128());
+  }
+
+  ALWAYS_INLINE friend GSVector8i operator&(const GSVector8i& v, s32 i) { return v & GSVector8i(i); }
+  ALWAYS_INLINE friend GSVector8i operator|(const GSVector8i& v, s32 i) { return v | GSVector8i(i); }
+  ALWAYS_INLINE friend GSVector8i operator^(const GSVector8i& v, s32 i) { return v ^ GSVector8i(i); }
+  ALWAYS_INLINE friend GSVector8i operator~(const GSVector8i& v) { return GSVector8i(~v.low128(), ~v.high128()); }
+
+  ALWAYS_INLINE static GSVector8i zero() { return GSVector8i(GSVector4i::zero(), GSVector4i::zero()); }
+
+  ALWAYS_INLINE static GSVector8i broadcast128(const GSVector4i& v) { return GSVector8i(v, v); }
+
+  template<bool aligned>
+  ALWAYS_INLINE static GSVector8i broadcast128(const void* v)
+  {
+    return broadcast128(GSVector4i::load<aligned>(v));
+  }
+
+  ALWAYS_INLINE GSVector4i low128() const { return GSVector4i(v4s[0]); }
+  ALWAYS_INLINE GSVector4i high128() const { return GSVector4i(v4s[1]); }
+};
+
+#undef UNARY_HALVES
+#undef BINARY_HALVES
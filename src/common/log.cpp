@@ -5,14 +5,22 @@
 #include "assert.h"
 #include "file_system.h"
 #include "small_string.h"
+#include "threading.h"
 #include "timer.h"
 
 #include "fmt/format.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <bitset>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <cstring>
+#include <memory>
 #include <mutex>
+#include <thread>
 #include <vector>
 
 #if defined(_WIN32)
@@ -34,6 +42,42 @@ struct RegisteredCallback
   Log::CallbackFunctionType Function;
   void* Parameter;
 };
+
+/// Single-producer single-consumer ring of messages, owned by the thread which writes to it.
+struct AsyncBuffer
+{
+  static constexpr u32 SIZE = 256 * 1024;
+  static constexpr u32 MASK = SIZE - 1;
+
+  struct MessageHeader
+  {
+    Timer::Value timestamp;
+    MessageCategory category;
+    u16 function_name_length;
+    u32 message_length;
+  };
+
+  // Positions are free-running, and masked when accessing the data.
+  alignas(HOST_CACHE_LINE_SIZE) std::atomic<u32> write_pos{0};
+  alignas(HOST_CACHE_LINE_SIZE) std::atomic<u32> read_pos{0};
+  std::atomic_bool abandoned{false};
+  std::unique_ptr<u8[]> data = std::make_unique<u8[]>(SIZE);
+
+  void CopyIn(u32 pos, const void* src, u32 size);
+  void CopyOut(u32 pos, void* dst, u32 size) const;
+};
+
+/// Marks the calling thread's buffer as abandoned when the thread exits, so the writer thread can free it.
+struct AsyncBufferOwner
+{
+  AsyncBuffer* buffer = nullptr;
+
+  ~AsyncBufferOwner()
+  {
+    if (buffer)
+      buffer->abandoned.store(true, std::memory_order_release);
+  }
+};
 } // namespace
 
 using ChannelBitSet = std::bitset<static_cast<size_t>(Channel::MaxCount)>;
@@ -44,6 +88,12 @@ static void UnregisterCallback(CallbackFunctionType callbackFunction, void* pUse
                                const std::unique_lock<std::mutex>& lock);
 static void UpdateEffectiveLevel();
 
+static AsyncBuffer* GetAsyncBufferForCurrentThread();
+static void PushAsyncMessage(MessageCategory cat, const char* function_name, std::string_view message);
+static void DrainAsyncBuffers();
+static void AsyncOutputThreadEntryPoint();
+static void StopAsyncOutputThread();
+
 static bool FilterTest(Channel channel, Level level);
 static void ExecuteCallbacks(MessageCategory cat, const char* functionName, std::string_view message);
 static void FormatLogMessageForDisplay(fmt::memory_buffer& buffer, MessageCategory cat, const char* functionName,
@@ -72,6 +122,9 @@ static constexpr const std::array<const char*, static_cast<size_t>(Channel::MaxC
 #undef LOG_CHANNEL_NAME
 }};
 
+// How often the writer thread wakes up if nothing signals it.
+static constexpr std::chrono::milliseconds ASYNC_FLUSH_INTERVAL{10};
+
 namespace {
 
 struct State
@@ -93,19 +146,40 @@ struct State
   bool file_output_timestamp = false;
   bool debug_output_enabled = false;
 
+  std::atomic_bool async_output_enabled{false};
+  std::atomic<u64> async_dropped_messages{0};
+  u64 async_dropped_messages_reported = 0;
+  std::mutex async_buffers_mutex;
+  std::vector<std::unique_ptr<AsyncBuffer>> async_buffers;
+  std::mutex async_drain_mutex;
+  std::vector<AsyncBuffer*> async_drain_list;
+  std::mutex async_wake_mutex;
+  std::condition_variable async_wake_cv;
+  std::thread async_thread;
+  bool async_thread_stop = false;
+
 #ifdef _WIN32
   HANDLE hConsoleStdIn = NULL;
   HANDLE hConsoleStdOut = NULL;
   HANDLE hConsoleStdErr = NULL;
 #endif
+
+  ~State() { StopAsyncOutputThread(); }
 };
 
 } // namespace
 
 ALIGN_TO_CACHE_LINE static State s_state;
 
+static thread_local AsyncBufferOwner s_async_buffer_owner;
+
+// Set by the writer thread while dispatching a queued message, so that its timestamp is used.
+static thread_local Timer::Value s_async_message_timestamp = 0;
+
 } // namespace Log
 
+std::array<Log::Level, static_cast<size_t>(Log::Channel::MaxCount)> Log::g_channel_log_levels = {};
+
 void Log::RegisterCallback(CallbackFunctionType callbackFunction, void* pUserParam)
 {
   std::unique_lock lock(s_state.callbacks_mutex);
@@ -146,6 +220,8 @@ void Log::UnregisterCallback(CallbackFunctionType callbackFunction, void* pUserP
 void Log::UpdateEffectiveLevel()
 {
   s_state.effective_log_level = s_state.callbacks.empty() ? Level::None : s_state.requested_log_level;
+  for (size_t i = 0; i < static_cast<size_t>(Channel::MaxCount); i++)
+    g_channel_log_levels[i] = s_state.log_channels_enabled[i] ? s_state.effective_log_level : Level::None;
 }
 
 const std::array<const char*, static_cast<size_t>(Log::Channel::MaxCount)>& Log::GetChannelNames()
@@ -155,7 +231,9 @@ const std::array<const char*, static_cast<size_t>(Log::Channel::MaxCount)>& Log:
 
 float Log::GetCurrentMessageTime()
 {
-  return static_cast<float>(Timer::ConvertValueToSeconds(Timer::GetCurrentValue() - s_state.start_timestamp));
+  const Timer::Value timestamp =
+    (s_async_message_timestamp != 0) ? s_async_message_timestamp : Timer::GetCurrentValue();
+  return static_cast<float>(Timer::ConvertValueToSeconds(timestamp - s_state.start_timestamp));
 }
 
 bool Log::AreConsoleOutputTimestampsEnabled()
@@ -403,6 +481,8 @@ void Log::DebugOutputLogCallback(void* pUserParam, MessageCategory cat, const ch
 
 void Log::SetConsoleOutputParams(bool enabled, bool timestamps)
 {
+  DrainAsyncBuffers();
+
   std::unique_lock lock(s_state.callbacks_mutex);
 
   s_state.console_output_timestamps = timestamps;
@@ -483,6 +563,8 @@ void Log::SetConsoleOutputParams(bool enabled, bool timestamps)
 
 void Log::SetDebugOutputParams(bool enabled)
 {
+  DrainAsyncBuffers();
+
   std::unique_lock lock(s_state.callbacks_mutex);
   if (s_state.debug_output_enabled == enabled)
     return;
@@ -503,12 +585,18 @@ void Log::FileOutputLogCallback(void* pUserParam, MessageCategory cat, const cha
   FormatLogMessageAndPrint(cat, function_name, message, s_state.file_output_timestamp, false,
                            [](std::string_view message) {
                              std::fwrite(message.data(), 1, message.size(), s_state.file_handle.get());
-                             std::fflush(s_state.file_handle.get());
+
+                             // The writer thread flushes once per batch instead.
+                             if (s_async_message_timestamp == 0)
+                               std::fflush(s_state.file_handle.get());
                            });
 }
 
 void Log::SetFileOutputParams(bool enabled, const char* filename, bool timestamps /* = true */)
 {
+  // Make sure anything queued makes it to the old file before it's closed.
+  DrainAsyncBuffers();
+
   std::unique_lock lock(s_state.callbacks_mutex);
 
   s_state.file_output_timestamp = timestamps;
@@ -542,11 +630,6 @@ Log::Level Log::GetLogLevel()
   return s_state.effective_log_level;
 }
 
-bool Log::IsLogVisible(Level level, Channel channel)
-{
-  return FilterTest(channel, level);
-}
-
 void Log::SetLogLevel(Level level)
 {
   std::unique_lock lock(s_state.callbacks_mutex);
@@ -560,6 +643,7 @@ void Log::SetLogChannelEnabled(Channel channel, bool enabled)
   std::unique_lock lock(s_state.callbacks_mutex);
   DebugAssert(channel < Channel::MaxCount);
   s_state.log_channels_enabled[static_cast<size_t>(channel)] = enabled;
+  UpdateEffectiveLevel();
 }
 
 const char* Log::GetChannelName(Channel channel)
@@ -569,7 +653,7 @@ const char* Log::GetChannelName(Channel channel)
 
 ALWAYS_INLINE_RELEASE bool Log::FilterTest(Channel channel, Level level)
 {
-  return (level <= s_state.effective_log_level && s_state.log_channels_enabled[static_cast<size_t>(channel)]);
+  return IsLogVisible(level, channel);
 }
 
 void Log::Write(MessageCategory cat, std::string_view message)
@@ -577,6 +661,12 @@ void Log::Write(MessageCategory cat, std::string_view message)
   if (!FilterTest(UnpackChannel(cat), UnpackLevel(cat)))
     return;
 
+  if (s_state.async_output_enabled.load(std::memory_order_relaxed))
+  {
+    PushAsyncMessage(cat, nullptr, message);
+    return;
+  }
+
   std::unique_lock lock(s_state.callbacks_mutex);
   ExecuteCallbacks(cat, nullptr, message);
 }
@@ -586,6 +676,12 @@ void Log::WriteFuncName(MessageCategory cat, const char* function_name, std::str
   if (!FilterTest(UnpackChannel(cat), UnpackLevel(cat)))
     return;
 
+  if (s_state.async_output_enabled.load(std::memory_order_relaxed))
+  {
+    PushAsyncMessage(cat, function_name, message);
+    return;
+  }
+
   std::unique_lock lock(s_state.callbacks_mutex);
   ExecuteCallbacks(cat, function_name, message);
 }
@@ -598,6 +694,12 @@ void Log::WriteFmtArgs(MessageCategory cat, fmt::string_view fmt, fmt::format_ar
   fmt::memory_buffer buffer;
   fmt::vformat_to(std::back_inserter(buffer), fmt, args);
 
+  if (s_state.async_output_enabled.load(std::memory_order_relaxed))
+  {
+    PushAsyncMessage(cat, nullptr, std::string_view(buffer.data(), buffer.size()));
+    return;
+  }
+
   std::unique_lock lock(s_state.callbacks_mutex);
   ExecuteCallbacks(cat, nullptr, std::string_view(buffer.data(), buffer.size()));
 }
@@ -611,6 +713,232 @@ void Log::WriteFuncNameFmtArgs(MessageCategory cat, const char* function_name, f
   fmt::memory_buffer buffer;
   fmt::vformat_to(std::back_inserter(buffer), fmt, args);
 
+  if (s_state.async_output_enabled.load(std::memory_order_relaxed))
+  {
+    PushAsyncMessage(cat, function_name, std::string_view(buffer.data(), buffer.size()));
+    return;
+  }
+
   std::unique_lock lock(s_state.callbacks_mutex);
   ExecuteCallbacks(cat, function_name, std::string_view(buffer.data(), buffer.size()));
 }
+
+void Log::AsyncBuffer::CopyIn(u32 pos, const void* src, u32 size)
+{
+  const u32 offset = pos & MASK;
+  const u32 first = std::min(size, SIZE - offset);
+  std::memcpy(&data[offset], src, first);
+  if (first < size)
+    std::memcpy(&data[0], static_cast<const u8*>(src) + first, size - first);
+}
+
+void Log::AsyncBuffer::CopyOut(u32 pos, void* dst, u32 size) const
+{
+  const u32 offset = pos & MASK;
+  const u32 first = std::min(size, SIZE - offset);
+  std::memcpy(dst, &data[offset], first);
+  if (first < size)
+    std::memcpy(static_cast<u8*>(dst) + first, &data[0], size - first);
+}
+
+Log::AsyncBuffer* Log::GetAsyncBufferForCurrentThread()
+{
+  if (s_async_buffer_owner.buffer) [[likely]]
+    return s_async_buffer_owner.buffer;
+
+  std::unique_lock lock(s_state.async_buffers_mutex);
+  s_async_buffer_owner.buffer = s_state.async_buffers.emplace_back(std::make_unique<AsyncBuffer>()).get();
+  return s_async_buffer_owner.buffer;
+}
+
+void Log::PushAsyncMessage(MessageCategory cat, const char* function_name, std::string_view message)
+{
+  AsyncBuffer* const buffer = GetAsyncBufferForCurrentThread();
+
+  // Function names are copied too, they're not guaranteed to outlive the call.
+  AsyncBuffer::MessageHeader header;
+  header.timestamp = Timer::GetCurrentValue();
+  header.category = cat;
+  header.function_name_length = function_name ? static_cast<u16>(std::strlen(function_name)) : 0;
+  header.message_length = static_cast<u32>(message.length());
+
+  const size_t size = sizeof(header) + header.function_name_length + message.length();
+  const u32 write_pos = buffer->write_pos.load(std::memory_order_relaxed);
+  const u32 used = write_pos - buffer->read_pos.load(std::memory_order_acquire);
+  if (size > (AsyncBuffer::SIZE - used)) [[unlikely]]
+  {
+    s_state.async_dropped_messages.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  buffer->CopyIn(write_pos, &header, sizeof(header));
+  buffer->CopyIn(write_pos + sizeof(header), function_name, header.function_name_length);
+  buffer->CopyIn(write_pos + sizeof(header) + header.function_name_length, message.data(), header.message_length);
+  buffer->write_pos.store(write_pos + static_cast<u32>(size), std::memory_order_release);
+
+  // Only wake the writer early when the buffer is getting full, or for errors, which should hit the disk promptly.
+  // Otherwise it picks the messages up on its next interval.
+  if ((used < (AsyncBuffer::SIZE / 2) && (used + size) >= (AsyncBuffer::SIZE / 2)) ||
+      UnpackLevel(cat) <= Level::Error)
+  {
+    s_state.async_wake_cv.notify_one();
+  }
+}
+
+void Log::DrainAsyncBuffers()
+{
+  std::unique_lock drain_lock(s_state.async_drain_mutex);
+  {
+    std::unique_lock lock(s_state.async_buffers_mutex);
+    if (s_state.async_buffers.empty())
+      return;
+
+    s_state.async_drain_list.clear();
+    for (const std::unique_ptr<AsyncBuffer>& buffer : s_state.async_buffers)
+      s_state.async_drain_list.push_back(buffer.get());
+  }
+
+  // Snapshot the write positions, anything written after this is picked up next time.
+  std::vector<std::pair<u32, u32>> positions;
+  positions.reserve(s_state.async_drain_list.size());
+  for (AsyncBuffer* buffer : s_state.async_drain_list)
+  {
+    positions.emplace_back(buffer->read_pos.load(std::memory_order_relaxed),
+                           buffer->write_pos.load(std::memory_order_acquire));
+  }
+
+  std::unique_lock lock(s_state.callbacks_mutex);
+
+  const u64 dropped = s_state.async_dropped_messages.load(std::memory_order_relaxed);
+  if (dropped != s_state.async_dropped_messages_reported)
+  {
+    ExecuteCallbacks(PackCategory(Channel::Log, Level::Warning, Color::Default), nullptr,
+                     TinyString::from_format("Dropped {} log messages, async log buffer was full.",
+                                             dropped - s_state.async_dropped_messages_reported));
+    s_state.async_dropped_messages_reported = dropped;
+  }
+
+  // Merge by timestamp, so messages from different threads come out in the order they were written.
+  SmallString function_name;
+  fmt::memory_buffer message;
+  bool wrote_any = false;
+  for (;;)
+  {
+    size_t next = s_state.async_drain_list.size();
+    AsyncBuffer::MessageHeader header = {};
+    for (size_t i = 0; i < s_state.async_drain_list.size(); i++)
+    {
+      if (positions[i].first == positions[i].second)
+        continue;
+
+      AsyncBuffer::MessageHeader this_header;
+      s_state.async_drain_list[i]->CopyOut(positions[i].first, &this_header, sizeof(this_header));
+      if (next == s_state.async_drain_list.size() || this_header.timestamp < header.timestamp)
+      {
+        next = i;
+        header = this_header;
+      }
+    }
+    if (next == s_state.async_drain_list.size())
+      break;
+
+    const AsyncBuffer* buffer = s_state.async_drain_list[next];
+    u32& read_pos = positions[next].first;
+    read_pos += sizeof(header);
+    function_name.resize(header.function_name_length);
+    buffer->CopyOut(read_pos, function_name.data(), header.function_name_length);
+    read_pos += header.function_name_length;
+    message.resize(header.message_length);
+    buffer->CopyOut(read_pos, message.data(), header.message_length);
+    read_pos += header.message_length;
+
+    // Use the time the message was written, not when it's displayed.
+    s_async_message_timestamp = header.timestamp;
+    ExecuteCallbacks(header.category, (header.function_name_length > 0) ? function_name.c_str() : nullptr,
+                     std::string_view(message.data(), message.size()));
+    wrote_any = true;
+  }
+  s_async_message_timestamp = 0;
+
+  if (wrote_any && s_state.file_handle)
+    std::fflush(s_state.file_handle.get());
+
+  lock.unlock();
+
+  for (size_t i = 0; i < s_state.async_drain_list.size(); i++)
+    s_state.async_drain_list[i]->read_pos.store(positions[i].first, std::memory_order_release);
+
+  // Free buffers belonging to threads which have exited, once they're empty.
+  std::unique_lock buffers_lock(s_state.async_buffers_mutex);
+  for (auto it = s_state.async_buffers.begin(); it != s_state.async_buffers.end();)
+  {
+    AsyncBuffer* buffer = it->get();
+    if (buffer->abandoned.load(std::memory_order_acquire) &&
+        buffer->read_pos.load(std::memory_order_relaxed) == buffer->write_pos.load(std::memory_order_acquire))
+    {
+      it = s_state.async_buffers.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+void Log::AsyncOutputThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Log Writer");
+
+  std::unique_lock lock(s_state.async_wake_mutex);
+  while (!s_state.async_thread_stop)
+  {
+    s_state.async_wake_cv.wait_for(lock, ASYNC_FLUSH_INTERVAL);
+    lock.unlock();
+    DrainAsyncBuffers();
+    lock.lock();
+  }
+}
+
+void Log::StopAsyncOutputThread()
+{
+  if (!s_state.async_thread.joinable())
+    return;
+
+  {
+    std::unique_lock lock(s_state.async_wake_mutex);
+    s_state.async_thread_stop = true;
+  }
+  s_state.async_wake_cv.notify_one();
+  s_state.async_thread.join();
+}
+
+bool Log::IsAsyncOutputEnabled()
+{
+  return s_state.async_output_enabled.load(std::memory_order_relaxed);
+}
+
+void Log::SetAsyncOutputParams(bool enabled)
+{
+  if (s_state.async_output_enabled.load(std::memory_order_relaxed) == enabled)
+    return;
+
+  if (enabled)
+  {
+    s_state.async_thread_stop = false;
+    s_state.async_thread = std::thread(&Log::AsyncOutputThreadEntryPoint);
+    s_state.async_output_enabled.store(true, std::memory_order_release);
+  }
+  else
+  {
+    s_state.async_output_enabled.store(false, std::memory_order_release);
+    StopAsyncOutputThread();
+
+    // Pick up anything written while the thread was shutting down.
+    DrainAsyncBuffers();
+  }
+}
+
+u64 Log::GetDroppedMessageCount()
+{
+  return s_state.async_dropped_messages.load(std::memory_order_relaxed);
+}
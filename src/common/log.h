@@ -115,11 +115,26 @@ void SetDebugOutputParams(bool enabled);
 // adds a file output
 void SetFileOutputParams(bool enabled, const char* filename, bool timestamps = true);
 
+// Queues messages in per-thread ring buffers, and dispatches them to the sinks from a background thread. Messages
+// which don't fit in the calling thread's buffer are dropped and counted, instead of stalling the caller.
+bool IsAsyncOutputEnabled();
+void SetAsyncOutputParams(bool enabled);
+
+// Returns the total number of messages dropped because an async buffer was full.
+u64 GetDroppedMessageCount();
+
 // Returns the current global filtering level.
 Level GetLogLevel();
 
+// Effective level for each channel, None if the channel is disabled or there are no sinks. Written under the log
+// lock, read without it by IsLogVisible().
+extern std::array<Level, static_cast<size_t>(Channel::MaxCount)> g_channel_log_levels;
+
 // Returns true if log messages for the specified log level/filter would not be filtered (and visible).
-bool IsLogVisible(Level level, Channel channel);
+ALWAYS_INLINE bool IsLogVisible(Level level, Channel channel)
+{
+  return (level <= g_channel_log_levels[static_cast<size_t>(channel)]);
+}
 
 // Sets global filtering level, messages below this level won't be sent to any of the logging sinks.
 void SetLogLevel(Level level);
@@ -160,14 +175,14 @@ ALWAYS_INLINE void WriteFuncName(MessageCategory cat, const char* function_name,
 #define GENERIC_LOG(channel, level, color, ...)                                                                        \
   do                                                                                                                   \
   {                                                                                                                    \
-    if ((level) <= Log::GetLogLevel()) [[unlikely]]                                                                    \
+    if (Log::IsLogVisible((level), (channel))) [[unlikely]]                                                            \
       Log::Write(Log::PackCategory((channel), (level), (color)), __VA_ARGS__);                                         \
   } while (0)
 
 #define GENERIC_FUNC_LOG(channel, level, color, ...)                                                                   \
   do                                                                                                                   \
   {                                                                                                                    \
-    if ((level) <= Log::GetLogLevel()) [[unlikely]]                                                                    \
+    if (Log::IsLogVisible((level), (channel))) [[unlikely]]                                                            \
       Log::WriteFuncName(Log::PackCategory((channel), (level), (color)), __func__, __VA_ARGS__);                       \
   } while (0)
 
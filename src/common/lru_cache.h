@@ -3,21 +3,28 @@
 
 #pragma once
 #include "heterogeneous_containers.h"
-#include <cstdint>
-#include <map>
+#include <cstddef>
+#include <unordered_map>
 
+/// Least-recently-used cache, bounded by item count and optionally by total size in bytes.
+/// Items are kept in a hash map, with an intrusive list in recency order threaded through them, so lookups,
+/// insertions and evictions are all O(1). Pointers to values remain valid until the item is removed or evicted.
 template<class K, class V>
 class LRUCache
 {
-  using CounterType = std::uint64_t;
-
   struct Item
   {
     V value;
-    CounterType last_access;
+    std::size_t size_in_bytes;
+
+    // Recency list, most recently used at the head. The key pointer refers back into the map node.
+    Item* prev;
+    Item* next;
+    const K* key;
   };
 
-  using MapType = std::conditional_t<std::is_same_v<K, std::string>, StringMap<Item>, std::map<K, Item>>;
+  using MapType =
+    std::conditional_t<std::is_same_v<K, std::string>, UnorderedStringMap<Item>, std::unordered_map<K, Item>>;
 
 public:
   LRUCache(std::size_t max_capacity = 16, bool manual_evict = false)
@@ -26,16 +33,35 @@ public:
   }
   ~LRUCache() = default;
 
+  LRUCache(const LRUCache&) = delete;
+  LRUCache& operator=(const LRUCache&) = delete;
+
   std::size_t GetSize() const { return m_items.size(); }
   std::size_t GetMaxCapacity() const { return m_max_capacity; }
+  std::size_t GetSizeInBytes() const { return m_size_in_bytes; }
+  std::size_t GetMaxBytes() const { return m_max_bytes; }
 
-  void Clear() { m_items.clear(); }
+  void Clear()
+  {
+    m_items.clear();
+    m_head = nullptr;
+    m_tail = nullptr;
+    m_size_in_bytes = 0;
+  }
 
   void SetMaxCapacity(std::size_t capacity)
   {
     m_max_capacity = capacity;
-    if (m_items.size() > m_max_capacity)
-      Evict(m_items.size() - m_max_capacity);
+    if (!m_manual_evict)
+      ManualEvict();
+  }
+
+  /// Sets the budget for the sum of the sizes passed to Insert(). Zero means no limit.
+  void SetMaxBytes(std::size_t max_bytes)
+  {
+    m_max_bytes = max_bytes;
+    if (!m_manual_evict)
+      ManualEvict();
   }
 
   template<typename KeyT>
@@ -45,42 +71,42 @@ public:
     if (iter == m_items.end())
       return nullptr;
 
-    iter->second.last_access = ++m_last_counter;
+    MoveToHead(&iter->second);
     return &iter->second.value;
   }
 
-  V* Insert(K key, V value)
+  /// Inserts or replaces an item. size_in_bytes only matters if a byte budget has been set.
+  V* Insert(K key, V value, std::size_t size_in_bytes = 0)
   {
-    ShrinkForNewItem();
-
     auto iter = m_items.find(key);
     if (iter != m_items.end())
     {
-      iter->second.value = std::move(value);
-      iter->second.last_access = ++m_last_counter;
-      return &iter->second.value;
-    }
-    else
-    {
-      Item it;
-      it.last_access = ++m_last_counter;
-      it.value = std::move(value);
-      auto ip = m_items.emplace(std::move(key), std::move(it));
-      return &ip.first->second.value;
+      Item& item = iter->second;
+      item.value = std::move(value);
+      m_size_in_bytes = m_size_in_bytes - item.size_in_bytes + size_in_bytes;
+      item.size_in_bytes = size_in_bytes;
+      MoveToHead(&item);
+      if (!m_manual_evict)
+        ShrinkToFit(&item);
+      return &item.value;
     }
+
+    if (!m_manual_evict)
+      ShrinkForNewItem(size_in_bytes);
+
+    iter = m_items.emplace(std::move(key), Item{std::move(value), size_in_bytes, nullptr, nullptr, nullptr}).first;
+    Item& item = iter->second;
+    item.key = &iter->first;
+    LinkAtHead(&item);
+    m_size_in_bytes += size_in_bytes;
+    return &item.value;
   }
 
   void Evict(std::size_t count = 1)
   {
-    while (!m_items.empty() && count > 0)
+    while (m_tail && count > 0)
     {
-      typename MapType::iterator lowest = m_items.end();
-      for (auto iter = m_items.begin(); iter != m_items.end(); ++iter)
-      {
-        if (lowest == m_items.end() || iter->second.last_access < lowest->second.last_access)
-          lowest = iter;
-      }
-      m_items.erase(lowest);
+      RemoveItem(m_tail);
       count--;
     }
   }
@@ -93,6 +119,8 @@ public:
     {
       if (pred(iter->first))
       {
+        Unlink(&iter->second);
+        m_size_in_bytes -= iter->second.size_in_bytes;
         iter = m_items.erase(iter);
         removed_count++;
       }
@@ -110,6 +138,8 @@ public:
     auto iter = m_items.find(key);
     if (iter == m_items.end())
       return false;
+    Unlink(&iter->second);
+    m_size_in_bytes -= iter->second.size_in_bytes;
     m_items.erase(iter);
     return true;
   }
@@ -122,8 +152,7 @@ public:
   void ManualEvict()
   {
     // evict if we went over
-    while (m_items.size() > m_max_capacity)
-      Evict(m_items.size() - m_max_capacity);
+    ShrinkToFit(nullptr);
   }
 
   template<typename F>
@@ -134,16 +163,69 @@ public:
   }
 
 private:
-  void ShrinkForNewItem()
+  bool IsOverBudget(std::size_t extra_items, std::size_t extra_bytes) const
   {
-    if (m_items.size() < m_max_capacity)
+    return ((m_items.size() + extra_items) > m_max_capacity ||
+            (m_max_bytes > 0 && (m_size_in_bytes + extra_bytes) > m_max_bytes));
+  }
+
+  void ShrinkForNewItem(std::size_t size_in_bytes)
+  {
+    while (m_tail && IsOverBudget(1, size_in_bytes))
+      RemoveItem(m_tail);
+  }
+
+  /// Evicts until within budget, but never evicts keep, so an item which was just replaced always survives.
+  void ShrinkToFit(const Item* keep)
+  {
+    while (m_tail && m_tail != keep && IsOverBudget(0, 0))
+      RemoveItem(m_tail);
+  }
+
+  void LinkAtHead(Item* item)
+  {
+    item->prev = nullptr;
+    item->next = m_head;
+    if (m_head)
+      m_head->prev = item;
+    else
+      m_tail = item;
+    m_head = item;
+  }
+
+  void Unlink(Item* item)
+  {
+    if (item->prev)
+      item->prev->next = item->next;
+    else
+      m_head = item->next;
+    if (item->next)
+      item->next->prev = item->prev;
+    else
+      m_tail = item->prev;
+  }
+
+  void MoveToHead(Item* item)
+  {
+    if (item == m_head)
       return;
 
-    Evict(m_items.size() - (m_max_capacity - 1));
+    Unlink(item);
+    LinkAtHead(item);
+  }
+
+  void RemoveItem(Item* item)
+  {
+    Unlink(item);
+    m_size_in_bytes -= item->size_in_bytes;
+    m_items.erase(m_items.find(*item->key));
   }
 
   MapType m_items;
-  CounterType m_last_counter = 0;
+  Item* m_head = nullptr;
+  Item* m_tail = nullptr;
+  std::size_t m_size_in_bytes = 0;
   std::size_t m_max_capacity = 0;
+  std::size_t m_max_bytes = 0;
   bool m_manual_evict = false;
-};
\ No newline at end of file
+};
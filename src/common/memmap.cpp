@@ -16,6 +16,7 @@
 #if defined(_WIN32)
 #include "windows_headers.h"
 #include <Psapi.h>
+#include <io.h>
 #elif defined(__APPLE__)
 #ifdef __aarch64__
 #include <pthread.h> // pthread_jit_write_protect_np()
@@ -49,6 +50,9 @@ LOG_CHANNEL(MemMap);
 namespace MemMap {
 /// Allocates RWX memory at the specified address.
 static void* AllocateJITMemoryAt(const void* addr, size_t size);
+
+// Size of a huge page on the common hosts, JIT address candidates are aligned to this so the buffer can be promoted.
+static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
 } // namespace MemMap
 
 #ifdef DYNAMIC_HOST_PAGE_SIZE
@@ -148,8 +152,59 @@ const void* MemMap::GetBaseAddress()
   return mi.lpBaseOfDll;
 }
 
+bool MemMap::AdviseHugePages(void* ptr, size_t size)
+{
+  // Windows has no transparent huge pages, large pages have to be requested at allocation time.
+  return false;
+}
+
+static size_t GetLargePageSize()
+{
+  // Large pages need SeLockMemoryPrivilege, which has to be granted to the user through policy. If it hasn't been,
+  // enabling it fails, and we stick to regular pages.
+  static const size_t large_page_size = []() -> size_t {
+    const size_t min_size = GetLargePageMinimum();
+    if (min_size == 0)
+      return 0;
+
+    HANDLE token;
+    if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+      return 0;
+
+    TOKEN_PRIVILEGES tp = {};
+    tp.PrivilegeCount = 1;
+    tp.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+    const bool enabled = (LookupPrivilegeValueW(nullptr, SE_LOCK_MEMORY_NAME, &tp.Privileges[0].Luid) &&
+                          AdjustTokenPrivileges(token, FALSE, &tp, 0, nullptr, nullptr) &&
+                          GetLastError() == ERROR_SUCCESS);
+    CloseHandle(token);
+    if (!enabled)
+      return 0;
+
+    INFO_LOG("Large pages of {} KB are available.", min_size / 1024);
+    return min_size;
+  }();
+
+  return large_page_size;
+}
+
 void* MemMap::AllocateJITMemoryAt(const void* addr, size_t size)
 {
+  // Large pages are committed and locked up front, but the code buffer is touched all over anyway.
+  if (const size_t large_page_size = GetLargePageSize();
+      addr && large_page_size != 0 && (reinterpret_cast<uintptr_t>(addr) % large_page_size) == 0 &&
+      (size % large_page_size) == 0)
+  {
+    if (void* ptr = VirtualAlloc(const_cast<void*>(addr), size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                                 PAGE_EXECUTE_READWRITE))
+    {
+      return ptr;
+    }
+
+    // Physical memory is probably too fragmented, fall back to regular pages.
+    VERBOSE_LOG("VirtualAlloc(MEM_LARGE_PAGES, {}) failed: {}", size, GetLastError());
+  }
+
   void* ptr = static_cast<u8*>(VirtualAlloc(const_cast<void*>(addr), size,
                                             addr ? (MEM_RESERVE | MEM_COMMIT) : MEM_COMMIT, PAGE_EXECUTE_READWRITE));
   if (!ptr && !addr) [[unlikely]]
@@ -364,6 +419,70 @@ bool SharedMemoryMappingArea::Unmap(void* map_base, size_t map_size)
   return true;
 }
 
+const void* MemMap::MapFileReadOnly(std::FILE* fp, size_t size, Error* error)
+{
+  const HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(fp)));
+  const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping)
+  {
+    Error::SetWin32(error, "CreateFileMappingW() failed: ", GetLastError());
+    return nullptr;
+  }
+
+  // The view keeps the mapping object alive.
+  const void* ret = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+  if (!ret)
+    Error::SetWin32(error, "MapViewOfFile() failed: ", GetLastError());
+
+  CloseHandle(mapping);
+  return ret;
+}
+
+void MemMap::UnmapFile(const void* ptr, size_t size)
+{
+  if (!UnmapViewOfFile(ptr))
+    Panic("Failed to unmap file");
+}
+
+void* MemMap::ReserveMemory(size_t size, Error* error)
+{
+  void* ret = VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+  if (!ret)
+    Error::SetWin32(error, "VirtualAlloc() failed: ", GetLastError());
+
+  return ret;
+}
+
+bool MemMap::CommitMemory(void* ptr, size_t size)
+{
+  if (!VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE))
+  {
+    ERROR_LOG("VirtualAlloc(MEM_COMMIT) for {} at {} failed: {}", size, ptr, GetLastError());
+    return false;
+  }
+
+  return true;
+}
+
+void MemMap::DecommitMemory(void* ptr, size_t size)
+{
+  if (!VirtualFree(ptr, size, MEM_DECOMMIT))
+    Panic("Failed to decommit memory");
+}
+
+void MemMap::ReleaseMemory(void* ptr, size_t size)
+{
+  if (!VirtualFree(ptr, 0, MEM_RELEASE))
+    Panic("Failed to release memory");
+}
+
+void MemMap::PrefetchMappedRange(const void* ptr, size_t size)
+{
+  WIN32_MEMORY_RANGE_ENTRY entry = {const_cast<void*>(ptr), size};
+  if (!PrefetchVirtualMemory(GetCurrentProcess(), 1, &entry, 0))
+    WARNING_LOG("PrefetchVirtualMemory() failed: {}", GetLastError());
+}
+
 #elif defined(__APPLE__)
 
 u32 MemMap::GetRuntimePageSize()
@@ -921,6 +1040,10 @@ void* MemMap::AllocateJITMemory(size_t size)
   const size_t max_displacement_from_start = max_displacement - size;
   Assert(size <= max_displacement);
 
+  static constexpr auto AlignDownHugePage = [](const u8* ptr) {
+    return reinterpret_cast<const u8*>(Common::AlignDownPow2(reinterpret_cast<uintptr_t>(ptr), HUGE_PAGE_SIZE));
+  };
+
   // Try to find a region in the max displacement range of the process base address.
   // Assume that the DuckStation binary will at max be some size, release is currently around 12MB on Windows.
   // Therefore the max offset is +/- 12MB + code_size. Try allocating in steps by incrementing the pointer, then if no
@@ -932,8 +1055,8 @@ void* MemMap::AllocateJITMemory(size_t size)
   VERBOSE_LOG("Acceptable address range: {} - {}", static_cast<const void*>(min_address),
               static_cast<const void*>(max_address));
 
-  // Start offset by the expected binary size.
-  for (const u8* current_address = base + assume_binary_size;; current_address += step)
+  // Start offset by the expected binary size. Candidates are aligned to huge pages, so the buffer can be promoted.
+  for (const u8* current_address = AlignDownHugePage(base + assume_binary_size);; current_address += step)
   {
     VERBOSE_LOG("Trying {} (displacement 0x{:X})", static_cast<const void*>(current_address),
                 static_cast<ptrdiff_t>(current_address - base));
@@ -950,7 +1073,7 @@ void* MemMap::AllocateJITMemory(size_t size)
   // Try before (will likely fail).
   if (!ptr && reinterpret_cast<uintptr_t>(base) >= step)
   {
-    for (const u8* current_address = base - step;; current_address -= step)
+    for (const u8* current_address = AlignDownHugePage(base - step);; current_address -= step)
     {
       VERBOSE_LOG("Trying {} (displacement 0x{:X})", static_cast<const void*>(current_address),
                   static_cast<ptrdiff_t>(base - current_address));
@@ -985,3 +1108,84 @@ void* MemMap::AllocateJITMemory(size_t size)
 
   return ptr;
 }
+
+#ifndef _WIN32
+
+const void* MemMap::MapFileReadOnly(std::FILE* fp, size_t size, Error* error)
+{
+  void* ret = mmap(nullptr, size, PROT_READ, MAP_SHARED, fileno(fp), 0);
+  if (ret == MAP_FAILED)
+  {
+    Error::SetErrno(error, "mmap() failed: ", errno);
+    return nullptr;
+  }
+
+  return ret;
+}
+
+void MemMap::UnmapFile(const void* ptr, size_t size)
+{
+  if (munmap(const_cast<void*>(ptr), size) != 0)
+    Panic("Failed to unmap file");
+}
+
+void* MemMap::ReserveMemory(size_t size, Error* error)
+{
+  void* ret = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ret == MAP_FAILED)
+  {
+    Error::SetErrno(error, "mmap() failed: ", errno);
+    return nullptr;
+  }
+
+  return ret;
+}
+
+bool MemMap::CommitMemory(void* ptr, size_t size)
+{
+  // Anonymous pages are only backed once they're touched, so this just makes them accessible.
+  if (mprotect(ptr, size, PROT_READ | PROT_WRITE) != 0)
+  {
+    ERROR_LOG("mprotect() for {} at {} failed: {}", size, ptr, errno);
+    return false;
+  }
+
+  return true;
+}
+
+void MemMap::DecommitMemory(void* ptr, size_t size)
+{
+  // Replacing the mapping drops the pages, and they read as zero when committed again.
+  if (mmap(ptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED)
+    Panic("Failed to decommit memory");
+}
+
+void MemMap::ReleaseMemory(void* ptr, size_t size)
+{
+  if (munmap(ptr, size) != 0)
+    Panic("Failed to release memory");
+}
+
+void MemMap::PrefetchMappedRange(const void* ptr, size_t size)
+{
+  if (madvise(const_cast<void*>(ptr), size, MADV_WILLNEED) != 0)
+    WARNING_LOG("madvise(MADV_WILLNEED) failed: {}", errno);
+}
+
+bool MemMap::AdviseHugePages(void* ptr, size_t size)
+{
+#ifdef MADV_HUGEPAGE
+  // Fails with EINVAL if transparent huge pages are disabled, that's not worth a warning.
+  if (madvise(ptr, size, MADV_HUGEPAGE) != 0)
+  {
+    VERBOSE_LOG("madvise(MADV_HUGEPAGE) failed: {}", errno);
+    return false;
+  }
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+#endif
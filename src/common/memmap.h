@@ -5,6 +5,7 @@
 
 #include "types.h"
 
+#include <cstdio>
 #include <map>
 #include <string>
 
@@ -62,6 +63,27 @@ void* MapSharedMemory(void* handle, size_t offset, void* baseaddr, size_t size,
 void UnmapSharedMemory(void* baseaddr, size_t size);
 bool MemProtect(void* baseaddr, size_t size, PageProtect mode);
 
+/// Maps the first size bytes of an open file read-only. The mapping stays valid after the file is closed.
+const void* MapFileReadOnly(std::FILE* fp, size_t size, Error* error);
+void UnmapFile(const void* ptr, size_t size);
+
+/// Reserves address space without backing it with memory. Pages have to be committed before they're accessed, and
+/// read as zero when first committed.
+void* ReserveMemory(size_t size, Error* error);
+bool CommitMemory(void* ptr, size_t size);
+
+/// Returns the pages to the OS, they must be committed again before being accessed.
+void DecommitMemory(void* ptr, size_t size);
+void ReleaseMemory(void* ptr, size_t size);
+
+/// Hints that a mapped range will be read soon, so it can be paged in ahead of time.
+void PrefetchMappedRange(const void* ptr, size_t size);
+
+/// Hints that a range is hot enough to be worth backing with huge pages, to cut down on TLB misses. Only the
+/// 2MB-aligned parts of the range can be promoted, and pages which are later protected separately get split again.
+/// Returns false if the host doesn't support it, in which case the range stays on regular pages.
+bool AdviseHugePages(void* ptr, size_t size);
+
 /// Returns the base address for the current process.
 const void* GetBaseAddress();
 
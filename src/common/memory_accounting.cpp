@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "memory_accounting.h"
+
+#include <array>
+#include <atomic>
+
+namespace MemoryAccounting {
+namespace {
+
+struct CategoryInfo
+{
+  const char* group;
+  const char* name;
+  const char* identifier;
+};
+
+struct CategoryUsage
+{
+  std::atomic<s64> host_bytes{0};
+  std::atomic<s64> gpu_bytes{0};
+};
+
+} // namespace
+
+static constexpr const std::array<CategoryInfo, NUM_CATEGORIES> s_category_info = {{
+  {"CPU", "Code Buffer", "code_buffer"},
+  {"CPU", "Code Blocks", "code_blocks"},
+  {"System", "Rewind/Runahead States", "rewind_states"},
+  {"CD-ROM", "Precached Image", "cd_precache"},
+  {"GPU", "Texture Cache", "texture_cache"},
+  {"GPU", "Texture Replacements", "texture_replacements"},
+  {"GPU", "Shader Cache", "shader_cache"},
+  {"UI", "Fonts", "fonts"},
+  {"GPU Device", "All Textures", "gpu_textures"},
+}};
+
+static std::array<CategoryUsage, NUM_CATEGORIES> s_usage;
+
+} // namespace MemoryAccounting
+
+const char* MemoryAccounting::GetCategoryGroup(Category category)
+{
+  return s_category_info[static_cast<size_t>(category)].group;
+}
+
+const char* MemoryAccounting::GetCategoryName(Category category)
+{
+  return s_category_info[static_cast<size_t>(category)].name;
+}
+
+const char* MemoryAccounting::GetCategoryIdentifier(Category category)
+{
+  return s_category_info[static_cast<size_t>(category)].identifier;
+}
+
+void MemoryAccounting::Set(Category category, size_t host_bytes, size_t gpu_bytes)
+{
+  CategoryUsage& usage = s_usage[static_cast<size_t>(category)];
+  usage.host_bytes.store(static_cast<s64>(host_bytes), std::memory_order_relaxed);
+  usage.gpu_bytes.store(static_cast<s64>(gpu_bytes), std::memory_order_relaxed);
+}
+
+void MemoryAccounting::Add(Category category, s64 host_delta, s64 gpu_delta)
+{
+  CategoryUsage& usage = s_usage[static_cast<size_t>(category)];
+  if (host_delta != 0)
+    usage.host_bytes.fetch_add(host_delta, std::memory_order_relaxed);
+  if (gpu_delta != 0)
+    usage.gpu_bytes.fetch_add(gpu_delta, std::memory_order_relaxed);
+}
+
+MemoryAccounting::Usage MemoryAccounting::Get(Category category)
+{
+  const CategoryUsage& usage = s_usage[static_cast<size_t>(category)];
+  return Usage{usage.host_bytes.load(std::memory_order_relaxed), usage.gpu_bytes.load(std::memory_order_relaxed)};
+}
+
+MemoryAccounting::Usage MemoryAccounting::GetTotal()
+{
+  Usage total = {0, Get(Category::GPUTextures).gpu_bytes};
+  for (const CategoryUsage& usage : s_usage)
+    total.host_bytes += usage.host_bytes.load(std::memory_order_relaxed);
+  return total;
+}
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#pragma once
+
+#include "types.h"
+
+/// Running totals of the memory held by the larger subsystems, split into host and GPU memory. Subsystems report
+/// their own usage when it changes, from whichever thread owns them, so reading the totals never has to touch
+/// subsystem state.
+namespace MemoryAccounting {
+
+enum class Category : u8
+{
+  CodeBuffer,
+  CodeBlocks,
+  RewindStates,
+  CDPrecache,
+  TextureCache,
+  TextureReplacements,
+  ShaderCache,
+  Fonts,
+
+  // Every texture the device has created, including the GPU memory of the categories above.
+  GPUTextures,
+
+  MaxCount
+};
+
+static constexpr size_t NUM_CATEGORIES = static_cast<size_t>(Category::MaxCount);
+
+struct Usage
+{
+  s64 host_bytes;
+  s64 gpu_bytes;
+};
+
+/// Name of the subsystem the category belongs to, categories are grouped by this in the UI.
+const char* GetCategoryGroup(Category category);
+const char* GetCategoryName(Category category);
+
+/// Short name for machine-readable output.
+const char* GetCategoryIdentifier(Category category);
+
+/// Replaces the usage of a category, for subsystems that can cheaply compute their total.
+void Set(Category category, size_t host_bytes, size_t gpu_bytes);
+
+/// Adjusts the usage of a category, for subsystems that track individual allocations.
+void Add(Category category, s64 host_delta, s64 gpu_delta);
+
+Usage Get(Category category);
+
+/// Host memory is summed across categories. GPU memory is the GPUTextures category, since it already includes the
+/// GPU memory reported by the others.
+Usage GetTotal();
+
+} // namespace MemoryAccounting
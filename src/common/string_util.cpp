@@ -4,6 +4,7 @@
 #include "string_util.h"
 #include "assert.h"
 #include "bitutils.h"
+#include "gsvector.h"
 
 #include <cctype>
 #include <charconv>
@@ -184,16 +185,51 @@ int StringUtil::Strncasecmp(const char* s1, const char* s2, std::size_t n)
 #endif
 }
 
+// The NoCase functions below only fold ASCII, the same as strncasecmp() in the C locale, which lets them work on
+// 16 bytes at a time. Game list sorting and filtering runs them over every entry.
+static constexpr size_t NOCASE_VECTOR_SIZE = 16;
+
+/// Lowercases any ASCII letters in the vector. Everything else, including bytes above 0x7F, is left alone.
+ALWAYS_INLINE static GSVector4i FoldCaseASCII(const GSVector4i v)
+{
+  const GSVector4i is_upper = v.gt8(GSVector4i(0x40404040)) & v.lt8(GSVector4i(0x5B5B5B5B));
+  return v | (is_upper & GSVector4i(0x20202020));
+}
+
+ALWAYS_INLINE static GSVector4i BroadcastChar(char ch)
+{
+  return GSVector4i(static_cast<s32>(0x01010101u * static_cast<u8>(ch)));
+}
+
+/// Returns the offset of the first byte which differs after case folding, or len if they're equal.
+static size_t FindFirstMismatchNoCase(const char* s1, const char* s2, size_t len)
+{
+  size_t i = 0;
+  for (; (i + NOCASE_VECTOR_SIZE) <= len; i += NOCASE_VECTOR_SIZE)
+  {
+    const GSVector4i v1 = FoldCaseASCII(GSVector4i::load<false>(s1 + i));
+    const GSVector4i v2 = FoldCaseASCII(GSVector4i::load<false>(s2 + i));
+    const u32 mismatch = static_cast<u32>(~v1.eq8(v2).mask()) & 0xFFFFu;
+    if (mismatch != 0)
+      return i + CountTrailingZeros(mismatch);
+  }
+
+  for (; i < len; i++)
+  {
+    if (StringUtil::ToLower(s1[i]) != StringUtil::ToLower(s2[i]))
+      return i;
+  }
+
+  return len;
+}
+
 bool StringUtil::EqualNoCase(std::string_view s1, std::string_view s2)
 {
   const size_t s1_len = s1.length();
-  const size_t s2_len = s2.length();
-  if (s1_len != s2_len)
+  if (s1_len != s2.length())
     return false;
-  else if (s1_len == 0)
-    return true;
 
-  return (Strncasecmp(s1.data(), s2.data(), s1_len) == 0);
+  return (FindFirstMismatchNoCase(s1.data(), s2.data(), s1_len) == s1_len);
 }
 
 int StringUtil::CompareNoCase(std::string_view s1, std::string_view s2)
@@ -201,14 +237,69 @@ int StringUtil::CompareNoCase(std::string_view s1, std::string_view s2)
   const size_t s1_len = s1.length();
   const size_t s2_len = s2.length();
   const size_t compare_len = std::min(s1_len, s2_len);
-  const int compare_res = (compare_len > 0) ? Strncasecmp(s1.data(), s2.data(), compare_len) : 0;
-  return (compare_res != 0) ? compare_res : ((s1_len < s2_len) ? -1 : ((s1_len > s2_len) ? 1 : 0));
+  const size_t mismatch = FindFirstMismatchNoCase(s1.data(), s2.data(), compare_len);
+  if (mismatch != compare_len)
+  {
+    // Compare as unsigned, same as strncasecmp().
+    return (static_cast<u8>(ToLower(s1[mismatch])) < static_cast<u8>(ToLower(s2[mismatch]))) ? -1 : 1;
+  }
+
+  return (s1_len < s2_len) ? -1 : ((s1_len > s2_len) ? 1 : 0);
+}
+
+u64 StringUtil::GetNoCaseSortKey(std::string_view str)
+{
+  u64 key = 0;
+  const size_t len = std::min<size_t>(str.length(), sizeof(key));
+  for (size_t i = 0; i < len; i++)
+    key |= static_cast<u64>(static_cast<u8>(ToLower(str[i]))) << (56 - (i * 8));
+  return key;
 }
 
 bool StringUtil::ContainsNoCase(std::string_view s1, std::string_view s2)
 {
-  return (std::search(s1.begin(), s1.end(), s2.begin(), s2.end(),
-                      [](char lhs, char rhs) { return (ToLower(lhs) == ToLower(rhs)); }) != s1.end());
+  const size_t s1_len = s1.length();
+  const size_t s2_len = s2.length();
+  if (s2_len == 0)
+    return (s1_len > 0);
+  else if (s2_len > s1_len)
+    return false;
+
+  // Look for positions where both the first and last characters of the needle match, 16 at a time, and only compare
+  // the whole needle at those. Usually rules out almost every position in the haystack.
+  const char* const haystack = s1.data();
+  const char* const needle = s2.data();
+  const size_t last_start = s1_len - s2_len;
+  const char first_ch = ToLower(needle[0]);
+  const char last_ch = ToLower(needle[s2_len - 1]);
+  const GSVector4i first = BroadcastChar(first_ch);
+  const GSVector4i last = BroadcastChar(last_ch);
+  size_t i = 0;
+  for (; (i + NOCASE_VECTOR_SIZE) <= (last_start + 1); i += NOCASE_VECTOR_SIZE)
+  {
+    const GSVector4i block_first = FoldCaseASCII(GSVector4i::load<false>(haystack + i));
+    const GSVector4i block_last = FoldCaseASCII(GSVector4i::load<false>(haystack + i + s2_len - 1));
+    u32 candidates = static_cast<u32>((block_first.eq8(first) & block_last.eq8(last)).mask()) & 0xFFFFu;
+    while (candidates != 0)
+    {
+      const size_t pos = i + CountTrailingZeros(candidates);
+      if (FindFirstMismatchNoCase(haystack + pos, needle, s2_len) == s2_len)
+        return true;
+
+      candidates &= candidates - 1;
+    }
+  }
+
+  for (; i <= last_start; i++)
+  {
+    if (ToLower(haystack[i]) == first_ch && ToLower(haystack[i + s2_len - 1]) == last_ch &&
+        FindFirstMismatchNoCase(haystack + i, needle, s2_len) == s2_len)
+    {
+      return true;
+    }
+  }
+
+  return false;
 }
 
 /// Wrapper around std::from_chars
@@ -574,14 +665,17 @@ std::string StringUtil::EncodeBase64(const std::span<u8> data)
 
 bool StringUtil::StartsWithNoCase(const std::string_view str, const std::string_view prefix)
 {
-  return (!str.empty() && Strncasecmp(str.data(), prefix.data(), prefix.length()) == 0);
+  const std::size_t prefix_length = prefix.length();
+  return (!str.empty() && str.length() >= prefix_length &&
+          FindFirstMismatchNoCase(str.data(), prefix.data(), prefix_length) == prefix_length);
 }
 
 bool StringUtil::EndsWithNoCase(const std::string_view str, const std::string_view suffix)
 {
   const std::size_t suffix_length = suffix.length();
   return (str.length() >= suffix_length &&
-          Strncasecmp(str.data() + (str.length() - suffix_length), suffix.data(), suffix_length) == 0);
+          FindFirstMismatchNoCase(str.data() + (str.length() - suffix_length), suffix.data(), suffix_length) ==
+            suffix_length);
 }
 
 size_t StringUtil::CountChar(const std::string_view str, char ch)
@@ -635,24 +729,7 @@ std::vector<std::string_view> StringUtil::SplitString(const std::string_view str
                                                       bool skip_empty /*= true*/)
 {
   std::vector<std::string_view> res;
-  std::string_view::size_type last_pos = 0;
-  std::string_view::size_type pos;
-  while (last_pos < str.size() && (pos = str.find(delimiter, last_pos)) != std::string_view::npos)
-  {
-    std::string_view part(StripWhitespace(str.substr(last_pos, pos - last_pos)));
-    if (!skip_empty || !part.empty())
-      res.push_back(std::move(part));
-
-    last_pos = pos + 1;
-  }
-
-  if (last_pos < str.size())
-  {
-    std::string_view part(StripWhitespace(str.substr(last_pos)));
-    if (!skip_empty || !part.empty())
-      res.push_back(std::move(part));
-  }
-
+  SplitStringInto(res, str, delimiter, skip_empty);
   return res;
 }
 
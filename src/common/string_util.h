@@ -51,6 +51,10 @@ bool EqualNoCase(std::string_view s1, std::string_view s2);
 int CompareNoCase(std::string_view s1, std::string_view s2);
 bool ContainsNoCase(std::string_view s1, std::string_view s2);
 
+/// Packs the first eight bytes of the string, lowercased, into an integer. Comparing the keys of two strings gives the
+/// same order as CompareNoCase(), except when the keys are equal, where the full strings still need comparing.
+u64 GetNoCaseSortKey(std::string_view str);
+
 /// Constexpr version of strcmp, suitable for use in static_assert.
 inline constexpr int ConstexprCompare(const char* s1, const char* s2)
 {
@@ -184,6 +188,28 @@ std::string_view StripWhitespace(const std::string_view str);
 void StripWhitespace(std::string* str);
 
 /// Splits a string based on a single character delimiter.
+/// The Into variant appends the parts to an existing container, e.g. one which uses a different allocator.
+template<typename Container>
+void SplitStringInto(Container& res, const std::string_view str, char delimiter, bool skip_empty = true)
+{
+  std::string_view::size_type last_pos = 0;
+  std::string_view::size_type pos;
+  while (last_pos < str.size() && (pos = str.find(delimiter, last_pos)) != std::string_view::npos)
+  {
+    std::string_view part(StripWhitespace(str.substr(last_pos, pos - last_pos)));
+    if (!skip_empty || !part.empty())
+      res.push_back(part);
+
+    last_pos = pos + 1;
+  }
+
+  if (last_pos < str.size())
+  {
+    std::string_view part(StripWhitespace(str.substr(last_pos)));
+    if (!skip_empty || !part.empty())
+      res.push_back(part);
+  }
+}
 [[nodiscard]] std::vector<std::string_view> SplitString(const std::string_view str, char delimiter,
                                                         bool skip_empty = true);
 [[nodiscard]] std::vector<std::string> SplitNewString(const std::string_view str, char delimiter,
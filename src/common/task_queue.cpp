@@ -4,95 +4,268 @@
 #include "task_queue.h"
 #include "assert.h"
 
+#include "fmt/format.h"
+
+thread_local TaskQueue::Worker* TaskQueue::s_current_worker = nullptr;
+
+TaskQueue::Group::Group() = default;
+
+TaskQueue::Group::~Group()
+{
+  // The last task holds the lock until it's finished with the group, so it can't be destroyed underneath it.
+  std::unique_lock lock(m_mutex);
+  Assert(m_outstanding.load(std::memory_order_acquire) == 0);
+}
+
+bool TaskQueue::Group::IsDone() const
+{
+  return (m_outstanding.load(std::memory_order_acquire) == 0);
+}
+
 TaskQueue::TaskQueue() = default;
 
 TaskQueue::~TaskQueue()
 {
   SetWorkerCount(0);
-  Assert(m_tasks.empty());
+  Assert(m_outstanding_tasks.load(std::memory_order_acquire) == 0);
 }
 
 void TaskQueue::SetWorkerCount(u32 count)
 {
-  std::unique_lock lock(m_mutex);
-
-  WaitForAll(lock);
+  WaitForAll();
 
-  if (!m_threads.empty())
+  if (!m_workers.empty())
   {
-    m_threads_done = true;
-    m_task_wait_cv.notify_all();
-
-    auto threads = std::move(m_threads);
-    m_threads = decltype(threads)();
+    {
+      std::unique_lock lock(m_wake_mutex);
+      m_threads_done = true;
+    }
+    m_wake_cv.notify_all();
 
-    lock.unlock();
-    for (std::thread& t : threads)
-      t.join();
-    lock.lock();
+    for (const std::unique_ptr<Worker>& worker : m_workers)
+      worker->thread.join();
+    m_workers.clear();
   }
 
   if (count > 0)
   {
     m_threads_done = false;
+
+    // Create all the workers before starting any threads, since they steal from each other.
+    m_workers.reserve(count);
     for (u32 i = 0; i < count; i++)
-      m_threads.emplace_back(&TaskQueue::WorkerThreadEntryPoint, this);
+    {
+      std::unique_ptr<Worker>& worker = m_workers.emplace_back(std::make_unique<Worker>());
+      worker->queue = this;
+      worker->index = i;
+    }
+    for (const std::unique_ptr<Worker>& worker : m_workers)
+      worker->thread = std::thread(&TaskQueue::WorkerThreadEntryPoint, this, worker.get());
   }
 }
 
-void TaskQueue::SubmitTask(TaskFunctionType func)
+void TaskQueue::SubmitTask(Task task, Priority priority, Group* group)
 {
-  std::unique_lock lock(m_mutex);
-  m_tasks.push_back(std::move(func));
-  m_tasks_outstanding++;
-  m_task_wait_cv.notify_one();
+  if (group)
+    group->m_outstanding.fetch_add(1, std::memory_order_acq_rel);
+  m_outstanding_tasks.fetch_add(1, std::memory_order_acq_rel);
+
+  // Counted before it's visible, so that the pending count can't go negative. A worker which sees the count before
+  // the push just tries again.
+  m_pending_tasks.fetch_add(1);
+
+  // Tasks submitted from a worker go on its own deque, where they're likely to be picked up while the data they use
+  // is still in that core's cache.
+  QueuedTask qtask = {std::move(task), group};
+  if (Worker* const self = GetCurrentWorker())
+  {
+    std::unique_lock lock(self->mutex);
+    self->tasks[static_cast<size_t>(priority)].push_back(std::move(qtask));
+  }
+  else
+  {
+    std::unique_lock lock(m_mutex);
+    m_tasks[static_cast<size_t>(priority)].push_back(std::move(qtask));
+  }
+
+  // Lock so that a worker which has just checked the pending count can't miss the wakeup.
+  {
+    std::unique_lock lock(m_wake_mutex);
+  }
+  m_wake_cv.notify_one();
+
+  // Threads blocked in WaitForAll() help out with the new task, a nested wait could otherwise deadlock.
+  if (m_done_waiters.load() > 0)
+    NotifyDone();
+}
+
+void TaskQueue::SubmitContinuation(Group& group, Task task, Priority priority)
+{
+  {
+    std::unique_lock lock(group.m_mutex);
+    if (!group.IsDone())
+    {
+      group.m_continuations.emplace_back(std::move(task), priority);
+      return;
+    }
+  }
+
+  SubmitTask(std::move(task), priority, nullptr);
 }
 
 void TaskQueue::WaitForAll()
 {
-  std::unique_lock lock(m_mutex);
-  WaitForAll(lock);
+  WaitForCounter(m_outstanding_tasks);
 }
 
-void TaskQueue::WaitForAll(std::unique_lock<std::mutex>& lock)
+void TaskQueue::WaitForAll(Group& group)
 {
-  // while we're waiting, execute work on the calling thread
-  m_tasks_done_cv.wait(lock, [this, &lock]() {
-    if (m_tasks_outstanding == 0)
-      return true;
+  WaitForCounter(group.m_outstanding);
+}
 
-    while (!m_tasks.empty())
-      ExecuteOneTask(lock);
+bool TaskQueue::TryGetTask(Worker* self, QueuedTask* task)
+{
+  if (m_pending_tasks.load(std::memory_order_acquire) == 0)
+    return false;
 
-    return (m_tasks_outstanding == 0);
-  });
+  const size_t num_workers = m_workers.size();
+  for (u32 priority = 0; priority < NUM_PRIORITIES; priority++)
+  {
+    if (self)
+    {
+      std::unique_lock lock(self->mutex);
+      std::deque<QueuedTask>& deque = self->tasks[priority];
+      if (!deque.empty())
+      {
+        *task = std::move(deque.back());
+        deque.pop_back();
+        m_pending_tasks.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+      }
+    }
+
+    {
+      std::unique_lock lock(m_mutex);
+      std::deque<QueuedTask>& deque = m_tasks[priority];
+      if (!deque.empty())
+      {
+        *task = std::move(deque.front());
+        deque.pop_front();
+        m_pending_tasks.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+      }
+    }
+
+    // Start stealing from the next worker along, so that the workers don't all go after the same victim.
+    const size_t start = self ? (self->index + 1) : 0;
+    for (size_t i = 0; i < num_workers; i++)
+    {
+      Worker* const victim = m_workers[(start + i) % num_workers].get();
+      if (victim == self)
+        continue;
+
+      std::unique_lock lock(victim->mutex);
+      std::deque<QueuedTask>& deque = victim->tasks[priority];
+      if (!deque.empty())
+      {
+        *task = std::move(deque.front());
+        deque.pop_front();
+        m_pending_tasks.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+      }
+    }
+  }
+
+  return false;
 }
 
-void TaskQueue::ExecuteOneTask(std::unique_lock<std::mutex>& lock)
+void TaskQueue::ExecuteTask(QueuedTask& task)
 {
-  TaskFunctionType func = std::move(m_tasks.front());
-  m_tasks.pop_front();
-  lock.unlock();
-  func();
-  lock.lock();
-  m_tasks_outstanding--;
-  if (m_tasks_outstanding == 0)
-    m_tasks_done_cv.notify_all();
+  task.func();
+  task.func = Task();
+
+  // Group first, so that its continuations are counted before the outstanding count can reach zero.
+  bool notify = false;
+  if (task.group && OnGroupTaskDone(*task.group))
+    notify = true;
+
+  if (m_outstanding_tasks.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    notify = true;
+
+  if (notify)
+    NotifyDone();
 }
 
-void TaskQueue::WorkerThreadEntryPoint()
+bool TaskQueue::OnGroupTaskDone(Group& group)
 {
-  Threading::SetNameOfCurrentThread("TaskQueue Worker");
+  // Once the count reaches zero, the group can be destroyed by a waiter, so the continuations have to be taken
+  // before then. The waiter can't get past the group's destructor until we release the lock.
+  std::vector<std::pair<Task, Priority>> continuations;
+  {
+    std::unique_lock lock(group.m_mutex);
+    if (group.m_outstanding.fetch_sub(1, std::memory_order_acq_rel) != 1)
+      return false;
 
-  std::unique_lock lock(m_mutex);
-  while (!m_threads_done)
+    continuations.swap(group.m_continuations);
+  }
+
+  for (auto& [task, priority] : continuations)
+    SubmitTask(std::move(task), priority, nullptr);
+
+  return true;
+}
+
+void TaskQueue::WaitForCounter(const std::atomic<u32>& counter)
+{
+  // While we're waiting, execute work on the calling thread.
+  Worker* const self = GetCurrentWorker();
+  while (counter.load(std::memory_order_acquire) != 0)
   {
-    if (m_tasks.empty())
+    QueuedTask task;
+    if (TryGetTask(self, &task))
     {
-      m_task_wait_cv.wait(lock);
+      ExecuteTask(task);
       continue;
     }
 
-    ExecuteOneTask(lock);
+    // Everything left is running on other threads, but any tasks they queue in the meantime need to wake us too.
+    std::unique_lock lock(m_done_mutex);
+    m_done_waiters.fetch_add(1);
+    m_done_cv.wait(lock, [this, &counter]() {
+      return (counter.load(std::memory_order_acquire) == 0 || m_pending_tasks.load() > 0);
+    });
+    m_done_waiters.fetch_sub(1);
+  }
+}
+
+void TaskQueue::NotifyDone()
+{
+  {
+    std::unique_lock lock(m_done_mutex);
   }
+  m_done_cv.notify_all();
+}
+
+void TaskQueue::WorkerThreadEntryPoint(Worker* worker)
+{
+  Threading::SetNameOfCurrentThread(fmt::format("TaskQueue Worker {}", worker->index).c_str());
+  Threading::ApplyBackgroundWorkerAffinity();
+  s_current_worker = worker;
+
+  for (;;)
+  {
+    QueuedTask task;
+    if (TryGetTask(worker, &task))
+    {
+      ExecuteTask(task);
+      continue;
+    }
+
+    std::unique_lock lock(m_wake_mutex);
+    m_wake_cv.wait(lock, [this]() { return (m_threads_done || m_pending_tasks.load(std::memory_order_acquire) > 0); });
+    if (m_threads_done)
+      break;
+  }
+
+  s_current_worker = nullptr;
 }
@@ -6,19 +6,142 @@
 #include "threading.h"
 #include "types.h"
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
+#include <cstddef>
 #include <deque>
-#include <functional>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-/// Implements a simple task queue with multiple worker threads.
+/// Implements a work-stealing task queue with multiple worker threads.
+///
+/// Each worker has its own deques, which it pops from newest-first, and idle workers steal the oldest tasks from
+/// the others. Tasks submitted from outside the pool go to a shared queue. Interactive tasks are always picked
+/// before background tasks, so long-running work doesn't hold up anything the user is waiting on.
 class TaskQueue
 {
 public:
-  using TaskFunctionType = std::function<void()>;
+  enum class Priority : u8
+  {
+    Interactive,
+    Background,
+    MaxCount
+  };
+
+  /// Type-erased callable. Small callables are stored inline, so submitting a lambda with a few captures doesn't
+  /// need a heap allocation, larger ones fall back to the heap.
+  class Task
+  {
+  public:
+    static constexpr size_t INLINE_STORAGE_SIZE = 64 - sizeof(void*);
+
+    Task() = default;
+
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+    Task(F&& func)
+    {
+      using T = std::decay_t<F>;
+      if constexpr (sizeof(T) <= INLINE_STORAGE_SIZE && alignof(T) <= alignof(std::max_align_t) &&
+                    std::is_nothrow_move_constructible_v<T>)
+      {
+        new (m_storage) T(std::forward<F>(func));
+        m_ops = &s_inline_ops<T>;
+      }
+      else
+      {
+        *reinterpret_cast<T**>(m_storage) = new T(std::forward<F>(func));
+        m_ops = &s_heap_ops<T>;
+      }
+    }
+
+    Task(Task&& move) noexcept : m_ops(std::exchange(move.m_ops, nullptr))
+    {
+      if (m_ops)
+        m_ops->move(m_storage, move.m_storage);
+    }
+
+    ~Task()
+    {
+      if (m_ops)
+        m_ops->destroy(m_storage);
+    }
+
+    Task& operator=(Task&& move) noexcept
+    {
+      if (this != &move)
+      {
+        if (m_ops)
+          m_ops->destroy(m_storage);
+        m_ops = std::exchange(move.m_ops, nullptr);
+        if (m_ops)
+          m_ops->move(m_storage, move.m_storage);
+      }
+
+      return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ALWAYS_INLINE explicit operator bool() const { return (m_ops != nullptr); }
+    ALWAYS_INLINE void operator()() { m_ops->invoke(m_storage); }
+
+  private:
+    struct Ops
+    {
+      void (*invoke)(void* storage);
+      void (*move)(void* dst, void* src); // Also destroys src.
+      void (*destroy)(void* storage);
+    };
+
+    template<typename T>
+    static constexpr Ops s_inline_ops = {
+      [](void* storage) { (*static_cast<T*>(storage))(); },
+      [](void* dst, void* src) {
+        new (dst) T(std::move(*static_cast<T*>(src)));
+        static_cast<T*>(src)->~T();
+      },
+      [](void* storage) { static_cast<T*>(storage)->~T(); },
+    };
+
+    template<typename T>
+    static constexpr Ops s_heap_ops = {
+      [](void* storage) { (**static_cast<T**>(storage))(); },
+      [](void* dst, void* src) { *static_cast<T**>(dst) = *static_cast<T**>(src); },
+      [](void* storage) { delete *static_cast<T**>(storage); },
+    };
+
+    alignas(std::max_align_t) u8 m_storage[INLINE_STORAGE_SIZE];
+    const Ops* m_ops = nullptr;
+  };
+
+  /// Tracks a set of tasks, so that they can be waited on together, or followed up by continuations. Must outlive
+  /// the tasks submitted to it.
+  class Group
+  {
+  public:
+    Group();
+    ~Group();
+
+    Group(const Group&) = delete;
+    Group& operator=(const Group&) = delete;
+
+    /// Returns true if all tasks that were submitted to the group have completed.
+    bool IsDone() const;
+
+  private:
+    friend TaskQueue;
+
+    std::atomic<u32> m_outstanding{0};
+    std::mutex m_mutex;
+    std::vector<std::pair<Task, Priority>> m_continuations;
+  };
 
   TaskQueue();
   ~TaskQueue();
@@ -30,30 +153,92 @@ public:
 
   /// Submits a task to the queue for execution.
   /// @param func The task function to execute.
-  void SubmitTask(TaskFunctionType func);
+  /// @param priority Interactive tasks are always run before background tasks.
+  /// @param group Optional group to add the task to.
+  template<typename F>
+  void SubmitTask(F&& func, Priority priority = Priority::Interactive, Group* group = nullptr)
+  {
+    SubmitTask(Task(std::forward<F>(func)), priority, group);
+  }
+  void SubmitTask(Task task, Priority priority = Priority::Interactive, Group* group = nullptr);
+
+  /// Submits a task which is queued once all tasks in the group have completed, or immediately if it is already done.
+  /// Continuations aren't part of the group themselves.
+  template<typename F>
+  void SubmitContinuation(Group& group, F&& func, Priority priority = Priority::Interactive)
+  {
+    SubmitContinuation(group, Task(std::forward<F>(func)), priority);
+  }
+  void SubmitContinuation(Group& group, Task task, Priority priority = Priority::Interactive);
 
   /// Waits for all submitted tasks to complete execution.
   void WaitForAll();
 
+  /// Waits for all tasks in the group to complete execution. Continuations of the group may still be pending.
+  void WaitForAll(Group& group);
+
 private:
-  /// Waits for all submitted tasks to complete execution.
-  /// This is a helper function that assumes a lock is already held.
-  /// @param lock A unique_lock object holding the mutex.
-  void WaitForAll(std::unique_lock<std::mutex>& lock);
+  static constexpr u32 NUM_PRIORITIES = static_cast<u32>(Priority::MaxCount);
+
+  struct QueuedTask
+  {
+    Task func;
+    Group* group = nullptr;
+  };
+
+  using TaskDeques = std::array<std::deque<QueuedTask>, NUM_PRIORITIES>;
+
+  struct Worker
+  {
+    TaskQueue* queue;
+    u32 index;
+    std::mutex mutex;
+    TaskDeques tasks;
+    std::thread thread;
+  };
+
+  /// Returns the worker state for the calling thread, if it belongs to this queue.
+  ALWAYS_INLINE Worker* GetCurrentWorker() const
+  {
+    return (s_current_worker && s_current_worker->queue == this) ? s_current_worker : nullptr;
+  }
 
-  /// Executes one task from the queue.
-  /// This is a helper function that assumes a lock is already held.
-  /// @param lock A unique_lock object holding the mutex.
-  void ExecuteOneTask(std::unique_lock<std::mutex>& lock);
+  /// Pops a task from the calling worker's own deques, the shared queue, or finally another worker, in that order
+  /// for each priority.
+  bool TryGetTask(Worker* self, QueuedTask* task);
 
-  /// Entry point for worker threads. Executes tasks from the queue until termination is signaled.
-  void WorkerThreadEntryPoint();
+  /// Runs the task, and signals any waiters if it was the last one outstanding.
+  void ExecuteTask(QueuedTask& task);
 
+  /// Releases a task's reference to its group, and queues any continuations if it was the last one outstanding.
+  /// Returns true if the group completed.
+  bool OnGroupTaskDone(Group& group);
+
+  /// Runs tasks on the calling thread until counter reaches zero.
+  void WaitForCounter(const std::atomic<u32>& counter);
+
+  /// Notifies waiters on m_done_cv, without racing with them checking their condition.
+  void NotifyDone();
+
+  /// Entry point for worker threads. Executes tasks until termination is signaled.
+  void WorkerThreadEntryPoint(Worker* worker);
+
+  // Tasks submitted from outside the pool.
   std::mutex m_mutex;
-  std::deque<TaskFunctionType> m_tasks;
-  size_t m_tasks_outstanding = 0;
-  std::condition_variable m_task_wait_cv;
-  std::condition_variable m_tasks_done_cv;
-  std::vector<std::thread> m_threads;
+  TaskDeques m_tasks;
+
+  std::vector<std::unique_ptr<Worker>> m_workers;
+
+  // Queued but not yet started, and queued or running.
+  std::atomic<u32> m_pending_tasks{0};
+  std::atomic<u32> m_outstanding_tasks{0};
+
+  std::mutex m_wake_mutex;
+  std::condition_variable m_wake_cv;
+  std::mutex m_done_mutex;
+  std::condition_variable m_done_cv;
+  std::atomic<u32> m_done_waiters{0};
   bool m_threads_done = false;
+
+  static thread_local Worker* s_current_worker;
 };
@@ -3,12 +3,21 @@
 
 #include "threading.h"
 #include "assert.h"
+#include "bitutils.h"
+#include "event_trace.h"
 #include "log.h"
 
 #ifdef __APPLE__
 #include "cocoa_tools.h"
 #endif
 
+#ifdef __linux__
+#include "file_system.h"
+#include "small_string.h"
+#include "string_util.h"
+#endif
+
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -110,6 +119,233 @@ void Threading::Timeslice()
 #endif
 }
 
+namespace Threading {
+namespace {
+struct ProcessorInfo
+{
+  u32 index;
+  u32 core_id;
+  u32 capacity; // Relative performance, higher is faster. Only compared against other processors.
+};
+} // namespace
+
+static ProcessorTopology BuildProcessorTopology(std::vector<ProcessorInfo> processors);
+static ProcessorTopology DetectProcessorTopology();
+
+static std::atomic<u64> s_background_worker_affinity{0};
+} // namespace Threading
+
+Threading::ProcessorTopology Threading::BuildProcessorTopology(std::vector<ProcessorInfo> processors)
+{
+  ProcessorTopology ret;
+  std::erase_if(processors, [](const ProcessorInfo& pi) { return (pi.index >= 64); });
+  if (processors.empty())
+    return ret;
+
+  // Only the slowest class counts as efficiency cores, so a prime/big/little layout keeps its big cores.
+  const auto [min_it, max_it] = std::minmax_element(
+    processors.begin(), processors.end(),
+    [](const ProcessorInfo& lhs, const ProcessorInfo& rhs) { return (lhs.capacity < rhs.capacity); });
+  const bool hybrid = (min_it->capacity != max_it->capacity);
+  const u32 efficiency_capacity = min_it->capacity;
+
+  std::stable_sort(processors.begin(), processors.end(), [](const ProcessorInfo& lhs, const ProcessorInfo& rhs) {
+    return (lhs.capacity > rhs.capacity || (lhs.capacity == rhs.capacity && lhs.index < rhs.index));
+  });
+
+  std::vector<u32> seen_cores;
+  for (const ProcessorInfo& pi : processors)
+  {
+    const u64 bit = static_cast<u64>(1) << pi.index;
+    const bool first_in_core = (std::find(seen_cores.begin(), seen_cores.end(), pi.core_id) == seen_cores.end());
+    if (first_in_core)
+      seen_cores.push_back(pi.core_id);
+
+    ret.num_logical_processors++;
+    if (hybrid && pi.capacity == efficiency_capacity)
+    {
+      ret.efficiency_processors_mask |= bit;
+      ret.num_efficiency_cores += BoolToUInt32(first_in_core);
+    }
+    else
+    {
+      ret.performance_processors_mask |= bit;
+      if (first_in_core)
+        ret.performance_cores.push_back(pi.index);
+    }
+  }
+
+  return ret;
+}
+
+#if defined(_WIN32)
+
+Threading::ProcessorTopology Threading::DetectProcessorTopology()
+{
+  ULONG length = 0;
+  GetSystemCpuSetInformation(nullptr, 0, &length, GetCurrentProcess(), 0);
+  if (length == 0)
+    return {};
+
+  std::unique_ptr<u8[]> buffer = std::make_unique<u8[]>(length);
+  if (!GetSystemCpuSetInformation(reinterpret_cast<PSYSTEM_CPU_SET_INFORMATION>(buffer.get()), length, &length,
+                                  GetCurrentProcess(), 0))
+  {
+    WARNING_LOG("GetSystemCpuSetInformation() failed: {}", GetLastError());
+    return {};
+  }
+
+  // Efficiency class is higher for faster cores, and is the same for every core on non-hybrid CPUs.
+  std::vector<ProcessorInfo> processors;
+  for (ULONG offset = 0; offset < length;)
+  {
+    const SYSTEM_CPU_SET_INFORMATION* info = reinterpret_cast<const SYSTEM_CPU_SET_INFORMATION*>(&buffer[offset]);
+    if (info->Size == 0)
+      break;
+
+    if (info->Type == CpuSetInformation && info->CpuSet.Group == 0)
+    {
+      processors.push_back(ProcessorInfo{info->CpuSet.LogicalProcessorIndex, info->CpuSet.CoreIndex,
+                                         info->CpuSet.EfficiencyClass});
+    }
+
+    offset += info->Size;
+  }
+
+  return BuildProcessorTopology(std::move(processors));
+}
+
+#elif defined(__linux__)
+
+static u64 ParseCPUList(std::string_view list)
+{
+  // Lists look like "0-3,8,10-11".
+  u64 mask = 0;
+  for (const std::string_view range : StringUtil::SplitString(StringUtil::StripWhitespace(list), ',', true))
+  {
+    const std::string_view::size_type dash = range.find('-');
+    const std::optional<u32> first = StringUtil::FromChars<u32>(range.substr(0, dash));
+    const std::optional<u32> last =
+      (dash != std::string_view::npos) ? StringUtil::FromChars<u32>(range.substr(dash + 1)) : first;
+    if (!first.has_value() || !last.has_value())
+      continue;
+
+    for (u32 i = first.value(); i <= std::min(last.value(), 63u); i++)
+      mask |= static_cast<u64>(1) << i;
+  }
+
+  return mask;
+}
+
+Threading::ProcessorTopology Threading::DetectProcessorTopology()
+{
+  const u64 online_mask = ParseCPUList(FileSystem::ReadFileToString("/sys/devices/system/cpu/online").value_or(""));
+
+  // ARM exposes the scheduler's capacity for each processor. Intel hybrid parts don't, but list their E-cores instead.
+  const u64 atom_mask = ParseCPUList(FileSystem::ReadFileToString("/sys/devices/cpu_atom/cpus").value_or(""));
+
+  std::vector<ProcessorInfo> processors;
+  SmallString path;
+  for (u64 remaining = online_mask; remaining != 0; remaining &= (remaining - 1))
+  {
+    const u32 index = CountTrailingZeros(remaining);
+
+    path.format("/sys/devices/system/cpu/cpu{}/topology/thread_siblings_list", index);
+    const u64 siblings = ParseCPUList(FileSystem::ReadFileToString(path.c_str()).value_or(""));
+
+    path.format("/sys/devices/system/cpu/cpu{}/cpu_capacity", index);
+    const std::optional<u32> capacity =
+      StringUtil::FromChars<u32>(StringUtil::StripWhitespace(FileSystem::ReadFileToString(path.c_str()).value_or("")));
+
+    processors.push_back(
+      ProcessorInfo{index, (siblings != 0) ? CountTrailingZeros(siblings) : index,
+                    capacity.value_or(BoolToUInt32((atom_mask & (static_cast<u64>(1) << index)) == 0))});
+  }
+
+  return BuildProcessorTopology(std::move(processors));
+}
+
+#else
+
+Threading::ProcessorTopology Threading::DetectProcessorTopology()
+{
+  // No affinity control on MacOS, so there's little point in knowing.
+  return {};
+}
+
+#endif
+
+const Threading::ProcessorTopology& Threading::GetProcessorTopology()
+{
+  static const ProcessorTopology topology = DetectProcessorTopology();
+  return topology;
+}
+
+bool Threading::SetCurrentThreadRealtimePriority(bool enabled)
+{
+#if defined(_WIN32)
+  // MMCSS boosts registered threads into the real-time priority range. avrt isn't linked, since it's optional.
+  using PFNAVSETMMTHREADCHARACTERISTICSW = HANDLE(WINAPI*)(LPCWSTR, LPDWORD);
+  using PFNAVREVERTMMTHREADCHARACTERISTICS = BOOL(WINAPI*)(HANDLE);
+  static const HMODULE avrt = LoadLibraryW(L"avrt.dll");
+  static const auto set_characteristics = avrt ? reinterpret_cast<PFNAVSETMMTHREADCHARACTERISTICSW>(
+                                                   GetProcAddress(avrt, "AvSetMmThreadCharacteristicsW")) :
+                                                 nullptr;
+  static const auto revert_characteristics = avrt ? reinterpret_cast<PFNAVREVERTMMTHREADCHARACTERISTICS>(
+                                                      GetProcAddress(avrt, "AvRevertMmThreadCharacteristics")) :
+                                                    nullptr;
+  static thread_local HANDLE mmcss_handle = nullptr;
+  if (!set_characteristics || !revert_characteristics)
+    return false;
+
+  if (enabled == (mmcss_handle != nullptr))
+    return true;
+
+  if (!enabled)
+  {
+    revert_characteristics(mmcss_handle);
+    mmcss_handle = nullptr;
+    return true;
+  }
+
+  DWORD task_index = 0;
+  mmcss_handle = set_characteristics(L"Games", &task_index);
+  if (!mmcss_handle)
+  {
+    WARNING_LOG("AvSetMmThreadCharacteristicsW() failed: {}", GetLastError());
+    return false;
+  }
+
+  return true;
+#elif defined(__linux__)
+  // Lowest FIFO priority is enough to run ahead of every regular thread.
+  sched_param param = {};
+  param.sched_priority = enabled ? sched_get_priority_min(SCHED_FIFO) : 0;
+  const int res = pthread_setschedparam(pthread_self(), enabled ? SCHED_FIFO : SCHED_OTHER, &param);
+  if (res != 0)
+  {
+    WARNING_LOG("pthread_setschedparam({}) failed: {}", enabled ? "SCHED_FIFO" : "SCHED_OTHER", res);
+    return false;
+  }
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+void Threading::SetBackgroundWorkerAffinity(u64 processor_mask)
+{
+  s_background_worker_affinity.store(processor_mask, std::memory_order_relaxed);
+}
+
+void Threading::ApplyBackgroundWorkerAffinity()
+{
+  const u64 processor_mask = s_background_worker_affinity.load(std::memory_order_relaxed);
+  if (processor_mask != 0)
+    ThreadHandle::GetForCallingThread().SetAffinity(processor_mask);
+}
+
 Threading::ThreadHandle::ThreadHandle() = default;
 
 #ifdef _WIN32
@@ -258,7 +494,7 @@ bool Threading::ThreadHandle::SetAffinity(u64 processor_mask) const
   if (processor_mask == 0)
     processor_mask = ~processor_mask;
 
-  return (SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)processor_mask) != 0 || GetLastError() != ERROR_SUCCESS);
+  return (SetThreadAffinityMask((HANDLE)m_native_handle, (DWORD_PTR)processor_mask) != 0);
 #elif defined(__linux__)
   cpu_set_t set;
   CPU_ZERO(&set);
@@ -626,6 +862,8 @@ void Threading::SetNameOfCurrentThread(const char* name)
 #else
   pthread_set_name_np(pthread_self(), name);
 #endif
+
+  EventTrace::SetThreadName(name);
 }
 
 Threading::KernelSemaphore::KernelSemaphore()
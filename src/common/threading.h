@@ -12,6 +12,7 @@
 
 #include <atomic>
 #include <functional>
+#include <vector>
 
 namespace Threading {
 extern u64 GetThreadCpuTime();
@@ -23,6 +24,35 @@ extern void SetNameOfCurrentThread(const char* name);
 // Releases a timeslice to other threads.
 extern void Timeslice();
 
+/// Layout of the host's processors, as far as placing threads goes. Only the first 64 logical processors (processor
+/// group 0 on Windows) are considered, since that's all an affinity mask can hold.
+struct ProcessorTopology
+{
+  /// First logical processor of each performance core, fastest first. On non-hybrid CPUs, every core is listed.
+  std::vector<u32> performance_cores;
+
+  /// All logical processors belonging to performance/efficiency cores. No efficiency processors if not hybrid.
+  u64 performance_processors_mask = 0;
+  u64 efficiency_processors_mask = 0;
+
+  u32 num_efficiency_cores = 0;
+  u32 num_logical_processors = 0;
+
+  bool IsHybrid() const { return (efficiency_processors_mask != 0); }
+};
+
+/// Returns the processor topology, which is detected on first use. Empty if the platform doesn't expose it.
+extern const ProcessorTopology& GetProcessorTopology();
+
+/// Raises or restores the scheduling priority of the calling thread, for threads with real-time deadlines. Uses MMCSS
+/// on Windows, and SCHED_FIFO on Linux, which is only allowed if the user has an RLIMIT_RTPRIO allowance.
+extern bool SetCurrentThreadRealtimePriority(bool enabled);
+
+/// Processors which background worker threads should be restricted to, zero for no restriction. Workers pick this up
+/// when they start by calling ApplyBackgroundWorkerAffinity(), so changing it doesn't move already-running workers.
+extern void SetBackgroundWorkerAffinity(u64 processor_mask);
+extern void ApplyBackgroundWorkerAffinity();
+
 // --------------------------------------------------------------------------------------
 //  ThreadHandle
 // --------------------------------------------------------------------------------------
@@ -27,6 +27,7 @@
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/heap_array.h"
+#include "common/heterogeneous_containers.h"
 #include "common/log.h"
 #include "common/md5_digest.h"
 #include "common/path.h"
@@ -126,8 +127,8 @@ static void OnHardcoreModeChanged(bool enabled, bool display_message, bool displ
 static bool IsRAIntegrationInitializing();
 static void FinishInitialize();
 static void FinishLogin();
-static bool IdentifyGame(CDImage* image);
-static bool IdentifyCurrentGame();
+static void SetRunningGame(CDImage* image, const std::optional<GameHash>& game_hash);
+static bool IdentifyGame();
 static void BeginLoadGame();
 static void UpdateGameSummary(bool update_progress_database);
 static DynamicHeapArray<u8> SaveStateToBuffer();
@@ -136,6 +137,8 @@ static bool SaveStateToBuffer(std::span<u8> data);
 static std::string GetImageURL(const char* image_name, u32 type);
 static std::string GetLocalImagePath(const std::string_view image_name, u32 type);
 static void DownloadImage(std::string url, std::string cache_path);
+static bool IsImageCached(std::string_view cache_path);
+static void LoadImageCacheIndex();
 
 static TinyString DecryptLoginToken(std::string_view encrypted_token, std::string_view username);
 static TinyString EncryptLoginToken(std::string_view token, std::string_view username);
@@ -237,6 +240,11 @@ struct State
   std::unique_ptr<HTTPDownloader> http_downloader;
 
   std::string game_path;
+
+  // running disc as reported by System, kept while inactive so it can be identified later without reading it again
+  std::string running_game_path;
+  std::optional<GameHash> running_game_hash;
+  bool running_game_has_image = false;
   std::string game_title;
   std::string game_icon;
   std::string game_icon_url;
@@ -261,9 +269,20 @@ struct State
 #endif
 };
 
+// The image cache is used from the UI threads without the client lock, so it has its own.
+struct ImageCacheState
+{
+  std::mutex mutex;
+  UnorderedStringSet files;    // file names present in the cache directory
+  UnorderedStringSet pending;  // cache paths with a download in flight
+  UnorderedStringSet failed;   // urls which couldn't be downloaded, not retried until restart
+  bool index_loaded = false;
+};
+
 } // namespace
 
 ALIGN_TO_CACHE_LINE static State s_state;
+static ImageCacheState s_image_cache;
 
 } // namespace Achievements
 
@@ -433,26 +452,80 @@ std::string Achievements::GetLocalImagePath(const std::string_view image_name, u
   return ret;
 }
 
+void Achievements::LoadImageCacheIndex()
+{
+  if (s_image_cache.index_loaded)
+    return;
+
+  s_image_cache.index_loaded = true;
+
+  // one directory listing up front is much cheaper than a stat for every badge on every lookup
+  FileSystem::FindResultsArray files;
+  FileSystem::FindFiles(Path::Combine(EmuFolders::Cache, CACHE_SUBDIRECTORY_NAME).c_str(), "*.png",
+                        FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_RELATIVE_PATHS, &files);
+  s_image_cache.files.reserve(files.size());
+  for (FILESYSTEM_FIND_DATA& fd : files)
+  {
+    if (fd.Size > 0)
+      s_image_cache.files.insert(std::move(fd.FileName));
+  }
+
+  DEV_LOG("Found {} cached achievement images", s_image_cache.files.size());
+}
+
+bool Achievements::IsImageCached(std::string_view cache_path)
+{
+  std::unique_lock lock(s_image_cache.mutex);
+  LoadImageCacheIndex();
+  return s_image_cache.files.contains(Path::GetFileName(cache_path));
+}
+
 void Achievements::DownloadImage(std::string url, std::string cache_path)
 {
-  auto callback = [cache_path = std::move(cache_path)](s32 status_code, const Error& error,
-                                                       const std::string& content_type,
-                                                       HTTPDownloader::Request::Data data) mutable {
+  {
+    std::unique_lock lock(s_image_cache.mutex);
+    LoadImageCacheIndex();
+
+    // the same badge tends to be requested from several places at once, e.g. the list and a notification
+    if (s_image_cache.files.contains(Path::GetFileName(cache_path)) || s_image_cache.pending.contains(cache_path) ||
+        s_image_cache.failed.contains(url))
+    {
+      return;
+    }
+
+    s_image_cache.pending.insert(cache_path);
+  }
+
+  auto callback = [url, cache_path = std::move(cache_path)](s32 status_code, const Error& error,
+                                                            const std::string& content_type,
+                                                            HTTPDownloader::Request::Data data) mutable {
+    bool written = false;
     if (status_code != HTTPDownloader::HTTP_STATUS_OK)
     {
       ERROR_LOG("Failed to download badge '{}': {}", Path::GetFileName(cache_path), error.GetDescription());
-      return;
+    }
+    else
+    {
+      // written to a temporary file first, so the async texture loader never sees a partial image
+      Error write_error;
+      if (!(written = FileSystem::WriteAtomicRenamedFile(cache_path, data, &write_error)))
+        ERROR_LOG("Failed to write badge image to '{}': {}", cache_path, write_error.GetDescription());
     }
 
-    Error write_error;
-    if (!FileSystem::WriteBinaryFile(cache_path.c_str(), data, &write_error))
     {
-      ERROR_LOG("Failed to write badge image to '{}': {}", cache_path, write_error.GetDescription());
-      return;
+      std::unique_lock lock(s_image_cache.mutex);
+      s_image_cache.pending.erase(cache_path);
+      if (written)
+        s_image_cache.files.emplace(Path::GetFileName(cache_path));
+      else if (status_code != HTTPDownloader::HTTP_STATUS_CANCELLED)
+        s_image_cache.failed.insert(std::move(url));
     }
 
-    GPUThread::RunOnThread(
-      [cache_path = std::move(cache_path)]() { FullscreenUI::InvalidateCachedTexture(cache_path); });
+    if (written)
+    {
+      GPUThread::RunOnThread(
+        [cache_path = std::move(cache_path)]() { FullscreenUI::InvalidateCachedTexture(cache_path); });
+    }
   };
 
   s_state.http_downloader->CreateRequest(std::move(url), std::move(callback));
@@ -565,7 +638,7 @@ void Achievements::FinishInitialize()
   // Are we running a game?
   if (System::IsValid())
   {
-    IdentifyCurrentGame();
+    IdentifyGame();
     BeginLoadGame();
 
     // Hardcore mode isn't enabled when achievements first starts, if a game is already running.
@@ -997,10 +1070,13 @@ void Achievements::UpdateRichPresence(std::unique_lock<std::recursive_mutex>& lo
   lock.lock();
 }
 
-void Achievements::OnSystemStarting(CDImage* image, bool disable_hardcore_mode)
+void Achievements::OnSystemStarting(CDImage* image, const std::optional<GameHash>& game_hash,
+                                    bool disable_hardcore_mode)
 {
   std::unique_lock lock(s_state.mutex);
 
+  SetRunningGame(image, game_hash);
+
   if (!IsActive() || IsRAIntegrationInitializing())
     return;
 
@@ -1027,7 +1103,7 @@ void Achievements::OnSystemStarting(CDImage* image, bool disable_hardcore_mode)
   }
 
   // now we can finally identify the game
-  IdentifyGame(image);
+  IdentifyGame();
   BeginLoadGame();
 }
 
@@ -1036,6 +1112,7 @@ void Achievements::OnSystemDestroyed()
   const auto lock = GetLock();
   ClearGameInfo();
   ClearGameHash();
+  SetRunningGame(nullptr, std::nullopt);
   DisableHardcoreMode(false, false);
 }
 
@@ -1058,15 +1135,17 @@ void Achievements::OnSystemReset()
   rc_client_reset(s_state.client);
 }
 
-void Achievements::GameChanged(CDImage* image)
+void Achievements::GameChanged(CDImage* image, const std::optional<GameHash>& game_hash)
 {
   std::unique_lock lock(s_state.mutex);
 
+  SetRunningGame(image, game_hash);
+
   if (!IsActive() || IsRAIntegrationInitializing())
     return;
 
   // disc changed?
-  if (!IdentifyGame(image))
+  if (!IdentifyGame())
     return;
 
   // cancel previous requests
@@ -1081,23 +1160,25 @@ void Achievements::GameChanged(CDImage* image)
                                            ClientLoadGameCallback, reinterpret_cast<void*>(static_cast<uintptr_t>(1)));
 }
 
-bool Achievements::IdentifyGame(CDImage* image)
+void Achievements::SetRunningGame(CDImage* image, const std::optional<GameHash>& game_hash)
 {
-  std::optional<GameHash> game_hash;
-  if (image)
-  {
-    game_hash = GetGameHash(image);
+  s_state.running_game_path = image ? image->GetPath() : std::string();
+  s_state.running_game_hash = image ? game_hash : std::nullopt;
+  s_state.running_game_has_image = (image != nullptr);
+}
 
-    if (!game_hash.has_value() && !rc_client_is_game_loaded(s_state.client))
-    {
-      // If we are starting with this game and it's bad, notify the user that this is why.
-      Host::AddIconOSDMessage(OSDMessageType::Error, "AchievementsHashFailed", ICON_EMOJI_WARNING,
-                              TRANSLATE_STR("Achievements", "Failed to read executable from disc."),
-                              TRANSLATE_STR("Achievements", "Achievements have been disabled."));
-    }
+bool Achievements::IdentifyGame()
+{
+  const std::optional<GameHash>& game_hash = s_state.running_game_hash;
+  if (s_state.running_game_has_image && !game_hash.has_value() && !rc_client_is_game_loaded(s_state.client))
+  {
+    // If we are starting with this game and it's bad, notify the user that this is why.
+    Host::AddIconOSDMessage(OSDMessageType::Error, "AchievementsHashFailed", ICON_EMOJI_WARNING,
+                            TRANSLATE_STR("Achievements", "Failed to read executable from disc."),
+                            TRANSLATE_STR("Achievements", "Achievements have been disabled."));
   }
 
-  s_state.game_path = image ? image->GetPath() : std::string();
+  s_state.game_path = s_state.running_game_path;
 
   if (s_state.game_hash == game_hash)
   {
@@ -1110,23 +1191,6 @@ bool Achievements::IdentifyGame(CDImage* image)
   return true;
 }
 
-bool Achievements::IdentifyCurrentGame()
-{
-  DebugAssert(System::IsValid());
-
-  // this crap is only needed because we can't grab the image from the reader...
-  std::unique_ptr<CDImage> temp_image;
-  if (const std::string& disc_path = System::GetGamePath(); !disc_path.empty())
-  {
-    Error error;
-    temp_image = CDImage::Open(disc_path.c_str(), g_settings.cdrom_load_image_patches, &error);
-    if (!temp_image)
-      ERROR_LOG("Failed to open disc for late game identification: {}", error.GetDescription());
-  }
-
-  return IdentifyGame(temp_image.get());
-}
-
 void Achievements::BeginLoadGame()
 {
   if (!s_state.game_hash.has_value())
@@ -1242,7 +1306,7 @@ void Achievements::ClientLoadGameCallback(int result, const char* error_message,
   s_state.game_icon = GetLocalImagePath(info->badge_name, RC_IMAGE_TYPE_GAME);
   if (!s_state.game_icon.empty() && !s_state.game_icon_url.empty())
   {
-    if (!FileSystem::FileExists(s_state.game_icon.c_str()))
+    if (!IsImageCached(s_state.game_icon))
       DownloadImage(s_state.game_icon_url, s_state.game_icon);
 
     GameList::UpdateAchievementBadgeName(info->id, info->badge_name);
@@ -1913,7 +1977,7 @@ std::string Achievements::GetAchievementBadgePath(const rc_client_achievement_t*
 {
   const u32 image_type = locked ? RC_IMAGE_TYPE_ACHIEVEMENT_LOCKED : RC_IMAGE_TYPE_ACHIEVEMENT;
   const std::string path = GetLocalImagePath(achievement->badge_name, image_type);
-  if (download_if_missing && !path.empty() && !FileSystem::FileExists(path.c_str()))
+  if (download_if_missing && !path.empty() && !IsImageCached(path))
   {
     std::string url;
     const char* url_ptr;
@@ -1936,7 +2000,7 @@ std::string Achievements::GetAchievementBadgePath(const rc_client_achievement_t*
 std::string Achievements::GetLeaderboardUserBadgePath(const rc_client_leaderboard_entry_t* entry)
 {
   const std::string path = GetLocalImagePath(entry->user, RC_IMAGE_TYPE_USER);
-  if (!FileSystem::FileExists(path.c_str()))
+  if (!path.empty() && !IsImageCached(path))
   {
     std::string url = GetImageURL(entry->user, RC_IMAGE_TYPE_USER);
     if (!url.empty())
@@ -1949,7 +2013,7 @@ std::string Achievements::GetLeaderboardUserBadgePath(const rc_client_leaderboar
 std::string Achievements::GetSubsetBadgePath(const rc_client_subset_t* subset)
 {
   std::string badge_path = GetLocalImagePath(subset->badge_name, RC_IMAGE_TYPE_GAME);
-  if (!FileSystem::FileExists(badge_path.c_str()))
+  if (!badge_path.empty() && !IsImageCached(badge_path))
   {
     std::string url;
     if (IsUsingRAIntegration() || !subset->badge_url)
@@ -2016,7 +2080,7 @@ bool Achievements::Login(const char* username, const char* password, Error* erro
   // If we were't a temporary client, get the game loaded.
   if (System::IsValid() && !is_temporary_client)
   {
-    IdentifyCurrentGame();
+    IdentifyGame();
     BeginLoadGame();
   }
 
@@ -2125,7 +2189,7 @@ void Achievements::FinishLogin()
     return;
 
   s_state.user_badge_path = GetLocalImagePath(user->username, RC_IMAGE_TYPE_USER);
-  if (!s_state.user_badge_path.empty() && !FileSystem::FileExists(s_state.user_badge_path.c_str()))
+  if (!s_state.user_badge_path.empty() && !IsImageCached(s_state.user_badge_path))
   {
     std::string url;
     if (IsUsingRAIntegration() || !user->avatar_url)
@@ -2184,6 +2248,11 @@ std::string Achievements::GetGameBadgePath(std::string_view badge_name)
   return GetLocalImagePath(badge_name, RC_IMAGE_TYPE_GAME);
 }
 
+bool Achievements::HasCachedImage(std::string_view path)
+{
+  return (!path.empty() && IsImageCached(path));
+}
+
 bool Achievements::DownloadGameIcons(ProgressCallback* progress, Error* error)
 {
   // Collect all unique game IDs that don't have icons yet
@@ -2252,7 +2321,7 @@ bool Achievements::DownloadGameIcons(ProgressCallback* progress, Error* error)
       continue;
 
     std::string path = GetLocalImagePath(entry.badge_name, RC_IMAGE_TYPE_GAME);
-    if (FileSystem::FileExists(path.c_str()))
+    if (IsImageCached(path))
     {
       // Already have this icon, just update the cache
       GameList::UpdateAchievementBadgeName(entry.game_id, entry.badge_name);
@@ -2273,10 +2342,17 @@ bool Achievements::DownloadGameIcons(ProgressCallback* progress, Error* error)
           INFO_LOG("Writing badge to {}...", Path::GetFileName(path));
 
           Error write_error;
-          if (!FileSystem::FileExists(path.c_str()) && !FileSystem::WriteBinaryFile(path.c_str(), data, &write_error))
+          if (!IsImageCached(path))
           {
-            ERROR_LOG("Failed to write badge to {}: {}", Path::GetFileName(path), write_error.GetDescription());
-            FileSystem::DeleteFile(path.c_str());
+            if (FileSystem::WriteAtomicRenamedFile(path, data, &write_error))
+            {
+              std::unique_lock lock(s_image_cache.mutex);
+              s_image_cache.files.emplace(Path::GetFileName(path));
+            }
+            else
+            {
+              ERROR_LOG("Failed to write badge to {}: {}", Path::GetFileName(path), write_error.GetDescription());
+            }
           }
         }
         else
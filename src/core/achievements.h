@@ -84,7 +84,8 @@ void Shutdown();
 bool RefreshAllProgressDatabase(ProgressCallback* progress, Error* error);
 
 /// Called when the system is start. Engages hardcore mode if enabled.
-void OnSystemStarting(CDImage* image, bool disable_hardcore_mode);
+/// The hash is calculated by the caller from the executable it has already read, so the disc isn't read again.
+void OnSystemStarting(CDImage* image, const std::optional<GameHash>& game_hash, bool disable_hardcore_mode);
 
 /// Called when the system is shutting down. If this returns false, the shutdown should be aborted.
 void OnSystemDestroyed();
@@ -93,7 +94,7 @@ void OnSystemDestroyed();
 void OnSystemReset();
 
 /// Called when the system changes game.
-void GameChanged(CDImage* image);
+void GameChanged(CDImage* image, const std::optional<GameHash>& game_hash);
 
 /// Called once a frame at vsync time on the CPU thread.
 void FrameUpdate();
@@ -185,6 +186,9 @@ SmallString GetLoggedInUserPointsSummary();
 /// Returns the path to the local cache for the specified badge name.
 std::string GetGameBadgePath(std::string_view badge_name);
 
+/// Returns true if the image at the specified cache path has been downloaded.
+bool HasCachedImage(std::string_view path);
+
 /// Downloads game icons from RetroAchievements for all games that have an achievements_game_id.
 /// This fetches the game badge images that are normally downloaded when a game is opened.
 bool DownloadGameIcons(ProgressCallback* progress, Error* error);
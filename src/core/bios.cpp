@@ -17,6 +17,8 @@
 #include "common/path.h"
 #include "common/string_util.h"
 
+#include <algorithm>
+
 LOG_CHANNEL(BIOS);
 
 namespace BIOS {
@@ -146,6 +148,19 @@ static constexpr const ImageInfo s_openbios_info = {
 static constexpr const char s_openbios_signature[] = {'O', 'p', 'e', 'n', 'B', 'I', 'O', 'S'};
 static constexpr u32 s_openbios_signature_offset = 0x78;
 
+namespace {
+struct CachedImage
+{
+  ConsoleRegion region;
+  std::string path;
+  Image image;
+};
+} // namespace
+
+// Only accessed on the CPU thread, like the rest of the BIOS loading.
+static std::vector<CachedImage> s_image_cache;
+static bool s_image_cache_enabled = false;
+
 } // namespace BIOS
 
 bool BIOS::ImageInfo::CanSlowBootDisc(DiscRegion disc_region) const
@@ -199,17 +214,16 @@ std::optional<BIOS::Image> BIOS::LoadImageFromFile(const char* filename, Error*
     return ret;
   }
 
-  // We want to hash the whole file. That means reading the whole thing in, if it's a larger BIOS (PS2).
-  std::optional<DynamicHeapArray<u8>> data = FileSystem::ReadBinaryFile(fp.get(), error);
+  // We want to hash the whole file. Map it, rather than reading it all in, since a larger BIOS (PS2) is 4MB.
+  std::optional<FileSystem::MappedFile> data = FileSystem::MapBinaryFile(fp.get(), error);
   if (!data.has_value() || data->size() < BIOS_SIZE)
     return ret;
 
   ret = BIOS::Image();
-  ret->hash = MD5Digest::HashData(data.value());
+  ret->hash = MD5Digest::HashData(data->cspan());
 
   // But only copy the first 512KB, since that's all that's mapped.
-  ret->data = std::move(data.value());
-  ret->data.resize(BIOS_SIZE);
+  ret->data = DynamicHeapArray<u8>(data->data(), BIOS_SIZE);
   ret->info = GetInfoForHash(ret->data, ret->hash);
 
   DEV_LOG("Hash for BIOS '{}': {}", FileSystem::GetDisplayNameFromPath(filename), ImageInfo::GetHashString(ret->hash));
@@ -348,6 +362,13 @@ DiscRegion BIOS::GetPSExeDiscRegion(const PSEXEHeader& header)
     return DiscRegion::Other;
 }
 
+void BIOS::SetImageCacheEnabled(bool enabled)
+{
+  s_image_cache_enabled = enabled;
+  if (!enabled)
+    s_image_cache.clear();
+}
+
 std::optional<BIOS::Image> BIOS::GetBIOSImage(ConsoleRegion region, Error* error)
 {
   std::string bios_name;
@@ -369,15 +390,31 @@ std::optional<BIOS::Image> BIOS::GetBIOSImage(ConsoleRegion region, Error* error
 
   std::optional<Image> image;
 
-  if (bios_name.empty())
+  // auto-detection searches the whole directory, so the cache is keyed on that rather than the file
+  std::string image_path = bios_name.empty() ? EmuFolders::Bios : Path::Combine(EmuFolders::Bios, bios_name);
+  const auto cached_image = std::find_if(s_image_cache.begin(), s_image_cache.end(), [&](const CachedImage& ci) {
+    return (ci.region == region && ci.path == image_path);
+  });
+  if (cached_image != s_image_cache.end())
   {
-    // auto-detect
-    image = FindBIOSImageInDirectory(region, EmuFolders::Bios.c_str(), error);
+    DEV_LOG("Using cached BIOS image for '{}'", image_path);
+    image = cached_image->image;
   }
   else
   {
-    // try the configured path
-    image = LoadImageFromFile(Path::Combine(EmuFolders::Bios, bios_name).c_str(), error);
+    if (bios_name.empty())
+    {
+      // auto-detect
+      image = FindBIOSImageInDirectory(region, EmuFolders::Bios.c_str(), error);
+    }
+    else
+    {
+      // try the configured path
+      image = LoadImageFromFile(image_path.c_str(), error);
+    }
+
+    if (s_image_cache_enabled && image.has_value())
+      s_image_cache.push_back(CachedImage{region, std::move(image_path), image.value()});
   }
 
   // verify region
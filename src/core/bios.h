@@ -96,6 +96,10 @@ DiscRegion GetPSExeDiscRegion(const PSEXEHeader& header);
 /// Loads the BIOS image for the specified region.
 std::optional<Image> GetBIOSImage(ConsoleRegion region, Error* error);
 
+/// Keeps images returned by GetBIOSImage() in memory, so repeated boots skip the directory scan and hashing. Disabling
+/// the cache discards any images it holds. Changes to the BIOS directory are not picked up while it is enabled.
+void SetImageCacheEnabled(bool enabled);
+
 /// Searches for a BIOS image for the specified region in the specified directory. If no match is found, the first
 /// BIOS image within 512KB and 4MB will be used.
 std::optional<Image> FindBIOSImageInDirectory(ConsoleRegion region, const char* directory, Error* error);
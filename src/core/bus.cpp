@@ -152,6 +152,12 @@ static u8** s_fastmem_lut = nullptr;
 
 static bool s_kernel_initialize_hook_run = false;
 
+static bool s_ram_dirty_tracking = false;
+static u64 s_ram_generation = 1;
+static std::bitset<RAM_8MB_CODE_PAGE_COUNT> s_ram_dirty_bits{}; // Written since the last snapshot, i.e. unprotected.
+static std::array<u64, RAM_8MB_CODE_PAGE_COUNT> s_ram_page_generations{};
+static std::bitset<RAM_8MB_CODE_PAGE_COUNT> s_ram_watch_bits{}; // Inaccessible in the fastmem views.
+
 static bool AllocateMemoryMap(bool export_shared_memory, Error* error);
 static void ReleaseMemoryMap();
 static void SetRAMSize(bool enable_8mb_ram);
@@ -164,6 +170,11 @@ static void UnmapFastmemViews();
 static u8* GetLUTFastmemPointer(u32 address, u8* ram_ptr);
 
 static void SetRAMPageWritable(u32 page_index, bool writable);
+static void SetRAMPageRangeWritable(u32 first_page_index, u32 page_count, bool writable);
+static bool IsRAMPageWriteProtected(u32 index);
+static void ProtectFastmemWatchPages(u32 first_page_index, u32 page_count);
+static void MarkAllRAMPagesDirty();
+static void BeginRAMGeneration();
 
 static void KernelInitializedHook();
 static bool SideloadEXE(const std::string& path, Error* error);
@@ -228,6 +239,9 @@ bool Bus::AllocateMemoryMap(bool export_shared_memory, Error* error)
     return false;
   }
 
+  // Only a hint, protecting pages containing code for SMC detection splits the huge pages they're in.
+  MemMap::AdviseHugePages(g_ram, MemoryMap::RAM_SIZE);
+  MemMap::AdviseHugePages(g_unprotected_ram, MemoryMap::RAM_SIZE);
   VERBOSE_LOG("RAM is mapped at {}.", static_cast<void*>(g_ram));
 
   g_bios = static_cast<u8*>(MemMap::MapSharedMemory(s_shmem_handle, MemoryMap::BIOS_OFFSET, nullptr,
@@ -361,6 +375,10 @@ bool Bus::ReallocateMemoryMap(bool export_shared_memory, Error* error)
   if (!AllocateMemoryMap(export_shared_memory, error)) [[unlikely]]
     return false;
 
+  // New mapping is entirely writable.
+  if (s_ram_dirty_tracking)
+    MarkAllRAMPagesDirty();
+
   if (System::IsValid())
   {
     UpdateMappedRAMSize();
@@ -400,6 +418,7 @@ void Bus::SetRAMSize(bool enable_8mb_ram)
 
 void Bus::Shutdown()
 {
+  SetRAMDirtyTracking(false);
   UnmapFastmemViews();
   CPU::g_state.fastmem_base = nullptr;
 
@@ -420,6 +439,7 @@ void Bus::Reset()
   s_MEMCTRL.exp2_delay_size.bits = 0x00070777;
   s_MEMCTRL.common_delay.bits = 0x00031125;
   g_ram_code_bits = {};
+  s_ram_watch_bits.reset();
   s_kernel_initialize_hook_run = false;
   RecalculateMemoryTimings();
 
@@ -431,15 +451,24 @@ void Bus::Reset()
   }
 }
 
-bool Bus::DoState(StateWrapper& sw)
+bool Bus::DoState(StateWrapper& sw, bool include_ram)
 {
   u32 ram_size = g_ram_size;
   sw.DoEx(&ram_size, 52, static_cast<u32>(RAM_2MB_SIZE));
   if (ram_size != g_ram_size)
   {
+    // Memory states only invalidate code in changed pages, which doesn't cover the mask changing.
+    CPU::CodeCache::InvalidateAllRAMBlocks();
+
+    // Protection is only applied to the active pages, so restart tracking for the new size.
+    const bool dirty_tracking = s_ram_dirty_tracking;
+    SetRAMDirtyTracking(false);
+
     const bool using_8mb_ram = (ram_size == RAM_8MB_SIZE);
     SetRAMSize(using_8mb_ram);
     RemapFastmemViews();
+
+    SetRAMDirtyTracking(dirty_tracking);
   }
 
   sw.Do(&g_exp1_access_time);
@@ -447,7 +476,8 @@ bool Bus::DoState(StateWrapper& sw)
   sw.Do(&g_bios_access_time);
   sw.Do(&g_cdrom_access_time);
   sw.Do(&g_spu_access_time);
-  sw.DoBytes(g_ram, g_ram_size);
+  if (include_ram)
+    sw.DoBytes(g_ram, g_ram_size);
 
   if (sw.GetVersion() < 58) [[unlikely]]
   {
@@ -460,7 +490,10 @@ bool Bus::DoState(StateWrapper& sw)
   const RAM_SIZE_REG old_ram_size_reg = s_RAM_SIZE;
   sw.Do(&s_RAM_SIZE.bits);
   if (s_RAM_SIZE.memory_window != old_ram_size_reg.memory_window)
+  {
+    CPU::CodeCache::InvalidateAllRAMBlocks();
     UpdateMappedRAMSize();
+  }
 
   sw.Do(&s_tty_line_buffer);
 
@@ -570,7 +603,7 @@ void Bus::MapFastmemViews()
       const u32 page_count = g_ram_size >> HOST_PAGE_SHIFT;
       for (u32 i = 0; i < page_count; i++)
       {
-        if (g_ram_code_bits[i])
+        if (IsRAMPageWriteProtected(i))
         {
           u8* page_address = map_address + (i << HOST_PAGE_SHIFT);
           if (!MemMap::MemProtect(page_address, HOST_PAGE_SIZE, PageProtect::ReadOnly)) [[unlikely]]
@@ -580,6 +613,13 @@ void Bus::MapFastmemViews()
             return;
           }
         }
+
+        if (s_ram_watch_bits[i]) [[unlikely]]
+        {
+          u8* page_address = map_address + (i << HOST_PAGE_SHIFT);
+          if (!MemMap::MemProtect(page_address, HOST_PAGE_SIZE, PageProtect::NoAccess)) [[unlikely]]
+            ERROR_LOG("Failed to protect watched page at {}", static_cast<void*>(page_address));
+        }
       }
 
       s_fastmem_ram_views.emplace_back(map_address, g_ram_size);
@@ -702,9 +742,11 @@ void Bus::SetRAMCodePage(u32 index)
   if (g_ram_code_bits[index])
     return;
 
-  // protect fastmem pages
+  // protect fastmem pages, unless they're already protected for dirty tracking
+  const bool was_protected = IsRAMPageWriteProtected(index);
   g_ram_code_bits[index] = true;
-  SetRAMPageWritable(index, false);
+  if (!was_protected)
+    SetRAMPageWritable(index, false);
 }
 
 void Bus::ClearRAMCodePage(u32 index)
@@ -714,35 +756,49 @@ void Bus::ClearRAMCodePage(u32 index)
 
   // unprotect fastmem pages
   g_ram_code_bits[index] = false;
-  SetRAMPageWritable(index, true);
+  if (!IsRAMPageWriteProtected(index))
+    SetRAMPageWritable(index, true);
+}
+
+bool Bus::IsRAMPageWriteProtected(u32 index)
+{
+  return (g_ram_code_bits[index] || (s_ram_dirty_tracking && !s_ram_dirty_bits[index]));
 }
 
 void Bus::SetRAMPageWritable(u32 page_index, bool writable)
 {
-  if (!MemMap::MemProtect(&g_ram[page_index << HOST_PAGE_SHIFT], HOST_PAGE_SIZE,
-                          writable ? PageProtect::ReadWrite : PageProtect::ReadOnly)) [[unlikely]]
+  SetRAMPageRangeWritable(page_index, 1, writable);
+}
+
+void Bus::SetRAMPageRangeWritable(u32 first_page_index, u32 page_count, bool writable)
+{
+  const size_t offset = static_cast<size_t>(first_page_index) << HOST_PAGE_SHIFT;
+  const size_t size = static_cast<size_t>(page_count) << HOST_PAGE_SHIFT;
+  const PageProtect protect = writable ? PageProtect::ReadWrite : PageProtect::ReadOnly;
+  if (!MemMap::MemProtect(&g_ram[offset], size, protect)) [[unlikely]]
   {
-    ERROR_LOG("Failed to set RAM host page {} ({}) to {}", page_index,
-              reinterpret_cast<const void*>(&g_ram[page_index * HOST_PAGE_SIZE]),
-              writable ? "read-write" : "read-only");
+    ERROR_LOG("Failed to set RAM host pages {}-{} ({}) to {}", first_page_index, first_page_index + page_count - 1,
+              reinterpret_cast<const void*>(&g_ram[offset]), writable ? "read-write" : "read-only");
   }
 
 #ifdef ENABLE_MMAP_FASTMEM
   if (g_settings.cpu_fastmem_mode == CPUFastmemMode::MMap)
   {
-    const PageProtect protect = writable ? PageProtect::ReadWrite : PageProtect::ReadOnly;
-
     // unprotect fastmem pages
     for (const auto& it : s_fastmem_ram_views)
     {
-      u8* page_address = it.first + (page_index << HOST_PAGE_SHIFT);
-      if (!MemMap::MemProtect(page_address, HOST_PAGE_SIZE, protect)) [[unlikely]]
+      u8* page_address = it.first + offset;
+      if (!MemMap::MemProtect(page_address, size, protect)) [[unlikely]]
       {
-        ERROR_LOG("Failed to {} code page {} (0x{:08X}) @ {}", writable ? "unprotect" : "protect", page_index,
-                  page_index << HOST_PAGE_SHIFT, static_cast<void*>(page_address));
+        ERROR_LOG("Failed to {} RAM pages {}-{} (0x{:08X}) @ {}", writable ? "unprotect" : "protect",
+                  first_page_index, first_page_index + page_count - 1, offset, static_cast<void*>(page_address));
       }
     }
 
+    // watched pages have to stay inaccessible whatever their code/dirty state is
+    if (s_ram_watch_bits.any()) [[unlikely]]
+      ProtectFastmemWatchPages(first_page_index, page_count);
+
     return;
   }
 #endif
@@ -750,6 +806,20 @@ void Bus::SetRAMPageWritable(u32 page_index, bool writable)
 
 void Bus::ClearRAMCodePageFlags()
 {
+  if (s_ram_dirty_tracking)
+  {
+    // Pages which haven't been written since the last snapshot need to stay protected.
+    const u32 page_count = g_ram_size >> HOST_PAGE_SHIFT;
+    for (u32 i = 0; i < page_count; i++)
+    {
+      if (g_ram_code_bits[i] && s_ram_dirty_bits[i])
+        SetRAMPageWritable(i, true);
+    }
+
+    g_ram_code_bits.reset();
+    return;
+  }
+
   g_ram_code_bits.reset();
 
   if (!MemMap::MemProtect(g_ram, RAM_8MB_SIZE, PageProtect::ReadWrite))
@@ -764,10 +834,71 @@ void Bus::ClearRAMCodePageFlags()
       if (!MemMap::MemProtect(it.first, it.second, PageProtect::ReadWrite))
         ERROR_LOG("Failed to unprotect code pages for fastmem view @ {}", static_cast<void*>(it.first));
     }
+
+    if (s_ram_watch_bits.any()) [[unlikely]]
+      ProtectFastmemWatchPages(0, g_ram_size >> HOST_PAGE_SHIFT);
+  }
+#endif
+}
+
+void Bus::ProtectFastmemWatchPages(u32 first_page_index, u32 page_count)
+{
+#ifdef ENABLE_MMAP_FASTMEM
+  for (u32 i = first_page_index; i < (first_page_index + page_count); i++)
+  {
+    if (!s_ram_watch_bits[i])
+      continue;
+
+    for (const auto& it : s_fastmem_ram_views)
+    {
+      u8* page_address = it.first + (static_cast<size_t>(i) << HOST_PAGE_SHIFT);
+      if (!MemMap::MemProtect(page_address, HOST_PAGE_SIZE, PageProtect::NoAccess)) [[unlikely]]
+        ERROR_LOG("Failed to protect watched RAM page {} @ {}", i, static_cast<void*>(page_address));
+    }
   }
 #endif
 }
 
+void Bus::SetRAMWatchAddresses(std::span<const PhysicalMemoryAddress> addresses)
+{
+  std::bitset<RAM_8MB_CODE_PAGE_COUNT> new_bits;
+  for (const PhysicalMemoryAddress address : addresses)
+  {
+    if (IsRAMAddress(address))
+      new_bits[GetRAMCodePageIndex(address)] = true;
+  }
+
+  const std::bitset<RAM_8MB_CODE_PAGE_COUNT> changed_bits = s_ram_watch_bits ^ new_bits;
+  if (changed_bits.none())
+    return;
+
+  s_ram_watch_bits = new_bits;
+
+#ifdef ENABLE_MMAP_FASTMEM
+  const u32 page_count = g_ram_size >> HOST_PAGE_SHIFT;
+  for (u32 i = 0; i < page_count; i++)
+  {
+    if (!changed_bits[i])
+      continue;
+
+    const PageProtect protect =
+      s_ram_watch_bits[i] ? PageProtect::NoAccess :
+                            (IsRAMPageWriteProtected(i) ? PageProtect::ReadOnly : PageProtect::ReadWrite);
+    for (const auto& it : s_fastmem_ram_views)
+    {
+      u8* page_address = it.first + (static_cast<size_t>(i) << HOST_PAGE_SHIFT);
+      if (!MemMap::MemProtect(page_address, HOST_PAGE_SIZE, protect)) [[unlikely]]
+        ERROR_LOG("Failed to change protection of watched RAM page {} @ {}", i, static_cast<void*>(page_address));
+    }
+  }
+#endif
+}
+
+bool Bus::IsRAMWatchPage(u32 index)
+{
+  return s_ram_watch_bits[index];
+}
+
 bool Bus::IsCodePageAddress(PhysicalMemoryAddress address)
 {
   return IsRAMAddress(address) ? g_ram_code_bits[(address & g_ram_mask) >> HOST_PAGE_SHIFT] : false;
@@ -793,6 +924,168 @@ bool Bus::HasCodePagesInRange(PhysicalMemoryAddress start_address, u32 size)
   return false;
 }
 
+void Bus::SetRAMDirtyTracking(bool enabled)
+{
+  if (s_ram_dirty_tracking == enabled)
+    return;
+
+  if (enabled)
+  {
+    // Everything is considered modified until the first snapshot, so no need to change protection yet.
+    INFO_LOG("Enabling RAM dirty page tracking.");
+    s_ram_dirty_tracking = true;
+    s_ram_generation++;
+    MarkAllRAMPagesDirty();
+    return;
+  }
+
+  INFO_LOG("Disabling RAM dirty page tracking.");
+  const u32 page_count = g_ram_size >> HOST_PAGE_SHIFT;
+  for (u32 i = 0; i < page_count;)
+  {
+    if (s_ram_dirty_bits[i] || g_ram_code_bits[i])
+    {
+      i++;
+      continue;
+    }
+
+    const u32 first_page = i;
+    while (i < page_count && !s_ram_dirty_bits[i] && !g_ram_code_bits[i])
+      i++;
+    SetRAMPageRangeWritable(first_page, i - first_page, true);
+  }
+
+  s_ram_dirty_tracking = false;
+}
+
+bool Bus::HandleRAMDirtyPageFault(u32 index)
+{
+  if (!s_ram_dirty_tracking || s_ram_dirty_bits[index])
+    return false;
+
+  s_ram_dirty_bits[index] = true;
+  s_ram_page_generations[index] = s_ram_generation;
+
+  // Code pages stay protected until the code cache has invalidated the blocks.
+  if (g_ram_code_bits[index])
+    return false;
+
+  SetRAMPageWritable(index, true);
+  return true;
+}
+
+void Bus::MarkRAMPageDirty(u32 index)
+{
+  if (s_ram_dirty_tracking)
+    s_ram_page_generations[index] = s_ram_generation;
+}
+
+void Bus::MarkAllRAMPagesDirty()
+{
+  s_ram_dirty_bits.set();
+  s_ram_page_generations.fill(s_ram_generation);
+}
+
+void Bus::BeginRAMGeneration()
+{
+  // Re-protect everything that was written, so we find out about the next write. Code pages are already protected.
+  const u32 page_count = g_ram_size >> HOST_PAGE_SHIFT;
+  for (u32 i = 0; i < page_count;)
+  {
+    if (!s_ram_dirty_bits[i])
+    {
+      i++;
+      continue;
+    }
+
+    const u32 first_page = i;
+    for (; i < page_count && s_ram_dirty_bits[i]; i++)
+      s_ram_dirty_bits[i] = false;
+    SetRAMPageRangeWritable(first_page, i - first_page, false);
+  }
+
+  s_ram_generation++;
+}
+
+u64 Bus::UpdateRAMSnapshot(u8* snapshot, u64 snapshot_generation)
+{
+  DebugAssert(s_ram_dirty_tracking);
+
+  const u32 page_count = g_ram_size >> HOST_PAGE_SHIFT;
+  for (u32 i = 0; i < page_count;)
+  {
+    if (s_ram_page_generations[i] <= snapshot_generation)
+    {
+      i++;
+      continue;
+    }
+
+    const u32 first_page = i;
+    while (i < page_count && s_ram_page_generations[i] > snapshot_generation)
+      i++;
+
+    const size_t offset = static_cast<size_t>(first_page) << HOST_PAGE_SHIFT;
+    std::memcpy(snapshot + offset, g_unprotected_ram + offset, static_cast<size_t>(i - first_page) << HOST_PAGE_SHIFT);
+  }
+
+  const u64 generation = s_ram_generation;
+  BeginRAMGeneration();
+  return generation;
+}
+
+void Bus::RestoreRAMSnapshot(const u8* snapshot, u64 snapshot_generation)
+{
+  DebugAssert(s_ram_dirty_tracking);
+
+  // Restored pages count as modified, since other snapshots may not match them.
+  const u32 page_count = g_ram_size >> HOST_PAGE_SHIFT;
+  for (u32 i = 0; i < page_count;)
+  {
+    if (s_ram_page_generations[i] <= snapshot_generation)
+    {
+      i++;
+      continue;
+    }
+
+    const u32 first_page = i;
+    for (; i < page_count && s_ram_page_generations[i] > snapshot_generation; i++)
+    {
+      s_ram_page_generations[i] = s_ram_generation;
+
+      // Pages can be dirty without the contents differing, e.g. if the same data was written back.
+      const size_t page_offset = static_cast<size_t>(i) << HOST_PAGE_SHIFT;
+      if (IsRAMCodePage(i) &&
+          std::memcmp(g_unprotected_ram + page_offset, snapshot + page_offset, HOST_PAGE_SIZE) != 0)
+      {
+        CPU::CodeCache::InvalidateLoadedRAMPage(i);
+      }
+    }
+
+    const size_t offset = static_cast<size_t>(first_page) << HOST_PAGE_SHIFT;
+    std::memcpy(g_unprotected_ram + offset, snapshot + offset, static_cast<size_t>(i - first_page) << HOST_PAGE_SHIFT);
+  }
+
+  BeginRAMGeneration();
+}
+
+void Bus::RestoreRAMImage(const u8* data)
+{
+  DebugAssert(!s_ram_dirty_tracking);
+
+  const u32 page_count = g_ram_size >> HOST_PAGE_SHIFT;
+  for (u32 i = 0; i < page_count; i++)
+  {
+    const size_t offset = static_cast<size_t>(i) << HOST_PAGE_SHIFT;
+    if (std::memcmp(g_unprotected_ram + offset, data + offset, HOST_PAGE_SIZE) == 0)
+      continue;
+
+    if (IsRAMCodePage(i))
+      CPU::CodeCache::InvalidateLoadedRAMPage(i);
+
+    std::memcpy(g_unprotected_ram + offset, data + offset, HOST_PAGE_SIZE);
+  }
+}
+
 const TickCount* Bus::GetMemoryAccessTimePtr(PhysicalMemoryAddress address, MemoryAccessSize size)
 {
   // Currently only BIOS, but could be EXP1 as well.
@@ -126,7 +126,7 @@ void CleanupMemoryMap();
 void Initialize();
 void Shutdown();
 void Reset();
-bool DoState(StateWrapper& sw);
+bool DoState(StateWrapper& sw, bool include_ram = true);
 
 using MemoryReadHandler = u32 (*)(VirtualMemoryAddress address);
 using MemoryWriteHandler = void (*)(VirtualMemoryAddress, u32);
@@ -190,6 +190,33 @@ bool IsCodePageAddress(PhysicalMemoryAddress address);
 /// Returns true if the range specified overlaps with a code page.
 bool HasCodePagesInRange(PhysicalMemoryAddress start_address, u32 size);
 
+/// Makes the fastmem views of RAM pages containing any of the specified addresses inaccessible, so accesses to them
+/// fault and are moved to the slow path, where they can be checked against breakpoints. Other pages are unaffected.
+void SetRAMWatchAddresses(std::span<const PhysicalMemoryAddress> addresses);
+
+/// Returns true if the specified page is inaccessible through fastmem because it is being watched.
+bool IsRAMWatchPage(u32 index);
+
+/// Enables tracking of modified RAM pages, so snapshots only need to copy pages which have changed. Pages are
+/// write-protected after each snapshot, and flagged on the first write fault.
+void SetRAMDirtyTracking(bool enabled);
+
+/// Called on write faults to protected RAM. Returns true if the fault was only for dirty tracking.
+bool HandleRAMDirtyPageFault(u32 index);
+
+/// Flags a RAM page as modified, for writes which do not go through the protected mapping.
+void MarkRAMPageDirty(u32 index);
+
+/// Copies RAM pages modified since the snapshot was taken. Returns the generation to pass back in next time.
+u64 UpdateRAMSnapshot(u8* snapshot, u64 snapshot_generation);
+
+/// Restores RAM pages which were modified since the snapshot was taken.
+void RestoreRAMSnapshot(const u8* snapshot, u64 snapshot_generation);
+
+/// Copies in a full RAM image from a memory state. Only pages which differ are written, and code is only invalidated
+/// in those pages, so unchanged code does not need to be revalidated.
+void RestoreRAMImage(const u8* data);
+
 /// Returns the number of cycles stolen by DMA RAM access.
 ALWAYS_INLINE TickCount GetDMARAMTickCount(u32 word_count)
 {
@@ -9,6 +9,7 @@
 #include "host.h"
 #include "interrupt_controller.h"
 #include "mdec.h"
+#include "performance_counters.h"
 #include "settings.h"
 #include "spu.h"
 #include "system.h"
@@ -19,6 +20,7 @@
 #include "util/iso_reader.h"
 #include "util/state_wrapper.h"
 #include "util/translation.h"
+#include "util/xa_adpcm.h"
 
 #include "common/align.h"
 #include "common/bitfield.h"
@@ -52,11 +54,8 @@ enum : u32
   MODE1_HEADER_SIZE = CDImage::MODE1_HEADER_SIZE,
   MODE2_HEADER_SIZE = CDImage::MODE2_HEADER_SIZE,
   SUBQ_SECTOR_SKEW = 2,
-  XA_ADPCM_SAMPLES_PER_SECTOR_4BIT = 4032, // 28 words * 8 nibbles per word * 18 chunks
-  XA_ADPCM_SAMPLES_PER_SECTOR_8BIT = 2016, // 28 words * 4 bytes per word * 18 chunks
-  XA_RESAMPLE_RING_BUFFER_SIZE = 32,
-  XA_RESAMPLE_ZIGZAG_TABLE_SIZE = 29,
-  XA_RESAMPLE_NUM_ZIGZAG_TABLES = 7,
+  XA_ADPCM_SAMPLES_PER_SECTOR_4BIT = XAADPCM::SAMPLES_PER_SECTOR_4BIT,
+  XA_ADPCM_SAMPLES_PER_SECTOR_8BIT = XAADPCM::SAMPLES_PER_SECTOR_8BIT,
   PRNG_SEED = 0x4B435544u,
 
   PARAM_FIFO_SIZE = 16,
@@ -271,24 +270,6 @@ struct XASubHeader
   } codinginfo;
 };
 
-union XA_ADPCMBlockHeader
-{
-  u8 bits;
-
-  BitField<u8, u8, 0, 4> shift;
-  BitField<u8, u8, 4, 4> filter;
-
-  // For both 4bit and 8bit ADPCM, reserved shift values 13..15 will act same as shift=9).
-  u8 GetShift() const
-  {
-    const u8 shift_value = shift;
-    return (shift_value > 12) ? 9 : shift_value;
-  }
-
-  u8 GetFilter() const { return filter; }
-};
-static_assert(sizeof(XA_ADPCMBlockHeader) == 1, "XA-ADPCM block header is one byte");
-
 } // namespace
 
 static TickCount SoftReset(TickCount ticks_late);
@@ -373,14 +354,6 @@ static void ResetAudioDecoder();
 static void ClearSectorBuffers();
 static void CheckForSectorBufferReadComplete();
 
-// Decodes XA-ADPCM samples in an audio sector. Stereo samples are interleaved with left first.
-template<bool IS_STEREO, bool IS_8BIT>
-static void DecodeXAADPCMChunks(const u8* chunk_ptr, s16* samples);
-template<bool STEREO>
-static void ResampleXAADPCM(const s16* frames_in, u32 num_frames_in);
-template<bool STEREO>
-static void ResampleXAADPCM18900(const s16* frames_in, u32 num_frames_in);
-
 static TinyString LBAToMSFString(CDImage::LBA lba);
 
 static void CreateFileMap();
@@ -462,10 +435,8 @@ struct CDROMState
   std::array<std::array<u8, 2>, 2> cd_audio_volume_matrix{};
   std::array<std::array<u8, 2>, 2> next_cd_audio_volume_matrix{};
 
-  std::array<s32, 4> xa_last_samples{};
-  std::array<std::array<s16, XA_RESAMPLE_RING_BUFFER_SIZE>, 2> xa_resample_ring_buffer{};
-  u8 xa_resample_p = 0;
-  u8 xa_resample_sixstep = 6;
+  XAADPCM::DecoderState xa_last_samples{};
+  XAADPCM::ResamplerState xa_resampler{{}, 0, 6};
 
   InlineFIFOQueue<u8, PARAM_FIFO_SIZE> param_fifo;
   InlineFIFOQueue<u8, RESPONSE_FIFO_SIZE> response_fifo;
@@ -767,9 +738,9 @@ bool CDROM::DoState(StateWrapper& sw)
   sw.Do(&s_state.cd_audio_volume_matrix);
   sw.Do(&s_state.next_cd_audio_volume_matrix);
   sw.Do(&s_state.xa_last_samples);
-  sw.Do(&s_state.xa_resample_ring_buffer);
-  sw.Do(&s_state.xa_resample_p);
-  sw.Do(&s_state.xa_resample_sixstep);
+  sw.Do(&s_state.xa_resampler.ring_buffer);
+  sw.Do(&s_state.xa_resampler.p);
+  sw.Do(&s_state.xa_resampler.sixstep);
   sw.Do(&s_state.param_fifo);
   sw.Do(&s_state.response_fifo);
   sw.Do(&s_state.async_response_fifo);
@@ -952,6 +923,8 @@ bool CDROM::InsertMedia(std::unique_ptr<CDImage>& media, DiscRegion region, std:
   INFO_LOG("Inserting new media, disc region: {}, console region: {}", Settings::GetDiscRegionName(region),
            Settings::GetConsoleRegionName(System::GetRegion()));
 
+  media->SetDecompressionCacheSize(static_cast<u32>(g_settings.cdrom_decompression_cache_size) * 1048576u);
+
   s_state.subq_replacement = std::move(subq);
   s_state.disc_region = region;
   s_reader.SetMedia(std::move(media));
@@ -1027,7 +1000,7 @@ bool CDROM::PrecacheMedia()
 
   Error error;
   FullscreenUI::LoadingScreenProgressCallback callback;
-  if (!s_reader.Precache(&callback, &error))
+  if (!s_reader.Precache(g_settings.cdrom_load_image_compressed, &callback, &error))
   {
     Host::AddOSDMessage(OSDMessageType::Error,
                         TRANSLATE_STR("OSDMessage", "Precaching CD image failed, it may be unreliable."));
@@ -1078,6 +1051,7 @@ void CDROM::CPUClockChanged()
 
 u8 CDROM::ReadRegister(u32 offset)
 {
+  PerformanceCounters::CPUTimeScope cpu_time_scope(PerformanceCounters::CPUTimeCategory::CDROM);
   switch (offset)
   {
     case 0: // status register
@@ -1146,6 +1120,7 @@ u8 CDROM::ReadRegister(u32 offset)
 
 void CDROM::WriteRegister(u32 offset, u8 value)
 {
+  PerformanceCounters::CPUTimeScope cpu_time_scope(PerformanceCounters::CPUTimeCategory::CDROM);
   if (offset == 0)
   {
     TRACE_LOG("CDROM status register <- 0x{:02X}", value);
@@ -1321,6 +1296,7 @@ void CDROM::WriteRegister(u32 offset, u8 value)
 
 void CDROM::DMARead(u32* words, u32 word_count)
 {
+  PerformanceCounters::CPUTimeScope cpu_time_scope(PerformanceCounters::CPUTimeCategory::CDROM);
   SectorBuffer& sb = s_state.sector_buffers[s_state.current_read_sector_buffer];
   const u32 bytes_available = (s_state.request_register.BFRD && sb.position < sb.size) ? (sb.size - sb.position) : 0;
   u8* dst_ptr = reinterpret_cast<u8*>(words);
@@ -1425,6 +1401,7 @@ void CDROM::QueueDeliverAsyncInterrupt()
 
 void CDROM::DeliverAsyncInterrupt(void*, TickCount ticks, TickCount ticks_late)
 {
+  PerformanceCounters::CPUTimeScope cpu_time_scope(PerformanceCounters::CPUTimeCategory::CDROM);
   if (HasPendingInterrupt())
   {
     // This shouldn't really happen, because we should block command execution.. but just in case.
@@ -1831,6 +1808,7 @@ void CDROM::EndCommand()
 
 void CDROM::ExecuteCommand(void*, TickCount ticks, TickCount ticks_late)
 {
+  PerformanceCounters::CPUTimeScope cpu_time_scope(PerformanceCounters::CPUTimeCategory::CDROM);
   const CommandInfo& ci = s_command_info[static_cast<u8>(s_state.command)];
   if (s_state.param_fifo.GetSize() < ci.min_parameters || s_state.param_fifo.GetSize() > ci.max_parameters) [[unlikely]]
   {
@@ -2596,6 +2574,7 @@ void CDROM::ExecuteTestCommand(u8 subcommand)
 
 void CDROM::ExecuteCommandSecondResponse(void*, TickCount ticks, TickCount ticks_late)
 {
+  PerformanceCounters::CPUTimeScope cpu_time_scope(PerformanceCounters::CPUTimeCategory::CDROM);
   switch (s_state.command_second_response)
   {
     case Command::GetID:
@@ -2675,6 +2654,7 @@ void CDROM::UpdateCommandEvent()
 
 void CDROM::ExecuteDrive(void*, TickCount ticks, TickCount ticks_late)
 {
+  PerformanceCounters::CPUTimeScope cpu_time_scope(PerformanceCounters::CPUTimeCategory::CDROM);
   switch (s_state.drive_state)
   {
     case DriveState::ShellOpening:
@@ -3072,7 +3052,7 @@ bool CDROM::CompleteSeek()
         {
           if (logical)
           {
-            ProcessDataSectorHeader(s_reader.GetSectorBuffer().data());
+            ProcessDataSectorHeader(s_reader.GetSectorData());
             seek_okay = (s_state.last_sector_header.minute == seek_mm && s_state.last_sector_header.second == seek_ss &&
                          s_state.last_sector_header.frame == seek_ff);
 
@@ -3362,7 +3342,7 @@ void CDROM::DoSectorRead()
   const bool is_data_sector = subq.IsData();
   if (is_data_sector)
   {
-    ProcessDataSectorHeader(s_reader.GetSectorBuffer().data());
+    ProcessDataSectorHeader(s_reader.GetSectorData());
   }
   else if (s_state.mode.auto_pause)
   {
@@ -3395,12 +3375,12 @@ void CDROM::DoSectorRead()
   u32 next_sector = s_state.current_lba + 1u;
   if (is_data_sector && s_state.drive_state == DriveState::Reading)
   {
-    ProcessDataSector(s_reader.GetSectorBuffer().data(), subq);
+    ProcessDataSector(s_reader.GetSectorData(), subq);
   }
   else if (!is_data_sector && (s_state.drive_state == DriveState::Playing ||
                                (s_state.drive_state == DriveState::Reading && s_state.mode.cdda)))
   {
-    ProcessCDDASector(s_reader.GetSectorBuffer().data(), subq, subq_valid);
+    ProcessCDDASector(s_reader.GetSectorData(), subq, subq_valid);
 
     if (s_state.fast_forward_rate != 0)
       next_sector = s_state.current_lba + SignExtend32(s_state.fast_forward_rate);
@@ -3536,195 +3516,6 @@ s16 CDROM::SaturateVolume(s32 volume)
   return static_cast<s16>((volume < -0x8000) ? -0x8000 : ((volume > 0x7FFF) ? 0x7FFF : volume));
 }
 
-template<bool IS_STEREO, bool IS_8BIT>
-void CDROM::DecodeXAADPCMChunks(const u8* chunk_ptr, s16* samples)
-{
-  static constexpr std::array<s8, 16> filter_table_pos = {{0, 60, 115, 98, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
-  static constexpr std::array<s8, 16> filter_table_neg = {{0, 0, -52, -55, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
-
-  // The data layout is annoying here. Each word of data is interleaved with the other blocks, requiring multiple
-  // passes to decode the whole chunk.
-  constexpr u32 NUM_CHUNKS = 18;
-  constexpr u32 CHUNK_SIZE_IN_BYTES = 128;
-  constexpr u32 WORDS_PER_CHUNK = 28;
-  constexpr u32 SAMPLES_PER_CHUNK = WORDS_PER_CHUNK * (IS_8BIT ? 4 : 8);
-  constexpr u32 NUM_BLOCKS = IS_8BIT ? 4 : 8;
-  constexpr u32 WORDS_PER_BLOCK = 28;
-
-  for (u32 i = 0; i < NUM_CHUNKS; i++)
-  {
-    const u8* headers_ptr = chunk_ptr + 4;
-    const u8* words_ptr = chunk_ptr + 16;
-
-    for (u32 block = 0; block < NUM_BLOCKS; block++)
-    {
-      const XA_ADPCMBlockHeader block_header{headers_ptr[block]};
-      const u8 shift = block_header.GetShift();
-      const u8 filter = block_header.GetFilter();
-      const s32 filter_pos = filter_table_pos[filter];
-      const s32 filter_neg = filter_table_neg[filter];
-
-      s16* out_samples_ptr =
-        IS_STEREO ? &samples[(block / 2) * (WORDS_PER_BLOCK * 2) + (block % 2)] : &samples[block * WORDS_PER_BLOCK];
-      constexpr u32 out_samples_increment = IS_STEREO ? 2 : 1;
-
-      for (u32 word = 0; word < 28; word++)
-      {
-        // NOTE: assumes LE
-        u32 word_data;
-        std::memcpy(&word_data, &words_ptr[word * sizeof(u32)], sizeof(word_data));
-
-        // extract nibble from block
-        const u32 nibble = IS_8BIT ? ((word_data >> (block * 8)) & 0xFF) : ((word_data >> (block * 4)) & 0x0F);
-        const s16 sample = static_cast<s16>(Truncate16(nibble << (IS_8BIT ? 8 : 12))) >> shift;
-
-        // mix in previous values
-        s32* prev = IS_STEREO ? &s_state.xa_last_samples[(block & 1) * 2] : &s_state.xa_last_samples[0];
-        const s32 interp_sample = std::clamp<s32>(
-          static_cast<s32>(sample) + ((prev[0] * filter_pos) >> 6) + ((prev[1] * filter_neg) >> 6), -32768, 32767);
-
-        // update previous values
-        prev[1] = prev[0];
-        prev[0] = interp_sample;
-
-        *out_samples_ptr = static_cast<s16>(interp_sample);
-        out_samples_ptr += out_samples_increment;
-      }
-    }
-
-    samples += SAMPLES_PER_CHUNK;
-    chunk_ptr += CHUNK_SIZE_IN_BYTES;
-  }
-}
-
-template<bool STEREO>
-void CDROM::ResampleXAADPCM(const s16* frames_in, u32 num_frames_in)
-{
-  static constexpr auto zigzag_interpolate = [](const s16* ringbuf, u32 table_index, u32 p) -> s16 {
-    static std::array<std::array<s16, 29>, 7> tables = {
-      {{0,      0x0,     0x0,     0x0,    0x0,     -0x0002, 0x000A,  -0x0022, 0x0041, -0x0054,
-        0x0034, 0x0009,  -0x010A, 0x0400, -0x0A78, 0x234C,  0x6794,  -0x1780, 0x0BCD, -0x0623,
-        0x0350, -0x016D, 0x006B,  0x000A, -0x0010, 0x0011,  -0x0008, 0x0003,  -0x0001},
-       {0,       0x0,    0x0,     -0x0002, 0x0,    0x0003,  -0x0013, 0x003C,  -0x004B, 0x00A2,
-        -0x00E3, 0x0132, -0x0043, -0x0267, 0x0C9D, 0x74BB,  -0x11B4, 0x09B8,  -0x05BF, 0x0372,
-        -0x01A8, 0x00A6, -0x001B, 0x0005,  0x0006, -0x0008, 0x0003,  -0x0001, 0x0},
-       {0,      0x0,     -0x0001, 0x0003,  -0x0002, -0x0005, 0x001F,  -0x004A, 0x00B3, -0x0192,
-        0x02B1, -0x039E, 0x04F8,  -0x05A6, 0x7939,  -0x05A6, 0x04F8,  -0x039E, 0x02B1, -0x0192,
-        0x00B3, -0x004A, 0x001F,  -0x0005, -0x0002, 0x0003,  -0x0001, 0x0,     0x0},
-       {0,       -0x0001, 0x0003,  -0x0008, 0x0006, 0x0005,  -0x001B, 0x00A6, -0x01A8, 0x0372,
-        -0x05BF, 0x09B8,  -0x11B4, 0x74BB,  0x0C9D, -0x0267, -0x0043, 0x0132, -0x00E3, 0x00A2,
-        -0x004B, 0x003C,  -0x0013, 0x0003,  0x0,    -0x0002, 0x0,     0x0,    0x0},
-       {-0x0001, 0x0003,  -0x0008, 0x0011,  -0x0010, 0x000A, 0x006B,  -0x016D, 0x0350, -0x0623,
-        0x0BCD,  -0x1780, 0x6794,  0x234C,  -0x0A78, 0x0400, -0x010A, 0x0009,  0x0034, -0x0054,
-        0x0041,  -0x0022, 0x000A,  -0x0001, 0x0,     0x0001, 0x0,     0x0,     0x0},
-       {0x0002,  -0x0008, 0x0010,  -0x0023, 0x002B, 0x001A,  -0x00EB, 0x027B,  -0x0548, 0x0AFA,
-        -0x16FA, 0x53E0,  0x3C07,  -0x1249, 0x080E, -0x0347, 0x015B,  -0x0044, -0x0017, 0x0046,
-        -0x0023, 0x0011,  -0x0005, 0x0,     0x0,    0x0,     0x0,     0x0,     0x0},
-       {-0x0005, 0x0011,  -0x0023, 0x0046, -0x0017, -0x0044, 0x015B,  -0x0347, 0x080E, -0x1249,
-        0x3C07,  0x53E0,  -0x16FA, 0x0AFA, -0x0548, 0x027B,  -0x00EB, 0x001A,  0x002B, -0x0023,
-        0x0010,  -0x0008, 0x0002,  0x0,    0x0,     0x0,     0x0,     0x0,     0x0}}};
-
-    const s16* table = tables[table_index].data();
-    s32 sum = 0;
-    for (u32 i = 0; i < 29; i++)
-      sum += (static_cast<s32>(ringbuf[(p - i) & 0x1F]) * static_cast<s32>(table[i])) >> 15;
-
-    return static_cast<s16>(std::clamp<s32>(sum, -0x8000, 0x7FFF));
-  };
-
-  s16* const left_ringbuf = s_state.xa_resample_ring_buffer[0].data();
-  [[maybe_unused]] s16* const right_ringbuf = s_state.xa_resample_ring_buffer[1].data();
-  u32 p = s_state.xa_resample_p;
-  u32 sixstep = s_state.xa_resample_sixstep;
-
-  for (u32 in_sample_index = 0; in_sample_index < num_frames_in; in_sample_index++)
-  {
-    // TODO: We can vectorize the multiplications in zigzag_interpolate by duplicating the sample in the ringbuffer at
-    // offset +32, allowing it to wrap once.
-    left_ringbuf[p] = *(frames_in++);
-    if constexpr (STEREO)
-      right_ringbuf[p] = *(frames_in++);
-    p = (p + 1) % 32;
-    sixstep--;
-
-    if (sixstep == 0)
-    {
-      sixstep = 6;
-      for (u32 j = 0; j < 7; j++)
-      {
-        const s16 left_interp = zigzag_interpolate(left_ringbuf, j, p);
-        const s16 right_interp = STEREO ? zigzag_interpolate(right_ringbuf, j, p) : left_interp;
-        AddCDAudioFrame(left_interp, right_interp);
-      }
-    }
-  }
-
-  s_state.xa_resample_p = Truncate8(p);
-  s_state.xa_resample_sixstep = Truncate8(sixstep);
-}
-
-template<bool STEREO>
-void CDROM::ResampleXAADPCM18900(const s16* frames_in, u32 num_frames_in)
-{
-  // Weights originally from Mednafen's interpolator. It's unclear where these came from, perhaps it was calculated
-  // somehow. This doesn't appear to use a zigzag pattern like psx-spx suggests, therefore it is restricted to only
-  // 18900hz resampling. Duplicating the 18900hz samples to 37800hz sounds even more awful than lower sample rate audio
-  // should, with a big spike at ~16KHz, especially with music in FMVs. Fortunately, few games actually use 18900hz XA.
-  static constexpr auto interpolate = [](const s16* ringbuf, u32 table_index, u32 p) -> s16 {
-    static std::array<std::array<s16, 25>, 7> tables = {{
-      {{0x0,     -0x5,  0x11,   -0x23, 0x46,  -0x17, -0x44, 0x15b, -0x347, 0x80e, -0x1249, 0x3c07, 0x53e0,
-        -0x16fa, 0xafa, -0x548, 0x27b, -0xeb, 0x1a,  0x2b,  -0x23, 0x10,   -0x8,  0x2,     0x0}},
-      {{0x0,     -0x2,  0xa,    -0x22, 0x41,   -0x54, 0x34, 0x9,   -0x10a, 0x400, -0xa78, 0x234c, 0x6794,
-        -0x1780, 0xbcd, -0x623, 0x350, -0x16d, 0x6b,  0xa,  -0x10, 0x11,   -0x8,  0x3,    -0x1}},
-      {{-0x2,    0x0,   0x3,    -0x13, 0x3c,   -0x4b, 0xa2,  -0xe3, 0x132, -0x43, -0x267, 0xc9d, 0x74bb,
-        -0x11b4, 0x9b8, -0x5bf, 0x372, -0x1a8, 0xa6,  -0x1b, 0x5,   0x6,   -0x8,  0x3,    -0x1}},
-      {{-0x1,   0x3,   -0x2,   -0x5,  0x1f,   -0x4a, 0xb3,  -0x192, 0x2b1, -0x39e, 0x4f8, -0x5a6, 0x7939,
-        -0x5a6, 0x4f8, -0x39e, 0x2b1, -0x192, 0xb3,  -0x4a, 0x1f,   -0x5,  -0x2,   0x3,   -0x1}},
-      {{-0x1,  0x3,    -0x8,  0x6,   0x5,   -0x1b, 0xa6,  -0x1a8, 0x372, -0x5bf, 0x9b8, -0x11b4, 0x74bb,
-        0xc9d, -0x267, -0x43, 0x132, -0xe3, 0xa2,  -0x4b, 0x3c,   -0x13, 0x3,    0x0,   -0x2}},
-      {{-0x1,   0x3,    -0x8,  0x11,   -0x10, 0xa,  0x6b,  -0x16d, 0x350, -0x623, 0xbcd, -0x1780, 0x6794,
-        0x234c, -0xa78, 0x400, -0x10a, 0x9,   0x34, -0x54, 0x41,   -0x22, 0xa,    -0x2,  0x0}},
-      {{0x0,    0x2,     -0x8,  0x10,   -0x23, 0x2b,  0x1a,  -0xeb, 0x27b, -0x548, 0xafa, -0x16fa, 0x53e0,
-        0x3c07, -0x1249, 0x80e, -0x347, 0x15b, -0x44, -0x17, 0x46,  -0x23, 0x11,   -0x5,  0x0}},
-    }};
-
-    const s16* table = tables[table_index].data();
-    s32 sum = 0;
-    for (u32 i = 0; i < 25; i++)
-      sum += (static_cast<s32>(ringbuf[(p + 32 - 25 + i) & 0x1F]) * static_cast<s32>(table[i]));
-
-    return static_cast<s16>(std::clamp<s32>(sum >> 15, -0x8000, 0x7FFF));
-  };
-
-  s16* const left_ringbuf = s_state.xa_resample_ring_buffer[0].data();
-  [[maybe_unused]] s16* const right_ringbuf = s_state.xa_resample_ring_buffer[1].data();
-  u32 p = s_state.xa_resample_p;
-  u32 sixstep = s_state.xa_resample_sixstep;
-
-  for (u32 in_sample_index = 0; in_sample_index < num_frames_in;)
-  {
-    if (sixstep >= 7)
-    {
-      sixstep -= 7;
-      p = (p + 1) % 32;
-
-      left_ringbuf[p] = *(frames_in++);
-      if constexpr (STEREO)
-        right_ringbuf[p] = *(frames_in++);
-
-      in_sample_index++;
-    }
-
-    const s16 left_interp = interpolate(left_ringbuf, sixstep, p);
-    const s16 right_interp = STEREO ? interpolate(right_ringbuf, sixstep, p) : left_interp;
-    AddCDAudioFrame(left_interp, right_interp);
-    sixstep += 3;
-  }
-
-  s_state.xa_resample_p = Truncate8(p);
-  s_state.xa_resample_sixstep = Truncate8(sixstep);
-}
-
 void CDROM::ResetCurrentXAFile()
 {
   s_state.xa_current_channel_number = 0;
@@ -3739,12 +3530,7 @@ void CDROM::ResetAudioDecoder()
   ResetCurrentXAFile();
 
   s_state.xa_last_samples.fill(0);
-  for (u32 i = 0; i < 2; i++)
-  {
-    s_state.xa_resample_ring_buffer[i].fill(0);
-    s_state.xa_resample_p = 0;
-    s_state.xa_resample_sixstep = 6;
-  }
+  s_state.xa_resampler.Reset();
   s_state.audio_fifo.Clear();
 }
 
@@ -3809,44 +3595,31 @@ ALWAYS_INLINE_RELEASE void CDROM::ProcessXAADPCMSector(const u8* raw_sector, con
   }
 
   // If muted, we still need to decode the data, to update the previous samples.
+  // The reader thread normally unpacks the sector ahead of time, only the filtering has to happen here.
   std::array<s16, XA_ADPCM_SAMPLES_PER_SECTOR_4BIT> sample_buffer;
-  const u8* xa_block_start =
-    raw_sector + CDImage::SECTOR_SYNC_SIZE + sizeof(CDImage::SectorHeader) + sizeof(XASubHeader) * 2;
-  s_state.xa_current_codinginfo.bits = s_state.last_sector_subheader.codinginfo.bits;
-
-  if (s_state.last_sector_subheader.codinginfo.Is8BitADPCM())
-  {
-    if (s_state.last_sector_subheader.codinginfo.IsStereo())
-      DecodeXAADPCMChunks<true, true>(xa_block_start, sample_buffer.data());
-    else
-      DecodeXAADPCMChunks<false, true>(xa_block_start, sample_buffer.data());
-  }
-  else
+  const XAADPCM::UnpackedSector* unpacked = s_reader.GetSectorXAADPCM();
+  XAADPCM::UnpackedSector local_unpacked;
+  if (!unpacked)
   {
-    if (s_state.last_sector_subheader.codinginfo.IsStereo())
-      DecodeXAADPCMChunks<true, false>(xa_block_start, sample_buffer.data());
-    else
-      DecodeXAADPCMChunks<false, false>(xa_block_start, sample_buffer.data());
+    CDROMAsyncReader::UnpackXAADPCMSector(raw_sector, &local_unpacked);
+    unpacked = &local_unpacked;
   }
+  s_state.xa_current_codinginfo.bits = s_state.last_sector_subheader.codinginfo.bits;
+
+  const bool stereo = s_state.last_sector_subheader.codinginfo.IsStereo();
+  XAADPCM::DecodeSector(*unpacked, stereo, s_state.last_sector_subheader.codinginfo.Is8BitADPCM(),
+                        s_state.xa_last_samples, sample_buffer.data());
 
   // Only send to SPU if we're not muted.
   if (s_state.muted || s_state.adpcm_muted || g_settings.cdrom_mute_cd_audio)
     return;
 
-  if (s_state.last_sector_subheader.codinginfo.IsStereo())
-  {
-    if (s_state.last_sector_subheader.codinginfo.IsHalfSampleRate())
-      ResampleXAADPCM18900<true>(sample_buffer.data(), num_frames);
-    else
-      ResampleXAADPCM<true>(sample_buffer.data(), num_frames);
-  }
-  else
-  {
-    if (s_state.last_sector_subheader.codinginfo.IsHalfSampleRate())
-      ResampleXAADPCM18900<false>(sample_buffer.data(), num_frames);
-    else
-      ResampleXAADPCM<false>(sample_buffer.data(), num_frames);
-  }
+  std::array<u32, XAADPCM::MAX_RESAMPLED_FRAMES_PER_SECTOR> resampled_frames;
+  const u32 num_resampled_frames =
+    XAADPCM::ResampleSector(sample_buffer.data(), num_frames, stereo,
+                            s_state.last_sector_subheader.codinginfo.IsHalfSampleRate(), s_state.xa_resampler,
+                            resampled_frames.data());
+  s_state.audio_fifo.PushRange(resampled_frames.data(), num_resampled_frames);
 }
 
 static s16 GetPeakVolume(const u8* raw_sector, u8 channel)
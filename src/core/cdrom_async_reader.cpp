@@ -2,9 +2,17 @@
 // SPDX-License-Identifier: CC-BY-NC-ND-4.0
 
 #include "cdrom_async_reader.h"
+#include "performance_counters.h"
+
 #include "common/assert.h"
+#include "common/event_trace.h"
 #include "common/log.h"
+#include "common/threading.h"
 #include "common/timer.h"
+
+#include <algorithm>
+#include <cstring>
+
 LOG_CHANNEL(CDROMAsyncReader);
 
 CDROMAsyncReader::CDROMAsyncReader() = default;
@@ -20,7 +28,11 @@ void CDROMAsyncReader::StartThread(u32 readahead_count)
     StopThread();
 
   m_buffers.clear();
-  m_buffers.resize(readahead_count);
+  m_buffers.resize(readahead_count * MAX_READAHEAD_SCALE);
+  m_xa_buffers.resize(m_buffers.size());
+  m_readahead_count = readahead_count;
+  m_readahead_window.store(readahead_count);
+  m_sequential_reads = 0;
   EmptyBuffers();
 
   m_shutdown_flag.store(false);
@@ -42,6 +54,9 @@ void CDROMAsyncReader::StopThread()
   m_read_thread.join();
   EmptyBuffers();
   m_buffers.clear();
+  m_xa_buffers.clear();
+  m_readahead_count = 0;
+  ClearHotSeeks();
 }
 
 void CDROMAsyncReader::SetMedia(std::unique_ptr<CDImage> media)
@@ -49,6 +64,8 @@ void CDROMAsyncReader::SetMedia(std::unique_ptr<CDImage> media)
   if (IsUsingThread())
     CancelReadahead();
 
+  // Seek history is only meaningful for the disc it came from.
+  ClearHotSeeks();
   m_media = std::move(media);
 }
 
@@ -57,24 +74,36 @@ std::unique_ptr<CDImage> CDROMAsyncReader::RemoveMedia()
   if (IsUsingThread())
     CancelReadahead();
 
+  ClearHotSeeks();
   return std::move(m_media);
 }
 
-bool CDROMAsyncReader::Precache(ProgressCallback* callback, Error* error)
+bool CDROMAsyncReader::Precache(bool compressed, ProgressCallback* callback, Error* error)
 {
   WaitForIdle();
 
   std::unique_lock lock(m_mutex);
   if (!m_media)
     return false;
-  else if (m_media->IsPrecached())
+  else if (m_media->IsPrecached() && m_media->IsPrecachedCompressed() == compressed)
     return true;
 
-  const CDImage::PrecacheResult res = m_media->Precache(callback, error);
+  // The worker can start reading ahead again between the idle wait and taking the lock.
+  if (IsUsingThread())
+    m_notify_read_complete_cv.wait(lock, [this]() { return !m_is_reading.load(); });
+
+  // Precaching either replaces the image or its backing, so nothing can keep pointing into the old file mapping.
+  DetachBufferedSectors();
+
+  // Native precaching keeps the whole image resident, skip it when we're trying to save memory.
+  const CDImage::PrecacheResult res =
+    compressed ? CDImage::PrecacheResult::Unsupported : m_media->Precache(callback, error);
   if (res == CDImage::PrecacheResult::Unsupported)
   {
     // fall back to copy precaching
-    std::unique_ptr<CDImage> memory_image = CDImage::CreateMemoryImage(m_media.get(), callback, error);
+    std::unique_ptr<CDImage> memory_image =
+      compressed ? CDImage::CreateCompressedMemoryImage(m_media.get(), callback, error) :
+                   CDImage::CreateMemoryImage(m_media.get(), callback, error);
     if (memory_image)
     {
       const CDImage::LBA lba = m_media->GetPositionOnDisc();
@@ -123,6 +152,9 @@ void CDROMAsyncReader::QueueReadSector(CDImage::LBA lba)
     {
       // great, don't need a seek, but still kick the thread to start reading ahead again
       DEBUG_LOG("Readahead buffer hit for sector {}", lba);
+      if ((++m_sequential_reads) >= m_readahead_window.load())
+        GrowReadaheadWindow();
+
       m_buffer_front.store(next_buffer);
       m_buffer_count.fetch_sub(1);
       m_can_readahead.store(true);
@@ -133,6 +165,8 @@ void CDROMAsyncReader::QueueReadSector(CDImage::LBA lba)
 
   // we need to toss away our readahead and start fresh
   DEBUG_LOG("Readahead buffer miss, queueing seek to {}", lba);
+  ShrinkReadaheadWindow();
+
   std::unique_lock lock(m_mutex);
   m_next_position_set.store(true);
   m_next_position = lba;
@@ -163,6 +197,8 @@ bool CDROMAsyncReader::ReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ
 
 bool CDROMAsyncReader::InternalReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ* subq, SectorBuffer* data)
 {
+  EventTrace::ScopedSpan span("CD Sector Read");
+
   if (m_media->GetPositionOnDisc() != lba && !m_media->Seek(lba)) [[unlikely]]
   {
     WARNING_LOG("Seek to LBA {} failed", lba);
@@ -188,6 +224,7 @@ bool CDROMAsyncReader::WaitForReadToComplete()
   }
 
   Timer wait_timer;
+  EventTrace::ScopedSpan span("CD Read Wait");
   DEBUG_LOG("Sector read pending, waiting");
 
   std::unique_lock lock(m_mutex);
@@ -202,7 +239,10 @@ bool CDROMAsyncReader::WaitForReadToComplete()
   const u32 front = m_buffer_front.load();
   const double wait_time = wait_timer.GetTimeMilliseconds();
   if (wait_time > 1.0f) [[unlikely]]
+  {
     WARNING_LOG("Had to wait {:.2f} msec for LBA {}", wait_time, m_buffers[front].lba);
+    PerformanceCounters::AttributeStutter(PerformanceCounters::StutterCause::CDSeek);
+  }
 
   TRACE_LOG("Returning sector {} after waiting", m_buffers[front].lba);
   return m_buffers[front].result;
@@ -224,6 +264,165 @@ void CDROMAsyncReader::EmptyBuffers()
   m_buffer_count.store(0);
 }
 
+void CDROMAsyncReader::GrowReadaheadWindow()
+{
+  m_sequential_reads = 0;
+
+  const u32 window = m_readahead_window.load();
+  const u32 new_window = std::min(window * 2, static_cast<u32>(m_buffers.size()));
+  if (new_window == window)
+    return;
+
+  DEBUG_LOG("Growing readahead window to {} sectors", new_window);
+  m_readahead_window.store(new_window);
+}
+
+void CDROMAsyncReader::ShrinkReadaheadWindow()
+{
+  m_sequential_reads = 0;
+
+  const u32 window = m_readahead_window.load();
+  const u32 new_window = std::max(window / 2, std::max(m_readahead_count / MIN_READAHEAD_DIVISOR, 1u));
+  if (new_window == window)
+    return;
+
+  DEBUG_LOG("Shrinking readahead window to {} sectors", new_window);
+  m_readahead_window.store(new_window);
+}
+
+CDROMAsyncReader::HotSeek* CDROMAsyncReader::RecordSeekTarget(CDImage::LBA lba)
+{
+  const u64 use = ++m_hot_seek_counter;
+  HotSeek* victim = nullptr;
+  for (HotSeek& hs : m_hot_seeks)
+  {
+    if (hs.lba == lba)
+    {
+      hs.seek_count++;
+      hs.last_use = use;
+      return &hs;
+    }
+
+    if (!victim || hs.last_use < victim->last_use)
+      victim = &hs;
+  }
+
+  if (m_hot_seeks.size() < MAX_HOT_SEEKS)
+    victim = &m_hot_seeks.emplace_back();
+
+  victim->lba = lba;
+  victim->seek_count = 1;
+  victim->sector_count = 0;
+  victim->last_use = use;
+  return victim;
+}
+
+u32 CDROMAsyncReader::FillBuffersFromHotSeek(const HotSeek& hs)
+{
+  const u32 count = std::min(hs.sector_count, m_readahead_window.load());
+  for (u32 i = 0; i < count; i++)
+    CopyBufferSlot(m_buffers[i], hs.sectors[i]);
+
+  m_buffer_back.store(count % static_cast<u32>(m_buffers.size()));
+  m_buffer_count.store(count);
+  return count;
+}
+
+void CDROMAsyncReader::RetainHotSeekSector(const BufferSlot& buffer)
+{
+  HotSeek* const hs = m_retaining_hot_seek;
+  if (!buffer.result || buffer.lba != (hs->lba + hs->sector_count))
+  {
+    m_retaining_hot_seek = nullptr;
+    return;
+  }
+
+  if (!hs->sectors)
+    hs->sectors = std::make_unique<BufferSlot[]>(HOT_SEEK_SECTORS);
+
+  CopyBufferSlot(hs->sectors[hs->sector_count++], buffer);
+  if (hs->sector_count == HOT_SEEK_SECTORS)
+    m_retaining_hot_seek = nullptr;
+}
+
+void CDROMAsyncReader::CopyBufferSlot(BufferSlot& dst, const BufferSlot& src)
+{
+  dst.lba = src.lba;
+  dst.subq = src.subq;
+  dst.result = src.result;
+
+  // Unpacked XA data isn't retained, the CPU thread will unpack it itself.
+  dst.xa_unpacked = false;
+
+  // Mapped sectors can be shared, but local copies have to follow the slot.
+  if (src.data_ptr == src.data.data())
+  {
+    dst.data = src.data;
+    dst.data_ptr = dst.data.data();
+  }
+  else
+  {
+    dst.data_ptr = src.data_ptr;
+  }
+}
+
+bool CDROMAsyncReader::ReadSectorIntoSlot(BufferSlot& buffer)
+{
+  EventTrace::ScopedSpan span("CD Sector Read");
+
+  // Memory-mapped images can hand out the sector directly without copying it.
+  if ((buffer.data_ptr = m_media->ReadRawSectorInPlace(&buffer.subq)) != nullptr)
+    return true;
+
+  buffer.data_ptr = buffer.data.data();
+  return m_media->ReadRawSector(buffer.data.data(), &buffer.subq);
+}
+
+bool CDROMAsyncReader::IsXAADPCMSector(const u8* raw_sector)
+{
+  // Mode 2 header, with the audio and real-time submode bits set.
+  static constexpr u32 MODE_OFFSET = CDImage::SECTOR_SYNC_SIZE + 3;
+  static constexpr u32 SUBMODE_OFFSET = CDImage::SECTOR_SYNC_SIZE + CDImage::SECTOR_HEADER_SIZE + 2;
+  static constexpr u8 SUBMODE_AUDIO_REALTIME = (1 << 2) | (1 << 6);
+
+  return (raw_sector[MODE_OFFSET] == 2 &&
+          (raw_sector[SUBMODE_OFFSET] & SUBMODE_AUDIO_REALTIME) == SUBMODE_AUDIO_REALTIME);
+}
+
+void CDROMAsyncReader::UnpackXAADPCMSector(const u8* raw_sector, XAADPCM::UnpackedSector* out)
+{
+  static constexpr u32 CODINGINFO_OFFSET = CDImage::SECTOR_SYNC_SIZE + CDImage::SECTOR_HEADER_SIZE + 3;
+  static constexpr u32 DATA_OFFSET = CDImage::SECTOR_SYNC_SIZE + CDImage::SECTOR_HEADER_SIZE + 8;
+
+  const bool is_8bit = ((raw_sector[CODINGINFO_OFFSET] >> 4) & 1) != 0;
+  XAADPCM::UnpackSector(raw_sector + DATA_OFFSET, is_8bit, out);
+}
+
+void CDROMAsyncReader::ClearHotSeeks()
+{
+  std::unique_lock lock(m_mutex);
+  m_hot_seeks.clear();
+  m_retaining_hot_seek = nullptr;
+  m_hot_seek_counter = 0;
+}
+
+void CDROMAsyncReader::DetachBufferedSectors()
+{
+  // The sector at the front may still be consumed by the CPU thread, so the buffers are copied rather than dropped.
+  for (BufferSlot& buffer : m_buffers)
+  {
+    if (buffer.data_ptr && buffer.data_ptr != buffer.data.data())
+    {
+      std::memcpy(buffer.data.data(), buffer.data_ptr, buffer.data.size());
+      buffer.data_ptr = buffer.data.data();
+    }
+  }
+
+  m_hot_seeks.clear();
+  m_retaining_hot_seek = nullptr;
+  m_hot_seek_counter = 0;
+}
+
 bool CDROMAsyncReader::ReadSectorIntoBuffer(std::unique_lock<std::mutex>& lock)
 {
   Timer timer;
@@ -238,15 +437,21 @@ bool CDROMAsyncReader::ReadSectorIntoBuffer(std::unique_lock<std::mutex>& lock)
 
   TRACE_LOG("Reading LBA {}...", buffer.lba);
 
-  buffer.result = m_media->ReadRawSector(buffer.data.data(), &buffer.subq);
+  buffer.result = ReadSectorIntoSlot(buffer);
   if (buffer.result) [[likely]]
   {
     const double read_time = timer.GetTimeMilliseconds();
     if (read_time > 1.0f) [[unlikely]]
       DEV_LOG("Read LBA {} took {:.2f} msec", buffer.lba, read_time);
+
+    // Get the ADPCM unpacking out of the way while we're off the CPU thread.
+    buffer.xa_unpacked = IsXAADPCMSector(buffer.data_ptr);
+    if (buffer.xa_unpacked)
+      UnpackXAADPCMSector(buffer.data_ptr, &m_xa_buffers[slot]);
   }
   else
   {
+    buffer.xa_unpacked = false;
     ERROR_LOG("Read of LBA {} failed", buffer.lba);
   }
 
@@ -254,6 +459,10 @@ bool CDROMAsyncReader::ReadSectorIntoBuffer(std::unique_lock<std::mutex>& lock)
   m_is_reading.store(false);
   m_buffer_count.fetch_add(1);
   m_notify_read_complete_cv.notify_all();
+
+  if (m_retaining_hot_seek)
+    RetainHotSeekSector(buffer);
+
   return true;
 }
 
@@ -277,7 +486,8 @@ void CDROMAsyncReader::ReadSectorNonThreaded(CDImage::LBA lba)
 
   TRACE_LOG("Reading LBA {}...", buffer.lba);
 
-  buffer.result = m_media->ReadRawSector(buffer.data.data(), &buffer.subq);
+  buffer.result = ReadSectorIntoSlot(buffer);
+  buffer.xa_unpacked = false;
   if (buffer.result) [[likely]]
   {
     const double read_time = timer.GetTimeMilliseconds();
@@ -308,6 +518,9 @@ void CDROMAsyncReader::CancelReadahead()
 
 void CDROMAsyncReader::WorkerThreadEntryPoint()
 {
+  Threading::SetNameOfCurrentThread("CD Reader");
+  Threading::ApplyBackgroundWorkerAffinity();
+
   std::unique_lock lock(m_mutex);
 
   for (;;)
@@ -326,12 +539,30 @@ void CDROMAsyncReader::WorkerThreadEntryPoint()
         EmptyBuffers();
         m_next_position_set.store(false);
         m_seek_error.store(false);
+
+        // repeatedly-used targets can be served from the retained sectors, skipping over them in the image
+        m_retaining_hot_seek = nullptr;
+        u32 retained_count = 0;
+        if (HotSeek* hs = RecordSeekTarget(seek_location); hs->seek_count >= HOT_SEEK_THRESHOLD)
+        {
+          if (hs->sector_count > 0)
+          {
+            retained_count = FillBuffersFromHotSeek(*hs);
+            DEBUG_LOG("Serving {} sectors from retained seek to LBA {}", retained_count, seek_location);
+            m_notify_read_complete_cv.notify_all();
+          }
+
+          if (hs->sector_count < HOT_SEEK_SECTORS)
+            m_retaining_hot_seek = hs;
+        }
+
         m_is_reading.store(true);
         lock.unlock();
 
         // seek without lock held in case it takes time
-        DEBUG_LOG("Seeking to LBA {}...", seek_location);
-        const bool seek_result = (m_media->GetPositionOnDisc() == seek_location || m_media->Seek(seek_location));
+        const CDImage::LBA read_location = seek_location + retained_count;
+        DEBUG_LOG("Seeking to LBA {}...", read_location);
+        const bool seek_result = (m_media->GetPositionOnDisc() == read_location || m_media->Seek(read_location));
 
         lock.lock();
         m_is_reading.store(false);
@@ -358,8 +589,9 @@ void CDROMAsyncReader::WorkerThreadEntryPoint()
         break;
 
       // readahead time! read as many sectors as we have space for
-      DEBUG_LOG("Reading ahead {} sectors...", static_cast<u32>(m_buffers.size()) - m_buffer_count.load());
-      while (m_buffer_count.load() < static_cast<u32>(m_buffers.size()))
+      const u32 window = m_readahead_window.load();
+      DEBUG_LOG("Reading ahead {} sectors...", window - std::min(m_buffer_count.load(), window));
+      while (m_buffer_count.load() < window)
       {
         if (m_next_position_set.load())
         {
@@ -3,11 +3,14 @@
 
 #pragma once
 #include "util/cd_image.h"
+#include "util/xa_adpcm.h"
 #include "types.h"
 #include <array>
 #include <atomic>
 #include <condition_variable>
+#include <memory>
 #include <thread>
+#include <vector>
 
 class ProgressCallback;
 
@@ -19,20 +22,28 @@ public:
   struct BufferSlot
   {
     CDImage::LBA lba;
+    const u8* data_ptr; // either points into the image's file mapping, or at data
     SectorBuffer data;
     CDImage::SubChannelQ subq;
     bool result;
+    bool xa_unpacked;
   };
 
   CDROMAsyncReader();
   ~CDROMAsyncReader();
 
   CDImage::LBA GetLastReadSector() const { return m_buffers[m_buffer_front.load()].lba; }
-  const SectorBuffer& GetSectorBuffer() const { return m_buffers[m_buffer_front.load()].data; }
+  const u8* GetSectorData() const { return m_buffers[m_buffer_front.load()].data_ptr; }
   const CDImage::SubChannelQ& GetSectorSubQ() const { return m_buffers[m_buffer_front.load()].subq; }
+  const XAADPCM::UnpackedSector* GetSectorXAADPCM() const
+  {
+    const u32 front = m_buffer_front.load();
+    return m_buffers[front].xa_unpacked ? &m_xa_buffers[front] : nullptr;
+  }
   u32 GetBufferedSectorCount() const { return m_buffer_count.load(); }
   bool HasBufferedSectors() const { return (m_buffer_count.load() > 0); }
-  u32 GetReadaheadCount() const { return static_cast<u32>(m_buffers.size()); }
+  u32 GetReadaheadCount() const { return m_readahead_count; }
+  u32 GetReadaheadWindow() const { return m_readahead_window.load(); }
 
   bool HasMedia() const { return static_cast<bool>(m_media); }
   const CDImage* GetMedia() const { return m_media.get(); }
@@ -47,7 +58,9 @@ public:
   std::unique_ptr<CDImage> RemoveMedia();
 
   /// Precaches image, either to memory, or using the underlying image precache.
-  bool Precache(ProgressCallback* callback, Error* error);
+  /// If compressed is set, the image is always copied to memory, compressed, to reduce the memory footprint.
+  /// An image which is already precached is copied again if it isn't in the requested form.
+  bool Precache(bool compressed, ProgressCallback* callback, Error* error);
 
   void QueueReadSector(CDImage::LBA lba);
 
@@ -57,8 +70,47 @@ public:
   /// Bypasses the sector cache and reads directly from the image.
   bool ReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ* subq, SectorBuffer* data);
 
+  /// Returns true if the sector is a real-time XA-ADPCM audio sector.
+  static bool IsXAADPCMSector(const u8* raw_sector);
+
+  /// Unpacks the ADPCM data of the sector, ahead of filtering. The sector must be an XA-ADPCM sector.
+  static void UnpackXAADPCMSector(const u8* raw_sector, XAADPCM::UnpackedSector* out);
+
 private:
+  // The readahead window grows up to this multiple of the configured count during sequential reads, and shrinks down
+  // to a quarter of it on seeks.
+  static constexpr u32 MAX_READAHEAD_SCALE = 4;
+  static constexpr u32 MIN_READAHEAD_DIVISOR = 4;
+
+  // Seek targets which are jumped to repeatedly have the sectors after them retained.
+  static constexpr u32 MAX_HOT_SEEKS = 16;
+  static constexpr u32 HOT_SEEK_THRESHOLD = 2;
+  static constexpr u32 HOT_SEEK_SECTORS = 8;
+
+  struct HotSeek
+  {
+    CDImage::LBA lba;
+    u32 seek_count;
+    u32 sector_count;
+    u64 last_use;
+    std::unique_ptr<BufferSlot[]> sectors;
+  };
+
   void EmptyBuffers();
+  void GrowReadaheadWindow();
+  void ShrinkReadaheadWindow();
+  HotSeek* RecordSeekTarget(CDImage::LBA lba);
+  u32 FillBuffersFromHotSeek(const HotSeek& hs);
+  void RetainHotSeekSector(const BufferSlot& buffer);
+  bool ReadSectorIntoSlot(BufferSlot& buffer);
+
+  static void CopyBufferSlot(BufferSlot& dst, const BufferSlot& src);
+  void ClearHotSeeks();
+
+  /// Copies buffered sectors which point into the image's file mapping into their slots, and drops retained hot seek
+  /// sectors. Must be called with the lock held and the worker idle.
+  void DetachBufferedSectors();
+
   bool ReadSectorIntoBuffer(std::unique_lock<std::mutex>& lock);
   void ReadSectorNonThreaded(CDImage::LBA lba);
   bool InternalReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ* subq, SectorBuffer* data);
@@ -82,7 +134,18 @@ private:
   std::atomic_bool m_seek_error{false};
 
   std::vector<BufferSlot> m_buffers;
+  std::vector<XAADPCM::UnpackedSector> m_xa_buffers;
   std::atomic<u32> m_buffer_front{0};
   std::atomic<u32> m_buffer_back{0};
   std::atomic<u32> m_buffer_count{0};
+
+  // Window is written by the CPU thread, and read by the worker when deciding how far to read ahead.
+  u32 m_readahead_count = 0;
+  u32 m_sequential_reads = 0;
+  std::atomic<u32> m_readahead_window{0};
+
+  // Owned by the worker thread, with the lock held.
+  std::vector<HotSeek> m_hot_seeks;
+  HotSeek* m_retaining_hot_seek = nullptr;
+  u64 m_hot_seek_counter = 0;
 };
@@ -6,6 +6,7 @@
 #include "bus.h"
 #include "controller.h"
 #include "core.h"
+#include "cpu_code_cache.h"
 #include "cpu_core.h"
 #include "game_database.h"
 #include "host.h"
@@ -14,6 +15,7 @@
 #include "util/imgui_manager.h"
 #include "util/translation.h"
 
+#include "common/align.h"
 #include "common/assert.h"
 #include "common/error.h"
 #include "common/file_system.h"
@@ -22,6 +24,7 @@
 #include "common/settings_interface.h"
 #include "common/small_string.h"
 #include "common/string_util.h"
+#include "common/timer.h"
 #include "common/zip_helpers.h"
 
 #include "IconsEmoji.h"
@@ -98,69 +101,40 @@ private:
   u32 m_current_line_number = 0;
 };
 
-class CheatArchive
-{
-public:
-  ~CheatArchive()
-  {
-    // zip has to be destroyed before data
-    m_zip.reset();
-    m_data.deallocate();
-  }
-
-  ALWAYS_INLINE bool IsOpen() const { return static_cast<bool>(m_zip); }
-
-  bool Open(bool cheats)
-  {
-    if (m_zip)
-      return true;
-
-#ifndef __ANDROID__
-    const char* name = cheats ? "cheats.zip" : "patches.zip";
-#else
-    const char* name = cheats ? "patchcodes.zip" : "patches.zip";
-#endif
-
-    Error error;
-    std::optional<DynamicHeapArray<u8>> data = Host::ReadResourceFile(name, false, &error);
-    if (!data.has_value())
-    {
-      ERROR_LOG("Failed to read cheat archive {}: {}", name, error.GetDescription());
-      return false;
-    }
-
-    m_data = std::move(data.value());
-    m_zip = ZipHelpers::OpenManagedZipBuffer(m_data.data(), m_data.size(), 0, false, &error);
-    if (!m_zip) [[unlikely]]
-    {
-      ERROR_LOG("Failed to open cheat archive {}: {}", name, error.GetDescription());
-      return false;
-    }
+} // namespace
 
-    return true;
-  }
+namespace Cheats {
 
-  std::optional<std::string> ReadFile(const char* name) const
+namespace {
+/// Flattened form of frame end code instructions. Codes which only do simple reads and writes to RAM are compiled to
+/// these when the active list changes, with addresses checked and the skip targets of conditional chains resolved
+/// ahead of time, so applying them each frame doesn't have to go through the interpreter and the generic bus path.
+struct CompiledInstruction
+{
+  enum class Op : u8
   {
-    Error error;
-    std::optional<std::string> ret = ZipHelpers::ReadFileInZipToString(m_zip.get(), name, true, &error);
-    if (!ret.has_value())
-      DEV_LOG("Failed to read {} from zip: {}", name, error.GetDescription());
-    return ret;
-  }
+    Nop,
+    Write,
+    Or,
+    And,
+    Add,
+    Sub,
+    CompareEqual,
+    CompareNotEqual,
+    CompareLess,
+    CompareGreater,
+    Interpret,
+  };
 
-private:
-  // Maybe counter-intuitive, but it ends up faster for reading a single game's cheats if we keep a
-  // copy of the archive in memory, as opposed to reading from disk.
-  DynamicHeapArray<u8> m_data;
-  ZipHelpers::ManagedZipT m_zip;
+  Op op;
+  MemoryAccessSize size;
+  u32 address; // physical RAM address, naturally aligned
+  u32 value;
+  u32 target; // instruction index to continue at if a comparison fails, or the index of the code to interpret
 };
 
-} // namespace
-
-namespace Cheats {
+using CompiledInstructionList = std::vector<CompiledInstruction>;
 
-namespace {
 /// Represents a cheat code, after being parsed.
 class CheatCode
 {
@@ -197,6 +171,9 @@ public:
   virtual void Apply() const = 0;
   virtual void ApplyOnDisable() const = 0;
 
+  /// Appends the compiled form of the code to the list, returns false if it has to be interpreted instead.
+  virtual bool Compile(CompiledInstructionList* dst) const = 0;
+
 protected:
   Metadata m_metadata;
 };
@@ -206,6 +183,109 @@ using CheatCodeList = std::vector<std::unique_ptr<CheatCode>>;
 using ActiveCodeList = std::vector<const CheatCode*>;
 using EnableCodeList = std::vector<std::string>;
 
+namespace {
+
+/// Index of the bundled cheat/patch archive. Building it decompresses and parses every file in the zip once, and it
+/// is cached as a flat image which is mapped on later runs. Looking up a game's codes is then a binary search, with
+/// no decompression or parsing of the code metadata.
+class CheatArchive
+{
+public:
+  struct File
+  {
+    const CheatArchive* archive;
+    std::string_view contents;
+    u32 index;
+
+    /// Appends the pre-parsed metadata for the codes in this file.
+    void GetCodeInfo(CodeInfoList* dst) const { archive->GetCodeInfo(index, dst); }
+  };
+
+  ALWAYS_INLINE bool IsOpen() const { return m_open; }
+
+  bool Open(bool cheats);
+
+  std::optional<File> FindFile(std::string_view name) const;
+
+private:
+  struct ImageString
+  {
+    u32 offset;
+    u32 length;
+  };
+
+  struct IndexHeader
+  {
+    u32 signature;
+    u32 version;
+    u64 archive_ts;
+    u32 num_files;
+    u32 files_offset;
+    u32 num_codes;
+    u32 codes_offset;
+    u32 num_options;
+    u32 options_offset;
+    u32 strings_offset;
+    u32 strings_size;
+  };
+
+  // Sorted by name.
+  struct FileRecord
+  {
+    ImageString name;
+    ImageString contents;
+    u32 first_code;
+    u32 num_codes;
+  };
+
+  struct CodeRecord
+  {
+    ImageString name;
+    ImageString author;
+    ImageString description;
+    ImageString body;
+    u32 first_option;
+    u32 num_options;
+    u32 file_offset_start;
+    u32 file_offset_body_start;
+    u32 file_offset_end;
+    u16 option_range_start;
+    u16 option_range_end;
+    CodeType type;
+    CodeActivation activation;
+    bool disallow_for_achievements;
+  };
+
+  struct OptionRecord
+  {
+    ImageString name;
+    u32 value;
+  };
+
+  static constexpr u32 INDEX_SIGNATURE = 0x58444943; // CIDX
+  static constexpr u32 INDEX_VERSION = 1;
+  static constexpr u32 INDEX_SECTION_ALIGNMENT = 8;
+
+  template<typename T>
+  static bool GetSection(std::span<const u8> data, u32 offset, u32 count, std::span<const T>* records);
+
+  bool OpenIndex(std::span<const u8> data, u64 archive_ts);
+  bool BuildIndex(const char* name, u64 archive_ts, Error* error);
+
+  std::string_view GetString(const ImageString& str) const;
+  void GetCodeInfo(u32 file_index, CodeInfoList* dst) const;
+
+  FileSystem::MappedFile m_index_data; // when loaded from the cache
+  std::vector<u8> m_built_data;        // when built, and the cache couldn't be used
+  std::span<const FileRecord> m_files;
+  std::span<const CodeRecord> m_codes;
+  std::span<const OptionRecord> m_options;
+  std::string_view m_strings;
+  bool m_open = false;
+};
+
+} // namespace
+
 static std::string GetChtTemplate(const std::string_view serial, std::optional<GameHash> hash, bool add_wildcard);
 static std::vector<std::string> FindChtFilesOnDisk(const std::string_view serial, std::optional<GameHash> hash,
                                                    bool cheats);
@@ -220,6 +300,7 @@ static void ReloadEnabledLists();
 static u32 EnablePatches(const CheatCodeList& patches, const EnableCodeList& enable_list, const char* section,
                          bool hc_mode_active);
 static bool EnableWidescreenPatch(const CheatCodeList& patches, bool hc_mode_active);
+static void CompileFrameEndCodes();
 static void UpdateActiveCodes(bool reload_enabled_list, bool verbose, bool verbose_if_changed,
                               bool show_disabled_codes);
 
@@ -256,6 +337,8 @@ struct Locals
   EnableCodeList enabled_patches;
 
   ActiveCodeList frame_end_codes;
+  CompiledInstructionList frame_end_program;
+  ActiveCodeList frame_end_interpreted_codes;
 
   u32 active_patch_count = 0;
   u32 active_cheat_count = 0;
@@ -278,6 +361,258 @@ ALIGN_TO_CACHE_LINE static ArchiveLocals s_archive_locals;
 
 } // namespace Cheats
 
+template<typename T>
+bool Cheats::CheatArchive::GetSection(std::span<const u8> data, u32 offset, u32 count, std::span<const T>* records)
+{
+  if ((offset % alignof(T)) != 0 || offset > data.size() || count > ((data.size() - offset) / sizeof(T)))
+    return false;
+
+  *records = std::span<const T>(reinterpret_cast<const T*>(data.data() + offset), count);
+  return true;
+}
+
+bool Cheats::CheatArchive::Open(bool cheats)
+{
+  if (m_open)
+    return true;
+
+#ifndef __ANDROID__
+  const char* name = cheats ? "cheats.zip" : "patches.zip";
+#else
+  const char* name = cheats ? "patchcodes.zip" : "patches.zip";
+#endif
+
+  const std::string index_path = Path::Combine(EmuFolders::Cache, fmt::format("{}.idx", Path::GetFileTitle(name)));
+  const u64 archive_ts = static_cast<u64>(Host::GetResourceFileTimestamp(name, false).value_or(0));
+
+  Error error;
+  if (std::optional<FileSystem::MappedFile> data = FileSystem::MapBinaryFile(index_path.c_str(), &error);
+      data.has_value() && OpenIndex(data->cspan(), archive_ts))
+  {
+    m_index_data = std::move(data.value());
+    m_open = true;
+    return true;
+  }
+
+  Timer timer;
+  if (!BuildIndex(name, archive_ts, &error))
+  {
+    ERROR_LOG("Failed to index cheat archive {}: {}", name, error.GetDescription());
+    return false;
+  }
+
+  INFO_LOG("Indexed {} codes in {} files from {} in {:.0f}ms.", m_codes.size(), m_files.size(), name,
+           timer.GetTimeMilliseconds());
+
+  if (!FileSystem::WriteAtomicRenamedFile(index_path, m_built_data, &error))
+    ERROR_LOG("Failed to write cheat archive index {}: {}", Path::GetFileName(index_path), error.GetDescription());
+
+  m_open = true;
+  return true;
+}
+
+bool Cheats::CheatArchive::OpenIndex(std::span<const u8> data, u64 archive_ts)
+{
+  IndexHeader header;
+  if (data.size() < sizeof(header))
+    return false;
+
+  std::memcpy(&header, data.data(), sizeof(header));
+  if (header.signature != INDEX_SIGNATURE || header.version != INDEX_VERSION || header.archive_ts != archive_ts)
+  {
+    DEV_LOG("Cheat archive index is out of date, recreating.");
+    return false;
+  }
+
+  std::span<const char> strings;
+  if (!GetSection(data, header.files_offset, header.num_files, &m_files) ||
+      !GetSection(data, header.codes_offset, header.num_codes, &m_codes) ||
+      !GetSection(data, header.options_offset, header.num_options, &m_options) ||
+      !GetSection(data, header.strings_offset, header.strings_size, &strings))
+  {
+    DEV_LOG("Cheat archive index is corrupted.");
+    m_files = {};
+    m_codes = {};
+    m_options = {};
+    return false;
+  }
+
+  m_strings = std::string_view(strings.data(), strings.size());
+  return true;
+}
+
+bool Cheats::CheatArchive::BuildIndex(const char* name, u64 archive_ts, Error* error)
+{
+  // Maybe counter-intuitive, but it ends up faster to decompress from the archive mapped in memory.
+  std::optional<FileSystem::MappedFile> data = Host::MapResourceFile(name, false, error);
+  if (!data.has_value())
+    return false;
+
+  ZipHelpers::ManagedZipT zip = ZipHelpers::OpenManagedZipBuffer(data->data(), data->size(), 0, false, error);
+  if (!zip)
+    return false;
+
+  struct ArchiveFile
+  {
+    std::string name;
+    std::string contents;
+  };
+
+  std::vector<ArchiveFile> files;
+  const zip_int64_t num_entries = zip_get_num_entries(zip.get(), 0);
+  files.reserve(static_cast<size_t>(std::max<zip_int64_t>(num_entries, 0)));
+  for (zip_int64_t i = 0; i < num_entries; i++)
+  {
+    zip_stat_t zst;
+    if (zip_stat_index(zip.get(), static_cast<zip_uint64_t>(i), 0, &zst) != 0 || !(zst.valid & ZIP_STAT_NAME) ||
+        !StringUtil::EndsWithNoCase(zst.name, ".cht"))
+    {
+      continue;
+    }
+
+    Error read_error;
+    std::optional<std::string> contents = ZipHelpers::ReadFileInZipToString(zip.get(), zst.name, true, &read_error);
+    if (!contents.has_value())
+    {
+      WARNING_LOG("Failed to read {} from zip: {}", zst.name, read_error.GetDescription());
+      continue;
+    }
+
+    files.push_back(ArchiveFile{zst.name, std::move(contents.value())});
+  }
+
+  // zip has to be destroyed before data
+  zip.reset();
+  data.reset();
+
+  std::sort(files.begin(), files.end(),
+            [](const ArchiveFile& lhs, const ArchiveFile& rhs) { return (lhs.name < rhs.name); });
+
+  std::string strings;
+  const auto add_string = [&strings](std::string_view str) {
+    const ImageString ret = {static_cast<u32>(strings.size()), static_cast<u32>(str.size())};
+    strings.append(str);
+    return ret;
+  };
+
+  std::vector<FileRecord> file_records;
+  std::vector<CodeRecord> code_records;
+  std::vector<OptionRecord> option_records;
+  file_records.reserve(files.size());
+  for (const ArchiveFile& file : files)
+  {
+    CodeInfoList codes;
+    ExtractCodeInfo(&codes, file.contents, true, false, nullptr);
+
+    file_records.push_back(FileRecord{add_string(file.name), add_string(file.contents),
+                                      static_cast<u32>(code_records.size()), static_cast<u32>(codes.size())});
+    for (const CodeInfo& code : codes)
+    {
+      CodeRecord& record = code_records.emplace_back();
+      record.name = add_string(code.name);
+      record.author = add_string(code.author);
+      record.description = add_string(code.description);
+      record.body = add_string(code.body);
+      record.first_option = static_cast<u32>(option_records.size());
+      record.num_options = static_cast<u32>(code.options.size());
+      record.file_offset_start = code.file_offset_start;
+      record.file_offset_body_start = code.file_offset_body_start;
+      record.file_offset_end = code.file_offset_end;
+      record.option_range_start = code.option_range_start;
+      record.option_range_end = code.option_range_end;
+      record.type = code.type;
+      record.activation = code.activation;
+      record.disallow_for_achievements = code.disallow_for_achievements;
+      for (const CodeOption& option : code.options)
+        option_records.push_back(OptionRecord{add_string(option.first), option.second});
+    }
+  }
+
+  IndexHeader header = {};
+  header.signature = INDEX_SIGNATURE;
+  header.version = INDEX_VERSION;
+  header.archive_ts = archive_ts;
+  header.num_files = static_cast<u32>(file_records.size());
+  header.num_codes = static_cast<u32>(code_records.size());
+  header.num_options = static_cast<u32>(option_records.size());
+  header.strings_size = static_cast<u32>(strings.size());
+
+  std::vector<u8> image(sizeof(header));
+  const auto append_section = [&image](const void* section_data, size_t size) {
+    const size_t offset = Common::AlignUpPow2(image.size(), INDEX_SECTION_ALIGNMENT);
+    image.resize(offset + size);
+    if (size > 0)
+      std::memcpy(image.data() + offset, section_data, size);
+    return static_cast<u32>(offset);
+  };
+  header.files_offset = append_section(file_records.data(), file_records.size() * sizeof(FileRecord));
+  header.codes_offset = append_section(code_records.data(), code_records.size() * sizeof(CodeRecord));
+  header.options_offset = append_section(option_records.data(), option_records.size() * sizeof(OptionRecord));
+  header.strings_offset = append_section(strings.data(), strings.size());
+  std::memcpy(image.data(), &header, sizeof(header));
+
+  m_built_data = std::move(image);
+  if (!OpenIndex(m_built_data, archive_ts))
+  {
+    Error::SetStringView(error, "Failed to open newly-built index.");
+    m_built_data = {};
+    return false;
+  }
+
+  return true;
+}
+
+std::string_view Cheats::CheatArchive::GetString(const ImageString& str) const
+{
+  // records aren't validated on load, so a corrupted index gives empty strings rather than reading out of bounds
+  return (str.offset <= m_strings.size() && str.length <= (m_strings.size() - str.offset)) ?
+           m_strings.substr(str.offset, str.length) :
+           std::string_view();
+}
+
+std::optional<Cheats::CheatArchive::File> Cheats::CheatArchive::FindFile(std::string_view name) const
+{
+  const auto it = std::lower_bound(
+    m_files.begin(), m_files.end(), name,
+    [this](const FileRecord& record, const std::string_view& search) { return (GetString(record.name) < search); });
+  if (it == m_files.end() || GetString(it->name) != name)
+    return std::nullopt;
+
+  return File{this, GetString(it->contents), static_cast<u32>(std::distance(m_files.begin(), it))};
+}
+
+void Cheats::CheatArchive::GetCodeInfo(u32 file_index, CodeInfoList* dst) const
+{
+  const FileRecord& file = m_files[file_index];
+  if (file.first_code > m_codes.size() || file.num_codes > (m_codes.size() - file.first_code))
+    return;
+
+  for (const CodeRecord& record : m_codes.subspan(file.first_code, file.num_codes))
+  {
+    CodeInfo code;
+    code.name = GetString(record.name);
+    code.author = GetString(record.author);
+    code.description = GetString(record.description);
+    code.body = GetString(record.body);
+    if (record.first_option <= m_options.size() && record.num_options <= (m_options.size() - record.first_option))
+    {
+      code.options.reserve(record.num_options);
+      for (const OptionRecord& option : m_options.subspan(record.first_option, record.num_options))
+        code.options.emplace_back(GetString(option.name), option.value);
+    }
+    code.option_range_start = record.option_range_start;
+    code.option_range_end = record.option_range_end;
+    code.file_offset_start = record.file_offset_start;
+    code.file_offset_body_start = record.file_offset_body_start;
+    code.file_offset_end = record.file_offset_end;
+    code.type = record.type;
+    code.activation = record.activation;
+    code.from_database = true;
+    code.disallow_for_achievements = record.disallow_for_achievements;
+    AppendCheatToList(dst, std::move(code));
+  }
+}
+
 Cheats::CheatCode::CheatCode(Metadata metadata) : m_metadata(std::move(metadata))
 {
 }
@@ -409,16 +744,16 @@ bool Cheats::SearchCheatArchive(CheatArchive& archive, std::string_view serial,
 {
   // Prefer filename with hash.
   std::string zip_filename = GetChtTemplate(serial, hash, false);
-  std::optional<std::string> data = archive.ReadFile(zip_filename.c_str());
-  if (!data.has_value() && hash.has_value())
+  std::optional<CheatArchive::File> file = archive.FindFile(zip_filename);
+  if (!file.has_value() && hash.has_value())
   {
     // Try without the hash.
     zip_filename = GetChtTemplate(serial, std::nullopt, false);
-    data = archive.ReadFile(zip_filename.c_str());
+    file = archive.FindFile(zip_filename);
   }
-  if (data.has_value())
+  if (file.has_value())
   {
-    f(zip_filename, std::move(data.value()), true);
+    f(zip_filename, file->contents, &file.value());
     return true;
   }
 
@@ -496,7 +831,7 @@ void Cheats::EnumerateChtFiles(const std::string_view serial, std::optional<Game
       {
         const std::optional<std::string> contents = FileSystem::ReadFileToString(file.c_str(), &error);
         if (contents.has_value())
-          f(file, std::move(contents.value()), false);
+          f(file, contents.value(), nullptr);
         else
           WARNING_LOG("Failed to read cht file '{}': {}", Path::GetFileName(file), error.GetDescription());
       }
@@ -563,8 +898,11 @@ Cheats::CodeInfoList Cheats::GetCodeInfoList(const std::string_view serial, std:
   CodeInfoList ret;
 
   EnumerateChtFiles(serial, hash, cheats, true, true, load_from_database,
-                    [&ret](const std::string& filename, const std::string& data, bool from_database) {
-                      ExtractCodeInfo(&ret, data, from_database, false, nullptr);
+                    [&ret](const std::string& filename, std::string_view data, const CheatArchive::File* db_file) {
+                      if (db_file)
+                        db_file->GetCodeInfo(&ret);
+                      else
+                        ExtractCodeInfo(&ret, data, false, false, nullptr);
                     });
 
   if (sort_by_name)
@@ -997,7 +1335,8 @@ void Cheats::ReloadCheats(bool reload_files, bool reload_enabled_list, bool verb
       if (patches_are_enabled)
       {
         EnumerateChtFiles(serial, hash, false, false, !Achievements::IsHardcoreModeActive(), true,
-                          [](const std::string& filename, const std::string& file_contents, bool from_database) {
+                          [](const std::string& filename, std::string_view file_contents,
+                             const CheatArchive::File* db_file) {
                             ParseFile(&s_locals.patch_codes, file_contents);
                             if (s_locals.patch_codes.size() > 0)
                               INFO_LOG("Found {} game patches in {}.", s_locals.patch_codes.size(), filename);
@@ -1009,7 +1348,8 @@ void Cheats::ReloadCheats(bool reload_files, bool reload_enabled_list, bool verb
       if (cheats_are_enabled)
       {
         EnumerateChtFiles(serial, hash, true, false, true, cheatdb_is_enabled,
-                          [](const std::string& filename, const std::string& file_contents, bool from_database) {
+                          [](const std::string& filename, std::string_view file_contents,
+                             const CheatArchive::File* db_file) {
                             ParseFile(&s_locals.cheat_codes, file_contents);
                             if (s_locals.cheat_codes.size() > 0)
                               INFO_LOG("Found {} cheats in {}.", s_locals.cheat_codes.size(), filename);
@@ -1029,6 +1369,8 @@ void Cheats::UnloadAll()
   s_locals.active_cheat_count = 0;
   s_locals.active_patch_count = 0;
   s_locals.frame_end_codes = ActiveCodeList();
+  s_locals.frame_end_program = CompiledInstructionList();
+  s_locals.frame_end_interpreted_codes = ActiveCodeList();
   s_locals.enabled_patches = EnableCodeList();
   s_locals.enabled_cheats = EnableCodeList();
   s_locals.cheat_codes = CheatCodeList();
@@ -1105,6 +1447,9 @@ void Cheats::UpdateActiveCodes(bool reload_enabled_list, bool verbose, bool verb
       AreCheatsEnabled() ? EnablePatches(s_locals.cheat_codes, s_locals.enabled_cheats, "Cheats", hc_mode_active) : 0;
   }
 
+  // options have been applied by now, so the compiled values are final
+  CompileFrameEndCodes();
+
   // Display message on first boot when we load patches.
   // Except when it's just GameDB.
   const size_t new_count = s_locals.frame_end_codes.size();
@@ -1162,10 +1507,130 @@ void Cheats::UpdateActiveCodes(bool reload_enabled_list, bool verbose, bool verb
   }
 }
 
-void Cheats::ApplyFrameEndCodes()
+void Cheats::CompileFrameEndCodes()
 {
+  s_locals.frame_end_program.clear();
+  s_locals.frame_end_interpreted_codes.clear();
+
   for (const CheatCode* code : s_locals.frame_end_codes)
-    code->Apply();
+  {
+    if (code->Compile(&s_locals.frame_end_program))
+      continue;
+
+    s_locals.frame_end_program.push_back(
+      CompiledInstruction{CompiledInstruction::Op::Interpret, MemoryAccessSize::Word, 0, 0,
+                          static_cast<u32>(s_locals.frame_end_interpreted_codes.size())});
+    s_locals.frame_end_interpreted_codes.push_back(code);
+  }
+
+  if (!s_locals.frame_end_codes.empty())
+  {
+    DEV_LOG("Compiled {} of {} frame end codes.",
+            s_locals.frame_end_codes.size() - s_locals.frame_end_interpreted_codes.size(),
+            s_locals.frame_end_codes.size());
+  }
+}
+
+template<typename T>
+ALWAYS_INLINE static T ReadCompiledRAM(u32 address)
+{
+  T value;
+  std::memcpy(&value, &Bus::g_unprotected_ram[address & Bus::g_ram_mask], sizeof(value));
+  return value;
+}
+
+template<typename T>
+ALWAYS_INLINE static void WriteCompiledRAM(u32 address, T value)
+{
+  // same as a safe write, only the pages which actually change need to be flagged/invalidated
+  const u32 offset = address & Bus::g_ram_mask;
+  T old_value;
+  std::memcpy(&old_value, &Bus::g_unprotected_ram[offset], sizeof(old_value));
+  if (old_value == value)
+    return;
+
+  std::memcpy(&Bus::g_unprotected_ram[offset], &value, sizeof(value));
+
+  const u32 page_index = offset >> HOST_PAGE_SHIFT;
+  Bus::MarkRAMPageDirty(page_index);
+  if (Bus::g_ram_code_bits[page_index])
+    CPU::CodeCache::InvalidateBlocksInRange(offset, sizeof(value));
+}
+
+template<typename T>
+ALWAYS_INLINE static u32 ExecuteCompiledInstruction(const Cheats::CompiledInstruction& inst, u32 index)
+{
+  using Op = Cheats::CompiledInstruction::Op;
+
+  const T value = static_cast<T>(inst.value);
+  switch (inst.op)
+  {
+    case Op::Write:
+      WriteCompiledRAM<T>(inst.address, value);
+      return index + 1;
+
+    case Op::Or:
+      WriteCompiledRAM<T>(inst.address, static_cast<T>(ReadCompiledRAM<T>(inst.address) | value));
+      return index + 1;
+
+    case Op::And:
+      WriteCompiledRAM<T>(inst.address, static_cast<T>(ReadCompiledRAM<T>(inst.address) & value));
+      return index + 1;
+
+    case Op::Add:
+      WriteCompiledRAM<T>(inst.address, static_cast<T>(ReadCompiledRAM<T>(inst.address) + value));
+      return index + 1;
+
+    case Op::Sub:
+      WriteCompiledRAM<T>(inst.address, static_cast<T>(ReadCompiledRAM<T>(inst.address) - value));
+      return index + 1;
+
+    case Op::CompareEqual:
+      return (ReadCompiledRAM<T>(inst.address) == value) ? (index + 1) : inst.target;
+
+    case Op::CompareNotEqual:
+      return (ReadCompiledRAM<T>(inst.address) != value) ? (index + 1) : inst.target;
+
+    case Op::CompareLess:
+      return (ReadCompiledRAM<T>(inst.address) < value) ? (index + 1) : inst.target;
+
+    case Op::CompareGreater:
+      return (ReadCompiledRAM<T>(inst.address) > value) ? (index + 1) : inst.target;
+
+    case Op::Nop:
+    default:
+      return index + 1;
+  }
+}
+
+void Cheats::ApplyFrameEndCodes()
+{
+  const CompiledInstructionList& program = s_locals.frame_end_program;
+  const u32 count = static_cast<u32>(program.size());
+  for (u32 index = 0; index < count;)
+  {
+    const CompiledInstruction& inst = program[index];
+    if (inst.op == CompiledInstruction::Op::Interpret)
+    {
+      s_locals.frame_end_interpreted_codes[inst.target]->Apply();
+      index++;
+      continue;
+    }
+
+    switch (inst.size)
+    {
+      case MemoryAccessSize::Byte:
+        index = ExecuteCompiledInstruction<u8>(inst, index);
+        break;
+      case MemoryAccessSize::HalfWord:
+        index = ExecuteCompiledInstruction<u16>(inst, index);
+        break;
+      case MemoryAccessSize::Word:
+      default:
+        index = ExecuteCompiledInstruction<u32>(inst, index);
+        break;
+    }
+  }
 }
 
 bool Cheats::EnumerateManualCodes(std::function<bool(const std::string& name)> callback)
@@ -2141,6 +2606,8 @@ public:
   void Apply() const override;
   void ApplyOnDisable() const override;
 
+  bool Compile(CompiledInstructionList* dst) const override;
+
 private:
   enum class InstructionCode : u8
   {
@@ -2526,6 +2993,80 @@ u32 Cheats::GamesharkCheatCode::GetNextNonConditionalInstruction(u32 index) cons
   return index;
 }
 
+bool Cheats::GamesharkCheatCode::Compile(CompiledInstructionList* dst) const
+{
+  using Op = CompiledInstruction::Op;
+  static constexpr MemoryAccessSize S8 = MemoryAccessSize::Byte;
+  static constexpr MemoryAccessSize S16 = MemoryAccessSize::HalfWord;
+  static constexpr MemoryAccessSize S32 = MemoryAccessSize::Word;
+
+  // instructions map one-to-one, so skip targets are the same as the interpreter's, offset by where the code starts
+  const u32 base = static_cast<u32>(dst->size());
+  const u32 count = static_cast<u32>(instructions.size());
+  for (u32 index = 0; index < count; index++)
+  {
+    const Instruction& inst = instructions[index];
+
+    // values are truncated to the access size when executed, so the full word can be used for all sizes
+    Op op;
+    MemoryAccessSize size;
+    u32 value;
+    switch (inst.code)
+    {
+        // clang-format off
+      case InstructionCode::Nop:                   op = Op::Nop;             size = S8;  value = 0;             break;
+      case InstructionCode::ConstantWrite8:        op = Op::Write;           size = S8;  value = inst.value32;  break;
+      case InstructionCode::ConstantWrite16:       op = Op::Write;           size = S16; value = inst.value32;  break;
+      case InstructionCode::ExtConstantWrite32:    op = Op::Write;           size = S32; value = inst.value32;  break;
+      case InstructionCode::ExtConstantBitSet8:    op = Op::Or;              size = S8;  value = inst.value32;  break;
+      case InstructionCode::ExtConstantBitSet16:   op = Op::Or;              size = S16; value = inst.value32;  break;
+      case InstructionCode::ExtConstantBitSet32:   op = Op::Or;              size = S32; value = inst.value32;  break;
+      case InstructionCode::ExtConstantBitClear8:  op = Op::And;             size = S8;  value = ~inst.value32; break;
+      case InstructionCode::ExtConstantBitClear16: op = Op::And;             size = S16; value = ~inst.value32; break;
+      case InstructionCode::ExtConstantBitClear32: op = Op::And;             size = S32; value = ~inst.value32; break;
+      case InstructionCode::Increment8:            op = Op::Add;             size = S8;  value = inst.value32;  break;
+      case InstructionCode::Decrement8:            op = Op::Sub;             size = S8;  value = inst.value32;  break;
+      case InstructionCode::Increment16:           op = Op::Add;             size = S16; value = inst.value32;  break;
+      case InstructionCode::Decrement16:           op = Op::Sub;             size = S16; value = inst.value32;  break;
+      case InstructionCode::ExtIncrement32:        op = Op::Add;             size = S32; value = inst.value32;  break;
+      case InstructionCode::ExtDecrement32:        op = Op::Sub;             size = S32; value = inst.value32;  break;
+      case InstructionCode::CompareEqual8:         op = Op::CompareEqual;    size = S8;  value = inst.value32;  break;
+      case InstructionCode::CompareNotEqual8:      op = Op::CompareNotEqual; size = S8;  value = inst.value32;  break;
+      case InstructionCode::CompareLess8:          op = Op::CompareLess;     size = S8;  value = inst.value32;  break;
+      case InstructionCode::CompareGreater8:       op = Op::CompareGreater;  size = S8;  value = inst.value32;  break;
+      case InstructionCode::CompareEqual16:        op = Op::CompareEqual;    size = S16; value = inst.value32;  break;
+      case InstructionCode::CompareNotEqual16:     op = Op::CompareNotEqual; size = S16; value = inst.value32;  break;
+      case InstructionCode::CompareLess16:         op = Op::CompareLess;     size = S16; value = inst.value32;  break;
+      case InstructionCode::CompareGreater16:      op = Op::CompareGreater;  size = S16; value = inst.value32;  break;
+      case InstructionCode::ExtCompareEqual32:     op = Op::CompareEqual;    size = S32; value = inst.value32;  break;
+      case InstructionCode::ExtCompareNotEqual32:  op = Op::CompareNotEqual; size = S32; value = inst.value32;  break;
+      case InstructionCode::ExtCompareLess32:      op = Op::CompareLess;     size = S32; value = inst.value32;  break;
+      case InstructionCode::ExtCompareGreater32:   op = Op::CompareGreater;  size = S32; value = inst.value32;  break;
+        // clang-format on
+
+      default:
+      {
+        // everything else touches other hardware, depends on state, or uses multiple lines
+        dst->resize(base);
+        return false;
+      }
+    }
+
+    // unaligned or non-RAM accesses are split/routed by the bus, leave those to the interpreter
+    const u32 size_bytes = 1u << static_cast<u32>(size);
+    if (op != Op::Nop && (!Bus::IsRAMAddress(inst.address) || !Common::IsAlignedPow2(inst.address, size_bytes)))
+    {
+      dst->resize(base);
+      return false;
+    }
+
+    const u32 target = (op >= Op::CompareEqual) ? (base + GetNextNonConditionalInstruction(index)) : 0;
+    dst->push_back(CompiledInstruction{op, size, inst.address, value, target});
+  }
+
+  return true;
+}
+
 void Cheats::GamesharkCheatCode::Apply() const
 {
   const u32 count = static_cast<u32>(instructions.size());
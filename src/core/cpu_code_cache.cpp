@@ -3,10 +3,12 @@
 
 #include "bus.h"
 #include "cpu_code_cache_private.h"
+#include "cpu_code_cache_version.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 #include "cpu_disasm.h"
 #include "host.h"
+#include "performance_counters.h"
 #include "settings.h"
 #include "system.h"
 #include "timing_event.h"
@@ -15,10 +17,16 @@
 
 #include "common/align.h"
 #include "common/assert.h"
+#include "common/binary_reader_writer.h"
 #include "common/error.h"
+#include "common/fast_hash.h"
+#include "common/file_system.h"
 #include "common/intrin.h"
 #include "common/log.h"
 #include "common/memmap.h"
+#include "common/memory_accounting.h"
+#include "common/path.h"
+#include "common/timer.h"
 
 LOG_CHANNEL(CodeCache);
 
@@ -52,6 +60,26 @@ static constexpr u32 RECOMPILE_FRAMES_FOR_INTERPRETER_FALLBACK = 15;
 static constexpr u32 INVALIDATE_COUNT_FOR_MANUAL_PROTECTION = 4;
 static constexpr u32 INVALIDATE_FRAMES_FOR_MANUAL_PROTECTION = 60;
 
+// Limits for stitching the targets of direct jumps into the current block.
+static constexpr u32 MAX_TRACE_JUMPS = 8;
+static constexpr u32 MAX_TRACE_INSTRUCTIONS = 256;
+
+// Longest self-loop, including the branch delay slot, which is considered for idle loop skipping.
+static constexpr u32 MAX_IDLE_LOOP_INSTRUCTIONS = 8;
+
+// Persistent cache of analysed RAM blocks, used to skip decoding on warm starts.
+// BIOS blocks go in a separate file keyed by the ROM contents, so every game and instance using it can share it.
+static constexpr u32 PERSISTENT_CACHE_SIGNATURE = 0x43434B42; // BKCC
+static constexpr u32 MAX_PERSISTENT_CACHE_BLOCKS = 65536;
+
+struct PersistentBlockInfo
+{
+  BlockMetadata metadata;
+  PageProtectionMode protection;
+  BlockInstructionList instructions;
+};
+using PersistentBlockMap = std::unordered_map<u32, PersistentBlockInfo>;
+
 static void AllocateLUTs();
 static void DeallocateLUTs();
 static void ResetCodeLUT();
@@ -61,17 +89,38 @@ static void ClearBlocks();
 
 static Block* LookupBlock(u32 pc);
 static Block* CreateBlock(u32 pc, const BlockInstructionList& instructions, const BlockMetadata& metadata);
+static Block* AllocateBlock(u32 size);
+static void FreeBlock(Block* block);
 static bool HasBlockLUT(u32 pc);
 static bool IsBlockCodeCurrent(const Block* block);
+static u32 GetTraceJumpTarget(const Instruction& instruction, u32 delay_slot_pc);
+static bool CanTraceJump(const Instruction& instruction, u32 start_pc, u32 delay_slot_pc);
 static bool RevalidateBlock(Block* block);
 static PageProtectionMode GetProtectionModeForPC(u32 pc);
 static PageProtectionMode GetProtectionModeForBlock(const Block* block);
 static bool ReadBlockInstructions(u32 start_pc, BlockInstructionList* instructions, BlockMetadata* metadata);
 static void FillBlockRegInfo(Block* block);
+static Reg GetPureWriteRegister(const Instruction& instruction, Reg* rs, Reg* rt);
+static void MarkDeadWrites(Block* block);
+static void DetectIdleLoop(Block* block);
 static void CopyRegInfo(InstructionInfo* dst, const InstructionInfo* src);
 static void SetRegAccess(InstructionInfo* inst, Reg reg, bool write);
 static void AddBlockToPageList(Block* block);
 static void RemoveBlockFromPageList(Block* block);
+static bool UpdatePageInvalidateCount(u32 index);
+static bool BlockOverlapsRange(const Block* block, PhysicalMemoryAddress start, PhysicalMemoryAddress end);
+static void InvalidateBlocksInPageRange(u32 index, PhysicalMemoryAddress start, PhysicalMemoryAddress end);
+
+static std::string GetPersistentCachePath(GameHash hash);
+static std::string GetPersistentBIOSCachePath(u64 bios_hash);
+static bool LoadPersistentCacheFile(const std::string& path, PersistentBlockMap* blocks);
+static void SavePersistentCacheFile(const std::string& path, const PersistentBlockMap& blocks);
+static void UpdatePersistentCacheFromBlocks();
+static const u8* GetPersistentBlockCode(u32 pc, u32 size);
+static bool LookupPersistentBlock(u32 start_pc, BlockInstructionList* instructions, BlockMetadata* metadata);
+
+static bool ShouldDeferCompile(u32 start_pc);
+static void RestoreDeferredBlocks();
 
 static Block* CreateCachedInterpreterBlock(u32 pc);
 [[noreturn]] static void ExecuteCachedInterpreter();
@@ -90,9 +139,21 @@ static std::vector<Block*> s_blocks;
 // for compiling - reuse to avoid allocations
 static BlockInstructionList s_block_instructions;
 
+static PersistentBlockMap s_persistent_blocks;
+static GameHash s_persistent_cache_hash = 0;
+static PersistentBlockMap s_persistent_bios_blocks;
+static u64 s_persistent_bios_cache_hash = 0;
+static bool s_persistent_bios_cache_dirty = false;
+static bool s_persistent_cache_icache = false;
+
+// keyed by pc, so counts carry over when blocks are recompiled or the code buffer is reset
+static std::unordered_map<u32, BlockProfileInfo> s_block_profile;
+
 static void BacklinkBlocks(u32 pc, const void* dst);
 static void UnlinkBlockExits(Block* block);
 static void ResetCodeBuffer();
+static void InitCodeBufferGenerations();
+static void EvictCodeBufferGeneration();
 
 static void CompileASMFunctions();
 static bool CompileBlock(Block* block);
@@ -104,6 +165,10 @@ static BlockLinkMap s_block_links;
 static std::map<const void*, LoadstoreBackpatchInfo> s_fastmem_backpatch_info;
 static std::unordered_set<u32> s_fastmem_faulting_pcs;
 
+// blocks which exceeded the per-frame compile budget, and are interpreted until the next frame
+static std::vector<u32> s_deferred_compile_pcs;
+static Timer::Value s_compile_time_this_frame = 0;
+
 NORETURN_FUNCTION_POINTER void (*g_enter_recompiler)();
 const void* g_compile_or_revalidate_block;
 const void* g_run_events_and_dispatch;
@@ -151,6 +216,32 @@ static u8* s_free_far_code_ptr = nullptr;
 static u32 s_far_code_size = 0;
 static u32 s_far_code_used = 0;
 
+// When eviction is enabled, the space after the ASM functions is split into two generations which are filled
+// alternately. Running out of space in one evicts the blocks in the other, instead of flushing the whole cache.
+struct CodeBufferGeneration
+{
+  u8* code_start;
+  u32 code_size;
+  u8* far_code_start;
+  u32 far_code_size;
+
+  ALWAYS_INLINE bool Contains(const void* ptr) const
+  {
+    const u8* p = static_cast<const u8*>(ptr);
+    return ((p >= code_start && p < (code_start + code_size)) ||
+            (p >= far_code_start && p < (far_code_start + far_code_size)));
+  }
+};
+static std::array<CodeBufferGeneration, 2> s_code_generations = {};
+static u32 s_current_code_generation = 0;
+static bool s_code_generations_active = false;
+
+// event counts for GetStatistics(), cleared on shutdown
+static u32 s_stats_compiles = 0;
+static u32 s_stats_invalidations = 0;
+static u32 s_stats_evictions = 0;
+static u32 s_stats_flushes = 0;
+
 #ifdef DUMP_CODE_SIZE_STATS
 static u32 s_total_instructions_compiled = 0;
 static u32 s_total_host_instructions_emitted = 0;
@@ -188,7 +279,12 @@ bool CPU::CodeCache::ProcessStartup(Error* error)
     return false;
   }
 
+  // The buffer is much bigger than what the TLB covers with regular pages, and we jump all over it.
+  if (MemMap::AdviseHugePages(s_code_buffer_ptr, RECOMPILER_CODE_CACHE_SIZE))
+    VERBOSE_LOG("Requested huge pages for code buffer.");
+
   AllocateLUTs();
+  MemoryAccounting::Set(MemoryAccounting::Category::CodeBuffer, RECOMPILER_CODE_CACHE_SIZE, 0);
 
   if (!PageFaultHandler::Install(error))
     return false;
@@ -203,23 +299,40 @@ void CPU::CodeCache::ProcessShutdown()
 #ifndef USE_CODE_BUFFER_SECTION
   MemMap::ReleaseJITMemory(s_code_buffer_ptr, RECOMPILER_CODE_CACHE_SIZE);
 #endif
+
+  MemoryAccounting::Set(MemoryAccounting::Category::CodeBuffer, 0, 0);
 }
 
 void CPU::CodeCache::Reset()
 {
+  PerformanceCounters::AttributeStutter(PerformanceCounters::StutterCause::CodeCacheReset);
   ClearBlocks();
 
   if (IsUsingRecompiler())
   {
     ResetCodeBuffer();
     CompileASMFunctions();
+    InitCodeBufferGenerations();
     ResetCodeLUT();
   }
 }
 
 void CPU::CodeCache::Shutdown()
 {
+  SavePersistentCache();
   ClearBlocks();
+
+  s_persistent_blocks = {};
+  s_persistent_cache_hash = 0;
+  s_persistent_bios_blocks = {};
+  s_persistent_bios_cache_hash = 0;
+  s_persistent_bios_cache_dirty = false;
+  s_block_profile = {};
+
+  s_stats_compiles = 0;
+  s_stats_invalidations = 0;
+  s_stats_evictions = 0;
+  s_stats_flushes = 0;
 }
 
 void CPU::CodeCache::Execute()
@@ -368,6 +481,26 @@ bool CPU::CodeCache::HasBlockLUT(u32 pc)
   return (s_block_lut[table] != nullptr);
 }
 
+CPU::CodeCache::Block* CPU::CodeCache::AllocateBlock(u32 size)
+{
+  const size_t alloc_size = sizeof(Block) + (sizeof(Instruction) * size) + (sizeof(InstructionInfo) * size);
+  Block* block = static_cast<Block*>(Common::AlignedMalloc(alloc_size, alignof(Block)));
+  Assert(block);
+  new (block) Block();
+  MemoryAccounting::Add(MemoryAccounting::Category::CodeBlocks, static_cast<s64>(alloc_size), 0);
+  return block;
+}
+
+void CPU::CodeCache::FreeBlock(Block* block)
+{
+  // blocks are only reused when the size matches, so this is the size they were allocated with
+  const size_t alloc_size =
+    sizeof(Block) + (sizeof(Instruction) * block->size) + (sizeof(InstructionInfo) * block->size);
+  MemoryAccounting::Add(MemoryAccounting::Category::CodeBlocks, -static_cast<s64>(alloc_size), 0);
+  block->~Block();
+  Common::AlignedFree(block);
+}
+
 CPU::CodeCache::Block* CPU::CodeCache::CreateBlock(u32 pc, const BlockInstructionList& instructions,
                                                    const BlockMetadata& metadata)
 {
@@ -400,18 +533,14 @@ CPU::CodeCache::Block* CPU::CodeCache::CreateBlock(u32 pc, const BlockInstructio
       Assert(it != s_blocks.end());
       s_blocks.erase(it);
 
-      block->~Block();
-      Common::AlignedFree(block);
+      FreeBlock(block);
       block = nullptr;
     }
   }
 
   if (!block)
   {
-    block = static_cast<Block*>(Common::AlignedMalloc(
-      sizeof(Block) + (sizeof(Instruction) * size) + (sizeof(InstructionInfo) * size), alignof(Block)));
-    Assert(block);
-    new (block) Block();
+    block = AllocateBlock(size);
     s_blocks.push_back(block);
   }
 
@@ -428,6 +557,12 @@ CPU::CodeCache::Block* CPU::CodeCache::CreateBlock(u32 pc, const BlockInstructio
   block->host_code_size = 0;
   block->compile_frame = recompile_frame;
   block->compile_count = recompile_count + 1;
+  block->profile = g_settings.cpu_recompiler_block_profiling ? &s_block_profile[pc] : nullptr;
+  if (block->profile)
+  {
+    block->profile->size = size;
+    block->profile->compile_count++;
+  }
 
   // copy instructions/info
   {
@@ -467,6 +602,8 @@ CPU::CodeCache::Block* CPU::CodeCache::CreateBlock(u32 pc, const BlockInstructio
 
   // populate backpropogation information for liveness queries
   FillBlockRegInfo(block);
+  MarkDeadWrites(block);
+  DetectIdleLoop(block);
 
   // add it to the tracking list for its page
   AddBlockToPageList(block);
@@ -476,6 +613,39 @@ CPU::CodeCache::Block* CPU::CodeCache::CreateBlock(u32 pc, const BlockInstructio
 
 bool CPU::CodeCache::IsBlockCodeCurrent(const Block* block)
 {
+  if (block->HasFlag(BlockFlags::IsTrace))
+  {
+    // traces aren't contiguous, so follow the stitched jumps
+    const Instruction* inst = block->Instructions();
+    const InstructionInfo* info = block->InstructionsInfo();
+    u32 pc = block->pc;
+    std::optional<u32> trace_target;
+    for (u32 i = 0; i < block->size; i++)
+    {
+      u32 bits;
+      std::memcpy(&bits, &Bus::g_ram[VirtualAddressToPhysical(pc)], sizeof(bits));
+      if (bits != inst[i].bits)
+        return false;
+
+      if (info[i].is_trace_jump)
+      {
+        pc += sizeof(Instruction);
+        trace_target = GetTraceJumpTarget(inst[i], pc);
+      }
+      else if (trace_target.has_value())
+      {
+        pc = trace_target.value();
+        trace_target.reset();
+      }
+      else
+      {
+        pc += sizeof(Instruction);
+      }
+    }
+
+    return true;
+  }
+
   // blocks shouldn't be wrapping..
   const PhysicalMemoryAddress phys_addr = VirtualAddressToPhysical(block->pc);
   DebugAssert((phys_addr + (sizeof(Instruction) * block->size)) <= Bus::g_ram_size);
@@ -492,6 +662,10 @@ bool CPU::CodeCache::RevalidateBlock(Block* block)
   if (block->state >= BlockState::NeedsRecompile)
     return false;
 
+  // Direct scratchpad accesses would bypass the isolated cache.
+  if (block->HasFlag(BlockFlags::UsesDirectScratchpadAccess) && g_state.cop0_regs.sr.Isc)
+    return false;
+
   // Protection may have changed if we didn't execute before it got invalidated again. e.g. THPS2.
   if (block->protection != GetProtectionModeForBlock(block))
     return false;
@@ -563,12 +737,8 @@ void CPU::CodeCache::RemoveBlockFromPageList(Block* block)
   }
 }
 
-void CPU::CodeCache::InvalidateBlocksWithPageIndex(u32 index)
+bool CPU::CodeCache::UpdatePageInvalidateCount(u32 index)
 {
-  DebugAssert(index < Bus::RAM_8MB_CODE_PAGE_COUNT);
-  Bus::ClearRAMCodePage(index);
-
-  BlockState new_block_state = BlockState::Invalidated;
   PageProtectionInfo& ppi = s_page_protection[index];
 
   const u32 frame_number = System::GetFrameNumber();
@@ -585,9 +755,21 @@ void CPU::CodeCache::InvalidateBlocksWithPageIndex(u32 index)
     DEV_LOG("{} invalidations in {} frames to page {} [0x{:08X} -> 0x{:08X}], switching to manual protection",
             ppi.invalidate_count, frame_delta, index, (index << HOST_PAGE_SHIFT), ((index + 1) << HOST_PAGE_SHIFT));
     ppi.mode = PageProtectionMode::ManualCheck;
-    new_block_state = BlockState::NeedsRecompile;
+    return true;
   }
 
+  return false;
+}
+
+void CPU::CodeCache::InvalidateBlocksWithPageIndex(u32 index)
+{
+  DebugAssert(index < Bus::RAM_8MB_CODE_PAGE_COUNT);
+  Bus::ClearRAMCodePage(index);
+
+  PageProtectionInfo& ppi = s_page_protection[index];
+  const BlockState new_block_state =
+    UpdatePageInvalidateCount(index) ? BlockState::NeedsRecompile : BlockState::Invalidated;
+
   if (!ppi.first_block_in_page)
     return;
 
@@ -596,6 +778,9 @@ void CPU::CodeCache::InvalidateBlocksWithPageIndex(u32 index)
   Block* block = ppi.first_block_in_page;
   while (block)
   {
+    if (block->profile)
+      block->profile->invalidate_count++;
+
     InvalidateBlock(block, new_block_state);
     block = std::exchange(block->next_block_in_page, nullptr);
   }
@@ -606,6 +791,112 @@ void CPU::CodeCache::InvalidateBlocksWithPageIndex(u32 index)
   MemMap::EndCodeWrite();
 }
 
+void CPU::CodeCache::InvalidateBlocksInRange(PhysicalMemoryAddress address, u32 size)
+{
+  const PhysicalMemoryAddress start = address & Bus::g_ram_mask;
+  const PhysicalMemoryAddress end = start + size;
+  const u32 start_page = Bus::GetRAMCodePageIndex(start);
+  const u32 end_page = Bus::GetRAMCodePageIndex(end - 1);
+  for (u32 index = start_page; index <= end_page; index++)
+  {
+    if (!Bus::IsRAMCodePage(index))
+      continue;
+
+    if (!g_settings.cpu_recompiler_subpage_invalidation)
+    {
+      InvalidateBlocksWithPageIndex(index);
+      continue;
+    }
+
+    InvalidateBlocksInPageRange(index, start, end);
+  }
+}
+
+bool CPU::CodeCache::BlockOverlapsRange(const Block* block, PhysicalMemoryAddress start, PhysicalMemoryAddress end)
+{
+  // traces aren't contiguous, we don't know which parts of the page they cover
+  if (block->HasFlag(BlockFlags::IsTrace))
+    return true;
+
+  const PhysicalMemoryAddress block_start = VirtualAddressToPhysical(block->pc) & Bus::g_ram_mask;
+  const PhysicalMemoryAddress block_end = block_start + (block->size * sizeof(Instruction));
+  return (start < block_end && end > block_start);
+}
+
+void CPU::CodeCache::InvalidateBlocksInPageRange(u32 index, PhysicalMemoryAddress start, PhysicalMemoryAddress end)
+{
+  PageProtectionInfo& ppi = s_page_protection[index];
+
+  // data sharing the page with code doesn't need to flush anything
+  Block* block = ppi.first_block_in_page;
+  while (block && !BlockOverlapsRange(block, start, end))
+    block = block->next_block_in_page;
+  if (!block)
+    return;
+
+  // if the page is being written too often, it gets switched to manual protection, which needs a full recompile
+  if (UpdatePageInvalidateCount(index))
+  {
+    Bus::ClearRAMCodePage(index);
+
+    MemMap::BeginCodeWrite();
+
+    block = ppi.first_block_in_page;
+    while (block)
+    {
+      if (block->profile)
+        block->profile->invalidate_count++;
+
+      InvalidateBlock(block, BlockState::NeedsRecompile);
+      block = std::exchange(block->next_block_in_page, nullptr);
+    }
+
+    ppi.first_block_in_page = nullptr;
+    ppi.last_block_in_page = nullptr;
+
+    MemMap::EndCodeWrite();
+    return;
+  }
+
+  DEBUG_LOG("Invalidating blocks in page {} overlapping 0x{:08X} -> 0x{:08X}", index, start, end);
+
+  MemMap::BeginCodeWrite();
+
+  Block* prev_block = nullptr;
+  block = ppi.first_block_in_page;
+  while (block)
+  {
+    Block* const next_block = block->next_block_in_page;
+    if (!BlockOverlapsRange(block, start, end))
+    {
+      prev_block = block;
+      block = next_block;
+      continue;
+    }
+
+    if (block->profile)
+      block->profile->invalidate_count++;
+
+    InvalidateBlock(block, BlockState::Invalidated);
+    block->next_block_in_page = nullptr;
+
+    if (prev_block)
+      prev_block->next_block_in_page = next_block;
+    else
+      ppi.first_block_in_page = next_block;
+    if (!next_block)
+      ppi.last_block_in_page = prev_block;
+
+    block = next_block;
+  }
+
+  MemMap::EndCodeWrite();
+
+  // the remaining blocks still need the page protected
+  if (!ppi.first_block_in_page)
+    Bus::ClearRAMCodePage(index);
+}
+
 CPU::CodeCache::PageProtectionMode CPU::CodeCache::GetProtectionModeForPC(u32 pc)
 {
   if (!AddressInRAM(pc))
@@ -631,6 +922,7 @@ void CPU::CodeCache::InvalidateBlock(Block* block, BlockState new_state)
   {
     SetCodeLUT(block->pc, g_compile_or_revalidate_block);
     BacklinkBlocks(block->pc, g_compile_or_revalidate_block);
+    s_stats_invalidations++;
   }
 
   block->state = new_state;
@@ -660,8 +952,65 @@ void CPU::CodeCache::InvalidateAllRAMBlocks()
   Bus::ClearRAMCodePageFlags();
 }
 
+void CPU::CodeCache::InvalidateDirectScratchpadAccessBlocks()
+{
+  MemMap::BeginCodeWrite();
+
+  for (Block* block : s_blocks)
+  {
+    if (block->state != BlockState::Valid || !block->HasFlag(BlockFlags::UsesDirectScratchpadAccess))
+      continue;
+
+    // only RAM blocks can be revalidated, the rest get compiled again
+    if (!AddressInRAM(block->pc))
+    {
+      InvalidateBlock(block, BlockState::NeedsRecompile);
+      continue;
+    }
+
+    InvalidateBlock(block, BlockState::Invalidated);
+    if (block->protection == PageProtectionMode::WriteProtected)
+    {
+      RemoveBlockFromPageList(block);
+
+      const u32 page_idx = block->StartPageIndex();
+      if (!s_page_protection[page_idx].first_block_in_page)
+        Bus::ClearRAMCodePage(page_idx);
+    }
+  }
+
+  MemMap::EndCodeWrite();
+}
+
+void CPU::CodeCache::InvalidateLoadedRAMPage(u32 index)
+{
+  DebugAssert(index < Bus::RAM_8MB_CODE_PAGE_COUNT);
+  Bus::ClearRAMCodePage(index);
+
+  PageProtectionInfo& ppi = s_page_protection[index];
+  if (!ppi.first_block_in_page)
+    return;
+
+  MemMap::BeginCodeWrite();
+
+  Block* block = ppi.first_block_in_page;
+  while (block)
+  {
+    InvalidateBlock(block, BlockState::Invalidated);
+    block = std::exchange(block->next_block_in_page, nullptr);
+  }
+
+  ppi.first_block_in_page = nullptr;
+  ppi.last_block_in_page = nullptr;
+
+  MemMap::EndCodeWrite();
+}
+
 void CPU::CodeCache::ClearBlocks()
 {
+  // don't lose the analysis of anything we compiled before the flush
+  UpdatePersistentCacheFromBlocks();
+
   for (u32 i = 0; i < Bus::RAM_8MB_CODE_PAGE_COUNT; i++)
   {
     PageProtectionInfo& ppi = s_page_protection[i];
@@ -674,12 +1023,11 @@ void CPU::CodeCache::ClearBlocks()
   s_fastmem_backpatch_info.clear();
   s_fastmem_faulting_pcs.clear();
   s_block_links.clear();
+  s_deferred_compile_pcs.clear();
+  s_compile_time_this_frame = 0;
 
   for (Block* block : s_blocks)
-  {
-    block->~Block();
-    Common::AlignedFree(block);
-  }
+    FreeBlock(block);
   s_blocks.clear();
 
   std::memset(s_lut_block_pointers.get(), 0, sizeof(Block*) * GetLUTSlotCount(false));
@@ -695,6 +1043,9 @@ PageFaultHandler::HandlerResult PageFaultHandler::HandlePageFault(void* exceptio
     DebugAssert(is_write);
     const u32 guest_address = static_cast<u32>(static_cast<const u8*>(fault_address) - Bus::g_ram);
     const u32 page_index = Bus::GetRAMCodePageIndex(guest_address);
+    if (Bus::HandleRAMDirtyPageFault(page_index))
+      return PageFaultHandler::HandlerResult::ContinueExecution;
+
     DEV_LOG("Page fault on protected RAM @ 0x{:08X} (page #{}), invalidating code cache.", guest_address, page_index);
     CPU::CodeCache::InvalidateBlocksWithPageIndex(page_index);
     return PageFaultHandler::HandlerResult::ContinueExecution;
@@ -790,9 +1141,20 @@ template<PGXPMode pgxp_mode>
 
       // Handle self-looping blocks
       if (g_state.pc == block->pc)
+      {
+        // Nothing the loop reads can change until the next event, so skip straight to it.
+        if (block->HasFlag(BlockFlags::IsIdleLoop))
+        {
+          SkipIdleLoopTicks();
+          break;
+        }
+
         goto reexecute_block;
+      }
       else
+      {
         continue;
+      }
 
     interpret_block:
       InterpretUncachedBlock<pgxp_mode>();
@@ -819,6 +1181,12 @@ template<PGXPMode pgxp_mode>
   }
 }
 
+void CPU::CodeCache::SkipIdleLoopTicks()
+{
+  // Stalls within the loop can already have taken us past the event, don't rewind over them.
+  g_state.pending_ticks += std::max<TickCount>(g_state.downcount - g_state.pending_ticks, 0);
+}
+
 void CPU::CodeCache::LogCurrentState()
 {
 #if 0
@@ -853,6 +1221,9 @@ bool CPU::CodeCache::ReadBlockInstructions(u32 start_pc, BlockInstructionList* i
 {
   // TODO: Jump to other block if it exists at this pc?
 
+  if (LookupPersistentBlock(start_pc, instructions, metadata))
+    return true;
+
   const PageProtectionMode protection = GetProtectionModeForPC(start_pc);
   const bool use_icache = CPU::IsCachedAddress(start_pc);
   const bool dynamic_fetch_ticks =
@@ -875,6 +1246,14 @@ bool CPU::CodeCache::ReadBlockInstructions(u32 start_pc, BlockInstructionList* i
   u32 last_cache_line = ICACHE_LINES;
   u32 last_page = (protection == PageProtectionMode::WriteProtected) ? Bus::GetRAMCodePageIndex(start_pc) : 0;
 
+  // Traces are only formed within write-protected pages. The icache check assumes the block covers contiguous lines.
+  const bool form_traces = (g_settings.cpu_recompiler_trace_formation &&
+                            CPU::GetCurrentExecutionMode() == CPUExecutionMode::Recompiler &&
+                            protection == PageProtectionMode::WriteProtected &&
+                            !(use_icache && g_settings.cpu_recompiler_icache));
+  std::optional<u32> trace_target;
+  u32 trace_jump_count = 0;
+
   for (;;)
   {
     if (protection == PageProtectionMode::WriteProtected)
@@ -947,6 +1326,15 @@ bool CPU::CodeCache::ReadBlockInstructions(u32 start_pc, BlockInstructionList* i
 
     pc += sizeof(Instruction);
 
+    if (form_traces && !is_branch_delay_slot && trace_jump_count < MAX_TRACE_JUMPS &&
+        instructions->size() < MAX_TRACE_INSTRUCTIONS && CanTraceJump(instruction, start_pc, pc))
+    {
+      info.is_trace_jump = true;
+      trace_target = GetTraceJumpTarget(instruction, pc);
+      trace_jump_count++;
+      metadata->flags |= BlockFlags::IsTrace;
+    }
+
     if (is_branch_delay_slot && info.is_branch_instruction)
     {
       const BlockInstructionInfoPair& prev = instructions->back();
@@ -973,7 +1361,18 @@ bool CPU::CodeCache::ReadBlockInstructions(u32 start_pc, BlockInstructionList* i
     // if we're in a branch delay slot, the block is now done
     // except if this is a branch in a branch delay slot, then we grab the one after that, and so on...
     if (is_branch_delay_slot && !info.is_branch_instruction)
-      break;
+    {
+      if (!trace_target.has_value() || IsExitBlockInstruction(instruction))
+        break;
+
+      // stitched jump, keep going at the target
+      DEBUG_LOG("Continuing block 0x{:08X} at jump target 0x{:08X}", start_pc, trace_target.value());
+      pc = trace_target.value();
+      trace_target.reset();
+      is_branch_delay_slot = false;
+      is_load_delay_slot = info.has_load_delay;
+      continue;
+    }
 
     // if this is a branch, we grab the next instruction (delay slot), and then exit
     is_branch_delay_slot = info.is_branch_instruction;
@@ -1000,18 +1399,50 @@ bool CPU::CodeCache::ReadBlockInstructions(u32 start_pc, BlockInstructionList* i
   DEBUG_LOG("Block at 0x{:08X}", start_pc);
   DEBUG_LOG(" Uncached fetch ticks: {}", metadata->uncached_fetch_ticks);
   DEBUG_LOG(" ICache line count: {}", metadata->icache_line_count);
+  std::optional<u32> disasm_trace_target;
   for (const auto& cbi : *instructions)
   {
     CPU::DisassembleInstruction(&disasm, disasm_pc, cbi.first.bits);
     DEBUG_LOG("[{} {} 0x{:08X}] {:08X} {}", cbi.second.is_branch_delay_slot ? "BD" : "  ",
               cbi.second.is_load_delay_slot ? "LD" : "  ", disasm_pc, cbi.first.bits, disasm);
-    disasm_pc += sizeof(Instruction);
+    if (cbi.second.is_trace_jump)
+    {
+      disasm_pc += sizeof(Instruction);
+      disasm_trace_target = GetTraceJumpTarget(cbi.first, disasm_pc);
+    }
+    else if (disasm_trace_target.has_value())
+    {
+      disasm_pc = disasm_trace_target.value();
+      disasm_trace_target.reset();
+    }
+    else
+    {
+      disasm_pc += sizeof(Instruction);
+    }
   }
 #endif
 
   return true;
 }
 
+u32 CPU::CodeCache::GetTraceJumpTarget(const Instruction& instruction, u32 delay_slot_pc)
+{
+  return (delay_slot_pc & UINT32_C(0xF0000000)) | (instruction.j.target << 2);
+}
+
+bool CPU::CodeCache::CanTraceJump(const Instruction& instruction, u32 start_pc, u32 delay_slot_pc)
+{
+  if (instruction.op != InstructionOp::j && instruction.op != InstructionOp::jal)
+    return false;
+
+  // Only forward jumps are followed, so loops still go through block linking, and code is never duplicated.
+  // The whole trace has to live in the block's start page, since that's the only page it gets registered in.
+  const u32 target = GetTraceJumpTarget(instruction, delay_slot_pc);
+  const u32 page = Bus::GetRAMCodePageIndex(start_pc);
+  return (target > delay_slot_pc && Bus::GetRAMCodePageIndex(delay_slot_pc) == page &&
+          Bus::GetRAMCodePageIndex(target) == page);
+}
+
 void CPU::CodeCache::CopyRegInfo(InstructionInfo* dst, const InstructionInfo* src)
 {
   std::memcpy(dst->reg_flags, src->reg_flags, sizeof(dst->reg_flags));
@@ -1275,6 +1706,538 @@ void CPU::CodeCache::FillBlockRegInfo(Block* block)
   } // end while
 }
 
+CPU::Reg CPU::CodeCache::GetPureWriteRegister(const Instruction& instruction, Reg* rs, Reg* rt)
+{
+  // add/addi/sub can only raise overflow exceptions when memory exceptions are enabled
+  const bool can_overflow = g_settings.cpu_recompiler_memory_exceptions;
+  *rs = Reg::zero;
+  *rt = Reg::zero;
+
+  switch (instruction.op)
+  {
+    case InstructionOp::funct:
+    {
+      switch (instruction.r.funct)
+      {
+        case InstructionFunct::sll:
+        case InstructionFunct::srl:
+        case InstructionFunct::sra:
+          *rt = instruction.r.rt;
+          return instruction.r.rd;
+
+        case InstructionFunct::add:
+        case InstructionFunct::sub:
+          if (can_overflow)
+            return Reg::count;
+          [[fallthrough]];
+
+        case InstructionFunct::sllv:
+        case InstructionFunct::srlv:
+        case InstructionFunct::srav:
+        case InstructionFunct::addu:
+        case InstructionFunct::subu:
+        case InstructionFunct::and_:
+        case InstructionFunct::or_:
+        case InstructionFunct::xor_:
+        case InstructionFunct::nor:
+        case InstructionFunct::slt:
+        case InstructionFunct::sltu:
+          *rs = instruction.r.rs;
+          *rt = instruction.r.rt;
+          return instruction.r.rd;
+
+        default:
+          return Reg::count;
+      }
+    }
+
+    case InstructionOp::addi:
+      if (can_overflow)
+        return Reg::count;
+      [[fallthrough]];
+
+    case InstructionOp::addiu:
+    case InstructionOp::slti:
+    case InstructionOp::sltiu:
+    case InstructionOp::andi:
+    case InstructionOp::ori:
+    case InstructionOp::xori:
+      *rs = instruction.i.rs;
+      return instruction.i.rt;
+
+    case InstructionOp::lui:
+      return instruction.i.rt;
+
+    default:
+      return Reg::count;
+  }
+}
+
+void CPU::CodeCache::MarkDeadWrites(Block* block)
+{
+  // analysis can come from the persistent cache, so don't trust what's there
+  InstructionInfo* const infos = block->InstructionsInfo();
+  for (u32 i = 0; i < block->size; i++)
+    infos[i].is_dead_write = false;
+
+  if (!g_settings.cpu_recompiler_block_optimization || !IsUsingRecompiler() || g_settings.UsingPGXPCPUMode())
+    return;
+
+  // Only consider ALU results which are overwritten later in the block by another ALU instruction, with nothing in
+  // between that could read the register, exit the block, or raise an exception which observes it.
+  const Instruction* const instructions = block->Instructions();
+  const bool transparent_memory_ops = !g_settings.cpu_recompiler_memory_exceptions;
+  u32 num_dead = 0;
+  for (u32 i = 0; i < block->size; i++)
+  {
+    Reg rs, rt;
+    const Reg dst = GetPureWriteRegister(instructions[i], &rs, &rt);
+    if (dst == Reg::count || dst == Reg::zero || infos[i].is_branch_delay_slot)
+      continue;
+
+    for (u32 j = i + 1; j < block->size; j++)
+    {
+      const Instruction& next = instructions[j];
+      Reg next_rs, next_rt;
+      const Reg next_dst = GetPureWriteRegister(next, &next_rs, &next_rt);
+      if (next_dst != Reg::count)
+      {
+        if (next_rs == dst || next_rt == dst)
+          break;
+
+        if (next_dst == dst)
+        {
+          infos[i].is_dead_write = true;
+          num_dead++;
+          break;
+        }
+
+        continue;
+      }
+
+      // Loads are delayed, so the old value would still be visible in their delay slot. Stop there.
+      const bool is_load = IsMemoryLoadInstruction(next);
+      if (!transparent_memory_ops || !(is_load || IsMemoryStoreInstruction(next)) || next.i.rs == dst ||
+          next.i.rt == dst)
+      {
+        break;
+      }
+    }
+  }
+
+  if (num_dead > 0)
+    DEBUG_LOG("Eliminated {} dead writes in block {:08X}", num_dead, block->pc);
+}
+
+void CPU::CodeCache::DetectIdleLoop(Block* block)
+{
+  block->flags &= ~BlockFlags::IsIdleLoop;
+  if (!g_settings.cpu_idle_loop_skipping || g_settings.bios_tty_logging || block->HasFlag(BlockFlags::IsTrace) ||
+      block->size < 2 || block->size > MAX_IDLE_LOOP_INSTRUCTIONS)
+  {
+    return;
+  }
+
+  // Has to end with a direct branch back to the start of the block, without linking.
+  const Instruction* const instructions = block->Instructions();
+  const InstructionInfo* const infos = block->InstructionsInfo();
+  const u32 branch_index = block->size - 2;
+  const Instruction& branch = instructions[branch_index];
+  const VirtualMemoryAddress branch_pc = block->pc + branch_index * sizeof(Instruction);
+  if (!infos[branch_index].is_direct_branch_instruction || branch.op == InstructionOp::jal ||
+      (branch.op == InstructionOp::b && (static_cast<u8>(branch.i.rt.GetValue()) & u8(0x1E)) == u8(0x10)) ||
+      !infos[branch_index + 1].is_branch_delay_slot || GetDirectBranchTarget(branch, branch_pc) != block->pc)
+  {
+    return;
+  }
+
+  // The body can only consist of loads and pure ALU instructions, and every register it reads must either be
+  // untouched by the loop or written earlier in the same iteration. That way each iteration computes the same
+  // result until something outside the CPU changes memory, which only happens when events run.
+  const auto reg_bit = [](Reg reg) { return (reg == Reg::zero) ? u64(0) : (u64(1) << static_cast<u8>(reg)); };
+  u64 loop_writes = 0;
+  for (u32 i = 0; i < block->size; i++)
+  {
+    if (i == branch_index)
+      continue;
+
+    const Instruction& inst = instructions[i];
+    Reg rs, rt;
+    const Reg dst = GetPureWriteRegister(inst, &rs, &rt);
+    if (dst != Reg::count)
+    {
+      loop_writes |= reg_bit(dst);
+      continue;
+    }
+
+    // lwl/lwr merge with the old value, so they're loop-carried by definition.
+    switch (inst.op)
+    {
+      case InstructionOp::lb:
+      case InstructionOp::lbu:
+      case InstructionOp::lh:
+      case InstructionOp::lhu:
+      case InstructionOp::lw:
+        loop_writes |= reg_bit(inst.i.rt);
+        break;
+
+      default:
+        return;
+    }
+  }
+
+  // A load in the delay slot would be visible at the start of the next iteration.
+  if (infos[block->size - 1].has_load_delay)
+    return;
+
+  u64 written = 0;
+  u64 pending_load = 0;
+  for (u32 i = 0; i < block->size; i++)
+  {
+    const Instruction& inst = instructions[i];
+    Reg rs, rt, dst;
+    if (i == branch_index)
+    {
+      rs = (inst.op == InstructionOp::j) ? Reg::zero : inst.i.rs.GetValue();
+      rt = (inst.op == InstructionOp::beq || inst.op == InstructionOp::bne) ? inst.i.rt.GetValue() : Reg::zero;
+      dst = Reg::zero;
+    }
+    else if ((dst = GetPureWriteRegister(inst, &rs, &rt)) == Reg::count)
+    {
+      rs = inst.i.rs.GetValue();
+      rt = Reg::zero;
+      dst = Reg::zero;
+    }
+
+    const u64 reads = reg_bit(rs) | reg_bit(rt);
+    if ((reads & loop_writes & ~written) != 0 || (reg_bit(dst) & pending_load) != 0)
+      return;
+
+    written |= pending_load | reg_bit(dst);
+    pending_load = infos[i].has_load_delay ? reg_bit(inst.i.rt) : u64(0);
+  }
+
+  DEV_LOG("Detected idle loop at {:08X}", block->pc);
+  block->flags |= BlockFlags::IsIdleLoop;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// MARK: - Persistent Block Cache
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::string CPU::CodeCache::GetPersistentCachePath(GameHash hash)
+{
+  return Path::Combine(EmuFolders::Cache, TinyString::from_format("blocks_{:016X}.cache", hash));
+}
+
+std::string CPU::CodeCache::GetPersistentBIOSCachePath(u64 bios_hash)
+{
+  return Path::Combine(EmuFolders::Cache, TinyString::from_format("bios_blocks_{:016X}.cache", bios_hash));
+}
+
+void CPU::CodeCache::ReloadPersistentCache()
+{
+  const bool enabled =
+    (g_settings.cpu_recompiler_block_cache && g_settings.cpu_execution_mode != CPUExecutionMode::Interpreter);
+  const GameHash hash = enabled ? System::GetGameHash() : 0;
+  const u64 bios_hash = enabled ? FastHash::Hash64(Bus::g_bios, Bus::BIOS_SIZE) : 0;
+  if (hash == s_persistent_cache_hash && bios_hash == s_persistent_bios_cache_hash)
+    return;
+
+  SavePersistentCache();
+  s_persistent_blocks.clear();
+  s_persistent_bios_blocks.clear();
+  s_persistent_cache_hash = hash;
+  s_persistent_bios_cache_hash = bios_hash;
+  s_persistent_bios_cache_dirty = false;
+  s_persistent_cache_icache = g_settings.cpu_recompiler_icache;
+
+  if (hash != 0 && !LoadPersistentCacheFile(GetPersistentCachePath(hash), &s_persistent_blocks))
+    s_persistent_blocks.clear();
+  if (bios_hash != 0 && !LoadPersistentCacheFile(GetPersistentBIOSCachePath(bios_hash), &s_persistent_bios_blocks))
+    s_persistent_bios_blocks.clear();
+}
+
+bool CPU::CodeCache::LoadPersistentCacheFile(const std::string& path, PersistentBlockMap* blocks)
+{
+  if (!FileSystem::FileExists(path.c_str()))
+    return true;
+
+  Error error;
+  std::optional<FileSystem::MappedFile> data = FileSystem::MapBinaryFile(path.c_str(), &error);
+  if (!data.has_value())
+  {
+    ERROR_LOG("Failed to read block cache: {}", error.GetDescription());
+    return false;
+  }
+
+  BinarySpanReader reader(data->cspan());
+  u32 signature, version, info_size, num_blocks;
+  bool icache;
+  if (!reader.ReadU32(&signature) || !reader.ReadU32(&version) || !reader.ReadU32(&info_size) ||
+      !reader.ReadBool(&icache) || !reader.ReadU32(&num_blocks) || signature != PERSISTENT_CACHE_SIGNATURE ||
+      version != CODE_CACHE_VERSION || info_size != sizeof(InstructionInfo) ||
+      num_blocks > MAX_PERSISTENT_CACHE_BLOCKS)
+  {
+    WARNING_LOG("Block cache header is corrupted or version mismatch, ignoring.");
+    return false;
+  }
+
+  // icache line counts are only filled when icache emulation is on, so the analysis is not interchangeable
+  if (icache != s_persistent_cache_icache)
+  {
+    DEV_LOG("Block cache was created with different ICache setting, ignoring.");
+    return true;
+  }
+
+  blocks->reserve(num_blocks);
+  for (u32 i = 0; i < num_blocks; i++)
+  {
+    u32 pc, size;
+    u8 protection, flags;
+    PersistentBlockInfo pbi;
+    if (!reader.ReadU32(&pc) || !reader.ReadU32(&size) || !reader.ReadU8(&protection) || !reader.ReadU8(&flags) ||
+        !reader.ReadS32(&pbi.metadata.uncached_fetch_ticks) || !reader.ReadU32(&pbi.metadata.icache_line_count) ||
+        size == 0 || size > (Bus::RAM_8MB_SIZE / sizeof(Instruction)) ||
+        protection > static_cast<u8>(PageProtectionMode::Unprotected) ||
+        !reader.CheckRemaining(size * (sizeof(Instruction) + sizeof(InstructionInfo))))
+    {
+      WARNING_LOG("Block cache entry {} is corrupted, ignoring.", i);
+      return false;
+    }
+
+    pbi.metadata.flags = static_cast<BlockFlags>(flags);
+    pbi.protection = static_cast<PageProtectionMode>(protection);
+    pbi.instructions.resize(size);
+    for (BlockInstructionInfoPair& it : pbi.instructions)
+    {
+      reader.ReadU32(&it.first.bits);
+      reader.Read(&it.second, sizeof(it.second));
+    }
+
+    blocks->insert_or_assign(pc, std::move(pbi));
+  }
+
+  INFO_LOG("Loaded {} blocks from {}.", blocks->size(), Path::GetFileName(path));
+  return true;
+}
+
+void CPU::CodeCache::SavePersistentCache()
+{
+  if (s_persistent_cache_hash == 0 && s_persistent_bios_cache_hash == 0)
+    return;
+
+  UpdatePersistentCacheFromBlocks();
+  if (s_persistent_cache_hash != 0 && !s_persistent_blocks.empty())
+    SavePersistentCacheFile(GetPersistentCachePath(s_persistent_cache_hash), s_persistent_blocks);
+
+  // other instances are likely sharing the same file, don't rewrite it unless we found something new
+  if (s_persistent_bios_cache_hash != 0 && s_persistent_bios_cache_dirty)
+  {
+    SavePersistentCacheFile(GetPersistentBIOSCachePath(s_persistent_bios_cache_hash), s_persistent_bios_blocks);
+    s_persistent_bios_cache_dirty = false;
+  }
+}
+
+void CPU::CodeCache::SavePersistentCacheFile(const std::string& path, const PersistentBlockMap& blocks)
+{
+  Error error;
+  FileSystem::AtomicRenamedFile file = FileSystem::CreateAtomicRenamedFile(path, &error);
+  if (!file)
+  {
+    ERROR_LOG("Failed to open block cache for writing: {}", error.GetDescription());
+    return;
+  }
+
+  const u32 num_blocks = std::min(static_cast<u32>(blocks.size()), MAX_PERSISTENT_CACHE_BLOCKS);
+
+  BinaryFileWriter writer(file.get());
+  writer.WriteU32(PERSISTENT_CACHE_SIGNATURE);
+  writer.WriteU32(CODE_CACHE_VERSION);
+  writer.WriteU32(sizeof(InstructionInfo));
+  writer.WriteBool(s_persistent_cache_icache);
+  writer.WriteU32(num_blocks);
+
+  u32 written = 0;
+  for (const auto& [pc, pbi] : blocks)
+  {
+    if (written == num_blocks)
+      break;
+
+    writer.WriteU32(pc);
+    writer.WriteU32(static_cast<u32>(pbi.instructions.size()));
+    writer.WriteU8(static_cast<u8>(pbi.protection));
+    writer.WriteU8(static_cast<u8>(pbi.metadata.flags));
+    writer.WriteS32(pbi.metadata.uncached_fetch_ticks);
+    writer.WriteU32(pbi.metadata.icache_line_count);
+    for (const BlockInstructionInfoPair& it : pbi.instructions)
+    {
+      writer.WriteU32(it.first.bits);
+      writer.Write(&it.second, sizeof(it.second));
+    }
+
+    written++;
+  }
+
+  if (!writer.Flush(&error) || !FileSystem::CommitAtomicRenamedFile(file, &error))
+  {
+    ERROR_LOG("Failed to write block cache: {}", error.GetDescription());
+    FileSystem::DiscardAtomicRenamedFile(file);
+    return;
+  }
+
+  INFO_LOG("Wrote {} blocks to {}.", written, Path::GetFileName(path));
+}
+
+void CPU::CodeCache::UpdatePersistentCacheFromBlocks()
+{
+  if ((s_persistent_cache_hash == 0 && s_persistent_bios_cache_hash == 0) ||
+      s_persistent_cache_icache != g_settings.cpu_recompiler_icache)
+  {
+    return;
+  }
+
+  for (const Block* block : s_blocks)
+  {
+    // traces aren't contiguous, and the lookup compares a straight run of memory
+    if (block->size == 0 || block->state == BlockState::FallbackToInterpreter ||
+        block->HasFlag(BlockFlags::IsTrace) || !GetPersistentBlockCode(block->pc, block->size))
+    {
+      continue;
+    }
+
+    PersistentBlockInfo* pbi;
+    if (AddressInRAM(block->pc))
+    {
+      if (s_persistent_cache_hash == 0)
+        continue;
+
+      // branch delay crossing forces manual protection on the block, but the instructions were read from a protected
+      // page
+      pbi = &s_persistent_blocks[block->pc];
+      pbi->protection =
+        block->HasFlag(BlockFlags::BranchDelaySpansPages) ? PageProtectionMode::WriteProtected : block->protection;
+    }
+    else
+    {
+      // ROM can't change, so anything already in the cache is still current
+      if (s_persistent_bios_cache_hash == 0 || s_persistent_bios_blocks.contains(block->pc))
+        continue;
+
+      pbi = &s_persistent_bios_blocks[block->pc];
+      pbi->protection = GetProtectionModeForPC(block->pc);
+      s_persistent_bios_cache_dirty = true;
+    }
+
+    // whether scratchpad accesses were compiled directly depends on the state at compile time
+    pbi->metadata.flags = block->flags & ~BlockFlags::UsesDirectScratchpadAccess;
+    pbi->metadata.uncached_fetch_ticks = block->uncached_fetch_ticks;
+    pbi->metadata.icache_line_count = block->icache_line_count;
+    pbi->instructions.resize(block->size);
+
+    const Instruction* inst = block->Instructions();
+    const InstructionInfo* info = block->InstructionsInfo();
+    for (u32 i = 0; i < block->size; i++)
+      pbi->instructions[i] = BlockInstructionInfoPair(inst[i], info[i]);
+  }
+}
+
+const u8* CPU::CodeCache::GetPersistentBlockCode(u32 pc, u32 size)
+{
+  const PhysicalMemoryAddress phys_addr = VirtualAddressToPhysical(pc);
+  const u32 size_in_bytes = size * sizeof(Instruction);
+  if (phys_addr < Bus::g_ram_size)
+    return ((phys_addr + size_in_bytes) <= Bus::g_ram_size) ? &Bus::g_ram[phys_addr] : nullptr;
+  else if (phys_addr >= Bus::BIOS_BASE && (phys_addr - Bus::BIOS_BASE + size_in_bytes) <= Bus::BIOS_SIZE)
+    return &Bus::g_bios[phys_addr - Bus::BIOS_BASE];
+  else
+    return nullptr;
+}
+
+bool CPU::CodeCache::LookupPersistentBlock(u32 start_pc, BlockInstructionList* instructions, BlockMetadata* metadata)
+{
+  if (s_persistent_cache_icache != g_settings.cpu_recompiler_icache)
+    return false;
+
+  const PersistentBlockMap& blocks = AddressInRAM(start_pc) ? s_persistent_blocks : s_persistent_bios_blocks;
+  const auto it = blocks.find(start_pc);
+  if (it == blocks.end())
+    return false;
+
+  // block boundaries depend on the page protection mode, so it has to match what we read it with
+  const PersistentBlockInfo& pbi = it->second;
+  if (pbi.protection != GetProtectionModeForPC(start_pc))
+    return false;
+
+  // the BIOS can still be patched after loading, so check the code either way
+  const u32 size = static_cast<u32>(pbi.instructions.size());
+  const u8* code = GetPersistentBlockCode(start_pc, size);
+  if (!code)
+    return false;
+
+  for (u32 i = 0; i < size; i++)
+  {
+    u32 bits;
+    std::memcpy(&bits, code + (i * sizeof(Instruction)), sizeof(bits));
+    if (bits != pbi.instructions[i].first.bits)
+      return false;
+  }
+
+  DEBUG_LOG("Using cached analysis for block at 0x{:08X}", start_pc);
+  *instructions = pbi.instructions;
+  *metadata = pbi.metadata;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// MARK: - Block Profiler
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CPU::CodeCache::RecordBlockExecution(u32 pc)
+{
+  const Block* block = LookupBlock(pc);
+  if (block && block->profile)
+    block->profile->execution_count++;
+}
+
+bool CPU::CodeCache::DumpBlockProfile(const char* path, u32 count, Error* error)
+{
+  if (s_block_profile.empty())
+  {
+    Error::SetStringView(error, "No blocks have been profiled.");
+    return false;
+  }
+
+  // cost is approximated as one cycle per instruction, which is enough to rank blocks
+  using ProfileEntry = std::pair<u32, const BlockProfileInfo*>;
+  std::vector<ProfileEntry> entries;
+  entries.reserve(s_block_profile.size());
+  for (const auto& [pc, info] : s_block_profile)
+    entries.emplace_back(pc, &info);
+  std::sort(entries.begin(), entries.end(), [](const ProfileEntry& lhs, const ProfileEntry& rhs) {
+    return ((lhs.second->execution_count * lhs.second->size) > (rhs.second->execution_count * rhs.second->size));
+  });
+  if (count > 0 && entries.size() > count)
+    entries.resize(count);
+
+  std::string csv = "pc,size,executions,estimated_cycles,host_code_size,host_instructions,compiles,invalidations,"
+                    "page_invalidations\n";
+  for (const auto& [pc, info] : entries)
+  {
+    const u32 page_invalidations =
+      AddressInRAM(pc) ? s_page_protection[Bus::GetRAMCodePageIndex(pc)].invalidate_count : 0;
+    fmt::format_to(std::back_inserter(csv), "{:08X},{},{},{},{},{},{},{},{}\n", pc, info->size,
+                   info->execution_count, info->execution_count * info->size, info->host_code_size,
+                   info->host_instruction_count, info->compile_count, info->invalidate_count, page_invalidations);
+  }
+
+  if (!FileSystem::WriteStringToFile(path, csv, error))
+    return false;
+
+  INFO_LOG("Wrote {} of {} profiled blocks to {}.", entries.size(), s_block_profile.size(), Path::GetFileName(path));
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // MARK: - Recompiler Glue
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1298,7 +2261,17 @@ void CPU::CodeCache::CompileOrRevalidateBlock(u32 start_pc)
       MemMap::EndCodeWrite();
       return;
     }
+  }
 
+  // The old block is left intact when deferring, since it might still be revalidated the next time we get here.
+  if (ShouldDeferCompile(start_pc))
+  {
+    MemMap::EndCodeWrite();
+    return;
+  }
+
+  if (block)
+  {
     // remove outward links from this block, since we're recompiling it
     UnlinkBlockExits(block);
 
@@ -1307,6 +2280,8 @@ void CPU::CodeCache::CompileOrRevalidateBlock(u32 start_pc)
       RemoveBackpatchInfoForRange(block->host_code, block->host_code_size);
   }
 
+  const Timer::Value compile_start_time = Timer::GetCurrentValue();
+
   BlockMetadata metadata = {};
   if (!ReadBlockInstructions(start_pc, &s_block_instructions, &metadata))
   {
@@ -1326,8 +2301,19 @@ void CPU::CodeCache::CompileOrRevalidateBlock(u32 start_pc)
       free_code_space < Recompiler::MIN_CODE_RESERVE_FOR_BLOCK ||
       free_far_code_space < Recompiler::MIN_CODE_RESERVE_FOR_BLOCK)
   {
-    ERROR_LOG("Out of code space while compiling {:08X}. Resetting code cache.", start_pc);
-    CodeCache::Reset();
+    if (s_code_generations_active)
+    {
+      DEV_LOG("Out of code space while compiling {:08X}. Evicting older generation.", start_pc);
+      EvictCodeBufferGeneration();
+      PerformanceCounters::AttributeStutter(PerformanceCounters::StutterCause::CodeCacheReset);
+      s_stats_evictions++;
+    }
+    else
+    {
+      ERROR_LOG("Out of code space while compiling {:08X}. Resetting code cache.", start_pc);
+      CodeCache::Reset();
+      s_stats_flushes++;
+    }
   }
 
   if ((block = CreateBlock(start_pc, s_block_instructions, metadata)) == nullptr || block->size == 0 ||
@@ -1343,6 +2329,55 @@ void CPU::CodeCache::CompileOrRevalidateBlock(u32 start_pc)
   SetCodeLUT(start_pc, block->host_code);
   BacklinkBlocks(start_pc, block->host_code);
   MemMap::EndCodeWrite();
+
+  s_compile_time_this_frame += Timer::GetCurrentValue() - compile_start_time;
+}
+
+bool CPU::CodeCache::ShouldDeferCompile(u32 start_pc)
+{
+  if (g_settings.cpu_recompiler_compile_budget == 0 ||
+      Timer::ConvertValueToNanoseconds(s_compile_time_this_frame) <
+        static_cast<double>(g_settings.cpu_recompiler_compile_budget) * 1000.0)
+  {
+    return false;
+  }
+
+  // Interpret it until the next frame. Any links to this block go through the compiler, since we're not creating
+  // the block yet, so they'll end up here again and get deferred until the budget is refreshed.
+  DEBUG_LOG("Compile budget exceeded, deferring block at 0x{:08X}", start_pc);
+  SetCodeLUT(start_pc, g_interpret_block);
+  BacklinkBlocks(start_pc, g_interpret_block);
+  s_deferred_compile_pcs.push_back(start_pc);
+  return true;
+}
+
+void CPU::CodeCache::RestoreDeferredBlocks()
+{
+  MemMap::BeginCodeWrite();
+
+  for (const u32 pc : s_deferred_compile_pcs)
+  {
+    // might have been sent to the interpreter for another reason since then
+    const u32 table = pc >> LUT_TABLE_SHIFT;
+    const u32 idx = (pc & 0xFFFF) >> 2;
+    if (g_code_lut[table][idx] != g_interpret_block)
+      continue;
+
+    SetCodeLUT(pc, g_compile_or_revalidate_block);
+    BacklinkBlocks(pc, g_compile_or_revalidate_block);
+  }
+
+  MemMap::EndCodeWrite();
+
+  DEV_LOG("Restored {} deferred blocks", s_deferred_compile_pcs.size());
+  s_deferred_compile_pcs.clear();
+}
+
+void CPU::CodeCache::EndFrame()
+{
+  s_compile_time_this_frame = 0;
+  if (!s_deferred_compile_pcs.empty())
+    RestoreDeferredBlocks();
 }
 
 void CPU::CodeCache::DiscardAndRecompileBlock(u32 start_pc)
@@ -1461,6 +2496,92 @@ void CPU::CodeCache::ResetCodeBuffer()
   s_far_code_ptr = (far_code_size > 0) ? (static_cast<u8*>(s_code_ptr) + s_code_size) : nullptr;
   s_free_far_code_ptr = s_far_code_ptr;
   s_far_code_used = 0;
+
+  s_code_generations = {};
+  s_current_code_generation = 0;
+  s_code_generations_active = false;
+}
+
+void CPU::CodeCache::InitCodeBufferGenerations()
+{
+  if (!g_settings.cpu_recompiler_code_buffer_eviction)
+    return;
+
+  // ASM functions stay at the start of the buffer, split what's left.
+  const u32 code_space = Common::AlignDownPow2(GetFreeCodeSpace() / 2, HOST_PAGE_SIZE);
+  const u32 far_code_space = Common::AlignDownPow2(GetFreeFarCodeSpace() / 2, HOST_PAGE_SIZE);
+  s_code_generations[0] = {s_free_code_ptr, code_space, s_free_far_code_ptr, far_code_space};
+  s_code_generations[1] = {s_free_code_ptr + code_space, GetFreeCodeSpace() - code_space,
+                           s_free_far_code_ptr + far_code_space, GetFreeFarCodeSpace() - far_code_space};
+  s_current_code_generation = 0;
+  s_code_generations_active = true;
+
+  // Limit allocation to the first generation.
+  s_code_size = static_cast<u32>((s_code_generations[0].code_start + s_code_generations[0].code_size) - s_code_ptr);
+  s_far_code_size =
+    static_cast<u32>((s_code_generations[0].far_code_start + s_code_generations[0].far_code_size) - s_far_code_ptr);
+}
+
+void CPU::CodeCache::EvictCodeBufferGeneration()
+{
+  DebugAssert(s_code_generations_active);
+
+  // The older generation is whichever one we're not currently filling.
+  const u32 evict_generation = s_current_code_generation ^ 1;
+  const CodeBufferGeneration& gen = s_code_generations[evict_generation];
+
+  // don't lose the analysis of anything we're about to throw away
+  UpdatePersistentCacheFromBlocks();
+
+  // Drop links which originate in the evicted code first, so we don't bother patching them below. Links can only
+  // come from blocks in the same generation, so surviving blocks' exit iterators stay valid.
+  for (auto it = s_block_links.begin(); it != s_block_links.end();)
+  {
+    if (gen.Contains(it->second))
+      it = s_block_links.erase(it);
+    else
+      ++it;
+  }
+
+  // Compact the block list in a single pass, erasing one at a time is quadratic with a full cache.
+  const auto evicted_begin = std::remove_if(s_blocks.begin(), s_blocks.end(), [&gen](Block* block) {
+    if (!block->host_code || !gen.Contains(block->host_code))
+      return false;
+
+    // surviving blocks which link to this one go through the compiler again
+    if (block->state == BlockState::Valid)
+    {
+      InvalidateBlock(block, BlockState::Invalidated);
+      if (AddressInRAM(block->pc) && block->protection == PageProtectionMode::WriteProtected)
+      {
+        RemoveBlockFromPageList(block);
+
+        const u32 page_idx = block->StartPageIndex();
+        if (!s_page_protection[page_idx].first_block_in_page)
+          Bus::ClearRAMCodePage(page_idx);
+      }
+    }
+
+    s_block_lut[block->pc >> LUT_TABLE_SHIFT][(block->pc & 0xFFFF) >> 2] = nullptr;
+    FreeBlock(block);
+    return true;
+  });
+  const size_t num_evicted = static_cast<size_t>(std::distance(evicted_begin, s_blocks.end()));
+  s_blocks.erase(evicted_begin, s_blocks.end());
+
+  RemoveBackpatchInfoForRange(gen.code_start, gen.code_size);
+
+  // Start filling the evicted generation.
+  s_current_code_generation = evict_generation;
+  s_free_code_ptr = gen.code_start;
+  s_code_used = static_cast<u32>(gen.code_start - s_code_ptr);
+  s_code_size = s_code_used + gen.code_size;
+  s_free_far_code_ptr = gen.far_code_start;
+  s_far_code_used = static_cast<u32>(gen.far_code_start - s_far_code_ptr);
+  s_far_code_size = s_far_code_used + gen.far_code_size;
+
+  DEV_LOG("Evicted {} blocks from code buffer generation {}, {} blocks remain.", num_evicted, evict_generation,
+          s_blocks.size());
 }
 
 u8* CPU::CodeCache::GetFreeCodePointer()
@@ -1473,6 +2594,21 @@ u32 CPU::CodeCache::GetFreeCodeSpace()
   return s_code_size - s_code_used;
 }
 
+CPU::CodeCache::Statistics CPU::CodeCache::GetStatistics()
+{
+  Statistics ret;
+  ret.num_blocks = static_cast<u32>(s_blocks.size());
+  ret.num_compiles = s_stats_compiles;
+  ret.num_invalidations = s_stats_invalidations;
+  ret.num_evictions = s_stats_evictions;
+  ret.num_flushes = s_stats_flushes;
+  ret.code_used = s_code_used;
+  ret.code_size = s_code_size;
+  ret.far_code_used = s_far_code_used;
+  ret.far_code_size = s_far_code_size;
+  return ret;
+}
+
 void CPU::CodeCache::CommitCode(u32 length)
 {
   if (length == 0) [[unlikely]]
@@ -1570,6 +2706,7 @@ bool CPU::CodeCache::CompileBlock(Block* block)
 
   block->host_code = host_code;
   block->host_code_size = host_code_size;
+  s_stats_compiles++;
 
   if (!host_code)
   {
@@ -1605,6 +2742,14 @@ bool CPU::CodeCache::CompileBlock(Block* block)
   MIPSPerfScope.RegisterPC(host_code, host_code_size, block->pc);
 #endif
 
+  if (block->profile)
+  {
+    block->profile->host_code_size = host_code_size;
+#ifdef ENABLE_HOST_DISASSEMBLY
+    block->profile->host_instruction_count = GetHostInstructionCount(host_code, host_code_size);
+#endif
+  }
+
   return true;
 }
 
@@ -1670,12 +2815,17 @@ PageFaultHandler::HandlerResult CPU::CodeCache::HandleFastmemException(void* exc
 
     // if we're writing to ram, let it go through a few times, and use manual block protection to sort it out
     // TODO: path for manual protection to return back to read-only pages
+    // watched pages are backpatched instead, so the access goes through the thunks which check the breakpoints
     if (!g_state.cop0_regs.sr.Isc && GetSegmentForAddress(guest_address) != CPU::Segment::KSEG2 &&
-        AddressInRAM(guest_address))
+        AddressInRAM(guest_address) && !Bus::IsRAMWatchPage(Bus::GetRAMCodePageIndex(guest_address)))
     {
       DebugAssert(is_write);
+      const u32 page_index = Bus::GetRAMCodePageIndex(guest_address);
+      if (Bus::HandleRAMDirtyPageFault(page_index))
+        return PageFaultHandler::HandlerResult::ContinueExecution;
+
       DEV_LOG("Ignoring fault due to RAM write @ 0x{:08X}", guest_address);
-      InvalidateBlocksWithPageIndex(Bus::GetRAMCodePageIndex(guest_address));
+      InvalidateBlocksWithPageIndex(page_index);
       return PageFaultHandler::HandlerResult::ContinueExecution;
     }
   }
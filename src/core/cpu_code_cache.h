@@ -10,6 +10,19 @@ class Error;
 
 namespace CPU::CodeCache {
 
+struct Statistics
+{
+  u32 num_blocks;
+  u32 num_compiles;
+  u32 num_invalidations;
+  u32 num_evictions;
+  u32 num_flushes;
+  u32 code_used;
+  u32 code_size;
+  u32 far_code_used;
+  u32 far_code_size;
+};
+
 /// Returns true if any recompiler is in use.
 bool IsUsingRecompiler();
 
@@ -31,10 +44,37 @@ void Reset();
 /// Free all non-persistent resources for the code cache.
 void Shutdown();
 
+/// Refreshes the per-frame compile budget, and queues any deferred blocks for compilation.
+void EndFrame();
+
 /// Invalidates all blocks which are in the range of the specified code page.
 void InvalidateBlocksWithPageIndex(u32 page_index);
 
+/// Invalidates blocks affected by a write to the specified RAM range. Without sub-page invalidation enabled, this
+/// flushes every code page touched by the range.
+void InvalidateBlocksInRange(PhysicalMemoryAddress address, u32 size);
+
 /// Invalidates all blocks in the cache.
 void InvalidateAllRAMBlocks();
 
+/// Invalidates blocks which access the scratchpad directly, since those accesses assume the cache isn't isolated.
+/// They aren't revalidated until the cache is no longer isolated.
+void InvalidateDirectScratchpadAccessBlocks();
+
+/// Invalidates the blocks in a RAM page which was overwritten by loading a memory state. Unlike
+/// InvalidateBlocksWithPageIndex(), this does not count towards switching the page to manual protection.
+void InvalidateLoadedRAMPage(u32 page_index);
+
+/// Loads the persistent block analysis cache for the running game, writing out the previous game's first.
+void ReloadPersistentCache();
+
+/// Writes the persistent block analysis cache for the running game to disk.
+void SavePersistentCache();
+
+/// Returns the current code buffer usage, and the number of times each event has happened since the system started.
+Statistics GetStatistics();
+
+/// Writes the most expensive blocks recorded by the block profiler to a CSV file.
+bool DumpBlockProfile(const char* path, u32 count, Error* error);
+
 } // namespace CPU::CodeCache
@@ -46,6 +46,8 @@ struct InstructionInfo
   bool is_load_delay_slot : 1;
   bool is_last_instruction : 1;
   bool has_load_delay : 1;
+  bool is_trace_jump : 1;
+  bool is_dead_write : 1;
 
   u8 reg_flags[static_cast<u8>(Reg::count)];
   // Reg write_reg[3];
@@ -89,6 +91,9 @@ enum class BlockFlags : u8
   BranchDelaySpansPages = (1 << 2),
   IsUsingICache = (1 << 3),
   NeedsDynamicFetchTicks = (1 << 4),
+  IsTrace = (1 << 5),
+  IsIdleLoop = (1 << 6),
+  UsesDirectScratchpadAccess = (1 << 7),
 };
 IMPLEMENT_ENUM_CLASS_BITWISE_OPERATORS(BlockFlags);
 
@@ -106,6 +111,16 @@ struct BlockMetadata
   BlockFlags flags;
 };
 
+struct BlockProfileInfo
+{
+  u64 execution_count;
+  u32 size;
+  u32 host_code_size;
+  u32 host_instruction_count;
+  u32 compile_count;
+  u32 invalidate_count;
+};
+
 struct alignas(16) Block
 {
   u32 pc;
@@ -130,6 +145,9 @@ struct alignas(16) Block
   u32 compile_frame;
   u8 compile_count;
 
+  // only set when the block profiler is enabled, survives the block being freed
+  BlockProfileInfo* profile;
+
   // followed by Instruction * size, InstructionRegInfo * size
   ALWAYS_INLINE const Instruction* Instructions() const { return reinterpret_cast<const Instruction*>(this + 1); }
   ALWAYS_INLINE Instruction* Instructions() { return reinterpret_cast<Instruction*>(this + 1); }
@@ -213,6 +231,12 @@ void InterpretUncachedBlock();
 
 void LogCurrentState();
 
+/// Advances time to the next event when an idle loop is hit, keeping any ticks which are already past it.
+void SkipIdleLoopTicks();
+
+/// Called from generated code on block entry when the block profiler is enabled.
+void RecordBlockExecution(u32 pc);
+
 #if defined(_DEBUG) || defined(_DEVEL) || false
 // Enable disassembly of host assembly code.
 #define ENABLE_HOST_DISASSEMBLY 1
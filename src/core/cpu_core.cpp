@@ -10,6 +10,7 @@
 #include "gte.h"
 #include "host.h"
 #include "pcdrv.h"
+#include "performance_counters.h"
 #include "pio.h"
 #include "settings.h"
 #include "system.h"
@@ -64,6 +65,9 @@ static bool CheckBreakpointList(BreakpointType type, VirtualMemoryAddress addres
 static void ExecutionBreakpointCheck(u32 pc);
 template<MemoryAccessType type>
 static void MemoryBreakpointCheck(VirtualMemoryAddress address);
+template<MemoryAccessType type>
+static void FastmemWatchpointCheck(VirtualMemoryAddress address);
+static bool UpdateFastmemWatchpoints();
 
 #ifdef _DEBUG
 static void TracePrintInstruction();
@@ -108,6 +112,7 @@ struct Locals
   u32 last_breakpoint_check_pc = INVALID_BREAKPOINT_PC;
   CPUExecutionMode current_execution_mode = CPUExecutionMode::Interpreter;
   std::array<std::vector<Breakpoint>, static_cast<u32>(BreakpointType::Count)> breakpoints;
+  bool using_fastmem_watchpoints = false;
 
   std::FILE* log_file = nullptr;
   bool log_file_opened = false;
@@ -2108,7 +2113,10 @@ CPUExecutionMode CPU::GetCurrentExecutionMode()
 
 bool CPU::UpdateDebugDispatcherFlag()
 {
-  const bool has_any_breakpoints = (HasAnyBreakpoints() || s_locals.break_type == ExecutionBreakType::SingleStep);
+  // Read/write breakpoints in RAM can be caught by protecting the fastmem pages instead of leaving the recompiler.
+  const bool has_any_breakpoints =
+    (UpdateFastmemWatchpoints() ? !GetBreakpointList(BreakpointType::Execute).empty() : HasAnyBreakpoints()) ||
+    s_locals.break_type == ExecutionBreakType::SingleStep;
 
   const auto& dcic = g_state.cop0_regs.dcic;
   const bool has_cop0_breakpoints = dcic.super_master_enable_1 && dcic.super_master_enable_2 &&
@@ -2125,9 +2133,36 @@ bool CPU::UpdateDebugDispatcherFlag()
   return true;
 }
 
+bool CPU::UpdateFastmemWatchpoints()
+{
+  std::vector<PhysicalMemoryAddress> addresses;
+  bool usable =
+    (g_settings.cpu_execution_mode == CPUExecutionMode::Recompiler &&
+     g_settings.cpu_fastmem_mode == CPUFastmemMode::MMap &&
+     (!GetBreakpointList(BreakpointType::Read).empty() || !GetBreakpointList(BreakpointType::Write).empty()));
+  for (const BreakpointType type : {BreakpointType::Read, BreakpointType::Write})
+  {
+    for (const Breakpoint& bp : GetBreakpointList(type))
+    {
+      // Only RAM goes through fastmem, everything else would need the interpreter.
+      const PhysicalMemoryAddress paddr = VirtualAddressToPhysical(bp.address);
+      usable = usable && (paddr < Bus::g_ram_size);
+      if (bp.enabled)
+        addresses.push_back(paddr);
+    }
+  }
+
+  if (!usable)
+    addresses.clear();
+
+  Bus::SetRAMWatchAddresses(addresses);
+  s_locals.using_fastmem_watchpoints = usable;
+  return usable;
+}
+
 void CPU::CheckForExecutionModeChange()
 {
-  // Currently, any breakpoints require the interpreter.
+  // Currently, any breakpoints other than fastmem watchpoints require the interpreter.
   const CPUExecutionMode new_execution_mode =
     (g_state.using_debug_dispatcher ? CPUExecutionMode::Interpreter : g_settings.cpu_execution_mode);
   if (s_locals.current_execution_mode == new_execution_mode) [[likely]]
@@ -2504,6 +2539,17 @@ ALWAYS_INLINE_RELEASE void CPU::MemoryBreakpointCheck(VirtualMemoryAddress addre
     s_locals.break_type = ExecutionBreakType::Breakpoint;
 }
 
+template<MemoryAccessType type>
+ALWAYS_INLINE_RELEASE void CPU::FastmemWatchpointCheck(VirtualMemoryAddress address)
+{
+  // Recompiled code can't stop mid-block, so execution stops once the system is paused at the end of the frame.
+  if (!s_locals.using_fastmem_watchpoints) [[likely]]
+    return;
+
+  const BreakpointType bptype = (type == MemoryAccessType::Read) ? BreakpointType::Read : BreakpointType::Write;
+  CheckBreakpointList(bptype, address);
+}
+
 template<PGXPMode pgxp_mode, bool debug>
 [[noreturn]] void CPU::ExecuteImpl()
 {
@@ -2625,7 +2671,14 @@ void CPU::Execute()
   CheckForExecutionModeChange();
 
   if (fastjmp_set(&s_locals.exit_jmp_buf) != 0)
+  {
+    PerformanceCounters::EndCPUTimeProfiling();
     return;
+  }
+
+  PerformanceCounters::BeginCPUTimeProfiling((GetCurrentExecutionMode() == CPUExecutionMode::Recompiler) ?
+                                               PerformanceCounters::CPUTimeCategory::Recompiler :
+                                               PerformanceCounters::CPUTimeCategory::Interpreter);
 
   if (g_state.using_interpreter)
     ExecuteInterpreter();
@@ -2691,6 +2744,7 @@ template void CPU::CodeCache::InterpretCachedBlock<PGXPMode::CPU>(const Block* b
 template<PGXPMode pgxp_mode>
 void CPU::CodeCache::InterpretUncachedBlock()
 {
+  PerformanceCounters::CPUTimeScope cpu_time_scope(PerformanceCounters::CPUTimeCategory::Interpreter);
   g_state.npc = g_state.pc;
   g_state.exception_raised = false;
   g_state.bus_error = false;
@@ -2786,6 +2840,10 @@ void CPU::UpdateMemoryPointers()
 {
   g_state.memory_handlers = Bus::GetMemoryHandlers(g_state.cop0_regs.sr.Isc, g_state.cop0_regs.sr.Swc);
   g_state.fastmem_base = Bus::GetFastmemBase(g_state.cop0_regs.sr.Isc);
+
+  // Blocks compiled while the cache wasn't isolated can't keep going straight to the scratchpad.
+  if (g_state.cop0_regs.sr.Isc)
+    CodeCache::InvalidateDirectScratchpadAccessBlocks();
 }
 
 template<bool add_ticks, bool icache_read, u32 word_count, bool raise_exceptions>
@@ -3157,8 +3215,9 @@ ALWAYS_INLINE bool CPU::DoSafeMemoryAccess(VirtualMemoryAddress address, u32& va
         if (g_unprotected_ram[offset] != Truncate8(value))
         {
           g_unprotected_ram[offset] = Truncate8(value);
+          Bus::MarkRAMPageDirty(page_index);
           if (g_ram_code_bits[page_index])
-            CPU::CodeCache::InvalidateBlocksWithPageIndex(page_index);
+            CPU::CodeCache::InvalidateBlocksInRange(offset, sizeof(u8));
         }
       }
       else if constexpr (size == MemoryAccessSize::HalfWord)
@@ -3169,8 +3228,9 @@ ALWAYS_INLINE bool CPU::DoSafeMemoryAccess(VirtualMemoryAddress address, u32& va
         if (old_value != new_value)
         {
           std::memcpy(&g_unprotected_ram[offset], &new_value, sizeof(u16));
+          Bus::MarkRAMPageDirty(page_index);
           if (g_ram_code_bits[page_index])
-            CPU::CodeCache::InvalidateBlocksWithPageIndex(page_index);
+            CPU::CodeCache::InvalidateBlocksInRange(offset, sizeof(u16));
         }
       }
       else if constexpr (size == MemoryAccessSize::Word)
@@ -3180,8 +3240,9 @@ ALWAYS_INLINE bool CPU::DoSafeMemoryAccess(VirtualMemoryAddress address, u32& va
         if (old_value != value)
         {
           std::memcpy(&g_unprotected_ram[offset], &value, sizeof(u32));
+          Bus::MarkRAMPageDirty(page_index);
           if (g_ram_code_bits[page_index])
-            CPU::CodeCache::InvalidateBlocksWithPageIndex(page_index);
+            CPU::CodeCache::InvalidateBlocksInRange(offset, sizeof(u32));
         }
       }
     }
@@ -3346,8 +3407,24 @@ bool CPU::SafeWriteMemoryBytes(VirtualMemoryAddress addr, const void* data, u32
     return true;
   }
 
-  // Fast path: all in RAM, no wraparound.
-  std::memcpy(&g_ram[addr & g_ram_mask], data, length);
+  // Fast path: all in RAM, no wraparound. Goes through the unprotected view like single writes, so large copies
+  // don't take a fault on every protected page.
+  const u32 offset = addr & g_ram_mask;
+  std::memcpy(&g_unprotected_ram[offset], data, length);
+  if (length > 0)
+  {
+    bool has_code = false;
+    const u32 end_page = (offset + length - 1) >> HOST_PAGE_SHIFT;
+    for (u32 page_index = offset >> HOST_PAGE_SHIFT; page_index <= end_page; page_index++)
+    {
+      Bus::MarkRAMPageDirty(page_index);
+      has_code |= g_ram_code_bits[page_index];
+    }
+
+    if (has_code)
+      CPU::CodeCache::InvalidateBlocksInRange(offset, length);
+  }
+
   return true;
 }
 
@@ -3637,6 +3714,7 @@ u64 CPU::RecompilerThunks::ReadMemoryByte(u32 address)
   }
 
   MEMORY_BREAKPOINT(MemoryAccessType::Read, MemoryAccessSize::Byte, address, value);
+  FastmemWatchpointCheck<MemoryAccessType::Read>(address);
   return ZeroExtend64(value);
 }
 
@@ -3656,6 +3734,7 @@ u64 CPU::RecompilerThunks::ReadMemoryHalfWord(u32 address)
   }
 
   MEMORY_BREAKPOINT(MemoryAccessType::Read, MemoryAccessSize::HalfWord, address, value);
+  FastmemWatchpointCheck<MemoryAccessType::Read>(address);
   return ZeroExtend64(value);
 }
 
@@ -3675,12 +3754,14 @@ u64 CPU::RecompilerThunks::ReadMemoryWord(u32 address)
   }
 
   MEMORY_BREAKPOINT(MemoryAccessType::Read, MemoryAccessSize::Word, address, value);
+  FastmemWatchpointCheck<MemoryAccessType::Read>(address);
   return ZeroExtend64(value);
 }
 
 u32 CPU::RecompilerThunks::WriteMemoryByte(u32 address, u32 value)
 {
   MEMORY_BREAKPOINT(MemoryAccessType::Write, MemoryAccessSize::Byte, address, value);
+  FastmemWatchpointCheck<MemoryAccessType::Write>(address);
 
   GetMemoryWriteHandler(address, MemoryAccessSize::Byte)(address, value);
   if (g_state.bus_error) [[unlikely]]
@@ -3695,6 +3776,7 @@ u32 CPU::RecompilerThunks::WriteMemoryByte(u32 address, u32 value)
 u32 CPU::RecompilerThunks::WriteMemoryHalfWord(u32 address, u32 value)
 {
   MEMORY_BREAKPOINT(MemoryAccessType::Write, MemoryAccessSize::HalfWord, address, value);
+  FastmemWatchpointCheck<MemoryAccessType::Write>(address);
 
   if (!Common::IsAlignedPow2(address, 2)) [[unlikely]]
   {
@@ -3715,6 +3797,7 @@ u32 CPU::RecompilerThunks::WriteMemoryHalfWord(u32 address, u32 value)
 u32 CPU::RecompilerThunks::WriteMemoryWord(u32 address, u32 value)
 {
   MEMORY_BREAKPOINT(MemoryAccessType::Write, MemoryAccessSize::Word, address, value);
+  FastmemWatchpointCheck<MemoryAccessType::Write>(address);
 
   if (!Common::IsAlignedPow2(address, 4)) [[unlikely]]
   {
@@ -3736,6 +3819,7 @@ u32 CPU::RecompilerThunks::UncheckedReadMemoryByte(u32 address)
 {
   const u32 value = GetMemoryReadHandler(address, MemoryAccessSize::Byte)(address);
   MEMORY_BREAKPOINT(MemoryAccessType::Read, MemoryAccessSize::Byte, address, value);
+  FastmemWatchpointCheck<MemoryAccessType::Read>(address);
   return value;
 }
 
@@ -3743,6 +3827,7 @@ u32 CPU::RecompilerThunks::UncheckedReadMemoryHalfWord(u32 address)
 {
   const u32 value = GetMemoryReadHandler(address, MemoryAccessSize::HalfWord)(address);
   MEMORY_BREAKPOINT(MemoryAccessType::Read, MemoryAccessSize::HalfWord, address, value);
+  FastmemWatchpointCheck<MemoryAccessType::Read>(address);
   return value;
 }
 
@@ -3750,24 +3835,28 @@ u32 CPU::RecompilerThunks::UncheckedReadMemoryWord(u32 address)
 {
   const u32 value = GetMemoryReadHandler(address, MemoryAccessSize::Word)(address);
   MEMORY_BREAKPOINT(MemoryAccessType::Read, MemoryAccessSize::Word, address, value);
+  FastmemWatchpointCheck<MemoryAccessType::Read>(address);
   return value;
 }
 
 void CPU::RecompilerThunks::UncheckedWriteMemoryByte(u32 address, u32 value)
 {
   MEMORY_BREAKPOINT(MemoryAccessType::Write, MemoryAccessSize::Byte, address, value);
+  FastmemWatchpointCheck<MemoryAccessType::Write>(address);
   GetMemoryWriteHandler(address, MemoryAccessSize::Byte)(address, value);
 }
 
 void CPU::RecompilerThunks::UncheckedWriteMemoryHalfWord(u32 address, u32 value)
 {
   MEMORY_BREAKPOINT(MemoryAccessType::Write, MemoryAccessSize::HalfWord, address, value);
+  FastmemWatchpointCheck<MemoryAccessType::Write>(address);
   GetMemoryWriteHandler(address, MemoryAccessSize::HalfWord)(address, value);
 }
 
 void CPU::RecompilerThunks::UncheckedWriteMemoryWord(u32 address, u32 value)
 {
   MEMORY_BREAKPOINT(MemoryAccessType::Write, MemoryAccessSize::Word, address, value);
+  FastmemWatchpointCheck<MemoryAccessType::Write>(address);
   GetMemoryWriteHandler(address, MemoryAccessSize::Word)(address, value);
 }
 
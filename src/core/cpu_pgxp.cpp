@@ -17,8 +17,12 @@
 #include "util/state_wrapper.h"
 
 #include "common/assert.h"
+#include "common/error.h"
 #include "common/log.h"
+#include "common/memmap.h"
 
+#include <algorithm>
+#include <array>
 #include <climits>
 #include <cmath>
 
@@ -38,7 +42,13 @@ enum : u32
   VERTEX_CACHE_SIZE = VERTEX_CACHE_WIDTH * VERTEX_CACHE_HEIGHT,
   PGXP_MEM_SIZE = (static_cast<u32>(Bus::RAM_8MB_SIZE) + static_cast<u32>(CPU::SCRATCHPAD_SIZE)) / 4,
   PGXP_MEM_SCRATCH_OFFSET = Bus::RAM_8MB_SIZE / 4,
+
+  // Shadow memory is committed in chunks on first write, games rarely touch more than a fraction of it.
+  PGXP_MEM_CHUNK_VALUES = 16384,
+  PGXP_MEM_CHUNK_SIZE = PGXP_MEM_CHUNK_VALUES * sizeof(PGXPValue),
+  PGXP_MEM_NUM_CHUNKS = (PGXP_MEM_SIZE + PGXP_MEM_CHUNK_VALUES - 1) / PGXP_MEM_CHUNK_VALUES,
 };
+static_assert((PGXP_MEM_CHUNK_SIZE % 65536) == 0, "Chunks are page aligned");
 
 enum : u32
 {
@@ -81,7 +91,11 @@ static void SetRtValue(Instruction instr, const PGXPValue& val);
 static void SetRtValue(Instruction instr, const PGXPValue& val, u32 rtVal);
 static void PushScreenXYFIFO();
 
+static u32 GetMemIndex(u32 addr);
 static PGXPValue* GetPtr(u32 addr);
+static PGXPValue* GetWritePtr(u32 addr);
+static void CommitMemChunk(u32 chunk);
+static void DecommitMemChunks();
 static const PGXPValue& ValidateAndLoadMem(u32 addr, u32 value);
 static void ValidateAndLoadMem16(PGXPValue& dest, u32 addr, u32 value, bool sign);
 
@@ -122,6 +136,11 @@ static constexpr const PGXPValue INVALID_VALUE = {};
 
 static PGXPValue* s_mem = nullptr;
 static PGXPValue* s_vertex_cache = nullptr;
+static std::array<bool, PGXP_MEM_NUM_CHUNKS> s_mem_committed = {};
+
+// Lookups in chunks which haven't been written yet go here, it's reset to invalid every time.
+static PGXPValue s_uncommitted_value = {};
+static u8 s_zero_chunk[PGXP_MEM_CHUNK_SIZE] = {};
 
 #ifdef LOG_VALUES
 static std::FILE* s_log;
@@ -142,9 +161,14 @@ void CPU::PGXP::Initialize()
 
   if (!s_mem)
   {
-    s_mem = static_cast<PGXPValue*>(std::calloc(PGXP_MEM_SIZE, sizeof(PGXPValue)));
+    Error error;
+    s_mem = static_cast<PGXPValue*>(MemMap::ReserveMemory(PGXP_MEM_NUM_CHUNKS * PGXP_MEM_CHUNK_SIZE, &error));
     if (!s_mem)
-      Panic("Failed to allocate PGXP memory");
+    {
+      ERROR_LOG("Failed to reserve PGXP memory: {}", error.GetDescription());
+      Panic("Failed to reserve PGXP memory");
+    }
+    s_mem_committed = {};
   }
 
   if (g_settings.gpu_pgxp_vertex_cache && !s_vertex_cache)
@@ -168,7 +192,7 @@ void CPU::PGXP::Reset()
   std::memset(g_state.pgxp_gte, 0, sizeof(g_state.pgxp_gte));
 
   if (s_mem)
-    std::memset(s_mem, 0, sizeof(PGXPValue) * PGXP_MEM_SIZE);
+    DecommitMemChunks();
 
   if (g_settings.gpu_pgxp_vertex_cache && s_vertex_cache)
     std::memset(s_vertex_cache, 0, sizeof(PGXPValue) * VERTEX_CACHE_SIZE);
@@ -183,8 +207,9 @@ void CPU::PGXP::Shutdown()
   }
   if (s_mem)
   {
-    std::free(s_mem);
+    MemMap::ReleaseMemory(s_mem, PGXP_MEM_NUM_CHUNKS * PGXP_MEM_CHUNK_SIZE);
     s_mem = nullptr;
+    s_mem_committed = {};
   }
 
   std::memset(g_state.pgxp_gte, 0, sizeof(g_state.pgxp_gte));
@@ -219,7 +244,33 @@ void CPU::PGXP::DoState(StateWrapper& sw)
   sw.DoBytes(g_state.pgxp_cop0, sizeof(g_state.pgxp_cop0));
   sw.DoBytes(g_state.pgxp_gte, sizeof(g_state.pgxp_gte));
 
-  sw.DoBytes(s_mem, sizeof(PGXPValue) * PGXP_MEM_SIZE);
+  // Chunks which have never been written are stored as zeros, and only committed on load if they aren't zero.
+  for (u32 chunk = 0; chunk < PGXP_MEM_NUM_CHUNKS; chunk++)
+  {
+    const u32 start = chunk * PGXP_MEM_CHUNK_VALUES;
+    const size_t size = std::min<u32>(PGXP_MEM_CHUNK_VALUES, PGXP_MEM_SIZE - start) * sizeof(PGXPValue);
+    if (s_mem_committed[chunk])
+    {
+      sw.DoBytes(&s_mem[start], size);
+    }
+    else if (sw.IsReading())
+    {
+      if ((sw.GetPosition() + size) > sw.GetDataSize() ||
+          std::memcmp(sw.GetData() + sw.GetPosition(), s_zero_chunk, size) != 0)
+      {
+        CommitMemChunk(chunk);
+        sw.DoBytes(&s_mem[start], size);
+      }
+      else
+      {
+        sw.SkipBytes(size);
+      }
+    }
+    else
+    {
+      sw.DoBytes(s_zero_chunk, size);
+    }
+  }
 
   if (s_vertex_cache)
     sw.DoBytes(s_vertex_cache, sizeof(PGXPValue) * VERTEX_CACHE_SIZE);
@@ -284,7 +335,7 @@ ALWAYS_INLINE void CPU::PGXP::PushScreenXYFIFO()
   PGXP_GTE_REGISTER(SXY2) = PGXP_GTE_REGISTER(SXYP); // SXY2 = SXYP
 }
 
-ALWAYS_INLINE_RELEASE CPU::PGXPValue* CPU::PGXP::GetPtr(u32 addr)
+ALWAYS_INLINE_RELEASE u32 CPU::PGXP::GetMemIndex(u32 addr)
 {
 #if 0
   if ((addr & CPU::PHYSICAL_MEMORY_ADDRESS_MASK) >= 0x0017A2B4 &&
@@ -293,14 +344,63 @@ ALWAYS_INLINE_RELEASE CPU::PGXPValue* CPU::PGXP::GetPtr(u32 addr)
 #endif
 
   if ((addr & SCRATCHPAD_ADDR_MASK) == SCRATCHPAD_ADDR)
-    return &s_mem[PGXP_MEM_SCRATCH_OFFSET + ((addr & SCRATCHPAD_OFFSET_MASK) >> 2)];
+    return PGXP_MEM_SCRATCH_OFFSET + ((addr & SCRATCHPAD_OFFSET_MASK) >> 2);
 
   // Don't worry about >512MB here for performance reasons.
   const u32 paddr = (addr & KSEG_MASK);
   if (paddr < Bus::RAM_MIRROR_END)
-    return &s_mem[(paddr & Bus::g_ram_mask) >> 2];
+    return (paddr & Bus::g_ram_mask) >> 2;
   else
+    return PGXP_MEM_SIZE;
+}
+
+ALWAYS_INLINE_RELEASE CPU::PGXPValue* CPU::PGXP::GetPtr(u32 addr)
+{
+  const u32 index = GetMemIndex(addr);
+  if (index >= PGXP_MEM_SIZE)
+    return nullptr;
+
+  if (!s_mem_committed[index / PGXP_MEM_CHUNK_VALUES]) [[unlikely]]
+  {
+    // never written, so nothing in it can be valid
+    s_uncommitted_value = INVALID_VALUE;
+    return &s_uncommitted_value;
+  }
+
+  return &s_mem[index];
+}
+
+ALWAYS_INLINE_RELEASE CPU::PGXPValue* CPU::PGXP::GetWritePtr(u32 addr)
+{
+  const u32 index = GetMemIndex(addr);
+  if (index >= PGXP_MEM_SIZE)
     return nullptr;
+
+  const u32 chunk = index / PGXP_MEM_CHUNK_VALUES;
+  if (!s_mem_committed[chunk]) [[unlikely]]
+    CommitMemChunk(chunk);
+
+  return &s_mem[index];
+}
+
+void CPU::PGXP::CommitMemChunk(u32 chunk)
+{
+  if (!MemMap::CommitMemory(reinterpret_cast<u8*>(s_mem) + (chunk * PGXP_MEM_CHUNK_SIZE), PGXP_MEM_CHUNK_SIZE))
+    Panic("Failed to commit PGXP memory");
+
+  s_mem_committed[chunk] = true;
+}
+
+void CPU::PGXP::DecommitMemChunks()
+{
+  for (u32 chunk = 0; chunk < PGXP_MEM_NUM_CHUNKS; chunk++)
+  {
+    if (!s_mem_committed[chunk])
+      continue;
+
+    MemMap::DecommitMemory(reinterpret_cast<u8*>(s_mem) + (chunk * PGXP_MEM_CHUNK_SIZE), PGXP_MEM_CHUNK_SIZE);
+    s_mem_committed[chunk] = false;
+  }
 }
 
 ALWAYS_INLINE_RELEASE const CPU::PGXPValue& CPU::PGXP::ValidateAndLoadMem(u32 addr, u32 value)
@@ -357,7 +457,7 @@ ALWAYS_INLINE_RELEASE void CPU::PGXP::ValidateAndLoadMem16(PGXPValue& dest, u32
 
 ALWAYS_INLINE_RELEASE void CPU::PGXP::WriteMem(u32 addr, const PGXPValue& value)
 {
-  PGXPValue* pMem = GetPtr(addr);
+  PGXPValue* pMem = GetWritePtr(addr);
   if (!pMem) [[unlikely]]
     return;
 
@@ -368,7 +468,7 @@ ALWAYS_INLINE_RELEASE void CPU::PGXP::WriteMem(u32 addr, const PGXPValue& value)
 
 ALWAYS_INLINE_RELEASE void CPU::PGXP::WriteMem16(u32 addr, const PGXPValue& value)
 {
-  PGXPValue* dest = GetPtr(addr);
+  PGXPValue* dest = GetWritePtr(addr);
   if (!dest) [[unlikely]]
     return;
 
@@ -856,7 +956,7 @@ void CPU::PGXP::CPU_SWx(Instruction instr, u32 addr, u32 rtVal)
   LOG_VALUES_STORE(instr.r.rt.GetValue(), rtVal, addr);
 
   const u32 aligned_addr = addr & ~3u;
-  PGXPValue* pmemVal = GetPtr(aligned_addr);
+  PGXPValue* pmemVal = GetWritePtr(aligned_addr);
   u32 memVal;
   if (!pmemVal)
     return;
@@ -1168,12 +1268,18 @@ void CPU::PGXP::CPU_LUI(Instruction instr)
   LOG_VALUES_NV();
 
   // Rt = Imm << 16
-  PGXPValue& pRtVal = GetRtValue(instr);
-  pRtVal.x = 0.0f;
-  pRtVal.y = static_cast<float>(instr.i.imm_s16());
-  pRtVal.z = 0.0f;
-  pRtVal.value = instr.i.imm_zext32() << 16;
-  pRtVal.flags = VALID_XY;
+  GetRtValue(instr) = GetLUIValue(instr);
+}
+
+CPU::PGXPValue CPU::PGXP::GetLUIValue(Instruction instr)
+{
+  PGXPValue val;
+  val.x = 0.0f;
+  val.y = static_cast<float>(instr.i.imm_s16());
+  val.z = 0.0f;
+  val.value = instr.i.imm_zext32() << 16;
+  val.flags = VALID_XY;
+  return val;
 }
 
 void CPU::PGXP::CPU_ADD(Instruction instr, u32 rsVal, u32 rtVal)
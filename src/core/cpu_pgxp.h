@@ -54,6 +54,7 @@ void CPU_XORI(Instruction instr, u32 rsVal);
 void CPU_SLTI(Instruction instr, u32 rsVal);
 void CPU_SLTIU(Instruction instr, u32 rsVal);
 void CPU_LUI(Instruction instr);
+PGXPValue GetLUIValue(Instruction instr);
 void CPU_ADD(Instruction instr, u32 rsVal, u32 rtVal);
 void CPU_SUB(Instruction instr, u32 rsVal, u32 rtVal);
 void CPU_AND_(Instruction instr, u32 rsVal, u32 rtVal);
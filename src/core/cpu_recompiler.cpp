@@ -12,6 +12,8 @@
 #include "common/log.h"
 #include "common/small_string.h"
 
+#include <algorithm>
+#include <bit>
 #include <cstdint>
 #include <limits>
 
@@ -63,6 +65,10 @@ void CPU::Recompiler::Recompiler::Reset(CodeCache::Block* block, u8* code_buffer
   m_load_delay_register = Reg::count;
   m_load_delay_value_register = NUM_HOST_REGS;
 
+  m_loop_head = nullptr;
+  m_loop_branch_instruction = nullptr;
+  m_num_loop_regs = 0;
+
   InitSpeculativeRegs();
 }
 
@@ -80,8 +86,19 @@ void CPU::Recompiler::Recompiler::BeginBlock()
     GenerateBlockProtectCheck(ram_ptr, shadow_ptr, m_block->size * sizeof(Instruction));
   }
 
+  if (CanCacheLoopRegisters())
+    BeginLoopRegisterCache();
+
   GenerateICacheCheckAndUpdate();
 
+  if (m_block->profile)
+  {
+    const u32 pc_reg = AllocateTempHostReg();
+    LoadHostRegWithConstant(pc_reg, m_block->pc);
+    GenerateCall(reinterpret_cast<const void*>(&CodeCache::RecordBlockExecution), static_cast<s32>(pc_reg));
+    FreeHostReg(pc_reg);
+  }
+
   if (g_settings.bios_tty_logging)
   {
     const u32 masked_pc = VirtualAddressToPhysical(m_block->pc);
@@ -100,6 +117,160 @@ void CPU::Recompiler::Recompiler::BeginBlock()
   m_dirty_instruction_bits = true;
 }
 
+bool CPU::Recompiler::Recompiler::CanCacheLoopRegisters() const
+{
+  if (!g_settings.cpu_recompiler_loop_register_cache || !g_settings.cpu_recompiler_block_linking ||
+      g_settings.bios_tty_logging || g_settings.UsingPGXPCPUMode() || !SupportsLoopRegisterCache() ||
+      m_block->HasFlag(CodeCache::BlockFlags::IsTrace) || m_block->HasFlag(CodeCache::BlockFlags::IsIdleLoop) ||
+      m_block->size < 2)
+  {
+    return false;
+  }
+
+  // The back edge isn't registered as a block link, so nothing in the loop can be allowed to invalidate it.
+  const Instruction* instructions = m_block->Instructions();
+  const CodeCache::InstructionInfo* infos = m_block->InstructionsInfo();
+  for (u32 i = 0; i < m_block->size; i++)
+  {
+    if (infos[i].is_store_instruction)
+      return false;
+  }
+
+  // Has to end with a direct branch back to the start of the block.
+  const u32 branch_index = m_block->size - 2;
+  const VirtualMemoryAddress branch_pc = m_block->pc + branch_index * sizeof(Instruction);
+  return (infos[branch_index].is_direct_branch_instruction && infos[branch_index + 1].is_branch_delay_slot &&
+          !infos[branch_index + 1].is_branch_instruction && !infos[branch_index + 1].has_load_delay &&
+          GetDirectBranchTarget(instructions[branch_index], branch_pc) == m_block->pc);
+}
+
+void CPU::Recompiler::Recompiler::BeginLoopRegisterCache()
+{
+  // Count guest register reads across the block, the most used ones get pinned.
+  std::array<u32, static_cast<size_t>(Reg::count)> read_counts = {};
+  const CodeCache::InstructionInfo* infos = m_block->InstructionsInfo();
+  for (u32 i = 0; i < m_block->size; i++)
+  {
+    for (const Reg reg : infos[i].read_reg)
+    {
+      if (reg > Reg::zero && reg < Reg::count)
+        read_counts[static_cast<u8>(reg)]++;
+    }
+  }
+
+  // Leave at least half of the callee-saved registers for the loop body.
+  u32 callee_saved_count = 0;
+  for (u32 i = 0; i < NUM_HOST_REGS; i++)
+  {
+    if ((m_host_regs[i].flags & (HR_USABLE | HR_CALLEE_SAVED)) == (HR_USABLE | HR_CALLEE_SAVED))
+      callee_saved_count++;
+  }
+
+  const u32 max_regs = std::min(MAX_LOOP_REGISTERS, callee_saved_count / 2);
+  if (max_regs == 0 || *std::max_element(read_counts.begin(), read_counts.end()) == 0)
+    return;
+
+  // Loop head can't have an incoming load delay, since the back edge won't carry one.
+  if (m_load_delay_dirty)
+    Flush(FLUSH_LOAD_DELAY_FROM_STATE);
+
+  while (m_num_loop_regs < max_regs)
+  {
+    const auto it = std::max_element(read_counts.begin(), read_counts.end());
+    if (*it == 0)
+      break;
+
+    const Reg reg = static_cast<Reg>(std::distance(read_counts.begin(), it));
+    *it = 0;
+
+    // Write mode, because after the first iteration the host register is newer than the state.
+    DEBUG_LOG("Caching guest reg {} across loop iterations", GetRegName(reg));
+    m_loop_guest_regs[m_num_loop_regs] = reg;
+    m_loop_host_regs[m_num_loop_regs] =
+      AllocateHostReg(HR_MODE_READ | HR_MODE_WRITE | HR_CALLEE_SAVED, HR_TYPE_CPU_REG, reg);
+    m_num_loop_regs++;
+  }
+
+  ClearHostRegsNeeded();
+  m_loop_branch_instruction = &m_block->Instructions()[m_block->size - 2];
+  m_loop_head = GetCurrentCodePointer();
+}
+
+bool CPU::Recompiler::Recompiler::PrepareLoopBackEdge()
+{
+  // Load delays can't be carried over the back edge, use the regular path instead.
+  if (!m_loop_head || m_load_delay_dirty || HasLoadDelay() || m_next_load_delay_register != Reg::count)
+    return false;
+
+  // Anything that isn't sitting in its loop register gets written back.
+  for (u32 i = 0; i < NUM_HOST_REGS; i++)
+  {
+    if (IsHostRegAllocated(i) && !IsLoopRegister(i))
+      FreeHostReg(i);
+  }
+
+  // Reload loop registers which were evicted or turned into constants in the body.
+  for (u32 i = 0; i < m_num_loop_regs; i++)
+  {
+    const u32 hreg = m_loop_host_regs[i];
+    const Reg reg = m_loop_guest_regs[i];
+    if (IsHostRegAllocated(hreg))
+      continue;
+
+    if (HasConstantReg(reg))
+    {
+      LoadHostRegWithConstant(hreg, GetConstantRegU32(reg));
+      ClearConstantReg(reg);
+    }
+    else
+    {
+      LoadHostRegFromCPUPointer(hreg, &g_state.regs.r[static_cast<u8>(reg)]);
+    }
+
+    HostRegAlloc& ra = m_host_regs[hreg];
+    ra.flags = (ra.flags & IMMUTABLE_HR_FLAGS) | HR_ALLOCATED | HR_MODE_READ | HR_MODE_WRITE;
+    ra.type = HR_TYPE_CPU_REG;
+    ra.reg = reg;
+  }
+
+  FlushConstantRegs(true);
+  return true;
+}
+
+void CPU::Recompiler::Recompiler::FlushLoopRegisters()
+{
+  for (u32 i = 0; i < m_num_loop_regs; i++)
+  {
+    StoreHostRegToCPUPointer(m_loop_host_regs[i], &g_state.regs.r[static_cast<u8>(m_loop_guest_regs[i])]);
+    ClearHostReg(m_loop_host_regs[i]);
+  }
+}
+
+bool CPU::Recompiler::Recompiler::IsLoopRegister(u32 host_reg) const
+{
+  const HostRegAlloc& ra = m_host_regs[host_reg];
+  if (!(ra.flags & HR_ALLOCATED) || ra.type != HR_TYPE_CPU_REG)
+    return false;
+
+  for (u32 i = 0; i < m_num_loop_regs; i++)
+  {
+    if (m_loop_host_regs[i] == host_reg)
+      return (m_loop_guest_regs[i] == ra.reg);
+  }
+
+  return false;
+}
+
+bool CPU::Recompiler::Recompiler::SupportsLoopRegisterCache() const
+{
+  return false;
+}
+
+void CPU::Recompiler::Recompiler::EndLoopBackEdge()
+{
+  Panic("Loop register cache not supported");
+}
+
 const void* CPU::Recompiler::Recompiler::CompileBlock(CodeCache::Block* block, u32* host_code_size,
                                                       u32* host_far_code_size)
 {
@@ -1075,11 +1246,16 @@ void CPU::Recompiler::Recompiler::Flush(u32 flags)
   {
     if (flags & FLUSH_FLUSH_MIPS_REGISTERS)
     {
+      // Loop registers stay dirty over the back edge, the exit paths write them back.
+      const bool keep_loop_regs = (flags == FLUSH_FOR_BRANCH && inst == m_loop_branch_instruction);
       for (u32 i = 0; i < NUM_HOST_REGS; i++)
       {
         HostRegAlloc& ra = m_host_regs[i];
-        if ((ra.flags & (HR_ALLOCATED | HR_MODE_WRITE)) == (HR_ALLOCATED | HR_MODE_WRITE) && ra.type == HR_TYPE_CPU_REG)
+        if ((ra.flags & (HR_ALLOCATED | HR_MODE_WRITE)) == (HR_ALLOCATED | HR_MODE_WRITE) &&
+            ra.type == HR_TYPE_CPU_REG && !(keep_loop_regs && IsLoopRegister(i)))
+        {
           FlushHostReg(i);
+        }
       }
 
       // flush any constant registers which are dirty too
@@ -1196,6 +1372,14 @@ void CPU::Recompiler::Recompiler::CompileInstruction()
     return;
   }
 
+  if (iinfo->is_dead_write)
+  {
+    // Result gets overwritten before anything can read it.
+    DEBUG_LOG("Skipping dead write at {:08X}", m_current_instruction_pc);
+    UpdateLoadDelay();
+    return;
+  }
+
   switch (inst->op)
   {
 #define PGXPFN(x) reinterpret_cast<const void*>(&PGXP::x)
@@ -1703,6 +1887,41 @@ void CPU::Recompiler::Recompiler::CompileLoadStoreTemplate(
     }
   }
 
+  // word loads from a constant scratchpad address can read the state directly, skipping the memory handlers
+  if (addr.has_value() && inst->op == InstructionOp::lw && CanUseDirectScratchpadAccess(addr.value()))
+  {
+    DEBUG_LOG("Direct scratchpad load from {:08X}", addr.value());
+    m_block->flags |= CodeCache::BlockFlags::UsesDirectScratchpadAccess;
+    if (rt != Reg::zero)
+    {
+      const u32 offset = VirtualAddressToPhysical(addr.value()) - SCRATCHPAD_ADDR;
+      const u32 dst = AllocateHostReg(GetFlagsForNewLoadDelayedReg(),
+                                      EMULATE_LOAD_DELAYS ? HR_TYPE_NEXT_LOAD_DELAY_VALUE : HR_TYPE_CPU_REG, rt);
+      LoadHostRegFromCPUPointer(dst, &g_state.scratchpad[offset]);
+    }
+
+    return;
+  }
+
+  // same for word stores, nothing else can observe the scratchpad, and it can't contain code
+  if (addr.has_value() && inst->op == InstructionOp::sw && CanUseDirectScratchpadAccess(addr.value()))
+  {
+    DEBUG_LOG("Direct scratchpad store to {:08X}", addr.value());
+    m_block->flags |= CodeCache::BlockFlags::UsesDirectScratchpadAccess;
+    const u32 offset = VirtualAddressToPhysical(addr.value()) - SCRATCHPAD_ADDR;
+    if (HasConstantReg(rt))
+    {
+      StoreConstantToCPUPointer(GetConstantRegU32(rt), &g_state.scratchpad[offset]);
+    }
+    else
+    {
+      const u32 src = AllocateHostReg(HR_MODE_READ, HR_TYPE_CPU_REG, rt);
+      StoreHostRegToCPUPointer(src, &g_state.scratchpad[offset]);
+    }
+
+    return;
+  }
+
   // when not using fastmem, flush GTE completion cycle
   // otherwise we end up consuming more cycles, because we're only counting a single cycle for loads
   // and ram loads would have normally used up all the cycles the GTE was busy for
@@ -1715,9 +1934,12 @@ void CPU::Recompiler::Recompiler::CompileLoadStoreTemplate(
       GetSegmentForAddress(spec_addr.value()) != Segment::KSEG2)
   {
     // Get rid of physical aliases.
+    // Traces are confined to the start page, but aren't contiguous, so check the rest of the page instead.
     const u32 phys_spec_addr = VirtualAddressToPhysical(spec_addr.value());
     if (phys_spec_addr >= VirtualAddressToPhysical(m_compiler_pc) &&
-        phys_spec_addr < VirtualAddressToPhysical(m_block->pc + (m_block->size * sizeof(Instruction))))
+        (m_block->HasFlag(CodeCache::BlockFlags::IsTrace) ?
+           ((phys_spec_addr >> HOST_PAGE_SHIFT) == (VirtualAddressToPhysical(m_block->pc) >> HOST_PAGE_SHIFT)) :
+           (phys_spec_addr < VirtualAddressToPhysical(m_block->pc + (m_block->size * sizeof(Instruction))))))
     {
       WARNING_LOG("Instruction {:08X} speculatively writes to {:08X} inside block {:08X}-{:08X}. Truncating block.",
                   m_current_instruction_pc, phys_spec_addr, m_block->pc,
@@ -1727,12 +1949,50 @@ void CPU::Recompiler::Recompiler::CompileLoadStoreTemplate(
   }
 }
 
+bool CPU::Recompiler::Recompiler::CanUseDirectScratchpadAccess(VirtualMemoryAddress address)
+{
+  if constexpr ((OFFSETOF(State, scratchpad) + SCRATCHPAD_SIZE) > MAX_STATE_LOAD_OFFSET)
+    return false;
+
+  // PGXP needs to see the access, and isolated cache accesses don't go to the scratchpad. The cache state is only
+  // known for certain until the block writes SR, since isolating the cache at runtime invalidates these blocks.
+  if (!g_settings.cpu_recompiler_block_optimization || g_settings.gpu_pgxp_enable ||
+      m_speculative_constants.cop0_sr_written || !m_speculative_constants.cop0_sr.has_value() || SpecIsCacheIsolated())
+  {
+    return false;
+  }
+
+  // scratchpad isn't accessible through KSEG1
+  const Segment segment = GetSegmentForAddress(address);
+  const PhysicalMemoryAddress paddr = VirtualAddressToPhysical(address);
+  return ((segment == Segment::KUSEG || segment == Segment::KSEG0) && (address & 3) == 0 &&
+          paddr >= SCRATCHPAD_ADDR && paddr < (SCRATCHPAD_ADDR + SCRATCHPAD_SIZE));
+}
+
 void CPU::Recompiler::Recompiler::TruncateBlock()
 {
-  m_block->size = ((m_current_instruction_pc - m_block->pc) / sizeof(Instruction)) + 1;
+  // use the instruction index, traces don't map pc to index linearly
+  m_block->size = static_cast<u32>(inst - m_block->Instructions()) + 1;
   iinfo->is_last_instruction = true;
 }
 
+void CPU::Recompiler::Recompiler::SkipIdleLoop(const std::optional<u32>& newpc)
+{
+  if (!newpc.has_value() || newpc.value() != m_block->pc || !m_block->HasFlag(CodeCache::BlockFlags::IsIdleLoop))
+    return;
+
+  // Bring pending_ticks up to downcount, the event test when the block ends will then run events instead of looping.
+  // Registers have already been flushed for the end of the block, so nothing is live across the call.
+  GenerateCall(reinterpret_cast<const void*>(&CodeCache::SkipIdleLoopTicks));
+}
+
+void CPU::Recompiler::Recompiler::ContinueTrace(u32 newpc)
+{
+  // CompileBlock() advances both PCs before compiling the next instruction.
+  m_current_instruction_pc = newpc - sizeof(Instruction);
+  m_compiler_pc = newpc;
+}
+
 const TickCount* CPU::Recompiler::Recompiler::GetFetchMemoryAccessTimePtr() const
 {
   const TickCount* ptr = Bus::GetMemoryAccessTimePtr(VirtualAddressToPhysical(m_block->pc), MemoryAccessSize::Word);
@@ -1774,20 +2034,29 @@ void CPU::Recompiler::Recompiler::CompileMoveRegTemplate(Reg dst, Reg src, bool
   // TODO: This could be made better if we only did it for registers where there was a previous MFC2.
   if (g_settings.gpu_pgxp_enable && pgxp_move)
   {
-    // might've been renamed, so use dst here
-    GeneratePGXPCallWithMIPSRegs(reinterpret_cast<const void*>(&PGXP::CPU_MOVE_Packed), PGXP::PackMoveArgs(dst, src),
-                                 dst);
+    GeneratePGXPMove(dst, src);
   }
 }
 
+void CPU::Recompiler::Recompiler::GeneratePGXPMove(Reg dst, Reg src)
+{
+  // might've been renamed, so use dst here
+  GeneratePGXPCallWithMIPSRegs(reinterpret_cast<const void*>(&PGXP::CPU_MOVE_Packed), PGXP::PackMoveArgs(dst, src),
+                               dst);
+}
+
 void CPU::Recompiler::Recompiler::Compile_j()
 {
   const u32 newpc = (m_compiler_pc & UINT32_C(0xF0000000)) | (inst->j.target << 2);
+  const bool trace_jump = iinfo->is_trace_jump;
 
   // TODO: Delay slot swap.
   // We could also move the cycle commit back.
   CompileBranchDelaySlot();
-  EndBlock(newpc, true);
+  if (trace_jump)
+    ContinueTrace(newpc);
+  else
+    EndBlock(newpc, true);
 }
 
 void CPU::Recompiler::Recompiler::Compile_jr_const(CompileFlags cf)
@@ -1807,9 +2076,13 @@ void CPU::Recompiler::Recompiler::Compile_jr_const(CompileFlags cf)
 void CPU::Recompiler::Recompiler::Compile_jal()
 {
   const u32 newpc = (m_compiler_pc & UINT32_C(0xF0000000)) | (inst->j.target << 2);
+  const bool trace_jump = iinfo->is_trace_jump;
   SetConstantReg(Reg::ra, GetBranchReturnAddress({}));
   CompileBranchDelaySlot();
-  EndBlock(newpc, true);
+  if (trace_jump)
+    ContinueTrace(newpc);
+  else
+    EndBlock(newpc, true);
 }
 
 void CPU::Recompiler::Recompiler::Compile_jalr_const(CompileFlags cf)
@@ -2180,7 +2453,16 @@ void CPU::Recompiler::Recompiler::Compile_lui()
   SetConstantReg(inst->i.rt, inst->i.imm_zext32() << 16);
 
   if (g_settings.UsingPGXPCPUMode())
-    GeneratePGXPCallWithMIPSRegs(reinterpret_cast<const void*>(&PGXP::CPU_LUI), inst->bits);
+  {
+    // the shadow register is a constant as well, no need to call out to PGXP for it
+    const PGXPValue val = PGXP::GetLUIValue(*inst);
+    PGXPValue& rt = g_state.pgxp_gpr[static_cast<u8>(inst->i.rt.GetValue())];
+    StoreConstantToCPUPointer(std::bit_cast<u32>(val.x), &rt.x);
+    StoreConstantToCPUPointer(std::bit_cast<u32>(val.y), &rt.y);
+    StoreConstantToCPUPointer(std::bit_cast<u32>(val.z), &rt.z);
+    StoreConstantToCPUPointer(val.value, &rt.value);
+    StoreConstantToCPUPointer(val.flags, &rt.flags);
+  }
 }
 
 static constexpr const std::array<std::pair<u32*, u32>, 16> s_cop0_table = {
@@ -2319,6 +2601,30 @@ CPU::Recompiler::Recompiler::GetGTERegisterPointer(u32 index, bool writing)
   }
 }
 
+CPU::Recompiler::Recompiler::GTEInlineCommand CPU::Recompiler::Recompiler::GetGTEInlineCommand(u32 inst_bits)
+{
+  const GTE::Instruction inst{inst_bits};
+  switch (inst.command)
+  {
+    case 0x06:
+      // PGXP culling needs the precise vertices, leave that to the GTE.
+      return (g_settings.gpu_pgxp_enable && g_settings.gpu_pgxp_culling) ? GTEInlineCommand::None :
+                                                                           GTEInlineCommand::NCLIP;
+
+    case 0x28:
+      return GTEInlineCommand::SQR;
+
+    case 0x2D:
+      return GTEInlineCommand::AVSZ3;
+
+    case 0x2E:
+      return GTEInlineCommand::AVSZ4;
+
+    default:
+      return GTEInlineCommand::None;
+  }
+}
+
 void CPU::Recompiler::Recompiler::AddGTETicks(TickCount ticks)
 {
   // TODO: check, int has +1 here
@@ -2383,6 +2689,7 @@ void CPU::Recompiler::Recompiler::InitSpeculativeRegs()
     m_speculative_constants.regs[i] = g_state.regs.r[i];
 
   m_speculative_constants.cop0_sr = g_state.cop0_regs.sr.bits;
+  m_speculative_constants.cop0_sr_written = false;
   m_speculative_constants.memory.clear();
 }
 
@@ -2875,7 +3182,11 @@ void CPU::Recompiler::Recompiler::SpecExec_mfc0()
 void CPU::Recompiler::Recompiler::SpecExec_mtc0()
 {
   const Cop0Reg rd = static_cast<Cop0Reg>(inst->r.rd.GetValue());
-  if (rd != Cop0Reg::SR || !m_speculative_constants.cop0_sr.has_value())
+  if (rd != Cop0Reg::SR)
+    return;
+
+  m_speculative_constants.cop0_sr_written = true;
+  if (!m_speculative_constants.cop0_sr.has_value())
     return;
 
   SpecValue val = SpecReadReg(inst->r.rt);
@@ -34,6 +34,9 @@ public:
   static constexpr u32 NUM_HOST_REGS = 16;
   static constexpr bool HAS_MEMORY_OPERANDS = true;
 
+  // Largest offset from the CPU state pointer reachable by a single word load.
+  static constexpr u32 MAX_STATE_LOAD_OFFSET = 0xFFFFFFFFu;
+
   // Align functions to 16 bytes.
   static constexpr u32 FUNCTION_ALIGNMENT = 16;
 
@@ -47,6 +50,9 @@ public:
   static constexpr u32 NUM_HOST_REGS = 16;
   static constexpr bool HAS_MEMORY_OPERANDS = false;
 
+  // Largest offset from the CPU state pointer reachable by a single word load.
+  static constexpr u32 MAX_STATE_LOAD_OFFSET = 4095;
+
   // Align functions to 4 bytes (word size).
   static constexpr u32 FUNCTION_ALIGNMENT = 16;
 
@@ -62,6 +68,9 @@ public:
   static constexpr u32 NUM_HOST_REGS = 32;
   static constexpr bool HAS_MEMORY_OPERANDS = false;
 
+  // Largest offset from the CPU state pointer reachable by a single word load.
+  static constexpr u32 MAX_STATE_LOAD_OFFSET = 16380;
+
   // Align functions to 16 bytes.
   static constexpr u32 FUNCTION_ALIGNMENT = 16;
 
@@ -71,6 +80,9 @@ public:
   static constexpr u32 NUM_HOST_REGS = 32;
   static constexpr bool HAS_MEMORY_OPERANDS = false;
 
+  // Largest offset from the CPU state pointer reachable by a single word load.
+  static constexpr u32 MAX_STATE_LOAD_OFFSET = 2047;
+
   // A reasonable "maximum" number of bytes per instruction.
   // Seems to hover around ~36-48 bytes without PGXP, and ~48-64 bytes with.
   // Use an upper bound of 64 bytes to be safe.
@@ -256,6 +268,9 @@ protected:
   bool TrySwapDelaySlot(Reg rs = Reg::zero, Reg rt = Reg::zero, Reg rd = Reg::zero);
   void SetCompilerPC(u32 newpc);
   void TruncateBlock();
+  bool CanUseDirectScratchpadAccess(VirtualMemoryAddress address);
+  void ContinueTrace(u32 newpc);
+  void SkipIdleLoop(const std::optional<u32>& newpc);
 
   const TickCount* GetFetchMemoryAccessTimePtr() const;
 
@@ -271,6 +286,16 @@ protected:
   virtual void EndBlockWithException(Exception excode) = 0;
   virtual const void* EndCompile(u32* code_size, u32* far_code_size) = 0;
 
+  /// Loop register cache. Blocks which branch back to their own start keep their most-read guest registers in
+  /// callee-saved host registers, and jump back to the loop head without a flush/reload when no events are pending.
+  bool CanCacheLoopRegisters() const;
+  void BeginLoopRegisterCache();
+  bool PrepareLoopBackEdge();
+  void FlushLoopRegisters();
+  bool IsLoopRegister(u32 host_reg) const;
+  virtual bool SupportsLoopRegisterCache() const;
+  virtual void EndLoopBackEdge();
+
   ALWAYS_INLINE bool IsHostRegAllocated(u32 r) const { return (m_host_regs[r].flags & HR_ALLOCATED) != 0; }
   static const char* GetReadWriteModeString(u32 flags);
   virtual const char* GetHostRegName(u32 reg) const = 0;
@@ -336,6 +361,10 @@ protected:
   virtual void GeneratePGXPCallWithMIPSRegs(const void* func, u32 arg1val, Reg arg2reg = Reg::count,
                                             Reg arg3reg = Reg::count) = 0;
 
+  /// Validates the PGXP value of src against the value of dst, then copies it to dst. Backends can override this to
+  /// update the shadow registers inline, instead of flushing and calling out to PGXP.
+  virtual void GeneratePGXPMove(Reg dst, Reg src);
+
   virtual void Compile_Fallback() = 0;
 
   void Compile_j();
@@ -458,6 +487,30 @@ protected:
 
   static std::pair<u32*, GTERegisterAccessAction> GetGTERegisterPointer(u32 index, bool writing);
 
+  /// GTE commands which are short enough to be emitted inline, instead of calling the implementation.
+  enum class GTEInlineCommand : u8
+  {
+    None,
+    NCLIP,
+    AVSZ3,
+    AVSZ4,
+    SQR,
+  };
+
+  static GTEInlineCommand GetGTEInlineCommand(u32 inst_bits);
+
+  /// FLAG bits set by the inline commands. IR3 saturation is the only one that doesn't also set the error bit.
+  enum GTEFlagBit : u32
+  {
+    GTE_FLAG_MAC0_UNDERFLOW_BIT = 15,
+    GTE_FLAG_MAC0_OVERFLOW_BIT = 16,
+    GTE_FLAG_SZ1_OTZ_SATURATED_BIT = 18,
+    GTE_FLAG_IR3_SATURATED_BIT = 22,
+    GTE_FLAG_IR2_SATURATED_BIT = 23,
+    GTE_FLAG_IR1_SATURATED_BIT = 24,
+    GTE_FLAG_ERROR_BIT = 31,
+  };
+
   CodeCache::Block* m_block = nullptr;
   u32 m_compiler_pc = 0;
   TickCount m_cycles = 0;
@@ -488,6 +541,13 @@ protected:
   Reg m_next_load_delay_register = Reg::count;
   u32 m_next_load_delay_value_register = 0;
 
+  static constexpr u32 MAX_LOOP_REGISTERS = 4;
+  const void* m_loop_head = nullptr;
+  const Instruction* m_loop_branch_instruction = nullptr;
+  std::array<Reg, MAX_LOOP_REGISTERS> m_loop_guest_regs = {};
+  std::array<u32, MAX_LOOP_REGISTERS> m_loop_host_regs = {};
+  u32 m_num_loop_regs = 0;
+
   struct HostStateBackup
   {
     TickCount cycles;
@@ -526,6 +586,7 @@ protected:
     std::array<SpecValue, static_cast<u8>(Reg::count)> regs;
     std::unordered_map<PhysicalMemoryAddress, SpecValue> memory;
     SpecValue cop0_sr;
+    bool cop0_sr_written; // cop0_sr is only a guess after the block writes SR, even if it has a value
   };
 
   void InitSpeculativeRegs();
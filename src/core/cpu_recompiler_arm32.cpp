@@ -690,6 +690,7 @@ void CPU::ARM32Recompiler::EndBlock(const std::optional<u32>& newpc, bool do_eve
 
   // flush regs
   Flush(FLUSH_END_BLOCK);
+  SkipIdleLoop(newpc);
   EndAndLinkBlock(newpc, do_event_test, false);
 }
 
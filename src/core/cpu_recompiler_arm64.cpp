@@ -812,11 +812,31 @@ void CPU::ARM64Recompiler::GenerateICacheCheckAndUpdate()
     const auto& fill_ticks_reg = w4;
     const auto& ticks_to_add_reg = w5;
 
-    VirtualMemoryAddress current_pc = m_block->pc & ICACHE_TAG_ADDRESS_MASK;
-    const TickCount fill_ticks = GetICacheFillTicks(current_pc);
+    const VirtualMemoryAddress block_pc = m_block->pc & ICACHE_TAG_ADDRESS_MASK;
+    const TickCount fill_ticks = GetICacheFillTicks(block_pc);
     if (fill_ticks <= 0)
       return;
 
+    // The lines and tags are known at compile time, and the block is usually still cached. So compare them all first,
+    // chaining the comparisons, and only update tags and add fill ticks in far code if any of them missed.
+    VirtualMemoryAddress current_pc = block_pc;
+    armEmitMov(armAsm, current_tag_reg, current_pc);
+    for (u32 i = 0; i < m_block->icache_line_count; i++, current_pc += ICACHE_LINE_SIZE)
+    {
+      const u32 offset = OFFSETOF(State, icache_tags) + (GetICacheLine(current_pc) * sizeof(u32));
+      armAsm->ldr(existing_tag_reg, MemOperand(RSTATE, offset));
+      if (i == 0)
+        armAsm->cmp(existing_tag_reg, current_tag_reg);
+      else
+        armAsm->ccmp(existing_tag_reg, current_tag_reg, NoFlag, eq);
+
+      if (i != (m_block->icache_line_count - 1))
+        armAsm->add(current_tag_reg, current_tag_reg, armCheckAddSubConstant(ICACHE_LINE_SIZE));
+    }
+
+    SwitchToFarCode(true, ne);
+    current_pc = block_pc;
+
     armAsm->ldr(ticks_reg, PTR(&g_state.pending_ticks));
     armEmitMov(armAsm, current_tag_reg, current_pc);
     armEmitMov(armAsm, fill_ticks_reg, fill_ticks);
@@ -838,6 +858,7 @@ void CPU::ARM64Recompiler::GenerateICacheCheckAndUpdate()
     }
 
     armAsm->str(ticks_reg, PTR(&g_state.pending_ticks));
+    SwitchToNearCode(true);
   }
 }
 
@@ -855,6 +876,12 @@ void CPU::ARM64Recompiler::GenerateCall(const void* func, s32 arg1reg /*= -1*/,
 
 void CPU::ARM64Recompiler::EndBlock(const std::optional<u32>& newpc, bool do_event_test)
 {
+  if (newpc.has_value() && newpc.value() == m_block->pc && PrepareLoopBackEdge())
+  {
+    EndLoopBackEdge();
+    return;
+  }
+
   if (newpc.has_value())
   {
     if (m_dirty_pc || m_compiler_pc != newpc)
@@ -867,9 +894,45 @@ void CPU::ARM64Recompiler::EndBlock(const std::optional<u32>& newpc, bool do_eve
 
   // flush regs
   Flush(FLUSH_END_BLOCK);
+  SkipIdleLoop(newpc);
   EndAndLinkBlock(newpc, do_event_test, false);
 }
 
+bool CPU::ARM64Recompiler::SupportsLoopRegisterCache() const
+{
+  return true;
+}
+
+void CPU::ARM64Recompiler::EndLoopBackEdge()
+{
+  DebugAssert(!m_block_ended);
+  m_block_ended = true;
+  m_dirty_pc = false;
+
+  // pending_ticks += cycles
+  // if (pending_ticks < downcount) { goto loop_head; }
+  const TickCount cycles = std::exchange(m_cycles, 0);
+  armAsm->ldr(RWARG1, PTR(&g_state.pending_ticks));
+  armAsm->ldr(RWARG2, PTR(&g_state.downcount));
+  if (cycles > 0)
+    armAsm->add(RWARG1, RWARG1, armCheckAddSubConstant(cycles));
+  if (m_gte_done_cycle > cycles)
+  {
+    armAsm->add(RWARG3, RWARG1, armCheckAddSubConstant(m_gte_done_cycle - cycles));
+    armAsm->str(RWARG3, PTR(&g_state.gte_completion_tick));
+  }
+  armAsm->cmp(RWARG1, RWARG2);
+  if (cycles > 0)
+    armAsm->str(RWARG1, PTR(&g_state.pending_ticks));
+  armEmitCondBranch(armAsm, lt, m_loop_head);
+
+  // events pending, write the cached registers back and come back in through the block start
+  EmitMov(RWSCRATCH, m_block->pc);
+  armAsm->str(RWSCRATCH, PTR(&g_state.pc));
+  FlushLoopRegisters();
+  armEmitJmp(armAsm, CodeCache::g_run_events_and_dispatch, false);
+}
+
 void CPU::ARM64Recompiler::EndBlockWithException(Exception excode)
 {
   // flush regs, but not pc, it's going to get overwritten
@@ -1136,6 +1199,30 @@ void CPU::ARM64Recompiler::GeneratePGXPCallWithMIPSRegs(const void* func, u32 ar
   EmitCall(func);
 }
 
+void CPU::ARM64Recompiler::GeneratePGXPMove(Reg dst, Reg src)
+{
+  PGXPValue& src_val = g_state.pgxp_gpr[static_cast<u8>(src)];
+  PGXPValue& dst_val = g_state.pgxp_gpr[static_cast<u8>(dst)];
+
+  // flags = (src.value == value) ? src.flags : 0, written back to both
+  MoveMIPSRegToReg(RWARG1, dst);
+  armAsm->ldr(RWARG2, PTR(&src_val.value));
+  armAsm->ldr(RWARG3, PTR(&src_val.flags));
+  armAsm->cmp(RWARG1, RWARG2);
+  armAsm->csel(RWARG3, RWARG3, wzr, eq);
+  armAsm->str(RWARG3, PTR(&src_val.flags));
+  armAsm->str(RWARG3, PTR(&dst_val.flags));
+  armAsm->str(RWARG2, PTR(&dst_val.value));
+
+  // values aren't 8 byte aligned, so copy the rest a word at a time
+  armAsm->ldr(RWARG1, PTR(&src_val.x));
+  armAsm->str(RWARG1, PTR(&dst_val.x));
+  armAsm->ldr(RWARG1, PTR(&src_val.y));
+  armAsm->str(RWARG1, PTR(&dst_val.y));
+  armAsm->ldr(RWARG1, PTR(&src_val.z));
+  armAsm->str(RWARG1, PTR(&dst_val.z));
+}
+
 void CPU::ARM64Recompiler::Flush(u32 flags)
 {
   Recompiler::Flush(flags);
@@ -2675,13 +2762,129 @@ void CPU::ARM64Recompiler::Compile_cop2(CompileFlags cf)
   TickCount func_ticks;
   GTE::InstructionImpl func = GTE::GetInstructionImpl(inst->bits, &func_ticks);
 
-  Flush(FLUSH_FOR_C_CALL);
-  EmitMov(RWARG1, inst->bits & GTE::Instruction::REQUIRED_BITS_MASK);
-  EmitCall(reinterpret_cast<const void*>(func));
+  const GTEInlineCommand inline_command = GetGTEInlineCommand(inst->bits);
+  switch (inline_command)
+  {
+    case GTEInlineCommand::NCLIP:
+      Compile_gte_nclip();
+      break;
+
+    case GTEInlineCommand::AVSZ3:
+    case GTEInlineCommand::AVSZ4:
+      Compile_gte_avsz(inline_command == GTEInlineCommand::AVSZ4);
+      break;
+
+    case GTEInlineCommand::SQR:
+      Compile_gte_sqr(GTE::Instruction{inst->bits}.GetShift());
+      break;
+
+    default:
+    {
+      Flush(FLUSH_FOR_C_CALL);
+      EmitMov(RWARG1, inst->bits & GTE::Instruction::REQUIRED_BITS_MASK);
+      EmitCall(reinterpret_cast<const void*>(func));
+    }
+    break;
+  }
 
   AddGTETicks(func_ticks);
 }
 
+void CPU::ARM64Recompiler::TestGTEMAC0Overflow(const vixl::aarch64::Register& value,
+                                               const vixl::aarch64::Register& flags,
+                                               const vixl::aarch64::Register& temp)
+{
+  // flags = (value != s32(value)) ? ((value < 0) ? underflow : overflow) : 0
+  EmitMov(flags, (1u << GTE_FLAG_MAC0_OVERFLOW_BIT) | (1u << GTE_FLAG_ERROR_BIT));
+  EmitMov(temp, (1u << GTE_FLAG_MAC0_UNDERFLOW_BIT) | (1u << GTE_FLAG_ERROR_BIT));
+  armAsm->cmp(value, 0);
+  armAsm->csel(flags, temp, flags, lt);
+  armAsm->cmp(value, Operand(value.W(), SXTW));
+  armAsm->csel(flags, wzr, flags, eq);
+}
+
+void CPU::ARM64Recompiler::Compile_gte_nclip()
+{
+  // MAC0 = SX0*SY1 + SX1*SY2 + SX2*SY0 - SX0*SY2 - SX1*SY0 - SX2*SY1
+  //      = SX0*(SY1-SY2) + SX1*(SY2-SY0) + SX2*(SY0-SY1), which is exact in 64 bits.
+  armAsm->ldrsh(RWARG2, PTR(&g_state.gte_regs.SXY1[1]));
+  armAsm->ldrsh(RWARG3, PTR(&g_state.gte_regs.SXY2[1]));
+  armAsm->sub(RWARG2, RWARG2, RWARG3);
+  armAsm->ldrsh(RWSCRATCH, PTR(&g_state.gte_regs.SXY0[0]));
+  armAsm->smull(RXRET, RWSCRATCH, RWARG2);
+  armAsm->ldrsh(RWARG2, PTR(&g_state.gte_regs.SXY0[1]));
+  armAsm->sub(RWARG3, RWARG3, RWARG2);
+  armAsm->ldrsh(RWSCRATCH, PTR(&g_state.gte_regs.SXY1[0]));
+  armAsm->smaddl(RXRET, RWSCRATCH, RWARG3, RXRET);
+  armAsm->ldrsh(RWARG3, PTR(&g_state.gte_regs.SXY1[1]));
+  armAsm->sub(RWARG2, RWARG2, RWARG3);
+  armAsm->ldrsh(RWSCRATCH, PTR(&g_state.gte_regs.SXY2[0]));
+  armAsm->smaddl(RXRET, RWSCRATCH, RWARG2, RXRET);
+
+  armAsm->str(RWRET, PTR(&g_state.gte_regs.MAC0));
+  TestGTEMAC0Overflow(RXRET, RWARG2, RWARG3);
+  armAsm->str(RWARG2, PTR(&g_state.gte_regs.FLAG.bits));
+}
+
+void CPU::ARM64Recompiler::Compile_gte_avsz(bool avsz4)
+{
+  // MAC0 = ZSF3*(SZ1+SZ2+SZ3) or ZSF4*(SZ0+SZ1+SZ2+SZ3), OTZ = MAC0 SAR 12 clamped to 0..FFFFh
+  armAsm->ldrh(RWARG2, PTR(&g_state.gte_regs.SZ1));
+  armAsm->ldrh(RWARG3, PTR(&g_state.gte_regs.SZ2));
+  armAsm->add(RWARG2, RWARG2, RWARG3);
+  armAsm->ldrh(RWARG3, PTR(&g_state.gte_regs.SZ3));
+  armAsm->add(RWARG2, RWARG2, RWARG3);
+  if (avsz4)
+  {
+    armAsm->ldrh(RWARG3, PTR(&g_state.gte_regs.SZ0));
+    armAsm->add(RWARG2, RWARG2, RWARG3);
+  }
+  armAsm->ldrsh(RWARG3, PTR(avsz4 ? &g_state.gte_regs.ZSF4 : &g_state.gte_regs.ZSF3));
+  armAsm->smull(RXRET, RWARG2, RWARG3);
+
+  armAsm->str(RWRET, PTR(&g_state.gte_regs.MAC0));
+  TestGTEMAC0Overflow(RXRET, RWARG2, RWARG3);
+
+  // Negative values are above FFFFh unsigned, so one compare covers both ends.
+  armAsm->asr(RXRET, RXRET, 12);
+  EmitMov(RWARG3, 0xFFFF);
+  armAsm->cmp(RXRET, RXARG3);
+  armAsm->csel(RXSCRATCH, RXARG3, RXRET, gt);
+  armAsm->cset(RWARG3, hi);
+  armAsm->cmp(RXRET, 0);
+  armAsm->csel(RWSCRATCH, wzr, RWSCRATCH, lt);
+  armAsm->str(RWSCRATCH, PTR(&g_state.gte_regs.dr32[7]));
+  armAsm->orr(RWARG2, RWARG2, Operand(RWARG3, LSL, GTE_FLAG_SZ1_OTZ_SATURATED_BIT));
+  armAsm->orr(RWARG2, RWARG2, Operand(RWARG3, LSL, GTE_FLAG_ERROR_BIT));
+  armAsm->str(RWARG2, PTR(&g_state.gte_regs.FLAG.bits));
+}
+
+void CPU::ARM64Recompiler::Compile_gte_sqr(u8 shift)
+{
+  // MAC1..3 = (IR1..3 * IR1..3) SAR shift, IR1..3 = MAC1..3 clamped. The squares are never negative.
+  static constexpr std::array<u32, 3> sat_bits = {GTE_FLAG_IR1_SATURATED_BIT, GTE_FLAG_IR2_SATURATED_BIT,
+                                                  GTE_FLAG_IR3_SATURATED_BIT};
+
+  EmitMov(RWARG2, 0);
+  EmitMov(RWARG3, 0x7FFF);
+  for (u32 i = 0; i < 3; i++)
+  {
+    armAsm->ldrsh(RWRET, PTR(&g_state.gte_regs.r32[9 + i]));
+    armAsm->mul(RWRET, RWRET, RWRET);
+    if (shift > 0)
+      armAsm->asr(RWRET, RWRET, shift);
+    armAsm->str(RWRET, PTR(&g_state.gte_regs.r32[25 + i]));
+    armAsm->cmp(RWRET, RWARG3);
+    armAsm->csel(RWSCRATCH, RWARG3, RWRET, gt);
+    armAsm->str(RWSCRATCH, PTR(&g_state.gte_regs.r32[9 + i]));
+    armAsm->cset(RWSCRATCH, gt);
+    armAsm->orr(RWARG2, RWARG2, Operand(RWSCRATCH, LSL, sat_bits[i]));
+    if (sat_bits[i] != GTE_FLAG_IR3_SATURATED_BIT)
+      armAsm->orr(RWARG2, RWARG2, Operand(RWSCRATCH, LSL, GTE_FLAG_ERROR_BIT));
+  }
+  armAsm->str(RWARG2, PTR(&g_state.gte_regs.FLAG.bits));
+}
+
 u32 CPU::Recompiler::CompileLoadStoreThunk(void* thunk_code, u32 thunk_space, void* code_address, u32 code_size,
                                            TickCount cycles_to_add, TickCount cycles_to_remove, u32 gpr_bitmask,
                                            u8 address_register, u8 data_register, MemoryAccessSize size, bool is_signed,
@@ -653,6 +653,7 @@ void CPU::RISCV64Recompiler::EndBlock(const std::optional<u32>& newpc, bool do_e
 
   // flush regs
   Flush(FLUSH_END_BLOCK);
+  SkipIdleLoop(newpc);
   EndAndLinkBlock(newpc, do_event_test, false);
 }
 
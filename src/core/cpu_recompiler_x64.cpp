@@ -541,11 +541,24 @@ void CPU::X64Recompiler::GenerateICacheCheckAndUpdate()
   else if (m_block->icache_line_count > 0)
   {
     // RAM to ROM is not contiguous, therefore the cost will be the same across the entire block.
-    VirtualMemoryAddress current_pc = m_block->pc & ICACHE_TAG_ADDRESS_MASK;
-    const TickCount fill_ticks = GetICacheFillTicks(current_pc);
+    const VirtualMemoryAddress block_pc = m_block->pc & ICACHE_TAG_ADDRESS_MASK;
+    const TickCount fill_ticks = GetICacheFillTicks(block_pc);
     if (fill_ticks <= 0)
       return;
 
+    // The lines and tags are known at compile time, and the block is usually still cached. So check them all first,
+    // and only update tags and add fill ticks in far code if any of them missed.
+    const void* miss_code = m_far_emitter->getCurr<const void*>();
+    VirtualMemoryAddress current_pc = block_pc;
+    for (u32 i = 0; i < m_block->icache_line_count; i++, current_pc += ICACHE_LINE_SIZE)
+    {
+      cg->cmp(cg->dword[PTR(&g_state.icache_tags[GetICacheLine(current_pc)])], GetICacheTagForAddress(current_pc));
+      cg->jne(miss_code);
+    }
+
+    SwitchToFarCode(false);
+    current_pc = block_pc;
+
     cg->lea(RXARG1, cg->dword[PTR(&g_state.icache_tags)]);
     cg->xor_(RWARG2, RWARG2);
     cg->mov(RWARG4, fill_ticks);
@@ -566,6 +579,7 @@ void CPU::X64Recompiler::GenerateICacheCheckAndUpdate()
     }
 
     cg->add(cg->dword[PTR(&g_state.pending_ticks)], RWARG2);
+    SwitchToNearCode(true);
   }
 }
 
@@ -583,6 +597,12 @@ void CPU::X64Recompiler::GenerateCall(const void* func, s32 arg1reg /*= -1*/, s3
 
 void CPU::X64Recompiler::EndBlock(const std::optional<u32>& newpc, bool do_event_test)
 {
+  if (newpc.has_value() && newpc.value() == m_block->pc && PrepareLoopBackEdge())
+  {
+    EndLoopBackEdge();
+    return;
+  }
+
   if (newpc.has_value())
   {
     if (m_dirty_pc || m_compiler_pc != newpc)
@@ -592,9 +612,44 @@ void CPU::X64Recompiler::EndBlock(const std::optional<u32>& newpc, bool do_event
 
   // flush regs
   Flush(FLUSH_END_BLOCK);
+  SkipIdleLoop(newpc);
   EndAndLinkBlock(newpc, do_event_test, false);
 }
 
+bool CPU::X64Recompiler::SupportsLoopRegisterCache() const
+{
+  return true;
+}
+
+void CPU::X64Recompiler::EndLoopBackEdge()
+{
+  DebugAssert(!m_block_ended);
+  m_block_ended = true;
+  m_dirty_pc = false;
+
+  // pending_ticks += cycles
+  // if (pending_ticks < downcount) { goto loop_head; }
+  const TickCount cycles = std::exchange(m_cycles, 0);
+  cg->mov(RWARG1, cg->dword[PTR(&g_state.pending_ticks)]);
+  if (cycles > 0)
+    cg->add(RWARG1, cycles);
+  if (m_gte_done_cycle > cycles)
+  {
+    cg->mov(RWARG2, RWARG1);
+    cg->add(RWARG2, m_gte_done_cycle - cycles);
+    cg->mov(cg->dword[PTR(&g_state.gte_completion_tick)], RWARG2);
+  }
+  cg->cmp(RWARG1, cg->dword[PTR(&g_state.downcount)]);
+  if (cycles > 0)
+    cg->mov(cg->dword[PTR(&g_state.pending_ticks)], RWARG1);
+  cg->jl(m_loop_head);
+
+  // events pending, write the cached registers back and come back in through the block start
+  cg->mov(cg->dword[PTR(&g_state.pc)], m_block->pc);
+  FlushLoopRegisters();
+  cg->jmp(CodeCache::g_run_events_and_dispatch);
+}
+
 void CPU::X64Recompiler::EndBlockWithException(Exception excode)
 {
   // flush regs, but not pc, it's going to get overwritten
@@ -898,6 +953,24 @@ void CPU::X64Recompiler::GeneratePGXPCallWithMIPSRegs(const void* func, u32 arg1
   cg->call(func);
 }
 
+void CPU::X64Recompiler::GeneratePGXPMove(Reg dst, Reg src)
+{
+  PGXPValue& src_val = g_state.pgxp_gpr[static_cast<u8>(src)];
+  PGXPValue& dst_val = g_state.pgxp_gpr[static_cast<u8>(dst)];
+
+  // flags = (src.value == value) ? src.flags : 0, written back to both
+  MoveMIPSRegToReg(RWARG1, dst);
+  cg->xor_(RWARG2, RWARG2);
+  cg->cmp(RWARG1, cg->dword[PTR(&src_val.value)]);
+  cg->cmove(RWARG2, cg->dword[PTR(&src_val.flags)]);
+  cg->mov(cg->dword[PTR(&src_val.flags)], RWARG2);
+  cg->mov(RXARG3, cg->qword[PTR(&src_val.x)]);
+  cg->mov(cg->qword[PTR(&dst_val.x)], RXARG3);
+  cg->mov(RXARG3, cg->qword[PTR(&src_val.z)]);
+  cg->mov(cg->qword[PTR(&dst_val.z)], RXARG3);
+  cg->mov(cg->dword[PTR(&dst_val.flags)], RWARG2);
+}
+
 void CPU::X64Recompiler::Flush(u32 flags)
 {
   Recompiler::Flush(flags);
@@ -2500,13 +2573,143 @@ void CPU::X64Recompiler::Compile_cop2(CompileFlags cf)
   TickCount func_ticks;
   GTE::InstructionImpl func = GTE::GetInstructionImpl(inst->bits, &func_ticks);
 
-  Flush(FLUSH_FOR_C_CALL);
-  cg->mov(RWARG1, inst->bits & GTE::Instruction::REQUIRED_BITS_MASK);
-  cg->call(reinterpret_cast<const void*>(func));
+  const GTEInlineCommand inline_command = GetGTEInlineCommand(inst->bits);
+  switch (inline_command)
+  {
+    case GTEInlineCommand::NCLIP:
+      Compile_gte_nclip();
+      break;
+
+    case GTEInlineCommand::AVSZ3:
+    case GTEInlineCommand::AVSZ4:
+      Compile_gte_avsz(inline_command == GTEInlineCommand::AVSZ4);
+      break;
+
+    case GTEInlineCommand::SQR:
+      Compile_gte_sqr(GTE::Instruction{inst->bits}.GetShift());
+      break;
+
+    default:
+    {
+      Flush(FLUSH_FOR_C_CALL);
+      cg->mov(RWARG1, inst->bits & GTE::Instruction::REQUIRED_BITS_MASK);
+      cg->call(reinterpret_cast<const void*>(func));
+    }
+    break;
+  }
 
   AddGTETicks(func_ticks);
 }
 
+void CPU::X64Recompiler::TestGTEMAC0Overflow(const Xbyak::Reg64& value, const Xbyak::Reg32& flags,
+                                             const Xbyak::Reg32& temp)
+{
+  // flags = (value != s32(value)) ? ((value < 0) ? underflow : overflow) : 0
+  Label done;
+  cg->xor_(flags, flags);
+  cg->movsxd(temp.cvt64(), Reg32(value.getIdx()));
+  cg->cmp(temp.cvt64(), value);
+  cg->je(done, CodeGenerator::T_SHORT);
+  cg->mov(flags, (1u << GTE_FLAG_MAC0_OVERFLOW_BIT) | (1u << GTE_FLAG_ERROR_BIT));
+  cg->mov(temp, (1u << GTE_FLAG_MAC0_UNDERFLOW_BIT) | (1u << GTE_FLAG_ERROR_BIT));
+  cg->test(value, value);
+  cg->cmovs(flags, temp);
+  cg->L(done);
+}
+
+void CPU::X64Recompiler::Compile_gte_nclip()
+{
+  // MAC0 = SX0*SY1 + SX1*SY2 + SX2*SY0 - SX0*SY2 - SX1*SY0 - SX2*SY1
+  //      = SX0*(SY1-SY2) + SX1*(SY2-SY0) + SX2*(SY0-SY1), which is exact in 64 bits.
+  const Reg64 acc = RXRET;
+  const Reg64 s1 = RXARG1;
+  const Reg64 s2 = RXARG2;
+  const Reg64 s3 = RXARG3;
+  cg->movsx(s1, cg->word[PTR(&g_state.gte_regs.SXY1[1])]);
+  cg->movsx(s2, cg->word[PTR(&g_state.gte_regs.SXY2[1])]);
+  cg->sub(s1, s2);
+  cg->movsx(acc, cg->word[PTR(&g_state.gte_regs.SXY0[0])]);
+  cg->imul(acc, s1);
+  cg->movsx(s1, cg->word[PTR(&g_state.gte_regs.SXY0[1])]);
+  cg->sub(s2, s1);
+  cg->movsx(s3, cg->word[PTR(&g_state.gte_regs.SXY1[0])]);
+  cg->imul(s3, s2);
+  cg->add(acc, s3);
+  cg->movsx(s2, cg->word[PTR(&g_state.gte_regs.SXY1[1])]);
+  cg->sub(s1, s2);
+  cg->movsx(s3, cg->word[PTR(&g_state.gte_regs.SXY2[0])]);
+  cg->imul(s3, s1);
+  cg->add(acc, s3);
+
+  cg->mov(cg->dword[PTR(&g_state.gte_regs.MAC0)], Reg32(acc.getIdx()));
+  TestGTEMAC0Overflow(acc, Reg32(s3.getIdx()), Reg32(s1.getIdx()));
+  cg->mov(cg->dword[PTR(&g_state.gte_regs.FLAG.bits)], Reg32(s3.getIdx()));
+}
+
+void CPU::X64Recompiler::Compile_gte_avsz(bool avsz4)
+{
+  // MAC0 = ZSF3*(SZ1+SZ2+SZ3) or ZSF4*(SZ0+SZ1+SZ2+SZ3), OTZ = MAC0 SAR 12 clamped to 0..FFFFh
+  const Reg64 acc = RXRET;
+  const Reg64 temp = RXARG1;
+  const Reg32 flags = RWARG2;
+  cg->movzx(RWRET, cg->word[PTR(&g_state.gte_regs.SZ1)]);
+  cg->movzx(RWARG1, cg->word[PTR(&g_state.gte_regs.SZ2)]);
+  cg->add(RWRET, RWARG1);
+  cg->movzx(RWARG1, cg->word[PTR(&g_state.gte_regs.SZ3)]);
+  cg->add(RWRET, RWARG1);
+  if (avsz4)
+  {
+    cg->movzx(RWARG1, cg->word[PTR(&g_state.gte_regs.SZ0)]);
+    cg->add(RWRET, RWARG1);
+  }
+  cg->movsx(temp, cg->word[PTR(avsz4 ? &g_state.gte_regs.ZSF4 : &g_state.gte_regs.ZSF3)]);
+  cg->imul(acc, temp);
+
+  cg->mov(cg->dword[PTR(&g_state.gte_regs.MAC0)], RWRET);
+  TestGTEMAC0Overflow(acc, flags, RWARG1);
+
+  Label otz_in_range;
+  cg->sar(acc, 12);
+  cg->cmp(acc, 0xFFFF);
+  cg->jbe(otz_in_range, CodeGenerator::T_SHORT);
+  cg->or_(flags, (1u << GTE_FLAG_SZ1_OTZ_SATURATED_BIT) | (1u << GTE_FLAG_ERROR_BIT));
+  cg->sar(acc, 63);
+  cg->not_(RWRET);
+  cg->and_(RWRET, 0xFFFF);
+  cg->L(otz_in_range);
+  cg->mov(cg->dword[PTR(&g_state.gte_regs.dr32[7])], RWRET);
+  cg->mov(cg->dword[PTR(&g_state.gte_regs.FLAG.bits)], flags);
+}
+
+void CPU::X64Recompiler::Compile_gte_sqr(u8 shift)
+{
+  // MAC1..3 = (IR1..3 * IR1..3) SAR shift, IR1..3 = MAC1..3 clamped. The squares are never negative.
+  static constexpr std::array<u32, 3> sat_flags = {
+    (1u << GTE_FLAG_IR1_SATURATED_BIT) | (1u << GTE_FLAG_ERROR_BIT),
+    (1u << GTE_FLAG_IR2_SATURATED_BIT) | (1u << GTE_FLAG_ERROR_BIT),
+    (1u << GTE_FLAG_IR3_SATURATED_BIT),
+  };
+
+  const Reg32 flags = RWARG2;
+  cg->xor_(flags, flags);
+  for (u32 i = 0; i < 3; i++)
+  {
+    Label ir_in_range;
+    cg->movsx(RWRET, cg->word[PTR(&g_state.gte_regs.r32[9 + i])]);
+    cg->imul(RWRET, RWRET);
+    if (shift > 0)
+      cg->sar(RWRET, shift);
+    cg->mov(cg->dword[PTR(&g_state.gte_regs.r32[25 + i])], RWRET);
+    cg->cmp(RWRET, 0x7FFF);
+    cg->jle(ir_in_range, CodeGenerator::T_SHORT);
+    cg->mov(RWRET, 0x7FFF);
+    cg->or_(flags, sat_flags[i]);
+    cg->L(ir_in_range);
+    cg->mov(cg->dword[PTR(&g_state.gte_regs.r32[9 + i])], RWRET);
+  }
+  cg->mov(cg->dword[PTR(&g_state.gte_regs.FLAG.bits)], flags);
+}
+
 u32 CPU::Recompiler::CompileLoadStoreThunk(void* thunk_code, u32 thunk_space, void* code_address, u32 code_size,
                                            TickCount cycles_to_add, TickCount cycles_to_remove, u32 gpr_bitmask,
                                            u8 address_register, u8 data_register, MemoryAccessSize size, bool is_signed,
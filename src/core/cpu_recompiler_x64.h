@@ -44,6 +44,8 @@ protected:
   void GenerateCall(const void* func, s32 arg1reg = -1, s32 arg2reg = -1, s32 arg3reg = -1) override;
   void EndBlock(const std::optional<u32>& newpc, bool do_event_test) override;
   void EndBlockWithException(Exception excode) override;
+  bool SupportsLoopRegisterCache() const override;
+  void EndLoopBackEdge() override;
   void EndAndLinkBlock(const std::optional<u32>& newpc, bool do_event_test, bool force_run_events);
   const void* EndCompile(u32* code_size, u32* far_code_size) override;
 
@@ -122,9 +124,14 @@ protected:
   void Compile_mfc2(CompileFlags cf) override;
   void Compile_mtc2(CompileFlags cf) override;
   void Compile_cop2(CompileFlags cf) override;
+  void Compile_gte_nclip();
+  void Compile_gte_avsz(bool avsz4);
+  void Compile_gte_sqr(u8 shift);
+  void TestGTEMAC0Overflow(const Xbyak::Reg64& value, const Xbyak::Reg32& flags, const Xbyak::Reg32& temp);
 
   void GeneratePGXPCallWithMIPSRegs(const void* func, u32 arg1val, Reg arg2reg = Reg::count,
                                     Reg arg3reg = Reg::count) override;
+  void GeneratePGXPMove(Reg dst, Reg src) override;
 
 private:
   void SwitchToFarCode(bool emit_jump, void (Xbyak::CodeGenerator::*jump_op)(const void*) = nullptr);
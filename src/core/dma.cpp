@@ -48,6 +48,7 @@ static constexpr PhysicalMemoryAddress LINKED_LIST_TERMINATOR = UINT32_C(0x00FFF
 
 static constexpr TickCount LINKED_LIST_HEADER_READ_TICKS = 8;
 static constexpr TickCount LINKED_LIST_BLOCK_SETUP_TICKS = 5;
+static constexpr u32 LINKED_LIST_BATCH_SIZE = 128;
 static constexpr TickCount SLICE_SIZE_WHEN_TRANSMITTING_PAD = 10;
 static constexpr TickCount SLICE_SIZE_WHEN_DECODING_MDEC = 100;
 
@@ -185,6 +186,8 @@ template<Channel channel>
 static bool TransferChannel();
 
 static bool IsLinkedListTerminator(PhysicalMemoryAddress address);
+static bool TransferGPULinkedListBatch(ChannelState& cs, PhysicalMemoryAddress* current_address,
+                                       TickCount* remaining_ticks);
 static bool CheckForBusError(Channel channel, ChannelState& cs, PhysicalMemoryAddress address, u32 size);
 static void CompleteTransfer(Channel channel, ChannelState& cs);
 
@@ -505,6 +508,94 @@ ALWAYS_INLINE_RELEASE bool DMA::IsLinkedListTerminator(PhysicalMemoryAddress add
   return ((address & LINKED_LIST_TERMINATOR) == LINKED_LIST_TERMINATOR);
 }
 
+bool DMA::TransferGPULinkedListBatch(ChannelState& cs, PhysicalMemoryAddress* current_address,
+                                     TickCount* remaining_ticks)
+{
+  // Walk as many nodes as fit in the remaining time first, so the headers are read in one tight loop. Nothing can
+  // write to RAM while this runs, and the list is walked again from the base address on the next slice, so changes
+  // made by the CPU in between are always seen. Anything unusual, i.e. bus errors, nodes which wrap around the end
+  // of RAM, reversed steps or dumping, is left to the node-by-node path.
+  struct Packet
+  {
+    PhysicalMemoryAddress data_address;
+    PhysicalMemoryAddress next_address;
+    u32 word_count;
+  };
+
+  if (cs.channel_control.address_step_reverse || g_gpu.GetGPUDump())
+    return false;
+
+  const u8* const ram_ptr = Bus::g_ram;
+  const u32 mask = Bus::g_ram_mask;
+  const u32 mapped_size = Bus::g_ram_mapped_size;
+
+  std::array<Packet, LINKED_LIST_BATCH_SIZE> packets;
+  u32 num_packets = 0;
+  TickCount batch_ticks = 0;
+  PhysicalMemoryAddress address = *current_address;
+  do
+  {
+    const PhysicalMemoryAddress transfer_addr = address & TRANSFER_ADDRESS_MASK;
+    if ((transfer_addr + sizeof(u32)) >= mapped_size)
+      break;
+
+    u32 header;
+    std::memcpy(&header, &ram_ptr[transfer_addr & mask], sizeof(header));
+    const u32 word_count = header >> 24;
+    const PhysicalMemoryAddress data_address = (transfer_addr + sizeof(header)) & mask;
+    if (word_count > 0 && ((transfer_addr + ((word_count - 1) * sizeof(u32))) >= mapped_size ||
+                           (data_address + (word_count * sizeof(u32))) > (mask + 1)))
+    {
+      break;
+    }
+
+    address = header & 0x00FFFFFFu;
+    packets[num_packets++] = {data_address, address, word_count};
+    batch_ticks += LINKED_LIST_HEADER_READ_TICKS;
+    if (word_count > 0)
+      batch_ticks += LINKED_LIST_BLOCK_SETUP_TICKS + Bus::GetDMARAMTickCount(word_count);
+  } while (num_packets < LINKED_LIST_BATCH_SIZE && batch_ticks < *remaining_ticks && !IsLinkedListTerminator(address));
+
+  if (num_packets == 0)
+    return false;
+
+  // Each packet still has to be executed before the next is sent, the GPU's request can drop at any point.
+  const bool gpu_accepts_dma = g_gpu.BeginDMAWrite();
+  for (u32 i = 0; i < num_packets; i++)
+  {
+    const Packet& packet = packets[i];
+    TRACE_LOG(" .. linked list entry at 0x{:08X} size={}({} words) next=0x{:08X}", *current_address,
+              packet.word_count * 4, packet.word_count, packet.next_address);
+
+    const TickCount setup_ticks = (packet.word_count > 0) ?
+                                    (LINKED_LIST_HEADER_READ_TICKS + LINKED_LIST_BLOCK_SETUP_TICKS) :
+                                    LINKED_LIST_HEADER_READ_TICKS;
+    CPU::AddPendingTicks(setup_ticks);
+    *remaining_ticks -= setup_ticks;
+
+    if (packet.word_count > 0)
+    {
+      if (gpu_accepts_dma) [[likely]]
+      {
+        g_gpu.DMAWrite(packet.data_address,
+                       std::span<const u32>(reinterpret_cast<const u32*>(&ram_ptr[packet.data_address]),
+                                            packet.word_count));
+        g_gpu.EndDMAWrite();
+      }
+
+      const TickCount block_ticks = Bus::GetDMARAMTickCount(packet.word_count);
+      CPU::AddPendingTicks(block_ticks);
+      *remaining_ticks -= block_ticks;
+    }
+
+    *current_address = packet.next_address;
+    if (!cs.request)
+      break;
+  }
+
+  return true;
+}
+
 ALWAYS_INLINE_RELEASE bool DMA::CheckForBusError(Channel channel, ChannelState& cs, PhysicalMemoryAddress address,
                                                  u32 size)
 {
@@ -609,6 +700,21 @@ bool DMA::TransferChannel()
       TickCount remaining_ticks = slice_ticks;
       while (cs.request && remaining_ticks > 0)
       {
+        if constexpr (channel == Channel::GPU)
+        {
+          if (TransferGPULinkedListBatch(cs, &current_address, &remaining_ticks))
+          {
+            if (IsLinkedListTerminator(current_address))
+            {
+              cs.base_address = LINKED_LIST_TERMINATOR;
+              CompleteTransfer(channel, cs);
+              return true;
+            }
+
+            continue;
+          }
+        }
+
         u32 header;
         PhysicalMemoryAddress transfer_addr = current_address & TRANSFER_ADDRESS_MASK;
         if (CheckForBusError(channel, cs, transfer_addr, sizeof(header))) [[unlikely]]
@@ -839,13 +945,21 @@ TickCount DMA::TransferMemoryToDevice(u32 address, u32 increment, u32 word_count
           dump->EndGP0Packet();
         }
 
-        u8* ram_pointer = Bus::g_ram;
-        for (u32 i = 0; i < word_count; i++)
+        if (increment == sizeof(u32) && (address + (word_count * sizeof(u32))) <= (mask + 1)) [[likely]]
         {
-          u32 value;
-          std::memcpy(&value, &ram_pointer[address], sizeof(u32));
-          g_gpu.DMAWrite(address, value);
-          address = (address + increment) & mask;
+          // Forward block which doesn't wrap, hand it to the GPU in one go.
+          g_gpu.DMAWrite(address, std::span<const u32>(src_pointer, word_count));
+        }
+        else
+        {
+          u8* ram_pointer = Bus::g_ram;
+          for (u32 i = 0; i < word_count; i++)
+          {
+            u32 value;
+            std::memcpy(&value, &ram_pointer[address], sizeof(u32));
+            g_gpu.DMAWrite(address, value);
+            address = (address + increment) & mask;
+          }
         }
         g_gpu.EndDMAWrite();
       }
@@ -910,12 +1024,7 @@ TickCount DMA::TransferDeviceToMemory(u32 address, u32 increment, u32 word_count
   }
   else if constexpr (channel == Channel::CDROM)
   {
-    const u32 end_page = (address + (increment * word_count) - 1) >> HOST_PAGE_SHIFT;
-    for (u32 page = address >> HOST_PAGE_SHIFT; page <= end_page; page++)
-    {
-      if (Bus::IsRAMCodePage(page))
-        CPU::CodeCache::InvalidateBlocksWithPageIndex(page);
-    }
+    CPU::CodeCache::InvalidateBlocksInRange(address, increment * word_count);
   }
 
   // Read from device.
@@ -105,12 +105,15 @@ struct SaveStateListEntry
   time_t timestamp;
   s32 slot;
   bool global;
+  bool preview_pending; // Screenshot is loaded when the entry is first drawn.
 };
 
 static void InitializePlaceholderSaveStateListEntry(SaveStateListEntry* li, s32 slot, bool global);
 static bool InitializeSaveStateListEntryFromSerial(SaveStateListEntry* li, const std::string& serial, s32 slot,
-                                                   bool global);
-static bool InitializeSaveStateListEntryFromPath(SaveStateListEntry* li, std::string path, s32 slot, bool global);
+                                                   bool global, bool defer_preview = false);
+static bool InitializeSaveStateListEntryFromPath(SaveStateListEntry* li, std::string path, s32 slot, bool global,
+                                                 bool defer_preview = false);
+static void LoadSaveStateListEntryPreview(SaveStateListEntry* li);
 static void ClearSaveStateEntryList();
 static u32 PopulateSaveStateListEntries(const std::string& serial, std::optional<ExtendedSaveStateInfo> undo_save_state,
                                         bool is_loading);
@@ -1726,13 +1729,14 @@ void FullscreenUI::InitializePlaceholderSaveStateListEntry(SaveStateListEntry* l
   li->slot = slot;
   li->preview_texture = {};
   li->global = global;
+  li->preview_pending = false;
 }
 
 bool FullscreenUI::InitializeSaveStateListEntryFromSerial(SaveStateListEntry* li, const std::string& serial, s32 slot,
-                                                          bool global)
+                                                          bool global, bool defer_preview)
 {
   const std::string path = (global ? System::GetGlobalSaveStatePath(slot) : System::GetGameSaveStatePath(serial, slot));
-  if (!InitializeSaveStateListEntryFromPath(li, path.c_str(), slot, global))
+  if (!InitializeSaveStateListEntryFromPath(li, path.c_str(), slot, global, defer_preview))
   {
     InitializePlaceholderSaveStateListEntry(li, slot, global);
     return false;
@@ -1741,9 +1745,10 @@ bool FullscreenUI::InitializeSaveStateListEntryFromSerial(SaveStateListEntry* li
   return true;
 }
 
-bool FullscreenUI::InitializeSaveStateListEntryFromPath(SaveStateListEntry* li, std::string path, s32 slot, bool global)
+bool FullscreenUI::InitializeSaveStateListEntryFromPath(SaveStateListEntry* li, std::string path, s32 slot, bool global,
+                                                        bool defer_preview)
 {
-  std::optional<ExtendedSaveStateInfo> ssi(System::GetExtendedSaveStateInfo(path.c_str()));
+  std::optional<ExtendedSaveStateInfo> ssi(System::GetExtendedSaveStateInfo(path.c_str(), !defer_preview));
   if (!ssi.has_value())
     return false;
 
@@ -1763,12 +1768,22 @@ bool FullscreenUI::InitializeSaveStateListEntryFromPath(SaveStateListEntry* li,
   li->state_path = std::move(path);
   li->game_path = std::move(ssi->media_path);
   li->global = global;
+  li->preview_pending = defer_preview;
   if (ssi->screenshot.IsValid())
     li->preview_texture = g_gpu_device->FetchAndUploadTextureImage(ssi->screenshot);
 
   return true;
 }
 
+void FullscreenUI::LoadSaveStateListEntryPreview(SaveStateListEntry* li)
+{
+  li->preview_pending = false;
+
+  std::optional<ExtendedSaveStateInfo> ssi(System::GetExtendedSaveStateInfo(li->state_path.c_str()));
+  if (ssi.has_value() && ssi->screenshot.IsValid())
+    li->preview_texture = g_gpu_device->FetchAndUploadTextureImage(ssi->screenshot);
+}
+
 void FullscreenUI::ClearSaveStateEntryList()
 {
   for (SaveStateListEntry& entry : s_locals.save_state_selector_slots)
@@ -1786,7 +1801,7 @@ u32 FullscreenUI::PopulateSaveStateListEntries(const std::string& serial,
 
   if (undo_save_state.has_value())
   {
-    SaveStateListEntry li;
+    SaveStateListEntry li = {};
     li.title = FSUI_STR("Undo Load State");
     li.summary = fmt::format(FSUI_FSTR("Saved {}"), Host::FormatNumber(Host::NumberFormatType::ShortDateTime,
                                                                        static_cast<s64>(undo_save_state->timestamp)));
@@ -1800,7 +1815,7 @@ u32 FullscreenUI::PopulateSaveStateListEntries(const std::string& serial,
     for (s32 i = 1; i <= System::PER_GAME_SAVE_STATE_SLOTS; i++)
     {
       SaveStateListEntry li;
-      if (InitializeSaveStateListEntryFromSerial(&li, serial, i, false) || !is_loading)
+      if (InitializeSaveStateListEntryFromSerial(&li, serial, i, false, true) || !is_loading)
         s_locals.save_state_selector_slots.push_back(std::move(li));
     }
   }
@@ -1808,7 +1823,7 @@ u32 FullscreenUI::PopulateSaveStateListEntries(const std::string& serial,
   for (s32 i = 1; i <= System::GLOBAL_SAVE_STATE_SLOTS; i++)
   {
     SaveStateListEntry li;
-    if (InitializeSaveStateListEntryFromSerial(&li, serial, i, true) || !is_loading)
+    if (InitializeSaveStateListEntryFromSerial(&li, serial, i, true, true) || !is_loading)
       s_locals.save_state_selector_slots.push_back(std::move(li));
   }
 
@@ -1887,6 +1902,7 @@ void FullscreenUI::DrawSaveStateSelector()
   const ImVec2 heading_size = ImVec2(
     io.DisplaySize.x, UIStyle.LargeFontSize + (LayoutScale(LAYOUT_MENU_BUTTON_Y_PADDING) * 2.0f) + LayoutScale(2.0f));
   SaveStateListEntry* pressed_entry = nullptr;
+  bool loaded_preview = false;
   bool closed = false;
 
   // last state deleted?
@@ -1964,6 +1980,13 @@ void FullscreenUI::DrawSaveStateSelector()
         bb.Min += style.FramePadding;
         bb.Max -= style.FramePadding;
 
+        // Only decode screenshots for slots which are on screen, and one per frame so opening the list stays quick.
+        if (entry.preview_pending && !loaded_preview)
+        {
+          LoadSaveStateListEntryPreview(&entry);
+          loaded_preview = true;
+        }
+
         GPUTexture* const screenshot =
           entry.preview_texture ? entry.preview_texture.get() : GetCachedTextureAsync("no-save.png");
         const ImRect image_rect(
@@ -13,6 +13,7 @@
 
 #include "common/error.h"
 #include "common/file_system.h"
+#include "common/frame_arena.h"
 #include "common/path.h"
 #include "common/string_util.h"
 
@@ -154,8 +155,14 @@ void FullscreenUI::PopulateGameListEntryList()
   const bool reverse = Core::GetBaseBoolSettingValue("Main", "FullscreenUIGameSortReverse", false);
   const bool merge_disc_sets = Core::GetBaseBoolSettingValue("Main", "FullscreenUIMergeDiscSets", true);
 
-  s_game_list_locals.game_list_sorted_entries.clear();
-  s_game_list_locals.game_list_sorted_entries.reserve(GameList::GetEntryCount());
+  // This runs every frame, so fold the start of each title once up front, rather than in every comparison.
+  struct SortEntry
+  {
+    u64 title_key;
+    const GameList::Entry* entry;
+  };
+  FrameVector<SortEntry> sort_entries;
+  sort_entries.reserve(GameList::GetEntryCount());
   for (const GameList::Entry& entry : GameList::GetEntries())
   {
     if (merge_disc_sets)
@@ -169,11 +176,13 @@ void FullscreenUI::PopulateGameListEntryList()
         continue;
     }
 
-    s_game_list_locals.game_list_sorted_entries.push_back(&entry);
+    sort_entries.push_back(SortEntry{StringUtil::GetNoCaseSortKey(entry.GetSortTitle()), &entry});
   }
 
-  std::sort(s_game_list_locals.game_list_sorted_entries.begin(), s_game_list_locals.game_list_sorted_entries.end(),
-            [sort, reverse](const GameList::Entry* lhs, const GameList::Entry* rhs) {
+  std::sort(sort_entries.begin(), sort_entries.end(),
+            [sort, reverse](const SortEntry& lhs_sort, const SortEntry& rhs_sort) {
+              const GameList::Entry* const lhs = lhs_sort.entry;
+              const GameList::Entry* const rhs = rhs_sort.entry;
               switch (sort)
               {
                 case 0: // Type
@@ -269,6 +278,8 @@ void FullscreenUI::PopulateGameListEntryList()
               }
 
               // fallback to title when all else is equal
+              if (lhs_sort.title_key != rhs_sort.title_key)
+                return reverse ? (lhs_sort.title_key > rhs_sort.title_key) : (lhs_sort.title_key < rhs_sort.title_key);
               const int res = StringUtil::CompareNoCase(lhs->GetSortTitle(), rhs->GetSortTitle());
               if (res != 0)
                 return reverse ? (res > 0) : (res < 0);
@@ -276,6 +287,11 @@ void FullscreenUI::PopulateGameListEntryList()
               // fallback to path when all else is equal
               return reverse ? (lhs->path > rhs->path) : (lhs->path < rhs->path);
             });
+
+  s_game_list_locals.game_list_sorted_entries.clear();
+  s_game_list_locals.game_list_sorted_entries.reserve(sort_entries.size());
+  for (const SortEntry& sort_entry : sort_entries)
+    s_game_list_locals.game_list_sorted_entries.push_back(sort_entry.entry);
 }
 
 void FullscreenUI::DrawGameListWindow()
@@ -26,6 +26,7 @@
 #include "common/assert.h"
 #include "common/error.h"
 #include "common/file_system.h"
+#include "common/frame_arena.h"
 #include "common/log.h"
 #include "common/path.h"
 #include "common/string_util.h"
@@ -2343,9 +2344,17 @@ void FullscreenUI::DrawInterfaceSettingsPage()
     bsi, FSUI_ICONVSTR(ICON_PF_CPU_PROCESSOR, "Show CPU Usage"),
     FSUI_VSTR("Shows the host's CPU usage of each system thread in the top-right corner of the display."), "Display",
     "ShowCPU", false);
+  DrawToggleSetting(bsi, FSUI_ICONVSTR(ICON_FA_CHART_BAR, "Show CPU Time Breakdown"),
+                    FSUI_VSTR("Shows how the CPU thread's time is split between the emulated subsystems in the "
+                              "top-right corner of the display."),
+                    "Display", "ShowCPUBreakdown", false);
   DrawToggleSetting(bsi, FSUI_ICONVSTR(ICON_PF_GPU_GRAPHICS_CARD, "Show GPU Usage"),
                     FSUI_VSTR("Shows the host's GPU usage in the top-right corner of the display."), "Display",
                     "ShowGPU", false);
+  DrawToggleSetting(bsi, FSUI_ICONVSTR(ICON_FA_CHART_BAR, "Show GPU Time Breakdown"),
+                    FSUI_VSTR("Shows the most expensive rendering passes on the host GPU in the top-right corner of "
+                              "the display."),
+                    "Display", "ShowGPUBreakdown", false);
   DrawToggleSetting(bsi, FSUI_ICONVSTR(ICON_FA_WAVE_SQUARE, "Show Frame Times"),
                     FSUI_VSTR("Shows a visual history of frame times in the upper-left corner of the display."),
                     "Display", "ShowFrameTimes", false);
@@ -2924,6 +2933,12 @@ void FullscreenUI::DrawEmulationSettingsPage()
     FSUI_VSTR("Skips the presentation/display of frames that are not unique. Can result in worse frame pacing."),
     "Display", "SkipPresentingDuplicateFrames", false);
 
+  DrawToggleSetting(
+    bsi, FSUI_ICONVSTR(ICON_FA_MUSIC, "Audio-Only PSF Playback"),
+    FSUI_VSTR("Uses the software renderer and only refreshes the display a few times a second when playing PSF "
+              "files, reducing power usage."),
+    "Main", "PSFAudioOnly", false);
+
   const bool optimal_frame_pacing_active = GetEffectiveBoolSetting(bsi, "Display", "OptimalFramePacing", false);
   DrawToggleSetting(
     bsi, FSUI_ICONVSTR(ICON_FA_STOPWATCH_20, "Reduce Input Latency"),
@@ -2956,6 +2971,25 @@ void FullscreenUI::DrawEmulationSettingsPage()
                               "usage. Especially useful when upscaling."),
                     "GPU", "UseSoftwareRendererForMemoryStates", false, rewind_enabled);
 
+  DrawToggleSetting(bsi, FSUI_ICONVSTR(ICON_FA_DOWN_LEFT_AND_UP_RIGHT_TO_CENTER, "Save VRAM at Native Resolution"),
+                    FSUI_VSTR("Keeps a native resolution copy of VRAM in system memory for rewind states, instead of "
+                              "a texture at the upscaled resolution. Upscaled detail is lost after rewinding."),
+                    "GPU", "NativeResolutionMemoryStates", false,
+                    rewind_enabled && !runahead_enabled &&
+                      !GetEffectiveBoolSetting(bsi, "GPU", "UseSoftwareRendererForMemoryStates", false));
+
+  DrawToggleSetting(bsi, FSUI_ICONVSTR(ICON_FA_COMPRESS, "Compress Rewind States"),
+                    FSUI_VSTR("Stores rewind states as differences from the next state, allowing many more saves in "
+                              "the same amount of memory."),
+                    "Main", "RewindCompressStates", false, rewind_enabled && !runahead_enabled);
+
+  DrawToggleSetting(bsi, FSUI_ICONVSTR(ICON_FA_LAYER_GROUP, "Tiered Rewind History"),
+                    FSUI_VSTR("Keeps older rewind saves further apart, allowing rewinding much further back in the "
+                              "same amount of memory."),
+                    "Main", "RewindTieredStates", false,
+                    rewind_enabled && !runahead_enabled &&
+                      !GetEffectiveBoolSetting(bsi, "Main", "RewindCompressStates", false));
+
   DrawFloatRangeSetting(
     bsi, FSUI_ICONVSTR(ICON_FA_FLOPPY_DISK, "Rewind Save Frequency"),
     FSUI_VSTR("How often a rewind state will be created. Higher frequencies have greater system requirements."), "Main",
@@ -2991,7 +3025,9 @@ void FullscreenUI::DrawEmulationSettingsPage()
     const u32 resolution_scale = GetEffectiveUIntSetting(bsi, "GPU", "ResolutionScale", 1);
     const u32 multisamples = GetEffectiveUIntSetting(bsi, "GPU", "Multisamples", 1);
     const bool use_software_renderer = GetEffectiveBoolSetting(bsi, "GPU", "UseSoftwareRendererForMemoryStates", false);
+    const bool native_resolution_vram = GetEffectiveBoolSetting(bsi, "GPU", "NativeResolutionMemoryStates", false);
     const bool enable_8mb_ram = GetEffectiveBoolSetting(bsi, "Console", "Enable8MBRAM", false);
+    const bool compress_states = GetEffectiveBoolSetting(bsi, "Main", "RewindCompressStates", false);
     const float rewind_frequency = GetEffectiveFloatSetting(bsi, "Main", "RewindFrequency", 10.0f);
     const s32 rewind_save_slots = GetEffectiveIntSetting(bsi, "Main", "RewindSaveSlots", 10);
     const float duration =
@@ -3000,7 +3036,8 @@ void FullscreenUI::DrawEmulationSettingsPage()
 
     u64 ram_usage, vram_usage;
     System::CalculateRewindMemoryUsage(rewind_save_slots, resolution_scale, multisamples, use_software_renderer,
-                                       enable_8mb_ram, &ram_usage, &vram_usage);
+                                       native_resolution_vram, enable_8mb_ram, compress_states, &ram_usage,
+                                       &vram_usage);
     if (vram_usage > 0)
     {
       rewind_summary.format(
@@ -3480,7 +3517,10 @@ void FullscreenUI::DrawControllerSettingsPage()
       TinyString pretty_binds_string;
       if (!binds_string.empty())
       {
-        for (const std::string_view& bind : StringUtil::SplitString(binds_string, '&', true))
+        // Runs every frame for every macro, so keep the split off the heap.
+        FrameVector<std::string_view> binds;
+        StringUtil::SplitStringInto(binds, binds_string, '&', true);
+        for (const std::string_view& bind : binds)
         {
           std::string_view dispname;
           for (const Controller::ControllerBindingInfo& bi : ci->bindings)
@@ -3764,7 +3804,7 @@ void FullscreenUI::DrawGraphicsSettingsPage()
       GetEffectiveTinyStringSetting(bsi, "GPU", "Renderer", Settings::GetRendererName(Settings::DEFAULT_GPU_RENDERER))
         .c_str())
       .value_or(Settings::DEFAULT_GPU_RENDERER);
-  const bool is_hardware = (renderer != GPURenderer::Software);
+  const bool is_hardware = Settings::IsHardwareRenderer(renderer);
 
   std::optional<SmallString> current_adapter =
     bsi->GetOptionalSmallStringValue("GPU", "Adapter", game_settings ? std::nullopt : std::optional<const char*>(""));
@@ -3820,12 +3860,21 @@ void FullscreenUI::DrawGraphicsSettingsPage()
                        FSUI_VSTR("Upscales the game's rendering by the specified multiplier."), "GPU",
                        "ResolutionScale", 1, resolution_scales);
 
+    DrawToggleSetting(bsi, FSUI_ICONVSTR(ICON_FA_GAUGE, "Dynamic Resolution"),
+                      FSUI_VSTR("Lowers the internal resolution in demanding scenes to keep the GPU within the frame "
+                                "time budget. The resolution above is used as the upper limit."),
+                      "GPU", "DynamicResolutionScale", false);
+    DrawIntRangeSetting(bsi, FSUI_ICONVSTR(ICON_FA_COMPRESS, "Minimum Dynamic Resolution"),
+                        FSUI_VSTR("Lowest resolution scale that dynamic resolution will step down to."), "GPU",
+                        "DynamicResolutionScaleMinimum", 1, 1, 16, FSUI_CSTR("%dx"),
+                        GetEffectiveBoolSetting(bsi, "GPU", "DynamicResolutionScale", false));
+
     DrawEnumSetting(bsi, FSUI_ICONVSTR(ICON_FA_COMPRESS, "Downsampling"),
                     FSUI_VSTR("Downsamples the rendered image prior to displaying it. Can improve "
                               "overall image quality in mixed 2D/3D games."),
                     "GPU", "DownsampleMode", Settings::DEFAULT_GPU_DOWNSAMPLE_MODE, &Settings::ParseDownsampleModeName,
                     &Settings::GetDownsampleModeName, &Settings::GetDownsampleModeDisplayName, GPUDownsampleMode::Count,
-                    (renderer != GPURenderer::Software));
+                    Settings::IsHardwareRenderer(renderer));
     if (Settings::ParseDownsampleModeName(
           GetEffectiveTinyStringSetting(bsi, "GPU", "DownsampleMode",
                                         Settings::GetDownsampleModeName(Settings::DEFAULT_GPU_DOWNSAMPLE_MODE))
@@ -4193,6 +4242,13 @@ void FullscreenUI::DrawGraphicsSettingsPage()
                     ((texture_cache_enabled &&
                       GetEffectiveBoolSetting(bsi, "TextureReplacements", "EnableTextureReplacements", false)) ||
                      GetEffectiveBoolSetting(bsi, "TextureReplacements", "EnableVRAMWriteReplacements", false)));
+  DrawToggleSetting(bsi, FSUI_ICONVSTR(ICON_FA_HOURGLASS, "Load Replacement Textures Asynchronously"),
+                    FSUI_VSTR("Decodes replacement textures in the background, using the original texture until the "
+                              "replacement is ready."),
+                    "TextureReplacements", "AsyncLoadTextures", false,
+                    ((texture_cache_enabled &&
+                      GetEffectiveBoolSetting(bsi, "TextureReplacements", "EnableTextureReplacements", false)) ||
+                     GetEffectiveBoolSetting(bsi, "TextureReplacements", "EnableVRAMWriteReplacements", false)));
 
   DrawToggleSetting(bsi, FSUI_ICONVSTR(ICON_FA_FILE_IMPORT, "Enable Texture Replacements"),
                     FSUI_VSTR("Enables loading of replacement textures. Not compatible with all games."),
@@ -4693,6 +4749,12 @@ void FullscreenUI::DrawPostProcessingSettingsPage()
 
 void FullscreenUI::DrawAudioSettingsPage()
 {
+  static constexpr const std::array output_sample_rate_names = {
+    FSUI_NSTR("Match Emulation (44100 Hz)"), FSUI_NSTR("48000 Hz"),  FSUI_NSTR("88200 Hz"),
+    FSUI_NSTR("96000 Hz"),                   FSUI_NSTR("192000 Hz"),
+  };
+  static constexpr const std::array output_sample_rate_values = {0, 48000, 88200, 96000, 192000};
+
   SettingsInterface* bsi = GetEditingSettingsInterface();
 
   BeginMenuButtons();
@@ -4706,6 +4768,10 @@ void FullscreenUI::DrawAudioSettingsPage()
   DrawIntRangeSetting(bsi, FSUI_ICONVSTR(ICON_FA_FORWARD, "Fast Forward Volume"),
                       FSUI_VSTR("Controls the volume of the audio played on the host when fast forwarding."), "Audio",
                       "FastForwardVolume", 100, 0, 200, "%d%%");
+  DrawIntRangeSetting(bsi, FSUI_ICONVSTR(ICON_FA_FORWARD_FAST, "Skip Audio Above Speed"),
+                      FSUI_VSTR("Stops producing audio when running at or above this speed, to reduce the cost of fast "
+                                "forwarding. Set to 0% to always produce audio."),
+                      "Audio", "SkipOutputSpeed", 0, 0, 1000, "%d%%");
   DrawToggleSetting(bsi, FSUI_ICONVSTR(ICON_FA_VOLUME_XMARK, "Mute All Sound"),
                     FSUI_VSTR("Prevents the emulator from producing any audible sound."), "Audio", "OutputMuted",
                     false);
@@ -4726,6 +4792,11 @@ void FullscreenUI::DrawAudioSettingsPage()
                   AudioStreamParameters::DEFAULT_STRETCH_MODE, &CoreAudioStream::ParseStretchMode,
                   &CoreAudioStream::GetStretchModeName, &CoreAudioStream::GetStretchModeDisplayName,
                   AudioStretchMode::Count);
+  DrawIntListSetting(bsi, FSUI_ICONVSTR(ICON_FA_WAVE_SQUARE, "Output Sample Rate"),
+                     FSUI_VSTR("Opens the audio device at this rate, converting the output with a high quality "
+                               "resampler."),
+                     "Audio", "OutputSampleRate", AudioStreamParameters::DEFAULT_OUTPUT_SAMPLE_RATE,
+                     output_sample_rate_names, true, output_sample_rate_values);
   DrawIntRangeSetting(bsi, FSUI_ICONVSTR(ICON_FA_BUCKET, "Buffer Size"),
                       FSUI_VSTR("Determines the amount of audio buffered before being pulled by the host API."),
                       "Audio", "BufferMS", AudioStreamParameters::DEFAULT_BUFFER_MS, 10, 500, FSUI_CSTR("%d ms"));
@@ -4741,6 +4812,10 @@ void FullscreenUI::DrawAudioSettingsPage()
   DrawToggleSetting(bsi, FSUI_ICONVSTR(ICON_FA_STOPWATCH, "Minimal Output Latency"),
                     FSUI_VSTR("When enabled, the minimum supported output latency will be used for the host API."),
                     "Audio", "OutputLatencyMinimal", AudioStreamParameters::DEFAULT_OUTPUT_LATENCY_MINIMAL);
+  DrawToggleSetting(bsi, FSUI_ICONVSTR(ICON_FA_GAUGE_HIGH, "Low Latency Mode"),
+                    FSUI_VSTR("Buffers only as much audio as the host requests, adjusting playback rate slightly to "
+                              "stay on target."),
+                    "Audio", "LowLatency", AudioStreamParameters::DEFAULT_LOW_LATENCY);
 
   EndMenuButtons();
 }
@@ -5210,6 +5285,10 @@ void FullscreenUI::DrawAdvancedSettingsPage()
                   "SaveStateCompression", Settings::DEFAULT_SAVE_STATE_COMPRESSION_MODE,
                   &Settings::ParseSaveStateCompressionModeName, &Settings::GetSaveStateCompressionModeName,
                   &Settings::GetSaveStateCompressionModeDisplayName, SaveStateCompressionMode::Count);
+  DrawToggleSetting(
+    bsi, FSUI_VSTR("Uncompressed Resume States"),
+    FSUI_VSTR("Saves resume states without compression, so resuming a game is quicker at the cost of disk space."),
+    "Main", "UncompressedResumeStates", false);
 
   DrawEnumSetting(bsi, FSUI_VSTR("Wireframe Rendering"),
                   FSUI_VSTR("Overlays or replaces normal triangle drawing with a wireframe/line view."), "GPU",
@@ -5226,6 +5305,14 @@ void FullscreenUI::DrawAdvancedSettingsPage()
     bsi, FSUI_VSTR("Enable Recompiler Block Linking"),
     FSUI_VSTR("Performance enhancement - jumps directly between blocks instead of returning to the dispatcher."), "CPU",
     "RecompilerBlockLinking", true);
+  DrawToggleSetting(
+    bsi, FSUI_VSTR("Enable Recompiler Block Cache"),
+    FSUI_VSTR("Stores analysed blocks on disk per-game, reducing stutter when code is first executed."), "CPU",
+    "RecompilerBlockCache", false);
+  DrawToggleSetting(
+    bsi, FSUI_VSTR("Enable Recompiler Trace Formation"),
+    FSUI_VSTR("Compiles code following unconditional jumps into the same block, reducing block dispatch overhead."),
+    "CPU", "RecompilerTraceFormation", false);
   DrawEnumSetting(bsi, FSUI_VSTR("Recompiler Fast Memory Access"),
                   FSUI_VSTR("Avoids calls to C++ code, significantly speeding up the recompiler."), "CPU",
                   "FastmemMode", Settings::DEFAULT_CPU_FASTMEM_MODE, &Settings::ParseCPUFastmemMode,
@@ -5262,6 +5349,10 @@ void FullscreenUI::DrawAdvancedSettingsPage()
     FSUI_VSTR("Allows booting to continue even without a required SBI file. These games will not run correctly."),
     "CDROM", "AllowBootingWithoutSBIFile", false);
 
+  DrawToggleSetting(bsi, FSUI_VSTR("Decode MDEC Macroblocks On Worker Thread"),
+                    FSUI_VSTR("Moves FMV decoding off the CPU thread. Output is identical."), "Hacks", "MDECUseThread",
+                    false);
+
   EndMenuButtons();
 }
 
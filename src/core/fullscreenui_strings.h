@@ -24,6 +24,7 @@ TRANSLATE_NOOP("FullscreenUI", "%d Frames");
 TRANSLATE_NOOP("FullscreenUI", "%d cycles");
 TRANSLATE_NOOP("FullscreenUI", "%d ms");
 TRANSLATE_NOOP("FullscreenUI", "%d sectors");
+TRANSLATE_NOOP("FullscreenUI", "%dx");
 TRANSLATE_NOOP("FullscreenUI", "%g seconds");
 TRANSLATE_NOOP("FullscreenUI", "%u MB");
 TRANSLATE_NOOP("FullscreenUI", "-");
@@ -42,6 +43,7 @@ TRANSLATE_NOOP("FullscreenUI", "150% [90 FPS (NTSC) / 75 FPS (PAL)]");
 TRANSLATE_NOOP("FullscreenUI", "15x");
 TRANSLATE_NOOP("FullscreenUI", "16x");
 TRANSLATE_NOOP("FullscreenUI", "175% [105 FPS (NTSC) / 87 FPS (PAL)]");
+TRANSLATE_NOOP("FullscreenUI", "192000 Hz");
 TRANSLATE_NOOP("FullscreenUI", "1x");
 TRANSLATE_NOOP("FullscreenUI", "2 Frames");
 TRANSLATE_NOOP("FullscreenUI", "20% [12 FPS (NTSC) / 10 FPS (PAL)]");
@@ -60,6 +62,7 @@ TRANSLATE_NOOP("FullscreenUI", "4 Frames");
 TRANSLATE_NOOP("FullscreenUI", "40% [24 FPS (NTSC) / 20 FPS (PAL)]");
 TRANSLATE_NOOP("FullscreenUI", "400% [240 FPS (NTSC) / 200 FPS (PAL)]");
 TRANSLATE_NOOP("FullscreenUI", "450% [270 FPS (NTSC) / 225 FPS (PAL)]");
+TRANSLATE_NOOP("FullscreenUI", "48000 Hz");
 TRANSLATE_NOOP("FullscreenUI", "4x");
 TRANSLATE_NOOP("FullscreenUI", "4x (8x Speed)");
 TRANSLATE_NOOP("FullscreenUI", "5 Frames");
@@ -81,10 +84,12 @@ TRANSLATE_NOOP("FullscreenUI", "7x");
 TRANSLATE_NOOP("FullscreenUI", "8 Frames");
 TRANSLATE_NOOP("FullscreenUI", "80% [48 FPS (NTSC) / 40 FPS (PAL)]");
 TRANSLATE_NOOP("FullscreenUI", "800% [480 FPS (NTSC) / 400 FPS (PAL)]");
+TRANSLATE_NOOP("FullscreenUI", "88200 Hz");
 TRANSLATE_NOOP("FullscreenUI", "8x");
 TRANSLATE_NOOP("FullscreenUI", "9 Frames");
 TRANSLATE_NOOP("FullscreenUI", "90% [54 FPS (NTSC) / 45 FPS (PAL)]");
 TRANSLATE_NOOP("FullscreenUI", "900% [540 FPS (NTSC) / 450 FPS (PAL)]");
+TRANSLATE_NOOP("FullscreenUI", "96000 Hz");
 TRANSLATE_NOOP("FullscreenUI", "9x (for 4K)");
 TRANSLATE_NOOP("FullscreenUI", "<Parent Directory>");
 TRANSLATE_NOOP("FullscreenUI", "<Use This Directory>");
@@ -126,6 +131,7 @@ TRANSLATE_NOOP("FullscreenUI", "Attempts to map the selected port to a chosen co
 TRANSLATE_NOOP("FullscreenUI", "Audio Backend");
 TRANSLATE_NOOP("FullscreenUI", "Audio Control");
 TRANSLATE_NOOP("FullscreenUI", "Audio Settings");
+TRANSLATE_NOOP("FullscreenUI", "Audio-Only PSF Playback");
 TRANSLATE_NOOP("FullscreenUI", "Auto-Detect");
 TRANSLATE_NOOP("FullscreenUI", "Automatic");
 TRANSLATE_NOOP("FullscreenUI", "Automatic Mapping");
@@ -154,6 +160,7 @@ TRANSLATE_NOOP("FullscreenUI", "Border Overlay");
 TRANSLATE_NOOP("FullscreenUI", "Borderless Fullscreen");
 TRANSLATE_NOOP("FullscreenUI", "Bottom: ");
 TRANSLATE_NOOP("FullscreenUI", "Buffer Size");
+TRANSLATE_NOOP("FullscreenUI", "Buffers only as much audio as the host requests, adjusting playback rate slightly to stay on target.");
 TRANSLATE_NOOP("FullscreenUI", "Buttons");
 TRANSLATE_NOOP("FullscreenUI", "CD-ROM Emulation");
 TRANSLATE_NOOP("FullscreenUI", "CPU Emulation");
@@ -184,6 +191,7 @@ TRANSLATE_NOOP("FullscreenUI", "Cobalt Sky");
 TRANSLATE_NOOP("FullscreenUI", "Compatibility Rating");
 TRANSLATE_NOOP("FullscreenUI", "Compatibility: ");
 TRANSLATE_NOOP("FullscreenUI", "Completely exits the application, returning you to your desktop.");
+TRANSLATE_NOOP("FullscreenUI", "Compress Rewind States");
 TRANSLATE_NOOP("FullscreenUI", "Configuration");
 TRANSLATE_NOOP("FullscreenUI", "Confirm Game Close");
 TRANSLATE_NOOP("FullscreenUI", "Console Settings");
@@ -220,6 +228,7 @@ TRANSLATE_NOOP("FullscreenUI", "Dark");
 TRANSLATE_NOOP("FullscreenUI", "Dark Ruby");
 TRANSLATE_NOOP("FullscreenUI", "Deadzone");
 TRANSLATE_NOOP("FullscreenUI", "Debugging Settings");
+TRANSLATE_NOOP("FullscreenUI", "Decode MDEC Macroblocks On Worker Thread");
 TRANSLATE_NOOP("FullscreenUI", "Default");
 TRANSLATE_NOOP("FullscreenUI", "Default Boot");
 TRANSLATE_NOOP("FullscreenUI", "Default Value");
@@ -291,6 +300,7 @@ TRANSLATE_NOOP("FullscreenUI", "DuckStation can automatically download covers fo
 TRANSLATE_NOOP("FullscreenUI", "DuckStation is a free simulator/emulator of the Sony PlayStation(TM) console, focusing on playability, speed, and long-term maintainability.");
 TRANSLATE_NOOP("FullscreenUI", "Dump Replaced Textures");
 TRANSLATE_NOOP("FullscreenUI", "Dumps textures that have replacements already loaded.");
+TRANSLATE_NOOP("FullscreenUI", "Dynamic Resolution");
 TRANSLATE_NOOP("FullscreenUI", "Emulation Settings");
 TRANSLATE_NOOP("FullscreenUI", "Emulation Speed");
 TRANSLATE_NOOP("FullscreenUI", "Enable 8MB RAM");
@@ -429,6 +439,8 @@ TRANSLATE_NOOP("FullscreenUI", "Inhibit Screensaver");
 TRANSLATE_NOOP("FullscreenUI", "Input Sources");
 TRANSLATE_NOOP("FullscreenUI", "Interface Settings");
 TRANSLATE_NOOP("FullscreenUI", "Internal Resolution");
+TRANSLATE_NOOP("FullscreenUI", "Keeps a native resolution copy of VRAM in system memory for rewind states, instead of a texture at the upscaled resolution. Upscaled detail is lost after rewinding.");
+TRANSLATE_NOOP("FullscreenUI", "Keeps older rewind saves further apart, allowing rewinding much further back in the same amount of memory.");
 TRANSLATE_NOOP("FullscreenUI", "Language");
 TRANSLATE_NOOP("FullscreenUI", "Language: ");
 TRANSLATE_NOOP("FullscreenUI", "Last Played");
@@ -470,8 +482,12 @@ TRANSLATE_NOOP("FullscreenUI", "Logs BIOS calls to printf(). Not all games conta
 TRANSLATE_NOOP("FullscreenUI", "Logs messages to duckstation.log in the user directory.");
 TRANSLATE_NOOP("FullscreenUI", "Logs messages to the console window.");
 TRANSLATE_NOOP("FullscreenUI", "Logs messages to the debug console where supported.");
+TRANSLATE_NOOP("FullscreenUI", "Low Latency Mode");
+TRANSLATE_NOOP("FullscreenUI", "Lowers the internal resolution in demanding scenes to keep the GPU within the frame time budget. The resolution above is used as the upper limit.");
+TRANSLATE_NOOP("FullscreenUI", "Lowest resolution scale that dynamic resolution will step down to.");
 TRANSLATE_NOOP("FullscreenUI", "Macro {}");
 TRANSLATE_NOOP("FullscreenUI", "Makes games run closer to their console framerate, at a small cost to performance.");
+TRANSLATE_NOOP("FullscreenUI", "Match Emulation (44100 Hz)");
 TRANSLATE_NOOP("FullscreenUI", "Maximum (Safer)");
 TRANSLATE_NOOP("FullscreenUI", "Maximum Read Speedup Cycles");
 TRANSLATE_NOOP("FullscreenUI", "Maximum Seek Speedup Cycles");
@@ -486,8 +502,10 @@ TRANSLATE_NOOP("FullscreenUI", "Merge Multi-Disc Games");
 TRANSLATE_NOOP("FullscreenUI", "Merges multi-disc games into one item in the game list.");
 TRANSLATE_NOOP("FullscreenUI", "Message Location");
 TRANSLATE_NOOP("FullscreenUI", "Minimal Output Latency");
+TRANSLATE_NOOP("FullscreenUI", "Minimum Dynamic Resolution");
 TRANSLATE_NOOP("FullscreenUI", "Move Down");
 TRANSLATE_NOOP("FullscreenUI", "Move Up");
+TRANSLATE_NOOP("FullscreenUI", "Moves FMV decoding off the CPU thread. Output is identical.");
 TRANSLATE_NOOP("FullscreenUI", "Moves this shader higher in the chain, applying it earlier.");
 TRANSLATE_NOOP("FullscreenUI", "Moves this shader lower in the chain, applying it later.");
 TRANSLATE_NOOP("FullscreenUI", "Multitap");
@@ -521,10 +539,12 @@ TRANSLATE_NOOP("FullscreenUI", "On-Screen Display Message Durations");
 TRANSLATE_NOOP("FullscreenUI", "Open Containing Directory");
 TRANSLATE_NOOP("FullscreenUI", "Open To Game List");
 TRANSLATE_NOOP("FullscreenUI", "Open in File Browser");
+TRANSLATE_NOOP("FullscreenUI", "Opens the audio device at this rate, converting the output with a high quality resampler.");
 TRANSLATE_NOOP("FullscreenUI", "Operations");
 TRANSLATE_NOOP("FullscreenUI", "Optimal Frame Pacing");
 TRANSLATE_NOOP("FullscreenUI", "Options");
 TRANSLATE_NOOP("FullscreenUI", "Output Latency");
+TRANSLATE_NOOP("FullscreenUI", "Output Sample Rate");
 TRANSLATE_NOOP("FullscreenUI", "Output Volume");
 TRANSLATE_NOOP("FullscreenUI", "Overclocking Percentage");
 TRANSLATE_NOOP("FullscreenUI", "Overlays or replaces normal triangle drawing with a wireframe/line view.");
@@ -635,6 +655,7 @@ TRANSLATE_NOOP("FullscreenUI", "Save Screenshot");
 TRANSLATE_NOOP("FullscreenUI", "Save State");
 TRANSLATE_NOOP("FullscreenUI", "Save State Compression");
 TRANSLATE_NOOP("FullscreenUI", "Save State On Game Close");
+TRANSLATE_NOOP("FullscreenUI", "Save VRAM at Native Resolution");
 TRANSLATE_NOOP("FullscreenUI", "Save as Serial File Names");
 TRANSLATE_NOOP("FullscreenUI", "Saved {}");
 TRANSLATE_NOOP("FullscreenUI", "Saves state periodically so you can rewind any mistakes while playing.");
@@ -695,6 +716,7 @@ TRANSLATE_NOOP("FullscreenUI", "Shader {} added as stage {}.");
 TRANSLATE_NOOP("FullscreenUI", "Shared Card Name");
 TRANSLATE_NOOP("FullscreenUI", "Show Achievement Trophy Icons");
 TRANSLATE_NOOP("FullscreenUI", "Show All");
+TRANSLATE_NOOP("FullscreenUI", "Show CPU Time Breakdown");
 TRANSLATE_NOOP("FullscreenUI", "Show CPU Usage");
 TRANSLATE_NOOP("FullscreenUI", "Show Controller Input");
 TRANSLATE_NOOP("FullscreenUI", "Show Enhancement Settings");
@@ -716,6 +738,7 @@ TRANSLATE_NOOP("FullscreenUI", "Shows a popup in the selected location when prog
 TRANSLATE_NOOP("FullscreenUI", "Shows a timer in the selected location when leaderboard challenges are active.");
 TRANSLATE_NOOP("FullscreenUI", "Shows a visual history of frame times in the upper-left corner of the display.");
 TRANSLATE_NOOP("FullscreenUI", "Shows enhancement settings in the bottom-right corner of the screen.");
+TRANSLATE_NOOP("FullscreenUI", "Shows how the CPU thread's time is split between the emulated subsystems in the top-right corner of the display.");
 TRANSLATE_NOOP("FullscreenUI", "Shows information about input and audio latency in the top-right corner of the display.");
 TRANSLATE_NOOP("FullscreenUI", "Shows information about the emulated GPU in the top-right corner of the display.");
 TRANSLATE_NOOP("FullscreenUI", "Shows on-screen-display messages when events occur. Errors and warnings are still displayed regardless of this setting.");
@@ -732,6 +755,7 @@ TRANSLATE_NOOP("FullscreenUI", "Shows trophy icons in game grid when games have
 TRANSLATE_NOOP("FullscreenUI", "Simulates the region check present in original, unmodified consoles.");
 TRANSLATE_NOOP("FullscreenUI", "Simulates the system ahead of time and rolls back/replays to reduce input lag. Very high system requirements.");
 TRANSLATE_NOOP("FullscreenUI", "Size: ");
+TRANSLATE_NOOP("FullscreenUI", "Skip Audio Above Speed");
 TRANSLATE_NOOP("FullscreenUI", "Skip Duplicate Frame Display");
 TRANSLATE_NOOP("FullscreenUI", "Skips the presentation/display of frames that are not unique. Can result in worse frame pacing.");
 TRANSLATE_NOOP("FullscreenUI", "Slow Boot");
@@ -759,6 +783,8 @@ TRANSLATE_NOOP("FullscreenUI", "Start Fullscreen");
 TRANSLATE_NOOP("FullscreenUI", "Start Game");
 TRANSLATE_NOOP("FullscreenUI", "Start a game from a disc in your PC's DVD drive.");
 TRANSLATE_NOOP("FullscreenUI", "Start the console without any disc inserted.");
+TRANSLATE_NOOP("FullscreenUI", "Stops producing audio when running at or above this speed, to reduce the cost of fast forwarding. Set to 0% to always produce audio.");
+TRANSLATE_NOOP("FullscreenUI", "Stores rewind states as differences from the next state, allowing many more saves in the same amount of memory.");
 TRANSLATE_NOOP("FullscreenUI", "Stores the current settings to a controller preset.");
 TRANSLATE_NOOP("FullscreenUI", "Stretch Mode");
 TRANSLATE_NOOP("FullscreenUI", "Summary");
@@ -780,6 +806,7 @@ TRANSLATE_NOOP("FullscreenUI", "The selected memory card image will be used in s
 TRANSLATE_NOOP("FullscreenUI", "Theme");
 TRANSLATE_NOOP("FullscreenUI", "This game was not scanned by DuckStation. Some functionality is not available.");
 TRANSLATE_NOOP("FullscreenUI", "Threaded Rendering");
+TRANSLATE_NOOP("FullscreenUI", "Tiered Rewind History");
 TRANSLATE_NOOP("FullscreenUI", "Time Played");
 TRANSLATE_NOOP("FullscreenUI", "Time Played: ");
 TRANSLATE_NOOP("FullscreenUI", "Timing out in {:.0f} seconds...");
@@ -830,6 +857,7 @@ TRANSLATE_NOOP("FullscreenUI", "Uses perspective-correct interpolation for color
 TRANSLATE_NOOP("FullscreenUI", "Uses perspective-correct interpolation for texture coordinates, straightening out warped textures.");
 TRANSLATE_NOOP("FullscreenUI", "Uses screen positions to resolve PGXP data. May improve visuals in some games.");
 TRANSLATE_NOOP("FullscreenUI", "Uses separate game settings for each disc of multi-disc games. Can only be set on the first/main disc.");
+TRANSLATE_NOOP("FullscreenUI", "Uses the software renderer and only refreshes the display a few times a second when playing PSF files, reducing power usage.");
 TRANSLATE_NOOP("FullscreenUI", "Uses the software renderer when creating rewind states to prevent additional VRAM usage. Especially useful when upscaling.");
 TRANSLATE_NOOP("FullscreenUI", "Utilizes the chosen frame rate regardless of the game's setting.");
 TRANSLATE_NOOP("FullscreenUI", "Value Range");
@@ -10,6 +10,7 @@
 #include "util/imgui_manager.h"
 #include "util/translation.h"
 
+#include "common/align.h"
 #include "common/assert.h"
 #include "common/binary_reader_writer.h"
 #include "common/error.h"
@@ -23,13 +24,17 @@
 
 #include "ryml.hpp"
 
+#include <algorithm>
 #include <bit>
+#include <cstring>
 #include <iomanip>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <span>
 #include <sstream>
 #include <type_traits>
+#include <unordered_map>
 
 #include "IconsEmoji.h"
 #include "IconsFontAwesome.h"
@@ -42,15 +47,161 @@ namespace GameDatabase {
 enum : u32
 {
   GAME_DATABASE_CACHE_SIGNATURE = 0x45434C48,
-  GAME_DATABASE_CACHE_VERSION = 33,
+  GAME_DATABASE_CACHE_VERSION = 34,
+  TRACK_HASHES_CACHE_SIGNATURE = 0x44434448,
+  TRACK_HASHES_CACHE_VERSION = 1,
+  IMAGE_SECTION_ALIGNMENT = 8,
 };
 
+namespace {
+
+// The cache files are flat images which are mapped and used in place. Nothing is parsed when they're loaded, records
+// are only decoded into Entry/DiscSetEntry the first time something looks them up. Strings are stored as offsets into
+// a pool at the end of the image, and all the lookup tables are sorted for binary searching.
+struct ImageString
+{
+  u32 offset;
+  u32 length;
+};
+
+struct DatabaseImageHeader
+{
+  u32 signature;
+  u32 version;
+  u64 gamedb_ts;
+  u64 discsets_ts;
+  u32 num_entries;
+  u32 entries_offset;
+  u32 num_disc_sets;
+  u32 disc_sets_offset;
+  u32 num_disc_set_serials;
+  u32 disc_set_serials_offset;
+  u32 num_codes;
+  u32 codes_offset;
+  u32 strings_offset;
+  u32 strings_size;
+};
+
+// Sorted by serial.
+struct EntryRecord
+{
+  static constexpr u32 TRAIT_BYTES = (static_cast<u32>(Trait::MaxCount) + 7) / 8;
+  static constexpr u32 LANGUAGE_BYTES = (static_cast<u32>(Language::MaxCount) + 7) / 8;
+
+  ImageString serial;
+  ImageString title;
+  ImageString sort_title;
+  ImageString localized_title;
+  ImageString save_title;
+  ImageString genre;
+  ImageString developer;
+  ImageString publisher;
+  ImageString compatibility_version_tested;
+  ImageString compatibility_comments;
+  u64 release_date;
+  s32 disc_set_index;
+  u32 present_fields; // one bit per optional field, in ForEachOptionalField() order
+  u8 min_players;
+  u8 max_players;
+  u8 min_blocks;
+  u8 max_blocks;
+  u16 supported_controllers;
+  CompatibilityRating compatibility;
+  std::array<u8, TRAIT_BYTES> traits;
+  std::array<u8, LANGUAGE_BYTES> languages;
+
+  s16 display_active_start_offset;
+  s16 display_active_end_offset;
+  s8 display_line_start_offset;
+  s8 display_line_end_offset;
+  DisplayCropMode display_crop_mode;
+  DisplayDeinterlacingMode display_deinterlacing_mode;
+  GPULineDetectMode gpu_line_detect_mode;
+  u8 cpu_overclock;
+  bool gpu_pgxp_preserve_proj_fp;
+  u32 dma_max_slice_ticks;
+  u32 dma_halt_ticks;
+  u32 cdrom_max_seek_speedup_cycles;
+  u32 cdrom_max_read_speedup_cycles;
+  u32 gpu_fifo_size;
+  u32 gpu_max_run_ahead;
+  float gpu_pgxp_tolerance;
+  float gpu_pgxp_depth_threshold;
+};
+
+struct DiscSetRecord
+{
+  ImageString title;
+  ImageString sort_title;
+  ImageString localized_title;
+  ImageString save_title;
+  u32 first_serial; // index into disc set serials
+  u32 num_serials;
+};
+
+// Sorted by code.
+struct CodeRecord
+{
+  ImageString code;
+  u32 entry_index;
+};
+
+struct TrackHashesImageHeader
+{
+  u32 signature;
+  u32 version;
+  u64 discdb_ts;
+  u32 num_hashes;
+  u32 hashes_offset;
+  u32 strings_offset;
+  u32 strings_size;
+};
+
+// Sorted by hash, tracks with the same hash keep their disc database order.
+struct TrackHashRecord
+{
+  CDImageHasher::Hash hash;
+  ImageString serial;
+  ImageString revision_str;
+  u32 revision;
+};
+
+static_assert(std::is_trivially_copyable_v<EntryRecord> && std::is_trivially_copyable_v<TrackHashRecord>);
+static_assert(alignof(DatabaseImageHeader) <= IMAGE_SECTION_ALIGNMENT &&
+              alignof(TrackHashesImageHeader) <= IMAGE_SECTION_ALIGNMENT &&
+              alignof(EntryRecord) <= IMAGE_SECTION_ALIGNMENT && alignof(TrackHashRecord) <= IMAGE_SECTION_ALIGNMENT);
+
+/// Deduplicates strings while building an image, most of the genres/developers/publishers are repeated.
+class StringPoolBuilder
+{
+public:
+  ImageString Add(std::string_view str);
+
+  ALWAYS_INLINE const std::string& GetData() const { return m_data; }
+
+private:
+  std::string m_data;
+  UnorderedStringMap<u32> m_offsets;
+};
+
+} // namespace
+
 static const Entry* GetEntryForId(std::string_view code);
+static const Entry* GetDecodedEntry(u32 index);
+static const DiscSetEntry* GetDecodedDiscSet(u32 index);
+static std::string_view GetImageString(std::string_view strings, const ImageString& str);
+template<typename T>
+static bool GetImageSection(std::span<const u8> image, u32 offset, u32 count, std::span<const T>* records);
+static u32 AppendImageSection(std::vector<u8>& image, const void* data, size_t size);
+template<typename R, typename E, typename F>
+static void ForEachOptionalField(R& record, E& entry, const F& func);
 
 static void EnsureLoaded();
 static void Load();
-static bool LoadFromCache();
+static bool LoadFromCache(u64 gamedb_ts, u64 discsets_ts);
 static bool SaveToCache();
+static bool OpenDatabaseImage(std::span<const u8> image, u64 gamedb_ts, u64 discsets_ts);
+static bool BuildDatabaseImage(u64 gamedb_ts, u64 discsets_ts);
 
 static bool LoadGameDBYaml();
 static bool ParseYamlEntry(Entry* entry, const ryml::ConstNodeRef& value);
@@ -59,6 +210,8 @@ static bool ParseYamlCodes(UnorderedStringMap<std::string_view>& lookup, const r
                            std::string_view serial);
 static void BindDiscSetsToEntries();
 static bool LoadTrackHashes();
+static bool LoadTrackHashesFromCache(u64 discdb_ts);
+static bool OpenTrackHashesImage(std::span<const u8> image, u64 discdb_ts);
 
 static constexpr const std::array<const char*, static_cast<int>(CompatibilityRating::Count)>
   s_compatibility_rating_names = {{
@@ -113,6 +266,7 @@ static constexpr const std::array s_trait_names = {
   "ForcePGXPVertexCache",
   "ForcePGXPCPUMode",
   "ForceRecompilerICache",
+  "ForceRecompilerBlockOptimization",
   "ForceCDROMSubQSkew",
   "IsLibCryptProtected",
 };
@@ -151,6 +305,7 @@ static constexpr const std::array s_trait_display_names = {
   TRANSLATE_DISAMBIG_NOOP("GameDatabase", "Force PGXP Vertex Cache", "GameDatabase::Trait"),
   TRANSLATE_DISAMBIG_NOOP("GameDatabase", "Force PGXP CPU Mode", "GameDatabase::Trait"),
   TRANSLATE_DISAMBIG_NOOP("GameDatabase", "Force Recompiler ICache", "GameDatabase::Trait"),
+  TRANSLATE_DISAMBIG_NOOP("GameDatabase", "Force Recompiler Block Optimization", "GameDatabase::Trait"),
   TRANSLATE_DISAMBIG_NOOP("GameDatabase", "Force CD-ROM SubQ Skew", "GameDatabase::Trait"),
   TRANSLATE_DISAMBIG_NOOP("GameDatabase", "Is LibCrypt Protected", "GameDatabase::Trait"),
 };
@@ -166,6 +321,8 @@ static_assert(s_language_names.size() == static_cast<size_t>(Language::MaxCount)
 static constexpr const char* GAMEDB_YAML_FILENAME = "gamedb.yaml";
 static constexpr const char* DISCSETS_YAML_FILENAME = "discsets.yaml";
 static constexpr const char* DISCDB_YAML_FILENAME = "discdb.yaml";
+static constexpr const char* GAMEDB_CACHE_FILENAME = "gamedb.cache";
+static constexpr const char* DISCDB_CACHE_FILENAME = "discdb.cache";
 static DisplayDeinterlacingMode DEFAULT_DEINTERLACING_MODE = DisplayDeinterlacingMode::Adaptive;
 
 namespace {
@@ -174,16 +331,33 @@ struct State
   bool loaded;
   bool track_hashes_loaded;
 
-  DynamicHeapArray<u8> db_data;          // we take strings from the data, so store a copy
-  DynamicHeapArray<u8> disc_set_db_data; // if loaded from binary cache, this will be empty
-
+  // only used while the image is being built from the yaml files, strings point into the yaml data
+  DynamicHeapArray<u8> db_data;
+  DynamicHeapArray<u8> disc_set_db_data;
   std::vector<GameDatabase::Entry> entries;
   std::vector<GameDatabase::DiscSetEntry> disc_sets;
   UnorderedStringMap<u32> code_lookup;
 
-  TrackHashesMap track_hashes_map;
+  FileSystem::MappedFile db_cache_data; // image, when loaded from the cache
+  std::vector<u8> db_image_data;        // image, if it was built and couldn't be mapped from the cache
+  std::span<const EntryRecord> db_entries;
+  std::span<const DiscSetRecord> db_disc_sets;
+  std::span<const ImageString> db_disc_set_serials;
+  std::span<const CodeRecord> db_codes;
+  std::string_view db_strings;
+
+  FileSystem::MappedFile track_hashes_cache_data;
+  std::vector<u8> track_hashes_image_data;
+  std::span<const TrackHashRecord> track_hashes;
+  std::string_view track_hashes_strings;
+
+  // node-based, so pointers to decoded entries stay valid as more are added
+  std::mutex decode_mutex;
+  std::unordered_map<u32, GameDatabase::Entry> decoded_entries;
+  std::unordered_map<u32, GameDatabase::DiscSetEntry> decoded_disc_sets;
 
   std::once_flag load_once_flag;
+  std::once_flag track_hashes_once_flag;
 };
 } // namespace
 
@@ -203,29 +377,154 @@ void GameDatabase::Load()
 {
   Timer timer;
 
-  if (!LoadFromCache())
+  const u64 gamedb_ts = static_cast<u64>(Host::GetResourceFileTimestamp(GAMEDB_YAML_FILENAME, false).value_or(0));
+  const u64 discsets_ts = static_cast<u64>(Host::GetResourceFileTimestamp(DISCSETS_YAML_FILENAME, false).value_or(0));
+  if (!LoadFromCache(gamedb_ts, discsets_ts))
   {
+    if (LoadGameDBYaml() && BuildDatabaseImage(gamedb_ts, discsets_ts))
+      SaveToCache();
+
+    // everything we need was copied into the image
     s_state.entries = {};
+    s_state.disc_sets = {};
     s_state.code_lookup = {};
     s_state.db_data.deallocate();
     s_state.disc_set_db_data.deallocate();
-
-    if (LoadGameDBYaml())
-    {
-      SaveToCache();
-    }
-    else
-    {
-      s_state.entries = {};
-      s_state.code_lookup = {};
-      s_state.db_data.deallocate();
-      s_state.disc_set_db_data.deallocate();
-    }
   }
 
   s_state.loaded = true;
 
-  INFO_LOG("Database load of {} entries took {:.0f}ms.", s_state.entries.size(), timer.GetTimeMilliseconds());
+  INFO_LOG("Database load of {} entries took {:.0f}ms.", s_state.db_entries.size(), timer.GetTimeMilliseconds());
+}
+
+std::string_view GameDatabase::GetImageString(std::string_view strings, const ImageString& str)
+{
+  // records aren't validated on load, so a corrupted image gives empty strings rather than reading out of bounds
+  return (str.offset <= strings.size() && str.length <= (strings.size() - str.offset)) ?
+           strings.substr(str.offset, str.length) :
+           std::string_view();
+}
+
+template<typename T>
+bool GameDatabase::GetImageSection(std::span<const u8> image, u32 offset, u32 count, std::span<const T>* records)
+{
+  if ((offset % alignof(T)) != 0 || offset > image.size() || count > ((image.size() - offset) / sizeof(T)))
+    return false;
+
+  *records = std::span<const T>(reinterpret_cast<const T*>(image.data() + offset), count);
+  return true;
+}
+
+u32 GameDatabase::AppendImageSection(std::vector<u8>& image, const void* data, size_t size)
+{
+  const size_t offset = Common::AlignUpPow2(image.size(), IMAGE_SECTION_ALIGNMENT);
+  image.resize(offset + size);
+  if (size > 0)
+    std::memcpy(image.data() + offset, data, size);
+  return static_cast<u32>(offset);
+}
+
+GameDatabase::ImageString GameDatabase::StringPoolBuilder::Add(std::string_view str)
+{
+  if (str.empty())
+    return {};
+
+  if (const auto it = m_offsets.find(str); it != m_offsets.end())
+    return ImageString{it->second, static_cast<u32>(str.length())};
+
+  const u32 offset = static_cast<u32>(m_data.length());
+  m_data.append(str);
+  m_offsets.emplace(str, offset);
+  return ImageString{offset, static_cast<u32>(str.length())};
+}
+
+template<typename R, typename E, typename F>
+void GameDatabase::ForEachOptionalField(R& record, E& entry, const F& func)
+{
+  func(record.display_active_start_offset, entry.display_active_start_offset);
+  func(record.display_active_end_offset, entry.display_active_end_offset);
+  func(record.display_line_start_offset, entry.display_line_start_offset);
+  func(record.display_line_end_offset, entry.display_line_end_offset);
+  func(record.display_crop_mode, entry.display_crop_mode);
+  func(record.display_deinterlacing_mode, entry.display_deinterlacing_mode);
+  func(record.dma_max_slice_ticks, entry.dma_max_slice_ticks);
+  func(record.dma_halt_ticks, entry.dma_halt_ticks);
+  func(record.cdrom_max_seek_speedup_cycles, entry.cdrom_max_seek_speedup_cycles);
+  func(record.cdrom_max_read_speedup_cycles, entry.cdrom_max_read_speedup_cycles);
+  func(record.gpu_fifo_size, entry.gpu_fifo_size);
+  func(record.gpu_max_run_ahead, entry.gpu_max_run_ahead);
+  func(record.gpu_pgxp_tolerance, entry.gpu_pgxp_tolerance);
+  func(record.gpu_pgxp_depth_threshold, entry.gpu_pgxp_depth_threshold);
+  func(record.gpu_pgxp_preserve_proj_fp, entry.gpu_pgxp_preserve_proj_fp);
+  func(record.gpu_line_detect_mode, entry.gpu_line_detect_mode);
+  func(record.cpu_overclock, entry.cpu_overclock);
+}
+
+const GameDatabase::DiscSetEntry* GameDatabase::GetDecodedDiscSet(u32 index)
+{
+  if (const auto it = s_state.decoded_disc_sets.find(index); it != s_state.decoded_disc_sets.end())
+    return &it->second;
+
+  const DiscSetRecord& record = s_state.db_disc_sets[index];
+  DiscSetEntry& disc_set = s_state.decoded_disc_sets[index];
+  disc_set.title = GetImageString(s_state.db_strings, record.title);
+  disc_set.sort_title = GetImageString(s_state.db_strings, record.sort_title);
+  disc_set.localized_title = GetImageString(s_state.db_strings, record.localized_title);
+  disc_set.save_title = GetImageString(s_state.db_strings, record.save_title);
+  if (record.first_serial <= s_state.db_disc_set_serials.size() &&
+      record.num_serials <= (s_state.db_disc_set_serials.size() - record.first_serial))
+  {
+    disc_set.serials.reserve(record.num_serials);
+    for (const ImageString& serial : s_state.db_disc_set_serials.subspan(record.first_serial, record.num_serials))
+      disc_set.serials.push_back(GetImageString(s_state.db_strings, serial));
+  }
+
+  return &disc_set;
+}
+
+const GameDatabase::Entry* GameDatabase::GetDecodedEntry(u32 index)
+{
+  std::unique_lock lock(s_state.decode_mutex);
+  if (const auto it = s_state.decoded_entries.find(index); it != s_state.decoded_entries.end())
+    return &it->second;
+
+  const EntryRecord& record = s_state.db_entries[index];
+  Entry& entry = s_state.decoded_entries[index];
+  entry.serial = GetImageString(s_state.db_strings, record.serial);
+  entry.title = GetImageString(s_state.db_strings, record.title);
+  entry.sort_title = GetImageString(s_state.db_strings, record.sort_title);
+  entry.localized_title = GetImageString(s_state.db_strings, record.localized_title);
+  entry.save_title = GetImageString(s_state.db_strings, record.save_title);
+  entry.genre = GetImageString(s_state.db_strings, record.genre);
+  entry.developer = GetImageString(s_state.db_strings, record.developer);
+  entry.publisher = GetImageString(s_state.db_strings, record.publisher);
+  entry.compatibility_version_tested = GetImageString(s_state.db_strings, record.compatibility_version_tested);
+  entry.compatibility_comments = GetImageString(s_state.db_strings, record.compatibility_comments);
+  entry.disc_set = (record.disc_set_index >= 0 && static_cast<u32>(record.disc_set_index) < s_state.db_disc_sets.size()) ?
+                     GetDecodedDiscSet(static_cast<u32>(record.disc_set_index)) :
+                     nullptr;
+  entry.release_date = record.release_date;
+  entry.min_players = record.min_players;
+  entry.max_players = record.max_players;
+  entry.min_blocks = record.min_blocks;
+  entry.max_blocks = record.max_blocks;
+  entry.supported_controllers = record.supported_controllers;
+  entry.compatibility = (record.compatibility < CompatibilityRating::Count) ? record.compatibility :
+                                                                                CompatibilityRating::Unknown;
+
+  for (size_t i = 0; i < static_cast<size_t>(Trait::MaxCount); i++)
+    entry.traits[i] = ((record.traits[i / 8] & (1u << (i % 8))) != 0);
+  for (size_t i = 0; i < static_cast<size_t>(Language::MaxCount); i++)
+    entry.languages[i] = ((record.languages[i / 8] & (1u << (i % 8))) != 0);
+
+  u32 bit = 0;
+  ForEachOptionalField(record, entry, [&record, &bit](const auto& value, auto& field) {
+    if (record.present_fields & (1u << bit))
+      field = value;
+    bit++;
+  });
+
+  return &entry;
 }
 
 const GameDatabase::Entry* GameDatabase::GetEntryForId(std::string_view code)
@@ -235,8 +534,17 @@ const GameDatabase::Entry* GameDatabase::GetEntryForId(std::string_view code)
 
   EnsureLoaded();
 
-  auto iter = s_state.code_lookup.find(code);
-  return (iter != s_state.code_lookup.end()) ? &s_state.entries[iter->second] : nullptr;
+  const auto it = std::lower_bound(s_state.db_codes.begin(), s_state.db_codes.end(), code,
+                                   [](const CodeRecord& record, const std::string_view& search) {
+                                     return (GetImageString(s_state.db_strings, record.code) < search);
+                                   });
+  if (it == s_state.db_codes.end() || GetImageString(s_state.db_strings, it->code) != code ||
+      it->entry_index >= s_state.db_entries.size())
+  {
+    return nullptr;
+  }
+
+  return GetDecodedEntry(it->entry_index);
 }
 
 std::string GameDatabase::GetSerialForDisc(CDImage* image)
@@ -303,10 +611,14 @@ const GameDatabase::Entry* GameDatabase::GetEntryForSerial(std::string_view seri
 
   EnsureLoaded();
 
-  const auto it =
-    std::lower_bound(s_state.entries.cbegin(), s_state.entries.cend(), serial,
-                     [](const Entry& entry, const std::string_view& search) { return (entry.serial < search); });
-  return (it != s_state.entries.end() && it->serial == serial) ? &(*it) : nullptr;
+  const auto it = std::lower_bound(s_state.db_entries.begin(), s_state.db_entries.end(), serial,
+                                   [](const EntryRecord& record, const std::string_view& search) {
+                                     return (GetImageString(s_state.db_strings, record.serial) < search);
+                                   });
+  if (it == s_state.db_entries.end() || GetImageString(s_state.db_strings, it->serial) != serial)
+    return nullptr;
+
+  return GetDecodedEntry(static_cast<u32>(std::distance(s_state.db_entries.begin(), it)));
 }
 
 const char* GameDatabase::GetTraitName(Trait trait)
@@ -713,6 +1025,7 @@ void GameDatabase::Entry::ApplySettings(Settings& settings, bool display_osd_mes
 
     settings.gpu_resolution_scale = 1;
     settings.gpu_automatic_resolution_scale = false;
+    settings.gpu_dynamic_resolution_scale = false;
     settings.gpu_multisamples = 1;
   }
 
@@ -869,6 +1182,12 @@ void GameDatabase::Entry::ApplySettings(Settings& settings, bool display_osd_mes
     settings.cpu_recompiler_icache = true;
   }
 
+  if (HasTrait(Trait::ForceRecompilerBlockOptimization))
+  {
+    WARNING_LOG("Recompiler block optimization forced by compatibility settings.");
+    settings.cpu_recompiler_block_optimization = true;
+  }
+
   if (HasTrait(Trait::ForceCDROMSubQSkew))
   {
     WARNING_LOG("CD-ROM SubQ Skew forced by compatibility settings.");
@@ -1087,239 +1406,180 @@ std::string GameDatabase::Entry::GenerateCompatibilityReport() const
   return std::string(ret.view());
 }
 
-static std::string GetCacheFile()
-{
-  return Path::Combine(EmuFolders::Cache, "gamedb.cache");
-}
-
-bool GameDatabase::LoadFromCache()
+bool GameDatabase::LoadFromCache(u64 gamedb_ts, u64 discsets_ts)
 {
   Error error;
-  std::optional<DynamicHeapArray<u8>> db_data = FileSystem::ReadBinaryFile(GetCacheFile().c_str(), &error);
+  std::optional<FileSystem::MappedFile> db_data =
+    FileSystem::MapBinaryFile(Path::Combine(EmuFolders::Cache, GAMEDB_CACHE_FILENAME).c_str(), &error);
   if (!db_data.has_value())
   {
     DEV_LOG("Failed to read cache, loading full database: {}", error.GetDescription());
     return false;
   }
 
-  BinarySpanReader reader(db_data->cspan());
-  const u64 gamedb_ts = static_cast<u64>(Host::GetResourceFileTimestamp(GAMEDB_YAML_FILENAME, false).value_or(0));
-  const u64 discsets_ts = static_cast<u64>(Host::GetResourceFileTimestamp(DISCSETS_YAML_FILENAME, false).value_or(0));
+  if (!OpenDatabaseImage(db_data->cspan(), gamedb_ts, discsets_ts))
+    return false;
+
+  // the mapping doesn't move along with the object
+  s_state.db_cache_data = std::move(db_data.value());
+  return true;
+}
 
-  u32 signature, version, num_disc_set_entries, num_entries, num_codes;
-  u64 file_gamedb_ts, file_discsets_ts;
-  if (!reader.ReadU32(&signature) || !reader.ReadU32(&version) || !reader.ReadU64(&file_gamedb_ts) ||
-      !reader.ReadU64(&file_discsets_ts) || !reader.ReadU32(&num_disc_set_entries) || !reader.ReadU32(&num_entries) ||
-      !reader.ReadU32(&num_codes) || signature != GAME_DATABASE_CACHE_SIGNATURE ||
-      version != GAME_DATABASE_CACHE_VERSION)
+bool GameDatabase::OpenDatabaseImage(std::span<const u8> image, u64 gamedb_ts, u64 discsets_ts)
+{
+  DatabaseImageHeader header;
+  if (image.size() < sizeof(header))
   {
-    DEV_LOG("Cache header is corrupted or version mismatch.");
+    DEV_LOG("Cache header is corrupted.");
     return false;
   }
 
-  if (gamedb_ts != file_gamedb_ts || discsets_ts != file_discsets_ts)
+  std::memcpy(&header, image.data(), sizeof(header));
+  if (header.signature != GAME_DATABASE_CACHE_SIGNATURE || header.version != GAME_DATABASE_CACHE_VERSION)
   {
-    DEV_LOG("Cache is out of date, recreating.");
+    DEV_LOG("Cache header is corrupted or version mismatch.");
     return false;
   }
 
-  s_state.entries.reserve(num_entries);
-  s_state.disc_sets.reserve(num_disc_set_entries);
-
-  for (u32 i = 0; i < num_disc_set_entries; i++)
+  if (header.gamedb_ts != gamedb_ts || header.discsets_ts != discsets_ts)
   {
-    DiscSetEntry& disc_set = s_state.disc_sets.emplace_back();
-    u32 num_serials;
-    if (!reader.ReadSizePrefixedString(&disc_set.title) || !reader.ReadSizePrefixedString(&disc_set.sort_title) ||
-        !reader.ReadSizePrefixedString(&disc_set.localized_title) ||
-        !reader.ReadSizePrefixedString(&disc_set.save_title) || !reader.ReadU32(&num_serials))
-    {
-      DEV_LOG("Cache disc set entry is corrupted.");
-      return false;
-    }
-    if (num_serials > 0)
-    {
-      disc_set.serials.reserve(num_serials);
-      for (u32 j = 0; j < num_serials; j++)
-      {
-        if (!reader.ReadSizePrefixedString(&disc_set.serials.emplace_back()))
-        {
-          DEV_LOG("Cache disc set entry is corrupted.");
-          return false;
-        }
-      }
-    }
-  }
-
-  for (u32 i = 0; i < num_entries; i++)
-  {
-    Entry& entry = s_state.entries.emplace_back();
-
-    constexpr u32 trait_num_bytes = (static_cast<u32>(Trait::MaxCount) + 7) / 8;
-    constexpr u32 language_num_bytes = (static_cast<u32>(Language::MaxCount) + 7) / 8;
-    std::array<u8, trait_num_bytes> trait_bits;
-    std::array<u8, language_num_bytes> language_bits;
-    u8 compatibility;
-    s32 disc_set_index;
-
-    if (!reader.ReadSizePrefixedString(&entry.serial) || !reader.ReadSizePrefixedString(&entry.title) ||
-        !reader.ReadSizePrefixedString(&entry.sort_title) || !reader.ReadSizePrefixedString(&entry.localized_title) ||
-        !reader.ReadSizePrefixedString(&entry.save_title) || !reader.ReadSizePrefixedString(&entry.genre) ||
-        !reader.ReadSizePrefixedString(&entry.developer) || !reader.ReadSizePrefixedString(&entry.publisher) ||
-        !reader.ReadSizePrefixedString(&entry.compatibility_version_tested) ||
-        !reader.ReadSizePrefixedString(&entry.compatibility_comments) || !reader.ReadS32(&disc_set_index) ||
-        (disc_set_index >= 0 && static_cast<u32>(disc_set_index) >= num_disc_set_entries) ||
-        !reader.ReadU64(&entry.release_date) || !reader.ReadU8(&entry.min_players) ||
-        !reader.ReadU8(&entry.max_players) || !reader.ReadU8(&entry.min_blocks) || !reader.ReadU8(&entry.max_blocks) ||
-        !reader.ReadU16(&entry.supported_controllers) || !reader.ReadU8(&compatibility) ||
-        compatibility >= static_cast<u8>(GameDatabase::CompatibilityRating::Count) ||
-        !reader.Read(trait_bits.data(), trait_num_bytes) || !reader.Read(language_bits.data(), language_num_bytes) ||
-        !reader.ReadOptionalT(&entry.display_active_start_offset) ||
-        !reader.ReadOptionalT(&entry.display_active_end_offset) ||
-        !reader.ReadOptionalT(&entry.display_line_start_offset) ||
-        !reader.ReadOptionalT(&entry.display_line_end_offset) || !reader.ReadOptionalT(&entry.display_crop_mode) ||
-        !reader.ReadOptionalT(&entry.display_deinterlacing_mode) || !reader.ReadOptionalT(&entry.dma_max_slice_ticks) ||
-        !reader.ReadOptionalT(&entry.dma_halt_ticks) || !reader.ReadOptionalT(&entry.cdrom_max_seek_speedup_cycles) ||
-        !reader.ReadOptionalT(&entry.cdrom_max_read_speedup_cycles) || !reader.ReadOptionalT(&entry.gpu_fifo_size) ||
-        !reader.ReadOptionalT(&entry.gpu_max_run_ahead) || !reader.ReadOptionalT(&entry.gpu_pgxp_tolerance) ||
-        !reader.ReadOptionalT(&entry.gpu_pgxp_depth_threshold) ||
-        !reader.ReadOptionalT(&entry.gpu_pgxp_preserve_proj_fp) || !reader.ReadOptionalT(&entry.gpu_line_detect_mode) ||
-        !reader.ReadOptionalT(&entry.cpu_overclock))
-    {
-      DEV_LOG("Cache entry is corrupted.");
-      return false;
-    }
-
-    entry.disc_set = (disc_set_index >= 0) ? &s_state.disc_sets[static_cast<u32>(disc_set_index)] : nullptr;
-    entry.compatibility = static_cast<GameDatabase::CompatibilityRating>(compatibility);
-    entry.traits.reset();
-    for (size_t j = 0; j < static_cast<size_t>(Trait::MaxCount); j++)
-    {
-      if ((trait_bits[j / 8] & (1u << (j % 8))) != 0)
-        entry.traits[j] = true;
-    }
-    for (size_t j = 0; j < static_cast<size_t>(Language::MaxCount); j++)
-    {
-      if ((language_bits[j / 8] & (1u << (j % 8))) != 0)
-        entry.languages[j] = true;
-    }
+    DEV_LOG("Cache is out of date, recreating.");
+    return false;
   }
 
-  for (u32 i = 0; i < num_codes; i++)
+  std::span<const char> strings;
+  if (!GetImageSection(image, header.entries_offset, header.num_entries, &s_state.db_entries) ||
+      !GetImageSection(image, header.disc_sets_offset, header.num_disc_sets, &s_state.db_disc_sets) ||
+      !GetImageSection(image, header.disc_set_serials_offset, header.num_disc_set_serials,
+                       &s_state.db_disc_set_serials) ||
+      !GetImageSection(image, header.codes_offset, header.num_codes, &s_state.db_codes) ||
+      !GetImageSection(image, header.strings_offset, header.strings_size, &strings))
   {
-    std::string code;
-    u32 index;
-    if (!reader.ReadSizePrefixedString(&code) || !reader.ReadU32(&index) ||
-        index >= static_cast<u32>(s_state.entries.size()))
-    {
-      DEV_LOG("Cache code entry is corrupted.");
-      return false;
-    }
-
-    s_state.code_lookup.emplace(std::move(code), index);
+    DEV_LOG("Cache sections are corrupted.");
+    s_state.db_entries = {};
+    s_state.db_disc_sets = {};
+    s_state.db_disc_set_serials = {};
+    s_state.db_codes = {};
+    return false;
   }
 
-  s_state.db_data = std::move(db_data.value());
+  s_state.db_strings = std::string_view(strings.data(), strings.size());
   return true;
 }
 
-bool GameDatabase::SaveToCache()
+bool GameDatabase::BuildDatabaseImage(u64 gamedb_ts, u64 discsets_ts)
 {
-  const u64 gamedb_ts = static_cast<u64>(Host::GetResourceFileTimestamp(GAMEDB_YAML_FILENAME, false).value_or(0));
-  const u64 discsets_ts = static_cast<u64>(Host::GetResourceFileTimestamp(DISCSETS_YAML_FILENAME, false).value_or(0));
-
-  Error error;
-  FileSystem::AtomicRenamedFile file = FileSystem::CreateAtomicRenamedFile(GetCacheFile(), &error);
-  if (!file)
-  {
-    ERROR_LOG("Failed to open cache file for writing: {}", error.GetDescription());
-    return false;
-  }
-
-  BinaryFileWriter writer(file.get());
-  writer.WriteU32(GAME_DATABASE_CACHE_SIGNATURE);
-  writer.WriteU32(GAME_DATABASE_CACHE_VERSION);
-  writer.WriteU64(gamedb_ts);
-  writer.WriteU64(discsets_ts);
-
-  writer.WriteU32(static_cast<u32>(s_state.disc_sets.size()));
-  writer.WriteU32(static_cast<u32>(s_state.entries.size()));
-  writer.WriteU32(static_cast<u32>(s_state.code_lookup.size()));
+  StringPoolBuilder pool;
 
+  std::vector<DiscSetRecord> disc_set_records;
+  std::vector<ImageString> disc_set_serials;
+  disc_set_records.reserve(s_state.disc_sets.size());
   for (const DiscSetEntry& disc_set : s_state.disc_sets)
   {
-    writer.WriteSizePrefixedString(disc_set.title);
-    writer.WriteSizePrefixedString(disc_set.sort_title);
-    writer.WriteSizePrefixedString(disc_set.localized_title);
-    writer.WriteSizePrefixedString(disc_set.save_title);
-    writer.WriteU32(static_cast<u32>(disc_set.serials.size()));
+    DiscSetRecord& record = disc_set_records.emplace_back();
+    record.title = pool.Add(disc_set.title);
+    record.sort_title = pool.Add(disc_set.sort_title);
+    record.localized_title = pool.Add(disc_set.localized_title);
+    record.save_title = pool.Add(disc_set.save_title);
+    record.first_serial = static_cast<u32>(disc_set_serials.size());
+    record.num_serials = static_cast<u32>(disc_set.serials.size());
     for (const std::string_view& ds_serial : disc_set.serials)
-      writer.WriteSizePrefixedString(ds_serial);
+      disc_set_serials.push_back(pool.Add(ds_serial));
   }
 
+  std::vector<EntryRecord> entry_records;
+  entry_records.reserve(s_state.entries.size());
   for (const Entry& entry : s_state.entries)
   {
-    writer.WriteSizePrefixedString(entry.serial);
-    writer.WriteSizePrefixedString(entry.title);
-    writer.WriteSizePrefixedString(entry.sort_title);
-    writer.WriteSizePrefixedString(entry.localized_title);
-    writer.WriteSizePrefixedString(entry.save_title);
-    writer.WriteSizePrefixedString(entry.genre);
-    writer.WriteSizePrefixedString(entry.developer);
-    writer.WriteSizePrefixedString(entry.publisher);
-    writer.WriteSizePrefixedString(entry.compatibility_version_tested);
-    writer.WriteSizePrefixedString(entry.compatibility_comments);
-    writer.WriteS32(entry.disc_set ? static_cast<s32>(entry.disc_set - &s_state.disc_sets[0]) : -1);
-    writer.WriteU64(entry.release_date);
-    writer.WriteU8(entry.min_players);
-    writer.WriteU8(entry.max_players);
-    writer.WriteU8(entry.min_blocks);
-    writer.WriteU8(entry.max_blocks);
-    writer.WriteU16(entry.supported_controllers);
-    writer.WriteU8(static_cast<u8>(entry.compatibility));
-
-    constexpr u32 trait_num_bytes = (static_cast<u32>(Trait::MaxCount) + 7) / 8;
-    std::array<u8, trait_num_bytes> trait_bits = {};
-    for (size_t j = 0; j < static_cast<size_t>(Trait::MaxCount); j++)
+    EntryRecord& record = entry_records.emplace_back();
+    record.serial = pool.Add(entry.serial);
+    record.title = pool.Add(entry.title);
+    record.sort_title = pool.Add(entry.sort_title);
+    record.localized_title = pool.Add(entry.localized_title);
+    record.save_title = pool.Add(entry.save_title);
+    record.genre = pool.Add(entry.genre);
+    record.developer = pool.Add(entry.developer);
+    record.publisher = pool.Add(entry.publisher);
+    record.compatibility_version_tested = pool.Add(entry.compatibility_version_tested);
+    record.compatibility_comments = pool.Add(entry.compatibility_comments);
+    record.disc_set_index = entry.disc_set ? static_cast<s32>(entry.disc_set - s_state.disc_sets.data()) : -1;
+    record.release_date = entry.release_date;
+    record.min_players = entry.min_players;
+    record.max_players = entry.max_players;
+    record.min_blocks = entry.min_blocks;
+    record.max_blocks = entry.max_blocks;
+    record.supported_controllers = entry.supported_controllers;
+    record.compatibility = entry.compatibility;
+
+    for (size_t i = 0; i < static_cast<size_t>(Trait::MaxCount); i++)
     {
-      if (entry.traits[j])
-        trait_bits[j / 8] |= (1u << (j % 8));
+      if (entry.traits[i])
+        record.traits[i / 8] |= static_cast<u8>(1u << (i % 8));
     }
-
-    writer.Write(trait_bits.data(), trait_num_bytes);
-
-    constexpr u32 language_num_bytes = (static_cast<u32>(Language::MaxCount) + 7) / 8;
-    std::array<u8, language_num_bytes> language_bits = {};
-    for (size_t j = 0; j < static_cast<size_t>(Language::MaxCount); j++)
+    for (size_t i = 0; i < static_cast<size_t>(Language::MaxCount); i++)
     {
-      if (entry.languages[j])
-        language_bits[j / 8] |= (1u << (j % 8));
+      if (entry.languages[i])
+        record.languages[i / 8] |= static_cast<u8>(1u << (i % 8));
     }
-    writer.Write(language_bits.data(), language_num_bytes);
 
-    writer.WriteOptionalT(entry.display_active_start_offset);
-    writer.WriteOptionalT(entry.display_active_end_offset);
-    writer.WriteOptionalT(entry.display_line_start_offset);
-    writer.WriteOptionalT(entry.display_line_end_offset);
-    writer.WriteOptionalT(entry.display_crop_mode);
-    writer.WriteOptionalT(entry.display_deinterlacing_mode);
-    writer.WriteOptionalT(entry.dma_max_slice_ticks);
-    writer.WriteOptionalT(entry.dma_halt_ticks);
-    writer.WriteOptionalT(entry.cdrom_max_seek_speedup_cycles);
-    writer.WriteOptionalT(entry.cdrom_max_read_speedup_cycles);
-    writer.WriteOptionalT(entry.gpu_fifo_size);
-    writer.WriteOptionalT(entry.gpu_max_run_ahead);
-    writer.WriteOptionalT(entry.gpu_pgxp_tolerance);
-    writer.WriteOptionalT(entry.gpu_pgxp_depth_threshold);
-    writer.WriteOptionalT(entry.gpu_pgxp_preserve_proj_fp);
-    writer.WriteOptionalT(entry.gpu_line_detect_mode);
-    writer.WriteOptionalT(entry.cpu_overclock);
+    u32 bit = 0;
+    ForEachOptionalField(record, entry, [&record, &bit](auto& value, const auto& field) {
+      if (field.has_value())
+      {
+        value = field.value();
+        record.present_fields |= (1u << bit);
+      }
+      bit++;
+    });
+  }
+
+  std::vector<std::pair<std::string_view, u32>> sorted_codes(s_state.code_lookup.begin(), s_state.code_lookup.end());
+  std::sort(sorted_codes.begin(), sorted_codes.end());
+  std::vector<CodeRecord> code_records;
+  code_records.reserve(sorted_codes.size());
+  for (const auto& [code, index] : sorted_codes)
+    code_records.push_back(CodeRecord{pool.Add(code), index});
+
+  DatabaseImageHeader header = {};
+  header.signature = GAME_DATABASE_CACHE_SIGNATURE;
+  header.version = GAME_DATABASE_CACHE_VERSION;
+  header.gamedb_ts = gamedb_ts;
+  header.discsets_ts = discsets_ts;
+  header.num_entries = static_cast<u32>(entry_records.size());
+  header.num_disc_sets = static_cast<u32>(disc_set_records.size());
+  header.num_disc_set_serials = static_cast<u32>(disc_set_serials.size());
+  header.num_codes = static_cast<u32>(code_records.size());
+  header.strings_size = static_cast<u32>(pool.GetData().size());
+
+  std::vector<u8> image(sizeof(header));
+  header.entries_offset = AppendImageSection(image, entry_records.data(), entry_records.size() * sizeof(EntryRecord));
+  header.disc_sets_offset =
+    AppendImageSection(image, disc_set_records.data(), disc_set_records.size() * sizeof(DiscSetRecord));
+  header.disc_set_serials_offset =
+    AppendImageSection(image, disc_set_serials.data(), disc_set_serials.size() * sizeof(ImageString));
+  header.codes_offset = AppendImageSection(image, code_records.data(), code_records.size() * sizeof(CodeRecord));
+  header.strings_offset = AppendImageSection(image, pool.GetData().data(), pool.GetData().size());
+  std::memcpy(image.data(), &header, sizeof(header));
+
+  s_state.db_image_data = std::move(image);
+  if (!OpenDatabaseImage(s_state.db_image_data, gamedb_ts, discsets_ts))
+  {
+    ERROR_LOG("Failed to open newly-built database image.");
+    s_state.db_image_data = {};
+    return false;
   }
 
-  for (const auto& it : s_state.code_lookup)
+  return true;
+}
+
+bool GameDatabase::SaveToCache()
+{
+  Error error;
+  if (!FileSystem::WriteAtomicRenamedFile(Path::Combine(EmuFolders::Cache, GAMEDB_CACHE_FILENAME),
+                                          s_state.db_image_data, &error))
   {
-    writer.WriteSizePrefixedString(it.first);
-    writer.WriteU32(it.second);
+    ERROR_LOG("Failed to write cache file: {}", error.GetDescription());
+    return false;
   }
 
   return true;
@@ -1738,19 +1998,82 @@ bool GameDatabase::ParseYamlCodes(UnorderedStringMap<std::string_view>& lookup,
   return (added > 0);
 }
 
-void GameDatabase::EnsureTrackHashesMapLoaded()
+void GameDatabase::EnsureTrackHashesLoaded()
 {
   if (s_state.track_hashes_loaded)
     return;
 
-  s_state.track_hashes_loaded = true;
-  LoadTrackHashes();
+  std::call_once(s_state.track_hashes_once_flag, []() {
+    LoadTrackHashes();
+    s_state.track_hashes_loaded = true;
+  });
+}
+
+bool GameDatabase::LoadTrackHashesFromCache(u64 discdb_ts)
+{
+  Error error;
+  std::optional<FileSystem::MappedFile> data =
+    FileSystem::MapBinaryFile(Path::Combine(EmuFolders::Cache, DISCDB_CACHE_FILENAME).c_str(), &error);
+  if (!data.has_value())
+  {
+    DEV_LOG("Failed to read track hashes cache, loading full database: {}", error.GetDescription());
+    return false;
+  }
+
+  if (!OpenTrackHashesImage(data->cspan(), discdb_ts))
+    return false;
+
+  s_state.track_hashes_cache_data = std::move(data.value());
+  return true;
+}
+
+bool GameDatabase::OpenTrackHashesImage(std::span<const u8> image, u64 discdb_ts)
+{
+  TrackHashesImageHeader header;
+  if (image.size() < sizeof(header))
+  {
+    DEV_LOG("Track hashes cache header is corrupted.");
+    return false;
+  }
+
+  std::memcpy(&header, image.data(), sizeof(header));
+  if (header.signature != TRACK_HASHES_CACHE_SIGNATURE || header.version != TRACK_HASHES_CACHE_VERSION)
+  {
+    DEV_LOG("Track hashes cache header is corrupted or version mismatch.");
+    return false;
+  }
+
+  if (header.discdb_ts != discdb_ts)
+  {
+    DEV_LOG("Track hashes cache is out of date, recreating.");
+    return false;
+  }
+
+  std::span<const char> strings;
+  if (!GetImageSection(image, header.hashes_offset, header.num_hashes, &s_state.track_hashes) ||
+      !GetImageSection(image, header.strings_offset, header.strings_size, &strings))
+  {
+    DEV_LOG("Track hashes cache sections are corrupted.");
+    s_state.track_hashes = {};
+    return false;
+  }
+
+  s_state.track_hashes_strings = std::string_view(strings.data(), strings.size());
+  return true;
 }
 
 bool GameDatabase::LoadTrackHashes()
 {
   Timer load_timer;
 
+  const u64 discdb_ts = static_cast<u64>(Host::GetResourceFileTimestamp(DISCDB_YAML_FILENAME, false).value_or(0));
+  if (LoadTrackHashesFromCache(discdb_ts))
+  {
+    INFO_LOG("Loaded {} track hashes from cache in {:.0f}ms.", s_state.track_hashes.size(),
+             load_timer.GetTimeMilliseconds());
+    return !s_state.track_hashes.empty();
+  }
+
   Error error;
   std::optional<std::string> gamedb_data(Host::ReadResourceFileToString(DISCDB_YAML_FILENAME, false, &error));
   if (!gamedb_data.has_value())
@@ -1763,7 +2086,8 @@ bool GameDatabase::LoadTrackHashes()
   const ryml::Tree tree = ryml::parse_in_arena(to_csubstr(DISCDB_YAML_FILENAME), to_csubstr(gamedb_data.value()));
   const ryml::ConstNodeRef root = tree.rootref();
 
-  s_state.track_hashes_map = {};
+  StringPoolBuilder pool;
+  std::vector<TrackHashRecord> records;
 
   size_t serials = 0;
   for (const ryml::ConstNodeRef& current : root.cchildren())
@@ -1782,6 +2106,7 @@ bool GameDatabase::LoadTrackHashes()
       continue;
     }
 
+    const ImageString serial_str = pool.Add(serial);
     u32 revision = 0;
     for (const ryml::ConstNodeRef& track_revisions : track_data.cchildren())
     {
@@ -1792,8 +2117,9 @@ bool GameDatabase::LoadTrackHashes()
         continue;
       }
 
-      std::string revision_string;
+      std::string_view revision_string;
       GetStringFromObject(track_revisions, "version", &revision_string);
+      const ImageString revision_str = pool.Add(revision_string);
 
       for (const ryml::ConstNodeRef& track : tracks)
       {
@@ -1807,14 +2133,9 @@ bool GameDatabase::LoadTrackHashes()
 
         const std::optional<CDImageHasher::Hash> md5o = CDImageHasher::HashFromString(md5_str);
         if (md5o.has_value())
-        {
-          s_state.track_hashes_map.emplace(std::piecewise_construct, std::forward_as_tuple(md5o.value()),
-                                           std::forward_as_tuple(std::string(serial), revision_string, revision));
-        }
+          records.push_back(TrackHashRecord{md5o.value(), serial_str, revision_str, revision});
         else
-        {
           WARNING_LOG("invalid md5 in {}", serial);
-        }
       }
       revision++;
     }
@@ -1823,13 +2144,59 @@ bool GameDatabase::LoadTrackHashes()
   }
 
   ryml::reset_callbacks();
-  INFO_LOG("Loaded {} track hashes from {} serials in {:.0f}ms.", s_state.track_hashes_map.size(), serials,
+
+  std::stable_sort(records.begin(), records.end(),
+                   [](const TrackHashRecord& lhs, const TrackHashRecord& rhs) { return (lhs.hash < rhs.hash); });
+
+  TrackHashesImageHeader header = {};
+  header.signature = TRACK_HASHES_CACHE_SIGNATURE;
+  header.version = TRACK_HASHES_CACHE_VERSION;
+  header.discdb_ts = discdb_ts;
+  header.num_hashes = static_cast<u32>(records.size());
+  header.strings_size = static_cast<u32>(pool.GetData().size());
+
+  std::vector<u8> image(sizeof(header));
+  header.hashes_offset = AppendImageSection(image, records.data(), records.size() * sizeof(TrackHashRecord));
+  header.strings_offset = AppendImageSection(image, pool.GetData().data(), pool.GetData().size());
+  std::memcpy(image.data(), &header, sizeof(header));
+
+  s_state.track_hashes_image_data = std::move(image);
+  if (!OpenTrackHashesImage(s_state.track_hashes_image_data, discdb_ts))
+  {
+    ERROR_LOG("Failed to open newly-built track hashes image.");
+    s_state.track_hashes_image_data = {};
+    return false;
+  }
+
+  if (!FileSystem::WriteAtomicRenamedFile(Path::Combine(EmuFolders::Cache, DISCDB_CACHE_FILENAME),
+                                          s_state.track_hashes_image_data, &error))
+  {
+    ERROR_LOG("Failed to write track hashes cache file: {}", error.GetDescription());
+  }
+
+  INFO_LOG("Loaded {} track hashes from {} serials in {:.0f}ms.", s_state.track_hashes.size(), serials,
            load_timer.GetTimeMilliseconds());
-  return !s_state.track_hashes_map.empty();
+  return !s_state.track_hashes.empty();
 }
 
-const GameDatabase::TrackHashesMap& GameDatabase::GetTrackHashesMap()
+std::vector<GameDatabase::TrackData> GameDatabase::GetTracksForHash(const CDImageHasher::Hash& hash)
 {
-  EnsureTrackHashesMapLoaded();
-  return s_state.track_hashes_map;
+  EnsureTrackHashesLoaded();
+
+  struct Compare
+  {
+    bool operator()(const TrackHashRecord& lhs, const CDImageHasher::Hash& rhs) const { return (lhs.hash < rhs); }
+    bool operator()(const CDImageHasher::Hash& lhs, const TrackHashRecord& rhs) const { return (lhs < rhs.hash); }
+  };
+
+  std::vector<TrackData> ret;
+  const auto [begin, end] = std::equal_range(s_state.track_hashes.begin(), s_state.track_hashes.end(), hash, Compare());
+  ret.reserve(static_cast<size_t>(std::distance(begin, end)));
+  for (auto it = begin; it != end; ++it)
+  {
+    ret.push_back(TrackData{GetImageString(s_state.track_hashes_strings, it->serial),
+                            GetImageString(s_state.track_hashes_strings, it->revision_str), it->revision});
+  }
+
+  return ret;
 }
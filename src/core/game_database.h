@@ -10,7 +10,6 @@
 #include "common/small_string.h"
 
 #include <bitset>
-#include <map>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -65,6 +64,7 @@ enum class Trait : u32
   ForcePGXPVertexCache,
   ForcePGXPCPUMode,
   ForceRecompilerICache,
+  ForceRecompilerBlockOptimization,
   ForceCDROMSubQSkew,
   IsLibCryptProtected,
 
@@ -214,14 +214,9 @@ const char* GetLanguageName(Language language);
 std::optional<Language> ParseLanguageName(std::string_view str);
 TinyString GetLanguageFlagResourceName(std::string_view language_name);
 
-/// Map of track hashes for image verification
+/// Track hashes for image verification. Strings point into the disc database, and live for the whole process.
 struct TrackData
 {
-  TrackData(std::string serial_, std::string revision_str_, uint32_t revision_)
-    : serial(std::move(serial_)), revision_str(std::move(revision_str_)), revision(revision_)
-  {
-  }
-
   friend bool operator==(const TrackData& left, const TrackData& right)
   {
     // 'revisionString' is deliberately ignored in comparisons as it's redundant with comparing 'revision'! Do not
@@ -229,13 +224,13 @@ struct TrackData
     return left.serial == right.serial && left.revision == right.revision;
   }
 
-  std::string serial;
-  std::string revision_str;
+  std::string_view serial;
+  std::string_view revision_str;
   u32 revision;
 };
 
-using TrackHashesMap = std::multimap<CDImageHasher::Hash, TrackData>;
-const TrackHashesMap& GetTrackHashesMap();
-void EnsureTrackHashesMapLoaded();
+/// Returns every known track with the given hash, in disc database order.
+std::vector<TrackData> GetTracksForHash(const CDImageHasher::Hash& hash);
+void EnsureTrackHashesLoaded();
 
 } // namespace GameDatabase
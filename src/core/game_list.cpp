@@ -6,6 +6,7 @@
 #include "bios.h"
 #include "core.h"
 #include "fullscreenui.h"
+#include "host.h"
 #include "memory_card_image.h"
 #include "psf_loader.h"
 #include "settings.h"
@@ -21,7 +22,9 @@
 
 #include "common/assert.h"
 #include "common/binary_reader_writer.h"
+#include "common/directory_watcher.h"
 #include "common/error.h"
+#include "common/fast_hash.h"
 #include "common/file_system.h"
 #include "common/heterogeneous_containers.h"
 #include "common/log.h"
@@ -29,6 +32,7 @@
 #include "common/progress_callback.h"
 #include "common/string_pool.h"
 #include "common/string_util.h"
+#include "common/task_queue.h"
 #include "common/thirdparty/SmallVector.h"
 #include "common/time_helpers.h"
 #include "common/timer.h"
@@ -38,7 +42,9 @@
 #include <algorithm>
 #include <array>
 #include <bit>
+#include <condition_variable>
 #include <ctime>
+#include <mutex>
 #include <string_view>
 #include <type_traits>
 #include <unordered_map>
@@ -56,13 +62,16 @@ namespace {
 enum : u32
 {
   GAME_LIST_CACHE_SIGNATURE = 0x45434C48,
-  GAME_LIST_CACHE_VERSION = 39,
+  GAME_LIST_CACHE_VERSION = 40,
 
   PLAYED_TIME_SERIAL_LENGTH = 32,
   PLAYED_TIME_LAST_TIME_LENGTH = 20,  // uint64
   PLAYED_TIME_TOTAL_TIME_LENGTH = 20, // uint64
   PLAYED_TIME_LINE_LENGTH =
     PLAYED_TIME_SERIAL_LENGTH + 1 + PLAYED_TIME_LAST_TIME_LENGTH + 1 + PLAYED_TIME_TOTAL_TIME_LENGTH,
+  PLAYED_TIME_JOURNAL_COMPACT_THRESHOLD = 64,
+
+  MEMCARD_TIMESTAMP_CACHE_COMPACT_THRESHOLD = 64,
 };
 
 struct PlayedTimeEntry
@@ -85,11 +94,91 @@ struct MemcardTimestampCacheEntry
 };
 #pragma pack(pop)
 
+/// The cache file is a header, followed by the records, and then an index of the records sorted by the hash of their
+/// path. It's mapped rather than read, so entries are only parsed when a file is looked up.
+struct CacheHeader
+{
+  u32 signature;
+  u32 version;
+  u32 index_offset;
+  u32 index_count;
+};
+
+struct CacheIndexEntry
+{
+  u64 path_hash;
+  u32 offset;
+  u32 size;
+};
+static_assert(sizeof(CacheIndexEntry) == 16);
+
+enum class CacheRecordState : u8
+{
+  Unused,
+  Used,
+  Stale,
+};
+
+/// Directory which was scanned, and is watched for changes.
+struct WatchedDirectory
+{
+  std::string path;
+  std::string full_path;
+  bool recursive;
+
+  bool operator==(const WatchedDirectory& rhs) const = default;
+};
+
+/// File found by the last full scan, kept so that later refreshes don't need to enumerate directories again.
+struct WatchedFile
+{
+  std::string path;
+  std::string path_in_cache;
+  std::time_t timestamp;
+};
+
+struct ScannedEntry
+{
+  Entry entry;
+  std::string path_for_cache;
+};
+
+/// Files which aren't in the cache are read on a small pool of workers, while the scanning thread keeps enumerating,
+/// and merges the results into the list and cache file as they come in.
+struct ScanPipeline
+{
+  // Reading an image is mostly waiting on the disk, but more workers than this just thrash a spinning drive.
+  static constexpr u32 NUM_WORKERS = 4;
+
+  // Limits how far enumeration can run ahead of the workers, so cancelling doesn't have a long tail.
+  static constexpr u32 MAX_IN_FLIGHT = NUM_WORKERS * 4;
+
+  TaskQueue queue;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<ScannedEntry> completed;
+  u32 in_flight = 0;
+};
+
 } // namespace
 
-using CacheMap = UnorderedStringMap<Entry>;
 using PlayedTimeMap = UnorderedStringMap<PlayedTimeEntry>;
 
+namespace {
+struct ScanContext
+{
+  const std::vector<std::string>& excluded_paths;
+  const PlayedTimeMap& played_time_map;
+  const INISettingsInterface& custom_attributes_ini;
+  const Achievements::ProgressDatabase& achievements_progress;
+  ProgressCallback* progress;
+  bool only_cache;
+  bool write_cache;
+  ScanPipeline pipeline;
+};
+} // namespace
+
 static_assert(std::is_same_v<decltype(Entry::hash), GameHash>);
 
 static bool ShouldLoadAchievementsProgress();
@@ -103,34 +192,51 @@ static void ApplyCustomAttributes(const std::string& path, Entry* entry,
                                   const INISettingsInterface& custom_attributes_ini);
 static bool RescanCustomAttributesForPath(const std::string& path, const INISettingsInterface& custom_attributes_ini);
 static void PopulateEntryAchievements(Entry* entry, const Achievements::ProgressDatabase& achievements_progress);
-static bool GetGameListEntryFromCache(const std::string& path, Entry* entry,
+static bool GetGameListEntryFromCache(const std::string& path, std::time_t timestamp, Entry* entry,
                                       const INISettingsInterface& custom_attributes_ini,
                                       const Achievements::ProgressDatabase& achievements_progress);
 static Entry* GetMutableEntryForPath(std::string_view path);
-static void ScanDirectory(const std::string& path, bool recursive, bool only_cache,
-                          const std::vector<std::string>& excluded_paths, const PlayedTimeMap& played_time_map,
-                          const INISettingsInterface& custom_attributes_ini,
-                          const Achievements::ProgressDatabase& achievements_progress, BinaryFileWriter& cache_writer,
-                          ProgressCallback* progress);
+static void ScanDirectory(ScanContext& ctx, const WatchedDirectory& dir, std::vector<WatchedFile>* found_files);
+static void ScanWatchedFiles(ScanContext& ctx);
+static bool ScanFoundFile(ScanContext& ctx, std::string path, std::string path_in_cache, std::time_t timestamp);
 static bool AddFileFromCache(const std::string& path, const std::string& path_in_cache, std::time_t timestamp,
                              const PlayedTimeMap& played_time_map, const INISettingsInterface& custom_attributes_ini,
                              const Achievements::ProgressDatabase& achievements_progress);
-static void ScanFile(std::string path, std::time_t timestamp, std::unique_lock<std::recursive_mutex>& lock,
+static void ScanFile(std::string path, std::time_t timestamp, std::string path_for_cache,
                      const PlayedTimeMap& played_time_map, const INISettingsInterface& custom_attributes_ini,
-                     const Achievements::ProgressDatabase& achievements_progress, const std::string& path_for_cache,
-                     BinaryFileWriter& cache_writer);
-
-static bool LoadOrInitializeCache(std::FILE* fp, bool invalidate_cache);
-static bool LoadEntriesFromCache(BinaryFileReader& reader);
-static bool WriteEntryToCache(const Entry* entry, const std::string& entry_path, BinaryFileWriter& writer);
+                     const Achievements::ProgressDatabase& achievements_progress, ScanPipeline& pipeline);
+static void CommitScannedFiles(ScanContext& ctx, u32 max_in_flight);
+
+static void LoadCache(std::FILE* fp, bool invalidate_cache);
+static bool ReadCacheRecord(std::span<const u8> record, std::string_view* path, Entry* entry);
+static void AppendEntryToCache(const Entry& entry, std::string_view entry_path);
+static bool WriteCache(std::FILE* fp, bool keep_unused_entries);
+static void ResetCache();
+
+static bool IsPathExcluded(const std::vector<std::string>& excluded_paths, const std::string_view& path);
+static std::vector<WatchedDirectory> GetWatchedDirectories(const std::vector<std::string>& dirs,
+                                                           const std::vector<std::string>& recursive_dirs);
+static bool TakeDirectoryChanges(const std::vector<WatchedDirectory>& directories,
+                                 const std::vector<std::string>& excluded_paths, std::vector<std::string>* paths);
+static void ApplyDirectoryChanges(const std::vector<std::string>& paths, const std::vector<std::string>& excluded_paths);
+static void AddWatchedFile(std::string path, std::time_t timestamp, const std::vector<std::string>& excluded_paths);
+static std::unique_ptr<DirectoryWatcher> CreateDirectoryWatcher(const std::vector<WatchedDirectory>& directories);
+static void OnDirectoryChanged();
 static void CreateDiscSetEntries(const std::vector<std::string>& excluded_paths, const PlayedTimeMap& played_time_map,
                                  const INISettingsInterface& custom_attributes_ini);
 
 static std::string GetPlayedTimePath();
+static std::string GetPlayedTimeJournalPath();
 static bool ParsePlayedTimeLine(char* line, std::string_view& serial, PlayedTimeEntry& entry);
 static std::string MakePlayedTimeLine(std::string_view serial, const PlayedTimeEntry& entry);
+static void ReadPlayedTimeFile(std::FILE* fp, PlayedTimeMap& map);
+static u32 ReadPlayedTimeJournal(std::FILE* fp, PlayedTimeMap& map);
+static void ApplyPlayedTimeDelta(PlayedTimeMap& map, std::string_view serial, const PlayedTimeEntry& delta);
 static PlayedTimeMap LoadPlayedTimeMap();
+static void LockedLoadPlayedTimeMap();
 static PlayedTimeEntry UpdatePlayedTimeFile(std::string_view serial, std::time_t last_time, std::time_t add_time);
+static void QueuePlayedTimeCompaction();
+static void CompactPlayedTimeJournal();
 
 static std::string GetCustomPropertiesFile();
 static const std::string& GetCustomPropertiesSection(const std::string& path, std::string* temp_path);
@@ -139,6 +245,8 @@ static bool PutCustomPropertiesField(INISettingsInterface& ini, const std::strin
 
 static std::string GetMemcardTimestampCachePath();
 static bool UpdateMemcardTimestampCache(const MemcardTimestampCacheEntry& entry);
+static size_t RemoveDuplicateMemcardTimestampCacheEntries(std::vector<MemcardTimestampCacheEntry>& entries);
+static void CompactMemcardTimestampCache();
 
 static std::string GetAchievementGameBadgeCachePath();
 static void LoadAchievementGameBadges();
@@ -147,7 +255,32 @@ struct State
 {
   EntryList entries;
   std::recursive_mutex mutex;
-  CacheMap cache_map;
+
+  // Cache from the previous refresh, and records for files scanned in this one. Both are written out at the end.
+  FileSystem::MappedFile cache_data;
+  std::span<const CacheIndexEntry> cache_index;
+  std::vector<CacheRecordState> cache_record_states;
+  std::vector<u8> new_cache_records;
+  std::vector<CacheIndexEntry> new_cache_index;
+  bool cache_loaded = false;
+
+  // Files from the last full scan, and notifications of changes to them since.
+  std::mutex watcher_mutex;
+  std::unique_ptr<DirectoryWatcher> watcher;
+  std::vector<WatchedDirectory> watched_directories;
+  std::vector<std::string> watched_excluded_paths;
+  std::vector<WatchedFile> watched_files;
+  bool refresh_in_progress = false;
+  bool refresh_requested = false;
+
+  // Base file plus the journal, as of the last time they were read. Updates are appended to the journal, which is
+  // folded back into the base file once it gets long enough.
+  std::mutex played_time_mutex;
+  PlayedTimeMap played_time_map;
+  u32 played_time_journal_entries = 0;
+  bool played_time_map_loaded = false;
+  bool played_time_compaction_queued = false;
+
   std::vector<MemcardTimestampCacheEntry> memcard_timestamp_cache_entries;
 
   // TODO: Turn this into a proper cache of achievement data, not just the badge names.
@@ -276,7 +409,7 @@ bool GameList::GetExeListEntry(const std::string& path, GameList::Entry* entry)
   }
 
   Error error;
-  const auto data = FileSystem::ReadBinaryFile(fp.get(), &error);
+  const std::optional<FileSystem::MappedFile> data = FileSystem::MapBinaryFile(fp.get(), &error);
   if (!data.has_value())
   {
     WARNING_LOG("Failed to read {}: {}", Path::GetFileName(path), error.GetDescription());
@@ -444,98 +577,211 @@ bool GameList::PopulateEntryFromPath(const std::string& path, Entry* entry)
   return GetDiscListEntry(path, entry);
 }
 
-bool GameList::GetGameListEntryFromCache(const std::string& path, Entry* entry,
+bool GameList::GetGameListEntryFromCache(const std::string& path, std::time_t timestamp, Entry* entry,
                                          const INISettingsInterface& custom_attributes_ini,
                                          const Achievements::ProgressDatabase& achievements_progress)
 {
-  auto iter = s_state.cache_map.find(path);
-  if (iter == s_state.cache_map.end())
-    return false;
+  const u64 path_hash = FastHash::Hash64(path.data(), path.size());
+  const auto begin = s_state.cache_index.begin();
+  for (auto iter = std::lower_bound(begin, s_state.cache_index.end(), path_hash,
+                                    [](const CacheIndexEntry& ie, u64 hash) { return (ie.path_hash < hash); });
+       iter != s_state.cache_index.end() && iter->path_hash == path_hash; ++iter)
+  {
+    std::string_view record_path;
+    if (!ReadCacheRecord(s_state.cache_data.cspan().subspan(iter->offset, iter->size), &record_path, entry))
+    {
+      WARNING_LOG("Game list cache entry is corrupted");
+      continue;
+    }
+    else if (record_path != path)
+    {
+      continue;
+    }
 
-  *entry = std::move(iter->second);
-  entry->dbentry = GameDatabase::GetEntryForSerial(entry->serial);
-  s_state.cache_map.erase(iter);
-  ApplyCustomAttributes(path, entry, custom_attributes_ini);
-  if (entry->IsDisc())
-    PopulateEntryAchievements(entry, achievements_progress);
+    // outdated entries get dropped from the cache when it's written back
+    const size_t index = static_cast<size_t>(iter - begin);
+    if (entry->last_modified_time != timestamp)
+    {
+      s_state.cache_record_states[index] = CacheRecordState::Stale;
+      return false;
+    }
 
-  return true;
+    s_state.cache_record_states[index] = CacheRecordState::Used;
+    entry->path = path;
+    entry->dbentry = GameDatabase::GetEntryForSerial(entry->serial);
+    ApplyCustomAttributes(path, entry, custom_attributes_ini);
+    if (entry->IsDisc())
+      PopulateEntryAchievements(entry, achievements_progress);
+
+    return true;
+  }
+
+  return false;
 }
 
-bool GameList::LoadEntriesFromCache(BinaryFileReader& reader)
+bool GameList::ReadCacheRecord(std::span<const u8> record, std::string_view* path, Entry* entry)
 {
-  u32 file_signature, file_version;
-  if (!reader.ReadU32(&file_signature) || !reader.ReadU32(&file_version) ||
-      file_signature != GAME_LIST_CACHE_SIGNATURE || file_version != GAME_LIST_CACHE_VERSION)
+  BinarySpanReader reader(record);
+  u8 type;
+  u8 region;
+  if (!reader.ReadU8(&type) || !reader.ReadU8(&region) || !reader.ReadSizePrefixedString(path) ||
+      !reader.ReadSizePrefixedString(&entry->serial) || !reader.ReadSizePrefixedString(&entry->title) ||
+      !reader.ReadU64(&entry->hash) || !reader.ReadS64(&entry->file_size) ||
+      !reader.ReadU64(&entry->uncompressed_size) ||
+      !reader.ReadU64(reinterpret_cast<u64*>(&entry->last_modified_time)) || !reader.ReadS8(&entry->disc_set_index) ||
+      !reader.Read(entry->achievements_hash.data(), entry->achievements_hash.size()) ||
+      region >= static_cast<u8>(DiscRegion::Count) || type > static_cast<u8>(EntryType::MaxCount))
   {
-    WARNING_LOG("Game list cache is corrupted");
     return false;
   }
 
-  while (!reader.IsAtEnd())
+  entry->region = static_cast<DiscRegion>(region);
+  entry->type = static_cast<EntryType>(type);
+  return true;
+}
+
+void GameList::AppendEntryToCache(const Entry& entry, std::string_view entry_path)
+{
+  const std::string_view title = entry.has_custom_title ? std::string_view() : std::string_view(entry.title);
+  const size_t size = sizeof(u8) + sizeof(u8) + (sizeof(u32) + entry_path.size()) +
+                      (sizeof(u32) + entry.serial.size()) + (sizeof(u32) + title.size()) + sizeof(u64) + sizeof(s64) +
+                      sizeof(u64) + sizeof(u64) + sizeof(s8) + entry.achievements_hash.size();
+  const size_t offset = s_state.new_cache_records.size();
+  s_state.new_cache_records.resize(offset + size);
+
+  BinarySpanWriter writer(std::span<u8>(s_state.new_cache_records).subspan(offset));
+  writer.WriteU8(static_cast<u8>(entry.type));
+  writer.WriteU8(static_cast<u8>(entry.region));
+  writer.WriteSizePrefixedString(entry_path);
+  writer.WriteSizePrefixedString(entry.serial);
+  writer.WriteSizePrefixedString(title);
+  writer.WriteU64(entry.hash);
+  writer.WriteS64(entry.file_size);
+  writer.WriteU64(entry.uncompressed_size);
+  writer.WriteU64(entry.last_modified_time);
+  writer.WriteS8(entry.disc_set_index);
+  writer.Write(entry.achievements_hash.data(), entry.achievements_hash.size());
+  DebugAssert(writer.GetBufferRemaining() == 0);
+
+  s_state.new_cache_index.push_back(CacheIndexEntry{FastHash::Hash64(entry_path.data(), entry_path.size()),
+                                                    static_cast<u32>(offset), static_cast<u32>(size)});
+}
+
+void GameList::LoadCache(std::FILE* fp, bool invalidate_cache)
+{
+  ResetCache();
+  if (!fp)
+    return;
+
+  Error error;
+  if (invalidate_cache || !s_state.cache_data.Map(fp, &error) || s_state.cache_data.empty())
   {
-    std::string path;
-    Entry ge;
+    if (error.IsValid())
+      ERROR_LOG("Failed to map game list cache: {}", error.GetDescription());
 
-    u8 type;
-    u8 region;
+    WARNING_LOG("Initializing game list cache.");
+    ResetCache();
+    return;
+  }
+
+  const u8* const data = s_state.cache_data.data();
+  const size_t size = s_state.cache_data.size();
+  CacheHeader header;
+  if (size >= sizeof(header))
+    std::memcpy(&header, data, sizeof(header));
+  if (size < sizeof(header) || header.signature != GAME_LIST_CACHE_SIGNATURE ||
+      header.version != GAME_LIST_CACHE_VERSION || header.index_offset < sizeof(header) ||
+      header.index_offset > size || !Common::IsAlignedPow2(header.index_offset, alignof(CacheIndexEntry)) ||
+      ((size - header.index_offset) / sizeof(CacheIndexEntry)) < header.index_count)
+  {
+    WARNING_LOG("Game list cache is corrupted");
+    WARNING_LOG("Initializing game list cache.");
+    ResetCache();
+    return;
+  }
 
-    if (!reader.ReadU8(&type) || !reader.ReadU8(&region) || !reader.ReadSizePrefixedString(&path) ||
-        !reader.ReadSizePrefixedString(&ge.serial) || !reader.ReadSizePrefixedString(&ge.title) ||
-        !reader.ReadU64(&ge.hash) || !reader.ReadS64(&ge.file_size) || !reader.ReadU64(&ge.uncompressed_size) ||
-        !reader.ReadU64(reinterpret_cast<u64*>(&ge.last_modified_time)) || !reader.ReadS8(&ge.disc_set_index) ||
-        !reader.Read(ge.achievements_hash.data(), ge.achievements_hash.size()) ||
-        region >= static_cast<u8>(DiscRegion::Count) || type > static_cast<u8>(EntryType::MaxCount))
+  // only the index is checked up front, the records are validated as they're read
+  const std::span<const CacheIndexEntry> index(reinterpret_cast<const CacheIndexEntry*>(data + header.index_offset),
+                                               header.index_count);
+  for (const CacheIndexEntry& ie : index)
+  {
+    if (ie.offset < sizeof(header) || ie.offset > header.index_offset || ie.size > (header.index_offset - ie.offset))
     {
       WARNING_LOG("Game list cache entry is corrupted");
-      return false;
+      WARNING_LOG("Initializing game list cache.");
+      ResetCache();
+      return;
     }
-
-    ge.path = path;
-    ge.region = static_cast<DiscRegion>(region);
-    ge.type = static_cast<EntryType>(type);
-
-    auto iter = s_state.cache_map.find(ge.path);
-    if (iter != s_state.cache_map.end())
-      iter->second = std::move(ge);
-    else
-      s_state.cache_map.emplace(std::move(path), std::move(ge));
   }
 
-  return true;
+  s_state.cache_index = index;
+  s_state.cache_record_states.resize(index.size(), CacheRecordState::Unused);
+  s_state.cache_loaded = true;
 }
 
-bool GameList::WriteEntryToCache(const Entry* entry, const std::string& entry_path, BinaryFileWriter& writer)
+bool GameList::WriteCache(std::FILE* fp, bool keep_unused_entries)
 {
-  writer.WriteU8(static_cast<u8>(entry->type));
-  writer.WriteU8(static_cast<u8>(entry->region));
-  writer.WriteSizePrefixedString(entry_path);
-  writer.WriteSizePrefixedString(entry->serial);
-  writer.WriteSizePrefixedString(entry->has_custom_title ? std::string_view() : std::string_view(entry->title));
-  writer.WriteU64(entry->hash);
-  writer.WriteS64(entry->file_size);
-  writer.WriteU64(entry->uncompressed_size);
-  writer.WriteU64(entry->last_modified_time);
-  writer.WriteS8(entry->disc_set_index);
-  writer.Write(entry->achievements_hash.data(), entry->achievements_hash.size());
-  return writer.IsGood();
-}
+  const auto keep_record = [keep_unused_entries](CacheRecordState state) {
+    return (state == CacheRecordState::Used || (state == CacheRecordState::Unused && keep_unused_entries));
+  };
 
-bool GameList::LoadOrInitializeCache(std::FILE* fp, bool invalidate_cache)
-{
-  BinaryFileReader reader(fp);
-  if (!invalidate_cache && !reader.IsAtEnd() && LoadEntriesFromCache(reader))
+  size_t records_size = s_state.new_cache_records.size();
+  size_t num_records = s_state.new_cache_index.size();
+  for (size_t i = 0; i < s_state.cache_index.size(); i++)
   {
-    // Prepare for writing.
-    return (FileSystem::FSeek64(fp, 0, SEEK_END) == 0);
+    if (keep_record(s_state.cache_record_states[i]))
+    {
+      records_size += s_state.cache_index[i].size;
+      num_records++;
+    }
   }
 
-  WARNING_LOG("Initializing game list cache.");
-  s_state.cache_map.clear();
-  if (!fp)
+  // don't rewrite it if nothing has changed
+  if (s_state.cache_loaded && s_state.new_cache_index.empty() && num_records == s_state.cache_index.size())
+    return true;
+
+  const size_t index_offset = Common::AlignUpPow2(sizeof(CacheHeader) + records_size, alignof(CacheIndexEntry));
+  const size_t total_size = index_offset + (num_records * sizeof(CacheIndexEntry));
+  if (total_size > std::numeric_limits<u32>::max())
+  {
+    ERROR_LOG("Game list cache is too large ({} bytes)", total_size);
     return false;
+  }
+
+  std::vector<u8> data(total_size);
+  std::vector<CacheIndexEntry> index;
+  index.reserve(num_records);
+
+  size_t pos = sizeof(CacheHeader);
+  for (size_t i = 0; i < s_state.cache_index.size(); i++)
+  {
+    const CacheIndexEntry& ie = s_state.cache_index[i];
+    if (!keep_record(s_state.cache_record_states[i]))
+      continue;
+
+    std::memcpy(&data[pos], s_state.cache_data.data() + ie.offset, ie.size);
+    index.push_back(CacheIndexEntry{ie.path_hash, static_cast<u32>(pos), ie.size});
+    pos += ie.size;
+  }
+  if (!s_state.new_cache_records.empty())
+  {
+    std::memcpy(&data[pos], s_state.new_cache_records.data(), s_state.new_cache_records.size());
+    for (const CacheIndexEntry& ie : s_state.new_cache_index)
+      index.push_back(CacheIndexEntry{ie.path_hash, static_cast<u32>(pos + ie.offset), ie.size});
+  }
+
+  std::sort(index.begin(), index.end(),
+            [](const CacheIndexEntry& lhs, const CacheIndexEntry& rhs) { return (lhs.path_hash < rhs.path_hash); });
+  std::memcpy(&data[index_offset], index.data(), index.size() * sizeof(CacheIndexEntry));
+
+  const CacheHeader header = {GAME_LIST_CACHE_SIGNATURE, GAME_LIST_CACHE_VERSION, static_cast<u32>(index_offset),
+                              static_cast<u32>(num_records)};
+  std::memcpy(data.data(), &header, sizeof(header));
+
+  // mapped files can't be truncated on Windows
+  s_state.cache_data.Unmap();
+  s_state.cache_index = {};
 
-  // Truncate file, and re-write header.
   Error error;
   if (!FileSystem::FSeek64(fp, 0, SEEK_SET, &error) || !FileSystem::FTruncate64(fp, 0, &error))
   {
@@ -544,87 +790,138 @@ bool GameList::LoadOrInitializeCache(std::FILE* fp, bool invalidate_cache)
   }
 
   BinaryFileWriter writer(fp);
-  writer.WriteU32(GAME_LIST_CACHE_SIGNATURE);
-  writer.WriteU32((GAME_LIST_CACHE_VERSION));
+  writer.Write(data.data(), data.size());
   if (!writer.Flush(&error))
   {
-    ERROR_LOG("Failed to write game list cache header: {}", error.GetDescription());
+    ERROR_LOG("Failed to write game list cache: {}", error.GetDescription());
     return false;
   }
 
+  VERBOSE_LOG("Wrote {} entries to game list cache", num_records);
   return true;
 }
 
-static bool IsPathExcluded(const std::vector<std::string>& excluded_paths, const std::string_view& path)
+void GameList::ResetCache()
+{
+  s_state.cache_index = {};
+  s_state.cache_data.Unmap();
+  s_state.cache_record_states = {};
+  s_state.new_cache_records = {};
+  s_state.new_cache_index = {};
+  s_state.cache_loaded = false;
+}
+
+bool GameList::IsPathExcluded(const std::vector<std::string>& excluded_paths, const std::string_view& path)
 {
   return std::find_if(excluded_paths.begin(), excluded_paths.end(),
                       [&path](const std::string& entry) { return path.starts_with(entry); }) != excluded_paths.end();
 }
 
-void GameList::ScanDirectory(const std::string& path, bool recursive, bool only_cache,
-                             const std::vector<std::string>& excluded_paths, const PlayedTimeMap& played_time_map,
-                             const INISettingsInterface& custom_attributes_ini,
-                             const Achievements::ProgressDatabase& achievements_progress,
-                             BinaryFileWriter& cache_writer, ProgressCallback* progress)
+void GameList::ScanDirectory(ScanContext& ctx, const WatchedDirectory& dir, std::vector<WatchedFile>* found_files)
 {
-  VERBOSE_LOG("Scanning {}{}", path, recursive ? " (recursively)" : "");
+  VERBOSE_LOG("Scanning {}{}", dir.path, dir.recursive ? " (recursively)" : "");
 
-  progress->SetStatusText(SmallString::from_format(TRANSLATE_FS("GameList", "Scanning directory '{}'..."), path));
+  ProgressCallback* const progress = ctx.progress;
+  progress->SetStatusText(SmallString::from_format(TRANSLATE_FS("GameList", "Scanning directory '{}'..."), dir.path));
 
   // relative paths require extra care
-  std::string relative_full_path;
-  const bool is_relative_scan = !Path::IsAbsolute(path);
-  if (is_relative_scan)
-    relative_full_path = Path::Combine(EmuFolders::DataRoot, path);
-
-  FileSystem::FindResultsArray files;
-  FileSystem::FindFiles(is_relative_scan ? relative_full_path.c_str() : path.c_str(), "*",
-                        (FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_HIDDEN_FILES) |
-                          (recursive ? FILESYSTEM_FIND_RECURSIVE : 0) |
-                          (is_relative_scan ? FILESYSTEM_FIND_RELATIVE_PATHS : 0),
-                        &files);
-  if (files.empty())
-    return;
+  const bool is_relative_scan = !Path::IsAbsolute(dir.path);
 
+  // Files are scanned as the walk finds them, rather than waiting for the whole tree, which can take a while on
+  // network shares. That means the total isn't known until the end, so the range grows as files are found.
   progress->PushState();
-  progress->SetProgressRange(static_cast<u32>(files.size()));
   progress->SetProgressValue(0);
 
   u32 files_scanned = 0;
-  for (FILESYSTEM_FIND_DATA& ffd : files)
+  FileSystem::EnumerateFiles(
+    dir.full_path.c_str(), "*",
+    (FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_HIDDEN_FILES) | (dir.recursive ? FILESYSTEM_FIND_RECURSIVE : 0) |
+      (is_relative_scan ? FILESYSTEM_FIND_RELATIVE_PATHS : 0),
+    [&](FILESYSTEM_FIND_DATA& ffd) {
+      if (progress->IsCancelled())
+        return false;
+
+      files_scanned++;
+      progress->SetProgressRange(files_scanned);
+
+      if (!IsScannableFilename(ffd.FileName) || IsPathExcluded(ctx.excluded_paths, ffd.FileName))
+        return true;
+
+      // scan dir = games, subdir/file => /root/games/subdir/file, cache path games/subdir/file
+      std::string path_in_cache;
+      if (is_relative_scan)
+      {
+        // need to prefix the relative directory
+        path_in_cache = Path::Combine(dir.path, ffd.FileName);
+        ffd.FileName = Path::Combine(EmuFolders::DataRoot, path_in_cache);
+      }
+
+      if (found_files)
+        found_files->push_back(WatchedFile{ffd.FileName, path_in_cache, ffd.ModificationTime});
+
+      if (ScanFoundFile(ctx, std::move(ffd.FileName), std::move(path_in_cache), ffd.ModificationTime))
+        progress->SetProgressValue(files_scanned);
+
+      return true;
+    });
+
+  // even if cancelled, the workers reference our state, and there's no harm in keeping what they've read
+  CommitScannedFiles(ctx, 0);
+
+  progress->SetProgressValue(files_scanned);
+  progress->PopState();
+}
+
+void GameList::ScanWatchedFiles(ScanContext& ctx)
+{
+  ProgressCallback* const progress = ctx.progress;
+  progress->SetStatusText(TRANSLATE_SV("GameList", "Checking for changed files..."));
+  progress->SetProgressRange(static_cast<u32>(s_state.watched_files.size()));
+  progress->SetProgressValue(0);
+
+  u32 files_scanned = 0;
+  for (const WatchedFile& file : s_state.watched_files)
   {
-    files_scanned++;
+    if (progress->IsCancelled())
+      break;
 
-    if (progress->IsCancelled() || !IsScannableFilename(ffd.FileName) || IsPathExcluded(excluded_paths, ffd.FileName))
-      continue;
+    files_scanned++;
+    if (ScanFoundFile(ctx, file.path, file.path_in_cache, file.timestamp))
+      progress->SetProgressValue(files_scanned);
+  }
 
-    // scan dir = games, subdir/file => /root/games/subdir/file, cache path games/subdir/file
-    std::string path_in_cache;
-    if (is_relative_scan)
-    {
-      // need to prefix the relative directory
-      path_in_cache = Path::Combine(path, ffd.FileName);
-      ffd.FileName = Path::Combine(EmuFolders::DataRoot, path_in_cache);
-    }
+  CommitScannedFiles(ctx, 0);
+  progress->SetProgressValue(files_scanned);
+}
 
+bool GameList::ScanFoundFile(ScanContext& ctx, std::string path, std::string path_in_cache, std::time_t timestamp)
+{
+  {
     std::unique_lock lock(s_state.mutex);
-    if (GetEntryForPath(ffd.FileName) ||
-        AddFileFromCache(ffd.FileName, path_in_cache, ffd.ModificationTime, played_time_map, custom_attributes_ini,
-                         achievements_progress) ||
-        only_cache)
+    if (GetEntryForPath(path) ||
+        AddFileFromCache(path, path_in_cache, timestamp, ctx.played_time_map, ctx.custom_attributes_ini,
+                         ctx.achievements_progress) ||
+        ctx.only_cache)
     {
-      continue;
+      return false;
     }
-
-    progress->SetStatusText(SmallString::from_format(TRANSLATE_FS("GameList", "Scanning '{}'..."),
-                                                     FileSystem::GetDisplayNameFromPath(ffd.FileName)));
-    ScanFile(std::move(ffd.FileName), ffd.ModificationTime, lock, played_time_map, custom_attributes_ini,
-             achievements_progress, path_in_cache, cache_writer);
-    progress->SetProgressValue(files_scanned);
   }
 
-  progress->SetProgressValue(files_scanned);
-  progress->PopState();
+  // make room for another file, picking up anything that's finished in the meantime
+  CommitScannedFiles(ctx, ScanPipeline::MAX_IN_FLIGHT - 1);
+
+  ctx.progress->SetStatusText(SmallString::from_format(TRANSLATE_FS("GameList", "Scanning '{}'..."),
+                                                       FileSystem::GetDisplayNameFromPath(path)));
+  {
+    std::unique_lock lock(ctx.pipeline.mutex);
+    ctx.pipeline.in_flight++;
+  }
+  ctx.pipeline.queue.SubmitTask(
+    [&ctx, path = std::move(path), timestamp, path_in_cache = std::move(path_in_cache)]() mutable {
+      ScanFile(std::move(path), timestamp, std::move(path_in_cache), ctx.played_time_map, ctx.custom_attributes_ini,
+               ctx.achievements_progress, ctx.pipeline);
+    });
+  return true;
 }
 
 bool GameList::AddFileFromCache(const std::string& path, const std::string& path_in_cache, std::time_t timestamp,
@@ -632,9 +929,8 @@ bool GameList::AddFileFromCache(const std::string& path, const std::string& path
                                 const Achievements::ProgressDatabase& achievements_progress)
 {
   Entry entry;
-  if (!GetGameListEntryFromCache(path_in_cache.empty() ? path : path_in_cache, &entry, custom_attributes_ini,
-                                 achievements_progress) ||
-      entry.last_modified_time != timestamp)
+  if (!GetGameListEntryFromCache(path_in_cache.empty() ? path : path_in_cache, timestamp, &entry,
+                                 custom_attributes_ini, achievements_progress))
   {
     return false;
   }
@@ -658,14 +954,10 @@ bool GameList::AddFileFromCache(const std::string& path, const std::string& path
   return true;
 }
 
-void GameList::ScanFile(std::string path, std::time_t timestamp, std::unique_lock<std::recursive_mutex>& lock,
+void GameList::ScanFile(std::string path, std::time_t timestamp, std::string path_for_cache,
                         const PlayedTimeMap& played_time_map, const INISettingsInterface& custom_attributes_ini,
-                        const Achievements::ProgressDatabase& achievements_progress, const std::string& path_for_cache,
-                        BinaryFileWriter& cache_writer)
+                        const Achievements::ProgressDatabase& achievements_progress, ScanPipeline& pipeline)
 {
-  // don't block UI while scanning
-  lock.unlock();
-
   VERBOSE_LOG("Scanning '{}'...", path);
 
   Entry entry;
@@ -691,26 +983,207 @@ void GameList::ScanFile(std::string path, std::time_t timestamp, std::unique_loc
   entry.path = std::move(path);
   entry.last_modified_time = timestamp;
 
+  {
+    std::unique_lock lock(pipeline.mutex);
+    pipeline.completed.push_back(ScannedEntry{std::move(entry), std::move(path_for_cache)});
+    pipeline.in_flight--;
+  }
+
+  pipeline.cv.notify_one();
+}
+
+void GameList::CommitScannedFiles(ScanContext& ctx, u32 max_in_flight)
+{
+  ScanPipeline& pipeline = ctx.pipeline;
+  std::vector<ScannedEntry> completed;
+  {
+    std::unique_lock lock(pipeline.mutex);
+    pipeline.cv.wait(lock, [&pipeline, max_in_flight]() { return (pipeline.in_flight <= max_in_flight); });
+    completed.swap(pipeline.completed);
+  }
+
+  if (completed.empty())
+    return;
+
   // write the relative path to the cache if this is a relative scan
-  if (cache_writer.IsOpen() &&
-      !WriteEntryToCache(&entry, path_for_cache.empty() ? entry.path : path_for_cache, cache_writer)) [[unlikely]]
+  if (ctx.write_cache)
   {
-    WARNING_LOG("Failed to write entry '{}' to cache", entry.path);
+    for (const ScannedEntry& it : completed)
+      AppendEntryToCache(it.entry, it.path_for_cache.empty() ? it.entry.path : it.path_for_cache);
   }
 
-  lock.lock();
+  std::unique_lock lock(s_state.mutex);
+  for (ScannedEntry& it : completed)
+  {
+    // don't add invalid entries to the list
+    if (!it.entry.IsValid())
+      continue;
 
-  // don't add invalid entries to the list
-  if (!entry.IsValid())
+    // replace if present
+    auto eit = std::find_if(s_state.entries.begin(), s_state.entries.end(),
+                            [&it](const Entry& existing_entry) { return (existing_entry.path == it.entry.path); });
+    if (eit != s_state.entries.end())
+      *eit = std::move(it.entry);
+    else
+      s_state.entries.push_back(std::move(it.entry));
+  }
+}
+
+std::vector<GameList::WatchedDirectory> GameList::GetWatchedDirectories(const std::vector<std::string>& dirs,
+                                                                        const std::vector<std::string>& recursive_dirs)
+{
+  std::vector<WatchedDirectory> ret;
+  ret.reserve(dirs.size() + recursive_dirs.size());
+
+  const auto add = [&ret](const std::string& path, bool recursive) {
+    ret.push_back(WatchedDirectory{path, Path::IsAbsolute(path) ? path : Path::Combine(EmuFolders::DataRoot, path),
+                                   recursive});
+  };
+  for (const std::string& dir : dirs)
+    add(dir, false);
+  for (const std::string& dir : recursive_dirs)
+    add(dir, true);
+
+  return ret;
+}
+
+bool GameList::TakeDirectoryChanges(const std::vector<WatchedDirectory>& directories,
+                                    const std::vector<std::string>& excluded_paths, std::vector<std::string>* paths)
+{
+  std::unique_lock lock(s_state.watcher_mutex);
+  if (!s_state.watcher || directories != s_state.watched_directories ||
+      excluded_paths != s_state.watched_excluded_paths)
+  {
+    return false;
+  }
+
+  if (!s_state.watcher->TakeChanges(paths))
+  {
+    WARNING_LOG("Directory change notifications were lost, rescanning.");
+    return false;
+  }
+
+  return true;
+}
+
+void GameList::ApplyDirectoryChanges(const std::vector<std::string>& paths,
+                                     const std::vector<std::string>& excluded_paths)
+{
+  for (const std::string& path : paths)
+  {
+    // drop anything at or below the changed path, whatever's still there gets added back
+    std::erase_if(s_state.watched_files, [&path](const WatchedFile& file) {
+      return (file.path.starts_with(path) &&
+              (file.path.length() == path.length() || file.path[path.length()] == FS_OSPATH_SEPARATOR_CHARACTER));
+    });
+
+    FILESYSTEM_STAT_DATA sd;
+    if (!FileSystem::StatFile(path.c_str(), &sd))
+      continue;
+
+    if (sd.Attributes & FILESYSTEM_FILE_ATTRIBUTE_DIRECTORY)
+    {
+      // directory was created or moved in, AddWatchedFile() skips anything a non-recursive scan wouldn't see
+      FileSystem::EnumerateFiles(path.c_str(), "*",
+                                 FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_HIDDEN_FILES | FILESYSTEM_FIND_RECURSIVE,
+                                 [&excluded_paths](FILESYSTEM_FIND_DATA& ffd) {
+                                   AddWatchedFile(std::move(ffd.FileName), ffd.ModificationTime, excluded_paths);
+                                   return true;
+                                 });
+    }
+    else
+    {
+      AddWatchedFile(path, sd.ModificationTime, excluded_paths);
+    }
+  }
+}
+
+void GameList::AddWatchedFile(std::string path, std::time_t timestamp, const std::vector<std::string>& excluded_paths)
+{
+  if (!IsScannableFilename(path))
     return;
 
-  // replace if present
-  auto it = std::find_if(s_state.entries.begin(), s_state.entries.end(),
-                         [&entry](const Entry& existing_entry) { return (existing_entry.path == entry.path); });
-  if (it != s_state.entries.end())
-    *it = std::move(entry);
-  else
-    s_state.entries.push_back(std::move(entry));
+  for (const WatchedDirectory& dir : s_state.watched_directories)
+  {
+    std::string_view relative_path(path);
+    if (!relative_path.starts_with(dir.full_path))
+      continue;
+
+    relative_path = relative_path.substr(dir.full_path.length());
+    if (!dir.full_path.ends_with(FS_OSPATH_SEPARATOR_CHARACTER))
+    {
+      if (!relative_path.starts_with(FS_OSPATH_SEPARATOR_CHARACTER))
+        continue;
+
+      relative_path = relative_path.substr(1);
+    }
+
+    if (relative_path.empty() ||
+        (!dir.recursive && relative_path.find(FS_OSPATH_SEPARATOR_CHARACTER) != std::string_view::npos))
+    {
+      continue;
+    }
+
+    // same checks as ScanDirectory(), which sees relative names for relative scans
+    const bool is_relative_scan = !Path::IsAbsolute(dir.path);
+    if (IsPathExcluded(excluded_paths, is_relative_scan ? relative_path : std::string_view(path)))
+      return;
+
+    std::string path_in_cache = is_relative_scan ? Path::Combine(dir.path, relative_path) : std::string();
+    s_state.watched_files.push_back(WatchedFile{std::move(path), std::move(path_in_cache), timestamp});
+    return;
+  }
+}
+
+std::unique_ptr<DirectoryWatcher> GameList::CreateDirectoryWatcher(const std::vector<WatchedDirectory>& directories)
+{
+  if (!DirectoryWatcher::IsSupported() || directories.empty())
+    return {};
+
+  std::unique_ptr<DirectoryWatcher> watcher = std::make_unique<DirectoryWatcher>();
+  for (const WatchedDirectory& dir : directories)
+    watcher->AddDirectory(dir.full_path, dir.recursive);
+
+  // other files in the game directories, e.g. saves, shouldn't cause refreshes
+  Error error;
+  if (!watcher->Start(&GameList::OnDirectoryChanged,
+                      [](const std::string& path) {
+                        return (IsScannableFilename(path) || !FileSystem::FileExists(path.c_str()));
+                      },
+                      &error))
+  {
+    WARNING_LOG("Failed to watch game list directories: {}", error.GetDescription());
+    return {};
+  }
+
+  return watcher;
+}
+
+void GameList::OnDirectoryChanged()
+{
+  {
+    // picked up by the refresh once it's done, restarting it could mean it never finishes
+    std::unique_lock lock(s_state.watcher_mutex);
+    if (s_state.refresh_in_progress)
+    {
+      s_state.refresh_requested = true;
+      return;
+    }
+  }
+
+  Host::RunOnCoreThread([]() { Host::RefreshGameListAsync(false); });
+}
+
+void GameList::StopWatchingDirectories()
+{
+  std::unique_ptr<DirectoryWatcher> watcher;
+  {
+    std::unique_lock lock(s_state.watcher_mutex);
+    watcher = std::move(s_state.watcher);
+  }
+
+  // Destroyed outside the lock, the watcher thread could be waiting on it in OnDirectoryChanged().
+  watcher.reset();
 }
 
 bool GameList::RescanCustomAttributesForPath(const std::string& path, const INISettingsInterface& custom_attributes_ini)
@@ -1058,10 +1531,7 @@ void GameList::Refresh(bool invalidate_cache, bool only_cache, ProgressCallback*
     FileSystem::OpenLockedFile(Path::Combine(EmuFolders::Cache, "gamelist.cache").c_str(), true, &error);
   if (!cache_file)
     ERROR_LOG("Failed to open game list cache: {}", error.GetDescription());
-  else if (!LoadOrInitializeCache(cache_file.get(), invalidate_cache))
-    cache_file.reset();
-
-  BinaryFileWriter cache_writer(cache_file.get());
+  LoadCache(cache_file.get(), invalidate_cache);
 
   // don't delete the old entries, since the frontend might still access them
   std::vector<Entry> old_entries;
@@ -1088,38 +1558,75 @@ void GameList::Refresh(bool invalidate_cache, bool only_cache, ProgressCallback*
   recursive_dirs.push_back(Path::Combine(EmuFolders::DataRoot, "games"));
 #endif
 
-  if (!dirs.empty() || !recursive_dirs.empty())
   {
-    progress->SetProgressRange(static_cast<u32>(dirs.size() + recursive_dirs.size()));
-    progress->SetProgressValue(0);
+    std::unique_lock lock(s_state.watcher_mutex);
+    s_state.refresh_in_progress = true;
+  }
+
+  ScanContext ctx = {excluded_paths,    played_time, custom_attributes_ini, achievements_progress, progress,
+                     only_cache,        static_cast<bool>(cache_file), {}};
+  ctx.pipeline.queue.SetWorkerCount(ScanPipeline::NUM_WORKERS);
+
+  std::vector<WatchedDirectory> directories = GetWatchedDirectories(dirs, recursive_dirs);
+  std::vector<std::string> changed_paths;
+  if (!invalidate_cache && TakeDirectoryChanges(directories, excluded_paths, &changed_paths))
+  {
+    // nothing's been missed since the last full scan, so only the files which changed need to be looked at
+    VERBOSE_LOG("Applying {} changes to game list directories", changed_paths.size());
+    ApplyDirectoryChanges(changed_paths, excluded_paths);
+    ScanWatchedFiles(ctx);
+  }
+  else
+  {
+    // start watching before the scan, so nothing which changes while it's running is missed
+    StopWatchingDirectories();
+    std::unique_ptr<DirectoryWatcher> watcher = CreateDirectoryWatcher(directories);
+    std::vector<WatchedFile> found_files;
 
-    // we manually count it here, because otherwise pop state updates it itself
-    int directory_counter = 0;
-    for (const std::string& dir : dirs)
+    if (!directories.empty())
     {
-      if (progress->IsCancelled())
-        break;
+      progress->SetProgressRange(static_cast<u32>(directories.size()));
+      progress->SetProgressValue(0);
+
+      // we manually count it here, because otherwise pop state updates it itself
+      int directory_counter = 0;
+      for (const WatchedDirectory& dir : directories)
+      {
+        if (progress->IsCancelled())
+          break;
 
-      ScanDirectory(dir, false, only_cache, excluded_paths, played_time, custom_attributes_ini, achievements_progress,
-                    cache_writer, progress);
-      progress->SetProgressValue(++directory_counter);
+        ScanDirectory(ctx, dir, watcher ? &found_files : nullptr);
+        progress->SetProgressValue(++directory_counter);
+      }
     }
-    for (const std::string& dir : recursive_dirs)
-    {
-      if (progress->IsCancelled())
-        break;
 
-      ScanDirectory(dir, true, only_cache, excluded_paths, played_time, custom_attributes_ini, achievements_progress,
-                    cache_writer, progress);
-      progress->SetProgressValue(++directory_counter);
+    // later refreshes can only skip the scan if this one saw everything
+    if (watcher && !progress->IsCancelled())
+    {
+      std::unique_lock lock(s_state.watcher_mutex);
+      s_state.watcher = std::move(watcher);
+      s_state.watched_directories = std::move(directories);
+      s_state.watched_excluded_paths = excluded_paths;
+      s_state.watched_files = std::move(found_files);
     }
   }
 
-  // don't need unused cache entries
-  s_state.cache_map.clear();
+  // unused entries are dropped, unless we didn't get to look for them
+  if (cache_file)
+    WriteCache(cache_file.get(), progress->IsCancelled());
+  ResetCache();
 
   // merge multi-disc games
   CreateDiscSetEntries(excluded_paths, played_time, custom_attributes_ini);
+
+  bool refresh_again;
+  {
+    std::unique_lock lock(s_state.watcher_mutex);
+    s_state.refresh_in_progress = false;
+    refresh_again = (std::exchange(s_state.refresh_requested, false) && s_state.watcher);
+  }
+  if (refresh_again)
+    Host::RunOnCoreThread([]() { Host::RefreshGameListAsync(false); });
 }
 
 GameList::EntryList GameList::TakeEntryList()
@@ -1363,6 +1870,11 @@ std::string GameList::GetPlayedTimePath()
   return Path::Combine(EmuFolders::DataRoot, "playtime.dat");
 }
 
+std::string GameList::GetPlayedTimeJournalPath()
+{
+  return Path::Combine(EmuFolders::DataRoot, "playtime.journal");
+}
+
 bool GameList::ParsePlayedTimeLine(char* line, std::string_view& serial, PlayedTimeEntry& entry)
 {
   size_t len = std::strlen(line);
@@ -1399,92 +1911,191 @@ std::string GameList::MakePlayedTimeLine(std::string_view serial, const PlayedTi
                      entry.last_played_time, static_cast<unsigned>(PLAYED_TIME_LAST_TIME_LENGTH));
 }
 
-GameList::PlayedTimeMap GameList::LoadPlayedTimeMap()
+void GameList::ReadPlayedTimeFile(std::FILE* fp, PlayedTimeMap& map)
 {
-  PlayedTimeMap ret;
-
-  Error error;
-  FileSystem::LockedFile fp = FileSystem::OpenLockedFile(GetPlayedTimePath().c_str(), false, &error);
-  if (!fp)
-  {
-    ERROR_LOG("Failed to load played time map: {}", error.GetDescription());
-    return ret;
-  }
-
   char line[256];
-  while (std::fgets(line, sizeof(line), fp.get()))
+  while (std::fgets(line, sizeof(line), fp))
   {
     std::string_view serial;
     PlayedTimeEntry entry;
     if (!ParsePlayedTimeLine(line, serial, entry))
       continue;
 
-    if (ret.find(serial) != ret.end())
+    if (map.find(serial) != map.end())
     {
       WARNING_LOG("Duplicate entry: '{}'", serial);
       continue;
     }
 
-    ret.emplace(std::string(serial), entry);
+    map.emplace(std::string(serial), entry);
   }
+}
 
-  return ret;
+u32 GameList::ReadPlayedTimeJournal(std::FILE* fp, PlayedTimeMap& map)
+{
+  u32 count = 0;
+  char line[256];
+  while (std::fgets(line, sizeof(line), fp))
+  {
+    std::string_view serial;
+    PlayedTimeEntry delta;
+    if (!ParsePlayedTimeLine(line, serial, delta))
+      continue;
+
+    ApplyPlayedTimeDelta(map, serial, delta);
+    count++;
+  }
+
+  return count;
 }
 
-GameList::PlayedTimeEntry GameList::UpdatePlayedTimeFile(const std::string_view serial, std::time_t last_time,
-                                                         std::time_t add_time)
+void GameList::ApplyPlayedTimeDelta(PlayedTimeMap& map, std::string_view serial, const PlayedTimeEntry& delta)
 {
-  const PlayedTimeEntry new_entry{last_time, add_time};
+  // journal records are the arguments to UpdatePlayedTimeFile(), a zero last time is a reset
+  auto iter = map.find(serial);
+  if (delta.last_played_time == 0)
+  {
+    if (iter != map.end())
+      iter->second = PlayedTimeEntry{0, 0};
+    return;
+  }
+
+  if (iter == map.end())
+    iter = map.emplace(std::string(serial), PlayedTimeEntry{0, 0}).first;
 
+  iter->second.last_played_time = delta.last_played_time;
+  iter->second.total_played_time += delta.total_played_time;
+}
+
+GameList::PlayedTimeMap GameList::LoadPlayedTimeMap()
+{
+  std::unique_lock lock(s_state.played_time_mutex);
+  LockedLoadPlayedTimeMap();
+  return s_state.played_time_map;
+}
+
+void GameList::LockedLoadPlayedTimeMap()
+{
+  PlayedTimeMap map;
+  u32 journal_entries = 0;
+
+  // the base file stays locked while the journal is read, otherwise a compaction in between could be missed
   Error error;
-  FileSystem::LockedFile fp = FileSystem::OpenLockedFile(GetPlayedTimePath().c_str(), true, &error);
-  if (!fp)
+  FileSystem::LockedFile fp = FileSystem::OpenLockedFile(GetPlayedTimePath().c_str(), false, &error);
+  if (fp)
+    ReadPlayedTimeFile(fp.get(), map);
+  else
+    ERROR_LOG("Failed to load played time map: {}", error.GetDescription());
+
+  if (FileSystem::FileExists(GetPlayedTimeJournalPath().c_str()))
   {
-    ERROR_LOG("Failed to open played time map for update: {}", error.GetDescription());
-    return new_entry;
+    FileSystem::LockedFile journal_fp = FileSystem::OpenLockedFile(GetPlayedTimeJournalPath().c_str(), false, &error);
+    if (journal_fp)
+      journal_entries = ReadPlayedTimeJournal(journal_fp.get(), map);
+    else
+      ERROR_LOG("Failed to load played time journal: {}", error.GetDescription());
   }
 
-  for (;;)
-  {
-    char line[256];
-    const s64 line_pos = FileSystem::FTell64(fp.get());
-    if (!std::fgets(line, sizeof(line), fp.get()))
-      break;
+  s_state.played_time_map = std::move(map);
+  s_state.played_time_journal_entries = journal_entries;
+  s_state.played_time_map_loaded = true;
 
-    std::string_view line_serial;
-    PlayedTimeEntry line_entry;
-    if (!ParsePlayedTimeLine(line, line_serial, line_entry))
-      continue;
+  if (journal_entries >= PLAYED_TIME_JOURNAL_COMPACT_THRESHOLD)
+    QueuePlayedTimeCompaction();
+}
 
-    if (line_serial != serial)
-      continue;
+GameList::PlayedTimeEntry GameList::UpdatePlayedTimeFile(const std::string_view serial, std::time_t last_time,
+                                                         std::time_t add_time)
+{
+  const PlayedTimeEntry delta{last_time, add_time};
 
-    // found it!
-    line_entry.last_played_time = (last_time != 0) ? last_time : 0;
-    line_entry.total_played_time = (last_time != 0) ? (line_entry.total_played_time + add_time) : 0;
+  std::unique_lock lock(s_state.played_time_mutex);
+  if (!s_state.played_time_map_loaded)
+    LockedLoadPlayedTimeMap();
 
-    const std::string new_line = MakePlayedTimeLine(serial, line_entry);
-    if (FileSystem::FSeek64(fp.get(), line_pos, SEEK_SET) != 0 ||
+  // only an append, rather than rewriting the line in place, totals are summed up when the journal is read back
+  Error error;
+  FileSystem::LockedFile fp = FileSystem::OpenLockedFile(GetPlayedTimeJournalPath().c_str(), true, &error);
+  if (fp)
+  {
+    const std::string new_line = MakePlayedTimeLine(serial, delta);
+    if (FileSystem::FSeek64(fp.get(), 0, SEEK_END) != 0 ||
         std::fwrite(new_line.data(), new_line.length(), 1, fp.get()) != 1)
     {
-      ERROR_LOG("Failed to update '{}' in played time map.", serial);
+      ERROR_LOG("Failed to append '{}' to played time journal.", serial);
     }
 
-    return line_entry;
+    fp.reset();
+    s_state.played_time_journal_entries++;
+  }
+  else
+  {
+    ERROR_LOG("Failed to open played time journal for update: {}", error.GetDescription());
   }
 
-  if (last_time != 0)
+  ApplyPlayedTimeDelta(s_state.played_time_map, serial, delta);
+  if (s_state.played_time_journal_entries >= PLAYED_TIME_JOURNAL_COMPACT_THRESHOLD)
+    QueuePlayedTimeCompaction();
+
+  const auto iter = s_state.played_time_map.find(serial);
+  return (iter != s_state.played_time_map.end()) ? iter->second : PlayedTimeEntry{0, 0};
+}
+
+void GameList::QueuePlayedTimeCompaction()
+{
+  if (s_state.played_time_compaction_queued)
+    return;
+
+  s_state.played_time_compaction_queued = true;
+  Host::QueueAsyncTask(&GameList::CompactPlayedTimeJournal);
+}
+
+void GameList::CompactPlayedTimeJournal()
+{
+  std::unique_lock lock(s_state.played_time_mutex);
+  s_state.played_time_compaction_queued = false;
+
+  // same lock order as loading, base file first
+  Error error;
+  FileSystem::LockedFile fp = FileSystem::OpenLockedFile(GetPlayedTimePath().c_str(), true, &error);
+  FileSystem::LockedFile journal_fp;
+  if (!fp || !(journal_fp = FileSystem::OpenLockedFile(GetPlayedTimeJournalPath().c_str(), true, &error)))
   {
-    // new entry.
-    const std::string new_line = MakePlayedTimeLine(serial, new_entry);
-    if (FileSystem::FSeek64(fp.get(), 0, SEEK_END) != 0 ||
-        std::fwrite(new_line.data(), new_line.length(), 1, fp.get()) != 1)
-    {
-      ERROR_LOG("Failed to append '{}' to played time map.", serial);
-    }
+    ERROR_LOG("Failed to open played time files for compaction: {}", error.GetDescription());
+    return;
+  }
+
+  // re-read both, another instance could have appended since we last looked
+  PlayedTimeMap map;
+  ReadPlayedTimeFile(fp.get(), map);
+  const u32 journal_entries = ReadPlayedTimeJournal(journal_fp.get(), map);
+
+  std::string data;
+  data.reserve(map.size() * (PLAYED_TIME_LINE_LENGTH + 1));
+  for (const auto& [serial, entry] : map)
+  {
+    if (entry.last_played_time != 0)
+      data.append(MakePlayedTimeLine(serial, entry));
+  }
+
+  // journal is only cleared once the base file has been rewritten with it folded in
+  if (!FileSystem::FTruncate64(fp.get(), 0, &error) || FileSystem::FSeek64(fp.get(), 0, SEEK_SET) != 0 ||
+      (!data.empty() && std::fwrite(data.data(), data.length(), 1, fp.get()) != 1) || std::fflush(fp.get()) != 0)
+  {
+    ERROR_LOG("Failed to write compacted played time map: {}", error.GetDescription());
+    return;
+  }
+
+  if (!FileSystem::FTruncate64(journal_fp.get(), 0, &error))
+  {
+    ERROR_LOG("Failed to truncate played time journal: {}", error.GetDescription());
+    return;
   }
 
-  return new_entry;
+  VERBOSE_LOG("Compacted {} played time journal entries into {} games", journal_entries, map.size());
+  s_state.played_time_map = std::move(map);
+  s_state.played_time_journal_entries = 0;
+  s_state.played_time_map_loaded = true;
 }
 
 void GameList::AddPlayedTimeForSerial(const std::string& serial, std::time_t last_time, std::time_t add_time)
@@ -1741,7 +2352,8 @@ bool GameList::DownloadCovers(const std::vector<std::string>& url_templates, boo
     return false;
   }
 
-  std::vector<std::pair<std::string, std::string>> download_urls;
+  // each entry's templates are tried in order, until one of them succeeds
+  std::vector<std::pair<std::string, std::vector<std::string>>> download_urls;
   {
     std::unique_lock lock(s_state.mutex);
     for (const GameList::Entry& entry : s_state.entries)
@@ -1750,6 +2362,7 @@ bool GameList::DownloadCovers(const std::vector<std::string>& url_templates, boo
       if (!existing_path.empty())
         continue;
 
+      std::vector<std::string> urls;
       for (const std::string& url_template : url_templates)
       {
         std::string url(url_template);
@@ -1767,8 +2380,10 @@ bool GameList::DownloadCovers(const std::vector<std::string>& url_templates, boo
         if (has_serial)
           StringUtil::ReplaceAll(&url, "${serial}", Path::URLEncode(entry.serial));
 
-        download_urls.emplace_back(entry.path, std::move(url));
+        urls.push_back(std::move(url));
       }
+
+      download_urls.emplace_back(entry.path, std::move(urls));
     }
   }
   if (download_urls.empty())
@@ -1787,10 +2402,51 @@ bool GameList::DownloadCovers(const std::vector<std::string>& url_templates, boo
   progress->SetCancellable(true);
   progress->SetProgressRange(static_cast<u32>(download_urls.size()));
 
-  for (auto& [entry_path, url] : download_urls)
-  {
-    if (progress->IsCancelled())
-      break;
+  const auto save_cover = [use_serial, &save_callback, progress](const std::string& entry_path,
+                                                                 const std::string& filename,
+                                                                 const std::string& content_type,
+                                                                 const HTTPDownloader::Request::Data& data) {
+    std::unique_lock lock(s_state.mutex);
+    const GameList::Entry* entry = GetEntryForPath(entry_path);
+    if (!entry || !GetCoverImagePathForEntry(entry).empty())
+      return;
+
+    progress->SetStatusText(entry->GetDisplayTitle(true));
+
+    // prefer the content type from the response for the extension
+    // otherwise, if it's missing, and the request didn't have an extension.. fall back to jpegs.
+    std::string template_filename;
+    std::string content_type_extension(HTTPDownloader::GetExtensionForContentType(content_type));
+
+    // don't treat the domain name as an extension..
+    const std::string::size_type last_slash = filename.find('/');
+    const std::string::size_type last_dot = filename.find('.');
+    if (!content_type_extension.empty())
+      template_filename = fmt::format("cover.{}", content_type_extension);
+    else if (last_slash != std::string::npos && last_dot != std::string::npos && last_dot > last_slash)
+      template_filename = Path::GetFileName(filename);
+    else
+      template_filename = "cover.jpg";
+
+    std::string write_path(GetNewCoverImagePathForEntry(entry, template_filename.c_str(), use_serial));
+    if (write_path.empty())
+      return;
+
+    if (FileSystem::WriteBinaryFile(write_path.c_str(), data.data(), data.size()) && save_callback)
+      save_callback(entry, std::move(write_path));
+  };
+
+  // callbacks run from PollRequests() on this thread, so the next template can be queued from them
+  std::function<void(size_t, size_t)> start_download;
+  start_download = [&download_urls, &downloader, &start_download, &save_cover, progress](size_t entry_index,
+                                                                                        size_t url_index) {
+    const std::string& entry_path = download_urls[entry_index].first;
+    const std::vector<std::string>& urls = download_urls[entry_index].second;
+    if (url_index == urls.size() || progress->IsCancelled())
+    {
+      progress->IncrementProgressValue();
+      return;
+    }
 
     // make sure it didn't get done already
     {
@@ -1799,53 +2455,44 @@ bool GameList::DownloadCovers(const std::vector<std::string>& url_templates, boo
       if (!entry || !GetCoverImagePathForEntry(entry).empty())
       {
         progress->IncrementProgressValue();
-        continue;
+        return;
       }
-
-      progress->SetStatusText(entry->GetDisplayTitle(true));
     }
 
-    // we could actually do a few in parallel here...
-    std::string filename = Path::URLDecode(url);
-    downloader->CreateRequest(std::move(url), [use_serial, &save_callback, entry_path = std::move(entry_path),
-                                               filename = std::move(filename)](s32 status_code, const Error& error,
-                                                                               const std::string& content_type,
-                                                                               HTTPDownloader::Request::Data data) {
+    const std::string& url = urls[url_index];
+    downloader->CreateRequest(url, [&start_download, &save_cover, &entry_path, progress, entry_index, url_index,
+                                    filename = Path::URLDecode(url)](s32 status_code, const Error& error,
+                                                                     const std::string& content_type,
+                                                                     HTTPDownloader::Request::Data data) {
       if (status_code != HTTPDownloader::HTTP_STATUS_OK || data.empty())
       {
         ERROR_LOG("Download for {} failed: {}", Path::GetFileName(filename), error.GetDescription());
+        start_download(entry_index, url_index + 1);
         return;
       }
 
-      std::unique_lock lock(s_state.mutex);
-      const GameList::Entry* entry = GetEntryForPath(entry_path);
-      if (!entry || !GetCoverImagePathForEntry(entry).empty())
-        return;
+      save_cover(entry_path, filename, content_type, data);
+      progress->IncrementProgressValue();
+    });
+  };
 
-      // prefer the content type from the response for the extension
-      // otherwise, if it's missing, and the request didn't have an extension.. fall back to jpegs.
-      std::string template_filename;
-      std::string content_type_extension(HTTPDownloader::GetExtensionForContentType(content_type));
-
-      // don't treat the domain name as an extension..
-      const std::string::size_type last_slash = filename.find('/');
-      const std::string::size_type last_dot = filename.find('.');
-      if (!content_type_extension.empty())
-        template_filename = fmt::format("cover.{}", content_type_extension);
-      else if (last_slash != std::string::npos && last_dot != std::string::npos && last_dot > last_slash)
-        template_filename = Path::GetFileName(filename);
-      else
-        template_filename = "cover.jpg";
+  // different games are downloaded in parallel, most will come from the same host
+  static constexpr u32 MAX_CONCURRENT_COVER_DOWNLOADS = 8;
+  downloader->SetMaxActiveRequests(MAX_CONCURRENT_COVER_DOWNLOADS);
+  for (size_t i = 0; i < download_urls.size(); i++)
+    start_download(i, 0);
 
-      std::string write_path(GetNewCoverImagePathForEntry(entry, template_filename.c_str(), use_serial));
-      if (write_path.empty())
-        return;
+  while (downloader->HasAnyRequests())
+  {
+    if (progress->IsCancelled())
+    {
+      downloader->CancelAllRequests();
+      break;
+    }
 
-      if (FileSystem::WriteBinaryFile(write_path.c_str(), data.data(), data.size()) && save_callback)
-        save_callback(entry, std::move(write_path));
-    });
-    downloader->WaitForAllRequests();
-    progress->IncrementProgressValue();
+    // Don't burn too much CPU.
+    Timer::NanoSleep(1000000);
+    downloader->PollRequests();
   }
 
   return true;
@@ -2043,9 +2690,74 @@ void GameList::ReloadMemcardTimestampCache()
     return;
   }
 
+  // Updates are appended, so drop all but the last record for each serial.
+  const size_t removed = RemoveDuplicateMemcardTimestampCacheEntries(s_state.memcard_timestamp_cache_entries);
+  if (removed >= MEMCARD_TIMESTAMP_CACHE_COMPACT_THRESHOLD)
+    Host::QueueAsyncTask(&GameList::CompactMemcardTimestampCache);
+}
+
+size_t GameList::RemoveDuplicateMemcardTimestampCacheEntries(std::vector<MemcardTimestampCacheEntry>& entries)
+{
   // Just in case.
-  for (MemcardTimestampCacheEntry& entry : s_state.memcard_timestamp_cache_entries)
+  for (MemcardTimestampCacheEntry& entry : entries)
     entry.serial[sizeof(entry.serial) - 1] = 0;
+
+  const size_t count = entries.size();
+  for (size_t i = 0; i < entries.size(); i++)
+  {
+    for (size_t j = i + 1; j < entries.size(); j++)
+    {
+      if (StringUtil::EqualNoCase(entries[i].serial, entries[j].serial))
+      {
+        entries[i] = entries[j];
+        entries.erase(entries.begin() + j);
+        j--;
+      }
+    }
+  }
+
+  return count - entries.size();
+}
+
+void GameList::CompactMemcardTimestampCache()
+{
+  Error error;
+  FileSystem::LockedFile fp = FileSystem::OpenLockedFile(GetMemcardTimestampCachePath().c_str(), true, &error);
+  if (!fp)
+  {
+    ERROR_LOG("Failed to open memory card cache for compaction: {}", error.GetDescription());
+    return;
+  }
+
+  // re-read under the lock, it could have been appended to since we loaded it
+  const s64 file_size = FileSystem::FSize64(fp.get());
+  char signature[sizeof(MEMCARD_TIMESTAMP_CACHE_SIGNATURE)];
+  if (file_size < static_cast<s64>(sizeof(MEMCARD_TIMESTAMP_CACHE_SIGNATURE)) ||
+      std::fread(signature, sizeof(signature), 1, fp.get()) != 1 ||
+      std::memcmp(signature, MEMCARD_TIMESTAMP_CACHE_SIGNATURE, sizeof(signature)) != 0)
+  {
+    return;
+  }
+
+  std::vector<MemcardTimestampCacheEntry> entries(
+    (static_cast<size_t>(file_size) - sizeof(MEMCARD_TIMESTAMP_CACHE_SIGNATURE)) / sizeof(MemcardTimestampCacheEntry));
+  if (std::fread(entries.data(), sizeof(MemcardTimestampCacheEntry), entries.size(), fp.get()) != entries.size())
+    return;
+
+  const size_t removed = RemoveDuplicateMemcardTimestampCacheEntries(entries);
+  if (removed == 0)
+    return;
+
+  if (FileSystem::FSeek64(fp.get(), sizeof(MEMCARD_TIMESTAMP_CACHE_SIGNATURE), SEEK_SET) != 0 ||
+      (!entries.empty() &&
+       std::fwrite(entries.data(), sizeof(MemcardTimestampCacheEntry), entries.size(), fp.get()) != entries.size()) ||
+      !FileSystem::FTruncate64(fp.get(), FileSystem::FTell64(fp.get()), &error))
+  {
+    ERROR_LOG("Failed to compact memory card cache: {}", error.GetDescription());
+    return;
+  }
+
+  VERBOSE_LOG("Removed {} stale records from memory card cache", removed);
 }
 
 std::string GameList::GetGameIconPath(const GameList::Entry* entry)
@@ -2172,33 +2884,10 @@ bool GameList::UpdateMemcardTimestampCache(const MemcardTimestampCacheEntry& ent
     }
   }
 
-  // need to seek to switch from read->write?
-  s64 current_pos = sizeof(MEMCARD_TIMESTAMP_CACHE_SIGNATURE);
-  if (FileSystem::FSeek64(fp.get(), current_pos, SEEK_SET) != 0)
-    return false;
-
-  for (;;)
-  {
-    MemcardTimestampCacheEntry existing_entry;
-    if (std::fread(&existing_entry, sizeof(existing_entry), 1, fp.get()) != 1)
-      break;
-
-    existing_entry.serial[sizeof(existing_entry.serial) - 1] = 0;
-    if (!StringUtil::EqualNoCase(existing_entry.serial, entry.serial))
-    {
-      current_pos += sizeof(existing_entry);
-      continue;
-    }
-
-    // found it here, so overwrite
-    return (FileSystem::FSeek64(fp.get(), current_pos, SEEK_SET) == 0 &&
-            std::fwrite(&entry, sizeof(entry), 1, fp.get()) == 1);
-  }
-
-  if (FileSystem::FSeek64(fp.get(), current_pos, SEEK_SET) != 0)
+  // Always appended rather than overwriting the old record, the last one for a serial wins when loading.
+  if (FileSystem::FSeek64(fp.get(), 0, SEEK_END) != 0)
     return false;
 
-  // append it.
   return (std::fwrite(&entry, sizeof(entry), 1, fp.get()) == 1);
 }
 
@@ -2222,7 +2911,7 @@ std::string GameList::GetAchievementGameBadgePath(u32 game_id)
     if (!badge_name.empty())
     {
       ret = Achievements::GetGameBadgePath(badge_name);
-      if (!FileSystem::FileExists(ret.c_str()))
+      if (!Achievements::HasCachedImage(ret))
         ret.clear();
     }
   }
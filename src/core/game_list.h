@@ -122,8 +122,13 @@ bool CanEditGameSettingsForPath(const std::string_view path, const std::string_v
 /// Populates the game list with files in the configured directories.
 /// If invalidate_cache is set, all files will be re-scanned.
 /// If only_cache is set, no new files will be scanned, only those present in the cache.
+/// Where the platform supports it, the directories are watched after a full scan, and a refresh is queued when files
+/// change. Later refreshes then only look at the files which changed, instead of enumerating the directories again.
 void Refresh(bool invalidate_cache, bool only_cache = false, ProgressCallback* progress = nullptr);
 
+/// Stops watching the game directories for changes, until the next full refresh. Call before shutting down the host.
+void StopWatchingDirectories();
+
 /// Moves the current game list, which can be temporarily displayed in the UI until refresh completes.
 /// The caller **must** call Refresh() afterward, otherwise it will be permanently lost.
 EntryList TakeEntryList();
@@ -3,6 +3,7 @@
 
 #include "gdb_server.h"
 #include "bus.h"
+#include "cpu_code_cache.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 #include "system.h"
@@ -15,7 +16,10 @@
 
 #include "util/sockets.h"
 
+#include <iterator>
 #include <optional>
+#include <span>
+#include <string>
 
 LOG_CHANNEL(GDBServer);
 
@@ -34,6 +38,9 @@ public:
 
   void SendReplyWithAck(std::string_view reply = std::string_view());
 
+  bool IsNoAckMode() const { return m_no_ack_mode; }
+  void SetNoAckMode() { m_no_ack_mode = true; }
+
 protected:
   void OnConnected() override;
   void OnDisconnected(const Error& error) override;
@@ -43,11 +50,17 @@ private:
   void SendPacket(std::string_view sv);
 
   bool m_seen_resume = false;
+  bool m_no_ack_mode = false;
 };
 
 } // namespace
 
 static u8 ComputeChecksum(std::string_view str);
+static void AppendEscapedBinary(SmallStringBase& dst, std::span<const u8> data);
+static bool DecodeEscapedBinary(llvm::SmallVectorImpl<u8>& dst, std::string_view src);
+static bool ParseAddressAndLength(std::string_view* caret, VirtualMemoryAddress* address, u32* length);
+static void InvalidateWrittenMemory(VirtualMemoryAddress address, u32 length);
+static std::string GetMemoryMapXML();
 
 static bool Cmd$_questionMark(ClientSocket* client, std::string_view data);
 static bool Cmd$g(ClientSocket* client, std::string_view data);
@@ -55,22 +68,29 @@ static bool Cmd$G(ClientSocket* client, std::string_view data);
 static bool Cmd$H(ClientSocket* client, std::string_view data);
 static bool Cmd$m(ClientSocket* client, std::string_view data);
 static bool Cmd$M(ClientSocket* client, std::string_view data);
+static bool Cmd$x(ClientSocket* client, std::string_view data);
+static bool Cmd$X(ClientSocket* client, std::string_view data);
 static bool Cmd$s(ClientSocket* client, std::string_view data);
 template<bool add_breakpoint>
 static bool Cmd$z(ClientSocket* client, std::string_view data);
 static bool Cmd$vMustReplyEmpty(ClientSocket* client, std::string_view data);
 static bool Cmd$qSupported(ClientSocket* client, std::string_view data);
+static bool Cmd$qXferMemoryMapRead(ClientSocket* client, std::string_view data);
+static bool Cmd$QStartNoAckMode(ClientSocket* client, std::string_view data);
 
 static bool IsPacketAck(std::string_view data);
 static bool IsPacketInterrupt(std::string_view data);
 static bool IsPacketContinue(std::string_view data);
 
-static bool IsPacketComplete(std::string_view data);
+static size_t GetPacketSize(std::string_view data);
 static bool ProcessPacket(ClientSocket* socket, std::string_view data);
 
 /// yikes, lots of stack space
 using LargeReplyPacket = SmallStackString<768>;
 
+/// Largest packet we accept, reported to the client. The read buffer has to hold an escaped 'X' packet this long.
+static constexpr u32 MAX_PACKET_SIZE = 0x4000;
+
 /// Number of registers in GDB remote protocol for MIPS III.
 static constexpr int NUM_GDB_REGISTERS = 73;
 
@@ -125,11 +145,15 @@ static constexpr std::pair<std::string_view, bool (*)(ClientSocket*, std::string
   {"H", Cmd$H},
   {"m", Cmd$m},
   {"M", Cmd$M},
+  {"x", Cmd$x},
+  {"X", Cmd$X},
   {"s", Cmd$s},
   {"z", Cmd$z<false>},
   {"Z", Cmd$z<true>},
   {"vMustReplyEmpty", Cmd$vMustReplyEmpty},
   {"qSupported", Cmd$qSupported},
+  {"qXfer:memory-map:read::", Cmd$qXferMemoryMapRead},
+  {"QStartNoAckMode", Cmd$QStartNoAckMode},
 };
 
 static std::shared_ptr<ListenSocket> s_gdb_listen_socket;
@@ -146,6 +170,103 @@ u8 GDBServer::ComputeChecksum(std::string_view str)
   return checksum;
 }
 
+void GDBServer::AppendEscapedBinary(SmallStringBase& dst, std::span<const u8> data)
+{
+  for (const u8 byte : data)
+  {
+    if (byte == '#' || byte == '$' || byte == '}' || byte == '*')
+    {
+      dst.append('}');
+      dst.append(static_cast<char>(byte ^ 0x20));
+    }
+    else
+    {
+      dst.append(static_cast<char>(byte));
+    }
+  }
+}
+
+bool GDBServer::DecodeEscapedBinary(llvm::SmallVectorImpl<u8>& dst, std::string_view src)
+{
+  for (size_t i = 0; i < src.size(); i++)
+  {
+    if (src[i] == '}')
+    {
+      if (++i == src.size())
+        return false;
+
+      dst.push_back(static_cast<u8>(src[i]) ^ 0x20);
+    }
+    else
+    {
+      dst.push_back(static_cast<u8>(src[i]));
+    }
+  }
+
+  return true;
+}
+
+bool GDBServer::ParseAddressAndLength(std::string_view* caret, VirtualMemoryAddress* address, u32* length)
+{
+  // address,length
+  std::optional<VirtualMemoryAddress> parsed_address;
+  std::optional<u32> parsed_length;
+  if (!(parsed_address = StringUtil::FromChars<VirtualMemoryAddress>(*caret, 16, caret)).has_value() ||
+      caret->empty() || (*caret)[0] != ',' ||
+      !(parsed_length = StringUtil::FromChars<u32>(caret->substr(1), 16, caret)).has_value())
+  {
+    return false;
+  }
+
+  *address = parsed_address.value();
+  *length = parsed_length.value();
+  return true;
+}
+
+void GDBServer::InvalidateWrittenMemory(VirtualMemoryAddress address, u32 length)
+{
+  // Writes from here don't go through the protected mapping, so anything compiled from the old code stays around.
+  const PhysicalMemoryAddress phys_address = CPU::VirtualAddressToPhysical(address);
+  if (length == 0 || !Bus::IsRAMAddress(phys_address))
+    return;
+
+  const u32 start_page = Bus::GetRAMCodePageIndex(phys_address);
+  const u32 end_page = Bus::GetRAMCodePageIndex(phys_address + length - 1);
+  for (u32 i = start_page; i <= end_page; i++)
+  {
+    Bus::MarkRAMPageDirty(i);
+    if (Bus::IsRAMCodePage(i))
+      CPU::CodeCache::InvalidateBlocksWithPageIndex(i);
+  }
+}
+
+std::string GDBServer::GetMemoryMapXML()
+{
+  std::string ret = "<?xml version=\"1.0\"?>\n"
+                    "<!DOCTYPE memory-map PUBLIC \"+//IDN gnu.org//DTD GDB Memory Map V1.0//EN\" "
+                    "\"http://sourceware.org/gdb/gdb-memory-map.dtd\">\n"
+                    "<memory-map>\n";
+  const auto add_region = [&ret](const char* type, u32 start, u32 length) {
+    fmt::format_to(std::back_inserter(ret), "<memory type=\"{}\" start=\"0x{:08x}\" length=\"0x{:x}\"/>\n", type, start,
+                   length);
+  };
+
+  // KUSEG, KSEG0, KSEG1. Scratchpad isn't accessible through KSEG1.
+  for (const u32 segment : {0x00000000u, 0x80000000u, 0xA0000000u})
+  {
+    add_region("ram", segment | Bus::RAM_BASE, Bus::RAM_MIRROR_SIZE);
+    add_region("ram", segment | Bus::EXP1_BASE, Bus::EXP1_SIZE);
+    if (segment != 0xA0000000u)
+      add_region("ram", segment | CPU::SCRATCHPAD_ADDR, CPU::SCRATCHPAD_SIZE);
+    add_region("ram", segment | Bus::HW_BASE, Bus::HW_SIZE + Bus::EXP2_SIZE);
+    add_region("ram", segment | Bus::EXP3_BASE, Bus::EXP3_SIZE);
+    add_region("rom", segment | Bus::BIOS_BASE, Bus::BIOS_SIZE);
+  }
+
+  ret += "</memory-map>\n";
+  return ret;
+}
+
 /// Get stop reason.
 bool GDBServer::Cmd$_questionMark(ClientSocket* client, std::string_view data)
 {
@@ -218,12 +339,10 @@ bool GDBServer::Cmd$H(ClientSocket* client, std::string_view data)
 /// Get memory.
 bool GDBServer::Cmd$m(ClientSocket* client, std::string_view data)
 {
-  // address,length
   std::string_view caret = data;
-  std::optional<VirtualMemoryAddress> address;
-  std::optional<u32> length;
-  if (!(address = StringUtil::FromChars<VirtualMemoryAddress>(caret, 16, &caret)).has_value() || caret.empty() ||
-      caret[0] != ',' || !(length = StringUtil::FromChars<u32>(caret.substr(1), 16)).has_value())
+  VirtualMemoryAddress address;
+  u32 length;
+  if (!ParseAddressAndLength(&caret, &address, &length) || length > MAX_PACKET_SIZE)
   {
     ERROR_LOG("Invalid packet: {}", data);
     return false;
@@ -231,10 +350,10 @@ bool GDBServer::Cmd$m(ClientSocket* client, std::string_view data)
 
   // large enough for most requests
   llvm::SmallVector<u8, 128> buffer;
-  buffer.resize_for_overwrite(length.value());
-  if (!CPU::SafeReadMemoryBytes(address.value(), buffer.data(), length.value()))
+  buffer.resize_for_overwrite(length);
+  if (!CPU::SafeReadMemoryBytes(address, buffer.data(), length))
   {
-    ERROR_LOG("Failed to read {} bytes from address 0x{:08X}", buffer.size(), address.value());
+    ERROR_LOG("Failed to read {} bytes from address 0x{:08X}", buffer.size(), address);
     client->SendReplyWithAck("E00");
     return true;
   }
@@ -250,11 +369,9 @@ bool GDBServer::Cmd$M(ClientSocket* client, std::string_view data)
 {
   // address,length:data
   std::string_view caret = data;
-  std::optional<VirtualMemoryAddress> address;
-  std::optional<u32> length;
-  if (!(address = StringUtil::FromChars<VirtualMemoryAddress>(caret, 16, &caret)).has_value() || caret.empty() ||
-      caret[0] != ',' || !(length = StringUtil::FromChars<u32>(caret.substr(1), 16, &caret)).has_value() ||
-      caret.empty() || caret[0] != ':')
+  VirtualMemoryAddress address;
+  u32 length;
+  if (!ParseAddressAndLength(&caret, &address, &length) || caret.empty() || caret[0] != ':')
   {
     ERROR_LOG("Invalid packet: {}", data);
     return false;
@@ -262,7 +379,7 @@ bool GDBServer::Cmd$M(ClientSocket* client, std::string_view data)
 
   // remove ':'
   caret = caret.substr(1);
-  if (length.value() != (caret.size() / 2))
+  if (length != (caret.size() / 2))
   {
     ERROR_LOG("Invalid length in packet {}", data);
     return false;
@@ -270,20 +387,84 @@ bool GDBServer::Cmd$M(ClientSocket* client, std::string_view data)
 
   // large enough for most requests
   llvm::SmallVector<u8, 128> buffer;
-  buffer.resize_for_overwrite(length.value());
+  buffer.resize_for_overwrite(length);
   if (!StringUtil::DecodeHex(buffer, caret))
   {
     ERROR_LOG("Invalid hex in packet {}", data);
     return false;
   }
 
-  if (!CPU::SafeWriteMemoryBytes(address.value(), buffer))
+  if (!CPU::SafeWriteMemoryBytes(address, buffer))
+  {
+    ERROR_LOG("Failed to write {} bytes to {}", buffer.size(), address);
+    client->SendReplyWithAck("E00");
+    return true;
+  }
+
+  InvalidateWrittenMemory(address, length);
+  client->SendReplyWithAck("OK");
+  return true;
+}
+
+/// Get memory, binary reply.
+bool GDBServer::Cmd$x(ClientSocket* client, std::string_view data)
+{
+  std::string_view caret = data;
+  VirtualMemoryAddress address;
+  u32 length;
+  if (!ParseAddressAndLength(&caret, &address, &length) || length > MAX_PACKET_SIZE)
+  {
+    ERROR_LOG("Invalid packet: {}", data);
+    return false;
+  }
+
+  // RAM reads are a straight copy out of the RAM mapping, so this is cheap even for large ranges.
+  llvm::SmallVector<u8, 128> buffer;
+  buffer.resize_for_overwrite(length);
+  if (!CPU::SafeReadMemoryBytes(address, buffer.data(), length))
+  {
+    ERROR_LOG("Failed to read {} bytes from address 0x{:08X}", buffer.size(), address);
+    client->SendReplyWithAck("E00");
+    return true;
+  }
+
+  SmallString reply;
+  reply.reserve(length + (length / 8) + 1);
+  reply.append('b');
+  AppendEscapedBinary(reply, buffer);
+  client->SendReplyWithAck(reply);
+  return true;
+}
+
+/// Set memory, binary payload.
+bool GDBServer::Cmd$X(ClientSocket* client, std::string_view data)
+{
+  // address,length:data
+  std::string_view caret = data;
+  VirtualMemoryAddress address;
+  u32 length;
+  if (!ParseAddressAndLength(&caret, &address, &length) || caret.empty() || caret[0] != ':')
+  {
+    ERROR_LOG("Invalid packet: {}", data);
+    return false;
+  }
+
+  llvm::SmallVector<u8, 128> buffer;
+  if (!DecodeEscapedBinary(buffer, caret.substr(1)) || buffer.size() != length)
+  {
+    ERROR_LOG("Invalid binary data in 'X' packet, expected {} bytes", length);
+    return false;
+  }
+
+  // zero-length writes are used to probe for support
+  if (length > 0 && !CPU::SafeWriteMemoryBytes(address, buffer))
   {
-    ERROR_LOG("Failed to write {} bytes to {}", buffer.size(), address.value());
+    ERROR_LOG("Failed to write {} bytes to {}", buffer.size(), address);
     client->SendReplyWithAck("E00");
     return true;
   }
 
+  InvalidateWrittenMemory(address, length);
   client->SendReplyWithAck("OK");
   return true;
 }
@@ -375,7 +556,40 @@ bool GDBServer::Cmd$vMustReplyEmpty(ClientSocket* client, std::string_view data)
 
 bool GDBServer::Cmd$qSupported(ClientSocket* client, std::string_view data)
 {
-  client->SendReplyWithAck();
+  client->SendReplyWithAck(TinyString::from_format("PacketSize={:x};qXfer:memory-map:read+;QStartNoAckMode+;"
+                                                   "binary-upload+",
+                                                   MAX_PACKET_SIZE));
+  return true;
+}
+
+bool GDBServer::Cmd$qXferMemoryMapRead(ClientSocket* client, std::string_view data)
+{
+  // offset,length
+  std::string_view caret = data;
+  VirtualMemoryAddress offset;
+  u32 length;
+  if (!ParseAddressAndLength(&caret, &offset, &length))
+  {
+    ERROR_LOG("Invalid packet: {}", data);
+    return false;
+  }
+
+  // 'm' if there's more to come, 'l' for the last chunk
+  const std::string xml = GetMemoryMapXML();
+  const std::string_view chunk =
+    (offset < xml.size()) ? std::string_view(xml).substr(offset, length) : std::string_view();
+  SmallString reply;
+  reply.append(((offset + chunk.size()) < xml.size()) ? 'm' : 'l');
+  AppendEscapedBinary(reply, std::span<const u8>(reinterpret_cast<const u8*>(chunk.data()), chunk.size()));
+  client->SendReplyWithAck(reply);
+  return true;
+}
+
+bool GDBServer::Cmd$QStartNoAckMode(ClientSocket* client, std::string_view data)
+{
+  // this reply still gets acked, everything after doesn't
+  client->SendReplyWithAck("OK");
+  client->SetNoAckMode();
   return true;
 }
 
@@ -396,9 +610,18 @@ bool GDBServer::IsPacketContinue(std::string_view data)
   return (data.size() >= 5) && (data.substr(data.size() - 5) == "$c#63");
 }
 
-bool GDBServer::IsPacketComplete(std::string_view data)
+size_t GDBServer::GetPacketSize(std::string_view data)
 {
-  return ((data.size() == 1) && (data[0] == '\003')) || ((data.size() > 3) && (*(data.end() - 3) == '#'));
+  DebugAssert(data.size() >= 1);
+  if (data[0] != '$')
+  {
+    // ack, interrupt, or junk which gets skipped a byte at a time
+    return 1;
+  }
+
+  // $data#xx, binary data escapes '#' so the first one ends the packet
+  const size_t end = data.find('#', 1);
+  return (end != std::string_view::npos && (end + 3) <= data.size()) ? (end + 3) : 0;
 }
 
 bool GDBServer::ProcessPacket(ClientSocket* client, std::string_view data)
@@ -476,60 +699,47 @@ void GDBServer::ClientSocket::OnRead()
   if (buffer.empty())
     return;
 
+  // Handle every complete packet that's arrived, clients can pipeline requests when acks are off.
+  const std::string_view data(reinterpret_cast<const char*>(buffer.data()), buffer.size());
   size_t buffer_offset = 0;
-  while (buffer_offset < buffer.size())
+  while (buffer_offset < data.size())
   {
-    size_t current_packet_size = 1;
-    bool packet_complete = false;
-    for (; (buffer_offset + current_packet_size) <= buffer.size(); current_packet_size++)
+    const size_t current_packet_size = GetPacketSize(data.substr(buffer_offset));
+    if (current_packet_size == 0)
     {
-      const std::string_view current_packet(reinterpret_cast<const char*>(buffer.data() + buffer_offset),
-                                            current_packet_size);
-
-      if (GDBServer::IsPacketAck(current_packet))
-      {
-        // Eat ACKs.
-        if (current_packet[0] == '-')
-          ERROR_LOG("Received negative ack");
+      // Large packets can arrive over several reads.
+      DEBUG_LOG("Incomplete packet, got {} bytes", data.size() - buffer_offset);
+      break;
+    }
 
-        packet_complete = true;
-        break;
-      }
-      else if (GDBServer::IsPacketInterrupt(current_packet))
-      {
-        DEV_LOG("{} > Interrupt request", GetRemoteAddress().ToString());
-        System::PauseSystem(true);
-        packet_complete = true;
-        break;
-      }
-      else if (GDBServer::IsPacketContinue(current_packet))
-      {
-        DEV_LOG("{} > Continue request", GetRemoteAddress().ToString());
-        System::PauseSystem(false);
-        packet_complete = true;
-        break;
-      }
-      else if (GDBServer::IsPacketComplete(current_packet))
-      {
-        DEBUG_LOG("{} > {}", GetRemoteAddress().ToString(), current_packet);
-        if (!ProcessPacket(this, current_packet))
-          SendPacket("-");
+    const std::string_view current_packet = data.substr(buffer_offset, current_packet_size);
+    buffer_offset += current_packet_size;
 
-        packet_complete = true;
-        break;
-      }
+    if (GDBServer::IsPacketAck(current_packet))
+    {
+      // Eat ACKs.
+      if (current_packet[0] == '-')
+        ERROR_LOG("Received negative ack");
     }
-
-    if (!packet_complete)
+    else if (GDBServer::IsPacketInterrupt(current_packet))
     {
-      WARNING_LOG(
-        "Incomplete packet, got {} bytes: {}", buffer.size() - buffer_offset,
-        std::string_view(reinterpret_cast<const char*>(buffer.data() + buffer_offset), buffer.size() - buffer_offset));
-      break;
+      DEV_LOG("{} > Interrupt request", GetRemoteAddress().ToString());
+      System::PauseSystem(true);
+    }
+    else if (GDBServer::IsPacketContinue(current_packet))
+    {
+      DEV_LOG("{} > Continue request", GetRemoteAddress().ToString());
+      System::PauseSystem(false);
+    }
+    else if (current_packet[0] == '$')
+    {
+      DEBUG_LOG("{} > {}", GetRemoteAddress().ToString(), current_packet);
+      if (!ProcessPacket(this, current_packet) && !m_no_ack_mode)
+        SendPacket("-");
     }
     else
     {
-      buffer_offset += current_packet_size;
+      WARNING_LOG("Ignoring unexpected byte 0x{:02X}", static_cast<u8>(current_packet[0]));
     }
   }
 
@@ -562,12 +772,13 @@ void GDBServer::ClientSocket::OnSystemResumed()
   m_seen_resume = true;
 
   // Send ack, in case GDB sent a continue request.
-  SendPacket("+");
+  if (!m_no_ack_mode)
+    SendPacket("+");
 }
 
 void GDBServer::ClientSocket::SendReplyWithAck(std::string_view reply)
 {
-  SendPacket(SmallString::from_format("+${}#{:02x}", reply, ComputeChecksum(reply)));
+  SendPacket(SmallString::from_format("{}${}#{:02x}", m_no_ack_mode ? "" : "+", reply, ComputeChecksum(reply)));
 }
 
 bool GDBServer::Initialize(u16 port)
@@ -578,6 +578,24 @@ void GPU::DMARead(u32* words, u32 word_count)
     words[i] = ReadGPUREAD();
 }
 
+void GPU::DMAWrite(u32 address, std::span<const u32> words)
+{
+  // Fill the FIFO in as few runs as possible, rather than wrapping the tail on every word.
+  while (!words.empty())
+  {
+    const u32 count = std::min(m_fifo.GetContiguousSpace(), static_cast<u32>(words.size()));
+    DebugAssert(count > 0);
+
+    u64* dst = m_fifo.GetWritePointer();
+    for (u32 i = 0; i < count; i++)
+      dst[i] = (ZeroExtend64(address + (i * sizeof(u32))) << 32) | ZeroExtend64(words[i]);
+
+    m_fifo.AdvanceTail(count);
+    address += count * sizeof(u32);
+    words = words.subspan(count);
+  }
+}
+
 void GPU::EndDMAWrite()
 {
   ExecuteCommands();
@@ -1983,12 +2001,14 @@ void GPU::CalculateDrawRect(const GSVector2i& window_size, const GSVector2i& vid
 
 void GPU::ReadVRAM(u16 x, u16 y, u16 width, u16 height)
 {
-  // If we're using the software renderer, we only need to sync the thread.
-  // If stats are enabled, still send the packet to update the read counter.
-  if ((!GPUBackend::IsUsingHardwareBackend() || g_settings.gpu_use_software_renderer_for_readbacks) &&
-      !g_settings.display_show_gpu_stats)
+  // If we're using the software renderer, we only need to wait for the commands that write to the region.
+  // If stats are enabled, still send the packet to update the read counter. Binned software rendering finishes draws
+  // on worker threads, so those have to be waited on by the backend.
+  const bool hardware_backend = GPUBackend::IsUsingHardwareBackend();
+  if ((!hardware_backend || g_settings.gpu_use_software_renderer_for_readbacks) &&
+      (hardware_backend || g_settings.gpu_software_renderer_threads <= 1) && !g_settings.display_show_gpu_stats)
   {
-    GPUBackend::SyncGPUThread(true);
+    GPUThread::SyncGPUThreadForVRAMRead(x, y, width, height);
     return;
   }
 
@@ -2002,6 +2022,10 @@ void GPU::ReadVRAM(u16 x, u16 y, u16 width, u16 height)
 
 void GPU::UpdateVRAM(u16 x, u16 y, u16 width, u16 height, const void* data, bool set_mask, bool check_mask)
 {
+  // Games often upload CLUTs and small sprites a few rows at a time.
+  if (GPUThread::AppendToPendingVRAMWrite(x, y, width, height, data, set_mask, check_mask))
+    return;
+
   const u32 num_words = width * height;
   GPUBackendUpdateVRAMCommand* cmd = GPUBackend::NewUpdateVRAMCommand(num_words);
   cmd->x = x;
@@ -2011,7 +2035,7 @@ void GPU::UpdateVRAM(u16 x, u16 y, u16 width, u16 height, const void* data, bool
   cmd->set_mask_while_drawing = set_mask;
   cmd->check_mask_before_draw = check_mask;
   std::memcpy(cmd->data, data, num_words * sizeof(u16));
-  GPUBackend::PushCommand(cmd);
+  GPUThread::PushVRAMWriteCommand(cmd);
 }
 
 void GPU::ClearDisplay()
@@ -2241,6 +2265,12 @@ void GPU::DrawDebugStateWindow(float scale)
   }
 }
 
+static GPUDumpCompressionMode GetGPUDumpCompressionMode()
+{
+  return Settings::ParseGPUDumpCompressionMode(Core::GetTinyStringSettingValue("GPU", "DumpCompressionMode"))
+    .value_or(Settings::DEFAULT_GPU_DUMP_COMPRESSION_MODE);
+}
+
 bool GPU::StartRecordingGPUDump(const char* path, u32 num_frames /* = 1 */)
 {
   if (m_gpu_dump)
@@ -2260,7 +2290,8 @@ bool GPU::StartRecordingGPUDump(const char* path, u32 num_frames /* = 1 */)
 
   std::string osd_key = fmt::format("GPUDump_{}", Path::GetFileName(path));
   Error error;
-  m_gpu_dump = GPUDump::Recorder::Create(path, System::GetGameSerial(), num_frames, &error);
+  m_gpu_dump =
+    GPUDump::Recorder::Create(path, System::GetGameSerial(), num_frames, GetGPUDumpCompressionMode(), &error);
   if (!m_gpu_dump)
   {
     Host::AddIconOSDMessage(
@@ -2294,14 +2325,13 @@ void GPU::StopRecordingGPUDump()
       OSDMessageType::Error, "GPUDump", ICON_EMOJI_CAMERA_WITH_FLASH,
       fmt::format("{}\n{}", TRANSLATE_SV("GPU", "Failed to close GPU trace:"), error.GetDescription()));
     m_gpu_dump.reset();
+    return;
   }
 
-  // Are we compressing the dump?
-  const GPUDumpCompressionMode compress_mode =
-    Settings::ParseGPUDumpCompressionMode(Core::GetTinyStringSettingValue("GPU", "DumpCompressionMode"))
-      .value_or(Settings::DEFAULT_GPU_DUMP_COMPRESSION_MODE);
+  // Are we compressing the dump? Zstandard dumps are compressed while recording.
+  const GPUDumpCompressionMode compress_mode = GetGPUDumpCompressionMode();
   std::string osd_key = fmt::format("GPUDump_{}", Path::GetFileName(m_gpu_dump->GetPath()));
-  if (compress_mode == GPUDumpCompressionMode::Disabled)
+  if (compress_mode == GPUDumpCompressionMode::Disabled || m_gpu_dump->IsStreamCompressed())
   {
     Host::AddIconOSDMessage(
       OSDMessageType::Info, "GPUDump", ICON_EMOJI_CAMERA_WITH_FLASH,
@@ -125,6 +125,9 @@ public:
   {
     m_fifo.Push((ZeroExtend64(address) << 32) | ZeroExtend64(value));
   }
+
+  /// Writes a block of words which are contiguous in RAM, starting at address.
+  void DMAWrite(u32 address, std::span<const u32> words);
   void EndDMAWrite();
 
   /// Writing to GPU dump.
@@ -3,6 +3,7 @@
 
 #include "gpu_backend.h"
 #include "gpu.h"
+#include "gpu_hw_texture_cache.h"
 #include "gpu_presenter.h"
 #include "gpu_sw_rasterizer.h"
 #include "gpu_thread.h"
@@ -23,6 +24,7 @@
 #include "common/log.h"
 #include "common/path.h"
 #include "common/threading.h"
+#include "common/timer.h"
 
 #include "IconsEmoji.h"
 #include "IconsFontAwesome.h"
@@ -127,6 +129,19 @@ void GPUBackend::UpdatePostProcessingSettings(bool force_reload)
 {
 }
 
+void GPUBackend::OnGameSerialChanged()
+{
+}
+
+void GPUBackend::UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit)
+{
+  GPU_SW_Rasterizer::UpdateCLUT(reg, clut_is_8bit);
+}
+
+void GPUBackend::SetRenderSkip(bool enabled)
+{
+}
+
 GPUThreadCommand* GPUBackend::NewClearVRAMCommand()
 {
   return static_cast<GPUThreadCommand*>(
@@ -267,7 +282,7 @@ void GPUBackend::SyncGPUThread(bool spin)
 
 bool GPUBackend::IsUsingHardwareBackend()
 {
-  return (GPUThread::GetRequestedRenderer().value_or(GPURenderer::Software) != GPURenderer::Software);
+  return Settings::IsHardwareRenderer(GPUThread::GetRequestedRenderer().value_or(GPURenderer::Software));
 }
 
 bool GPUBackend::BeginQueueFrame()
@@ -493,7 +508,7 @@ void GPUBackend::HandleCommand(const GPUThreadCommand* cmd)
     case GPUBackendCommandType::UpdateCLUT:
     {
       const GPUBackendUpdateCLUTCommand* ccmd = static_cast<const GPUBackendUpdateCLUTCommand*>(cmd);
-      GPU_SW_Rasterizer::UpdateCLUT(ccmd->reg, ccmd->clut_is_8bit);
+      UpdateCLUT(ccmd->reg, ccmd->clut_is_8bit);
     }
     break;
 
@@ -564,13 +579,18 @@ void GPUBackend::HandleUpdateDisplayCommand(const GPUBackendUpdateDisplayCommand
   const GSVector4i active_rect = GSVector4i::xyxy(active_origin, active_origin.add32(active_size));
   m_presenter.SetDisplayParameters(display_size, active_rect, cmd->display_pixel_aspect_ratio, cmd->display_24bit);
 
-  UpdateDisplay(cmd);
+  // Skipped frames are never presented, and VRAM on the host GPU may be out of date.
+  if (!m_render_skip)
+    UpdateDisplay(cmd);
   if (cmd->submit_frame)
     HandleSubmitFrameCommand(&cmd->frame);
 }
 
 void GPUBackend::HandleSubmitFrameCommand(const GPUBackendFramePresentationParameters* cmd)
 {
+  // Used by pre-frame sleep to predict when the frame will be ready to present.
+  GPUThread::ReportFrameLatency(Timer::GetCurrentValue() - cmd->submit_time);
+
   // For regtest.
   Host::FrameDoneOnGPUThread(this, cmd->frame_number);
 
@@ -581,11 +601,18 @@ void GPUBackend::HandleSubmitFrameCommand(const GPUBackendFramePresentationParam
     needs_restore = true;
   }
 
+  // Skipped frames never updated the display texture, so there's nothing new to export.
+  if (g_gpu_settings.display_shared_memory_frame_export && !m_render_skip)
+  {
+    m_presenter.SendDisplayToSharedFrameExport(cmd->frame_number);
+    needs_restore = true;
+  }
+
   // If this returns false, our backend object is deleted and replaced with null, so bail out.
   if (cmd->present_frame)
   {
     bool result;
-    if (GPUThread::ShouldPresentVideoFrame(cmd->present_time))
+    if (!m_render_skip && GPUThread::ShouldPresentVideoFrame(cmd->present_time))
     {
       result = m_presenter.PresentFrame(&m_presenter, this, cmd->present_time);
       needs_restore = true;
@@ -606,6 +633,10 @@ void GPUBackend::HandleSubmitFrameCommand(const GPUBackendFramePresentationParam
   if (cmd->update_performance_counters)
     PerformanceCounters::Update(this, cmd->frame_number, cmd->internal_frame_number);
 
+  // Media capture needs every frame, so it can't skip any.
+  const bool skip_next_frame = GPUThread::ShouldSkipRenderingNextFrame();
+  SetRenderSkip(skip_next_frame && !cmd->media_capture);
+
   if (needs_restore)
     RestoreDeviceContext();
 }
@@ -623,6 +654,8 @@ void GPUBackend::GetStatsString(SmallStringBase& str) const
                  GPUDevice::RenderAPIToString(g_gpu_device->GetRenderAPI()), g_gpu_settings.gpu_use_thread ? "-MT" : "",
                  s_stats.num_primitives, s_stats.host_num_draws, s_stats.host_num_downloads, s_stats.num_copies,
                  s_stats.num_writes, s_stats.gpu_busy_pct, s_stats.num_depth_buffer_clears);
+      if (g_gpu_settings.gpu_pgxp_depth_culling)
+        str.append_format(" | {} " BOLD("DCP"), s_stats.num_depth_culled_polygons);
     }
     else
     {
@@ -651,6 +684,16 @@ void GPUBackend::GetMemoryStatsString(SmallStringBase& str) const
                "TC") " | {} " BOLD("TU"),
              vram_usage_mb, stream_kb, s_stats.host_num_barriers, s_stats.host_num_render_passes,
              s_stats.host_num_copies, s_stats.host_num_uploads);
+
+  if (IsUsingHardwareBackend() && (g_gpu_settings.texture_replacements.enable_texture_replacements ||
+                                   g_gpu_settings.texture_replacements.enable_vram_write_replacements))
+  {
+    const u32 replacement_usage_mb =
+      static_cast<u32>((GPUTextureCache::GetReplacementCacheVRAMUsage() + (1048576 - 1)) / 1048576);
+    str.append_format(" | {}MB " BOLD("RC") " | {} " BOLD("RH") " | {} " BOLD("RM") " | {} " BOLD("RE"),
+                      replacement_usage_mb, s_stats.replacement_cache_hits, s_stats.replacement_cache_misses,
+                      s_stats.replacement_cache_evictions);
+  }
 }
 
 #undef BOLD
@@ -675,6 +718,7 @@ void GPUBackend::UpdateStatistics(u32 frame_count)
   UPDATE_COUNTER(num_vertices);
   UPDATE_COUNTER(num_primitives);
   UPDATE_COUNTER(num_depth_buffer_clears);
+  UPDATE_COUNTER(num_depth_culled_polygons);
 
   // UPDATE_COUNTER(num_read_texture_updates);
   // UPDATE_COUNTER(num_ubo_updates);
@@ -687,6 +731,11 @@ void GPUBackend::UpdateStatistics(u32 frame_count)
   UPDATE_GPU_STAT(num_downloads);
   UPDATE_GPU_STAT(num_uploads);
 
+  const GPUTextureCache::ReplacementCacheCounters rc = GPUTextureCache::GetAndResetReplacementCacheCounters();
+  s_stats.replacement_cache_hits = (rc.hits + round) / frame_count;
+  s_stats.replacement_cache_misses = (rc.misses + round) / frame_count;
+  s_stats.replacement_cache_evictions = (rc.evictions + round) / frame_count;
+
 #undef UPDATE_GPU_STAT
 #undef UPDATE_COUNTER
 
@@ -734,6 +783,88 @@ bool GPUBackend::RenderScreenshotToBuffer(u32 width, u32 height, bool postfx, bo
   return result;
 }
 
+static void SaveScreenshotImage(std::string path, u8 quality, std::string osd_key, Image* image, Error* error)
+{
+  if (!image)
+  {
+    ERROR_LOG("Failed to read back screenshot: {}", error->GetDescription());
+    if (!osd_key.empty())
+    {
+      Host::AddIconOSDMessage(
+        OSDMessageType::Error, std::move(osd_key), ICON_EMOJI_WARNING,
+        fmt::format(TRANSLATE_FS("GPU", "Failed to save screenshot:\n{}"), error->GetDescription()));
+    }
+
+    return;
+  }
+
+  auto fp = FileSystem::OpenManagedCFile(path.c_str(), "wb", error);
+  if (!fp)
+  {
+    ERROR_LOG("Can't open file '{}': {}", Path::GetFileName(path), error->GetDescription());
+    if (!osd_key.empty())
+    {
+      Host::AddIconOSDMessage(
+        OSDMessageType::Error, std::move(osd_key), ICON_EMOJI_WARNING,
+        fmt::format(TRANSLATE_FS("GPU", "Failed to save screenshot:\n{}"), error->GetDescription()));
+    }
+
+    return;
+  }
+
+  if (!osd_key.empty())
+  {
+    Host::AddIconOSDMessage(OSDMessageType::Persistent, osd_key, ICON_EMOJI_CAMERA_WITH_FLASH,
+                            fmt::format(TRANSLATE_FS("GPU", "Saving screenshot to '{}'."), Path::GetFileName(path)));
+  }
+
+    Host::QueueAsyncTask([path = std::move(path), fp = fp.release(), quality,
+                          flip_y = g_gpu_device->UsesLowerLeftOrigin(), image = std::move(*image),
+                          osd_key = std::move(osd_key)]() mutable {
+      Error error;
+
+      if (flip_y)
+        image.FlipY();
+
+      if (image.GetFormat() != ImageFormat::RGBA8)
+      {
+        std::optional<Image> convert_image = image.ConvertToRGBA8(&error);
+        if (!convert_image.has_value())
+        {
+          ERROR_LOG("Failed to convert {} screenshot to RGBA8: {}", Image::GetFormatName(image.GetFormat()),
+                    error.GetDescription());
+          image.Invalidate();
+        }
+        else
+        {
+          image = std::move(convert_image.value());
+        }
+      }
+
+      bool result = false;
+      if (image.IsValid())
+      {
+        image.SetAllPixelsOpaque();
+
+        result = image.SaveToFile(path.c_str(), fp, quality, &error);
+        if (!result)
+          ERROR_LOG("Failed to save screenshot to '{}': '{}'", Path::GetFileName(path), error.GetDescription());
+      }
+
+      if (!osd_key.empty())
+      {
+        Host::AddIconOSDMessage(result ? OSDMessageType::Info : OSDMessageType::Error, std::move(osd_key),
+                                ICON_EMOJI_CAMERA,
+                                fmt::format(result ? TRANSLATE_FS("GPU", "Saved screenshot to '{}'.") :
+                                                     TRANSLATE_FS("GPU", "Failed to save screenshot to '{}'."),
+                                            Path::GetFileName(path)));
+      }
+
+      std::fclose(fp);
+      return result;
+    });
+}
+
 void GPUBackend::RenderScreenshotToFile(const std::string_view path, DisplayScreenshotMode mode, u8 quality,
                                         bool show_osd_message)
 {
@@ -750,100 +881,36 @@ void GPUBackend::RenderScreenshotToFile(const std::string_view path, DisplayScre
       if (show_osd_message)
         osd_key = fmt::format("ScreenshotSaver_{}", path);
 
+      // Readback completes a couple of frames later, so the GPU thread doesn't have to wait for it.
       const bool internal_resolution = (mode != DisplayScreenshotMode::ScreenResolution);
       const bool apply_aspect_ratio = (mode != DisplayScreenshotMode::UncorrectedInternalResolution);
       Error error;
-      Image image;
-      if (!backend->m_presenter.RenderScreenshotToBuffer(size.x, size.y, !internal_resolution, apply_aspect_ratio,
-                                                         &image, &error))
-      {
-        ERROR_LOG("Failed to render {}x{} screenshot: {}", size.x, size.y, error.GetDescription());
-        if (show_osd_message)
-        {
-          Host::AddIconOSDMessage(
-            OSDMessageType::Error, std::move(osd_key), ICON_EMOJI_WARNING,
-            fmt::format(TRANSLATE_FS("GPU", "Failed to save screenshot:\n{}"), error.GetDescription()));
-        }
-
-        backend->RestoreDeviceContext();
-        return;
-      }
-
-      // no more GPU calls
+      const bool result = backend->m_presenter.RenderScreenshotToBufferAsync(
+        size.x, size.y, !internal_resolution, apply_aspect_ratio,
+        [path = std::move(path), quality, osd_key](Image* image, Error* error) mutable {
+          SaveScreenshotImage(std::move(path), quality, std::move(osd_key), image, error);
+        },
+        &error);
       backend->RestoreDeviceContext();
 
-      auto fp = FileSystem::OpenManagedCFile(path.c_str(), "wb", &error);
-      if (!fp)
+      if (!result)
       {
-        ERROR_LOG("Can't open file '{}': {}", Path::GetFileName(path), error.GetDescription());
+        ERROR_LOG("Failed to render {}x{} screenshot: {}", size.x, size.y, error.GetDescription());
         if (show_osd_message)
         {
           Host::AddIconOSDMessage(
             OSDMessageType::Error, std::move(osd_key), ICON_EMOJI_WARNING,
             fmt::format(TRANSLATE_FS("GPU", "Failed to save screenshot:\n{}"), error.GetDescription()));
         }
-
-        return;
       }
-
-      if (show_osd_message)
-      {
-        Host::AddIconOSDMessage(
-          OSDMessageType::Persistent, osd_key, ICON_EMOJI_CAMERA_WITH_FLASH,
-          fmt::format(TRANSLATE_FS("GPU", "Saving screenshot to '{}'."), Path::GetFileName(path)));
-      }
-
-      Host::QueueAsyncTask([path = std::move(path), fp = fp.release(), quality,
-                            flip_y = g_gpu_device->UsesLowerLeftOrigin(), image = std::move(image),
-                            osd_key = std::move(osd_key)]() mutable {
-        Error error;
-
-        if (flip_y)
-          image.FlipY();
-
-        if (image.GetFormat() != ImageFormat::RGBA8)
-        {
-          std::optional<Image> convert_image = image.ConvertToRGBA8(&error);
-          if (!convert_image.has_value())
-          {
-            ERROR_LOG("Failed to convert {} screenshot to RGBA8: {}", Image::GetFormatName(image.GetFormat()),
-                      error.GetDescription());
-            image.Invalidate();
-          }
-          else
-          {
-            image = std::move(convert_image.value());
-          }
-        }
-
-        bool result = false;
-        if (image.IsValid())
-        {
-          image.SetAllPixelsOpaque();
-
-          result = image.SaveToFile(path.c_str(), fp, quality, &error);
-          if (!result)
-            ERROR_LOG("Failed to save screenshot to '{}': '{}'", Path::GetFileName(path), error.GetDescription());
-        }
-
-        if (!osd_key.empty())
-        {
-          Host::AddIconOSDMessage(result ? OSDMessageType::Info : OSDMessageType::Error, std::move(osd_key),
-                                  ICON_EMOJI_CAMERA,
-                                  fmt::format(result ? TRANSLATE_FS("GPU", "Saved screenshot to '{}'.") :
-                                                       TRANSLATE_FS("GPU", "Failed to save screenshot to '{}'."),
-                                              Path::GetFileName(path)));
-        }
-
-        std::fclose(fp);
-        return result;
-      });
     },
     false, false);
 }
 
 namespace {
 
+// Consumes the command stream without rasterizing anything. VRAM transfers are still applied to g_vram, so that
+// readbacks and save states stay correct, which makes it usable for measuring CPU/SPU throughput.
 class GPUNullBackend final : public GPUBackend
 {
 public:
@@ -917,20 +984,24 @@ void GPUNullBackend::FlushRender()
 
 void GPUNullBackend::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
 {
+  // g_vram is always up to date.
 }
 
 void GPUNullBackend::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, bool interlaced_rendering,
                               u8 interlaced_display_field)
 {
+  GPU_SW_Rasterizer::FillVRAM(x, y, width, height, color, interlaced_rendering, interlaced_display_field);
 }
 
 void GPUNullBackend::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask)
 {
+  GPU_SW_Rasterizer::WriteVRAM(x, y, width, height, data, set_mask, check_mask);
 }
 
 void GPUNullBackend::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height, bool set_mask,
                               bool check_mask)
 {
+  GPU_SW_Rasterizer::CopyVRAM(src_x, src_y, dst_x, dst_y, width, height, set_mask, check_mask);
 }
 
 void GPUNullBackend::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
@@ -967,6 +1038,8 @@ void GPUNullBackend::OnBufferSwapped()
 
 void GPUNullBackend::ClearVRAM()
 {
+  std::memset(g_vram, 0, sizeof(g_vram));
+  std::memset(g_gpu_clut, 0, sizeof(g_gpu_clut));
 }
 
 void GPUNullBackend::UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd)
@@ -975,15 +1048,21 @@ void GPUNullBackend::UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd)
 
 void GPUNullBackend::LoadState(const GPUBackendLoadStateCommand* cmd)
 {
+  std::memcpy(g_vram, cmd->vram_data, sizeof(g_vram));
+  std::memcpy(g_gpu_clut, cmd->clut_data, sizeof(g_gpu_clut));
 }
 
 bool GPUNullBackend::AllocateMemorySaveState(System::MemorySaveState& mss, Error* error)
 {
-  return false;
+  mss.gpu_state_data.resize(sizeof(g_vram) + sizeof(g_gpu_clut));
+  return true;
 }
 
 void GPUNullBackend::DoMemoryState(StateWrapper& sw, System::MemorySaveState& mss)
 {
+  sw.DoBytes(g_vram, sizeof(g_vram));
+  sw.DoBytes(g_gpu_clut, sizeof(g_gpu_clut));
+  DebugAssert(!sw.HasError());
 }
 
 Common::unique_aligned_ptr<GPUBackend> GPUBackend::CreateNullBackend(GPUPresenter& presenter)
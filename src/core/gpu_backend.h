@@ -83,6 +83,9 @@ public:
   virtual bool UpdateSettings(const GPUSettings& old_settings, Error* error);
   virtual void UpdatePostProcessingSettings(bool force_reload);
 
+  /// Called when the running game's serial changes.
+  virtual void OnGameSerialChanged();
+
   /// Returns the current resolution scale.
   virtual u32 GetResolutionScale() const = 0;
 
@@ -136,6 +139,7 @@ protected:
     u32 num_vertices;
     u32 num_primitives;
     u32 num_depth_buffer_clears;
+    u32 num_depth_culled_polygons;
   };
 
   struct Stats : Counters
@@ -148,6 +152,10 @@ protected:
     u32 host_num_downloads;
     u32 host_num_uploads;
 
+    u32 replacement_cache_hits;
+    u32 replacement_cache_misses;
+    u32 replacement_cache_evictions;
+
     u8 gpu_busy_pct;
   };
 
@@ -165,12 +173,16 @@ protected:
   virtual void DrawPreciseLine(const GPUBackendDrawPreciseLineCommand* cmd) = 0;
 
   virtual void DrawingAreaChanged() = 0;
+  virtual void UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit);
   virtual void ClearCache() = 0;
   virtual void OnBufferSwapped() = 0;
   virtual void ClearVRAM() = 0;
 
   virtual void UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd) = 0;
 
+  /// Enables or disables rendering for frames which aren't going to be presented.
+  virtual void SetRenderSkip(bool enabled);
+
   virtual void LoadState(const GPUBackendLoadStateCommand* cmd) = 0;
 
   virtual bool AllocateMemorySaveState(System::MemorySaveState& mss, Error* error) = 0;
@@ -181,6 +193,7 @@ protected:
 
   GPUPresenter& m_presenter;
   GSVector4i m_clamped_drawing_area = {};
+  bool m_render_skip = false;
 
   static Counters s_counters;
   static Stats s_stats;
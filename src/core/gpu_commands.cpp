@@ -8,6 +8,7 @@
 #include "gpu_helpers.h"
 #include "gpu_thread_commands.h"
 #include "interrupt_controller.h"
+#include "performance_counters.h"
 #include "system.h"
 
 #include "common/assert.h"
@@ -111,6 +112,7 @@ void GPU::TryExecuteCommands()
 
 void GPU::ExecuteCommands()
 {
+  PerformanceCounters::CPUTimeScope cpu_time_scope(PerformanceCounters::CPUTimeCategory::GPU);
   const bool was_executing_from_event = std::exchange(m_executing_commands, true);
 
   TryExecuteCommands();
@@ -19,11 +19,19 @@
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/path.h"
+#include "common/small_string.h"
 #include "common/string_util.h"
+#include "common/threading.h"
 #include "common/timer.h"
 
 #include "fmt/format.h"
 
+#include <algorithm>
+#include <bit>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
 LOG_CHANNEL(GPUDump);
 
 namespace GPUDump {
@@ -32,8 +40,64 @@ static constexpr GPUVersion GPU_VERSION = GPUVersion::V2_1MB_VRAM;
 // Write the file header.
 static constexpr u8 FILE_HEADER[] = {'P', 'S', 'X', 'G', 'P', 'U', 'D', 'U', 'M', 'P', 'v', '1', '\0', '\0'};
 
+// Stream-compressed dumps are a sequence of independent zstd frames, split on vsync boundaries once the chunk reaches
+// this size, so that any frame can be reached by decompressing only the chunk containing it. Builds which predate
+// this only read the first frame's content size, so they can't load dumps with more than one chunk.
+static constexpr u32 STREAM_CHUNK_SIZE = 4 * 1024 * 1024;
+
+// Don't let the compressor fall too far behind, otherwise we're back to holding the whole dump in memory.
+static constexpr u32 MAX_PENDING_STREAM_CHUNKS = 4;
+
+// The chunk index is stored in a zstd skippable frame at the end of the file, so regular decoders ignore it.
+static constexpr u32 CHUNK_INDEX_FRAME_MAGIC = 0x184D2A5Bu;
+static constexpr u32 CHUNK_INDEX_FOOTER_MAGIC = 0x58494447u; // GDIX
+
+namespace {
+
+struct ChunkIndexEntry
+{
+  u32 compressed_size;
+  u32 decompressed_size;
+  u32 first_frame;
+};
+static_assert(sizeof(ChunkIndexEntry) == 12);
+
+struct ChunkIndexFooter
+{
+  u32 num_chunks;
+  u32 num_frames;
+  u32 magic;
+};
+static_assert(sizeof(ChunkIndexFooter) == 12);
+
+} // namespace
+
+static int GetZstdCompressionLevel(GPUDumpCompressionMode mode);
+
 }; // namespace GPUDump
 
+struct GPUDump::Recorder::StreamState
+{
+  // Owned by the recording thread.
+  std::vector<u8> chunk_buffer;
+  u32 chunk_first_frame = 0;
+  int clevel = 0;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::pair<std::vector<u8>, u32>> pending_chunks;
+  std::vector<ChunkIndexEntry> index;
+  bool shutdown = false;
+  bool write_error = false;
+
+  Threading::Thread thread;
+};
+
+int GPUDump::GetZstdCompressionLevel(GPUDumpCompressionMode mode)
+{
+  return ((mode == GPUDumpCompressionMode::ZstLow) ? 1 : ((mode == GPUDumpCompressionMode::ZstHigh) ? 19 : 0));
+}
+
 GPUDump::Recorder::Recorder(FileSystem::AtomicRenamedFile fp, u32 vsyncs_remaining, std::string path)
   : m_fp(std::move(fp)), m_vsyncs_remaining(vsyncs_remaining), m_path(path)
 {
@@ -41,6 +105,9 @@ GPUDump::Recorder::Recorder(FileSystem::AtomicRenamedFile fp, u32 vsyncs_remaini
 
 GPUDump::Recorder::~Recorder()
 {
+  if (m_stream)
+    StopStreamThread();
+
   if (m_fp)
     FileSystem::DiscardAtomicRenamedFile(m_fp);
 }
@@ -56,6 +123,9 @@ bool GPUDump::Recorder::IsFinished()
 
 bool GPUDump::Recorder::Close(Error* error)
 {
+  if (m_stream && !FinishStreamCompression(error))
+    return false;
+
   if (m_write_error)
   {
     Error::SetStringView(error, "Previous write error occurred.");
@@ -66,15 +136,23 @@ bool GPUDump::Recorder::Close(Error* error)
 }
 
 std::unique_ptr<GPUDump::Recorder> GPUDump::Recorder::Create(std::string path, std::string_view serial, u32 num_frames,
-                                                             Error* error)
+                                                             GPUDumpCompressionMode compression, Error* error)
 {
   std::unique_ptr<Recorder> ret;
 
+  const bool stream_compress =
+    (compression >= GPUDumpCompressionMode::ZstLow && compression <= GPUDumpCompressionMode::ZstHigh);
+  if (stream_compress)
+    path.append(".zst");
+
   auto fp = FileSystem::CreateAtomicRenamedFile(path, error);
   if (!fp)
     return ret;
 
   ret = std::unique_ptr<Recorder>(new Recorder(std::move(fp), num_frames, std::move(path)));
+  if (stream_compress)
+    ret->StartStreamCompression(GetZstdCompressionLevel(compression));
+
   ret->WriteHeaders(serial);
   g_gpu.WriteCurrentVideoModeToDump(ret.get());
   ret->WriteCurrentVRAM();
@@ -103,8 +181,7 @@ bool GPUDump::Recorder::Compress(const std::string& source_path, GPUDumpCompress
 
   if (mode >= GPUDumpCompressionMode::ZstLow && mode <= GPUDumpCompressionMode::ZstHigh)
   {
-    const int clevel =
-      ((mode == GPUDumpCompressionMode::ZstLow) ? 1 : ((mode == GPUDumpCompressionMode::ZstHigh) ? 19 : 0));
+    const int clevel = GetZstdCompressionLevel(mode);
     if (!CompressHelpers::CompressToFile(fmt::format("{}.zst", source_path).c_str(), std::move(data.value()), clevel,
                                          true, error))
     {
@@ -244,9 +321,8 @@ void GPUDump::Recorder::EndPacket()
   PacketHeader hdr = {};
   hdr.length = static_cast<u32>(m_packet_buffer.size());
   hdr.type = m_current_packet;
-  if (std::fwrite(&hdr, sizeof(hdr), 1, m_fp.get()) != 1 ||
-      (!m_packet_buffer.empty() &&
-       std::fwrite(m_packet_buffer.data(), m_packet_buffer.size() * sizeof(u32), 1, m_fp.get()) != 1))
+  if (!WriteToFile(&hdr, sizeof(hdr)) ||
+      (!m_packet_buffer.empty() && !WriteToFile(m_packet_buffer.data(), m_packet_buffer.size() * sizeof(u32))))
   {
     ERROR_LOG("Failed to write packet to file: {}", Error::CreateErrno(errno).GetDescription());
     m_write_error = true;
@@ -255,6 +331,151 @@ void GPUDump::Recorder::EndPacket()
   }
 
   m_packet_buffer.clear();
+
+  if (m_current_packet == PacketType::VSyncEvent)
+  {
+    m_vsyncs_written++;
+    if (m_stream && m_stream->chunk_buffer.size() >= STREAM_CHUNK_SIZE)
+      SubmitStreamChunk();
+  }
+}
+
+bool GPUDump::Recorder::WriteToFile(const void* data, size_t size)
+{
+  if (m_stream)
+  {
+    const u8* const data_bytes = static_cast<const u8*>(data);
+    m_stream->chunk_buffer.insert(m_stream->chunk_buffer.end(), data_bytes, data_bytes + size);
+    return true;
+  }
+
+  return (std::fwrite(data, size, 1, m_fp.get()) == 1);
+}
+
+void GPUDump::Recorder::StartStreamCompression(int clevel)
+{
+  m_stream = std::make_unique<StreamState>();
+  m_stream->clevel = clevel;
+  m_stream->chunk_buffer.reserve(STREAM_CHUNK_SIZE);
+  m_stream->thread.Start([this]() { StreamThreadEntryPoint(); });
+}
+
+void GPUDump::Recorder::SubmitStreamChunk()
+{
+  StreamState& ss = *m_stream;
+  if (ss.chunk_buffer.empty())
+    return;
+
+  {
+    std::unique_lock lock(ss.mutex);
+    ss.cv.wait(lock, [&ss]() { return (ss.pending_chunks.size() < MAX_PENDING_STREAM_CHUNKS); });
+    ss.pending_chunks.emplace_back(std::move(ss.chunk_buffer), ss.chunk_first_frame);
+  }
+  ss.cv.notify_all();
+
+  // Chunks are only split after vsync, so the next one always starts at the beginning of a frame.
+  ss.chunk_buffer = {};
+  ss.chunk_buffer.reserve(STREAM_CHUNK_SIZE);
+  ss.chunk_first_frame = m_vsyncs_written;
+}
+
+void GPUDump::Recorder::StopStreamThread()
+{
+  StreamState& ss = *m_stream;
+  if (!ss.thread.Joinable())
+    return;
+
+  {
+    std::unique_lock lock(ss.mutex);
+    ss.shutdown = true;
+  }
+  ss.cv.notify_all();
+  ss.thread.Join();
+}
+
+bool GPUDump::Recorder::FinishStreamCompression(Error* error)
+{
+  StreamState& ss = *m_stream;
+  SubmitStreamChunk();
+  StopStreamThread();
+
+  if (ss.write_error)
+  {
+    Error::SetStringView(error, "Failed to write compressed chunk.");
+    return false;
+  }
+
+  const u32 index_size = static_cast<u32>(ss.index.size() * sizeof(ChunkIndexEntry) + sizeof(ChunkIndexFooter));
+  const ChunkIndexFooter footer = {.num_chunks = static_cast<u32>(ss.index.size()),
+                                   .num_frames = m_vsyncs_written + 1,
+                                   .magic = CHUNK_INDEX_FOOTER_MAGIC};
+  if (std::fwrite(&CHUNK_INDEX_FRAME_MAGIC, sizeof(CHUNK_INDEX_FRAME_MAGIC), 1, m_fp.get()) != 1 ||
+      std::fwrite(&index_size, sizeof(index_size), 1, m_fp.get()) != 1 ||
+      (!ss.index.empty() &&
+       std::fwrite(ss.index.data(), ss.index.size() * sizeof(ChunkIndexEntry), 1, m_fp.get()) != 1) ||
+      std::fwrite(&footer, sizeof(footer), 1, m_fp.get()) != 1)
+  {
+    Error::SetErrno(error, "Failed to write chunk index: ", errno);
+    return false;
+  }
+
+  return true;
+}
+
+void GPUDump::Recorder::StreamThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("GPU Dump Compression");
+
+  StreamState& ss = *m_stream;
+  std::unique_lock lock(ss.mutex);
+  for (;;)
+  {
+    ss.cv.wait(lock, [&ss]() { return (ss.shutdown || !ss.pending_chunks.empty()); });
+    if (ss.pending_chunks.empty())
+      break;
+
+    std::vector<u8> chunk = std::move(ss.pending_chunks.front().first);
+    const u32 first_frame = ss.pending_chunks.front().second;
+    ss.pending_chunks.pop_front();
+    const bool had_write_error = ss.write_error;
+    lock.unlock();
+    ss.cv.notify_all();
+
+    // Once a chunk has failed, the file is useless, so don't bother compressing the remainder.
+    bool result = false;
+    u32 compressed_size = 0;
+    if (!had_write_error)
+    {
+      Error error;
+      const CompressHelpers::OptionalByteBuffer compressed = CompressHelpers::CompressToBuffer(
+        CompressHelpers::CompressType::Zstandard, std::span<const u8>(chunk), ss.clevel, &error);
+      if (!compressed.has_value())
+      {
+        ERROR_LOG("Failed to compress GPU dump chunk: {}", error.GetDescription());
+      }
+      else if (std::fwrite(compressed->data(), compressed->size(), 1, m_fp.get()) != 1)
+      {
+        ERROR_LOG("Failed to write GPU dump chunk: {}", Error::CreateErrno(errno).GetDescription());
+      }
+      else
+      {
+        compressed_size = static_cast<u32>(compressed->size());
+        result = true;
+      }
+    }
+
+    lock.lock();
+    if (result)
+    {
+      ss.index.push_back(ChunkIndexEntry{.compressed_size = compressed_size,
+                                         .decompressed_size = static_cast<u32>(chunk.size()),
+                                         .first_frame = first_frame});
+    }
+    else
+    {
+      ss.write_error = true;
+    }
+  }
 }
 
 void GPUDump::Recorder::WriteGP1Command(GP1Command command, u32 param)
@@ -266,7 +487,7 @@ void GPUDump::Recorder::WriteGP1Command(GP1Command command, u32 param)
 
 void GPUDump::Recorder::WriteHeaders(std::string_view serial)
 {
-  if (std::fwrite(FILE_HEADER, sizeof(FILE_HEADER), 1, m_fp.get()) != 1)
+  if (!WriteToFile(FILE_HEADER, sizeof(FILE_HEADER)))
   {
     ERROR_LOG("Failed to write file header: {}", Error::CreateErrno(errno).GetDescription());
     m_write_error = true;
@@ -322,15 +543,33 @@ std::unique_ptr<GPUDump::Player> GPUDump::Player::Open(std::string path, Error*
 
   Timer timer;
 
-  std::optional<DynamicHeapArray<u8>> data;
-  if (StringUtil::EndsWithNoCase(path, ".psxgpu.zst") || StringUtil::EndsWithNoCase(path, ".psxgpu.xz"))
-    data = CompressHelpers::DecompressFile(path.c_str(), std::nullopt, error);
+  if (StringUtil::EndsWithNoCase(path, ".psxgpu.zst"))
+  {
+    // zstd dumps may have a chunk index, in which case we only decompress what's needed.
+    std::optional<DynamicHeapArray<u8>> compressed_data = FileSystem::ReadBinaryFile(path.c_str(), error);
+    if (!compressed_data.has_value())
+      return ret;
+
+    ret = std::unique_ptr<Player>(new Player(std::move(path), DynamicHeapArray<u8>()));
+    if (!ret->LoadCompressedData(std::move(compressed_data.value()), error))
+    {
+      ret.reset();
+      return ret;
+    }
+  }
   else
-    data = FileSystem::ReadBinaryFile(path.c_str(), error);
-  if (!data.has_value())
-    return ret;
+  {
+    std::optional<DynamicHeapArray<u8>> data;
+    if (StringUtil::EndsWithNoCase(path, ".psxgpu.xz"))
+      data = CompressHelpers::DecompressFile(path.c_str(), std::nullopt, error);
+    else
+      data = FileSystem::ReadBinaryFile(path.c_str(), error);
+    if (!data.has_value())
+      return ret;
+
+    ret = std::unique_ptr<Player>(new Player(std::move(path), std::move(data.value())));
+  }
 
-  ret = std::unique_ptr<Player>(new Player(std::move(path), std::move(data.value())));
   if (!ret->Preprocess(error))
   {
     ret.reset();
@@ -341,11 +580,112 @@ std::unique_ptr<GPUDump::Player> GPUDump::Player::Open(std::string path, Error*
   return ret;
 }
 
+bool GPUDump::Player::LoadCompressedData(DynamicHeapArray<u8> compressed_data, Error* error)
+{
+  // Look for the chunk index at the end of the file.
+  ChunkIndexFooter footer;
+  u32 frame_header[2];
+  size_t index_frame_size = 0;
+  if (compressed_data.size() >= (sizeof(frame_header) + sizeof(footer)))
+  {
+    std::memcpy(&footer, &compressed_data[compressed_data.size() - sizeof(footer)], sizeof(footer));
+    index_frame_size = sizeof(frame_header) + sizeof(ChunkIndexEntry) * footer.num_chunks + sizeof(footer);
+    if (footer.magic != CHUNK_INDEX_FOOTER_MAGIC || index_frame_size > compressed_data.size())
+      index_frame_size = 0;
+  }
+  if (index_frame_size > 0)
+  {
+    std::memcpy(frame_header, &compressed_data[compressed_data.size() - index_frame_size], sizeof(frame_header));
+    if (frame_header[0] != CHUNK_INDEX_FRAME_MAGIC || frame_header[1] != (index_frame_size - sizeof(frame_header)))
+      index_frame_size = 0;
+  }
+
+  if (index_frame_size == 0)
+  {
+    // Compressed after recording, or by an external tool.
+    DEV_LOG("No chunk index found, decompressing entire dump.");
+    std::optional<DynamicHeapArray<u8>> data =
+      CompressHelpers::DecompressBuffer(CompressHelpers::CompressType::Zstandard, compressed_data.cspan(), std::nullopt,
+                                        error);
+    if (!data.has_value())
+      return false;
+
+    m_data = std::move(data.value());
+    return true;
+  }
+
+  const size_t index_offset = compressed_data.size() - index_frame_size + sizeof(frame_header);
+  m_chunks.reserve(footer.num_chunks);
+
+  size_t compressed_offset = 0;
+  size_t data_offset = 0;
+  for (u32 i = 0; i < footer.num_chunks; i++)
+  {
+    ChunkIndexEntry entry;
+    std::memcpy(&entry, &compressed_data[index_offset + i * sizeof(ChunkIndexEntry)], sizeof(entry));
+    if ((compressed_offset + entry.compressed_size) > index_offset ||
+        (!m_chunks.empty() && entry.first_frame < m_chunks.back().first_frame))
+    {
+      Error::SetStringFmt(error, "Chunk {} in index is invalid.", i);
+      return false;
+    }
+
+    m_chunks.push_back(StreamChunk{.compressed_offset = compressed_offset,
+                                   .data_offset = data_offset,
+                                   .compressed_size = entry.compressed_size,
+                                   .data_size = entry.decompressed_size,
+                                   .first_frame = entry.first_frame,
+                                   .loaded = false});
+    compressed_offset += entry.compressed_size;
+    data_offset += entry.decompressed_size;
+  }
+
+  DEV_LOG("Found chunk index with {} chunks, {} frames, {} bytes uncompressed.", footer.num_chunks, footer.num_frames,
+          data_offset);
+  m_data.resize(data_offset);
+  m_compressed_data = std::move(compressed_data);
+  m_frame_count = footer.num_frames;
+  return true;
+}
+
+bool GPUDump::Player::EnsureDataLoaded(size_t offset, size_t size)
+{
+  if (m_chunks.empty())
+    return true;
+
+  // Find the first chunk containing the range.
+  auto it = std::upper_bound(m_chunks.begin(), m_chunks.end(), offset,
+                             [](size_t offset, const StreamChunk& chunk) { return (offset < chunk.data_offset); });
+  if (it == m_chunks.begin())
+    return false;
+
+  const size_t end_offset = offset + size;
+  for (--it; it != m_chunks.end() && it->data_offset < end_offset; ++it)
+  {
+    if (it->loaded)
+      continue;
+
+    Error error;
+    if (!CompressHelpers::DecompressBuffer(m_data.span(it->data_offset, it->data_size),
+                                           CompressHelpers::CompressType::Zstandard,
+                                           m_compressed_data.cspan(it->compressed_offset, it->compressed_size),
+                                           it->data_size, &error))
+    {
+      ERROR_LOG("Failed to decompress chunk at offset {}: {}", it->data_offset, error.GetDescription());
+      return false;
+    }
+
+    it->loaded = true;
+  }
+
+  return true;
+}
+
 std::optional<GPUDump::Player::PacketRef> GPUDump::Player::GetNextPacket()
 {
   std::optional<PacketRef> ret;
 
-  if (m_position >= m_data.size())
+  if ((m_position + sizeof(PacketHeader)) > m_data.size() || !EnsureDataLoaded(m_position, sizeof(PacketHeader)))
     return ret;
 
   size_t new_position = m_position;
@@ -354,8 +694,11 @@ std::optional<GPUDump::Player::PacketRef> GPUDump::Player::GetNextPacket()
   std::memcpy(&hdr, &m_data[new_position], sizeof(hdr));
   new_position += sizeof(hdr);
 
-  if ((new_position + (hdr.length * sizeof(u32))) > m_data.size())
+  if ((new_position + (hdr.length * sizeof(u32))) > m_data.size() ||
+      !EnsureDataLoaded(new_position, hdr.length * sizeof(u32)))
+  {
     return ret;
+  }
 
   ret = PacketRef{.type = hdr.type,
                   .data = (hdr.length > 0) ?
@@ -384,13 +727,23 @@ bool GPUDump::Player::Preprocess(Error* error)
 
   m_position = m_start_offset;
 
-  if (!FindFrameStarts(error))
+  // Stream-compressed dumps have the frame count in the index, and scanning would mean decompressing everything.
+  if (m_chunks.empty())
   {
-    Error::AddPrefix(error, "Failed to process header: ");
+    if (!FindFrameStarts(error))
+    {
+      Error::AddPrefix(error, "Failed to process header: ");
+      return false;
+    }
+
+    m_position = m_start_offset;
+  }
+  else if (m_frame_count < 2)
+  {
+    Error::SetStringView(error, "Dump does not contain at least one frame.");
     return false;
   }
 
-  m_position = m_start_offset;
   return true;
 }
 
@@ -447,6 +800,7 @@ bool GPUDump::Player::ProcessHeader(Error* error)
       case PacketType::TraceBegin:
       {
         DEV_LOG("Trace start found at offset {}", m_position);
+        m_first_frame_offset = m_position;
         return true;
       }
 
@@ -507,6 +861,8 @@ bool GPUDump::Player::FindFrameStarts(Error* error)
     return false;
   }
 
+  m_frame_count = m_frame_offsets.size();
+
 #if defined(_DEBUG) || defined(_DEVEL)
   for (size_t i = 0; i < m_frame_offsets.size(); i++)
     DEBUG_LOG("Frame {} starts at offset {}", i, m_frame_offsets[i]);
@@ -525,6 +881,42 @@ void GPUDump::Player::ProcessPacket(const PacketRef& pkt)
   }
 }
 
+void GPUDump::Player::ProcessPacketWithTiming(const PacketRef& pkt)
+{
+  TimingCategory category;
+  switch (pkt.type)
+  {
+    case PacketType::GPUPort0Data:
+      category = pkt.data.empty() ? TimingCategory::GP0Misc : static_cast<TimingCategory>(pkt.data[0] >> 29);
+      break;
+
+    case PacketType::GPUPort1Data:
+      category = TimingCategory::GP1;
+      break;
+
+    case PacketType::VSyncEvent:
+      category = TimingCategory::VSync;
+      break;
+
+    default:
+      ProcessPacket(pkt);
+      return;
+  }
+
+  const Timer::Value start_time = Timer::GetCurrentValue();
+  ProcessPacket(pkt);
+  const Timer::Value elapsed = Timer::GetCurrentValue() - start_time;
+
+  const u64 elapsed_us = static_cast<u64>(Timer::ConvertValueToNanoseconds(elapsed) / 1000.0);
+  const u32 bucket = std::min<u32>(static_cast<u32>(std::bit_width(elapsed_us)), NUM_TIMING_BUCKETS - 1);
+
+  TimingStatistics& stats = m_timings[static_cast<size_t>(category)];
+  stats.count++;
+  stats.total_time += elapsed;
+  stats.max_time = std::max(stats.max_time, elapsed);
+  stats.buckets[bucket]++;
+}
+
 void GPUDump::Player::Execute()
 {
   if (fastjmp_set(CPU::GetExecutionJmpBuf()) != 0)
@@ -535,10 +927,101 @@ void GPUDump::Player::Execute()
     const std::optional<PacketRef> packet = GetNextPacket();
     if (!packet.has_value())
     {
-      m_position = g_settings.gpu_dump_fast_replay_mode ? m_frame_offsets.front() : m_start_offset;
+      m_position = g_settings.gpu_dump_fast_replay_mode ? m_first_frame_offset : m_start_offset;
       continue;
     }
 
-    ProcessPacket(packet.value());
+    if (m_timing_enabled) [[unlikely]]
+      ProcessPacketWithTiming(packet.value());
+    else
+      ProcessPacket(packet.value());
+  }
+}
+
+bool GPUDump::Player::SeekToFrame(u32 frame)
+{
+  if (frame >= m_frame_count)
+    return false;
+
+  if (m_chunks.empty())
+  {
+    m_position = m_frame_offsets[frame];
+    return true;
+  }
+
+  // Start from the closest chunk, then skip forward to the requested frame.
+  auto it = std::upper_bound(m_chunks.begin(), m_chunks.end(), frame,
+                             [](u32 frame, const StreamChunk& chunk) { return (frame < chunk.first_frame); });
+  DebugAssert(it != m_chunks.begin());
+  --it;
+
+  // First chunk also contains the headers and initial VRAM.
+  m_position = (it == m_chunks.begin()) ? m_first_frame_offset : it->data_offset;
+  for (u32 current_frame = it->first_frame; current_frame < frame;)
+  {
+    const std::optional<PacketRef> packet = GetNextPacket();
+    if (!packet.has_value())
+      return false;
+
+    current_frame += BoolToUInt32(packet->type == PacketType::VSyncEvent);
+  }
+
+  return true;
+}
+
+void GPUDump::Player::SetTimingEnabled(bool enabled)
+{
+  m_timing_enabled = enabled;
+}
+
+void GPUDump::Player::ResetTimings()
+{
+  m_timings = {};
+}
+
+const char* GPUDump::Player::GetTimingCategoryName(TimingCategory category)
+{
+  static constexpr const std::array<const char*, static_cast<size_t>(TimingCategory::MaxCount)> names = {{
+    "GP0 Misc/Fill",
+    "GP0 Polygon",
+    "GP0 Line",
+    "GP0 Rectangle",
+    "GP0 VRAM->VRAM",
+    "GP0 CPU->VRAM",
+    "GP0 VRAM->CPU",
+    "GP0 Environment",
+    "GP1",
+    "VSync",
+  }};
+
+  return names[static_cast<size_t>(category)];
+}
+
+void GPUDump::Player::LogTimings() const
+{
+  SmallString buckets_str;
+  for (u32 i = 0; i < NUM_TIMING_BUCKETS; i++)
+  {
+    if (i == (NUM_TIMING_BUCKETS - 1))
+      buckets_str.append_format(" {:>7}", fmt::format(">={}us", 1u << (i - 1)));
+    else
+      buckets_str.append_format(" {:>7}", fmt::format("<{}us", 1u << i));
+  }
+  INFO_LOG("{:<16} {:>10} {:>10} {:>9} {:>9}{}", "Packet Type", "Count", "Total ms", "Avg us", "Max us", buckets_str);
+
+  for (size_t i = 0; i < m_timings.size(); i++)
+  {
+    const TimingStatistics& stats = m_timings[i];
+    if (stats.count == 0)
+      continue;
+
+    const double total_ms = Timer::ConvertValueToMilliseconds(stats.total_time);
+    buckets_str.clear();
+    for (const u64 bucket_count : stats.buckets)
+      buckets_str.append_format(" {:>7}", bucket_count);
+
+    INFO_LOG("{:<16} {:>10} {:>10.2f} {:>9.2f} {:>9.2f}{}", GetTimingCategoryName(static_cast<TimingCategory>(i)),
+             stats.count, total_ms, (total_ms * 1000.0) / static_cast<double>(stats.count),
+             Timer::ConvertValueToNanoseconds(stats.max_time) / 1000.0, buckets_str);
   }
 }
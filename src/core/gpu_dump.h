@@ -9,6 +9,7 @@
 #include "common/bitfield.h"
 #include "common/file_system.h"
 
+#include <array>
 #include <memory>
 
 // Implements the specification from https://github.com/ps1dev/standards/blob/main/GPUDUMP.md
@@ -54,13 +55,18 @@ class Recorder
 public:
   ~Recorder();
 
-  static std::unique_ptr<Recorder> Create(std::string path, std::string_view serial, u32 num_frames, Error* error);
+  /// Zstandard modes compress on a background thread while recording, appending .zst to the path.
+  static std::unique_ptr<Recorder> Create(std::string path, std::string_view serial, u32 num_frames,
+                                          GPUDumpCompressionMode compression, Error* error);
 
   /// Compresses an already-created dump.
   static bool Compress(const std::string& source_path, GPUDumpCompressionMode mode, Error* error);
 
   ALWAYS_INLINE const std::string& GetPath() const { return m_path; }
 
+  /// Returns true if the dump was compressed while recording, and does not need Compress() afterwards.
+  ALWAYS_INLINE bool IsStreamCompressed() const { return static_cast<bool>(m_stream); }
+
   /// Returns true if the caller should stop recording data.
   bool IsFinished();
 
@@ -85,14 +91,25 @@ public:
   void WriteVSync(u64 ticks);
 
 private:
+  struct StreamState;
+
   Recorder(FileSystem::AtomicRenamedFile fp, u32 vsyncs_remaining, std::string path);
 
+  bool WriteToFile(const void* data, size_t size);
   void WriteHeaders(std::string_view serial);
   void WriteCurrentVRAM();
 
+  void StartStreamCompression(int clevel);
+  void SubmitStreamChunk();
+  void StopStreamThread();
+  bool FinishStreamCompression(Error* error);
+  void StreamThreadEntryPoint();
+
   FileSystem::AtomicRenamedFile m_fp;
   std::vector<u32> m_packet_buffer;
+  std::unique_ptr<StreamState> m_stream;
   u32 m_vsyncs_remaining = 0;
+  u32 m_vsyncs_written = 0;
   PacketType m_current_packet = PacketType::Comment;
   bool m_write_error = false;
 
@@ -107,15 +124,64 @@ public:
   ALWAYS_INLINE const std::string& GetPath() const { return m_path; }
   ALWAYS_INLINE const std::string& GetSerial() const { return m_serial; }
   ALWAYS_INLINE ConsoleRegion GetRegion() const { return m_region; }
-  ALWAYS_INLINE size_t GetFrameCount() const { return m_frame_offsets.size(); }
+  ALWAYS_INLINE size_t GetFrameCount() const { return m_frame_count; }
 
   static std::unique_ptr<Player> Open(std::string path, Error* error);
 
   void Execute();
 
+  /// Moves playback to the start of the specified frame. Only decompresses the chunk containing the frame for
+  /// dumps that were stream-compressed. VRAM is not restored, so the output will not match until it is redrawn.
+  bool SeekToFrame(u32 frame);
+
+  /// Enables collection of per-packet processing times, for benchmarking.
+  void SetTimingEnabled(bool enabled);
+  void ResetTimings();
+
+  /// Writes a histogram of packet processing times to the log.
+  void LogTimings() const;
+
 private:
   Player(std::string path, DynamicHeapArray<u8> data);
 
+  /// GP0 packets are categorized by the command of their first word.
+  enum class TimingCategory : u8
+  {
+    GP0Misc,
+    GP0Polygon,
+    GP0Line,
+    GP0Rectangle,
+    GP0CopyVRAM,
+    GP0WriteVRAM,
+    GP0ReadVRAM,
+    GP0Environment,
+    GP1,
+    VSync,
+    MaxCount
+  };
+
+  /// Buckets are powers of two in microseconds, i.e. <1us, <2us, <4us, ..., last bucket is everything above.
+  static constexpr u32 NUM_TIMING_BUCKETS = 16;
+
+  struct TimingStatistics
+  {
+    u64 count;
+    u64 total_time;
+    u64 max_time;
+    std::array<u64, NUM_TIMING_BUCKETS> buckets;
+  };
+
+  /// Independently-compressed block of a stream-compressed dump.
+  struct StreamChunk
+  {
+    size_t compressed_offset;
+    size_t data_offset;
+    u32 compressed_size;
+    u32 data_size;
+    u32 first_frame;
+    bool loaded;
+  };
+
   struct PacketRef
   {
     PacketType type;
@@ -126,20 +192,35 @@ private:
 
   std::optional<PacketRef> GetNextPacket();
 
+  bool LoadCompressedData(DynamicHeapArray<u8> compressed_data, Error* error);
+  bool EnsureDataLoaded(size_t offset, size_t size);
+
   bool Preprocess(Error* error);
   bool ProcessHeader(Error* error);
   bool FindFrameStarts(Error* error);
 
   void ProcessPacket(const PacketRef& pkt);
+  void ProcessPacketWithTiming(const PacketRef& pkt);
+
+  static const char* GetTimingCategoryName(TimingCategory category);
 
   DynamicHeapArray<u8> m_data;
   size_t m_start_offset = 0;
   size_t m_position = 0;
+  size_t m_first_frame_offset = 0;
+  size_t m_frame_count = 0;
+
+  // Only populated for stream-compressed dumps, chunks are decompressed into m_data on first access.
+  DynamicHeapArray<u8> m_compressed_data;
+  std::vector<StreamChunk> m_chunks;
 
   std::string m_path;
   std::string m_serial;
   ConsoleRegion m_region = ConsoleRegion::NTSC_U;
-  std::vector<size_t> m_frame_offsets;
+  std::vector<size_t> m_frame_offsets; // Not populated for stream-compressed dumps.
+
+  bool m_timing_enabled = false;
+  std::array<TimingStatistics, static_cast<size_t>(TimingCategory::MaxCount)> m_timings = {};
 };
 
 } // namespace GPUDump
@@ -10,6 +10,8 @@
 #include "common/bitutils.h"
 #include "common/gsvector.h"
 
+#include <cstring>
+
 ALWAYS_INLINE static constexpr bool TextureModeHasPalette(GPUTextureMode mode)
 {
   return (mode < GPUTextureMode::Direct16Bit);
@@ -102,8 +104,28 @@ ALWAYS_INLINE void ConvertVRAMPixels(u8*& dest, GSVector4i c16)
   }
 }
 
+/// Expands four packed 24-bit pixels to RGBA8. Reads 16 bytes from src, so the four bytes following the last pixel
+/// must be readable.
+ALWAYS_INLINE void ConvertVRAM24BitPixels(u8*& dest, const u8*& src)
+{
+  static constexpr GSVector4i shuffle = GSVector4i::cxpr8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  static constexpr GSVector4i alpha = GSVector4i::cxpr(static_cast<s32>(0xFF000000u));
+
+  GSVector4i::store<false>(dest, GSVector4i::load<false>(src).shuffle8(shuffle) | alpha);
+  dest += sizeof(GSVector4i);
+  src += 4 * 3;
+}
+
 #endif
 
+ALWAYS_INLINE void ConvertVRAM24BitPixel(u8*& dest, const u8*& src)
+{
+  const u32 c32 = ZeroExtend32(src[0]) | (ZeroExtend32(src[1]) << 8) | (ZeroExtend32(src[2]) << 16) | 0xFF000000u;
+  std::memcpy(dest, &c32, sizeof(c32));
+  dest += sizeof(c32);
+  src += 3;
+}
+
 template<GPUTextureFormat format>
 ALWAYS_INLINE void ConvertVRAMPixel(u8*& dest, u16 c16)
 {
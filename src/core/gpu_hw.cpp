@@ -16,17 +16,24 @@
 #include "host.h"
 #include "imgui_overlays.h"
 #include "settings.h"
+#include "shader_cache_version.h"
 #include "system_private.h"
 
+#include "scmversion/scmversion.h"
+
 #include "util/imgui_manager.h"
 #include "util/postprocessing.h"
 #include "util/state_wrapper.h"
 
 #include "common/align.h"
 #include "common/assert.h"
+#include "common/binary_reader_writer.h"
+#include "common/bitutils.h"
 #include "common/error.h"
+#include "common/file_system.h"
 #include "common/gsvector_formatter.h"
 #include "common/log.h"
+#include "common/path.h"
 #include "common/scoped_guard.h"
 #include "common/string_util.h"
 #include "common/timer.h"
@@ -36,8 +43,11 @@
 #include "fmt/format.h"
 #include "imgui.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <limits>
+#include <mutex>
 #include <sstream>
 #include <tuple>
 
@@ -50,6 +60,9 @@ static constexpr GPUTextureFormat VRAM_DS_FORMAT = GPUTextureFormat::D16;
 static constexpr GPUTextureFormat VRAM_DS_DEPTH_FORMAT = GPUTextureFormat::D32F;
 static constexpr GPUTextureFormat VRAM_DS_COLOR_FORMAT = GPUTextureFormat::R32F;
 
+static constexpr u32 PIPELINE_USAGE_LIST_SIGNATURE = 0x4C555050; // PPUL
+static constexpr u32 SHADERGEN_MEMO_SIGNATURE = 0x4D475344;      // DSGM
+
 #if defined(_DEBUG) || defined(_DEVEL)
 
 static u32 s_draw_number = 0;
@@ -244,8 +257,30 @@ private:
   u32 m_progress;
   u32 m_total;
 };
+
+/// Keeps the first error from pipeline tasks which run in parallel.
+struct PipelineTaskError
+{
+  std::atomic_bool failed{false};
+  std::mutex mutex;
+  Error error;
+
+  void Set(Error e)
+  {
+    const std::unique_lock lock(mutex);
+    if (!failed.load(std::memory_order_relaxed))
+    {
+      error = std::move(e);
+      failed.store(true, std::memory_order_release);
+    }
+  }
+};
 } // namespace
 
+// Pipeline tasks are waited on in chunks of this many, so the loading screen is still updated, and a cancelled
+// startup doesn't have to wait for every pipeline.
+static constexpr u32 PIPELINE_TASK_CHUNK_SIZE = 32;
+
 GPU_HW::GPU_HW(GPUPresenter& presenter) : GPUBackend(presenter)
 {
 #if defined(_DEBUG) || defined(_DEVEL)
@@ -255,6 +290,8 @@ GPU_HW::GPU_HW(GPUPresenter& presenter) : GPUBackend(presenter)
 
 GPU_HW::~GPU_HW()
 {
+  SavePipelineUsageList();
+  SaveShaderGenMemo();
   GPUTextureCache::Shutdown();
 }
 
@@ -278,6 +315,19 @@ ALWAYS_INLINE void GPU_HW::BatchVertex::Set(float x_, float y_, float z_, float
   uv_limits = uv_limits_;
 }
 
+ALWAYS_INLINE void GPU_HW::BatchVertex::Set(const GSVector4 xyzw, const GSVector4i attributes)
+{
+  // Two full stores, rather than a scattered write per field into the mapped vertex buffer.
+  GSVector4::store<false>(&x, xyzw);
+  GSVector4i::store<false>(&color, attributes);
+}
+
+ALWAYS_INLINE GSVector4i GPU_HW::BatchVertex::PackAttributes(u32 color, u32 texpage, u32 u, u32 v, u32 uv_limits)
+{
+  return GSVector4i(static_cast<s32>(color), static_cast<s32>(texpage), static_cast<s32>(u | (v << 16)),
+                    static_cast<s32>(uv_limits));
+}
+
 ALWAYS_INLINE u32 GPU_HW::BatchVertex::PackUVLimits(u32 min_u, u32 max_u, u32 min_v, u32 max_v)
 {
   return min_u | (min_v << 8) | (max_u << 16) | (max_v << 24);
@@ -312,11 +362,18 @@ bool GPU_HW::Initialize(bool upload_vram, Error* error)
   m_use_texture_cache = g_gpu_settings.gpu_texture_cache;
   m_texture_dumping = m_use_texture_cache && g_gpu_settings.texture_replacements.dump_textures;
   m_draw_with_software_renderer = ShouldDrawWithSoftwareRenderer();
+  m_defer_batches = g_gpu_settings.gpu_deferred_batch_submission;
+  m_speculative_readbacks = g_gpu_settings.gpu_speculative_vram_readbacks;
+  m_precompile_used_pipelines = g_gpu_settings.gpu_precompile_used_pipelines;
+  m_depth_culling = m_pgxp_depth_buffer && g_gpu_settings.gpu_pgxp_depth_culling;
+  ResetDepthCullTiles();
 
   CheckSettings();
 
   PrintSettingsToLog();
 
+  LoadShaderGenMemo();
+
   if (!CompileCommonShaders(error) || !CompilePipelines(error) || !CreateBuffers(error))
     return false;
 
@@ -358,12 +415,16 @@ void GPU_HW::ClearVRAM()
   // Don't need to finish the current draw.
   if (m_batch_vertex_ptr)
     UnmapGPUBuffer(0, 0);
+  DiscardDeferredDraws();
+  InvalidateSpeculativeReadback();
 
   m_texpage_dirty = false;
   m_compute_uv_range = m_clamp_uvs;
 
   std::memset(g_vram, 0, sizeof(g_vram));
   std::memset(g_gpu_clut, 0, sizeof(g_gpu_clut));
+  InvalidateCachedDisplay();
+  m_render_skip_dirty_rect = INVALID_RECT;
 
   m_batch = {};
   m_current_depth = 1;
@@ -375,10 +436,13 @@ void GPU_HW::LoadState(const GPUBackendLoadStateCommand* cmd)
   DebugAssert((m_batch_vertex_ptr != nullptr) == (m_batch_index_ptr != nullptr));
   if (m_batch_vertex_ptr)
     UnmapGPUBuffer(0, 0);
+  DiscardDeferredDraws();
+  InvalidateSpeculativeReadback();
 
   std::memcpy(g_vram, cmd->vram_data, sizeof(g_vram));
   std::memcpy(g_gpu_clut, cmd->clut_data, sizeof(g_gpu_clut));
   UpdateVRAMOnGPU(0, 0, VRAM_WIDTH, VRAM_HEIGHT, g_vram, VRAM_WIDTH * sizeof(u16), false, false, VRAM_SIZE_RECT);
+  m_render_skip_dirty_rect = INVALID_RECT;
 
   if (m_use_texture_cache)
   {
@@ -397,9 +461,17 @@ void GPU_HW::LoadState(const GPUBackendLoadStateCommand* cmd)
   ResetBatchVertexDepth();
 }
 
+bool GPU_HW::UseNativeResolutionMemoryStates() const
+{
+  // The texture cache and software renderer already keep an up-to-date copy of VRAM.
+  return (g_gpu_settings.gpu_native_resolution_memory_states && !m_draw_with_software_renderer &&
+          !m_use_texture_cache);
+}
+
 bool GPU_HW::AllocateMemorySaveState(System::MemorySaveState& mss, Error* error)
 {
-  if (!g_gpu_settings.gpu_use_software_renderer_for_memory_states)
+  const bool native_resolution = UseNativeResolutionMemoryStates();
+  if (!g_gpu_settings.gpu_use_software_renderer_for_memory_states && !native_resolution)
   {
     mss.vram_texture = g_gpu_device->FetchTexture(
       m_vram_texture->GetWidth(), m_vram_texture->GetHeight(), 1, 1, m_vram_texture->GetSamples(),
@@ -421,7 +493,7 @@ bool GPU_HW::AllocateMemorySaveState(System::MemorySaveState& mss, Error* error)
   static constexpr u32 MAX_TC_SIZE = 1024 * 1024;
 
   u32 buffer_size = 0;
-  if (m_draw_with_software_renderer || m_use_texture_cache)
+  if (m_draw_with_software_renderer || m_use_texture_cache || native_resolution)
     buffer_size += sizeof(g_vram);
   if (m_draw_with_software_renderer)
     buffer_size += sizeof(g_gpu_clut);
@@ -436,10 +508,15 @@ bool GPU_HW::AllocateMemorySaveState(System::MemorySaveState& mss, Error* error)
 
 void GPU_HW::DoMemoryState(StateWrapper& sw, System::MemorySaveState& mss)
 {
+  // The VRAM texture has to be current for saving, and our copy of VRAM for skipping after loading.
+  SetRenderSkip(false);
+
   if (sw.IsReading())
   {
     if (m_batch_vertex_ptr)
       UnmapGPUBuffer(0, 0);
+    DiscardDeferredDraws();
+    InvalidateSpeculativeReadback();
 
     m_batch = {};
     ResetBatchVertexDepth();
@@ -447,12 +524,20 @@ void GPU_HW::DoMemoryState(StateWrapper& sw, System::MemorySaveState& mss)
   else
   {
     // don't bother flushing render if we're using the software renderer
-    if (mss.vram_texture)
+    const bool native_resolution = UseNativeResolutionMemoryStates();
+    if (mss.vram_texture || native_resolution)
       FlushRender();
+
+    // downsample to 1x, the high resolution detail is lost until the game redraws it
+    if (native_resolution)
+    {
+      GL_SCOPE("Download VRAM for memory state");
+      DownloadVRAMFromGPU(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+    }
   }
 
   // Save VRAM/CLUT.
-  if (m_draw_with_software_renderer || m_use_texture_cache)
+  if (m_draw_with_software_renderer || m_use_texture_cache || UseNativeResolutionMemoryStates())
     sw.DoBytes(g_vram, sizeof(g_vram));
   if (m_draw_with_software_renderer)
     sw.DoBytes(g_gpu_clut, sizeof(g_gpu_clut));
@@ -508,8 +593,12 @@ bool GPU_HW::UpdateSettings(const GPUSettings& old_settings, Error* error)
   if (!GPUBackend::UpdateSettings(old_settings, error))
     return false;
 
+  SetRenderSkip(false);
   FlushRender();
 
+  // display settings may have changed what the cached frame would look like
+  InvalidateCachedDisplay();
+
   const GPUDevice::Features features = g_gpu_device->GetFeatures();
 
   const u8 resolution_scale = Truncate8(CalculateResolutionScale());
@@ -599,6 +688,19 @@ bool GPU_HW::UpdateSettings(const GPUSettings& old_settings, Error* error)
   m_texture_dumping = m_use_texture_cache && g_gpu_settings.texture_replacements.dump_textures;
   m_batch.sprite_mode = (m_allow_sprite_mode && m_batch.sprite_mode);
   m_draw_with_software_renderer = draw_with_software_renderer;
+  m_defer_batches = g_gpu_settings.gpu_deferred_batch_submission;
+  m_speculative_readbacks = g_gpu_settings.gpu_speculative_vram_readbacks;
+  if (m_precompile_used_pipelines != g_gpu_settings.gpu_precompile_used_pipelines)
+  {
+    m_precompile_used_pipelines = g_gpu_settings.gpu_precompile_used_pipelines;
+    ReloadPipelineUsageList();
+    UpdateUnrecordedBatchPipelines();
+  }
+  if (!m_speculative_readbacks)
+  {
+    InvalidateSpeculativeReadback();
+    m_vram_speculative_download_texture.reset();
+  }
 
   const bool depth_buffer_changed = (m_pgxp_depth_buffer != g_gpu_settings.UsingPGXPDepthBuffer());
   if (depth_buffer_changed)
@@ -607,6 +709,11 @@ bool GPU_HW::UpdateSettings(const GPUSettings& old_settings, Error* error)
     m_batch.use_depth_buffer = false;
     m_depth_was_copied = false;
   }
+  if (m_depth_culling != (m_pgxp_depth_buffer && g_gpu_settings.gpu_pgxp_depth_culling))
+  {
+    m_depth_culling = (m_pgxp_depth_buffer && g_gpu_settings.gpu_pgxp_depth_culling);
+    ResetDepthCullTiles();
+  }
 
   CheckSettings();
 
@@ -838,7 +945,9 @@ bool GPU_HW::IsUsingDownsampling(const GPUBackendUpdateDisplayCommand* cmd) cons
 
 void GPU_HW::SetFullVRAMDirtyRectangle()
 {
+  InvalidateCachedDisplay();
   m_vram_dirty_draw_rect = VRAM_SIZE_RECT;
+  m_vram_dirty_draw_tiles.fill(static_cast<u16>((1u << VRAM_DIRTY_TILES_X) - 1));
   m_draw_mode.bits = INVALID_DRAW_MODE_BITS;
 }
 
@@ -846,12 +955,33 @@ void GPU_HW::ClearVRAMDirtyRectangle()
 {
   m_vram_dirty_draw_rect = INVALID_RECT;
   m_vram_dirty_write_rect = INVALID_RECT;
+  m_vram_dirty_draw_tiles = {};
+  m_vram_dirty_write_tiles = {};
+}
+
+void GPU_HW::AddDirtyTiles(VRAMDirtyTileMask& mask, const GSVector4i rect)
+{
+  const GSVector4i clamped_rect = rect.rintersect(VRAM_SIZE_RECT);
+  if (clamped_rect.rempty())
+    return;
+
+  const u32 start_x = static_cast<u32>(clamped_rect.left) >> VRAM_DIRTY_TILE_SHIFT;
+  const u32 end_x = (static_cast<u32>(clamped_rect.right) - 1) >> VRAM_DIRTY_TILE_SHIFT;
+  const u32 start_y = static_cast<u32>(clamped_rect.top) >> VRAM_DIRTY_TILE_SHIFT;
+  const u32 end_y = (static_cast<u32>(clamped_rect.bottom) - 1) >> VRAM_DIRTY_TILE_SHIFT;
+  const u16 row_bits = static_cast<u16>(((2u << end_x) - 1) & ~((1u << start_x) - 1));
+  for (u32 y = start_y; y <= end_y; y++)
+    mask[y] |= row_bits;
 }
 
 void GPU_HW::AddWrittenRectangle(const GSVector4i rect)
 {
   m_vram_dirty_write_rect = m_vram_dirty_write_rect.runion(rect);
+  m_display_dirty_rect = m_display_dirty_rect.runion(rect);
+  AddDirtyTiles(m_vram_dirty_write_tiles, rect);
+  m_speculative_readback_stale_rect = m_speculative_readback_stale_rect.runion(rect);
   SetTexPageChangedOnOverlap(m_vram_dirty_write_rect);
+  InvalidateDepthCullTiles(rect);
 
   if (m_use_texture_cache)
     GPUTextureCache::AddWrittenRectangle(rect);
@@ -861,12 +991,21 @@ void GPU_HW::AddDrawnRectangle(const GSVector4i rect)
 {
   // Normally, we would check for overlap here. But the GPU's texture cache won't actually reload until the page
   // changes, or it samples a larger region, so we can get away without doing so. This reduces copies considerably in
-  // games like Mega Man Legends 2.
+  // games like Mega Man Legends 2. The tiles still need to be marked, as the bounding box can cover undrawn gaps.
+  AddDirtyTiles(m_vram_dirty_draw_tiles, rect);
+  m_display_dirty_rect = m_display_dirty_rect.runion(rect);
   if (m_current_draw_rect.rcontains(rect))
+  {
+    // The software renderer still modifies our copy of VRAM, so the texture cache can't reuse its row hashes.
+    if (m_use_texture_cache && m_draw_with_software_renderer)
+      GPUTextureCache::InvalidateRowHashes(rect);
+
     return;
+  }
 
   m_current_draw_rect = m_current_draw_rect.runion(rect);
   m_vram_dirty_draw_rect = m_vram_dirty_draw_rect.runion(m_current_draw_rect);
+  m_speculative_readback_stale_rect = m_speculative_readback_stale_rect.runion(m_current_draw_rect);
 
   if (m_use_texture_cache)
     GPUTextureCache::AddDrawnRectangle(m_current_draw_rect, m_clamped_drawing_area);
@@ -875,7 +1014,11 @@ void GPU_HW::AddDrawnRectangle(const GSVector4i rect)
 void GPU_HW::AddUnclampedDrawnRectangle(const GSVector4i rect)
 {
   m_vram_dirty_draw_rect = m_vram_dirty_draw_rect.runion(rect);
+  m_display_dirty_rect = m_display_dirty_rect.runion(rect);
+  AddDirtyTiles(m_vram_dirty_draw_tiles, rect);
+  m_speculative_readback_stale_rect = m_speculative_readback_stale_rect.runion(rect);
   SetTexPageChangedOnOverlap(m_vram_dirty_draw_rect);
+  InvalidateDepthCullTiles(rect);
   if (m_use_texture_cache)
     GPUTextureCache::AddDrawnRectangle(rect, rect);
 }
@@ -893,6 +1036,111 @@ void GPU_HW::SetTexPageChangedOnOverlap(const GSVector4i update_rect)
   }
 }
 
+void GPU_HW::ResetDepthCullTiles()
+{
+  // Infinity means "no known occluder", so nothing in the tile can be culled.
+  m_depth_cull_tiles.fill(std::numeric_limits<float>::infinity());
+}
+
+void GPU_HW::InvalidateDepthCullTiles(const GSVector4i rect)
+{
+  // VRAM writes, fills and copies can replace the depth values without going through the depth test.
+  if (!m_depth_culling)
+    return;
+
+  const GSVector4i clamped_rect = rect.rintersect(VRAM_SIZE_RECT);
+  if (clamped_rect.rempty())
+    return;
+
+  const u32 start_x = static_cast<u32>(clamped_rect.left) >> DEPTH_CULL_TILE_SHIFT;
+  const u32 start_y = static_cast<u32>(clamped_rect.top) >> DEPTH_CULL_TILE_SHIFT;
+  const u32 end_x = (static_cast<u32>(clamped_rect.right) + (DEPTH_CULL_TILE_SIZE - 1)) >> DEPTH_CULL_TILE_SHIFT;
+  const u32 end_y = (static_cast<u32>(clamped_rect.bottom) + (DEPTH_CULL_TILE_SIZE - 1)) >> DEPTH_CULL_TILE_SHIFT;
+  for (u32 y = start_y; y < end_y; y++)
+  {
+    float* row = &m_depth_cull_tiles[y * DEPTH_CULL_TILES_X];
+    std::fill(row + start_x, row + end_x, std::numeric_limits<float>::infinity());
+  }
+}
+
+bool GPU_HW::IsPolygonDepthCulled(const BatchVertex* vertices, u32 num_vertices, const GSVector4i rect) const
+{
+  // LessEqual test, so the polygon is only hidden if every tile is strictly in front of its nearest point.
+  // The bias allows for the interpolated depth rounding slightly past the vertex values.
+  static constexpr float DEPTH_CULL_BIAS = 1.0f / static_cast<float>(GTE::MAX_Z);
+
+  float min_depth = vertices[0].w;
+  for (u32 i = 1; i < num_vertices; i++)
+    min_depth = std::min(min_depth, vertices[i].w);
+  min_depth -= DEPTH_CULL_BIAS;
+
+  const u32 start_x = static_cast<u32>(rect.left) >> DEPTH_CULL_TILE_SHIFT;
+  const u32 start_y = static_cast<u32>(rect.top) >> DEPTH_CULL_TILE_SHIFT;
+  const u32 end_x = (static_cast<u32>(rect.right) + (DEPTH_CULL_TILE_SIZE - 1)) >> DEPTH_CULL_TILE_SHIFT;
+  const u32 end_y = (static_cast<u32>(rect.bottom) + (DEPTH_CULL_TILE_SIZE - 1)) >> DEPTH_CULL_TILE_SHIFT;
+  for (u32 y = start_y; y < end_y; y++)
+  {
+    const float* row = &m_depth_cull_tiles[y * DEPTH_CULL_TILES_X];
+    for (u32 x = start_x; x < end_x; x++)
+    {
+      if (row[x] >= min_depth)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+void GPU_HW::UpdateDepthCullTiles(const BatchVertex& v0, const BatchVertex& v1, const BatchVertex& v2,
+                                  const GSVector4i clamped_rect)
+{
+  // Anything outside the clip range doesn't write depth at all.
+  const float max_depth = std::max(v0.w, std::max(v1.w, v2.w));
+  const float min_depth = std::min(v0.w, std::min(v1.w, v2.w));
+  if (min_depth < 0.0f || max_depth > 1.0f)
+    return;
+
+  // Only tiles entirely within the drawing area and the triangle are guaranteed to have every pixel written.
+  const s32 start_x = (clamped_rect.left + static_cast<s32>(DEPTH_CULL_TILE_SIZE - 1)) >> DEPTH_CULL_TILE_SHIFT;
+  const s32 start_y = (clamped_rect.top + static_cast<s32>(DEPTH_CULL_TILE_SIZE - 1)) >> DEPTH_CULL_TILE_SHIFT;
+  const s32 end_x = clamped_rect.right >> DEPTH_CULL_TILE_SHIFT;
+  const s32 end_y = clamped_rect.bottom >> DEPTH_CULL_TILE_SHIFT;
+  if (start_x >= end_x || start_y >= end_y)
+    return;
+
+  const float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+  if (area == 0.0f)
+    return;
+
+  // Edge functions, oriented so the inside of the triangle is positive regardless of winding.
+  const float sign = (area > 0.0f) ? 1.0f : -1.0f;
+  const auto inside = [&v0, &v1, &v2, sign](float px, float py) {
+    const auto edge = [px, py, sign](const BatchVertex& a, const BatchVertex& b) {
+      return ((b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x)) * sign;
+    };
+    return (edge(v0, v1) >= 0.0f && edge(v1, v2) >= 0.0f && edge(v2, v0) >= 0.0f);
+  };
+
+  // Triangles are convex, so containing the corners means containing the tile. The corners are pushed out by a
+  // pixel to cover the vertex offset and rasterization rules at higher resolutions.
+  for (s32 y = start_y; y < end_y; y++)
+  {
+    const float top = static_cast<float>(y << DEPTH_CULL_TILE_SHIFT) - 1.0f;
+    const float bottom = static_cast<float>((y + 1) << DEPTH_CULL_TILE_SHIFT) + 1.0f;
+    for (s32 x = start_x; x < end_x; x++)
+    {
+      const float left = static_cast<float>(x << DEPTH_CULL_TILE_SHIFT) - 1.0f;
+      const float right = static_cast<float>((x + 1) << DEPTH_CULL_TILE_SHIFT) + 1.0f;
+      if (!inside(left, top) || !inside(right, top) || !inside(left, bottom) || !inside(right, bottom))
+        continue;
+
+      // Depth only ever decreases through the test, so the new bound is the nearer of the two.
+      float& tile = m_depth_cull_tiles[static_cast<u32>(y) * DEPTH_CULL_TILES_X + static_cast<u32>(x)];
+      tile = std::min(tile, max_depth);
+    }
+  }
+}
+
 void GPU_HW::PrintSettingsToLog()
 {
   INFO_LOG("Resolution Scale: {} ({}x{}), maximum {}", m_resolution_scale, VRAM_WIDTH * m_resolution_scale,
@@ -1025,6 +1273,7 @@ void GPU_HW::ClearFramebuffer()
   ClearVRAMDirtyRectangle();
   if (m_use_texture_cache)
     GPUTextureCache::Invalidate();
+  ResetDepthCullTiles();
   m_last_depth_z = 1.0f;
   m_current_depth = 1;
 }
@@ -1063,9 +1312,13 @@ void GPU_HW::DestroyBuffers()
   DebugAssert((m_batch_vertex_ptr != nullptr) == (m_batch_index_ptr != nullptr));
   if (m_batch_vertex_ptr)
     UnmapGPUBuffer(0, 0);
+  DiscardDeferredDraws();
+  InvalidateSpeculativeReadback();
+  InvalidateCachedDisplay();
 
   m_vram_upload_buffer.reset();
   m_vram_readback_download_texture.reset();
+  m_vram_speculative_download_texture.reset();
   g_gpu_device->RecycleTexture(std::move(m_downsample_texture));
   g_gpu_device->RecycleTexture(std::move(m_vram_extract_depth_texture));
   g_gpu_device->RecycleTexture(std::move(m_vram_extract_texture));
@@ -1155,19 +1408,37 @@ bool GPU_HW::CompilePipelines(Error* error)
   const GPU_HW_ShaderGen shadergen(g_gpu_device->GetRenderAPI(), m_supports_dual_source_blend,
                                    m_supports_framebuffer_fetch);
 
-  const u32 max_active_texture_modes =
-    (m_allow_sprite_mode ? NUM_TEXTURE_MODES :
-                           (NUM_TEXTURE_MODES - (NUM_TEXTURE_MODES - static_cast<u32>(BatchTextureMode::SpriteStart))));
-  const u32 num_active_texture_modes =
-    (max_active_texture_modes - (BoolToUInt32(!needs_page_texture) * (BoolToUInt32(m_allow_sprite_mode) + 1)));
-  const u32 total_vertex_shaders =
-    ((m_allow_sprite_mode ? 7 : 4) - (BoolToUInt32(!needs_page_texture) * (BoolToUInt32(m_allow_sprite_mode) + 1)));
-  const u32 total_fragment_shaders = ((1 + BoolToUInt32(needs_rov_depth)) * 5 * 5 * num_active_texture_modes * 2 *
-                                      (1 + BoolToUInt32(!true_color)) * (1 + BoolToUInt32(!force_progressive_scan)));
+  m_batch_shader_config = {.upscaled = upscaled,
+                           .msaa = msaa,
+                           .per_sample_shading = per_sample_shading,
+                           .force_round_texcoords = force_round_texcoords,
+                           .modulation_crop = modulation_crop,
+                           .true_color = true_color,
+                           .scaled_dithering = scaled_dithering,
+                           .scaled_interlacing = scaled_interlacing,
+                           .disable_color_perspective = disable_color_perspective,
+                           .needs_page_texture = needs_page_texture,
+                           .force_progressive_scan = force_progressive_scan,
+                           .needs_rov_depth = needs_rov_depth,
+                           .needs_real_depth_buffer = needs_real_depth_buffer,
+                           .needs_feedback_loop = needs_feedback_loop,
+                           .depth_buffer_format = depth_buffer_format};
+
+  // Pick up the list of pipelines the game used last time, if we're only compiling those.
+  if (!m_precompile_used_pipelines || GetPipelineUsageListPath() != m_pipeline_usage_list_path)
+    ReloadPipelineUsageList();
+
+  const bool use_usage_list = (m_precompile_used_pipelines && m_used_batch_pipelines.any());
+  std::vector<u16> batch_pipeline_keys;
+  batch_pipeline_keys.reserve(use_usage_list ? m_used_batch_pipelines.count() : NUM_BATCH_PIPELINES);
+  for (u32 key = 0; key < NUM_BATCH_PIPELINES; key++)
+  {
+    if ((!use_usage_list || m_used_batch_pipelines.test(key)) && IsBatchPipelineNeeded(key))
+      batch_pipeline_keys.push_back(static_cast<u16>(key));
+  }
+
   const u32 total_items =
-    total_vertex_shaders + total_fragment_shaders +
-    ((m_pgxp_depth_buffer ? 2 : 1) * 5 * 5 * num_active_texture_modes * 2 * (1 + BoolToUInt32(!true_color)) *
-     (1 + BoolToUInt32(!force_progressive_scan))) +              // batch pipelines
+    static_cast<u32>(batch_pipeline_keys.size()) +              // batch pipelines
     ((m_wireframe_mode != GPUWireframeMode::Disabled) ? 1 : 0) + // wireframe
     (2 * 2) +                                                    // vram fill
     (1 + BoolToUInt32(m_write_mask_as_depth)) +                  // vram copy
@@ -1176,12 +1447,13 @@ bool GPU_HW::CompilePipelines(Error* error)
     (m_write_mask_as_depth ? 1 : 0) +                            // mask -> depth
     1;                                                           // resolution dependent shaders
 
-  INFO_LOG("Compiling {} vertex shaders, {} fragment shaders, and {} pipelines.", total_vertex_shaders,
-           total_fragment_shaders, total_items);
+  INFO_LOG("Compiling {} batch pipelines{}, and {} pipelines in total.", batch_pipeline_keys.size(),
+           use_usage_list ? " from usage list" : "", total_items);
 
   // destroy old pipelines, if any
   m_wireframe_pipeline.reset();
   m_batch_pipelines.enumerate([](std::unique_ptr<GPUPipeline>& p) { p.reset(); });
+  m_unrecorded_batch_pipelines.clear();
   m_vram_fill_pipelines.enumerate([](std::unique_ptr<GPUPipeline>& p) { p.reset(); });
   for (std::unique_ptr<GPUPipeline>& p : m_vram_write_pipelines)
     p.reset();
@@ -1191,169 +1463,89 @@ bool GPU_HW::CompilePipelines(Error* error)
   m_vram_write_replacement_pipeline.reset();
   m_clear_depth_pipeline.reset();
   m_copy_depth_pipeline.reset();
+  DestroyBatchShaders();
 
-  ShaderCompileProgressTracker progress(total_items);
-
-  // vertex shaders - [textured/palette/sprite]
-  // fragment shaders - [depth_test][render_mode][transparency_mode][texture_mode][check_mask][dithering][interlacing]
-  static constexpr auto destroy_shader = [](std::unique_ptr<GPUShader>& s) { s.reset(); };
-  DimensionalArray<std::unique_ptr<GPUShader>, 2, 3, 2> batch_vertex_shaders{};
-  DimensionalArray<std::unique_ptr<GPUShader>, 2, 2, 2, NUM_TEXTURE_MODES, 5, 5, 2> batch_fragment_shaders{};
-  ScopedGuard batch_shader_guard([&batch_vertex_shaders, &batch_fragment_shaders]() {
-    batch_vertex_shaders.enumerate(destroy_shader);
-    batch_fragment_shaders.enumerate(destroy_shader);
+  // Shaders are only needed after startup when something outside the list gets drawn.
+  ScopedGuard batch_shader_guard([this, use_usage_list]() {
+    if (!use_usage_list)
+      DestroyBatchShaders();
   });
 
-  for (u8 textured = 0; textured < 2; textured++)
-  {
-    for (u8 palette = 0; palette < 3; palette++)
-    {
-      if (palette && !textured)
-        continue;
-      if (palette == 2 && !needs_page_texture)
-        continue;
+  ShaderCompileProgressTracker progress(total_items);
 
-      for (u8 sprite = 0; sprite < 2; sprite++)
+  // Batch pipelines are created in parallel where the device allows it. Tasks only write to their own slots.
+  PipelineTaskError task_error;
+  const auto run_tasks = [&progress, &task_error, error](size_t count, u32 progress_per_task, const auto& func) {
+    TaskQueue::Group group;
+    for (size_t start = 0; start < count; start += PIPELINE_TASK_CHUNK_SIZE)
+    {
+      const size_t end = std::min<size_t>(start + PIPELINE_TASK_CHUNK_SIZE, count);
+      for (size_t i = start; i < end; i++)
       {
-        if (sprite && (!textured || !m_allow_sprite_mode))
-          continue;
-
-        const bool uv_limits = ShouldClampUVs(sprite ? m_sprite_texture_filtering : m_texture_filtering);
-        const std::string vs = shadergen.GenerateBatchVertexShader(
-          upscaled, msaa, per_sample_shading, textured != 0, palette == 1, palette == 2, uv_limits,
-          !sprite && force_round_texcoords, m_pgxp_depth_buffer, disable_color_perspective);
-        if (!(batch_vertex_shaders[textured][palette][sprite] =
-                g_gpu_device->CreateShader(GPUShaderStage::Vertex, shadergen.GetLanguage(), vs, error)))
-        {
-          return false;
-        }
-
-        if (!progress.Increment(1, error)) [[unlikely]]
-          return false;
+        g_gpu_device->SubmitPipelineTask(
+          [&func, &task_error, i]() {
+            if (task_error.failed.load(std::memory_order_acquire))
+              return;
+
+            Error task_func_error;
+            if (!func(i, &task_func_error))
+              task_error.Set(std::move(task_func_error));
+          },
+          group);
       }
-    }
-  }
+      g_gpu_device->WaitForPipelineTasks(group);
 
-  for (u8 depth_test = 0; depth_test < 2; depth_test++)
-  {
-    if (depth_test && !needs_rov_depth)
-    {
-      // Don't need to do depth testing in the shader.
-      continue;
-    }
-
-    for (u8 render_mode = 0; render_mode < 5; render_mode++)
-    {
-      for (u8 transparency_mode = 0; transparency_mode < 5; transparency_mode++)
+      if (task_error.failed.load(std::memory_order_acquire))
       {
-        if (
-          // Can't generate shader blending.
-          ((render_mode == static_cast<u8>(BatchRenderMode::ShaderBlend) && !m_allow_shader_blend) ||
-           (render_mode != static_cast<u8>(BatchRenderMode::ShaderBlend) &&
-            transparency_mode != static_cast<u8>(GPUTransparencyMode::Disabled))) ||
-          // Don't need multipass shaders if we're preferring shader blend or have (free) FBFetch.
-          ((m_supports_framebuffer_fetch || m_prefer_shader_blend) &&
-           (render_mode == static_cast<u8>(BatchRenderMode::OnlyOpaque) ||
-            render_mode == static_cast<u8>(BatchRenderMode::OnlyTransparent))) ||
-          // If using ROV depth, we only draw with shader blending.
-          (needs_rov_depth && render_mode != static_cast<u8>(BatchRenderMode::ShaderBlend)))
-        {
-          if (!progress.Increment(num_active_texture_modes * 2 * (1 + BoolToUInt32(!true_color)) *
-                                    (1 + BoolToUInt32(!force_progressive_scan)),
-                                  error)) [[unlikely]]
-          {
-            return false;
-          }
+        if (error)
+          *error = task_error.error;
+        return false;
+      }
 
-          continue;
-        }
+      if (!progress.Increment(progress_per_task * static_cast<u32>(end - start), error)) [[unlikely]]
+        return false;
+    }
 
-        for (u8 texture_mode = 0; texture_mode < max_active_texture_modes; texture_mode++)
-        {
-          if (!needs_page_texture && (texture_mode == static_cast<u8>(BatchTextureMode::PageTexture) ||
-                                      texture_mode == static_cast<u8>(BatchTextureMode::SpritePageTexture)))
-          {
-            continue;
-          }
+    return true;
+  };
 
-          for (u8 check_mask = 0; check_mask < 2; check_mask++)
-          {
-            if (check_mask && render_mode != static_cast<u8>(BatchRenderMode::ShaderBlend))
-            {
-              // mask bit testing is only valid with shader blending.
-              if (!progress.Increment((1 + BoolToUInt32(!true_color)) * (1 + BoolToUInt32(!force_progressive_scan)),
-                                      error)) [[unlikely]]
-              {
-                return false;
-              }
-
-              continue;
-            }
-
-            for (u8 dithering = 0; dithering < 2; dithering++)
-            {
-              // Never going to draw with dithering on in true color.
-              if (dithering && true_color)
-                continue;
-
-              for (u8 interlacing = 0; interlacing < 2; interlacing++)
-              {
-                // Never going to draw with line skipping in force progressive.
-                if (interlacing && force_progressive_scan)
-                  continue;
-
-                const bool sprite = (static_cast<BatchTextureMode>(texture_mode) >= BatchTextureMode::SpriteStart);
-                const bool uv_limits = ShouldClampUVs(sprite ? m_sprite_texture_filtering : m_texture_filtering);
-                const BatchTextureMode shader_texmode = static_cast<BatchTextureMode>(
-                  texture_mode - (sprite ? static_cast<u8>(BatchTextureMode::SpriteStart) : 0));
-                const GPUTextureFilter texture_filter = sprite ? m_sprite_texture_filtering : m_texture_filtering;
-                const bool texture_filter_is_blended =
-                  (shader_texmode != BatchTextureMode::Disabled && IsBlendedTextureFiltering(texture_filter));
-                const bool use_rov =
-                  (render_mode == static_cast<u8>(BatchRenderMode::ShaderBlend) && m_use_rov_for_shader_blend);
-                const bool rov_depth_test = (use_rov && depth_test != 0);
-                const bool rov_depth_write = (rov_depth_test && static_cast<GPUTransparencyMode>(transparency_mode) ==
-                                                                  GPUTransparencyMode::Disabled);
-                const std::string fs = shadergen.GenerateBatchFragmentShader(
-                  static_cast<BatchRenderMode>(render_mode), static_cast<GPUTransparencyMode>(transparency_mode),
-                  shader_texmode, texture_filter, texture_filter_is_blended, upscaled, msaa, per_sample_shading,
-                  uv_limits, !sprite && force_round_texcoords, modulation_crop, true_color,
-                  ConvertToBoolUnchecked(dithering), scaled_dithering, disable_color_perspective,
-                  ConvertToBoolUnchecked(interlacing), scaled_interlacing, ConvertToBoolUnchecked(check_mask),
-                  m_write_mask_as_depth, use_rov, needs_rov_depth, rov_depth_test, rov_depth_write);
-
-                if (!(batch_fragment_shaders[depth_test][render_mode][transparency_mode][texture_mode][check_mask]
-                                            [dithering][interlacing] = g_gpu_device->CreateShader(
-                                              GPUShaderStage::Fragment, shadergen.GetLanguage(), fs, error)))
-                {
-                  return false;
-                }
-
-                if (!progress.Increment(1, error)) [[unlikely]]
-                  return false;
-              }
-            }
-          }
-        }
-      }
-    }
+  // Shaders go first, otherwise pipelines which share them would race to create them.
+  std::vector<std::array<u8, 3>> batch_vertex_shaders;
+  std::vector<std::array<u8, 7>> batch_fragment_shaders;
+  batch_vertex_shaders.reserve(batch_pipeline_keys.size());
+  batch_fragment_shaders.reserve(batch_pipeline_keys.size());
+  for (const u16 key : batch_pipeline_keys)
+  {
+    const BatchPipelineShaders shaders = GetBatchPipelineShaders(key);
+    batch_vertex_shaders.push_back(shaders.vs);
+    batch_fragment_shaders.push_back(shaders.fs);
+  }
+  std::sort(batch_vertex_shaders.begin(), batch_vertex_shaders.end());
+  batch_vertex_shaders.erase(std::unique(batch_vertex_shaders.begin(), batch_vertex_shaders.end()),
+                             batch_vertex_shaders.end());
+  std::sort(batch_fragment_shaders.begin(), batch_fragment_shaders.end());
+  batch_fragment_shaders.erase(std::unique(batch_fragment_shaders.begin(), batch_fragment_shaders.end()),
+                               batch_fragment_shaders.end());
+
+  if (!run_tasks(batch_vertex_shaders.size(), 0,
+                 [this, &batch_vertex_shaders](size_t i, Error* task_error) {
+                   const std::array<u8, 3>& vs = batch_vertex_shaders[i];
+                   return (GetBatchVertexShader(vs[0], vs[1], vs[2], task_error) != nullptr);
+                 }) ||
+      !run_tasks(batch_fragment_shaders.size(), 0,
+                 [this, &batch_fragment_shaders](size_t i, Error* task_error) {
+                   const std::array<u8, 7>& fs = batch_fragment_shaders[i];
+                   return (GetBatchFragmentShader(fs[0], fs[1], fs[2], fs[3], fs[4], fs[5], fs[6], task_error) !=
+                           nullptr);
+                 }) ||
+      !run_tasks(batch_pipeline_keys.size(), 1, [this, &batch_pipeline_keys](size_t i, Error* task_error) {
+        return CompileBatchPipeline(batch_pipeline_keys[i], task_error);
+      }))
+  {
+    return false;
   }
 
-  static constexpr GPUPipeline::VertexAttribute vertex_attributes[] = {
-    GPUPipeline::VertexAttribute::Make(0, GPUPipeline::VertexAttribute::Semantic::Position, 0,
-                                       GPUPipeline::VertexAttribute::Type::Float, 4, OFFSETOF(BatchVertex, x)),
-    GPUPipeline::VertexAttribute::Make(1, GPUPipeline::VertexAttribute::Semantic::Color, 0,
-                                       GPUPipeline::VertexAttribute::Type::UNorm8, 4, OFFSETOF(BatchVertex, color)),
-    GPUPipeline::VertexAttribute::Make(2, GPUPipeline::VertexAttribute::Semantic::TexCoord, 0,
-                                       GPUPipeline::VertexAttribute::Type::UInt32, 1, OFFSETOF(BatchVertex, u)),
-    GPUPipeline::VertexAttribute::Make(3, GPUPipeline::VertexAttribute::Semantic::TexCoord, 1,
-                                       GPUPipeline::VertexAttribute::Type::UInt32, 1, OFFSETOF(BatchVertex, texpage)),
-    GPUPipeline::VertexAttribute::Make(4, GPUPipeline::VertexAttribute::Semantic::TexCoord, 2,
-                                       GPUPipeline::VertexAttribute::Type::UNorm8, 4, OFFSETOF(BatchVertex, uv_limits)),
-  };
-  static constexpr u32 NUM_BATCH_VERTEX_ATTRIBUTES = 2;
-  static constexpr u32 NUM_BATCH_TEXTURED_VERTEX_ATTRIBUTES = 4;
-  static constexpr u32 NUM_BATCH_TEXTURED_LIMITS_VERTEX_ATTRIBUTES = 5;
+  UpdateUnrecordedBatchPipelines();
 
   GPUPipeline::GraphicsConfig plconfig = {};
   plconfig.layout = GPUPipeline::Layout::SingleTextureAndUBO;
@@ -1362,198 +1554,6 @@ bool GPU_HW::CompilePipelines(Error* error)
   plconfig.primitive = GPUPipeline::Primitive::Triangles;
   plconfig.geometry_shader = nullptr;
   plconfig.depth = GPUPipeline::DepthState::GetNoTestsState();
-
-  // [depth_test][transparency_mode][render_mode][texture_mode][dithering][interlacing][check_mask]
-  for (u8 depth_test = 0; depth_test < 2; depth_test++)
-  {
-    if (depth_test && !m_pgxp_depth_buffer)
-    {
-      // Not used.
-      continue;
-    }
-
-    for (u8 transparency_mode = 0; transparency_mode < 5; transparency_mode++)
-    {
-      for (u8 render_mode = 0; render_mode < 5; render_mode++)
-      {
-        if (
-          // Can't generate shader blending.
-          (render_mode == static_cast<u8>(BatchRenderMode::ShaderBlend) && !m_allow_shader_blend) ||
-          // Don't need multipass shaders.
-          ((m_supports_framebuffer_fetch || m_prefer_shader_blend) &&
-           (render_mode == static_cast<u8>(BatchRenderMode::OnlyOpaque) ||
-            render_mode == static_cast<u8>(BatchRenderMode::OnlyTransparent))) ||
-          // If using ROV depth, we only draw with shader blending.
-          (needs_rov_depth && render_mode != static_cast<u8>(BatchRenderMode::ShaderBlend)))
-        {
-          if (!progress.Increment(num_active_texture_modes * 2 * (1 + BoolToUInt32(!true_color)) *
-                                    (1 + BoolToUInt32(!force_progressive_scan)),
-                                  error)) [[unlikely]]
-          {
-            return false;
-          }
-
-          continue;
-        }
-
-        for (u8 texture_mode = 0; texture_mode < max_active_texture_modes; texture_mode++)
-        {
-          if (!needs_page_texture && (texture_mode == static_cast<u8>(BatchTextureMode::PageTexture) ||
-                                      texture_mode == static_cast<u8>(BatchTextureMode::SpritePageTexture)))
-          {
-            continue;
-          }
-
-          for (u8 dithering = 0; dithering < 2; dithering++)
-          {
-            // Never going to draw with dithering on in true color.
-            if (dithering && true_color)
-              continue;
-
-            for (u8 interlacing = 0; interlacing < 2; interlacing++)
-            {
-              // Never going to draw with line skipping in force progressive.
-              if (interlacing && force_progressive_scan)
-                continue;
-
-              for (u8 check_mask = 0; check_mask < 2; check_mask++)
-              {
-                const bool textured = (static_cast<BatchTextureMode>(texture_mode) != BatchTextureMode::Disabled);
-                const bool palette =
-                  (static_cast<BatchTextureMode>(texture_mode) == BatchTextureMode::Palette4Bit ||
-                   static_cast<BatchTextureMode>(texture_mode) == BatchTextureMode::Palette8Bit ||
-                   static_cast<BatchTextureMode>(texture_mode) == BatchTextureMode::SpritePalette4Bit ||
-                   static_cast<BatchTextureMode>(texture_mode) == BatchTextureMode::SpritePalette8Bit);
-                const bool page_texture =
-                  (static_cast<BatchTextureMode>(texture_mode) == BatchTextureMode::PageTexture ||
-                   static_cast<BatchTextureMode>(texture_mode) == BatchTextureMode::SpritePageTexture);
-                const bool sprite = (static_cast<BatchTextureMode>(texture_mode) >= BatchTextureMode::SpriteStart);
-                const bool uv_limits = ShouldClampUVs(sprite ? m_sprite_texture_filtering : m_texture_filtering);
-                const bool use_shader_blending = (render_mode == static_cast<u8>(BatchRenderMode::ShaderBlend));
-                const bool use_rov = (use_shader_blending && m_use_rov_for_shader_blend);
-                plconfig.input_layout.vertex_attributes =
-                  textured ?
-                    (uv_limits ? std::span<const GPUPipeline::VertexAttribute>(
-                                   vertex_attributes, NUM_BATCH_TEXTURED_LIMITS_VERTEX_ATTRIBUTES) :
-                                 std::span<const GPUPipeline::VertexAttribute>(vertex_attributes,
-                                                                               NUM_BATCH_TEXTURED_VERTEX_ATTRIBUTES)) :
-                    std::span<const GPUPipeline::VertexAttribute>(vertex_attributes, NUM_BATCH_VERTEX_ATTRIBUTES);
-
-                plconfig.vertex_shader =
-                  batch_vertex_shaders[BoolToUInt8(textured)][page_texture ? 2 : BoolToUInt8(palette)]
-                                      [BoolToUInt8(sprite)]
-                                        .get();
-                plconfig.fragment_shader =
-                  batch_fragment_shaders[BoolToUInt8(depth_test && needs_rov_depth)][render_mode]
-                                        [use_shader_blending ? transparency_mode :
-                                                               static_cast<u8>(GPUTransparencyMode::Disabled)]
-                                        [texture_mode][use_shader_blending ? check_mask : 0][dithering][interlacing]
-                                          .get();
-                Assert(plconfig.vertex_shader && plconfig.fragment_shader);
-
-                if (needs_real_depth_buffer)
-                {
-                  plconfig.depth.depth_test =
-                    m_pgxp_depth_buffer ?
-                      (depth_test ? GPUPipeline::DepthFunc::LessEqual : GPUPipeline::DepthFunc::Always) :
-                      (check_mask ? GPUPipeline::DepthFunc::GreaterEqual : GPUPipeline::DepthFunc::Always);
-
-                  // Don't write for transparent, but still test.
-                  plconfig.depth.depth_write =
-                    !m_pgxp_depth_buffer ||
-                    (depth_test && transparency_mode == static_cast<u8>(GPUTransparencyMode::Disabled));
-                }
-
-                plconfig.SetTargetFormats(use_rov ? GPUTextureFormat::Unknown : VRAM_RT_FORMAT,
-                                          needs_rov_depth ? GPUTextureFormat::Unknown : depth_buffer_format);
-                plconfig.color_formats[1] = needs_rov_depth ? VRAM_DS_COLOR_FORMAT : GPUTextureFormat::Unknown;
-
-                // Don't enable feedback loop bit if it's not needed.
-                if (use_rov)
-                {
-                  plconfig.render_pass_flags = GPUPipeline::BindRenderTargetsAsImages;
-                }
-                else if (needs_feedback_loop)
-                {
-                  plconfig.render_pass_flags = static_cast<GPUPipeline::RenderPassFlag>(
-                    use_shader_blending ? (GPUPipeline::ColorFeedbackLoop | GPUPipeline::ColorFeedbackLoopActive) :
-                                          GPUPipeline::ColorFeedbackLoop);
-                }
-                else
-                {
-                  plconfig.render_pass_flags = GPUPipeline::NoRenderPassFlags;
-                }
-
-                plconfig.blend = GPUPipeline::BlendState::GetNoBlendingState();
-
-                if (use_rov)
-                {
-                  plconfig.blend.write_mask = 0;
-                }
-                else if (!use_shader_blending &&
-                         ((static_cast<GPUTransparencyMode>(transparency_mode) != GPUTransparencyMode::Disabled &&
-                           (static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
-                            static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque)) ||
-                          (textured &&
-                           IsBlendedTextureFiltering(sprite ? m_sprite_texture_filtering : m_texture_filtering))))
-                {
-                  plconfig.blend.enable = true;
-                  plconfig.blend.src_alpha_blend = GPUPipeline::BlendFunc::One;
-                  plconfig.blend.dst_alpha_blend = GPUPipeline::BlendFunc::Zero;
-                  plconfig.blend.alpha_blend_op = GPUPipeline::BlendOp::Add;
-
-                  if (m_supports_dual_source_blend)
-                  {
-                    plconfig.blend.src_blend = GPUPipeline::BlendFunc::One;
-                    plconfig.blend.dst_blend = GPUPipeline::BlendFunc::SrcAlpha1;
-                    plconfig.blend.blend_op =
-                      (static_cast<GPUTransparencyMode>(transparency_mode) ==
-                         GPUTransparencyMode::BackgroundMinusForeground &&
-                       static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
-                       static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
-                        GPUPipeline::BlendOp::ReverseSubtract :
-                        GPUPipeline::BlendOp::Add;
-                  }
-                  else
-                  {
-                    // TODO: This isn't entirely accurate, 127.5 versus 128.
-                    // But if we use fbfetch on Mali, it doesn't matter.
-                    plconfig.blend.src_blend = GPUPipeline::BlendFunc::One;
-                    plconfig.blend.dst_blend = GPUPipeline::BlendFunc::One;
-                    if (static_cast<GPUTransparencyMode>(transparency_mode) ==
-                        GPUTransparencyMode::HalfBackgroundPlusHalfForeground)
-                    {
-                      plconfig.blend.dst_blend = GPUPipeline::BlendFunc::ConstantColor;
-                      plconfig.blend.dst_alpha_blend = GPUPipeline::BlendFunc::ConstantColor;
-                      plconfig.blend.constant = 0x00808080u;
-                    }
-
-                    plconfig.blend.blend_op =
-                      (static_cast<GPUTransparencyMode>(transparency_mode) ==
-                         GPUTransparencyMode::BackgroundMinusForeground &&
-                       static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
-                       static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
-                        GPUPipeline::BlendOp::ReverseSubtract :
-                        GPUPipeline::BlendOp::Add;
-                  }
-                }
-
-                if (!(m_batch_pipelines[depth_test][transparency_mode][render_mode][texture_mode][dithering]
-                                       [interlacing][check_mask] = g_gpu_device->CreatePipeline(plconfig, error)))
-                {
-                  return false;
-                }
-
-                if (!progress.Increment(1, error)) [[unlikely]]
-                  return false;
-              }
-            }
-          }
-        }
-      }
-    }
-  }
-
   plconfig.SetTargetFormats(VRAM_RT_FORMAT, needs_rov_depth ? GPUTextureFormat::Unknown : depth_buffer_format);
   plconfig.render_pass_flags = needs_feedback_loop ? GPUPipeline::ColorFeedbackLoop : GPUPipeline::NoRenderPassFlags;
 
@@ -1569,14 +1569,14 @@ bool GPU_HW::CompilePipelines(Error* error)
     GL_OBJECT_NAME(gs, "Batch Wireframe Geometry Shader");
     GL_OBJECT_NAME(fs, "Batch Wireframe Fragment Shader");
 
-    plconfig.input_layout.vertex_attributes =
-      std::span<const GPUPipeline::VertexAttribute>(vertex_attributes, NUM_BATCH_VERTEX_ATTRIBUTES);
+    plconfig.input_layout.vertex_attributes = GetBatchVertexAttributes(false, false);
     plconfig.blend = (m_wireframe_mode == GPUWireframeMode::OverlayWireframe) ?
                        GPUPipeline::BlendState::GetAlphaBlendingState() :
                        GPUPipeline::BlendState::GetNoBlendingState();
     plconfig.blend.write_mask = 0x7;
     plconfig.depth = GPUPipeline::DepthState::GetNoTestsState();
-    plconfig.vertex_shader = batch_vertex_shaders[0][0][0].get();
+    if (!(plconfig.vertex_shader = GetBatchVertexShader(0, 0, 0, error)))
+      return false;
     plconfig.geometry_shader = gs.get();
     plconfig.fragment_shader = fs.get();
 
@@ -1786,6 +1786,686 @@ bool GPU_HW::CompilePipelines(Error* error)
   return true;
 }
 
+std::span<const GPUPipeline::VertexAttribute> GPU_HW::GetBatchVertexAttributes(bool textured, bool uv_limits)
+{
+  static constexpr GPUPipeline::VertexAttribute vertex_attributes[] = {
+    GPUPipeline::VertexAttribute::Make(0, GPUPipeline::VertexAttribute::Semantic::Position, 0,
+                                       GPUPipeline::VertexAttribute::Type::Float, 4, OFFSETOF(BatchVertex, x)),
+    GPUPipeline::VertexAttribute::Make(1, GPUPipeline::VertexAttribute::Semantic::Color, 0,
+                                       GPUPipeline::VertexAttribute::Type::UNorm8, 4, OFFSETOF(BatchVertex, color)),
+    GPUPipeline::VertexAttribute::Make(2, GPUPipeline::VertexAttribute::Semantic::TexCoord, 0,
+                                       GPUPipeline::VertexAttribute::Type::UInt32, 1, OFFSETOF(BatchVertex, u)),
+    GPUPipeline::VertexAttribute::Make(3, GPUPipeline::VertexAttribute::Semantic::TexCoord, 1,
+                                       GPUPipeline::VertexAttribute::Type::UInt32, 1, OFFSETOF(BatchVertex, texpage)),
+    GPUPipeline::VertexAttribute::Make(4, GPUPipeline::VertexAttribute::Semantic::TexCoord, 2,
+                                       GPUPipeline::VertexAttribute::Type::UNorm8, 4, OFFSETOF(BatchVertex, uv_limits)),
+  };
+  static constexpr u32 NUM_BATCH_VERTEX_ATTRIBUTES = 2;
+  static constexpr u32 NUM_BATCH_TEXTURED_VERTEX_ATTRIBUTES = 4;
+  static constexpr u32 NUM_BATCH_TEXTURED_LIMITS_VERTEX_ATTRIBUTES = 5;
+
+  return std::span<const GPUPipeline::VertexAttribute>(
+    vertex_attributes, textured ? (uv_limits ? NUM_BATCH_TEXTURED_LIMITS_VERTEX_ATTRIBUTES :
+                                               NUM_BATCH_TEXTURED_VERTEX_ATTRIBUTES) :
+                                  NUM_BATCH_VERTEX_ATTRIBUTES);
+}
+
+namespace {
+struct BatchPipelineKey
+{
+  u8 depth_test;
+  u8 transparency_mode;
+  u8 render_mode;
+  u8 texture_mode;
+  u8 dithering;
+  u8 interlacing;
+  u8 check_mask;
+};
+} // namespace
+
+ALWAYS_INLINE static BatchPipelineKey DecodeBatchPipelineKey(u32 key)
+{
+  BatchPipelineKey ret;
+  ret.check_mask = static_cast<u8>(key % 2);
+  key /= 2;
+  ret.interlacing = static_cast<u8>(key % 2);
+  key /= 2;
+  ret.dithering = static_cast<u8>(key % 2);
+  key /= 2;
+  ret.texture_mode = static_cast<u8>(key % static_cast<u32>(GPU_HW::BatchTextureMode::MaxCount));
+  key /= static_cast<u32>(GPU_HW::BatchTextureMode::MaxCount);
+  ret.render_mode = static_cast<u8>(key % 5);
+  key /= 5;
+  ret.transparency_mode = static_cast<u8>(key % 5);
+  key /= 5;
+  ret.depth_test = static_cast<u8>(key);
+  return ret;
+}
+
+ALWAYS_INLINE_RELEASE u32 GPU_HW::GetBatchPipelineKey(u8 depth_test, u8 transparency_mode, u8 render_mode,
+                                                      u8 texture_mode, u8 dithering, u8 interlacing, u8 check_mask)
+{
+  // Same ordering as m_batch_pipelines, so the key is the flattened index.
+  u32 key = depth_test;
+  key = (key * 5u) + transparency_mode;
+  key = (key * 5u) + render_mode;
+  key = (key * NUM_TEXTURE_MODES) + texture_mode;
+  key = (key * 2u) + dithering;
+  key = (key * 2u) + interlacing;
+  key = (key * 2u) + check_mask;
+  return key;
+}
+
+std::unique_ptr<GPUPipeline>& GPU_HW::GetBatchPipeline(u32 key)
+{
+  const BatchPipelineKey k = DecodeBatchPipelineKey(key);
+  return m_batch_pipelines[k.depth_test][k.transparency_mode][k.render_mode][k.texture_mode][k.dithering][k.interlacing]
+                          [k.check_mask];
+}
+
+bool GPU_HW::IsBatchPipelineNeeded(u32 key) const
+{
+  const BatchPipelineKey k = DecodeBatchPipelineKey(key);
+  const BatchShaderConfig& cfg = m_batch_shader_config;
+
+  // Not used.
+  if (k.depth_test && !m_pgxp_depth_buffer)
+    return false;
+
+  if (
+    // Can't generate shader blending.
+    (k.render_mode == static_cast<u8>(BatchRenderMode::ShaderBlend) && !m_allow_shader_blend) ||
+    // Don't need multipass shaders.
+    ((m_supports_framebuffer_fetch || m_prefer_shader_blend) &&
+     (k.render_mode == static_cast<u8>(BatchRenderMode::OnlyOpaque) ||
+      k.render_mode == static_cast<u8>(BatchRenderMode::OnlyTransparent))) ||
+    // If using ROV depth, we only draw with shader blending.
+    (cfg.needs_rov_depth && k.render_mode != static_cast<u8>(BatchRenderMode::ShaderBlend)))
+  {
+    return false;
+  }
+
+  if (!m_allow_sprite_mode && k.texture_mode >= static_cast<u8>(BatchTextureMode::SpriteStart))
+    return false;
+
+  if (!cfg.needs_page_texture && (k.texture_mode == static_cast<u8>(BatchTextureMode::PageTexture) ||
+                                  k.texture_mode == static_cast<u8>(BatchTextureMode::SpritePageTexture)))
+  {
+    return false;
+  }
+
+  // Never going to draw with dithering on in true color, or line skipping in force progressive.
+  return (!k.dithering || !cfg.true_color) && (!k.interlacing || !cfg.force_progressive_scan);
+}
+
+namespace {
+/// Packs everything a batch shader's source is generated from into a key for the shadergen memo.
+class ShaderGenMemoKey
+{
+public:
+  ShaderGenMemoKey(GPUShaderStage stage, RenderAPI render_api, bool dual_source_blend, bool framebuffer_fetch)
+  {
+    Add(static_cast<u32>(stage), 3);
+    Add(static_cast<u32>(render_api), 4);
+    Add(dual_source_blend);
+    Add(framebuffer_fetch);
+  }
+
+  void Add(u32 value, u32 bits)
+  {
+    DebugAssert((m_bits + bits) <= 64 && value < (1u << bits));
+    m_value |= static_cast<u64>(value) << m_bits;
+    m_bits += bits;
+  }
+  void Add(bool value) { Add(BoolToUInt32(value), 1); }
+
+  u64 Get() const { return m_value; }
+
+private:
+  u64 m_value = 0;
+  u32 m_bits = 0;
+};
+} // namespace
+
+template<typename GenerateSource>
+std::unique_ptr<GPUShader> GPU_HW::CreateBatchShader(GPUShaderStage stage, GPUShaderLanguage language, u64 memo_key,
+                                                     const GenerateSource& generate_source, Error* error)
+{
+  if (m_shadergen_memo_path.empty())
+    return g_gpu_device->CreateShader(stage, language, generate_source(), error);
+
+  std::optional<GPUShaderCache::CacheIndexKey> cache_key;
+  {
+    std::unique_lock lock(m_shadergen_memo_mutex);
+    const auto iter = m_shadergen_memo.find(memo_key);
+    if (iter != m_shadergen_memo.end())
+      cache_key = iter->second;
+  }
+
+  // If we know what the source hashes to and the binary is still cached, there's no need to generate it at all.
+  std::unique_ptr<GPUShader> shader;
+  if (cache_key.has_value() && (shader = g_gpu_device->CreateShaderFromCache(stage, cache_key.value())))
+    return shader;
+
+  const std::string source = generate_source();
+  const GPUShaderCache::CacheIndexKey new_cache_key = GPUShaderCache::GetCacheKey(stage, language, source, "main");
+  if (!(shader = g_gpu_device->CreateShader(stage, language, source, error)))
+    return shader;
+
+  if (!cache_key.has_value() || cache_key.value() != new_cache_key)
+  {
+    std::unique_lock lock(m_shadergen_memo_mutex);
+    m_shadergen_memo[memo_key] = new_cache_key;
+    m_shadergen_memo_dirty = true;
+  }
+
+  return shader;
+}
+
+GPUShader* GPU_HW::GetBatchVertexShader(u8 textured, u8 palette, u8 sprite, Error* error)
+{
+  std::unique_ptr<GPUShader>& shader = m_batch_vertex_shaders[textured][palette][sprite];
+  if (shader)
+    return shader.get();
+
+  const BatchShaderConfig& cfg = m_batch_shader_config;
+  const GPU_HW_ShaderGen shadergen(g_gpu_device->GetRenderAPI(), m_supports_dual_source_blend,
+                                   m_supports_framebuffer_fetch);
+  const bool uv_limits = ShouldClampUVs(sprite ? m_sprite_texture_filtering : m_texture_filtering);
+  const bool force_round_texcoords = (!sprite && cfg.force_round_texcoords);
+
+  ShaderGenMemoKey memo_key(GPUShaderStage::Vertex, g_gpu_device->GetRenderAPI(), m_supports_dual_source_blend,
+                            m_supports_framebuffer_fetch);
+  memo_key.Add(cfg.upscaled);
+  memo_key.Add(cfg.msaa);
+  memo_key.Add(cfg.per_sample_shading);
+  memo_key.Add(textured != 0);
+  memo_key.Add(static_cast<u32>(palette), 2);
+  memo_key.Add(uv_limits);
+  memo_key.Add(force_round_texcoords);
+  memo_key.Add(m_pgxp_depth_buffer);
+  memo_key.Add(cfg.disable_color_perspective);
+
+  shader = CreateBatchShader(
+    GPUShaderStage::Vertex, shadergen.GetLanguage(), memo_key.Get(),
+    [&]() {
+      return shadergen.GenerateBatchVertexShader(cfg.upscaled, cfg.msaa, cfg.per_sample_shading, textured != 0,
+                                                 palette == 1, palette == 2, uv_limits, force_round_texcoords,
+                                                 m_pgxp_depth_buffer, cfg.disable_color_perspective);
+    },
+    error);
+  return shader.get();
+}
+
+GPUShader* GPU_HW::GetBatchFragmentShader(u8 depth_test, u8 render_mode, u8 transparency_mode, u8 texture_mode,
+                                          u8 check_mask, u8 dithering, u8 interlacing, Error* error)
+{
+  std::unique_ptr<GPUShader>& shader =
+    m_batch_fragment_shaders[depth_test][render_mode][transparency_mode][texture_mode][check_mask][dithering]
+                            [interlacing];
+  if (shader)
+    return shader.get();
+
+  const BatchShaderConfig& cfg = m_batch_shader_config;
+  const GPU_HW_ShaderGen shadergen(g_gpu_device->GetRenderAPI(), m_supports_dual_source_blend,
+                                   m_supports_framebuffer_fetch);
+  const bool sprite = (static_cast<BatchTextureMode>(texture_mode) >= BatchTextureMode::SpriteStart);
+  const bool uv_limits = ShouldClampUVs(sprite ? m_sprite_texture_filtering : m_texture_filtering);
+  const BatchTextureMode shader_texmode =
+    static_cast<BatchTextureMode>(texture_mode - (sprite ? static_cast<u8>(BatchTextureMode::SpriteStart) : 0));
+  const GPUTextureFilter texture_filter = sprite ? m_sprite_texture_filtering : m_texture_filtering;
+  const bool texture_filter_is_blended =
+    (shader_texmode != BatchTextureMode::Disabled && IsBlendedTextureFiltering(texture_filter));
+  const bool use_rov = (render_mode == static_cast<u8>(BatchRenderMode::ShaderBlend) && m_use_rov_for_shader_blend);
+  const bool rov_depth_test = (use_rov && depth_test != 0);
+  const bool rov_depth_write =
+    (rov_depth_test && static_cast<GPUTransparencyMode>(transparency_mode) == GPUTransparencyMode::Disabled);
+  const bool force_round_texcoords = (!sprite && cfg.force_round_texcoords);
+
+  ShaderGenMemoKey memo_key(GPUShaderStage::Fragment, g_gpu_device->GetRenderAPI(), m_supports_dual_source_blend,
+                            m_supports_framebuffer_fetch);
+  memo_key.Add(static_cast<u32>(render_mode), 3);
+  memo_key.Add(static_cast<u32>(transparency_mode), 3);
+  memo_key.Add(static_cast<u32>(shader_texmode), 3);
+  memo_key.Add(static_cast<u32>(texture_filter), 4);
+  memo_key.Add(texture_filter_is_blended);
+  memo_key.Add(cfg.upscaled);
+  memo_key.Add(cfg.msaa);
+  memo_key.Add(cfg.per_sample_shading);
+  memo_key.Add(uv_limits);
+  memo_key.Add(force_round_texcoords);
+  memo_key.Add(cfg.modulation_crop);
+  memo_key.Add(cfg.true_color);
+  memo_key.Add(dithering != 0);
+  memo_key.Add(cfg.scaled_dithering);
+  memo_key.Add(cfg.disable_color_perspective);
+  memo_key.Add(interlacing != 0);
+  memo_key.Add(cfg.scaled_interlacing);
+  memo_key.Add(check_mask != 0);
+  memo_key.Add(m_write_mask_as_depth);
+  memo_key.Add(use_rov);
+  memo_key.Add(cfg.needs_rov_depth);
+  memo_key.Add(rov_depth_test);
+  memo_key.Add(rov_depth_write);
+
+  shader = CreateBatchShader(
+    GPUShaderStage::Fragment, shadergen.GetLanguage(), memo_key.Get(),
+    [&]() {
+      return shadergen.GenerateBatchFragmentShader(
+        static_cast<BatchRenderMode>(render_mode), static_cast<GPUTransparencyMode>(transparency_mode),
+        shader_texmode, texture_filter, texture_filter_is_blended, cfg.upscaled, cfg.msaa, cfg.per_sample_shading,
+        uv_limits, force_round_texcoords, cfg.modulation_crop, cfg.true_color, ConvertToBoolUnchecked(dithering),
+        cfg.scaled_dithering, cfg.disable_color_perspective, ConvertToBoolUnchecked(interlacing),
+        cfg.scaled_interlacing, ConvertToBoolUnchecked(check_mask), m_write_mask_as_depth, use_rov,
+        cfg.needs_rov_depth, rov_depth_test, rov_depth_write);
+    },
+    error);
+  return shader.get();
+}
+
+GPU_HW::BatchPipelineShaders GPU_HW::GetBatchPipelineShaders(u32 key) const
+{
+  const BatchPipelineKey k = DecodeBatchPipelineKey(key);
+  const BatchTextureMode texture_mode = static_cast<BatchTextureMode>(k.texture_mode);
+  const bool textured = (texture_mode != BatchTextureMode::Disabled);
+  const bool palette =
+    (texture_mode == BatchTextureMode::Palette4Bit || texture_mode == BatchTextureMode::Palette8Bit ||
+     texture_mode == BatchTextureMode::SpritePalette4Bit || texture_mode == BatchTextureMode::SpritePalette8Bit);
+  const bool page_texture =
+    (texture_mode == BatchTextureMode::PageTexture || texture_mode == BatchTextureMode::SpritePageTexture);
+  const bool sprite = (texture_mode >= BatchTextureMode::SpriteStart);
+  const bool use_shader_blending = (k.render_mode == static_cast<u8>(BatchRenderMode::ShaderBlend));
+
+  return BatchPipelineShaders{
+    .vs = {BoolToUInt8(textured), page_texture ? static_cast<u8>(2) : BoolToUInt8(palette), BoolToUInt8(sprite)},
+    .fs = {BoolToUInt8(k.depth_test && m_batch_shader_config.needs_rov_depth), k.render_mode,
+           use_shader_blending ? k.transparency_mode : static_cast<u8>(GPUTransparencyMode::Disabled),
+           k.texture_mode, use_shader_blending ? k.check_mask : static_cast<u8>(0), k.dithering, k.interlacing}};
+}
+
+bool GPU_HW::CompileBatchPipeline(u32 key, Error* error)
+{
+  const BatchPipelineKey k = DecodeBatchPipelineKey(key);
+  const BatchShaderConfig& cfg = m_batch_shader_config;
+  const u8 depth_test = k.depth_test;
+  const u8 transparency_mode = k.transparency_mode;
+  const u8 render_mode = k.render_mode;
+  const u8 texture_mode = k.texture_mode;
+  const u8 check_mask = k.check_mask;
+
+  const bool textured = (static_cast<BatchTextureMode>(texture_mode) != BatchTextureMode::Disabled);
+  const bool sprite = (static_cast<BatchTextureMode>(texture_mode) >= BatchTextureMode::SpriteStart);
+  const bool uv_limits = ShouldClampUVs(sprite ? m_sprite_texture_filtering : m_texture_filtering);
+  const bool use_shader_blending = (render_mode == static_cast<u8>(BatchRenderMode::ShaderBlend));
+  const bool use_rov = (use_shader_blending && m_use_rov_for_shader_blend);
+
+  GPUPipeline::GraphicsConfig plconfig = {};
+  plconfig.layout = GPUPipeline::Layout::SingleTextureAndUBO;
+  plconfig.input_layout.vertex_stride = sizeof(BatchVertex);
+  plconfig.input_layout.vertex_attributes = GetBatchVertexAttributes(textured, uv_limits);
+  plconfig.rasterization = GPUPipeline::RasterizationState::GetNoCullState(m_multisamples, cfg.per_sample_shading);
+  plconfig.primitive = GPUPipeline::Primitive::Triangles;
+  plconfig.geometry_shader = nullptr;
+  plconfig.depth = GPUPipeline::DepthState::GetNoTestsState();
+
+  const BatchPipelineShaders shaders = GetBatchPipelineShaders(key);
+  plconfig.vertex_shader = GetBatchVertexShader(shaders.vs[0], shaders.vs[1], shaders.vs[2], error);
+  plconfig.fragment_shader = GetBatchFragmentShader(shaders.fs[0], shaders.fs[1], shaders.fs[2], shaders.fs[3],
+                                                    shaders.fs[4], shaders.fs[5], shaders.fs[6], error);
+  if (!plconfig.vertex_shader || !plconfig.fragment_shader)
+    return false;
+
+  if (cfg.needs_real_depth_buffer)
+  {
+    plconfig.depth.depth_test =
+      m_pgxp_depth_buffer ? (depth_test ? GPUPipeline::DepthFunc::LessEqual : GPUPipeline::DepthFunc::Always) :
+                            (check_mask ? GPUPipeline::DepthFunc::GreaterEqual : GPUPipeline::DepthFunc::Always);
+
+    // Don't write for transparent, but still test.
+    plconfig.depth.depth_write =
+      !m_pgxp_depth_buffer || (depth_test && transparency_mode == static_cast<u8>(GPUTransparencyMode::Disabled));
+  }
+
+  plconfig.SetTargetFormats(use_rov ? GPUTextureFormat::Unknown : VRAM_RT_FORMAT,
+                            cfg.needs_rov_depth ? GPUTextureFormat::Unknown : cfg.depth_buffer_format);
+  plconfig.color_formats[1] = cfg.needs_rov_depth ? VRAM_DS_COLOR_FORMAT : GPUTextureFormat::Unknown;
+
+  // Don't enable feedback loop bit if it's not needed.
+  if (use_rov)
+  {
+    plconfig.render_pass_flags = GPUPipeline::BindRenderTargetsAsImages;
+  }
+  else if (cfg.needs_feedback_loop)
+  {
+    plconfig.render_pass_flags = static_cast<GPUPipeline::RenderPassFlag>(
+      use_shader_blending ? (GPUPipeline::ColorFeedbackLoop | GPUPipeline::ColorFeedbackLoopActive) :
+                            GPUPipeline::ColorFeedbackLoop);
+  }
+  else
+  {
+    plconfig.render_pass_flags = GPUPipeline::NoRenderPassFlags;
+  }
+
+  plconfig.blend = GPUPipeline::BlendState::GetNoBlendingState();
+
+  if (use_rov)
+  {
+    plconfig.blend.write_mask = 0;
+  }
+  else if (!use_shader_blending &&
+           ((static_cast<GPUTransparencyMode>(transparency_mode) != GPUTransparencyMode::Disabled &&
+             (static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
+              static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque)) ||
+            (textured && IsBlendedTextureFiltering(sprite ? m_sprite_texture_filtering : m_texture_filtering))))
+  {
+    plconfig.blend.enable = true;
+    plconfig.blend.src_alpha_blend = GPUPipeline::BlendFunc::One;
+    plconfig.blend.dst_alpha_blend = GPUPipeline::BlendFunc::Zero;
+    plconfig.blend.alpha_blend_op = GPUPipeline::BlendOp::Add;
+
+    if (m_supports_dual_source_blend)
+    {
+      plconfig.blend.src_blend = GPUPipeline::BlendFunc::One;
+      plconfig.blend.dst_blend = GPUPipeline::BlendFunc::SrcAlpha1;
+      plconfig.blend.blend_op =
+        (static_cast<GPUTransparencyMode>(transparency_mode) == GPUTransparencyMode::BackgroundMinusForeground &&
+         static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
+         static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
+          GPUPipeline::BlendOp::ReverseSubtract :
+          GPUPipeline::BlendOp::Add;
+    }
+    else
+    {
+      // TODO: This isn't entirely accurate, 127.5 versus 128.
+      // But if we use fbfetch on Mali, it doesn't matter.
+      plconfig.blend.src_blend = GPUPipeline::BlendFunc::One;
+      plconfig.blend.dst_blend = GPUPipeline::BlendFunc::One;
+      if (static_cast<GPUTransparencyMode>(transparency_mode) == GPUTransparencyMode::HalfBackgroundPlusHalfForeground)
+      {
+        plconfig.blend.dst_blend = GPUPipeline::BlendFunc::ConstantColor;
+        plconfig.blend.dst_alpha_blend = GPUPipeline::BlendFunc::ConstantColor;
+        plconfig.blend.constant = 0x00808080u;
+      }
+
+      plconfig.blend.blend_op =
+        (static_cast<GPUTransparencyMode>(transparency_mode) == GPUTransparencyMode::BackgroundMinusForeground &&
+         static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
+         static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
+          GPUPipeline::BlendOp::ReverseSubtract :
+          GPUPipeline::BlendOp::Add;
+    }
+  }
+
+  return static_cast<bool>(
+    m_batch_pipelines[depth_test][transparency_mode][render_mode][texture_mode][k.dithering][k.interlacing]
+                     [check_mask] = g_gpu_device->CreatePipeline(plconfig, error));
+}
+
+void GPU_HW::CompileBatchPipelineOnDemand(u32 key)
+{
+  if (!IsBatchPipelineNeeded(key))
+  {
+    ERROR_LOG("Batch pipeline {} is not valid in the current configuration.", key);
+    return;
+  }
+
+  // Already compiled, but held back so that this first draw gets recorded.
+  if (!m_unrecorded_batch_pipelines.empty() && m_unrecorded_batch_pipelines[key])
+  {
+    GetBatchPipeline(key) = std::move(m_unrecorded_batch_pipelines[key]);
+  }
+  else
+  {
+    Timer timer;
+    Error error;
+    if (!CompileBatchPipeline(key, &error))
+    {
+      ERROR_LOG("Failed to compile batch pipeline {}: {}", key, error.GetDescription());
+      return;
+    }
+
+    WARNING_LOG("Compiled batch pipeline {} on demand in {:.2f} ms.", key, timer.GetTimeMilliseconds());
+  }
+
+  if (m_precompile_used_pipelines)
+  {
+    m_used_batch_pipelines.set(key);
+    m_pipeline_usage_dirty = true;
+  }
+}
+
+void GPU_HW::UpdateUnrecordedBatchPipelines()
+{
+  // Without a usage list to record into, everything that's compiled can be drawn with directly.
+  if (!m_precompile_used_pipelines)
+  {
+    for (u32 key = 0; key < static_cast<u32>(m_unrecorded_batch_pipelines.size()); key++)
+    {
+      if (m_unrecorded_batch_pipelines[key])
+        GetBatchPipeline(key) = std::move(m_unrecorded_batch_pipelines[key]);
+    }
+    m_unrecorded_batch_pipelines.clear();
+    return;
+  }
+
+  m_unrecorded_batch_pipelines.resize(NUM_BATCH_PIPELINES);
+  for (u32 key = 0; key < NUM_BATCH_PIPELINES; key++)
+  {
+    std::unique_ptr<GPUPipeline>& pipeline = GetBatchPipeline(key);
+    std::unique_ptr<GPUPipeline>& unrecorded = m_unrecorded_batch_pipelines[key];
+    if (m_used_batch_pipelines.test(key))
+    {
+      if (!pipeline && unrecorded)
+        pipeline = std::move(unrecorded);
+    }
+    else if (pipeline)
+    {
+      unrecorded = std::move(pipeline);
+    }
+  }
+}
+
+void GPU_HW::DestroyBatchShaders()
+{
+  static constexpr auto destroy_shader = [](std::unique_ptr<GPUShader>& s) { s.reset(); };
+  m_batch_vertex_shaders.enumerate(destroy_shader);
+  m_batch_fragment_shaders.enumerate(destroy_shader);
+}
+
+std::string GPU_HW::GetPipelineUsageListPath() const
+{
+  const std::string& serial = GPUThread::GetGameSerial();
+  if (serial.empty())
+    return {};
+
+  // Which permutations get drawn with depends on the blending/depth configuration, keep separate lists.
+  const BatchShaderConfig& cfg = m_batch_shader_config;
+  const u32 config_bits = (BoolToUInt32(m_allow_shader_blend) << 0) | (BoolToUInt32(m_prefer_shader_blend) << 1) |
+                          (BoolToUInt32(m_supports_framebuffer_fetch) << 2) |
+                          (BoolToUInt32(m_pgxp_depth_buffer) << 3) | (BoolToUInt32(cfg.needs_rov_depth) << 4) |
+                          (BoolToUInt32(cfg.true_color) << 5) | (BoolToUInt32(cfg.force_progressive_scan) << 6) |
+                          (BoolToUInt32(cfg.needs_page_texture) << 7) | (BoolToUInt32(m_allow_sprite_mode) << 8);
+
+  return Path::Combine(EmuFolders::Cache, TinyString::from_format("pipelines_{}_{:03X}.cache",
+                                                                  Path::SanitizeFileName(serial), config_bits));
+}
+
+void GPU_HW::ReloadPipelineUsageList()
+{
+  SavePipelineUsageList();
+
+  m_pipeline_usage_list_path = m_precompile_used_pipelines ? GetPipelineUsageListPath() : std::string();
+  m_used_batch_pipelines.reset();
+  m_pipeline_usage_dirty = false;
+  if (m_pipeline_usage_list_path.empty() || !FileSystem::FileExists(m_pipeline_usage_list_path.c_str()))
+    return;
+
+  Error error;
+  std::optional<FileSystem::MappedFile> data = FileSystem::MapBinaryFile(m_pipeline_usage_list_path.c_str(), &error);
+  if (!data.has_value())
+  {
+    ERROR_LOG("Failed to read pipeline usage list: {}", error.GetDescription());
+    return;
+  }
+
+  BinarySpanReader reader(data->cspan());
+  u32 signature, version, num_pipelines, count;
+  if (!reader.ReadU32(&signature) || !reader.ReadU32(&version) || !reader.ReadU32(&num_pipelines) ||
+      !reader.ReadU32(&count) || signature != PIPELINE_USAGE_LIST_SIGNATURE || version != SHADER_CACHE_VERSION ||
+      num_pipelines != NUM_BATCH_PIPELINES || !reader.CheckRemaining(count * sizeof(u16)))
+  {
+    WARNING_LOG("Pipeline usage list is corrupted or version mismatch, ignoring.");
+    return;
+  }
+
+  for (u32 i = 0; i < count; i++)
+  {
+    const u16 key = reader.ReadU16();
+    if (key < NUM_BATCH_PIPELINES)
+      m_used_batch_pipelines.set(key);
+  }
+
+  INFO_LOG("Loaded {} used pipelines from {}.", m_used_batch_pipelines.count(),
+           Path::GetFileName(m_pipeline_usage_list_path));
+}
+
+void GPU_HW::OnGameSerialChanged()
+{
+  // Pipelines that are already compiled stay around, anything else in the new list gets compiled when it's drawn.
+  if (m_precompile_used_pipelines)
+  {
+    ReloadPipelineUsageList();
+    UpdateUnrecordedBatchPipelines();
+  }
+}
+
+void GPU_HW::SavePipelineUsageList()
+{
+  if (!m_pipeline_usage_dirty || m_pipeline_usage_list_path.empty())
+    return;
+
+  m_pipeline_usage_dirty = false;
+
+  Error error;
+  FileSystem::AtomicRenamedFile file = FileSystem::CreateAtomicRenamedFile(m_pipeline_usage_list_path, &error);
+  if (!file)
+  {
+    ERROR_LOG("Failed to open pipeline usage list for writing: {}", error.GetDescription());
+    return;
+  }
+
+  const u32 count = static_cast<u32>(m_used_batch_pipelines.count());
+
+  BinaryFileWriter writer(file.get());
+  writer.WriteU32(PIPELINE_USAGE_LIST_SIGNATURE);
+  writer.WriteU32(SHADER_CACHE_VERSION);
+  writer.WriteU32(NUM_BATCH_PIPELINES);
+  writer.WriteU32(count);
+  for (u32 key = 0; key < NUM_BATCH_PIPELINES; key++)
+  {
+    if (m_used_batch_pipelines.test(key))
+      writer.WriteU16(static_cast<u16>(key));
+  }
+
+  if (!writer.Flush(&error) || !FileSystem::CommitAtomicRenamedFile(file, &error))
+  {
+    ERROR_LOG("Failed to write pipeline usage list: {}", error.GetDescription());
+    FileSystem::DiscardAtomicRenamedFile(file);
+    return;
+  }
+
+  INFO_LOG("Wrote {} used pipelines to {}.", count, Path::GetFileName(m_pipeline_usage_list_path));
+}
+
+void GPU_HW::LoadShaderGenMemo()
+{
+  // GL source depends on the driver's GLSL version, which isn't part of the key. Builds with local changes can alter
+  // what gets generated without the cache version changing, so they don't get a memo either.
+  const RenderAPI render_api = g_gpu_device->GetRenderAPI();
+  m_shadergen_memo.clear();
+  m_shadergen_memo_dirty = false;
+  if (!g_gpu_device->GetFeatures().shader_cache || g_gpu_settings.gpu_disable_shader_cache ||
+      EmuFolders::Cache.empty() || render_api == RenderAPI::OpenGL || render_api == RenderAPI::OpenGLES ||
+      std::string_view(g_scm_tag_str).ends_with("-dirty"))
+  {
+    m_shadergen_memo_path = {};
+    return;
+  }
+
+  m_shadergen_memo_path = Path::Combine(
+    EmuFolders::Cache, TinyString::from_format("{}.memo", g_gpu_device->GetShaderCacheBaseName("shadergen")));
+  if (!FileSystem::FileExists(m_shadergen_memo_path.c_str()))
+    return;
+
+  Error error;
+  std::optional<FileSystem::MappedFile> data = FileSystem::MapBinaryFile(m_shadergen_memo_path.c_str(), &error);
+  if (!data.has_value())
+  {
+    ERROR_LOG("Failed to read shadergen memo: {}", error.GetDescription());
+    return;
+  }
+
+  // Entries from another build could point at source that the generator no longer produces.
+  BinarySpanReader reader(data->cspan());
+  u32 signature, version, count;
+  std::string_view scm_hash;
+  if (!reader.ReadU32(&signature) || !reader.ReadU32(&version) || !reader.ReadSizePrefixedString(&scm_hash) ||
+      !reader.ReadU32(&count) || signature != SHADERGEN_MEMO_SIGNATURE || version != SHADER_CACHE_VERSION ||
+      scm_hash != g_scm_hash_str ||
+      !reader.CheckRemaining(count * (sizeof(u64) + sizeof(GPUShaderCache::CacheIndexKey))))
+  {
+    WARNING_LOG("Shadergen memo is corrupted or from a different build, ignoring.");
+    return;
+  }
+
+  m_shadergen_memo.reserve(count);
+  for (u32 i = 0; i < count; i++)
+  {
+    const u64 memo_key = reader.ReadU64();
+    GPUShaderCache::CacheIndexKey cache_key;
+    reader.Read(&cache_key, sizeof(cache_key));
+    m_shadergen_memo.emplace(memo_key, cache_key);
+  }
+
+  INFO_LOG("Loaded {} shader permutations from {}.", m_shadergen_memo.size(), Path::GetFileName(m_shadergen_memo_path));
+}
+
+void GPU_HW::SaveShaderGenMemo()
+{
+  if (!m_shadergen_memo_dirty || m_shadergen_memo_path.empty())
+    return;
+
+  m_shadergen_memo_dirty = false;
+
+  Error error;
+  FileSystem::AtomicRenamedFile file = FileSystem::CreateAtomicRenamedFile(m_shadergen_memo_path, &error);
+  if (!file)
+  {
+    ERROR_LOG("Failed to open shadergen memo for writing: {}", error.GetDescription());
+    return;
+  }
+
+  BinaryFileWriter writer(file.get());
+  writer.WriteU32(SHADERGEN_MEMO_SIGNATURE);
+  writer.WriteU32(SHADER_CACHE_VERSION);
+  writer.WriteSizePrefixedString(g_scm_hash_str);
+  writer.WriteU32(static_cast<u32>(m_shadergen_memo.size()));
+  for (const auto& [memo_key, cache_key] : m_shadergen_memo)
+  {
+    writer.WriteU64(memo_key);
+    writer.Write(&cache_key, sizeof(cache_key));
+  }
+
+  if (!writer.Flush(&error) || !FileSystem::CommitAtomicRenamedFile(file, &error))
+  {
+    ERROR_LOG("Failed to write shadergen memo: {}", error.GetDescription());
+    FileSystem::DiscardAtomicRenamedFile(file);
+    return;
+  }
+
+  INFO_LOG("Wrote {} shader permutations to {}.", m_shadergen_memo.size(), Path::GetFileName(m_shadergen_memo_path));
+}
+
 bool GPU_HW::CompileResolutionDependentPipelines(Error* error)
 {
   Timer timer;
@@ -1864,6 +2544,8 @@ bool GPU_HW::CompileResolutionDependentPipelines(Error* error)
 bool GPU_HW::CompileDownsamplePipelines(Error* error)
 {
   m_downsample_pass_pipeline.reset();
+  for (std::unique_ptr<GPUPipeline>& pipeline : m_downsample_mip_compute_pipelines)
+    pipeline.reset();
   m_downsample_blur_pipeline.reset();
   m_downsample_composite_pipeline.reset();
   m_downsample_lod_sampler.reset();
@@ -1904,6 +2586,35 @@ bool GPU_HW::CompileDownsamplePipelines(Error* error)
       return false;
     GL_OBJECT_NAME(m_downsample_pass_pipeline, "Downsample First Pass Pipeline");
 
+    // Compute path generates two mip levels per dispatch. The fragment pipeline above is still needed as a fallback.
+    const RenderAPI render_api = g_gpu_device->GetRenderAPI();
+    if (g_gpu_device->GetFeatures().compute_shaders &&
+        (render_api == RenderAPI::Vulkan || render_api == RenderAPI::D3D12 || render_api == RenderAPI::Metal))
+    {
+      GPUPipeline::ComputeConfig cplconfig;
+      cplconfig.layout = GPUPipeline::Layout::ComputeMultiTextureAndUBO;
+      for (u32 two_levels = 0; two_levels < 2; two_levels++)
+      {
+        Error compute_error;
+        std::unique_ptr<GPUShader> cs =
+          g_gpu_device->CreateShader(GPUShaderStage::Compute, shadergen.GetLanguage(),
+                                     shadergen.GenerateAdaptiveDownsampleMipComputeShader(two_levels != 0),
+                                     &compute_error);
+        cplconfig.compute_shader = cs.get();
+        if (!cs || !(m_downsample_mip_compute_pipelines[two_levels] =
+                       g_gpu_device->CreatePipeline(cplconfig, &compute_error)))
+        {
+          WARNING_LOG("Failed to compile compute downsample pipeline, using fragment path: {}",
+                      compute_error.GetDescription());
+          for (std::unique_ptr<GPUPipeline>& pipeline : m_downsample_mip_compute_pipelines)
+            pipeline.reset();
+          break;
+        }
+        GL_OBJECT_NAME_FMT(m_downsample_mip_compute_pipelines[two_levels], "Downsample Mip Compute Pipeline, levels={}",
+                           two_levels + 1);
+      }
+    }
+
     fs = g_gpu_device->CreateShader(GPUShaderStage::Fragment, shadergen.GetLanguage(),
                                     shadergen.GenerateAdaptiveDownsampleBlurFragmentShader(), error);
     if (!fs)
@@ -1976,7 +2687,7 @@ void GPU_HW::UpdateVRAMReadTexture(bool drawn, bool written)
 {
   GL_SCOPE("UpdateVRAMReadTexture()");
 
-  const auto update = [this](GSVector4i& rect, u8 dbit) {
+  const auto update = [this](GSVector4i& rect, VRAMDirtyTileMask& tiles, u8 dbit) {
     if (m_texpage_dirty & dbit)
     {
       m_texpage_dirty &= ~dbit;
@@ -1984,30 +2695,41 @@ void GPU_HW::UpdateVRAMReadTexture(bool drawn, bool written)
         GL_INS_FMT("{} texpage is no longer dirty", (dbit & TEXPAGE_DIRTY_DRAWN_RECT) ? "DRAW" : "WRITE");
     }
 
-    const GSVector4i scaled_rect = rect.mul32l(GSVector4i(m_resolution_scale));
-    if (m_vram_texture->IsMultisampled())
+    if (m_vram_texture->IsMultisampled() && !g_gpu_device->GetFeatures().partial_msaa_resolve)
     {
-      if (g_gpu_device->GetFeatures().partial_msaa_resolve)
-      {
-        g_gpu_device->ResolveTextureRegion(m_vram_read_texture.get(), scaled_rect.left, scaled_rect.top, 0, 0,
-                                           m_vram_texture.get(), scaled_rect.left, scaled_rect.top, scaled_rect.width(),
-                                           scaled_rect.height());
-      }
-      else
-      {
-        g_gpu_device->ResolveTextureRegion(m_vram_read_texture.get(), 0, 0, 0, 0, m_vram_texture.get(), 0, 0,
-                                           m_vram_texture->GetWidth(), m_vram_texture->GetHeight());
-      }
+      g_gpu_device->ResolveTextureRegion(m_vram_read_texture.get(), 0, 0, 0, 0, m_vram_texture.get(), 0, 0,
+                                         m_vram_texture->GetWidth(), m_vram_texture->GetHeight());
     }
     else
     {
-      g_gpu_device->CopyTextureRegion(m_vram_read_texture.get(), scaled_rect.left, scaled_rect.top, 0, 0,
-                                      m_vram_texture.get(), scaled_rect.left, scaled_rect.top, 0, 0,
-                                      scaled_rect.width(), scaled_rect.height());
+      // Scattered writes can produce a bounding box much larger than the area that changed, so only copy the
+      // dirty tiles. Horizontal runs of tiles are merged with identical runs in the following rows.
+      for (u32 ty = 0; ty < VRAM_DIRTY_TILES_Y; ty++)
+      {
+        while (tiles[ty] != 0)
+        {
+          const u32 start_x = CountTrailingZeros(tiles[ty]);
+          const u32 run_length = CountTrailingZeros(~(static_cast<u32>(tiles[ty]) >> start_x));
+          const u16 run_bits = static_cast<u16>(((1u << run_length) - 1) << start_x);
+          tiles[ty] &= ~run_bits;
+
+          u32 end_y = ty + 1;
+          for (; end_y < VRAM_DIRTY_TILES_Y && (tiles[end_y] & run_bits) == run_bits; end_y++)
+            tiles[end_y] &= ~run_bits;
+
+          const GSVector4i tile_rect = GSVector4i(start_x << VRAM_DIRTY_TILE_SHIFT, ty << VRAM_DIRTY_TILE_SHIFT,
+                                                  (start_x + run_length) << VRAM_DIRTY_TILE_SHIFT,
+                                                  end_y << VRAM_DIRTY_TILE_SHIFT)
+                                         .rintersect(rect);
+          if (!tile_rect.rempty())
+            UpdateVRAMReadTextureRegion(tile_rect);
+        }
+      }
     }
 
     // m_counters.num_read_texture_updates++;
     rect = INVALID_RECT;
+    tiles = {};
   };
 
   if (drawn)
@@ -2022,16 +2744,38 @@ void GPU_HW::UpdateVRAMReadTexture(bool drawn, bool written)
       GL_INS_FMT("Including write rect {}", m_vram_dirty_write_rect);
       m_vram_dirty_draw_rect = m_vram_dirty_draw_rect.runion(m_vram_dirty_write_rect);
       m_vram_dirty_write_rect = INVALID_RECT;
+      for (u32 i = 0; i < VRAM_DIRTY_TILES_Y; i++)
+        m_vram_dirty_draw_tiles[i] |= m_vram_dirty_write_tiles[i];
+      m_vram_dirty_write_tiles = {};
       dbits = TEXPAGE_DIRTY_DRAWN_RECT | TEXPAGE_DIRTY_WRITTEN_RECT;
       written = false;
     }
 
-    update(m_vram_dirty_draw_rect, dbits);
+    update(m_vram_dirty_draw_rect, m_vram_dirty_draw_tiles, dbits);
   }
   if (written)
   {
     GL_INS_FMT("Updating write rect {}", m_vram_dirty_write_rect);
-    update(m_vram_dirty_write_rect, TEXPAGE_DIRTY_WRITTEN_RECT);
+    update(m_vram_dirty_write_rect, m_vram_dirty_write_tiles, TEXPAGE_DIRTY_WRITTEN_RECT);
+  }
+}
+
+void GPU_HW::UpdateVRAMReadTextureRegion(const GSVector4i rect)
+{
+  GL_INS_FMT("Copying {} to read texture", rect);
+
+  const GSVector4i scaled_rect = rect.mul32l(GSVector4i(m_resolution_scale));
+  if (m_vram_texture->IsMultisampled())
+  {
+    g_gpu_device->ResolveTextureRegion(m_vram_read_texture.get(), scaled_rect.left, scaled_rect.top, 0, 0,
+                                       m_vram_texture.get(), scaled_rect.left, scaled_rect.top, scaled_rect.width(),
+                                       scaled_rect.height());
+  }
+  else
+  {
+    g_gpu_device->CopyTextureRegion(m_vram_read_texture.get(), scaled_rect.left, scaled_rect.top, 0, 0,
+                                    m_vram_texture.get(), scaled_rect.left, scaled_rect.top, 0, 0, scaled_rect.width(),
+                                    scaled_rect.height());
   }
 }
 
@@ -2104,6 +2848,8 @@ void GPU_HW::ClearDepthBuffer(bool only_drawing_area)
       DrawScreenQuad(clear_bounds, m_vram_depth_texture->GetSizeVec(), GSVector4::zero(), nullptr, 0);
       SetVRAMRenderTarget();
     }
+
+    InvalidateDepthCullTiles(m_clamped_drawing_area);
   }
   else
   {
@@ -2111,6 +2857,8 @@ void GPU_HW::ClearDepthBuffer(bool only_drawing_area)
       g_gpu_device->ClearRenderTarget(m_vram_depth_texture.get(), 0xFF);
     else
       g_gpu_device->ClearDepth(m_vram_depth_texture.get(), 1.0f);
+
+    ResetDepthCullTiles();
   }
 
   m_last_depth_z = 1.0f;
@@ -2148,6 +2896,7 @@ void GPU_HW::UnmapGPUBuffer(u32 used_vertices, u32 used_indices)
   m_batch_index_ptr = nullptr;
   m_batch_index_count = 0;
   m_batch_index_space = 0;
+  m_batch_deferred_index_count = 0;
 }
 
 ALWAYS_INLINE_RELEASE void GPU_HW::DrawBatchVertices(BatchRenderMode render_mode, u32 num_indices, u32 base_index,
@@ -2160,9 +2909,21 @@ ALWAYS_INLINE_RELEASE void GPU_HW::DrawBatchVertices(BatchRenderMode render_mode
                               0));
   const u8 depth_test = BoolToUInt8(m_batch.use_depth_buffer);
   const u8 check_mask = BoolToUInt8(m_batch.check_mask_before_draw);
-  g_gpu_device->SetPipeline(m_batch_pipelines[depth_test][static_cast<u8>(m_batch.transparency_mode)][static_cast<u8>(
-    render_mode)][texture_mode][BoolToUInt8(m_batch.dithering)][BoolToUInt8(m_batch.interlacing)][check_mask]
-                              .get());
+  const u8 transparency_mode = static_cast<u8>(m_batch.transparency_mode);
+  const u8 dithering = BoolToUInt8(m_batch.dithering);
+  const u8 interlacing = BoolToUInt8(m_batch.interlacing);
+  std::unique_ptr<GPUPipeline>& pipeline =
+    m_batch_pipelines[depth_test][transparency_mode][static_cast<u8>(render_mode)][texture_mode][dithering][interlacing]
+                     [check_mask];
+  if (!pipeline) [[unlikely]]
+  {
+    CompileBatchPipelineOnDemand(GetBatchPipelineKey(depth_test, transparency_mode, static_cast<u8>(render_mode),
+                                                     texture_mode, dithering, interlacing, check_mask));
+    if (!pipeline)
+      return;
+  }
+
+  g_gpu_device->SetPipeline(pipeline.get());
 
   if (m_use_texture_cache && texture_mode != static_cast<u8>(BatchTextureMode::Disabled))
   {
@@ -2513,7 +3274,7 @@ void GPU_HW::SetBatchDepthBuffer(const GPUBackendDrawCommand* cmd, bool enabled)
 
   if (m_batch_index_count > 0)
   {
-    FlushRender();
+    DeferRender();
     EnsureVertexBufferSpaceForCommand(cmd);
   }
 
@@ -2543,17 +3304,92 @@ void GPU_HW::SetBatchSpriteMode(const GPUBackendDrawCommand* cmd, bool enabled)
 
   if (m_batch_index_count > 0)
   {
-    FlushRender();
+    DeferRender();
     EnsureVertexBufferSpaceForCommand(cmd);
   }
 
-  GL_INS_FMT("Sprite mode is now {}", enabled ? "ON" : "OFF");
+  GL_INS_FMT("Sprite mode is now {}", enabled ? "ON" : "OFF");
+
+  m_batch.sprite_mode = enabled;
+}
+
+void GPU_HW::DrawLineWithSoftwareRenderer(const GPUBackendDrawLineCommand* cmd)
+{
+  const GPU_SW_Rasterizer::DrawLineFunction DrawFunction =
+    GPU_SW_Rasterizer::GetDrawLineFunction(cmd->shading_enable, cmd->transparency_enable);
+
+  for (u32 i = 0; i < cmd->num_vertices; i += 2)
+    DrawFunction(cmd, &cmd->vertices[i], &cmd->vertices[i + 1]);
+}
+
+void GPU_HW::DrawPreciseLineWithSoftwareRenderer(const GPUBackendDrawPreciseLineCommand* cmd)
+{
+  const GPU_SW_Rasterizer::DrawLineFunction DrawFunction =
+    GPU_SW_Rasterizer::GetDrawLineFunction(cmd->shading_enable, cmd->transparency_enable);
+
+  for (u32 i = 0; i < cmd->num_vertices; i += 2)
+  {
+    const GPUBackendDrawPreciseLineCommand::Vertex& RESTRICT start = cmd->vertices[i];
+    const GPUBackendDrawPreciseLineCommand::Vertex& RESTRICT end = cmd->vertices[i + 1];
+    const GPUBackendDrawLineCommand::Vertex vertices[2] = {
+      {.x = start.native_x, .y = start.native_y, .color = start.color},
+      {.x = end.native_x, .y = end.native_y, .color = end.color},
+    };
+
+    DrawFunction(cmd, &vertices[0], &vertices[1]);
+  }
+}
+
+void GPU_HW::DrawSpriteWithSoftwareRenderer(const GPUBackendDrawRectangleCommand* cmd)
+{
+  const GPU_SW_Rasterizer::DrawRectangleFunction DrawFunction = GPU_SW_Rasterizer::GetDrawRectangleFunction(
+    GPU_SW_Rasterizer::GetModulationMode(cmd->texture_enable, cmd->raw_texture_enable,
+                                         g_gpu_settings.gpu_modulation_crop),
+    cmd->transparency_enable);
+  DrawFunction(cmd);
+}
 
-  m_batch.sprite_mode = enabled;
+void GPU_HW::DrawPolygonWithSoftwareRenderer(const GPUBackendDrawPolygonCommand* cmd)
+{
+  const GPU_SW_Rasterizer::DrawTriangleFunction DrawFunction = GPU_SW_Rasterizer::GetDrawTriangleFunction(
+    cmd->shading_enable,
+    GPU_SW_Rasterizer::GetModulationMode(cmd->texture_enable, cmd->raw_texture_enable,
+                                         g_gpu_settings.gpu_modulation_crop),
+    cmd->transparency_enable);
+  DrawFunction(cmd, &cmd->vertices[0], &cmd->vertices[1], &cmd->vertices[2]);
+  if (cmd->num_vertices > 3)
+    DrawFunction(cmd, &cmd->vertices[2], &cmd->vertices[1], &cmd->vertices[3]);
+}
+
+void GPU_HW::DrawPrecisePolygonWithSoftwareRenderer(const GPUBackendDrawPrecisePolygonCommand* cmd)
+{
+  const GPU_SW_Rasterizer::DrawTriangleFunction DrawFunction = GPU_SW_Rasterizer::GetDrawTriangleFunction(
+    cmd->shading_enable,
+    GPU_SW_Rasterizer::GetModulationMode(cmd->texture_enable, cmd->raw_texture_enable,
+                                         g_gpu_settings.gpu_modulation_crop),
+    cmd->transparency_enable);
+  GPUBackendDrawPolygonCommand::Vertex sw_vertices[4];
+  for (u32 i = 0; i < cmd->num_vertices; i++)
+  {
+    const GPUBackendDrawPrecisePolygonCommand::Vertex& src = cmd->vertices[i];
+    sw_vertices[i] = GPUBackendDrawPolygonCommand::Vertex{
+      .x = src.native_x, .y = src.native_y, .color = src.color, .texcoord = src.texcoord};
+  }
+
+  DrawFunction(cmd, &sw_vertices[0], &sw_vertices[1], &sw_vertices[2]);
+  if (cmd->num_vertices > 3)
+    DrawFunction(cmd, &sw_vertices[2], &sw_vertices[1], &sw_vertices[3]);
 }
 
 void GPU_HW::DrawLine(const GPUBackendDrawLineCommand* cmd)
 {
+  if (m_render_skip)
+  {
+    AddRenderSkipDirtyRectangle(m_clamped_drawing_area);
+    DrawLineWithSoftwareRenderer(cmd);
+    return;
+  }
+
   PrepareDraw(cmd);
   SetBatchDepthBuffer(cmd, false);
 
@@ -2583,17 +3419,18 @@ void GPU_HW::DrawLine(const GPUBackendDrawLineCommand* cmd)
   }
 
   if (m_draw_with_software_renderer)
-  {
-    const GPU_SW_Rasterizer::DrawLineFunction DrawFunction =
-      GPU_SW_Rasterizer::GetDrawLineFunction(cmd->shading_enable, cmd->transparency_enable);
-
-    for (u32 i = 0; i < num_vertices; i += 2)
-      DrawFunction(cmd, &cmd->vertices[i], &cmd->vertices[i + 1]);
-  }
+    DrawLineWithSoftwareRenderer(cmd);
 }
 
 void GPU_HW::DrawPreciseLine(const GPUBackendDrawPreciseLineCommand* cmd)
 {
+  if (m_render_skip)
+  {
+    AddRenderSkipDirtyRectangle(m_clamped_drawing_area);
+    DrawPreciseLineWithSoftwareRenderer(cmd);
+    return;
+  }
+
   PrepareDraw(cmd);
 
   const bool use_depth = m_pgxp_depth_buffer && cmd->valid_w;
@@ -2639,22 +3476,7 @@ void GPU_HW::DrawPreciseLine(const GPUBackendDrawPreciseLineCommand* cmd)
   }
 
   if (m_draw_with_software_renderer)
-  {
-    const GPU_SW_Rasterizer::DrawLineFunction DrawFunction =
-      GPU_SW_Rasterizer::GetDrawLineFunction(cmd->shading_enable, cmd->transparency_enable);
-
-    for (u32 i = 0; i < cmd->num_vertices; i += 2)
-    {
-      const GPUBackendDrawPreciseLineCommand::Vertex& RESTRICT start = cmd->vertices[i];
-      const GPUBackendDrawPreciseLineCommand::Vertex& RESTRICT end = cmd->vertices[i + 1];
-      const GPUBackendDrawLineCommand::Vertex vertices[2] = {
-        {.x = start.native_x, .y = start.native_y, .color = start.color},
-        {.x = end.native_x, .y = end.native_y, .color = end.color},
-      };
-
-      DrawFunction(cmd, &vertices[0], &vertices[1]);
-    }
-  }
+    DrawPreciseLineWithSoftwareRenderer(cmd);
 }
 
 void GPU_HW::DrawLine(const GPUBackendDrawCommand* cmd, const GSVector4 bounds, u32 col0, u32 col1, float depth0,
@@ -2765,6 +3587,13 @@ void GPU_HW::DrawLine(const GPUBackendDrawCommand* cmd, const GSVector4 bounds,
 
 void GPU_HW::DrawSprite(const GPUBackendDrawRectangleCommand* cmd)
 {
+  if (m_render_skip)
+  {
+    AddRenderSkipDirtyRectangle(m_clamped_drawing_area);
+    DrawSpriteWithSoftwareRenderer(cmd);
+    return;
+  }
+
   // Treat non-textured sprite draws as fills, so we don't break the TC on framebuffer clears.
   bool draw_with_software_renderer = m_draw_with_software_renderer;
   if (m_use_texture_cache && !cmd->transparency_enable && !cmd->shading_enable && !cmd->texture_enable &&
@@ -2842,17 +3671,17 @@ void GPU_HW::DrawSprite(const GPUBackendDrawRectangleCommand* cmd)
 
       const u32 base_vertex = m_batch_vertex_count;
       (m_batch_vertex_ptr++)
-        ->Set(quad_start_x, quad_start_y, depth, 1.0f, color, texpage, Truncate16(tex_left), Truncate16(tex_top),
-              uv_limits);
+        ->Set(GSVector4(quad_start_x, quad_start_y, depth, 1.0f),
+              BatchVertex::PackAttributes(color, texpage, tex_left, tex_top, uv_limits));
       (m_batch_vertex_ptr++)
-        ->Set(quad_end_x, quad_start_y, depth, 1.0f, color, texpage, Truncate16(tex_right), Truncate16(tex_top),
-              uv_limits);
+        ->Set(GSVector4(quad_end_x, quad_start_y, depth, 1.0f),
+              BatchVertex::PackAttributes(color, texpage, tex_right, tex_top, uv_limits));
       (m_batch_vertex_ptr++)
-        ->Set(quad_start_x, quad_end_y, depth, 1.0f, color, texpage, Truncate16(tex_left), Truncate16(tex_bottom),
-              uv_limits);
+        ->Set(GSVector4(quad_start_x, quad_end_y, depth, 1.0f),
+              BatchVertex::PackAttributes(color, texpage, tex_left, tex_bottom, uv_limits));
       (m_batch_vertex_ptr++)
-        ->Set(quad_end_x, quad_end_y, depth, 1.0f, color, texpage, Truncate16(tex_right), Truncate16(tex_bottom),
-              uv_limits);
+        ->Set(GSVector4(quad_end_x, quad_end_y, depth, 1.0f),
+              BatchVertex::PackAttributes(color, texpage, tex_right, tex_bottom, uv_limits));
       m_batch_vertex_count += 4;
       m_batch_vertex_space -= 4;
 
@@ -2876,19 +3705,21 @@ void GPU_HW::DrawSprite(const GPUBackendDrawRectangleCommand* cmd)
   AddDrawnRectangle(clamped_rect);
 
   if (draw_with_software_renderer)
-  {
-    const GPU_SW_Rasterizer::DrawRectangleFunction DrawFunction = GPU_SW_Rasterizer::GetDrawRectangleFunction(
-      GPU_SW_Rasterizer::GetModulationMode(cmd->texture_enable, cmd->raw_texture_enable,
-                                           g_gpu_settings.gpu_modulation_crop),
-      cmd->transparency_enable);
-    DrawFunction(cmd);
-  }
+    DrawSpriteWithSoftwareRenderer(cmd);
 }
 
 void GPU_HW::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
 {
-  // TODO: This could write directly to the mapped GPU pointer. But watch out for the reads below.
+  if (m_render_skip)
+  {
+    AddRenderSkipDirtyRectangle(m_clamped_drawing_area);
+    DrawPolygonWithSoftwareRenderer(cmd);
+    return;
+  }
+
+  // Vertices are built on the stack rather than in the mapped buffer, since the heuristics below read them back.
   const bool raw_texture = (cmd->texture_enable && cmd->raw_texture_enable);
+  const bool truncate_color = ShouldTruncate32To16(cmd);
   const u32 texpage = ZeroExtend32(cmd->draw_mode.bits) | (ZeroExtend32(cmd->palette.bits) << 16);
   std::array<BatchVertex, 4> vertices;
   u32 num_vertices = cmd->num_vertices;
@@ -2896,8 +3727,9 @@ void GPU_HW::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
   {
     const GPUBackendDrawPolygonCommand::Vertex& vert = cmd->vertices[i];
     const GSVector2 vert_pos = GSVector2(GSVector2i::load<true>(&vert.x));
-    vertices[i].Set(vert_pos.x, vert_pos.y, 0.0f, 1.0f, raw_texture ? UINT32_C(0x00808080) : vert.color, texpage,
-                    vert.texcoord, 0xFFFF0000u);
+    const u32 color = raw_texture ? UINT32_C(0x00808080) : (truncate_color ? Truncate32To16(vert.color) : vert.color);
+    vertices[i].Set(GSVector4::xyxy(vert_pos, GSVector2::cxpr(0.0f, 1.0f)),
+                    BatchVertex::PackAttributes(color, texpage, vert.u, vert.v, 0xFFFF0000u));
   }
 
   GSVector4i clamped_draw_rect_012, clamped_draw_rect_123;
@@ -2909,30 +3741,32 @@ void GPU_HW::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
   }
 
   if (m_draw_with_software_renderer)
-  {
-    const GPU_SW_Rasterizer::DrawTriangleFunction DrawFunction = GPU_SW_Rasterizer::GetDrawTriangleFunction(
-      cmd->shading_enable,
-      GPU_SW_Rasterizer::GetModulationMode(cmd->texture_enable, cmd->raw_texture_enable,
-                                           g_gpu_settings.gpu_modulation_crop),
-      cmd->transparency_enable);
-    DrawFunction(cmd, &cmd->vertices[0], &cmd->vertices[1], &cmd->vertices[2]);
-    if (cmd->num_vertices > 3)
-      DrawFunction(cmd, &cmd->vertices[2], &cmd->vertices[1], &cmd->vertices[3]);
-  }
+    DrawPolygonWithSoftwareRenderer(cmd);
 }
 
 void GPU_HW::DrawPrecisePolygon(const GPUBackendDrawPrecisePolygonCommand* cmd)
 {
-  // TODO: This could write directly to the mapped GPU pointer. But watch out for the reads below.
+  if (m_render_skip)
+  {
+    AddRenderSkipDirtyRectangle(m_clamped_drawing_area);
+    DrawPrecisePolygonWithSoftwareRenderer(cmd);
+    return;
+  }
+
+  // Vertices are built on the stack rather than in the mapped buffer, since the heuristics below read them back.
   const bool raw_texture = (cmd->texture_enable && cmd->raw_texture_enable);
+  const bool truncate_color = ShouldTruncate32To16(cmd);
   const u32 texpage = ZeroExtend32(cmd->draw_mode.bits) | (ZeroExtend32(cmd->palette.bits) << 16);
   std::array<BatchVertex, 4> vertices;
   u32 num_vertices = cmd->num_vertices;
   for (u32 i = 0; i < num_vertices; i++)
   {
     const GPUBackendDrawPrecisePolygonCommand::Vertex& vert = cmd->vertices[i];
-    vertices[i].Set(vert.x, vert.y, 0.0f, vert.w, raw_texture ? UINT32_C(0x00808080) : vert.color, texpage,
-                    vert.texcoord, 0xFFFF0000u);
+    const u32 color = raw_texture ? UINT32_C(0x00808080) : (truncate_color ? Truncate32To16(vert.color) : vert.color);
+    const u32 u = vert.texcoord & 0xFFu;
+    const u32 v = ZeroExtend32(vert.texcoord) >> 8;
+    vertices[i].Set(GSVector4(vert.x, vert.y, 0.0f, vert.w),
+                    BatchVertex::PackAttributes(color, texpage, u, v, 0xFFFF0000u));
   }
 
   GSVector4i clamped_draw_rect_012, clamped_draw_rect_123;
@@ -2952,28 +3786,34 @@ void GPU_HW::DrawPrecisePolygon(const GPUBackendDrawPrecisePolygonCommand* cmd)
       CheckForDepthClear(cmd, average_z);
     }
 
-    FinishPolygonDraw(cmd, vertices, num_vertices, true, is_3d, clamped_draw_rect_012, clamped_draw_rect_123);
-  }
-
-  if (m_draw_with_software_renderer)
-  {
-    const GPU_SW_Rasterizer::DrawTriangleFunction DrawFunction = GPU_SW_Rasterizer::GetDrawTriangleFunction(
-      cmd->shading_enable,
-      GPU_SW_Rasterizer::GetModulationMode(cmd->texture_enable, cmd->raw_texture_enable,
-                                           g_gpu_settings.gpu_modulation_crop),
-      cmd->transparency_enable);
-    GPUBackendDrawPolygonCommand::Vertex sw_vertices[4];
-    for (u32 i = 0; i < cmd->num_vertices; i++)
+    // The software renderer doesn't depth test, and wireframes should show everything that was submitted.
+    const bool depth_cull = (use_depth && m_depth_culling && !m_draw_with_software_renderer &&
+                             m_wireframe_mode == GPUWireframeMode::Disabled);
+    const GSVector4i polygon_rect =
+      (num_vertices == 4) ? clamped_draw_rect_012.runion(clamped_draw_rect_123) : clamped_draw_rect_012;
+    if (depth_cull && IsPolygonDepthCulled(vertices.data(), num_vertices, polygon_rect))
     {
-      const GPUBackendDrawPrecisePolygonCommand::Vertex& src = cmd->vertices[i];
-      sw_vertices[i] = GPUBackendDrawPolygonCommand::Vertex{
-        .x = src.native_x, .y = src.native_y, .color = src.color, .texcoord = src.texcoord};
+      GL_INS_FMT("Culling occluded polygon: {},{} {},{} {},{}", vertices[0].x, vertices[0].y, vertices[1].x,
+                 vertices[1].y, vertices[2].x, vertices[2].y);
+      s_counters.num_depth_culled_polygons++;
     }
+    else
+    {
+      FinishPolygonDraw(cmd, vertices, num_vertices, true, is_3d, clamped_draw_rect_012, clamped_draw_rect_123);
 
-    DrawFunction(cmd, &sw_vertices[0], &sw_vertices[1], &sw_vertices[2]);
-    if (cmd->num_vertices > 3)
-      DrawFunction(cmd, &sw_vertices[2], &sw_vertices[1], &sw_vertices[3]);
+      // Untextured opaque polygons write every covered pixel, so they can act as occluders.
+      if (depth_cull && !cmd->transparency_enable && !cmd->texture_enable && !m_batch.check_mask_before_draw &&
+          !m_batch.interlacing)
+      {
+        UpdateDepthCullTiles(vertices[0], vertices[1], vertices[2], clamped_draw_rect_012);
+        if (num_vertices == 4)
+          UpdateDepthCullTiles(vertices[2], vertices[1], vertices[3], clamped_draw_rect_123);
+      }
+    }
   }
+
+  if (m_draw_with_software_renderer)
+    DrawPrecisePolygonWithSoftwareRenderer(cmd);
 }
 
 ALWAYS_INLINE_RELEASE bool GPU_HW::BeginPolygonDraw(const GPUBackendDrawCommand* cmd,
@@ -3085,12 +3925,6 @@ ALWAYS_INLINE_RELEASE bool GPU_HW::BeginPolygonDraw(const GPUBackendDrawCommand*
     }
   }
 
-  if (ShouldTruncate32To16(cmd))
-  {
-    for (u32 i = 0; i < 4; i++)
-      vertices[i].color = Truncate32To16(vertices[i].color);
-  }
-
   PrepareDraw(cmd);
   return true;
 }
@@ -3140,10 +3974,10 @@ ALWAYS_INLINE_RELEASE void GPU_HW::FinishPolygonDraw(const GPUBackendDrawCommand
     m_batch_index_space -= 3;
 
     // Fake depth must be written here rather than at vertex init time, because a flush could occur in between.
+    // It's set before copying, so the mapped buffer only sees whole vertices.
     DebugAssert(m_batch_vertex_space >= 4);
+    vertices[0].z = vertices[1].z = vertices[2].z = vertices[3].z = GetCurrentNormalizedVertexDepth();
     std::memcpy(m_batch_vertex_ptr, vertices.data(), sizeof(BatchVertex) * 4);
-    m_batch_vertex_ptr[0].z = m_batch_vertex_ptr[1].z = m_batch_vertex_ptr[2].z = m_batch_vertex_ptr[3].z =
-      GetCurrentNormalizedVertexDepth();
     m_batch_vertex_ptr += 4;
     m_batch_vertex_count += 4;
     m_batch_vertex_space -= 4;
@@ -3151,8 +3985,8 @@ ALWAYS_INLINE_RELEASE void GPU_HW::FinishPolygonDraw(const GPUBackendDrawCommand
   else
   {
     DebugAssert(m_batch_vertex_space >= 3);
+    vertices[0].z = vertices[1].z = vertices[2].z = GetCurrentNormalizedVertexDepth();
     std::memcpy(m_batch_vertex_ptr, vertices.data(), sizeof(BatchVertex) * 3);
-    m_batch_vertex_ptr[0].z = m_batch_vertex_ptr[1].z = m_batch_vertex_ptr[2].z = GetCurrentNormalizedVertexDepth();
     m_batch_vertex_ptr += 3;
     m_batch_vertex_count += 3;
     m_batch_vertex_space -= 3;
@@ -3253,7 +4087,7 @@ ALWAYS_INLINE_RELEASE void GPU_HW::CheckForTexPageOverlap(const GPUBackendDrawCo
 
     if (update_drawn || update_written)
     {
-      if (m_batch_index_count > 0)
+      if (!IsFlushed())
       {
         FlushRender();
         EnsureVertexBufferSpaceForCommand(cmd);
@@ -3271,7 +4105,7 @@ bool GPU_HW::ShouldCheckForTexPageOverlap() const
 
 ALWAYS_INLINE bool GPU_HW::IsFlushed() const
 {
-  return (m_batch_index_count == 0);
+  return (m_batch_index_count == 0 && m_deferred_draws.empty());
 }
 
 ALWAYS_INLINE_RELEASE bool GPU_HW::NeedsTwoPassRendering() const
@@ -3367,10 +4201,18 @@ ALWAYS_INLINE float GPU_HW::GetCurrentNormalizedVertexDepth() const
 
 void GPU_HW::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, bool interlaced_rendering, u8 active_line_lsb)
 {
+  if (m_render_skip)
+  {
+    AddRenderSkipDirtyRectangle(GetVRAMTransferBounds(x, y, width, height));
+    GPU_SW_Rasterizer::FillVRAM(x, y, width, height, color, interlaced_rendering, active_line_lsb);
+    return;
+  }
+
   FlushRender();
   DeactivateROV();
 
   GL_SCOPE_FMT("FillVRAM({},{} => {},{} ({}x{}) with 0x{:08X}", x, y, x + width, y + height, width, height, color);
+  const GPUDevice::TimingScope timing_scope("VRAM Fill");
 
   GL_INS_FMT("Dirty draw area before: {}", m_vram_dirty_draw_rect);
 
@@ -3426,21 +4268,29 @@ void GPU_HW::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
 {
   GL_SCOPE_FMT("ReadVRAM({},{} => {},{} ({}x{})", x, y, x + width, y + height, width, height);
 
-  if (m_draw_with_software_renderer)
+  if (m_draw_with_software_renderer || m_render_skip)
   {
     GL_INS("VRAM is already up to date due to SW draws.");
     return;
   }
 
+  // The download replaces drawn areas of our copy of VRAM.
+  if (m_use_texture_cache)
+    GPUTextureCache::InvalidateRowHashes(GetVRAMReadbackRect(x, y, width, height));
+
+  if (m_speculative_readbacks)
+  {
+    const GSVector4i copy_rect = GetVRAMReadbackRect(x, y, width, height);
+    m_frame_readback_rect = m_frame_readback_rect.runion(copy_rect);
+    if (ReadSpeculativeVRAM(copy_rect))
+      return;
+  }
+
   DownloadVRAMFromGPU(x, y, width, height);
 }
 
-void GPU_HW::DownloadVRAMFromGPU(u32 x, u32 y, u32 width, u32 height)
+GSVector4i GPU_HW::GetVRAMReadbackRect(u32 x, u32 y, u32 width, u32 height)
 {
-  FlushRender();
-
-  // TODO: Only read if it's in the drawn area
-
   // Get bounds with wrap-around handled.
   GSVector4i copy_rect = GetVRAMTransferBounds(x, y, width, height);
 
@@ -3451,8 +4301,11 @@ void GPU_HW::DownloadVRAMFromGPU(u32 x, u32 y, u32 width, u32 height)
     copy_rect.right++;
 
   DebugAssert((copy_rect.left % 2) == 0 && (copy_rect.width() % 2) == 0);
-  const u32 encoded_left = copy_rect.left / 2;
-  const u32 encoded_top = copy_rect.top;
+  return copy_rect;
+}
+
+void GPU_HW::EncodeVRAMForReadback(const GSVector4i copy_rect)
+{
   const u32 encoded_width = copy_rect.width() / 2;
   const u32 encoded_height = copy_rect.height();
 
@@ -3463,6 +4316,21 @@ void GPU_HW::DownloadVRAMFromGPU(u32 x, u32 y, u32 width, u32 height)
   g_gpu_device->SetTextureSampler(0, m_vram_texture.get(), g_gpu_device->GetNearestSampler());
   g_gpu_device->SetViewportAndScissor(0, 0, encoded_width, encoded_height);
   g_gpu_device->DrawWithPushConstants(3, 0, uniforms, sizeof(uniforms));
+}
+
+void GPU_HW::DownloadVRAMFromGPU(u32 x, u32 y, u32 width, u32 height)
+{
+  FlushRender();
+
+  // TODO: Only read if it's in the drawn area
+
+  const GSVector4i copy_rect = GetVRAMReadbackRect(x, y, width, height);
+  const u32 encoded_left = copy_rect.left / 2;
+  const u32 encoded_top = copy_rect.top;
+  const u32 encoded_width = copy_rect.width() / 2;
+  const u32 encoded_height = copy_rect.height();
+
+  EncodeVRAMForReadback(copy_rect);
 
   // Stage the readback and copy it into our shadow buffer.
   if (m_vram_readback_download_texture->IsImported())
@@ -3485,15 +4353,82 @@ void GPU_HW::DownloadVRAMFromGPU(u32 x, u32 y, u32 width, u32 height)
   RestoreDeviceContext();
 }
 
-void GPU_HW::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask)
+bool GPU_HW::ReadSpeculativeVRAM(const GSVector4i copy_rect)
+{
+  if (m_speculative_readback_rect.rempty() || !m_speculative_readback_rect.rcontains(copy_rect) ||
+      m_speculative_readback_stale_rect.rintersects(copy_rect))
+  {
+    return false;
+  }
+
+  GL_INS_FMT("Using speculative readback of {} for {}", m_speculative_readback_rect, copy_rect);
+
+  // Should have completed by now, a frame has passed since it was queued.
+  if (m_vram_speculative_download_texture->NeedsFlush())
+    m_vram_speculative_download_texture->Flush();
+
+  return m_vram_speculative_download_texture->ReadTexels(
+    copy_rect.left / 2, copy_rect.top, copy_rect.width() / 2, copy_rect.height(),
+    &g_vram[copy_rect.top * VRAM_WIDTH + copy_rect.left], VRAM_WIDTH * sizeof(u16));
+}
+
+void GPU_HW::QueueSpeculativeReadback()
 {
+  // Only predict a readback when the last two frames read the same area.
+  const GSVector4i rect = std::exchange(m_frame_readback_rect, INVALID_RECT);
+  const bool predicted = (!rect.rempty() && rect.eq(m_last_frame_readback_rect));
+  m_last_frame_readback_rect = rect;
+  if (!m_speculative_readbacks || !predicted)
+    return;
+
+  // Can't use an imported buffer here, the copy would land in guest VRAM at an arbitrary point.
+  if (!m_vram_speculative_download_texture)
+  {
+    Error error;
+    m_vram_speculative_download_texture =
+      g_gpu_device->CreateDownloadTexture(m_vram_readback_texture->GetWidth(), m_vram_readback_texture->GetHeight(),
+                                          m_vram_readback_texture->GetFormat(), &error);
+    if (!m_vram_speculative_download_texture)
+    {
+      ERROR_LOG("Failed to create speculative readback texture: {}", error.GetDescription());
+      m_speculative_readbacks = false;
+      return;
+    }
+  }
+
+  GL_SCOPE_FMT("QueueSpeculativeReadback({})", rect);
+
   FlushRender();
+  EncodeVRAMForReadback(rect);
+  m_vram_speculative_download_texture->CopyFromTexture(rect.left / 2, rect.top, m_vram_readback_texture.get(), 0, 0,
+                                                         rect.width() / 2, rect.height(), 0, 0, false);
+  m_speculative_readback_rect = rect;
+  m_speculative_readback_stale_rect = INVALID_RECT;
+  RestoreDeviceContext();
+}
 
-  GL_SCOPE_FMT("UpdateVRAM({},{} => {},{} ({}x{})", x, y, x + width, y + height, width, height);
+void GPU_HW::InvalidateSpeculativeReadback()
+{
+  m_speculative_readback_rect = INVALID_RECT;
+}
 
+void GPU_HW::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask)
+{
   // TODO: Handle wrapped transfers... break them up or something
   const GSVector4i bounds = GetVRAMTransferBounds(x, y, width, height);
   DebugAssert(bounds.right <= static_cast<s32>(VRAM_WIDTH) && bounds.bottom <= static_cast<s32>(VRAM_HEIGHT));
+  if (m_render_skip)
+  {
+    AddRenderSkipDirtyRectangle(bounds);
+    GPU_SW_Rasterizer::WriteVRAM(x, y, width, height, data, set_mask, check_mask);
+    return;
+  }
+
+  FlushRender();
+
+  GL_SCOPE_FMT("UpdateVRAM({},{} => {},{} ({}x{})", x, y, x + width, y + height, width, height);
+  const GPUDevice::TimingScope timing_scope("VRAM Write");
+
   AddWrittenRectangle(bounds);
 
   GPUTextureCache::WriteVRAM(x, y, width, height, data, set_mask, check_mask, bounds);
@@ -3506,10 +4441,7 @@ void GPU_HW::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, b
   else
   {
     // no point dumping things we can't replace, so put it after the mask check
-    if (GPUTextureCache::ShouldDumpVRAMWrite(width, height))
-      GPUTextureCache::DumpVRAMWrite(width, height, data);
-
-    GPUTexture* rtex = GPUTextureCache::GetVRAMReplacement(width, height, data);
+    GPUTexture* rtex = GPUTextureCache::ProcessVRAMWrite(width, height, data);
     if (rtex && BlitVRAMReplacementTexture(rtex, x * m_resolution_scale, y * m_resolution_scale,
                                            width * m_resolution_scale, height * m_resolution_scale))
     {
@@ -3524,6 +4456,7 @@ void GPU_HW::UpdateVRAMOnGPU(u32 x, u32 y, u32 width, u32 height, const void* da
                              bool check_mask, const GSVector4i bounds)
 {
   DeactivateROV();
+  InvalidateDepthCullTiles(bounds);
 
   GPUDevice::AutoRecycleTexture upload_texture;
   u32 map_index;
@@ -3592,9 +4525,17 @@ void GPU_HW::UpdateVRAMOnGPU(u32 x, u32 y, u32 width, u32 height, const void* da
 
 void GPU_HW::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height, bool set_mask, bool check_mask)
 {
+  if (m_render_skip)
+  {
+    AddRenderSkipDirtyRectangle(GetVRAMTransferBounds(dst_x, dst_y, width, height));
+    GPU_SW_Rasterizer::CopyVRAM(src_x, src_y, dst_x, dst_y, width, height, set_mask, check_mask);
+    return;
+  }
+
   FlushRender();
 
   GL_SCOPE_FMT("CopyVRAM({}x{} @ {},{} => {},{}", width, height, src_x, src_y, dst_x, dst_y);
+  const GPUDevice::TimingScope timing_scope("VRAM Copy");
 
   // masking enabled, oversized, or overlapping
   const GSVector4i src_bounds = GetVRAMTransferBounds(src_x, src_y, width, height);
@@ -3860,7 +4801,7 @@ void GPU_HW::PrepareDraw(const GPUBackendDrawCommand* cmd)
         m_batch.set_mask_while_drawing != cmd->set_mask_while_drawing ||
         (texture_mode == BatchTextureMode::PageTexture && m_texture_cache_key != texture_cache_key))
     {
-      FlushRender();
+      DeferRender();
     }
   }
 
@@ -3917,6 +4858,13 @@ void GPU_HW::PrepareDraw(const GPUBackendDrawCommand* cmd)
 
     if (m_drawing_area_changed)
     {
+      // scissor applies to everything that hasn't been submitted
+      if (!m_deferred_draws.empty())
+      {
+        FlushRender();
+        EnsureVertexBufferSpaceForCommand(cmd);
+      }
+
       m_drawing_area_changed = false;
       SetScissor();
 
@@ -3936,11 +4884,14 @@ void GPU_HW::PrepareDraw(const GPUBackendDrawCommand* cmd)
 void GPU_HW::FlushRender()
 {
   const u32 base_vertex = m_batch_base_vertex;
-  const u32 base_index = m_batch_base_index;
+  const u32 deferred_index_count = m_batch_deferred_index_count;
+  const u32 base_index = m_batch_base_index + deferred_index_count;
   const u32 index_count = m_batch_index_count;
   DebugAssert((m_batch_vertex_ptr != nullptr) == (m_batch_index_ptr != nullptr));
   if (m_batch_vertex_ptr)
-    UnmapGPUBuffer(m_batch_vertex_count, index_count);
+    UnmapGPUBuffer(m_batch_vertex_count, deferred_index_count + index_count);
+  if (!m_deferred_draws.empty())
+    SubmitDeferredDraws(m_batch_base_index, base_vertex);
   if (index_count == 0)
     return;
 
@@ -3973,21 +4924,29 @@ void GPU_HW::FlushRender()
   m_current_draw_rect = INVALID_RECT;
   m_current_uv_rect = INVALID_RECT;
 
+  DrawBatch(index_count, base_index, base_vertex, texture);
+}
+
+void GPU_HW::DrawBatch(u32 num_indices, u32 base_index, u32 base_vertex, const GPUTextureCache::Source* texture)
+{
+  // Left open, so that consecutive batches share a scope. The next transfer, display update or submit closes it.
+  g_gpu_device->BeginTimingScope("VRAM Draw");
+
   if (m_wireframe_mode != GPUWireframeMode::OnlyWireframe)
   {
     if (NeedsShaderBlending(m_batch.transparency_mode, m_batch.texture_mode, m_batch.check_mask_before_draw) ||
         m_rov_active || (m_use_rov_for_shader_blend && m_pgxp_depth_buffer))
     {
-      DrawBatchVertices(BatchRenderMode::ShaderBlend, index_count, base_index, base_vertex, texture);
+      DrawBatchVertices(BatchRenderMode::ShaderBlend, num_indices, base_index, base_vertex, texture);
     }
     else if (NeedsTwoPassRendering())
     {
-      DrawBatchVertices(BatchRenderMode::OnlyOpaque, index_count, base_index, base_vertex, texture);
-      DrawBatchVertices(BatchRenderMode::OnlyTransparent, index_count, base_index, base_vertex, texture);
+      DrawBatchVertices(BatchRenderMode::OnlyOpaque, num_indices, base_index, base_vertex, texture);
+      DrawBatchVertices(BatchRenderMode::OnlyTransparent, num_indices, base_index, base_vertex, texture);
     }
     else
     {
-      DrawBatchVertices(m_batch.GetRenderMode(), index_count, base_index, base_vertex, texture);
+      DrawBatchVertices(m_batch.GetRenderMode(), num_indices, base_index, base_vertex, texture);
     }
   }
 
@@ -3996,8 +4955,57 @@ void GPU_HW::FlushRender()
     // This'll be less than ideal, but wireframe is for debugging, so take the perf hit.
     DeactivateROV();
     g_gpu_device->SetPipeline(m_wireframe_pipeline.get());
-    g_gpu_device->DrawIndexed(index_count, base_index, base_vertex);
+    g_gpu_device->DrawIndexed(num_indices, base_index, base_vertex);
+  }
+}
+
+void GPU_HW::DeferRender()
+{
+  // Texture cache lookups and ROV activation depend on the draws before them having been submitted.
+  if (!m_defer_batches || m_use_texture_cache || m_use_rov_for_shader_blend || m_batch_index_count == 0)
+  {
+    FlushRender();
+    return;
+  }
+
+  DeferredDraw& dd = m_deferred_draws.emplace_back();
+  dd.batch = m_batch;
+  dd.base_index = m_batch_deferred_index_count;
+  dd.num_indices = m_batch_index_count;
+  dd.ubo_dirty = std::exchange(m_batch_ubo_dirty, false);
+  if (dd.ubo_dirty)
+    dd.ubo_data = m_batch_ubo_data;
+
+  m_batch_deferred_index_count += m_batch_index_count;
+  m_batch_index_count = 0;
+  m_current_draw_rect = INVALID_RECT;
+  m_current_uv_rect = INVALID_RECT;
+
+  if (m_deferred_draws.size() == MAX_DEFERRED_DRAWS)
+    FlushRender();
+}
+
+void GPU_HW::SubmitDeferredDraws(u32 base_index, u32 base_vertex)
+{
+  GL_SCOPE_FMT("Submit {} deferred draws", m_deferred_draws.size());
+
+  const BatchConfig current_batch = m_batch;
+  for (const DeferredDraw& dd : m_deferred_draws)
+  {
+    if (dd.ubo_dirty)
+      g_gpu_device->UploadUniformBuffer(&dd.ubo_data, sizeof(dd.ubo_data));
+
+    m_batch = dd.batch;
+    DrawBatch(dd.num_indices, base_index + dd.base_index, base_vertex, nullptr);
   }
+
+  m_batch = current_batch;
+  m_deferred_draws.clear();
+}
+
+void GPU_HW::DiscardDeferredDraws()
+{
+  m_deferred_draws.clear();
 }
 
 void GPU_HW::DrawingAreaChanged()
@@ -4010,8 +5018,10 @@ void GPU_HW::UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd)
 {
   FlushRender();
   DeactivateROV();
+  QueueSpeculativeReadback();
 
   GL_SCOPE("UpdateDisplay()");
+  const GPUDevice::TimingScope timing_scope("Display Update");
 
   GPUTextureCache::Compact();
 
@@ -4022,6 +5032,7 @@ void GPU_HW::UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd)
 
   if (g_gpu_settings.gpu_show_vram)
   {
+    InvalidateCachedDisplay();
     if (IsUsingMultisampling())
     {
       UpdateVRAMReadTexture(!m_vram_dirty_draw_rect.eq(INVALID_RECT), !m_vram_dirty_write_rect.eq(INVALID_RECT));
@@ -4049,6 +5060,7 @@ void GPU_HW::UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd)
 
   if (cmd->display_disabled)
   {
+    InvalidateCachedDisplay();
     m_presenter.ClearDisplayTexture();
     if (interlaced)
       m_presenter.Deinterlace(interlaced_field);
@@ -4060,6 +5072,7 @@ void GPU_HW::UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd)
            (scaled_vram_offset_y + scaled_display_height) <= m_vram_texture->GetHeight() &&
            (!m_internal_postfx || !m_internal_postfx->IsActive()))
   {
+    InvalidateCachedDisplay();
     m_presenter.SetDisplayTexture(m_vram_texture.get(), GSVector4i(scaled_vram_offset_x, scaled_vram_offset_y,
                                                                    scaled_vram_offset_x + scaled_display_width,
                                                                    scaled_vram_offset_y + scaled_display_height));
@@ -4078,6 +5091,14 @@ void GPU_HW::UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd)
   }
   else
   {
+    // Skip the extract, internal post-processing, chroma smoothing and downsampling if the frame is unchanged.
+    GPUTexture* const postfx_output = (m_internal_postfx && m_internal_postfx->IsActive()) ?
+                                        m_internal_postfx->GetTextureUnusedAtEndOfChain() :
+                                        nullptr;
+    if (UseCachedDisplay(cmd, postfx_output))
+      return;
+
+    InvalidateCachedDisplay();
     if (!g_gpu_device->ResizeTexture(&m_vram_extract_texture, scaled_display_width, scaled_display_height,
                                      GPUTexture::Type::RenderTarget, GPUTextureFormat::RGBA8, GPUTexture::Flags::None))
       [[unlikely]]
@@ -4155,11 +5176,11 @@ void GPU_HW::UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd)
                                         scaled_display_width, scaled_display_height, scaled_display_width,
                                         scaled_display_height))
     {
-      GPUTexture* const postfx_output = m_internal_postfx->GetOutputTexture();
-      m_internal_postfx->Apply(
-        m_vram_extract_texture.get(), depth_source ? m_vram_extract_depth_texture.get() : nullptr,
-        m_internal_postfx->GetOutputTexture(), GSVector4i(0, 0, scaled_display_width, scaled_display_height),
-        m_presenter.GetVideoSize().x, m_presenter.GetVideoSize().y, cmd->display_vram_width, cmd->display_vram_height);
+      GPUTexture* const postfx_output = m_internal_postfx->GetTextureUnusedAtEndOfChain();
+      m_internal_postfx->Apply(m_vram_extract_texture.get(), depth_source ? m_vram_extract_depth_texture.get() : nullptr,
+                               postfx_output, GSVector4i(0, 0, scaled_display_width, scaled_display_height),
+                               m_presenter.GetVideoSize().x, m_presenter.GetVideoSize().y, cmd->display_vram_width,
+                               cmd->display_vram_height);
       m_presenter.SetDisplayTexture(postfx_output, postfx_output->GetRect());
     }
 
@@ -4185,7 +5206,122 @@ void GPU_HW::UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd)
   }
 
   if (drew_anything)
+  {
+    if (!interlaced && m_presenter.HasDisplayTexture())
+    {
+      SetCachedDisplay(cmd, (m_internal_postfx && m_internal_postfx->IsActive()) ?
+                              m_internal_postfx->GetTextureUnusedAtEndOfChain() :
+                              nullptr);
+    }
+
     RestoreDeviceContext();
+  }
+}
+
+GSVector4i GPU_HW::GetDisplayVRAMRect(const GPUBackendUpdateDisplayCommand* cmd)
+{
+  // 24-bit reads start from X and cover 1.5 halfwords per pixel, so this is conservative.
+  const s32 left = std::min<s32>(cmd->X, cmd->display_vram_left);
+  const s32 right = std::max<s32>(cmd->X, cmd->display_vram_left) +
+                    static_cast<s32>(cmd->display_vram_width) * (cmd->display_24bit ? 2 : 1);
+  const s32 top = cmd->display_vram_top;
+  const s32 bottom = top + cmd->display_vram_height;
+  return GSVector4i(left, top, right, bottom);
+}
+
+bool GPU_HW::UseCachedDisplay(const GPUBackendUpdateDisplayCommand* cmd, GPUTexture* postfx_output)
+{
+  if (!m_cached_display.texture || cmd->interlaced_display_enabled || m_cached_display.x != cmd->X ||
+      m_cached_display.display_24bit != cmd->display_24bit || m_cached_display.postfx_output != postfx_output ||
+      !m_cached_display.vram_rect.eq(GSVector4i(cmd->display_vram_left, cmd->display_vram_top,
+                                                cmd->display_vram_width, cmd->display_vram_height)) ||
+      m_display_dirty_rect.rintersects(GetDisplayVRAMRect(cmd)))
+  {
+    return false;
+  }
+
+  GL_INS("Display area unchanged, reusing last frame");
+  m_presenter.SetDisplayTexture(m_cached_display.texture, m_cached_display.texture_rect);
+  return true;
+}
+
+void GPU_HW::SetCachedDisplay(const GPUBackendUpdateDisplayCommand* cmd, GPUTexture* postfx_output)
+{
+  // Areas which wrap around VRAM are not worth tracking.
+  const GSVector4i vram_rect = GetDisplayVRAMRect(cmd);
+  if (!VRAM_SIZE_RECT.rcontains(vram_rect))
+  {
+    InvalidateCachedDisplay();
+    return;
+  }
+
+  m_cached_display.vram_rect =
+    GSVector4i(cmd->display_vram_left, cmd->display_vram_top, cmd->display_vram_width, cmd->display_vram_height);
+  m_cached_display.texture_rect = m_presenter.GetDisplayTextureRect();
+  m_cached_display.texture = m_presenter.GetDisplayTexture();
+  m_cached_display.postfx_output = postfx_output;
+  m_cached_display.x = cmd->X;
+  m_cached_display.display_24bit = cmd->display_24bit;
+  m_display_dirty_rect = INVALID_RECT;
+}
+
+void GPU_HW::InvalidateCachedDisplay()
+{
+  m_cached_display.texture = nullptr;
+}
+
+void GPU_HW::SetRenderSkip(bool enabled)
+{
+  // The texture cache tracks draws on the GPU, so it can't be bypassed.
+  if (m_render_skip == enabled || (enabled && m_use_texture_cache))
+    return;
+
+  if (enabled)
+  {
+    GL_SCOPE("Begin render skip");
+
+    // The software renderer needs an up-to-date copy of VRAM and the CLUT.
+    if (!m_draw_with_software_renderer)
+    {
+      DownloadVRAMFromGPU(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+
+      if (m_draw_mode.mode_reg.texture_mode <= GPUTextureMode::Palette8Bit)
+      {
+        GPU_SW_Rasterizer::UpdateCLUT(m_draw_mode.palette_reg,
+                                      m_draw_mode.mode_reg.texture_mode == GPUTextureMode::Palette8Bit);
+      }
+    }
+    else
+    {
+      FlushRender();
+    }
+
+    m_render_skip_dirty_rect = INVALID_RECT;
+  }
+  else
+  {
+    GL_SCOPE_FMT("End render skip, uploading {}", m_render_skip_dirty_rect);
+
+    // Anything drawn while skipping is at native resolution, until the game draws it again.
+    const GSVector4i rect = m_render_skip_dirty_rect.rintersect(VRAM_SIZE_RECT);
+    if (!rect.rempty())
+    {
+      UpdateVRAMOnGPU(rect.left, rect.top, rect.width(), rect.height(), &g_vram[rect.top * VRAM_WIDTH + rect.left],
+                      VRAM_WIDTH * sizeof(u16), false, false, rect);
+      AddWrittenRectangle(rect);
+    }
+
+    m_render_skip_dirty_rect = INVALID_RECT;
+    InvalidateSpeculativeReadback();
+    InvalidateCachedDisplay();
+  }
+
+  m_render_skip = enabled;
+}
+
+void GPU_HW::AddRenderSkipDirtyRectangle(const GSVector4i rect)
+{
+  m_render_skip_dirty_rect = m_render_skip_dirty_rect.runion(rect);
 }
 
 void GPU_HW::UpdateDownsamplingLevels()
@@ -4224,6 +5360,7 @@ void GPU_HW::DownsampleFramebuffer()
   GPUTexture* source = m_presenter.GetDisplayTexture();
   const GSVector4i& source_rect = m_presenter.GetDisplayTextureRect();
 
+  const GPUDevice::TimingScope timing_scope("Downsample");
   if (m_downsample_mode == GPUDownsampleMode::Adaptive)
     DownsampleFramebufferAdaptive(source, source_rect);
   else
@@ -4271,7 +5408,13 @@ void GPU_HW::DownsampleFramebufferAdaptive(GPUTexture* source, const GSVector4i&
   SmoothingUBOData uniforms;
 
   // create mip chain
-  for (u32 level = 1; level < m_downsample_scale_or_levels; level++)
+  const bool created_with_compute = CreateAdaptiveDownsampleMipChainCompute(level_texture.get(), width, height);
+
+  // If the compute path failed partway, it restored the device context, which unbound the level texture.
+  if (!created_with_compute)
+    g_gpu_device->SetTextureSampler(0, level_texture.get(), m_downsample_lod_sampler.get());
+
+  for (u32 level = 1; level < m_downsample_scale_or_levels && !created_with_compute; level++)
   {
     GL_SCOPE_FMT("Create miplevel {}", level);
 
@@ -4348,6 +5491,74 @@ void GPU_HW::DownsampleFramebufferAdaptive(GPUTexture* source, const GSVector4i&
   m_presenter.SetDisplayTexture(m_downsample_texture.get(), GSVector4i(0, 0, width, height));
 }
 
+bool GPU_HW::CreateAdaptiveDownsampleMipChainCompute(GPUTexture* level_texture, u32 width, u32 height)
+{
+  static constexpr u32 GROUP_SIZE = 8;
+
+  struct MipUBOData
+  {
+    u32 dst_size0[2];
+    u32 dst_size1[2];
+    s32 src_level;
+  };
+
+  // The smallest level must still exist, the images can't be zero-sized.
+  const u32 last_level = m_downsample_scale_or_levels - 1;
+  if (!m_downsample_mip_compute_pipelines[0] || last_level == 0 || (width >> last_level) == 0 ||
+      (height >> last_level) == 0)
+  {
+    return false;
+  }
+
+  GL_SCOPE_FMT("CreateAdaptiveDownsampleMipChainCompute({}x{}, {} levels)", width, height, last_level);
+
+  GPUTexture* last_image = nullptr;
+  GPUDevice::AutoRecycleTexture images[2];
+  for (u32 level = 1; level <= last_level; level += 2)
+  {
+    const bool two_levels = (level < last_level);
+    const u32 num_images = two_levels ? 2 : 1;
+    for (u32 i = 0; i < num_images; i++)
+    {
+      images[i] = g_gpu_device->FetchAutoRecycleTexture(width >> (level + i), height >> (level + i), 1, 1, 1,
+                                                        GPUTexture::Type::RenderTarget, VRAM_RT_FORMAT,
+                                                        GPUTexture::Flags::AllowBindAsImage);
+      if (!images[i])
+      {
+        // Levels that already exist are overwritten by the fragment path.
+        ERROR_LOG("Failed to create {}x{} image for compute downsampling", width >> (level + i), height >> (level + i));
+        RestoreDeviceContext();
+        return false;
+      }
+    }
+
+    const MipUBOData uniforms = {.dst_size0 = {width >> level, height >> level},
+                                 .dst_size1 = {width >> (level + 1), height >> (level + 1)},
+                                 .src_level = static_cast<s32>(level - 1)};
+    const auto [groups_x, groups_y, groups_z] =
+      GPUDevice::GetDispatchCount(uniforms.dst_size0[0], uniforms.dst_size0[1], 1, GROUP_SIZE, GROUP_SIZE, 1);
+
+    GPUTexture* const rts[2] = {images[0].get(), images[1].get()};
+    g_gpu_device->SetRenderTargets(rts, num_images, nullptr, GPUPipeline::BindRenderTargetsAsImages);
+    g_gpu_device->SetPipeline(m_downsample_mip_compute_pipelines[BoolToUInt8(two_levels)].get());
+    g_gpu_device->UploadUniformBuffer(&uniforms, sizeof(uniforms));
+    g_gpu_device->Dispatch(groups_x * GROUP_SIZE, groups_y * GROUP_SIZE, groups_z, GROUP_SIZE, GROUP_SIZE, 1);
+
+    for (u32 i = 0; i < num_images; i++)
+    {
+      g_gpu_device->CopyTextureRegion(level_texture, 0, 0, 0, level + i, images[i].get(), 0, 0, 0, 0,
+                                      images[i]->GetWidth(), images[i]->GetHeight());
+    }
+
+    last_image = images[num_images - 1].get();
+  }
+
+  // The blur pass reads the smallest level from the downsample texture.
+  g_gpu_device->CopyTextureRegion(m_downsample_texture.get(), 0, 0, 0, 0, last_image, 0, 0, 0, 0,
+                                  last_image->GetWidth(), last_image->GetHeight());
+  return true;
+}
+
 void GPU_HW::DownsampleFramebufferBoxFilter(GPUTexture* source, const GSVector4i& source_rect)
 {
   GL_SCOPE_FMT("DownsampleFramebufferBoxFilter({})", source_rect);
@@ -4400,6 +5611,8 @@ void GPU_HW::UpdatePostProcessingSettings(bool force_reload)
 {
   static constexpr const char* section = PostProcessing::Config::INTERNAL_CHAIN_SECTION;
 
+  InvalidateCachedDisplay();
+
   auto lock = Core::GetSettingsLock();
   const SettingsInterface& si = *Core::GetSettingsInterface();
 
@@ -11,9 +11,15 @@
 #include "common/dimensional_array.h"
 #include "common/gsvector.h"
 
+#include <array>
+#include <bitset>
 #include <limits>
+#include <mutex>
+#include <string>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace PostProcessing {
 class Chain;
@@ -97,6 +103,9 @@ public:
   void DoMemoryState(StateWrapper& sw, System::MemorySaveState& mss) override;
 
   void UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd) override;
+  void SetRenderSkip(bool enabled) override;
+
+  void OnGameSerialChanged() override;
 
 private:
   enum : u32
@@ -105,8 +114,27 @@ private:
     MAX_VERTICES_FOR_RECTANGLE = 6 * (((MAX_PRIMITIVE_WIDTH + (TEXTURE_PAGE_WIDTH - 1)) / TEXTURE_PAGE_WIDTH) + 1u) *
                                  (((MAX_PRIMITIVE_HEIGHT + (TEXTURE_PAGE_HEIGHT - 1)) / TEXTURE_PAGE_HEIGHT) + 1u),
     NUM_TEXTURE_MODES = static_cast<u32>(BatchTextureMode::MaxCount),
+    NUM_BATCH_PIPELINES = 2 * 5 * 5 * NUM_TEXTURE_MODES * 2 * 2 * 2,
     INVALID_DRAW_MODE_BITS = 0xFFFFFFFFu,
+
+    VRAM_DIRTY_TILE_SHIFT = 6,
+    VRAM_DIRTY_TILE_SIZE = 1u << VRAM_DIRTY_TILE_SHIFT,
+    VRAM_DIRTY_TILES_X = VRAM_WIDTH / VRAM_DIRTY_TILE_SIZE,
+    VRAM_DIRTY_TILES_Y = VRAM_HEIGHT / VRAM_DIRTY_TILE_SIZE,
+
+    DEPTH_CULL_TILE_SHIFT = 4,
+    DEPTH_CULL_TILE_SIZE = 1u << DEPTH_CULL_TILE_SHIFT,
+    DEPTH_CULL_TILES_X = VRAM_WIDTH / DEPTH_CULL_TILE_SIZE,
+    DEPTH_CULL_TILES_Y = VRAM_HEIGHT / DEPTH_CULL_TILE_SIZE,
   };
+
+  /// One bit per 64x64 tile, a row per element.
+  using VRAMDirtyTileMask = std::array<u16, VRAM_DIRTY_TILES_Y>;
+  static_assert(VRAM_DIRTY_TILES_X <= 16);
+
+  /// Upper bound of the depth buffer contents within each 16x16 tile, in native resolution.
+  using DepthCullTileArray = std::array<float, DEPTH_CULL_TILES_X * DEPTH_CULL_TILES_Y>;
+
   enum : u8
   {
     TEXPAGE_DIRTY_DRAWN_RECT = (1 << 0),
@@ -131,6 +159,8 @@ private:
 
     void Set(float x_, float y_, float z_, float w_, u32 color_, u32 texpage_, u16 packed_texcoord, u32 uv_limits_);
     void Set(float x_, float y_, float z_, float w_, u32 color_, u32 texpage_, u16 u_, u16 v_, u32 uv_limits_);
+    void Set(const GSVector4 xyzw, const GSVector4i attributes); // color, texpage, u | (v << 16), uv_limits
+    static GSVector4i PackAttributes(u32 color, u32 texpage, u32 u, u32 v, u32 uv_limits);
     static u32 PackUVLimits(u32 min_u, u32 max_u, u32 min_v, u32 max_v);
     void SetUVLimits(u32 min_u, u32 max_u, u32 min_v, u32 max_v);
   };
@@ -162,6 +192,19 @@ private:
     float u_resolution_scale_minus_one;
   };
 
+  /// Batch which has been ended by a state change, but whose draw hasn't been submitted yet.
+  struct DeferredDraw
+  {
+    BatchConfig batch;
+    u16 base_index;
+    u16 num_indices;
+    bool ubo_dirty;
+    BatchUBOData ubo_data;
+  };
+
+  /// Upper bound for batches kept in a single mapping of the vertex/index buffers.
+  static constexpr u32 MAX_DEFERRED_DRAWS = 256;
+
   struct RendererStats
   {
     u32 num_batches;
@@ -178,13 +221,43 @@ private:
 
   bool CompileCommonShaders(Error* error);
   bool CompilePipelines(Error* error);
+  static std::span<const GPUPipeline::VertexAttribute> GetBatchVertexAttributes(bool textured, bool uv_limits);
+  bool IsBatchPipelineNeeded(u32 key) const;
+  template<typename GenerateSource>
+  std::unique_ptr<GPUShader> CreateBatchShader(GPUShaderStage stage, GPUShaderLanguage language, u64 memo_key,
+                                               const GenerateSource& generate_source, Error* error);
+  GPUShader* GetBatchVertexShader(u8 textured, u8 palette, u8 sprite, Error* error);
+  GPUShader* GetBatchFragmentShader(u8 depth_test, u8 render_mode, u8 transparency_mode, u8 texture_mode, u8 check_mask,
+                                    u8 dithering, u8 interlacing, Error* error);
+  /// Arguments to GetBatchVertexShader() and GetBatchFragmentShader() for a batch pipeline.
+  struct BatchPipelineShaders
+  {
+    std::array<u8, 3> vs;
+    std::array<u8, 7> fs;
+  };
+
+  BatchPipelineShaders GetBatchPipelineShaders(u32 key) const;
+  bool CompileBatchPipeline(u32 key, Error* error);
+  void CompileBatchPipelineOnDemand(u32 key);
+  void UpdateUnrecordedBatchPipelines();
+  void DestroyBatchShaders();
   bool CompileResolutionDependentPipelines(Error* error);
   bool CompileDownsamplePipelines(Error* error);
 
+  std::unique_ptr<GPUPipeline>& GetBatchPipeline(u32 key);
+  static u32 GetBatchPipelineKey(u8 depth_test, u8 transparency_mode, u8 render_mode, u8 texture_mode, u8 dithering,
+                                 u8 interlacing, u8 check_mask);
+  std::string GetPipelineUsageListPath() const;
+  void ReloadPipelineUsageList();
+  void SavePipelineUsageList();
+  void LoadShaderGenMemo();
+  void SaveShaderGenMemo();
+
   void PrintSettingsToLog();
   void CheckSettings();
 
   void UpdateVRAMReadTexture(bool drawn, bool written);
+  void UpdateVRAMReadTextureRegion(const GSVector4i rect);
   void UpdateDepthBufferFromMaskBit();
   void CopyAndClearDepthBuffer(bool only_drawing_area);
   void ClearDepthBuffer(bool only_drawing_area);
@@ -195,6 +268,12 @@ private:
   void UnmapGPUBuffer(u32 used_vertices, u32 used_indices);
   void DrawBatchVertices(BatchRenderMode render_mode, u32 num_indices, u32 base_index, u32 base_vertex,
                          const GPUTextureCache::Source* texture);
+  void DrawBatch(u32 num_indices, u32 base_index, u32 base_vertex, const GPUTextureCache::Source* texture);
+
+  /// Ends the current batch without unmapping the vertex/index buffers, if possible.
+  void DeferRender();
+  void SubmitDeferredDraws(u32 base_index, u32 base_vertex);
+  void DiscardDeferredDraws();
 
   u32 CalculateResolutionScale() const;
   GPUDownsampleMode GetDownsampleMode(u32 resolution_scale) const;
@@ -205,11 +284,19 @@ private:
   void SetFullVRAMDirtyRectangle();
   void ClearVRAMDirtyRectangle();
 
+  static void AddDirtyTiles(VRAMDirtyTileMask& mask, const GSVector4i rect);
+
   void AddWrittenRectangle(const GSVector4i rect);
   void AddDrawnRectangle(const GSVector4i rect);
   void AddUnclampedDrawnRectangle(const GSVector4i rect);
   void SetTexPageChangedOnOverlap(const GSVector4i update_rect);
 
+  void ResetDepthCullTiles();
+  void InvalidateDepthCullTiles(const GSVector4i rect);
+  bool IsPolygonDepthCulled(const BatchVertex* vertices, u32 num_vertices, const GSVector4i rect) const;
+  void UpdateDepthCullTiles(const BatchVertex& v0, const BatchVertex& v1, const BatchVertex& v2,
+                            const GSVector4i clamped_rect);
+
   void CheckForTexPageOverlap(const GPUBackendDrawCommand* cmd, GSVector4i uv_rect);
   bool ShouldCheckForTexPageOverlap() const;
 
@@ -234,7 +321,34 @@ private:
   /// Returns true if the draw is going to use shader blending/framebuffer fetch.
   bool NeedsShaderBlending(GPUTransparencyMode transparency, BatchTextureMode texture, bool check_mask) const;
 
+  /// Returns true if memory states should keep a 1x copy of VRAM on the CPU instead of a full-resolution texture.
+  bool UseNativeResolutionMemoryStates() const;
+
   void DownloadVRAMFromGPU(u32 x, u32 y, u32 width, u32 height);
+  static GSVector4i GetVRAMReadbackRect(u32 x, u32 y, u32 width, u32 height);
+  void EncodeVRAMForReadback(const GSVector4i copy_rect);
+
+  /// Speculative readbacks: areas which were read in the last two frames are downloaded ahead of time, and the
+  /// result is used if nothing has touched the area since.
+  bool ReadSpeculativeVRAM(const GSVector4i copy_rect);
+  void QueueSpeculativeReadback();
+  void InvalidateSpeculativeReadback();
+
+  /// Unchanged frames: the displayed texture is reused if nothing has been drawn or written to its VRAM area since.
+  bool UseCachedDisplay(const GPUBackendUpdateDisplayCommand* cmd, GPUTexture* postfx_output);
+  void SetCachedDisplay(const GPUBackendUpdateDisplayCommand* cmd, GPUTexture* postfx_output);
+  void InvalidateCachedDisplay();
+
+  /// Render skip: frames which won't be presented are only drawn into our copy of VRAM with the software renderer,
+  /// and the touched area is uploaded to the GPU once rendering resumes.
+  void AddRenderSkipDirtyRectangle(const GSVector4i rect);
+  static void DrawLineWithSoftwareRenderer(const GPUBackendDrawLineCommand* cmd);
+  static void DrawPreciseLineWithSoftwareRenderer(const GPUBackendDrawPreciseLineCommand* cmd);
+  static void DrawSpriteWithSoftwareRenderer(const GPUBackendDrawRectangleCommand* cmd);
+  static void DrawPolygonWithSoftwareRenderer(const GPUBackendDrawPolygonCommand* cmd);
+  static void DrawPrecisePolygonWithSoftwareRenderer(const GPUBackendDrawPrecisePolygonCommand* cmd);
+
+  static GSVector4i GetDisplayVRAMRect(const GPUBackendUpdateDisplayCommand* cmd);
   void UpdateVRAMOnGPU(u32 x, u32 y, u32 width, u32 height, const void* data, u32 data_pitch, bool set_mask,
                        bool check_mask, const GSVector4i bounds);
   bool BlitVRAMReplacementTexture(GPUTexture* tex, u32 dst_x, u32 dst_y, u32 width, u32 height);
@@ -264,6 +378,7 @@ private:
 
   void DownsampleFramebuffer();
   void DownsampleFramebufferAdaptive(GPUTexture* source, const GSVector4i& source_rect);
+  bool CreateAdaptiveDownsampleMipChainCompute(GPUTexture* level_texture, u32 width, u32 height);
   void DownsampleFramebufferBoxFilter(GPUTexture* source, const GSVector4i& source_rect);
 
   void LoadInternalPostProcessing();
@@ -274,6 +389,7 @@ private:
   std::unique_ptr<GPUTexture> m_vram_read_texture;
   std::unique_ptr<GPUTexture> m_vram_readback_texture;
   std::unique_ptr<GPUDownloadTexture> m_vram_readback_download_texture;
+  std::unique_ptr<GPUDownloadTexture> m_vram_speculative_download_texture;
 
   std::unique_ptr<GPUTextureBuffer> m_vram_upload_buffer;
   std::unique_ptr<GPUTexture> m_vram_write_texture;
@@ -286,6 +402,7 @@ private:
   u16 m_batch_index_count = 0;
   u16 m_batch_vertex_space = 0;
   u16 m_batch_index_space = 0;
+  u16 m_batch_deferred_index_count = 0;
   s32 m_current_depth = 0;
   float m_last_depth_z = 1.0f;
 
@@ -315,6 +432,11 @@ private:
 
   bool m_use_texture_cache : 1 = false;
   bool m_texture_dumping : 1 = false;
+  bool m_defer_batches : 1 = false;
+  bool m_speculative_readbacks : 1 = false;
+  bool m_precompile_used_pipelines : 1 = false;
+  bool m_pipeline_usage_dirty : 1 = false;
+  bool m_depth_culling : 1 = false;
 
   u8 m_texpage_dirty = 0;
 
@@ -325,6 +447,7 @@ private:
 
   // Changed state
   alignas(VECTOR_ALIGNMENT) BatchUBOData m_batch_ubo_data = {};
+  std::vector<DeferredDraw> m_deferred_draws;
 
   // Texture cache state
   GPUTextureCache::SourceKey m_texture_cache_key = {};
@@ -332,8 +455,37 @@ private:
   // Bounding box of VRAM area that the GPU has drawn into.
   GSVector4i m_vram_dirty_draw_rect = INVALID_RECT;
   GSVector4i m_vram_dirty_write_rect = INVALID_RECT; // TODO: Don't use in TC mode, should be kept at zero.
+
+  // Tiles within the bounding boxes that actually need copying to the read texture.
+  VRAMDirtyTileMask m_vram_dirty_draw_tiles = {};
+  VRAMDirtyTileMask m_vram_dirty_write_tiles = {};
+
+  // Coarse depth used to skip polygons that are hidden behind earlier opaque geometry.
+  DepthCullTileArray m_depth_cull_tiles = {};
   GSVector4i m_current_uv_rect = INVALID_RECT;
   GSVector4i m_current_draw_rect = INVALID_RECT;
+
+  // Speculative readback state.
+  GSVector4i m_speculative_readback_rect = INVALID_RECT;
+  GSVector4i m_speculative_readback_stale_rect = INVALID_RECT;
+  GSVector4i m_frame_readback_rect = INVALID_RECT;
+  GSVector4i m_last_frame_readback_rect = INVALID_RECT;
+
+  // Area of VRAM which has been modified while rendering was skipped.
+  GSVector4i m_render_skip_dirty_rect = INVALID_RECT;
+
+  // Cached display state, the last extracted frame is presented again while its area is untouched.
+  struct CachedDisplay
+  {
+    GSVector4i vram_rect;
+    GSVector4i texture_rect;
+    GPUTexture* texture;
+    GPUTexture* postfx_output;
+    u16 x;
+    bool display_24bit;
+  };
+  CachedDisplay m_cached_display = {};
+  GSVector4i m_display_dirty_rect = INVALID_RECT;
   alignas(8) s32 m_current_texture_page_offset[2] = {};
 
   union
@@ -372,6 +524,7 @@ private:
 
   std::unique_ptr<GPUTexture> m_downsample_texture;
   std::unique_ptr<GPUPipeline> m_downsample_pass_pipeline;
+  std::array<std::unique_ptr<GPUPipeline>, 2> m_downsample_mip_compute_pipelines; // [two_levels]
   std::unique_ptr<GPUPipeline> m_downsample_blur_pipeline;
   std::unique_ptr<GPUPipeline> m_downsample_composite_pipeline;
   std::unique_ptr<GPUSampler> m_downsample_lod_sampler;
@@ -381,6 +534,45 @@ private:
   // [depth_test][transparency_mode][render_mode][texture_mode][dithering][interlacing][check_mask]
   DimensionalArray<std::unique_ptr<GPUPipeline>, 2, 2, 2, NUM_TEXTURE_MODES, 5, 5, 2> m_batch_pipelines{};
 
+  // Derived state needed to compile batch shaders/pipelines outside of CompilePipelines().
+  struct BatchShaderConfig
+  {
+    bool upscaled;
+    bool msaa;
+    bool per_sample_shading;
+    bool force_round_texcoords;
+    bool modulation_crop;
+    bool true_color;
+    bool scaled_dithering;
+    bool scaled_interlacing;
+    bool disable_color_perspective;
+    bool needs_page_texture;
+    bool force_progressive_scan;
+    bool needs_rov_depth;
+    bool needs_real_depth_buffer;
+    bool needs_feedback_loop;
+    GPUTextureFormat depth_buffer_format;
+  } m_batch_shader_config = {};
+
+  // [textured][palette][sprite]
+  DimensionalArray<std::unique_ptr<GPUShader>, 2, 3, 2> m_batch_vertex_shaders{};
+
+  // [depth_test][render_mode][transparency_mode][texture_mode][check_mask][dithering][interlacing]
+  DimensionalArray<std::unique_ptr<GPUShader>, 2, 2, 2, NUM_TEXTURE_MODES, 5, 5, 2> m_batch_fragment_shaders{};
+
+  // Batch pipelines drawn with by the current game, indexed by GetBatchPipelineKey().
+  std::bitset<NUM_BATCH_PIPELINES> m_used_batch_pipelines;
+
+  // Compiled batch pipelines not in the usage list yet, kept out of m_batch_pipelines until first drawn with.
+  std::vector<std::unique_ptr<GPUPipeline>> m_unrecorded_batch_pipelines;
+  std::string m_pipeline_usage_list_path;
+
+  // Cache keys of the batch shaders generated for each permutation, so they can be created without generating them.
+  std::unordered_map<u64, GPUShaderCache::CacheIndexKey> m_shadergen_memo;
+  std::string m_shadergen_memo_path;
+  std::mutex m_shadergen_memo_mutex;
+  bool m_shadergen_memo_dirty = false;
+
   // common shaders
   std::unique_ptr<GPUShader> m_fullscreen_quad_vertex_shader;
   std::unique_ptr<GPUShader> m_screen_quad_vertex_shader;
@@ -2276,6 +2276,80 @@ std::string GPU_HW_ShaderGen::GenerateAdaptiveDownsampleMipFragmentShader() cons
   return std::move(ss).str();
 }
 
+std::string GPU_HW_ShaderGen::GenerateAdaptiveDownsampleMipComputeShader(bool two_levels) const
+{
+  static constexpr u32 GROUP_SIZE = 8;
+
+  std::stringstream ss;
+  WriteHeader(ss);
+  DefineMacro(ss, "TWO_LEVELS", two_levels);
+  DeclareUniformBuffer(ss, {"uint2 u_dst_size0", "uint2 u_dst_size1", "int u_src_level"}, false);
+  DeclareTexture(ss, "samp0", 0, false);
+  DeclareImage(ss, "dst_level0", 0, false, false, false, false);
+  if (two_levels)
+  {
+    DeclareImage(ss, "dst_level1", 1, false, false, false, false);
+    ss << (m_glsl ? "shared" : "groupshared") << " float4 s_level0[" << (GROUP_SIZE * GROUP_SIZE) << "];\n";
+  }
+
+  ss << "CONSTANT uint GROUP_SIZE = " << GROUP_SIZE << "u;\n";
+  ss << R"(
+// Same reduction as the fragment shader, but on exact texels rather than through the sampler.
+float4 ReduceQuad(float4 c00, float4 c01, float4 c10, float4 c11, bool first_level)
+{
+  float3 cavg = (c00.rgb + c01.rgb + c10.rgb + c11.rgb) * 0.25;
+  float variance =
+    1.0 - log2(1000.0 * (dot(c00.rgb - cavg.rgb, c00.rgb - cavg.rgb) + dot(c01.rgb - cavg, c01.rgb - cavg) +
+                         dot(c10.rgb - cavg.rgb, c10.rgb - cavg.rgb) + dot(c11.rgb - cavg, c11.rgb - cavg)) +
+               1.0);
+  float aavg = (c00.a + c01.a + c10.a + c11.a) * 0.25;
+  return float4(cavg, variance * (first_level ? 1.0 : aavg));
+}
+
+)";
+
+  DeclareComputeEntryPoint(ss, GROUP_SIZE, GROUP_SIZE);
+  ss << R"(
+{
+  // Threads outside the level can't return early, they still have to reach the barrier.
+  uint2 coords = c_global_id.xy;
+  float4 result = float4(0.0, 0.0, 0.0, 0.0);
+  if (coords.x < u_dst_size0.x && coords.y < u_dst_size0.y)
+  {
+    int2 src_coords = int2(coords * 2u);
+    float4 c00 = LOAD_TEXTURE(samp0, src_coords, u_src_level);
+    float4 c01 = LOAD_TEXTURE(samp0, src_coords + int2(0, 1), u_src_level);
+    float4 c10 = LOAD_TEXTURE(samp0, src_coords + int2(1, 0), u_src_level);
+    float4 c11 = LOAD_TEXTURE(samp0, src_coords + int2(1, 1), u_src_level);
+    result = ReduceQuad(c00, c01, c10, c11, (u_src_level == 0));
+    STORE_IMAGE(dst_level0, coords, result);
+  }
+
+#if TWO_LEVELS
+  // Second level comes from the first level's results in shared memory, avoiding a round trip through VRAM.
+  s_level0[c_local_id.y * GROUP_SIZE + c_local_id.x] = result;
+  GROUP_MEMORY_BARRIER();
+
+  if (c_local_id.x < (GROUP_SIZE / 2u) && c_local_id.y < (GROUP_SIZE / 2u))
+  {
+    uint2 dst_coords = c_group_id.xy * (GROUP_SIZE / 2u) + c_local_id.xy;
+    if (dst_coords.x < u_dst_size1.x && dst_coords.y < u_dst_size1.y)
+    {
+      uint base = (c_local_id.y * 2u) * GROUP_SIZE + (c_local_id.x * 2u);
+      float4 c00 = s_level0[base];
+      float4 c01 = s_level0[base + GROUP_SIZE];
+      float4 c10 = s_level0[base + 1u];
+      float4 c11 = s_level0[base + GROUP_SIZE + 1u];
+      STORE_IMAGE(dst_level1, dst_coords, ReduceQuad(c00, c01, c10, c11, false));
+    }
+  }
+#endif
+}
+)";
+
+  return std::move(ss).str();
+}
+
 std::string GPU_HW_ShaderGen::GenerateAdaptiveDownsampleBlurFragmentShader() const
 {
   std::stringstream ss;
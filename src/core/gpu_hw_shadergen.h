@@ -43,6 +43,7 @@ public:
 
   std::string GenerateAdaptiveDownsampleVertexShader() const;
   std::string GenerateAdaptiveDownsampleMipFragmentShader() const;
+  std::string GenerateAdaptiveDownsampleMipComputeShader(bool two_levels) const;
   std::string GenerateAdaptiveDownsampleBlurFragmentShader() const;
   std::string GenerateAdaptiveDownsampleCompositeFragmentShader() const;
   std::string GenerateBoxSampleDownsampleFragmentShader(u32 factor) const;
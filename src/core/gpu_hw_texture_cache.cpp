@@ -11,6 +11,7 @@
 #include "gpu_thread.h"
 #include "host.h"
 #include "imgui_overlays.h"
+#include "performance_counters.h"
 #include "settings.h"
 #include "system.h"
 
@@ -19,10 +20,12 @@
 #include "util/state_wrapper.h"
 
 #include "common/error.h"
+#include "common/fast_hash.h"
 #include "common/file_system.h"
 #include "common/gsvector_formatter.h"
 #include "common/heterogeneous_containers.h"
 #include "common/log.h"
+#include "common/memory_accounting.h"
 #include "common/path.h"
 #include "common/string_util.h"
 #include "common/timer.h"
@@ -30,16 +33,11 @@
 #include "IconsEmoji.h"
 #include "IconsFontAwesome.h"
 
-#ifndef XXH_STATIC_LINKING_ONLY
-#define XXH_STATIC_LINKING_ONLY
-#endif
-#include "xxhash.h"
-#ifdef CPU_ARCH_SSE
-#include "xxh_x86dispatch.h"
-#endif
-
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <deque>
+#include <mutex>
 #include <numeric>
 #include <unordered_set>
 
@@ -55,14 +53,26 @@ static constexpr u32 NUM_PAGE_DRAW_RECTS = 4;
 static constexpr const GSVector4i& INVALID_RECT = GPU_HW::INVALID_RECT;
 static constexpr const GPUTextureFormat REPLACEMENT_TEXTURE_FORMAT = GPUTextureFormat::RGBA8;
 static constexpr const char LOCAL_CONFIG_FILENAME[] = "config.yaml";
+static constexpr const char REPLACEMENT_PACK_FILENAME[] = "replacements.pack";
+
+/// Maximum number of async tasks that will be decoding replacement images at once.
+static constexpr u32 MAX_ASYNC_REPLACEMENT_LOADERS = 2;
+
+/// Dumps which are still being encoded before new ones are dropped, bounds the memory held by queued images.
+static constexpr u32 MAX_PENDING_DUMPS = 32;
 
 static constexpr u32 STATE_PALETTE_RECORD_SIZE =
   sizeof(GSVector4i) + sizeof(SourceKey) + sizeof(PaletteRecordFlags) + sizeof(HashType) + sizeof(u16) * MAX_CLUT_SIZE;
 
+namespace {
+struct GPUReplacementImage;
+}
+
 // Has to be public because it's referenced in Source.
 struct HashCacheEntry
 {
   std::unique_ptr<GPUTexture> texture;
+  GPUReplacementImage* direct_replacement; // sampled instead of texture if set, owned by the replacement cache
   u32 ref_count;
   u32 last_used_frame;
   TList<Source> sources;
@@ -138,6 +148,7 @@ struct TextureReplacementSubImage
 {
   GSVector4i dst_rect;
   GSVector4i src_rect;
+  GPUReplacementImage* image;
   GPUTexture* texture;
   float scale_x;
   float scale_y;
@@ -247,7 +258,88 @@ struct DumpedTextureKeyHash
 
 using HashCache = std::unordered_map<HashCacheKey, HashCacheEntry, HashCacheKeyHash>;
 using ReplacementImageCache = UnorderedStringMap<TextureReplacementImage>;
-using GPUReplacementImageCache = UnorderedStringMap<std::pair<std::unique_ptr<GPUTexture>, u32>>;
+
+namespace {
+struct GPUReplacementImage
+{
+  std::unique_ptr<GPUTexture> texture;
+  const std::string* path; // key in the cache map, node addresses are stable
+  u32 num_hash_cache_refs;  // not in the LRU list while referenced, can't be evicted
+  TListNode<GPUReplacementImage> lru_ref;
+};
+} // namespace
+
+using GPUReplacementImageCache = UnorderedStringMap<GPUReplacementImage>;
+
+/// Value is true if the image was requested by a lookup, i.e. sources need to be invalidated once it arrives.
+using PendingReplacementImageMap = UnorderedStringMap<bool>;
+
+namespace {
+
+/// Replacement images stored in a single file, so the directory doesn't need to be enumerated, and each image
+/// doesn't need to be opened. The file is mapped, and consists of a header, entries sorted by name, the names, then
+/// the image files themselves. Created by scripts/pack_texture_replacements.py.
+class TextureReplacementPack
+{
+public:
+  static std::shared_ptr<const TextureReplacementPack> Open(std::string path, Error* error);
+
+  ALWAYS_INLINE const std::string& GetPath() const { return m_path; }
+  ALWAYS_INLINE u32 GetEntryCount() const { return m_num_entries; }
+
+  /// Path used to refer to the entry in the replacement maps, the pack path followed by the name.
+  std::string GetEntryPath(u32 index) const;
+
+  /// Looks up an entry by its name relative to the replacement directory, using '/' as the separator.
+  std::optional<u32> FindEntry(std::string_view name) const;
+
+  /// Looks up an entry by a path returned from GetEntryPath().
+  std::optional<std::span<const u8>> FindEntryData(std::string_view path) const;
+
+private:
+  static constexpr u32 MAGIC = 0x50527344; // DsRP
+  static constexpr u32 VERSION = 1;
+
+  struct Header
+  {
+    u32 magic;
+    u32 version;
+    u32 num_entries;
+    u32 names_size;
+  };
+
+  struct Entry
+  {
+    u64 data_offset;
+    u64 data_size;
+    u32 name_offset;
+    u32 name_length;
+  };
+  static_assert(sizeof(Entry) == 24);
+
+  std::string_view GetEntryName(u32 index) const;
+
+  FileSystem::MappedFile m_file;
+  std::string m_path;
+  const Entry* m_entries = nullptr;
+  const char* m_names = nullptr;
+  u32 m_num_entries = 0;
+};
+
+struct AsyncReplacementLoad
+{
+  std::string path;
+  std::shared_ptr<const TextureReplacementPack> pack; // kept alive until the load is done
+  bool prefetch;
+};
+
+struct AsyncReplacementResult
+{
+  std::string path;
+  std::optional<TextureReplacementImage> image;
+  bool skipped; // prefetch memory budget exceeded, can still be loaded on demand
+};
+} // namespace
 
 using VRAMReplacementMap = std::unordered_map<VRAMReplacementName, std::string, VRAMReplacementNameHash>;
 using TextureReplacementMap =
@@ -281,7 +373,10 @@ static void InvalidatePageSources(u32 pn, const GSVector4i rc, bool remove_from_
 static void InvalidateSources();
 static void DestroySource(Source* src, bool remove_from_hash_cache = false);
 
+static void InvalidateAllRowHashes();
+static HashType GetRowHash(u32 segment, u32 y);
 static HashType HashPage(u8 page, GPUTextureMode mode);
+static HashType HashPageForReplacements(u8 page, GPUTextureMode mode);
 static HashType HashPalette(GPUTexturePaletteReg palette, GPUTextureMode mode);
 static HashType HashPartialPalette(const u16* palette, u32 min, u32 max);
 static HashType HashPartialPalette(GPUTexturePaletteReg palette, GPUTextureMode mode, u32 min, u32 max);
@@ -313,6 +408,8 @@ static void DecodeTexture(u8 page, GPUTexturePaletteReg palette, GPUTextureMode
 
 static std::optional<TextureReplacementType> GetTextureReplacementTypeFromFileTitle(const std::string_view file_title);
 static bool HasValidReplacementExtension(const std::string_view path);
+static bool LoadTextureReplacementImage(TextureReplacementImage* image, const std::string& path,
+                                        const TextureReplacementPack* pack, Error* error);
 
 static bool EnsureGameDirectoryExists();
 static std::string GetTextureReplacementDirectory();
@@ -320,6 +417,8 @@ static std::string GetTextureDumpDirectory();
 
 static VRAMReplacementName GetVRAMWriteHash(u32 width, u32 height, const void* pixels);
 static std::string GetVRAMWriteDumpPath(const VRAMReplacementName& name);
+static bool ShouldDumpVRAMWrite(u32 width, u32 height);
+static void DumpVRAMWrite(const VRAMReplacementName& name, u32 width, u32 height, const void* pixels);
 
 static bool IsMatchingReplacementPalette(HashType full_palette_hash, GPUTextureMode mode, GPUTexturePaletteReg palette,
                                          const TextureReplacementName& name);
@@ -331,14 +430,25 @@ static void LoadTextureReplacementAliases(const ryml::ConstNodeRef& root, bool l
                                           bool load_texture_replacement_aliases);
 
 static const TextureReplacementImage* GetTextureReplacementImage(const std::string& path);
-static GPUTexture* GetTextureReplacementGPUImage(const std::string& path);
+static GPUReplacementImage* GetTextureReplacementGPUImage(const std::string& path);
 static void CompactTextureReplacementGPUImages();
+static void UpdateMemoryAccounting();
+static void RemoveTextureReplacementGPUImage(GPUReplacementImage* image);
+static void AddTextureReplacementGPUImageRef(GPUReplacementImage* image);
+static void ReleaseTextureReplacementGPUImageRef(GPUReplacementImage* image);
 static void PreloadReplacementTextures();
+static void PrefetchReplacementTextures();
+static void QueueAsyncReplacementImageLoad(const std::string& path, bool prefetch);
+static void AsyncReplacementImageLoaderTask(bool dxt_supported, bool bptc_supported, size_t prefetch_budget);
+static void ProcessAsyncReplacementImages();
+static void CancelAsyncReplacementImageLoads();
 static void PurgeUnreferencedTexturesFromCache();
 
 static void DumpTexture(TextureReplacementType type, u32 offset_x, u32 offset_y, u32 src_width, u32 src_height,
                         GPUTextureMode mode, HashType src_hash, HashType pal_hash, u32 pal_min, u32 pal_max,
                         const u16* palette, const GSVector4i rect, PaletteRecordFlags flags);
+static bool TryReserveDumpSlot();
+static void ReleaseDumpSlot();
 
 static bool HasVRAMWriteTextureReplacements();
 static void GetVRAMWriteTextureReplacements(std::vector<TextureReplacementSubImage>& replacements,
@@ -552,6 +662,7 @@ struct GPUTextureCacheState
   std::unique_ptr<GPUPipeline> replacement_draw_pipeline;                 // copies alpha as-is
   std::unique_ptr<GPUPipeline> replacement_semitransparent_draw_pipeline; // inverts alpha (i.e. semitransparent)
 
+  std::shared_ptr<const TextureReplacementPack> replacement_pack;
   VRAMReplacementMap vram_replacements;
 
   // TODO: Combine these into one map?
@@ -560,14 +671,32 @@ struct GPUTextureCacheState
 
   // TODO: Check the size, purge some when it gets too large.
   ReplacementImageCache replacement_image_cache;
+  size_t replacement_image_cache_memory_usage = 0;
   GPUReplacementImageCache gpu_replacement_image_cache;
+  TList<GPUReplacementImage> gpu_replacement_image_lru = {}; // head is most recently used
   size_t gpu_replacement_image_cache_vram_usage = 0;
-  std::vector<std::pair<GPUReplacementImageCache::iterator, s32>> gpu_replacement_image_cache_purge_list;
+  ReplacementCacheCounters replacement_cache_counters = {};
+
+  /// Images queued for or being decoded on a worker thread. GPU thread only.
+  PendingReplacementImageMap pending_replacement_images;
+
+  /// State shared with async loader tasks, protected by async_replacement_mutex.
+  std::mutex async_replacement_mutex;
+  std::deque<AsyncReplacementLoad> async_replacement_queue;
+  std::vector<AsyncReplacementResult> async_replacement_results;
+  size_t async_prefetch_memory_usage = 0;
+  u32 async_replacement_generation = 0;
+  u32 async_replacement_loaders = 0;
 
   std::unordered_set<VRAMReplacementName, VRAMReplacementNameHash> dumped_vram_writes;
   std::unordered_set<DumpedTextureKey, DumpedTextureKeyHash> dumped_textures;
+  std::atomic_uint32_t pending_dumps{0};
 
   ALIGN_TO_CACHE_LINE std::array<PageEntry, NUM_VRAM_PAGES> pages = {};
+
+  /// Hashes of each page-width segment of each VRAM row, so pages only need the modified rows rehashed.
+  std::array<u16, VRAM_HEIGHT> valid_row_hashes = {}; // bit per page column
+  std::array<HashType, VRAM_HEIGHT * VRAM_PAGES_WIDE> row_hashes;
 };
 } // namespace
 
@@ -600,6 +729,9 @@ bool GPUTextureCache::Initialize(GPU_HW* backend, Error* error)
 {
   s_state.hw_backend = backend;
 
+  // VRAM could have changed while we weren't active.
+  InvalidateAllRowHashes();
+
   SetHashCacheTextureFormat();
 
   // note: safe because the CPU thread is waiting for the GPU thread to finish initializing
@@ -705,6 +837,8 @@ bool GPUTextureCache::DoState(StateWrapper& sw, bool skip)
   {
     if (!skip)
       Invalidate();
+    else
+      InvalidateAllRowHashes();
 
     u32 num_vram_writes = 0;
     sw.Do(&num_vram_writes);
@@ -823,25 +957,26 @@ void GPUTextureCache::Shutdown()
   ClearHashCache();
   DestroyPipelines();
   s_state.replacement_texture_render_target.reset();
-  s_state.gpu_replacement_image_cache_purge_list = {};
   s_state.hash_cache_purge_list = {};
   s_state.temp_vram_write_list = {};
   s_state.track_vram_writes = false;
   s_state.hw_backend = nullptr;
 
-  for (auto it = s_state.gpu_replacement_image_cache.begin(); it != s_state.gpu_replacement_image_cache.end();)
-  {
-    g_gpu_device->RecycleTexture(std::move(it->second.first));
-    it = s_state.gpu_replacement_image_cache.erase(it);
-  }
-  s_state.gpu_replacement_image_cache_vram_usage = 0;
+  while (s_state.gpu_replacement_image_lru.tail)
+    RemoveTextureReplacementGPUImage(s_state.gpu_replacement_image_lru.tail->ref);
+  DebugAssert(s_state.gpu_replacement_image_cache.empty() && s_state.gpu_replacement_image_cache_vram_usage == 0);
+  s_state.replacement_cache_counters = {};
 
+  CancelAsyncReplacementImageLoads();
+  s_state.replacement_pack.reset();
   s_state.replacement_image_cache.clear();
+  s_state.replacement_image_cache_memory_usage = 0;
   s_state.vram_replacements.clear();
   s_state.vram_write_texture_replacements.clear();
   s_state.texture_page_texture_replacements.clear();
   s_state.dumped_textures.clear();
   s_state.dumped_vram_writes.clear();
+  UpdateMemoryAccounting();
 }
 
 void GPUTextureCache::SetHashCacheTextureFormat()
@@ -929,6 +1064,8 @@ void GPUTextureCache::DestroyPipelines()
 
 void GPUTextureCache::AddDrawnRectangle(const GSVector4i rect, const GSVector4i clip_rect)
 {
+  InvalidateRowHashes(rect);
+
   // TODO: This might be a bit slow...
   LoopRectPages(rect, [&rect, &clip_rect](u32 pn) {
     PageEntry& page = s_state.pages[pn];
@@ -1058,6 +1195,8 @@ void GPUTextureCache::WriteVRAM(u32 x, u32 y, u32 width, u32 height, const void*
 
 void GPUTextureCache::AddWrittenRectangle(const GSVector4i rect, bool update_vram_writes, bool remove_from_hash_cache)
 {
+  InvalidateRowHashes(rect);
+
   LoopRectPages(rect, [&rect, &update_vram_writes, &remove_from_hash_cache](u32 pn) {
     PageEntry& page = s_state.pages[pn];
     InvalidatePageSources(pn, rect, remove_from_hash_cache);
@@ -1596,6 +1735,7 @@ void GPUTextureCache::Invalidate()
   DebugAssert(!s_state.last_vram_write);
 #endif
 
+  InvalidateAllRowHashes();
   ClearHashCache();
 }
 
@@ -1703,7 +1843,7 @@ GPUTextureCache::Source* GPUTextureCache::CreateSource(SourceKey key)
   Source* src = new Source();
   src->key = key;
   src->num_page_refs = 0;
-  src->texture = hcentry->texture.get();
+  src->texture = hcentry->direct_replacement ? hcentry->direct_replacement->texture.get() : hcentry->texture.get();
   src->from_hash_cache = hcentry;
   ListAppend(&hcentry->sources, src, &src->hash_cache_ref);
   src->texture_hash = tex_hash;
@@ -2175,10 +2315,77 @@ void GPUTextureCache::DumpTextureFromPage(const Source* src)
               tex_hash, pal_hash, pal_min, pal_max, pal_ptr, dump_rect, src->palette_record_flags);
 }
 
+void GPUTextureCache::InvalidateRowHashes(const GSVector4i rect)
+{
+  const GSVector4i clamped_rect = rect.rintersect(GSVector4i::cxpr(0, 0, VRAM_WIDTH, VRAM_HEIGHT));
+  if (clamped_rect.rempty())
+    return;
+
+  const u32 first_segment = static_cast<u32>(clamped_rect.left) / VRAM_PAGE_WIDTH;
+  const u32 last_segment = static_cast<u32>(clamped_rect.right - 1) / VRAM_PAGE_WIDTH;
+  const u16 mask = static_cast<u16>(((1u << (last_segment + 1)) - 1u) & ~((1u << first_segment) - 1u));
+  for (s32 y = clamped_rect.top; y < clamped_rect.bottom; y++)
+    s_state.valid_row_hashes[y] &= ~mask;
+}
+
+void GPUTextureCache::InvalidateAllRowHashes()
+{
+  s_state.valid_row_hashes.fill(0);
+}
+
+ALWAYS_INLINE_RELEASE GPUTextureCache::HashType GPUTextureCache::GetRowHash(u32 segment, u32 y)
+{
+  const u16* row_ptr = &g_vram[y * VRAM_WIDTH + segment * VRAM_PAGE_WIDTH];
+  const u16 bit = static_cast<u16>(1u << segment);
+  HashType& hash = s_state.row_hashes[y * VRAM_PAGES_WIDE + segment];
+  if (s_state.valid_row_hashes[y] & bit)
+    return hash;
+
+  hash = FastHash::Hash64(row_ptr, VRAM_PAGE_WIDTH * sizeof(u16));
+
+  // Drawn areas can change without us being told (readbacks, software rendering), so never trust them.
+  const PageEntry& page = s_state.pages[VRAMPageIndex(segment, y / VRAM_PAGE_HEIGHT)];
+  if (page.num_draw_rects == 0 || static_cast<s32>(y) < page.total_draw_rect.top ||
+      static_cast<s32>(y) >= page.total_draw_rect.bottom)
+  {
+    s_state.valid_row_hashes[y] |= bit;
+  }
+
+  return hash;
+}
+
 GPUTextureCache::HashType GPUTextureCache::HashPage(u8 page, GPUTextureMode mode)
 {
-  XXH3_state_t state;
-  XXH3_64bits_reset(&state);
+  static_assert(VRAM_PAGES_WIDE <= 16, "Row hash valid mask fits in 16 bits");
+
+  // Combine the hashes of each row segment the page covers. Same memory as HashPageForReplacements(), i.e. wider
+  // pages run into the start of the next row instead of wrapping.
+  DebugAssert(mode <= GPUTextureMode::Direct16Bit);
+  const u32 segments_per_row = 1u << static_cast<u32>(mode);
+  const u32 start_segment = VRAMPageStartX(page) / VRAM_PAGE_WIDTH;
+  const u32 start_y = VRAMPageStartY(page);
+
+  std::array<HashType, VRAM_PAGE_HEIGHT * 4> hashes;
+  HashType* hashes_ptr = hashes.data();
+  for (u32 y = start_y; y < (start_y + VRAM_PAGE_HEIGHT); y++)
+  {
+    for (u32 i = 0; i < segments_per_row; i++)
+    {
+      const u32 segment = start_segment + i;
+      const u32 row = y + (segment / VRAM_PAGES_WIDE);
+      *(hashes_ptr++) = (row < VRAM_HEIGHT) ?
+                          GetRowHash(segment % VRAM_PAGES_WIDE, row) :
+                          FastHash::Hash64(&g_vram[y * VRAM_WIDTH + segment * VRAM_PAGE_WIDTH],
+                                      VRAM_PAGE_WIDTH * sizeof(u16));
+    }
+  }
+
+  return FastHash::Hash64(hashes.data(), sizeof(HashType) * static_cast<size_t>(hashes_ptr - hashes.data()));
+}
+
+GPUTextureCache::HashType GPUTextureCache::HashPageForReplacements(u8 page, GPUTextureMode mode)
+{
+  FastHash::Hasher64 hasher;
 
   // Pages aren't contiguous in memory :(
   const u16* page_ptr = VRAMPagePointer(page);
@@ -2189,7 +2396,7 @@ GPUTextureCache::HashType GPUTextureCache::HashPage(u8 page, GPUTextureMode mode
     {
       for (u32 y = 0; y < VRAM_PAGE_HEIGHT; y++)
       {
-        XXH3_64bits_update(&state, page_ptr, VRAM_PAGE_WIDTH * sizeof(u16));
+        hasher.Update(page_ptr, VRAM_PAGE_WIDTH * sizeof(u16));
         page_ptr += VRAM_WIDTH;
       }
     }
@@ -2199,7 +2406,7 @@ GPUTextureCache::HashType GPUTextureCache::HashPage(u8 page, GPUTextureMode mode
     {
       for (u32 y = 0; y < VRAM_PAGE_HEIGHT; y++)
       {
-        XXH3_64bits_update(&state, page_ptr, VRAM_PAGE_WIDTH * 2 * sizeof(u16));
+        hasher.Update(page_ptr, VRAM_PAGE_WIDTH * 2 * sizeof(u16));
         page_ptr += VRAM_WIDTH;
       }
     }
@@ -2209,7 +2416,7 @@ GPUTextureCache::HashType GPUTextureCache::HashPage(u8 page, GPUTextureMode mode
     {
       for (u32 y = 0; y < VRAM_PAGE_HEIGHT; y++)
       {
-        XXH3_64bits_update(&state, page_ptr, VRAM_PAGE_WIDTH * 4 * sizeof(u16));
+        hasher.Update(page_ptr, VRAM_PAGE_WIDTH * 4 * sizeof(u16));
         page_ptr += VRAM_WIDTH;
       }
     }
@@ -2218,7 +2425,7 @@ GPUTextureCache::HashType GPUTextureCache::HashPage(u8 page, GPUTextureMode mode
       DefaultCaseIsUnreachable()
   }
 
-  return XXH3_64bits_digest(&state);
+  return hasher.Final();
 }
 
 GPUTextureCache::HashType GPUTextureCache::HashPalette(GPUTexturePaletteReg palette, GPUTextureMode mode)
@@ -2229,16 +2436,16 @@ GPUTextureCache::HashType GPUTextureCache::HashPalette(GPUTexturePaletteReg pale
   switch (mode)
   {
     case GPUTextureMode::Palette4Bit:
-      return XXH3_64bits(base, sizeof(u16) * 16);
+      return FastHash::Hash64(base, sizeof(u16) * 16);
 
     case GPUTextureMode::Palette8Bit:
     {
       // If the palette wraps around, chances are we aren't using those indices.
       // Games that do this: Metal Gear Solid.
       if ((x_base + 256) > VRAM_WIDTH) [[unlikely]]
-        return XXH3_64bits(base, sizeof(u16) * (VRAM_WIDTH - x_base));
+        return FastHash::Hash64(base, sizeof(u16) * (VRAM_WIDTH - x_base));
       else
-        return XXH3_64bits(base, sizeof(u16) * 256);
+        return FastHash::Hash64(base, sizeof(u16) * 256);
     }
 
       DefaultCaseIsUnreachable()
@@ -2255,24 +2462,23 @@ GPUTextureCache::HashType GPUTextureCache::HashPartialPalette(GPUTexturePaletteR
 GPUTextureCache::HashType GPUTextureCache::HashPartialPalette(const u16* palette, u32 min, u32 max)
 {
   const u32 size = max - min + 1;
-  return XXH3_64bits(palette, sizeof(u16) * size);
+  return FastHash::Hash64(palette, sizeof(u16) * size);
 }
 
 GPUTextureCache::HashType GPUTextureCache::HashRect(const GSVector4i rc)
 {
-  XXH3_state_t state;
-  XXH3_64bits_reset(&state);
+  FastHash::Hasher64 hasher;
 
   const u32 width = rc.width();
   const u32 height = rc.height();
   const u16* ptr = &g_vram[rc.top * VRAM_WIDTH + rc.left];
   for (u32 y = 0; y < height; y++)
   {
-    XXH3_64bits_update(&state, ptr, width * sizeof(u16));
+    hasher.Update(ptr, width * sizeof(u16));
     ptr += VRAM_WIDTH;
   }
 
-  return XXH3_64bits_digest(&state);
+  return hasher.Final();
 }
 
 void GPUTextureCache::InitializeVRAMWritePaletteRecord(VRAMWrite::PaletteRecord* record, SourceKey source_key,
@@ -2288,7 +2494,7 @@ void GPUTextureCache::InitializeVRAMWritePaletteRecord(VRAMWrite::PaletteRecord*
     {
       // Always has 16 colours.
       std::memcpy(record->palette, VRAMPalettePointer(source_key.palette), 16 * sizeof(u16));
-      record->palette_hash = XXH3_64bits(record->palette, 16 * sizeof(u16));
+      record->palette_hash = FastHash::Hash64(record->palette, 16 * sizeof(u16));
     }
     break;
 
@@ -2300,13 +2506,13 @@ void GPUTextureCache::InitializeVRAMWritePaletteRecord(VRAMWrite::PaletteRecord*
       {
         std::memcpy(record->palette, VRAMPalettePointer(source_key.palette), pal_width * sizeof(u16));
         std::memset(&record->palette[pal_width], 0, sizeof(record->palette) - (pal_width * sizeof(u16)));
-        record->palette_hash = XXH3_64bits(record->palette, pal_width * sizeof(u16));
+        record->palette_hash = FastHash::Hash64(record->palette, pal_width * sizeof(u16));
       }
       else
       {
         // Whole thing, 2ez.
         std::memcpy(record->palette, VRAMPalettePointer(source_key.palette), 256 * sizeof(u16));
-        record->palette_hash = XXH3_64bits(record->palette, 256 * sizeof(u16));
+        record->palette_hash = FastHash::Hash64(record->palette, 256 * sizeof(u16));
       }
     }
     break;
@@ -2342,6 +2548,7 @@ GPUTextureCache::HashCacheEntry* GPUTextureCache::LookupHashCache(SourceKey key,
   GL_INS_FMT("TC: Hash cache miss {:X} {:X}", hkey.texture_hash, hkey.palette_hash);
 
   HashCacheEntry entry;
+  entry.direct_replacement = nullptr;
   entry.ref_count = 0;
   entry.last_used_frame = 0;
   entry.sources = {};
@@ -2352,8 +2559,12 @@ GPUTextureCache::HashCacheEntry* GPUTextureCache::LookupHashCache(SourceKey key,
 
   DecodeTexture(key.page, key.palette, key.mode, entry.texture.get());
 
+  // Replacements are named by the hash of the whole page, not the incremental hash.
   if (g_gpu_settings.texture_replacements.enable_texture_replacements)
-    ApplyTextureReplacements(key, tex_hash, pal_hash, &entry);
+  {
+    ApplyTextureReplacements(key, HasTexturePageTextureReplacements() ? HashPageForReplacements(key.page, key.mode) : 0,
+                             pal_hash, &entry);
+  }
 
   s_state.hash_cache_memory_usage += entry.texture->GetVRAMUsage();
 
@@ -2376,6 +2587,9 @@ void GPUTextureCache::RemoveFromHashCache(HashCache::iterator it)
   DebugAssert(s_state.hash_cache_memory_usage >= vram_usage);
   s_state.hash_cache_memory_usage -= vram_usage;
 
+  if (it->second.direct_replacement)
+    ReleaseTextureReplacementGPUImageRef(it->second.direct_replacement);
+
   g_gpu_device->RecycleTexture(std::move(it->second.texture));
   s_state.hash_cache.erase(it);
 }
@@ -2388,6 +2602,8 @@ void GPUTextureCache::ClearHashCache()
 
 void GPUTextureCache::Compact()
 {
+  ProcessAsyncReplacementImages();
+
   // Number of frames before unused hash cache entries are evicted.
   static constexpr u32 MAX_HASH_CACHE_AGE = 600;
 
@@ -2451,6 +2667,14 @@ void GPUTextureCache::Compact()
   }
 
   CompactTextureReplacementGPUImages();
+  UpdateMemoryAccounting();
+}
+
+void GPUTextureCache::UpdateMemoryAccounting()
+{
+  MemoryAccounting::Set(MemoryAccounting::Category::TextureCache, 0, s_state.hash_cache_memory_usage);
+  MemoryAccounting::Set(MemoryAccounting::Category::TextureReplacements, s_state.replacement_image_cache_memory_usage,
+                        s_state.gpu_replacement_image_cache_vram_usage);
 }
 
 size_t GPUTextureCache::HashCacheKeyHash::operator()(const HashCacheKey& k) const
@@ -2766,15 +2990,23 @@ void GPUTextureCache::GameSerialChanged()
   ReloadTextureReplacements(false, false);
 }
 
-GPUTexture* GPUTextureCache::GetVRAMReplacement(u32 width, u32 height, const void* pixels)
+GPUTexture* GPUTextureCache::ProcessVRAMWrite(u32 width, u32 height, const void* pixels)
 {
-  const VRAMReplacementName hash = GetVRAMWriteHash(width, height, pixels);
+  // Most games upload far more than they'd ever have replaced, so don't hash anything if nothing would use it.
+  const bool dump = ShouldDumpVRAMWrite(width, height);
+  if (!dump && s_state.vram_replacements.empty())
+    return nullptr;
+
+  const VRAMReplacementName name = GetVRAMWriteHash(width, height, pixels);
+  if (dump)
+    DumpVRAMWrite(name, width, height, pixels);
 
-  const auto it = s_state.vram_replacements.find(hash);
+  const auto it = s_state.vram_replacements.find(name);
   if (it == s_state.vram_replacements.end())
     return nullptr;
 
-  return GetTextureReplacementGPUImage(it->second);
+  GPUReplacementImage* const image = GetTextureReplacementGPUImage(it->second);
+  return image ? image->texture.get() : nullptr;
 }
 
 bool GPUTextureCache::ShouldDumpVRAMWrite(u32 width, u32 height)
@@ -2784,47 +3016,81 @@ bool GPUTextureCache::ShouldDumpVRAMWrite(u32 width, u32 height)
           height >= s_state.config.vram_write_dump_height_threshold);
 }
 
-void GPUTextureCache::DumpVRAMWrite(u32 width, u32 height, const void* pixels)
+void GPUTextureCache::DumpVRAMWrite(const VRAMReplacementName& name, u32 width, u32 height, const void* pixels)
 {
-  const VRAMReplacementName name = GetVRAMWriteHash(width, height, pixels);
   if (s_state.dumped_vram_writes.find(name) != s_state.dumped_vram_writes.end())
   {
     DEV_COLOR_LOG(Green, "Not dumping {}", name.ToString());
     return;
   }
 
-  s_state.dumped_vram_writes.insert(name);
+  std::string path = GetVRAMWriteDumpPath(name);
+  if (path.empty())
+    return;
 
-  const std::string path = GetVRAMWriteDumpPath(name);
-  if (path.empty() || FileSystem::FileExists(path.c_str()))
+  // leave it out of the dumped set when the queue is full, so the next identical write gets another chance
+  if (!TryReserveDumpSlot())
     return;
 
-  Image image(width, height, ImageFormat::RGBA8);
+  s_state.dumped_vram_writes.insert(name);
 
+  // only the copy happens here, conversion and encoding are done on a worker thread
   const u16* src_pixels = reinterpret_cast<const u16*>(pixels);
+  std::vector<u16> raw_pixels(src_pixels, src_pixels + (width * height));
+  const bool force_alpha_channel = s_state.config.dump_vram_write_force_alpha_channel;
 
-  for (u32 y = 0; y < height; y++)
-  {
-    u8* row_ptr = image.GetRowPixels(y);
-    for (u32 x = 0; x < width; x++)
+  Host::QueueAsyncTask([path = std::move(path), raw_pixels = std::move(raw_pixels), width, height,
+                        force_alpha_channel]() {
+    if (!FileSystem::FileExists(path.c_str()))
     {
-      const u32 pixel32 = VRAMRGBA5551ToRGBA8888(*(src_pixels++));
-      std::memcpy(row_ptr, &pixel32, sizeof(pixel32));
-      row_ptr += sizeof(pixel32);
-    }
-  }
+      Image image(width, height, ImageFormat::RGBA8);
+      const u16* src_ptr = raw_pixels.data();
+      for (u32 y = 0; y < height; y++)
+      {
+        u8* row_ptr = image.GetRowPixels(y);
+        for (u32 x = 0; x < width; x++)
+        {
+          const u32 pixel32 = VRAMRGBA5551ToRGBA8888(*(src_ptr++));
+          std::memcpy(row_ptr, &pixel32, sizeof(pixel32));
+          row_ptr += sizeof(pixel32);
+        }
+      }
 
-  if (s_state.config.dump_vram_write_force_alpha_channel)
-    image.SetAllPixelsOpaque();
+      if (force_alpha_channel)
+        image.SetAllPixelsOpaque();
 
-  INFO_LOG("Dumping {}x{} VRAM write to '{}'", width, height, Path::GetFileName(path));
+      INFO_LOG("Dumping {}x{} VRAM write to '{}'", width, height, Path::GetFileName(path));
 
-  Error error;
-  if (!image.SaveToFile(path.c_str(), Image::DEFAULT_SAVE_QUALITY, &error)) [[unlikely]]
+      Error error;
+      if (!image.SaveToFile(path.c_str(), Image::DEFAULT_SAVE_QUALITY, &error)) [[unlikely]]
+      {
+        ERROR_LOG("Failed to dump {}x{} VRAM write to '{}': {}", width, height, Path::GetFileName(path),
+                  error.GetDescription());
+      }
+    }
+
+    ReleaseDumpSlot();
+  });
+}
+
+bool GPUTextureCache::TryReserveDumpSlot()
+{
+  u32 pending = s_state.pending_dumps.load(std::memory_order_relaxed);
+  do
   {
-    ERROR_LOG("Failed to dump {}x{} VRAM write to '{}': {}", width, height, Path::GetFileName(path),
-              error.GetDescription());
-  }
+    if (pending >= MAX_PENDING_DUMPS)
+    {
+      DEV_LOG("Dropping dump, {} are still being written", pending);
+      return false;
+    }
+  } while (!s_state.pending_dumps.compare_exchange_weak(pending, pending + 1, std::memory_order_relaxed));
+
+  return true;
+}
+
+void GPUTextureCache::ReleaseDumpSlot()
+{
+  s_state.pending_dumps.fetch_sub(1, std::memory_order_relaxed);
 }
 
 void GPUTextureCache::DumpTexture(TextureReplacementType type, u32 offset_x, u32 offset_y, u32 src_width,
@@ -2871,14 +3137,15 @@ void GPUTextureCache::DumpTexture(TextureReplacementType type, u32 offset_x, u32
   if (!FileSystem::EnsureDirectoryExists(dump_directory.c_str(), false))
     return;
 
+  if (!TryReserveDumpSlot())
+    return;
+
   s_state.dumped_textures.insert(key);
 
   SmallString filename = name.ToString();
   filename.append(".png");
 
   std::string path = Path::Combine(dump_directory, filename);
-  if (FileSystem::FileExists(path.c_str()))
-    return;
 
   DEV_LOG("Dumping VRAM write {:016X} [{}x{}] at {}", src_hash, width, height, rect);
 
@@ -2887,6 +3154,12 @@ void GPUTextureCache::DumpTexture(TextureReplacementType type, u32 offset_x, u32
                                  image.GetPitch(), width, height, GPUTextureFormat::RGBA8);
 
   Host::QueueAsyncTask([path = std::move(path), image = std::move(image), width, height, semitransparent]() mutable {
+    if (FileSystem::FileExists(path.c_str()))
+    {
+      ReleaseDumpSlot();
+      return;
+    }
+
     // TODO: Vectorize this.
     u32* image_pixels = reinterpret_cast<u32*>(image.GetPixels());
     const u32* image_pixels_end = image_pixels + (width * height);
@@ -2920,6 +3193,8 @@ void GPUTextureCache::DumpTexture(TextureReplacementType type, u32 offset_x, u32
 
     if (!image.SaveToFile(path.c_str()))
       ERROR_LOG("Failed to write texture dump to {}.", Path::GetFileName(path));
+
+    ReleaseDumpSlot();
   });
 }
 
@@ -2980,10 +3255,12 @@ void GPUTextureCache::GetVRAMWriteTextureReplacements(std::vector<TextureReplace
       continue;
     }
 
-    GPUTexture* texture = GetTextureReplacementGPUImage(it->second.second);
-    if (!texture)
+    GPUReplacementImage* const image = GetTextureReplacementGPUImage(it->second.second);
+    if (!image)
       continue;
 
+    GPUTexture* const texture = image->texture.get();
+
     // Especially for C16 textures, the write may span multiple pages. In this case, we need to offset
     // the start of the page into the replacement texture.
     const GSVector2i rect_in_page_space_start = rect_in_page_space.xy();
@@ -3001,7 +3278,7 @@ void GPUTextureCache::GetVRAMWriteTextureReplacements(std::vector<TextureReplace
     const GSVector2 scale = GSVector2(texture->GetSizeVec()) / GSVector2(name.GetSizeVec());
     replacements.push_back(TextureReplacementSubImage{
       clamped_rect_in_page_space, GSVector4i::xyxy(src_offset, src_offset.add32(clamped_rect_in_page_space.rsize())),
-      texture, scale.x, scale.y, name.IsSemitransparent()});
+      image, texture, scale.x, scale.y, name.IsSemitransparent()});
   }
 }
 
@@ -3055,13 +3332,15 @@ void GPUTextureCache::GetTexturePageTextureReplacements(std::vector<TextureRepla
         continue;
     }
 
-    GPUTexture* texture = GetTextureReplacementGPUImage(it->second.second);
-    if (!texture)
+    GPUReplacementImage* const image = GetTextureReplacementGPUImage(it->second.second);
+    if (!image)
       continue;
 
+    GPUTexture* const texture = image->texture.get();
+
     const GSVector2 scale = GSVector2(texture->GetSizeVec()) / GSVector2(name.GetSizeVec());
-    replacements.push_back(TextureReplacementSubImage{rect_in_page_space, GSVector4i::loadh(name.GetSizeVec()), texture,
-                                                      scale.x, scale.y, name.IsSemitransparent()});
+    replacements.push_back(TextureReplacementSubImage{rect_in_page_space, GSVector4i::loadh(name.GetSizeVec()), image,
+                                                      texture, scale.x, scale.y, name.IsSemitransparent()});
   }
 }
 
@@ -3083,7 +3362,7 @@ GPUTextureCache::GetTextureReplacementTypeFromFileTitle(const std::string_view p
 bool GPUTextureCache::HasValidReplacementExtension(const std::string_view path)
 {
   const std::string_view extension = Path::GetExtension(path);
-  for (const char* test_extension : {"png", "jpg", "webp"})
+  for (const char* test_extension : {"png", "jpg", "webp", "dds"})
   {
     if (StringUtil::EqualNoCase(extension, test_extension))
       return true;
@@ -3092,27 +3371,172 @@ bool GPUTextureCache::HasValidReplacementExtension(const std::string_view path)
   return false;
 }
 
+bool GPUTextureCache::LoadTextureReplacementImage(TextureReplacementImage* image, const std::string& path,
+                                                  const TextureReplacementPack* pack, Error* error)
+{
+  if (pack)
+  {
+    if (const std::optional<std::span<const u8>> data = pack->FindEntryData(path))
+      return image->LoadFromBuffer(path, data.value(), error);
+  }
+
+  return image->LoadFromFile(path.c_str(), error);
+}
+
+std::shared_ptr<const GPUTextureCache::TextureReplacementPack> GPUTextureCache::TextureReplacementPack::Open(
+  std::string path, Error* error)
+{
+  std::optional<FileSystem::MappedFile> file = FileSystem::MapBinaryFile(path.c_str(), error);
+  if (!file.has_value())
+    return {};
+
+  Header header;
+  if (file->size() < sizeof(header))
+  {
+    Error::SetStringView(error, "File is too small.");
+    return {};
+  }
+
+  std::memcpy(&header, file->data(), sizeof(header));
+  if (header.magic != MAGIC || header.version != VERSION)
+  {
+    Error::SetStringFmt(error, "Unknown pack format {:08X} version {}.", header.magic, header.version);
+    return {};
+  }
+
+  const size_t entries_offset = sizeof(Header);
+  const size_t names_offset = entries_offset + (static_cast<size_t>(header.num_entries) * sizeof(Entry));
+  if (names_offset > file->size() || header.names_size > (file->size() - names_offset))
+  {
+    Error::SetStringView(error, "Index is truncated.");
+    return {};
+  }
+
+  // check everything up front, so lookups don't need to
+  const Entry* entries = reinterpret_cast<const Entry*>(file->data() + entries_offset);
+  const char* names = reinterpret_cast<const char*>(file->data() + names_offset);
+  std::string_view last_name;
+  for (u32 i = 0; i < header.num_entries; i++)
+  {
+    const Entry& entry = entries[i];
+    if (entry.name_offset > header.names_size || entry.name_length > (header.names_size - entry.name_offset) ||
+        entry.data_offset > file->size() || entry.data_size > (file->size() - entry.data_offset))
+    {
+      Error::SetStringFmt(error, "Entry {} is out of range.", i);
+      return {};
+    }
+
+    const std::string_view name(names + entry.name_offset, entry.name_length);
+    if (i > 0 && name <= last_name)
+    {
+      Error::SetStringFmt(error, "Entry '{}' is not sorted.", name);
+      return {};
+    }
+
+    last_name = name;
+  }
+
+  std::shared_ptr<TextureReplacementPack> pack = std::make_shared<TextureReplacementPack>();
+  pack->m_file = std::move(file.value());
+  pack->m_path = std::move(path);
+  pack->m_entries = reinterpret_cast<const Entry*>(pack->m_file.data() + entries_offset);
+  pack->m_names = reinterpret_cast<const char*>(pack->m_file.data() + names_offset);
+  pack->m_num_entries = header.num_entries;
+  return pack;
+}
+
+std::string_view GPUTextureCache::TextureReplacementPack::GetEntryName(u32 index) const
+{
+  return std::string_view(m_names + m_entries[index].name_offset, m_entries[index].name_length);
+}
+
+std::string GPUTextureCache::TextureReplacementPack::GetEntryPath(u32 index) const
+{
+  const std::string_view name = GetEntryName(index);
+  std::string ret;
+  ret.reserve(m_path.size() + 1 + name.size());
+  ret.append(m_path);
+  ret.push_back('/');
+  ret.append(name);
+  return ret;
+}
+
+std::optional<u32> GPUTextureCache::TextureReplacementPack::FindEntry(std::string_view name) const
+{
+  const Entry* const end = m_entries + m_num_entries;
+  const Entry* const it = std::lower_bound(m_entries, end, name, [this](const Entry& entry, std::string_view value) {
+    return (std::string_view(m_names + entry.name_offset, entry.name_length) < value);
+  });
+  if (it == end || GetEntryName(static_cast<u32>(it - m_entries)) != name)
+    return std::nullopt;
+
+  return static_cast<u32>(it - m_entries);
+}
+
+std::optional<std::span<const u8>> GPUTextureCache::TextureReplacementPack::FindEntryData(std::string_view path) const
+{
+  if (path.size() <= m_path.size() || !path.starts_with(m_path) || path[m_path.size()] != '/')
+    return std::nullopt;
+
+  const std::optional<u32> index = FindEntry(path.substr(m_path.size() + 1));
+  if (!index.has_value())
+    return std::nullopt;
+
+  const Entry& entry = m_entries[index.value()];
+  return m_file.cspan().subspan(static_cast<size_t>(entry.data_offset), static_cast<size_t>(entry.data_size));
+}
+
 void GPUTextureCache::FindTextureReplacements(bool load_vram_write_replacements, bool load_texture_replacements,
                                               bool prefill_dumped_texture_list, bool prefill_dumped_vram_list)
 {
   if (GPUThread::GetGameSerial().empty())
     return;
 
+  const std::string replacement_dir = GetTextureReplacementDirectory();
+  std::string pack_path = Path::Combine(replacement_dir, REPLACEMENT_PACK_FILENAME);
+  std::vector<std::string> paths;
   FileSystem::FindResultsArray files;
-  FileSystem::FindFiles(GetTextureReplacementDirectory().c_str(), "*",
-                        FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_RECURSIVE, &files);
+  if (FileSystem::FileExists(pack_path.c_str()))
+  {
+    // packs replace the loose files entirely, so the directory doesn't have to be enumerated
+    Error error;
+    s_state.replacement_pack = TextureReplacementPack::Open(std::move(pack_path), &error);
+    if (s_state.replacement_pack)
+    {
+      paths.reserve(s_state.replacement_pack->GetEntryCount());
+      for (u32 i = 0; i < s_state.replacement_pack->GetEntryCount(); i++)
+        paths.push_back(s_state.replacement_pack->GetEntryPath(i));
+
+      INFO_LOG("Using {} replacements from '{}'", paths.size(),
+               Path::GetFileName(s_state.replacement_pack->GetPath()));
+    }
+    else
+    {
+      ERROR_LOG("Failed to open replacement pack: {}", error.GetDescription());
+    }
+  }
+  else
+  {
+    FileSystem::FindFiles(replacement_dir.c_str(), "*", FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_RECURSIVE, &files);
+    paths.reserve(files.size());
+    for (FILESYSTEM_FIND_DATA& fd : files)
+    {
+      if (!(fd.Attributes & FILESYSTEM_FILE_ATTRIBUTE_DIRECTORY))
+        paths.push_back(std::move(fd.FileName));
+    }
+  }
 
   const bool add_texture_replacements_to_dumped =
     prefill_dumped_texture_list && !g_gpu_settings.texture_replacements.dump_replaced_textures;
   const bool add_vram_replacements_to_dumped =
     prefill_dumped_vram_list && !g_gpu_settings.texture_replacements.dump_replaced_textures;
 
-  for (FILESYSTEM_FIND_DATA& fd : files)
+  for (std::string& path : paths)
   {
-    if ((fd.Attributes & FILESYSTEM_FILE_ATTRIBUTE_DIRECTORY) || !HasValidReplacementExtension(fd.FileName))
+    if (!HasValidReplacementExtension(path))
       continue;
 
-    const std::string_view file_title = Path::GetFileTitle(fd.FileName);
+    const std::string_view file_title = Path::GetFileTitle(path);
     const std::optional<TextureReplacementType> type = GetTextureReplacementTypeFromFileTitle(file_title);
     if (!type.has_value())
       continue;
@@ -3133,11 +3557,11 @@ void GPUTextureCache::FindTextureReplacements(bool load_vram_write_replacements,
           if (const auto it = s_state.vram_replacements.find(name); it != s_state.vram_replacements.end())
           {
             WARNING_LOG("Duplicate VRAM replacement: '{}' and '{}'", Path::GetFileName(it->second),
-                        Path::GetFileName(fd.FileName));
+                        Path::GetFileName(path));
             continue;
           }
 
-          s_state.vram_replacements.emplace(name, std::move(fd.FileName));
+          s_state.vram_replacements.emplace(name, std::move(path));
         }
       }
       break;
@@ -3169,14 +3593,14 @@ void GPUTextureCache::FindTextureReplacements(bool load_vram_write_replacements,
             if (it->second.first == name) [[unlikely]]
             {
               WARNING_LOG("Duplicate texture replacement: '{}' and '{}'", Path::GetFileName(it->second.second),
-                          Path::GetFileName(fd.FileName));
+                          Path::GetFileName(path));
               duplicate = true;
             }
           }
           if (duplicate) [[unlikely]]
             continue;
 
-          dest_map.emplace(index, std::make_pair(name, std::move(fd.FileName)));
+          dest_map.emplace(index, std::make_pair(name, std::move(path)));
         }
       }
       break;
@@ -3260,8 +3684,19 @@ void GPUTextureCache::LoadTextureReplacementAliases(const ryml::ConstNodeRef& ro
       continue;
 
     const std::string_view replacement_filename = to_stringview(current.val());
-    std::string replacement_path = Path::Combine(source_dir, replacement_filename);
-    if (!FileSystem::FileExists(replacement_path.c_str()))
+    std::string replacement_path;
+    if (s_state.replacement_pack)
+    {
+      if (const std::optional<u32> index = s_state.replacement_pack->FindEntry(replacement_filename))
+        replacement_path = s_state.replacement_pack->GetEntryPath(index.value());
+    }
+    else
+    {
+      replacement_path = Path::Combine(source_dir, replacement_filename);
+      if (!FileSystem::FileExists(replacement_path.c_str()))
+        replacement_path.clear();
+    }
+    if (replacement_path.empty())
     {
       ERROR_LOG("File '{}' for alias '{}' does not exist.", key, replacement_filename);
       continue;
@@ -3344,9 +3779,11 @@ const GPUTextureCache::TextureReplacementImage* GPUTextureCache::GetTextureRepla
   if (it != s_state.replacement_image_cache.end())
     return &it->second;
 
+  PerformanceCounters::AttributeStutter(PerformanceCounters::StutterCause::TextureReplacementLoad);
+
   Image image;
   Error error;
-  if (!image.LoadFromFile(path.c_str(), &error))
+  if (!LoadTextureReplacementImage(&image, path, s_state.replacement_pack.get(), &error))
   {
     ERROR_LOG("Failed to load '{}': {}", Path::GetFileName(path), error.GetDescription());
     return nullptr;
@@ -3354,20 +3791,25 @@ const GPUTextureCache::TextureReplacementImage* GPUTextureCache::GetTextureRepla
 
   VERBOSE_LOG("Loaded '{}': {}x{} {}", Path::GetFileName(path), image.GetWidth(), image.GetHeight(),
               Image::GetFormatName(image.GetFormat()));
+  s_state.replacement_image_cache_memory_usage += image.GetStorageSize();
   it = s_state.replacement_image_cache.emplace(path, std::move(image)).first;
   return &it->second;
 }
 
-GPUTexture* GPUTextureCache::GetTextureReplacementGPUImage(const std::string& path)
+GPUTextureCache::GPUReplacementImage* GPUTextureCache::GetTextureReplacementGPUImage(const std::string& path)
 {
   // Already in cache?
   const auto git = s_state.gpu_replacement_image_cache.find(path);
   if (git != s_state.gpu_replacement_image_cache.end())
   {
-    git->second.second = System::GetFrameNumber();
-    return git->second.first.get();
+    if (git->second.num_hash_cache_refs == 0)
+      ListMoveToFront(&s_state.gpu_replacement_image_lru, &git->second.lru_ref);
+    s_state.replacement_cache_counters.hits++;
+    return &git->second;
   }
 
+  s_state.replacement_cache_counters.misses++;
+
   // Need to upload it.
   Error error;
   std::unique_ptr<GPUTexture> tex;
@@ -3378,11 +3820,18 @@ GPUTexture* GPUTextureCache::GetTextureReplacementGPUImage(const std::string& pa
   {
     tex = g_gpu_device->FetchAndUploadTextureImage(it->second, GPUTexture::Flags::None, &error);
   }
+  else if (g_gpu_settings.texture_replacements.async_load_textures)
+  {
+    // Decode in the background, the original texture gets used until it's ready.
+    QueueAsyncReplacementImageLoad(path, false);
+    return nullptr;
+  }
   else
   {
     // Need to load it.
+    PerformanceCounters::AttributeStutter(PerformanceCounters::StutterCause::TextureReplacementLoad);
     Image cpu_image;
-    if (cpu_image.LoadFromFile(path.c_str(), &error))
+    if (LoadTextureReplacementImage(&cpu_image, path, s_state.replacement_pack.get(), &error))
       tex = g_gpu_device->FetchAndUploadTextureImage(cpu_image, GPUTexture::Flags::None, &error);
   }
 
@@ -3398,8 +3847,36 @@ GPUTexture* GPUTextureCache::GetTextureReplacementGPUImage(const std::string& pa
   VERBOSE_LOG("Uploaded '{}': {}x{} {} {:.2f} KB", Path::GetFileName(path), tex->GetWidth(), tex->GetHeight(),
               GPUTexture::GetFormatName(tex->GetFormat()), static_cast<float>(vram_usage) / 1024.0f);
 
-  return s_state.gpu_replacement_image_cache.emplace(path, std::make_pair(std::move(tex), System::GetFrameNumber()))
-    .first->second.first.get();
+  const auto it2 =
+    s_state.gpu_replacement_image_cache.emplace(path, GPUReplacementImage{std::move(tex), nullptr, 0, {}}).first;
+  GPUReplacementImage& image = it2->second;
+  image.path = &it2->first;
+  ListPrepend(&s_state.gpu_replacement_image_lru, &image, &image.lru_ref);
+  return &image;
+}
+
+void GPUTextureCache::AddTextureReplacementGPUImageRef(GPUReplacementImage* image)
+{
+  if (image->num_hash_cache_refs++ == 0)
+    ListUnlink(image->lru_ref);
+}
+
+void GPUTextureCache::ReleaseTextureReplacementGPUImageRef(GPUReplacementImage* image)
+{
+  DebugAssert(image->num_hash_cache_refs > 0);
+  if (--image->num_hash_cache_refs == 0)
+    ListPrepend(&s_state.gpu_replacement_image_lru, image, &image->lru_ref);
+}
+
+void GPUTextureCache::RemoveTextureReplacementGPUImage(GPUReplacementImage* image)
+{
+  DebugAssert(image->num_hash_cache_refs == 0);
+  ListUnlink(image->lru_ref);
+  s_state.gpu_replacement_image_cache_vram_usage -= image->texture->GetVRAMUsage();
+  g_gpu_device->RecycleTexture(std::move(image->texture));
+
+  // Invalidates image.
+  s_state.gpu_replacement_image_cache.erase(s_state.gpu_replacement_image_cache.find(*image->path));
 }
 
 void GPUTextureCache::CompactTextureReplacementGPUImages()
@@ -3416,32 +3893,14 @@ void GPUTextureCache::CompactTextureReplacementGPUImages()
           s_state.gpu_replacement_image_cache.size(),
           static_cast<float>(s_state.gpu_replacement_image_cache_vram_usage) / 1048576.0f);
 
-  const u32 frame_number = System::GetFrameNumber();
-  s_state.gpu_replacement_image_cache_purge_list.reserve(s_state.gpu_replacement_image_cache.size());
-  for (auto it = s_state.gpu_replacement_image_cache.begin(); it != s_state.gpu_replacement_image_cache.end(); ++it)
-    s_state.gpu_replacement_image_cache_purge_list.emplace_back(it, frame_number - it->second.second);
-
-  // Reverse sort, put the oldest on the end.
-  std::sort(s_state.gpu_replacement_image_cache_purge_list.begin(),
-            s_state.gpu_replacement_image_cache_purge_list.end(),
-            [](const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
-
-  // See first comment above.
+  // See first comment above. The tail of the LRU list is the least recently used texture.
   const size_t target_size = (max_usage < EXTRA_COMPACT_SIZE) ? max_usage : (max_usage - EXTRA_COMPACT_SIZE);
-  while (s_state.gpu_replacement_image_cache_vram_usage > target_size &&
-         !s_state.gpu_replacement_image_cache_purge_list.empty())
+  while (s_state.gpu_replacement_image_cache_vram_usage > target_size && s_state.gpu_replacement_image_lru.tail)
   {
-    GPUReplacementImageCache::iterator iter = s_state.gpu_replacement_image_cache_purge_list.back().first;
-    s_state.gpu_replacement_image_cache_purge_list.pop_back();
-
-    std::unique_ptr<GPUTexture> tex = std::move(iter->second.first);
-    s_state.gpu_replacement_image_cache.erase(iter);
-    s_state.gpu_replacement_image_cache_vram_usage -= tex->GetVRAMUsage();
-    g_gpu_device->RecycleTexture(std::move(tex));
+    RemoveTextureReplacementGPUImage(s_state.gpu_replacement_image_lru.tail->ref);
+    s_state.replacement_cache_counters.evictions++;
   }
 
-  s_state.gpu_replacement_image_cache_purge_list.clear();
-
   DEV_LOG("Finished compacting replacement GPU image cache, count = {}, size = {:.1f} MB",
           s_state.gpu_replacement_image_cache.size(),
           static_cast<float>(s_state.gpu_replacement_image_cache_vram_usage) / 1048576.0f);
@@ -3453,6 +3912,8 @@ void GPUTextureCache::PreloadReplacementTextures()
 
   Timer last_update_time;
   u32 num_textures_loaded = 0;
+  size_t memory_usage = 0;
+  const size_t max_memory_usage = static_cast<size_t>(s_state.config.max_preload_memory_usage_mb) * 1048576;
   const size_t total_textures = s_state.vram_replacements.size() + s_state.vram_write_texture_replacements.size() +
                                 s_state.texture_page_texture_replacements.size();
   std::string image_path = System::GetImageForLoadingScreen(GPUThread::GetGamePath());
@@ -3467,25 +3928,198 @@ void GPUTextureCache::PreloadReplacementTextures()
     last_update_time.Reset();                                                                                          \
   }
 
+#define PRELOAD_IMAGE(path)                                                                                            \
+  if (memory_usage >= max_memory_usage)                                                                                \
+    break;                                                                                                             \
+  UPDATE_PROGRESS();                                                                                                   \
+  if (const TextureReplacementImage* image = GetTextureReplacementImage(path))                                         \
+    memory_usage += image->GetStorageSize();                                                                           \
+  num_textures_loaded++;
+
   for (const auto& it : s_state.vram_replacements)
   {
-    UPDATE_PROGRESS();
-    GetTextureReplacementImage(it.second);
-    num_textures_loaded++;
+    PRELOAD_IMAGE(it.second);
   }
 
 #define PROCESS_MAP(map)                                                                                               \
   for (const auto& it : map)                                                                                           \
   {                                                                                                                    \
-    UPDATE_PROGRESS();                                                                                                 \
-    GetTextureReplacementImage(it.second.second);                                                                      \
-    num_textures_loaded++;                                                                                             \
+    PRELOAD_IMAGE(it.second.second);                                                                                   \
   }
 
   PROCESS_MAP(s_state.vram_write_texture_replacements);
   PROCESS_MAP(s_state.texture_page_texture_replacements);
 #undef PROCESS_MAP
+#undef PRELOAD_IMAGE
 #undef UPDATE_PROGRESS
+
+  if (memory_usage >= max_memory_usage)
+  {
+    WARNING_LOG("Preload memory budget of {} MB exhausted after {} of {} textures, the remainder will load on demand.",
+                s_state.config.max_preload_memory_usage_mb, num_textures_loaded, total_textures);
+  }
+}
+
+void GPUTextureCache::PrefetchReplacementTextures()
+{
+  // VRAM replacements first, they're needed as soon as the game uploads.
+  for (const auto& it : s_state.vram_replacements)
+    QueueAsyncReplacementImageLoad(it.second, true);
+  for (const auto& it : s_state.vram_write_texture_replacements)
+    QueueAsyncReplacementImageLoad(it.second.second, true);
+  for (const auto& it : s_state.texture_page_texture_replacements)
+    QueueAsyncReplacementImageLoad(it.second.second, true);
+
+  DEV_LOG("Prefetching {} replacement textures in the background", s_state.pending_replacement_images.size());
+}
+
+void GPUTextureCache::QueueAsyncReplacementImageLoad(const std::string& path, bool prefetch)
+{
+  const auto [pit, inserted] = s_state.pending_replacement_images.emplace(path, !prefetch);
+  if (!inserted)
+  {
+    // Already in flight, or failed to load. Make sure sources get refreshed when it arrives.
+    pit->second |= !prefetch;
+    return;
+  }
+
+  std::unique_lock lock(s_state.async_replacement_mutex);
+
+  // Lookups jump ahead of anything that is being prefetched.
+  if (prefetch)
+    s_state.async_replacement_queue.push_back(AsyncReplacementLoad{path, s_state.replacement_pack, true});
+  else
+    s_state.async_replacement_queue.push_front(AsyncReplacementLoad{path, s_state.replacement_pack, false});
+
+  if (s_state.async_replacement_loaders >= MAX_ASYNC_REPLACEMENT_LOADERS)
+    return;
+
+  s_state.async_replacement_loaders++;
+  lock.unlock();
+
+  // Device features are only safe to query on the GPU thread.
+  const GPUDevice::Features& features = g_gpu_device->GetFeatures();
+  Host::QueueAsyncTask([dxt_supported = features.dxt_textures, bptc_supported = features.bptc_textures,
+                        prefetch_budget = static_cast<size_t>(s_state.config.max_preload_memory_usage_mb) * 1048576]() {
+    AsyncReplacementImageLoaderTask(dxt_supported, bptc_supported, prefetch_budget);
+  });
+}
+
+void GPUTextureCache::AsyncReplacementImageLoaderTask(bool dxt_supported, bool bptc_supported, size_t prefetch_budget)
+{
+  std::unique_lock lock(s_state.async_replacement_mutex);
+  while (!s_state.async_replacement_queue.empty())
+  {
+    AsyncReplacementLoad load = std::move(s_state.async_replacement_queue.front());
+    s_state.async_replacement_queue.pop_front();
+
+    if (load.prefetch && s_state.async_prefetch_memory_usage >= prefetch_budget)
+    {
+      s_state.async_replacement_results.push_back(AsyncReplacementResult{std::move(load.path), std::nullopt, true});
+      continue;
+    }
+
+    const u32 generation = s_state.async_replacement_generation;
+    lock.unlock();
+
+    Error error;
+    std::optional<TextureReplacementImage> image = TextureReplacementImage();
+    if (LoadTextureReplacementImage(&image.value(), load.path, load.pack.get(), &error))
+    {
+      // Decompress block formats here if the device can't sample them, rather than at upload time.
+      const ImageFormat format = image->GetFormat();
+      if (((format == ImageFormat::BC1 || format == ImageFormat::BC2 || format == ImageFormat::BC3) &&
+           !dxt_supported) ||
+          (format == ImageFormat::BC7 && !bptc_supported))
+      {
+        image = image->ConvertToRGBA8(&error);
+      }
+    }
+    else
+    {
+      image.reset();
+    }
+
+    if (image.has_value())
+    {
+      VERBOSE_LOG("Loaded '{}' asynchronously: {}x{} {}", Path::GetFileName(load.path), image->GetWidth(),
+                  image->GetHeight(), Image::GetFormatName(image->GetFormat()));
+    }
+    else
+    {
+      ERROR_LOG("Failed to load '{}': {}", Path::GetFileName(load.path), error.GetDescription());
+    }
+
+    lock.lock();
+
+    // Replacements were reloaded while we were decoding?
+    if (generation != s_state.async_replacement_generation)
+      continue;
+
+    if (load.prefetch && image.has_value())
+      s_state.async_prefetch_memory_usage += image->GetStorageSize();
+
+    s_state.async_replacement_results.push_back(
+      AsyncReplacementResult{std::move(load.path), std::move(image), false});
+  }
+
+  s_state.async_replacement_loaders--;
+}
+
+void GPUTextureCache::ProcessAsyncReplacementImages()
+{
+  std::vector<AsyncReplacementResult> results;
+  {
+    const std::unique_lock lock(s_state.async_replacement_mutex);
+    if (s_state.async_replacement_results.empty())
+      return;
+
+    results.swap(s_state.async_replacement_results);
+  }
+
+  bool invalidate_sources = false;
+  for (AsyncReplacementResult& res : results)
+  {
+    const auto pit = s_state.pending_replacement_images.find(res.path);
+    if (pit == s_state.pending_replacement_images.end())
+      continue;
+
+    const bool requested = pit->second;
+    if (res.skipped)
+    {
+      // Out of prefetch budget. Load it now if something has already asked for it.
+      s_state.pending_replacement_images.erase(pit);
+      if (requested)
+        QueueAsyncReplacementImageLoad(res.path, false);
+      continue;
+    }
+
+    // Failed images stay in the pending list, so we don't try to load them again every frame.
+    if (!res.image.has_value())
+      continue;
+
+    s_state.pending_replacement_images.erase(pit);
+    s_state.replacement_image_cache_memory_usage += res.image->GetStorageSize();
+    s_state.replacement_image_cache.emplace(std::move(res.path), std::move(res.image.value()));
+    invalidate_sources |= requested;
+  }
+
+  // Sources which were created with the original texture need to pick up the replacement.
+  if (invalidate_sources && (HasVRAMWriteTextureReplacements() || HasTexturePageTextureReplacements()))
+    InvalidateSources();
+}
+
+void GPUTextureCache::CancelAsyncReplacementImageLoads()
+{
+  {
+    const std::unique_lock lock(s_state.async_replacement_mutex);
+    s_state.async_replacement_generation++;
+    s_state.async_replacement_queue.clear();
+    s_state.async_replacement_results.clear();
+    s_state.async_prefetch_memory_usage = 0;
+  }
+
+  s_state.pending_replacement_images.clear();
 }
 
 bool GPUTextureCache::EnsureGameDirectoryExists()
@@ -3571,8 +4205,8 @@ std::string GPUTextureCache::GetTextureDumpDirectory()
 
 GPUTextureCache::VRAMReplacementName GPUTextureCache::GetVRAMWriteHash(u32 width, u32 height, const void* pixels)
 {
-  const XXH128_hash_t hash = XXH3_128bits(pixels, width * height * sizeof(u16));
-  return {hash.low64, hash.high64};
+  const FastHash::Hash128 hash = FastHash::Hash128Bits(pixels, width * height * sizeof(u16));
+  return {hash.low, hash.high};
 }
 
 std::string GPUTextureCache::GetVRAMWriteDumpPath(const VRAMReplacementName& name)
@@ -3650,9 +4284,14 @@ bool GPUTextureCache::LoadLocalConfiguration(bool load_vram_write_replacement_al
     GetOptionalTFromObject<u32>(root, "MaxHashCacheVRAMUsageMB").value_or(s_state.config.max_hash_cache_vram_usage_mb);
   s_state.config.max_replacement_cache_vram_usage_mb = GetOptionalTFromObject<u32>(root, "MaxReplacementCacheVRAMUsage")
                                                          .value_or(s_state.config.max_replacement_cache_vram_usage_mb);
+  s_state.config.max_preload_memory_usage_mb =
+    GetOptionalTFromObject<u32>(root, "MaxPreloadMemoryUsageMB").value_or(s_state.config.max_preload_memory_usage_mb);
   s_state.config.replacement_scale_linear_filter =
     GetOptionalTFromObject<bool>(root, "ReplacementScaleLinearFilter")
       .value_or(static_cast<bool>(s_state.config.replacement_scale_linear_filter));
+  s_state.config.direct_replacement_textures =
+    GetOptionalTFromObject<bool>(root, "DirectReplacementTextures")
+      .value_or(static_cast<bool>(s_state.config.direct_replacement_textures));
 
   if (load_vram_write_replacement_aliases || load_texture_replacement_aliases)
   {
@@ -3672,6 +4311,8 @@ void GPUTextureCache::ReloadTextureReplacements(bool show_info, bool show_info_i
   s_state.vram_replacements.clear();
   s_state.vram_write_texture_replacements.clear();
   s_state.texture_page_texture_replacements.clear();
+  CancelAsyncReplacementImageLoads();
+  s_state.replacement_pack.reset();
 
   const bool load_vram_write_replacements = (g_gpu_settings.texture_replacements.enable_vram_write_replacements);
   const bool load_texture_replacements =
@@ -3690,7 +4331,12 @@ void GPUTextureCache::ReloadTextureReplacements(bool show_info, bool show_info_i
   LoadLocalConfiguration(load_vram_write_replacements, load_texture_replacements);
 
   if (g_gpu_settings.texture_replacements.preload_textures)
-    PreloadReplacementTextures();
+  {
+    if (g_gpu_settings.texture_replacements.async_load_textures)
+      PrefetchReplacementTextures();
+    else
+      PreloadReplacementTextures();
+  }
 
   PurgeUnreferencedTexturesFromCache();
 
@@ -3715,11 +4361,12 @@ void GPUTextureCache::ReloadTextureReplacements(bool show_info, bool show_info_i
 void GPUTextureCache::PurgeUnreferencedTexturesFromCache()
 {
   ReplacementImageCache old_map = std::move(s_state.replacement_image_cache);
-  GPUReplacementImageCache old_gpu_map = std::move(s_state.gpu_replacement_image_cache);
   s_state.replacement_image_cache = ReplacementImageCache();
-  s_state.gpu_replacement_image_cache = GPUReplacementImageCache();
 
-  const auto reinsert_texture = [&old_map, &old_gpu_map](const std::string& name) {
+  // GPU images are linked into the LRU list, so they have to be removed in place rather than moved.
+  UnorderedStringSet referenced_gpu_images;
+
+  const auto reinsert_texture = [&old_map, &referenced_gpu_images](const std::string& name) {
     const auto it2 = old_map.find(name);
     if (it2 != old_map.end())
     {
@@ -3727,12 +4374,8 @@ void GPUTextureCache::PurgeUnreferencedTexturesFromCache()
       old_map.erase(it2);
     }
 
-    const auto it3 = old_gpu_map.find(name);
-    if (it3 != old_gpu_map.end())
-    {
-      s_state.gpu_replacement_image_cache.emplace(name, std::move(it3->second));
-      old_gpu_map.erase(it3);
-    }
+    if (s_state.gpu_replacement_image_cache.contains(name))
+      referenced_gpu_images.insert(name);
   };
 
   for (const auto& it : s_state.vram_replacements)
@@ -3743,6 +4386,30 @@ void GPUTextureCache::PurgeUnreferencedTexturesFromCache()
 
   for (const auto& it : s_state.texture_page_texture_replacements)
     reinsert_texture(it.second.second);
+
+  // Everything that's left in the old map gets freed.
+  for (const auto& it : old_map)
+    s_state.replacement_image_cache_memory_usage -= it.second.GetStorageSize();
+
+  for (TListNode<GPUReplacementImage>* n = s_state.gpu_replacement_image_lru.head; n;)
+  {
+    GPUReplacementImage* image = n->ref;
+    n = n->next;
+    if (!referenced_gpu_images.contains(*image->path))
+      RemoveTextureReplacementGPUImage(image);
+  }
+}
+
+GPUTextureCache::ReplacementCacheCounters GPUTextureCache::GetAndResetReplacementCacheCounters()
+{
+  const ReplacementCacheCounters ret = s_state.replacement_cache_counters;
+  s_state.replacement_cache_counters = {};
+  return ret;
+}
+
+size_t GPUTextureCache::GetReplacementCacheVRAMUsage()
+{
+  return s_state.gpu_replacement_image_cache_vram_usage;
 }
 
 void GPUTextureCache::ApplyTextureReplacements(SourceKey key, HashType tex_hash, HashType pal_hash,
@@ -3779,6 +4446,19 @@ void GPUTextureCache::ApplyTextureReplacements(SourceKey key, HashType tex_hash,
   if (subimages.empty())
     return;
 
+  // If a single opaque replacement covers the whole page, sample it as-is instead of compositing it into a new
+  // RGBA8 texture. Not only does that save the copy, it keeps block-compressed (DDS) replacements compressed.
+  static constexpr GSVector4i full_page_rect = GSVector4i::cxpr(0, 0, TEXTURE_PAGE_WIDTH, TEXTURE_PAGE_HEIGHT);
+  if (s_state.config.direct_replacement_textures && subimages.size() == 1 && !subimages[0].invert_alpha &&
+      subimages[0].dst_rect.eq(full_page_rect) && subimages[0].src_rect.eq(full_page_rect))
+  {
+    GL_INS_FMT("Using {}x{} {} replacement directly", subimages[0].texture->GetWidth(),
+               subimages[0].texture->GetHeight(), GPUTexture::GetFormatName(subimages[0].texture->GetFormat()));
+    AddTextureReplacementGPUImageRef(subimages[0].image);
+    entry->direct_replacement = subimages[0].image;
+    return;
+  }
+
   float max_scale_x = subimages[0].scale_x, max_scale_y = subimages[0].scale_y;
   for (size_t i = 0; i < subimages.size(); i++)
   {
@@ -119,6 +119,9 @@ void Invalidate();
 void AddWrittenRectangle(const GSVector4i rect, bool update_vram_writes = false, bool remove_from_hash_cache = false);
 void AddDrawnRectangle(const GSVector4i rect, const GSVector4i clip_rect);
 
+/// Forgets cached row hashes for an area of VRAM that was modified behind our back, e.g. by a readback.
+void InvalidateRowHashes(const GSVector4i rect);
+
 void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height, bool set_mask, bool check_mask,
               const GSVector4i src_bounds, const GSVector4i dst_bounds);
 void WriteVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask,
@@ -135,8 +138,18 @@ void GameSerialChanged();
 void ReloadTextureReplacements(bool show_info, bool show_info_if_none);
 
 // VRAM Write Replacements
-GPUTexture* GetVRAMReplacement(u32 width, u32 height, const void* pixels);
-void DumpVRAMWrite(u32 width, u32 height, const void* pixels);
-bool ShouldDumpVRAMWrite(u32 width, u32 height);
+/// Dumps the write if enabled, and returns its replacement texture if there is one. Writes are only hashed when they
+/// could be dumped or replaced, and at most once.
+GPUTexture* ProcessVRAMWrite(u32 width, u32 height, const void* pixels);
+
+// Replacement texture cache statistics, for the performance overlay.
+struct ReplacementCacheCounters
+{
+  u32 hits;
+  u32 misses;
+  u32 evictions;
+};
+ReplacementCacheCounters GetAndResetReplacementCacheCounters();
+size_t GetReplacementCacheVRAMUsage();
 
 } // namespace GPUTextureCache
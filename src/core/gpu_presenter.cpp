@@ -23,12 +23,15 @@
 #include "util/imgui_manager.h"
 #include "util/media_capture.h"
 #include "util/postprocessing.h"
+#include "util/shared_frame_export.h"
 #include "util/state_wrapper.h"
 
 #include "common/align.h"
 #include "common/assert.h"
 #include "common/error.h"
+#include "common/event_trace.h"
 #include "common/file_system.h"
+#include "common/frame_arena.h"
 #include "common/gsvector_formatter.h"
 #include "common/log.h"
 #include "common/path.h"
@@ -43,10 +46,20 @@
 
 LOG_CHANNEL(GPU);
 
+struct GPUPresenter::PendingScreenshot
+{
+  std::unique_ptr<GPUDownloadTexture> texture;
+  Image image;
+  ScreenshotCallback callback;
+  u32 frames_remaining;
+};
+
 GPUPresenter::GPUPresenter() = default;
 
 GPUPresenter::~GPUPresenter()
 {
+  ProcessPendingScreenshots(true);
+  m_shared_frame_export.reset();
   DestroyDeinterlaceTextures();
   g_gpu_device->RecycleTexture(std::move(m_chroma_smoothing_texture));
 }
@@ -92,6 +105,13 @@ bool GPUPresenter::UpdateSettings(const GPUSettings& old_settings, Error* error)
     }
   }
 
+  // Give it another go if it's toggled, in case it failed.
+  if (g_gpu_settings.display_shared_memory_frame_export != old_settings.display_shared_memory_frame_export)
+  {
+    m_shared_frame_export.reset();
+    m_shared_frame_export_failed = false;
+  }
+
   return true;
 }
 
@@ -186,6 +206,30 @@ bool GPUPresenter::CompileDisplayPipelines(bool display, bool deinterlace, bool
       m_display_24bit_pipeline.reset();
     }
 
+    // At 1:1 every scaling mode reduces to a copy of the source texels, so use a single fetch with no filtering.
+    // Not needed if nearest is already used for both, since that's the same shader.
+    const auto is_nearest = [](DisplayScalingMode mode) {
+      return (mode == DisplayScalingMode::Nearest || mode == DisplayScalingMode::NearestInteger);
+    };
+    if (!is_nearest(g_gpu_settings.display_scaling) || !is_nearest(g_gpu_settings.display_scaling_24bit))
+    {
+      std::unique_ptr<GPUShader> direct_fso =
+        g_gpu_device->CreateShader(GPUShaderStage::Fragment, shadergen.GetLanguage(),
+                                   shadergen.GenerateDisplayFragmentShader(false, true), error);
+      if (!direct_fso)
+        return false;
+      GL_OBJECT_NAME(direct_fso, "Display Direct Fragment Shader");
+
+      plconfig.fragment_shader = direct_fso.get();
+      if (!(m_display_direct_pipeline = g_gpu_device->CreatePipeline(plconfig, error)))
+        return false;
+      GL_OBJECT_NAME(m_display_direct_pipeline, "Display Direct Pipeline");
+    }
+    else
+    {
+      m_display_direct_pipeline.reset();
+    }
+
     std::unique_ptr<GPUShader> copy_fso = g_gpu_device->CreateShader(
       GPUShaderStage::Fragment, shadergen.GetLanguage(), shadergen.GenerateCopyFragmentShader(false), error);
     if (!copy_fso)
@@ -417,6 +461,7 @@ GPUDevice::PresentResult GPUPresenter::RenderDisplay(GPUTexture* target, const G
                                                      bool apply_aspect_ratio) const
 {
   GL_SCOPE_FMT("RenderDisplay: {}x{}", target_size.x, target_size.y);
+  const GPUDevice::TimingScope timing_scope("Present");
 
   if (m_display_texture)
     m_display_texture->MakeReadyForSampling();
@@ -546,6 +591,7 @@ GPUDevice::PresentResult GPUPresenter::RenderDisplay(GPUTexture* target, const G
         postfx_delayed_rotation ? display_rect_without_overlay.yxwz() : display_rect_without_overlay;
       ApplyDisplayPostProcess(postfx_output, postfx_input, postfx_final_rect, postfx_output->GetSizeVec());
       postfx_output->MakeReadyForSampling();
+      g_gpu_device->BeginTimingScope("Present");
 
       // Start draw to final buffer.
       if (const GPUDevice::PresentResult pres = bind_final_target(have_overlay); pres != GPUDevice::PresentResult::OK)
@@ -748,10 +794,22 @@ void GPUPresenter::DrawDisplay(const GSVector2i target_size, const GSVector2i fi
       break;
   }
 
-  if (m_display_texture_24bit && m_display_24bit_pipeline)
+  // Unscaled and unrotated, the filter doesn't change anything, so skip straight to loading texels.
+  if (m_display_direct_pipeline && !dst_alpha_blend && rotation == DisplayRotation::Normal &&
+      prerotation == WindowInfo::PreRotation::Identity && display_rect.rsize().eq(display_source_rect))
+  {
+    GL_INS("Using direct display pipeline");
+    g_gpu_device->SetPipeline(m_display_direct_pipeline.get());
+    texture_filter_linear = false;
+  }
+  else if (m_display_texture_24bit && m_display_24bit_pipeline)
+  {
     g_gpu_device->SetPipeline(dst_alpha_blend ? m_display_24bit_blend_pipeline.get() : m_display_24bit_pipeline.get());
+  }
   else
+  {
     g_gpu_device->SetPipeline(dst_alpha_blend ? m_display_blend_pipeline.get() : m_display_pipeline.get());
+  }
   g_gpu_device->SetTextureSampler(
     0, m_display_texture, texture_filter_linear ? g_gpu_device->GetLinearSampler() : g_gpu_device->GetNearestSampler());
 
@@ -953,13 +1011,122 @@ void GPUPresenter::SendDisplayToMediaCapture(MediaCapture* cap)
     (g_gpu_settings.display_screenshot_mode == DisplayScreenshotMode::ScreenResolution &&
      g_gpu_device->HasMainSwapChain() && target->GetSizeVec().eq(g_gpu_device->GetMainSwapChain()->GetSizeVec()));
 
-  if (RenderDisplay(target, target->GetSizeVec(), postfx, apply_aspect_ratio) != GPUDevice::PresentResult::OK ||
-      !cap->DeliverVideoFrame(target)) [[unlikely]]
+  if (RenderDisplay(target, target->GetSizeVec(), postfx, apply_aspect_ratio) != GPUDevice::PresentResult::OK)
+    [[unlikely]]
   {
-    WARNING_LOG("Failed to render/deliver video capture frame.");
+    WARNING_LOG("Failed to render video capture frame.");
     Host::RunOnCoreThread(&System::StopMediaCapture);
     return;
   }
+
+  // Convert to YUV on the GPU if the encoder wants it, so less has to be downloaded and swscale doesn't have to.
+  GPUTexture* deliver_texture = target;
+  if (const MediaCapture::PlanarFormat planar_format = cap->GetPlanarFormat();
+      planar_format != MediaCapture::PlanarFormat::None)
+  {
+    deliver_texture = cap->GetPlanarRenderTexture();
+    if (!deliver_texture ||
+        !ConvertMediaCaptureFrame(deliver_texture, target, planar_format == MediaCapture::PlanarFormat::I420))
+      [[unlikely]]
+    {
+      WARNING_LOG("Failed to convert video capture frame.");
+      Host::RunOnCoreThread(&System::StopMediaCapture);
+      return;
+    }
+  }
+
+  if (!cap->DeliverVideoFrame(deliver_texture)) [[unlikely]]
+  {
+    WARNING_LOG("Failed to deliver video capture frame.");
+    Host::RunOnCoreThread(&System::StopMediaCapture);
+    return;
+  }
+}
+
+void GPUPresenter::SendDisplayToSharedFrameExport(u32 frame_number)
+{
+  // 24-bit frames are still packed in VRAM, and need the display shader to unpack them.
+  if (m_shared_frame_export_failed || !m_display_texture || m_display_texture_24bit)
+    return;
+
+  if (!m_shared_frame_export)
+  {
+    m_shared_frame_export = std::make_unique<SharedFrameExport>();
+    INFO_LOG("Exporting frames to shared memory '{}'", m_shared_frame_export->GetName());
+  }
+
+  Error error;
+  const GSVector4i rect = m_display_texture_rect;
+  if (!m_shared_frame_export->SubmitFrame(m_display_texture, rect.left, rect.top, rect.width(), rect.height(),
+                                          frame_number, m_display_pixel_aspect_ratio, &error)) [[unlikely]]
+  {
+    ERROR_LOG("Failed to export frame to shared memory: {}", error.GetDescription());
+    m_shared_frame_export.reset();
+    m_shared_frame_export_failed = true;
+  }
+}
+
+bool GPUPresenter::CompileMediaCapturePlanarPipeline(Error* error)
+{
+  const GPUShaderGen shadergen(g_gpu_device->GetRenderAPI(), g_gpu_device->GetFeatures().dual_source_blend,
+                               g_gpu_device->GetFeatures().framebuffer_fetch);
+
+  std::unique_ptr<GPUShader> vso = g_gpu_device->CreateShader(GPUShaderStage::Vertex, shadergen.GetLanguage(),
+                                                              shadergen.GenerateScreenQuadVertexShader(), error);
+  std::unique_ptr<GPUShader> fso =
+    g_gpu_device->CreateShader(GPUShaderStage::Fragment, shadergen.GetLanguage(),
+                               shadergen.GenerateMediaCapturePlanarFragmentShader(), error);
+  if (!vso || !fso)
+    return false;
+  GL_OBJECT_NAME(vso, "Media Capture Planar Vertex Shader");
+  GL_OBJECT_NAME(fso, "Media Capture Planar Fragment Shader");
+
+  GPUPipeline::GraphicsConfig plconfig;
+  plconfig.layout = GPUPipeline::Layout::SingleTextureAndPushConstants;
+  plconfig.primitive = GPUPipeline::Primitive::Triangles;
+  plconfig.input_layout = {};
+  plconfig.rasterization = GPUPipeline::RasterizationState::GetNoCullState();
+  plconfig.depth = GPUPipeline::DepthState::GetNoTestsState();
+  plconfig.blend = GPUPipeline::BlendState::GetNoBlendingState();
+  plconfig.geometry_shader = nullptr;
+  plconfig.depth_format = GPUTextureFormat::Unknown;
+  plconfig.render_pass_flags = GPUPipeline::NoRenderPassFlags;
+  plconfig.SetTargetFormats(GPUTextureFormat::R8);
+  plconfig.vertex_shader = vso.get();
+  plconfig.fragment_shader = fso.get();
+  if (!(m_media_capture_planar_pipeline = g_gpu_device->CreatePipeline(plconfig, error)))
+    return false;
+  GL_OBJECT_NAME(m_media_capture_planar_pipeline, "Media Capture Planar Pipeline");
+
+  return true;
+}
+
+bool GPUPresenter::ConvertMediaCaptureFrame(GPUTexture* target, GPUTexture* source, bool i420)
+{
+  if (!m_media_capture_planar_pipeline)
+  {
+    Error error;
+    if (!CompileMediaCapturePlanarPipeline(&error)) [[unlikely]]
+    {
+      ERROR_LOG("Failed to compile media capture planar pipeline: {}", error.GetDescription());
+      return false;
+    }
+  }
+
+  GL_SCOPE_FMT("ConvertMediaCaptureFrame({}x{}, {})", source->GetWidth(), source->GetHeight(), i420 ? "I420" : "NV12");
+
+  source->MakeReadyForSampling();
+  g_gpu_device->InvalidateRenderTarget(target);
+  g_gpu_device->SetRenderTarget(target);
+  g_gpu_device->SetPipeline(m_media_capture_planar_pipeline.get());
+  g_gpu_device->SetTextureSampler(0, source, g_gpu_device->GetNearestSampler());
+  g_gpu_device->SetViewportAndScissor(target->GetRect());
+
+  // Source has to be flipped on the way in for GL, the planes are read back in the order they're written.
+  const u32 uniforms[] = {source->GetWidth(), source->GetHeight(), static_cast<u32>(i420),
+                          static_cast<u32>(g_gpu_device->UsesLowerLeftOrigin())};
+  g_gpu_device->DrawWithPushConstants(3, 0, uniforms, sizeof(uniforms));
+  return true;
 }
 
 void GPUPresenter::DestroyDeinterlaceTextures()
@@ -1186,8 +1353,11 @@ void GPUPresenter::CalculateDrawRect(const GSVector2i& window_size, bool apply_a
                          g_gpu_settings.display_fine_crop_amount, source_rect, display_rect, draw_rect);
 }
 
-bool GPUPresenter::PresentFrame(GPUPresenter* presenter, GPUBackend* backend, u64 present_time)
+bool GPUPresenter::PresentFrame(GPUPresenter* presenter, GPUBackend* backend, u64 present_time,
+                                bool skip_if_unchanged)
 {
+  EventTrace::ScopedSpan span("Present");
+
   // acquire for IO.MousePos and system state.
   std::atomic_thread_fence(std::memory_order_acquire);
 
@@ -1213,6 +1383,16 @@ bool GPUPresenter::PresentFrame(GPUPresenter* presenter, GPUBackend* backend, u6
 
   ImGuiManager::CreateDrawLists();
 
+  // Draw lists are built, so the UI is done with anything it allocated for this frame.
+  FrameArena::GetForCurrentThread().Reset();
+
+  // Nothing on screen would change, so leave the last frame up. The swap chain keeps showing it.
+  if (skip_if_unchanged && !FullscreenUI::IsTransitionActive() && ImGuiManager::AreDrawListsUnchanged())
+  {
+    ImGuiManager::NewFrame(Timer::GetCurrentValue());
+    return true;
+  }
+
   // render offscreen for transitions
   if (FullscreenUI::IsTransitionActive())
   {
@@ -1266,6 +1446,9 @@ bool GPUPresenter::PresentFrame(GPUPresenter* presenter, GPUBackend* backend, u6
     const Timer::Value current_time = Timer::GetCurrentValue();
     GPUThread::SetLastPresentTime(scheduled_present ? std::max(current_time, present_time) : current_time);
     ImGuiManager::NewFrame(current_time);
+
+    if (presenter)
+      presenter->ProcessPendingScreenshots(false);
   }
   else
   {
@@ -1304,8 +1487,8 @@ void GPUPresenter::SleepUntilPresentTime(u64 present_time)
 #endif
 }
 
-bool GPUPresenter::RenderScreenshotToBuffer(u32 width, u32 height, bool postfx, bool apply_aspect_ratio,
-                                            Image* out_image, Error* error)
+bool GPUPresenter::QueueScreenshotReadback(u32 width, u32 height, bool postfx, bool apply_aspect_ratio, Image* image,
+                                           std::unique_ptr<GPUDownloadTexture>* dltex, Error* error)
 {
   const ImageFormat image_format = GPUTexture::GetImageFormatForTextureFormat(m_present_format);
   if (image_format == ImageFormat::None)
@@ -1324,31 +1507,142 @@ bool GPUPresenter::RenderScreenshotToBuffer(u32 width, u32 height, bool postfx,
     return false;
   }
 
-  Image image(width, height, image_format);
+  *image = Image(width, height, image_format);
 
-  std::unique_ptr<GPUDownloadTexture> dltex;
   if (g_gpu_device->GetFeatures().memory_import)
   {
-    dltex = g_gpu_device->CreateDownloadTexture(width, height, m_present_format, image.GetPixels(),
-                                                image.GetStorageSize(), image.GetPitch(), error);
+    *dltex = g_gpu_device->CreateDownloadTexture(width, height, m_present_format, image->GetPixels(),
+                                                 image->GetStorageSize(), image->GetPitch(), error);
   }
-  if (!dltex)
+  if (!*dltex)
   {
-    if (!(dltex = g_gpu_device->CreateDownloadTexture(width, height, m_present_format, error)))
+    if (!(*dltex = g_gpu_device->CreateDownloadTexture(width, height, m_present_format, error)))
     {
       Error::AddPrefixFmt(error, "Failed to create {}x{} download texture: ", width, height);
       return false;
     }
   }
 
-  dltex->CopyFromTexture(0, 0, render_texture.get(), 0, 0, width, height, 0, 0, false);
+  (*dltex)->CopyFromTexture(0, 0, render_texture.get(), 0, 0, width, height, 0, 0, false);
+  return true;
+}
+
+bool GPUPresenter::RenderScreenshotToBuffer(u32 width, u32 height, bool postfx, bool apply_aspect_ratio,
+                                            Image* out_image, Error* error)
+{
+  Image image;
+  std::unique_ptr<GPUDownloadTexture> dltex;
+  if (!QueueScreenshotReadback(width, height, postfx, apply_aspect_ratio, &image, &dltex, error))
+    return false;
+
   if (!dltex->ReadTexels(0, 0, width, height, image.GetPixels(), image.GetPitch()))
+  {
+    Error::SetStringView(error, "Failed to read back screenshot.");
     return false;
+  }
 
   *out_image = std::move(image);
   return true;
 }
 
+bool GPUPresenter::ReadDisplayTexture(Image* image, Error* error) const
+{
+  if (!m_display_texture)
+  {
+    Error::SetStringView(error, "No display texture.");
+    image->Invalidate();
+    return false;
+  }
+
+  const u32 read_x = static_cast<u32>(m_display_texture_rect.x);
+  const u32 read_y = static_cast<u32>(m_display_texture_rect.y);
+  const u32 read_width = static_cast<u32>(m_display_texture_rect.width());
+  const u32 read_height = static_cast<u32>(m_display_texture_rect.height());
+  const GPUTextureFormat read_format = m_display_texture->GetFormat();
+  const ImageFormat image_format = GPUTexture::GetImageFormatForTextureFormat(read_format);
+  if (image_format == ImageFormat::None)
+  {
+    Error::SetStringFmt(error, "Unsupported display texture format {}.", GPUTexture::GetFormatName(read_format));
+    image->Invalidate();
+    return false;
+  }
+
+  if (image->GetWidth() != read_width || image->GetHeight() != read_height || image->GetFormat() != image_format)
+    *image = Image(read_width, read_height, image_format);
+
+  std::unique_ptr<GPUDownloadTexture> dltex;
+  if (g_gpu_device->GetFeatures().memory_import)
+  {
+    dltex = g_gpu_device->CreateDownloadTexture(read_width, read_height, read_format, image->GetPixels(),
+                                                image->GetStorageSize(), image->GetPitch());
+  }
+  if (!dltex)
+  {
+    if (!(dltex = g_gpu_device->CreateDownloadTexture(read_width, read_height, read_format, error)))
+    {
+      Error::AddPrefixFmt(error, "Failed to create {}x{} download texture: ", read_width, read_height);
+      image->Invalidate();
+      return false;
+    }
+  }
+
+  dltex->CopyFromTexture(0, 0, m_display_texture, read_x, read_y, read_width, read_height, 0, 0, !dltex->IsImported());
+  if (!dltex->ReadTexels(0, 0, read_width, read_height, image->GetPixels(), image->GetPitch()))
+  {
+    Error::SetStringFmt(error, "Failed to read {}x{} download texture.", read_width, read_height);
+    image->Invalidate();
+    return false;
+  }
+
+  return true;
+}
+
+bool GPUPresenter::RenderScreenshotToBufferAsync(u32 width, u32 height, bool postfx, bool apply_aspect_ratio,
+                                                 ScreenshotCallback callback, Error* error)
+{
+  PendingScreenshot& ps = m_pending_screenshots.emplace_back();
+  if (!QueueScreenshotReadback(width, height, postfx, apply_aspect_ratio, &ps.image, &ps.texture, error))
+  {
+    m_pending_screenshots.pop_back();
+    return false;
+  }
+
+  ps.callback = std::move(callback);
+  ps.frames_remaining = SCREENSHOT_READBACK_DELAY_FRAMES;
+
+  // Frames aren't presented while paused, so there's nothing to wait for.
+  if (GPUThread::IsSystemPaused())
+    ProcessPendingScreenshots(true);
+
+  return true;
+}
+
+void GPUPresenter::ProcessPendingScreenshots(bool force)
+{
+  // They all wait the same number of frames, so the oldest is always at the front.
+  for (PendingScreenshot& ps : m_pending_screenshots)
+    ps.frames_remaining -= static_cast<u32>(ps.frames_remaining > 0);
+
+  while (!m_pending_screenshots.empty() && (force || m_pending_screenshots.front().frames_remaining == 0))
+  {
+    PendingScreenshot ps = std::move(m_pending_screenshots.front());
+    m_pending_screenshots.erase(m_pending_screenshots.begin());
+
+    Error error;
+    if (ps.texture->ReadTexels(0, 0, ps.image.GetWidth(), ps.image.GetHeight(), ps.image.GetPixels(),
+                               ps.image.GetPitch()))
+    {
+      ps.texture.reset();
+      ps.callback(&ps.image, &error);
+    }
+    else
+    {
+      Error::SetStringView(&error, "Failed to read back screenshot.");
+      ps.callback(nullptr, &error);
+    }
+  }
+}
+
 GSVector2i GPUPresenter::CalculateScreenshotSize(DisplayScreenshotMode mode) const
 {
   const GSVector2i window_size =
@@ -1476,7 +1770,7 @@ void GPUPresenter::TogglePostProcessing()
       if (!presenter.m_display_postfx)
       {
         presenter.LoadPostProcessingSettings(true);
-        if (presenter.m_display_postfx && presenter.m_display_postfx->IsActive())
+        if (presenter.m_display_postfx && presenter.m_display_postfx->IsEnabled())
           return;
       }
       if (presenter.m_display_postfx)
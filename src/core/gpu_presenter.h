@@ -7,6 +7,7 @@
 
 #include "util/gpu_device.h"
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -15,6 +16,7 @@ class Error;
 class Image;
 class MediaCapture;
 class SettingsInterface;
+class SharedFrameExport;
 
 enum class DisplayScreenshotMode : u8;
 
@@ -65,11 +67,32 @@ public:
   bool RenderScreenshotToBuffer(u32 width, u32 height, bool postfx, bool apply_aspect_ratio, Image* out_image,
                                 Error* error);
 
+  /// Called on the GPU thread with the screenshot once it has been read back, or null and the error.
+  using ScreenshotCallback = std::function<void(Image* image, Error* error)>;
+
+  /// Same as RenderScreenshotToBuffer(), but the readback happens a few frames later when the GPU has caught up,
+  /// instead of stalling for it.
+  bool RenderScreenshotToBufferAsync(u32 width, u32 height, bool postfx, bool apply_aspect_ratio,
+                                     ScreenshotCallback callback, Error* error);
+
+  /// Completes readbacks for any screenshots which are ready, or all of them if force is set.
+  void ProcessPendingScreenshots(bool force);
+
+  /// Reads back the display texture as-is, without scaling or post-processing. The image's storage is reused if it is
+  /// already the right size, and the GPU writes directly into it when the device can import host memory. The image is
+  /// invalidated on failure.
+  bool ReadDisplayTexture(Image* image, Error* error) const;
+
   /// Sends the current frame to media capture.
   void SendDisplayToMediaCapture(MediaCapture* cap);
 
-  /// Main frame presenter - used both when a game is and is not running.
-  static bool PresentFrame(GPUPresenter* presenter, GPUBackend* backend, u64 present_time);
+  /// Publishes the current display texture to shared memory, for external capture tools.
+  void SendDisplayToSharedFrameExport(u32 frame_number);
+
+  /// Main frame presenter - used both when a game is and is not running. If skip_if_unchanged is set and the UI is
+  /// the same as what was last presented, nothing is rendered or presented.
+  static bool PresentFrame(GPUPresenter* presenter, GPUBackend* backend, u64 present_time,
+                           bool skip_if_unchanged = false);
 
   /// Returns a list of border overlay presets.
   static std::vector<std::string> EnumerateBorderOverlayPresets();
@@ -93,8 +116,11 @@ private:
   enum : u32
   {
     DEINTERLACE_BUFFER_COUNT = 4,
+    SCREENSHOT_READBACK_DELAY_FRAMES = 2,
   };
 
+  struct PendingScreenshot;
+
   static void SleepUntilPresentTime(u64 present_time);
 
   bool CompileDisplayPipelines(bool display, bool deinterlace, bool chroma_smoothing, Error* error);
@@ -115,6 +141,12 @@ private:
   GPUDevice::PresentResult ApplyDisplayPostProcess(GPUTexture* target, GPUTexture* input, const GSVector4i display_rect,
                                                    const GSVector2i postfx_size) const;
 
+  bool QueueScreenshotReadback(u32 width, u32 height, bool postfx, bool apply_aspect_ratio, Image* image,
+                               std::unique_ptr<GPUDownloadTexture>* dltex, Error* error);
+
+  bool CompileMediaCapturePlanarPipeline(Error* error);
+  bool ConvertMediaCaptureFrame(GPUTexture* target, GPUTexture* source, bool i420);
+
   bool DeinterlaceSetTargetSize(u32 width, u32 height, bool preserve);
   void DestroyDeinterlaceTextures();
 
@@ -139,6 +171,7 @@ private:
 
   std::unique_ptr<GPUPipeline> m_display_pipeline;
   std::unique_ptr<GPUPipeline> m_display_24bit_pipeline;
+  std::unique_ptr<GPUPipeline> m_display_direct_pipeline;
   GPUTexture* m_display_texture = nullptr;
   GSVector4i m_display_texture_rect = GSVector4i::cxpr(0);
 
@@ -158,6 +191,13 @@ private:
   std::unique_ptr<GPUPipeline> m_display_24bit_blend_pipeline;
   std::unique_ptr<GPUPipeline> m_present_copy_blend_pipeline;
 
+  std::unique_ptr<GPUPipeline> m_media_capture_planar_pipeline;
+
+  std::unique_ptr<SharedFrameExport> m_shared_frame_export;
+  bool m_shared_frame_export_failed = false;
+
+  std::vector<PendingScreenshot> m_pending_screenshots;
+
   GSVector4i m_border_overlay_display_rect = GSVector4i::zero();
 
   // Low-traffic variables down here.
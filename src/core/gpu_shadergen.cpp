@@ -322,3 +322,63 @@ float3 SampleVRAMAverage2x2(uint2 icoords)
 
   return std::move(ss).str();
 }
+
+std::string GPUShaderGen::GenerateMediaCapturePlanarFragmentShader() const
+{
+  std::stringstream ss;
+  WriteHeader(ss);
+  DeclareUniformBuffer(ss, {"uint2 u_size", "uint u_i420", "uint u_flip"}, true);
+  DeclareTexture(ss, "samp0", 0);
+
+  // BT.601 limited range, matching what swscale does by default.
+  ss << R"(
+float3 LoadSource(uint2 icoords)
+{
+  icoords.y = (u_flip != 0u) ? (u_size.y - 1u - icoords.y) : icoords.y;
+  return LOAD_TEXTURE(samp0, int2(icoords), 0).rgb;
+}
+)";
+
+  DeclareFragmentEntryPoint(ss, 0, 1, {}, true);
+  ss << R"(
+{
+  uint2 fcoord = uint2(v_pos.xy);
+  float value;
+  if (fcoord.y < u_size.y)
+  {
+    value = dot(LoadSource(fcoord), float3(0.256788f, 0.504129f, 0.097906f)) + (16.0f / 255.0f);
+  }
+  else
+  {
+    uint row = fcoord.y - u_size.y;
+    uint plane;
+    uint2 ccoords;
+    if (u_i420 != 0u)
+    {
+      // U plane followed by V plane, each texture row holds two half-width chroma rows.
+      uint half_width = u_size.x / 2u;
+      uint plane_rows = u_size.y / 4u;
+      plane = row / plane_rows;
+      ccoords = uint2(fcoord.x % half_width, ((row % plane_rows) * 2u) + (fcoord.x / half_width));
+    }
+    else
+    {
+      // Interleaved U/V.
+      plane = fcoord.x & 1u;
+      ccoords = uint2(fcoord.x / 2u, row);
+    }
+
+    uint2 scoords = ccoords * 2u;
+    float3 rgb = (LoadSource(scoords) + LoadSource(scoords + uint2(1u, 0u)) + LoadSource(scoords + uint2(0u, 1u)) +
+                  LoadSource(scoords + uint2(1u, 1u))) * 0.25f;
+    float3 coeff = (plane == 0u) ? float3(-0.148223f, -0.290993f, 0.439216f) :
+                                   float3(0.439216f, -0.367788f, -0.071427f);
+    value = dot(rgb, coeff) + (128.0f / 255.0f);
+  }
+
+  o_col0 = float4(value, 0.0f, 0.0f, 1.0f);
+}
+)";
+
+  return std::move(ss).str();
+}
@@ -26,7 +26,10 @@ GPU_SW::GPU_SW(GPUPresenter& presenter) : GPUBackend(presenter)
 {
 }
 
-GPU_SW::~GPU_SW() = default;
+GPU_SW::~GPU_SW()
+{
+  StopBinWorkers();
+}
 
 u32 GPU_SW::GetResolutionScale() const
 {
@@ -57,19 +60,313 @@ bool GPU_SW::Initialize(bool upload_vram, Error* error)
   if (!upload_vram)
     std::memset(g_vram, 0, sizeof(g_vram));
 
+  MarkAllLinesDirty();
+  StartBinWorkers(g_gpu_settings.gpu_software_renderer_threads);
   return true;
 }
 
+bool GPU_SW::UpdateSettings(const GPUSettings& old_settings, Error* error)
+{
+  if (!GPUBackend::UpdateSettings(old_settings, error))
+    return false;
+
+  if (g_gpu_settings.gpu_software_renderer_threads != old_settings.gpu_software_renderer_threads)
+  {
+    StopBinWorkers();
+    StartBinWorkers(g_gpu_settings.gpu_software_renderer_threads);
+  }
+
+  return true;
+}
+
+void GPU_SW::StartBinWorkers(u32 count)
+{
+  // A single worker would just be a slower version of drawing on this thread.
+  count = std::min(count, MAX_BIN_THREADS);
+  if (count <= 1)
+    return;
+
+  INFO_LOG("Using {} threads for binned software rendering.", count);
+
+  m_bin_queue = std::make_unique_for_overwrite<BinnedPrimitive[]>(BIN_QUEUE_SIZE);
+  m_bin_clut_snapshots = std::make_unique<std::array<u16, GPU_CLUT_SIZE>[]>(BIN_CLUT_SNAPSHOTS);
+  m_bin_clut_snapshot_last_use.fill(0);
+  m_bin_clut_index = 0;
+  std::memcpy(m_bin_clut_snapshots[0].data(), g_gpu_clut, sizeof(g_gpu_clut));
+  m_bin_write_pos = 0;
+  m_bin_min_read_pos = 0;
+  m_bin_published_pos.store(0, std::memory_order_relaxed);
+  m_bin_shutdown.store(false, std::memory_order_relaxed);
+  m_bin_dirty_rect = INVALID_RECT;
+  m_bin_read_rect = INVALID_RECT;
+
+  m_bin_workers.reserve(count);
+  for (u32 i = 0; i < count; i++)
+  {
+    std::unique_ptr<BinWorker>& worker = m_bin_workers.emplace_back(std::make_unique<BinWorker>());
+    worker->index = i;
+  }
+
+  // Don't start any threads until the worker count is final, they use it to pick their bands.
+  m_bin_num_workers = count;
+  for (const std::unique_ptr<BinWorker>& worker : m_bin_workers)
+    worker->thread.Start([this, worker = worker.get()]() { BinWorkerThread(worker); });
+}
+
+void GPU_SW::StopBinWorkers()
+{
+  if (!IsBinning())
+    return;
+
+  WaitForBinWorkers();
+
+  m_bin_shutdown.store(true, std::memory_order_release);
+  for (const std::unique_ptr<BinWorker>& worker : m_bin_workers)
+  {
+    worker->wake_semaphore.Post();
+    worker->thread.Join();
+  }
+
+  m_bin_workers.clear();
+  m_bin_num_workers = 0;
+  m_bin_queue.reset();
+  m_bin_clut_snapshots.reset();
+}
+
+void GPU_SW::WaitForBinWorkers()
+{
+  // Workers only post the idle semaphore when asked to, and only once they've caught up to the write position.
+  for (const std::unique_ptr<BinWorker>& worker : m_bin_workers)
+  {
+    if (worker->read_pos.load() == m_bin_write_pos)
+      continue;
+
+    worker->signal_when_idle.store(true);
+    if (worker->read_pos.load() != m_bin_write_pos || !worker->signal_when_idle.exchange(false))
+      m_bin_idle_semaphore.Wait();
+  }
+
+  m_bin_min_read_pos = m_bin_write_pos;
+  m_bin_dirty_rect = INVALID_RECT;
+  m_bin_read_rect = INVALID_RECT;
+}
+
+void GPU_SW::UpdateBinMinReadPos()
+{
+  u32 max_distance = 0;
+  for (const std::unique_ptr<BinWorker>& worker : m_bin_workers)
+    max_distance = std::max(max_distance, m_bin_write_pos - worker->read_pos.load(std::memory_order_acquire));
+
+  m_bin_min_read_pos = m_bin_write_pos - max_distance;
+}
+
+void GPU_SW::BinWorkerThread(BinWorker* worker)
+{
+  Threading::SetNameOfCurrentThread("GPU SW Worker");
+
+  u32 pos = 0;
+  while (!m_bin_shutdown.load(std::memory_order_acquire))
+  {
+    const u32 end_pos = m_bin_published_pos.load(std::memory_order_acquire);
+    if (pos != end_pos)
+    {
+      do
+      {
+        ExecuteBinnedPrimitive(m_bin_queue[pos & BIN_QUEUE_MASK], worker->index);
+        worker->read_pos.store(++pos);
+      } while (pos != end_pos);
+      continue;
+    }
+
+    if (worker->signal_when_idle.load())
+    {
+      // More work may have been queued before the wait started.
+      if (m_bin_published_pos.load() != pos)
+        continue;
+
+      if (worker->signal_when_idle.exchange(false))
+        m_bin_idle_semaphore.Post();
+    }
+
+    // If work was queued while we were going to sleep and the GPU thread didn't see the flag, skip the wait.
+    // Otherwise, the semaphore has been or is about to be posted, and we have to consume it.
+    worker->sleeping.store(true);
+    if ((m_bin_published_pos.load() != pos || m_bin_shutdown.load()) && worker->sleeping.exchange(false))
+      continue;
+
+    worker->wake_semaphore.Wait();
+  }
+}
+
+void GPU_SW::ExecuteBinnedPrimitive(const BinnedPrimitive& prim, u32 worker_index) const
+{
+  // Bands are interleaved between workers, so find the first band at or after the top of the primitive we own.
+  const u32 top = static_cast<u32>(prim.top);
+  const u32 bottom = static_cast<u32>(prim.bottom);
+  const u32 first_band = top / BIN_BAND_HEIGHT;
+  u32 band = first_band + ((worker_index + m_bin_num_workers - (first_band % m_bin_num_workers)) % m_bin_num_workers);
+  if ((band * BIN_BAND_HEIGHT) > bottom)
+    return;
+
+  GPU_SW_Rasterizer::g_clut = m_bin_clut_snapshots[prim.clut_index].data();
+
+  for (; (band * BIN_BAND_HEIGHT) <= bottom; band += m_bin_num_workers)
+  {
+    GPUDrawingArea& area = GPU_SW_Rasterizer::g_drawing_area;
+    area = prim.drawing_area;
+    area.top = std::max(top, band * BIN_BAND_HEIGHT);
+    area.bottom = std::min(bottom, (band * BIN_BAND_HEIGHT) + (BIN_BAND_HEIGHT - 1));
+
+    switch (prim.type)
+    {
+      case BinnedPrimitiveType::Triangle:
+        prim.func.triangle(&prim.cmd, &prim.vertices.triangle[0], &prim.vertices.triangle[1],
+                           &prim.vertices.triangle[2]);
+        break;
+
+      case BinnedPrimitiveType::Rectangle:
+        prim.func.rectangle(&prim.cmd);
+        break;
+
+      case BinnedPrimitiveType::Line:
+        prim.func.line(&prim.cmd, &prim.vertices.line[0], &prim.vertices.line[1]);
+        break;
+
+        DefaultCaseIsUnreachable();
+    }
+  }
+}
+
+bool GPU_SW::CanBinPrimitive()
+{
+  if (!IsBinning())
+    return false;
+
+  // Rows past the bottom of VRAM wrap around, which would break the band ownership.
+  if (GPU_SW_Rasterizer::g_drawing_area.bottom < VRAM_HEIGHT) [[likely]]
+    return true;
+
+  WaitForBinWorkers();
+  return false;
+}
+
+GPU_SW::BinnedPrimitive* GPU_SW::AllocateBinnedPrimitive(const GPUBackendDrawCommand* cmd, s32 top, s32 bottom)
+{
+  top = std::max(top, static_cast<s32>(GPU_SW_Rasterizer::g_drawing_area.top));
+  bottom = std::min(bottom, static_cast<s32>(GPU_SW_Rasterizer::g_drawing_area.bottom));
+  if (top > bottom)
+    return nullptr;
+
+  // Texture reads can come from any band, so anything still being drawn to the page has to land first. Likewise, a
+  // band which is ahead can't draw over texels that another band still has to read.
+  if ((cmd->texture_enable &&
+       GetTextureRect(cmd->draw_mode.texture_page, cmd->draw_mode.texture_mode).rintersects(m_bin_dirty_rect)) ||
+      m_clamped_drawing_area.rintersects(m_bin_read_rect))
+  {
+    WaitForBinWorkers();
+  }
+
+  if ((m_bin_write_pos - m_bin_min_read_pos) >= BIN_QUEUE_SIZE)
+  {
+    UpdateBinMinReadPos();
+    if ((m_bin_write_pos - m_bin_min_read_pos) >= BIN_QUEUE_SIZE)
+      WaitForBinWorkers();
+  }
+
+  BinnedPrimitive& prim = m_bin_queue[m_bin_write_pos & BIN_QUEUE_MASK];
+  prim.clut_index = m_bin_clut_index;
+  prim.top = static_cast<s16>(top);
+  prim.bottom = static_cast<s16>(bottom);
+  prim.drawing_area = GPU_SW_Rasterizer::g_drawing_area;
+  std::memcpy(&prim.cmd, cmd, sizeof(GPUBackendDrawCommand));
+  return &prim;
+}
+
+void GPU_SW::PushBinnedPrimitive()
+{
+  const GPUBackendDrawCommand& cmd = m_bin_queue[m_bin_write_pos & BIN_QUEUE_MASK].cmd;
+  if (cmd.texture_enable)
+  {
+    const GPUTextureMode mode = cmd.draw_mode.texture_mode;
+    m_bin_read_rect = m_bin_read_rect.runion(GetTextureRect(cmd.draw_mode.texture_page, mode));
+    if (GetPaletteWidth(mode) > 0)
+      m_bin_read_rect = m_bin_read_rect.runion(GetPaletteRect(cmd.palette, mode));
+  }
+
+  m_bin_clut_snapshot_last_use[m_bin_clut_index] = ++m_bin_write_pos;
+  m_bin_dirty_rect = m_bin_dirty_rect.runion(m_clamped_drawing_area);
+  m_bin_published_pos.store(m_bin_write_pos);
+
+  for (const std::unique_ptr<BinWorker>& worker : m_bin_workers)
+  {
+    if (worker->sleeping.load() && worker->sleeping.exchange(false))
+      worker->wake_semaphore.Post();
+  }
+}
+
+void GPU_SW::BinTriangle(const GPUBackendDrawCommand* cmd, GPU_SW_Rasterizer::DrawTriangleFunction func,
+                         const GPUBackendDrawPolygonCommand::Vertex* v0, const GPUBackendDrawPolygonCommand::Vertex* v1,
+                         const GPUBackendDrawPolygonCommand::Vertex* v2)
+{
+  // Positions outside this range get wrapped by the rasterizer, so we can't trust the bounds.
+  s32 top = std::min(v0->y, std::min(v1->y, v2->y)) - 1;
+  s32 bottom = std::max(v0->y, std::max(v1->y, v2->y)) + 1;
+  if (top < -1024 || bottom > 1023) [[unlikely]]
+  {
+    top = 0;
+    bottom = VRAM_HEIGHT - 1;
+  }
+
+  BinnedPrimitive* prim = AllocateBinnedPrimitive(cmd, top, bottom);
+  if (!prim)
+    return;
+
+  prim->type = BinnedPrimitiveType::Triangle;
+  prim->func.triangle = func;
+  prim->vertices.triangle[0] = *v0;
+  prim->vertices.triangle[1] = *v1;
+  prim->vertices.triangle[2] = *v2;
+  PushBinnedPrimitive();
+}
+
+void GPU_SW::BinLine(const GPUBackendDrawCommand* cmd, GPU_SW_Rasterizer::DrawLineFunction func,
+                     const GPUBackendDrawLineCommand::Vertex* p0, const GPUBackendDrawLineCommand::Vertex* p1)
+{
+  s32 top = std::min(p0->y, p1->y) - 1;
+  s32 bottom = std::max(p0->y, p1->y) + 1;
+  if (top < -1024 || bottom > 1023) [[unlikely]]
+  {
+    top = 0;
+    bottom = VRAM_HEIGHT - 1;
+  }
+
+  BinnedPrimitive* prim = AllocateBinnedPrimitive(cmd, top, bottom);
+  if (!prim)
+    return;
+
+  prim->type = BinnedPrimitiveType::Line;
+  prim->func.line = func;
+  prim->vertices.line[0] = *p0;
+  prim->vertices.line[1] = *p1;
+  PushBinnedPrimitive();
+}
+
 void GPU_SW::ClearVRAM()
 {
+  WaitForBinWorkers();
   std::memset(g_vram, 0, sizeof(g_vram));
   std::memset(g_gpu_clut, 0, sizeof(g_gpu_clut));
+  RefreshBinCLUTSnapshot();
+  MarkAllLinesDirty();
 }
 
 void GPU_SW::LoadState(const GPUBackendLoadStateCommand* cmd)
 {
+  WaitForBinWorkers();
   std::memcpy(g_vram, cmd->vram_data, sizeof(g_vram));
   std::memcpy(g_gpu_clut, cmd->clut_data, sizeof(g_gpu_clut));
+  RefreshBinCLUTSnapshot();
+  MarkAllLinesDirty();
 }
 
 bool GPU_SW::AllocateMemorySaveState(System::MemorySaveState& mss, Error* error)
@@ -80,28 +377,95 @@ bool GPU_SW::AllocateMemorySaveState(System::MemorySaveState& mss, Error* error)
 
 void GPU_SW::DoMemoryState(StateWrapper& sw, System::MemorySaveState& mss)
 {
+  WaitForBinWorkers();
   sw.DoBytes(g_vram, sizeof(g_vram));
   sw.DoBytes(g_gpu_clut, sizeof(g_gpu_clut));
   DebugAssert(!sw.HasError());
+
+  if (sw.IsReading())
+  {
+    RefreshBinCLUTSnapshot();
+    MarkAllLinesDirty();
+  }
 }
 
 void GPU_SW::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
 {
+  // The CPU thread reads g_vram directly once this command completes.
+  WaitForBinWorkers();
 }
 
 void GPU_SW::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, bool interlaced_rendering, u8 active_line_lsb)
 {
+  WaitForBinWorkers();
   GPU_SW_Rasterizer::FillVRAM(x, y, width, height, color, interlaced_rendering, active_line_lsb);
+  MarkLinesDirty(y, height);
 }
 
 void GPU_SW::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask)
 {
+  WaitForBinWorkers();
   GPU_SW_Rasterizer::WriteVRAM(x, y, width, height, data, set_mask, check_mask);
+  MarkLinesDirty(y, height);
 }
 
 void GPU_SW::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height, bool set_mask, bool check_mask)
 {
+  WaitForBinWorkers();
   GPU_SW_Rasterizer::CopyVRAM(src_x, src_y, dst_x, dst_y, width, height, set_mask, check_mask);
+  MarkLinesDirty(dst_y, height);
+}
+
+void GPU_SW::MarkLinesDirty(u32 y, u32 height)
+{
+  // Writes wrap around the bottom of VRAM.
+  y %= VRAM_HEIGHT;
+  height = std::min<u32>(height, VRAM_HEIGHT);
+  const u32 end = y + height;
+  if (end > VRAM_HEIGHT)
+  {
+    MarkLinesDirty(0, end - VRAM_HEIGHT);
+    height = VRAM_HEIGHT - y;
+  }
+
+  for (u32 line = y; line < (y + height);)
+  {
+    const u32 word = line / 64;
+    const u32 bit = line % 64;
+    const u32 count = std::min(64 - bit, (y + height) - line);
+    m_dirty_lines[word] |= ((count == 64) ? ~static_cast<u64>(0) : (((static_cast<u64>(1) << count) - 1) << bit));
+    line += count;
+  }
+}
+
+void GPU_SW::MarkDrawDirty(s32 top, s32 bottom)
+{
+  // Positions outside this range get wrapped by the rasterizer, so we can't trust the bounds.
+  const GPUDrawingArea& area = GPU_SW_Rasterizer::g_drawing_area;
+  if (top < -1024 || bottom > 1023) [[unlikely]]
+  {
+    top = static_cast<s32>(area.top);
+    bottom = static_cast<s32>(area.bottom);
+  }
+
+  top = std::max(top, static_cast<s32>(area.top));
+  bottom = std::min(bottom, static_cast<s32>(area.bottom));
+  if (top <= bottom)
+    MarkLinesDirty(static_cast<u32>(top), static_cast<u32>(bottom - top + 1));
+}
+
+template<typename T>
+void GPU_SW::MarkVerticesDirty(const T* vertices, u32 num_vertices)
+{
+  s32 top = vertices[0].y;
+  s32 bottom = vertices[0].y;
+  for (u32 i = 1; i < num_vertices; i++)
+  {
+    top = std::min(top, vertices[i].y);
+    bottom = std::max(bottom, vertices[i].y);
+  }
+
+  MarkDrawDirty(top, bottom);
 }
 
 void GPU_SW::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
@@ -112,6 +476,16 @@ void GPU_SW::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
                                          g_gpu_settings.gpu_modulation_crop),
     cmd->transparency_enable);
 
+  MarkVerticesDirty(cmd->vertices, cmd->num_vertices);
+
+  if (CanBinPrimitive())
+  {
+    BinTriangle(cmd, DrawFunction, &cmd->vertices[0], &cmd->vertices[1], &cmd->vertices[2]);
+    if (cmd->num_vertices > 3)
+      BinTriangle(cmd, DrawFunction, &cmd->vertices[2], &cmd->vertices[1], &cmd->vertices[3]);
+    return;
+  }
+
   DrawFunction(cmd, &cmd->vertices[0], &cmd->vertices[1], &cmd->vertices[2]);
   if (cmd->num_vertices > 3)
     DrawFunction(cmd, &cmd->vertices[2], &cmd->vertices[1], &cmd->vertices[3]);
@@ -135,6 +509,16 @@ void GPU_SW::DrawPrecisePolygon(const GPUBackendDrawPrecisePolygonCommand* cmd)
       .x = src.native_x, .y = src.native_y, .color = src.color, .texcoord = src.texcoord};
   }
 
+  MarkVerticesDirty(vertices, cmd->num_vertices);
+
+  if (CanBinPrimitive())
+  {
+    BinTriangle(cmd, DrawFunction, &vertices[0], &vertices[1], &vertices[2]);
+    if (cmd->num_vertices > 3)
+      BinTriangle(cmd, DrawFunction, &vertices[2], &vertices[1], &vertices[3]);
+    return;
+  }
+
   DrawFunction(cmd, &vertices[0], &vertices[1], &vertices[2]);
   if (cmd->num_vertices > 3)
     DrawFunction(cmd, &vertices[2], &vertices[1], &vertices[3]);
@@ -154,11 +538,26 @@ void GPU_SW::DrawSprite(const GPUBackendDrawRectangleCommand* cmd)
     return;
   }
 
+  MarkLinesDirty(static_cast<u32>(clamped_rect.top), static_cast<u32>(clamped_rect.height()));
+
   const GPU_SW_Rasterizer::DrawRectangleFunction DrawFunction = GPU_SW_Rasterizer::GetDrawRectangleFunction(
     GPU_SW_Rasterizer::GetModulationMode(cmd->texture_enable, cmd->raw_texture_enable,
                                          g_gpu_settings.gpu_modulation_crop),
     cmd->transparency_enable);
 
+  if (CanBinPrimitive())
+  {
+    BinnedPrimitive* prim = AllocateBinnedPrimitive(cmd, cmd->y, cmd->y + static_cast<s32>(cmd->height) - 1);
+    if (!prim)
+      return;
+
+    prim->type = BinnedPrimitiveType::Rectangle;
+    prim->func.rectangle = DrawFunction;
+    std::memcpy(&prim->cmd, cmd, sizeof(GPUBackendDrawRectangleCommand));
+    PushBinnedPrimitive();
+    return;
+  }
+
   DrawFunction(cmd);
 }
 
@@ -167,6 +566,15 @@ void GPU_SW::DrawLine(const GPUBackendDrawLineCommand* cmd)
   const GPU_SW_Rasterizer::DrawLineFunction DrawFunction =
     GPU_SW_Rasterizer::GetDrawLineFunction(cmd->shading_enable, cmd->transparency_enable);
 
+  MarkVerticesDirty(cmd->vertices, cmd->num_vertices);
+
+  if (CanBinPrimitive())
+  {
+    for (u16 i = 0; i < cmd->num_vertices; i += 2)
+      BinLine(cmd, DrawFunction, &cmd->vertices[i], &cmd->vertices[i + 1]);
+    return;
+  }
+
   for (u16 i = 0; i < cmd->num_vertices; i += 2)
     DrawFunction(cmd, &cmd->vertices[i], &cmd->vertices[i + 1]);
 }
@@ -178,6 +586,7 @@ void GPU_SW::DrawPreciseLine(const GPUBackendDrawPreciseLineCommand* cmd)
 
   // Need to cut out the irrelevant bits.
   // TODO: In _theory_ we could use the fixed-point parts here.
+  const bool binned = CanBinPrimitive();
   for (u32 i = 0; i < cmd->num_vertices; i += 2)
   {
     const GPUBackendDrawPreciseLineCommand::Vertex& RESTRICT start = cmd->vertices[i];
@@ -187,7 +596,12 @@ void GPU_SW::DrawPreciseLine(const GPUBackendDrawPreciseLineCommand* cmd)
       {.x = end.native_x, .y = end.native_y, .color = end.color},
     };
 
-    DrawFunction(cmd, &vertices[0], &vertices[1]);
+    MarkVerticesDirty(vertices, 2);
+
+    if (binned)
+      BinLine(cmd, DrawFunction, &vertices[0], &vertices[1]);
+    else
+      DrawFunction(cmd, &vertices[0], &vertices[1]);
   }
 }
 
@@ -196,6 +610,41 @@ void GPU_SW::DrawingAreaChanged()
   // GPU_SW_Rasterizer::g_drawing_area set by base class.
 }
 
+void GPU_SW::UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit)
+{
+  if (!IsBinning())
+  {
+    GPU_SW_Rasterizer::UpdateCLUT(reg, clut_is_8bit);
+    return;
+  }
+
+  // Palette has to be read after any pending draws to it.
+  const GPUTextureMode mode = clut_is_8bit ? GPUTextureMode::Palette8Bit : GPUTextureMode::Palette4Bit;
+  if (GetPaletteRect(reg, mode).rintersects(m_bin_dirty_rect))
+    WaitForBinWorkers();
+
+  GPU_SW_Rasterizer::UpdateCLUT(reg, clut_is_8bit);
+
+  // Can't overwrite a snapshot that queued primitives are still going to sample from.
+  const u8 next_index = static_cast<u8>((m_bin_clut_index + 1) % BIN_CLUT_SNAPSHOTS);
+  if (static_cast<s32>(m_bin_clut_snapshot_last_use[next_index] - m_bin_min_read_pos) > 0)
+  {
+    UpdateBinMinReadPos();
+    if (static_cast<s32>(m_bin_clut_snapshot_last_use[next_index] - m_bin_min_read_pos) > 0)
+      WaitForBinWorkers();
+  }
+
+  m_bin_clut_index = next_index;
+  std::memcpy(m_bin_clut_snapshots[next_index].data(), g_gpu_clut, sizeof(g_gpu_clut));
+}
+
+void GPU_SW::RefreshBinCLUTSnapshot()
+{
+  // Only called with no primitives in flight, so the current snapshot can be replaced.
+  if (IsBinning())
+    std::memcpy(m_bin_clut_snapshots[m_bin_clut_index].data(), g_gpu_clut, sizeof(g_gpu_clut));
+}
+
 void GPU_SW::ClearCache()
 {
 }
@@ -206,6 +655,7 @@ void GPU_SW::OnBufferSwapped()
 
 void GPU_SW::FlushRender()
 {
+  WaitForBinWorkers();
 }
 
 void GPU_SW::RestoreDeviceContext()
@@ -229,7 +679,8 @@ GPUTexture* GPU_SW::GetDisplayTexture(u32 width, u32 height, GPUTextureFormat fo
 }
 
 template<GPUTextureFormat display_format>
-ALWAYS_INLINE_RELEASE bool GPU_SW::CopyOut15Bit(u32 src_x, u32 src_y, u32 width, u32 height, u32 line_skip)
+ALWAYS_INLINE_RELEASE bool GPU_SW::CopyOut15Bit(u32 src_x, u32 src_y, u32 width, u32 height, u32 line_skip, u32 dst_y,
+                                                u32 copy_height)
 {
   GPUTexture* texture = GetDisplayTexture(width, height, display_format);
   if (!texture) [[unlikely]]
@@ -237,10 +688,12 @@ ALWAYS_INLINE_RELEASE bool GPU_SW::CopyOut15Bit(u32 src_x, u32 src_y, u32 width,
 
   u32 dst_stride = Common::AlignUpPow2(width * texture->GetPixelSize(), 4);
   u8* dst_ptr = m_upload_buffer.data();
-  const bool mapped = texture->Map(reinterpret_cast<void**>(&dst_ptr), &dst_stride, 0, 0, width, height);
+  const bool mapped = texture->Map(reinterpret_cast<void**>(&dst_ptr), &dst_stride, 0, dst_y, width, copy_height);
+
+  src_y += dst_y << line_skip;
 
   // Fast path when not wrapping around.
-  if ((src_x + width) <= VRAM_WIDTH && (src_y + height) <= VRAM_HEIGHT)
+  if ((src_x + width) <= VRAM_WIDTH && (src_y + (copy_height << line_skip)) <= VRAM_HEIGHT)
   {
     [[maybe_unused]] constexpr u32 pixels_per_vec = 8;
     [[maybe_unused]] const u32 aligned_width = Common::AlignDownPow2(width, pixels_per_vec);
@@ -248,7 +701,7 @@ ALWAYS_INLINE_RELEASE bool GPU_SW::CopyOut15Bit(u32 src_x, u32 src_y, u32 width,
     const u16* src_ptr = &g_vram[src_y * VRAM_WIDTH + src_x];
     const u32 src_step = VRAM_WIDTH << line_skip;
 
-    for (u32 row = 0; row < height; row++)
+    for (u32 row = 0; row < copy_height; row++)
     {
       const u16* src_row_ptr = src_ptr;
       u8* dst_row_ptr = dst_ptr;
@@ -273,7 +726,7 @@ ALWAYS_INLINE_RELEASE bool GPU_SW::CopyOut15Bit(u32 src_x, u32 src_y, u32 width,
   {
     const u32 end_x = src_x + width;
     const u32 y_step = (1 << line_skip);
-    for (u32 row = 0; row < height; row++)
+    for (u32 row = 0; row < copy_height; row++)
     {
       const u16* src_row_ptr = &g_vram[(src_y % VRAM_HEIGHT) * VRAM_WIDTH];
       u8* dst_row_ptr = dst_ptr;
@@ -289,12 +742,13 @@ ALWAYS_INLINE_RELEASE bool GPU_SW::CopyOut15Bit(u32 src_x, u32 src_y, u32 width,
   if (mapped)
     texture->Unmap();
   else
-    texture->Update(0, 0, width, height, m_upload_buffer.data(), dst_stride);
+    texture->Update(0, dst_y, width, copy_height, m_upload_buffer.data(), dst_stride);
 
   return true;
 }
 
-ALWAYS_INLINE_RELEASE bool GPU_SW::CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u32 line_skip)
+ALWAYS_INLINE_RELEASE bool GPU_SW::CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u32 line_skip,
+                                                u32 dst_y, u32 copy_height)
 {
   GPUTexture* texture = GetDisplayTexture(width, height, FORMAT_FOR_24BIT);
   if (!texture) [[unlikely]]
@@ -302,23 +756,30 @@ ALWAYS_INLINE_RELEASE bool GPU_SW::CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x
 
   u32 dst_stride = width * sizeof(u32);
   u8* dst_ptr = m_upload_buffer.data();
-  const bool mapped = texture->Map(reinterpret_cast<void**>(&dst_ptr), &dst_stride, 0, 0, width, height);
+  const bool mapped = texture->Map(reinterpret_cast<void**>(&dst_ptr), &dst_stride, 0, dst_y, width, copy_height);
+
+  src_y += dst_y << line_skip;
 
-  if ((src_x + width) <= VRAM_WIDTH && (src_y + (height << line_skip)) <= VRAM_HEIGHT)
+  if ((src_x + width) <= VRAM_WIDTH && (src_y + (copy_height << line_skip)) <= VRAM_HEIGHT)
   {
     const u8* src_ptr = reinterpret_cast<const u8*>(&g_vram[src_y * VRAM_WIDTH + src_x]) + (skip_x * 3);
     const u32 src_stride = (VRAM_WIDTH << line_skip) * sizeof(u16);
-    for (u32 row = 0; row < height; row++)
+    [[maybe_unused]] constexpr u32 pixels_per_vec = 4;
+
+    for (u32 row = 0; row < copy_height; row++)
     {
       const u8* src_row_ptr = src_ptr;
       u8* dst_row_ptr = reinterpret_cast<u8*>(dst_ptr);
-      for (u32 col = 0; col < width; col++)
-      {
-        *(dst_row_ptr++) = *(src_row_ptr++);
-        *(dst_row_ptr++) = *(src_row_ptr++);
-        *(dst_row_ptr++) = *(src_row_ptr++);
-        *(dst_row_ptr++) = 0xFF;
-      }
+      u32 col = 0;
+
+#ifdef CPU_ARCH_SIMD
+      // Vector loads over-read by four bytes, so stop while there's at least two pixels of slack left in the row.
+      for (; (col + pixels_per_vec + 2) <= width; col += pixels_per_vec)
+        ConvertVRAM24BitPixels(dst_row_ptr, src_row_ptr);
+#endif
+
+      for (; col < width; col++)
+        ConvertVRAM24BitPixel(dst_row_ptr, src_row_ptr);
 
       src_ptr += src_stride;
       dst_ptr += dst_stride;
@@ -328,7 +789,7 @@ ALWAYS_INLINE_RELEASE bool GPU_SW::CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x
   {
     const u32 y_step = (1 << line_skip);
 
-    for (u32 row = 0; row < height; row++)
+    for (u32 row = 0; row < copy_height; row++)
     {
       const u16* src_row_ptr = &g_vram[(src_y % VRAM_HEIGHT) * VRAM_WIDTH];
       u32* dst_row_ptr = reinterpret_cast<u32*>(dst_ptr);
@@ -352,12 +813,13 @@ ALWAYS_INLINE_RELEASE bool GPU_SW::CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x
   if (mapped)
     texture->Unmap();
   else
-    texture->Update(0, 0, width, height, m_upload_buffer.data(), dst_stride);
+    texture->Update(0, dst_y, width, copy_height, m_upload_buffer.data(), dst_stride);
 
   return true;
 }
 
-bool GPU_SW::CopyOut(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u32 line_skip, bool is_24bit)
+bool GPU_SW::CopyOut(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u32 line_skip, bool is_24bit,
+                     u32 dst_y, u32 copy_height)
 {
   if (!is_24bit)
   {
@@ -366,19 +828,19 @@ bool GPU_SW::CopyOut(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u3
     switch (m_16bit_display_format)
     {
       case GPUTextureFormat::RGB5A1:
-        return CopyOut15Bit<GPUTextureFormat::RGB5A1>(src_x, src_y, width, height, line_skip);
+        return CopyOut15Bit<GPUTextureFormat::RGB5A1>(src_x, src_y, width, height, line_skip, dst_y, copy_height);
 
       case GPUTextureFormat::A1BGR5:
-        return CopyOut15Bit<GPUTextureFormat::A1BGR5>(src_x, src_y, width, height, line_skip);
+        return CopyOut15Bit<GPUTextureFormat::A1BGR5>(src_x, src_y, width, height, line_skip, dst_y, copy_height);
 
       case GPUTextureFormat::RGB565:
-        return CopyOut15Bit<GPUTextureFormat::RGB565>(src_x, src_y, width, height, line_skip);
+        return CopyOut15Bit<GPUTextureFormat::RGB565>(src_x, src_y, width, height, line_skip, dst_y, copy_height);
 
       case GPUTextureFormat::RGBA8:
-        return CopyOut15Bit<GPUTextureFormat::RGBA8>(src_x, src_y, width, height, line_skip);
+        return CopyOut15Bit<GPUTextureFormat::RGBA8>(src_x, src_y, width, height, line_skip, dst_y, copy_height);
 
       case GPUTextureFormat::BGRA8:
-        return CopyOut15Bit<GPUTextureFormat::BGRA8>(src_x, src_y, width, height, line_skip);
+        return CopyOut15Bit<GPUTextureFormat::BGRA8>(src_x, src_y, width, height, line_skip, dst_y, copy_height);
 
       default:
         UnreachableCode();
@@ -386,12 +848,61 @@ bool GPU_SW::CopyOut(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u3
   }
   else
   {
-    return CopyOut24Bit(src_x, src_y, skip_x, width, height, line_skip);
+    return CopyOut24Bit(src_x, src_y, skip_x, width, height, line_skip, dst_y, copy_height);
+  }
+}
+
+bool GPU_SW::UpdateDisplayTexture(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u32 line_skip,
+                                  bool is_24bit)
+{
+  const DisplayCopyParams params = {.src_x = src_x,
+                                    .src_y = src_y,
+                                    .skip_x = skip_x,
+                                    .width = width,
+                                    .height = height,
+                                    .line_skip = line_skip,
+                                    .is_24bit = is_24bit};
+  const GPUTextureFormat format = is_24bit ? FORMAT_FOR_24BIT : m_16bit_display_format;
+  const bool can_skip_clean_lines = (params == m_last_display_copy && m_upload_texture &&
+                                     m_upload_texture->GetWidth() == width && m_upload_texture->GetHeight() == height &&
+                                     m_upload_texture->GetFormat() == format);
+
+  // Interlaced fields alternate src_y, so they always take the full path.
+  bool result;
+  if (!can_skip_clean_lines)
+  {
+    result = CopyOut(src_x, src_y, skip_x, width, height, line_skip, is_24bit, 0, height);
+  }
+  else
+  {
+    result = true;
+    for (u32 row = 0; row < height && result;)
+    {
+      if (!IsLineDirty((src_y + (row << line_skip)) % VRAM_HEIGHT))
+      {
+        row++;
+        continue;
+      }
+
+      const u32 start_row = row;
+      while (row < height && IsLineDirty((src_y + (row << line_skip)) % VRAM_HEIGHT))
+        row++;
+
+      GL_INS_FMT("Software scanout of dirty lines {}-{}", start_row, row - 1);
+      result = CopyOut(src_x, src_y, skip_x, width, height, line_skip, is_24bit, start_row, row - start_row);
+    }
   }
+
+  // Anything outside the display area changes params, which forces a full copy, so we can clear everything.
+  m_dirty_lines.fill(0);
+  m_last_display_copy = result ? params : DisplayCopyParams{};
+  return result;
 }
 
 void GPU_SW::UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd)
 {
+  WaitForBinWorkers();
+
   if (!g_gpu_settings.gpu_show_vram)
   {
     const u32 field = BoolToUInt32(cmd->interlaced_display_field);
@@ -418,7 +929,7 @@ void GPU_SW::UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd)
 
     if (cmd->interlaced_display_enabled)
     {
-      if (CopyOut(src_x, src_y, skip_x, width, height, line_skip, is_24bit))
+      if (UpdateDisplayTexture(src_x, src_y, skip_x, width, height, line_skip, is_24bit))
       {
         m_presenter.SetDisplayTexture(m_upload_texture.get(), GSVector4i::loadh(GSVector2i(width, height)));
         if (is_24bit && g_gpu_settings.display_24bit_chroma_smoothing)
@@ -434,7 +945,7 @@ void GPU_SW::UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd)
     }
     else
     {
-      if (CopyOut(src_x, src_y, skip_x, width, height, 0, is_24bit))
+      if (UpdateDisplayTexture(src_x, src_y, skip_x, width, height, 0, is_24bit))
       {
         m_presenter.SetDisplayTexture(m_upload_texture.get(), GSVector4i::loadh(GSVector2i(width, height)));
         if (is_24bit && g_gpu_settings.display_24bit_chroma_smoothing)
@@ -444,7 +955,7 @@ void GPU_SW::UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd)
   }
   else
   {
-    if (CopyOut(0, 0, 0, VRAM_WIDTH, VRAM_HEIGHT, 0, false))
+    if (UpdateDisplayTexture(0, 0, 0, VRAM_WIDTH, VRAM_HEIGHT, 0, false))
       m_presenter.SetDisplayTexture(m_upload_texture.get(), GSVector4i::cxpr(0, 0, VRAM_WIDTH, VRAM_HEIGHT));
   }
 }
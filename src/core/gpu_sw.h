@@ -5,12 +5,17 @@
 
 #include "gpu.h"
 #include "gpu_backend.h"
+#include "gpu_sw_rasterizer.h"
 
 #include "util/gpu_device.h"
 
 #include "common/heap_array.h"
+#include "common/threading.h"
 
+#include <atomic>
+#include <limits>
 #include <memory>
+#include <vector>
 
 // TODO: Move to cpp
 // TODO: Rename to GPUSWBackend, preserved to avoid conflicts.
@@ -21,6 +26,7 @@ public:
   ~GPU_SW() override;
 
   bool Initialize(bool upload_vram, Error* error) override;
+  bool UpdateSettings(const GPUSettings& old_settings, Error* error) override;
 
   void RestoreDeviceContext() override;
   void FlushRender() override;
@@ -39,6 +45,7 @@ public:
   void DrawPreciseLine(const GPUBackendDrawPreciseLineCommand* cmd) override;
   void DrawSprite(const GPUBackendDrawRectangleCommand* cmd) override;
   void DrawingAreaChanged() override;
+  void UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit) override;
   void ClearCache() override;
   void OnBufferSwapped() override;
 
@@ -54,16 +61,133 @@ public:
 private:
   static constexpr GPUTextureFormat FORMAT_FOR_24BIT = GPUTextureFormat::RGBA8; // RGBA8 always supported.
 
+  // Binned rendering splits VRAM into bands of rows, interleaved between the worker threads.
+  static constexpr u32 MAX_BIN_THREADS = 16;
+  static constexpr u32 BIN_BAND_HEIGHT = 16;
+  static constexpr u32 BIN_QUEUE_SIZE = 4096;
+  static constexpr u32 BIN_QUEUE_MASK = BIN_QUEUE_SIZE - 1;
+  static constexpr u32 BIN_CLUT_SNAPSHOTS = 64;
+  static constexpr GSVector4i INVALID_RECT =
+    GSVector4i::cxpr(std::numeric_limits<s32>::max(), std::numeric_limits<s32>::max(), std::numeric_limits<s32>::min(),
+                     std::numeric_limits<s32>::min());
+
+  enum class BinnedPrimitiveType : u8
+  {
+    Triangle,
+    Rectangle,
+    Line,
+  };
+
+  struct BinnedPrimitive
+  {
+    BinnedPrimitiveType type;
+    u8 clut_index;
+    s16 top;
+    s16 bottom;
+    GPUDrawingArea drawing_area;
+    union
+    {
+      GPU_SW_Rasterizer::DrawTriangleFunction triangle;
+      GPU_SW_Rasterizer::DrawRectangleFunction rectangle;
+      GPU_SW_Rasterizer::DrawLineFunction line;
+    } func;
+
+    // Only the GPUBackendDrawCommand part is used for triangles and lines.
+    GPUBackendDrawRectangleCommand cmd;
+    union
+    {
+      GPUBackendDrawPolygonCommand::Vertex triangle[3];
+      GPUBackendDrawLineCommand::Vertex line[2];
+    } vertices;
+  };
+
+  struct BinWorker
+  {
+    Threading::Thread thread;
+    Threading::KernelSemaphore wake_semaphore;
+    std::atomic<u32> read_pos{0};
+    std::atomic_bool sleeping{false};
+    std::atomic_bool signal_when_idle{false};
+    u32 index = 0;
+  };
+
+  ALWAYS_INLINE bool IsBinning() const { return (m_bin_num_workers > 0); }
+  bool CanBinPrimitive();
+  void StartBinWorkers(u32 count);
+  void StopBinWorkers();
+  void WaitForBinWorkers();
+  void UpdateBinMinReadPos();
+  void RefreshBinCLUTSnapshot();
+  void BinWorkerThread(BinWorker* worker);
+  void ExecuteBinnedPrimitive(const BinnedPrimitive& prim, u32 worker_index) const;
+  BinnedPrimitive* AllocateBinnedPrimitive(const GPUBackendDrawCommand* cmd, s32 top, s32 bottom);
+  void PushBinnedPrimitive();
+
+  void BinTriangle(const GPUBackendDrawCommand* cmd, GPU_SW_Rasterizer::DrawTriangleFunction func,
+                   const GPUBackendDrawPolygonCommand::Vertex* v0, const GPUBackendDrawPolygonCommand::Vertex* v1,
+                   const GPUBackendDrawPolygonCommand::Vertex* v2);
+  void BinLine(const GPUBackendDrawCommand* cmd, GPU_SW_Rasterizer::DrawLineFunction func,
+               const GPUBackendDrawLineCommand::Vertex* p0, const GPUBackendDrawLineCommand::Vertex* p1);
+
+  struct DisplayCopyParams
+  {
+    u32 src_x;
+    u32 src_y;
+    u32 skip_x;
+    u32 width;
+    u32 height;
+    u32 line_skip;
+    bool is_24bit;
+
+    bool operator==(const DisplayCopyParams&) const = default;
+  };
+
+  ALWAYS_INLINE bool IsLineDirty(u32 y) const { return ((m_dirty_lines[y / 64] >> (y % 64)) & 1) != 0; }
+  ALWAYS_INLINE void MarkAllLinesDirty() { m_dirty_lines.fill(~static_cast<u64>(0)); }
+  void MarkLinesDirty(u32 y, u32 height);
+  void MarkDrawDirty(s32 top, s32 bottom);
+  template<typename T>
+  void MarkVerticesDirty(const T* vertices, u32 num_vertices);
+
   template<GPUTextureFormat display_format>
-  bool CopyOut15Bit(u32 src_x, u32 src_y, u32 width, u32 height, u32 line_skip);
+  bool CopyOut15Bit(u32 src_x, u32 src_y, u32 width, u32 height, u32 line_skip, u32 dst_y, u32 copy_height);
+
+  bool CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u32 line_skip, u32 dst_y,
+                    u32 copy_height);
 
-  bool CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u32 line_skip);
+  bool CopyOut(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u32 line_skip, bool is_24bit, u32 dst_y,
+               u32 copy_height);
 
-  bool CopyOut(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u32 line_skip, bool is_24bit);
+  /// Only converts and uploads lines which have changed, if the display configuration is the same as last time.
+  bool UpdateDisplayTexture(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u32 line_skip, bool is_24bit);
 
   GPUTexture* GetDisplayTexture(u32 width, u32 height, GPUTextureFormat format);
 
   FixedHeapArray<u8, GPU_MAX_DISPLAY_WIDTH * GPU_MAX_DISPLAY_HEIGHT * sizeof(u32)> m_upload_buffer;
   GPUTextureFormat m_16bit_display_format = GPUTextureFormat::Unknown;
   std::unique_ptr<GPUTexture> m_upload_texture;
+
+  // One bit per VRAM line, set when written since the last display upload.
+  std::array<u64, VRAM_HEIGHT / 64> m_dirty_lines = {};
+  DisplayCopyParams m_last_display_copy = {};
+
+  std::vector<std::unique_ptr<BinWorker>> m_bin_workers;
+  u32 m_bin_num_workers = 0;
+  std::unique_ptr<BinnedPrimitive[]> m_bin_queue;
+  u32 m_bin_write_pos = 0;
+  u32 m_bin_min_read_pos = 0;
+  std::atomic<u32> m_bin_published_pos{0};
+  std::atomic_bool m_bin_shutdown{false};
+  Threading::KernelSemaphore m_bin_idle_semaphore;
+
+  // Union of the drawing areas written by primitives which may still be in flight.
+  GSVector4i m_bin_dirty_rect = INVALID_RECT;
+
+  // Union of the texture pages and palettes read by primitives which may still be in flight.
+  GSVector4i m_bin_read_rect = INVALID_RECT;
+
+  // Workers sample from a snapshot of the CLUT taken at queue time, since g_gpu_clut can change underneath them.
+  std::unique_ptr<std::array<u16, GPU_CLUT_SIZE>[]> m_bin_clut_snapshots;
+  std::array<u32, BIN_CLUT_SNAPSHOTS> m_bin_clut_snapshot_last_use = {};
+  u8 m_bin_clut_index = 0;
 };
@@ -36,7 +36,8 @@ const DrawLineFunctionTable* DrawLineFunctions = nullptr;
 FillVRAMFunction FillVRAM = nullptr;
 WriteVRAMFunction WriteVRAM = nullptr;
 CopyVRAMFunction CopyVRAM = nullptr;
-GPUDrawingArea g_drawing_area = {};
+constinit thread_local GPUDrawingArea g_drawing_area = {};
+constinit thread_local const u16* g_clut = g_gpu_clut;
 } // namespace GPU_SW_Rasterizer
 
 void GPU_SW_Rasterizer::UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit)
@@ -83,14 +84,8 @@ namespace {
 #endif
 
 // Declare alternative implementations.
-void GPU_SW_Rasterizer::SelectImplementation()
+bool GPU_SW_Rasterizer::SelectImplementation(const char* isa)
 {
-  static bool selected = false;
-  if (selected)
-    return;
-
-  selected = true;
-
 #define SELECT_IMPLEMENTATION(isa)                                                                                     \
   do                                                                                                                   \
   {                                                                                                                    \
@@ -104,27 +99,55 @@ void GPU_SW_Rasterizer::SelectImplementation()
   } while (0)
 
 #if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
-  const char* use_isa = std::getenv("SW_USE_ISA");
-
   // AVX2/256-bit path still has issues, and I need to make sure that it's not ODR'ing any shared
   // symbols on top of the base symbols.
 #if defined(CPU_ARCH_SSE) && defined(_MSC_VER) && 0
-  if (cpuinfo_has_x86_avx2() && (!use_isa || StringUtil::Strcasecmp(use_isa, "AVX2") == 0))
+  if (StringUtil::Strcasecmp(isa, "AVX2") == 0)
   {
+    if (!cpuinfo_has_x86_avx2())
+      return false;
+
     SELECT_IMPLEMENTATION(AVX2);
-    return;
+    return true;
   }
 #endif
 
-  if (!use_isa || StringUtil::Strcasecmp(use_isa, "SIMD") == 0)
+  if (StringUtil::Strcasecmp(isa, "SIMD") == 0)
   {
     SELECT_IMPLEMENTATION(SIMD);
-    return;
+    return true;
   }
 #endif
 
-  INFO_LOG("Using scalar software rasterizer implementation.");
-  SELECT_IMPLEMENTATION(Scalar);
+  if (StringUtil::Strcasecmp(isa, "Scalar") == 0)
+  {
+    SELECT_IMPLEMENTATION(Scalar);
+    return true;
+  }
+
+  return false;
 
 #undef SELECT_IMPLEMENTATION
 }
+
+void GPU_SW_Rasterizer::SelectImplementation()
+{
+  static bool selected = false;
+  if (selected)
+    return;
+
+  selected = true;
+
+  if (const char* use_isa = std::getenv("SW_USE_ISA"))
+  {
+    if (!SelectImplementation(use_isa))
+      SelectImplementation("Scalar");
+    return;
+  }
+
+  for (const char* isa : IMPLEMENTATION_NAMES)
+  {
+    if (SelectImplementation(isa))
+      return;
+  }
+}
@@ -28,7 +28,11 @@ using DitherLUT = std::array<std::array<std::array<u8, DITHER_LUT_SIZE>, DITHER_
 extern const DitherLUT g_dither_lut;
 
 // TODO: Pack in struct
-extern GPUDrawingArea g_drawing_area;
+// Per-thread so that binned worker threads can restrict drawing to their own band of VRAM.
+extern constinit thread_local GPUDrawingArea g_drawing_area;
+
+// CLUT used when sampling paletted textures. Points to g_gpu_clut unless a worker is using a snapshot.
+extern constinit thread_local const u16* g_clut;
 
 extern void UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit);
 
@@ -58,8 +62,15 @@ extern FillVRAMFunction FillVRAM;
 extern WriteVRAMFunction WriteVRAM;
 extern CopyVRAMFunction CopyVRAM;
 
+/// Implementations in order of preference. Not all of them are available on every build or CPU.
+inline constexpr std::array<const char*, 3> IMPLEMENTATION_NAMES = {{"AVX2", "SIMD", "Scalar"}};
+
+/// Picks the best implementation, or the one named by the SW_USE_ISA environment variable. Only runs once.
 extern void SelectImplementation();
 
+/// Switches to a specific implementation, returning false if it isn't available.
+extern bool SelectImplementation(const char* isa);
+
 ALWAYS_INLINE TextureModulationMode GetModulationMode(bool texture_enable, bool raw_texture_enable,
                                                       bool modulation_crop)
 {
@@ -100,7 +100,7 @@ template<TextureModulationMode modulation_mode, bool transparency_enable>
           GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 4)) % VRAM_WIDTH,
                    (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
         const size_t palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
-        texture_color = g_gpu_clut[palette_index];
+        texture_color = g_clut[palette_index];
       }
       break;
 
@@ -110,7 +110,7 @@ template<TextureModulationMode modulation_mode, bool transparency_enable>
           GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 2)) % VRAM_WIDTH,
                    (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
         const size_t palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
-        texture_color = g_gpu_clut[palette_index];
+        texture_color = g_clut[palette_index];
       }
       break;
 
@@ -292,6 +292,11 @@ static constexpr GSVector4i PIXELS_PER_VEC_VEC = GSVector4i::cxpr(4);
 static constexpr u32 PIXELS_PER_VEC = 4;
 #endif
 
+// 4-bit palettes fit in a pair of byte tables, so they can be looked up with pshufb/tbl instead of scalar loads.
+#if defined(GSVECTOR_HAS_SRLV) && (defined(CPU_ARCH_SSE41) || defined(CPU_ARCH_NEON))
+#define USE_CLUT4_TABLE_LOOKUP 1
+#endif
+
 #ifdef GSVECTOR_HAS_256
 
 ALWAYS_INLINE_RELEASE static GSVector8i GatherVector(GSVector8i coord_x, GSVector8i coord_y)
@@ -312,14 +317,14 @@ template<u32 mask>
 ALWAYS_INLINE_RELEASE static GSVector8i GatherCLUTVector(GSVector8i indices, GSVector8i shifts)
 {
   const GSVector8i offsets = indices.srlv32(shifts) & GSVector8i::cxpr(mask);
-  GSVector8i pixels = GSVector8i::zext32(g_gpu_clut[static_cast<u32>(offsets.extract32<0>())]);
-  pixels = pixels.insert16<2>(g_gpu_clut[static_cast<u32>(offsets.extract32<1>())]);
-  pixels = pixels.insert16<4>(g_gpu_clut[static_cast<u32>(offsets.extract32<2>())]);
-  pixels = pixels.insert16<6>(g_gpu_clut[static_cast<u32>(offsets.extract32<3>())]);
-  pixels = pixels.insert16<8>(g_gpu_clut[static_cast<u32>(offsets.extract32<4>())]);
-  pixels = pixels.insert16<10>(g_gpu_clut[static_cast<u32>(offsets.extract32<5>())]);
-  pixels = pixels.insert16<12>(g_gpu_clut[static_cast<u32>(offsets.extract32<6>())]);
-  pixels = pixels.insert16<14>(g_gpu_clut[static_cast<u32>(offsets.extract32<7>())]);
+  GSVector8i pixels = GSVector8i::zext32(g_clut[static_cast<u32>(offsets.extract32<0>())]);
+  pixels = pixels.insert16<2>(g_clut[static_cast<u32>(offsets.extract32<1>())]);
+  pixels = pixels.insert16<4>(g_clut[static_cast<u32>(offsets.extract32<2>())]);
+  pixels = pixels.insert16<6>(g_clut[static_cast<u32>(offsets.extract32<3>())]);
+  pixels = pixels.insert16<8>(g_clut[static_cast<u32>(offsets.extract32<4>())]);
+  pixels = pixels.insert16<10>(g_clut[static_cast<u32>(offsets.extract32<5>())]);
+  pixels = pixels.insert16<12>(g_clut[static_cast<u32>(offsets.extract32<6>())]);
+  pixels = pixels.insert16<14>(g_clut[static_cast<u32>(offsets.extract32<7>())]);
   return pixels;
 }
 
@@ -391,10 +396,10 @@ ALWAYS_INLINE_RELEASE static GSVector4i GatherCLUTVector(GSVector4i indices, GSV
 #ifdef GSVECTOR_HAS_SRLV
   // On everywhere except RISC-V, we can do the shl 1 (* 2) as part of the load instruction.
   const GSVector4i offsets = indices.srlv32(shifts) & GSVector4i::cxpr(mask);
-  GSVector4i pixels = GSVector4i::zext32(g_gpu_clut[static_cast<u32>(offsets.extract32<0>())]);
-  pixels = pixels.insert16<2>(g_gpu_clut[static_cast<u32>(offsets.extract32<1>())]);
-  pixels = pixels.insert16<4>(g_gpu_clut[static_cast<u32>(offsets.extract32<2>())]);
-  pixels = pixels.insert16<6>(g_gpu_clut[static_cast<u32>(offsets.extract32<3>())]);
+  GSVector4i pixels = GSVector4i::zext32(g_clut[static_cast<u32>(offsets.extract32<0>())]);
+  pixels = pixels.insert16<2>(g_clut[static_cast<u32>(offsets.extract32<1>())]);
+  pixels = pixels.insert16<4>(g_clut[static_cast<u32>(offsets.extract32<2>())]);
+  pixels = pixels.insert16<6>(g_clut[static_cast<u32>(offsets.extract32<3>())]);
   return pixels;
 #else
   // Without variable shifts, it's probably quicker to do it without vectors.
@@ -404,10 +409,10 @@ ALWAYS_INLINE_RELEASE static GSVector4i GatherCLUTVector(GSVector4i indices, GSV
   GSVector4i::store<true>(indices_array, indices);
   GSVector4i::store<true>(shifts_array, shifts);
 
-  GSVector4i pixels = GSVector4i::zext32(g_gpu_clut[((indices_array[0] >> shifts_array[0]) & mask)]);
-  pixels = pixels.insert16<2>(g_gpu_clut[((indices_array[1] >> shifts_array[1]) & mask)]);
-  pixels = pixels.insert16<4>(g_gpu_clut[((indices_array[2] >> shifts_array[2]) & mask)]);
-  pixels = pixels.insert16<6>(g_gpu_clut[((indices_array[3] >> shifts_array[3]) & mask)]);
+  GSVector4i pixels = GSVector4i::zext32(g_clut[((indices_array[0] >> shifts_array[0]) & mask)]);
+  pixels = pixels.insert16<2>(g_clut[((indices_array[1] >> shifts_array[1]) & mask)]);
+  pixels = pixels.insert16<4>(g_clut[((indices_array[2] >> shifts_array[2]) & mask)]);
+  pixels = pixels.insert16<6>(g_clut[((indices_array[3] >> shifts_array[3]) & mask)]);
   return pixels;
 #endif
 }
@@ -500,6 +505,12 @@ struct PixelVectors
   NO_UNIQUE_ADDRESS typename std::conditional_t<texture_enable, GSVectorNi, UnusedField> texture_base_x;
   NO_UNIQUE_ADDRESS typename std::conditional_t<texture_enable, GSVectorNi, UnusedField> texture_base_y;
 
+#ifdef USE_CLUT4_TABLE_LOOKUP
+  // Low and high bytes of the 16 palette entries, only valid in 4-bit mode.
+  NO_UNIQUE_ADDRESS typename std::conditional_t<texture_enable, GSVectorNi, UnusedField> clut4_low;
+  NO_UNIQUE_ADDRESS typename std::conditional_t<texture_enable, GSVectorNi, UnusedField> clut4_high;
+#endif
+
   PixelVectors(const GPUBackendDrawCommand* cmd)
   {
     clip_left = GSVectorNi(g_drawing_area.left);
@@ -516,11 +527,36 @@ struct PixelVectors
       texture_window_or_y = GSVectorNi(cmd->window.or_y);
       texture_base_x = GSVectorNi(cmd->draw_mode.GetTexturePageBaseX());
       texture_base_y = GSVectorNi(cmd->draw_mode.GetTexturePageBaseY());
+
+#ifdef USE_CLUT4_TABLE_LOOKUP
+      if (cmd->draw_mode.texture_mode == GPUTextureMode::Palette4Bit)
+      {
+        const GSVector4i entries_0_7 = GSVector4i::load<false>(&g_clut[0]);
+        const GSVector4i entries_8_15 = GSVector4i::load<false>(&g_clut[8]);
+        clut4_low = GSVectorNi::broadcast128(
+          (entries_0_7 & GSVector4i::cxpr16(0xFF)).pu16(entries_8_15 & GSVector4i::cxpr16(0xFF)));
+        clut4_high = GSVectorNi::broadcast128(entries_0_7.srl16<8>().pu16(entries_8_15.srl16<8>()));
+      }
+#endif
     }
   }
 };
 } // namespace
 
+#ifdef USE_CLUT4_TABLE_LOOKUP
+
+ALWAYS_INLINE_RELEASE static GSVectorNi LookupCLUT4Vector(const PixelVectors<true>& RESTRICT pv, GSVectorNi indices,
+                                                          GSVectorNi shifts)
+{
+  // Out-of-range (0x80) indices produce zero, so each lookup fills one byte of the 32-bit lane.
+  const GSVectorNi offsets = indices.srlv32(shifts) & GSVectorNi::cxpr(0x0F);
+  const GSVectorNi low = pv.clut4_low.shuffle8(offsets | GSVectorNi::cxpr(static_cast<s32>(0x80808000u)));
+  const GSVectorNi high = pv.clut4_high.shuffle8(offsets.sll32<8>() | GSVectorNi::cxpr(static_cast<s32>(0x80800080u)));
+  return low | high;
+}
+
+#endif
+
 template<TextureModulationMode modulation_mode, bool transparency_enable>
 ALWAYS_INLINE_RELEASE static void
 ShadePixel(const PixelVectors<modulation_mode != TextureModulationMode::Disabled>& RESTRICT pv,
@@ -554,7 +590,11 @@ ShadePixel(const PixelVectors<modulation_mode != TextureModulationMode::Disabled
 
         const GSVectorNi palette_shift = (texcoord_x & GSVectorNi::cxpr(3)).sll32<2>();
         const GSVectorNi palette_indices = GatherVector(load_texcoord_x, texcoord_y);
+#ifdef USE_CLUT4_TABLE_LOOKUP
+        texture_color = LookupCLUT4Vector(pv, palette_indices, palette_shift);
+#else
         texture_color = GatherCLUTVector<0x0F>(palette_indices, palette_shift);
+#endif
       }
       break;
 
@@ -1523,6 +1563,7 @@ static void DrawTriangle(const GPUBackendDrawCommand* RESTRICT cmd,
 
 #undef ATTRIB_STEP
 #undef ATTRIB_DETERMINANT
+#undef USE_CLUT4_TABLE_LOOKUP
 
   // Undo the start of the vertex, so that when we add the offset for each line, it starts at the beginning value.
   UVStepper uv;
@@ -26,7 +26,9 @@
 
 #include "common/align.h"
 #include "common/error.h"
+#include "common/event_trace.h"
 #include "common/log.h"
+#include "common/path.h"
 #include "common/threading.h"
 #include "common/timer.h"
 
@@ -35,7 +37,9 @@
 #include "fmt/format.h"
 #include "imgui.h"
 
+#include <array>
 #include <optional>
+#include <thread>
 
 LOG_CHANNEL(GPUThread);
 
@@ -56,8 +60,29 @@ static constexpr u32 THREAD_SPIN_TIME_US = 50;
 static constexpr u32 THREAD_SPIN_TIME_US = 200;
 #endif
 
+// The spin window adapts to recent sync completion times, between these bounds.
+static constexpr u32 THREAD_MIN_SPIN_TIME_US = 5;
+static constexpr Timer::Value SYNC_COMPLETION_AVERAGE_WEIGHT = 8;
+static constexpr u32 SYNC_YIELD_COUNT = 4;
+
 static constexpr u32 MAX_SKIPPED_PRESENT_COUNT = 50;
+static constexpr u32 MAX_RENDER_SKIPPED_FRAME_COUNT = 10;
+
+/// When idle without a game, unchanged UI frames aren't presented, but it's still refreshed at least this often.
+static constexpr float IDLE_UI_REFRESH_INTERVAL = 0.25f;
+
+// VRAM is split into 64x64 tiles for readback fences.
+static constexpr u32 VRAM_FENCE_TILE_SHIFT = 6;
+static constexpr u32 VRAM_FENCE_TILES_X = VRAM_WIDTH >> VRAM_FENCE_TILE_SHIFT;
+static constexpr u32 VRAM_FENCE_TILES_Y = VRAM_HEIGHT >> VRAM_FENCE_TILE_SHIFT;
+
+// CPU->VRAM transfers up to this size are held back, so that following transfers which continue them can be merged.
+static constexpr u32 MAX_COALESCED_VRAM_WRITE_WORDS = 4096;
+static constexpr u32 MAX_PENDING_VRAM_WRITE_WORDS = 64 * 1024;
 
+static void QueueReconfigure(std::optional<GPURenderer> renderer, bool upload_vram, std::optional<bool> fullscreen,
+                             std::optional<bool> start_fullscreen_ui, bool recreate_device, bool* out_result,
+                             Error* error);
 static bool Reconfigure(std::optional<GPURenderer> renderer, bool upload_vram, std::optional<bool> fullscreen,
                         std::optional<bool> start_fullscreen_ui, bool recreate_device, Error* error);
 
@@ -72,6 +97,13 @@ static void ResetCommandFIFO();
 static bool IsCommandFIFOEmpty();
 static void WakeGPUThread();
 static void WakeGPUThreadIfSleeping();
+static bool IsGPUThreadDoneOrWake();
+static void UpdateSyncSpinWindow(Timer::Value completion_time);
+static void TrackCommandVRAMWrites(const GPUThreadCommand* cmd);
+static void MarkVRAMTilesWritten(u32 x, u32 y, u32 width, u32 height, u64 fence);
+static void FlushDrawingAreaFence();
+static void FlushPendingVRAMWrite();
+static u64 GetVRAMRegionFence(u32 x, u32 y, u32 width, u32 height);
 static bool SleepGPUThread(bool allow_sleep);
 
 static bool CreateDeviceOnThread(RenderAPI api, bool fullscreen, bool preserve_fsui_state, Error* error);
@@ -81,6 +113,8 @@ static void UpdateDisplayWindowOnThread(bool fullscreen, bool allow_exclusive_fu
 static void DisplayWindowResizedOnThread();
 static bool CheckExclusiveFullscreenOnThread();
 static void ThrottlePresentation();
+static bool IsPresentSkipActive();
+static float GetPresentThrottlePeriod();
 
 static void ReconfigureOnThread(GPUThreadReconfigureCommand* cmd);
 static bool CreateGPUBackendOnThread(GPURenderer renderer, bool upload_vram, Error* error);
@@ -101,6 +135,9 @@ struct ALIGN_TO_CACHE_LINE State
 {
   // Owned by CPU thread.
   Timer::Value thread_spin_time = 0;
+  Timer::Value thread_min_spin_time = 0;
+  Timer::Value thread_max_spin_time = 0;
+  Timer::Value sync_average_completion_time = 0;
   Threading::ThreadHandle gpu_thread;
   Common::unique_aligned_ptr<u8[]> command_fifo_data;
   WindowInfo render_window_info;
@@ -108,23 +145,46 @@ struct ALIGN_TO_CACHE_LINE State
   bool use_gpu_thread = false;
   bool requested_fullscreen = false;
 
+  // Sequence number of the last command pushed, and of the last command that wrote to each VRAM tile.
+  // Draws only record their fence against the drawing area, which is folded into the tiles when it changes.
+  u64 command_fence = 0;
+  u64 drawing_area_fence = 0;
+  GPUDrawingArea fence_drawing_area = {0, 0, VRAM_WIDTH - 1, VRAM_HEIGHT - 1};
+  std::array<u64, VRAM_FENCE_TILES_X * VRAM_FENCE_TILES_Y> vram_tile_fences = {};
+
+  // VRAM write which has been allocated at the write pointer, but not pushed yet.
+  GPUBackendUpdateVRAMCommand* pending_vram_write = nullptr;
+
   // Hot variables between both threads.
   ALIGN_TO_CACHE_LINE std::atomic<u32> command_fifo_write_ptr{0};
   std::atomic<s32> thread_wake_count{0}; // <0 = sleeping, >= 0 = has work
   Threading::KernelSemaphore thread_wake_semaphore;
   Threading::KernelSemaphore thread_is_done_semaphore;
+  std::atomic<Timer::Value> thread_done_post_time{0};
+  std::atomic<Timer::Value> max_frame_latency{0};
+
+  // Sync statistics, written by CPU thread, consumed by performance counters on the GPU thread.
+  std::atomic<Timer::Value> sync_stats_spin_window{0};
+  std::atomic<Timer::Value> sync_stats_wake_latency_total{0};
+  std::atomic<Timer::Value> sync_stats_wake_latency_max{0};
+  std::atomic<u32> sync_stats_spin_count{0};
+  std::atomic<u32> sync_stats_yield_count{0};
+  std::atomic<u32> sync_stats_sleep_count{0};
 
   // Owned by GPU thread.
   ALIGN_TO_CACHE_LINE Common::unique_aligned_ptr<GPUBackend> gpu_backend;
   std::unique_ptr<GPUPresenter> gpu_presenter;
   std::atomic<u32> command_fifo_read_ptr{0};
+  std::atomic<u64> completed_command_fence{0};
   u8 run_idle_reasons = 0;
   bool run_idle_flag = false;
   GPUVSyncMode requested_vsync = GPUVSyncMode::Disabled;
   PresentSkipMode requested_present_skip = PresentSkipMode::Disabled;
   bool requested_fullscreen_ui = false;
   u8 skipped_present_count = 0;
+  u8 render_skipped_frame_count = 0;
   u64 last_present_time = 0;
+  u64 last_frame_done_time = 0;
   u64 next_throttle_time = 0;
   std::string game_title;
   std::string game_serial;
@@ -153,7 +213,11 @@ void GPUThread::ResetCommandFIFO()
 
 void GPUThread::Internal::ProcessStartup()
 {
-  s_state.thread_spin_time = Timer::ConvertNanosecondsToValue(THREAD_SPIN_TIME_US * 1000.0);
+  s_state.thread_max_spin_time = Timer::ConvertNanosecondsToValue(THREAD_SPIN_TIME_US * 1000.0);
+  s_state.thread_min_spin_time = Timer::ConvertNanosecondsToValue(THREAD_MIN_SPIN_TIME_US * 1000.0);
+  s_state.thread_spin_time = s_state.thread_max_spin_time;
+  s_state.sync_average_completion_time = s_state.thread_max_spin_time / 2;
+  s_state.sync_stats_spin_window.store(s_state.thread_spin_time, std::memory_order_relaxed);
   s_state.command_fifo_data = Common::make_unique_aligned_for_overwrite<u8[]>(HOST_CACHE_LINE_SIZE, COMMAND_QUEUE_SIZE);
   s_state.use_gpu_thread = g_settings.gpu_use_thread;
   s_state.run_idle_reasons = static_cast<u8>(RunIdleReason::NoGPUBackend);
@@ -171,6 +235,10 @@ void GPUThread::Internal::RequestShutdown()
 
 GPUThreadCommand* GPUThread::AllocateCommand(GPUBackendCommandType command, u32 size)
 {
+  // Anything else that's queued could depend on the pending write, and would overwrite it in the FIFO.
+  if (s_state.pending_vram_write) [[unlikely]]
+    FlushPendingVRAMWrite();
+
   size = GPUThreadCommand::AlignCommandSize(size);
 
   for (;;)
@@ -264,6 +332,8 @@ void GPUThread::PushCommand(GPUThreadCommand* cmd)
     return;
   }
 
+  TrackCommandVRAMWrites(cmd);
+
   const u32 new_write_ptr = s_state.command_fifo_write_ptr.fetch_add(cmd->size, std::memory_order_release) + cmd->size;
   DebugAssert(new_write_ptr <= COMMAND_QUEUE_SIZE);
   UNREFERENCED_VARIABLE(new_write_ptr);
@@ -280,6 +350,8 @@ void GPUThread::PushCommandAndWakeThread(GPUThreadCommand* cmd)
     return;
   }
 
+  TrackCommandVRAMWrites(cmd);
+
   const u32 new_write_ptr = s_state.command_fifo_write_ptr.fetch_add(cmd->size, std::memory_order_release) + cmd->size;
   DebugAssert(new_write_ptr <= COMMAND_QUEUE_SIZE);
   UNREFERENCED_VARIABLE(new_write_ptr);
@@ -295,6 +367,8 @@ void GPUThread::PushCommandAndSync(GPUThreadCommand* cmd, bool spin)
     return;
   }
 
+  TrackCommandVRAMWrites(cmd);
+
   const u32 new_write_ptr = s_state.command_fifo_write_ptr.fetch_add(cmd->size, std::memory_order_release) + cmd->size;
   DebugAssert(new_write_ptr <= COMMAND_QUEUE_SIZE);
   UNREFERENCED_VARIABLE(new_write_ptr);
@@ -326,34 +400,58 @@ ALWAYS_INLINE_RELEASE void GPUThread::WakeGPUThreadIfSleeping()
   }
 }
 
+ALWAYS_INLINE_RELEASE bool GPUThread::IsGPUThreadDoneOrWake()
+{
+  // Check if the GPU thread is done/sleeping.
+  if (GetThreadWakeCount(s_state.thread_wake_count.load(std::memory_order_acquire)) < 0)
+  {
+    if (IsCommandFIFOEmpty())
+      return true;
+
+    WakeGPUThread();
+  }
+
+  return false;
+}
+
+void GPUThread::UpdateSyncSpinWindow(Timer::Value completion_time)
+{
+  // Exponential moving average of recent completion times. Spinning only helps if the GPU thread typically finishes
+  // within the spin window, so if it usually takes longer than the maximum, drop down to the minimum and sleep sooner.
+  s_state.sync_average_completion_time =
+    (s_state.sync_average_completion_time * (SYNC_COMPLETION_AVERAGE_WEIGHT - 1) + completion_time) /
+    SYNC_COMPLETION_AVERAGE_WEIGHT;
+
+  const Timer::Value window = s_state.sync_average_completion_time + (s_state.sync_average_completion_time / 2);
+  s_state.thread_spin_time = (window > s_state.thread_max_spin_time) ?
+                               s_state.thread_min_spin_time :
+                               std::max(window, s_state.thread_min_spin_time);
+  s_state.sync_stats_spin_window.store(s_state.thread_spin_time, std::memory_order_relaxed);
+}
+
 void GPUThread::SyncGPUThread(bool spin)
 {
   if (!s_state.use_gpu_thread)
     return;
 
+  if (s_state.pending_vram_write)
+    FlushPendingVRAMWrite();
+
+  EventTrace::ScopedSpan span("Sync GPU Thread");
+  const Timer::Value start_time = Timer::GetCurrentValue();
   if (spin)
   {
-    // Check if the GPU thread is done/sleeping.
-    if (GetThreadWakeCount(s_state.thread_wake_count.load(std::memory_order_acquire)) < 0)
-    {
-      if (IsCommandFIFOEmpty())
-        return;
-
-      WakeGPUThread();
-    }
+    if (IsGPUThreadDoneOrWake())
+      return;
 
-    const Timer::Value start_time = Timer::GetCurrentValue();
     Timer::Value current_time = start_time;
     do
     {
-      // Check if the GPU thread is done/sleeping.
-      if (GetThreadWakeCount(s_state.thread_wake_count.load(std::memory_order_acquire)) < 0)
+      if (IsGPUThreadDoneOrWake())
       {
-        if (IsCommandFIFOEmpty())
-          return;
-
-        WakeGPUThread();
-        continue;
+        UpdateSyncSpinWindow(Timer::GetCurrentValue() - start_time);
+        s_state.sync_stats_spin_count.fetch_add(1, std::memory_order_relaxed);
+        return;
       }
 
       // Hopefully ought to be enough.
@@ -361,6 +459,18 @@ void GPUThread::SyncGPUThread(bool spin)
 
       current_time = Timer::GetCurrentValue();
     } while ((current_time - start_time) < s_state.thread_spin_time);
+
+    // Give up the rest of our timeslice a few times before going to sleep, in case the GPU thread is close to done.
+    for (u32 i = 0; i < SYNC_YIELD_COUNT; i++)
+    {
+      std::this_thread::yield();
+      if (IsGPUThreadDoneOrWake())
+      {
+        UpdateSyncSpinWindow(Timer::GetCurrentValue() - start_time);
+        s_state.sync_stats_yield_count.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+    }
   }
 
   // s_thread_wake_count |= THREAD_WAKE_COUNT_CPU_THREAD_IS_WAITING if not zero
@@ -380,6 +490,268 @@ void GPUThread::SyncGPUThread(bool spin)
   } while (!s_state.thread_wake_count.compare_exchange_weak(value, value | THREAD_WAKE_COUNT_CPU_THREAD_IS_WAITING,
                                                             std::memory_order_acq_rel, std::memory_order_relaxed));
   s_state.thread_is_done_semaphore.Wait();
+
+  // Time between the GPU thread signalling us and actually getting scheduled again.
+  const Timer::Value wake_time = Timer::GetCurrentValue();
+  const Timer::Value wake_latency = wake_time - s_state.thread_done_post_time.load(std::memory_order_acquire);
+  s_state.sync_stats_sleep_count.fetch_add(1, std::memory_order_relaxed);
+  s_state.sync_stats_wake_latency_total.fetch_add(wake_latency, std::memory_order_relaxed);
+  if (wake_latency > s_state.sync_stats_wake_latency_max.load(std::memory_order_relaxed))
+    s_state.sync_stats_wake_latency_max.store(wake_latency, std::memory_order_relaxed);
+  if (spin)
+    UpdateSyncSpinWindow(wake_time - start_time);
+}
+
+void GPUThread::TrackCommandVRAMWrites(const GPUThreadCommand* cmd)
+{
+  const u64 fence = ++s_state.command_fence;
+  switch (cmd->type)
+  {
+    case GPUBackendCommandType::FillVRAM:
+    {
+      const GPUBackendFillVRAMCommand* ccmd = static_cast<const GPUBackendFillVRAMCommand*>(cmd);
+      MarkVRAMTilesWritten(ccmd->x, ccmd->y, ccmd->width, ccmd->height, fence);
+    }
+    break;
+
+    case GPUBackendCommandType::UpdateVRAM:
+    {
+      const GPUBackendUpdateVRAMCommand* ccmd = static_cast<const GPUBackendUpdateVRAMCommand*>(cmd);
+      MarkVRAMTilesWritten(ccmd->x, ccmd->y, ccmd->width, ccmd->height, fence);
+    }
+    break;
+
+    case GPUBackendCommandType::CopyVRAM:
+    {
+      const GPUBackendCopyVRAMCommand* ccmd = static_cast<const GPUBackendCopyVRAMCommand*>(cmd);
+      MarkVRAMTilesWritten(ccmd->dst_x, ccmd->dst_y, ccmd->width, ccmd->height, fence);
+    }
+    break;
+
+    case GPUBackendCommandType::SetDrawingArea:
+    {
+      FlushDrawingAreaFence();
+      s_state.fence_drawing_area = static_cast<const GPUBackendSetDrawingAreaCommand*>(cmd)->new_area;
+    }
+    break;
+
+    case GPUBackendCommandType::DrawPolygon:
+    case GPUBackendCommandType::DrawPrecisePolygon:
+    case GPUBackendCommandType::DrawRectangle:
+    case GPUBackendCommandType::DrawLine:
+    case GPUBackendCommandType::DrawPreciseLine:
+      s_state.drawing_area_fence = fence;
+      break;
+
+    case GPUBackendCommandType::Shutdown:
+    case GPUBackendCommandType::UpdateGameInfo:
+    case GPUBackendCommandType::ClearDisplay:
+    case GPUBackendCommandType::UpdateDisplay:
+    case GPUBackendCommandType::SubmitFrame:
+    case GPUBackendCommandType::BufferSwapped:
+    case GPUBackendCommandType::SaveMemoryState:
+    case GPUBackendCommandType::ReadVRAM:
+    case GPUBackendCommandType::UpdateCLUT:
+    case GPUBackendCommandType::ClearCache:
+      break;
+
+    default:
+    {
+      // State loads, renderer switches and async calls can replace anything, including the drawing area.
+      s_state.vram_tile_fences.fill(fence);
+      s_state.drawing_area_fence = 0;
+      s_state.fence_drawing_area = {0, 0, VRAM_WIDTH - 1, VRAM_HEIGHT - 1};
+    }
+    break;
+  }
+}
+
+void GPUThread::MarkVRAMTilesWritten(u32 x, u32 y, u32 width, u32 height, u64 fence)
+{
+  if (width == 0 || height == 0)
+    return;
+
+  // Writes wrap around the edges of VRAM.
+  const u32 start_tx = (x % VRAM_WIDTH) >> VRAM_FENCE_TILE_SHIFT;
+  const u32 start_ty = (y % VRAM_HEIGHT) >> VRAM_FENCE_TILE_SHIFT;
+  const u32 count_x = std::min<u32>(
+    (((x % VRAM_WIDTH) + width - 1) >> VRAM_FENCE_TILE_SHIFT) - start_tx + 1, VRAM_FENCE_TILES_X);
+  const u32 count_y = std::min<u32>(
+    (((y % VRAM_HEIGHT) + height - 1) >> VRAM_FENCE_TILE_SHIFT) - start_ty + 1, VRAM_FENCE_TILES_Y);
+  for (u32 ty = 0; ty < count_y; ty++)
+  {
+    u64* const row = &s_state.vram_tile_fences[((start_ty + ty) % VRAM_FENCE_TILES_Y) * VRAM_FENCE_TILES_X];
+    for (u32 tx = 0; tx < count_x; tx++)
+      row[(start_tx + tx) % VRAM_FENCE_TILES_X] = fence;
+  }
+}
+
+void GPUThread::FlushDrawingAreaFence()
+{
+  if (s_state.drawing_area_fence == 0)
+    return;
+
+  const GPUDrawingArea& area = s_state.fence_drawing_area;
+  if (area.right >= area.left && area.bottom >= area.top)
+  {
+    MarkVRAMTilesWritten(area.left, area.top, area.right - area.left + 1, area.bottom - area.top + 1,
+                         s_state.drawing_area_fence);
+  }
+
+  s_state.drawing_area_fence = 0;
+}
+
+u64 GPUThread::GetVRAMRegionFence(u32 x, u32 y, u32 width, u32 height)
+{
+  FlushDrawingAreaFence();
+
+  const u32 start_tx = x >> VRAM_FENCE_TILE_SHIFT;
+  const u32 start_ty = y >> VRAM_FENCE_TILE_SHIFT;
+  const u32 end_tx = std::min<u32>((x + width - 1) >> VRAM_FENCE_TILE_SHIFT, VRAM_FENCE_TILES_X - 1);
+  const u32 end_ty = std::min<u32>((y + height - 1) >> VRAM_FENCE_TILE_SHIFT, VRAM_FENCE_TILES_Y - 1);
+
+  u64 fence = 0;
+  for (u32 ty = start_ty; ty <= end_ty; ty++)
+  {
+    for (u32 tx = start_tx; tx <= end_tx; tx++)
+      fence = std::max(fence, s_state.vram_tile_fences[ty * VRAM_FENCE_TILES_X + tx]);
+  }
+
+  return fence;
+}
+
+void GPUThread::SyncGPUThreadForVRAMRead(u32 x, u32 y, u32 width, u32 height)
+{
+  if (!s_state.use_gpu_thread || width == 0 || height == 0)
+    return;
+
+  if (s_state.pending_vram_write)
+    FlushPendingVRAMWrite();
+
+  // Wrapped reads are rare enough to not be worth splitting.
+  if ((x + width) > VRAM_WIDTH || (y + height) > VRAM_HEIGHT)
+  {
+    x = 0;
+    y = 0;
+    width = VRAM_WIDTH;
+    height = VRAM_HEIGHT;
+  }
+
+  const u64 fence = GetVRAMRegionFence(x, y, width, height);
+  if (s_state.completed_command_fence.load(std::memory_order_acquire) >= fence)
+    return;
+
+  // Spin until the last command touching the region has executed. The GPU thread only signals the semaphore once the
+  // whole queue is empty, so if it takes longer than the spin window, fall back to a regular sync.
+  const Timer::Value start_time = Timer::GetCurrentValue();
+  do
+  {
+    WakeGPUThreadIfSleeping();
+    MultiPause();
+
+    if (s_state.completed_command_fence.load(std::memory_order_acquire) >= fence)
+      return;
+  } while ((Timer::GetCurrentValue() - start_time) < s_state.thread_spin_time);
+
+  SyncGPUThread(false);
+}
+
+bool GPUThread::AppendToPendingVRAMWrite(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask,
+                                         bool check_mask)
+{
+  GPUBackendUpdateVRAMCommand* const cmd = s_state.pending_vram_write;
+  if (!cmd || cmd->set_mask_while_drawing != set_mask || cmd->check_mask_before_draw != check_mask)
+    return false;
+
+  const u32 num_words = width * height;
+  const u32 pending_words = ZeroExtend32(cmd->width) * ZeroExtend32(cmd->height);
+  u32 new_width = cmd->width;
+  u32 new_height = cmd->height;
+  if (x == cmd->x && y == cmd->y && width == cmd->width && height == cmd->height && !check_mask)
+  {
+    // Same area written again, e.g. a CLUT being re-uploaded, so the previous data is dead.
+    std::memcpy(cmd->data, data, num_words * sizeof(u16));
+    return true;
+  }
+  else if (x == cmd->x && width == cmd->width && y == (ZeroExtend32(cmd->y) + cmd->height) &&
+           (y + height) <= VRAM_HEIGHT)
+  {
+    // Continues below, rows are contiguous.
+    new_height += height;
+  }
+  else if (height == 1 && cmd->height == 1 && y == cmd->y && x == (ZeroExtend32(cmd->x) + cmd->width) &&
+           (x + width) <= VRAM_WIDTH)
+  {
+    // Continues to the right on the same line.
+    new_width += width;
+  }
+  else
+  {
+    return false;
+  }
+
+  const u32 total_words = pending_words + num_words;
+  if (total_words > MAX_PENDING_VRAM_WRITE_WORDS)
+    return false;
+
+  // The command is at the write pointer, so it can grow into the free space after it.
+  const u32 new_size =
+    GPUThreadCommand::AlignCommandSize(sizeof(GPUBackendUpdateVRAMCommand) + (total_words * sizeof(u16)));
+  if (new_size > cmd->size)
+  {
+    const u32 read_ptr = s_state.command_fifo_read_ptr.load(std::memory_order_acquire);
+    const u32 write_ptr = s_state.command_fifo_write_ptr.load(std::memory_order_relaxed);
+    const u32 available_size = (read_ptr > write_ptr) ? (read_ptr - write_ptr) : (COMMAND_QUEUE_SIZE - write_ptr);
+    if ((new_size + sizeof(GPUThreadCommand)) > available_size)
+      return false;
+
+    cmd->size = new_size;
+  }
+
+  std::memcpy(&cmd->data[pending_words], data, num_words * sizeof(u16));
+  cmd->width = Truncate16(new_width);
+  cmd->height = Truncate16(new_height);
+  return true;
+}
+
+void GPUThread::PushVRAMWriteCommand(GPUBackendUpdateVRAMCommand* cmd)
+{
+  // Hold back small writes, in case the next one continues it.
+  if (s_state.use_gpu_thread && (ZeroExtend32(cmd->width) * cmd->height) <= MAX_COALESCED_VRAM_WRITE_WORDS)
+  {
+    DebugAssert(!s_state.pending_vram_write);
+    s_state.pending_vram_write = cmd;
+    return;
+  }
+
+  PushCommand(cmd);
+}
+
+void GPUThread::FlushPendingVRAMWrite()
+{
+  PushCommand(std::exchange(s_state.pending_vram_write, nullptr));
+}
+
+GPUThread::Internal::SyncStatistics GPUThread::Internal::GetAndResetSyncStatistics()
+{
+  const u32 spin_count = s_state.sync_stats_spin_count.exchange(0, std::memory_order_relaxed);
+  const u32 yield_count = s_state.sync_stats_yield_count.exchange(0, std::memory_order_relaxed);
+  const u32 sleep_count = s_state.sync_stats_sleep_count.exchange(0, std::memory_order_relaxed);
+  const Timer::Value wake_latency_total = s_state.sync_stats_wake_latency_total.exchange(0, std::memory_order_relaxed);
+  const Timer::Value wake_latency_max = s_state.sync_stats_wake_latency_max.exchange(0, std::memory_order_relaxed);
+
+  SyncStatistics ret;
+  ret.spin_count = spin_count;
+  ret.yield_count = yield_count;
+  ret.sleep_count = sleep_count;
+  ret.spin_window_us = static_cast<float>(
+    Timer::ConvertValueToNanoseconds(s_state.sync_stats_spin_window.load(std::memory_order_relaxed)) / 1000.0);
+  ret.average_wake_latency_us =
+    (sleep_count > 0) ? static_cast<float>(Timer::ConvertValueToNanoseconds(wake_latency_total) /
+                                           (1000.0 * static_cast<double>(sleep_count))) :
+                        0.0f;
+  ret.maximum_wake_latency_us = static_cast<float>(Timer::ConvertValueToNanoseconds(wake_latency_max) / 1000.0);
+  return ret;
 }
 
 bool GPUThread::SleepGPUThread(bool allow_sleep)
@@ -404,7 +776,10 @@ bool GPUThread::SleepGPUThread(bool allow_sleep)
 
     // We're done, so wake the CPU thread if it's waiting.
     if (old_state & THREAD_WAKE_COUNT_CPU_THREAD_IS_WAITING)
+    {
+      s_state.thread_done_post_time.store(Timer::GetCurrentValue(), std::memory_order_release);
       s_state.thread_is_done_semaphore.Post();
+    }
 
     // Sleep until more work is queued.
     if (allow_sleep)
@@ -417,9 +792,12 @@ bool GPUThread::SleepGPUThread(bool allow_sleep)
 void GPUThread::Internal::GPUThreadEntryPoint()
 {
   s_state.gpu_thread = Threading::ThreadHandle::GetForCallingThread();
+  EventTrace::SetThreadName("GPU Thread");
+  System::ApplyGPUThreadPlacement();
 
   // Take a local copy of the FIFO, that way it's not ping-ponging between the threads.
   u8* const command_fifo_data = s_state.command_fifo_data.get();
+  u64 completed_fence = s_state.completed_command_fence.load(std::memory_order_relaxed);
 
   for (;;)
   {
@@ -440,6 +818,7 @@ void GPUThread::Internal::GPUThreadEntryPoint()
     }
 
     write_ptr = (write_ptr < read_ptr) ? COMMAND_QUEUE_SIZE : write_ptr;
+    const Timer::Value batch_start_time = EventTrace::IsRecording() ? Timer::GetCurrentValue() : 0;
     while (read_ptr < write_ptr)
     {
       GPUThreadCommand* cmd = reinterpret_cast<GPUThreadCommand*>(&command_fifo_data[read_ptr]);
@@ -450,9 +829,14 @@ void GPUThread::Internal::GPUThreadEntryPoint()
       {
         DebugAssert(s_state.gpu_backend);
         s_state.gpu_backend->HandleCommand(cmd);
+        s_state.completed_command_fence.store(++completed_fence, std::memory_order_release);
         continue;
       }
 
+      // Wraparound isn't pushed, so it doesn't have a fence.
+      if (cmd->type != GPUBackendCommandType::Wraparound)
+        completed_fence++;
+
       switch (cmd->type)
       {
         case GPUBackendCommandType::Wraparound:
@@ -469,16 +853,7 @@ void GPUThread::Internal::GPUThreadEntryPoint()
         case GPUBackendCommandType::AsyncCall:
         {
           GPUThreadAsyncCallCommand* acmd = static_cast<GPUThreadAsyncCallCommand*>(cmd);
-          acmd->func();
-          acmd->~GPUThreadAsyncCallCommand();
-        }
-        break;
-
-        case GPUBackendCommandType::AsyncBackendCall:
-        {
-          GPUThreadAsyncBackendCallCommand* acmd = static_cast<GPUThreadAsyncBackendCallCommand*>(cmd);
-          acmd->func(s_state.gpu_backend.get());
-          acmd->~GPUThreadAsyncBackendCallCommand();
+          acmd->thunk(acmd->GetStorage(), s_state.gpu_backend.get());
         }
         break;
 
@@ -510,6 +885,7 @@ void GPUThread::Internal::GPUThreadEntryPoint()
         {
           // Should have consumed everything, and be shutdown.
           DebugAssert(read_ptr == write_ptr);
+          s_state.completed_command_fence.store(completed_fence, std::memory_order_release);
           s_state.command_fifo_read_ptr.store(read_ptr, std::memory_order_release);
           return;
         }
@@ -517,9 +893,14 @@ void GPUThread::Internal::GPUThreadEntryPoint()
 
           DefaultCaseIsUnreachable();
       }
+
+      s_state.completed_command_fence.store(completed_fence, std::memory_order_release);
     }
 
     s_state.command_fifo_read_ptr.store(read_ptr, std::memory_order_release);
+
+    if (batch_start_time != 0)
+      EventTrace::Span("Command Batch", batch_start_time, Timer::GetCurrentValue());
   }
 
   s_state.gpu_thread = {};
@@ -534,22 +915,33 @@ void GPUThread::Internal::DoRunIdle()
     return;
   }
 
-  if (!PresentFrameAndRestoreContext())
+  // Without a game the UI often sits on a static screen, e.g. the game list, so don't render it again if nothing
+  // has changed. Paused games can still have animated post-processing, so they always present.
+  const u64 last_present_time = s_state.last_present_time;
+  const bool skip_if_unchanged =
+    (!s_state.gpu_backend && Timer::ConvertValueToSeconds(Timer::GetCurrentValue() - last_present_time) <
+                               IDLE_UI_REFRESH_INTERVAL);
+  if (!PresentFrameAndRestoreContext(skip_if_unchanged))
     return;
 
-  if (g_gpu_device->HasMainSwapChain() && !g_gpu_device->GetMainSwapChain()->IsVSyncModeBlocking())
+  // skipped frames don't get held up by vsync
+  if (g_gpu_device->HasMainSwapChain() &&
+      (!g_gpu_device->GetMainSwapChain()->IsVSyncModeBlocking() || s_state.last_present_time == last_present_time))
+  {
     ThrottlePresentation();
+  }
 }
 
-bool GPUThread::Reconfigure(std::optional<GPURenderer> renderer, bool upload_vram, std::optional<bool> fullscreen,
-                            std::optional<bool> start_fullscreen_ui, bool recreate_device, Error* error)
+void GPUThread::QueueReconfigure(std::optional<GPURenderer> renderer, bool upload_vram, std::optional<bool> fullscreen,
+                                 std::optional<bool> start_fullscreen_ui, bool recreate_device, bool* out_result,
+                                 Error* error)
 {
   INFO_LOG("Reconfiguring GPU thread.");
 
   s_state.requested_renderer = renderer;
   s_state.requested_fullscreen = fullscreen.value_or(s_state.requested_fullscreen);
 
-  bool result = false;
+  *out_result = false;
   GPUThreadReconfigureCommand* cmd = AllocateCommand<GPUThreadReconfigureCommand>(GPUBackendCommandType::Reconfigure);
   cmd->renderer = s_state.requested_renderer;
   cmd->fullscreen = s_state.requested_fullscreen;
@@ -559,14 +951,21 @@ bool GPUThread::Reconfigure(std::optional<GPURenderer> renderer, bool upload_vra
   cmd->force_recreate_device = recreate_device;
   cmd->upload_vram = upload_vram;
   cmd->error_ptr = error;
-  cmd->out_result = &result;
+  cmd->out_result = out_result;
   cmd->settings = g_settings;
 
   if (!s_state.use_gpu_thread) [[unlikely]]
     ReconfigureOnThread(cmd);
   else
-    PushCommandAndSync(cmd, false);
+    PushCommandAndWakeThread(cmd);
+}
 
+bool GPUThread::Reconfigure(std::optional<GPURenderer> renderer, bool upload_vram, std::optional<bool> fullscreen,
+                            std::optional<bool> start_fullscreen_ui, bool recreate_device, Error* error)
+{
+  bool result;
+  QueueReconfigure(renderer, upload_vram, fullscreen, start_fullscreen_ui, recreate_device, &result, error);
+  SyncGPUThread(false);
   return result;
 }
 
@@ -609,6 +1008,18 @@ bool GPUThread::CreateGPUBackend(GPURenderer renderer, bool upload_vram, std::op
   return Reconfigure(renderer, upload_vram, fullscreen, std::nullopt, false, error);
 }
 
+void GPUThread::BeginCreateGPUBackend(GPURenderer renderer, bool upload_vram, std::optional<bool> fullscreen,
+                                      bool* result, Error* error)
+{
+  QueueReconfigure(renderer, upload_vram, fullscreen, std::nullopt, false, result, error);
+}
+
+bool GPUThread::FinishCreateGPUBackend(const bool* result)
+{
+  SyncGPUThread(false);
+  return *result;
+}
+
 void GPUThread::DestroyGPUBackend()
 {
   Reconfigure(std::nullopt, false, std::nullopt, std::nullopt, false, nullptr);
@@ -689,7 +1100,8 @@ bool GPUThread::CreateDeviceOnThread(RenderAPI api, bool fullscreen, bool preser
   if (!g_gpu_device ||
       !(wi = Host::AcquireRenderWindow(api, fullscreen, fullscreen_mode.has_value(), &create_error)).has_value() ||
       !g_gpu_device->Create(Core::GetStringSettingValue("GPU", "Adapter"), create_flags, shader_dump_directory,
-                            EmuFolders::Cache, SHADER_CACHE_VERSION, wi.value(), s_state.requested_vsync,
+                            EmuFolders::Cache, Path::Combine(EmuFolders::Resources, "shaderpackage"),
+                            SHADER_CACHE_VERSION, wi.value(), s_state.requested_vsync,
                             fullscreen_mode.has_value() ? &fullscreen_mode.value() : nullptr,
                             exclusive_fullscreen_control, &create_error))
   {
@@ -784,10 +1196,12 @@ bool GPUThread::CreateGPUBackendOnThread(GPURenderer renderer, bool upload_vram,
     ImGuiManager::UpdateDebugWindowConfig();
   }
 
-  const bool is_hardware = (renderer != GPURenderer::Software);
+  const bool is_hardware = Settings::IsHardwareRenderer(renderer);
 
   if (is_hardware)
     s_state.gpu_backend = GPUBackend::CreateHardwareBackend(*s_state.gpu_presenter);
+  else if (renderer == GPURenderer::Null)
+    s_state.gpu_backend = GPUBackend::CreateNullBackend(*s_state.gpu_presenter);
   else
     s_state.gpu_backend = GPUBackend::CreateSoftwareBackend(*s_state.gpu_presenter);
 
@@ -817,7 +1231,7 @@ bool GPUThread::CreateGPUBackendOnThread(GPURenderer renderer, bool upload_vram,
     }
   }
 
-  g_gpu_device->SetGPUTimingEnabled(g_gpu_settings.display_show_gpu_usage);
+  g_gpu_device->SetGPUTimingEnabled(g_gpu_settings.IsGPUTimingNeeded());
   s_state.gpu_backend->RestoreDeviceContext();
   SetRunIdleReason(RunIdleReason::NoGPUBackend, false);
   std::atomic_thread_fence(std::memory_order_release);
@@ -864,7 +1278,8 @@ void GPUThread::ReconfigureOnThread(GPUThreadReconfigureCommand* cmd)
   // Device recreation?
   const RenderAPI current_api = g_gpu_device ? g_gpu_device->GetRenderAPI() : RenderAPI::None;
   const RenderAPI expected_api =
-    (cmd->renderer.has_value() && cmd->renderer.value() == GPURenderer::Software && current_api != RenderAPI::None) ?
+    (cmd->renderer.has_value() && !Settings::IsHardwareRenderer(cmd->renderer.value()) &&
+     current_api != RenderAPI::None) ?
       current_api :
       Settings::GetRenderAPIForRenderer(s_state.requested_renderer.value_or(g_gpu_settings.gpu_renderer));
   if (cmd->force_recreate_device || !GPUDevice::IsSameRenderAPI(current_api, expected_api))
@@ -972,14 +1387,14 @@ void GPUThread::DestroyGPUPresenterOnThread()
   s_state.gpu_presenter.reset();
 }
 
-bool GPUThread::Internal::PresentFrameAndRestoreContext()
+bool GPUThread::Internal::PresentFrameAndRestoreContext(bool skip_if_unchanged)
 {
   DebugAssert(IsOnThread());
 
   if (s_state.gpu_backend)
     s_state.gpu_backend->FlushRender();
 
-  if (!GPUPresenter::PresentFrame(s_state.gpu_presenter.get(), s_state.gpu_backend.get(), 0))
+  if (!GPUPresenter::PresentFrame(s_state.gpu_presenter.get(), s_state.gpu_backend.get(), 0, skip_if_unchanged))
     return false;
 
   if (s_state.gpu_backend)
@@ -1058,8 +1473,8 @@ void GPUThread::UpdateSettingsOnThread(GPUSettings&& new_settings)
 
   if (s_state.gpu_backend)
   {
-    if (g_gpu_settings.display_show_gpu_usage != old_settings.display_show_gpu_usage)
-      g_gpu_device->SetGPUTimingEnabled(g_gpu_settings.display_show_gpu_usage);
+    if (g_gpu_settings.IsGPUTimingNeeded() != old_settings.IsGPUTimingNeeded())
+      g_gpu_device->SetGPUTimingEnabled(g_gpu_settings.IsGPUTimingNeeded());
 
     Error error;
     if (!s_state.gpu_presenter->UpdateSettings(old_settings, &error) ||
@@ -1076,45 +1491,33 @@ void GPUThread::UpdateSettingsOnThread(GPUSettings&& new_settings)
   }
 }
 
-void GPUThread::RunOnThread(AsyncCallType func)
+GPUThreadCommand* GPUThread::Internal::AllocateAsyncCallCommand(AsyncCallThunk thunk, u32 storage_size,
+                                                                 void** storage)
 {
-  if (!s_state.use_gpu_thread) [[unlikely]]
-  {
-    func();
-    return;
-  }
-
-  GPUThreadAsyncCallCommand* cmd =
-    AllocateCommand<GPUThreadAsyncCallCommand>(GPUBackendCommandType::AsyncCall, std::move(func));
-  PushCommandAndWakeThread(cmd);
+  GPUThreadAsyncCallCommand* const cmd = static_cast<GPUThreadAsyncCallCommand*>(AllocateCommand(
+    GPUBackendCommandType::AsyncCall, GPUThreadAsyncCallCommand::STORAGE_OFFSET + storage_size));
+  cmd->thunk = thunk;
+  *storage = cmd->GetStorage();
+  return cmd;
 }
 
-void GPUThread::RunOnBackend(AsyncBackendCallType func, bool sync, bool spin_or_wake)
+GPUBackend* GPUThread::Internal::GetBackend()
 {
-  if (!s_state.use_gpu_thread) [[unlikely]]
-  {
-    func(s_state.gpu_backend.get());
-    return;
-  }
-
-  GPUThreadAsyncBackendCallCommand* cmd =
-    AllocateCommand<GPUThreadAsyncBackendCallCommand>(GPUBackendCommandType::AsyncBackendCall, std::move(func));
-  if (sync)
-    PushCommandAndSync(cmd, spin_or_wake);
-  else if (spin_or_wake)
-    PushCommandAndWakeThread(cmd);
-  else
-    PushCommand(cmd);
+  return s_state.gpu_backend.get();
 }
 
 std::pair<GPUThreadCommand*, void*> GPUThread::BeginASyncBufferCall(AsyncBufferCallType func, u32 buffer_size)
 {
-  // this is less than optimal, but it's only used for input osd updates currently, so whatever
-  GPUThreadAsyncCallCommand* const cmd = AllocateCommand<GPUThreadAsyncCallCommand>(
-    sizeof(GPUThreadAsyncCallCommand) + buffer_size, GPUBackendCommandType::AsyncCall);
-  void* const buffer = static_cast<void*>(cmd + 1);
-  cmd->func = [func, buffer]() { func(buffer); };
-  return std::make_pair(static_cast<GPUThreadCommand*>(cmd), buffer);
+  // Function pointer goes at the start of the storage, followed by the buffer.
+  static constexpr u32 BUFFER_OFFSET = 16;
+  static constexpr AsyncCallThunk thunk = [](void* storage, GPUBackend*) {
+    (*static_cast<AsyncBufferCallType*>(storage))(static_cast<u8*>(storage) + BUFFER_OFFSET);
+  };
+
+  void* storage;
+  GPUThreadCommand* const cmd = Internal::AllocateAsyncCallCommand(thunk, BUFFER_OFFSET + buffer_size, &storage);
+  *static_cast<AsyncBufferCallType*>(storage) = func;
+  return std::make_pair(cmd, static_cast<u8*>(storage) + BUFFER_OFFSET);
 }
 
 void GPUThread::EndASyncBufferCall(GPUThreadCommand* cmd)
@@ -1122,8 +1525,7 @@ void GPUThread::EndASyncBufferCall(GPUThreadCommand* cmd)
   if (!s_state.use_gpu_thread) [[unlikely]]
   {
     GPUThreadAsyncCallCommand* const acmd = static_cast<GPUThreadAsyncCallCommand*>(cmd);
-    acmd->func();
-    acmd->~GPUThreadAsyncCallCommand();
+    acmd->thunk(acmd->GetStorage(), s_state.gpu_backend.get());
     return;
   }
 
@@ -1228,7 +1630,10 @@ void GPUThread::GameInfoChanged(bool serial_changed)
     return;
 
   if (HasGPUBackend())
+  {
     GPUTextureCache::GameSerialChanged();
+    s_state.gpu_backend->OnGameSerialChanged();
+  }
   if (SaveStateSelectorUI::IsOpen())
     SaveStateSelectorUI::RefreshList();
 }
@@ -1527,23 +1932,30 @@ bool GPUThread::IsSystemPaused()
   return ((s_state.run_idle_reasons & static_cast<u8>(RunIdleReason::SystemPaused)) != 0);
 }
 
+bool GPUThread::IsPresentSkipActive()
+{
+  return (s_state.requested_present_skip == PresentSkipMode::Always ||
+          (s_state.requested_present_skip == PresentSkipMode::WhenVSyncBlocks &&
+           g_gpu_device->GetMainSwapChain()->IsVSyncModeBlocking()));
+}
+
+float GPUThread::GetPresentThrottlePeriod()
+{
+  const WindowInfo& swap_chain_wi = g_gpu_device->GetMainSwapChain()->GetWindowInfo();
+  const float throttle_rate = (swap_chain_wi.surface_refresh_rate > 0.0f) ? swap_chain_wi.surface_refresh_rate : 60.0f;
+  return 1.0f / throttle_rate;
+}
+
 bool GPUThread::ShouldPresentVideoFrame(u64 present_time)
 {
   // TODO: Move to VideoPresenter once it's turned into a namespace.
   if (!g_gpu_device->HasMainSwapChain())
     return false;
 
-  if (s_state.requested_present_skip == PresentSkipMode::Disabled ||
-      (s_state.requested_present_skip == PresentSkipMode::WhenVSyncBlocks &&
-       !g_gpu_device->GetMainSwapChain()->IsVSyncModeBlocking()))
-  {
+  if (!IsPresentSkipActive())
     return true;
-  }
-
-  const WindowInfo& swap_chain_wi = g_gpu_device->GetMainSwapChain()->GetWindowInfo();
-  const float throttle_rate = (swap_chain_wi.surface_refresh_rate > 0.0f) ? swap_chain_wi.surface_refresh_rate : 60.0f;
-  const float throttle_period = 1.0f / throttle_rate;
 
+  const float throttle_period = GetPresentThrottlePeriod();
   const u64 wanted_time = (present_time == 0) ? Timer::GetCurrentValue() : present_time;
   const double diff = Timer::ConvertValueToSeconds(wanted_time - s_state.last_present_time);
   if (diff >= throttle_period || s_state.skipped_present_count >= MAX_SKIPPED_PRESENT_COUNT)
@@ -1556,6 +1968,29 @@ bool GPUThread::ShouldPresentVideoFrame(u64 present_time)
   return false;
 }
 
+bool GPUThread::ShouldSkipRenderingNextFrame()
+{
+  const u64 current_time = Timer::GetCurrentValue();
+  const u64 last_frame_done_time = std::exchange(s_state.last_frame_done_time, current_time);
+  if (!g_gpu_settings.gpu_fast_forward_render_skip || !g_gpu_device->HasMainSwapChain() || !IsPresentSkipActive())
+  {
+    s_state.render_skipped_frame_count = 0;
+    return false;
+  }
+
+  // Assume the next frame takes as long as this one did, and only render it if it'll be due for presentation.
+  const u64 next_frame_done_time = current_time + (current_time - last_frame_done_time);
+  const double diff = Timer::ConvertValueToSeconds(next_frame_done_time - s_state.last_present_time);
+  if (diff >= GetPresentThrottlePeriod() || s_state.render_skipped_frame_count >= MAX_RENDER_SKIPPED_FRAME_COUNT)
+  {
+    s_state.render_skipped_frame_count = 0;
+    return false;
+  }
+
+  s_state.render_skipped_frame_count++;
+  return true;
+}
+
 u64 GPUThread::GetLastPresentTime()
 {
   return s_state.last_present_time;
@@ -1566,6 +2001,18 @@ void GPUThread::SetLastPresentTime(u64 time)
   s_state.last_present_time = time;
 }
 
+void GPUThread::ReportFrameLatency(u64 latency)
+{
+  // Racing with the reset is fine, worst case we lose one frame's sample.
+  if (latency > s_state.max_frame_latency.load(std::memory_order_relaxed))
+    s_state.max_frame_latency.store(latency, std::memory_order_relaxed);
+}
+
+u64 GPUThread::GetAndResetMaxFrameLatency()
+{
+  return s_state.max_frame_latency.exchange(0, std::memory_order_relaxed);
+}
+
 void GPUThread::ThrottlePresentation()
 {
   const float throttle_rate = (g_gpu_device && g_gpu_device->HasMainSwapChain() &&
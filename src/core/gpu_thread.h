@@ -6,7 +6,9 @@
 #include "types.h"
 
 #include <functional>
+#include <new>
 #include <optional>
+#include <type_traits>
 #include <utility>
 
 class Error;
@@ -26,11 +28,12 @@ enum class GPUBackendCommandType : u8;
 class GPUBackend;
 struct GPUThreadCommand;
 struct GPUBackendUpdateDisplayCommand;
+struct GPUBackendUpdateVRAMCommand;
 
 namespace GPUThread {
 using AsyncCallType = std::function<void()>;
-using AsyncBackendCallType = std::function<void(GPUBackend*)>;
 using AsyncBufferCallType = void (*)(void*);
+using AsyncCallThunk = void (*)(void* storage, GPUBackend* backend);
 
 enum class RunIdleReason : u8
 {
@@ -51,6 +54,12 @@ void StopFullscreenUI();
 /// Backend control.
 std::optional<GPURenderer> GetRequestedRenderer();
 bool CreateGPUBackend(GPURenderer renderer, bool upload_vram, std::optional<bool> fullscreen, Error* error);
+
+/// Starts creating the backend without waiting for it, so the caller can set up things which don't touch the GPU in
+/// the meantime. The result and error are filled once FinishCreateGPUBackend() returns, so both must outlive it.
+void BeginCreateGPUBackend(GPURenderer renderer, bool upload_vram, std::optional<bool> fullscreen, bool* result,
+                           Error* error);
+bool FinishCreateGPUBackend(const bool* result);
 void DestroyGPUBackend();
 bool HasGPUBackend();
 bool IsGPUBackendRequested();
@@ -81,13 +90,24 @@ void ReportFatalErrorAndShutdown(std::string_view reason);
 
 bool IsOnThread();
 bool IsUsingThread();
-void RunOnThread(AsyncCallType func);
-void RunOnBackend(AsyncBackendCallType func, bool sync, bool spin_or_wake);
+template<typename F>
+void RunOnThread(F&& func);
+template<typename F>
+void RunOnBackend(F&& func, bool sync, bool spin_or_wake);
 std::pair<GPUThreadCommand*, void*> BeginASyncBufferCall(AsyncBufferCallType func, u32 buffer_size);
 void EndASyncBufferCall(GPUThreadCommand* cmd);
 void SetVSync(GPUVSyncMode mode, PresentSkipMode present_throttle_mode);
 bool ShouldPresentVideoFrame(u64 present_time);
+
+/// Returns true if the next frame is not expected to be presented, so its rendering can be skipped.
+bool ShouldSkipRenderingNextFrame();
 u64 GetLastPresentTime();
+
+/// Records the time between the CPU thread submitting a frame, and the GPU thread finishing its commands.
+void ReportFrameLatency(u64 latency);
+
+/// Returns the largest frame latency reported since the last call, and resets it.
+u64 GetAndResetMaxFrameLatency();
 void SetLastPresentTime(u64 time);
 
 // Should only be called on the GPU thread.
@@ -106,16 +126,96 @@ void PushCommandAndWakeThread(GPUThreadCommand* cmd);
 void PushCommandAndSync(GPUThreadCommand* cmd, bool spin);
 void SyncGPUThread(bool spin);
 
+/// Waits until every queued command that writes to the specified VRAM region has executed.
+void SyncGPUThreadForVRAMRead(u32 x, u32 y, u32 width, u32 height);
+
+/// Merges a CPU->VRAM transfer into the previous one, if it directly continues it. Returns false if not possible.
+bool AppendToPendingVRAMWrite(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask);
+
+/// Queues a CPU->VRAM transfer. Small transfers are held back until the next command, for merging.
+void PushVRAMWriteCommand(GPUBackendUpdateVRAMCommand* cmd);
+
 namespace Internal {
+/// Allocates an async call command with room for a callable of storage_size bytes, aligned to 16 bytes.
+GPUThreadCommand* AllocateAsyncCallCommand(AsyncCallThunk thunk, u32 storage_size, void** storage);
+GPUBackend* GetBackend();
+
+template<typename T>
+void InvokeAsyncCall(void* storage, GPUBackend* backend)
+{
+  T* const func = static_cast<T*>(storage);
+  if constexpr (std::is_invocable_v<T&, GPUBackend*>)
+    (*func)(backend);
+  else
+    (*func)();
+  func->~T();
+}
+
+struct SyncStatistics
+{
+  float spin_window_us;
+  float average_wake_latency_us;
+  float maximum_wake_latency_us;
+  u32 spin_count;
+  u32 yield_count;
+  u32 sleep_count;
+};
+
+/// Returns CPU thread sync statistics since the last call, and resets them.
+SyncStatistics GetAndResetSyncStatistics();
+
 const Threading::ThreadHandle& GetThreadHandle();
 void ProcessStartup();
 void DoRunIdle();
 void RequestShutdown();
 void GPUThreadEntryPoint();
-bool PresentFrameAndRestoreContext();
+bool PresentFrameAndRestoreContext(bool skip_if_unchanged = false);
 } // namespace Internal
 } // namespace GPUThread
 
+template<typename F>
+inline void GPUThread::RunOnThread(F&& func)
+{
+  if (!IsUsingThread()) [[unlikely]]
+  {
+    func();
+    return;
+  }
+
+  using T = std::decay_t<F>;
+  static_assert(alignof(T) <= 16, "Callable alignment exceeds command storage alignment");
+
+  void* storage;
+  GPUThreadCommand* const cmd =
+    Internal::AllocateAsyncCallCommand(&Internal::InvokeAsyncCall<T>, static_cast<u32>(sizeof(T)), &storage);
+  new (storage) T(std::forward<F>(func));
+  PushCommandAndWakeThread(cmd);
+}
+
+template<typename F>
+inline void GPUThread::RunOnBackend(F&& func, bool sync, bool spin_or_wake)
+{
+  if (!IsUsingThread()) [[unlikely]]
+  {
+    func(Internal::GetBackend());
+    return;
+  }
+
+  using T = std::decay_t<F>;
+  static_assert(alignof(T) <= 16, "Callable alignment exceeds command storage alignment");
+
+  void* storage;
+  GPUThreadCommand* const cmd =
+    Internal::AllocateAsyncCallCommand(&Internal::InvokeAsyncCall<T>, static_cast<u32>(sizeof(T)), &storage);
+  new (storage) T(std::forward<F>(func));
+  if (sync)
+    PushCommandAndSync(cmd, spin_or_wake);
+  else if (spin_or_wake)
+    PushCommandAndWakeThread(cmd);
+  else
+    PushCommand(cmd);
+}
+
 namespace Host {
 
 /// Called when the core is creating a render device.
@@ -28,7 +28,6 @@ enum class GPUBackendCommandType : u8
 {
   Wraparound,
   AsyncCall,
-  AsyncBackendCall,
   Reconfigure,
   UpdateSettings,
   UpdateGameInfo,
@@ -104,20 +103,17 @@ struct GPUThreadUpdateGameInfoCommand : public GPUThreadCommand
   GameHash game_hash;
 };
 
+/// Callable is stored in the ring directly after the command, so no heap allocation is needed.
 struct GPUThreadAsyncCallCommand : public GPUThreadCommand
 {
-  GPUThreadAsyncCallCommand() = default;
-  GPUThreadAsyncCallCommand(std::function<void()> func_) : func(std::move(func_)) {}
+  static constexpr u32 STORAGE_OFFSET = 16;
 
-  std::function<void()> func;
-};
-
-struct GPUThreadAsyncBackendCallCommand : public GPUThreadCommand
-{
-  GPUThreadAsyncBackendCallCommand(std::function<void(GPUBackend*)> func_) : func(std::move(func_)) {}
+  /// Invokes the stored callable, then destroys it.
+  void (*thunk)(void* storage, GPUBackend* backend);
 
-  std::function<void(GPUBackend*)> func;
+  ALWAYS_INLINE void* GetStorage() { return reinterpret_cast<u8*>(this) + STORAGE_OFFSET; }
 };
+static_assert(sizeof(GPUThreadAsyncCallCommand) <= GPUThreadAsyncCallCommand::STORAGE_OFFSET);
 
 struct GPUBackendLoadStateCommand : public GPUThreadCommand
 {
@@ -139,6 +135,7 @@ struct GPUBackendFramePresentationParameters
   u32 internal_frame_number;
 
   u64 present_time;
+  u64 submit_time;
   MediaCapture* media_capture;
 
   union
@@ -6,6 +6,7 @@
 #include "cpu_core_private.h"
 #include "cpu_pgxp.h"
 #include "host.h"
+#include "performance_counters.h"
 #include "settings.h"
 
 #include "util/state_wrapper.h"
@@ -229,6 +230,8 @@ static void PushSZ(s32 value);
 static void PushRGBFromMAC();
 static u32 UNRDivide(u32 lhs, u32 rhs);
 
+static u32 MulMatVecMAC(const s16* M_, const s32 T[3], const s16 Vx, const s16 Vy, const s16 Vz, bool check_result,
+                        GSVector4i* mac12, GSVector4i* mac3);
 static void MulMatVec(const s16* M_, const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm);
 static void MulMatVec(const s16* M_, const s32 T[3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm);
 static void MulMatVecBuggy(const s16* M_, const s32 T[3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm);
@@ -268,6 +271,11 @@ static void Execute_INTPL(Instruction inst);
 static void Execute_GPL(Instruction inst);
 static void Execute_GPF(Instruction inst);
 
+template<InstructionImpl func>
+static void ExecuteProfiled(Instruction inst);
+template<InstructionImpl func>
+static InstructionImpl SelectInstructionImpl();
+
 } // namespace GTE
 
 void GTE::Reset()
@@ -572,38 +580,89 @@ ALWAYS_INLINE u32 GTE::UNRDivide(u32 lhs, u32 rhs)
   return std::min<u32>(0x1FFFF, result);
 }
 
-void GTE::MulMatVec(const s16* M_, const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm)
+ALWAYS_INLINE u32 GTE::MulMatVecMAC(const s16* M_, const s32 T[3], const s16 Vx, const s16 Vy, const s16 Vz,
+                                    bool check_result, GSVector4i* mac12, GSVector4i* mac3)
 {
-#define M(i, j) M_[((i) * 3) + (j)]
-#define dot3(i)                                                                                                        \
-  TruncateAndSetMACAndIR<i + 1>(SignExtendMACResult<i + 1>((s64(M(i, 0)) * s64(Vx)) + (s64(M(i, 1)) * s64(Vy))) +      \
-                                  (s64(M(i, 2)) * s64(Vz)),                                                            \
-                                shift, lm)
+  // All three rows are computed at once, with rows 1/2 in the 64-bit lanes of mac12, and row 3 in the low lane of mac3.
+  // Each product fits in 32 bits, only the sums need 44.
+#define M(i, j) static_cast<s32>(M_[((i) * 3) + (j)])
+  const GSVector4i P0 = GSVector4i(M(0, 0), M(1, 0), M(2, 0), 0).mul32l(GSVector4i(static_cast<s32>(Vx)));
+  const GSVector4i P1 = GSVector4i(M(0, 1), M(1, 1), M(2, 1), 0).mul32l(GSVector4i(static_cast<s32>(Vy)));
+  const GSVector4i P2 = GSVector4i(M(0, 2), M(1, 2), M(2, 2), 0).mul32l(GSVector4i(static_cast<s32>(Vz)));
+  const GSVector4i TV = GSVector4i(T[0], T[1], T[2], 0);
+#undef M
 
-  dot3(0);
-  dot3(1);
-  dot3(2);
+  // Range checks only need the upper 32 bits of each sum, i.e. the odd 32-bit lanes. The sum is out of range if
+  // those are outside -800h..7FFh. The even lanes are ignored when the masks are converted to flags.
+  GSVector4i overflow12 = GSVector4i::zero();
+  GSVector4i overflow3 = GSVector4i::zero();
+  GSVector4i underflow12 = GSVector4i::zero();
+  GSVector4i underflow3 = GSVector4i::zero();
+  const auto check = [&](const GSVector4i v12, const GSVector4i v3) {
+    overflow12 = overflow12 | v12.gt32(GSVector4i::cxpr(0x7FF));
+    overflow3 = overflow3 | v3.gt32(GSVector4i::cxpr(0x7FF));
+    underflow12 = underflow12 | v12.lt32(GSVector4i::cxpr(-0x800));
+    underflow3 = underflow3 | v3.lt32(GSVector4i::cxpr(-0x800));
+  };
 
-#undef dot3
-#undef M
+  // Same as SignExtendN<44>, sign extending bit 11 of the upper half.
+  const auto wrap = [](const GSVector4i v) { return v.blend32<0xA>(v.sll32<20>().sra32<20>()); };
+
+  // MAC = (T * 1000h + M[0] * Vx + M[1] * Vy + M[2] * Vz), with the first two sums checked and sign-extended.
+  GSVector4i v12 = TV.s32to64().sll64<12>().add64(P0.s32to64());
+  GSVector4i v3 = TV.uph64().s32to64().sll64<12>().add64(P0.uph64().s32to64());
+  check(v12, v3);
+  v12 = wrap(v12).add64(P1.s32to64());
+  v3 = wrap(v3).add64(P1.uph64().s32to64());
+  check(v12, v3);
+  v12 = wrap(v12).add64(P2.s32to64());
+  v3 = wrap(v3).add64(P2.uph64().s32to64());
+  if (check_result)
+    check(v12, v3);
+
+  *mac12 = v12;
+  *mac3 = v3;
+
+  // Sign bits of the upper halves are bits 7, 15 in the byte masks.
+  const u32 overflow_mask12 = static_cast<u32>(overflow12.mask());
+  const u32 underflow_mask12 = static_cast<u32>(underflow12.mask());
+  return (((overflow_mask12 >> 7) & 1u) << 30) | (((overflow_mask12 >> 15) & 1u) << 29) |
+         (((static_cast<u32>(overflow3.mask()) >> 7) & 1u) << 28) | (((underflow_mask12 >> 7) & 1u) << 27) |
+         (((underflow_mask12 >> 15) & 1u) << 26) | (((static_cast<u32>(underflow3.mask()) >> 7) & 1u) << 25);
+}
+
+void GTE::MulMatVec(const s16* M_, const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm)
+{
+  // The first product can't overflow on its own, so this is the same as a zero translation.
+  static constexpr const s32 zero_T[3] = {};
+  MulMatVec(M_, zero_T, Vx, Vy, Vz, shift, lm);
 }
 
 void GTE::MulMatVec(const s16* M_, const s32 T[3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm)
 {
-#define M(i, j) M_[((i) * 3) + (j)]
-#define dot3(i)                                                                                                        \
-  TruncateAndSetMACAndIR<i + 1>(                                                                                       \
-    SignExtendMACResult<i + 1>(SignExtendMACResult<i + 1>((s64(T[i]) << 12) + (s64(M(i, 0)) * s64(Vx))) +              \
-                               (s64(M(i, 1)) * s64(Vy))) +                                                             \
-      (s64(M(i, 2)) * s64(Vz)),                                                                                        \
-    shift, lm)
+  GSVector4i mac12, mac3;
+  u32 flags = MulMatVecMAC(M_, T, Vx, Vy, Vz, true, &mac12, &mac3);
 
-  dot3(0);
-  dot3(1);
-  dot3(2);
+  // The low 32 bits of a logical shift are the same as an arithmetic one, for shifts below 32.
+  mac12 = mac12.srl64(shift);
+  mac3 = mac3.srl64(shift);
+  const GSVector4i lo = mac12.upl32(mac3);
+  const GSVector4i hi = mac12.uph32(mac3);
+  const GSVector4i mac = lo.upl32(hi);
 
-#undef dot3
-#undef M
+  // Same as TruncateAndSetIR, for IR1-3.
+  const GSVector4i ir = mac.max_s32(GSVector4i(lm ? 0 : IR123_MIN_VALUE)).min_s32(GSVector4i::cxpr(IR123_MAX_VALUE));
+  const u32 saturated_mask = static_cast<u32>(ir.neq32(mac).mask());
+  flags |= (((saturated_mask >> 3) & 1u) << 24) | (((saturated_mask >> 7) & 1u) << 23) |
+           (((saturated_mask >> 11) & 1u) << 22);
+
+  REGS.dr32[25] = mac.extract32<0>();
+  REGS.dr32[26] = mac.extract32<1>();
+  REGS.dr32[27] = mac.extract32<2>();
+  REGS.dr32[9] = ir.extract32<0>();
+  REGS.dr32[10] = ir.extract32<1>();
+  REGS.dr32[11] = ir.extract32<2>();
+  REGS.FLAG.bits |= flags;
 }
 
 void GTE::MulMatVecBuggy(const s16* M_, const s32 T[3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm)
@@ -716,17 +775,15 @@ void GTE::Execute_OP(Instruction inst)
 
 void GTE::RTPS(const s16 V[3], u8 shift, bool lm, bool last)
 {
-#define dot3(i)                                                                                                        \
-  SignExtendMACResult<i + 1>(SignExtendMACResult<i + 1>((s64(REGS.TR[i]) << 12) + (s64(REGS.RT[i][0]) * s64(V[0]))) +  \
-                             (s64(REGS.RT[i][1]) * s64(V[1]))) +                                                       \
-    (s64(REGS.RT[i][2]) * s64(V[2]))
-
   // IR1 = MAC1 = (TRX*1000h + RT11*VX0 + RT12*VY0 + RT13*VZ0) SAR (sf*12)
   // IR2 = MAC2 = (TRY*1000h + RT21*VX0 + RT22*VY0 + RT23*VZ0) SAR (sf*12)
   // IR3 = MAC3 = (TRZ*1000h + RT31*VX0 + RT32*VY0 + RT33*VZ0) SAR (sf*12)
-  s64 x = dot3(0);
-  s64 y = dot3(1);
-  s64 z = dot3(2);
+  // The final sums are checked when they're stored, after freecam is applied.
+  GSVector4i mac12, mac3;
+  REGS.FLAG.bits |= MulMatVecMAC(&REGS.RT[0][0], REGS.TR, V[0], V[1], V[2], false, &mac12, &mac3);
+  s64 x = mac12.extract64<0>();
+  s64 y = mac12.extract64<1>();
+  s64 z = mac3.extract64<0>();
 
 #ifdef ENABLE_FREECAM
   if (s_config.freecam_active)
@@ -744,7 +801,6 @@ void GTE::RTPS(const s16 V[3], u8 shift, bool lm, bool last)
   // when "MAC3" exceeds -8000h..+7FFFh).
   TruncateAndSetIR<3>(s32(z >> 12), false);
   REGS.dr32[11] = std::clamp(REGS.MAC3, lm ? 0 : IR123_MIN_VALUE, IR123_MAX_VALUE);
-#undef dot3
 
   // SZ3 = MAC3 SAR ((1-sf)*12)                           ;ScreenZ FIFO 0..+FFFFh
   PushSZ(s32(z >> 12));
@@ -1260,6 +1316,8 @@ void GTE::Execute_GPF(Instruction inst)
 
 void GTE::ExecuteInstruction(u32 inst_bits)
 {
+  PerformanceCounters::CPUTimeScope cpu_time_scope(PerformanceCounters::CPUTimeCategory::GTE);
+
   const Instruction inst{inst_bits};
   switch (inst.command)
   {
@@ -1384,6 +1442,20 @@ void GTE::ExecuteInstruction(u32 inst_bits)
   }
 }
 
+template<GTE::InstructionImpl func>
+void GTE::ExecuteProfiled(Instruction inst)
+{
+  PerformanceCounters::CPUTimeScope cpu_time_scope(PerformanceCounters::CPUTimeCategory::GTE);
+  func(inst);
+}
+
+template<GTE::InstructionImpl func>
+GTE::InstructionImpl GTE::SelectInstructionImpl()
+{
+  // Recompiled code calls the handlers directly, so the time needs to be charged in a wrapper instead.
+  return g_settings.display_show_cpu_breakdown ? &ExecuteProfiled<func> : func;
+}
+
 GTE::InstructionImpl GTE::GetInstructionImpl(u32 inst_bits, TickCount* ticks)
 {
   const Instruction inst{inst_bits};
@@ -1391,96 +1463,96 @@ GTE::InstructionImpl GTE::GetInstructionImpl(u32 inst_bits, TickCount* ticks)
   {
     case 0x01:
       *ticks = 15;
-      return &Execute_RTPS;
+      return SelectInstructionImpl<&Execute_RTPS>();
 
     case 0x06:
     {
       *ticks = 8;
       if (g_settings.gpu_pgxp_enable && g_settings.gpu_pgxp_culling)
-        return &Execute_NCLIP_PGXP;
+        return SelectInstructionImpl<&Execute_NCLIP_PGXP>();
       else
-        return &Execute_NCLIP;
+        return SelectInstructionImpl<&Execute_NCLIP>();
     }
 
     case 0x0C:
       *ticks = 6;
-      return &Execute_OP;
+      return SelectInstructionImpl<&Execute_OP>();
 
     case 0x10:
       *ticks = 8;
-      return &Execute_DPCS;
+      return SelectInstructionImpl<&Execute_DPCS>();
 
     case 0x11:
       *ticks = 7;
-      return &Execute_INTPL;
+      return SelectInstructionImpl<&Execute_INTPL>();
 
     case 0x12:
       *ticks = 8;
-      return &Execute_MVMVA;
+      return SelectInstructionImpl<&Execute_MVMVA>();
 
     case 0x13:
       *ticks = 19;
-      return &Execute_NCDS;
+      return SelectInstructionImpl<&Execute_NCDS>();
 
     case 0x14:
       *ticks = 13;
-      return &Execute_CDP;
+      return SelectInstructionImpl<&Execute_CDP>();
 
     case 0x16:
       *ticks = 44;
-      return &Execute_NCDT;
+      return SelectInstructionImpl<&Execute_NCDT>();
 
     case 0x1B:
       *ticks = 17;
-      return &Execute_NCCS;
+      return SelectInstructionImpl<&Execute_NCCS>();
 
     case 0x1C:
       *ticks = 11;
-      return &Execute_CC;
+      return SelectInstructionImpl<&Execute_CC>();
 
     case 0x1E:
       *ticks = 14;
-      return &Execute_NCS;
+      return SelectInstructionImpl<&Execute_NCS>();
 
     case 0x20:
       *ticks = 30;
-      return &Execute_NCT;
+      return SelectInstructionImpl<&Execute_NCT>();
 
     case 0x28:
       *ticks = 5;
-      return &Execute_SQR;
+      return SelectInstructionImpl<&Execute_SQR>();
 
     case 0x29:
       *ticks = 8;
-      return &Execute_DCPL;
+      return SelectInstructionImpl<&Execute_DCPL>();
 
     case 0x2A:
       *ticks = 17;
-      return &Execute_DPCT;
+      return SelectInstructionImpl<&Execute_DPCT>();
 
     case 0x2D:
       *ticks = 5;
-      return &Execute_AVSZ3;
+      return SelectInstructionImpl<&Execute_AVSZ3>();
 
     case 0x2E:
       *ticks = 6;
-      return &Execute_AVSZ4;
+      return SelectInstructionImpl<&Execute_AVSZ4>();
 
     case 0x30:
       *ticks = 23;
-      return &Execute_RTPT;
+      return SelectInstructionImpl<&Execute_RTPT>();
 
     case 0x3D:
       *ticks = 5;
-      return &Execute_GPF;
+      return SelectInstructionImpl<&Execute_GPF>();
 
     case 0x3E:
       *ticks = 5;
-      return &Execute_GPL;
+      return SelectInstructionImpl<&Execute_GPL>();
 
     case 0x3F:
       *ticks = 39;
-      return &Execute_NCCT;
+      return SelectInstructionImpl<&Execute_NCCT>();
 
     default:
       Panic("Missing handler");
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "common/file_system.h"
 #include "common/heap_array.h"
 #include "common/types.h"
 
@@ -23,6 +24,10 @@ bool ResourceFileExists(std::string_view filename, bool allow_override);
 std::optional<DynamicHeapArray<u8>> ReadResourceFile(std::string_view filename, bool allow_override,
                                                      Error* error = nullptr);
 
+/// Maps a resource file read-only, for data which is only parsed. Hosts which can't map resources read them instead.
+std::optional<FileSystem::MappedFile> MapResourceFile(std::string_view filename, bool allow_override,
+                                                      Error* error = nullptr);
+
 /// Reads a resource file file from the resources directory as a string.
 std::optional<std::string> ReadResourceFileToString(std::string_view filename, bool allow_override,
                                                     Error* error = nullptr);
@@ -17,6 +17,7 @@
 #include "settings.h"
 #include "spu.h"
 #include "system.h"
+#include "timing_event.h"
 
 #include "util/gpu_device.h"
 #include "util/input_manager.h"
@@ -24,7 +25,9 @@
 #include "util/translation.h"
 
 #include "common/error.h"
+#include "common/event_trace.h"
 #include "common/file_system.h"
+#include "common/path.h"
 #include "common/timer.h"
 
 #include "IconsEmoji.h"
@@ -76,7 +79,9 @@ static void HotkeyToggleOSD()
   g_settings.display_show_resolution ^= Core::GetBoolSettingValue("Display", "ShowResolution", false);
   g_settings.display_show_latency_stats ^= Core::GetBoolSettingValue("Display", "ShowLatencyStatistics", false);
   g_settings.display_show_cpu_usage ^= Core::GetBoolSettingValue("Display", "ShowCPU", false);
+  g_settings.display_show_cpu_breakdown ^= Core::GetBoolSettingValue("Display", "ShowCPUBreakdown", false);
   g_settings.display_show_gpu_usage ^= Core::GetBoolSettingValue("Display", "ShowGPU", false);
+  g_settings.display_show_gpu_breakdown ^= Core::GetBoolSettingValue("Display", "ShowGPUBreakdown", false);
   g_settings.display_show_frame_times ^= Core::GetBoolSettingValue("Display", "ShowFrameTimes", false);
   g_settings.display_show_status_indicators ^= Core::GetBoolSettingValue("Display", "ShowStatusIndicators", true);
   g_settings.display_show_inputs ^= Core::GetBoolSettingValue("Display", "ShowInputs", false);
@@ -296,6 +301,17 @@ DEFINE_HOTKEY("ResetEmulationSpeed", TRANSLATE_NOOP("Hotkeys", "System"),
                 }
               })
 
+DEFINE_HOTKEY("ToggleInputRecording", TRANSLATE_NOOP("Hotkeys", "System"),
+              TRANSLATE_NOOP("Hotkeys", "Toggle Input Recording"), [](s32 pressed) {
+                if (!pressed && System::IsValid())
+                {
+                  if (System::IsRecordingInput())
+                    System::StopInputRecording();
+                  else
+                    System::StartInputRecording();
+                }
+              })
+
 DEFINE_HOTKEY("RotateClockwise", TRANSLATE_NOOP("Hotkeys", "Graphics"),
               TRANSLATE_NOOP("Hotkeys", "Rotate Display Clockwise"), [](s32 pressed) {
                 if (!pressed)
@@ -770,6 +786,81 @@ DEFINE_HOTKEY("ToggleVRAMView", TRANSLATE_NOOP("Hotkeys", "Debugging"), TRANSLAT
                                             TRANSLATE_STR("OSDMessage", "Now showing display."));
                 }
               })
+DEFINE_HOTKEY("DumpBlockProfile", TRANSLATE_NOOP("Hotkeys", "Debugging"),
+              TRANSLATE_NOOP("Hotkeys", "Dump Recompiler Block Profile"), [](s32 pressed) {
+                if (pressed && System::IsValid())
+                {
+                  if (!g_settings.cpu_recompiler_block_profiling)
+                    return;
+
+                  Error error;
+                  const std::string path = Path::Combine(EmuFolders::DataRoot, "blockprofile.csv");
+                  if (!CPU::CodeCache::DumpBlockProfile(path.c_str(), 100, &error))
+                  {
+                    Host::AddIconOSDMessage(
+                      OSDMessageType::Error, "DumpBlockProfile", ICON_FA_MICROCHIP,
+                      fmt::format(TRANSLATE_FS("OSDMessage", "Failed to dump block profile: {}"), error.GetDescription()));
+                    return;
+                  }
+
+                  Host::AddIconOSDMessage(
+                    OSDMessageType::Quick, "DumpBlockProfile", ICON_FA_MICROCHIP,
+                    fmt::format(TRANSLATE_FS("OSDMessage", "Block profile saved to {}."), Path::GetFileName(path)));
+                }
+              })
+DEFINE_HOTKEY("DumpTimingEventStatistics", TRANSLATE_NOOP("Hotkeys", "Debugging"),
+              TRANSLATE_NOOP("Hotkeys", "Dump Timing Event Statistics"), [](s32 pressed) {
+                if (pressed && System::IsValid())
+                {
+                  if (!g_settings.timing_event_statistics)
+                    return;
+
+                  Error error;
+                  const std::string path = Path::Combine(EmuFolders::DataRoot, "eventstats.txt");
+                  if (!TimingEvents::DumpStatistics(path.c_str(), &error))
+                  {
+                    Host::AddIconOSDMessage(
+                      OSDMessageType::Error, "DumpTimingEventStatistics", ICON_FA_CLOCK,
+                      fmt::format(TRANSLATE_FS("OSDMessage", "Failed to dump timing event statistics: {}"),
+                                  error.GetDescription()));
+                    return;
+                  }
+
+                  Host::AddIconOSDMessage(
+                    OSDMessageType::Quick, "DumpTimingEventStatistics", ICON_FA_CLOCK,
+                    fmt::format(TRANSLATE_FS("OSDMessage", "Timing event statistics saved to {}."),
+                                Path::GetFileName(path)));
+                }
+              })
+DEFINE_HOTKEY("ToggleEventTrace", TRANSLATE_NOOP("Hotkeys", "Debugging"),
+              TRANSLATE_NOOP("Hotkeys", "Toggle Event Trace Recording"), [](s32 pressed) {
+                if (!pressed)
+                  return;
+
+                if (!EventTrace::IsRecording())
+                {
+                  EventTrace::StartRecording();
+                  Host::AddIconOSDMessage(OSDMessageType::Quick, "ToggleEventTrace", ICON_FA_STOPWATCH,
+                                          TRANSLATE_STR("OSDMessage", "Event trace recording started."));
+                  return;
+                }
+
+                EventTrace::StopRecording();
+
+                Error error;
+                const std::string path = Path::Combine(EmuFolders::DataRoot, "trace.json");
+                if (!EventTrace::ExportChromeTrace(path.c_str(), &error))
+                {
+                  Host::AddIconOSDMessage(
+                    OSDMessageType::Error, "ToggleEventTrace", ICON_FA_STOPWATCH,
+                    fmt::format(TRANSLATE_FS("OSDMessage", "Failed to save event trace: {}"), error.GetDescription()));
+                  return;
+                }
+
+                Host::AddIconOSDMessage(
+                  OSDMessageType::Quick, "ToggleEventTrace", ICON_FA_STOPWATCH,
+                  fmt::format(TRANSLATE_FS("OSDMessage", "Event trace saved to {}."), Path::GetFileName(path)));
+              })
 };
 
 std::span<const HotkeyInfo> Core::GetHotkeyList()
@@ -34,6 +34,7 @@
 #include "common/file_system.h"
 #include "common/gsvector.h"
 #include "common/log.h"
+#include "common/memory_accounting.h"
 #include "common/path.h"
 #include "common/string_util.h"
 #include "common/thirdparty/SmallVector.h"
@@ -49,6 +50,7 @@
 #include <array>
 #include <atomic>
 #include <cmath>
+#include <cstring>
 #include <deque>
 #include <mutex>
 #include <span>
@@ -106,13 +108,17 @@ static void SetStatusIndicatorIcons(SmallStringBase& text, bool paused);
 static void DrawPerformanceOverlay(const GPUBackend* gpu, float& position_y, float scale, float margin, float spacing);
 static void DrawMediaCaptureOverlay(float& position_y, float scale, float margin, float spacing);
 static void DrawFrameTimeOverlay(float& position_y, float scale, float margin, float spacing);
+static void DrawCPUTimeBreakdownOverlay(float& position_y, float scale, float margin, float spacing);
+static void DrawGPUTimeBreakdownOverlay(float& position_y, float scale, float margin, float spacing);
 static void DrawEnhancementsOverlay(const GPUBackend* gpu);
 static void DrawInputsOverlay();
 static void UpdateInputOverlay(void* buffer);
 
 #ifndef __ANDROID__
 
-static constexpr size_t NUM_DEBUG_WINDOWS = 7;
+static void DrawMemoryUsageWindow(float scale);
+
+static constexpr size_t NUM_DEBUG_WINDOWS = 8;
 static constexpr const char* DEBUG_WINDOW_CONFIG_SECTION = "DebugWindows";
 static constexpr const std::array<DebugWindowInfo, NUM_DEBUG_WINDOWS> s_debug_window_info = {{
   {"Freecam", "Free Camera", ":icons/applications-system.png", &GTE::DrawFreecamWindow, 510, 500},
@@ -122,6 +128,7 @@ static constexpr const std::array<DebugWindowInfo, NUM_DEBUG_WINDOWS> s_debug_wi
   {"DMA", "DMA State", ":icons/applications-system.png", &DMA::DrawDebugStateWindow, 860, 180},
   {"MDEC", "MDEC State", ":icons/applications-system.png", &MDEC::DrawDebugStateWindow, 300, 350},
   {"Timers", "Timers State", ":icons/applications-system.png", &Timers::DrawDebugStateWindow, 800, 95},
+  {"Memory", "Memory Usage", ":icons/applications-system.png", &DrawMemoryUsageWindow, 500, 400},
 }};
 static std::array<ImGuiManager::AuxiliaryRenderWindowState, NUM_DEBUG_WINDOWS> s_debug_window_state = {};
 
@@ -234,6 +241,83 @@ void ImGuiManager::DestroyAllDebugWindows()
 #endif
 }
 
+#ifndef __ANDROID__
+
+void ImGuiManager::DrawMemoryUsageWindow(float scale)
+{
+  static constexpr auto draw_size = [](s64 bytes) { ImGui::Text("%.2f MB", static_cast<double>(bytes) / 1048576.0); };
+
+  if (!ImGui::BeginTable("memory", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV))
+    return;
+
+  ImGui::TableSetupColumn("Subsystem", ImGuiTableColumnFlags_WidthStretch);
+  ImGui::TableSetupColumn("Host", ImGuiTableColumnFlags_WidthFixed, 100.0f * scale);
+  ImGui::TableSetupColumn("GPU", ImGuiTableColumnFlags_WidthFixed, 100.0f * scale);
+  ImGui::TableHeadersRow();
+
+  // Categories in the same group are adjacent, so each group is one tree node.
+  size_t i = 0;
+  while (i < MemoryAccounting::NUM_CATEGORIES)
+  {
+    const char* group = MemoryAccounting::GetCategoryGroup(static_cast<MemoryAccounting::Category>(i));
+    size_t group_end = i + 1;
+    MemoryAccounting::Usage group_usage = MemoryAccounting::Get(static_cast<MemoryAccounting::Category>(i));
+    for (; group_end < MemoryAccounting::NUM_CATEGORIES &&
+           std::strcmp(MemoryAccounting::GetCategoryGroup(static_cast<MemoryAccounting::Category>(group_end)),
+                       group) == 0;
+         group_end++)
+    {
+      const MemoryAccounting::Usage usage = MemoryAccounting::Get(static_cast<MemoryAccounting::Category>(group_end));
+      group_usage.host_bytes += usage.host_bytes;
+      group_usage.gpu_bytes += usage.gpu_bytes;
+    }
+
+    ImGui::TableNextRow();
+    ImGui::TableNextColumn();
+    const bool open = ImGui::TreeNodeEx(group, ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_SpanFullWidth);
+    ImGui::TableNextColumn();
+    draw_size(group_usage.host_bytes);
+    ImGui::TableNextColumn();
+    draw_size(group_usage.gpu_bytes);
+
+    if (open)
+    {
+      for (; i < group_end; i++)
+      {
+        const MemoryAccounting::Category category = static_cast<MemoryAccounting::Category>(i);
+        const MemoryAccounting::Usage usage = MemoryAccounting::Get(category);
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TreeNodeEx(MemoryAccounting::GetCategoryName(category),
+                          ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen |
+                            ImGuiTreeNodeFlags_SpanFullWidth);
+        ImGui::TableNextColumn();
+        draw_size(usage.host_bytes);
+        ImGui::TableNextColumn();
+        draw_size(usage.gpu_bytes);
+      }
+
+      ImGui::TreePop();
+    }
+
+    i = group_end;
+  }
+
+  // GPU memory of the other categories is a subset of the device's texture total, so it isn't summed again.
+  const MemoryAccounting::Usage total = MemoryAccounting::GetTotal();
+  ImGui::TableNextRow();
+  ImGui::TableNextColumn();
+  ImGui::TextUnformatted("Total");
+  ImGui::TableNextColumn();
+  draw_size(total.host_bytes);
+  ImGui::TableNextColumn();
+  draw_size(total.gpu_bytes);
+
+  ImGui::EndTable();
+}
+
+#endif
+
 void ImGuiManager::RenderTextOverlays(const GPUBackend* gpu)
 {
   // Don't draw anything with loading screen open, it'll be nonsensical.
@@ -375,7 +459,8 @@ void ImGuiManager::DrawPerformanceOverlay(const GPUBackend* gpu, float& position
 
   if (!(g_gpu_settings.display_show_fps || g_gpu_settings.display_show_speed || g_gpu_settings.display_show_gpu_stats ||
         g_gpu_settings.display_show_resolution || g_gpu_settings.display_show_latency_stats ||
-        g_gpu_settings.display_show_cpu_usage || g_gpu_settings.display_show_gpu_usage ||
+        g_gpu_settings.display_show_cpu_usage || g_gpu_settings.display_show_cpu_breakdown ||
+        g_gpu_settings.display_show_gpu_usage || g_gpu_settings.display_show_gpu_breakdown ||
         g_gpu_settings.display_show_frame_times ||
         (g_gpu_settings.display_show_status_indicators &&
          (GPUThread::IsSystemPaused() || System::IsFastForwardEnabled() || System::IsTurboEnabled()))))
@@ -479,6 +564,34 @@ void ImGuiManager::DrawPerformanceOverlay(const GPUBackend* gpu, float& position
                           text);
       position_y += spacing;
 
+      const PerformanceCounters::FrameTimePercentiles& percentiles = PerformanceCounters::GetFrameTimePercentiles();
+      text.format(" {:.2f}ms " BOLD("P50") " | {:.2f}ms " BOLD("P95") " | {:.2f}ms " BOLD("P99") " | {:.2f}ms "
+                    BOLD("P99.9"),
+                  percentiles.p50, percentiles.p95, percentiles.p99, percentiles.p999);
+      DrawPerformanceStat(dl, position_y, fixed_font, fixed_font_size, FIXED_BOLD_WEIGHT, 0, shadow_offset, rbound,
+                          text);
+      position_y += spacing;
+
+      const PerformanceCounters::StutterStatistics& stutters = PerformanceCounters::GetStutterStatistics();
+      if (stutters.count > 0)
+      {
+        text.format(" {} " BOLD("Stutters") " | {:.2f}ms " BOLD("Last") " | ", stutters.count,
+                    stutters.last_frame_time);
+        if (stutters.last_causes == 0)
+          text.append("Unknown");
+        for (u32 i = 0, count = 0; i < PerformanceCounters::NUM_STUTTER_CAUSES; i++)
+        {
+          if (!(stutters.last_causes & (1u << i)))
+            continue;
+
+          const auto cause = static_cast<PerformanceCounters::StutterCause>(i);
+          text.append_format("{}{}", (count++ > 0) ? ", " : "", PerformanceCounters::GetStutterCauseName(cause));
+        }
+        DrawPerformanceStat(dl, position_y, fixed_font, fixed_font_size, FIXED_BOLD_WEIGHT, 0, shadow_offset, rbound,
+                            text);
+        position_y += spacing;
+      }
+
       if (g_settings.cpu_overclock_active || CPU::g_state.using_interpreter ||
           g_settings.cpu_execution_mode != CPUExecutionMode::Recompiler || g_settings.cpu_recompiler_icache ||
           g_settings.cpu_recompiler_memory_exceptions)
@@ -537,6 +650,12 @@ void ImGuiManager::DrawPerformanceOverlay(const GPUBackend* gpu, float& position
       {
         text.assign(BOLD("CAP:") " ");
         FormatProcessorStat(text, cap->GetCaptureThreadUsage(), cap->GetCaptureThreadTime());
+        if (cap->IsCapturingVideo())
+        {
+          text.append_format(" Q: {}/{}", cap->GetVideoQueueFill(), cap->GetVideoQueueDepth());
+          if (const u32 dropped_frames = cap->GetDroppedVideoFrames(); dropped_frames > 0)
+            text.append_format(" Drop: {}", dropped_frames);
+        }
         DrawPerformanceStat(dl, position_y, fixed_font, fixed_font_size, FIXED_BOLD_WEIGHT, 0, shadow_offset, rbound,
                             text);
         position_y += spacing;
@@ -544,6 +663,9 @@ void ImGuiManager::DrawPerformanceOverlay(const GPUBackend* gpu, float& position
 #endif
     }
 
+    if (g_gpu_settings.display_show_cpu_breakdown)
+      DrawCPUTimeBreakdownOverlay(position_y, scale, margin, spacing);
+
     if (g_gpu_settings.display_show_gpu_usage && g_gpu_device->IsGPUTimingEnabled())
     {
       text.assign(BOLD("GPU:") " ");
@@ -553,6 +675,9 @@ void ImGuiManager::DrawPerformanceOverlay(const GPUBackend* gpu, float& position
       position_y += spacing;
     }
 
+    if (g_gpu_settings.display_show_gpu_breakdown && g_gpu_device->IsGPUTimingEnabled())
+      DrawGPUTimeBreakdownOverlay(position_y, scale, margin, spacing);
+
     if (g_gpu_settings.display_show_frame_times)
       DrawFrameTimeOverlay(position_y, scale, margin, spacing);
 
@@ -787,6 +912,138 @@ void ImGuiManager::DrawFrameTimeOverlay(float& position_y, float scale, float ma
   position_y += window_size.y + spacing;
 }
 
+void ImGuiManager::DrawCPUTimeBreakdownOverlay(float& position_y, float scale, float margin, float spacing)
+{
+  using PerformanceCounters::CPUTimeCategory;
+  using PerformanceCounters::NUM_CPU_TIME_CATEGORIES;
+
+  static constexpr std::array<ImU32, NUM_CPU_TIME_CATEGORIES> category_colors = {{
+    IM_COL32(100, 180, 255, 255), // Recompiler
+    IM_COL32(255, 150, 80, 255),  // Interpreter
+    IM_COL32(255, 220, 80, 255),  // GTE
+    IM_COL32(120, 230, 120, 255), // GPU
+    IM_COL32(230, 120, 230, 255), // MDEC
+    IM_COL32(80, 220, 220, 255),  // SPU
+    IM_COL32(255, 110, 110, 255), // CDROM
+    IM_COL32(190, 190, 190, 255), // Events
+  }};
+  static constexpr u32 LEGEND_ENTRIES_PER_LINE = 4;
+
+  const PerformanceCounters::CPUTimeBreakdown& breakdown = PerformanceCounters::GetCPUTimeBreakdown();
+  float total_time = 0.0f;
+  for (const float time : breakdown.category_time)
+    total_time += time;
+  if (total_time <= 0.0f)
+    return;
+
+  ImDrawList* const dl = ImGui::GetBackgroundDrawList();
+  ImFont* const fixed_font = GetFixedFont();
+  const float fixed_font_size = GetFixedFontSize();
+  const float shadow_offset = std::ceil(1.0f * scale);
+  const float rbound = ImGui::GetIO().DisplaySize.x - margin;
+  const float bar_width = std::ceil(200.0f * scale);
+  const float bar_height = std::ceil(8.0f * scale);
+
+  // Segments are stacked left to right in category order.
+  float x = rbound - bar_width;
+  dl->AddRectFilled(ImVec2(x, position_y), ImVec2(rbound, position_y + bar_height), IM_COL32(0, 0, 0, 100));
+  for (u32 i = 0; i < NUM_CPU_TIME_CATEGORIES; i++)
+  {
+    const float segment_width = bar_width * (breakdown.category_time[i] / total_time);
+    if (segment_width <= 0.0f)
+      continue;
+
+    dl->AddRectFilled(ImVec2(x, position_y), ImVec2(x + segment_width, position_y + bar_height), category_colors[i]);
+    x += segment_width;
+  }
+  position_y += bar_height + spacing;
+
+  // Legend underneath in the same colours, skipping anything which didn't run.
+  std::array<std::pair<TinyString, ImU32>, LEGEND_ENTRIES_PER_LINE> line;
+  u32 line_size = 0;
+  const auto draw_line = [&]() {
+    const float space_width = fixed_font->CalcTextSizeA(fixed_font_size, FIXED_BOLD_WEIGHT, FLT_MAX, 0.0f, " ").x;
+    float width = space_width * static_cast<float>(line_size - 1);
+    float height = 0.0f;
+    for (u32 i = 0; i < line_size; i++)
+    {
+      const std::string_view str = line[i].first.view();
+      const ImVec2 size =
+        fixed_font->CalcTextSizeA(fixed_font_size, FIXED_BOLD_WEIGHT, FLT_MAX, 0.0f, IMSTR_START_END(str));
+      width += size.x;
+      height = std::max(height, size.y);
+    }
+
+    ImVec2 pos = ImVec2(rbound - width, position_y);
+    for (u32 i = 0; i < line_size; i++)
+    {
+      const std::string_view str = line[i].first.view();
+      dl->AddText(fixed_font, fixed_font_size, FIXED_BOLD_WEIGHT, ImVec2(pos.x + shadow_offset, pos.y + shadow_offset),
+                  IM_COL32(0, 0, 0, 100), IMSTR_START_END(str));
+      dl->AddText(fixed_font, fixed_font_size, FIXED_BOLD_WEIGHT, pos, line[i].second, IMSTR_START_END(str));
+      pos.x += fixed_font->CalcTextSizeA(fixed_font_size, FIXED_BOLD_WEIGHT, FLT_MAX, 0.0f, IMSTR_START_END(str)).x +
+               space_width;
+    }
+
+    position_y += height;
+    line_size = 0;
+  };
+
+  for (u32 i = 0; i < NUM_CPU_TIME_CATEGORIES; i++)
+  {
+    if (breakdown.category_time[i] < 0.005f)
+      continue;
+
+    line[line_size].first.format("{} {:.2f}ms",
+                                 PerformanceCounters::GetCPUTimeCategoryName(static_cast<CPUTimeCategory>(i)),
+                                 breakdown.category_time[i]);
+    line[line_size].second = category_colors[i];
+    if ((++line_size) == LEGEND_ENTRIES_PER_LINE)
+      draw_line();
+  }
+  if (line_size > 0)
+    draw_line();
+
+  if (breakdown.num_events > 0)
+  {
+    SmallString text;
+    text.assign("\x02" "EVT:" "\x01");
+    for (u32 i = 0; i < breakdown.num_events; i++)
+      text.append_format("{} {} {:.2f}ms", (i == 0) ? "" : " |", breakdown.event_names[i], breakdown.event_time[i]);
+    DrawPerformanceStat(dl, position_y, fixed_font, fixed_font_size, FIXED_BOLD_WEIGHT, 0, shadow_offset, rbound,
+                        text);
+  }
+
+  position_y += spacing;
+}
+
+void ImGuiManager::DrawGPUTimeBreakdownOverlay(float& position_y, float scale, float margin, float spacing)
+{
+  const PerformanceCounters::GPUTimeBreakdown& breakdown = PerformanceCounters::GetGPUTimeBreakdown();
+  if (breakdown.num_scopes == 0)
+    return;
+
+  ImDrawList* const dl = ImGui::GetBackgroundDrawList();
+  ImFont* const fixed_font = GetFixedFont();
+  const float fixed_font_size = GetFixedFontSize();
+  const float shadow_offset = std::ceil(1.0f * scale);
+  const float rbound = ImGui::GetIO().DisplaySize.x - margin;
+
+  // Percentages are of the whole GPU frame time, anything outside a scope (e.g. uploads) makes up the difference.
+  const float frame_time = PerformanceCounters::GetGPUAverageTime();
+  SmallString text;
+  for (u32 i = 0; i < breakdown.num_scopes; i++)
+  {
+    text.format("\x02" "{}:" "\x01" " {:.2f}ms", breakdown.scope_names[i], breakdown.scope_time[i]);
+    if (frame_time > 0.0f)
+      text.append_format(" ({:.0f}%)", (breakdown.scope_time[i] / frame_time) * 100.0f);
+    DrawPerformanceStat(dl, position_y, fixed_font, fixed_font_size, FIXED_BOLD_WEIGHT, 0, shadow_offset, rbound,
+                        text);
+  }
+
+  position_y += spacing;
+}
+
 void ImGuiManager::UpdateInputOverlay()
 {
   static constexpr u32 NORMAL_ICON_COLOR = 0xFFCCCCCCu;
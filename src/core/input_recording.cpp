@@ -0,0 +1,386 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "input_recording.h"
+#include "bus.h"
+#include "controller.h"
+#include "pad.h"
+#include "save_state_version.h"
+#include "system.h"
+
+#include "util/compress_helpers.h"
+
+#include "common/error.h"
+#include "common/string_util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Changes are stored as groups, one for each frame where a binding changed:
+//   varint frame_delta   - frames since the previous group, or since the start frame for the first group
+//   varint change_count
+//   change_count * [u8 port, u8 bind_index, u8 value]
+
+namespace InputRecording {
+
+static bool IsRecordedBinding(const Controller::ControllerBindingInfo& bi);
+static u8 GetRecordedBindState(const Controller* controller, u32 bind_index);
+static void WriteVarInt(std::vector<u8>& buf, u32 value);
+static bool ReadVarInt(std::span<const u8> buf, size_t* pos, u32* value);
+
+} // namespace InputRecording
+
+bool InputRecording::IsRecordedBinding(const Controller::ControllerBindingInfo& bi)
+{
+  return (bi.type == InputBindingInfo::Type::Button || bi.type == InputBindingInfo::Type::Axis ||
+          bi.type == InputBindingInfo::Type::HalfAxis);
+}
+
+u8 InputRecording::GetRecordedBindState(const Controller* controller, u32 bind_index)
+{
+  // Controllers quantize to 8 bits internally anyway.
+  const float value = std::clamp(controller->GetBindState(bind_index), 0.0f, 1.0f);
+  return static_cast<u8>(std::lround(value * 255.0f));
+}
+
+void InputRecording::WriteVarInt(std::vector<u8>& buf, u32 value)
+{
+  while (value >= 0x80)
+  {
+    buf.push_back(static_cast<u8>(value) | 0x80);
+    value >>= 7;
+  }
+  buf.push_back(static_cast<u8>(value));
+}
+
+bool InputRecording::ReadVarInt(std::span<const u8> buf, size_t* pos, u32* value)
+{
+  u32 result = 0;
+  for (u32 shift = 0; shift < 32; shift += 7)
+  {
+    if (*pos >= buf.size())
+      return false;
+
+    const u8 byte = buf[(*pos)++];
+    result |= static_cast<u32>(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+    {
+      *value = result;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+InputRecording::Recorder::Recorder(std::string path) : m_path(std::move(path))
+{
+}
+
+InputRecording::Recorder::~Recorder() = default;
+
+std::unique_ptr<InputRecording::Recorder> InputRecording::Recorder::Create(std::string path, Error* error)
+{
+  std::unique_ptr<Recorder> ret(new Recorder(std::move(path)));
+  ret->m_state_data.resize(System::GetMaxSaveStateSize(Bus::g_ram_size > Bus::RAM_2MB_SIZE));
+
+  size_t state_size;
+  if (!System::SaveStateDataToBuffer(ret->m_state_data, &state_size, error))
+  {
+    Error::AddPrefix(error, "Failed to save anchor state: ");
+    return {};
+  }
+  ret->m_state_data.resize(state_size);
+
+  FileHeader& header = ret->m_header;
+  header.magic = FILE_MAGIC;
+  header.version = FILE_VERSION;
+  header.save_state_version = SAVE_STATE_VERSION;
+  header.save_state_size = static_cast<u32>(state_size);
+  header.start_frame = System::GetFrameNumber();
+  StringUtil::Strlcpy(header.serial, System::GetGameSerial(), sizeof(header.serial));
+  for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
+  {
+    const Controller* controller = Pad::GetController(i);
+    header.controller_types[i] = controller ? controller->GetType() : ControllerType::None;
+    if (!controller)
+      continue;
+
+    // Everything starts released, so the first group holds the input at the start frame.
+    u32 bind_count = 0;
+    for (const Controller::ControllerBindingInfo& bi : Controller::GetControllerInfo(controller->GetType()).bindings)
+      bind_count = std::max(bind_count, bi.bind_index + 1);
+    ret->m_last_values[i].resize(bind_count, 0);
+  }
+
+  ret->m_last_frame = header.start_frame;
+  ret->m_last_change_frame = header.start_frame;
+  ret->RecordChanges(header.start_frame);
+  return ret;
+}
+
+bool InputRecording::Recorder::RecordFrame(u32 frame_number, Error* error)
+{
+  // Playback only follows consecutive frames, so skipping ahead is as bad as going backwards.
+  if (frame_number != (m_last_frame + 1))
+  {
+    Error::SetStringFmt(error, "Frame {} does not follow frame {}, a state was loaded or rewound.", frame_number,
+                        m_last_frame);
+    return false;
+  }
+
+  for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
+  {
+    // Swapping controllers mid-recording would make the binding indices meaningless.
+    const Controller* controller = Pad::GetController(i);
+    if ((controller ? controller->GetType() : ControllerType::None) != m_header.controller_types[i])
+    {
+      Error::SetStringFmt(error, "Controller in port {} was changed.", i + 1);
+      return false;
+    }
+  }
+
+  m_last_frame = frame_number;
+  RecordChanges(frame_number);
+  return true;
+}
+
+void InputRecording::Recorder::RecordChanges(u32 frame_number)
+{
+  m_pending_changes.clear();
+  for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
+  {
+    const Controller* controller = Pad::GetController(i);
+    if (!controller)
+      continue;
+
+    std::vector<u8>& last_values = m_last_values[i];
+    for (const Controller::ControllerBindingInfo& bi : Controller::GetControllerInfo(controller->GetType()).bindings)
+    {
+      if (!IsRecordedBinding(bi))
+        continue;
+
+      const u8 value = GetRecordedBindState(controller, bi.bind_index);
+      if (value == last_values[bi.bind_index])
+        continue;
+
+      last_values[bi.bind_index] = value;
+      m_pending_changes.push_back(static_cast<u8>(i));
+      m_pending_changes.push_back(static_cast<u8>(bi.bind_index));
+      m_pending_changes.push_back(value);
+    }
+  }
+
+  if (m_pending_changes.empty())
+    return;
+
+  WriteVarInt(m_changes, frame_number - m_last_change_frame);
+  WriteVarInt(m_changes, static_cast<u32>(m_pending_changes.size() / 3));
+  m_changes.insert(m_changes.end(), m_pending_changes.begin(), m_pending_changes.end());
+  m_last_change_frame = frame_number;
+  m_header.change_frame_count++;
+}
+
+bool InputRecording::Recorder::Close(Error* error)
+{
+  m_header.frame_count = GetFrameCount();
+
+  DynamicHeapArray<u8> data(sizeof(FileHeader) + m_state_data.size() + m_changes.size());
+  std::memcpy(data.data(), &m_header, sizeof(FileHeader));
+  std::memcpy(data.data() + sizeof(FileHeader), m_state_data.data(), m_state_data.size());
+  if (!m_changes.empty())
+    std::memcpy(data.data() + sizeof(FileHeader) + m_state_data.size(), m_changes.data(), m_changes.size());
+
+  if (!CompressHelpers::CompressToFile(CompressHelpers::CompressType::Zstandard, m_path.c_str(), data.cspan(), -1,
+                                       true, error))
+  {
+    Error::AddPrefixFmt(error, "Failed to write '{}': ", m_path);
+    return false;
+  }
+
+  return true;
+}
+
+InputRecording::Player::Player(std::string path, DynamicHeapArray<u8> data)
+  : m_data(std::move(data)), m_path(std::move(path))
+{
+}
+
+InputRecording::Player::~Player() = default;
+
+std::unique_ptr<InputRecording::Player> InputRecording::Player::Open(std::string path, Error* error)
+{
+  CompressHelpers::OptionalByteBuffer data =
+    CompressHelpers::DecompressFile(CompressHelpers::CompressType::Zstandard, path.c_str(), std::nullopt, error);
+  if (!data.has_value())
+  {
+    Error::AddPrefixFmt(error, "Failed to read '{}': ", path);
+    return {};
+  }
+
+  std::unique_ptr<Player> ret(new Player(std::move(path), std::move(data.value())));
+  if (!ret->Parse(error))
+    return {};
+
+  return ret;
+}
+
+bool InputRecording::Player::Parse(Error* error)
+{
+  if (m_data.size() < sizeof(FileHeader))
+  {
+    Error::SetStringView(error, "File is too small.");
+    return false;
+  }
+
+  std::memcpy(&m_header, m_data.data(), sizeof(FileHeader));
+  m_header.serial[sizeof(m_header.serial) - 1] = '\0';
+  if (m_header.magic != FILE_MAGIC || m_header.version != FILE_VERSION)
+  {
+    Error::SetStringView(error, "File is not an input recording, or was created by a different version.");
+    return false;
+  }
+  else if (m_header.save_state_version < SAVE_STATE_MINIMUM_VERSION ||
+           m_header.save_state_version > SAVE_STATE_VERSION)
+  {
+    Error::SetStringFmt(error, "Anchor state version {} is not supported, this build supports {} to {}.",
+                        m_header.save_state_version, SAVE_STATE_MINIMUM_VERSION, SAVE_STATE_VERSION);
+    return false;
+  }
+  else if ((m_data.size() - sizeof(FileHeader)) < m_header.save_state_size)
+  {
+    Error::SetStringView(error, "Anchor state is truncated.");
+    return false;
+  }
+
+  for (ControllerType type : m_header.controller_types)
+  {
+    if (type >= ControllerType::Count)
+    {
+      Error::SetStringFmt(error, "Unknown controller type {}.", static_cast<u32>(type));
+      return false;
+    }
+  }
+
+  m_state_offset = sizeof(FileHeader);
+  m_changes_offset = m_state_offset + m_header.save_state_size;
+
+  // Check the whole stream up front, so playback doesn't have to.
+  const std::span<const u8> changes = m_data.cspan().subspan(m_changes_offset);
+  size_t pos = 0;
+  u32 frame = m_header.start_frame;
+  for (u32 i = 0; i < m_header.change_frame_count; i++)
+  {
+    u32 frame_delta, change_count;
+    if (!ReadVarInt(changes, &pos, &frame_delta) || !ReadVarInt(changes, &pos, &change_count) ||
+        (changes.size() - pos) / 3 < change_count)
+    {
+      Error::SetStringFmt(error, "Input changes are truncated at group {}.", i);
+      return false;
+    }
+
+    frame += frame_delta;
+    for (u32 j = 0; j < change_count; j++, pos += 3)
+    {
+      const u8 port = changes[pos];
+      const u8 bind_index = changes[pos + 1];
+      if (port >= NUM_CONTROLLER_AND_CARD_PORTS || m_header.controller_types[port] == ControllerType::None)
+      {
+        Error::SetStringFmt(error, "Input change for unused port {} at frame {}.", port, frame);
+        return false;
+      }
+
+      const Controller::ControllerInfo& cinfo = Controller::GetControllerInfo(m_header.controller_types[port]);
+      if (std::none_of(cinfo.bindings.begin(), cinfo.bindings.end(),
+                       [bind_index](const Controller::ControllerBindingInfo& bi) {
+                         return (bi.bind_index == bind_index && IsRecordedBinding(bi));
+                       }))
+      {
+        Error::SetStringFmt(error, "Invalid binding {} for port {} at frame {}.", bind_index, port, frame);
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool InputRecording::Player::Start(Error* error)
+{
+  if (!System::LoadStateDataFromBuffer(m_data.cspan().subspan(m_state_offset, m_header.save_state_size),
+                                       m_header.save_state_version, error, true))
+  {
+    Error::AddPrefix(error, "Failed to load anchor state: ");
+    return false;
+  }
+
+  for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
+  {
+    Controller* controller = Pad::GetController(i);
+    const ControllerType type = controller ? controller->GetType() : ControllerType::None;
+    if (type != m_header.controller_types[i])
+    {
+      Error::SetStringFmt(error, "Port {} has a {} connected, but the recording was made with a {}.", i + 1,
+                          Controller::GetControllerInfo(type).GetDisplayName(),
+                          Controller::GetControllerInfo(m_header.controller_types[i]).GetDisplayName());
+      return false;
+    }
+
+    // Recordings start with everything released.
+    if (controller)
+    {
+      for (const Controller::ControllerBindingInfo& bi : Controller::GetControllerInfo(type).bindings)
+      {
+        if (IsRecordedBinding(bi))
+          controller->SetBindState(bi.bind_index, 0.0f);
+      }
+    }
+  }
+
+  m_changes_position = m_changes_offset;
+  m_changes_remaining = m_header.change_frame_count;
+  m_next_change_frame = m_header.start_frame;
+  if (m_changes_remaining > 0)
+  {
+    u32 frame_delta;
+    ReadVarInt(m_data.cspan(), &m_changes_position, &frame_delta);
+    m_next_change_frame += frame_delta;
+  }
+
+  m_last_frame = m_header.start_frame;
+  ApplyChanges(m_last_frame);
+  return true;
+}
+
+bool InputRecording::Player::PlayFrame(u32 frame_number)
+{
+  if (frame_number != (m_last_frame + 1))
+    return false;
+
+  m_last_frame = frame_number;
+  ApplyChanges(frame_number);
+  return (frame_number - m_header.start_frame) < m_header.frame_count;
+}
+
+void InputRecording::Player::ApplyChanges(u32 frame_number)
+{
+  if (m_changes_remaining == 0 || m_next_change_frame != frame_number)
+    return;
+
+  const std::span<const u8> data = m_data.cspan();
+  u32 change_count;
+  ReadVarInt(data, &m_changes_position, &change_count);
+  for (u32 i = 0; i < change_count; i++, m_changes_position += 3)
+  {
+    Controller* controller = Pad::GetController(data[m_changes_position]);
+    controller->SetBindState(data[m_changes_position + 1], static_cast<float>(data[m_changes_position + 2]) / 255.0f);
+  }
+
+  if (--m_changes_remaining > 0)
+  {
+    u32 frame_delta;
+    ReadVarInt(data, &m_changes_position, &frame_delta);
+    m_next_change_frame += frame_delta;
+  }
+}
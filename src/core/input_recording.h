@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#pragma once
+
+#include "types.h"
+
+#include "common/heap_array.h"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Error;
+
+/// Records controller input against system frame numbers, so the same gameplay can be replayed exactly, e.g. for
+/// benchmarking. A recording starts with a save state of the frame it was started on, followed by the binding values
+/// of every controller which changed at the end of each frame, when input is polled. The whole file is compressed.
+///
+/// Only button and axis bindings are recorded. Pointer positions for light guns and mice come from the host, and are
+/// not part of a recording.
+namespace InputRecording {
+
+inline constexpr u32 FILE_MAGIC = 0x52495344; // DSIR
+inline constexpr u32 FILE_VERSION = 1;
+inline constexpr const char* FILE_EXTENSION = "dsinput";
+
+struct FileHeader
+{
+  u32 magic;
+  u32 version;
+  u32 save_state_version;
+  u32 save_state_size;
+  u32 start_frame;
+  u32 frame_count;
+  u32 change_frame_count;
+  std::array<ControllerType, NUM_CONTROLLER_AND_CARD_PORTS> controller_types;
+  char serial[32];
+};
+
+class Recorder
+{
+public:
+  ~Recorder();
+
+  /// Saves the anchor state and starts recording from the current frame.
+  static std::unique_ptr<Recorder> Create(std::string path, Error* error);
+
+  ALWAYS_INLINE const std::string& GetPath() const { return m_path; }
+  ALWAYS_INLINE u32 GetFrameCount() const { return m_last_frame - m_header.start_frame; }
+
+  /// Records any binding changes since the last frame. Returns false if the recording can't be continued, because the
+  /// frame doesn't follow on from the last one, i.e. a state was loaded, or a controller was changed.
+  bool RecordFrame(u32 frame_number, Error* error);
+
+  /// Compresses and writes the recording.
+  bool Close(Error* error);
+
+private:
+  Recorder(std::string path);
+
+  void RecordChanges(u32 frame_number);
+
+  FileHeader m_header = {};
+  DynamicHeapArray<u8> m_state_data;
+  std::vector<u8> m_changes;
+  std::vector<u8> m_pending_changes;
+  std::array<std::vector<u8>, NUM_CONTROLLER_AND_CARD_PORTS> m_last_values;
+  u32 m_last_frame = 0;
+  u32 m_last_change_frame = 0;
+
+  std::string m_path;
+};
+
+class Player
+{
+public:
+  ~Player();
+
+  static std::unique_ptr<Player> Open(std::string path, Error* error);
+
+  ALWAYS_INLINE const std::string& GetPath() const { return m_path; }
+  ALWAYS_INLINE const char* GetSerial() const { return m_header.serial; }
+  ALWAYS_INLINE u32 GetFrameCount() const { return m_header.frame_count; }
+
+  /// Loads the anchor state into the running system, and applies the input for its frame.
+  bool Start(Error* error);
+
+  /// Applies the recorded input for the frame which was just completed. Returns false once the recording has ended,
+  /// or when the frame doesn't follow on from the last one, i.e. a state was loaded.
+  bool PlayFrame(u32 frame_number);
+
+private:
+  Player(std::string path, DynamicHeapArray<u8> data);
+
+  bool Parse(Error* error);
+  void ApplyChanges(u32 frame_number);
+
+  FileHeader m_header = {};
+  DynamicHeapArray<u8> m_data;
+  size_t m_state_offset = 0;
+  size_t m_changes_offset = 0;
+  size_t m_changes_position = 0;
+  u32 m_changes_remaining = 0;
+  u32 m_next_change_frame = 0;
+  u32 m_last_frame = 0;
+
+  std::string m_path;
+};
+
+} // namespace InputRecording
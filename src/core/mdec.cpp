@@ -2,9 +2,11 @@
 // SPDX-License-Identifier: CC-BY-NC-ND-4.0
 
 #include "mdec.h"
+#include "mdec_idct.h"
 #include "cdrom.h"
 #include "cpu_core.h"
 #include "dma.h"
+#include "performance_counters.h"
 #include "system.h"
 #include "timing_event.h"
 
@@ -15,11 +17,14 @@
 #include "common/fifo_queue.h"
 #include "common/gsvector.h"
 #include "common/log.h"
+#include "common/threading.h"
 
 #include "imgui.h"
 
 #include <array>
+#include <atomic>
 #include <memory>
+#include <thread>
 
 LOG_CHANNEL(MDEC);
 
@@ -115,6 +120,14 @@ static bool DecodeColoredMacroblock();
 static void ScheduleBlockCopyOut(TickCount ticks);
 static void CopyOutBlock(void* param, TickCount ticks, TickCount ticks_late);
 
+static void StartDecodeThread();
+static void StopDecodeThread();
+static bool IsUsingDecodeThread();
+static void WaitForDecodeThread();
+static void DecodeThreadEntryPoint();
+static void FlushPendingIDCT();
+static void ConvertColoredMacroblock(bool output_signed);
+
 static bool DecodeRLE_Old(s16* blk, const u8* qt);
 static void IDCT_Old(s16* blk);
 static void YUVToRGB_Old(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const std::array<s16, 64>& Cbblk,
@@ -123,7 +136,7 @@ static void YUVToRGB_Old(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const
 static bool DecodeRLE_New(s16* blk, const u8* qt);
 static void IDCT_New(s16* blk);
 static void YUVToRGB_New(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const std::array<s16, 64>& Cbblk,
-                         const std::array<s16, 64>& Yblk);
+                         const std::array<s16, 64>& Yblk, bool output_signed);
 
 static void YUVToMono(const std::array<s16, 64>& Yblk);
 
@@ -161,7 +174,25 @@ struct MDECState
 };
 } // namespace
 
+// The worker only ever has one macroblock in flight. It owns blocks and block_rgb from submission until
+// WaitForDecodeThread() returns, and the CPU thread waits before anything else touches them.
+struct DecodeThreadState
+{
+  std::thread thread;
+  Threading::KernelSemaphore work_sema;
+  Threading::KernelSemaphore done_sema;
+  std::atomic_bool shutdown{false};
+  bool output_signed = false;
+  bool busy = false;
+
+  // Blocks of the current macroblock which still need the IDCT, either queued for the worker or left over from when
+  // the thread was toggled mid-macroblock.
+  u8 pending_idct_mask = 0;
+  u8 work_idct_mask = 0;
+};
+
 ALIGN_TO_CACHE_LINE static MDECState s_state;
+static DecodeThreadState s_decode_thread;
 } // namespace MDEC
 
 void MDEC::Initialize()
@@ -171,13 +202,28 @@ void MDEC::Initialize()
 #endif
   s_state.active_frame_count = 0;
   Reset();
+
+  if (g_settings.mdec_use_thread)
+    StartDecodeThread();
 }
 
 void MDEC::Shutdown()
 {
+  StopDecodeThread();
   s_state.block_copy_out_event.Deactivate();
 }
 
+void MDEC::SetUseThread(bool enabled)
+{
+  if (enabled == IsUsingDecodeThread())
+    return;
+
+  if (enabled)
+    StartDecodeThread();
+  else
+    StopDecodeThread();
+}
+
 void MDEC::Reset()
 {
   s_state.active_frame_count = 0;
@@ -187,6 +233,10 @@ void MDEC::Reset()
 
 bool MDEC::DoState(StateWrapper& sw)
 {
+  // Save states always hold transformed blocks.
+  WaitForDecodeThread();
+  FlushPendingIDCT();
+
   sw.Do(&s_state.status.bits);
   sw.Do(&s_state.enable_dma_in);
   sw.Do(&s_state.enable_dma_out);
@@ -329,6 +379,8 @@ bool MDEC::HasPendingBlockCopyOut()
 
 void MDEC::SoftReset()
 {
+  WaitForDecodeThread();
+
   s_state.status.bits = 0;
   s_state.enable_dma_in = false;
   s_state.enable_dma_out = false;
@@ -345,6 +397,7 @@ void MDEC::SoftReset()
 
 void MDEC::ResetDecoder()
 {
+  s_decode_thread.pending_idct_mask = 0;
   s_state.current_block = 0;
   s_state.current_coefficient = 64;
   s_state.current_q_scale = 0;
@@ -408,6 +461,7 @@ void MDEC::WriteCommandRegister(u32 value)
 
 void MDEC::Execute()
 {
+  PerformanceCounters::CPUTimeScope cpu_time_scope(PerformanceCounters::CPUTimeCategory::MDEC);
   if (std::exchange(s_state.active_frame_count, ACTIVE_FRAME_COUNT) == 0)
   {
     if (g_settings.mdec_disable_cdrom_speedup)
@@ -617,7 +671,11 @@ bool MDEC::DecodeColoredMacroblock()
                          (s_state.current_block >= 2) ? s_state.iq_y.data() : s_state.iq_uv.data()))
         return false;
 
-      IDCT_New(s_state.blocks[s_state.current_block].data());
+      // The worker thread does the IDCT along with the colour conversion.
+      if (IsUsingDecodeThread())
+        s_decode_thread.pending_idct_mask |= static_cast<u8>(1u << s_state.current_block);
+      else
+        IDCT_New(s_state.blocks[s_state.current_block].data());
     }
 
     if (!s_state.data_out_fifo.IsEmpty())
@@ -625,13 +683,24 @@ bool MDEC::DecodeColoredMacroblock()
 
     // done decoding
     DEBUG_LOG("Decoded colored macroblock, {} words remaining", s_state.remaining_halfwords / 2);
+
+    if (IsUsingDecodeThread())
+    {
+      // Only needed by the time the copy out event fires.
+      DebugAssert(!s_decode_thread.busy);
+      s_decode_thread.work_idct_mask = s_decode_thread.pending_idct_mask;
+      s_decode_thread.output_signed = s_state.status.data_output_signed;
+      s_decode_thread.busy = true;
+      s_decode_thread.work_sema.Post();
+    }
+    else
+    {
+      FlushPendingIDCT();
+      ConvertColoredMacroblock(s_state.status.data_output_signed);
+    }
+
     ResetDecoder();
     s_state.state = State::WritingMacroblock;
-
-    YUVToRGB_New(0, 0, s_state.blocks[0], s_state.blocks[1], s_state.blocks[2]);
-    YUVToRGB_New(8, 0, s_state.blocks[0], s_state.blocks[1], s_state.blocks[3]);
-    YUVToRGB_New(0, 8, s_state.blocks[0], s_state.blocks[1], s_state.blocks[4]);
-    YUVToRGB_New(8, 8, s_state.blocks[0], s_state.blocks[1], s_state.blocks[5]);
   }
 
 #if defined(_DEBUG) || defined(_DEVEL)
@@ -652,8 +721,10 @@ void MDEC::ScheduleBlockCopyOut(TickCount ticks)
 
 void MDEC::CopyOutBlock(void* param, TickCount ticks, TickCount ticks_late)
 {
+  PerformanceCounters::CPUTimeScope cpu_time_scope(PerformanceCounters::CPUTimeCategory::MDEC);
   Assert(s_state.state == State::WritingMacroblock);
   s_state.block_copy_out_event.Deactivate();
+  WaitForDecodeThread();
 
   switch (s_state.status.data_output_depth)
   {
@@ -1049,41 +1120,20 @@ bool MDEC::DecodeRLE_New(s16* blk, const u8* qt)
   return false;
 }
 
-static s16 IDCTRow(const s16* blk, const s16* idct_matrix)
-{
-  // IDCT matrix is -32768..32767, block is -16384..16383. 4 adds can happen without overflow.
-  GSVector4i sum = GSVector4i::load<false>(blk).madd_s16(GSVector4i::load<true>(idct_matrix)).addp_s32();
-  return static_cast<s16>(((static_cast<s64>(sum.extract32<0>()) + static_cast<s64>(sum.extract32<1>())) + 0x20000) >>
-                          18);
-}
-
 void MDEC::IDCT_New(s16* blk)
 {
-  alignas(VECTOR_ALIGNMENT) std::array<s16, 64> temp;
-  for (u32 x = 0; x < 8; x++)
-  {
-    for (u32 y = 0; y < 8; y++)
-      temp[y * 8 + x] = IDCTRow(&blk[x * 8], &s_state.scale_table[y * 8]);
-  }
-  for (u32 x = 0; x < 8; x++)
-  {
-    for (u32 y = 0; y < 8; y++)
-    {
-      const s32 sum = IDCTRow(&temp[x * 8], &s_state.scale_table[y * 8]);
-      blk[x * 8 + y] = static_cast<s16>(std::clamp(SignExtendN<9, s32>(sum), -128, 127));
-    }
-  }
+  IDCTBlock(blk, s_state.scale_table.data());
 }
 
 void MDEC::YUVToRGB_New(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const std::array<s16, 64>& Cbblk,
-                        const std::array<s16, 64>& Yblk)
+                        const std::array<s16, 64>& Yblk, bool output_signed)
 {
-  const GSVector4i addval = s_state.status.data_output_signed ? GSVector4i::cxpr(0) : GSVector4i::cxpr(0x80808080);
-  for (u32 y = 0; y < 8; y++)
+  const GSVector4i addval = output_signed ? GSVector4i::cxpr(0) : GSVector4i::cxpr(0x80808080);
+  for (u32 y = 0; y < 8; y += 2)
   {
+    // Each chroma row covers two luma rows.
     const GSVector4i Cr = GSVector4i::loadl<false>(&Crblk[(xx / 2) + ((y + yy) / 2) * 8]).s16to32();
     const GSVector4i Cb = GSVector4i::loadl<false>(&Cbblk[(xx / 2) + ((y + yy) / 2) * 8]).s16to32();
-    const GSVector4i Y = GSVector4i::load<true>(&Yblk[y * 8]);
 
     // BT.601 YUV->RGB coefficients, rounding formula from Mednafen.
     // r = clamp(sext9(Y + (((359 * Cr) + 0x80) >> 8)), -128, 127) + addval;
@@ -1099,20 +1149,104 @@ void MDEC::YUVToRGB_New(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const
                                  .add32(GSVector4i::cxpr(0x80))
                                  .sra32<8>()
                                  .ps32();
-    const GSVector4i r = Crmul.upl16(Crmul).add16(Y).sll16<7>().sra16<7>().ps16().add8(addval);
-    const GSVector4i g = CrCbmul.upl16(CrCbmul).add16(Y).sll16<7>().sra16<7>().ps16().add8(addval);
-    const GSVector4i b = Cbmul.upl16(Cbmul).add16(Y).sll16<7>().sra16<7>().ps16().add8(addval);
-    const GSVector4i rg = r.upl8(g);
-    const GSVector4i b0 = b.upl8();
-    const GSVector4i rgblow = rg.upl16(b0);
-    const GSVector4i rgbhigh = rg.uph16(b0);
-
-    u32* const out_row = &s_state.block_rgb[xx + ((y + yy) * 16)];
-    GSVector4i::store<false>(&out_row[0], rgblow);
-    GSVector4i::store<false>(&out_row[4], rgbhigh);
+    const GSVector4i Crmul2 = Crmul.upl16(Crmul);
+    const GSVector4i CrCbmul2 = CrCbmul.upl16(CrCbmul);
+    const GSVector4i Cbmul2 = Cbmul.upl16(Cbmul);
+
+    for (u32 i = 0; i < 2; i++)
+    {
+      const GSVector4i Y = GSVector4i::load<true>(&Yblk[(y + i) * 8]);
+      const GSVector4i r = Crmul2.add16(Y).sll16<7>().sra16<7>().ps16().add8(addval);
+      const GSVector4i g = CrCbmul2.add16(Y).sll16<7>().sra16<7>().ps16().add8(addval);
+      const GSVector4i b = Cbmul2.add16(Y).sll16<7>().sra16<7>().ps16().add8(addval);
+      const GSVector4i rg = r.upl8(g);
+      const GSVector4i b0 = b.upl8();
+      const GSVector4i rgblow = rg.upl16(b0);
+      const GSVector4i rgbhigh = rg.uph16(b0);
+
+      u32* const out_row = &s_state.block_rgb[xx + ((y + i + yy) * 16)];
+      GSVector4i::store<false>(&out_row[0], rgblow);
+      GSVector4i::store<false>(&out_row[4], rgbhigh);
+    }
   }
 }
 
+void MDEC::ConvertColoredMacroblock(bool output_signed)
+{
+  YUVToRGB_New(0, 0, s_state.blocks[0], s_state.blocks[1], s_state.blocks[2], output_signed);
+  YUVToRGB_New(8, 0, s_state.blocks[0], s_state.blocks[1], s_state.blocks[3], output_signed);
+  YUVToRGB_New(0, 8, s_state.blocks[0], s_state.blocks[1], s_state.blocks[4], output_signed);
+  YUVToRGB_New(8, 8, s_state.blocks[0], s_state.blocks[1], s_state.blocks[5], output_signed);
+}
+
+void MDEC::StartDecodeThread()
+{
+  DebugAssert(!IsUsingDecodeThread());
+  s_decode_thread.shutdown.store(false, std::memory_order_release);
+  s_decode_thread.busy = false;
+  s_decode_thread.thread = std::thread(&MDEC::DecodeThreadEntryPoint);
+  INFO_LOG("MDEC decode thread started.");
+}
+
+void MDEC::StopDecodeThread()
+{
+  if (!IsUsingDecodeThread())
+    return;
+
+  WaitForDecodeThread();
+  s_decode_thread.shutdown.store(true, std::memory_order_release);
+  s_decode_thread.work_sema.Post();
+  s_decode_thread.thread.join();
+  INFO_LOG("MDEC decode thread stopped.");
+}
+
+bool MDEC::IsUsingDecodeThread()
+{
+  return s_decode_thread.thread.joinable();
+}
+
+void MDEC::WaitForDecodeThread()
+{
+  if (!s_decode_thread.busy)
+    return;
+
+  s_decode_thread.done_sema.Wait();
+  s_decode_thread.busy = false;
+}
+
+void MDEC::DecodeThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("MDEC Decode");
+  Threading::ApplyBackgroundWorkerAffinity();
+
+  for (;;)
+  {
+    s_decode_thread.work_sema.Wait();
+    if (s_decode_thread.shutdown.load(std::memory_order_acquire))
+      break;
+
+    for (u32 i = 0; i < NUM_BLOCKS; i++)
+    {
+      if (s_decode_thread.work_idct_mask & (1u << i))
+        IDCT_New(s_state.blocks[i].data());
+    }
+    ConvertColoredMacroblock(s_decode_thread.output_signed);
+
+    s_decode_thread.done_sema.Post();
+  }
+}
+
+void MDEC::FlushPendingIDCT()
+{
+  for (u32 i = 0; i < NUM_BLOCKS; i++)
+  {
+    if (s_decode_thread.pending_idct_mask & (1u << i))
+      IDCT_New(s_state.blocks[i].data());
+  }
+
+  s_decode_thread.pending_idct_mask = 0;
+}
+
 void MDEC::YUVToMono(const std::array<s16, 64>& Yblk)
 {
   const s32 addval = s_state.status.data_output_signed ? 0 : 0x80;
@@ -14,6 +14,9 @@ void Shutdown();
 void Reset();
 bool DoState(StateWrapper& sw);
 
+/// Moves IDCT and colour conversion of macroblocks to a worker thread.
+void SetUseThread(bool enabled);
+
 bool IsActive();
 bool IsDecodingMacroblock();
 void EndFrame();
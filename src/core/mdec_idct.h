@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#pragma once
+
+#include "common/gsvector.h"
+#include "common/types.h"
+
+#include <array>
+
+// Vectorized IDCT used by the new MDEC implementation. In a header so that the tests can check it against a scalar
+// reference.
+namespace MDEC {
+
+/// Same as ((s64(a) + s64(b) + 0x20000) >> 18), without needing 64-bit lanes.
+ALWAYS_INLINE GSVector4i IDCTRound(const GSVector4i a, const GSVector4i b)
+{
+  const GSVector4i frac_mask = GSVector4i::cxpr(0x3FFFF);
+  const GSVector4i frac = (a & frac_mask).add32(b & frac_mask).add32(GSVector4i::cxpr(0x20000)).sra32<18>();
+  return a.sra32<18>().add32(b.sra32<18>()).add32(frac);
+}
+
+/// Multiplies one row of the block with all 8 rows of the IDCT matrix. Each 32-bit lane of row is a pair of
+/// coefficients, and matrix holds the matching pairs from each matrix row, for outputs 0-3 followed by 4-7.
+ALWAYS_INLINE GSVector4i IDCTRow(const GSVector4i row, const GSVector4i* matrix)
+{
+  // IDCT matrix is -32768..32767, block is -16384..16383. 4 adds can happen without overflow.
+  const GSVector4i p0 = row.xxxx();
+  const GSVector4i p1 = row.yyyy();
+  const GSVector4i p2 = row.zzzz();
+  const GSVector4i p3 = row.wwww();
+  const GSVector4i lo = IDCTRound(p0.madd_s16(matrix[0]).add32(p1.madd_s16(matrix[1])),
+                                  p2.madd_s16(matrix[2]).add32(p3.madd_s16(matrix[3])));
+  const GSVector4i hi = IDCTRound(p0.madd_s16(matrix[4]).add32(p1.madd_s16(matrix[5])),
+                                  p2.madd_s16(matrix[6]).add32(p3.madd_s16(matrix[7])));
+
+  // Sums are at most 2^32, so the results always fit in 16 bits.
+  return lo.ps32(hi);
+}
+
+/// Applies the IDCT to a row-major block. scale_table must be vector aligned.
+ALWAYS_INLINE void IDCTBlock(s16* blk, const s16* scale_table)
+{
+  // Transpose the matrix as 32-bit coefficient pairs, so that one madd covers a pair for four outputs.
+  std::array<GSVector4i, 8> matrix;
+  for (u32 i = 0; i < 2; i++)
+  {
+    const GSVector4i m0 = GSVector4i::load<true>(&scale_table[(i * 4 + 0) * 8]);
+    const GSVector4i m1 = GSVector4i::load<true>(&scale_table[(i * 4 + 1) * 8]);
+    const GSVector4i m2 = GSVector4i::load<true>(&scale_table[(i * 4 + 2) * 8]);
+    const GSVector4i m3 = GSVector4i::load<true>(&scale_table[(i * 4 + 3) * 8]);
+    const GSVector4i t0 = m0.upl32(m1);
+    const GSVector4i t1 = m2.upl32(m3);
+    const GSVector4i t2 = m0.uph32(m1);
+    const GSVector4i t3 = m2.uph32(m3);
+    matrix[i * 4 + 0] = t0.upl64(t1);
+    matrix[i * 4 + 1] = t0.uph64(t1);
+    matrix[i * 4 + 2] = t2.upl64(t3);
+    matrix[i * 4 + 3] = t2.uph64(t3);
+  }
+
+  // First pass produces the temporary block transposed, one column per row of the input.
+  std::array<GSVector4i, 8> cols;
+  for (u32 x = 0; x < 8; x++)
+    cols[x] = IDCTRow(GSVector4i::load<false>(&blk[x * 8]), matrix.data());
+
+  const GSVector4i a0 = cols[0].upl16(cols[1]);
+  const GSVector4i a1 = cols[0].uph16(cols[1]);
+  const GSVector4i a2 = cols[2].upl16(cols[3]);
+  const GSVector4i a3 = cols[2].uph16(cols[3]);
+  const GSVector4i a4 = cols[4].upl16(cols[5]);
+  const GSVector4i a5 = cols[4].uph16(cols[5]);
+  const GSVector4i a6 = cols[6].upl16(cols[7]);
+  const GSVector4i a7 = cols[6].uph16(cols[7]);
+  const GSVector4i b0 = a0.upl32(a2);
+  const GSVector4i b1 = a0.uph32(a2);
+  const GSVector4i b2 = a1.upl32(a3);
+  const GSVector4i b3 = a1.uph32(a3);
+  const GSVector4i b4 = a4.upl32(a6);
+  const GSVector4i b5 = a4.uph32(a6);
+  const GSVector4i b6 = a5.upl32(a7);
+  const GSVector4i b7 = a5.uph32(a7);
+  const std::array<GSVector4i, 8> rows = {{b0.upl64(b4), b0.uph64(b4), b1.upl64(b5), b1.uph64(b5), b2.upl64(b6),
+                                          b2.uph64(b6), b3.upl64(b7), b3.uph64(b7)}};
+
+  for (u32 x = 0; x < 8; x++)
+  {
+    // clamp(sext9(sum), -128, 127)
+    const GSVector4i row = IDCTRow(rows[x], matrix.data()).sll16<7>().sra16<7>();
+    GSVector4i::store<false>(&blk[x * 8], row.max_s16(GSVector4i::cxpr16(-128)).min_s16(GSVector4i::cxpr16(127)));
+  }
+}
+
+} // namespace MDEC
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: CC-BY-NC-ND-4.0
 
 #include "memory_card.h"
+#include "host.h"
 #include "system_private.h"
 
 #include "util/imgui_manager.h"
@@ -19,8 +20,25 @@
 #include "IconsPromptFont.h"
 #include "fmt/format.h"
 
+#include <condition_variable>
+#include <mutex>
+
 LOG_CHANNEL(MemoryCard);
 
+/// Saves are written on a worker thread, so emulation never waits for storage. Only the newest snapshot is kept, so
+/// saves which are requested while a write is still in progress get merged into the next one.
+struct MemoryCard::AsyncWriter
+{
+  std::mutex mutex;
+  std::condition_variable done_cv;
+  std::unique_ptr<MemoryCardImage::DataArray> pending_data;
+  std::string path;
+  std::string icon_path;
+  u32 index = 0;
+  bool display_osd_message = false;
+  bool write_in_progress = false;
+};
+
 static constexpr std::array<std::string_view, NUM_CONTROLLER_AND_CARD_PORTS> s_event_names = {{
   "Memory Card 1 Host Flush",
   "Memory Card 2 Host Flush",
@@ -37,14 +55,16 @@ MemoryCard::MemoryCard(u32 index)
       s_event_names[index], GetSaveDelayInTicks(), GetSaveDelayInTicks(),
       [](void* param, TickCount ticks, TickCount ticks_late) { static_cast<MemoryCard*>(param)->SaveIfChanged(true); },
       this),
-    m_index(index)
+    m_writer(std::make_shared<AsyncWriter>()), m_index(index)
 {
   m_FLAG.no_write_yet = true;
 }
 
 MemoryCard::~MemoryCard()
 {
+  // card may be opened again straight away, so the file has to be complete
   SaveIfChanged(false);
+  WaitForPendingSave();
 }
 
 TickCount MemoryCard::GetSaveDelayInTicks()
@@ -358,39 +378,83 @@ bool MemoryCard::SaveIfChanged(bool display_osd_message)
   if (m_path.empty())
     return false;
 
-  std::string display_name;
+  // game icon has to be looked up here, the system could be gone by the time it's written
+  std::string icon_path;
   if (display_osd_message)
-    display_name = FileSystem::GetDisplayNameFromPath(m_path);
+  {
+    icon_path = System::GetGameIconPath(false);
+    if (icon_path.empty())
+      icon_path = ICON_PF_MEMORY_CARD;
+  }
 
-  INFO_LOG("Saving memory card to {}...", Path::GetFileTitle(m_path));
+  std::unique_lock lock(m_writer->mutex);
+  if (!m_writer->pending_data)
+    m_writer->pending_data = std::make_unique<MemoryCardImage::DataArray>();
+  *m_writer->pending_data = m_data;
+  m_writer->path = m_path;
+  m_writer->icon_path = std::move(icon_path);
+  m_writer->index = m_index;
+  m_writer->display_osd_message = display_osd_message;
+
+  // if a write is already running, it'll pick this up when it's done
+  if (!m_writer->write_in_progress)
+  {
+    m_writer->write_in_progress = true;
+    Host::QueueAsyncTask([writer = m_writer]() { RunAsyncWriter(writer); });
+  }
 
-  Error error;
-  if (!MemoryCardImage::SaveToFile(m_data, m_path.c_str(), &error))
+  return true;
+}
+
+void MemoryCard::WaitForPendingSave()
+{
+  std::unique_lock lock(m_writer->mutex);
+  m_writer->done_cv.wait(lock, [this]() { return !m_writer->write_in_progress; });
+}
+
+void MemoryCard::RunAsyncWriter(const std::shared_ptr<AsyncWriter>& writer)
+{
+  std::unique_lock lock(writer->mutex);
+  while (writer->pending_data)
   {
+    const std::unique_ptr<MemoryCardImage::DataArray> data = std::move(writer->pending_data);
+    const std::string path = writer->path;
+    std::string icon_path = std::move(writer->icon_path);
+    const u32 index = writer->index;
+    const bool display_osd_message = writer->display_osd_message;
+    lock.unlock();
+
+    INFO_LOG("Saving memory card to {}...", Path::GetFileTitle(path));
+
+    std::string display_name;
     if (display_osd_message)
+      display_name = FileSystem::GetDisplayNameFromPath(path);
+
+    // atomic rename means a crash part way through leaves the previous save intact
+    Error error;
+    if (!MemoryCardImage::SaveToFile(*data, path.c_str(), &error))
     {
-      Host::AddIconOSDMessage(OSDMessageType::Error, GetOSDMessageKey(m_index), ICON_EMOJI_WARNING,
-                              fmt::format(TRANSLATE_FS("MemoryCard", "Failed to save memory card {}."), m_index + 1),
-                              fmt::format(TRANSLATE_FS("MemoryCard", "File: {0}:\nError: {1}"),
-                                          Path::GetFileName(display_name), error.GetDescription()));
+      if (display_osd_message)
+      {
+        Host::AddIconOSDMessage(OSDMessageType::Error, GetOSDMessageKey(index), ICON_EMOJI_WARNING,
+                                fmt::format(TRANSLATE_FS("MemoryCard", "Failed to save memory card {}."), index + 1),
+                                fmt::format(TRANSLATE_FS("MemoryCard", "File: {0}:\nError: {1}"),
+                                            Path::GetFileName(display_name), error.GetDescription()));
+      }
+    }
+    else if (display_osd_message)
+    {
+      Host::AddIconOSDMessage(
+        OSDMessageType::Quick, GetOSDMessageKey(index), std::move(icon_path),
+        fmt::format(TRANSLATE_FS("MemoryCard", "Memory Card Slot {}"), index + 1),
+        fmt::format(TRANSLATE_FS("MemoryCard", "Saved card to '{}'."), Path::GetFileName(display_name)));
     }
 
-    return false;
-  }
-
-  if (display_osd_message)
-  {
-    std::string icon_path = System::GetGameIconPath(false);
-    if (icon_path.empty())
-      icon_path = ICON_PF_MEMORY_CARD;
-
-    Host::AddIconOSDMessage(
-      OSDMessageType::Quick, GetOSDMessageKey(m_index), std::move(icon_path),
-      fmt::format(TRANSLATE_FS("MemoryCard", "Memory Card Slot {}"), m_index + 1),
-      fmt::format(TRANSLATE_FS("MemoryCard", "Saved card to '{}'."), Path::GetFileName(display_name)));
+    lock.lock();
   }
 
-  return true;
+  writer->write_in_progress = false;
+  writer->done_cv.notify_all();
 }
 
 void MemoryCard::QueueFileSave()
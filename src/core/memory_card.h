@@ -92,11 +92,16 @@ private:
     GetID4,
   };
 
+  struct AsyncWriter;
+
   static TickCount GetSaveDelayInTicks();
 
   static std::string GetOSDMessageKey(u32 index);
 
+  static void RunAsyncWriter(const std::shared_ptr<AsyncWriter>& writer);
+
   bool SaveIfChanged(bool display_osd_message);
+  void WaitForPendingSave();
   void QueueFileSave();
 
   State m_state = State::Idle;
@@ -108,6 +113,7 @@ private:
   bool m_changed = false;
 
   TimingEvent m_save_event;
+  std::shared_ptr<AsyncWriter> m_writer;
   std::string m_path;
   u32 m_index;
 
@@ -6,14 +6,22 @@
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 
+#include "common/align.h"
 #include "common/error.h"
 #include "common/file_system.h"
+#include "common/gsvector.h"
 #include "common/log.h"
 #include "common/path.h"
 #include "common/ryml_helpers.h"
+#include "common/task_queue.h"
 
 #include "fmt/format.h"
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <thread>
+
 LOG_CHANNEL(Cheats);
 
 static bool IsValidScanAddress(VirtualMemoryAddress address)
@@ -34,6 +42,210 @@ static bool IsValidScanAddress(VirtualMemoryAddress address)
   return false;
 }
 
+namespace {
+enum class CompareOp : u8
+{
+  Equal,
+  NotEqual,
+  LessThan,
+  LessEqual,
+  GreaterThan,
+  GreaterEqual,
+};
+} // namespace
+
+// Keep the buffers sensible if someone enters a silly range, this is still ~4x the RAM mirrors.
+static constexpr u32 MAX_SCAN_RANGE = 32 * 1024 * 1024;
+
+// Scan addresses are valid/invalid in blocks of this size, see IsValidScanAddress().
+static constexpr u32 SCAN_VALID_BLOCK_SIZE = 1024;
+
+// Below this many bitmap words, it isn't worth spinning up threads.
+static constexpr u32 MIN_WORDS_PER_SCAN_THREAD = 4096;
+static constexpr u32 MAX_SCAN_THREADS = 8;
+
+/// Returns all bits set in each lane where the comparison is true.
+template<typename T, bool is_signed, CompareOp op>
+ALWAYS_INLINE static GSVector4i CompareLanes(GSVector4i lhs, GSVector4i rhs)
+{
+  if constexpr (op != CompareOp::Equal && op != CompareOp::NotEqual && !is_signed)
+  {
+    // no unsigned compares, so flip the sign bits and compare signed instead
+    constexpr s32 sign_bits = (sizeof(T) == 1) ? 0x80808080 : ((sizeof(T) == 2) ? 0x80008000 : 0x80000000);
+    lhs = lhs ^ GSVector4i(sign_bits);
+    rhs = rhs ^ GSVector4i(sign_bits);
+  }
+
+#define COMPARE(func)                                                                                                  \
+  if constexpr (sizeof(T) == 1)                                                                                        \
+    return lhs.func##8(rhs);                                                                                           \
+  else if constexpr (sizeof(T) == 2)                                                                                   \
+    return lhs.func##16(rhs);                                                                                          \
+  else                                                                                                                 \
+    return lhs.func##32(rhs);
+
+  if constexpr (op == CompareOp::Equal)
+  {
+    COMPARE(eq);
+  }
+  else if constexpr (op == CompareOp::NotEqual)
+  {
+    COMPARE(neq);
+  }
+  else if constexpr (op == CompareOp::LessThan)
+  {
+    COMPARE(lt);
+  }
+  else if constexpr (op == CompareOp::LessEqual)
+  {
+    COMPARE(le);
+  }
+  else if constexpr (op == CompareOp::GreaterThan)
+  {
+    COMPARE(gt);
+  }
+  else
+  {
+    COMPARE(ge);
+  }
+
+#undef COMPARE
+}
+
+/// Compares 16 elements against either the broadcast value, or the elements at rhs, and returns a bit per element.
+template<typename T, bool is_signed, CompareOp op, bool compare_last>
+ALWAYS_INLINE static u32 Compare16Elements(const u8* lhs, const u8* rhs, GSVector4i value)
+{
+  GSVector4i res[sizeof(T)];
+  for (u32 i = 0; i < sizeof(T); i++)
+  {
+    const GSVector4i rhs_vec = compare_last ? GSVector4i::load<false>(rhs + i * 16) : value;
+    res[i] = CompareLanes<T, is_signed, op>(GSVector4i::load<false>(lhs + i * 16), rhs_vec);
+  }
+
+  // narrow each lane down to a byte, so the mask is one bit per element
+  if constexpr (sizeof(T) == 1)
+    return static_cast<u32>(res[0].mask()) & 0xFFFFu;
+  else if constexpr (sizeof(T) == 2)
+    return static_cast<u32>(res[0].ps16(res[1]).mask()) & 0xFFFFu;
+  else
+    return static_cast<u32>(res[0].ps32(res[1]).ps16(res[2].ps32(res[3])).mask()) & 0xFFFFu;
+}
+
+namespace {
+struct CompareWordsArgs
+{
+  const u8* values;
+  const u8* last_values;
+  u32 comp_value;
+  u64* bits;
+  u32 first_word;
+  u32 last_word;
+};
+} // namespace
+
+/// ANDs a bit per element for words [first_word, last_word) into bits. The buffers must be padded to a whole word.
+template<typename T, bool is_signed, CompareOp op, bool compare_last>
+static void CompareElementWords(const CompareWordsArgs& args)
+{
+  constexpr u32 bytes_per_word = 64 * sizeof(T);
+  constexpr u32 bytes_per_group = 16 * sizeof(T);
+  const GSVector4i value_vec(static_cast<s32>(
+    (sizeof(T) == 1) ? (args.comp_value & 0xFFu) * 0x01010101u :
+                       ((sizeof(T) == 2) ? (args.comp_value & 0xFFFFu) * 0x00010001u : args.comp_value)));
+
+  for (u32 word = args.first_word; word < args.last_word; word++)
+  {
+    // follow-up scans only need to look at words which still have candidates
+    if (args.bits[word] == 0)
+      continue;
+
+    const u8* lhs = args.values + word * bytes_per_word;
+    const u8* rhs = args.last_values + word * bytes_per_word;
+    u64 word_bits = 0;
+    for (u32 group = 0; group < 4; group++)
+    {
+      word_bits |= static_cast<u64>(Compare16Elements<T, is_signed, op, compare_last>(
+                     lhs + group * bytes_per_group, rhs + group * bytes_per_group, value_vec))
+                   << (group * 16);
+    }
+
+    args.bits[word] &= word_bits;
+  }
+}
+
+template<typename T, bool is_signed>
+static void CompareElementWords(CompareOp op, bool compare_last, const CompareWordsArgs& args)
+{
+  switch (op)
+  {
+#define COMPARE_CASE(cop)                                                                                              \
+  case CompareOp::cop:                                                                                                 \
+  {                                                                                                                    \
+    if (compare_last)                                                                                                  \
+      CompareElementWords<T, is_signed, CompareOp::cop, true>(args);                                                   \
+    else                                                                                                               \
+      CompareElementWords<T, is_signed, CompareOp::cop, false>(args);                                                  \
+  }                                                                                                                    \
+  break;
+
+    COMPARE_CASE(Equal);
+    COMPARE_CASE(NotEqual);
+    COMPARE_CASE(LessThan);
+    COMPARE_CASE(LessEqual);
+    COMPARE_CASE(GreaterThan);
+    COMPARE_CASE(GreaterEqual);
+
+#undef COMPARE_CASE
+  }
+}
+
+/// Maps a scan operator onto a lane compare. Returns false if it has to be done per-element.
+static bool GetVectorCompareOp(MemoryScan::Operator op, MemoryAccessSize size, bool is_signed, u32 comp_value,
+                               CompareOp* compare_op, bool* compare_last)
+{
+  using Operator = MemoryScan::Operator;
+
+  *compare_last = true;
+  switch (op)
+  {
+      // clang-format off
+    case Operator::EqualLast: *compare_op = CompareOp::Equal; return true;
+    case Operator::NotEqualLast: *compare_op = CompareOp::NotEqual; return true;
+    case Operator::LessThanLast: *compare_op = CompareOp::LessThan; return true;
+    case Operator::LessEqualLast: *compare_op = CompareOp::LessEqual; return true;
+    case Operator::GreaterThanLast: *compare_op = CompareOp::GreaterThan; return true;
+    case Operator::GreaterEqualLast: *compare_op = CompareOp::GreaterEqual; return true;
+    case Operator::Equal: *compare_op = CompareOp::Equal; break;
+    case Operator::NotEqual: *compare_op = CompareOp::NotEqual; break;
+    case Operator::LessThan: *compare_op = CompareOp::LessThan; break;
+    case Operator::LessEqual: *compare_op = CompareOp::LessEqual; break;
+    case Operator::GreaterThan: *compare_op = CompareOp::GreaterThan; break;
+    case Operator::GreaterEqual: *compare_op = CompareOp::GreaterEqual; break;
+      // clang-format on
+
+    default:
+      // DecreasedBy etc. depend on 32-bit differences of the extended values, which the lanes don't have.
+      return false;
+  }
+
+  // The extended value is compared against all 32 bits, so a value outside the lane's range can't be truncated.
+  *compare_last = false;
+  if (size == MemoryAccessSize::Word)
+    return true;
+
+  const u32 bits = (size == MemoryAccessSize::Byte) ? 8 : 16;
+  if (is_signed)
+  {
+    const s32 svalue = static_cast<s32>(comp_value);
+    return (svalue >= -(1 << (bits - 1)) && svalue < (1 << (bits - 1)));
+  }
+  else
+  {
+    return (comp_value < (1u << bits));
+  }
+}
+
 MemoryScan::MemoryScan() = default;
 
 MemoryScan::~MemoryScan() = default;
@@ -41,116 +253,236 @@ MemoryScan::~MemoryScan() = default;
 void MemoryScan::ResetSearch()
 {
   m_results.clear();
+  m_result_count = 0;
+  m_scan_element_count = 0;
+  m_candidate_bits = {};
+  m_first_values = {};
+  m_last_values = {};
 }
 
-void MemoryScan::Search()
+u32 MemoryScan::GetElementSize() const
 {
-  m_results.clear();
+  return (1u << static_cast<u32>(m_size));
+}
 
+u32 MemoryScan::GetElementValue(const std::vector<u8>& data, u32 index) const
+{
   switch (m_size)
   {
     case MemoryAccessSize::Byte:
-      SearchBytes();
-      break;
+    {
+      const u8 value = data[index];
+      return m_signed ? SignExtend32(value) : ZeroExtend32(value);
+    }
 
     case MemoryAccessSize::HalfWord:
-      SearchHalfwords();
-      break;
+    {
+      u16 value;
+      std::memcpy(&value, &data[index * sizeof(u16)], sizeof(value));
+      return m_signed ? SignExtend32(value) : ZeroExtend32(value);
+    }
 
     case MemoryAccessSize::Word:
-      SearchWords();
-      break;
-
     default:
-      break;
+    {
+      u32 value;
+      std::memcpy(&value, &data[index * sizeof(u32)], sizeof(value));
+      return value;
+    }
   }
 }
 
-void MemoryScan::SearchBytes()
+bool MemoryScan::ReadScanMemory(std::vector<u8>* data, std::vector<u64>* valid_bits) const
 {
-  for (PhysicalMemoryAddress address = m_start_address; address < m_end_address; address++)
+  // Pad to a whole bitmap word, so the compare loops don't need a tail.
+  const u32 element_size = GetElementSize();
+  const u32 word_count = Common::AlignUpPow2(m_scan_element_count, 64) / 64;
+  const u32 length = m_scan_element_count * element_size;
+  data->resize(word_count * 64 * element_size);
+  std::memset(data->data() + length, 0, data->size() - length);
+
+  bool has_invalid = false;
+  if (valid_bits)
+    valid_bits->assign(word_count, ~static_cast<u64>(0));
+
+  for (u32 offset = 0; offset < length;)
   {
-    if (!IsValidScanAddress(address))
-      continue;
-
-    u8 bvalue = 0;
-    if (!CPU::SafeReadMemoryByte(address, &bvalue)) [[unlikely]]
-      continue;
-
-    Result res;
-    res.address = address;
-    res.value = m_signed ? SignExtend32(bvalue) : ZeroExtend32(bvalue);
-    res.last_value = res.value;
-    res.first_value = res.value;
-    res.value_changed = false;
+    const VirtualMemoryAddress address = m_scan_start_address + offset;
+    const u32 block_length =
+      std::min(Common::AlignUpPow2(address + 1, SCAN_VALID_BLOCK_SIZE) - address, length - offset);
+    if (!IsValidScanAddress(address) || !CPU::SafeReadMemoryBytes(address, data->data() + offset, block_length))
+    {
+      std::memset(data->data() + offset, 0, block_length);
+      has_invalid = true;
+
+      if (valid_bits)
+      {
+        const u32 first_element = Common::AlignUp(offset, element_size) / element_size;
+        const u32 last_element = std::min((offset + block_length + element_size - 1) / element_size,
+                                          m_scan_element_count);
+        for (u32 i = first_element; i < last_element; i++)
+          (*valid_bits)[i / 64] &= ~(static_cast<u64>(1) << (i % 64));
+      }
+    }
 
-    if (res.Filter(m_operator, m_value, m_signed))
-      m_results.push_back(res);
+    offset += block_length;
   }
+
+  return has_invalid;
 }
 
-void MemoryScan::SearchHalfwords()
+void MemoryScan::Search()
 {
-  for (PhysicalMemoryAddress address = m_start_address; address < m_end_address; address += 2)
-  {
-    if (!IsValidScanAddress(address))
-      continue;
+  const u32 element_size = GetElementSize();
+  const u32 range = (m_end_address > m_start_address) ? (m_end_address - m_start_address) : 0;
+  if (range > MAX_SCAN_RANGE)
+    WARNING_LOG("Memory scan range of {} bytes is too large, only scanning the first {}.", range, MAX_SCAN_RANGE);
 
-    u16 bvalue = 0;
-    if (!CPU::SafeReadMemoryHalfWord(address, &bvalue)) [[unlikely]]
-      continue;
+  ResetSearch();
+  m_scan_start_address = m_start_address;
+  m_scan_element_count = (std::min(range, MAX_SCAN_RANGE) + element_size - 1) / element_size;
 
-    Result res;
-    res.address = address;
-    res.value = m_signed ? SignExtend32(bvalue) : ZeroExtend32(bvalue);
-    res.last_value = res.value;
-    res.first_value = res.value;
-    res.value_changed = false;
+  // Invalid addresses start out as non-candidates, since they can never be read.
+  ReadScanMemory(&m_first_values, &m_candidate_bits);
+  m_last_values = m_first_values;
 
-    if (res.Filter(m_operator, m_value, m_signed))
-      m_results.push_back(res);
-  }
+  const u32 last_bits = m_scan_element_count % 64;
+  if (last_bits != 0)
+    m_candidate_bits.back() &= (static_cast<u64>(1) << last_bits) - 1;
+
+  FilterCandidates(m_first_values, true);
 }
 
-void MemoryScan::SearchWords()
+void MemoryScan::SearchAgain()
 {
-  for (PhysicalMemoryAddress address = m_start_address; address < m_end_address; address += 4)
-  {
-    if (!IsValidScanAddress(address))
-      continue;
+  if (m_result_count == 0)
+    return;
 
-    u32 bvalue = 0;
-    if (!CPU::SafeReadMemoryWord(address, &bvalue)) [[unlikely]]
-      continue;
+  std::vector<u8> values;
+  ReadScanMemory(&values, nullptr);
+  FilterCandidates(values, false);
+  m_last_values = std::move(values);
+}
 
-    Result res;
-    res.address = address;
-    res.value = bvalue;
-    res.last_value = res.value;
-    res.first_value = res.value;
-    res.value_changed = false;
+void MemoryScan::FilterCandidates(const std::vector<u8>& values, bool parallel)
+{
+  const u32 word_count = static_cast<u32>(m_candidate_bits.size());
 
-    if (res.Filter(m_operator, m_value, m_signed))
-      m_results.push_back(res);
+  CompareOp compare_op;
+  bool compare_last;
+  if (m_operator == Operator::Any)
+  {
+    // everything that's readable stays
+  }
+  else if (GetVectorCompareOp(m_operator, m_size, m_signed, m_value, &compare_op, &compare_last))
+  {
+    const auto compare_words = [this, &values, compare_op, compare_last](u32 first_word, u32 last_word) {
+      const CompareWordsArgs args = {values.data(), m_last_values.data(), m_value,
+                                     m_candidate_bits.data(), first_word, last_word};
+      switch (m_size)
+      {
+        case MemoryAccessSize::Byte:
+        {
+          if (m_signed)
+            CompareElementWords<u8, true>(compare_op, compare_last, args);
+          else
+            CompareElementWords<u8, false>(compare_op, compare_last, args);
+        }
+        break;
+
+        case MemoryAccessSize::HalfWord:
+        {
+          if (m_signed)
+            CompareElementWords<u16, true>(compare_op, compare_last, args);
+          else
+            CompareElementWords<u16, false>(compare_op, compare_last, args);
+        }
+        break;
+
+        case MemoryAccessSize::Word:
+        default:
+        {
+          if (m_signed)
+            CompareElementWords<u32, true>(compare_op, compare_last, args);
+          else
+            CompareElementWords<u32, false>(compare_op, compare_last, args);
+        }
+        break;
+      }
+    };
+
+    // Split the first scan across threads, each one only touches its own bitmap words.
+    const u32 thread_count =
+      parallel ? std::clamp(word_count / MIN_WORDS_PER_SCAN_THREAD, 1u,
+                            std::min(std::max(std::thread::hardware_concurrency(), 1u), MAX_SCAN_THREADS)) :
+                 1u;
+    if (thread_count > 1)
+    {
+      TaskQueue queue;
+      queue.SetWorkerCount(thread_count);
+
+      const u32 words_per_thread = (word_count + thread_count - 1) / thread_count;
+      for (u32 first_word = 0; first_word < word_count; first_word += words_per_thread)
+      {
+        const u32 last_word = std::min(first_word + words_per_thread, word_count);
+        queue.SubmitTask([&compare_words, first_word, last_word]() { compare_words(first_word, last_word); });
+      }
+
+      queue.WaitForAll();
+    }
+    else
+    {
+      compare_words(0, word_count);
+    }
+  }
+  else
+  {
+    for (u32 word = 0; word < word_count; word++)
+    {
+      u64 word_bits = m_candidate_bits[word];
+      while (word_bits != 0)
+      {
+        const u32 bit = static_cast<u32>(std::countr_zero(word_bits));
+        word_bits &= word_bits - 1;
+
+        const u32 index = word * 64 + bit;
+        const Result res = {m_scan_start_address + index * GetElementSize(), GetElementValue(values, index),
+                            GetElementValue(m_last_values, index), GetElementValue(m_first_values, index), false};
+        if (!res.Filter(m_operator, m_value, m_signed))
+          m_candidate_bits[word] &= ~(static_cast<u64>(1) << bit);
+      }
+    }
   }
+
+  m_result_count = 0;
+  for (const u64 word_bits : m_candidate_bits)
+    m_result_count += static_cast<u32>(std::popcount(word_bits));
+
+  UpdateListedResults(values);
 }
 
-void MemoryScan::SearchAgain()
+void MemoryScan::UpdateListedResults(const std::vector<u8>& values)
 {
-  ResultVector new_results;
-  new_results.reserve(m_results.size());
-  for (Result& res : m_results)
-  {
-    res.UpdateValue(m_size, m_signed);
+  m_results.clear();
+  m_results.reserve(std::min(m_result_count, MAX_LISTED_RESULTS));
 
-    if (res.Filter(m_operator, m_value, m_signed))
+  const u32 element_size = GetElementSize();
+  for (u32 word = 0; word < m_candidate_bits.size() && m_results.size() < MAX_LISTED_RESULTS; word++)
+  {
+    u64 word_bits = m_candidate_bits[word];
+    while (word_bits != 0 && m_results.size() < MAX_LISTED_RESULTS)
     {
+      const u32 index = word * 64 + static_cast<u32>(std::countr_zero(word_bits));
+      word_bits &= word_bits - 1;
+
+      Result& res = m_results.emplace_back();
+      res.address = m_scan_start_address + index * element_size;
+      res.value = GetElementValue(values, index);
       res.last_value = res.value;
-      new_results.push_back(res);
+      res.first_value = GetElementValue(m_first_values, index);
+      res.value_changed = false;
     }
   }
-
-  m_results.swap(new_results);
 }
 
 void MemoryScan::UpdateResultsValues()
@@ -49,6 +49,9 @@ public:
 
   using ResultVector = std::vector<Result>;
 
+  /// Only this many results are kept as entries, the rest are tracked in a bitmap of candidate addresses.
+  static constexpr u32 MAX_LISTED_RESULTS = 5000;
+
   MemoryScan();
   ~MemoryScan();
 
@@ -60,7 +63,7 @@ public:
   PhysicalMemoryAddress GetEndAddress() const { return m_end_address; }
   const ResultVector& GetResults() const { return m_results; }
   const Result& GetResult(u32 index) const { return m_results[index]; }
-  u32 GetResultCount() const { return static_cast<u32>(m_results.size()); }
+  u32 GetResultCount() const { return m_result_count; }
 
   void SetValue(u32 value) { m_value = value; }
   void SetValueSigned(bool s) { m_signed = s; }
@@ -77,9 +80,11 @@ public:
   void SetResultValue(u32 index, u32 value);
 
 private:
-  void SearchBytes();
-  void SearchHalfwords();
-  void SearchWords();
+  u32 GetElementSize() const;
+  u32 GetElementValue(const std::vector<u8>& data, u32 index) const;
+  bool ReadScanMemory(std::vector<u8>* data, std::vector<u64>* valid_bits) const;
+  void FilterCandidates(const std::vector<u8>& values, bool parallel);
+  void UpdateListedResults(const std::vector<u8>& values);
 
   u32 m_value = 0;
   MemoryAccessSize m_size = MemoryAccessSize::HalfWord;
@@ -88,6 +93,14 @@ private:
   PhysicalMemoryAddress m_end_address = 0x200000;
   ResultVector m_results;
   bool m_signed = false;
+
+  // Range and values for the current results, one bit/element per scanned address.
+  PhysicalMemoryAddress m_scan_start_address = 0;
+  u32 m_scan_element_count = 0;
+  u32 m_result_count = 0;
+  std::vector<u64> m_candidate_bits;
+  std::vector<u8> m_first_values;
+  std::vector<u8> m_last_values;
 };
 
 class MemoryWatchList
@@ -774,6 +774,10 @@ void Pad::DoTransfer(TickCount ticks_late)
       }
       else
       {
+        // controller address byte, this is where the game starts reading the pad
+        if (controller && data_out == 0x01)
+          System::PollInputForPadRead();
+
         if (!controller || (ack = controller->Transfer(data_out, &data_in)) == false)
         {
           if (!memory_card || (ack = memory_card->Transfer(data_out, &data_in)) == false)
@@ -11,11 +11,21 @@
 #include "common/small_string.h"
 #include "common/string_util.h"
 
+#include <algorithm>
+#include <cstring>
+
 LOG_CHANNEL(PCDrv);
 
 static constexpr u32 MAX_FILES = 100;
 
+/// Host files are buffered by this much, so small sequential reads don't each hit the disk.
+static constexpr size_t FILE_BUFFER_SIZE = 256 * 1024;
+
+/// Reads and writes are copied to/from guest memory in pieces this large.
+static constexpr u32 TRANSFER_CHUNK_SIZE = 64 * 1024;
+
 static std::vector<FileSystem::ManagedCFilePtr> s_files;
+static std::vector<u8> s_transfer_buffer;
 
 enum PCDrvAttribute : u32
 {
@@ -51,6 +61,7 @@ static void CloseAllFiles()
     DEV_LOG("Closing {} open files.", s_files.size());
 
   s_files.clear();
+  s_transfer_buffer = {};
 }
 
 static FILE* GetFileFromHandle(u32 handle)
@@ -189,6 +200,8 @@ bool PCDrv::HandleSyscall(u32 instruction_bits, CPU::Registers& regs)
         return true;
       }
 
+      std::setvbuf(s_files[handle].get(), nullptr, _IOFBF, FILE_BUFFER_SIZE);
+
       ERROR_LOG("PCDrv: Opened '{}' => {}", filename, handle);
       regs.v0 = 0;
       regs.v1 = static_cast<u32>(handle);
@@ -223,11 +236,12 @@ bool PCDrv::HandleSyscall(u32 instruction_bits, CPU::Registers& regs)
 
       const u32 count = regs.a2;
       u32 dstaddr = regs.a3;
-      for (u32 i = 0; i < count; i++)
+      s_transfer_buffer.resize(TRANSFER_CHUNK_SIZE);
+      for (u32 remaining = count; remaining > 0;)
       {
-        // Certainly less than optimal, but it's not like you're going to be reading megabytes of data here.
-        u8 val;
-        if (std::fread(&val, 1, 1, fp) != 1)
+        const u32 chunk_size = std::min(remaining, TRANSFER_CHUNK_SIZE);
+        const size_t bytes_read = std::fread(s_transfer_buffer.data(), 1, chunk_size, fp);
+        if (bytes_read != chunk_size)
         {
           // Does not stop at EOF according to psx-spx.
           if (std::ferror(fp) != 0)
@@ -236,11 +250,12 @@ bool PCDrv::HandleSyscall(u32 instruction_bits, CPU::Registers& regs)
             return true;
           }
 
-          val = 0;
+          std::memset(s_transfer_buffer.data() + bytes_read, 0, chunk_size - bytes_read);
         }
 
-        CPU::SafeWriteMemoryByte(dstaddr, val);
-        dstaddr++;
+        CPU::SafeWriteMemoryBytes(dstaddr, s_transfer_buffer.data(), chunk_size);
+        dstaddr += chunk_size;
+        remaining -= chunk_size;
       }
 
       regs.v0 = 0;
@@ -262,20 +277,32 @@ bool PCDrv::HandleSyscall(u32 instruction_bits, CPU::Registers& regs)
       const u32 count = regs.a2;
       u32 srcaddr = regs.a3;
       u32 written = 0;
-      for (u32 i = 0; i < count; i++)
+      s_transfer_buffer.resize(TRANSFER_CHUNK_SIZE);
+      while (written < count)
       {
-        u8 val;
-        if (!CPU::SafeReadMemoryByte(srcaddr, &val))
-          break;
+        const u32 chunk_size = std::min(count - written, TRANSFER_CHUNK_SIZE);
+        u32 valid_size = chunk_size;
+        if (!CPU::SafeReadMemoryBytes(srcaddr, s_transfer_buffer.data(), chunk_size))
+        {
+          // Writing stops at the first address that can't be read.
+          valid_size = 0;
+          while (valid_size < chunk_size &&
+                 CPU::SafeReadMemoryByte(srcaddr + valid_size, &s_transfer_buffer[valid_size]))
+          {
+            valid_size++;
+          }
+        }
 
-        if (std::fwrite(&val, 1, 1, fp) != 1)
+        if (valid_size > 0 && std::fwrite(s_transfer_buffer.data(), valid_size, 1, fp) != 1)
         {
           RETURN_ERROR();
           return true;
         }
 
-        srcaddr++;
-        written++;
+        srcaddr += valid_size;
+        written += valid_size;
+        if (valid_size != chunk_size)
+          break;
       }
 
       regs.v0 = 0;
@@ -5,21 +5,31 @@
 #include "gpu.h"
 #include "gpu_backend.h"
 #include "gpu_thread.h"
+#include "host.h"
+#include "spu.h"
 #include "system.h"
 #include "system_private.h"
 
+#include "util/core_audio_stream.h"
 #include "util/media_capture.h"
 
+#include "common/event_trace.h"
 #include "common/log.h"
+#include "common/small_string.h"
 #include "common/threading.h"
 #include "common/timer.h"
 
+#include <algorithm>
+#include <cmath>
 #include <utility>
+#include <vector>
 
 LOG_CHANNEL(PerfMon);
 
 namespace PerformanceCounters {
 
+static constexpr u32 MAX_CPU_TIME_EVENT_COUNTERS = 32;
+
 namespace {
 
 struct State
@@ -51,20 +61,84 @@ struct State
   float gpu_thread_usage;
   float gpu_thread_time;
 
+  float gpu_thread_sync_spin_window;
+  float gpu_thread_average_wake_latency;
+  float gpu_thread_maximum_wake_latency;
+  u32 gpu_thread_sync_spin_count;
+  u32 gpu_thread_sync_yield_count;
+  u32 gpu_thread_sync_sleep_count;
+
+  u32 audio_underrun_count;
+  u32 audio_overrun_count;
+  float audio_buffered_time;
+  float audio_buffer_usage;
+
   float average_gpu_time;
   float accumulated_gpu_time;
   float gpu_usage;
 
   alignas(VECTOR_ALIGNMENT) FrameTimeHistory frame_time_history;
   u32 frame_time_history_pos;
+
+  std::array<float, NUM_FRAME_TIME_PERCENTILE_SAMPLES> percentile_frame_times;
+  u32 percentile_frame_times_pos;
+  u32 percentile_frame_times_count;
+  FrameTimePercentiles frame_time_percentiles;
+
+  u32 last_shader_compile_count;
+  StutterStatistics stutter_statistics;
+
+  u64 last_cpu_time_timestamp;
+  std::array<u64, NUM_CPU_TIME_CATEGORIES> last_cpu_time_category_ticks;
+  std::array<u64, MAX_CPU_TIME_EVENT_COUNTERS> last_cpu_time_event_ticks;
+  CPUTimeBreakdown cpu_time_breakdown;
+
+  GPUTimeBreakdown gpu_time_breakdown;
+};
+
+struct CPUTimeEventCounter
+{
+  std::string_view name;
+  std::atomic<u64> ticks;
 };
 
 } // namespace
 
+static void SampleCPUTimeCounters(float time, float frames_run);
+static void UpdateFrameTimePercentiles();
+static void CheckForStutter(float frame_time, Timer::Value frame_end_time);
+static void UpdateGPUTimeBreakdown();
+
 static constexpr const float PERFORMANCE_COUNTER_UPDATE_INTERVAL = 1.0f;
 
+// Frames that take this much longer than the median are counted as stutters. The minimum increase stops frame pacing
+// jitter at high frame rates from being counted.
+static constexpr const float STUTTER_FRAME_TIME_FACTOR = 2.0f;
+static constexpr const float STUTTER_MINIMUM_FRAME_TIME_INCREASE = 4.0f;
+
 ALIGN_TO_CACHE_LINE State s_state = {};
 
+ALIGN_TO_CACHE_LINE CPUTimeCounters g_cpu_time_counters = {};
+
+// Event names are string literals, so entries are never removed. Only appended to by the CPU thread.
+static std::array<CPUTimeEventCounter, MAX_CPU_TIME_EVENT_COUNTERS> s_cpu_time_event_counters = {};
+static std::atomic<u32> s_num_cpu_time_event_counters{0};
+
+// Per-scope GPU time since the last update, and the buffer they're read into each present. GPU thread only.
+static std::vector<GPUDevice::TimingScopeTime> s_gpu_timing_scope_times;
+static std::vector<GPUDevice::TimingScopeTime> s_gpu_timing_scope_present_times;
+
+static constexpr const std::array<const char*, NUM_CPU_TIME_CATEGORIES> s_cpu_time_category_names = {
+  "REC", "INT", "GTE", "GPU", "MDEC", "SPU", "CDR", "EVT",
+};
+
+// When each cause last happened, zero once it has been attributed to a stutter. Written from any thread.
+static std::array<std::atomic<Timer::Value>, NUM_STUTTER_CAUSES> s_stutter_cause_times = {};
+
+static constexpr const std::array<const char*, NUM_STUTTER_CAUSES> s_stutter_cause_names = {
+  "Shader", "Code Cache", "CD Seek", "Texture Load", "Save State",
+};
+
 } // namespace PerformanceCounters
 
 float PerformanceCounters::GetFPS()
@@ -127,6 +201,56 @@ float PerformanceCounters::GetGPUAverageTime()
   return s_state.average_gpu_time;
 }
 
+float PerformanceCounters::GetGPUThreadSyncSpinWindow()
+{
+  return s_state.gpu_thread_sync_spin_window;
+}
+
+float PerformanceCounters::GetGPUThreadAverageWakeLatency()
+{
+  return s_state.gpu_thread_average_wake_latency;
+}
+
+float PerformanceCounters::GetGPUThreadMaximumWakeLatency()
+{
+  return s_state.gpu_thread_maximum_wake_latency;
+}
+
+u32 PerformanceCounters::GetGPUThreadSyncSpinCount()
+{
+  return s_state.gpu_thread_sync_spin_count;
+}
+
+u32 PerformanceCounters::GetGPUThreadSyncYieldCount()
+{
+  return s_state.gpu_thread_sync_yield_count;
+}
+
+u32 PerformanceCounters::GetGPUThreadSyncSleepCount()
+{
+  return s_state.gpu_thread_sync_sleep_count;
+}
+
+u32 PerformanceCounters::GetAudioUnderrunCount()
+{
+  return s_state.audio_underrun_count;
+}
+
+u32 PerformanceCounters::GetAudioOverrunCount()
+{
+  return s_state.audio_overrun_count;
+}
+
+float PerformanceCounters::GetAudioBufferedTime()
+{
+  return s_state.audio_buffered_time;
+}
+
+float PerformanceCounters::GetAudioBufferUsage()
+{
+  return s_state.audio_buffer_usage;
+}
+
 const PerformanceCounters::FrameTimeHistory& PerformanceCounters::GetFrameTimeHistory()
 {
   return s_state.frame_time_history;
@@ -137,9 +261,43 @@ u32 PerformanceCounters::GetFrameTimeHistoryPos()
   return s_state.frame_time_history_pos;
 }
 
+const PerformanceCounters::FrameTimePercentiles& PerformanceCounters::GetFrameTimePercentiles()
+{
+  return s_state.frame_time_percentiles;
+}
+
+const PerformanceCounters::StutterStatistics& PerformanceCounters::GetStutterStatistics()
+{
+  return s_state.stutter_statistics;
+}
+
+const char* PerformanceCounters::GetStutterCauseName(StutterCause cause)
+{
+  return s_stutter_cause_names[static_cast<size_t>(cause)];
+}
+
+const PerformanceCounters::CPUTimeBreakdown& PerformanceCounters::GetCPUTimeBreakdown()
+{
+  return s_state.cpu_time_breakdown;
+}
+
+const char* PerformanceCounters::GetCPUTimeCategoryName(CPUTimeCategory category)
+{
+  return s_cpu_time_category_names[static_cast<size_t>(category)];
+}
+
+const PerformanceCounters::GPUTimeBreakdown& PerformanceCounters::GetGPUTimeBreakdown()
+{
+  return s_state.gpu_time_breakdown;
+}
+
 void PerformanceCounters::Clear()
 {
   s_state = {};
+  s_gpu_timing_scope_times.clear();
+
+  for (std::atomic<Timer::Value>& time : s_stutter_cause_times)
+    time.store(0, std::memory_order_relaxed);
 }
 
 void PerformanceCounters::Reset()
@@ -153,11 +311,17 @@ void PerformanceCounters::Reset()
   s_state.last_internal_frame_number = System::GetInternalFrameNumber();
   s_state.last_core_time = System::GetCoreThreadHandle().GetCPUTime();
   s_state.last_gpu_thread_time = GPUThread::Internal::GetThreadHandle().GetCPUTime();
+  GPUThread::Internal::GetAndResetSyncStatistics();
+  SPU::GetOutputStream().GetAndResetStatistics();
 
   s_state.average_frame_time_accumulator = 0.0f;
   s_state.minimum_frame_time_accumulator = 0.0f;
   s_state.maximum_frame_time_accumulator = 0.0f;
 
+  SampleCPUTimeCounters(0.0f, 0.0f);
+  s_state.cpu_time_breakdown = {};
+  s_state.gpu_time_breakdown = {};
+
   std::atomic_thread_fence(std::memory_order_release);
 }
 
@@ -174,6 +338,17 @@ void PerformanceCounters::Update(GPUBackend* gpu, u32 frame_number, u32 internal
   s_state.maximum_frame_time_accumulator = std::max(s_state.maximum_frame_time_accumulator, frame_time);
   s_state.frame_time_history[s_state.frame_time_history_pos] = frame_time;
   s_state.frame_time_history_pos = (s_state.frame_time_history_pos + 1) % NUM_FRAME_TIME_SAMPLES;
+  s_state.percentile_frame_times[s_state.percentile_frame_times_pos] = frame_time;
+  s_state.percentile_frame_times_pos = (s_state.percentile_frame_times_pos + 1) % NUM_FRAME_TIME_PERCENTILE_SAMPLES;
+  s_state.percentile_frame_times_count =
+    std::min(s_state.percentile_frame_times_count + 1, NUM_FRAME_TIME_PERCENTILE_SAMPLES);
+
+  // Shaders are compiled on this thread, so any compiles since the last frame happened during it.
+  const u32 shader_compile_count = g_gpu_device->GetShaderCompileCount();
+  if (shader_compile_count != std::exchange(s_state.last_shader_compile_count, shader_compile_count))
+    AttributeStutter(StutterCause::ShaderCompile);
+
+  CheckForStutter(frame_time, now_ticks);
 
   // update fps counter
   const Timer::Value ticks_diff = now_ticks - s_state.last_update_time;
@@ -199,6 +374,8 @@ void PerformanceCounters::Update(GPUBackend* gpu, u32 frame_number, u32 internal
   s_state.average_frame_time = std::exchange(s_state.average_frame_time_accumulator, 0.0f) / frames_runf;
   s_state.maximum_frame_time = std::exchange(s_state.maximum_frame_time_accumulator, 0.0f);
 
+  UpdateFrameTimePercentiles();
+
   s_state.vps = static_cast<float>(frames_runf / time);
   s_state.fps = static_cast<float>(internal_frames_run) / time;
   s_state.speed = (s_state.vps / System::GetVideoFrameRate()) * 100.0f;
@@ -215,6 +392,27 @@ void PerformanceCounters::Update(GPUBackend* gpu, u32 frame_number, u32 internal
   s_state.gpu_thread_usage = static_cast<float>(static_cast<double>(gpu_thread_delta) * pct_divider);
   s_state.gpu_thread_time = static_cast<float>(static_cast<double>(gpu_thread_delta) * time_divider);
 
+  const GPUThread::Internal::SyncStatistics sync_stats = GPUThread::Internal::GetAndResetSyncStatistics();
+  s_state.gpu_thread_sync_spin_window = sync_stats.spin_window_us;
+  s_state.gpu_thread_average_wake_latency = sync_stats.average_wake_latency_us;
+  s_state.gpu_thread_maximum_wake_latency = sync_stats.maximum_wake_latency_us;
+  s_state.gpu_thread_sync_spin_count = sync_stats.spin_count;
+  s_state.gpu_thread_sync_yield_count = sync_stats.yield_count;
+  s_state.gpu_thread_sync_sleep_count = sync_stats.sleep_count;
+
+  CoreAudioStream& audio_stream = SPU::GetOutputStream();
+  const CoreAudioStream::Statistics audio_stats = audio_stream.GetAndResetStatistics();
+  s_state.audio_underrun_count = audio_stats.underrun_count;
+  s_state.audio_overrun_count = audio_stats.overrun_count;
+  s_state.audio_buffered_time =
+    (audio_stream.GetSampleRate() > 0) ?
+      (static_cast<float>(audio_stats.buffered_frames) * 1000.0f / static_cast<float>(audio_stream.GetSampleRate())) :
+      0.0f;
+  s_state.audio_buffer_usage =
+    (audio_stats.target_frames > 0) ?
+      (static_cast<float>(audio_stats.buffered_frames) * 100.0f / static_cast<float>(audio_stats.target_frames)) :
+      0.0f;
+
   if (MediaCapture* cap = System::GetMediaCapture())
     cap->UpdateCaptureThreadUsage(pct_divider, time_divider);
 
@@ -223,16 +421,36 @@ void PerformanceCounters::Update(GPUBackend* gpu, u32 frame_number, u32 internal
     s_state.average_gpu_time =
       s_state.accumulated_gpu_time / static_cast<float>(std::max(s_state.presents_since_last_update, 1u));
     s_state.gpu_usage = s_state.accumulated_gpu_time / (time * 10.0f);
+    UpdateGPUTimeBreakdown();
+
+    if (g_gpu_settings.gpu_dynamic_resolution_scale)
+    {
+      Host::RunOnCoreThread(
+        [gpu_time = s_state.average_gpu_time]() { System::UpdateDynamicResolutionScale(gpu_time); });
+    }
   }
   s_state.accumulated_gpu_time = 0.0f;
+  s_gpu_timing_scope_times.clear();
   s_state.presents_since_last_update = 0;
 
   if (g_settings.display_show_gpu_stats)
     gpu->UpdateStatistics(frames_run);
 
+  SampleCPUTimeCounters(time, frames_runf);
+
   VERBOSE_LOG("FPS: {:.2f} VPS: {:.2f} CPU: {:.2f} RNDR: {:.2f} GPU: {:.2f} Avg: {:.2f}ms Min: {:.2f}ms Max: {:.2f}ms",
               s_state.fps, s_state.vps, s_state.core_thread_usage, s_state.gpu_thread_usage, s_state.gpu_usage,
               s_state.average_frame_time, s_state.minimum_frame_time, s_state.maximum_frame_time);
+  VERBOSE_LOG("Frame time P50: {:.2f}ms P95: {:.2f}ms P99: {:.2f}ms P99.9: {:.2f}ms Stutters: {}",
+              s_state.frame_time_percentiles.p50, s_state.frame_time_percentiles.p95,
+              s_state.frame_time_percentiles.p99, s_state.frame_time_percentiles.p999,
+              s_state.stutter_statistics.count);
+  VERBOSE_LOG("GPU sync: Spin window: {:.1f}us Spin/Yield/Sleep: {}/{}/{} Wake Avg: {:.1f}us Max: {:.1f}us",
+              s_state.gpu_thread_sync_spin_window, s_state.gpu_thread_sync_spin_count,
+              s_state.gpu_thread_sync_yield_count, s_state.gpu_thread_sync_sleep_count,
+              s_state.gpu_thread_average_wake_latency, s_state.gpu_thread_maximum_wake_latency);
+  VERBOSE_LOG("Audio: Underruns: {} Overruns: {} Buffered: {:.1f}ms ({:.0f}% of target)", s_state.audio_underrun_count,
+              s_state.audio_overrun_count, s_state.audio_buffered_time, s_state.audio_buffer_usage);
 
   Host::OnPerformanceCountersUpdated(gpu);
 }
@@ -241,4 +459,189 @@ void PerformanceCounters::AccumulateGPUTime()
 {
   s_state.accumulated_gpu_time += g_gpu_device->GetAndResetAccumulatedGPUTime();
   s_state.presents_since_last_update++;
+
+  g_gpu_device->GetAndResetAccumulatedTimingScopeTimes(&s_gpu_timing_scope_present_times);
+  for (const GPUDevice::TimingScopeTime& present_time : s_gpu_timing_scope_present_times)
+  {
+    // Results arrive a few frames late, but that doesn't matter for a counter track.
+    EventTrace::Counter(present_time.name, static_cast<s64>(present_time.time * 1000.0f));
+
+    const auto iter =
+      std::find_if(s_gpu_timing_scope_times.begin(), s_gpu_timing_scope_times.end(),
+                   [&present_time](const GPUDevice::TimingScopeTime& it) { return (it.name == present_time.name); });
+    if (iter != s_gpu_timing_scope_times.end())
+      iter->time += present_time.time;
+    else
+      s_gpu_timing_scope_times.push_back(present_time);
+  }
+}
+
+void PerformanceCounters::UpdateGPUTimeBreakdown()
+{
+  GPUTimeBreakdown& breakdown = s_state.gpu_time_breakdown;
+  const float presents = static_cast<float>(std::max(s_state.presents_since_last_update, 1u));
+  const u32 num_scopes = static_cast<u32>(s_gpu_timing_scope_times.size());
+  breakdown.num_scopes = std::min(num_scopes, MAX_GPU_TIME_BREAKDOWN_SCOPES);
+  std::partial_sort(s_gpu_timing_scope_times.begin(), s_gpu_timing_scope_times.begin() + breakdown.num_scopes,
+                    s_gpu_timing_scope_times.end(),
+                    [](const auto& lhs, const auto& rhs) { return (lhs.time > rhs.time); });
+  for (u32 i = 0; i < breakdown.num_scopes; i++)
+  {
+    breakdown.scope_names[i] = s_gpu_timing_scope_times[i].name;
+    breakdown.scope_time[i] = s_gpu_timing_scope_times[i].time / presents;
+  }
+}
+
+void PerformanceCounters::AttributeStutter(StutterCause cause)
+{
+  s_stutter_cause_times[static_cast<size_t>(cause)].store(Timer::GetCurrentValue(), std::memory_order_relaxed);
+}
+
+void PerformanceCounters::UpdateFrameTimePercentiles()
+{
+  const u32 count = s_state.percentile_frame_times_count;
+  if (count == 0)
+    return;
+
+  // Order within the ring doesn't matter, and sorting ~1000 values once a second is cheap.
+  std::array<float, NUM_FRAME_TIME_PERCENTILE_SAMPLES> sorted;
+  std::copy_n(s_state.percentile_frame_times.begin(), count, sorted.begin());
+  std::sort(sorted.begin(), sorted.begin() + count);
+
+  // Nearest-rank, so the highest percentiles are real frame times rather than interpolated.
+  const auto percentile = [&sorted, count](double p) {
+    const u32 rank = static_cast<u32>(std::ceil(p * static_cast<double>(count)));
+    return sorted[std::clamp<u32>(rank, 1, count) - 1];
+  };
+
+  FrameTimePercentiles& percentiles = s_state.frame_time_percentiles;
+  percentiles.p50 = percentile(0.5);
+  percentiles.p95 = percentile(0.95);
+  percentiles.p99 = percentile(0.99);
+  percentiles.p999 = percentile(0.999);
+}
+
+void PerformanceCounters::CheckForStutter(float frame_time, Timer::Value frame_end_time)
+{
+  // Nothing to compare against until the first percentile update.
+  const float median = s_state.frame_time_percentiles.p50;
+  if (median <= 0.0f ||
+      frame_time < std::max(median * STUTTER_FRAME_TIME_FACTOR, median + STUTTER_MINIMUM_FRAME_TIME_INCREASE))
+  {
+    return;
+  }
+
+  // The GPU thread can be up to a frame behind the CPU thread, so causes from the frame before count too.
+  const Timer::Value window =
+    static_cast<Timer::Value>(Timer::ConvertMillisecondsToValue(static_cast<double>(frame_time + median)));
+  const Timer::Value window_start = (frame_end_time > window) ? (frame_end_time - window) : 0;
+
+  StutterStatistics& stats = s_state.stutter_statistics;
+  u32 causes = 0;
+  for (u32 i = 0; i < NUM_STUTTER_CAUSES; i++)
+  {
+    Timer::Value cause_time = s_stutter_cause_times[i].load(std::memory_order_relaxed);
+    if (cause_time == 0 || cause_time < window_start)
+      continue;
+
+    // Don't blame the same event for several slow frames in a row.
+    if (!s_stutter_cause_times[i].compare_exchange_strong(cause_time, 0, std::memory_order_relaxed))
+      continue;
+
+    causes |= (1u << i);
+    stats.cause_counts[i]++;
+  }
+
+  stats.count++;
+  stats.unattributed_count += BoolToUInt32(causes == 0);
+  stats.last_frame_time = frame_time;
+  stats.last_causes = causes;
+
+  if (Log::IsLogVisible(Log::Level::Dev, Log::Channel::PerfMon))
+  {
+    SmallString cause_names;
+    for (u32 i = 0; i < NUM_STUTTER_CAUSES; i++)
+    {
+      if (causes & (1u << i))
+        cause_names.append_format("{}{}", cause_names.empty() ? "" : ", ", s_stutter_cause_names[i]);
+    }
+
+    DEV_LOG("Stutter: {:.2f}ms frame, median {:.2f}ms, caused by {}", frame_time, median,
+            cause_names.empty() ? std::string_view("unknown") : cause_names.view());
+  }
+}
+
+void PerformanceCounters::SampleCPUTimeCounters(float time, float frames_run)
+{
+  const u64 timestamp = ReadCPUTimestamp();
+  const u64 timestamp_delta = timestamp - std::exchange(s_state.last_cpu_time_timestamp, timestamp);
+
+  // Counters are sampled from the GPU thread, so they only ever increase, and the change since the last sample is used.
+  // The timestamp frequency is calibrated against the wall clock over the same interval.
+  const double ms_per_tick = (timestamp_delta > 0 && frames_run > 0.0f) ?
+                               (static_cast<double>(time) * 1000.0 / static_cast<double>(timestamp_delta) /
+                                static_cast<double>(frames_run)) :
+                               0.0;
+  const auto sample = [ms_per_tick](const std::atomic<u64>& counter, u64& last_ticks) {
+    const u64 ticks = counter.load(std::memory_order_relaxed);
+    return static_cast<float>(static_cast<double>(ticks - std::exchange(last_ticks, ticks)) * ms_per_tick);
+  };
+
+  CPUTimeBreakdown& breakdown = s_state.cpu_time_breakdown;
+  for (u32 i = 0; i < NUM_CPU_TIME_CATEGORIES; i++)
+    breakdown.category_time[i] = sample(g_cpu_time_counters.category_ticks[i], s_state.last_cpu_time_category_ticks[i]);
+
+  std::array<std::pair<float, u32>, MAX_CPU_TIME_EVENT_COUNTERS> event_times;
+  const u32 num_event_counters = s_num_cpu_time_event_counters.load(std::memory_order_acquire);
+  for (u32 i = 0; i < num_event_counters; i++)
+  {
+    const float event_time = sample(s_cpu_time_event_counters[i].ticks, s_state.last_cpu_time_event_ticks[i]);
+    breakdown.category_time[static_cast<size_t>(CPUTimeCategory::Events)] += event_time;
+    event_times[i] = std::make_pair(event_time, i);
+  }
+
+  breakdown.num_events = std::min(num_event_counters, MAX_CPU_TIME_BREAKDOWN_EVENTS);
+  std::partial_sort(event_times.begin(), event_times.begin() + breakdown.num_events,
+                    event_times.begin() + num_event_counters,
+                    [](const auto& lhs, const auto& rhs) { return (lhs.first > rhs.first); });
+  for (u32 i = 0; i < breakdown.num_events; i++)
+  {
+    breakdown.event_names[i] = s_cpu_time_event_counters[event_times[i].second].name;
+    breakdown.event_time[i] = event_times[i].first;
+  }
+}
+
+void PerformanceCounters::BeginCPUTimeProfiling(CPUTimeCategory category)
+{
+  if (!g_settings.display_show_cpu_breakdown)
+    return;
+
+  g_cpu_time_counters.last_timestamp = ReadCPUTimestamp();
+  g_cpu_time_counters.current = &g_cpu_time_counters.category_ticks[static_cast<size_t>(category)];
+}
+
+void PerformanceCounters::EndCPUTimeProfiling()
+{
+  if (!g_cpu_time_counters.current)
+    return;
+
+  SwitchCPUTimeCounter(nullptr);
+}
+
+std::atomic<u64>* PerformanceCounters::GetEventCPUTimeCounter(std::string_view name)
+{
+  const u32 num_counters = s_num_cpu_time_event_counters.load(std::memory_order_relaxed);
+  for (u32 i = 0; i < num_counters; i++)
+  {
+    CPUTimeEventCounter& counter = s_cpu_time_event_counters[i];
+    if (counter.name.data() == name.data() || counter.name == name)
+      return &counter.ticks;
+  }
+
+  if (num_counters == MAX_CPU_TIME_EVENT_COUNTERS)
+    return &g_cpu_time_counters.category_ticks[static_cast<size_t>(CPUTimeCategory::Events)];
+
+  s_cpu_time_event_counters[num_counters].name = name;
+  s_num_cpu_time_event_counters.store(num_counters + 1, std::memory_order_release);
+  return &s_cpu_time_event_counters[num_counters].ticks;
 }
@@ -3,8 +3,20 @@
 
 #pragma once
 
+#include "common/intrin.h"
 #include "common/types.h"
 
+#include <array>
+#include <atomic>
+#include <string_view>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#if !defined(CPU_ARCH_X86) && !defined(CPU_ARCH_X64) && !defined(CPU_ARCH_ARM64) && !defined(CPU_ARCH_RISCV64)
+#include <chrono>
+#endif
+
 class GPUBackend;
 
 namespace PerformanceCounters {
@@ -12,6 +24,92 @@ namespace PerformanceCounters {
 inline constexpr u32 NUM_FRAME_TIME_SAMPLES = 152;
 using FrameTimeHistory = std::array<float, NUM_FRAME_TIME_SAMPLES>;
 
+/// Frame time percentiles, in milliseconds. Computed over the last NUM_FRAME_TIME_PERCENTILE_SAMPLES frames.
+inline constexpr u32 NUM_FRAME_TIME_PERCENTILE_SAMPLES = 1024;
+struct FrameTimePercentiles
+{
+  float p50;
+  float p95;
+  float p99;
+  float p999;
+};
+
+/// Things that are known to make frames take longer, recorded by the subsystem responsible with AttributeStutter().
+enum class StutterCause : u8
+{
+  ShaderCompile,
+  CodeCacheReset,
+  CDSeek,
+  TextureReplacementLoad,
+  SaveState,
+  MaxCount
+};
+
+inline constexpr u32 NUM_STUTTER_CAUSES = static_cast<u32>(StutterCause::MaxCount);
+
+struct StutterStatistics
+{
+  u32 count;
+
+  // Stutters can have more than one cause, so these don't necessarily add up to count.
+  std::array<u32, NUM_STUTTER_CAUSES> cause_counts;
+  u32 unattributed_count;
+
+  float last_frame_time;
+  u32 last_causes; // Bitmask of StutterCause.
+};
+
+/// Subsystems that CPU thread time is split between. Time is charged to the innermost scope only, so work that is
+/// nested inside another subsystem (e.g. GPU commands written from an event) is not counted twice.
+enum class CPUTimeCategory : u8
+{
+  Recompiler,
+  Interpreter,
+  GTE,
+  GPU,
+  MDEC,
+  SPU,
+  CDROM,
+  Events,
+  MaxCount
+};
+
+inline constexpr u32 NUM_CPU_TIME_CATEGORIES = static_cast<u32>(CPUTimeCategory::MaxCount);
+inline constexpr u32 MAX_CPU_TIME_BREAKDOWN_EVENTS = 3;
+
+struct CPUTimeBreakdown
+{
+  // Milliseconds per frame.
+  std::array<float, NUM_CPU_TIME_CATEGORIES> category_time;
+
+  // Most expensive event callbacks, these are included in the Events category time.
+  std::array<std::string_view, MAX_CPU_TIME_BREAKDOWN_EVENTS> event_names;
+  std::array<float, MAX_CPU_TIME_BREAKDOWN_EVENTS> event_time;
+  u32 num_events;
+};
+
+/// Most expensive GPU passes, timed with timestamp queries around each pass. Only sampled while the breakdown is
+/// shown, and only on backends which support timing scopes.
+inline constexpr u32 MAX_GPU_TIME_BREAKDOWN_SCOPES = 8;
+
+struct GPUTimeBreakdown
+{
+  // Milliseconds per presented frame, sorted by time.
+  std::array<const char*, MAX_GPU_TIME_BREAKDOWN_SCOPES> scope_names;
+  std::array<float, MAX_GPU_TIME_BREAKDOWN_SCOPES> scope_time;
+  u32 num_scopes;
+};
+
+/// Only written by the CPU thread. The counters are atomic so that they can be sampled from the GPU thread.
+struct CPUTimeCounters
+{
+  std::atomic<u64>* current;
+  u64 last_timestamp;
+  std::array<std::atomic<u64>, NUM_CPU_TIME_CATEGORIES> category_ticks;
+};
+
+extern CPUTimeCounters g_cpu_time_counters;
+
 float GetFPS();
 float GetVPS();
 float GetEmulationSpeed();
@@ -22,14 +120,103 @@ float GetCoreThreadUsage();
 float GetCoreThreadAverageTime();
 float GetGPUThreadUsage();
 float GetGPUThreadAverageTime();
+float GetGPUThreadSyncSpinWindow();
+float GetGPUThreadAverageWakeLatency();
+float GetGPUThreadMaximumWakeLatency();
+u32 GetGPUThreadSyncSpinCount();
+u32 GetGPUThreadSyncYieldCount();
+u32 GetGPUThreadSyncSleepCount();
+u32 GetAudioUnderrunCount();
+u32 GetAudioOverrunCount();
+float GetAudioBufferedTime();
+float GetAudioBufferUsage();
 float GetGPUUsage();
 float GetGPUAverageTime();
 const FrameTimeHistory& GetFrameTimeHistory();
 u32 GetFrameTimeHistoryPos();
+const FrameTimePercentiles& GetFrameTimePercentiles();
+const StutterStatistics& GetStutterStatistics();
+const char* GetStutterCauseName(StutterCause cause);
+const CPUTimeBreakdown& GetCPUTimeBreakdown();
+const char* GetCPUTimeCategoryName(CPUTimeCategory category);
+const GPUTimeBreakdown& GetGPUTimeBreakdown();
 
 void Clear();
 void Reset();
 void Update(GPUBackend* gpu, u32 frame_number, u32 internal_frame_number);
 void AccumulateGPUTime();
 
+/// Notes that something which may cause a stutter just happened. Any frame which is slow enough to be counted as a
+/// stutter in the next two frames is attributed to it. Can be called from any thread.
+void AttributeStutter(StutterCause cause);
+
+/// Charges CPU thread time to the given category until the end call, if the breakdown is enabled. Called around CPU
+/// execution, any scopes which are still open when execution is exited are simply discarded.
+void BeginCPUTimeProfiling(CPUTimeCategory category);
+void EndCPUTimeProfiling();
+
+/// Returns the counter used for the named event's callback.
+std::atomic<u64>* GetEventCPUTimeCounter(std::string_view name);
+
+/// Cheap timestamp for profiling. The frequency is unknown, so it is calibrated against the wall clock.
+ALWAYS_INLINE u64 ReadCPUTimestamp()
+{
+#if defined(CPU_ARCH_X86) || defined(CPU_ARCH_X64)
+  return __rdtsc();
+#elif defined(CPU_ARCH_ARM64) && defined(_MSC_VER) && !defined(__clang__)
+  return static_cast<u64>(_ReadStatusReg(ARM64_CNTVCT));
+#elif defined(CPU_ARCH_ARM64)
+  u64 value;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+  return value;
+#elif defined(CPU_ARCH_RISCV64)
+  u64 value;
+  asm volatile("rdtime %0" : "=r"(value));
+  return value;
+#else
+  return static_cast<u64>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+/// Charges the time since the last switch to the current counter, and makes counter current.
+ALWAYS_INLINE std::atomic<u64>* SwitchCPUTimeCounter(std::atomic<u64>* counter)
+{
+  const u64 now = ReadCPUTimestamp();
+  std::atomic<u64>* const previous = g_cpu_time_counters.current;
+  previous->store(previous->load(std::memory_order_relaxed) + (now - g_cpu_time_counters.last_timestamp),
+                  std::memory_order_relaxed);
+  g_cpu_time_counters.last_timestamp = now;
+  g_cpu_time_counters.current = counter;
+  return previous;
+}
+
+/// Charges time to a subsystem for the lifetime of the object. Only costs a branch when profiling isn't active.
+class CPUTimeScope
+{
+public:
+  ALWAYS_INLINE explicit CPUTimeScope(CPUTimeCategory category)
+    : m_previous(g_cpu_time_counters.current ?
+                   SwitchCPUTimeCounter(&g_cpu_time_counters.category_ticks[static_cast<size_t>(category)]) :
+                   nullptr)
+  {
+  }
+
+  ALWAYS_INLINE explicit CPUTimeScope(std::string_view event_name)
+    : m_previous(g_cpu_time_counters.current ? SwitchCPUTimeCounter(GetEventCPUTimeCounter(event_name)) : nullptr)
+  {
+  }
+
+  ALWAYS_INLINE ~CPUTimeScope()
+  {
+    if (m_previous && g_cpu_time_counters.current) [[unlikely]]
+      SwitchCPUTimeCounter(m_previous);
+  }
+
+  CPUTimeScope(const CPUTimeScope&) = delete;
+  CPUTimeScope& operator=(const CPUTimeScope&) = delete;
+
+private:
+  std::atomic<u64>* m_previous;
+};
+
 } // namespace PerformanceCounters
@@ -10,6 +10,7 @@
 #include "imgui_overlays.h"
 #include "system.h"
 
+#include "util/cd_image.h"
 #include "util/gpu_device.h"
 #include "util/imgui_manager.h"
 #include "util/input_manager.h"
@@ -220,6 +221,8 @@ void Settings::Load(const SettingsInterface& si, const SettingsInterface& contro
   disable_background_input = si.GetBoolValue("Main", "DisableBackgroundInput", false);
   save_state_on_exit = si.GetBoolValue("Main", "SaveStateOnExit", true);
   create_save_state_backups = si.GetBoolValue("Main", "CreateSaveStateBackups", DEFAULT_SAVE_STATE_BACKUPS);
+  uncompressed_resume_states = si.GetBoolValue("Main", "UncompressedResumeStates", false);
+  psf_audio_only = si.GetBoolValue("Main", "PSFAudioOnly", false);
   confim_power_off = si.GetBoolValue("Main", "ConfirmPowerOff", true);
   load_devices_from_save_states = si.GetBoolValue("Main", "LoadDevicesFromSaveStates", false);
   apply_compatibility_settings = si.GetBoolValue("Main", "ApplyCompatibilitySettings", true);
@@ -227,6 +230,8 @@ void Settings::Load(const SettingsInterface& si, const SettingsInterface& contro
   disable_all_enhancements = si.GetBoolValue("Main", "DisableAllEnhancements", false);
   enable_discord_presence = si.GetBoolValue("Main", "EnableDiscordPresence", false);
   rewind_enable = si.GetBoolValue("Main", "RewindEnable", false);
+  rewind_compress_states = si.GetBoolValue("Main", "RewindCompressStates", false);
+  rewind_tiered_states = si.GetBoolValue("Main", "RewindTieredStates", false);
   rewind_save_frequency = si.GetFloatValue("Main", "RewindFrequency", 10.0f);
   rewind_save_slots = static_cast<u16>(std::min(si.GetUIntValue("Main", "RewindSaveSlots", 10u), 65535u));
   runahead_frames = static_cast<u8>(std::min(si.GetUIntValue("Main", "RunaheadFrameCount", 0u), 255u));
@@ -243,15 +248,33 @@ void Settings::Load(const SettingsInterface& si, const SettingsInterface& contro
   cpu_recompiler_memory_exceptions = si.GetBoolValue("CPU", "RecompilerMemoryExceptions", false);
   cpu_recompiler_block_linking = si.GetBoolValue("CPU", "RecompilerBlockLinking", true);
   cpu_recompiler_icache = si.GetBoolValue("CPU", "RecompilerICache", false);
+  cpu_recompiler_block_cache = si.GetBoolValue("CPU", "RecompilerBlockCache", false);
+  cpu_recompiler_trace_formation = si.GetBoolValue("CPU", "RecompilerTraceFormation", false);
+  cpu_recompiler_block_profiling = si.GetBoolValue("CPU", "RecompilerBlockProfiling", false);
+  timing_event_statistics = si.GetBoolValue("Debug", "TimingEventStatistics", false);
+  cpu_recompiler_subpage_invalidation = si.GetBoolValue("CPU", "RecompilerSubPageInvalidation", false);
+  cpu_recompiler_loop_register_cache = si.GetBoolValue("CPU", "RecompilerLoopRegisterCache", false);
+  cpu_recompiler_code_buffer_eviction = si.GetBoolValue("CPU", "RecompilerCodeBufferEviction", false);
+  cpu_recompiler_block_optimization = si.GetBoolValue("CPU", "RecompilerBlockOptimization", false);
+  cpu_idle_loop_skipping = si.GetBoolValue("CPU", "IdleLoopSkipping", false);
+  cpu_recompiler_compile_budget =
+    static_cast<u16>(std::min(si.GetUIntValue("CPU", "RecompilerCompileBudget", 0u), 65535u));
   cpu_fastmem_mode = ParseCPUFastmemMode(
                        si.GetStringValue("CPU", "FastmemMode", GetCPUFastmemModeName(DEFAULT_CPU_FASTMEM_MODE)).c_str())
                        .value_or(DEFAULT_CPU_FASTMEM_MODE);
+  cpu_thread_placement =
+    ParseThreadPlacementMode(
+      si.GetStringValue("CPU", "ThreadPlacement", GetThreadPlacementModeName(DEFAULT_THREAD_PLACEMENT_MODE)).c_str())
+      .value_or(DEFAULT_THREAD_PLACEMENT_MODE);
 
   gpu_renderer = ParseRendererName(si.GetStringValue("GPU", "Renderer", GetRendererName(DEFAULT_GPU_RENDERER)).c_str())
                    .value_or(DEFAULT_GPU_RENDERER);
   gpu_adapter = si.GetStringValue("GPU", "Adapter", "");
   gpu_resolution_scale = static_cast<u8>(si.GetUIntValue("GPU", "ResolutionScale", 1u));
   gpu_automatic_resolution_scale = (gpu_resolution_scale == 0);
+  gpu_dynamic_resolution_scale = si.GetBoolValue("GPU", "DynamicResolutionScale", false);
+  gpu_dynamic_resolution_scale_minimum =
+    static_cast<u8>(std::clamp<u32>(si.GetUIntValue("GPU", "DynamicResolutionScaleMinimum", 1u), 1u, 255u));
   gpu_multisamples = static_cast<u8>(si.GetUIntValue("GPU", "Multisamples", 1u));
   gpu_use_debug_device = si.GetBoolValue("GPU", "UseDebugDevice", false);
   gpu_use_debug_device_gpu_validation = si.GetBoolValue("GPU", "UseGPUBasedValidation", false);
@@ -268,8 +291,11 @@ void Settings::Load(const SettingsInterface& si, const SettingsInterface& contro
   gpu_per_sample_shading = si.GetBoolValue("GPU", "PerSampleShading", false);
   gpu_use_thread = si.GetBoolValue("GPU", "UseThread", true);
   gpu_max_queued_frames = static_cast<u8>(si.GetUIntValue("GPU", "MaxQueuedFrames", DEFAULT_GPU_MAX_QUEUED_FRAMES));
+  gpu_software_renderer_threads =
+    static_cast<u8>(std::min<u32>(si.GetUIntValue("GPU", "SoftwareRendererThreads", 0u), 255));
   gpu_use_software_renderer_for_readbacks = si.GetBoolValue("GPU", "UseSoftwareRendererForReadbacks", false);
   gpu_use_software_renderer_for_memory_states = si.GetBoolValue("GPU", "UseSoftwareRendererForMemoryStates", false);
+  gpu_native_resolution_memory_states = si.GetBoolValue("GPU", "NativeResolutionMemoryStates", false);
   gpu_scaled_interlacing = si.GetBoolValue("GPU", "ScaledInterlacing", true);
   gpu_force_round_texcoords = si.GetBoolValue("GPU", "ForceRoundTextureCoordinates", false);
   gpu_texture_filter =
@@ -304,6 +330,11 @@ void Settings::Load(const SettingsInterface& si, const SettingsInterface& contro
   gpu_widescreen_rendering = gpu_widescreen_hack = si.GetBoolValue("GPU", "WidescreenHack", false);
   gpu_modulation_crop = si.GetBoolValue("GPU", "EnableModulationCrop", false);
   gpu_texture_cache = si.GetBoolValue("GPU", "EnableTextureCache", false);
+  gpu_deferred_batch_submission = si.GetBoolValue("GPU", "DeferredBatchSubmission", false);
+  gpu_speculative_vram_readbacks = si.GetBoolValue("GPU", "SpeculativeVRAMReadbacks", false);
+  gpu_fast_forward_render_skip = si.GetBoolValue("GPU", "FastForwardRenderSkip", false);
+  gpu_precompile_used_pipelines = si.GetBoolValue("GPU", "PrecompileUsedPipelines", false);
+  gpu_pgxp_depth_culling = si.GetBoolValue("GPU", "PGXPDepthCulling", false);
   display_24bit_chroma_smoothing = si.GetBoolValue("GPU", "ChromaSmoothing24Bit", false);
   gpu_pgxp_enable = si.GetBoolValue("GPU", "PGXPEnable", false);
   LoadPGXPSettings(si);
@@ -385,12 +416,15 @@ void Settings::Load(const SettingsInterface& si, const SettingsInterface& contro
   display_show_resolution = si.GetBoolValue("Display", "ShowResolution", false);
   display_show_latency_stats = si.GetBoolValue("Display", "ShowLatencyStatistics", false);
   display_show_cpu_usage = si.GetBoolValue("Display", "ShowCPU", false);
+  display_show_cpu_breakdown = si.GetBoolValue("Display", "ShowCPUBreakdown", false);
   display_show_gpu_usage = si.GetBoolValue("Display", "ShowGPU", false);
+  display_show_gpu_breakdown = si.GetBoolValue("Display", "ShowGPUBreakdown", false);
   display_show_frame_times = si.GetBoolValue("Display", "ShowFrameTimes", false);
   display_show_status_indicators = si.GetBoolValue("Display", "ShowStatusIndicators", true);
   display_show_inputs = si.GetBoolValue("Display", "ShowInputs", false);
   display_show_enhancements = si.GetBoolValue("Display", "ShowEnhancements", false);
   display_auto_resize_window = si.GetBoolValue("Display", "AutoResizeWindow", false);
+  display_shared_memory_frame_export = si.GetBoolValue("Display", "SharedMemoryFrameExport", false);
   display_osd_scale = si.GetFloatValue("Display", "OSDScale", DEFAULT_OSD_SCALE);
   display_osd_margin = std::max(si.GetFloatValue("Display", "OSDMargin", ImGuiManager::DEFAULT_SCREEN_MARGIN), 0.0f);
 
@@ -412,6 +446,8 @@ void Settings::Load(const SettingsInterface& si, const SettingsInterface& contro
 
   cdrom_readahead_sectors =
     static_cast<u8>(si.GetIntValue("CDROM", "ReadaheadSectors", DEFAULT_CDROM_READAHEAD_SECTORS));
+  cdrom_decompression_cache_size = Truncate16(std::min<u32>(
+    si.GetUIntValue("CDROM", "DecompressionCacheSize", DEFAULT_CDROM_DECOMPRESSION_CACHE_SIZE), 1024u));
   cdrom_mechacon_version =
     ParseCDROMMechVersionName(
       si.GetStringValue("CDROM", "MechaconVersion", GetCDROMMechVersionName(DEFAULT_CDROM_MECHACON_VERSION)).c_str())
@@ -419,6 +455,7 @@ void Settings::Load(const SettingsInterface& si, const SettingsInterface& contro
   cdrom_region_check = si.GetBoolValue("CDROM", "RegionCheck", false);
   cdrom_subq_skew = si.GetBoolValue("CDROM", "SubQSkew", false);
   cdrom_load_image_to_ram = si.GetBoolValue("CDROM", "LoadImageToRAM", false);
+  cdrom_load_image_compressed = si.GetBoolValue("CDROM", "LoadImageToRAMCompressed", false);
   cdrom_load_image_patches = si.GetBoolValue("CDROM", "LoadImagePatches", false);
   cdrom_ignore_host_subcode = si.GetBoolValue("CDROM", "IgnoreHostSubcode", false);
   cdrom_mute_cd_audio = si.GetBoolValue("CDROM", "MuteCDAudio", false);
@@ -444,10 +481,13 @@ void Settings::Load(const SettingsInterface& si, const SettingsInterface& contro
     Truncate8(std::min<u32>(si.GetUIntValue("Audio", "OutputVolume", 100), std::numeric_limits<u8>::max()));
   audio_fast_forward_volume =
     Truncate8(std::min<u32>(si.GetUIntValue("Audio", "FastForwardVolume", 100), std::numeric_limits<u8>::max()));
+  audio_skip_output_speed =
+    Truncate16(std::min<u32>(si.GetUIntValue("Audio", "SkipOutputSpeed", 0u), std::numeric_limits<u16>::max()));
 
   audio_output_muted = si.GetBoolValue("Audio", "OutputMuted", false);
 
   mdec_use_old_routines = si.GetBoolValue("Hacks", "UseOldMDECRoutines", false);
+  mdec_use_thread = si.GetBoolValue("Hacks", "MDECUseThread", false);
   export_shared_memory = si.GetBoolValue("Hacks", "ExportSharedMemory", false);
 
   dma_max_slice_ticks = si.GetIntValue("Hacks", "DMAMaxSliceTicks", DEFAULT_DMA_MAX_SLICE_TICKS);
@@ -464,6 +504,7 @@ void Settings::Load(const SettingsInterface& si, const SettingsInterface& contro
       controller_si.GetStringValue("ControllerPorts", "MultitapMode", GetMultitapModeName(DEFAULT_MULTITAP_MODE))
         .c_str())
       .value_or(DEFAULT_MULTITAP_MODE);
+  controller_late_input_poll = controller_si.GetBoolValue("ControllerPorts", "LateInputPoll", false);
 
   const std::array<bool, 2> mtap_enabled = {{IsPort1MultitapEnabled(), IsPort2MultitapEnabled()}};
   for (u32 pad = 0; pad < NUM_CONTROLLER_AND_CARD_PORTS; pad++)
@@ -532,6 +573,7 @@ void Settings::Load(const SettingsInterface& si, const SettingsInterface& contro
     si.GetBoolValue("TextureReplacements", "EnableVRAMWriteReplacements", false);
   texture_replacements.always_track_uploads = si.GetBoolValue("TextureReplacements", "AlwaysTrackUploads", false);
   texture_replacements.preload_textures = si.GetBoolValue("TextureReplacements", "PreloadTextures", false);
+  texture_replacements.async_load_textures = si.GetBoolValue("TextureReplacements", "AsyncLoadTextures", false);
   texture_replacements.dump_textures = si.GetBoolValue("TextureReplacements", "DumpTextures", false);
   texture_replacements.dump_replaced_textures = si.GetBoolValue("TextureReplacements", "DumpReplacedTextures", true);
   texture_replacements.dump_vram_writes = si.GetBoolValue("TextureReplacements", "DumpVRAMWrites", false);
@@ -549,6 +591,8 @@ void Settings::Load(const SettingsInterface& si, const SettingsInterface& contro
     si.GetBoolValue("TextureReplacements", "ConvertCopiesToWrites", false);
   texture_replacements.config.replacement_scale_linear_filter =
     si.GetBoolValue("TextureReplacements", "ReplacementScaleLinearFilter", false);
+  texture_replacements.config.direct_replacement_textures =
+    si.GetBoolValue("TextureReplacements", "DirectReplacementTextures", false);
 
   texture_replacements.config.max_hash_cache_entries =
     si.GetUIntValue("TextureReplacements", "MaxHashCacheEntries",
@@ -559,6 +603,9 @@ void Settings::Load(const SettingsInterface& si, const SettingsInterface& contro
   texture_replacements.config.max_replacement_cache_vram_usage_mb =
     si.GetUIntValue("TextureReplacements", "MaxReplacementCacheVRAMUsage",
                     TextureReplacementSettings::Configuration::DEFAULT_MAX_REPLACEMENT_CACHE_VRAM_USAGE_MB);
+  texture_replacements.config.max_preload_memory_usage_mb =
+    si.GetUIntValue("TextureReplacements", "MaxPreloadMemoryUsageMB",
+                    TextureReplacementSettings::Configuration::DEFAULT_MAX_PRELOAD_MEMORY_USAGE_MB);
 
   texture_replacements.config.max_vram_write_splits = Truncate16(
     std::min<u32>(si.GetUIntValue("TextureReplacements", "MaxVRAMWriteSplits", 0u), std::numeric_limits<u16>::max()));
@@ -627,6 +674,8 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
     si.SetBoolValue("Main", "PauseOnControllerDisconnection", pause_on_controller_disconnection);
     si.SetBoolValue("Main", "SaveStateOnExit", save_state_on_exit);
     si.SetBoolValue("Main", "CreateSaveStateBackups", create_save_state_backups);
+    si.SetBoolValue("Main", "UncompressedResumeStates", uncompressed_resume_states);
+    si.SetBoolValue("Main", "PSFAudioOnly", psf_audio_only);
     si.SetStringValue("Main", "SaveStateCompression", GetSaveStateCompressionModeName(save_state_compression));
     si.SetBoolValue("Main", "ConfirmPowerOff", confim_power_off);
     si.SetBoolValue("Main", "EnableDiscordPresence", enable_discord_presence);
@@ -637,6 +686,8 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
   si.SetBoolValue("Main", "LoadDevicesFromSaveStates", load_devices_from_save_states);
   si.SetBoolValue("Main", "DisableAllEnhancements", disable_all_enhancements);
   si.SetBoolValue("Main", "RewindEnable", rewind_enable);
+  si.SetBoolValue("Main", "RewindCompressStates", rewind_compress_states);
+  si.SetBoolValue("Main", "RewindTieredStates", rewind_tiered_states);
   si.SetFloatValue("Main", "RewindFrequency", rewind_save_frequency);
   si.SetUIntValue("Main", "RewindSaveSlots", rewind_save_slots);
   si.SetUIntValue("Main", "RunaheadFrameCount", runahead_frames);
@@ -649,11 +700,24 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
   si.SetBoolValue("CPU", "RecompilerMemoryExceptions", cpu_recompiler_memory_exceptions);
   si.SetBoolValue("CPU", "RecompilerBlockLinking", cpu_recompiler_block_linking);
   si.SetBoolValue("CPU", "RecompilerICache", cpu_recompiler_icache);
+  si.SetBoolValue("CPU", "RecompilerBlockCache", cpu_recompiler_block_cache);
+  si.SetBoolValue("CPU", "RecompilerTraceFormation", cpu_recompiler_trace_formation);
+  si.SetBoolValue("CPU", "RecompilerBlockProfiling", cpu_recompiler_block_profiling);
+  si.SetBoolValue("Debug", "TimingEventStatistics", timing_event_statistics);
+  si.SetBoolValue("CPU", "RecompilerSubPageInvalidation", cpu_recompiler_subpage_invalidation);
+  si.SetBoolValue("CPU", "RecompilerLoopRegisterCache", cpu_recompiler_loop_register_cache);
+  si.SetBoolValue("CPU", "RecompilerCodeBufferEviction", cpu_recompiler_code_buffer_eviction);
+  si.SetBoolValue("CPU", "RecompilerBlockOptimization", cpu_recompiler_block_optimization);
+  si.SetBoolValue("CPU", "IdleLoopSkipping", cpu_idle_loop_skipping);
+  si.SetUIntValue("CPU", "RecompilerCompileBudget", cpu_recompiler_compile_budget);
   si.SetStringValue("CPU", "FastmemMode", GetCPUFastmemModeName(cpu_fastmem_mode));
+  si.SetStringValue("CPU", "ThreadPlacement", GetThreadPlacementModeName(cpu_thread_placement));
 
   si.SetStringValue("GPU", "Renderer", GetRendererName(gpu_renderer));
   si.SetStringValue("GPU", "Adapter", gpu_adapter.c_str());
   si.SetUIntValue("GPU", "ResolutionScale", gpu_resolution_scale);
+  si.SetBoolValue("GPU", "DynamicResolutionScale", gpu_dynamic_resolution_scale);
+  si.SetUIntValue("GPU", "DynamicResolutionScaleMinimum", gpu_dynamic_resolution_scale_minimum);
   si.SetUIntValue("GPU", "Multisamples", gpu_multisamples);
 
   if (!ignore_base)
@@ -674,9 +738,11 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
 
   si.SetBoolValue("GPU", "PerSampleShading", gpu_per_sample_shading);
   si.SetUIntValue("GPU", "MaxQueuedFrames", gpu_max_queued_frames);
+  si.SetUIntValue("GPU", "SoftwareRendererThreads", gpu_software_renderer_threads);
   si.SetBoolValue("GPU", "UseThread", gpu_use_thread);
   si.SetBoolValue("GPU", "UseSoftwareRendererForReadbacks", gpu_use_software_renderer_for_readbacks);
   si.SetBoolValue("GPU", "UseSoftwareRendererForMemoryStates", gpu_use_software_renderer_for_memory_states);
+  si.SetBoolValue("GPU", "NativeResolutionMemoryStates", gpu_native_resolution_memory_states);
   si.SetBoolValue("GPU", "ScaledInterlacing", gpu_scaled_interlacing);
   si.SetBoolValue("GPU", "ForceRoundTextureCoordinates", gpu_force_round_texcoords);
   si.SetStringValue("GPU", "TextureFilter", GetTextureFilterName(gpu_texture_filter));
@@ -690,6 +756,11 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
   si.SetBoolValue("GPU", "WidescreenHack", gpu_widescreen_rendering);
   si.SetBoolValue("GPU", "EnableModulationCrop", gpu_modulation_crop);
   si.SetBoolValue("GPU", "EnableTextureCache", gpu_texture_cache);
+  si.SetBoolValue("GPU", "DeferredBatchSubmission", gpu_deferred_batch_submission);
+  si.SetBoolValue("GPU", "SpeculativeVRAMReadbacks", gpu_speculative_vram_readbacks);
+  si.SetBoolValue("GPU", "FastForwardRenderSkip", gpu_fast_forward_render_skip);
+  si.SetBoolValue("GPU", "PrecompileUsedPipelines", gpu_precompile_used_pipelines);
+  si.SetBoolValue("GPU", "PGXPDepthCulling", gpu_pgxp_depth_culling);
   si.SetBoolValue("GPU", "ChromaSmoothing24Bit", display_24bit_chroma_smoothing);
   si.SetBoolValue("GPU", "PGXPEnable", gpu_pgxp_enable);
   si.SetBoolValue("GPU", "PGXPCulling", gpu_pgxp_culling);
@@ -745,7 +816,9 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
     si.SetBoolValue("Display", "ShowLatencyStatistics", display_show_latency_stats);
     si.SetBoolValue("Display", "ShowGPUStatistics", display_show_gpu_stats);
     si.SetBoolValue("Display", "ShowCPU", display_show_cpu_usage);
+    si.SetBoolValue("Display", "ShowCPUBreakdown", display_show_cpu_breakdown);
     si.SetBoolValue("Display", "ShowGPU", display_show_gpu_usage);
+    si.SetBoolValue("Display", "ShowGPUBreakdown", display_show_gpu_breakdown);
     si.SetBoolValue("Display", "ShowFrameTimes", display_show_frame_times);
     si.SetBoolValue("Display", "ShowStatusIndicators", display_show_status_indicators);
     si.SetBoolValue("Display", "ShowInputs", display_show_inputs);
@@ -765,12 +838,15 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
   }
 
   si.SetBoolValue("Display", "AutoResizeWindow", display_auto_resize_window);
+  si.SetBoolValue("Display", "SharedMemoryFrameExport", display_shared_memory_frame_export);
 
   si.SetIntValue("CDROM", "ReadaheadSectors", cdrom_readahead_sectors);
+  si.SetUIntValue("CDROM", "DecompressionCacheSize", cdrom_decompression_cache_size);
   si.SetStringValue("CDROM", "MechaconVersion", GetCDROMMechVersionName(cdrom_mechacon_version));
   si.SetBoolValue("CDROM", "RegionCheck", cdrom_region_check);
   si.SetBoolValue("CDROM", "SubQSkew", cdrom_subq_skew);
   si.SetBoolValue("CDROM", "LoadImageToRAM", cdrom_load_image_to_ram);
+  si.SetBoolValue("CDROM", "LoadImageToRAMCompressed", cdrom_load_image_compressed);
   si.SetBoolValue("CDROM", "LoadImagePatches", cdrom_load_image_patches);
   si.SetBoolValue("CDROM", "IgnoreHostSubcode", cdrom_ignore_host_subcode);
   si.SetBoolValue("CDROM", "MuteCDAudio", cdrom_mute_cd_audio);
@@ -787,9 +863,11 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
   audio_stream_parameters.Save(si, "Audio");
   si.SetUIntValue("Audio", "OutputVolume", audio_output_volume);
   si.SetUIntValue("Audio", "FastForwardVolume", audio_fast_forward_volume);
+  si.SetUIntValue("Audio", "SkipOutputSpeed", audio_skip_output_speed);
   si.SetBoolValue("Audio", "OutputMuted", audio_output_muted);
 
   si.SetBoolValue("Hacks", "UseOldMDECRoutines", mdec_use_old_routines);
+  si.SetBoolValue("Hacks", "MDECUseThread", mdec_use_thread);
   si.SetBoolValue("Hacks", "ExportSharedMemory", export_shared_memory);
 
   if (!ignore_base)
@@ -826,6 +904,7 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
   si.SetBoolValue("MemoryCards", "FastForwardAccess", memory_card_fast_forward_access);
 
   si.SetStringValue("ControllerPorts", "MultitapMode", GetMultitapModeName(multitap_mode));
+  si.SetBoolValue("ControllerPorts", "LateInputPoll", controller_late_input_poll);
 
   si.SetBoolValue("Cheevos", "Enabled", achievements_enabled);
   si.SetBoolValue("Cheevos", "ChallengeMode", achievements_hardcore_mode);
@@ -855,6 +934,7 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
                   texture_replacements.enable_vram_write_replacements);
   si.SetBoolValue("TextureReplacements", "AlwaysTrackUploads", texture_replacements.always_track_uploads);
   si.SetBoolValue("TextureReplacements", "PreloadTextures", texture_replacements.preload_textures);
+  si.SetBoolValue("TextureReplacements", "AsyncLoadTextures", texture_replacements.async_load_textures);
   si.SetBoolValue("TextureReplacements", "DumpVRAMWrites", texture_replacements.dump_vram_writes);
   si.SetBoolValue("TextureReplacements", "DumpTextures", texture_replacements.dump_textures);
   si.SetBoolValue("TextureReplacements", "DumpReplacedTextures", texture_replacements.dump_replaced_textures);
@@ -871,12 +951,16 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
   si.SetBoolValue("TextureReplacements", "ConvertCopiesToWrites", texture_replacements.config.convert_copies_to_writes);
   si.SetBoolValue("TextureReplacements", "ReplacementScaleLinearFilter",
                   texture_replacements.config.replacement_scale_linear_filter);
+  si.SetBoolValue("TextureReplacements", "DirectReplacementTextures",
+                  texture_replacements.config.direct_replacement_textures);
 
   si.SetUIntValue("TextureReplacements", "MaxHashCacheEntries", texture_replacements.config.max_hash_cache_entries);
   si.SetUIntValue("TextureReplacements", "MaxHashCacheVRAMUsageMB",
                   texture_replacements.config.max_hash_cache_vram_usage_mb);
   si.SetUIntValue("TextureReplacements", "MaxReplacementCacheVRAMUsage",
                   texture_replacements.config.max_replacement_cache_vram_usage_mb);
+  si.SetUIntValue("TextureReplacements", "MaxPreloadMemoryUsageMB",
+                  texture_replacements.config.max_preload_memory_usage_mb);
 
   si.SetUIntValue("TextureReplacements", "MaxVRAMWriteSplits", texture_replacements.config.max_vram_write_splits);
   si.SetUIntValue("TextureReplacements", "MaxVRAMWriteCoalesceWidth",
@@ -909,6 +993,7 @@ bool Settings::TextureReplacementSettings::Configuration::operator==(const Confi
   return (max_hash_cache_entries == rhs.max_hash_cache_entries &&
           max_hash_cache_vram_usage_mb == rhs.max_hash_cache_vram_usage_mb &&
           max_replacement_cache_vram_usage_mb == rhs.max_replacement_cache_vram_usage_mb &&
+          max_preload_memory_usage_mb == rhs.max_preload_memory_usage_mb &&
           max_vram_write_splits == rhs.max_vram_write_splits &&
           max_vram_write_coalesce_width == rhs.max_vram_write_coalesce_width &&
           max_vram_write_coalesce_height == rhs.max_vram_write_coalesce_height &&
@@ -921,7 +1006,8 @@ bool Settings::TextureReplacementSettings::Configuration::operator==(const Confi
           dump_vram_write_force_alpha_channel == rhs.dump_vram_write_force_alpha_channel &&
           dump_c16_textures == rhs.dump_c16_textures && reduce_palette_range == rhs.reduce_palette_range &&
           convert_copies_to_writes == rhs.convert_copies_to_writes &&
-          replacement_scale_linear_filter == rhs.replacement_scale_linear_filter);
+          replacement_scale_linear_filter == rhs.replacement_scale_linear_filter &&
+          direct_replacement_textures == rhs.direct_replacement_textures);
 }
 
 bool Settings::TextureReplacementSettings::Configuration::operator!=(const Configuration& rhs) const
@@ -934,6 +1020,7 @@ bool Settings::TextureReplacementSettings::operator==(const TextureReplacementSe
   return (enable_texture_replacements == rhs.enable_texture_replacements &&
           enable_vram_write_replacements == rhs.enable_vram_write_replacements &&
           always_track_uploads == rhs.always_track_uploads && preload_textures == rhs.preload_textures &&
+          async_load_textures == rhs.async_load_textures &&
           dump_textures == rhs.dump_textures && dump_replaced_textures == rhs.dump_replaced_textures &&
           dump_vram_writes == rhs.dump_vram_writes && config == rhs.config);
 }
@@ -1028,6 +1115,10 @@ std::string Settings::TextureReplacementSettings::Configuration::ExportToYAML(bo
 # same size as the uncompressed source image on disk.
 {}MaxReplacementCacheVRAMUsage: {}
 
+# Sets the maximum amount of memory in megabytes that preloading replacement
+# textures can use. Textures past this budget are loaded when first used.
+{}MaxPreloadMemoryUsageMB: {}
+
 # Enables the use of a bilinear filter when scaling replacement textures.
 # If more than one replacement texture in a 256x256 texture page has a different
 # scaling over the native resolution, or the texture page is not covered, a
@@ -1035,6 +1126,11 @@ std::string Settings::TextureReplacementSettings::Configuration::ExportToYAML(bo
 # the original native data.
 {}ReplacementScaleLinearFilter: {}
 
+# Samples replacement textures which cover an entire texture page directly,
+# instead of copying them into an uncompressed texture. Reduces VRAM usage,
+# especially for packs using block-compressed DDS images.
+{}DirectReplacementTextures: {}
+
 # Use this section to define replacement aliases. One line per replacement
 # texture, with the key set to the source ID, and the value set to the filename
 # which should be loaded as a replacement. For example, without the newline,
@@ -1062,7 +1158,9 @@ std::string Settings::TextureReplacementSettings::Configuration::ExportToYAML(bo
                      comment_str, max_hash_cache_entries,              // MaxHashCacheEntries
                      comment_str, max_hash_cache_vram_usage_mb,        // MaxHashCacheVRAMUsageMB
                      comment_str, max_replacement_cache_vram_usage_mb, // MaxReplacementCacheVRAMUsage
-                     comment_str, replacement_scale_linear_filter);    // ReplacementScaleLinearFilter
+                     comment_str, max_preload_memory_usage_mb,         // MaxPreloadMemoryUsageMB
+                     comment_str, replacement_scale_linear_filter,     // ReplacementScaleLinearFilter
+                     comment_str, direct_replacement_textures);        // DirectReplacementTextures
 }
 
 void Settings::ApplySettingRestrictions()
@@ -1076,6 +1174,7 @@ void Settings::ApplySettingRestrictions()
     gpu_resolution_scale = 1;
     gpu_multisamples = 1;
     gpu_automatic_resolution_scale = false;
+    gpu_dynamic_resolution_scale = false;
     gpu_per_sample_shading = false;
     gpu_scaled_interlacing = false;
     gpu_force_round_texcoords = false;
@@ -1172,9 +1271,12 @@ void Settings::FixIncompatibleSettings(const SettingsInterface& si, bool display
     gpu_pgxp_transparent_depth = false;
   }
 
-  // texture replacements are not available without the TC or with the software renderer
-  texture_replacements.enable_texture_replacements &= (gpu_renderer != GPURenderer::Software && gpu_texture_cache);
-  texture_replacements.enable_vram_write_replacements &= (gpu_renderer != GPURenderer::Software);
+  // depth culling relies on the depth buffer
+  gpu_pgxp_depth_culling &= gpu_pgxp_depth_buffer;
+
+  // texture replacements are not available without the TC or with the software/null renderers
+  texture_replacements.enable_texture_replacements &= (IsHardwareRenderer(gpu_renderer) && gpu_texture_cache);
+  texture_replacements.enable_vram_write_replacements &= IsHardwareRenderer(gpu_renderer);
 
   // GPU thread should be disabled if any debug windows are active, since they will be racing to read CPU thread state.
   if (gpu_use_thread && gpu_max_queued_frames > 0 && ImGuiManager::AreAnyDebugWindowsEnabled(si))
@@ -1220,6 +1322,13 @@ void Settings::FixIncompatibleSettings(const SettingsInterface& si, bool display
 
   // Don't waste time running the software renderer for CPU-only rewind when rewind isn't enabled.
   gpu_use_software_renderer_for_memory_states &= rewind_enable;
+
+  // Downloading VRAM every frame would be far too slow for runahead, and the software renderer already has a copy.
+  gpu_native_resolution_memory_states &=
+    (rewind_enable && !IsRunaheadEnabled() && !gpu_use_software_renderer_for_memory_states);
+
+  // Thinning out old states would break the delta chain, since each state depends on the next newer one.
+  rewind_tiered_states &= (rewind_enable && !IsRunaheadEnabled() && !rewind_compress_states);
 }
 
 bool Settings::AreGPUDeviceSettingsChanged(const Settings& old_settings) const
@@ -1256,6 +1365,7 @@ void Settings::SetDefaultLogConfig(SettingsInterface& si)
   si.SetBoolValue("Logging", "LogToWindow", false);
   si.SetBoolValue("Logging", "LogToFile", false);
   si.SetBoolValue("Logging", "LogFileTimestamps", false);
+  si.SetBoolValue("Logging", "LogAsync", false);
 
   for (const char* channel_name : Log::GetChannelNames())
     si.SetBoolValue("Logging", channel_name, true);
@@ -1271,8 +1381,10 @@ void Settings::UpdateLogConfig(const SettingsInterface& si)
   const bool log_to_debug = si.GetBoolValue("Logging", "LogToDebug", false);
   const bool log_to_file = si.GetBoolValue("Logging", "LogToFile", false);
   const bool log_file_timestamps = si.GetBoolValue("Logging", "LogFileTimestamps", false);
+  const bool log_async = si.GetBoolValue("Logging", "LogAsync", false);
 
   Log::SetLogLevel(log_level);
+  Log::SetAsyncOutputParams(log_async);
   Log::SetConsoleOutputParams(log_to_console, log_timestamps);
   Log::SetDebugOutputParams(log_to_debug);
 
@@ -1497,6 +1609,42 @@ const char* Settings::GetCPUFastmemModeDisplayName(CPUFastmemMode mode)
                                   "CPUFastmemMode");
 }
 
+static constexpr const std::array s_thread_placement_mode_names = {
+  "Disabled",
+  "PerformanceCores",
+  "PerformanceCoresRealtime",
+};
+static constexpr const std::array s_thread_placement_mode_display_names = {
+  TRANSLATE_DISAMBIG_NOOP("Settings", "Disabled (Let OS Decide)", "ThreadPlacementMode"),
+  TRANSLATE_DISAMBIG_NOOP("Settings", "Pin To Performance Cores", "ThreadPlacementMode"),
+  TRANSLATE_DISAMBIG_NOOP("Settings", "Pin To Performance Cores + Real-Time Priority", "ThreadPlacementMode"),
+};
+
+std::optional<ThreadPlacementMode> Settings::ParseThreadPlacementMode(const char* str)
+{
+  u8 index = 0;
+  for (const char* name : s_thread_placement_mode_names)
+  {
+    if (StringUtil::Strcasecmp(name, str) == 0)
+      return static_cast<ThreadPlacementMode>(index);
+
+    index++;
+  }
+
+  return std::nullopt;
+}
+
+const char* Settings::GetThreadPlacementModeName(ThreadPlacementMode mode)
+{
+  return s_thread_placement_mode_names[static_cast<u8>(mode)];
+}
+
+const char* Settings::GetThreadPlacementModeDisplayName(ThreadPlacementMode mode)
+{
+  return Host::TranslateToCString("Settings", s_thread_placement_mode_display_names[static_cast<size_t>(mode)],
+                                  "ThreadPlacementMode");
+}
+
 static constexpr const std::array s_gpu_renderer_names = {
   "Automatic",
 #ifdef _WIN32
@@ -1512,6 +1660,7 @@ static constexpr const std::array s_gpu_renderer_names = {
   "OpenGL",
 #endif
   "Software",
+  "Null",
 };
 static constexpr const std::array s_gpu_renderer_display_names = {
   TRANSLATE_DISAMBIG_NOOP("Settings", "Automatic", "GPURenderer"),
@@ -1529,6 +1678,7 @@ static constexpr const std::array s_gpu_renderer_display_names = {
   TRANSLATE_DISAMBIG_NOOP("Settings", "OpenGL", "GPURenderer"),
 #endif
   TRANSLATE_DISAMBIG_NOOP("Settings", "Software", "GPURenderer"),
+  TRANSLATE_DISAMBIG_NOOP("Settings", "Null (No Rendering)", "GPURenderer"),
 };
 
 std::optional<GPURenderer> Settings::ParseRendererName(const char* str)
@@ -1579,12 +1729,18 @@ RenderAPI Settings::GetRenderAPIForRenderer(GPURenderer renderer)
       return RenderAPI::OpenGL;
 #endif
     case GPURenderer::Software:
+    case GPURenderer::Null:
     case GPURenderer::Automatic:
     default:
       return GPUDevice::GetPreferredAPI(Host::GetRenderWindowInfoType());
   }
 }
 
+bool Settings::IsHardwareRenderer(GPURenderer renderer)
+{
+  return (renderer != GPURenderer::Software && renderer != GPURenderer::Null);
+}
+
 GPURenderer Settings::GetRendererForRenderAPI(RenderAPI api)
 {
   switch (api)
@@ -2712,6 +2868,8 @@ void EmuFolders::LoadConfig(SettingsInterface& si)
   DEV_LOG("Textures Directory: {}", Textures);
   DEV_LOG("User Resources Directory: {}", UserResources);
   DEV_LOG("Videos Directory: {}", Videos);
+
+  CDImage::SetCHDHeaderIndexPath(Path::Combine(Cache, "chd_headers.cache"));
 }
 
 void EmuFolders::Save(SettingsInterface& si)
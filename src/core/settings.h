@@ -32,6 +32,7 @@ struct GPUSettings
 
   GPURenderer gpu_renderer = DEFAULT_GPU_RENDERER;
   u8 gpu_resolution_scale = 1;
+  u8 gpu_dynamic_resolution_scale_minimum = 1;
   u8 gpu_multisamples = 1;
 
   GPUTextureFilter gpu_texture_filter = DEFAULT_GPU_TEXTURE_FILTER;
@@ -54,6 +55,7 @@ struct GPUSettings
   DisplayScreenshotFormat display_screenshot_format = DEFAULT_DISPLAY_SCREENSHOT_FORMAT;
   u8 display_screenshot_quality = DEFAULT_DISPLAY_SCREENSHOT_QUALITY;
   u8 gpu_max_queued_frames = DEFAULT_GPU_MAX_QUEUED_FRAMES;
+  u8 gpu_software_renderer_threads = 0;
   s16 display_active_start_offset = 0;
   s16 display_active_end_offset = 0;
   s8 display_line_start_offset = 0;
@@ -62,6 +64,7 @@ struct GPUSettings
   bool gpu_use_thread : 1 = true;
   bool gpu_use_software_renderer_for_readbacks : 1 = false;
   bool gpu_use_software_renderer_for_memory_states : 1 = false;
+  bool gpu_native_resolution_memory_states : 1 = false;
   bool gpu_use_debug_device : 1 = false;
   bool gpu_use_debug_device_gpu_validation : 1 = false;
   bool gpu_prefer_gles_context : 1 = DEFAULT_GPU_PREFER_GLES_CONTEXT;
@@ -75,6 +78,7 @@ struct GPUSettings
   bool gpu_disable_compute_shaders : 1 = false;
   bool gpu_disable_compressed_textures : 1 = false;
   bool gpu_automatic_resolution_scale : 1 = false;
+  bool gpu_dynamic_resolution_scale : 1 = false;
   bool gpu_per_sample_shading : 1 = false;
   bool gpu_scaled_interlacing : 1 = true;
   bool gpu_force_round_texcoords : 1 = false;
@@ -82,6 +86,11 @@ struct GPUSettings
   bool gpu_widescreen_hack : 1 = false;
   bool gpu_modulation_crop : 1 = false;
   bool gpu_texture_cache : 1 = false;
+  bool gpu_deferred_batch_submission : 1 = false;
+  bool gpu_speculative_vram_readbacks : 1 = false;
+  bool gpu_fast_forward_render_skip : 1 = false;
+  bool gpu_precompile_used_pipelines : 1 = false;
+  bool gpu_pgxp_depth_culling : 1 = false;
   bool gpu_show_vram : 1 = false;
   bool gpu_dump_cpu_to_vram_copies : 1 = false;
   bool gpu_dump_vram_to_cpu_copies : 1 = false;
@@ -112,12 +121,15 @@ struct GPUSettings
   bool display_show_resolution : 1 = false;
   bool display_show_latency_stats : 1 = false;
   bool display_show_cpu_usage : 1 = false;
+  bool display_show_cpu_breakdown : 1 = false;
   bool display_show_gpu_usage : 1 = false;
+  bool display_show_gpu_breakdown : 1 = false;
   bool display_show_frame_times : 1 = false;
   bool display_show_status_indicators : 1 = true;
   bool display_show_inputs : 1 = false;
   bool display_show_enhancements : 1 = false;
   bool display_auto_resize_window : 1 = false;
+  bool display_shared_memory_frame_export : 1 = false;
 
   float gpu_pgxp_tolerance = -1.0f;
   float gpu_pgxp_depth_clear_threshold = 0.0f;
@@ -138,12 +150,14 @@ struct GPUSettings
       static constexpr u32 DEFAULT_MAX_HASH_CACHE_ENTRIES = 1200;
       static constexpr u32 DEFAULT_MAX_HASH_CACHE_VRAM_USAGE_MB = 2048;
       static constexpr u32 DEFAULT_MAX_REPLACEMENT_CACHE_VRAM_USAGE_MB = 512;
+      static constexpr u32 DEFAULT_MAX_PRELOAD_MEMORY_USAGE_MB = 2048;
 
       constexpr Configuration() = default;
 
       u32 max_hash_cache_entries = DEFAULT_MAX_HASH_CACHE_ENTRIES;
       u32 max_hash_cache_vram_usage_mb = DEFAULT_MAX_HASH_CACHE_VRAM_USAGE_MB;
       u32 max_replacement_cache_vram_usage_mb = DEFAULT_MAX_REPLACEMENT_CACHE_VRAM_USAGE_MB;
+      u32 max_preload_memory_usage_mb = DEFAULT_MAX_PRELOAD_MEMORY_USAGE_MB;
 
       u16 max_vram_write_splits = 0;
       u16 max_vram_write_coalesce_width = 0;
@@ -162,6 +176,7 @@ struct GPUSettings
       bool reduce_palette_range : 1 = true;
       bool convert_copies_to_writes : 1 = false;
       bool replacement_scale_linear_filter : 1 = false;
+      bool direct_replacement_textures : 1 = false;
 
       bool operator==(const Configuration& rhs) const;
       bool operator!=(const Configuration& rhs) const;
@@ -173,6 +188,7 @@ struct GPUSettings
     bool enable_vram_write_replacements : 1 = false;
     bool always_track_uploads : 1 = false;
     bool preload_textures : 1 = false;
+    bool async_load_textures : 1 = false;
 
     bool dump_textures : 1 = false;
     bool dump_replaced_textures : 1 = true;
@@ -190,6 +206,10 @@ struct GPUSettings
   void SetPGXPDepthClearThreshold(float value);
 
   ALWAYS_INLINE bool IsUsingSoftwareRenderer() const { return (gpu_renderer == GPURenderer::Software); }
+  ALWAYS_INLINE bool IsGPUTimingNeeded() const
+  {
+    return (display_show_gpu_usage || display_show_gpu_breakdown || gpu_dynamic_resolution_scale);
+  }
   ALWAYS_INLINE bool IsUsingTrueColor() const { return (gpu_dithering_mode >= GPUDitheringMode::TrueColor); }
   ALWAYS_INLINE bool IsUsingDithering() const { return (gpu_dithering_mode < GPUDitheringMode::TrueColor); }
   ALWAYS_INLINE bool IsUsingShaderBlending() const
@@ -265,14 +285,26 @@ struct Settings : public GPUSettings
 
   CPUExecutionMode cpu_execution_mode = DEFAULT_CPU_EXECUTION_MODE;
   CPUFastmemMode cpu_fastmem_mode = DEFAULT_CPU_FASTMEM_MODE;
+  ThreadPlacementMode cpu_thread_placement = DEFAULT_THREAD_PLACEMENT_MODE;
+  u16 cpu_recompiler_compile_budget = 0; // microseconds per frame, 0 = unlimited
   bool cpu_overclock_enable : 1 = false;
   bool cpu_overclock_active : 1 = false;
   bool cpu_recompiler_memory_exceptions : 1 = false;
   bool cpu_recompiler_block_linking : 1 = true;
   bool cpu_recompiler_icache : 1 = false;
+  bool cpu_recompiler_block_cache : 1 = false;
+  bool cpu_recompiler_trace_formation : 1 = false;
+  bool cpu_recompiler_block_profiling : 1 = false;
+  bool timing_event_statistics : 1 = false;
+  bool cpu_recompiler_subpage_invalidation : 1 = false;
+  bool cpu_recompiler_loop_register_cache : 1 = false;
+  bool cpu_recompiler_code_buffer_eviction : 1 = false;
+  bool cpu_recompiler_block_optimization : 1 = false;
+  bool cpu_idle_loop_skipping : 1 = false;
   bool cpu_enable_8mb_ram : 1 = false;
 
   bool mdec_use_old_routines : 1 = false;
+  bool mdec_use_thread : 1 = false;
   bool mdec_disable_cdrom_speedup : 1 = false;
 
   bool pcdrv_enable : 1 = false;
@@ -289,6 +321,7 @@ struct Settings : public GPUSettings
   bool cdrom_region_check : 1 = false;
   bool cdrom_subq_skew : 1 = false;
   bool cdrom_load_image_to_ram : 1 = false;
+  bool cdrom_load_image_compressed : 1 = false;
   bool cdrom_load_image_patches : 1 = false;
   bool cdrom_ignore_host_subcode : 1 = false;
   bool cdrom_mute_cd_audio : 1 = false;
@@ -299,6 +332,8 @@ struct Settings : public GPUSettings
   bool bios_fast_forward_boot : 1 = false;
 
   bool rewind_enable : 1 = false;
+  bool rewind_compress_states : 1 = false;
+  bool rewind_tiered_states : 1 = false;
   bool runahead_for_analog_input : 1 = false;
 
   bool apply_compatibility_settings : 1 = true;
@@ -311,6 +346,7 @@ struct Settings : public GPUSettings
   SaveStateCompressionMode save_state_compression = DEFAULT_SAVE_STATE_COMPRESSION_MODE;
 
   u8 cdrom_readahead_sectors = DEFAULT_CDROM_READAHEAD_SECTORS;
+  u16 cdrom_decompression_cache_size = DEFAULT_CDROM_DECOMPRESSION_CACHE_SIZE; // MB
   CDROMMechaconVersion cdrom_mechacon_version = DEFAULT_CDROM_MECHACON_VERSION;
 
   u8 cdrom_read_speedup = 1;
@@ -320,6 +356,7 @@ struct Settings : public GPUSettings
 
   u8 audio_output_volume = 100;
   u8 audio_fast_forward_volume = 100;
+  u16 audio_skip_output_speed = 0; // percent, 0 = never
 
   bool audio_output_muted : 1 = false;
 
@@ -328,8 +365,11 @@ struct Settings : public GPUSettings
   bool pause_on_focus_loss : 1 = false;
   bool pause_on_controller_disconnection : 1 = false;
   bool disable_background_input : 1 = false;
+  bool controller_late_input_poll : 1 = false;
   bool save_state_on_exit : 1 = true;
   bool create_save_state_backups : 1 = DEFAULT_SAVE_STATE_BACKUPS;
+  bool uncompressed_resume_states : 1 = false;
+  bool psf_audio_only : 1 = false;
   bool confim_power_off : 1 = true;
   bool disable_all_enhancements : 1 = false;
   bool enable_discord_presence : 1 = false;
@@ -477,10 +517,15 @@ struct Settings : public GPUSettings
   static const char* GetCPUFastmemModeName(CPUFastmemMode mode);
   static const char* GetCPUFastmemModeDisplayName(CPUFastmemMode mode);
 
+  static std::optional<ThreadPlacementMode> ParseThreadPlacementMode(const char* str);
+  static const char* GetThreadPlacementModeName(ThreadPlacementMode mode);
+  static const char* GetThreadPlacementModeDisplayName(ThreadPlacementMode mode);
+
   static std::optional<GPURenderer> ParseRendererName(const char* str);
   static const char* GetRendererName(GPURenderer renderer);
   static const char* GetRendererDisplayName(GPURenderer renderer);
   static RenderAPI GetRenderAPIForRenderer(GPURenderer renderer);
+  static bool IsHardwareRenderer(GPURenderer renderer);
   static GPURenderer GetRendererForRenderAPI(RenderAPI api);
 
   static std::optional<GPUTextureFilter> ParseTextureFilterName(const char* str);
@@ -602,8 +647,10 @@ struct Settings : public GPUSettings
 #else
   static constexpr CPUFastmemMode DEFAULT_CPU_FASTMEM_MODE = CPUFastmemMode::LUT;
 #endif
+  static constexpr ThreadPlacementMode DEFAULT_THREAD_PLACEMENT_MODE = ThreadPlacementMode::Disabled;
 
   static constexpr u8 DEFAULT_CDROM_READAHEAD_SECTORS = 8;
+  static constexpr u16 DEFAULT_CDROM_DECOMPRESSION_CACHE_SIZE = 16;
   static constexpr u32 DEFAULT_CDROM_MAX_SEEK_SPEEDUP_CYCLES = 30000;
   static constexpr u32 DEFAULT_CDROM_MAX_READ_SPEEDUP_CYCLES = 30000;
   static constexpr CDROMMechaconVersion DEFAULT_CDROM_MECHACON_VERSION = CDROMMechaconVersion::VC1A;
@@ -630,6 +677,7 @@ struct Settings : public GPUSettings
   static constexpr u32 DEFAULT_MEDIA_CAPTURE_VIDEO_HEIGHT = 480;
   static constexpr u32 DEFAULT_MEDIA_CAPTURE_VIDEO_BITRATE = 6000;
   static constexpr u32 DEFAULT_MEDIA_CAPTURE_AUDIO_BITRATE = 128;
+  static constexpr u32 DEFAULT_MEDIA_CAPTURE_VIDEO_QUEUE_DEPTH = 6;
 
   // Android doesn't create settings until they're first opened, so we have to override the defaults here.
 #ifndef __ANDROID__
@@ -6,12 +6,14 @@
 #include "dma.h"
 #include "imgui_overlays.h"
 #include "interrupt_controller.h"
+#include "performance_counters.h"
 #include "system.h"
 #include "timing_event.h"
 
 #include "util/audio_stream.h"
 #include "util/imgui_manager.h"
 #include "util/media_capture.h"
+#include "util/spu_reverb.h"
 #include "util/state_wrapper.h"
 #include "util/translation.h"
 #include "util/wav_reader_writer.h"
@@ -270,6 +272,11 @@ struct Voice
   bool has_samples;
   bool ignore_loop_address;
 
+  // Set when the sustain envelope can't change the volume any more, so ticking it is deferred until the end of
+  // Execute(). adsr_idle_frame is the first frame that wasn't ticked.
+  bool adsr_idle;
+  u32 adsr_idle_frame;
+
   bool IsOn() const { return adsr_phase != ADSRPhase::Off; }
 
   void KeyOn();
@@ -284,6 +291,12 @@ struct Voice
 
   // Updates the ADSR volume/phase.
   void TickADSR();
+
+  // Returns true if ticking the envelope would only advance its counter.
+  bool IsADSRIdle() const;
+
+  // Applies the envelope ticks that were skipped while idle, up to but not including end_frame.
+  void FlushIdleADSR(u32 end_frame);
 };
 
 struct ReverbRegisters
@@ -346,7 +359,10 @@ static void WriteToCaptureBuffer(u32 index, s16 value);
 static void IncrementCaptureBufferPosition();
 
 static void ReadADPCMBlock(u16 address, ADPCMBlock* block);
+static void LoadVoiceBlock(u32 voice_index);
+static void AdvanceVoice(u32 voice_index, u16 step);
 static std::tuple<s32, s32> SampleVoice(u32 voice_index);
+static void SampleVoices(s32* left_sum, s32* right_sum, s32* reverb_in_left, s32* reverb_in_right);
 
 static void UpdateNoise();
 
@@ -418,6 +434,9 @@ struct ALIGN_TO_CACHE_LINE SPUState
   s16 last_reverb_input[2];
   s32 last_reverb_output[2];
   bool audio_output_muted = false;
+  bool audio_output_skipped = false;
+
+  u32 execute_frame = 0;
 
   ALIGN_TO_CACHE_LINE std::array<Voice, NUM_VOICES> voices{};
 
@@ -443,6 +462,84 @@ static SPUState s_state;
 ALIGN_TO_CACHE_LINE static std::array<u8, RAM_SIZE> s_ram{};
 ALIGN_TO_CACHE_LINE static std::array<s16, (44100 / 60) * 2> s_muted_output_buffer{};
 
+static constexpr std::array<s16, 0x200> s_gauss_table = {{
+  -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, //
+  -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, //
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0001, //
+  0x0001, 0x0001, 0x0001, 0x0002, 0x0002, 0x0002, 0x0003, 0x0003, //
+  0x0003, 0x0004, 0x0004, 0x0005, 0x0005, 0x0006, 0x0007, 0x0007, //
+  0x0008, 0x0009, 0x0009, 0x000A, 0x000B, 0x000C, 0x000D, 0x000E, //
+  0x000F, 0x0010, 0x0011, 0x0012, 0x0013, 0x0015, 0x0016, 0x0018, // entry
+  0x0019, 0x001B, 0x001C, 0x001E, 0x0020, 0x0021, 0x0023, 0x0025, // 000..07F
+  0x0027, 0x0029, 0x002C, 0x002E, 0x0030, 0x0033, 0x0035, 0x0038, //
+  0x003A, 0x003D, 0x0040, 0x0043, 0x0046, 0x0049, 0x004D, 0x0050, //
+  0x0054, 0x0057, 0x005B, 0x005F, 0x0063, 0x0067, 0x006B, 0x006F, //
+  0x0074, 0x0078, 0x007D, 0x0082, 0x0087, 0x008C, 0x0091, 0x0096, //
+  0x009C, 0x00A1, 0x00A7, 0x00AD, 0x00B3, 0x00BA, 0x00C0, 0x00C7, //
+  0x00CD, 0x00D4, 0x00DB, 0x00E3, 0x00EA, 0x00F2, 0x00FA, 0x0101, //
+  0x010A, 0x0112, 0x011B, 0x0123, 0x012C, 0x0135, 0x013F, 0x0148, //
+  0x0152, 0x015C, 0x0166, 0x0171, 0x017B, 0x0186, 0x0191, 0x019C, //
+  0x01A8, 0x01B4, 0x01C0, 0x01CC, 0x01D9, 0x01E5, 0x01F2, 0x0200, //
+  0x020D, 0x021B, 0x0229, 0x0237, 0x0246, 0x0255, 0x0264, 0x0273, //
+  0x0283, 0x0293, 0x02A3, 0x02B4, 0x02C4, 0x02D6, 0x02E7, 0x02F9, //
+  0x030B, 0x031D, 0x0330, 0x0343, 0x0356, 0x036A, 0x037E, 0x0392, //
+  0x03A7, 0x03BC, 0x03D1, 0x03E7, 0x03FC, 0x0413, 0x042A, 0x0441, //
+  0x0458, 0x0470, 0x0488, 0x04A0, 0x04B9, 0x04D2, 0x04EC, 0x0506, //
+  0x0520, 0x053B, 0x0556, 0x0572, 0x058E, 0x05AA, 0x05C7, 0x05E4, // entry
+  0x0601, 0x061F, 0x063E, 0x065C, 0x067C, 0x069B, 0x06BB, 0x06DC, // 080..0FF
+  0x06FD, 0x071E, 0x0740, 0x0762, 0x0784, 0x07A7, 0x07CB, 0x07EF, //
+  0x0813, 0x0838, 0x085D, 0x0883, 0x08A9, 0x08D0, 0x08F7, 0x091E, //
+  0x0946, 0x096F, 0x0998, 0x09C1, 0x09EB, 0x0A16, 0x0A40, 0x0A6C, //
+  0x0A98, 0x0AC4, 0x0AF1, 0x0B1E, 0x0B4C, 0x0B7A, 0x0BA9, 0x0BD8, //
+  0x0C07, 0x0C38, 0x0C68, 0x0C99, 0x0CCB, 0x0CFD, 0x0D30, 0x0D63, //
+  0x0D97, 0x0DCB, 0x0E00, 0x0E35, 0x0E6B, 0x0EA1, 0x0ED7, 0x0F0F, //
+  0x0F46, 0x0F7F, 0x0FB7, 0x0FF1, 0x102A, 0x1065, 0x109F, 0x10DB, //
+  0x1116, 0x1153, 0x118F, 0x11CD, 0x120B, 0x1249, 0x1288, 0x12C7, //
+  0x1307, 0x1347, 0x1388, 0x13C9, 0x140B, 0x144D, 0x1490, 0x14D4, //
+  0x1517, 0x155C, 0x15A0, 0x15E6, 0x162C, 0x1672, 0x16B9, 0x1700, //
+  0x1747, 0x1790, 0x17D8, 0x1821, 0x186B, 0x18B5, 0x1900, 0x194B, //
+  0x1996, 0x19E2, 0x1A2E, 0x1A7B, 0x1AC8, 0x1B16, 0x1B64, 0x1BB3, //
+  0x1C02, 0x1C51, 0x1CA1, 0x1CF1, 0x1D42, 0x1D93, 0x1DE5, 0x1E37, //
+  0x1E89, 0x1EDC, 0x1F2F, 0x1F82, 0x1FD6, 0x202A, 0x207F, 0x20D4, //
+  0x2129, 0x217F, 0x21D5, 0x222C, 0x2282, 0x22DA, 0x2331, 0x2389, // entry
+  0x23E1, 0x2439, 0x2492, 0x24EB, 0x2545, 0x259E, 0x25F8, 0x2653, // 100..17F
+  0x26AD, 0x2708, 0x2763, 0x27BE, 0x281A, 0x2876, 0x28D2, 0x292E, //
+  0x298B, 0x29E7, 0x2A44, 0x2AA1, 0x2AFF, 0x2B5C, 0x2BBA, 0x2C18, //
+  0x2C76, 0x2CD4, 0x2D33, 0x2D91, 0x2DF0, 0x2E4F, 0x2EAE, 0x2F0D, //
+  0x2F6C, 0x2FCC, 0x302B, 0x308B, 0x30EA, 0x314A, 0x31AA, 0x3209, //
+  0x3269, 0x32C9, 0x3329, 0x3389, 0x33E9, 0x3449, 0x34A9, 0x3509, //
+  0x3569, 0x35C9, 0x3629, 0x3689, 0x36E8, 0x3748, 0x37A8, 0x3807, //
+  0x3867, 0x38C6, 0x3926, 0x3985, 0x39E4, 0x3A43, 0x3AA2, 0x3B00, //
+  0x3B5F, 0x3BBD, 0x3C1B, 0x3C79, 0x3CD7, 0x3D35, 0x3D92, 0x3DEF, //
+  0x3E4C, 0x3EA9, 0x3F05, 0x3F62, 0x3FBD, 0x4019, 0x4074, 0x40D0, //
+  0x412A, 0x4185, 0x41DF, 0x4239, 0x4292, 0x42EB, 0x4344, 0x439C, //
+  0x43F4, 0x444C, 0x44A3, 0x44FA, 0x4550, 0x45A6, 0x45FC, 0x4651, //
+  0x46A6, 0x46FA, 0x474E, 0x47A1, 0x47F4, 0x4846, 0x4898, 0x48E9, //
+  0x493A, 0x498A, 0x49D9, 0x4A29, 0x4A77, 0x4AC5, 0x4B13, 0x4B5F, //
+  0x4BAC, 0x4BF7, 0x4C42, 0x4C8D, 0x4CD7, 0x4D20, 0x4D68, 0x4DB0, //
+  0x4DF7, 0x4E3E, 0x4E84, 0x4EC9, 0x4F0E, 0x4F52, 0x4F95, 0x4FD7, // entry
+  0x5019, 0x505A, 0x509A, 0x50DA, 0x5118, 0x5156, 0x5194, 0x51D0, // 180..1FF
+  0x520C, 0x5247, 0x5281, 0x52BA, 0x52F3, 0x532A, 0x5361, 0x5397, //
+  0x53CC, 0x5401, 0x5434, 0x5467, 0x5499, 0x54CA, 0x54FA, 0x5529, //
+  0x5558, 0x5585, 0x55B2, 0x55DE, 0x5609, 0x5632, 0x565B, 0x5684, //
+  0x56AB, 0x56D1, 0x56F6, 0x571B, 0x573E, 0x5761, 0x5782, 0x57A3, //
+  0x57C3, 0x57E2, 0x57FF, 0x581C, 0x5838, 0x5853, 0x586D, 0x5886, //
+  0x589E, 0x58B5, 0x58CB, 0x58E0, 0x58F4, 0x5907, 0x5919, 0x592A, //
+  0x593A, 0x5949, 0x5958, 0x5965, 0x5971, 0x597C, 0x5986, 0x598F, //
+  0x5997, 0x599E, 0x59A4, 0x59A9, 0x59AD, 0x59B0, 0x59B2, 0x59B3  //
+}};
+
+// Gaussian interpolation taps, rearranged so the four coefficients for an interpolation index are contiguous.
+static constexpr std::array<std::array<s16, 4>, 0x100> s_gauss_taps = []() {
+  std::array<std::array<s16, 4>, 0x100> ret = {};
+  for (u32 i = 0; i < 0x100; i++)
+  {
+    ret[i] = {s_gauss_table[0x0FF - i], s_gauss_table[0x1FF - i], s_gauss_table[0x100 + i],
+              s_gauss_table[0x000 + i]};
+  }
+  return ret;
+}();
+
 } // namespace SPU
 
 #ifdef SPU_ENABLE_VU_METER
@@ -542,6 +639,7 @@ void SPU::Shutdown()
   s_state.tick_event.Deactivate();
   s_state.transfer_event.Deactivate();
   s_state.audio_stream.Destroy();
+  s_state.audio_output_skipped = false;
 }
 
 void SPU::Reset()
@@ -594,6 +692,7 @@ void SPU::Reset()
     v.adsr_target = 0;
     v.has_samples = false;
     v.ignore_loop_address = false;
+    v.adsr_idle = false;
   }
 
   s_state.tick_event.Deactivate();
@@ -1665,6 +1764,20 @@ void SPU::SetAudioOutputMuted(bool muted)
   s_state.audio_output_muted = muted;
 }
 
+bool SPU::IsAudioOutputSkipped()
+{
+  return s_state.audio_output_skipped;
+}
+
+void SPU::SetAudioOutputSkipped(bool skipped)
+{
+  if (s_state.audio_output_skipped == skipped)
+    return;
+
+  DEV_LOG("{} audio output", skipped ? "Skipping" : "Resuming");
+  s_state.audio_output_skipped = skipped;
+}
+
 CoreAudioStream& SPU::GetOutputStream()
 {
   return s_state.audio_stream;
@@ -1702,6 +1815,10 @@ void SPU::Voice::ForceOff()
   if (adsr_phase == ADSRPhase::Off)
     return;
 
+  // The counter stops when the voice turns off, so catch it up to the current frame first.
+  if (adsr_idle)
+    FlushIdleADSR(s_state.execute_frame + 1);
+
   regs.adsr_volume = 0;
   adsr_phase = ADSRPhase::Off;
 }
@@ -1845,6 +1962,9 @@ void SPU::VolumeSweep::Tick()
 
 void SPU::Voice::UpdateADSREnvelope()
 {
+  // Resetting the envelope clears the counter, so there's nothing to catch up on.
+  adsr_idle = false;
+
   switch (adsr_phase)
   {
     case ADSRPhase::Off:
@@ -1881,6 +2001,9 @@ void SPU::Voice::UpdateADSREnvelope()
 
 void SPU::Voice::TickADSR()
 {
+  if (adsr_idle)
+    return;
+
   if (adsr_envelope.counter_increment > 0)
     adsr_envelope.Tick(regs.adsr_volume);
 
@@ -1894,6 +2017,56 @@ void SPU::Voice::TickADSR()
       UpdateADSREnvelope();
     }
   }
+  else if (IsADSRIdle())
+  {
+    adsr_idle = true;
+    adsr_idle_frame = s_state.execute_frame + 1;
+  }
+}
+
+bool SPU::Voice::IsADSRIdle() const
+{
+  // Sustain only ends on key off, so once the level is pinned at a limit, ticks don't change anything but the counter.
+  if (adsr_phase != ADSRPhase::Sustain)
+    return false;
+  else if (adsr_envelope.counter_increment == 0)
+    return true;
+  else if (adsr_envelope.decreasing)
+    return (regs.adsr_volume == 0);
+  else
+    return (regs.adsr_volume == VolumeEnvelope::MAX_VOLUME && adsr_envelope.step > 0);
+}
+
+void SPU::Voice::FlushIdleADSR(u32 end_frame)
+{
+  DebugAssert(adsr_idle && end_frame >= adsr_idle_frame);
+  adsr_idle = false;
+
+  // Same increment that Tick() uses for this level.
+  u32 increment = adsr_envelope.counter_increment;
+  if (adsr_envelope.exponential && !adsr_envelope.decreasing && regs.adsr_volume >= 0x6000)
+  {
+    if (adsr_envelope.rate >= 44)
+      increment >>= 2;
+    else if (adsr_envelope.rate >= 40)
+      increment >>= 1;
+  }
+
+  u32 ticks = end_frame - adsr_idle_frame;
+  if (increment == 0 || ticks == 0)
+    return;
+
+  // The counter goes back to zero once it reaches 0x8000, so after the first wrap it repeats.
+  const u32 ticks_to_wrap = (0x8000 - adsr_envelope.counter + increment - 1) / increment;
+  if (ticks < ticks_to_wrap)
+  {
+    adsr_envelope.counter += ticks * increment;
+    return;
+  }
+
+  ticks -= ticks_to_wrap;
+  const u32 period = (0x8000 + increment - 1) / increment;
+  adsr_envelope.counter = (ticks % period) * increment;
 }
 
 void SPU::Voice::DecodeBlock(const ADPCMBlock& block)
@@ -1931,80 +2104,13 @@ void SPU::Voice::DecodeBlock(const ADPCMBlock& block)
 
 s32 SPU::Voice::Interpolate() const
 {
-  static constexpr std::array<s16, 0x200> gauss = {{
-    -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, //
-    -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, //
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0001, //
-    0x0001, 0x0001, 0x0001, 0x0002, 0x0002, 0x0002, 0x0003, 0x0003, //
-    0x0003, 0x0004, 0x0004, 0x0005, 0x0005, 0x0006, 0x0007, 0x0007, //
-    0x0008, 0x0009, 0x0009, 0x000A, 0x000B, 0x000C, 0x000D, 0x000E, //
-    0x000F, 0x0010, 0x0011, 0x0012, 0x0013, 0x0015, 0x0016, 0x0018, // entry
-    0x0019, 0x001B, 0x001C, 0x001E, 0x0020, 0x0021, 0x0023, 0x0025, // 000..07F
-    0x0027, 0x0029, 0x002C, 0x002E, 0x0030, 0x0033, 0x0035, 0x0038, //
-    0x003A, 0x003D, 0x0040, 0x0043, 0x0046, 0x0049, 0x004D, 0x0050, //
-    0x0054, 0x0057, 0x005B, 0x005F, 0x0063, 0x0067, 0x006B, 0x006F, //
-    0x0074, 0x0078, 0x007D, 0x0082, 0x0087, 0x008C, 0x0091, 0x0096, //
-    0x009C, 0x00A1, 0x00A7, 0x00AD, 0x00B3, 0x00BA, 0x00C0, 0x00C7, //
-    0x00CD, 0x00D4, 0x00DB, 0x00E3, 0x00EA, 0x00F2, 0x00FA, 0x0101, //
-    0x010A, 0x0112, 0x011B, 0x0123, 0x012C, 0x0135, 0x013F, 0x0148, //
-    0x0152, 0x015C, 0x0166, 0x0171, 0x017B, 0x0186, 0x0191, 0x019C, //
-    0x01A8, 0x01B4, 0x01C0, 0x01CC, 0x01D9, 0x01E5, 0x01F2, 0x0200, //
-    0x020D, 0x021B, 0x0229, 0x0237, 0x0246, 0x0255, 0x0264, 0x0273, //
-    0x0283, 0x0293, 0x02A3, 0x02B4, 0x02C4, 0x02D6, 0x02E7, 0x02F9, //
-    0x030B, 0x031D, 0x0330, 0x0343, 0x0356, 0x036A, 0x037E, 0x0392, //
-    0x03A7, 0x03BC, 0x03D1, 0x03E7, 0x03FC, 0x0413, 0x042A, 0x0441, //
-    0x0458, 0x0470, 0x0488, 0x04A0, 0x04B9, 0x04D2, 0x04EC, 0x0506, //
-    0x0520, 0x053B, 0x0556, 0x0572, 0x058E, 0x05AA, 0x05C7, 0x05E4, // entry
-    0x0601, 0x061F, 0x063E, 0x065C, 0x067C, 0x069B, 0x06BB, 0x06DC, // 080..0FF
-    0x06FD, 0x071E, 0x0740, 0x0762, 0x0784, 0x07A7, 0x07CB, 0x07EF, //
-    0x0813, 0x0838, 0x085D, 0x0883, 0x08A9, 0x08D0, 0x08F7, 0x091E, //
-    0x0946, 0x096F, 0x0998, 0x09C1, 0x09EB, 0x0A16, 0x0A40, 0x0A6C, //
-    0x0A98, 0x0AC4, 0x0AF1, 0x0B1E, 0x0B4C, 0x0B7A, 0x0BA9, 0x0BD8, //
-    0x0C07, 0x0C38, 0x0C68, 0x0C99, 0x0CCB, 0x0CFD, 0x0D30, 0x0D63, //
-    0x0D97, 0x0DCB, 0x0E00, 0x0E35, 0x0E6B, 0x0EA1, 0x0ED7, 0x0F0F, //
-    0x0F46, 0x0F7F, 0x0FB7, 0x0FF1, 0x102A, 0x1065, 0x109F, 0x10DB, //
-    0x1116, 0x1153, 0x118F, 0x11CD, 0x120B, 0x1249, 0x1288, 0x12C7, //
-    0x1307, 0x1347, 0x1388, 0x13C9, 0x140B, 0x144D, 0x1490, 0x14D4, //
-    0x1517, 0x155C, 0x15A0, 0x15E6, 0x162C, 0x1672, 0x16B9, 0x1700, //
-    0x1747, 0x1790, 0x17D8, 0x1821, 0x186B, 0x18B5, 0x1900, 0x194B, //
-    0x1996, 0x19E2, 0x1A2E, 0x1A7B, 0x1AC8, 0x1B16, 0x1B64, 0x1BB3, //
-    0x1C02, 0x1C51, 0x1CA1, 0x1CF1, 0x1D42, 0x1D93, 0x1DE5, 0x1E37, //
-    0x1E89, 0x1EDC, 0x1F2F, 0x1F82, 0x1FD6, 0x202A, 0x207F, 0x20D4, //
-    0x2129, 0x217F, 0x21D5, 0x222C, 0x2282, 0x22DA, 0x2331, 0x2389, // entry
-    0x23E1, 0x2439, 0x2492, 0x24EB, 0x2545, 0x259E, 0x25F8, 0x2653, // 100..17F
-    0x26AD, 0x2708, 0x2763, 0x27BE, 0x281A, 0x2876, 0x28D2, 0x292E, //
-    0x298B, 0x29E7, 0x2A44, 0x2AA1, 0x2AFF, 0x2B5C, 0x2BBA, 0x2C18, //
-    0x2C76, 0x2CD4, 0x2D33, 0x2D91, 0x2DF0, 0x2E4F, 0x2EAE, 0x2F0D, //
-    0x2F6C, 0x2FCC, 0x302B, 0x308B, 0x30EA, 0x314A, 0x31AA, 0x3209, //
-    0x3269, 0x32C9, 0x3329, 0x3389, 0x33E9, 0x3449, 0x34A9, 0x3509, //
-    0x3569, 0x35C9, 0x3629, 0x3689, 0x36E8, 0x3748, 0x37A8, 0x3807, //
-    0x3867, 0x38C6, 0x3926, 0x3985, 0x39E4, 0x3A43, 0x3AA2, 0x3B00, //
-    0x3B5F, 0x3BBD, 0x3C1B, 0x3C79, 0x3CD7, 0x3D35, 0x3D92, 0x3DEF, //
-    0x3E4C, 0x3EA9, 0x3F05, 0x3F62, 0x3FBD, 0x4019, 0x4074, 0x40D0, //
-    0x412A, 0x4185, 0x41DF, 0x4239, 0x4292, 0x42EB, 0x4344, 0x439C, //
-    0x43F4, 0x444C, 0x44A3, 0x44FA, 0x4550, 0x45A6, 0x45FC, 0x4651, //
-    0x46A6, 0x46FA, 0x474E, 0x47A1, 0x47F4, 0x4846, 0x4898, 0x48E9, //
-    0x493A, 0x498A, 0x49D9, 0x4A29, 0x4A77, 0x4AC5, 0x4B13, 0x4B5F, //
-    0x4BAC, 0x4BF7, 0x4C42, 0x4C8D, 0x4CD7, 0x4D20, 0x4D68, 0x4DB0, //
-    0x4DF7, 0x4E3E, 0x4E84, 0x4EC9, 0x4F0E, 0x4F52, 0x4F95, 0x4FD7, // entry
-    0x5019, 0x505A, 0x509A, 0x50DA, 0x5118, 0x5156, 0x5194, 0x51D0, // 180..1FF
-    0x520C, 0x5247, 0x5281, 0x52BA, 0x52F3, 0x532A, 0x5361, 0x5397, //
-    0x53CC, 0x5401, 0x5434, 0x5467, 0x5499, 0x54CA, 0x54FA, 0x5529, //
-    0x5558, 0x5585, 0x55B2, 0x55DE, 0x5609, 0x5632, 0x565B, 0x5684, //
-    0x56AB, 0x56D1, 0x56F6, 0x571B, 0x573E, 0x5761, 0x5782, 0x57A3, //
-    0x57C3, 0x57E2, 0x57FF, 0x581C, 0x5838, 0x5853, 0x586D, 0x5886, //
-    0x589E, 0x58B5, 0x58CB, 0x58E0, 0x58F4, 0x5907, 0x5919, 0x592A, //
-    0x593A, 0x5949, 0x5958, 0x5965, 0x5971, 0x597C, 0x5986, 0x598F, //
-    0x5997, 0x599E, 0x59A4, 0x59A9, 0x59AD, 0x59B0, 0x59B2, 0x59B3  //
-  }};
-
-  const u8 i = counter.interpolation_index;
+  const std::array<s16, 4>& taps = s_gauss_taps[counter.interpolation_index];
   const u32 s = NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + ZeroExtend32(counter.sample_index.GetValue());
 
-  s32 out = s32(gauss[0x0FF - i]) * s32(current_block_samples[s - 3]);
-  out += s32(gauss[0x1FF - i]) * s32(current_block_samples[s - 2]);
-  out += s32(gauss[0x100 + i]) * s32(current_block_samples[s - 1]);
-  out += s32(gauss[0x000 + i]) * s32(current_block_samples[s - 0]);
+  s32 out = s32(taps[0]) * s32(current_block_samples[s - 3]);
+  out += s32(taps[1]) * s32(current_block_samples[s - 2]);
+  out += s32(taps[2]) * s32(current_block_samples[s - 1]);
+  out += s32(taps[3]) * s32(current_block_samples[s - 0]);
   return out >> 15;
 }
 
@@ -2035,6 +2141,66 @@ void SPU::ReadADPCMBlock(u16 address, ADPCMBlock* block)
   }
 }
 
+void SPU::LoadVoiceBlock(u32 voice_index)
+{
+  Voice& voice = s_state.voices[voice_index];
+  ADPCMBlock block;
+  ReadADPCMBlock(voice.current_address, &block);
+  voice.DecodeBlock(block);
+  voice.has_samples = true;
+
+  if (voice.current_block_flags.loop_start && !voice.ignore_loop_address)
+  {
+    TRACE_LOG("Voice {} loop start @ 0x{:08X}", voice_index, voice.current_address);
+    voice.regs.adpcm_repeat_address = voice.current_address;
+  }
+}
+
+ALWAYS_INLINE_RELEASE void SPU::AdvanceVoice(u32 voice_index, u16 step)
+{
+  Voice& voice = s_state.voices[voice_index];
+
+  // Shouldn't ever overflow because if sample_index == 27, step == 0x4000 there won't be a carry out from the
+  // interpolation index. If there is a carry out, bit 12 will never be 1, so it'll never add more than 4 to
+  // sample_index, which should never be >27.
+  DebugAssert(voice.counter.sample_index < NUM_SAMPLES_PER_ADPCM_BLOCK);
+  voice.counter.bits += step;
+
+  if (voice.counter.sample_index >= NUM_SAMPLES_PER_ADPCM_BLOCK)
+  {
+    // next block
+    voice.counter.sample_index -= NUM_SAMPLES_PER_ADPCM_BLOCK;
+    voice.has_samples = false;
+    voice.is_first_block = false;
+    voice.current_address += 2;
+
+    // handle flags
+    if (voice.current_block_flags.loop_end)
+    {
+      s_state.endx_register |= (u32(1) << voice_index);
+      voice.current_address = voice.regs.adpcm_repeat_address & ~u16(1);
+
+      if (!voice.current_block_flags.loop_repeat)
+      {
+        // End+Mute flags are ignored when noise is enabled. ADPCM data is still decoded.
+        if (!IsVoiceNoiseEnabled(voice_index))
+        {
+          TRACE_LOG("Voice {} loop end+mute @ 0x{:04X}", voice_index, voice.current_address);
+          voice.ForceOff();
+        }
+        else
+        {
+          TRACE_LOG("IGNORING voice {} loop end+mute @ 0x{:04X}", voice_index, voice.current_address);
+        }
+      }
+      else
+      {
+        TRACE_LOG("Voice {} loop end+repeat @ 0x{:04X}", voice_index, voice.current_address);
+      }
+    }
+  }
+}
+
 ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
 {
   Voice& voice = s_state.voices[voice_index];
@@ -2054,18 +2220,7 @@ ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
   }
 
   if (!voice.has_samples)
-  {
-    ADPCMBlock block;
-    ReadADPCMBlock(voice.current_address, &block);
-    voice.DecodeBlock(block);
-    voice.has_samples = true;
-
-    if (voice.current_block_flags.loop_start && !voice.ignore_loop_address)
-    {
-      TRACE_LOG("Voice {} loop start @ 0x{:08X}", voice_index, voice.current_address);
-      voice.regs.adpcm_repeat_address = voice.current_address;
-    }
-  }
+    LoadVoiceBlock(voice_index);
 
   // skip interpolation when the volume is muted anyway
   s32 volume;
@@ -2099,45 +2254,7 @@ ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
   }
   step = std::min<u16>(step, 0x3FFF);
 
-  // Shouldn't ever overflow because if sample_index == 27, step == 0x4000 there won't be a carry out from the
-  // interpolation index. If there is a carry out, bit 12 will never be 1, so it'll never add more than 4 to
-  // sample_index, which should never be >27.
-  DebugAssert(voice.counter.sample_index < NUM_SAMPLES_PER_ADPCM_BLOCK);
-  voice.counter.bits += step;
-
-  if (voice.counter.sample_index >= NUM_SAMPLES_PER_ADPCM_BLOCK)
-  {
-    // next block
-    voice.counter.sample_index -= NUM_SAMPLES_PER_ADPCM_BLOCK;
-    voice.has_samples = false;
-    voice.is_first_block = false;
-    voice.current_address += 2;
-
-    // handle flags
-    if (voice.current_block_flags.loop_end)
-    {
-      s_state.endx_register |= (u32(1) << voice_index);
-      voice.current_address = voice.regs.adpcm_repeat_address & ~u16(1);
-
-      if (!voice.current_block_flags.loop_repeat)
-      {
-        // End+Mute flags are ignored when noise is enabled. ADPCM data is still decoded.
-        if (!IsVoiceNoiseEnabled(voice_index))
-        {
-          TRACE_LOG("Voice {} loop end+mute @ 0x{:04X}", voice_index, voice.current_address);
-          voice.ForceOff();
-        }
-        else
-        {
-          TRACE_LOG("IGNORING voice {} loop end+mute @ 0x{:04X}", voice_index, voice.current_address);
-        }
-      }
-      else
-      {
-        TRACE_LOG("Voice {} loop end+repeat @ 0x{:04X}", voice_index, voice.current_address);
-      }
-    }
-  }
+  AdvanceVoice(voice_index, step);
 
   // apply per-channel volume
   const s32 left = ApplyVolume(volume, voice.left_volume.current_level);
@@ -2161,6 +2278,142 @@ ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
   return std::make_tuple(left, right);
 }
 
+void SPU::SampleVoices(s32* left_sum, s32* right_sum, s32* reverb_in_left, s32* reverb_in_right)
+{
+  // Interpolation inputs are packed in pairs, so a multiply-add produces the sum of two taps for each voice.
+  alignas(VECTOR_ALIGNMENT) std::array<s16, NUM_VOICES * 2> samples_lo;
+  alignas(VECTOR_ALIGNMENT) std::array<s16, NUM_VOICES * 2> samples_hi;
+  alignas(VECTOR_ALIGNMENT) std::array<s16, NUM_VOICES * 2> taps_lo;
+  alignas(VECTOR_ALIGNMENT) std::array<s16, NUM_VOICES * 2> taps_hi;
+  alignas(VECTOR_ALIGNMENT) std::array<s32, NUM_VOICES> adsr_volumes;
+  alignas(VECTOR_ALIGNMENT) std::array<s32, NUM_VOICES> left_levels;
+  alignas(VECTOR_ALIGNMENT) std::array<s32, NUM_VOICES> right_levels;
+  alignas(VECTOR_ALIGNMENT) std::array<s32, NUM_VOICES> volumes;
+
+  // Block decoding, envelopes and the sample counter depend on the previous sample, so they're stepped per voice.
+  u32 audible_voices = 0;
+  for (u32 voice_index = 0; voice_index < NUM_VOICES; voice_index++)
+  {
+    Voice& voice = s_state.voices[voice_index];
+    s16* const voice_samples_lo = &samples_lo[voice_index * 2];
+    s16* const voice_samples_hi = &samples_hi[voice_index * 2];
+    s16* const voice_taps_lo = &taps_lo[voice_index * 2];
+    s16* const voice_taps_hi = &taps_hi[voice_index * 2];
+    if (!voice.IsOn() && !s_state.SPUCNT.irq9_enable)
+    {
+      std::memset(voice_samples_lo, 0, sizeof(s16) * 2);
+      std::memset(voice_samples_hi, 0, sizeof(s16) * 2);
+      std::memset(voice_taps_lo, 0, sizeof(s16) * 2);
+      std::memset(voice_taps_hi, 0, sizeof(s16) * 2);
+      adsr_volumes[voice_index] = 0;
+      left_levels[voice_index] = 0;
+      right_levels[voice_index] = 0;
+      continue;
+    }
+
+    if (!voice.has_samples)
+      LoadVoiceBlock(voice_index);
+
+    if (IsVoiceNoiseEnabled(voice_index))
+    {
+      // Two halves of 0x8000, so the noise level comes out of the interpolation unchanged.
+      const s16 level = GetVoiceNoiseLevel();
+      voice_samples_lo[0] = voice_samples_lo[1] = 0;
+      voice_samples_hi[0] = voice_samples_hi[1] = level;
+      voice_taps_lo[0] = voice_taps_lo[1] = 0;
+      voice_taps_hi[0] = voice_taps_hi[1] = 0x4000;
+    }
+    else
+    {
+      const std::array<s16, 4>& taps = s_gauss_taps[voice.counter.interpolation_index];
+      const u32 s = NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + ZeroExtend32(voice.counter.sample_index.GetValue());
+      std::memcpy(voice_samples_lo, &voice.current_block_samples[s - 3], sizeof(s16) * 2);
+      std::memcpy(voice_samples_hi, &voice.current_block_samples[s - 1], sizeof(s16) * 2);
+      std::memcpy(voice_taps_lo, &taps[0], sizeof(s16) * 2);
+      std::memcpy(voice_taps_hi, &taps[2], sizeof(s16) * 2);
+    }
+
+    adsr_volumes[voice_index] = voice.regs.adsr_volume;
+    audible_voices |= BoolToUInt32(voice.regs.adsr_volume != 0) << voice_index;
+
+    if (voice.adsr_phase != ADSRPhase::Off)
+      voice.TickADSR();
+
+    AdvanceVoice(voice_index, std::min<u16>(voice.regs.adpcm_sample_rate, 0x3FFF));
+
+    left_levels[voice_index] = voice.left_volume.current_level;
+    right_levels[voice_index] = voice.right_volume.current_level;
+    voice.left_volume.Tick();
+    voice.right_volume.Tick();
+  }
+
+  // Interpolation and volume are independent between voices, so four voices are done at a time.
+  const GSVector4i voice_bits = GSVector4i::cxpr(1, 2, 4, 8);
+  GSVector4i left = GSVector4i::zero();
+  GSVector4i right = GSVector4i::zero();
+  GSVector4i reverb_left = GSVector4i::zero();
+  GSVector4i reverb_right = GSVector4i::zero();
+  for (u32 voice_index = 0; voice_index < NUM_VOICES; voice_index += 4)
+  {
+    // Most voices are idle at any one time, so skip the whole group if none of them have any volume.
+    GSVector4i volume = GSVector4i::zero();
+    GSVector4i voice_left = GSVector4i::zero();
+    GSVector4i voice_right = GSVector4i::zero();
+    if (((audible_voices >> voice_index) & 0xFu) != 0)
+    {
+      const GSVector4i sample =
+        GSVector4i::load<true>(&samples_lo[voice_index * 2])
+          .madd_s16(GSVector4i::load<true>(&taps_lo[voice_index * 2]))
+          .add32(GSVector4i::load<true>(&samples_hi[voice_index * 2])
+                   .madd_s16(GSVector4i::load<true>(&taps_hi[voice_index * 2])))
+          .sra32<15>();
+      volume = sample.mul32l(GSVector4i::load<true>(&adsr_volumes[voice_index])).sra32<15>();
+      voice_left = volume.mul32l(GSVector4i::load<true>(&left_levels[voice_index])).sra32<15>();
+      voice_right = volume.mul32l(GSVector4i::load<true>(&right_levels[voice_index])).sra32<15>();
+      left = left.add32(voice_left);
+      right = right.add32(voice_right);
+
+      const GSVector4i reverb_mask =
+        (GSVector4i(static_cast<s32>(s_state.reverb_on_register >> voice_index)) & voice_bits).eq32(voice_bits);
+      reverb_left = reverb_left.add32(voice_left & reverb_mask);
+      reverb_right = reverb_right.add32(voice_right & reverb_mask);
+    }
+
+    GSVector4i::store<true>(&volumes[voice_index], volume);
+
+#if defined(SPU_ENABLE_VU_METER) || defined(SPU_DUMP_ALL_VOICES)
+    alignas(VECTOR_ALIGNMENT) std::array<s32, 4> debug_left;
+    alignas(VECTOR_ALIGNMENT) std::array<s32, 4> debug_right;
+    GSVector4i::store<true>(debug_left.data(), voice_left);
+    GSVector4i::store<true>(debug_right.data(), voice_right);
+    for (u32 i = 0; i < 4; i++)
+    {
+#ifdef SPU_ENABLE_VU_METER
+      if (IsVUMeterActive())
+        UpdateDebugPeaks(s_state.voice_peaks[voice_index + i], debug_left[i], debug_right[i]);
+#endif
+
+#ifdef SPU_DUMP_ALL_VOICES
+      if (s_state.s_voice_dump_writers[voice_index + i])
+      {
+        const s16 dump_samples[2] = {static_cast<s16>(Clamp16(debug_left[i])),
+                                     static_cast<s16>(Clamp16(debug_right[i]))};
+        s_state.s_voice_dump_writers[voice_index + i]->WriteFrames(dump_samples, 1);
+      }
+#endif
+    }
+#endif
+  }
+
+  for (u32 voice_index = 0; voice_index < NUM_VOICES; voice_index++)
+    s_state.voices[voice_index].last_volume = volumes[voice_index];
+
+  *left_sum = left.addv_s32();
+  *right_sum = right.addv_s32();
+  *reverb_in_left = reverb_left.addv_s32();
+  *reverb_in_right = reverb_right.addv_s32();
+}
+
 void SPU::UpdateNoise()
 {
   // Dr Hell's noise waveform, implementation borrowed from pcsx-r.
@@ -2216,20 +2469,6 @@ void SPU::ReverbWrite(u32 address, s16 data)
 
 void SPU::ProcessReverb(s32 left_in, s32 right_in, s32* left_out, s32* right_out)
 {
-  // From PSX-SPX:
-  // Input and output to/from the reverb unit is resampled using a 39-tap FIR filter with the following coefficients.
-  //  -0001h,  0000h,  0002h,  0000h, -000Ah,  0000h,  0023h,  0000h,
-  //  -0067h,  0000h,  010Ah,  0000h, -0268h,  0000h,  0534h,  0000h,
-  //  -0B90h,  0000h,  2806h,  4000h,  2806h,  0000h, -0B90h,  0000h,
-  //   0534h,  0000h, -0268h,  0000h,  010Ah,  0000h, -0067h,  0000h,
-  //   0023h,  0000h, -000Ah,  0000h,  0002h,  0000h, -0001h
-  //
-  // Zeros have been removed since the result is always zero, therefore the multiply is redundant.
-
-  alignas(VECTOR_ALIGNMENT) static constexpr std::array<s32, 20> resample_coeff = {
-    -0x0001, 0x0002,  -0x000A, 0x0023,  -0x0067, 0x010A,  -0x0268, 0x0534,  -0x0B90, 0x2806,
-    0x2806,  -0x0B90, 0x0534,  -0x0268, 0x010A,  -0x0067, 0x0023,  -0x000A, 0x0002,  -0x0001};
-
   static constexpr auto iiasm = [](const s16 insamp) {
     if (s_state.reverb_registers.IIR_ALPHA == -32768) [[unlikely]]
       return (insamp == -32768) ? 0 : (insamp * -65536);
@@ -2252,24 +2491,12 @@ void SPU::ProcessReverb(s32 left_in, s32 right_in, s32* left_out, s32* right_out
   s32 out[2];
   if (s_state.reverb_resample_buffer_position & 1u)
   {
+    // Resampling buffer has room past the end of the taps for the vector loads.
     std::array<s32, 2> downsampled;
     for (size_t channel = 0; channel < 2; channel++)
     {
-      const s16* src =
-        &s_state.reverb_downsample_buffer[channel][(s_state.reverb_resample_buffer_position - 38) & 0x3F];
-      GSVector4i acc =
-        GSVector4i::load<true>(&resample_coeff[0]).mul32l(GSVector4i::load<false>(&src[0]).sll32(16).sra32(16));
-      acc = acc.add32(
-        GSVector4i::load<true>(&resample_coeff[4]).mul32l(GSVector4i::load<false>(&src[8]).sll32(16).sra32(16)));
-      acc = acc.add32(
-        GSVector4i::load<true>(&resample_coeff[8]).mul32l(GSVector4i::load<false>(&src[16]).sll32(16).sra32(16)));
-      acc = acc.add32(
-        GSVector4i::load<true>(&resample_coeff[12]).mul32l(GSVector4i::load<false>(&src[24]).sll32(16).sra32(16)));
-      acc = acc.add32(
-        GSVector4i::load<true>(&resample_coeff[16]).mul32l(GSVector4i::load<false>(&src[32]).sll32(16).sra32(16)));
-
-      // Horizontal reduction, middle 0x4000. Moved here so we don't need another 4 elements above.
-      downsampled[channel] = Clamp16((acc.addv_s32() + (0x4000 * src[19])) >> 15);
+      downsampled[channel] = SPUReverb::Downsample(
+        &s_state.reverb_downsample_buffer[channel][(s_state.reverb_resample_buffer_position - 38) & 0x3F]);
     }
 
     for (size_t channel = 0; channel < 2; channel++)
@@ -2335,19 +2562,8 @@ void SPU::ProcessReverb(s32 left_in, s32 right_in, s32* left_out, s32* right_out
 
     for (size_t channel = 0; channel < 2; channel++)
     {
-      const s16* src =
-        &s_state.reverb_upsample_buffer[channel][((s_state.reverb_resample_buffer_position >> 1) - 19) & 0x1F];
-
-      GSVector4i srcs = GSVector4i::load<false>(&src[0]);
-      GSVector4i acc = GSVector4i::load<true>(&resample_coeff[0]).mul32l(srcs.s16to32());
-      acc = acc.add32(GSVector4i::load<true>(&resample_coeff[4]).mul32l(srcs.uph64().s16to32()));
-      srcs = GSVector4i::load<false>(&src[8]);
-      acc = acc.add32(GSVector4i::load<true>(&resample_coeff[8]).mul32l(srcs.s16to32()));
-      acc = acc.add32(GSVector4i::load<true>(&resample_coeff[12]).mul32l(srcs.uph64().s16to32()));
-      srcs = GSVector4i::loadl<false>(&src[16]);
-      acc = acc.add32(GSVector4i::load<true>(&resample_coeff[16]).mul32l(srcs.s16to32()));
-
-      out[channel] = std::clamp<s32>(acc.addv_s32() >> 14, -32768, 32767);
+      out[channel] = SPUReverb::Upsample(
+        &s_state.reverb_upsample_buffer[channel][((s_state.reverb_resample_buffer_position >> 1) - 19) & 0x1F]);
     }
   }
   else
@@ -2379,6 +2595,7 @@ void SPU::ProcessReverb(s32 left_in, s32 right_in, s32* left_out, s32* right_out
 
 void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
 {
+  PerformanceCounters::CPUTimeScope cpu_time_scope(PerformanceCounters::CPUTimeCategory::SPU);
   u32 remaining_frames;
   if (g_settings.cpu_overclock_active)
   {
@@ -2394,16 +2611,29 @@ void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
     s_state.ticks_carry = (ticks + s_state.ticks_carry) % SYSCLK_TICKS_PER_SPU_TICK;
   }
 
+  // Voice 0 can't be modulated, so its bit is ignored.
+  const bool pitch_modulation_active = ((s_state.pitch_modulation_enable_register & ~1u) != 0);
+  s_state.execute_frame = 0;
+
+  // When the output is skipped, the voices still have to run for IRQs, ENDX and the capture buffers, but the final mix
+  // is only needed if something is capturing it.
+  const bool write_to_stream = (!s_state.audio_output_muted && !s_state.audio_output_skipped);
+#ifndef __ANDROID__
+  const bool mix_output = (!s_state.audio_output_skipped || System::GetMediaCapture());
+#else
+  const bool mix_output = !s_state.audio_output_skipped;
+#endif
+
   while (remaining_frames > 0)
   {
-    s16* output_frame_start;
+    s16* output_frame_start = nullptr;
     u32 output_frame_space = remaining_frames;
-    if (!s_state.audio_output_muted) [[likely]]
+    if (write_to_stream) [[likely]]
     {
       output_frame_space = remaining_frames;
       s_state.audio_stream.BeginWrite(&output_frame_start, &output_frame_space);
     }
-    else
+    else if (mix_output)
     {
       // dummy space for writing samples when using runahead
       output_frame_start = s_muted_output_buffer.data();
@@ -2419,20 +2649,28 @@ void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
       s32 reverb_in_left = 0;
       s32 reverb_in_right = 0;
 
-      u32 reverb_on_register = s_state.reverb_on_register;
-
-      for (u32 voice = 0; voice < NUM_VOICES; voice++)
+      if (!pitch_modulation_active) [[likely]]
+      {
+        SampleVoices(&left_sum, &right_sum, &reverb_in_left, &reverb_in_right);
+      }
+      else
       {
-        const auto [left, right] = SampleVoice(voice);
-        left_sum += left;
-        right_sum += right;
+        // Pitch modulation needs the previous voice's output before the counter can be stepped.
+        u32 reverb_on_register = s_state.reverb_on_register;
 
-        if (reverb_on_register & 1u)
+        for (u32 voice = 0; voice < NUM_VOICES; voice++)
         {
-          reverb_in_left += left;
-          reverb_in_right += right;
+          const auto [left, right] = SampleVoice(voice);
+          left_sum += left;
+          right_sum += right;
+
+          if (reverb_on_register & 1u)
+          {
+            reverb_in_left += left;
+            reverb_in_right += right;
+          }
+          reverb_on_register >>= 1;
         }
-        reverb_on_register >>= 1;
       }
 
       if (!s_state.SPUCNT.mute_n)
@@ -2477,19 +2715,24 @@ void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
       right_sum += reverb_out_right;
 
       // Apply main volume after clamping. A maximum volume should not overflow here because both are 16-bit values.
+      if (output_frame) [[likely]]
+      {
 #ifdef SPU_ENABLE_VU_METER
-      const s16 final_left = static_cast<s16>(ApplyVolume(Clamp16(left_sum), s_state.main_volume_left.current_level));
-      const s16 final_right =
-        static_cast<s16>(ApplyVolume(Clamp16(right_sum), s_state.main_volume_right.current_level));
-      *(output_frame++) = final_left;
-      *(output_frame++) = final_right;
+        const s16 final_left =
+          static_cast<s16>(ApplyVolume(Clamp16(left_sum), s_state.main_volume_left.current_level));
+        const s16 final_right =
+          static_cast<s16>(ApplyVolume(Clamp16(right_sum), s_state.main_volume_right.current_level));
+        *(output_frame++) = final_left;
+        *(output_frame++) = final_right;
 
-      if (IsVUMeterActive())
-        UpdateDebugPeaks(s_state.output_peaks, final_left, final_right);
+        if (IsVUMeterActive())
+          UpdateDebugPeaks(s_state.output_peaks, final_left, final_right);
 #else
-      *(output_frame++) = static_cast<s16>(ApplyVolume(Clamp16(left_sum), s_state.main_volume_left.current_level));
-      *(output_frame++) = static_cast<s16>(ApplyVolume(Clamp16(right_sum), s_state.main_volume_right.current_level));
+        *(output_frame++) = static_cast<s16>(ApplyVolume(Clamp16(left_sum), s_state.main_volume_left.current_level));
+        *(output_frame++) =
+          static_cast<s16>(ApplyVolume(Clamp16(right_sum), s_state.main_volume_right.current_level));
 #endif
+      }
 
       s_state.main_volume_left.Tick();
       s_state.main_volume_right.Tick();
@@ -2500,6 +2743,7 @@ void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
       WriteToCaptureBuffer(2, static_cast<s16>(Clamp16(s_state.voices[1].last_volume)));
       WriteToCaptureBuffer(3, static_cast<s16>(Clamp16(s_state.voices[3].last_volume)));
       IncrementCaptureBufferPosition();
+      s_state.execute_frame++;
 
       // Key off/on voices after the first frame.
       if (i == 0 && (s_state.key_off_register != 0 || s_state.key_on_register != 0))
@@ -2527,17 +2771,24 @@ void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
     }
 
 #ifndef __ANDROID__
-    if (MediaCapture* cap = System::GetMediaCapture()) [[unlikely]]
+    if (MediaCapture* cap = System::GetMediaCapture(); cap && output_frame_start) [[unlikely]]
     {
       if (!cap->DeliverAudioFrames(output_frame_start, frames_in_this_batch))
         System::StopMediaCapture();
     }
 #endif
 
-    if (!s_state.audio_output_muted) [[likely]]
+    if (write_to_stream) [[likely]]
       s_state.audio_stream.EndWrite(frames_in_this_batch);
     remaining_frames -= frames_in_this_batch;
   }
+
+  // Registers and save states should see the envelope counters as if they'd been ticked every frame.
+  for (Voice& voice : s_state.voices)
+  {
+    if (voice.adsr_idle)
+      voice.FlushIdleADSR(s_state.execute_frame);
+  }
 }
 
 void SPU::UpdateEventInterval()
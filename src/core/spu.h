@@ -47,6 +47,10 @@ std::array<u8, RAM_SIZE>& GetWritableRAM();
 bool IsAudioOutputMuted();
 void SetAudioOutputMuted(bool muted);
 
+/// Stops generating host output while keeping the SPU running, used when fast forwarding.
+bool IsAudioOutputSkipped();
+void SetAudioOutputSkipped(bool skipped);
+
 CoreAudioStream& GetOutputStream();
 void CreateOutputStream();
 
@@ -26,6 +26,7 @@
 #include "gte.h"
 #include "host.h"
 #include "imgui_overlays.h"
+#include "input_recording.h"
 #include "interrupt_controller.h"
 #include "mdec.h"
 #include "memory_card.h"
@@ -62,10 +63,13 @@
 #include "common/binary_reader_writer.h"
 #include "common/dynamic_library.h"
 #include "common/error.h"
+#include "common/event_trace.h"
 #include "common/file_system.h"
+#include "common/frame_arena.h"
 #include "common/layered_settings_interface.h"
 #include "common/log.h"
 #include "common/memmap.h"
+#include "common/memory_accounting.h"
 #include "common/path.h"
 #include "common/ryml_helpers.h"
 #include "common/string_util.h"
@@ -86,8 +90,11 @@
 #include <chrono>
 #include <cinttypes>
 #include <cmath>
+#include <condition_variable>
 #include <cstdio>
 #include <limits>
+#include <mutex>
+#include <numeric>
 #include <thread>
 
 LOG_CHANNEL(System);
@@ -124,8 +131,22 @@ static constexpr float PRE_FRAME_SLEEP_UPDATE_INTERVAL = 1.0f;
 static constexpr const char FALLBACK_EXE_NAME[] = "PSX.EXE";
 static constexpr u32 MAX_SKIPPED_DUPLICATE_FRAME_COUNT = 2; // 20fps minimum
 static constexpr u32 MAX_SKIPPED_TIMEOUT_FRAME_COUNT = 1;   // 30fps minimum
+
+// Audio-only PSF playback still presents occasionally, so that OSD messages and menus show up.
+static constexpr u32 PSF_AUDIO_ONLY_PRESENT_INTERVAL = 15;
 static constexpr u8 MEMORY_CARD_FAST_FORWARD_FRAMES = 30;
 
+// Dynamic resolution scaling steps down when the GPU time exceeds this fraction of the frame budget, and steps up
+// when the time predicted for the next scale fits in the lower fraction. The sample counts provide hysteresis.
+static constexpr float DYNAMIC_RESOLUTION_SCALE_DOWN_THRESHOLD = 0.9f;
+static constexpr float DYNAMIC_RESOLUTION_SCALE_UP_THRESHOLD = 0.75f;
+static constexpr u8 DYNAMIC_RESOLUTION_SCALE_DOWN_SAMPLES = 2;
+static constexpr u8 DYNAMIC_RESOLUTION_SCALE_UP_SAMPLES = 5;
+static constexpr u32 MEMORY_STATE_DELTA_BLOCK_SIZE = 64;
+static constexpr u32 NUM_REWIND_TIERS = 3;
+static constexpr u32 REWIND_TIER_INTERVAL_SCALE = 4;
+static constexpr u32 MAX_POOLED_SAVE_STATE_BUFFERS = 2;
+
 namespace {
 
 struct SaveStateBuffer
@@ -149,6 +170,7 @@ struct UndoSaveStateBuffer : public SaveStateBuffer
 
 static void CheckCacheLineSize();
 static void LogStartupInformation();
+static void UpdateThreadPlacement();
 
 static const SettingsInterface& GetInputSourceSettingsLayer(std::unique_lock<std::mutex>& lock);
 static const SettingsInterface& GetControllerSettingsLayer(std::unique_lock<std::mutex>& lock);
@@ -173,6 +195,7 @@ static void LogUnsafeSettingsToConsole(const SmallStringBase& messages);
 
 static bool Initialize(std::unique_ptr<CDImage> disc, DiscRegion disc_region, bool force_software_renderer,
                        bool fullscreen, Error* error);
+static void AddBootStepTiming(std::string_view step);
 static bool LoadBIOS(Error* error);
 static bool SetBootMode(BootMode new_boot_mode, DiscRegion disc_region, Error* error);
 static void InternalReset();
@@ -192,10 +215,15 @@ static bool IsFastForwardingBoot();
 static void UpdateThrottlePeriod();
 static void ResetThrottler();
 
+static void ResetDynamicResolutionScale();
+static u8 ApplyDynamicResolutionScale(u8 max_scale);
+static void SetActiveResolutionScale(u8 scale);
+
 /// Throttles the system, i.e. sleeps until it's time to execute the next frame.
 static void Throttle(Timer::Value current_time, Timer::Value sleep_until);
 static void AccumulatePreFrameSleepTime(Timer::Value current_time);
 static void UpdateDisplayVSync();
+static bool ShouldSkipAudioOutput();
 static void InhibitScreensaver(bool inhibit);
 
 static bool UpdateGameSettingsLayer();
@@ -214,14 +242,30 @@ static std::string GetMediaPathFromSaveState(const char* path);
 static bool SaveUndoLoadState();
 static void UpdateMemorySaveStateSettings();
 static bool LoadOneRewindState();
+static void SaveRewindState();
+static MemorySaveState& PopRewindState();
+static MemorySaveState& GetLastMemoryState();
+static void RemoveMemoryState(u32 pos);
+static u32 GetRewindTierSize(u32 num_saves, u32 tier);
+static void ThinRewindStates();
+static void UpdateMemoryStateAccounting();
+static void EncodeMemoryStateDelta(MemorySaveState& mss, const MemorySaveState& base);
+static void DecodeMemoryStateDelta(MemorySaveState& mss, const MemorySaveState& base);
 static bool LoadStateFromBuffer(const SaveStateBuffer& buffer, Error* error, bool update_display);
 static bool LoadStateBufferFromFile(SaveStateBuffer* buffer, std::FILE* fp, Error* error, bool read_title,
                                     bool read_media_path, bool read_screenshot, bool read_data);
 static bool ReadAndDecompressStateData(std::FILE* fp, std::span<u8> dst, u32 file_offset, u32 compressed_size,
                                        SAVE_STATE_HEADER::CompressionType method, Error* error);
 static bool SaveStateToBuffer(SaveStateBuffer* buffer, Error* error, u32 screenshot_size = 256);
+static bool SaveStateWithCompression(std::string path, Error* error, bool backup_existing_save,
+                                     bool ignore_memcard_busy, SaveStateCompressionMode compression,
+                                     std::function<void(bool, const Error& error)> completion_callback);
 static bool SaveStateBufferToFile(const SaveStateBuffer& buffer, std::FILE* fp, Error* error,
                                   SaveStateCompressionMode compression_mode);
+static bool ConvertSaveStateScreenshot(Image* screenshot);
+static DynamicHeapArray<u8> AcquireSaveStateDataBuffer();
+static void CompleteSaveStateWrite(const std::string& path, DynamicHeapArray<u8> state_data);
+static void WaitForSaveStateWrite(std::string_view path);
 static u32 CompressAndWriteStateData(std::FILE* fp, std::span<const u8> src, SaveStateCompressionMode method,
                                      u32* header_type, Error* error);
 static bool DoState(StateWrapper& sw, bool update_display);
@@ -234,9 +278,12 @@ static void SetRewinding(bool enabled);
 static void DoRewind();
 
 static bool DoRunahead();
+static bool GetRunaheadInputState(std::array<u64, NUM_CONTROLLER_AND_CARD_PORTS>* state);
 
 static bool ChangeGPUDump(std::string new_path);
 
+static void UpdateInputRecording();
+
 static void UpdateSessionTime(const std::string& prev_serial);
 
 #ifdef ENABLE_DISCORD_PRESENCE
@@ -262,6 +309,8 @@ struct ALIGN_TO_CACHE_LINE StateVars
   bool system_executing = false;
   bool system_interrupted = false;
   bool frame_step_request = false;
+  bool run_single_frame = false;
+  bool single_frame_done = false;
 
   bool throttler_enabled = false;
   bool optimal_frame_pacing = false;
@@ -280,6 +329,12 @@ struct ALIGN_TO_CACHE_LINE StateVars
   u32 skipped_frame_count = 0;
   u32 last_presented_internal_frame_number = 0;
 
+  u8 dynamic_resolution_scale = 0; // 0 if not limited
+  u8 dynamic_resolution_scale_max = 0;
+  u8 dynamic_resolution_scale_over_budget = 0;
+  u8 dynamic_resolution_scale_under_budget = 0;
+  bool dynamic_resolution_scale_settling = false;
+
   float video_frame_rate = 0.0f;
   float target_speed = 0.0f;
 
@@ -288,15 +343,21 @@ struct ALIGN_TO_CACHE_LINE StateVars
 
   Timer::Value frame_start_time = 0;
   Timer::Value last_active_frame_time = 0;
+  u32 last_pad_read_poll_frame = 0;
   Timer::Value pre_frame_sleep_time = 0;
   Timer::Value max_active_frame_time = 0;
+  Timer::Value max_gpu_frame_latency = 0;
   Timer::Value last_pre_frame_sleep_update_time = 0;
 
   std::unique_ptr<MediaCapture> media_capture;
   std::unique_ptr<GPUDump::Player> gpu_dump_player;
+  std::unique_ptr<InputRecording::Recorder> input_recorder;
+  std::unique_ptr<InputRecording::Player> input_player;
 
   u32 runahead_frames = 0;
   u32 runahead_replay_frames = 0;
+  bool runahead_input_state_valid = false;
+  std::array<u64, NUM_CONTROLLER_AND_CARD_PORTS> runahead_input_state = {};
 
   s32 rewind_load_frequency = 0;
   s32 rewind_load_counter = 0;
@@ -304,8 +365,14 @@ struct ALIGN_TO_CACHE_LINE StateVars
   s32 rewind_save_counter = 0;
 
   std::vector<MemorySaveState> memory_save_states;
+  std::vector<u32> memory_save_state_order; // Ring of indices into memory_save_states, oldest first.
   u32 memory_save_state_front = 0;
   u32 memory_save_state_count = 0;
+  u32 rewind_save_index = 0;
+  bool memory_save_state_deltas = false;
+  bool memory_save_state_tiers = false;
+  bool memory_save_state_ram_snapshots = false;
+  DynamicHeapArray<u8> memory_save_state_delta_buffer;
 
   const BIOS::ImageInfo* bios_image_info = nullptr;
   BIOS::ImageInfo::Hash bios_hash = {};
@@ -317,6 +384,7 @@ struct ALIGN_TO_CACHE_LINE StateVars
   std::string exe_override;
   const GameDatabase::Entry* running_game_entry = nullptr;
   GameHash running_game_hash = 0;
+  std::optional<Achievements::GameHash> running_game_achievements_hash;
   bool running_game_custom_title = false;
 
   // Prevent screensaver inhibits when running on platforms that don't have it (e.g. gamescope).
@@ -324,12 +392,21 @@ struct ALIGN_TO_CACHE_LINE StateVars
 
   std::atomic_bool startup_cancelled{false};
 
+  // how long each part of the last boot took, for the log
+  Timer boot_step_timer;
+  SmallString boot_timings;
+
   std::unique_ptr<INISettingsInterface> game_settings_interface;
   std::unique_ptr<INISettingsInterface> input_settings_interface;
   std::string input_profile_name;
 
   Threading::ThreadHandle core_thread_handle;
 
+  // Where the CPU and GPU threads were pinned by the thread placement setting, if anywhere.
+  u64 gpu_thread_affinity = 0;
+  bool thread_placement_active = false;
+  bool thread_realtime_priority = false;
+
   // temporary save state, created when loading, used to undo load state
   std::optional<UndoSaveStateBuffer> undo_load_state;
 
@@ -339,6 +416,12 @@ struct ALIGN_TO_CACHE_LINE StateVars
   // internal async task counters
   std::atomic_uint32_t outstanding_save_state_tasks{0};
 
+  // paths of save states still being written, and state buffers to reuse for the next save
+  std::mutex save_state_write_mutex;
+  std::condition_variable save_state_write_cv;
+  std::vector<std::string> pending_save_state_paths;
+  std::vector<DynamicHeapArray<u8>> save_state_buffer_pool;
+
   // process start time
   Timer::Value process_start_time = 0;
 
@@ -475,11 +558,81 @@ void System::LogStartupInformation()
              package->core_count, package->cluster_count);
   }
 
+  if (const Threading::ProcessorTopology& topology = Threading::GetProcessorTopology();
+      topology.num_logical_processors > 0)
+  {
+    INFO_LOG("Processor topology: {} performance core(s) [0x{:X}], {} efficiency core(s) [0x{:X}].",
+             topology.performance_cores.size(), topology.performance_processors_mask, topology.num_efficiency_cores,
+             topology.efficiency_processors_mask);
+  }
+
 #ifdef DYNAMIC_HOST_PAGE_SIZE
   INFO_LOG("Host Page Size: {} bytes", HOST_PAGE_SIZE);
 #endif
 }
 
+void System::UpdateThreadPlacement()
+{
+  const ThreadPlacementMode mode = g_settings.cpu_thread_placement;
+  const Threading::ProcessorTopology& topology = Threading::GetProcessorTopology();
+
+  u64 core_thread_affinity = 0;
+  u64 gpu_thread_affinity = 0;
+  u64 worker_affinity = 0;
+  bool active = false;
+  if (mode != ThreadPlacementMode::Disabled)
+  {
+    // Stay off the first core if there's enough to go around, it tends to get the interrupts and housekeeping.
+    std::vector<u32> cores = topology.performance_cores;
+    if (cores.size() >= 3)
+      std::erase(cores, 0u);
+
+    if (cores.size() >= 2)
+    {
+      core_thread_affinity = static_cast<u64>(1) << cores[0];
+      gpu_thread_affinity = static_cast<u64>(1) << cores[1];
+      worker_affinity = topology.efficiency_processors_mask;
+      active = true;
+      INFO_LOG("Pinning CPU thread to processor {}, GPU thread to processor {}, workers to [0x{:X}].", cores[0],
+               cores[1], worker_affinity);
+    }
+    else
+    {
+      WARNING_LOG("Not enough performance cores to pin threads to, leaving placement to the OS.");
+    }
+  }
+
+  // Don't touch the affinity if we never changed it, it might have been set externally.
+  if (!active && !s_state.thread_placement_active)
+    return;
+
+  const bool realtime = (active && mode == ThreadPlacementMode::PerformanceCoresRealtime);
+  s_state.gpu_thread_affinity = gpu_thread_affinity;
+  s_state.thread_placement_active = active;
+  s_state.thread_realtime_priority = realtime;
+
+  s_state.core_thread_handle.SetAffinity(core_thread_affinity);
+  Threading::SetCurrentThreadRealtimePriority(realtime);
+  Threading::SetBackgroundWorkerAffinity(worker_affinity);
+
+  // GPU thread might not be running yet, in which case it'll pick this up when it starts.
+  if (const Threading::ThreadHandle& gpu_thread = GPUThread::Internal::GetThreadHandle(); gpu_thread)
+  {
+    gpu_thread.SetAffinity(gpu_thread_affinity);
+    if (GPUThread::IsUsingThread())
+      GPUThread::RunOnThread([realtime]() { Threading::SetCurrentThreadRealtimePriority(realtime); });
+  }
+}
+
+void System::ApplyGPUThreadPlacement()
+{
+  if (!s_state.thread_placement_active)
+    return;
+
+  Threading::ThreadHandle::GetForCallingThread().SetAffinity(s_state.gpu_thread_affinity);
+  Threading::SetCurrentThreadRealtimePriority(s_state.thread_realtime_priority);
+}
+
 bool System::ProcessStartup(Error* error)
 {
   Timer timer;
@@ -552,11 +705,13 @@ bool System::CoreThreadInitialize(Error* error)
 #endif
 
   s_state.core_thread_handle = Threading::ThreadHandle::GetForCallingThread();
+  EventTrace::SetThreadName("Core Thread");
 
   // This will call back to Host::LoadSettings() -> ReloadSources().
   LoadSettings(false);
 
   LogStartupInformation();
+  UpdateThreadPlacement();
 
   GPUThread::Internal::ProcessStartup();
 
@@ -678,6 +833,11 @@ size_t System::GetGPUDumpFrameCount()
   return s_state.gpu_dump_player ? s_state.gpu_dump_player->GetFrameCount() : 0;
 }
 
+GPUDump::Player* System::GetGPUDumpPlayer()
+{
+  return s_state.gpu_dump_player.get();
+}
+
 bool System::IsStartupCancelled()
 {
   return s_state.startup_cancelled.load(std::memory_order_acquire);
@@ -779,6 +939,25 @@ GlobalTicks System::GetGlobalTickCounter()
                                            (TimingEvents::GetGlobalTickCounter() + CPU::GetPendingTicks());
 }
 
+void System::PollInputForPadRead()
+{
+  // Don't bother if the sources were only just polled at the start of the frame.
+  static constexpr float MIN_POLL_INTERVAL_MS = 1.0f;
+
+  // Runahead replays have to see the same input as the frames they're replaying, and already poll early.
+  if (!g_settings.controller_late_input_poll || s_state.runahead_frames > 0 || IsReplayingGPUDump() ||
+      s_state.last_pad_read_poll_frame == s_state.frame_number)
+  {
+    return;
+  }
+
+  s_state.last_pad_read_poll_frame = s_state.frame_number;
+  if (Timer::ConvertValueToMilliseconds(Timer::GetCurrentValue() - s_state.frame_start_time) < MIN_POLL_INTERVAL_MS)
+    return;
+
+  InputManager::PollSourcesForPadRead();
+}
+
 u32 System::GetFrameNumber()
 {
   return s_state.frame_number;
@@ -1271,6 +1450,8 @@ void System::LoadSettings(bool display_osd_messages)
   // Fix up automatic resolution scale, yuck.
   if (g_settings.gpu_automatic_resolution_scale && IsValid())
     g_settings.gpu_resolution_scale = g_gpu.CalculateAutomaticResolutionScale();
+  if (IsValid())
+    g_settings.gpu_resolution_scale = ApplyDynamicResolutionScale(g_settings.gpu_resolution_scale);
 
   // show safe mode warning if it's toggled on, or on startup
   if (IsValidOrInitializing() && (display_osd_messages || (!previous_safe_mode && g_settings.disable_all_enhancements)))
@@ -1380,7 +1561,9 @@ void System::SetDefaultSettings(SettingsInterface& si)
   temp.display_show_gpu_stats = g_settings.display_show_gpu_stats;
   temp.display_show_resolution = g_settings.display_show_resolution;
   temp.display_show_cpu_usage = g_settings.display_show_cpu_usage;
+  temp.display_show_cpu_breakdown = g_settings.display_show_cpu_breakdown;
   temp.display_show_gpu_usage = g_settings.display_show_gpu_usage;
+  temp.display_show_gpu_breakdown = g_settings.display_show_gpu_breakdown;
   temp.display_show_frame_times = g_settings.display_show_frame_times;
 
   // keep controller, we reset it elsewhere
@@ -1401,6 +1584,8 @@ void System::SetDefaultSettings(SettingsInterface& si)
   si.SetUIntValue("MediaCapture", "VideoWidth", Settings::DEFAULT_MEDIA_CAPTURE_VIDEO_WIDTH);
   si.SetUIntValue("MediaCapture", "VideoHeight", Settings::DEFAULT_MEDIA_CAPTURE_VIDEO_HEIGHT);
   si.SetBoolValue("MediaCapture", "VideoAutoSize", false);
+  si.SetUIntValue("MediaCapture", "VideoQueueDepth", Settings::DEFAULT_MEDIA_CAPTURE_VIDEO_QUEUE_DEPTH);
+  si.SetBoolValue("MediaCapture", "VideoDropFrames", true);
   si.SetUIntValue("MediaCapture", "VideoBitrate", Settings::DEFAULT_MEDIA_CAPTURE_VIDEO_BITRATE);
   si.SetStringValue("MediaCapture", "VideoCodec", "");
   si.SetBoolValue("MediaCapture", "VideoCodecUseArgs", false);
@@ -1759,13 +1944,19 @@ bool System::SaveResumeState(Error* error)
     return false;
   }
 
+  // Resume states are loaded as part of booting, so skip decompressing them if the user would rather start quickly.
   std::string path(GetGameSaveStatePath(s_state.running_game_serial, -1));
-  return SaveState(std::move(path), error, false, true);
+  return SaveStateWithCompression(std::move(path), error, false, true,
+                                  g_settings.uncompressed_resume_states ? SaveStateCompressionMode::Uncompressed :
+                                                                          g_settings.save_state_compression,
+                                  {});
 }
 
 bool System::BootSystem(SystemBootParameters parameters, Error* error)
 {
   Timer boot_timer;
+  s_state.boot_step_timer.Reset();
+  s_state.boot_timings.clear();
 
   if (!parameters.save_state.empty())
   {
@@ -1841,6 +2032,8 @@ bool System::BootSystem(SystemBootParameters parameters, Error* error)
     return false;
   }
 
+  AddBootStepTiming("media");
+
   // Can't early cancel without destroying past this point.
   Assert(s_state.state == State::Shutdown);
   s_state.state = State::Starting;
@@ -1853,7 +2046,9 @@ bool System::BootSystem(SystemBootParameters parameters, Error* error)
 
   // Update running game, this will apply settings as well.
   UpdateRunningGame(disc ? disc->GetPath() : parameters.path, disc.get(), true);
-  Achievements::OnSystemStarting(disc.get(), parameters.disable_achievements_hardcore_mode);
+  Achievements::OnSystemStarting(disc.get(), s_state.running_game_achievements_hash,
+                                 parameters.disable_achievements_hardcore_mode);
+  AddBootStepTiming("game settings");
 
   // Determine console region. Has to be done here, because gamesettings can override it.
   s_state.region = (g_settings.region == ConsoleRegion::Auto) ? auto_console_region : g_settings.region;
@@ -1908,8 +2103,19 @@ bool System::BootSystem(SystemBootParameters parameters, Error* error)
   }
 
   // Load BIOS image, component setup, check for subchannel in games that need it.
-  if (!SetBootMode(boot_mode, disc_region, error) ||
-      !Initialize(std::move(disc), disc_region, parameters.force_software_renderer,
+  if (!SetBootMode(boot_mode, disc_region, error))
+  {
+    Host::OnSystemStopping();
+    DestroySystem();
+    return false;
+  }
+
+  AddBootStepTiming("BIOS");
+
+  // PSF playback doesn't draw anything, so there's no point in compiling pipelines for the hardware renderer.
+  const bool force_software_renderer =
+    (parameters.force_software_renderer || (boot_mode == BootMode::BootPSF && g_settings.psf_audio_only));
+  if (!Initialize(std::move(disc), disc_region, force_software_renderer,
                   parameters.override_fullscreen.value_or(ShouldStartFullscreen()), error))
   {
     Host::OnSystemStopping();
@@ -1955,6 +2161,7 @@ bool System::BootSystem(SystemBootParameters parameters, Error* error)
   UpdateMemoryCards();
   UpdateMultitaps();
   InternalReset();
+  AddBootStepTiming("controllers/memory cards");
 
   // Good to go.
   s_state.state = State::Running;
@@ -1975,6 +2182,9 @@ bool System::BootSystem(SystemBootParameters parameters, Error* error)
     return false;
   }
 
+  if (!parameters.save_state.empty())
+    AddBootStepTiming("save state");
+
   InputManager::UpdateHostMouseMode();
   InputManager::SynchronizeBindingHandlerState();
 
@@ -1999,7 +2209,8 @@ bool System::BootSystem(SystemBootParameters parameters, Error* error)
 
   UpdateSpeedLimiterState();
 
-  INFO_LOG("System booted in {:.2f}ms", boot_timer.GetTimeMilliseconds());
+  AddBootStepTiming("finishing");
+  INFO_LOG("System booted in {:.2f}ms ({})", boot_timer.GetTimeMilliseconds(), s_state.boot_timings);
   PerformanceCounters::Reset();
   ResetThrottler();
   return true;
@@ -2014,6 +2225,8 @@ bool System::Initialize(std::unique_ptr<CDImage> disc, DiscRegion disc_region, b
     Cheats::ReloadCheats(true, true, false, true, true);
     if (Cheats::HasAnySettingOverrides())
       ApplySettings(true);
+
+    AddBootStepTiming("cheats");
   }
 
   s_state.ticks_per_second = ScaleTicksToOverclock(MASTER_CLOCK);
@@ -2034,6 +2247,7 @@ bool System::Initialize(std::unique_ptr<CDImage> disc, DiscRegion disc_region, b
   s_state.rewind_save_counter = -1;
 
   TimingEvents::Initialize();
+  TimingEvents::SetStatisticsEnabled(g_settings.timing_event_statistics);
 
   Bus::Initialize();
   CPU::Initialize();
@@ -2057,14 +2271,13 @@ bool System::Initialize(std::unique_ptr<CDImage> disc, DiscRegion disc_region, b
   GPUThread::UpdateGameInfo(s_state.running_game_title, s_state.running_game_serial, s_state.running_game_path,
                             s_state.running_game_hash, false);
 
-  // This can fail due to the application being closed during startup.
-  if (!GPUThread::CreateGPUBackend(force_software_renderer ? GPURenderer::Software : g_settings.gpu_renderer, false,
-                                   fullscreen, error))
-  {
-    // Game info has to be manually cleared since the backend won't shutdown naturally.
-    GPUThread::ClearGameInfo();
-    return false;
-  }
+  AddBootStepTiming("core");
+
+  // Creating the device and compiling pipelines happens on the GPU thread and can take a while. Nothing else here
+  // touches the GPU, so those components (including opening the audio stream) are set up while it's working.
+  bool gpu_backend_created;
+  GPUThread::BeginCreateGPUBackend(force_software_renderer ? GPURenderer::Software : g_settings.gpu_renderer, false,
+                                   fullscreen, &gpu_backend_created, error);
 
   if (g_settings.gpu_pgxp_enable)
     CPU::PGXP::Initialize();
@@ -2076,8 +2289,20 @@ bool System::Initialize(std::unique_ptr<CDImage> disc, DiscRegion disc_region, b
   MDEC::Initialize();
   SIO::Initialize();
   PCDrv::Initialize();
+  AddBootStepTiming("components");
+
+  // This can fail due to the application being closed during startup.
+  if (!GPUThread::FinishCreateGPUBackend(&gpu_backend_created))
+  {
+    // Game info has to be manually cleared since the backend won't shutdown naturally.
+    GPUThread::ClearGameInfo();
+    return false;
+  }
+
+  AddBootStepTiming("GPU backend");
 
   UpdateGTEAspectRatio();
+  ResetDynamicResolutionScale();
   UpdateAutomaticResolutionScale();
   UpdateThrottlePeriod();
   UpdateMemorySaveStateSettings();
@@ -2087,6 +2312,12 @@ bool System::Initialize(std::unique_ptr<CDImage> disc, DiscRegion disc_region, b
   return true;
 }
 
+void System::AddBootStepTiming(std::string_view step)
+{
+  s_state.boot_timings.append_format("{}{}: {:.1f}ms", s_state.boot_timings.empty() ? "" : ", ", step,
+                                     s_state.boot_step_timer.GetTimeMillisecondsAndReset());
+}
+
 void System::DestroySystem()
 {
   DebugAssert(!s_state.system_executing);
@@ -2098,6 +2329,10 @@ void System::DestroySystem()
 
   s_state.gpu_dump_player.reset();
 
+  if (s_state.input_recorder)
+    StopInputRecording();
+  s_state.input_player.reset();
+
   s_state.undo_load_state.reset();
 
 #ifdef ENABLE_GDB_SERVER
@@ -2117,6 +2352,11 @@ void System::DestroySystem()
 
   FreeMemoryStateStorage(true, true, false);
 
+  {
+    std::unique_lock lock(s_state.save_state_write_mutex);
+    s_state.save_state_buffer_pool.clear();
+  }
+
   // unless fsui is running, we don't need sound effects anymore
   if (!GPUThread::IsFullscreenUIRequested())
     SoundEffectManager::Shutdown();
@@ -2185,6 +2425,7 @@ void System::ClearRunningGame()
   s_state.running_game_title.clear();
   s_state.running_game_entry = nullptr;
   s_state.running_game_hash = 0;
+  s_state.running_game_achievements_hash.reset();
 
   Host::OnSystemGameChanged(s_state.running_game_path, s_state.running_game_serial, s_state.running_game_title,
                             s_state.running_game_hash);
@@ -2212,6 +2453,9 @@ void System::Execute()
           CPU::Execute();
 
         s_state.system_executing = false;
+        if (s_state.single_frame_done) [[unlikely]]
+          return;
+
         continue;
       }
 
@@ -2228,14 +2472,33 @@ void System::Execute()
   }
 }
 
+bool System::RunFrame()
+{
+  if (s_state.state != State::Running)
+    return false;
+
+  s_state.run_single_frame = true;
+  s_state.single_frame_done = false;
+  Execute();
+  s_state.run_single_frame = false;
+  s_state.single_frame_done = false;
+  return IsValid();
+}
+
 void System::FrameDone()
 {
+  // Nothing from last frame's transient allocations is still in use.
+  FrameArena::GetForCurrentThread().Reset();
+
   // Generate any pending samples from the SPU before sleeping, this way we reduce the chances of underruns.
   // TODO: when running ahead, we can skip this (and the flush above)
   if (!IsReplayingGPUDump()) [[likely]]
   {
     MDEC::EndFrame();
 
+    if (CPU::GetCurrentExecutionMode() == CPUExecutionMode::Recompiler)
+      CPU::CodeCache::EndFrame();
+
     SPU::GeneratePendingSamples();
 
     Cheats::ApplyFrameEndCodes();
@@ -2258,7 +2521,7 @@ void System::FrameDone()
   {
     if (s_state.rewind_save_counter == 0)
     {
-      SaveMemoryState(AllocateMemoryState());
+      SaveRewindState();
       s_state.rewind_save_counter = s_state.rewind_save_frequency;
     }
     else
@@ -2309,9 +2572,17 @@ void System::FrameDone()
     PauseSystem(true);
   }
 
+  // Hand control back to RunFrame() now that the frame has been submitted.
+  if (s_state.run_single_frame)
+  {
+    s_state.single_frame_done = true;
+    InterruptExecution();
+  }
+
   // pre-frame sleep accounting (input lag reduction)
   const Timer::Value pre_frame_sleep_until = s_state.next_frame_time + s_state.pre_frame_sleep_time;
   s_state.last_active_frame_time = current_time - s_state.frame_start_time;
+  EventTrace::Span("Emulate Frame", s_state.frame_start_time, current_time);
   if (s_state.pre_frame_sleep)
     AccumulatePreFrameSleepTime(current_time);
 
@@ -2346,6 +2617,10 @@ void System::FrameDone()
     InputManager::PollSources();
   }
 
+  // Both sides of input recording run after the poll, so replayed input lands on the same frame it was recorded.
+  if (s_state.input_recorder || s_state.input_player) [[unlikely]]
+    UpdateInputRecording();
+
   // Frame step can still trigger exit
   CheckForAndExitExecution();
 
@@ -2360,6 +2635,7 @@ bool System::GetFramePresentationParameters(GPUBackendFramePresentationParameter
 
   frame->frame_number = s_state.frame_number;
   frame->internal_frame_number = s_state.internal_frame_number;
+  frame->submit_time = current_time;
 
   // explicit present (frame pacing)
   const bool is_unique_frame = (s_state.last_presented_internal_frame_number != s_state.internal_frame_number);
@@ -2367,9 +2643,12 @@ bool System::GetFramePresentationParameters(GPUBackendFramePresentationParameter
 
   const bool is_duplicate_frame = (s_state.skip_presenting_duplicate_frames && !is_unique_frame &&
                                    s_state.skipped_frame_count < MAX_SKIPPED_DUPLICATE_FRAME_COUNT);
+  const bool is_audio_only_frame = (s_state.boot_mode == BootMode::BootPSF && g_settings.psf_audio_only &&
+                                    (s_state.frame_number % PSF_AUDIO_ONLY_PRESENT_INTERVAL) != 0);
   const bool skip_this_frame =
-    ((is_duplicate_frame || (!s_state.optimal_frame_pacing && current_time > s_state.next_frame_time &&
-                             s_state.skipped_frame_count < MAX_SKIPPED_TIMEOUT_FRAME_COUNT)) &&
+    ((is_duplicate_frame || is_audio_only_frame ||
+      (!s_state.optimal_frame_pacing && current_time > s_state.next_frame_time &&
+       s_state.skipped_frame_count < MAX_SKIPPED_TIMEOUT_FRAME_COUNT)) &&
      !IsExecutionInterrupted());
   frame->update_performance_counters = !is_duplicate_frame;
   frame->present_frame = !skip_this_frame;
@@ -2446,6 +2725,8 @@ void System::ResetThrottler()
 {
   s_state.next_frame_time = Timer::GetCurrentValue() + s_state.frame_period;
   s_state.pre_frame_sleep_time = 0;
+  s_state.max_gpu_frame_latency = 0;
+  GPUThread::GetAndResetMaxFrameLatency();
 }
 
 void System::Throttle(Timer::Value current_time, Timer::Value sleep_until)
@@ -2460,6 +2741,8 @@ void System::Throttle(Timer::Value current_time, Timer::Value sleep_until)
     return;
   }
 
+  EventTrace::ScopedSpan span("Throttle");
+
 #ifdef ENABLE_SOCKET_MULTIPLEXER
   // If we are using the socket multiplier, and have clients, then use it to sleep instead.
   // That way in a query->response->query->response chain, we don't process only one message per frame.
@@ -2665,11 +2948,19 @@ System::MemorySaveState& System::AllocateMemoryState()
   if (s_state.memory_save_state_count < max_count)
     s_state.memory_save_state_count++;
 
-  MemorySaveState& ret = s_state.memory_save_states[s_state.memory_save_state_front];
+  MemorySaveState& ret = s_state.memory_save_states[s_state.memory_save_state_order[s_state.memory_save_state_front]];
   s_state.memory_save_state_front = (s_state.memory_save_state_front + 1) % max_count;
   return ret;
 }
 
+System::MemorySaveState& System::GetLastMemoryState()
+{
+  const u32 max_count = static_cast<u32>(s_state.memory_save_states.size());
+  DebugAssert(s_state.memory_save_state_count > 0);
+  return s_state.memory_save_states
+    [s_state.memory_save_state_order[(s_state.memory_save_state_front + max_count - 1) % max_count]];
+}
+
 System::MemorySaveState& System::GetFirstMemoryState()
 {
   const u32 max_count = static_cast<u32>(s_state.memory_save_states.size());
@@ -2678,7 +2969,7 @@ System::MemorySaveState& System::GetFirstMemoryState()
   const s32 front =
     static_cast<s32>(s_state.memory_save_state_front) - static_cast<s32>(s_state.memory_save_state_count);
   const u32 idx = static_cast<u32>((front < 0) ? (front + static_cast<s32>(max_count)) : front);
-  return s_state.memory_save_states[idx];
+  return s_state.memory_save_states[s_state.memory_save_state_order[idx]];
 }
 
 System::MemorySaveState& System::PopMemoryState()
@@ -2689,7 +2980,27 @@ System::MemorySaveState& System::PopMemoryState()
 
   const s32 front = static_cast<s32>(s_state.memory_save_state_front) - 1;
   s_state.memory_save_state_front = static_cast<u32>((front < 0) ? (front + static_cast<s32>(max_count)) : front);
-  return s_state.memory_save_states[s_state.memory_save_state_front];
+  return s_state.memory_save_states[s_state.memory_save_state_order[s_state.memory_save_state_front]];
+}
+
+void System::RemoveMemoryState(u32 pos)
+{
+  // The states themselves can't move, since the GPU thread may still have pointers to them. Shift the newer indices
+  // down instead, which leaves the removed slot at the front for the next allocation.
+  const u32 max_count = static_cast<u32>(s_state.memory_save_states.size());
+  DebugAssert(pos < s_state.memory_save_state_count);
+  u32 idx = (s_state.memory_save_state_front + max_count - s_state.memory_save_state_count + pos) % max_count;
+  const u32 removed = s_state.memory_save_state_order[idx];
+  for (u32 i = pos + 1; i < s_state.memory_save_state_count; i++)
+  {
+    const u32 next_idx = (idx + 1) % max_count;
+    s_state.memory_save_state_order[idx] = s_state.memory_save_state_order[next_idx];
+    idx = next_idx;
+  }
+
+  s_state.memory_save_state_order[idx] = removed;
+  s_state.memory_save_state_front = idx;
+  s_state.memory_save_state_count--;
 }
 
 bool System::AllocateMemoryStates(size_t state_count, bool recycle_old_textures)
@@ -2702,16 +3013,44 @@ bool System::AllocateMemoryStates(size_t state_count, bool recycle_old_textures)
     s_state.memory_save_states.resize(state_count);
   }
 
+  s_state.memory_save_state_order.resize(state_count);
+  std::iota(s_state.memory_save_state_order.begin(), s_state.memory_save_state_order.end(), 0u);
+
   // Allocate CPU buffers.
   // TODO: Maybe look at host memory limits here...
   const size_t size = GetMaxMemorySaveStateSize(g_settings.cpu_enable_8mb_ram, CPU::PGXP::ShouldSavePGXPState());
+  const size_t ram_size = g_settings.cpu_enable_8mb_ram ? Bus::RAM_8MB_SIZE : Bus::RAM_2MB_SIZE;
   for (MemorySaveState& mss : s_state.memory_save_states)
   {
     mss.state_size = 0;
-    if (mss.state_data.size() != size)
+    mss.delta_size = 0;
+    mss.ram_generation = 0;
+    mss.save_index = 0;
+
+    // RAM is copied separately when only modified pages are saved.
+    if (!s_state.memory_save_state_ram_snapshots)
+      mss.ram_data.deallocate();
+    else if (mss.ram_data.size() != ram_size)
+      mss.ram_data.resize(ram_size);
+
+    // With deltas, buffers are sized as states are saved. Only the newest state needs the full size.
+    if (s_state.memory_save_state_deltas)
+      mss.state_data.deallocate();
+    else if (mss.state_data.size() != size)
       mss.state_data.resize(size);
   }
 
+  // Worst case for a delta is every other block changing.
+  if (s_state.memory_save_state_deltas)
+  {
+    const size_t num_blocks = (size + MEMORY_STATE_DELTA_BLOCK_SIZE - 1) / MEMORY_STATE_DELTA_BLOCK_SIZE;
+    s_state.memory_save_state_delta_buffer.resize(size + ((num_blocks / 2) + 1) * (sizeof(u32) * 2));
+  }
+  else
+  {
+    s_state.memory_save_state_delta_buffer.deallocate();
+  }
+
   // Allocate GPU buffers.
   Error error;
   if (!GPUBackend::AllocateMemorySaveStates(s_state.memory_save_states, &error))
@@ -2730,6 +3069,7 @@ bool System::AllocateMemoryStates(size_t state_count, bool recycle_old_textures)
     return false;
   }
 
+  UpdateMemoryStateAccounting();
   return true;
 }
 
@@ -2737,6 +3077,7 @@ void System::ClearMemorySaveStates(bool reallocate_resources, bool recycle_textu
 {
   s_state.memory_save_state_front = 0;
   s_state.memory_save_state_count = 0;
+  s_state.rewind_save_index = 0;
 
   if (reallocate_resources && !s_state.memory_save_states.empty())
   {
@@ -2776,6 +3117,7 @@ void System::FreeMemoryStateStorage(bool release_memory, bool release_textures,
       mss.gpu_state_size = 0;
       mss.state_data.deallocate();
       mss.state_size = 0;
+      mss.delta_size = 0;
     }
 
     if (!textures.empty())
@@ -2795,9 +3137,27 @@ void System::FreeMemoryStateStorage(bool release_memory, bool release_textures,
   if (release_memory)
   {
     s_state.memory_save_states = std::vector<MemorySaveState>();
+    s_state.memory_save_state_order = std::vector<u32>();
     s_state.memory_save_state_front = 0;
     s_state.memory_save_state_count = 0;
+    s_state.memory_save_state_delta_buffer.deallocate();
   }
+
+  UpdateMemoryStateAccounting();
+}
+
+void System::UpdateMemoryStateAccounting()
+{
+  size_t host_bytes = s_state.memory_save_state_delta_buffer.size();
+  size_t gpu_bytes = 0;
+  for (const MemorySaveState& mss : s_state.memory_save_states)
+  {
+    host_bytes += mss.state_data.size() + mss.ram_data.size() + mss.gpu_state_data.size();
+    if (mss.vram_texture)
+      gpu_bytes += mss.vram_texture->GetVRAMUsage();
+  }
+
+  MemoryAccounting::Set(MemoryAccounting::Category::RewindStates, host_bytes, gpu_bytes);
 }
 
 void System::LoadMemoryState(MemorySaveState& mss, bool update_display)
@@ -2838,6 +3198,187 @@ void System::SaveMemoryState(MemorySaveState& mss)
 #endif
 }
 
+void System::SaveRewindState()
+{
+  if (!s_state.memory_save_state_deltas)
+  {
+    if (s_state.memory_save_state_tiers)
+      ThinRewindStates();
+
+    MemorySaveState& mss = AllocateMemoryState();
+    mss.save_index = s_state.rewind_save_index++;
+    SaveMemoryState(mss);
+    return;
+  }
+
+  // The newest state is always kept in full, and each older state as a delta against the one after it. That way
+  // dropping the oldest state never invalidates another, and stepping back only has to undo a single delta.
+  MemorySaveState* const prev = (s_state.memory_save_state_count > 0) ? &GetLastMemoryState() : nullptr;
+  MemorySaveState& mss = AllocateMemoryState();
+  const size_t size = GetMaxMemorySaveStateSize(g_settings.cpu_enable_8mb_ram, CPU::PGXP::ShouldSavePGXPState());
+  if (mss.state_data.size() != size)
+    mss.state_data.resize(size);
+  mss.delta_size = 0;
+  SaveMemoryState(mss);
+
+  if (prev && prev != &mss)
+    EncodeMemoryStateDelta(*prev, mss);
+
+  // Delta buffers change size as states are saved.
+  UpdateMemoryStateAccounting();
+}
+
+u32 System::GetRewindTierSize(u32 num_saves, u32 tier)
+{
+  // Half of the slots are kept at the save frequency, a quarter at the next tier's spacing, and the rest coarser.
+  const u32 fine = (num_saves + 1) / 2;
+  const u32 medium = (num_saves - fine) / 2;
+  return (tier == 0) ? fine : ((tier == 1) ? medium : (num_saves - fine - medium));
+}
+
+void System::ThinRewindStates()
+{
+  const u32 max_count = static_cast<u32>(s_state.memory_save_states.size());
+  if (s_state.memory_save_state_count < max_count)
+    return;
+
+  // Each tier only keeps every REWIND_TIER_INTERVAL_SCALE'th save from the tier before it. As states age past the
+  // end of a tier, the first one which doesn't fit the next tier's spacing is dropped. If everything fits, the oldest
+  // state is replaced as usual.
+  u32 tier_start = 0;
+  u32 interval = 1;
+  for (u32 tier = 0; tier < NUM_REWIND_TIERS; tier++)
+  {
+    const u32 tier_end = std::min(tier_start + GetRewindTierSize(max_count, tier), s_state.memory_save_state_count);
+    for (u32 i = tier_start; i < tier_end; i++)
+    {
+      const u32 pos = s_state.memory_save_state_count - 1 - i;
+      const u32 idx = (s_state.memory_save_state_front + max_count - s_state.memory_save_state_count + pos) % max_count;
+      if ((s_state.memory_save_states[s_state.memory_save_state_order[idx]].save_index % interval) != 0)
+      {
+        RemoveMemoryState(pos);
+        return;
+      }
+    }
+
+    tier_start = tier_end;
+    interval *= REWIND_TIER_INTERVAL_SCALE;
+  }
+}
+
+u32 System::GetRewindSaveIntervalCount(u32 num_saves, bool tiered_states)
+{
+  if (!tiered_states)
+    return num_saves;
+
+  u32 count = 0;
+  u32 interval = 1;
+  for (u32 tier = 0; tier < NUM_REWIND_TIERS; tier++)
+  {
+    count += GetRewindTierSize(num_saves, tier) * interval;
+    interval *= REWIND_TIER_INTERVAL_SCALE;
+  }
+
+  return count;
+}
+
+System::MemorySaveState& System::PopRewindState()
+{
+  MemorySaveState& mss = PopMemoryState();
+
+  // The state before it was stored as a delta against this one. The popped slot stays intact until the next save.
+  if (s_state.memory_save_state_count > 0)
+  {
+    MemorySaveState& prev = GetLastMemoryState();
+    if (prev.delta_size > 0)
+      DecodeMemoryStateDelta(prev, mss);
+  }
+
+  return mss;
+}
+
+void System::EncodeMemoryStateDelta(MemorySaveState& mss, const MemorySaveState& base)
+{
+  // Stored as pairs of (unchanged block count, changed block count), each followed by the changed blocks. Comparing
+  // whole blocks is cheap, and keeps the run headers from dominating when only scattered bytes change.
+  DebugAssert(mss.delta_size == 0 && base.delta_size == 0);
+  const u8* const src = mss.state_data.data();
+  const u8* const ref = base.state_data.data();
+  const size_t size = mss.state_size;
+  const size_t common_size = std::min(size, base.state_size);
+  const auto is_unchanged = [src, ref, size, common_size](size_t pos) {
+    const size_t len = std::min<size_t>(size - pos, MEMORY_STATE_DELTA_BLOCK_SIZE);
+    return ((pos + len) <= common_size && std::memcmp(src + pos, ref + pos, len) == 0);
+  };
+
+  u8* const out_start = s_state.memory_save_state_delta_buffer.data();
+  u8* out = out_start;
+  size_t pos = 0;
+  while (pos < size)
+  {
+    u32 unchanged_blocks = 0;
+    for (; pos < size && is_unchanged(pos); pos += MEMORY_STATE_DELTA_BLOCK_SIZE)
+      unchanged_blocks++;
+
+    pos = std::min(pos, size);
+    const size_t changed_start = pos;
+    u32 changed_blocks = 0;
+    for (; pos < size && !is_unchanged(pos); pos += MEMORY_STATE_DELTA_BLOCK_SIZE)
+      changed_blocks++;
+
+    pos = std::min(pos, size);
+    std::memcpy(out, &unchanged_blocks, sizeof(unchanged_blocks));
+    std::memcpy(out + sizeof(unchanged_blocks), &changed_blocks, sizeof(changed_blocks));
+    out += sizeof(unchanged_blocks) + sizeof(changed_blocks);
+    std::memcpy(out, src + changed_start, pos - changed_start);
+    out += pos - changed_start;
+  }
+
+  // Not worth it if most of the state changed, keep it in full.
+  const size_t delta_size = static_cast<size_t>(out - out_start);
+  if (delta_size >= size)
+    return;
+
+  std::memcpy(mss.state_data.data(), out_start, delta_size);
+  mss.state_data.resize(delta_size);
+  mss.delta_size = delta_size;
+}
+
+void System::DecodeMemoryStateDelta(MemorySaveState& mss, const MemorySaveState& base)
+{
+  DebugAssert(mss.delta_size > 0 && base.delta_size == 0);
+  DynamicHeapArray<u8> data(
+    GetMaxMemorySaveStateSize(g_settings.cpu_enable_8mb_ram, CPU::PGXP::ShouldSavePGXPState()));
+  const u8* in = mss.state_data.data();
+  const u8* const in_end = in + mss.delta_size;
+  const u8* const ref = base.state_data.data();
+  u8* const dst = data.data();
+  const size_t size = mss.state_size;
+  size_t pos = 0;
+  while (pos < size && in < in_end)
+  {
+    u32 unchanged_blocks, changed_blocks;
+    std::memcpy(&unchanged_blocks, in, sizeof(unchanged_blocks));
+    std::memcpy(&changed_blocks, in + sizeof(unchanged_blocks), sizeof(changed_blocks));
+    in += sizeof(unchanged_blocks) + sizeof(changed_blocks);
+
+    const size_t unchanged_size =
+      std::min(static_cast<size_t>(unchanged_blocks) * MEMORY_STATE_DELTA_BLOCK_SIZE, size - pos);
+    std::memcpy(dst + pos, ref + pos, unchanged_size);
+    pos += unchanged_size;
+
+    const size_t changed_size =
+      std::min(static_cast<size_t>(changed_blocks) * MEMORY_STATE_DELTA_BLOCK_SIZE, size - pos);
+    std::memcpy(dst + pos, in, changed_size);
+    in += changed_size;
+    pos += changed_size;
+  }
+  DebugAssert(pos == size && in == in_end);
+
+  mss.state_data = std::move(data);
+  mss.delta_size = 0;
+}
+
 void System::DoMemoryState(StateWrapper& sw, MemorySaveState& mss, bool update_display)
 {
 #if defined(_DEBUG) || defined(_DEVEL)
@@ -2858,10 +3399,39 @@ void System::DoMemoryState(StateWrapper& sw, MemorySaveState& mss, bool update_d
   SAVE_COMPONENT("CPU", CPU::DoState(sw));
   CPU::PGXP::DoState(sw);
 
-  if (sw.IsReading())
-    CPU::CodeCache::InvalidateAllRAMBlocks();
+  // RAM is handled separately from the rest of the bus state, so code only has to be invalidated in pages which
+  // actually changed.
+  SAVE_COMPONENT("Bus", Bus::DoState(sw, false));
+  if (s_state.memory_save_state_ram_snapshots)
+  {
+    if (sw.IsReading())
+    {
+      Bus::RestoreRAMSnapshot(mss.ram_data.data(), mss.ram_generation);
+    }
+    else
+    {
+      // RAM size can change from loading a state, the whole thing needs to be copied then.
+      if (mss.ram_data.size() != Bus::g_ram_size) [[unlikely]]
+      {
+        mss.ram_data.resize(Bus::g_ram_size);
+        mss.ram_generation = 0;
+      }
+
+      mss.ram_generation = Bus::UpdateRAMSnapshot(mss.ram_data.data(), mss.ram_generation);
+    }
+  }
+  else
+  {
+    const std::span<u8> ram = sw.GetDeferredBytes(Bus::g_ram_size);
+    if (!ram.empty())
+    {
+      if (sw.IsReading())
+        Bus::RestoreRAMImage(ram.data());
+      else
+        std::memcpy(ram.data(), Bus::g_unprotected_ram, ram.size());
+    }
+  }
 
-  SAVE_COMPONENT("Bus", Bus::DoState(sw));
   SAVE_COMPONENT("DMA", DMA::DoState(sw));
   SAVE_COMPONENT("InterruptController", InterruptController::DoState(sw));
 
@@ -3014,7 +3584,8 @@ std::optional<bool> System::LoadState(const char* path, Error* error, bool save_
     return std::nullopt;
   }
 
-  FlushSaveStates();
+  WaitForSaveStateWrite(path);
+  PerformanceCounters::AttributeStutter(PerformanceCounters::StutterCause::SaveState);
 
   Timer load_timer;
 
@@ -3291,6 +3862,14 @@ bool System::ReadAndDecompressStateData(std::FILE* fp, std::span<u8> dst, u32 fi
 
 bool System::SaveState(std::string path, Error* error, bool backup_existing_save, bool ignore_memcard_busy,
                        std::function<void(bool, const Error& error)> completion_callback)
+{
+  return SaveStateWithCompression(std::move(path), error, backup_existing_save, ignore_memcard_busy,
+                                  g_settings.save_state_compression, std::move(completion_callback));
+}
+
+bool System::SaveStateWithCompression(std::string path, Error* error, bool backup_existing_save,
+                                      bool ignore_memcard_busy, SaveStateCompressionMode compression,
+                                      std::function<void(bool, const Error& error)> completion_callback)
 {
   if (!IsValid() || IsReplayingGPUDump())
   {
@@ -3303,21 +3882,28 @@ bool System::SaveState(std::string path, Error* error, bool backup_existing_save
     return false;
   }
 
+  PerformanceCounters::AttributeStutter(PerformanceCounters::StutterCause::SaveState);
+
   Timer save_timer;
 
   SaveStateBuffer buffer;
+  buffer.state_data = AcquireSaveStateDataBuffer();
   if (!SaveStateToBuffer(&buffer, error, 256))
     return false;
 
   VERBOSE_LOG("Preparing state save took {:.2f} msec", save_timer.GetTimeMilliseconds());
 
   // ensure multiple saves to the same path do not overlap
-  FlushSaveStates();
+  WaitForSaveStateWrite(path);
+  {
+    std::unique_lock lock(s_state.save_state_write_mutex);
+    s_state.pending_save_state_paths.push_back(path);
+  }
 
   s_state.outstanding_save_state_tasks.fetch_add(1, std::memory_order_acq_rel);
   Host::QueueAsyncTask([path = std::move(path), buffer = std::move(buffer),
                         completion_callback = std::move(completion_callback), backup_existing_save,
-                        compression = g_settings.save_state_compression]() {
+                        compression]() mutable {
     INFO_LOG("Saving state to '{}'...", path);
 
     Error lerror;
@@ -3349,6 +3935,7 @@ bool System::SaveState(std::string path, Error* error, bool backup_existing_save
 
     VERBOSE_LOG("Saving state took {:.2f} msec", lsave_timer.GetTimeMilliseconds());
 
+    CompleteSaveStateWrite(path, std::move(buffer.state_data));
     s_state.outstanding_save_state_tasks.fetch_sub(1, std::memory_order_acq_rel);
     if (completion_callback)
       completion_callback(result, lerror);
@@ -3357,6 +3944,44 @@ bool System::SaveState(std::string path, Error* error, bool backup_existing_save
   return true;
 }
 
+DynamicHeapArray<u8> System::AcquireSaveStateDataBuffer()
+{
+  DynamicHeapArray<u8> ret;
+
+  std::unique_lock lock(s_state.save_state_write_mutex);
+  if (!s_state.save_state_buffer_pool.empty())
+  {
+    ret = std::move(s_state.save_state_buffer_pool.back());
+    s_state.save_state_buffer_pool.pop_back();
+  }
+
+  return ret;
+}
+
+void System::CompleteSaveStateWrite(const std::string& path, DynamicHeapArray<u8> state_data)
+{
+  {
+    std::unique_lock lock(s_state.save_state_write_mutex);
+    const auto iter = std::find(s_state.pending_save_state_paths.begin(), s_state.pending_save_state_paths.end(), path);
+    DebugAssert(iter != s_state.pending_save_state_paths.end());
+    s_state.pending_save_state_paths.erase(iter);
+
+    if (s_state.save_state_buffer_pool.size() < MAX_POOLED_SAVE_STATE_BUFFERS)
+      s_state.save_state_buffer_pool.push_back(std::move(state_data));
+  }
+
+  s_state.save_state_write_cv.notify_all();
+}
+
+void System::WaitForSaveStateWrite(std::string_view path)
+{
+  std::unique_lock lock(s_state.save_state_write_mutex);
+  s_state.save_state_write_cv.wait(lock, [path]() {
+    return std::none_of(s_state.pending_save_state_paths.begin(), s_state.pending_save_state_paths.end(),
+                        [path](const std::string& pending_path) { return (pending_path == path); });
+  });
+}
+
 static std::string GetSaveStateOSDKey(bool global, s32 slot)
 {
   return fmt::format("{}Slot{}", global ? "GlobalSave" : "GameSave", slot);
@@ -3490,24 +4115,9 @@ bool System::SaveStateToBuffer(SaveStateBuffer* buffer, Error* error, u32 screen
     if (GPUBackend::RenderScreenshotToBuffer(screenshot_size, screenshot_size, false, true, &buffer->screenshot,
                                              &screenshot_error))
     {
+      // Conversion to RGBA8 happens when the state is written, so it can be done on the worker thread.
       if (g_gpu_device->UsesLowerLeftOrigin())
         buffer->screenshot.FlipY();
-
-      // Ensure it's RGBA8.
-      if (buffer->screenshot.GetFormat() != ImageFormat::RGBA8)
-      {
-        std::optional<Image> screenshot_rgba8 = buffer->screenshot.ConvertToRGBA8(&screenshot_error);
-        if (!screenshot_rgba8.has_value())
-        {
-          ERROR_LOG("Failed to convert {} screenshot to RGBA8: {}",
-                    Image::GetFormatName(buffer->screenshot.GetFormat()), screenshot_error.GetDescription());
-          buffer->screenshot.Invalidate();
-        }
-        else
-        {
-          buffer->screenshot = std::move(screenshot_rgba8.value());
-        }
-      }
     }
     else
     {
@@ -3517,8 +4127,9 @@ bool System::SaveStateToBuffer(SaveStateBuffer* buffer, Error* error, u32 screen
   }
 
   // write data
-  if (buffer->state_data.empty())
-    buffer->state_data.resize(GetMaxSaveStateSize(Bus::g_ram_size > Bus::RAM_2MB_SIZE));
+  const size_t max_state_size = GetMaxSaveStateSize(Bus::g_ram_size > Bus::RAM_2MB_SIZE);
+  if (buffer->state_data.size() < max_state_size)
+    buffer->state_data.resize(max_state_size);
 
   return SaveStateDataToBuffer(buffer->state_data, &buffer->state_size, error);
 }
@@ -3549,8 +4160,8 @@ bool System::SaveStateBufferToFile(const SaveStateBuffer& buffer, std::FILE* fp,
   SAVE_STATE_HEADER header = {};
   header.magic = SAVE_STATE_MAGIC;
   header.version = SAVE_STATE_VERSION;
-  StringUtil::Strlcpy(header.title, s_state.running_game_title.c_str(), sizeof(header.title));
-  StringUtil::Strlcpy(header.serial, s_state.running_game_serial.c_str(), sizeof(header.serial));
+  StringUtil::Strlcpy(header.title, buffer.title.c_str(), sizeof(header.title));
+  StringUtil::Strlcpy(header.serial, buffer.serial.c_str(), sizeof(header.serial));
 
   u32 file_position = 0;
   DebugAssert(FileSystem::FTell64(fp) == static_cast<s64>(file_position));
@@ -3575,16 +4186,28 @@ bool System::SaveStateBufferToFile(const SaveStateBuffer& buffer, std::FILE* fp,
     file_position += static_cast<u32>(buffer.media_path.length());
   }
 
-  if (buffer.screenshot.IsValid())
+  // Screenshot is stored as RGBA8.
+  Image screenshot_rgba8;
+  const Image* screenshot = &buffer.screenshot;
+  if (screenshot->IsValid() && screenshot->GetFormat() != ImageFormat::RGBA8)
+  {
+    screenshot_rgba8 = buffer.screenshot;
+    if (ConvertSaveStateScreenshot(&screenshot_rgba8))
+      screenshot = &screenshot_rgba8;
+    else
+      screenshot = nullptr;
+  }
+
+  if (screenshot && screenshot->IsValid())
   {
     DebugAssert(FileSystem::FTell64(fp) == static_cast<s64>(file_position));
-    header.screenshot_width = buffer.screenshot.GetWidth();
-    header.screenshot_height = buffer.screenshot.GetHeight();
+    header.screenshot_width = screenshot->GetWidth();
+    header.screenshot_height = screenshot->GetHeight();
     header.offset_to_screenshot = file_position;
     header.screenshot_compressed_size =
       CompressAndWriteStateData(fp,
-                                std::span<const u8>(reinterpret_cast<const u8*>(buffer.screenshot.GetPixels()),
-                                                    buffer.screenshot.GetPitch() * buffer.screenshot.GetHeight()),
+                                std::span<const u8>(reinterpret_cast<const u8*>(screenshot->GetPixels()),
+                                                    screenshot->GetPitch() * screenshot->GetHeight()),
                                 compression, &header.screenshot_compression_type, error);
     if (header.screenshot_compressed_size == 0)
       return false;
@@ -3600,7 +4223,7 @@ bool System::SaveStateBufferToFile(const SaveStateBuffer& buffer, std::FILE* fp,
     return false;
 
   INFO_LOG("Save state compression: screenshot {} => {} bytes, data {} => {} bytes",
-           buffer.screenshot.GetPitch() * buffer.screenshot.GetHeight(), header.screenshot_compressed_size,
+           screenshot ? (screenshot->GetPitch() * screenshot->GetHeight()) : 0u, header.screenshot_compressed_size,
            buffer.state_size, header.data_compressed_size);
 
   if (!FileSystem::FSeek64(fp, 0, SEEK_SET, error))
@@ -3616,6 +4239,25 @@ bool System::SaveStateBufferToFile(const SaveStateBuffer& buffer, std::FILE* fp,
   return true;
 }
 
+bool System::ConvertSaveStateScreenshot(Image* screenshot)
+{
+  if (screenshot->GetFormat() == ImageFormat::RGBA8)
+    return true;
+
+  Error error;
+  std::optional<Image> screenshot_rgba8 = screenshot->ConvertToRGBA8(&error);
+  if (!screenshot_rgba8.has_value())
+  {
+    ERROR_LOG("Failed to convert {} screenshot to RGBA8: {}", Image::GetFormatName(screenshot->GetFormat()),
+              error.GetDescription());
+    screenshot->Invalidate();
+    return false;
+  }
+
+  *screenshot = std::move(screenshot_rgba8.value());
+  return true;
+}
+
 u32 System::CompressAndWriteStateData(std::FILE* fp, std::span<const u8> src, SaveStateCompressionMode method,
                                       u32* header_type, Error* error)
 {
@@ -3661,7 +4303,7 @@ u32 System::CompressAndWriteStateData(std::FILE* fp, std::span<const u8> src, Sa
   }
 
   const CompressHelpers::OptionalByteBuffer compressed_data =
-    CompressHelpers::CompressToBuffer(ctype, src, clevel, error);
+    CompressHelpers::CompressToBufferMultithreaded(ctype, src, clevel, error);
   if (!compressed_data.has_value())
     return 0;
 
@@ -3690,9 +4332,13 @@ void System::AccumulatePreFrameSleepTime(Timer::Value current_time)
 
   s_state.max_active_frame_time = std::max(s_state.max_active_frame_time, s_state.last_active_frame_time);
 
+  // the frame isn't ready to present until the GPU thread has caught up, so that has to fit before vblank as well
+  const Timer::Value gpu_frame_latency = GPUThread::GetAndResetMaxFrameLatency();
+  s_state.max_gpu_frame_latency = std::max(s_state.max_gpu_frame_latency, gpu_frame_latency);
+
   // in case one frame runs over, adjust to compensate
   const Timer::Value max_sleep_time_for_this_frame =
-    s_state.frame_period - std::min(s_state.last_active_frame_time, s_state.frame_period);
+    s_state.frame_period - std::min(s_state.last_active_frame_time + gpu_frame_latency, s_state.frame_period);
   if (max_sleep_time_for_this_frame < s_state.pre_frame_sleep_time)
   {
     s_state.pre_frame_sleep_time =
@@ -3708,15 +4354,18 @@ void System::AccumulatePreFrameSleepTime(Timer::Value current_time)
     s_state.last_pre_frame_sleep_update_time = current_time;
 
     const Timer::Value expected_frame_time =
-      s_state.max_active_frame_time + Timer::ConvertMillisecondsToValue(g_settings.display_pre_frame_sleep_buffer);
+      s_state.max_active_frame_time + s_state.max_gpu_frame_latency +
+      Timer::ConvertMillisecondsToValue(g_settings.display_pre_frame_sleep_buffer);
     s_state.pre_frame_sleep_time =
       Common::AlignDown(s_state.frame_period - std::min(expected_frame_time, s_state.frame_period),
                         static_cast<unsigned int>(Timer::ConvertMillisecondsToValue(1)));
-    DEV_LOG("Set pre-frame time to {} ms (expected frame time of {} ms)",
+    DEV_LOG("Set pre-frame time to {} ms (expected frame time of {} ms, GPU thread latency of {} ms)",
             Timer::ConvertValueToMilliseconds(s_state.pre_frame_sleep_time),
-            Timer::ConvertValueToMilliseconds(expected_frame_time));
+            Timer::ConvertValueToMilliseconds(expected_frame_time),
+            Timer::ConvertValueToMilliseconds(s_state.max_gpu_frame_latency));
 
     s_state.max_active_frame_time = 0;
+    s_state.max_gpu_frame_latency = 0;
   }
 }
 
@@ -3784,6 +4433,7 @@ void System::UpdateSpeedLimiterState()
   CoreAudioStream& stream = SPU::GetOutputStream();
   stream.SetOutputVolume(GetAudioOutputVolume());
   stream.SetNominalRate(GetAudioNominalRate());
+  SPU::SetAudioOutputSkipped(ShouldSkipAudioOutput());
 
   // Only empty stretch buffers when we're decreasing speed.
   if (s_state.target_speed != prev_speed && (prev_speed > s_state.target_speed || prev_speed == 0.0f))
@@ -4245,6 +4895,7 @@ void System::UpdateRunningGame(const std::string& path, CDImage* image, bool boo
   s_state.running_game_title.clear();
   s_state.running_game_entry = nullptr;
   s_state.running_game_hash = 0;
+  s_state.running_game_achievements_hash.reset();
   s_state.running_game_custom_title = false;
 
   if (!path.empty())
@@ -4294,8 +4945,11 @@ void System::UpdateRunningGame(const std::string& path, CDImage* image, bool boo
       // Data discs should try to pull the title from the serial.
       if (image->GetTrack(1).mode != CDImage::TrackMode::Audio)
       {
-        std::string id;
-        GetGameDetailsFromImage(image, &id, &s_state.running_game_hash);
+        // keep the executable for the achievements hash as well, so the disc is only read once
+        std::string id, executable_name;
+        std::vector<u8> executable_data;
+        if (GetGameDetailsFromImage(image, &id, &s_state.running_game_hash, &executable_name, &executable_data))
+          s_state.running_game_achievements_hash = Achievements::GetGameHash(executable_name, executable_data);
 
         s_state.running_game_entry = GameDatabase::GetEntryForGameDetails(id, s_state.running_game_hash);
         if (s_state.running_game_entry)
@@ -4327,13 +4981,14 @@ void System::UpdateRunningGame(const std::string& path, CDImage* image, bool boo
 
   UpdateGameSettingsLayer();
   ApplySettings(true);
+  CPU::CodeCache::ReloadPersistentCache();
 
   if (!IsReplayingGPUDump())
   {
     // Cheats are loaded later in Initialize().
     if (!booting)
     {
-      Achievements::GameChanged(image);
+      Achievements::GameChanged(image, s_state.running_game_achievements_hash);
 
       const bool had_setting_overrides = Cheats::HasAnySettingOverrides();
       Cheats::ReloadCheats(true, true, false, true, true);
@@ -4602,7 +5257,10 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
         g_settings.audio_stream_parameters.output_latency_ms !=
           old_settings.audio_stream_parameters.output_latency_ms ||
         g_settings.audio_stream_parameters.output_latency_minimal !=
-          old_settings.audio_stream_parameters.output_latency_minimal)
+          old_settings.audio_stream_parameters.output_latency_minimal ||
+        g_settings.audio_stream_parameters.low_latency != old_settings.audio_stream_parameters.low_latency ||
+        g_settings.audio_stream_parameters.output_sample_rate !=
+          old_settings.audio_stream_parameters.output_sample_rate)
     {
       if (g_settings.audio_backend != old_settings.audio_backend)
       {
@@ -4641,6 +5299,13 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
         (g_settings.cpu_recompiler_memory_exceptions != old_settings.cpu_recompiler_memory_exceptions ||
          g_settings.cpu_recompiler_block_linking != old_settings.cpu_recompiler_block_linking ||
          g_settings.cpu_recompiler_icache != old_settings.cpu_recompiler_icache ||
+         g_settings.cpu_recompiler_trace_formation != old_settings.cpu_recompiler_trace_formation ||
+         g_settings.cpu_recompiler_block_profiling != old_settings.cpu_recompiler_block_profiling ||
+         g_settings.display_show_cpu_breakdown != old_settings.display_show_cpu_breakdown ||
+         g_settings.cpu_recompiler_loop_register_cache != old_settings.cpu_recompiler_loop_register_cache ||
+         g_settings.cpu_recompiler_code_buffer_eviction != old_settings.cpu_recompiler_code_buffer_eviction ||
+         g_settings.cpu_recompiler_block_optimization != old_settings.cpu_recompiler_block_optimization ||
+         g_settings.cpu_idle_loop_skipping != old_settings.cpu_idle_loop_skipping ||
          g_settings.bios_tty_logging != old_settings.bios_tty_logging))
     {
       Host::AddIconOSDMessage(OSDMessageType::Info, "CPUFlushAllBlocks", ICON_FA_MICROCHIP,
@@ -4656,15 +5321,19 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
         InterruptExecution();
     }
 
+    if (g_settings.cpu_recompiler_block_cache != old_settings.cpu_recompiler_block_cache)
+      CPU::CodeCache::ReloadPersistentCache();
+
     if (g_settings.cpu_fastmem_mode != old_settings.cpu_fastmem_mode)
     {
       // Reallocate fastmem area, even if it's not being used.
       Bus::RemapFastmemViews();
       CPU::CodeCache::Reset();
+      CPU::UpdateDebugDispatcherFlag();
       InterruptExecution();
     }
 
-    SPU::GetOutputStream().SetOutputVolume(GetAudioOutputVolume());
+    UpdateVolume();
 
     // CPU side GPU settings
     if (g_settings.display_deinterlacing_mode != old_settings.display_deinterlacing_mode ||
@@ -4690,13 +5359,16 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
       RecreateGPU(g_settings.gpu_renderer);
     }
     else if (g_settings.gpu_resolution_scale != old_settings.gpu_resolution_scale ||
+             g_settings.gpu_dynamic_resolution_scale != old_settings.gpu_dynamic_resolution_scale ||
              g_settings.gpu_multisamples != old_settings.gpu_multisamples ||
              g_settings.gpu_per_sample_shading != old_settings.gpu_per_sample_shading ||
              g_settings.gpu_max_queued_frames != old_settings.gpu_max_queued_frames ||
+             g_settings.gpu_software_renderer_threads != old_settings.gpu_software_renderer_threads ||
              g_settings.gpu_use_software_renderer_for_readbacks !=
                old_settings.gpu_use_software_renderer_for_readbacks ||
              g_settings.gpu_use_software_renderer_for_memory_states !=
                old_settings.gpu_use_software_renderer_for_memory_states ||
+             g_settings.gpu_native_resolution_memory_states != old_settings.gpu_native_resolution_memory_states ||
              g_settings.gpu_scaled_interlacing != old_settings.gpu_scaled_interlacing ||
              g_settings.gpu_force_round_texcoords != old_settings.gpu_force_round_texcoords ||
              g_settings.gpu_texture_filter != old_settings.gpu_texture_filter ||
@@ -4708,6 +5380,11 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
              g_settings.gpu_wireframe_mode != old_settings.gpu_wireframe_mode ||
              g_settings.gpu_modulation_crop != old_settings.gpu_modulation_crop ||
              g_settings.gpu_texture_cache != old_settings.gpu_texture_cache ||
+             g_settings.gpu_deferred_batch_submission != old_settings.gpu_deferred_batch_submission ||
+             g_settings.gpu_speculative_vram_readbacks != old_settings.gpu_speculative_vram_readbacks ||
+             g_settings.gpu_fast_forward_render_skip != old_settings.gpu_fast_forward_render_skip ||
+             g_settings.gpu_precompile_used_pipelines != old_settings.gpu_precompile_used_pipelines ||
+             g_settings.gpu_pgxp_depth_culling != old_settings.gpu_pgxp_depth_culling ||
              g_settings.display_deinterlacing_mode != old_settings.display_deinterlacing_mode ||
              g_settings.display_24bit_chroma_smoothing != old_settings.display_24bit_chroma_smoothing ||
              g_settings.display_aspect_ratio != old_settings.display_aspect_ratio ||
@@ -4741,12 +5418,16 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
       // NOTE: Must come after the GPU thread settings update, otherwise it allocs the wrong size textures.
       const bool use_existing_textures = (g_settings.gpu_resolution_scale == old_settings.gpu_resolution_scale &&
                                           g_settings.gpu_use_software_renderer_for_memory_states ==
-                                            old_settings.gpu_use_software_renderer_for_memory_states);
+                                            old_settings.gpu_use_software_renderer_for_memory_states &&
+                                          g_settings.gpu_native_resolution_memory_states ==
+                                            old_settings.gpu_native_resolution_memory_states);
       FreeMemoryStateStorage(false, true, use_existing_textures);
 
       if (g_settings.rewind_enable == old_settings.rewind_enable &&
           g_settings.rewind_save_frequency == old_settings.rewind_save_frequency &&
           g_settings.rewind_save_slots == old_settings.rewind_save_slots &&
+          g_settings.rewind_compress_states == old_settings.rewind_compress_states &&
+          g_settings.rewind_tiered_states == old_settings.rewind_tiered_states &&
           g_settings.runahead_frames == old_settings.runahead_frames)
       {
         // done below if rewind settings changed
@@ -4768,13 +5449,16 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
              g_settings.display_show_resolution != old_settings.display_show_resolution ||
              g_settings.display_show_latency_stats != old_settings.display_show_latency_stats ||
              g_settings.display_show_cpu_usage != old_settings.display_show_cpu_usage ||
+             g_settings.display_show_cpu_breakdown != old_settings.display_show_cpu_breakdown ||
              g_settings.display_show_gpu_usage != old_settings.display_show_gpu_usage ||
+             g_settings.display_show_gpu_breakdown != old_settings.display_show_gpu_breakdown ||
              g_settings.display_show_latency_stats != old_settings.display_show_latency_stats ||
              g_settings.display_show_frame_times != old_settings.display_show_frame_times ||
              g_settings.display_show_status_indicators != old_settings.display_show_status_indicators ||
              g_settings.display_show_inputs != old_settings.display_show_inputs ||
              g_settings.display_show_enhancements != old_settings.display_show_enhancements ||
              g_settings.display_auto_resize_window != old_settings.display_auto_resize_window ||
+             g_settings.display_shared_memory_frame_export != old_settings.display_shared_memory_frame_export ||
              g_settings.display_screenshot_mode != old_settings.display_screenshot_mode ||
              g_settings.display_screenshot_format != old_settings.display_screenshot_format ||
              g_settings.display_screenshot_quality != old_settings.display_screenshot_quality ||
@@ -4790,6 +5474,8 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
         if (g_settings.rewind_enable == old_settings.rewind_enable &&
             g_settings.rewind_save_frequency == old_settings.rewind_save_frequency &&
             g_settings.rewind_save_slots == old_settings.rewind_save_slots &&
+            g_settings.rewind_compress_states == old_settings.rewind_compress_states &&
+            g_settings.rewind_tiered_states == old_settings.rewind_tiered_states &&
             g_settings.runahead_frames == old_settings.runahead_frames)
         {
           // done below if rewind settings changed
@@ -4840,6 +5526,16 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
     if (g_settings.cdrom_readahead_sectors != old_settings.cdrom_readahead_sectors)
       CDROM::SetReadaheadSectors(g_settings.cdrom_readahead_sectors);
 
+    // A preloaded image has to be copied again to switch between compressed and uncompressed storage.
+    if (g_settings.cdrom_load_image_compressed != old_settings.cdrom_load_image_compressed && CDROM::HasMedia() &&
+        CDROM::GetMedia()->IsPrecached())
+    {
+      CDROM::PrecacheMedia();
+    }
+
+    if (g_settings.mdec_use_thread != old_settings.mdec_use_thread)
+      MDEC::SetUseThread(g_settings.mdec_use_thread);
+
     bool controllers_updated = false;
     for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
     {
@@ -4865,6 +5561,8 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
     if (g_settings.rewind_enable != old_settings.rewind_enable ||
         g_settings.rewind_save_frequency != old_settings.rewind_save_frequency ||
         g_settings.rewind_save_slots != old_settings.rewind_save_slots ||
+        g_settings.rewind_compress_states != old_settings.rewind_compress_states ||
+        g_settings.rewind_tiered_states != old_settings.rewind_tiered_states ||
         g_settings.runahead_frames != old_settings.runahead_frames)
     {
       UpdateMemorySaveStateSettings();
@@ -4898,6 +5596,9 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
     if (g_settings.inhibit_screensaver != old_settings.inhibit_screensaver)
       InhibitScreensaver(!IsPaused() && g_settings.inhibit_screensaver);
 
+    if (g_settings.timing_event_statistics != old_settings.timing_event_statistics)
+      TimingEvents::SetStatisticsEnabled(g_settings.timing_event_statistics);
+
 #ifdef ENABLE_GDB_SERVER
     if (g_settings.enable_gdb_server != old_settings.enable_gdb_server ||
         g_settings.gdb_server_port != old_settings.gdb_server_port)
@@ -4949,6 +5650,9 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
   }
 #endif
 
+  if (g_settings.cpu_thread_placement != old_settings.cpu_thread_placement)
+    UpdateThreadPlacement();
+
   if (g_settings.export_shared_memory != old_settings.export_shared_memory) [[unlikely]]
   {
     Error error;
@@ -5194,15 +5898,33 @@ void System::LogUnsafeSettingsToConsole(const SmallStringBase& messages)
 }
 
 void System::CalculateRewindMemoryUsage(u32 num_saves, u32 resolution_scale, u32 multisamples,
-                                        bool use_software_renderer, bool enable_8mb_ram, u64* ram_usage,
-                                        u64* vram_usage)
+                                        bool use_software_renderer, bool native_resolution_vram, bool enable_8mb_ram,
+                                        bool compress_states, u64* ram_usage, u64* vram_usage)
 {
   const u32 real_resolution_scale = std::max<u32>(resolution_scale, 1u);
-  *ram_usage = GetMaxMemorySaveStateSize(enable_8mb_ram, false) * static_cast<u64>(num_saves);
-  *vram_usage = use_software_renderer ? 0 :
-                                        ((static_cast<u64>(VRAM_WIDTH * real_resolution_scale) *
-                                          static_cast<u64>(VRAM_HEIGHT * real_resolution_scale) * 4) *
-                                         static_cast<u64>(multisamples) * static_cast<u64>(num_saves));
+  const u64 state_size = GetMaxMemorySaveStateSize(enable_8mb_ram, false);
+
+  // Deltas depend on the game, but usually only a fraction of RAM changes between saves. Plus the full newest state
+  // and the encode buffer, which aren't allocated at all without any saves.
+  if (num_saves == 0)
+    *ram_usage = 0;
+  else if (compress_states)
+    *ram_usage = (state_size * 2) + (state_size / 4) * static_cast<u64>(num_saves - 1);
+  else
+    *ram_usage = state_size * static_cast<u64>(num_saves);
+
+  // Without a texture per state, a 1x copy of VRAM is kept in system memory instead.
+  if (use_software_renderer || native_resolution_vram)
+  {
+    *ram_usage += static_cast<u64>(VRAM_SIZE) * static_cast<u64>(num_saves);
+    *vram_usage = 0;
+  }
+  else
+  {
+    *vram_usage = (static_cast<u64>(VRAM_WIDTH * real_resolution_scale) *
+                   static_cast<u64>(VRAM_HEIGHT * real_resolution_scale) * 4) *
+                  static_cast<u64>(multisamples) * static_cast<u64>(num_saves);
+  }
 }
 
 void System::UpdateMemorySaveStateSettings()
@@ -5214,12 +5936,18 @@ void System::UpdateMemorySaveStateSettings()
   {
     s_state.rewind_save_counter = -1;
     s_state.runahead_frames = 0;
+    s_state.memory_save_state_ram_snapshots = false;
+    Bus::SetRAMDirtyTracking(false);
     return;
   }
 
   u32 num_slots = 0;
+  s_state.memory_save_state_deltas = false;
+  s_state.memory_save_state_tiers = false;
   if (g_settings.rewind_enable && !g_settings.IsRunaheadEnabled())
   {
+    s_state.memory_save_state_deltas = g_settings.rewind_compress_states;
+    s_state.memory_save_state_tiers = g_settings.rewind_tiered_states;
     s_state.rewind_save_frequency =
       static_cast<s32>(std::ceil(g_settings.rewind_save_frequency * s_state.video_frame_rate));
     s_state.rewind_save_counter = 0;
@@ -5228,10 +5956,13 @@ void System::UpdateMemorySaveStateSettings()
     u64 ram_usage, vram_usage;
     CalculateRewindMemoryUsage(g_settings.rewind_save_slots, g_settings.gpu_resolution_scale,
                                g_settings.gpu_multisamples, g_settings.gpu_use_software_renderer_for_memory_states,
-                               g_settings.cpu_enable_8mb_ram, &ram_usage, &vram_usage);
-    INFO_LOG("Rewind is enabled, saving every {} frames, with {} slots and {}MB RAM and {}MB VRAM usage",
-             std::max(s_state.rewind_save_frequency, 1), g_settings.rewind_save_slots, ram_usage / 1048576,
-             vram_usage / 1048576);
+                               g_settings.gpu_native_resolution_memory_states, g_settings.cpu_enable_8mb_ram,
+                               g_settings.rewind_compress_states, &ram_usage, &vram_usage);
+    INFO_LOG("Rewind is enabled, saving every {} frames, with {} slots covering {} saves and {}MB RAM and {}MB VRAM "
+             "usage",
+             std::max(s_state.rewind_save_frequency, 1), g_settings.rewind_save_slots,
+             GetRewindSaveIntervalCount(g_settings.rewind_save_slots, g_settings.rewind_tiered_states),
+             ram_usage / 1048576, vram_usage / 1048576);
   }
   else
   {
@@ -5244,12 +5975,17 @@ void System::UpdateMemorySaveStateSettings()
 
   s_state.runahead_frames = g_settings.runahead_frames;
   s_state.runahead_replay_pending = false;
+  s_state.runahead_input_state_valid = false;
   if (s_state.runahead_frames > 0)
   {
     INFO_LOG("Runahead is active with {} frames", s_state.runahead_frames);
     num_slots = s_state.runahead_frames;
   }
 
+  // Runahead saves and loads every frame, so only copy the RAM pages which were modified in between.
+  s_state.memory_save_state_ram_snapshots = (s_state.runahead_frames > 0);
+  Bus::SetRAMDirtyTracking(s_state.memory_save_state_ram_snapshots);
+
   // allocate storage for memory save states
   if (num_slots > 0)
     AllocateMemoryStates(num_slots, true);
@@ -5264,7 +6000,11 @@ bool System::LoadOneRewindState()
     return false;
 
   // keep the last state so we can go back to it with smaller frequencies
-  LoadMemoryState((s_state.memory_save_state_count > 1) ? PopMemoryState() : GetFirstMemoryState(), true);
+  MemorySaveState& mss = (s_state.memory_save_state_count > 1) ? PopRewindState() : GetFirstMemoryState();
+  LoadMemoryState(mss, true);
+
+  // saves made from here on follow the loaded state, so the tier spacing carries on from it
+  s_state.rewind_save_index = mss.save_index + 1;
 
   // back in time, need to reset perf counters
   GPUThread::RunOnThread(&PerformanceCounters::Reset);
@@ -5292,7 +6032,7 @@ void System::SetRewinding(bool enabled)
     {
       // Drop the last save if we just created it, since we don't want to rewind to where we are.
       if (s_state.rewind_save_counter == s_state.rewind_save_frequency && s_state.memory_save_state_count > 0)
-        PopMemoryState();
+        PopRewindState();
 
       s_state.system_interrupted = true;
     }
@@ -5348,6 +6088,23 @@ bool System::DoRunahead()
   static Timer replay_timer;
 #endif
 
+  // The frames since the oldest state were all run with the input from the last poll. If the input changed and then
+  // changed back before this poll, that prediction still holds and there's nothing to replay.
+  if (s_state.runahead_replay_frames == 0)
+  {
+    std::array<u64, NUM_CONTROLLER_AND_CARD_PORTS> input_state;
+    const bool input_state_valid = GetRunaheadInputState(&input_state);
+    if (s_state.runahead_replay_pending && input_state_valid && s_state.runahead_input_state_valid &&
+        input_state == s_state.runahead_input_state)
+    {
+      DEBUG_LOG("Input is unchanged since last poll, skipping runahead replay");
+      s_state.runahead_replay_pending = false;
+    }
+
+    s_state.runahead_input_state = input_state;
+    s_state.runahead_input_state_valid = input_state_valid;
+  }
+
   if (s_state.runahead_replay_pending)
   {
 #ifdef PROFILE_MEMORY_SAVE_STATES
@@ -5409,6 +6166,46 @@ bool System::DoRunahead()
   return false;
 }
 
+bool System::GetRunaheadInputState(std::array<u64, NUM_CONTROLLER_AND_CARD_PORTS>* state)
+{
+  for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
+  {
+    const Controller* controller = Pad::GetController(i);
+    if (!controller)
+    {
+      (*state)[i] = 0;
+      continue;
+    }
+
+    switch (controller->GetType())
+    {
+      // Button bits and axis bytes cover everything which can trigger a replay.
+      case ControllerType::DigitalController:
+      case ControllerType::PopnController:
+      case ControllerType::AnalogController:
+      case ControllerType::AnalogJoystick:
+      case ControllerType::NeGcon:
+      case ControllerType::NeGconRumble:
+        (*state)[i] = (static_cast<u64>(controller->GetButtonStateBits()) << 32) |
+                      static_cast<u64>(controller->GetAnalogInputBytes().value_or(0));
+        break;
+
+      // Never trigger a replay.
+      case ControllerType::GunCon:
+      case ControllerType::PlayStationMouse:
+      case ControllerType::Justifier:
+        (*state)[i] = 0;
+        break;
+
+      // Lever positions and steering aren't part of the button bits, so always replay.
+      default:
+        return false;
+    }
+  }
+
+  return true;
+}
+
 void System::SetRunaheadReplayFlag(bool is_analog_input)
 {
   if (s_state.runahead_frames == 0 || s_state.memory_save_state_count == 0)
@@ -5463,6 +6260,8 @@ std::optional<ExtendedSaveStateInfo> System::GetUndoSaveStateInfo()
     ssi->media_path = s_state.undo_load_state->media_path;
     ssi->screenshot = s_state.undo_load_state->screenshot;
     ssi->timestamp = s_state.undo_load_state->timestamp;
+    if (ssi->screenshot.IsValid())
+      ConvertSaveStateScreenshot(&ssi->screenshot);
   }
 
   return ssi;
@@ -5555,6 +6354,19 @@ void System::UpdateVolume()
     return;
 
   SPU::GetOutputStream().SetOutputVolume(GetAudioOutputVolume());
+  SPU::SetAudioOutputSkipped(ShouldSkipAudioOutput());
+}
+
+bool System::ShouldSkipAudioOutput()
+{
+  // nothing would be heard, so don't bother mixing or stretching it
+  if (GetAudioOutputVolume() == 0)
+    return true;
+
+  // the time-stretched audio isn't worth the cost of producing it at high speeds
+  return (g_settings.audio_skip_output_speed > 0 &&
+          (s_state.target_speed == 0.0f ||
+           s_state.target_speed >= (static_cast<float>(g_settings.audio_skip_output_speed) / 100.0f)));
 }
 
 std::string System::GetScreenshotPath(const char* extension)
@@ -5612,6 +6424,119 @@ void System::StopRecordingGPUDump()
   g_gpu.StopRecordingGPUDump();
 }
 
+bool System::StartInputRecording(const char* path /* = nullptr */)
+{
+  if (!IsValid() || IsReplayingGPUDump() || s_state.input_player)
+    return false;
+
+  if (s_state.input_recorder)
+    StopInputRecording();
+
+  std::string auto_path;
+  if (!path)
+    path = (auto_path = GetScreenshotPath(InputRecording::FILE_EXTENSION)).c_str();
+
+  Error error;
+  s_state.input_recorder = InputRecording::Recorder::Create(path, &error);
+  if (!s_state.input_recorder)
+  {
+    Host::AddIconOSDMessage(
+      OSDMessageType::Error, "InputRecording", ICON_PF_GAMEPAD,
+      fmt::format("{}\n{}", TRANSLATE_SV("System", "Failed to start input recording:"), error.GetDescription()));
+    return false;
+  }
+
+  INFO_LOG("Recording input to '{}' from frame {}", path, s_state.frame_number);
+  Host::AddIconOSDMessage(OSDMessageType::Quick, "InputRecording", ICON_PF_GAMEPAD,
+                          fmt::format(TRANSLATE_FS("System", "Recording input to '{}'."), Path::GetFileName(path)));
+  return true;
+}
+
+void System::StopInputRecording()
+{
+  const std::unique_ptr<InputRecording::Recorder> recorder = std::move(s_state.input_recorder);
+  if (!recorder)
+    return;
+
+  Error error;
+  if (!recorder->Close(&error))
+  {
+    Host::AddIconOSDMessage(
+      OSDMessageType::Error, "InputRecording", ICON_PF_GAMEPAD,
+      fmt::format("{}\n{}", TRANSLATE_SV("System", "Failed to save input recording:"), error.GetDescription()));
+    return;
+  }
+
+  INFO_LOG("Saved {} frames of input to '{}'", recorder->GetFrameCount(), recorder->GetPath());
+  Host::AddIconOSDMessage(OSDMessageType::Info, "InputRecording", ICON_PF_GAMEPAD,
+                          fmt::format(TRANSLATE_FS("System", "Saved {} frames of input to '{}'."),
+                                      recorder->GetFrameCount(), Path::GetFileName(recorder->GetPath())));
+}
+
+bool System::IsRecordingInput()
+{
+  return static_cast<bool>(s_state.input_recorder);
+}
+
+bool System::StartInputPlayback(const char* path, Error* error)
+{
+  if (!IsValid() || IsReplayingGPUDump())
+  {
+    Error::SetStringView(error, "System is not running a game.");
+    return false;
+  }
+
+  StopInputRecording();
+
+  std::unique_ptr<InputRecording::Player> player = InputRecording::Player::Open(path, error);
+  if (!player)
+    return false;
+
+  if (player->GetSerial() != s_state.running_game_serial)
+  {
+    WARNING_LOG("Input recording was made with '{}', but '{}' is running.", player->GetSerial(),
+                s_state.running_game_serial);
+  }
+
+  if (!player->Start(error))
+    return false;
+
+  INFO_LOG("Playing back {} frames of input from '{}'", player->GetFrameCount(), player->GetPath());
+  s_state.input_player = std::move(player);
+  return true;
+}
+
+void System::StopInputPlayback()
+{
+  s_state.input_player.reset();
+}
+
+bool System::IsPlayingBackInput()
+{
+  return static_cast<bool>(s_state.input_player);
+}
+
+u32 System::GetInputPlaybackFrameCount()
+{
+  return s_state.input_player ? s_state.input_player->GetFrameCount() : 0;
+}
+
+void System::UpdateInputRecording()
+{
+  Error error;
+  if (s_state.input_recorder && !s_state.input_recorder->RecordFrame(s_state.frame_number, &error))
+  {
+    WARNING_LOG("Stopping input recording: {}", error.GetDescription());
+    StopInputRecording();
+  }
+
+  if (s_state.input_player && !s_state.input_player->PlayFrame(s_state.frame_number))
+  {
+    INFO_LOG("Input playback finished at frame {}.", s_state.frame_number);
+    s_state.input_player.reset();
+  }
+}
+
 static std::string_view GetCaptureTypeForMessage(bool capture_video, bool capture_audio)
 {
   return capture_video ? (capture_audio ? TRANSLATE_SV("System", "capturing audio and video") :
@@ -5708,6 +6633,13 @@ bool System::StartMediaCapture(std::string path, bool capture_video, bool captur
 
   Error error;
   s_state.media_capture = MediaCapture::Create(backend, &error);
+  if (s_state.media_capture)
+  {
+    // Dropping frames when the encoder falls behind keeps it from slowing down emulation.
+    s_state.media_capture->SetVideoQueueOptions(
+      Core::GetUIntSettingValue("MediaCapture", "VideoQueueDepth", Settings::DEFAULT_MEDIA_CAPTURE_VIDEO_QUEUE_DEPTH),
+      Core::GetBoolSettingValue("MediaCapture", "VideoDropFrames", true));
+  }
   if (!s_state.media_capture ||
       !s_state.media_capture->BeginCapture(
         s_state.video_frame_rate, aspect, video_width, video_height, capture_format, SPU::SAMPLE_RATE, std::move(path),
@@ -5835,7 +6767,7 @@ std::optional<SaveStateInfo> System::GetSaveStateInfo(std::string_view serial, s
   const bool global = serial.empty();
   std::string path = global ? GetGlobalSaveStatePath(slot) : GetGameSaveStatePath(serial, slot);
 
-  FlushSaveStates();
+  WaitForSaveStateWrite(path);
 
   FILESYSTEM_STAT_DATA sd;
   if (!FileSystem::StatFile(path.c_str(), &sd))
@@ -5844,11 +6776,11 @@ std::optional<SaveStateInfo> System::GetSaveStateInfo(std::string_view serial, s
   return SaveStateInfo{std::move(path), sd.ModificationTime, slot, global};
 }
 
-std::optional<ExtendedSaveStateInfo> System::GetExtendedSaveStateInfo(const char* path)
+std::optional<ExtendedSaveStateInfo> System::GetExtendedSaveStateInfo(const char* path, bool read_screenshot)
 {
   std::optional<ExtendedSaveStateInfo> ssi;
 
-  FlushSaveStates();
+  WaitForSaveStateWrite(path);
 
   Error error;
   auto fp = FileSystem::OpenManagedCFile(path, "rb", &error);
@@ -5857,7 +6789,7 @@ std::optional<ExtendedSaveStateInfo> System::GetExtendedSaveStateInfo(const char
     ssi.emplace();
 
     SaveStateBuffer buffer;
-    if (LoadStateBufferFromFile(&buffer, fp.get(), &error, true, true, true, false)) [[likely]]
+    if (LoadStateBufferFromFile(&buffer, fp.get(), &error, true, true, read_screenshot, false)) [[likely]]
     {
       ssi->title = std::move(buffer.title);
       ssi->serial = std::move(buffer.serial);
@@ -6165,7 +7097,7 @@ void System::ToggleWidescreen()
 
 void System::ToggleSoftwareRendering()
 {
-  if (IsShutdown() || g_settings.gpu_renderer == GPURenderer::Software)
+  if (IsShutdown() || !Settings::IsHardwareRenderer(g_settings.gpu_renderer))
     return;
 
   const GPURenderer new_renderer =
@@ -6259,11 +7191,96 @@ void System::UpdateAutomaticResolutionScale()
   if (!IsValidOrInitializing() || !g_settings.gpu_automatic_resolution_scale)
     return;
 
-  const u32 new_scale = g_gpu.CalculateAutomaticResolutionScale();
+  const u8 new_scale = ApplyDynamicResolutionScale(Truncate8(g_gpu.CalculateAutomaticResolutionScale()));
   if (g_settings.gpu_resolution_scale == new_scale)
     return;
 
-  g_settings.gpu_resolution_scale = Truncate8(new_scale);
+  SetActiveResolutionScale(new_scale);
+}
+
+void System::UpdateDynamicResolutionScale(float gpu_time)
+{
+  if (!IsValid() || IsPaused() || !g_settings.gpu_dynamic_resolution_scale || !GPUBackend::IsUsingHardwareBackend() ||
+      s_state.dynamic_resolution_scale_max == 0 || gpu_time <= 0.0f)
+  {
+    return;
+  }
+
+  // The first sample after a change includes recreating the framebuffers, and possibly pipelines.
+  if (s_state.dynamic_resolution_scale_settling)
+  {
+    s_state.dynamic_resolution_scale_settling = false;
+    return;
+  }
+
+  const u8 current_scale = g_settings.gpu_resolution_scale;
+  const u8 min_scale = std::min(g_settings.gpu_dynamic_resolution_scale_minimum, s_state.dynamic_resolution_scale_max);
+  const float budget = 1000.0f / s_state.video_frame_rate;
+
+  u8 new_scale = current_scale;
+  if (gpu_time > (budget * DYNAMIC_RESOLUTION_SCALE_DOWN_THRESHOLD) && current_scale > min_scale)
+  {
+    s_state.dynamic_resolution_scale_under_budget = 0;
+    if (++s_state.dynamic_resolution_scale_over_budget >= DYNAMIC_RESOLUTION_SCALE_DOWN_SAMPLES)
+    {
+      // GPU time is roughly proportional to the pixel count, so jump straight to the scale that should fit.
+      const float fit_scale = static_cast<float>(current_scale) *
+                              std::sqrt((budget * DYNAMIC_RESOLUTION_SCALE_DOWN_THRESHOLD) / gpu_time);
+      new_scale = static_cast<u8>(std::clamp<s32>(static_cast<s32>(fit_scale), min_scale, current_scale - 1));
+    }
+  }
+  else if (current_scale < s_state.dynamic_resolution_scale_max)
+  {
+    s_state.dynamic_resolution_scale_over_budget = 0;
+
+    const float scale_ratio = static_cast<float>(current_scale + 1) / static_cast<float>(current_scale);
+    const float predicted_time = gpu_time * scale_ratio * scale_ratio;
+    if (predicted_time > (budget * DYNAMIC_RESOLUTION_SCALE_UP_THRESHOLD))
+      s_state.dynamic_resolution_scale_under_budget = 0;
+    else if (++s_state.dynamic_resolution_scale_under_budget >= DYNAMIC_RESOLUTION_SCALE_UP_SAMPLES)
+      new_scale = current_scale + 1;
+  }
+  else
+  {
+    s_state.dynamic_resolution_scale_over_budget = 0;
+    s_state.dynamic_resolution_scale_under_budget = 0;
+  }
+
+  if (new_scale == current_scale)
+    return;
+
+  DEV_LOG("Dynamic resolution scale {}x -> {}x, GPU time {:.2f}ms of {:.2f}ms", current_scale, new_scale, gpu_time,
+          budget);
+  s_state.dynamic_resolution_scale = new_scale;
+  s_state.dynamic_resolution_scale_over_budget = 0;
+  s_state.dynamic_resolution_scale_under_budget = 0;
+  s_state.dynamic_resolution_scale_settling = true;
+  SetActiveResolutionScale(new_scale);
+}
+
+void System::ResetDynamicResolutionScale()
+{
+  s_state.dynamic_resolution_scale = 0;
+  s_state.dynamic_resolution_scale_max = g_settings.gpu_resolution_scale;
+  s_state.dynamic_resolution_scale_over_budget = 0;
+  s_state.dynamic_resolution_scale_under_budget = 0;
+  s_state.dynamic_resolution_scale_settling = false;
+}
+
+u8 System::ApplyDynamicResolutionScale(u8 max_scale)
+{
+  // The configured (or automatic) scale is the upper bound, dynamic scaling can only lower it.
+  s_state.dynamic_resolution_scale_max = max_scale;
+  if (!g_settings.gpu_dynamic_resolution_scale || s_state.dynamic_resolution_scale == 0)
+    return max_scale;
+
+  return std::clamp(s_state.dynamic_resolution_scale,
+                    std::min(g_settings.gpu_dynamic_resolution_scale_minimum, max_scale), max_scale);
+}
+
+void System::SetActiveResolutionScale(u8 scale)
+{
+  g_settings.gpu_resolution_scale = scale;
   GPUThread::UpdateSettings(true, false, false);
   FreeMemoryStateStorage(false, true, false);
   ClearMemorySaveStates(true, false);
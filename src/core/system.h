@@ -228,6 +228,9 @@ GlobalTicks GetGlobalTickCounter();
 u32 GetFrameNumber();
 u32 GetInternalFrameNumber();
 
+/// Polls input again when the game starts reading a controller, at most once per frame, if enabled.
+void PollInputForPadRead();
+
 const std::string& GetGameTitle();
 const std::string& GetGameSerial();
 const std::string& GetGamePath();
@@ -301,6 +304,10 @@ bool SaveStateDataToBuffer(std::span<u8> data, size_t* data_size, Error* error);
 /// Runs the VM until the CPU execution is canceled.
 void Execute();
 
+/// Runs the VM until the end of the current frame, for hosts which drive emulation themselves. Throttling still
+/// applies unless it has been disabled. Returns false if the system is not running, or shut down during the frame.
+bool RunFrame();
+
 void SingleStepCPU();
 
 /// Sets target emulation speed.
@@ -401,8 +408,8 @@ std::vector<SaveStateInfo> GetAvailableSaveStates(std::string_view serial);
 /// Returns save state info if present. If serial is null or empty, assumes global state.
 std::optional<SaveStateInfo> GetSaveStateInfo(std::string_view serial, s32 slot);
 
-/// Returns save state info from opened save state stream.
-std::optional<ExtendedSaveStateInfo> GetExtendedSaveStateInfo(const char* path);
+/// Returns save state info from opened save state stream. The screenshot can be skipped if it's not needed yet.
+std::optional<ExtendedSaveStateInfo> GetExtendedSaveStateInfo(const char* path, bool read_screenshot = true);
 
 /// Deletes save states for the specified game code. If resume is set, the resume state is deleted too.
 void DeleteSaveStates(std::string_view serial, bool resume);
@@ -424,6 +431,18 @@ void SaveScreenshot(const char* path = nullptr, DisplayScreenshotMode mode = g_s
 bool StartRecordingGPUDump(const char* path = nullptr, u32 num_frames = 1);
 void StopRecordingGPUDump();
 
+/// Starts/stops recording controller input, anchored to a save state of the current frame. If no path is provided,
+/// one will be generated automatically.
+bool StartInputRecording(const char* path = nullptr);
+void StopInputRecording();
+bool IsRecordingInput();
+
+/// Loads the anchor state of an input recording, and replays its input until the end of the recording.
+bool StartInputPlayback(const char* path, Error* error);
+void StopInputPlayback();
+bool IsPlayingBackInput();
+u32 GetInputPlaybackFrameCount();
+
 /// Returns the path that a new media capture would be saved to by default. Safe to call from any thread.
 std::string GetNewMediaCapturePath(const std::string_view title, const std::string_view container);
 
@@ -451,7 +470,10 @@ std::string GetImageForLoadingScreen(const std::string& game_path);
 // Memory Save States (Rewind and Runahead)
 //////////////////////////////////////////////////////////////////////////
 void CalculateRewindMemoryUsage(u32 num_saves, u32 resolution_scale, u32 multisamples, bool use_software_renderer,
-                                bool enable_8mb_ram, u64* ram_usage, u64* vram_usage);
+                                bool native_resolution_vram, bool enable_8mb_ram, bool compress_states, u64* ram_usage,
+                                u64* vram_usage);
+/// Returns roughly how many save intervals the rewind buffer covers. Tiered states keep older saves further apart.
+u32 GetRewindSaveIntervalCount(u32 num_saves, bool tiered_states);
 void ClearMemorySaveStates(bool reallocate_resources, bool recycle_textures);
 void SetRunaheadReplayFlag(bool is_analog_input);
 
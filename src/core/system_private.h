@@ -10,6 +10,10 @@
 class GPUBackend;
 struct GPUBackendFramePresentationParameters;
 
+namespace GPUDump {
+class Player;
+}
+
 namespace System {
 
 /// Memory save states - only for internal use.
@@ -17,6 +21,11 @@ struct MemorySaveState
 {
   DynamicHeapArray<u8> state_data;
   size_t state_size;
+  size_t delta_size; // Nonzero if state_data is a delta against the next newer state.
+  u32 save_index;    // Rewind save counter, used to thin out older states.
+
+  DynamicHeapArray<u8> ram_data; // Only used with dirty page tracking, otherwise RAM is part of state_data.
+  u64 ram_generation;
 
   std::unique_ptr<GPUTexture> vram_texture;
   DynamicHeapArray<u8> gpu_state_data;
@@ -31,6 +40,9 @@ void FreeMemoryStateStorage(bool release_memory, bool release_textures, bool rec
 void LoadMemoryState(MemorySaveState& mss, bool update_display);
 void SaveMemoryState(MemorySaveState& mss);
 
+/// Returns the active GPU dump player, or null if not replaying a dump.
+GPUDump::Player* GetGPUDumpPlayer();
+
 bool IsRunaheadActive();
 void IncrementFrameNumber();
 void IncrementInternalFrameNumber();
@@ -53,6 +65,9 @@ void UpdateGTEAspectRatio();
 /// Updates the resolution scale when it is set to automatic.
 void UpdateAutomaticResolutionScale();
 
+/// Steps the resolution scale up or down to keep the average GPU time within the frame budget.
+void UpdateDynamicResolutionScale(float gpu_time);
+
 /// Called on card read/write, handles fast forwarding.
 void OnMemoryCardAccessed();
 
@@ -83,6 +98,9 @@ const Threading::ThreadHandle& GetCoreThreadHandle();
 /// Changes the CPU thread handle, use with care.
 void SetCoreThreadHandle(Threading::ThreadHandle handle);
 
+/// Called on the GPU thread when it starts, pins it according to the thread placement setting.
+void ApplyGPUThreadPlacement();
+
 /// Polls input, updates subsystems which are present while paused/inactive.
 void IdlePollUpdate();
 
@@ -484,7 +484,11 @@ void Timers::UpdateCountingEnabled(CounterState& cs)
 
 TickCount Timers::GetTicksUntilNextInterrupt()
 {
-  TickCount min_ticks = System::GetMaxSliceTicks();
+  // Counters are brought up to date whenever they're read, written or gated, so the event only has to run when an
+  // IRQ could be raised. If none can be, there's no need to run it every slice, just often enough to keep the carry
+  // small. That's a second, which is already scaled for overclocking.
+  constexpr TickCount NO_IRQ = std::numeric_limits<TickCount>::max();
+  TickCount min_ticks = NO_IRQ;
   for (u32 i = 0; i < NUM_TIMERS; i++)
   {
     const CounterState& cs = s_state.counters[i];
@@ -494,6 +498,10 @@ TickCount Timers::GetTicksUntilNextInterrupt()
       continue;
     }
 
+    // One-shot pulse IRQs which have already fired can't fire again until the mode is written.
+    if (cs.irq_done && !cs.mode.irq_repeat && !cs.mode.irq_pulse_n)
+      continue;
+
     if (cs.mode.irq_at_target)
     {
       TickCount ticks = (cs.counter <= cs.target) ? static_cast<TickCount>(cs.target - cs.counter) :
@@ -513,6 +521,10 @@ TickCount Timers::GetTicksUntilNextInterrupt()
     }
   }
 
+  if (min_ticks == NO_IRQ)
+    return System::GetTicksPerSecond();
+
+  min_ticks = std::min(min_ticks, System::GetMaxSliceTicks());
   return System::ScaleTicksToOverclock(std::max<TickCount>(1, min_ticks));
 }
 
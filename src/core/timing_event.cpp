@@ -4,42 +4,84 @@
 #include "timing_event.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
+#include "performance_counters.h"
 #include "system.h"
 
 #include "util/state_wrapper.h"
 
 #include "common/assert.h"
+#include "common/error.h"
+#include "common/file_system.h"
 #include "common/log.h"
+#include "common/path.h"
 #include "common/small_string.h"
 #include "common/thirdparty/SmallVector.h"
 
+#include "fmt/format.h"
+
+#include <algorithm>
+#include <array>
+
 LOG_CHANNEL(TimingEvents);
 
 namespace TimingEvents {
 
 static GlobalTicks GetTimestampForNewEvent();
 
+static bool IsEventBefore(const TimingEvent* lhs, const TimingEvent* rhs);
+static void SiftEventUp(TimingEvent* event);
+static void SiftEventDown(TimingEvent* event);
 static void SortEvent(TimingEvent* event);
 static void AddActiveEvent(TimingEvent* event);
 static void RemoveActiveEvent(TimingEvent* event);
 static void SortEvents();
+static TimingEvent* GetHeadEvent();
 static TimingEvent* FindActiveEvent(const std::string_view name);
 static void CommitGlobalTicks(const GlobalTicks new_global_ticks);
 
 namespace {
 struct TimingEventsState
 {
-  TimingEvent* active_events_head = nullptr;
-  TimingEvent* active_events_tail = nullptr;
+  // Binary min-heap, ordered by next run time and then sequence.
+  llvm::SmallVector<TimingEvent*, 32> active_events;
   TimingEvent* current_event = nullptr;
-  u32 active_event_count = 0;
+  u64 next_event_sequence = 0;
   GlobalTicks current_event_next_run_time = 0;
   GlobalTicks global_tick_counter = 0;
   GlobalTicks event_run_tick_counter = 0;
+  bool running_events = false;
+  bool statistics_enabled = false;
+};
+
+struct EventStatistics
+{
+  std::string_view name;
+  u64 invocations;
+  u64 early_invocations;
+  u64 reschedules;
+  u64 ticks_late;
+};
+
+struct SchedulerStatistics
+{
+  static constexpr u32 MAX_EVENTS = 64;
+
+  std::array<EventStatistics, MAX_EVENTS> events;
+  u32 num_events;
+  u32 start_frame;
+
+  // Only counted outside RunEvents(), i.e. while the CPU is executing.
+  u64 downcount_updates;
+  u64 downcount_reductions;
+  u64 downcount_ticks_removed;
 };
 } // namespace
 
+static EventStatistics* GetEventStatistics(std::string_view name);
+static void RecordDowncountUpdate(u32 new_downcount);
+
 ALIGN_TO_CACHE_LINE static TimingEventsState s_state;
+static SchedulerStatistics s_statistics = {};
 
 } // namespace TimingEvents
 
@@ -73,20 +115,19 @@ void TimingEvents::Reset()
 
 void TimingEvents::Shutdown()
 {
-  Assert(s_state.active_event_count == 0);
+  Assert(s_state.active_events.empty());
 }
 
 void TimingEvents::UpdateCPUDowncount()
 {
-  DebugAssert(s_state.active_events_head->m_next_run_time >= s_state.global_tick_counter);
-  const u32 event_downcount =
-    static_cast<u32>(s_state.active_events_head->m_next_run_time - s_state.global_tick_counter);
-  CPU::g_state.downcount = CPU::HasPendingInterrupt() ? 0 : event_downcount;
-}
+  const TimingEvent* head = GetHeadEvent();
+  DebugAssert(head->m_next_run_time >= s_state.global_tick_counter);
+  const u32 event_downcount = static_cast<u32>(head->m_next_run_time - s_state.global_tick_counter);
+  const u32 new_downcount = CPU::HasPendingInterrupt() ? 0 : event_downcount;
+  if (s_state.statistics_enabled && !s_state.running_events) [[unlikely]]
+    RecordDowncountUpdate(new_downcount);
 
-TimingEvent** TimingEvents::GetHeadEventPtr()
-{
-  return &s_state.active_events_head;
+  CPU::g_state.downcount = new_downcount;
 }
 
 void TimingEvents::SetGlobalTickCounter(GlobalTicks ticks)
@@ -94,209 +135,221 @@ void TimingEvents::SetGlobalTickCounter(GlobalTicks ticks)
   s_state.global_tick_counter = ticks;
 }
 
-void TimingEvents::SortEvent(TimingEvent* event)
+void TimingEvents::SetStatisticsEnabled(bool enabled)
 {
-  const GlobalTicks event_runtime = event->m_next_run_time;
-
-  if (event->prev && event->prev->m_next_run_time > event_runtime)
-  {
-    // move backwards
-    TimingEvent* current = event->prev;
-    while (current && current->m_next_run_time > event_runtime)
-      current = current->prev;
-
-    // unlink
-    if (event->prev)
-      event->prev->next = event->next;
-    else
-      s_state.active_events_head = event->next;
-    if (event->next)
-      event->next->prev = event->prev;
-    else
-      s_state.active_events_tail = event->prev;
+  if (s_state.statistics_enabled == enabled)
+    return;
 
-    // insert after current
-    if (current)
-    {
-      event->next = current->next;
-      if (current->next)
-        current->next->prev = event;
-      else
-        s_state.active_events_tail = event;
-
-      event->prev = current;
-      current->next = event;
-    }
-    else
-    {
-      // insert at front
-      DebugAssert(s_state.active_events_head);
-      s_state.active_events_head->prev = event;
-      event->prev = nullptr;
-      event->next = s_state.active_events_head;
-      s_state.active_events_head = event;
-      UpdateCPUDowncount();
-    }
-  }
-  else if (event->next && event_runtime > event->next->m_next_run_time)
-  {
-    // move forwards
-    TimingEvent* current = event->next;
-    while (current && event_runtime > current->m_next_run_time)
-      current = current->next;
+  s_state.statistics_enabled = enabled;
+  ResetStatistics();
+}
 
-    // unlink
-    if (event->prev)
-    {
-      event->prev->next = event->next;
-    }
-    else
-    {
-      s_state.active_events_head = event->next;
-      if (!s_state.current_event)
-        UpdateCPUDowncount();
-    }
-    if (event->next)
-      event->next->prev = event->prev;
-    else
-      s_state.active_events_tail = event->prev;
+void TimingEvents::ResetStatistics()
+{
+  s_statistics = {};
+  s_statistics.start_frame = System::GetFrameNumber();
+}
 
-    // insert before current
-    if (current)
-    {
-      event->next = current;
-      event->prev = current->prev;
+TimingEvents::EventStatistics* TimingEvents::GetEventStatistics(std::string_view name)
+{
+  // Names are almost always string literals, so comparing the pointer first avoids most string compares.
+  for (u32 i = 0; i < s_statistics.num_events; i++)
+  {
+    EventStatistics& es = s_statistics.events[i];
+    if (es.name.data() == name.data() || es.name == name)
+      return &es;
+  }
 
-      if (current->prev)
-      {
-        current->prev->next = event;
-      }
-      else
-      {
-        s_state.active_events_head = event;
-        if (!s_state.current_event)
-          UpdateCPUDowncount();
-      }
+  if (s_statistics.num_events == SchedulerStatistics::MAX_EVENTS)
+    return nullptr;
 
-      current->prev = event;
-    }
-    else
-    {
-      // insert at back
-      DebugAssert(s_state.active_events_tail);
-      s_state.active_events_tail->next = event;
-      event->next = nullptr;
-      event->prev = s_state.active_events_tail;
-      s_state.active_events_tail = event;
-    }
-  }
+  EventStatistics& es = s_statistics.events[s_statistics.num_events++];
+  es.name = name;
+  return &es;
 }
 
-void TimingEvents::AddActiveEvent(TimingEvent* event)
+void TimingEvents::RecordDowncountUpdate(u32 new_downcount)
 {
-  DebugAssert(!event->prev && !event->next);
-  s_state.active_event_count++;
+  s_statistics.downcount_updates++;
 
-  const GlobalTicks event_runtime = event->m_next_run_time;
-  TimingEvent* current = nullptr;
-  TimingEvent* next = s_state.active_events_head;
-  while (next && event_runtime > next->m_next_run_time)
+  const u32 old_downcount = CPU::g_state.downcount;
+  if (new_downcount < old_downcount)
   {
-    current = next;
-    next = next->next;
+    s_statistics.downcount_reductions++;
+    s_statistics.downcount_ticks_removed += old_downcount - new_downcount;
   }
+}
 
-  if (!next)
-  {
-    // new tail
-    event->prev = s_state.active_events_tail;
-    if (s_state.active_events_tail)
-    {
-      s_state.active_events_tail->next = event;
-      s_state.active_events_tail = event;
-    }
-    else
-    {
-      // first event
-      s_state.active_events_tail = event;
-      s_state.active_events_head = event;
-      UpdateCPUDowncount();
-    }
-  }
-  else if (!current)
+bool TimingEvents::DumpStatistics(const char* path, Error* error)
+{
+  if (!s_state.statistics_enabled)
   {
-    // new head
-    event->next = s_state.active_events_head;
-    s_state.active_events_head->prev = event;
-    s_state.active_events_head = event;
-    UpdateCPUDowncount();
+    Error::SetStringView(error, "Timing event statistics are not enabled.");
+    return false;
   }
-  else
+
+  std::array<const EventStatistics*, SchedulerStatistics::MAX_EVENTS> sorted;
+  for (u32 i = 0; i < s_statistics.num_events; i++)
+    sorted[i] = &s_statistics.events[i];
+  std::sort(sorted.begin(), sorted.begin() + s_statistics.num_events,
+            [](const EventStatistics* lhs, const EventStatistics* rhs) {
+              return ((lhs->invocations + lhs->early_invocations) > (rhs->invocations + rhs->early_invocations));
+            });
+
+  const u32 frames = std::max(System::GetFrameNumber() - s_statistics.start_frame, 1u);
+  const auto per_frame = [frames](u64 value) { return static_cast<double>(value) / static_cast<double>(frames); };
+
+  std::string report = fmt::format("Timing event statistics over {} frames\n\n", frames);
+  fmt::format_to(std::back_inserter(report), "{:<24} {:>12} {:>10} {:>10} {:>12} {:>12}\n", "Event", "Invocations",
+                 "Per Frame", "Avg Late", "Early", "Reschedules");
+  for (u32 i = 0; i < s_statistics.num_events; i++)
   {
-    // inbetween current < event > next
-    event->prev = current;
-    event->next = next;
-    current->next = event;
-    next->prev = event;
+    const EventStatistics& es = *sorted[i];
+    const double avg_late =
+      (es.invocations > 0) ? (static_cast<double>(es.ticks_late) / static_cast<double>(es.invocations)) : 0.0;
+    fmt::format_to(std::back_inserter(report), "{:<24} {:>12} {:>10.2f} {:>10.2f} {:>12} {:>12}\n", es.name,
+                   es.invocations, per_frame(es.invocations + es.early_invocations), avg_late, es.early_invocations,
+                   es.reschedules);
   }
+
+  const double avg_ticks_removed =
+    (s_statistics.downcount_reductions > 0) ?
+      (static_cast<double>(s_statistics.downcount_ticks_removed) /
+       static_cast<double>(s_statistics.downcount_reductions)) :
+      0.0;
+  fmt::format_to(std::back_inserter(report),
+                 "\nDowncount updates during execution: {} ({:.2f} per frame)\n"
+                 "Updates which ended execution early: {} ({:.2f} per frame), {:.2f} ticks earlier on average\n",
+                 s_statistics.downcount_updates, per_frame(s_statistics.downcount_updates),
+                 s_statistics.downcount_reductions, per_frame(s_statistics.downcount_reductions), avg_ticks_removed);
+
+  if (!FileSystem::WriteStringToFile(path, report, error))
+    return false;
+
+  INFO_LOG("Wrote statistics for {} timing events to {}.", s_statistics.num_events, Path::GetFileName(path));
+  return true;
 }
 
-void TimingEvents::RemoveActiveEvent(TimingEvent* event)
+ALWAYS_INLINE TimingEvent* TimingEvents::GetHeadEvent()
 {
-  DebugAssert(s_state.active_event_count > 0);
+  return s_state.active_events.front();
+}
 
-  if (event->next)
-  {
-    event->next->prev = event->prev;
-  }
-  else
+ALWAYS_INLINE bool TimingEvents::IsEventBefore(const TimingEvent* lhs, const TimingEvent* rhs)
+{
+  return (lhs->m_next_run_time < rhs->m_next_run_time ||
+          (lhs->m_next_run_time == rhs->m_next_run_time && lhs->m_sequence < rhs->m_sequence));
+}
+
+void TimingEvents::SiftEventUp(TimingEvent* event)
+{
+  u32 index = event->m_heap_index;
+  while (index > 0)
   {
-    s_state.active_events_tail = event->prev;
+    const u32 parent_index = (index - 1) / 2;
+    TimingEvent* parent = s_state.active_events[parent_index];
+    if (!IsEventBefore(event, parent))
+      break;
+
+    s_state.active_events[index] = parent;
+    parent->m_heap_index = index;
+    index = parent_index;
   }
 
-  if (event->prev)
+  s_state.active_events[index] = event;
+  event->m_heap_index = index;
+}
+
+void TimingEvents::SiftEventDown(TimingEvent* event)
+{
+  const u32 count = static_cast<u32>(s_state.active_events.size());
+  u32 index = event->m_heap_index;
+  for (;;)
   {
-    event->prev->next = event->next;
+    u32 child_index = (index * 2) + 1;
+    if (child_index >= count)
+      break;
+
+    TimingEvent* child = s_state.active_events[child_index];
+    if ((child_index + 1) < count && IsEventBefore(s_state.active_events[child_index + 1], child))
+      child = s_state.active_events[++child_index];
+    if (!IsEventBefore(child, event))
+      break;
+
+    s_state.active_events[index] = child;
+    child->m_heap_index = index;
+    index = child_index;
   }
+
+  s_state.active_events[index] = event;
+  event->m_heap_index = index;
+}
+
+void TimingEvents::SortEvent(TimingEvent* event)
+{
+  // Run times only ever change when an event is rescheduled, so it goes after anything else at the same time.
+  const TimingEvent* old_head = GetHeadEvent();
+  event->m_sequence = s_state.next_event_sequence++;
+
+  const u32 index = event->m_heap_index;
+  if (index > 0 && IsEventBefore(event, s_state.active_events[(index - 1) / 2]))
+    SiftEventUp(event);
   else
-  {
-    s_state.active_events_head = event->next;
-    if (s_state.active_events_head && !s_state.current_event)
-      UpdateCPUDowncount();
-  }
+    SiftEventDown(event);
 
-  event->prev = nullptr;
-  event->next = nullptr;
+  // The downcount only needs to change if the head did. Leave it alone if the running event is moving back,
+  // since it gets updated once the event loop finishes.
+  const TimingEvent* new_head = GetHeadEvent();
+  if (new_head == event || (new_head != old_head && !s_state.current_event))
+    UpdateCPUDowncount();
+}
+
+void TimingEvents::AddActiveEvent(TimingEvent* event)
+{
+  event->m_sequence = s_state.next_event_sequence++;
+  event->m_heap_index = static_cast<u32>(s_state.active_events.size());
+  s_state.active_events.push_back(event);
+  SiftEventUp(event);
 
-  s_state.active_event_count--;
+  if (GetHeadEvent() == event)
+    UpdateCPUDowncount();
 }
 
-void TimingEvents::SortEvents()
+void TimingEvents::RemoveActiveEvent(TimingEvent* event)
 {
-  llvm::SmallVector<TimingEvent*, 16> events;
-  events.reserve(s_state.active_event_count);
+  DebugAssert(!s_state.active_events.empty() && s_state.active_events[event->m_heap_index] == event);
 
-  TimingEvent* next = s_state.active_events_head;
-  while (next)
+  const u32 index = event->m_heap_index;
+  TimingEvent* last = s_state.active_events.back();
+  s_state.active_events.pop_back();
+  if (last != event)
   {
-    TimingEvent* current = next;
-    events.push_back(current);
-    next = current->next;
-    current->prev = nullptr;
-    current->next = nullptr;
+    // Fill the hole with the last event, it can need to go either way.
+    last->m_heap_index = index;
+    s_state.active_events[index] = last;
+    if (index > 0 && IsEventBefore(last, s_state.active_events[(index - 1) / 2]))
+      SiftEventUp(last);
+    else
+      SiftEventDown(last);
   }
 
-  s_state.active_events_head = nullptr;
-  s_state.active_events_tail = nullptr;
-  s_state.active_event_count = 0;
+  if (index == 0 && !s_state.active_events.empty() && !s_state.current_event)
+    UpdateCPUDowncount();
+}
 
-  for (TimingEvent* event : events)
-    AddActiveEvent(event);
+void TimingEvents::SortEvents()
+{
+  // Rebuild the whole heap, the run times of any event could have changed.
+  const u32 count = static_cast<u32>(s_state.active_events.size());
+  for (u32 i = 0; i < count; i++)
+    s_state.active_events[i]->m_heap_index = i;
+  for (u32 i = count / 2; i > 0; i--)
+    SiftEventDown(s_state.active_events[i - 1]);
 }
 
 static TimingEvent* TimingEvents::FindActiveEvent(const std::string_view name)
 {
-  for (TimingEvent* event = s_state.active_events_head; event; event = event->next)
+  for (TimingEvent* event : s_state.active_events)
   {
     if (event->GetName() == name)
       return event;
@@ -332,7 +385,7 @@ ALWAYS_INLINE_RELEASE void TimingEvents::CommitGlobalTicks(const GlobalTicks new
 
   do
   {
-    TimingEvent* event = s_state.active_events_head;
+    TimingEvent* event = GetHeadEvent();
     s_state.global_tick_counter = std::min(new_global_ticks, event->m_next_run_time);
 
     // Now we can actually run the callbacks.
@@ -350,15 +403,27 @@ ALWAYS_INLINE_RELEASE void TimingEvents::CommitGlobalTicks(const GlobalTicks new
       s_state.current_event_next_run_time = event->m_next_run_time + static_cast<u32>(event->m_interval);
       event->m_last_run_time = s_state.global_tick_counter;
 
+      if (s_state.statistics_enabled) [[unlikely]]
+      {
+        if (EventStatistics* const es = GetEventStatistics(event->m_name))
+        {
+          es->invocations++;
+          es->ticks_late += static_cast<u64>(ticks_late);
+        }
+      }
+
       // The cycles_late is only an indicator, it doesn't modify the cycles to execute.
-      event->m_callback(event->m_callback_param, ticks_to_execute, ticks_late);
+      {
+        PerformanceCounters::CPUTimeScope cpu_time_scope(event->m_name);
+        event->m_callback(event->m_callback_param, ticks_to_execute, ticks_late);
+      }
       if (event->m_active)
       {
         event->m_next_run_time = s_state.current_event_next_run_time;
         SortEvent(event);
       }
 
-      event = s_state.active_events_head;
+      event = GetHeadEvent();
     }
   } while (new_global_ticks > s_state.global_tick_counter);
   s_state.current_event = nullptr;
@@ -368,12 +433,13 @@ void TimingEvents::RunEvents()
 {
   DebugAssert(!s_state.current_event);
   DebugAssert(CPU::GetPendingTicks() >= CPU::g_state.downcount);
+  s_state.running_events = true;
 
   do
   {
     const GlobalTicks new_global_ticks =
       s_state.event_run_tick_counter + static_cast<GlobalTicks>(CPU::GetPendingTicks());
-    if (new_global_ticks >= s_state.active_events_head->m_next_run_time)
+    if (new_global_ticks >= GetHeadEvent()->m_next_run_time)
     {
       CPU::ResetPendingTicks();
       CommitGlobalTicks(new_global_ticks);
@@ -384,6 +450,8 @@ void TimingEvents::RunEvents()
 
     UpdateCPUDowncount();
   } while (CPU::GetPendingTicks() >= CPU::g_state.downcount);
+
+  s_state.running_events = false;
 }
 
 void TimingEvents::CommitLeftoverTicks()
@@ -393,12 +461,14 @@ void TimingEvents::CommitLeftoverTicks()
     DEV_LOG("Late-running {} ticks before execution", s_state.event_run_tick_counter - s_state.global_tick_counter);
 #endif
 
+  s_state.running_events = true;
   CommitGlobalTicks(s_state.event_run_tick_counter);
 
   if (CPU::HasPendingInterrupt())
     CPU::DispatchInterrupt();
 
   UpdateCPUDowncount();
+  s_state.running_events = false;
 }
 
 bool TimingEvents::DoState(StateWrapper& sw)
@@ -438,6 +508,7 @@ bool TimingEvents::DoState(StateWrapper& sw)
       event->m_last_run_time = s_state.global_tick_counter - static_cast<u32>(time_since_last_run);
       event->m_period = period;
       event->m_interval = interval;
+      event->m_sequence = s_state.next_event_sequence++;
     }
 
     if (sw.GetVersion() < 43) [[unlikely]]
@@ -493,6 +564,9 @@ bool TimingEvents::DoState(StateWrapper& sw)
         event->m_last_run_time = last_run_time;
         event->m_period = period;
         event->m_interval = interval;
+
+        // Events are saved in the order they run, so this keeps events at the same time in the same order.
+        event->m_sequence = s_state.next_event_sequence++;
       }
 
       DEBUG_LOG("Loaded {} events from save state.", event_count);
@@ -505,9 +579,13 @@ bool TimingEvents::DoState(StateWrapper& sw)
     }
     else
     {
-      sw.Do(&s_state.active_event_count);
+      llvm::SmallVector<TimingEvent*, 32> events(s_state.active_events.begin(), s_state.active_events.end());
+      std::sort(events.begin(), events.end(), &IsEventBefore);
+
+      u32 event_count = static_cast<u32>(events.size());
+      sw.Do(&event_count);
 
-      for (TimingEvent* event = s_state.active_events_head; event; event = event->next)
+      for (TimingEvent* event : events)
       {
         sw.Do(&event->m_name);
         GlobalTicks next_run_time =
@@ -518,7 +596,7 @@ bool TimingEvents::DoState(StateWrapper& sw)
         sw.Do(&event->m_interval);
       }
 
-      DEBUG_LOG("Wrote {} events to save state.", s_state.active_event_count);
+      DEBUG_LOG("Wrote {} events to save state.", event_count);
     }
   }
 
@@ -564,10 +642,14 @@ void TimingEvent::Delay(TickCount ticks)
 
   DebugAssert(TimingEvents::s_state.current_event != this);
 
+  if (s_state.statistics_enabled) [[unlikely]]
+  {
+    if (EventStatistics* const es = GetEventStatistics(m_name))
+      es->reschedules++;
+  }
+
   m_next_run_time += static_cast<u32>(ticks);
   SortEvent(this);
-  if (s_state.active_events_head == this)
-    UpdateCPUDowncount();
 }
 
 void TimingEvent::Schedule(TickCount ticks)
@@ -595,10 +677,14 @@ void TimingEvent::Schedule(TickCount ticks)
     // If this is a call from an IO handler for example, re-sort the event queue.
     if (s_state.current_event != this)
     {
+      if (s_state.statistics_enabled) [[unlikely]]
+      {
+        if (EventStatistics* const es = GetEventStatistics(m_name))
+          es->reschedules++;
+      }
+
       m_next_run_time = next_run_time;
       SortEvent(this);
-      if (s_state.active_events_head == this)
-        UpdateCPUDowncount();
     }
   }
 }
@@ -642,9 +728,14 @@ void TimingEvent::InvokeEarly(bool force /* = false */)
 
   // Since we've changed the downcount, we need to re-sort the events.
   SortEvent(this);
-  if (s_state.active_events_head == this)
-    UpdateCPUDowncount();
 
+  if (s_state.statistics_enabled) [[unlikely]]
+  {
+    if (EventStatistics* const es = GetEventStatistics(m_name))
+      es->early_invocations++;
+  }
+
+  PerformanceCounters::CPUTimeScope cpu_time_scope(m_name);
   m_callback(m_callback_param, ticks_to_execute, 0);
 }
 
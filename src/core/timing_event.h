@@ -7,6 +7,7 @@
 
 #include <string_view>
 
+class Error;
 class StateWrapper;
 
 // Event callback type. Second parameter is the number of cycles the event was executed "late".
@@ -58,15 +59,16 @@ public:
   void SetInterval(TickCount interval) { m_interval = interval; }
   void SetPeriod(TickCount period) { m_period = period; }
 
-  TimingEvent* prev = nullptr;
-  TimingEvent* next = nullptr;
-
   TimingEventCallback m_callback;
   void* m_callback_param;
 
   GlobalTicks m_next_run_time = 0;
   GlobalTicks m_last_run_time = 0;
 
+  // Events which run at the same time are ordered by when they were scheduled.
+  u64 m_sequence = 0;
+  u32 m_heap_index = 0;
+
   TickCount m_period;
   TickCount m_interval;
   bool m_active = false;
@@ -92,7 +94,11 @@ void CommitLeftoverTicks();
 
 void UpdateCPUDowncount();
 
-TimingEvent** GetHeadEventPtr();
+/// Scheduler statistics, counted per event name when enabled. Also tracks how often the CPU downcount is reduced
+/// while executing, since that forces the current block to exit early.
+void SetStatisticsEnabled(bool enabled);
+void ResetStatistics();
+bool DumpStatistics(const char* path, Error* error);
 
 // Tick counter injection, only for GPU dump replayer.
 void SetGlobalTickCounter(GlobalTicks ticks);
@@ -75,6 +75,7 @@ enum class GPURenderer : u8
   HardwareOpenGL,
 #endif
   Software,
+  Null,
   Count
 };
 
@@ -305,6 +306,14 @@ enum class CPUFastmemMode : u8
   Count
 };
 
+enum class ThreadPlacementMode : u8
+{
+  Disabled,
+  PerformanceCores,
+  PerformanceCoresRealtime,
+  Count
+};
+
 enum class CDROMMechaconVersion : u8
 {
   VC0A,
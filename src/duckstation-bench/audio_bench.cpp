@@ -0,0 +1,205 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "bench.h"
+
+#include "util/spu_reverb.h"
+#include "util/xa_adpcm.h"
+
+#include "common/gsvector.h"
+
+#include <array>
+#include <random>
+#include <vector>
+
+// One frame of audio at 60fps.
+static constexpr u32 SAMPLES_PER_FRAME = 735;
+
+static std::vector<u8> GenerateXASectorData()
+{
+  std::mt19937 rng(0x12345678);
+  std::vector<u8> data(XAADPCM::NUM_CHUNKS * XAADPCM::CHUNK_SIZE_IN_BYTES);
+  for (u8& byte : data)
+    byte = static_cast<u8>(rng());
+
+  // Sound group headers have to use a valid filter.
+  for (u32 chunk = 0; chunk < XAADPCM::NUM_CHUNKS; chunk++)
+  {
+    for (u32 i = 0; i < 16; i++)
+      data[chunk * XAADPCM::CHUNK_SIZE_IN_BYTES + i] = static_cast<u8>(((rng() % 4) << 4) | (rng() % 13));
+  }
+
+  return data;
+}
+
+template<void (*Unpack)(const u8*, bool, XAADPCM::UnpackedSector*)>
+static void BenchmarkXAUnpack(Bench::State& state)
+{
+  const std::vector<u8> data = GenerateXASectorData();
+  XAADPCM::UnpackedSector unpacked;
+  state.SetBytesPerIteration(data.size());
+  while (state.KeepRunning())
+  {
+    Unpack(data.data(), false, &unpacked);
+    Bench::DoNotOptimize(unpacked);
+  }
+}
+
+BENCHMARK(XA_UnpackSector)
+{
+  BenchmarkXAUnpack<XAADPCM::UnpackSector>(state);
+}
+
+BENCHMARK(XA_UnpackSector_Scalar)
+{
+  BenchmarkXAUnpack<XAADPCM::UnpackSectorScalar>(state);
+}
+
+BENCHMARK(XA_DecodeSector)
+{
+  const std::vector<u8> data = GenerateXASectorData();
+  XAADPCM::UnpackedSector unpacked;
+  XAADPCM::UnpackSectorScalar(data.data(), false, &unpacked);
+
+  XAADPCM::DecoderState decoder_state = {};
+  std::array<s16, XAADPCM::SAMPLES_PER_SECTOR_4BIT> samples;
+  state.SetBytesPerIteration(data.size());
+  while (state.KeepRunning())
+  {
+    XAADPCM::DecodeSector(unpacked, true, false, decoder_state, samples.data());
+    Bench::DoNotOptimize(samples);
+  }
+}
+
+template<u32 (*Resample)(const s16*, u32, bool, bool, XAADPCM::ResamplerState&, u32*)>
+static void BenchmarkXAResample(Bench::State& state)
+{
+  // 37800hz stereo, the most common format.
+  static constexpr u32 NUM_FRAMES = XAADPCM::SAMPLES_PER_SECTOR_4BIT / 2;
+
+  std::mt19937 rng(0x12345678);
+  std::vector<s16> frames(NUM_FRAMES * 2);
+  for (s16& v : frames)
+    v = static_cast<s16>(rng());
+
+  XAADPCM::ResamplerState resampler_state;
+  resampler_state.Reset();
+  std::vector<u32> frames_out(XAADPCM::MAX_RESAMPLED_FRAMES_PER_SECTOR);
+  state.SetBytesPerIteration(frames.size() * sizeof(s16));
+  while (state.KeepRunning())
+  {
+    const u32 count = Resample(frames.data(), NUM_FRAMES, true, false, resampler_state, frames_out.data());
+    Bench::DoNotOptimize(count);
+    Bench::ClobberMemory();
+  }
+}
+
+BENCHMARK(XA_ResampleSector)
+{
+  BenchmarkXAResample<XAADPCM::ResampleSector>(state);
+}
+
+BENCHMARK(XA_ResampleSector_Scalar)
+{
+  BenchmarkXAResample<XAADPCM::ResampleSectorScalar>(state);
+}
+
+template<s16 (*Downsample)(const s16*), s16 (*Upsample)(const s16*)>
+static void BenchmarkReverbResample(Bench::State& state)
+{
+  std::mt19937 rng(0x12345678);
+  std::vector<s16> samples(SAMPLES_PER_FRAME + SPUReverb::DOWNSAMPLE_READ_SIZE);
+  for (s16& v : samples)
+    v = static_cast<s16>(rng());
+
+  // The reverb unit runs at half rate, so every second sample is downsampled on the way in and upsampled on the way
+  // out, for both channels.
+  state.SetBytesPerIteration(SAMPLES_PER_FRAME * 2 * sizeof(s16));
+  while (state.KeepRunning())
+  {
+    s32 sum = 0;
+    for (u32 channel = 0; channel < 2; channel++)
+    {
+      for (u32 i = 0; i < SAMPLES_PER_FRAME; i += 2)
+        sum += Downsample(&samples[i]) + Upsample(&samples[i]);
+    }
+    Bench::DoNotOptimize(sum);
+  }
+}
+
+BENCHMARK(SPU_ReverbResample)
+{
+  BenchmarkReverbResample<SPUReverb::Downsample, SPUReverb::Upsample>(state);
+}
+
+BENCHMARK(SPU_ReverbResample_Scalar)
+{
+  BenchmarkReverbResample<SPUReverb::DownsampleScalar, SPUReverb::UpsampleScalar>(state);
+}
+
+BENCHMARK(SPU_VoiceMix)
+{
+  // Mirrors the interpolation and volume part of SPU::Execute(), which is file-local in core/spu.cpp. All voices are
+  // audible, which is the worst case.
+  static constexpr u32 NUM_VOICES = 24;
+
+  alignas(VECTOR_ALIGNMENT) std::array<s16, NUM_VOICES * 2> samples_lo;
+  alignas(VECTOR_ALIGNMENT) std::array<s16, NUM_VOICES * 2> samples_hi;
+  alignas(VECTOR_ALIGNMENT) std::array<s16, NUM_VOICES * 2> taps_lo;
+  alignas(VECTOR_ALIGNMENT) std::array<s16, NUM_VOICES * 2> taps_hi;
+  alignas(VECTOR_ALIGNMENT) std::array<s32, NUM_VOICES> adsr_volumes;
+  alignas(VECTOR_ALIGNMENT) std::array<s32, NUM_VOICES> left_levels;
+  alignas(VECTOR_ALIGNMENT) std::array<s32, NUM_VOICES> right_levels;
+  alignas(VECTOR_ALIGNMENT) std::array<s32, NUM_VOICES> volumes;
+
+  std::mt19937 rng(0x12345678);
+  for (u32 i = 0; i < NUM_VOICES * 2; i++)
+  {
+    samples_lo[i] = static_cast<s16>(rng());
+    samples_hi[i] = static_cast<s16>(rng());
+    taps_lo[i] = static_cast<s16>(rng() % 0x4000);
+    taps_hi[i] = static_cast<s16>(rng() % 0x4000);
+  }
+  for (u32 i = 0; i < NUM_VOICES; i++)
+  {
+    adsr_volumes[i] = static_cast<s32>(rng() % 0x8000);
+    left_levels[i] = static_cast<s32>(rng() % 0x8000);
+    right_levels[i] = static_cast<s32>(rng() % 0x8000);
+  }
+
+  const u32 reverb_on_register = 0x00AAAAAA;
+  const GSVector4i voice_bits = GSVector4i::cxpr(1, 2, 4, 8);
+  state.SetBytesPerIteration(SAMPLES_PER_FRAME * NUM_VOICES * 2 * sizeof(s16));
+  while (state.KeepRunning())
+  {
+    for (u32 i = 0; i < SAMPLES_PER_FRAME; i++)
+    {
+      GSVector4i left = GSVector4i::zero();
+      GSVector4i right = GSVector4i::zero();
+      GSVector4i reverb_left = GSVector4i::zero();
+      GSVector4i reverb_right = GSVector4i::zero();
+      for (u32 voice_index = 0; voice_index < NUM_VOICES; voice_index += 4)
+      {
+        const GSVector4i sample = GSVector4i::load<true>(&samples_lo[voice_index * 2])
+                                    .madd_s16(GSVector4i::load<true>(&taps_lo[voice_index * 2]))
+                                    .add32(GSVector4i::load<true>(&samples_hi[voice_index * 2])
+                                             .madd_s16(GSVector4i::load<true>(&taps_hi[voice_index * 2])))
+                                    .sra32<15>();
+        const GSVector4i volume = sample.mul32l(GSVector4i::load<true>(&adsr_volumes[voice_index])).sra32<15>();
+        const GSVector4i voice_left = volume.mul32l(GSVector4i::load<true>(&left_levels[voice_index])).sra32<15>();
+        const GSVector4i voice_right = volume.mul32l(GSVector4i::load<true>(&right_levels[voice_index])).sra32<15>();
+        left = left.add32(voice_left);
+        right = right.add32(voice_right);
+
+        const GSVector4i reverb_mask =
+          (GSVector4i(static_cast<s32>(reverb_on_register >> voice_index)) & voice_bits).eq32(voice_bits);
+        reverb_left = reverb_left.add32(voice_left & reverb_mask);
+        reverb_right = reverb_right.add32(voice_right & reverb_mask);
+        GSVector4i::store<true>(&volumes[voice_index], volume);
+      }
+
+      Bench::DoNotOptimize(left.addv_s32() + right.addv_s32() + reverb_left.addv_s32() + reverb_right.addv_s32());
+      Bench::ClobberMemory();
+    }
+  }
+}
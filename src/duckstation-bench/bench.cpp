@@ -0,0 +1,301 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "bench.h"
+
+#include "common/error.h"
+#include "common/file_system.h"
+#include "common/log.h"
+#include "common/string_util.h"
+
+#include "fmt/format.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+LOG_CHANNEL(Host);
+
+namespace Bench {
+namespace {
+
+struct Entry
+{
+  std::string name;
+  Function func;
+};
+
+struct Result
+{
+  std::string name;
+  u64 iterations;
+  double median_ns;
+  double min_ns;
+  double mb_per_second;
+  std::string skip_reason;
+};
+
+} // namespace
+
+static std::vector<Entry>& GetRegistry();
+static void PrintCommandLineHelp(const char* progname);
+static bool ParseCommandLineParameters(int argc, char* argv[]);
+static Result RunBenchmark(const Entry& entry);
+static void PrintResult(const Result& result);
+static bool WriteJSONResults(const std::vector<Result>& results);
+
+static std::string s_filter;
+static std::string s_json_output_path;
+static std::string s_chd_path;
+static double s_min_time_ms = 100.0;
+static u32 s_repetitions = 5;
+static bool s_list_only = false;
+
+} // namespace Bench
+
+std::vector<Bench::Entry>& Bench::GetRegistry()
+{
+  // Function-local, since benchmarks register themselves during static initialization.
+  static std::vector<Entry> registry;
+  return registry;
+}
+
+bool Bench::Register(std::string name, Function func)
+{
+  GetRegistry().push_back(Entry{std::move(name), std::move(func)});
+  return true;
+}
+
+const std::string& Bench::GetCHDPath()
+{
+  return s_chd_path;
+}
+
+void Bench::PrintCommandLineHelp(const char* progname)
+{
+  std::fprintf(stderr, "DuckStation Microbenchmarks\n");
+  std::fprintf(stderr, "\n");
+  std::fprintf(stderr, "Usage: %s [parameters]\n", progname);
+  std::fprintf(stderr, "\n");
+  std::fprintf(stderr, "  -help: Displays this information and exits.\n");
+  std::fprintf(stderr, "  -list: Lists the available benchmarks and exits.\n");
+  std::fprintf(stderr, "  -filter <text>: Only runs benchmarks with names containing text.\n");
+  std::fprintf(stderr, "  -min-time <ms>: Minimum duration of each repetition. Defaults to 100.\n");
+  std::fprintf(stderr, "  -repetitions <count>: Number of timed repetitions, the median is reported. Defaults to 5.\n");
+  std::fprintf(stderr, "  -json <path>: Writes the results as JSON to path (- for stdout).\n");
+  std::fprintf(stderr, "  -chd <path>: CHD image to use for the hunk decode benchmarks.\n");
+  std::fprintf(stderr, "\n");
+}
+
+bool Bench::ParseCommandLineParameters(int argc, char* argv[])
+{
+  for (int i = 1; i < argc; i++)
+  {
+#define CHECK_ARG(str) !std::strcmp(argv[i], str)
+#define CHECK_ARG_PARAM(str) (!std::strcmp(argv[i], str) && ((i + 1) < argc))
+
+    if (CHECK_ARG("-help"))
+    {
+      PrintCommandLineHelp(argv[0]);
+      return false;
+    }
+    else if (CHECK_ARG("-list"))
+    {
+      s_list_only = true;
+      continue;
+    }
+    else if (CHECK_ARG_PARAM("-filter"))
+    {
+      s_filter = argv[++i];
+      continue;
+    }
+    else if (CHECK_ARG_PARAM("-min-time"))
+    {
+      const std::optional<double> min_time = StringUtil::FromChars<double>(argv[++i]);
+      if (!min_time.has_value() || min_time.value() <= 0.0)
+      {
+        ERROR_LOG("Invalid minimum time specified: {}", argv[i]);
+        return false;
+      }
+
+      s_min_time_ms = min_time.value();
+      continue;
+    }
+    else if (CHECK_ARG_PARAM("-repetitions"))
+    {
+      const std::optional<u32> repetitions = StringUtil::FromChars<u32>(argv[++i]);
+      if (!repetitions.has_value() || repetitions.value() == 0)
+      {
+        ERROR_LOG("Invalid repetition count specified: {}", argv[i]);
+        return false;
+      }
+
+      s_repetitions = repetitions.value();
+      continue;
+    }
+    else if (CHECK_ARG_PARAM("-json"))
+    {
+      s_json_output_path = argv[++i];
+      continue;
+    }
+    else if (CHECK_ARG_PARAM("-chd"))
+    {
+      s_chd_path = argv[++i];
+      continue;
+    }
+
+    ERROR_LOG("Unknown parameter: '{}'", argv[i]);
+    return false;
+
+#undef CHECK_ARG_PARAM
+#undef CHECK_ARG
+  }
+
+  return true;
+}
+
+Bench::Result Bench::RunBenchmark(const Entry& entry)
+{
+  Result result = {};
+  result.name = entry.name;
+
+  // Grow the iteration count until a single run takes long enough to time reliably. This also warms the caches.
+  const Timer::Value min_time = Timer::ConvertMillisecondsToValue(s_min_time_ms);
+  u64 iterations = 1;
+  for (;;)
+  {
+    State state(iterations);
+    entry.func(state);
+    if (!state.GetSkipReason().empty())
+    {
+      result.skip_reason = state.GetSkipReason();
+      return result;
+    }
+
+    const Timer::Value elapsed = std::max<Timer::Value>(state.GetElapsedTime(), 1);
+    if (elapsed >= min_time)
+      break;
+
+    const double scale = static_cast<double>(min_time) / static_cast<double>(elapsed);
+    iterations = static_cast<u64>(static_cast<double>(iterations) * std::clamp(scale * 1.2, 2.0, 10.0));
+  }
+
+  std::vector<double> ns_per_iteration;
+  ns_per_iteration.reserve(s_repetitions);
+  u64 bytes_per_iteration = 0;
+  for (u32 i = 0; i < s_repetitions; i++)
+  {
+    State state(iterations);
+    entry.func(state);
+    ns_per_iteration.push_back(Timer::ConvertValueToNanoseconds(state.GetElapsedTime()) /
+                               static_cast<double>(iterations));
+    bytes_per_iteration = state.GetBytesPerIteration();
+  }
+
+  std::sort(ns_per_iteration.begin(), ns_per_iteration.end());
+  result.iterations = iterations;
+  result.median_ns = ns_per_iteration[ns_per_iteration.size() / 2];
+  result.min_ns = ns_per_iteration.front();
+  result.mb_per_second =
+    (bytes_per_iteration > 0) ? ((static_cast<double>(bytes_per_iteration) / result.median_ns) * 1000.0) : 0.0;
+  return result;
+}
+
+void Bench::PrintResult(const Result& result)
+{
+  if (!result.skip_reason.empty())
+  {
+    std::fprintf(stderr, "%-52s SKIPPED: %s\n", result.name.c_str(), result.skip_reason.c_str());
+    return;
+  }
+
+  if (result.mb_per_second > 0.0)
+  {
+    std::fprintf(stderr, "%-52s %12.1f ns %12.1f ns min %10.1f MB/s\n", result.name.c_str(), result.median_ns,
+                 result.min_ns, result.mb_per_second);
+  }
+  else
+  {
+    std::fprintf(stderr, "%-52s %12.1f ns %12.1f ns min\n", result.name.c_str(), result.median_ns, result.min_ns);
+  }
+}
+
+bool Bench::WriteJSONResults(const std::vector<Result>& results)
+{
+  std::string json;
+  json.append("{\n  \"benchmarks\": [");
+
+  bool first = true;
+  for (const Result& result : results)
+  {
+    if (!result.skip_reason.empty())
+      continue;
+
+    fmt::format_to(std::back_inserter(json),
+                   "{}\n    {{\"name\": \"{}\", \"iterations\": {}, \"ns\": {:.3f}, \"min_ns\": {:.3f}, "
+                   "\"mb_per_second\": {:.3f}}}",
+                   first ? "" : ",", result.name, result.iterations, result.median_ns, result.min_ns,
+                   result.mb_per_second);
+    first = false;
+  }
+
+  json.append("\n  ]\n}\n");
+
+  if (s_json_output_path == "-")
+  {
+    std::fwrite(json.data(), json.size(), 1, stdout);
+    return true;
+  }
+
+  Error error;
+  if (!FileSystem::WriteStringToFile(s_json_output_path.c_str(), json, &error))
+  {
+    ERROR_LOG("Failed to write results to '{}': {}", s_json_output_path, error.GetDescription());
+    return false;
+  }
+
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  Log::SetConsoleOutputParams(true, false);
+  Log::SetLogLevel(Log::Level::Warning);
+
+  if (!Bench::ParseCommandLineParameters(argc, argv))
+    return EXIT_FAILURE;
+
+  std::vector<Bench::Entry>& registry = Bench::GetRegistry();
+  std::sort(registry.begin(), registry.end(),
+            [](const Bench::Entry& lhs, const Bench::Entry& rhs) { return (lhs.name < rhs.name); });
+
+  std::vector<Bench::Result> results;
+  for (const Bench::Entry& entry : registry)
+  {
+    if (!Bench::s_filter.empty() && entry.name.find(Bench::s_filter) == std::string::npos)
+      continue;
+
+    if (Bench::s_list_only)
+    {
+      std::fprintf(stdout, "%s\n", entry.name.c_str());
+      continue;
+    }
+
+    results.push_back(Bench::RunBenchmark(entry));
+    Bench::PrintResult(results.back());
+  }
+
+  if (!Bench::s_list_only && results.empty())
+  {
+    ERROR_LOG("No benchmarks matched the filter '{}'.", Bench::s_filter);
+    return EXIT_FAILURE;
+  }
+
+  if (!Bench::s_json_output_path.empty() && !Bench::WriteJSONResults(results))
+    return EXIT_FAILURE;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#pragma once
+
+#include "common/timer.h"
+#include "common/types.h"
+
+#include <functional>
+#include <string>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/// Minimal microbenchmark harness. Each benchmark loops over KeepRunning(), any setup before the first call isn't
+/// timed. Inputs are generated from fixed seeds, so results are comparable between runs and commits.
+namespace Bench {
+
+class State
+{
+public:
+  explicit State(u64 iterations) : m_iterations(iterations), m_remaining(iterations) {}
+
+  ALWAYS_INLINE bool KeepRunning()
+  {
+    if (m_remaining > 0) [[likely]]
+    {
+      if (m_remaining-- == m_iterations) [[unlikely]]
+        m_start_time = Timer::GetCurrentValue();
+      return true;
+    }
+
+    m_end_time = Timer::GetCurrentValue();
+    return false;
+  }
+
+  ALWAYS_INLINE u64 GetIterations() const { return m_iterations; }
+  ALWAYS_INLINE Timer::Value GetElapsedTime() const { return m_end_time - m_start_time; }
+
+  /// Amount of input consumed by each iteration, used to report throughput.
+  ALWAYS_INLINE u64 GetBytesPerIteration() const { return m_bytes_per_iteration; }
+  ALWAYS_INLINE void SetBytesPerIteration(u64 bytes) { m_bytes_per_iteration = bytes; }
+
+  /// Marks the benchmark as not applicable to this run, e.g. a missing input file or unsupported ISA.
+  ALWAYS_INLINE const std::string& GetSkipReason() const { return m_skip_reason; }
+  ALWAYS_INLINE void Skip(std::string reason) { m_skip_reason = std::move(reason); }
+
+private:
+  u64 m_iterations;
+  u64 m_remaining;
+  u64 m_bytes_per_iteration = 0;
+  Timer::Value m_start_time = 0;
+  Timer::Value m_end_time = 0;
+  std::string m_skip_reason;
+};
+
+using Function = std::function<void(State& state)>;
+
+bool Register(std::string name, Function func);
+
+/// Path given with -chd, for benchmarks that need a real disc image. Empty if not set.
+const std::string& GetCHDPath();
+
+/// Stops the compiler from discarding a value that is otherwise unused.
+template<typename T>
+ALWAYS_INLINE void DoNotOptimize(const T& value)
+{
+#ifdef _MSC_VER
+  const volatile void* volatile sink = &value;
+  (void)sink;
+  _ReadWriteBarrier();
+#else
+  asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/// Forces any pending writes to memory to be performed.
+ALWAYS_INLINE void ClobberMemory()
+{
+#ifdef _MSC_VER
+  _ReadWriteBarrier();
+#else
+  asm volatile("" : : : "memory");
+#endif
+}
+
+} // namespace Bench
+
+#define BENCHMARK(name)                                                                                                \
+  static void Bench_##name(Bench::State& state);                                                                       \
+  [[maybe_unused]] static const bool s_bench_##name##_registered = Bench::Register(#name, &Bench_##name);              \
+  static void Bench_##name(Bench::State& state)
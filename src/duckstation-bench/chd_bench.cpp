@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "bench.h"
+
+#include "common/file_system.h"
+#include "common/heap_array.h"
+
+#include "fmt/format.h"
+#include "libchdr/chd.h"
+
+#include <memory>
+
+BENCHMARK(CHD_ReadHunks)
+{
+  // Goes through libchdr directly, so only decompression and file reads are measured, not the prefetching in
+  // CDImageCHD. Child CHDs aren't supported, since there's no way to pass the parent.
+  const std::string& path = Bench::GetCHDPath();
+  if (path.empty())
+  {
+    state.Skip("no -chd image given");
+    return;
+  }
+
+  FileSystem::ManagedCFilePtr fp = FileSystem::OpenManagedCFile(path.c_str(), "rb");
+  if (!fp)
+  {
+    state.Skip(fmt::format("failed to open '{}'", path));
+    return;
+  }
+
+  chd_file* chd;
+  const chd_error err = chd_open_file(fp.get(), CHD_OPEN_READ | CHD_OPEN_TRANSFER_FILE, nullptr, &chd);
+  if (err != CHDERR_NONE)
+  {
+    state.Skip(fmt::format("failed to open CHD: {}", chd_error_string(err)));
+    return;
+  }
+
+  // libchdr owns the file now.
+  fp.release();
+  const std::unique_ptr<chd_file, void (*)(chd_file*)> chd_ptr(chd, chd_close);
+
+  const chd_header* header = chd_get_header(chd);
+  DynamicHeapArray<u8> buffer(header->hunkbytes);
+  state.SetBytesPerIteration(header->hunkbytes);
+
+  // Reads cycle through the image, so libchdr's single-hunk cache never hits.
+  u32 hunk = 0;
+  while (state.KeepRunning())
+  {
+    if (chd_read(chd, hunk, buffer.data()) != CHDERR_NONE)
+    {
+      state.Skip(fmt::format("failed to read hunk {}", hunk));
+      return;
+    }
+
+    hunk = (hunk + 1) % header->totalhunks;
+    Bench::ClobberMemory();
+  }
+}
@@ -0,0 +1,171 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "bench.h"
+
+#include "core/gpu.h"
+#include "core/gpu_sw_rasterizer.h"
+
+#include "fmt/format.h"
+
+#include <array>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// The rasterizer is built into this target directly instead of linking all of core, so VRAM has to live here.
+// Nothing maps it into the fastmem area, so it doesn't need the page alignment that gpu.cpp uses.
+alignas(VECTOR_ALIGNMENT) u16 g_vram[VRAM_SIZE / sizeof(u16)];
+u16 g_gpu_clut[GPU_CLUT_SIZE];
+
+namespace {
+struct RasterizerCase
+{
+  const char* name;
+  bool shading_enable;
+  bool texture_enable;
+  bool raw_texture_enable;
+  bool transparency_enable;
+  bool dither_enable;
+  bool sprite;
+  GPUTextureMode texture_mode;
+};
+} // namespace
+
+static constexpr std::array<RasterizerCase, 8> s_rasterizer_cases = {{
+  {"FlatTriangle", false, false, false, false, false, false, GPUTextureMode::Palette4Bit},
+  {"ShadedDitheredTriangle", true, false, false, false, true, false, GPUTextureMode::Palette4Bit},
+  {"ShadedTransparentTriangle", true, false, false, true, true, false, GPUTextureMode::Palette4Bit},
+  {"Textured4BitTriangle", false, true, false, false, false, false, GPUTextureMode::Palette4Bit},
+  {"Textured8BitShadedTriangle", true, true, false, false, true, false, GPUTextureMode::Palette8Bit},
+  {"Textured16BitRawTriangle", false, true, true, false, false, false, GPUTextureMode::Direct16Bit},
+  {"Textured4BitSprite", false, true, false, false, false, true, GPUTextureMode::Palette4Bit},
+  {"Textured16BitTransparentSprite", false, true, true, true, false, true, GPUTextureMode::Direct16Bit},
+}};
+
+// Game-like load: lots of small primitives scattered over a 640x480 framebuffer.
+static constexpr u32 NUM_PRIMITIVES = 512;
+static constexpr s32 MAX_PRIMITIVE_SIZE = 48;
+static constexpr s32 FRAMEBUFFER_WIDTH = 640;
+static constexpr s32 FRAMEBUFFER_HEIGHT = 480;
+
+// Textures and the CLUT sit to the right of and below the framebuffer.
+static constexpr u8 TEXTURE_PAGE_X_BASE = 10;
+static constexpr u16 CLUT_Y = 480;
+
+static void SetupVRAM(const RasterizerCase& rc)
+{
+  std::mt19937 rng(0x12345678);
+  for (u16& pixel : g_vram)
+    pixel = static_cast<u16>(rng());
+
+  GPUTexturePaletteReg palette;
+  palette.bits = 0;
+  palette.y = CLUT_Y;
+  GPU_SW_Rasterizer::UpdateCLUT(palette, rc.texture_mode == GPUTextureMode::Palette8Bit);
+  GPU_SW_Rasterizer::g_clut = g_gpu_clut;
+  GPU_SW_Rasterizer::g_drawing_area = {0, 0, VRAM_WIDTH - 1, VRAM_HEIGHT - 1};
+}
+
+static void SetupCommand(GPUBackendDrawCommand* cmd, const RasterizerCase& rc)
+{
+  cmd->shading_enable = rc.shading_enable;
+  cmd->texture_enable = rc.texture_enable;
+  cmd->raw_texture_enable = rc.raw_texture_enable;
+  cmd->transparency_enable = rc.transparency_enable;
+  cmd->dither_enable = rc.dither_enable;
+  cmd->draw_mode.texture_mode = rc.texture_mode;
+  cmd->draw_mode.transparency_mode = GPUTransparencyMode::HalfBackgroundPlusHalfForeground;
+  cmd->draw_mode.texture_page_x_base = TEXTURE_PAGE_X_BASE;
+  cmd->palette.y = CLUT_Y;
+  cmd->window.and_x = 0xFF;
+  cmd->window.and_y = 0xFF;
+}
+
+static void RunTriangles(Bench::State& state, const RasterizerCase& rc)
+{
+  GPUBackendDrawPolygonCommand cmd;
+  std::memset(&cmd, 0, sizeof(cmd));
+  SetupCommand(&cmd, rc);
+  cmd.num_vertices = 3;
+
+  std::mt19937 rng(0x87654321);
+  std::vector<GPUBackendDrawPolygonCommand::Vertex> vertices(NUM_PRIMITIVES * 3);
+  for (u32 i = 0; i < NUM_PRIMITIVES; i++)
+  {
+    const s32 x = static_cast<s32>(rng() % (FRAMEBUFFER_WIDTH - MAX_PRIMITIVE_SIZE));
+    const s32 y = static_cast<s32>(rng() % (FRAMEBUFFER_HEIGHT - MAX_PRIMITIVE_SIZE));
+    for (u32 j = 0; j < 3; j++)
+    {
+      GPUBackendDrawPolygonCommand::Vertex& v = vertices[i * 3 + j];
+      v.x = x + static_cast<s32>(rng() % MAX_PRIMITIVE_SIZE);
+      v.y = y + static_cast<s32>(rng() % MAX_PRIMITIVE_SIZE);
+      v.color = static_cast<u32>(rng());
+      v.texcoord = static_cast<u16>(rng());
+    }
+  }
+
+  const GPU_SW_Rasterizer::DrawTriangleFunction func = GPU_SW_Rasterizer::GetDrawTriangleFunction(
+    rc.shading_enable, GPU_SW_Rasterizer::GetModulationMode(rc.texture_enable, rc.raw_texture_enable, false),
+    rc.transparency_enable);
+  while (state.KeepRunning())
+  {
+    for (u32 i = 0; i < NUM_PRIMITIVES; i++)
+      func(&cmd, &vertices[i * 3 + 0], &vertices[i * 3 + 1], &vertices[i * 3 + 2]);
+    Bench::ClobberMemory();
+  }
+}
+
+static void RunSprites(Bench::State& state, const RasterizerCase& rc)
+{
+  std::mt19937 rng(0x87654321);
+  std::vector<GPUBackendDrawRectangleCommand> cmds(NUM_PRIMITIVES);
+  for (GPUBackendDrawRectangleCommand& cmd : cmds)
+  {
+    std::memset(&cmd, 0, sizeof(cmd));
+    SetupCommand(&cmd, rc);
+    cmd.x = static_cast<s32>(rng() % (FRAMEBUFFER_WIDTH - MAX_PRIMITIVE_SIZE));
+    cmd.y = static_cast<s32>(rng() % (FRAMEBUFFER_HEIGHT - MAX_PRIMITIVE_SIZE));
+    cmd.width = static_cast<u16>((rng() % MAX_PRIMITIVE_SIZE) + 1);
+    cmd.height = static_cast<u16>((rng() % MAX_PRIMITIVE_SIZE) + 1);
+    cmd.texcoord = static_cast<u16>(rng());
+    cmd.color = static_cast<u32>(rng());
+  }
+
+  const GPU_SW_Rasterizer::DrawRectangleFunction func = GPU_SW_Rasterizer::GetDrawRectangleFunction(
+    GPU_SW_Rasterizer::GetModulationMode(rc.texture_enable, rc.raw_texture_enable, false), rc.transparency_enable);
+  while (state.KeepRunning())
+  {
+    for (const GPUBackendDrawRectangleCommand& cmd : cmds)
+      func(&cmd);
+    Bench::ClobberMemory();
+  }
+}
+
+static bool RegisterRasterizerBenchmarks()
+{
+  // Every implementation in the list is registered, the ones this build or CPU can't run are reported as skipped.
+  for (const char* isa : GPU_SW_Rasterizer::IMPLEMENTATION_NAMES)
+  {
+    for (const RasterizerCase& rc : s_rasterizer_cases)
+    {
+      Bench::Register(fmt::format("SWRasterizer_{}_{}", isa, rc.name), [isa, &rc](Bench::State& state) {
+        if (!GPU_SW_Rasterizer::SelectImplementation(isa))
+        {
+          state.Skip(fmt::format("{} implementation is not available", isa));
+          return;
+        }
+
+        SetupVRAM(rc);
+        if (rc.sprite)
+          RunSprites(state, rc);
+        else
+          RunTriangles(state, rc);
+      });
+    }
+  }
+
+  return true;
+}
+
+[[maybe_unused]] static const bool s_rasterizer_benchmarks_registered = RegisterRasterizerBenchmarks();
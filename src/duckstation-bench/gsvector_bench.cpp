@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "bench.h"
+
+#include "core/gpu_helpers.h"
+
+#include "common/gsvector.h"
+
+#include <array>
+#include <random>
+
+// One scanline of 1024 VRAM pixels, which is what the display and readback paths convert at a time.
+static constexpr u32 NUM_PIXELS = 1024;
+
+namespace {
+struct TestData
+{
+  alignas(VECTOR_ALIGNMENT) std::array<u16, NUM_PIXELS> vram;
+  alignas(VECTOR_ALIGNMENT) std::array<u8, NUM_PIXELS * 3 + 4> vram24;
+  alignas(VECTOR_ALIGNMENT) std::array<u8, NUM_PIXELS * sizeof(u32)> out;
+  alignas(VECTOR_ALIGNMENT) std::array<s16, NUM_PIXELS> coefficients;
+
+  TestData()
+  {
+    std::mt19937 rng(0x12345678);
+    for (u16& v : vram)
+      v = static_cast<u16>(rng());
+    for (u8& v : vram24)
+      v = static_cast<u8>(rng());
+    for (s16& v : coefficients)
+      v = static_cast<s16>(rng());
+    out = {};
+  }
+};
+} // namespace
+
+template<GPUTextureFormat format>
+static void BenchmarkConvert15Bit(Bench::State& state)
+{
+  TestData data;
+  state.SetBytesPerIteration(sizeof(data.vram));
+  while (state.KeepRunning())
+  {
+    u8* dest = data.out.data();
+#ifdef CPU_ARCH_SIMD
+    for (u32 i = 0; i < NUM_PIXELS; i += 8)
+      ConvertVRAMPixels<format>(dest, GSVector4i::load<true>(&data.vram[i]));
+#else
+    for (u32 i = 0; i < NUM_PIXELS; i++)
+      ConvertVRAMPixel<format>(dest, data.vram[i]);
+#endif
+    Bench::ClobberMemory();
+  }
+}
+
+BENCHMARK(GSVector_VRAM15BitToRGBA8)
+{
+  BenchmarkConvert15Bit<GPUTextureFormat::RGBA8>(state);
+}
+
+BENCHMARK(GSVector_VRAM15BitToRGB565)
+{
+  BenchmarkConvert15Bit<GPUTextureFormat::RGB565>(state);
+}
+
+BENCHMARK(GSVector_VRAM24BitToRGBA8)
+{
+  TestData data;
+  state.SetBytesPerIteration(NUM_PIXELS * 3);
+  while (state.KeepRunning())
+  {
+    const u8* src = data.vram24.data();
+    u8* dest = data.out.data();
+#ifdef CPU_ARCH_SIMD
+    for (u32 i = 0; i < NUM_PIXELS; i += 4)
+      ConvertVRAM24BitPixels(dest, src);
+#else
+    for (u32 i = 0; i < NUM_PIXELS; i++)
+      ConvertVRAM24BitPixel(dest, src);
+#endif
+    Bench::ClobberMemory();
+  }
+}
+
+BENCHMARK(GSVector_BlendAverage)
+{
+  // Half-transparency between two 15-bit colours, expanded to 16 bits per channel the way the rasterizer does it.
+  TestData data;
+  state.SetBytesPerIteration(sizeof(data.vram));
+  const GSVector4i mask = GSVector4i::cxpr16(0x1F);
+  while (state.KeepRunning())
+  {
+    for (u32 i = 0; i < NUM_PIXELS; i += 8)
+    {
+      const GSVector4i fg = GSVector4i::load<true>(&data.vram[i]);
+      const GSVector4i bg = GSVector4i::load<true>(&data.vram[(i + 8) % NUM_PIXELS]);
+      const GSVector4i r = (fg & mask).add16(bg & mask).srl16<1>();
+      const GSVector4i g = (fg.srl16<5>() & mask).add16(bg.srl16<5>() & mask).srl16<1>();
+      const GSVector4i b = (fg.srl16<10>() & mask).add16(bg.srl16<10>() & mask).srl16<1>();
+      GSVector4i::store<true>(&data.out[i * sizeof(u16)], r | g.sll16<5>() | b.sll16<10>());
+    }
+    Bench::ClobberMemory();
+  }
+}
+
+BENCHMARK(GSVector_DotProduct)
+{
+  // madd-based dot products, the core of the resampler, reverb and IDCT kernels.
+  TestData data;
+  state.SetBytesPerIteration(sizeof(data.vram) * 2);
+  const s16* samples = reinterpret_cast<const s16*>(data.vram.data());
+  while (state.KeepRunning())
+  {
+    GSVector4i acc = GSVector4i::zero();
+    for (u32 i = 0; i < NUM_PIXELS; i += 8)
+      acc = acc.add32(GSVector4i::load<true>(&samples[i]).madd_s16(GSVector4i::load<true>(&data.coefficients[i])));
+    Bench::DoNotOptimize(acc.addv_s32());
+  }
+}
+
+BENCHMARK(GSVector_ClampShuffle)
+{
+  TestData data;
+  state.SetBytesPerIteration(sizeof(data.vram));
+  const GSVector4i shuffle = GSVector4i::cxpr8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+  while (state.KeepRunning())
+  {
+    for (u32 i = 0; i < NUM_PIXELS; i += 8)
+    {
+      const GSVector4i v = GSVector4i::load<true>(&data.vram[i]);
+      const GSVector4i clamped = v.max_s16(GSVector4i::cxpr16(-128)).min_s16(GSVector4i::cxpr16(127));
+      GSVector4i::store<true>(&data.out[i * sizeof(u16)], clamped.shuffle8(shuffle));
+    }
+    Bench::ClobberMemory();
+  }
+}
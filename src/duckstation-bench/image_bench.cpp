@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "bench.h"
+
+#include "util/image.h"
+
+#include "common/error.h"
+
+#include "fmt/format.h"
+
+#include <random>
+
+// Screenshot-sized, with smooth gradients plus some noise so the compressors have work to do.
+static constexpr u32 IMAGE_WIDTH = 640;
+static constexpr u32 IMAGE_HEIGHT = 480;
+
+static Image GenerateImage(ImageFormat format)
+{
+  std::mt19937 rng(0x12345678);
+  Image image(IMAGE_WIDTH, IMAGE_HEIGHT, ImageFormat::RGBA8);
+  for (u32 y = 0; y < IMAGE_HEIGHT; y++)
+  {
+    u32* row = reinterpret_cast<u32*>(image.GetRowPixels(y));
+    for (u32 x = 0; x < IMAGE_WIDTH; x++)
+    {
+      const u32 noise = rng() & 0x0F;
+      row[x] = ((x * 255 / IMAGE_WIDTH) + noise) | (((y * 255 / IMAGE_HEIGHT) + noise) << 8) |
+               ((((x + y) * 127 / IMAGE_WIDTH) + noise) << 16) | 0xFF000000u;
+    }
+  }
+
+  if (format == ImageFormat::RGB5A1)
+  {
+    Image converted(IMAGE_WIDTH, IMAGE_HEIGHT, ImageFormat::RGB5A1);
+    for (u32 y = 0; y < IMAGE_HEIGHT; y++)
+    {
+      const u32* src = reinterpret_cast<const u32*>(image.GetRowPixels(y));
+      u16* dst = reinterpret_cast<u16*>(converted.GetRowPixels(y));
+      for (u32 x = 0; x < IMAGE_WIDTH; x++)
+      {
+        dst[x] = static_cast<u16>(((src[x] >> 3) & 0x1F) | (((src[x] >> 11) & 0x1F) << 5) |
+                                  (((src[x] >> 19) & 0x1F) << 10) | 0x8000);
+      }
+    }
+    return converted;
+  }
+
+  return image;
+}
+
+static void BenchmarkSave(Bench::State& state, const char* filename)
+{
+  const Image image = GenerateImage(ImageFormat::RGBA8);
+  state.SetBytesPerIteration(IMAGE_WIDTH * IMAGE_HEIGHT * sizeof(u32));
+  while (state.KeepRunning())
+  {
+    Error error;
+    const std::optional<DynamicHeapArray<u8>> data = image.SaveToBuffer(filename, Image::DEFAULT_SAVE_QUALITY, &error);
+    if (!data.has_value())
+    {
+      state.Skip(fmt::format("Failed to save {}: {}", filename, error.GetDescription()));
+      return;
+    }
+
+    Bench::DoNotOptimize(data->size());
+  }
+}
+
+BENCHMARK(Image_SavePNG)
+{
+  BenchmarkSave(state, "bench.png");
+}
+
+BENCHMARK(Image_SaveJPEG)
+{
+  BenchmarkSave(state, "bench.jpg");
+}
+
+BENCHMARK(Image_SaveWebP)
+{
+  BenchmarkSave(state, "bench.webp");
+}
+
+BENCHMARK(Image_ConvertRGB5A1ToRGBA8)
+{
+  const Image image = GenerateImage(ImageFormat::RGB5A1);
+  state.SetBytesPerIteration(IMAGE_WIDTH * IMAGE_HEIGHT * sizeof(u16));
+  while (state.KeepRunning())
+  {
+    std::optional<Image> converted = image.ConvertToRGBA8();
+    Bench::DoNotOptimize(converted.has_value());
+  }
+}
@@ -0,0 +1,167 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "bench.h"
+
+#include "common/bitutils.h"
+#include "common/gsvector.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+// The IDCT is file-local in core/mdec.cpp, so the same kernels are mirrored here, as in gsvector_idct_test.cpp.
+// Keep them in sync with MDEC::IDCT_New() when changing it.
+
+// A 320x240 frame is 300 macroblocks of six blocks each.
+static constexpr u32 NUM_BLOCKS = 300 * 6;
+
+namespace {
+struct MDECTestData
+{
+  alignas(VECTOR_ALIGNMENT) std::array<s16, 64> scale_table;
+  std::array<std::array<s16, 64>, NUM_BLOCKS> blocks;
+
+  MDECTestData()
+  {
+    std::mt19937 rng(0x12345678);
+    for (s16& v : scale_table)
+      v = static_cast<s16>(rng());
+
+    // Coefficients are stored with 4 bits of extra precision, clamped to -0x4000..0x3FFF.
+    for (std::array<s16, 64>& blk : blocks)
+    {
+      for (s16& v : blk)
+        v = static_cast<s16>(static_cast<s32>(rng() % 0x8000) - 0x4000);
+    }
+  }
+};
+} // namespace
+
+static s16 IDCTRow_Scalar(const s16* blk, const s16* idct_matrix)
+{
+  s32 sum0 = 0;
+  s32 sum1 = 0;
+  for (u32 i = 0; i < 4; i++)
+  {
+    sum0 = static_cast<s32>(static_cast<u32>(sum0) + static_cast<u32>(s32(blk[i]) * s32(idct_matrix[i])));
+    sum1 = static_cast<s32>(static_cast<u32>(sum1) + static_cast<u32>(s32(blk[i + 4]) * s32(idct_matrix[i + 4])));
+  }
+
+  return static_cast<s16>(((static_cast<s64>(sum0) + static_cast<s64>(sum1)) + 0x20000) >> 18);
+}
+
+static void IDCT_Scalar(s16* blk, const std::array<s16, 64>& scale_table)
+{
+  std::array<s16, 64> temp;
+  for (u32 x = 0; x < 8; x++)
+  {
+    for (u32 y = 0; y < 8; y++)
+      temp[y * 8 + x] = IDCTRow_Scalar(&blk[x * 8], &scale_table[y * 8]);
+  }
+  for (u32 x = 0; x < 8; x++)
+  {
+    for (u32 y = 0; y < 8; y++)
+    {
+      const s32 sum = IDCTRow_Scalar(&temp[x * 8], &scale_table[y * 8]);
+      blk[x * 8 + y] = static_cast<s16>(std::clamp(SignExtendN<9, s32>(sum), -128, 127));
+    }
+  }
+}
+
+ALWAYS_INLINE static GSVector4i IDCTRound(const GSVector4i a, const GSVector4i b)
+{
+  const GSVector4i frac_mask = GSVector4i::cxpr(0x3FFFF);
+  const GSVector4i frac = (a & frac_mask).add32(b & frac_mask).add32(GSVector4i::cxpr(0x20000)).sra32<18>();
+  return a.sra32<18>().add32(b.sra32<18>()).add32(frac);
+}
+
+ALWAYS_INLINE static GSVector4i IDCTRow_Vector(const GSVector4i row, const GSVector4i* matrix)
+{
+  const GSVector4i p0 = row.xxxx();
+  const GSVector4i p1 = row.yyyy();
+  const GSVector4i p2 = row.zzzz();
+  const GSVector4i p3 = row.wwww();
+  const GSVector4i lo = IDCTRound(p0.madd_s16(matrix[0]).add32(p1.madd_s16(matrix[1])),
+                                  p2.madd_s16(matrix[2]).add32(p3.madd_s16(matrix[3])));
+  const GSVector4i hi = IDCTRound(p0.madd_s16(matrix[4]).add32(p1.madd_s16(matrix[5])),
+                                  p2.madd_s16(matrix[6]).add32(p3.madd_s16(matrix[7])));
+  return lo.ps32(hi);
+}
+
+static void IDCT_Vector(s16* blk, const std::array<s16, 64>& scale_table)
+{
+  std::array<GSVector4i, 8> matrix;
+  for (u32 i = 0; i < 2; i++)
+  {
+    const GSVector4i m0 = GSVector4i::load<true>(&scale_table[(i * 4 + 0) * 8]);
+    const GSVector4i m1 = GSVector4i::load<true>(&scale_table[(i * 4 + 1) * 8]);
+    const GSVector4i m2 = GSVector4i::load<true>(&scale_table[(i * 4 + 2) * 8]);
+    const GSVector4i m3 = GSVector4i::load<true>(&scale_table[(i * 4 + 3) * 8]);
+    const GSVector4i t0 = m0.upl32(m1);
+    const GSVector4i t1 = m2.upl32(m3);
+    const GSVector4i t2 = m0.uph32(m1);
+    const GSVector4i t3 = m2.uph32(m3);
+    matrix[i * 4 + 0] = t0.upl64(t1);
+    matrix[i * 4 + 1] = t0.uph64(t1);
+    matrix[i * 4 + 2] = t2.upl64(t3);
+    matrix[i * 4 + 3] = t2.uph64(t3);
+  }
+
+  std::array<GSVector4i, 8> cols;
+  for (u32 x = 0; x < 8; x++)
+    cols[x] = IDCTRow_Vector(GSVector4i::load<false>(&blk[x * 8]), matrix.data());
+
+  const GSVector4i a0 = cols[0].upl16(cols[1]);
+  const GSVector4i a1 = cols[0].uph16(cols[1]);
+  const GSVector4i a2 = cols[2].upl16(cols[3]);
+  const GSVector4i a3 = cols[2].uph16(cols[3]);
+  const GSVector4i a4 = cols[4].upl16(cols[5]);
+  const GSVector4i a5 = cols[4].uph16(cols[5]);
+  const GSVector4i a6 = cols[6].upl16(cols[7]);
+  const GSVector4i a7 = cols[6].uph16(cols[7]);
+  const GSVector4i b0 = a0.upl32(a2);
+  const GSVector4i b1 = a0.uph32(a2);
+  const GSVector4i b2 = a1.upl32(a3);
+  const GSVector4i b3 = a1.uph32(a3);
+  const GSVector4i b4 = a4.upl32(a6);
+  const GSVector4i b5 = a4.uph32(a6);
+  const GSVector4i b6 = a5.upl32(a7);
+  const GSVector4i b7 = a5.uph32(a7);
+  const std::array<GSVector4i, 8> rows = {{b0.upl64(b4), b0.uph64(b4), b1.upl64(b5), b1.uph64(b5), b2.upl64(b6),
+                                          b2.uph64(b6), b3.upl64(b7), b3.uph64(b7)}};
+
+  for (u32 x = 0; x < 8; x++)
+  {
+    const GSVector4i row = IDCTRow_Vector(rows[x], matrix.data()).sll16<7>().sra16<7>();
+    GSVector4i::store<false>(&blk[x * 8], row.max_s16(GSVector4i::cxpr16(-128)).min_s16(GSVector4i::cxpr16(127)));
+  }
+}
+
+template<void (*IDCT)(s16*, const std::array<s16, 64>&)>
+static void BenchmarkIDCT(Bench::State& state)
+{
+  MDECTestData data;
+  std::array<s16, 64> blk;
+  state.SetBytesPerIteration(NUM_BLOCKS * sizeof(blk));
+  while (state.KeepRunning())
+  {
+    // The IDCT runs in place, so start from the same input every time.
+    for (const std::array<s16, 64>& src : data.blocks)
+    {
+      blk = src;
+      IDCT(blk.data(), data.scale_table);
+      Bench::DoNotOptimize(blk);
+    }
+  }
+}
+
+BENCHMARK(MDEC_IDCT_Scalar)
+{
+  BenchmarkIDCT<IDCT_Scalar>(state);
+}
+
+BENCHMARK(MDEC_IDCT_Vector)
+{
+  BenchmarkIDCT<IDCT_Vector>(state);
+}
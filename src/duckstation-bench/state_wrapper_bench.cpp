@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "bench.h"
+
+#include "util/state_wrapper.h"
+
+#include "common/heap_array.h"
+
+#include <array>
+#include <random>
+#include <vector>
+
+static constexpr u32 STATE_VERSION = 1;
+
+namespace {
+/// Roughly the shape of a save state: RAM, VRAM and SPU RAM, followed by a few thousand small fields.
+struct FakeSystemState
+{
+  static constexpr u32 NUM_SMALL_FIELDS = 4096;
+
+  DynamicHeapArray<u8> ram;
+  DynamicHeapArray<u8> vram;
+  DynamicHeapArray<u8> spu_ram;
+  std::vector<u32> small_fields;
+
+  FakeSystemState() : ram(2 * 1024 * 1024), vram(1024 * 1024), spu_ram(512 * 1024), small_fields(NUM_SMALL_FIELDS)
+  {
+    std::mt19937 rng(0x12345678);
+    for (DynamicHeapArray<u8>* block : {&ram, &vram, &spu_ram})
+    {
+      for (u8& v : *block)
+        v = static_cast<u8>(rng());
+    }
+    for (u32& v : small_fields)
+      v = static_cast<u32>(rng());
+  }
+
+  void DoState(StateWrapper& sw)
+  {
+    sw.DoBytes(ram.data(), ram.size());
+    sw.DoBytes(vram.data(), vram.size());
+    sw.DoBytes(spu_ram.data(), spu_ram.size());
+    for (u32& v : small_fields)
+      sw.Do(&v);
+  }
+
+  size_t GetSize() const { return ram.size() + vram.size() + spu_ram.size() + small_fields.size() * sizeof(u32); }
+};
+} // namespace
+
+BENCHMARK(StateWrapper_Write)
+{
+  FakeSystemState fs;
+  DynamicHeapArray<u8> buffer(fs.GetSize());
+  state.SetBytesPerIteration(fs.GetSize());
+  while (state.KeepRunning())
+  {
+    StateWrapper sw(buffer.span(), StateWrapper::Mode::Write, STATE_VERSION);
+    fs.DoState(sw);
+    Bench::DoNotOptimize(sw.GetPosition());
+  }
+}
+
+BENCHMARK(StateWrapper_Read)
+{
+  FakeSystemState fs;
+  DynamicHeapArray<u8> buffer(fs.GetSize());
+  {
+    StateWrapper sw(buffer.span(), StateWrapper::Mode::Write, STATE_VERSION);
+    fs.DoState(sw);
+  }
+
+  state.SetBytesPerIteration(fs.GetSize());
+  while (state.KeepRunning())
+  {
+    StateWrapper sw(buffer.cspan(), StateWrapper::Mode::Read, STATE_VERSION);
+    fs.DoState(sw);
+    Bench::DoNotOptimize(sw.GetPosition());
+  }
+}
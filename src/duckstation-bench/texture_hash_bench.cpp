@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "bench.h"
+
+#include "core/gpu_types.h"
+
+#ifndef XXH_STATIC_LINKING_ONLY
+#define XXH_STATIC_LINKING_ONLY
+#endif
+#include "xxhash.h"
+
+#include <array>
+#include <random>
+#include <vector>
+
+// Same scheme as GPUTextureCache::HashPage(), one hash per row segment and a hash of those, with the row hash cache
+// always missing. That's the cost of a page that was just written to.
+template<GPUTextureMode mode>
+static void BenchmarkHashPage(Bench::State& state)
+{
+  std::mt19937 rng(0x12345678);
+  std::vector<u16> vram(VRAM_WIDTH * VRAM_HEIGHT);
+  for (u16& v : vram)
+    v = static_cast<u16>(rng());
+
+  const u32 segments_per_row = 1u << static_cast<u32>(mode);
+  std::array<u64, VRAM_PAGE_HEIGHT * 4> hashes;
+  state.SetBytesPerIteration(VRAM_PAGE_HEIGHT * VRAM_PAGE_WIDTH * segments_per_row * sizeof(u16));
+  while (state.KeepRunning())
+  {
+    u64* hashes_ptr = hashes.data();
+    for (u32 y = 0; y < VRAM_PAGE_HEIGHT; y++)
+    {
+      for (u32 i = 0; i < segments_per_row; i++)
+        *(hashes_ptr++) = XXH3_64bits(&vram[y * VRAM_WIDTH + i * VRAM_PAGE_WIDTH], VRAM_PAGE_WIDTH * sizeof(u16));
+    }
+
+    Bench::DoNotOptimize(
+      XXH3_64bits(hashes.data(), sizeof(u64) * static_cast<size_t>(hashes_ptr - hashes.data())));
+  }
+}
+
+BENCHMARK(TextureCache_HashPage4Bit)
+{
+  BenchmarkHashPage<GPUTextureMode::Palette4Bit>(state);
+}
+
+BENCHMARK(TextureCache_HashPage8Bit)
+{
+  BenchmarkHashPage<GPUTextureMode::Palette8Bit>(state);
+}
+
+BENCHMARK(TextureCache_HashPage16Bit)
+{
+  BenchmarkHashPage<GPUTextureMode::Direct16Bit>(state);
+}
@@ -419,6 +419,13 @@ std::optional<DynamicHeapArray<u8>> Host::ReadResourceFile(std::string_view file
   return FileSystem::ReadBinaryFile(path.c_str(), error);
 }
 
+std::optional<FileSystem::MappedFile> Host::MapResourceFile(std::string_view filename, bool allow_override,
+                                                            Error* error)
+{
+  const std::string path = MiniHost::GetResourcePath(filename, allow_override);
+  return FileSystem::MapBinaryFile(path.c_str(), error);
+}
+
 std::optional<std::string> Host::ReadResourceFileToString(std::string_view filename, bool allow_override, Error* error)
 {
   const std::string path = MiniHost::GetResourcePath(filename, allow_override);
@@ -998,6 +1005,7 @@ void MiniHost::CoreThreadEntryPoint()
     CoreThreadMainLoop();
 
     Host::CancelGameListRefresh();
+    GameList::StopWatchingDirectories();
   }
   else
   {
@@ -1882,6 +1890,7 @@ int main(int argc, char* argv[])
   System::ProcessShutdown();
 
   // Ensure log is flushed.
+  Log::SetAsyncOutputParams(false);
   Log::SetFileOutputParams(false, nullptr);
 
   if (s_state.base_settings_interface.IsDirty())
@@ -266,6 +266,10 @@ void AdvancedSettingsWidget::addTweakOptions()
                        &Settings::GetSaveStateCompressionModeDisplayName,
                        static_cast<u32>(SaveStateCompressionMode::Count),
                        Settings::DEFAULT_SAVE_STATE_COMPRESSION_MODE);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Uncompressed Resume States"), "Main",
+                        "UncompressedResumeStates", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Audio-Only PSF Playback"), "Main", "PSFAudioOnly",
+                        false);
 
   if (m_dialog->isPerGameSettings())
   {
@@ -287,15 +291,59 @@ void AdvancedSettingsWidget::addTweakOptions()
                          Settings::DEFAULT_GPU_FIFO_SIZE, tr(" words"));
   addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("GPU Max Runahead"), "Hacks", "GPUMaxRunAhead", 0, 1000,
                          Settings::DEFAULT_GPU_MAX_RUN_AHEAD, tr(" cycles"));
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable GPU Deferred Batch Submission"), "GPU",
+                        "DeferredBatchSubmission", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Speculative VRAM Readbacks"), "GPU",
+                        "SpeculativeVRAMReadbacks", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Skip Rendering When Fast Forwarding"), "GPU",
+                        "FastForwardRenderSkip", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Export Frames To Shared Memory"), "Display",
+                        "SharedMemoryFrameExport", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Precompile Only Used GPU Pipelines"), "GPU",
+                        "PrecompileUsedPipelines", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Cull Occluded Polygons (PGXP Depth Buffer)"), "GPU",
+                        "PGXPDepthCulling", false);
+  addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Software Renderer Threads"), "GPU",
+                         "SoftwareRendererThreads", 0, 16, 0);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Dynamic Resolution Scaling"), "GPU",
+                        "DynamicResolutionScale", false);
+  addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Minimum Dynamic Resolution Scale"), "GPU",
+                         "DynamicResolutionScaleMinimum", 1, 16, 1);
+  addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Skip Audio Output Above Speed (%)"), "Audio",
+                         "SkipOutputSpeed", 0, 1000, 0);
 
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Memory Exceptions"), "CPU",
                         "RecompilerMemoryExceptions", false);
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Block Linking"), "CPU",
                         "RecompilerBlockLinking", true);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Block Cache"), "CPU",
+                        "RecompilerBlockCache", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Trace Formation"), "CPU",
+                        "RecompilerTraceFormation", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Block Profiling"), "CPU",
+                        "RecompilerBlockProfiling", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Timing Event Statistics"), "Debug",
+                        "TimingEventStatistics", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Sub-Page Invalidation"), "CPU",
+                        "RecompilerSubPageInvalidation", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Loop Register Cache"), "CPU",
+                        "RecompilerLoopRegisterCache", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Code Buffer Eviction"), "CPU",
+                        "RecompilerCodeBufferEviction", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Block Optimization"), "CPU",
+                        "RecompilerBlockOptimization", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Idle Loop Skipping"), "CPU", "IdleLoopSkipping",
+                        false);
+  addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Recompiler Compile Budget"), "CPU",
+                         "RecompilerCompileBudget", 0, 65535, 0, tr(" us"));
   addChoiceTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Fast Memory Access"), "CPU",
                        "FastmemMode", Settings::ParseCPUFastmemMode, Settings::GetCPUFastmemModeName,
                        Settings::GetCPUFastmemModeDisplayName, static_cast<u32>(CPUFastmemMode::Count),
                        Settings::DEFAULT_CPU_FASTMEM_MODE);
+  addChoiceTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Thread Placement"), "CPU", "ThreadPlacement",
+                       Settings::ParseThreadPlacementMode, Settings::GetThreadPlacementModeName,
+                       Settings::GetThreadPlacementModeDisplayName, static_cast<u32>(ThreadPlacementMode::Count),
+                       Settings::DEFAULT_THREAD_PLACEMENT_MODE);
 
   addChoiceTweakOption(m_dialog, m_ui.tweakOptionTable, tr("CD-ROM Mechacon Version"), "CDROM", "MechaconVersion",
                        Settings::ParseCDROMMechVersionName, Settings::GetCDROMMechVersionName,
@@ -303,6 +351,9 @@ void AdvancedSettingsWidget::addTweakOptions()
                        Settings::DEFAULT_CDROM_MECHACON_VERSION);
   addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("CD-ROM Readahead Sectors"), "CDROM", "ReadaheadSectors",
                          0, 32, Settings::DEFAULT_CDROM_READAHEAD_SECTORS, tr(" sectors"));
+  addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("CD-ROM Decompression Cache Size"), "CDROM",
+                         "DecompressionCacheSize", 0, 1024, Settings::DEFAULT_CDROM_DECOMPRESSION_CACHE_SIZE,
+                         tr(" MB"));
   addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("CD-ROM Max Read Speedup Cycles"), "CDROM",
                          "MaxReadSpeedupCycles", 1, 1000000, Settings::DEFAULT_CDROM_MAX_READ_SPEEDUP_CYCLES,
                          tr(" cycles"));
@@ -313,8 +364,12 @@ void AdvancedSettingsWidget::addTweakOptions()
                         "DisableSpeedupOnMDEC", false);
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("CD-ROM Region Check"), "CDROM", "RegionCheck", false);
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("CD-ROM SubQ Skew"), "CDROM", "SubQSkew", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("CD-ROM Compress Preloaded Image"), "CDROM",
+                        "LoadImageToRAMCompressed", false);
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Allow Booting Without SBI File"), "CDROM",
                         "AllowBootingWithoutSBIFile", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Decode MDEC Macroblocks On Worker Thread"), "Hacks",
+                        "MDECUseThread", false);
 
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable GDB Server"), "Debug", "EnableGDBServer", false);
   addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("GDB Server Port"), "Debug", "GDBServerPort", 1, 65535,
@@ -340,6 +395,8 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false); // Load Devices From Save States
     setChoiceTweakOption(m_ui.tweakOptionTable, i++,
                          Settings::DEFAULT_SAVE_STATE_COMPRESSION_MODE); // Save State Compression
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false); // Uncompressed Resume States
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false); // Audio-Only PSF Playback
     setIntRangeTweakOption(m_ui.tweakOptionTable, i++,
                            static_cast<int>(Settings::DEFAULT_DMA_MAX_SLICE_TICKS)); // DMA max slice ticks
     setIntRangeTweakOption(m_ui.tweakOptionTable, i++,
@@ -348,14 +405,38 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
                            static_cast<int>(Settings::DEFAULT_GPU_FIFO_SIZE)); // GPU FIFO size
     setIntRangeTweakOption(m_ui.tweakOptionTable, i++,
                            static_cast<int>(Settings::DEFAULT_GPU_MAX_RUN_AHEAD)); // GPU max runahead
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // GPU deferred batch submission
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Speculative VRAM readbacks
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Fast forward render skip
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Shared memory frame export
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Precompile used pipelines
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // PGXP depth culling
+    setIntRangeTweakOption(m_ui.tweakOptionTable, i++, 0);                         // Software renderer threads
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Dynamic resolution scaling
+    setIntRangeTweakOption(m_ui.tweakOptionTable, i++, 1);                         // Minimum dynamic resolution
+    setIntRangeTweakOption(m_ui.tweakOptionTable, i++, 0);                         // Skip audio output speed
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Recompiler memory exceptions
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, true);                       // Recompiler block linking
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Recompiler block cache
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Recompiler trace formation
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Recompiler block profiling
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Timing event statistics
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Recompiler sub-page invalidation
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Recompiler loop register cache
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Recompiler code buffer eviction
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Recompiler block optimization
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Idle loop skipping
+    setIntRangeTweakOption(m_ui.tweakOptionTable, i++, 0);                         // Recompiler compile budget
     setChoiceTweakOption(m_ui.tweakOptionTable, i++,
                          Settings::DEFAULT_CPU_FASTMEM_MODE); // Recompiler fastmem mode
+    setChoiceTweakOption(m_ui.tweakOptionTable, i++,
+                         Settings::DEFAULT_THREAD_PLACEMENT_MODE); // Thread placement
     setChoiceTweakOption(m_ui.tweakOptionTable, i++,
                          Settings::DEFAULT_CDROM_MECHACON_VERSION); // CDROM Mechacon Version
     setIntRangeTweakOption(m_ui.tweakOptionTable, i++,
                            Settings::DEFAULT_CDROM_READAHEAD_SECTORS); // CD-ROM Readahead Sectors
+    setIntRangeTweakOption(m_ui.tweakOptionTable, i++,
+                           Settings::DEFAULT_CDROM_DECOMPRESSION_CACHE_SIZE); // CD-ROM Decompression Cache Size
     setIntRangeTweakOption(m_ui.tweakOptionTable, i++,
                            Settings::DEFAULT_CDROM_MAX_READ_SPEEDUP_CYCLES); // CD-ROM Max Speedup Read Cycles
     setIntRangeTweakOption(m_ui.tweakOptionTable, i++,
@@ -363,7 +444,9 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                // CDROM Disable Speedup on MDEC
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                // CDROM Region Check
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                // CDROM SubQ Skew
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                // CDROM Compress Preloaded Image
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                // Allow booting without SBI file
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                // MDEC decode thread
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                // Enable GDB Server
     setIntRangeTweakOption(m_ui.tweakOptionTable, i++, Settings::DEFAULT_GDB_SERVER_PORT); // GDB Server Port
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                              // Export Shared Memory
@@ -381,6 +464,8 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
   sif->DeleteValue("Main", "LoadDevicesFromSaveStates");
   sif->DeleteValue("Main", "PauseOnStart");
   sif->DeleteValue("Main", "CompressSaveStates");
+  sif->DeleteValue("Main", "UncompressedResumeStates");
+  sif->DeleteValue("Main", "PSFAudioOnly");
   sif->DeleteValue("Display", "ActiveStartOffset");
   sif->DeleteValue("Display", "ActiveEndOffset");
   sif->DeleteValue("Display", "LineStartOffset");
@@ -389,18 +474,42 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
   sif->DeleteValue("Hacks", "DMAHaltTicks");
   sif->DeleteValue("Hacks", "GPUFIFOSize");
   sif->DeleteValue("Hacks", "GPUMaxRunAhead");
+  sif->DeleteValue("GPU", "DeferredBatchSubmission");
+  sif->DeleteValue("GPU", "SpeculativeVRAMReadbacks");
+  sif->DeleteValue("GPU", "FastForwardRenderSkip");
+  sif->DeleteValue("Display", "SharedMemoryFrameExport");
+  sif->DeleteValue("GPU", "PrecompileUsedPipelines");
+  sif->DeleteValue("GPU", "PGXPDepthCulling");
+  sif->DeleteValue("GPU", "SoftwareRendererThreads");
+  sif->DeleteValue("GPU", "DynamicResolutionScale");
+  sif->DeleteValue("GPU", "DynamicResolutionScaleMinimum");
+  sif->DeleteValue("Audio", "SkipOutputSpeed");
   sif->DeleteValue("Hacks", "ExportSharedMemory");
   sif->DeleteValue("CPU", "RecompilerMemoryExceptions");
   sif->DeleteValue("CPU", "RecompilerBlockLinking");
+  sif->DeleteValue("CPU", "RecompilerBlockCache");
+  sif->DeleteValue("CPU", "RecompilerTraceFormation");
+  sif->DeleteValue("CPU", "RecompilerBlockProfiling");
+  sif->DeleteValue("Debug", "TimingEventStatistics");
+  sif->DeleteValue("CPU", "RecompilerSubPageInvalidation");
+  sif->DeleteValue("CPU", "RecompilerLoopRegisterCache");
+  sif->DeleteValue("CPU", "RecompilerCodeBufferEviction");
+  sif->DeleteValue("CPU", "RecompilerBlockOptimization");
+  sif->DeleteValue("CPU", "IdleLoopSkipping");
+  sif->DeleteValue("CPU", "RecompilerCompileBudget");
   sif->DeleteValue("CPU", "FastmemMode");
+  sif->DeleteValue("CPU", "ThreadPlacement");
   sif->DeleteValue("CDROM", "MechaconVersion");
   sif->DeleteValue("CDROM", "ReadaheadSectors");
+  sif->DeleteValue("CDROM", "DecompressionCacheSize");
   sif->DeleteValue("CDROM", "MaxReadSpeedupCycles");
   sif->DeleteValue("CDROM", "MaxSeekSpeedupCycles");
   sif->DeleteValue("CDROM", "DisableSpeedupOnMDEC");
   sif->DeleteValue("CDROM", "RegionCheck");
   sif->DeleteValue("CDROM", "SubQSkew");
+  sif->DeleteValue("CDROM", "LoadImageToRAMCompressed");
   sif->DeleteValue("CDROM", "AllowBootingWithoutSBIFile");
+  sif->DeleteValue("Hacks", "MDECUseThread");
   sif->DeleteValue("Debug", "EnableGDBServer");
   sif->DeleteValue("Debug", "GDBServerPort");
   sif->DeleteValue("SIO", "RedirectToTTY");
@@ -16,6 +16,8 @@
 
 #include "moc_audiosettingswidget.cpp"
 
+static constexpr const int OUTPUT_SAMPLE_RATE_VALUES[] = {0, 48000, 88200, 96000, 192000};
+
 AudioSettingsWidget::AudioSettingsWidget(SettingsWindow* dialog, QWidget* parent) : QWidget(parent), m_dialog(dialog)
 {
   SettingsInterface* sif = dialog->getSettingsInterface();
@@ -36,6 +38,11 @@ AudioSettingsWidget::AudioSettingsWidget(SettingsWindow* dialog, QWidget* parent
                                               AudioStreamParameters::DEFAULT_OUTPUT_LATENCY_MS);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.outputLatencyMinimal, "Audio", "OutputLatencyMinimal",
                                                AudioStreamParameters::DEFAULT_OUTPUT_LATENCY_MINIMAL);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.lowLatency, "Audio", "LowLatency",
+                                               AudioStreamParameters::DEFAULT_LOW_LATENCY);
+  SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.outputSampleRate, "Audio", "OutputSampleRate",
+                                              AudioStreamParameters::DEFAULT_OUTPUT_SAMPLE_RATE,
+                                              OUTPUT_SAMPLE_RATE_VALUES);
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.sequenceLength, "Audio", "StretchSequenceLengthMS",
                                               AudioStreamParameters::DEFAULT_STRETCH_SEQUENCE_LENGTH, 0);
   QtUtils::BindLabelToSlider(m_ui.sequenceLength, m_ui.sequenceLengthLabel, 1.0f, tr("%1 ms"));
@@ -107,6 +114,17 @@ AudioSettingsWidget::AudioSettingsWidget(SettingsWindow* dialog, QWidget* parent
        "played through speakers."));
   dialog->registerWidgetHelp(m_ui.outputLatencyMinimal, tr("Minimal Output Latency"), tr("Unchecked"),
                              tr("When enabled, the minimum supported output latency will be used for the host API."));
+  dialog->registerWidgetHelp(
+    m_ui.lowLatency, tr("Low Latency Mode"), tr("Unchecked"),
+    tr("Keeps only as much audio buffered as the host is currently requesting at a time, adjusting the playback rate "
+       "very slightly to stay on target. The buffer size becomes the upper limit, and buffering is increased "
+       "temporarily if the audio runs out. Also uses the minimum output latency. When not running at 100% speed, the "
+       "selected stretch mode is used instead."));
+  dialog->registerWidgetHelp(
+    m_ui.outputSampleRate, tr("Output Sample Rate"), tr("Match Emulation (44100 Hz)"),
+    tr("Opens the audio device at this rate, and converts the output with a high quality resampler. Use this when "
+       "the device runs at a different rate to the console, such as 48000 Hz, instead of relying on the audio "
+       "backend or operating system to convert it. Has no effect on the selected stretch mode."));
   dialog->registerWidgetHelp(m_ui.volume, tr("Output Volume"), "100%",
                              tr("Controls the volume of the audio played on the host."));
   dialog->registerWidgetHelp(m_ui.fastForwardVolume, tr("Fast Forward Volume"), "100%",
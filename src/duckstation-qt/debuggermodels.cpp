@@ -100,16 +100,26 @@ QVariant DebuggerRegistersModel::headerData(int section, Qt::Orientation orienta
 
 void DebuggerRegistersModel::updateValues()
 {
-  beginResetModel();
-
   for (u32 i = 0; i < CPU::NUM_DEBUGGER_REGISTER_LIST_ENTRIES; i++)
-    m_reg_values[i] = *CPU::g_debugger_register_list[i].value_ptr;
+  {
+    const u32 value = *CPU::g_debugger_register_list[i].value_ptr;
+    if (value == m_reg_values[i])
+      continue;
 
-  endResetModel();
+    m_reg_values[i] = value;
+    emit dataChanged(index(static_cast<int>(i), 1), index(static_cast<int>(i), 1));
+  }
 }
 
 void DebuggerRegistersModel::saveCurrentValues()
 {
+  // clear the changed highlight
+  for (u32 i = 0; i < CPU::NUM_DEBUGGER_REGISTER_LIST_ENTRIES; i++)
+  {
+    if (m_reg_values[i] != m_old_reg_values[i])
+      emit dataChanged(index(static_cast<int>(i), 1), index(static_cast<int>(i), 1), {Qt::ForegroundRole});
+  }
+
   m_old_reg_values = m_reg_values;
 }
 
@@ -174,8 +184,8 @@ QVariant DebuggerStackModel::headerData(int section, Qt::Orientation orientation
 
 void DebuggerStackModel::invalidateView()
 {
-  beginResetModel();
-  endResetModel();
+  // The row count is fixed, so there's no need to reset the view's layout.
+  emit dataChanged(index(0, 0), index(rowCount() - 1, 1), {Qt::DisplayRole});
 }
 
 DebuggerAddBreakpointDialog::DebuggerAddBreakpointDialog(QWidget* parent /*= nullptr*/) : QDialog(parent)
@@ -76,7 +76,7 @@ void DebuggerWindow::reportMessage(const QString& message)
 
 void DebuggerWindow::timerRefresh()
 {
-  m_ui.memoryView->forceRefresh();
+  m_ui.memoryView->refreshChangedRows();
 }
 
 void DebuggerWindow::refreshAll()
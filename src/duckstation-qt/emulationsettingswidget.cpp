@@ -29,8 +29,12 @@ EmulationSettingsWidget::EmulationSettingsWidget(SettingsWindow* dialog, QWidget
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.rewindEnable, "Main", "RewindEnable", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.useSoftwareRendererForMemoryStates, "GPU",
                                                "UseSoftwareRendererForMemoryStates", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.nativeResolutionMemoryStates, "GPU",
+                                               "NativeResolutionMemoryStates", false);
   SettingWidgetBinder::BindWidgetToFloatSetting(sif, m_ui.rewindSaveFrequency, "Main", "RewindFrequency", 10.0f);
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.rewindSaveSlots, "Main", "RewindSaveSlots", 10);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.rewindCompressStates, "Main", "RewindCompressStates", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.rewindTieredStates, "Main", "RewindTieredStates", false);
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.runaheadFrames, "Main", "RunaheadFrameCount", 0);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.runaheadForAnalogInput, "Main", "RunaheadForAnalogInput",
                                                false);
@@ -89,10 +93,14 @@ EmulationSettingsWidget::EmulationSettingsWidget(SettingsWindow* dialog, QWidget
   connect(m_ui.rewindEnable, &QCheckBox::checkStateChanged, this, &EmulationSettingsWidget::updateRewind);
   connect(m_ui.useSoftwareRendererForMemoryStates, &QCheckBox::checkStateChanged, this,
           &EmulationSettingsWidget::updateRewind);
+  connect(m_ui.nativeResolutionMemoryStates, &QCheckBox::checkStateChanged, this,
+          &EmulationSettingsWidget::updateRewind);
   connect(m_ui.rewindSaveFrequency, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this,
           &EmulationSettingsWidget::updateRewind);
   connect(m_ui.rewindSaveSlots, QOverload<int>::of(&QSpinBox::valueChanged), this,
           &EmulationSettingsWidget::updateRewind);
+  connect(m_ui.rewindCompressStates, &QCheckBox::checkStateChanged, this, &EmulationSettingsWidget::updateRewind);
+  connect(m_ui.rewindTieredStates, &QCheckBox::checkStateChanged, this, &EmulationSettingsWidget::updateRewind);
   connect(m_ui.runaheadFrames, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
           &EmulationSettingsWidget::updateRewind);
 
@@ -150,6 +158,18 @@ EmulationSettingsWidget::EmulationSettingsWidget(SettingsWindow* dialog, QWidget
                              tr("Uses the software renderer when creating rewind states to prevent additional VRAM "
                                 "usage. Especially useful when upscaling, as this will significantly reduce the system "
                                 "requirements for rewinding."));
+  dialog->registerWidgetHelp(m_ui.nativeResolutionMemoryStates, tr("Save VRAM at Native Resolution"),
+                             tr("Unchecked"),
+                             tr("Keeps a native resolution copy of VRAM in system memory for each rewind state, "
+                                "instead of a texture at the upscaled resolution. Upscaled detail is lost after "
+                                "rewinding until the game redraws it, but rewinding no longer needs extra VRAM."));
+  dialog->registerWidgetHelp(m_ui.rewindCompressStates, tr("Compress Rewind States"), tr("Unchecked"),
+                             tr("Stores rewind states as differences from the next state, allowing many more saves in "
+                                "the same amount of memory. Rewinding and saving states takes slightly longer."));
+  dialog->registerWidgetHelp(m_ui.rewindTieredStates, tr("Tiered Rewind History"), tr("Unchecked"),
+                             tr("Keeps half of the buffer at the save frequency, and thins out older saves so they are "
+                                "further apart, allowing rewinding much further back in the same amount of memory. "
+                                "Not available with compressed rewind states."));
 
   dialog->registerWidgetHelp(
     m_ui.runaheadFrames, tr("Runahead"), tr("Disabled"),
@@ -256,6 +276,11 @@ void EmulationSettingsWidget::updateRewind()
   m_ui.rewindEnable->setEnabled(!runahead_enabled);
   m_ui.runaheadForAnalogInput->setEnabled(runahead_enabled);
   m_ui.useSoftwareRendererForMemoryStates->setEnabled(rewind_active);
+  m_ui.rewindCompressStates->setEnabled(rewind_active);
+  m_ui.rewindTieredStates->setEnabled(rewind_active &&
+                                      !m_dialog->getEffectiveBoolValue("Main", "RewindCompressStates", false));
+  m_ui.nativeResolutionMemoryStates->setEnabled(
+    rewind_active && !m_dialog->getEffectiveBoolValue("GPU", "UseSoftwareRendererForMemoryStates", false));
 
   if (rewind_active)
   {
@@ -263,15 +288,20 @@ void EmulationSettingsWidget::updateRewind()
     const u32 multisamples = m_dialog->getEffectiveIntValue("GPU", "Multisamples", 1);
     const bool use_software_renderer =
       m_dialog->getEffectiveBoolValue("GPU", "UseSoftwareRendererForMemoryStates", false);
+    const bool native_resolution_vram = m_dialog->getEffectiveBoolValue("GPU", "NativeResolutionMemoryStates", false);
     const bool enable_8mb_ram = m_dialog->getEffectiveBoolValue("Console", "Enable8MBRAM", false);
+    const bool compress_states = m_dialog->getEffectiveBoolValue("Main", "RewindCompressStates", false);
+    const bool tiered_states =
+      !compress_states && m_dialog->getEffectiveBoolValue("Main", "RewindTieredStates", false);
     const u32 frames = static_cast<u32>(m_ui.rewindSaveSlots->value());
     const float frequency = static_cast<float>(m_ui.rewindSaveFrequency->value());
-    const float duration =
-      ((frequency <= std::numeric_limits<float>::epsilon()) ? (1.0f / 60.0f) : frequency) * static_cast<float>(frames);
+    const float duration = ((frequency <= std::numeric_limits<float>::epsilon()) ? (1.0f / 60.0f) : frequency) *
+                           static_cast<float>(System::GetRewindSaveIntervalCount(frames, tiered_states));
 
     u64 ram_usage, vram_usage;
-    System::CalculateRewindMemoryUsage(frames, resolution_scale, multisamples, use_software_renderer, enable_8mb_ram,
-                                       &ram_usage, &vram_usage);
+    System::CalculateRewindMemoryUsage(frames, resolution_scale, multisamples, use_software_renderer,
+                                       native_resolution_vram, enable_8mb_ram, compress_states, &ram_usage,
+                                       &vram_usage);
 
     m_ui.rewindSummary->setText(
       (vram_usage > 0) ?
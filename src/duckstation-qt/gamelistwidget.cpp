@@ -22,11 +22,13 @@
 
 #include "common/assert.h"
 #include "common/error.h"
+#include "common/fast_hash.h"
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/path.h"
 #include "common/string_util.h"
 
+#include <QtCore/QBuffer>
 #include <QtCore/QDate>
 #include <QtCore/QDateTime>
 #include <QtCore/QSortFilterProxyModel>
@@ -41,6 +43,7 @@
 #include <QtWidgets/QToolTip>
 #include <algorithm>
 #include <limits>
+#include <unordered_set>
 
 #include "moc_gamelistwidget.cpp"
 
@@ -65,6 +68,8 @@ static constexpr int COVER_ART_SIZE = 512;
 static constexpr int COVER_ART_SPACING = 32;
 static constexpr int MIN_COVER_CACHE_SIZE = 256;
 static constexpr int MIN_COVER_CACHE_ROW_BUFFER = 4;
+static constexpr int COVER_THUMBNAIL_QUALITY = 90;
+static constexpr const char* COVER_THUMBNAIL_DIRECTORY = "cover_thumbnails";
 
 static constexpr QSize FLAG_PIXMAP_SIZE(30, 20);
 static constexpr QSize ACHIEVEMENT_PIXMAP_SIZE(16, 16);
@@ -172,6 +177,44 @@ static void resizeAndPadImage(QImage* image, const QSize& expected_size, bool fi
   *image = std::move(padded_image);
 }
 
+static std::string getCoverThumbnailPath(const std::string& cover_path, const QSize& size)
+{
+  // replacing the cover changes its timestamp, so stale thumbnails are never picked up
+  FILESYSTEM_STAT_DATA sd;
+  if (!FileSystem::StatFile(cover_path.c_str(), &sd))
+    return {};
+
+  const SmallString key = SmallString::from_format("{}|{}|{}|{}x{}", cover_path, sd.ModificationTime, sd.Size,
+                                                   size.width(), size.height());
+  const u64 hash = FastHash::Hash64(key.data(), key.length());
+  return fmt::format("{}" FS_OSPATH_SEPARATOR_STR "{}" FS_OSPATH_SEPARATOR_STR "{:016x}.jpg", EmuFolders::Cache,
+                     COVER_THUMBNAIL_DIRECTORY, hash);
+}
+
+static void saveCoverThumbnail(const std::string& thumbnail_path, const QImage& image)
+{
+  // only opaque covers, jpeg would lose the alpha channel
+  if (image.hasAlphaChannel())
+    return;
+
+  QByteArray data;
+  QBuffer buffer(&data);
+  if (!buffer.open(QIODevice::WriteOnly) || !image.save(&buffer, "JPG", COVER_THUMBNAIL_QUALITY))
+  {
+    ERROR_LOG("Failed to encode cover thumbnail for '{}'", Path::GetFileName(thumbnail_path));
+    return;
+  }
+
+  Error error;
+  if (!FileSystem::EnsureDirectoryExists(Path::Combine(EmuFolders::Cache, COVER_THUMBNAIL_DIRECTORY).c_str(), false,
+                                         &error) ||
+      !FileSystem::WriteAtomicRenamedFile(
+        thumbnail_path, std::span<const u8>(reinterpret_cast<const u8*>(data.constData()), data.size()), &error))
+  {
+    ERROR_LOG("Failed to write cover thumbnail '{}': {}", Path::GetFileName(thumbnail_path), error.GetDescription());
+  }
+}
+
 static void fastResizePixmap(QPixmap& pm, const QSize& expected_size)
 {
   if (pm.size() == expected_size)
@@ -472,11 +515,21 @@ void GameListModel::loadOrGenerateCover(QImage& image, const QImage& placeholder
   const std::string cover_path = GameList::GetCoverImagePath(path, serial, save_title, is_custom_title);
   if (!cover_path.empty())
   {
+    // decoding and scaling down the full size cover is most of the cost, so the result is kept on disk
+    const std::string thumbnail_path = getCoverThumbnailPath(cover_path, size);
+    if (!thumbnail_path.empty() && image.load(QString::fromStdString(thumbnail_path)))
+    {
+      image.setDevicePixelRatio(dpr);
+      return;
+    }
+
     image.load(QString::fromStdString(cover_path));
     if (!image.isNull())
     {
       image.setDevicePixelRatio(dpr);
       resizeImage(&image, size);
+      if (!thumbnail_path.empty())
+        saveCoverThumbnail(thumbnail_path, image);
     }
   }
 
@@ -500,6 +553,8 @@ void GameListModel::coverLoaded(const std::string& path, const QImage& image, fl
 
 void GameListModel::rowsChanged(const QList<int>& rows)
 {
+  invalidateTitleSortRanks();
+
   QList<int> roles_changed{Qt::DisplayRole, Qt::ToolTipRole};
   if (m_show_game_icons)
     roles_changed.append(Qt::DecorationRole);
@@ -536,6 +591,8 @@ QList<int> GameListModel::getRolesToInvalidate(int column)
 
 void GameListModel::invalidateColumn(int column, bool invalidate_cache /* = true */)
 {
+  invalidateTitleSortRanks();
+
   if (invalidate_cache)
   {
     if (column == Column_Icon)
@@ -560,6 +617,8 @@ void GameListModel::invalidateColumn(int column, bool invalidate_cache /* = true
 
 void GameListModel::invalidateColumnForPath(const std::string& path, int column, bool invalidate_cache /* = true */)
 {
+  invalidateTitleSortRanks();
+
   // if we're changing the title, the cover could change
   if (column == Column_Title)
     invalidateColumnForPath(path, Column_Cover, invalidate_cache);
@@ -1070,6 +1129,7 @@ void GameListModel::takeGameList()
 {
   const auto lock = GameList::GetLock();
   m_taken_entries = GameList::TakeEntryList();
+  invalidateTitleSortRanks();
 
   // If it's empty (e.g. first boot), don't use it.
   if (m_taken_entries->empty())
@@ -1081,6 +1141,7 @@ void GameListModel::refresh()
   beginResetModel();
 
   m_taken_entries.reset();
+  invalidateTitleSortRanks();
 
   // Invalidate memcard LRU cache, forcing a re-query of the memcard timestamps.
   m_icon_pixmap_cache.Clear();
@@ -1088,7 +1149,172 @@ void GameListModel::refresh()
   endResetModel();
 }
 
-bool GameListModel::titlesLessThan(const GameList::Entry* left, const GameList::Entry* right) const
+void GameListModel::applyRefreshedGameList(int scanned_row_count)
+{
+  // Resetting the model throws away the sort and filter mappings, and with a large library rebuilding them stalls
+  // the UI for seconds. Most refreshes only add, remove or touch a handful of games, so tell the views about that.
+  const bool updated = m_taken_entries.has_value() ? mergeTakenGameList() : updateScannedRows(scanned_row_count);
+  if (!updated)
+  {
+    refresh();
+    return;
+  }
+
+  invalidateTitleSortRanks();
+
+  // Invalidate memcard LRU cache, forcing a re-query of the memcard timestamps.
+  m_icon_pixmap_cache.Clear();
+}
+
+bool GameListModel::updateScannedRows(int scanned_row_count)
+{
+  // Rows were inserted as the scan found them, but disc sets are only merged at the end, which changes the earlier
+  // entries as well. If entries went away, the rows we've reported are no longer valid.
+  const auto lock = GameList::GetLock();
+  const int count = static_cast<int>(GameList::GetEntryCount());
+  if (count < scanned_row_count)
+    return false;
+
+  if (scanned_row_count > 0)
+    emit dataChanged(index(0, 0), index(scanned_row_count - 1, Column_Count - 1));
+
+  if (count > scanned_row_count)
+  {
+    beginInsertRows(QModelIndex(), scanned_row_count, count - 1);
+    endInsertRows();
+  }
+
+  return true;
+}
+
+bool GameListModel::mergeTakenGameList()
+{
+  // Beyond this many separate insertions/removals, shuffling the taken list around costs more than a reset.
+  static constexpr size_t MAX_ROW_CHANGES = 256;
+
+  struct RowChange
+  {
+    bool insert;
+    u32 row;
+    u32 count;
+    u32 new_index;
+  };
+
+  const auto lock = GameList::GetLock();
+  const std::span<const GameList::Entry> new_entries = GameList::GetEntries();
+  GameList::EntryList& entries = m_taken_entries.value();
+
+  std::unordered_set<std::string_view> old_paths, new_paths;
+  old_paths.reserve(entries.size());
+  new_paths.reserve(new_entries.size());
+  for (const GameList::Entry& entry : entries)
+    old_paths.insert(entry.path);
+  for (const GameList::Entry& entry : new_entries)
+    new_paths.insert(entry.path);
+
+  // Work out the insertions/removals up front, so nothing is touched if the order changed and we need a reset.
+  std::vector<RowChange> changes;
+  size_t old_pos = 0;
+  size_t new_pos = 0;
+  u32 row = 0;
+  while (old_pos < entries.size() || new_pos < new_entries.size())
+  {
+    if (old_pos < entries.size() && new_pos < new_entries.size() && entries[old_pos].path == new_entries[new_pos].path)
+    {
+      old_pos++;
+      new_pos++;
+      row++;
+    }
+    else if (old_pos < entries.size() && !new_paths.contains(entries[old_pos].path))
+    {
+      if (!changes.empty() && !changes.back().insert && changes.back().row == row)
+        changes.back().count++;
+      else
+        changes.push_back({false, row, 1, 0});
+      old_pos++;
+    }
+    else if (new_pos < new_entries.size() &&
+             (old_pos == entries.size() || !old_paths.contains(new_entries[new_pos].path)))
+    {
+      if (!changes.empty() && changes.back().insert && (changes.back().row + changes.back().count) == row)
+        changes.back().count++;
+      else
+        changes.push_back({true, row, 1, static_cast<u32>(new_pos)});
+      new_pos++;
+      row++;
+    }
+    else
+    {
+      // entries were reordered
+      return false;
+    }
+
+    if (changes.size() > MAX_ROW_CHANGES)
+      return false;
+  }
+
+  // Views query the model after each step, so the taken list has to match every intermediate state.
+  old_paths = {};
+  new_paths = {};
+  for (const RowChange& change : changes)
+  {
+    const int first = static_cast<int>(change.row);
+    const int last = static_cast<int>(change.row + change.count - 1);
+    if (change.insert)
+    {
+      beginInsertRows(QModelIndex(), first, last);
+      entries.insert(entries.begin() + change.row, new_entries.begin() + change.new_index,
+                     new_entries.begin() + change.new_index + change.count);
+      endInsertRows();
+    }
+    else
+    {
+      beginRemoveRows(QModelIndex(), first, last);
+      entries.erase(entries.begin() + change.row, entries.begin() + change.row + change.count);
+      endRemoveRows();
+    }
+  }
+
+  DebugAssert(entries.size() == new_entries.size());
+
+  // Rows which were kept may still have changed, e.g. the played time for the game that was just exited.
+  int changed_first = -1;
+  for (size_t i = 0; i <= entries.size(); i++)
+  {
+    const bool changed = (i < entries.size() && entryDiffers(entries[i], new_entries[i]));
+    if (changed)
+    {
+      entries[i] = new_entries[i];
+      if (changed_first < 0)
+        changed_first = static_cast<int>(i);
+    }
+    else if (changed_first >= 0)
+    {
+      emit dataChanged(index(changed_first, 0), index(static_cast<int>(i) - 1, Column_Count - 1));
+      changed_first = -1;
+    }
+  }
+
+  // The taken list now matches the live list row for row, so the switch doesn't need to be reported.
+  m_taken_entries.reset();
+  return true;
+}
+
+bool GameListModel::entryDiffers(const GameList::Entry& lhs, const GameList::Entry& rhs)
+{
+  return (lhs.type != rhs.type || lhs.region != rhs.region || lhs.disc_set_index != rhs.disc_set_index ||
+          lhs.disc_set_member != rhs.disc_set_member || lhs.has_custom_title != rhs.has_custom_title ||
+          lhs.has_custom_region != rhs.has_custom_region || lhs.custom_language != rhs.custom_language ||
+          lhs.dbentry != rhs.dbentry || lhs.hash != rhs.hash || lhs.file_size != rhs.file_size ||
+          lhs.uncompressed_size != rhs.uncompressed_size || lhs.last_modified_time != rhs.last_modified_time ||
+          lhs.last_played_time != rhs.last_played_time || lhs.total_played_time != rhs.total_played_time ||
+          lhs.achievements_game_id != rhs.achievements_game_id || lhs.num_achievements != rhs.num_achievements ||
+          lhs.unlocked_achievements != rhs.unlocked_achievements ||
+          lhs.unlocked_achievements_hc != rhs.unlocked_achievements_hc || lhs.serial != rhs.serial ||
+          lhs.title != rhs.title);
+}
+
+bool GameListModel::compareTitles(const GameList::Entry* left, const GameList::Entry* right)
 {
   const s32 res = StringUtil::CompareNoCase(left->GetSortTitle(), right->GetSortTitle());
   if (res != 0)
@@ -1098,6 +1324,54 @@ bool GameListModel::titlesLessThan(const GameList::Entry* left, const GameList::
   return (left->path < right->path);
 }
 
+std::span<const GameList::Entry> GameListModel::getSortEntries() const
+{
+  // caller holds the game list lock if it's not taken
+  return m_taken_entries.has_value() ? std::span<const GameList::Entry>(m_taken_entries.value()) :
+                                       GameList::GetEntries();
+}
+
+void GameListModel::updateTitleSortRanks(std::span<const GameList::Entry> entries) const
+{
+  if (m_title_sort_ranks_valid && m_title_sort_ranks_base == entries.data() &&
+      m_title_sort_ranks.size() == entries.size())
+  {
+    return;
+  }
+
+  // Sorting 20k games does several hundred thousand comparisons, nearly all of which end up comparing titles, and
+  // each of those goes through the database entry. Ordering the titles once up front turns them into integer compares.
+  std::vector<u32> order(entries.size());
+  for (u32 i = 0; i < static_cast<u32>(order.size()); i++)
+    order[i] = i;
+  std::sort(order.begin(), order.end(),
+            [&entries](u32 lhs, u32 rhs) { return compareTitles(&entries[lhs], &entries[rhs]); });
+
+  m_title_sort_ranks.resize(entries.size());
+  for (u32 i = 0; i < static_cast<u32>(order.size()); i++)
+    m_title_sort_ranks[order[i]] = i;
+
+  m_title_sort_ranks_base = entries.data();
+  m_title_sort_ranks_valid = true;
+}
+
+void GameListModel::invalidateTitleSortRanks()
+{
+  m_title_sort_ranks_valid = false;
+}
+
+bool GameListModel::titlesLessThan(const GameList::Entry* left, const GameList::Entry* right) const
+{
+  const std::span<const GameList::Entry> entries = getSortEntries();
+  const GameList::Entry* const base = entries.data();
+  const GameList::Entry* const end = base + entries.size();
+  if (left < base || left >= end || right < base || right >= end) [[unlikely]]
+    return compareTitles(left, right);
+
+  updateTitleSortRanks(entries);
+  return (m_title_sort_ranks[static_cast<size_t>(left - base)] < m_title_sort_ranks[static_cast<size_t>(right - base)]);
+}
+
 bool GameListModel::lessThan(const QModelIndex& left_index, const QModelIndex& right_index, int column) const
 {
   if (!left_index.isValid() || !right_index.isValid())
@@ -1574,9 +1848,10 @@ public:
       return false;
     }
 
-    AnimatedImage image;
+    // only the downscaled pixmaps are kept, so stream the frames rather than decoding all of them at full size
+    AnimatedImageStream stream;
     Error error;
-    if (!image.LoadFromFile(icon_path.c_str(), &error))
+    if (!stream.Open(icon_path.c_str(), AnimatedImageStream::DEFAULT_WINDOW_SIZE, &error))
     {
       ERROR_LOG("Failed to load animated icon '{}': {}", Path::GetFileName(icon_path), error.GetDescription());
       clearEntry();
@@ -1584,18 +1859,31 @@ public:
     }
 
     // don't use animated delegate if there's only one frame
-    if (image.GetFrames() <= 1)
+    if (stream.GetFrames() <= 1)
     {
       clearEntry();
       return false;
     }
 
     m_frame_pixmaps.clear();
-    m_frame_pixmaps.reserve(image.GetFrames());
-    for (u32 i = 0; i < image.GetFrames(); i++)
+    m_frame_pixmaps.reserve(stream.GetFrames());
+    AnimatedImage::FrameDelay delay = {1, 10};
+    for (u32 i = 0; i < stream.GetFrames(); i++)
     {
-      QPixmap pm = QPixmap::fromImage(QImage(reinterpret_cast<uchar*>(image.GetPixels(i)), image.GetWidth(),
-                                             image.GetHeight(), QImage::Format::Format_RGBA8888));
+      AnimatedImage::FrameDelay frame_delay;
+      const AnimatedImage::PixelType* pixels = stream.GetNextFrame(&frame_delay, &error);
+      if (!pixels)
+      {
+        ERROR_LOG("Failed to decode animated icon '{}': {}", Path::GetFileName(icon_path), error.GetDescription());
+        clearEntry();
+        return false;
+      }
+
+      if (i == 0)
+        delay = frame_delay;
+
+      QPixmap pm = QPixmap::fromImage(QImage(reinterpret_cast<const uchar*>(pixels), stream.GetWidth(),
+                                             stream.GetHeight(), QImage::Format::Format_RGBA8888));
       pm.setDevicePixelRatio(m_model->getDevicePixelRatio());
       resizeGameIcon(pm, m_model->getIconSize());
       m_frame_pixmaps.push_back(std::move(pm));
@@ -1605,7 +1893,6 @@ public:
     m_loops_remaining = GAME_ICON_ANIMATION_LOOPS;
     m_source_row = source_row;
 
-    const AnimatedImage::FrameDelay& delay = image.GetFrameDelay(0);
     m_animation_timer.start(std::max((1000 * delay.numerator) / delay.denominator, 100));
     return true;
   }
@@ -2017,7 +2304,7 @@ void GameListWidget::onRefreshProgress(const QString& status, int current, int t
 
 void GameListWidget::onRefreshComplete()
 {
-  m_model->refresh();
+  m_model->applyRefreshedGameList(m_refresh_last_entry_count);
   emit refreshComplete();
 
   AssertMsg(m_refresh_thread, "Has a refresh thread");
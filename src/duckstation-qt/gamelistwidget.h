@@ -22,6 +22,8 @@
 #include <algorithm>
 #include <array>
 #include <optional>
+#include <span>
+#include <vector>
 
 Q_DECLARE_METATYPE(const GameList::Entry*);
 
@@ -86,6 +88,11 @@ public:
   void takeGameList();
 
   void refresh();
+
+  /// Brings the model up to date after a game list refresh, inserting/removing/updating rows where possible
+  /// instead of resetting. scanned_row_count is the number of rows already inserted while scanning.
+  void applyRefreshedGameList(int scanned_row_count);
+
   void reloadThemeSpecificImages();
 
   bool titlesLessThan(const GameList::Entry* left, const GameList::Entry* right) const;
@@ -156,6 +163,15 @@ private:
 
   static QList<int> getRolesToInvalidate(int column);
 
+  bool updateScannedRows(int scanned_row_count);
+  bool mergeTakenGameList();
+  static bool entryDiffers(const GameList::Entry& lhs, const GameList::Entry& rhs);
+
+  static bool compareTitles(const GameList::Entry* left, const GameList::Entry* right);
+  std::span<const GameList::Entry> getSortEntries() const;
+  void updateTitleSortRanks(std::span<const GameList::Entry> entries) const;
+  void invalidateTitleSortRanks();
+
   const QPixmap& getIconPixmapForEntry(const GameList::Entry* ge) const;
   const QPixmap& getFlagPixmapForEntry(const GameList::Entry* ge) const;
 
@@ -163,6 +179,11 @@ private:
 
   std::optional<GameList::EntryList> m_taken_entries;
 
+  // Position of each entry when sorted by title, indexed by row. Used for the title comparisons while sorting.
+  mutable std::vector<u32> m_title_sort_ranks;
+  mutable const GameList::Entry* m_title_sort_ranks_base = nullptr;
+  mutable bool m_title_sort_ranks_valid = false;
+
   float m_cover_scale = 0.0f;
   int m_icon_size = 0;
   bool m_show_localized_titles = false;
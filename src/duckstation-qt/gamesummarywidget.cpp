@@ -509,9 +509,10 @@ void GameSummaryWidget::onComputeHashClicked()
   m_ui.computeHashes->setEnabled(false);
 
   QtAsyncTaskWithProgressDialog::create(this, TRANSLATE_SV("GameSummaryWidget", "Verifying Image"), {}, false, true, 1,
-                                        0, 0.0f, true, [this, path = m_path](ProgressCallback* progress) {
+                                        0, 0.0f, true,
+                                        [this, path = m_path, track_hashes = m_partial_track_hashes](
+                                          ProgressCallback* progress) mutable {
                                           Error error;
-                                          CDImageHasher::TrackHashes track_hashes;
                                           const bool result = computeImageHash(path, track_hashes, progress, &error);
                                           const bool cancelled = (!result && progress->IsCancelled());
                                           return [this, track_hashes = std::move(track_hashes),
@@ -528,10 +529,13 @@ bool GameSummaryWidget::computeImageHash(const std::string& path, CDImageHasher:
   if (!image)
     return false;
 
+  // Resume after any tracks that were hashed before a previous attempt was cancelled.
+  if (track_hashes.size() > image->GetTrackCount())
+    track_hashes.clear();
   track_hashes.reserve(image->GetTrackCount());
   progress->SetProgressRange(image->GetTrackCount());
 
-  for (u32 track = 0; track < image->GetTrackCount(); track++)
+  for (u32 track = static_cast<u32>(track_hashes.size()); track < image->GetTrackCount(); track++)
   {
     progress->SetProgressValue(track);
     progress->PushState();
@@ -557,8 +561,13 @@ void GameSummaryWidget::processHashResults(const CDImageHasher::TrackHashes& tra
 
   if (!result)
   {
-    if (!cancelled)
+    if (cancelled)
     {
+      m_partial_track_hashes = track_hashes;
+    }
+    else
+    {
+      m_partial_track_hashes.clear();
       QtUtils::AsyncMessageBox(this, QMessageBox::Critical, tr("Hash Calculation Failed"),
                                QString::fromStdString(error.GetDescription()));
     }
@@ -566,6 +575,8 @@ void GameSummaryWidget::processHashResults(const CDImageHasher::TrackHashes& tra
     return;
   }
 
+  m_partial_track_hashes.clear();
+
   // Verify hashes against gamedb
   std::vector<bool> verification_results(track_hashes.size(), false);
 
@@ -579,26 +590,24 @@ void GameSummaryWidget::processHashResults(const CDImageHasher::TrackHashes& tra
   // 2. For each data track match, try to match all audio tracks
   //    If all match, assume this revision. Else, try other revisions,
   //    and accept the one with the most matches.
-  const GameDatabase::TrackHashesMap& hashes_map = GameDatabase::GetTrackHashesMap();
-
-  auto data_track_matches = hashes_map.equal_range(track_hashes[0]);
-  if (data_track_matches.first != data_track_matches.second)
+  const std::vector<GameDatabase::TrackData> data_track_matches = GameDatabase::GetTracksForHash(track_hashes[0]);
+  if (!data_track_matches.empty())
   {
-    auto best_data_match = data_track_matches.second;
-    for (auto iter = data_track_matches.first; iter != data_track_matches.second; ++iter)
+    const GameDatabase::TrackData* best_data_match = nullptr;
+    for (const GameDatabase::TrackData& data_track_attribs : data_track_matches)
     {
       std::vector<bool> current_verification_results(track_hashes.size(), false);
-      const auto& data_track_attribs = iter->second;
       current_verification_results[0] = true; // Data track already matched
 
       for (auto audio_tracks_iter = std::next(track_hashes.begin()); audio_tracks_iter != track_hashes.end();
            ++audio_tracks_iter)
       {
-        auto audio_track_matches = hashes_map.equal_range(*audio_tracks_iter);
-        for (auto audio_iter = audio_track_matches.first; audio_iter != audio_track_matches.second; ++audio_iter)
+        const std::vector<GameDatabase::TrackData> audio_track_matches =
+          GameDatabase::GetTracksForHash(*audio_tracks_iter);
+        for (const GameDatabase::TrackData& audio_track : audio_track_matches)
         {
           // If audio track comes from the same revision and code as the data track, "pass" it
-          if (audio_iter->second == data_track_attribs)
+          if (audio_track == data_track_attribs)
           {
             current_verification_results[std::distance(track_hashes.begin(), audio_tracks_iter)] = true;
             break;
@@ -612,7 +621,7 @@ void GameSummaryWidget::processHashResults(const CDImageHasher::TrackHashes& tra
 
       if (new_matches_count > old_matches_count)
       {
-        best_data_match = iter;
+        best_data_match = &data_track_attribs;
         verification_results = current_verification_results;
         // If all elements got matched, early out
         if (new_matches_count >= static_cast<ptrdiff_t>(verification_results.size()))
@@ -622,8 +631,11 @@ void GameSummaryWidget::processHashResults(const CDImageHasher::TrackHashes& tra
       }
     }
 
-    found_revision = best_data_match->second.revision_str;
-    found_serial = best_data_match->second.serial;
+    if (best_data_match)
+    {
+      found_revision = best_data_match->revision_str;
+      found_serial = best_data_match->serial;
+    }
   }
 
   QString text;
@@ -56,5 +56,6 @@ private:
 
   std::string m_path;
   std::string m_redump_search_keyword;
+  CDImageHasher::TrackHashes m_partial_track_hashes; // tracks already hashed by a cancelled verification
   QString m_compatibility_comments;
 };
@@ -244,7 +244,9 @@ GraphicsSettingsWidget::GraphicsSettingsWidget(SettingsWindow* dialog, QWidget*
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.showSpeed, "Display", "ShowSpeed", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.showResolution, "Display", "ShowResolution", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.showCPU, "Display", "ShowCPU", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.showCPUBreakdown, "Display", "ShowCPUBreakdown", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.showGPU, "Display", "ShowGPU", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.showGPUBreakdown, "Display", "ShowGPUBreakdown", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.showInput, "Display", "ShowInputs", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.showGPUStatistics, "Display", "ShowGPUStatistics", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.showLatencyStatistics, "Display", "ShowLatencyStatistics",
@@ -319,6 +321,8 @@ GraphicsSettingsWidget::GraphicsSettingsWidget(SettingsWindow* dialog, QWidget*
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.enableTextureCache, "GPU", "EnableTextureCache", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.preloadTextureReplacements, "TextureReplacements",
                                                "PreloadTextures", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.asyncLoadTextureReplacements, "TextureReplacements",
+                                               "AsyncLoadTextures", false);
 
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.enableTextureReplacements, "TextureReplacements",
                                                "EnableTextureReplacements", false);
@@ -610,8 +614,16 @@ GraphicsSettingsWidget::GraphicsSettingsWidget(SettingsWindow* dialog, QWidget*
   dialog->registerWidgetHelp(
     m_ui.showCPU, tr("Show CPU Usage"), tr("Unchecked"),
     tr("Shows the host's CPU usage of each system thread in the top-right corner of the display."));
+  dialog->registerWidgetHelp(
+    m_ui.showCPUBreakdown, tr("Show CPU Time Breakdown"), tr("Unchecked"),
+    tr("Shows how the CPU thread's time is split between the emulated subsystems in the top-right corner of the "
+       "display. Timing each subsystem has a small performance cost."));
   dialog->registerWidgetHelp(m_ui.showGPU, tr("Show GPU Usage"), tr("Unchecked"),
                              tr("Shows the host's GPU usage in the top-right corner of the display."));
+  dialog->registerWidgetHelp(
+    m_ui.showGPUBreakdown, tr("Show GPU Time Breakdown"), tr("Unchecked"),
+    tr("Shows the most expensive rendering passes on the host GPU, such as drawing to VRAM or post-processing, in the "
+       "top-right corner of the display. Only supported with the Vulkan, Direct3D 12 and OpenGL renderers."));
   dialog->registerWidgetHelp(m_ui.showGPUStatistics, tr("Show GPU Statistics"), tr("Unchecked"),
                              tr("Shows information about the emulated GPU in the top-right corner of the display."));
   dialog->registerWidgetHelp(
@@ -689,6 +701,11 @@ GraphicsSettingsWidget::GraphicsSettingsWidget(SettingsWindow* dialog, QWidget*
        "experimental, and may cause rendering errors in some games.</strong>"));
   dialog->registerWidgetHelp(m_ui.preloadTextureReplacements, tr("Preload Texture Replacements"), tr("Unchecked"),
                              tr("Loads all replacement texture to RAM, reducing stuttering at runtime."));
+  dialog->registerWidgetHelp(m_ui.asyncLoadTextureReplacements, tr("Load Texture Replacements Asynchronously"),
+                             tr("Unchecked"),
+                             tr("Decodes replacement textures on worker threads instead of stalling rendering. The "
+                                "original texture is shown until the replacement is ready, and preloading happens in "
+                                "the background."));
 
   dialog->registerWidgetHelp(m_ui.enableTextureReplacements, tr("Enable Texture Replacements"), tr("Unchecked"),
                              tr("Enables loading of replacement textures. Not compatible with all games."));
@@ -790,7 +807,7 @@ GPURenderer GraphicsSettingsWidget::getEffectiveRenderer() const
 
 bool GraphicsSettingsWidget::effectiveRendererIsHardware() const
 {
-  return (getEffectiveRenderer() != GPURenderer::Software);
+  return Settings::IsHardwareRenderer(getEffectiveRenderer());
 }
 
 void GraphicsSettingsWidget::onShowDebugSettingsChanged(bool enabled)
@@ -802,7 +819,7 @@ void GraphicsSettingsWidget::updateRendererDependentOptions()
 {
   const GPURenderer renderer = getEffectiveRenderer();
   const RenderAPI render_api = Settings::GetRenderAPIForRenderer(renderer);
-  const bool is_hardware = (renderer != GPURenderer::Software);
+  const bool is_hardware = Settings::IsHardwareRenderer(renderer);
 
   m_ui.resolutionScale->setEnabled(is_hardware && !m_dialog->hasGameTrait(GameDatabase::Trait::DisableUpscaling));
   m_ui.resolutionScaleLabel->setEnabled(is_hardware && !m_dialog->hasGameTrait(GameDatabase::Trait::DisableUpscaling));
@@ -1187,7 +1204,7 @@ void GraphicsSettingsWidget::updatePGXPSettingsEnabled()
 
 void GraphicsSettingsWidget::updateResolutionDependentOptions()
 {
-  const bool is_hardware = (getEffectiveRenderer() != GPURenderer::Software);
+  const bool is_hardware = Settings::IsHardwareRenderer(getEffectiveRenderer());
   const int scale = m_dialog->getEffectiveIntValue("GPU", "ResolutionScale", 1);
   const GPUTextureFilter texture_filtering =
     Settings::ParseTextureFilterName(m_dialog->getEffectiveStringValue("GPU", "TextureFilter").c_str())
@@ -1417,6 +1434,7 @@ void GraphicsSettingsWidget::onEnableAnyTextureReplacementsChanged()
      (m_dialog->getEffectiveBoolValue("GPU", "EnableTextureCache", false) &&
       m_dialog->getEffectiveBoolValue("TextureReplacements", "EnableTextureReplacements", false)));
   m_ui.preloadTextureReplacements->setEnabled(any_replacements_enabled);
+  m_ui.asyncLoadTextureReplacements->setEnabled(any_replacements_enabled);
 }
 
 void GraphicsSettingsWidget::onGPUThreadChanged()
@@ -1450,6 +1468,9 @@ TextureReplacementSettingsDialog::TextureReplacementSettingsDialog(SettingsWindo
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.replacementScaleLinearFilter, "TextureReplacements",
                                                "ReplacementScaleLinearFilter",
                                                default_replacement_config.replacement_scale_linear_filter);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.directReplacementTextures, "TextureReplacements",
+                                               "DirectReplacementTextures",
+                                               default_replacement_config.direct_replacement_textures);
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.maxVRAMWriteSplits, "TextureReplacements", "MaxVRAMWriteSplits",
                                               default_replacement_config.max_vram_write_splits);
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.maxVRAMWriteCoalesceWidth, "TextureReplacements",
@@ -1498,6 +1519,7 @@ void TextureReplacementSettingsDialog::onExportClicked()
   config.reduce_palette_range = m_ui.reducePaletteRange->isChecked();
   config.convert_copies_to_writes = m_ui.convertCopiesToWrites->isChecked();
   config.replacement_scale_linear_filter = m_ui.replacementScaleLinearFilter->isChecked();
+  config.direct_replacement_textures = m_ui.directReplacementTextures->isChecked();
   config.max_vram_write_splits = static_cast<u16>(m_ui.maxVRAMWriteSplits->value());
   config.max_vram_write_coalesce_width = static_cast<u16>(m_ui.maxVRAMWriteCoalesceWidth->value());
   config.max_vram_write_coalesce_height = static_cast<u16>(m_ui.maxVRAMWriteCoalesceHeight->value());
@@ -6,6 +6,8 @@
 #include "qtprogresscallback.h"
 #include "qtutils.h"
 
+#include "core/host.h"
+
 #include "util/cd_image.h"
 #include "util/translation.h"
 
@@ -15,6 +17,7 @@
 #include "common/log.h"
 #include "common/path.h"
 
+#include <QtCore/QPointer>
 #include <QtGui/QIcon>
 #include <QtWidgets/QFileDialog>
 #include <QtWidgets/QMenu>
@@ -47,42 +50,67 @@ ISOBrowserWindow::ISOBrowserWindow(QWidget* parent) : QWidget(parent)
 
 ISOBrowserWindow::~ISOBrowserWindow() = default;
 
-ISOBrowserWindow* ISOBrowserWindow::createAndOpenFile(QWidget* parent, const QString& path)
+ISOBrowserWindow* ISOBrowserWindow::createAndOpenFile(const QString& path)
 {
   ISOBrowserWindow* ib = new ISOBrowserWindow(nullptr);
-
-  Error error;
-  if (!ib->tryOpenFile(path, &error))
-  {
-    QtUtils::AsyncMessageBox(
-      parent, QMessageBox::Critical, tr("Error"),
-      tr("Failed to open %1:\n%2").arg(path).arg(QString::fromStdString(error.GetDescription())));
-    delete ib;
-    return nullptr;
-  }
-
+  ib->openFile(path, true);
   return ib;
 }
 
-bool ISOBrowserWindow::tryOpenFile(const QString& path, Error* error /*= nullptr*/)
+void ISOBrowserWindow::openFile(const QString& path, bool close_on_failure)
 {
-  const std::string native_path = QDir::toNativeSeparators(path).toStdString();
-  std::unique_ptr<CDImage> image = CDImage::Open(native_path.c_str(), false, error);
-  if (!image)
-    return false;
-
-  IsoReader new_reader;
-  if (!new_reader.Open(image.get(), 1, error))
-    return false;
-
-  m_image = std::move(image);
-  m_iso = std::move(new_reader);
-  m_ui.openPath->setText(QString::fromStdString(native_path));
-  setWindowTitle(tr("ISO Browser - %1").arg(QtUtils::StringViewToQString(Path::GetFileName(native_path))));
-  enableUi(true);
-  populateDirectories();
-  populateFiles(QString());
-  return true;
+  struct OpenResult
+  {
+    std::unique_ptr<CDImage> image;
+    IsoReader iso;
+    Error error;
+  };
+
+  std::string native_path = QDir::toNativeSeparators(path).toStdString();
+  m_ui.openFile->setEnabled(false);
+  enableUi(false);
+
+  // Opening can take a while on network shares, so read the filesystem on the worker as well.
+  CDImage::OpenAsync(native_path, false,
+                     [this, window = QPointer<ISOBrowserWindow>(this), native_path, close_on_failure](
+                       std::unique_ptr<CDImage> image, Error* error) mutable {
+                       std::shared_ptr<OpenResult> result = std::make_shared<OpenResult>();
+                       if (image && result->iso.Open(image.get(), 1, &result->error))
+                         result->image = std::move(image);
+                       else if (!image)
+                         result->error = std::move(*error);
+
+                       Host::RunOnUIThread([this, window = std::move(window), native_path = std::move(native_path),
+                                            close_on_failure, result = std::move(result)]() {
+                         if (!window)
+                           return;
+
+                         m_ui.openFile->setEnabled(true);
+                         if (!result->image)
+                         {
+                           QtUtils::AsyncMessageBox(
+                             close_on_failure ? static_cast<QWidget*>(g_main_window) : this, QMessageBox::Critical,
+                             tr("Error"),
+                             tr("Failed to open %1:\n%2")
+                               .arg(QString::fromStdString(native_path))
+                               .arg(QString::fromStdString(result->error.GetDescription())));
+                           if (close_on_failure)
+                             close();
+                           else
+                             enableUi(static_cast<bool>(m_image));
+                           return;
+                         }
+
+                         m_image = std::move(result->image);
+                         m_iso = std::move(result->iso);
+                         m_ui.openPath->setText(QString::fromStdString(native_path));
+                         setWindowTitle(
+                           tr("ISO Browser - %1").arg(QtUtils::StringViewToQString(Path::GetFileName(native_path))));
+                         enableUi(true);
+                         populateDirectories();
+                         populateFiles(QString());
+                       });
+                     });
 }
 
 void ISOBrowserWindow::onOpenFileClicked()
@@ -93,14 +121,7 @@ void ISOBrowserWindow::onOpenFileClicked()
   if (path.isEmpty())
     return;
 
-  Error error;
-  if (!tryOpenFile(path, &error))
-  {
-    QtUtils::AsyncMessageBox(
-      this, QMessageBox::Critical, tr("Error"),
-      tr("Failed to open %1:\n%2").arg(path).arg(QString::fromStdString(error.GetDescription())));
-    return;
-  }
+  openFile(path, false);
 }
 
 void ISOBrowserWindow::onExtractClicked(IsoReader::ReadMode mode)
@@ -15,9 +15,10 @@ public:
   explicit ISOBrowserWindow(QWidget* parent = nullptr);
   ~ISOBrowserWindow();
 
-  static ISOBrowserWindow* createAndOpenFile(QWidget* parent, const QString& path);
+  static ISOBrowserWindow* createAndOpenFile(const QString& path);
 
-  bool tryOpenFile(const QString& path, Error* error = nullptr);
+  /// Opens the image in the background. If close_on_failure is set, the window is closed when the open fails.
+  void openFile(const QString& path, bool close_on_failure);
 
 private:
   void enableUi(bool enabled);
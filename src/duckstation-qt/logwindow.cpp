@@ -9,10 +9,18 @@
 #include "util/ini_settings_interface.h"
 
 #include <QtCore/QLatin1StringView>
-#include <QtCore/QUtf8StringView>
+#include <QtCore/QTimer>
+#include <QtGui/QClipboard>
+#include <QtGui/QGuiApplication>
 #include <QtGui/QIcon>
+#include <QtGui/QKeyEvent>
+#include <QtGui/QPainter>
+#include <QtWidgets/QLineEdit>
 #include <QtWidgets/QMenuBar>
 #include <QtWidgets/QScrollBar>
+#include <QtWidgets/QStyledItemDelegate>
+
+#include <algorithm>
 
 #include "moc_logwindow.cpp"
 
@@ -20,15 +28,167 @@
 // But once I get rid of that, there will be.
 LogWindow* g_log_window;
 
-LogWidget::LogWidget(QWidget* parent) : QPlainTextEdit(parent), m_is_dark_theme(QtHost::IsDarkApplicationTheme())
+namespace {
+
+class LogLineDelegate final : public QStyledItemDelegate
+{
+public:
+  explicit LogLineDelegate(LogWidget* parent) : QStyledItemDelegate(parent), m_parent(parent) {}
+
+  void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+  QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+private:
+  LogWidget* m_parent;
+};
+
+} // namespace
+
+static constexpr const QChar s_level_characters[static_cast<size_t>(Log::Level::MaxCount)] = {'X', 'E', 'W', 'I',
+                                                                                             'V', 'D', 'B', 'T'};
+static constexpr const QColor s_message_colors[2][static_cast<size_t>(Log::Color::MaxCount)] = {
+  // Light theme
+  {
+    QColor(0x00, 0x00, 0x00), // Default
+    QColor(0x00, 0x00, 0x00), // Black
+    QColor(0x70, 0x00, 0x00), // Red
+    QColor(0xec, 0x5e, 0xf1), // Green
+    QColor(0xe9, 0x39, 0xf3), // Blue
+    QColor(0xA0, 0x00, 0xA0), // Magenta
+    QColor(0xA0, 0x78, 0x00), // Orange
+    QColor(0x80, 0xB4, 0xB4), // Cyan
+    QColor(0xB4, 0xB4, 0x80), // Yellow
+    QColor(0x70, 0x70, 0x70), // White
+    QColor(0x00, 0x00, 0x00), // StrongBlack
+    QColor(0x80, 0x00, 0x00), // StrongRed
+    QColor(0x00, 0x80, 0x00), // StrongGreen
+    QColor(0x00, 0x00, 0x80), // StrongBlue
+    QColor(0xA0, 0x00, 0xA0), // StrongMagenta
+    QColor(0xA0, 0x78, 0x00), // StrongOrange
+    QColor(0x80, 0xB4, 0xB4), // StrongCyan
+    QColor(0xb4, 0xb4, 0x00), // StrongYellow
+    QColor(0x0D, 0x0d, 0x0D)  // StrongWhite
+  },
+  // Dark theme
+  {
+    QColor(0xD0, 0xD0, 0xD0), // Default
+    QColor(0xFF, 0xFF, 0xFF), // Black
+    QColor(0xB4, 0x00, 0x00), // Red
+    QColor(0x13, 0xA1, 0x0E), // Green
+    QColor(0x00, 0x37, 0xDA), // Blue
+    QColor(0xA0, 0x00, 0xA0), // Magenta
+    QColor(0xA0, 0x78, 0x00), // Orange
+    QColor(0x80, 0xB4, 0xB4), // Cyan
+    QColor(0xB4, 0xB4, 0x80), // Yellow
+    QColor(0xCC, 0xCC, 0xCC), // White
+    QColor(0xFF, 0xFF, 0xFF), // StrongBlack
+    QColor(0xE7, 0x48, 0x56), // StrongRed
+    QColor(0x16, 0xC6, 0x0C), // StrongGreen
+    QColor(0x20, 0x20, 0xCC), // StrongBlue
+    QColor(0xA0, 0x00, 0xA0), // StrongMagenta
+    QColor(0xB4, 0x96, 0x00), // StrongOrange
+    QColor(0x80, 0xB4, 0xB4), // StrongCyan
+    QColor(0xF9, 0xF1, 0xA5), // StrongYellow
+    QColor(0xFF, 0xFF, 0xFF), // StrongWhite
+  },
+};
+static constexpr const QColor s_timestamp_color[2] = {QColor(0x60, 0x60, 0x60), QColor(0xcc, 0xcc, 0xcc)};
+static constexpr const QColor s_channel_color[2] = {QColor(0x30, 0x30, 0x30), QColor(0xf2, 0xf2, 0xf2)};
+
+static QString FormatLineTimestamp(const LogWidget::Line& line)
+{
+  return QStringLiteral("[%1] ").arg(line.timestamp, 10, 'f', 4);
+}
+
+static QString FormatLineChannel(const LogWidget::Line& line)
+{
+  const Log::Level level = Log::UnpackLevel(static_cast<Log::MessageCategory>(line.cat));
+  return (level <= Log::Level::Warning) ?
+           QStringLiteral("%1(%2): ").arg(s_level_characters[static_cast<size_t>(level)]).arg(line.channel) :
+           QStringLiteral("%1/%2: ").arg(s_level_characters[static_cast<size_t>(level)]).arg(line.channel);
+}
+
+void LogLineDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
 {
-  setReadOnly(true);
-  setUndoRedoEnabled(false);
-  setTextInteractionFlags(Qt::TextSelectableByKeyboard | Qt::TextSelectableByMouse);
+  const LogWidget::Line& line = m_parent->getVisibleLine(index.row());
+  const size_t dark = static_cast<size_t>(m_parent->isDarkTheme());
+  const Log::Level level = Log::UnpackLevel(static_cast<Log::MessageCategory>(line.cat));
+  const Log::Color color = (Log::UnpackColor(static_cast<Log::MessageCategory>(line.cat)) == Log::Color::Default) ?
+                             Log::GetColorForLevel(level) :
+                             Log::UnpackColor(static_cast<Log::MessageCategory>(line.cat));
+
+  painter->save();
+
+  if (option.state & QStyle::State_Selected)
+    painter->fillRect(option.rect, option.palette.highlight());
+
+  // lines are clipped to the view, the tooltip has the full message
+  QRect rect = option.rect;
+  const auto draw_text = [painter, &option, &rect](const QString& text, const QColor& text_color) {
+    const QString elided_text = option.fontMetrics.elidedText(text, Qt::ElideRight, rect.width());
+    painter->setPen(text_color);
+    painter->drawText(rect, Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine, elided_text);
+    rect.setLeft(rect.left() + option.fontMetrics.horizontalAdvance(elided_text));
+  };
+
+  if (line.timestamp >= 0.0f)
+    draw_text(FormatLineTimestamp(line), s_timestamp_color[dark]);
+  draw_text(FormatLineChannel(line), s_channel_color[dark]);
+  draw_text(line.text, s_message_colors[dark][static_cast<size_t>(color)]);
+
+  painter->restore();
+}
+
+QSize LogLineDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+  // every line is the same size, so the view only has to lay out what's on screen
+  return QSize(m_parent->viewport()->width(), option.fontMetrics.height());
+}
+
+LogModel::LogModel(LogWidget* parent) : QAbstractListModel(parent), m_parent(parent)
+{
+}
+
+LogModel::~LogModel() = default;
+
+int LogModel::rowCount(const QModelIndex& parent) const
+{
+  return parent.isValid() ? 0 : static_cast<int>(m_parent->m_visible_lines.size());
+}
+
+QVariant LogModel::data(const QModelIndex& index, int role) const
+{
+  if (!index.isValid() || index.row() < 0 || index.row() >= static_cast<int>(m_parent->m_visible_lines.size()))
+    return QVariant();
+
+  const LogWidget::Line& line = m_parent->getVisibleLine(index.row());
+  if (role == Qt::DisplayRole)
+    return m_parent->getLineText(line);
+  else if (role == Qt::ToolTipRole)
+    return line.text;
+  else
+    return QVariant();
+}
+
+LogWidget::LogWidget(QWidget* parent)
+  : QListView(parent), m_model(new LogModel(this)), m_flush_timer(new QTimer(this)),
+    m_is_dark_theme(QtHost::IsDarkApplicationTheme()),
+    m_pending_messages(std::make_unique<PendingMessage[]>(PENDING_MESSAGE_QUEUE_SIZE))
+{
+  setModel(m_model);
+  setItemDelegate(new LogLineDelegate(this));
+  setUniformItemSizes(true);
+  setResizeMode(QListView::Adjust);
+  setSelectionMode(QAbstractItemView::ExtendedSelection);
+  setEditTriggers(QAbstractItemView::NoEditTriggers);
   setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
-  setMaximumBlockCount(MAX_LINES);
+  setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
   setFont(QtHost::GetFixedFont());
 
+  m_flush_timer->setSingleShot(true);
+  m_flush_timer->setInterval(FLUSH_INTERVAL_MS);
+  connect(m_flush_timer, &QTimer::timeout, this, &LogWidget::flushPendingMessages);
+
   Log::RegisterCallback(&LogWidget::logCallback, this);
 }
 
@@ -40,172 +200,238 @@ LogWidget::~LogWidget()
 void LogWidget::changeEvent(QEvent* event)
 {
   if (event->type() == QEvent::StyleChange)
+  {
     m_is_dark_theme = QtHost::IsDarkApplicationTheme();
+    viewport()->update();
+  }
 
-  QPlainTextEdit::changeEvent(event);
+  QListView::changeEvent(event);
 }
 
-void LogWidget::appendMessage(const QLatin1StringView& channel, quint32 cat, const QString& message)
+void LogWidget::keyPressEvent(QKeyEvent* event)
 {
-  const int num_lines_still_pending = m_lines_pending.fetch_sub(1, std::memory_order_acq_rel) - 1;
-  if (m_lines_to_skip > 0)
+  if (event->matches(QKeySequence::Copy))
   {
-    m_lines_to_skip--;
+    copySelectionToClipboard();
     return;
   }
 
-  if (num_lines_still_pending > MAX_LINES)
+  QListView::keyPressEvent(event);
+}
+
+void LogWidget::appendMessage(const QLatin1StringView& channel, quint32 cat, const QString& message)
+{
+  // keep it in order with anything that's still queued
+  flushPendingMessages();
+
+  const u64 first_new_line = m_first_line_number + m_lines.size();
+  addLines(channel, cat, Log::AreConsoleOutputTimestampsEnabled() ? Log::GetCurrentMessageTime() : -1.0f, message);
+  showNewLines(first_new_line);
+}
+
+void LogWidget::clear()
+{
+  m_model->beginResetModel();
+  m_first_line_number += m_lines.size();
+  m_lines.clear();
+  m_visible_lines.clear();
+  m_model->endResetModel();
+}
+
+void LogWidget::setFilter(const QString& filter)
+{
+  if (m_filter == filter)
+    return;
+
+  m_model->beginResetModel();
+  m_filter = filter;
+  m_visible_lines.clear();
+  for (size_t i = 0; i < m_lines.size(); i++)
   {
-    realAppendMessage(
-      QLatin1StringView(Log::GetChannelName(Log::Channel::Log)),
-      Log::PackCategory(Log::Channel::Log, Log::Level::Warning, Log::Color::StrongYellow),
-      tr("Dropped %1 log messages, please use file or system console logging.\n").arg(num_lines_still_pending));
-    m_lines_to_skip = num_lines_still_pending;
+    if (matchesFilter(m_lines[i]))
+      m_visible_lines.push_back(m_first_line_number + i);
+  }
+  m_model->endResetModel();
+
+  scrollToBottom();
+}
+
+const LogWidget::Line& LogWidget::getVisibleLine(int row) const
+{
+  return m_lines[static_cast<size_t>(m_visible_lines[static_cast<size_t>(row)] - m_first_line_number)];
+}
+
+QString LogWidget::getLineText(const Line& line) const
+{
+  QString ret;
+  if (line.timestamp >= 0.0f)
+    ret.append(FormatLineTimestamp(line));
+  ret.append(FormatLineChannel(line));
+  ret.append(line.text);
+  return ret;
+}
+
+QString LogWidget::toPlainText() const
+{
+  QString ret;
+  for (const Line& line : m_lines)
+  {
+    ret.append(getLineText(line));
+    ret.append(QChar('\n'));
+  }
+
+  return ret;
+}
+
+void LogWidget::copySelectionToClipboard()
+{
+  QModelIndexList rows = selectionModel()->selectedRows();
+  if (rows.isEmpty())
     return;
+
+  std::sort(rows.begin(), rows.end(),
+            [](const QModelIndex& lhs, const QModelIndex& rhs) { return (lhs.row() < rhs.row()); });
+
+  QString text;
+  for (const QModelIndex& index : rows)
+  {
+    text.append(getLineText(getVisibleLine(index.row())));
+    text.append(QChar('\n'));
   }
-  else if (num_lines_still_pending > BLOCK_UPDATES_THRESHOLD)
+
+  QGuiApplication::clipboard()->setText(text);
+}
+
+bool LogWidget::matchesFilter(const Line& line) const
+{
+  return (m_filter.isEmpty() || line.text.contains(m_filter, Qt::CaseInsensitive) ||
+          line.channel.contains(m_filter, Qt::CaseInsensitive));
+}
+
+void LogWidget::queueMessage(const QLatin1StringView& channel, quint32 cat, float timestamp, QString message)
+{
+  const u32 write_pos = m_pending_write_pos.load(std::memory_order_relaxed);
+  if ((write_pos - m_pending_read_pos.load(std::memory_order_acquire)) == PENDING_MESSAGE_QUEUE_SIZE)
   {
-    if (updatesEnabled())
-    {
-      setUpdatesEnabled(false);
-      document()->blockSignals(true);
-      blockSignals(true);
-    }
+    // UI thread isn't keeping up, it'll say how many were lost
+    m_dropped_messages.fetch_add(1, std::memory_order_relaxed);
   }
-  else if (!updatesEnabled())
+  else
   {
-    blockSignals(false);
-    document()->blockSignals(false);
-    setUpdatesEnabled(true);
+    PendingMessage& pm = m_pending_messages[write_pos % PENDING_MESSAGE_QUEUE_SIZE];
+    pm.message = std::move(message);
+    pm.channel = channel;
+    pm.timestamp = timestamp;
+    pm.cat = cat;
+    m_pending_write_pos.store(write_pos + 1, std::memory_order_release);
   }
 
-  realAppendMessage(channel, cat, message);
+  scheduleFlush();
+}
+
+void LogWidget::scheduleFlush()
+{
+  if (m_flush_scheduled.exchange(true, std::memory_order_acq_rel))
+    return;
+
+  // timer can only be started on the thread it belongs to
+  if (QThread::isMainThread())
+    m_flush_timer->start();
+  else
+    QMetaObject::invokeMethod(this, [this]() { m_flush_timer->start(); }, Qt::QueuedConnection);
 }
 
-void LogWidget::realAppendMessage(const QLatin1StringView& channel, quint32 cat, const QString& message)
+void LogWidget::flushPendingMessages()
 {
-  QTextCursor temp_cursor = textCursor();
-  QScrollBar* scrollbar = verticalScrollBar();
-  const bool cursor_at_end = temp_cursor.atEnd();
-  const bool scroll_at_end = scrollbar->sliderPosition() == scrollbar->maximum();
+  // anything logged from here on needs another flush
+  m_flush_scheduled.store(false, std::memory_order_release);
+  m_flush_timer->stop();
 
-  temp_cursor.movePosition(QTextCursor::End);
+  const u64 first_new_line = m_first_line_number + m_lines.size();
 
+  u32 read_pos = m_pending_read_pos.load(std::memory_order_relaxed);
+  const u32 write_pos = m_pending_write_pos.load(std::memory_order_acquire);
+  for (; read_pos != write_pos; read_pos++)
   {
-    static constexpr const QChar level_characters[static_cast<size_t>(Log::Level::MaxCount)] = {'X', 'E', 'W', 'I',
-                                                                                                'V', 'D', 'B', 'T'};
-    static constexpr const QColor message_colors[2][static_cast<size_t>(Log::Color::MaxCount)] = {
-      // Light theme
-      {
-        QColor(0x00, 0x00, 0x00), // Default
-        QColor(0x00, 0x00, 0x00), // Black
-        QColor(0x70, 0x00, 0x00), // Red
-        QColor(0xec, 0x5e, 0xf1), // Green
-        QColor(0xe9, 0x39, 0xf3), // Blue
-        QColor(0xA0, 0x00, 0xA0), // Magenta
-        QColor(0xA0, 0x78, 0x00), // Orange
-        QColor(0x80, 0xB4, 0xB4), // Cyan
-        QColor(0xB4, 0xB4, 0x80), // Yellow
-        QColor(0x70, 0x70, 0x70), // White
-        QColor(0x00, 0x00, 0x00), // StrongBlack
-        QColor(0x80, 0x00, 0x00), // StrongRed
-        QColor(0x00, 0x80, 0x00), // StrongGreen
-        QColor(0x00, 0x00, 0x80), // StrongBlue
-        QColor(0xA0, 0x00, 0xA0), // StrongMagenta
-        QColor(0xA0, 0x78, 0x00), // StrongOrange
-        QColor(0x80, 0xB4, 0xB4), // StrongCyan
-        QColor(0xb4, 0xb4, 0x00), // StrongYellow
-        QColor(0x0D, 0x0d, 0x0D)  // StrongWhite
-      },
-      // Dark theme
-      {
-        QColor(0xD0, 0xD0, 0xD0), // Default
-        QColor(0xFF, 0xFF, 0xFF), // Black
-        QColor(0xB4, 0x00, 0x00), // Red
-        QColor(0x13, 0xA1, 0x0E), // Green
-        QColor(0x00, 0x37, 0xDA), // Blue
-        QColor(0xA0, 0x00, 0xA0), // Magenta
-        QColor(0xA0, 0x78, 0x00), // Orange
-        QColor(0x80, 0xB4, 0xB4), // Cyan
-        QColor(0xB4, 0xB4, 0x80), // Yellow
-        QColor(0xCC, 0xCC, 0xCC), // White
-        QColor(0xFF, 0xFF, 0xFF), // StrongBlack
-        QColor(0xE7, 0x48, 0x56), // StrongRed
-        QColor(0x16, 0xC6, 0x0C), // StrongGreen
-        QColor(0x20, 0x20, 0xCC), // StrongBlue
-        QColor(0xA0, 0x00, 0xA0), // StrongMagenta
-        QColor(0xB4, 0x96, 0x00), // StrongOrange
-        QColor(0x80, 0xB4, 0xB4), // StrongCyan
-        QColor(0xF9, 0xF1, 0xA5), // StrongYellow
-        QColor(0xFF, 0xFF, 0xFF), // StrongWhite
-      },
-    };
-    static constexpr const QColor timestamp_color[2] = {QColor(0x60, 0x60, 0x60), QColor(0xcc, 0xcc, 0xcc)};
-    static constexpr const QColor channel_color[2] = {QColor(0x30, 0x30, 0x30), QColor(0xf2, 0xf2, 0xf2)};
-
-    QTextCharFormat format = temp_cursor.charFormat();
-    const size_t dark = static_cast<size_t>(m_is_dark_theme);
-
-    temp_cursor.beginEditBlock();
-    if (Log::AreConsoleOutputTimestampsEnabled())
-    {
-      const float message_time = Log::GetCurrentMessageTime();
-      const QString qtimestamp = QStringLiteral("[%1] ").arg(message_time, 10, 'f', 4);
-      format.setForeground(QBrush(timestamp_color[dark]));
-      temp_cursor.setCharFormat(format);
-      temp_cursor.insertText(qtimestamp);
-    }
+    PendingMessage& pm = m_pending_messages[read_pos % PENDING_MESSAGE_QUEUE_SIZE];
+    addLines(pm.channel, pm.cat, pm.timestamp, pm.message);
+    pm.message = QString();
+  }
+  m_pending_read_pos.store(read_pos, std::memory_order_release);
 
-    const Log::Level level = Log::UnpackLevel(static_cast<Log::MessageCategory>(cat));
-    const Log::Color color = (Log::UnpackColor(static_cast<Log::MessageCategory>(cat)) == Log::Color::Default) ?
-                               Log::GetColorForLevel(level) :
-                               Log::UnpackColor(static_cast<Log::MessageCategory>(cat));
-    const QString qchannel =
-      (level <= Log::Level::Warning) ?
-        QStringLiteral("%1(%2): ").arg(level_characters[static_cast<size_t>(level)]).arg(channel) :
-        QStringLiteral("%1/%2: ").arg(level_characters[static_cast<size_t>(level)]).arg(channel);
-    format.setForeground(QBrush(channel_color[dark]));
-    temp_cursor.setCharFormat(format);
-    temp_cursor.insertText(qchannel);
-
-    // message has \n already
-    format.setForeground(QBrush(message_colors[dark][static_cast<size_t>(color)]));
-    temp_cursor.setCharFormat(format);
-    temp_cursor.insertText(message);
-    temp_cursor.endEditBlock();
+  if (const u32 dropped = m_dropped_messages.exchange(0, std::memory_order_relaxed); dropped > 0)
+  {
+    addLines(QLatin1StringView(Log::GetChannelName(Log::Channel::Log)),
+             Log::PackCategory(Log::Channel::Log, Log::Level::Warning, Log::Color::StrongYellow), -1.0f,
+             tr("Dropped %1 log messages, please use file or system console logging.").arg(dropped));
   }
 
-  if (cursor_at_end && scroll_at_end)
-    centerCursor();
+  showNewLines(first_new_line);
 }
 
-void LogWidget::logCallback(void* pUserParam, Log::MessageCategory cat, const char* functionName,
-                            std::string_view message)
+void LogWidget::addLines(const QLatin1StringView& channel, quint32 cat, float timestamp, const QString& message)
 {
-  LogWidget* this_ptr = static_cast<LogWidget*>(pUserParam);
+  for (const QStringView line : QStringView(message).tokenize(QChar('\n'), Qt::SkipEmptyParts))
+    m_lines.push_back(Line{line.toString(), channel, timestamp, cat});
+}
 
-  // TODO: Split message based on lines.
-  // I don't like the memory allocations here either...
+void LogWidget::showNewLines(u64 first_new_line)
+{
+  const u64 end_line = m_first_line_number + m_lines.size();
+  if (first_new_line == end_line)
+    return;
 
-  QString qmessage;
-  qmessage.reserve(message.length() + 1);
-  qmessage.append(QUtf8StringView(message.data(), message.length()));
-  qmessage.append(QChar('\n'));
+  QScrollBar* const scrollbar = verticalScrollBar();
+  const bool scroll_at_end = (scrollbar->sliderPosition() == scrollbar->maximum());
 
-  const QLatin1StringView qchannel(
-    (Log::UnpackLevel(cat) <= Log::Level::Warning) ? functionName : Log::GetChannelName(Log::UnpackChannel(cat)));
+  // old lines go first, so the view doesn't have to lay out lines that are about to be removed
+  if (m_lines.size() > MAX_LINES)
+  {
+    const u64 new_first_line = end_line - MAX_LINES;
+    const auto first_kept = std::lower_bound(m_visible_lines.begin(), m_visible_lines.end(), new_first_line);
+    if (first_kept != m_visible_lines.begin())
+    {
+      m_model->beginRemoveRows(QModelIndex(), 0, static_cast<int>(first_kept - m_visible_lines.begin()) - 1);
+      m_visible_lines.erase(m_visible_lines.begin(), first_kept);
+      m_model->endRemoveRows();
+    }
 
-  this_ptr->m_lines_pending.fetch_add(1, std::memory_order_acq_rel);
+    m_lines.erase(m_lines.begin(), m_lines.begin() + static_cast<size_t>(new_first_line - m_first_line_number));
+    m_first_line_number = new_first_line;
+    first_new_line = std::max(first_new_line, new_first_line);
+  }
 
-  if (QThread::isMainThread())
+  std::vector<u64> new_visible_lines;
+  for (u64 line_number = first_new_line; line_number < end_line; line_number++)
   {
-    this_ptr->appendMessage(qchannel, static_cast<u32>(cat), qmessage);
+    if (matchesFilter(m_lines[static_cast<size_t>(line_number - m_first_line_number)]))
+      new_visible_lines.push_back(line_number);
   }
-  else
+
+  if (!new_visible_lines.empty())
   {
-    QMetaObject::invokeMethod(this_ptr, &LogWidget::appendMessage, Qt::QueuedConnection, qchannel,
-                              static_cast<quint32>(cat), qmessage);
+    const int first_row = static_cast<int>(m_visible_lines.size());
+    m_model->beginInsertRows(QModelIndex(), first_row, first_row + static_cast<int>(new_visible_lines.size()) - 1);
+    m_visible_lines.insert(m_visible_lines.end(), new_visible_lines.begin(), new_visible_lines.end());
+    m_model->endInsertRows();
   }
+
+  if (scroll_at_end)
+    scrollToBottom();
+}
+
+void LogWidget::logCallback(void* pUserParam, Log::MessageCategory cat, const char* functionName,
+                            std::string_view message)
+{
+  LogWidget* this_ptr = static_cast<LogWidget*>(pUserParam);
+
+  const QLatin1StringView qchannel(
+    (Log::UnpackLevel(cat) <= Log::Level::Warning) ? functionName : Log::GetChannelName(Log::UnpackChannel(cat)));
+  const float timestamp = Log::AreConsoleOutputTimestampsEnabled() ? Log::GetCurrentMessageTime() : -1.0f;
+
+  // callbacks are serialized, so only one thread can be queueing at a time
+  this_ptr->queueMessage(qchannel, static_cast<u32>(cat), timestamp,
+                         QString::fromUtf8(message.data(), static_cast<qsizetype>(message.length())));
 }
 
 LogWindow::LogWindow(bool attach_to_main) : QMainWindow(), m_attached_to_main_window(attach_to_main)
@@ -358,6 +584,12 @@ void LogWindow::createUi()
     filters_menu->clear();
     populateFilterMenu(filters_menu);
   });
+
+  QLineEdit* filter_edit = new QLineEdit(menu);
+  filter_edit->setPlaceholderText(tr("Filter"));
+  filter_edit->setClearButtonEnabled(true);
+  connect(filter_edit, &QLineEdit::textChanged, m_log_widget, &LogWidget::setFilter);
+  menu->setCornerWidget(filter_edit, Qt::TopRightCorner);
 }
 
 void LogWindow::updateLogLevelUi()
@@ -5,39 +5,114 @@
 
 #include "common/log.h"
 
+#include <QtCore/QAbstractListModel>
+#include <QtWidgets/QListView>
 #include <QtWidgets/QMainWindow>
-#include <QtWidgets/QPlainTextEdit>
 
 #include <atomic>
+#include <deque>
+#include <memory>
 #include <span>
 
-class ALIGN_TO_CACHE_LINE LogWidget : public QPlainTextEdit
+class QTimer;
+
+class LogWidget;
+
+/// Rows of the log widget, i.e. the lines which pass the current filter.
+class LogModel final : public QAbstractListModel
+{
+  Q_OBJECT
+
+public:
+  explicit LogModel(LogWidget* parent);
+  ~LogModel() override;
+
+  int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+private:
+  friend LogWidget;
+
+  LogWidget* m_parent;
+};
+
+class ALIGN_TO_CACHE_LINE LogWidget : public QListView
 {
   Q_OBJECT
 
 public:
+  struct Line
+  {
+    QString text;
+    QLatin1StringView channel;
+    float timestamp; ///< Negative if timestamps are disabled.
+    quint32 cat;
+  };
+
   explicit LogWidget(QWidget* parent);
   ~LogWidget();
 
   void appendMessage(const QLatin1StringView& channel, quint32 cat, const QString& message);
+  void clear();
+
+  /// Only shows lines which contain the filter text, in either the channel or message.
+  void setFilter(const QString& filter);
+
+  const Line& getVisibleLine(int row) const;
+  QString getLineText(const Line& line) const;
+  QString toPlainText() const;
+
+  ALWAYS_INLINE bool isDarkTheme() const { return m_is_dark_theme; }
 
 protected:
   void changeEvent(QEvent* event) override;
+  void keyPressEvent(QKeyEvent* event) override;
 
 private:
-  static constexpr int MAX_LINES = 1000;
-  static constexpr int BLOCK_UPDATES_THRESHOLD = 100;
-
-  void realAppendMessage(const QLatin1StringView& channel, quint32 cat, const QString& message);
+  friend LogModel;
+
+  static constexpr u32 MAX_LINES = 10000;
+  static constexpr u32 PENDING_MESSAGE_QUEUE_SIZE = 4096;
+  static constexpr int FLUSH_INTERVAL_MS = 50;
+
+  /// Message from the log callback, waiting for the UI thread to pick it up.
+  struct PendingMessage
+  {
+    QString message;
+    QLatin1StringView channel;
+    float timestamp;
+    quint32 cat;
+  };
+
+  void queueMessage(const QLatin1StringView& channel, quint32 cat, float timestamp, QString message);
+  void scheduleFlush();
+  void flushPendingMessages();
+  void addLines(const QLatin1StringView& channel, quint32 cat, float timestamp, const QString& message);
+  void showNewLines(u64 first_new_line);
+  bool matchesFilter(const Line& line) const;
+  void copySelectionToClipboard();
 
   static void logCallback(void* pUserParam, Log::MessageCategory cat, const char* functionName,
                           std::string_view message);
 
-  int m_lines_to_skip = 0;
+  LogModel* m_model;
+  QTimer* m_flush_timer;
+
+  // Lines are numbered from when the widget was created, so the visible list doesn't need updating when old lines
+  // are removed from the front.
+  std::deque<Line> m_lines;
+  u64 m_first_line_number = 0;
+  std::deque<u64> m_visible_lines;
+  QString m_filter;
 
   bool m_is_dark_theme = false;
 
-  ALIGN_TO_CACHE_LINE std::atomic_int m_lines_pending{0};
+  // Written by whichever thread is logging (callbacks are serialized), read by the UI thread.
+  std::unique_ptr<PendingMessage[]> m_pending_messages;
+  ALIGN_TO_CACHE_LINE std::atomic<u32> m_pending_read_pos{0};
+  ALIGN_TO_CACHE_LINE std::atomic<u32> m_pending_write_pos{0};
+  std::atomic<u32> m_dropped_messages{0};
+  std::atomic_bool m_flush_scheduled{false};
 };
 
 class LogWindow : public QMainWindow
@@ -64,8 +139,6 @@ protected:
 private:
   static constexpr int DEFAULT_WIDTH = 750;
   static constexpr int DEFAULT_HEIGHT = 400;
-  static constexpr int MAX_LINES = 1000;
-  static constexpr int BLOCK_UPDATES_THRESHOLD = 100;
 
   void createUi();
   void updateLogLevelUi();
@@ -185,6 +185,7 @@ MainWindow::~MainWindow()
   Assert(!m_display_widget);
   Assert(!m_debugger_window);
   cancelGameListRefresh();
+  GameList::StopWatchingDirectories();
 
   // we compare here, since recreate destroys the window later
   if (g_main_window == this)
@@ -1589,7 +1590,7 @@ void MainWindow::onGameListEntryContextMenuRequested(const QPoint& point)
       if (entry->IsDisc())
       {
         menu->addAction(tr("Browse ISO..."), [this, qpath]() {
-          ISOBrowserWindow* ib = ISOBrowserWindow::createAndOpenFile(this, qpath);
+          ISOBrowserWindow* ib = ISOBrowserWindow::createAndOpenFile(qpath);
           if (ib)
           {
             ib->setAttribute(Qt::WA_DeleteOnClose);
@@ -2627,6 +2628,8 @@ void MainWindow::connectSignals()
                                                false);
   SettingWidgetBinder::BindWidgetToBoolSetting(nullptr, m_ui.actionDebugShowMDECState, "DebugWindows", "MDEC", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(nullptr, m_ui.actionDebugShowDMAState, "DebugWindows", "DMA", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(nullptr, m_ui.actionDebugShowMemoryUsage, "DebugWindows", "Memory",
+                                               false);
 
   // Set status tip to the same as tooltip for accessibility.
   for (QAction* action : findChildren<QAction*>())
@@ -57,7 +57,7 @@ void MemoryEditorWindow::onSystemResumed()
 
 void MemoryEditorWindow::timerRefresh()
 {
-  m_ui.memoryView->forceRefresh();
+  m_ui.memoryView->refreshChangedRows();
   updateDataInspector();
 }
 
@@ -503,6 +503,7 @@ void MemoryEditorWindow::updateMemoryViewRegion()
     Host::RunOnCoreThread([start_page, end_page]() {
       for (u32 i = start_page; i <= end_page; i++)
       {
+        Bus::MarkRAMPageDirty(i);
         if (Bus::g_ram_code_bits[i])
           CPU::CodeCache::InvalidateBlocksWithPageIndex(i);
       }
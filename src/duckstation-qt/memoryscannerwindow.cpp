@@ -554,12 +554,13 @@ void MemoryScannerWindow::updateResults()
     row++;
   }
 
-  m_ui.scanResultCount->setText((row < static_cast<int>(results.size())) ?
-                                  tr("%1 (only showing first %2)").arg(results.size()).arg(row) :
-                                  QString::number(m_scanner.GetResultCount()));
+  const u32 result_count = m_scanner.GetResultCount();
+  m_ui.scanResultCount->setText((static_cast<u32>(row) < result_count) ?
+                                  tr("%1 (only showing first %2)").arg(result_count).arg(row) :
+                                  QString::number(result_count));
 
-  m_ui.scanResetSearch->setEnabled(!results.empty());
-  m_ui.scanSearchAgain->setEnabled(!results.empty());
+  m_ui.scanResetSearch->setEnabled(result_count > 0);
+  m_ui.scanSearchAgain->setEnabled(result_count > 0);
   m_ui.scanAddWatch->setEnabled(false);
 }
 
@@ -30,7 +30,7 @@ protected:
 private:
   enum : int
   {
-    MAX_DISPLAYED_SCAN_RESULTS = 5000,
+    MAX_DISPLAYED_SCAN_RESULTS = MemoryScan::MAX_LISTED_RESULTS,
     SCAN_INTERVAL = 100,
   };
 
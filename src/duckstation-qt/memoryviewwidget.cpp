@@ -5,6 +5,7 @@
 #include <QtGui/QMouseEvent>
 #include <QtGui/QPainter>
 #include <QtWidgets/QScrollBar>
+#include <algorithm>
 #include <cstring>
 
 #include "moc_memoryviewwidget.cpp"
@@ -71,6 +72,7 @@ void MemoryViewWidget::setData(size_t address_offset, void* data_ptr, size_t dat
   m_edit_callback = edit_callback;
   m_last_data_start_offset = 0;
   m_last_data.clear();
+  m_visible_data.clear();
   adjustContent();
   saveCurrentData();
 }
@@ -279,9 +281,19 @@ void MemoryViewWidget::paintEvent(QPaintEvent* event)
 
   y += m_char_height;
 
+  // timer refreshes only invalidate the rows which changed, so don't bother formatting the rest
+  const QRect& update_rect = event->rect();
+  const auto row_needs_paint = [this, &update_rect](unsigned row) { return rowRect(row).intersects(update_rect); };
+
   const unsigned num_rows = static_cast<unsigned>(m_end_offset - m_start_offset) / m_bytes_per_line;
   for (unsigned row = 0; row <= num_rows; row++)
   {
+    if (!row_needs_paint(row))
+    {
+      y += m_char_height;
+      continue;
+    }
+
     const size_t data_offset = m_start_offset + (row * m_bytes_per_line);
     const unsigned row_address = static_cast<unsigned>(m_address_offset + data_offset);
     const int draw_x = m_char_width / 2 - offsetX;
@@ -325,6 +337,13 @@ void MemoryViewWidget::paintEvent(QPaintEvent* event)
   size_t offset = m_start_offset;
   for (unsigned row = 0; row <= num_rows; row++)
   {
+    if (!row_needs_paint(row))
+    {
+      offset += m_bytes_per_line;
+      y += m_char_height;
+      continue;
+    }
+
     x = lx - offsetX + m_char_width;
     for (unsigned col = 0; col < m_bytes_per_line && offset < m_data_size; col++, offset++)
     {
@@ -384,6 +403,13 @@ void MemoryViewWidget::paintEvent(QPaintEvent* event)
   offset = m_start_offset;
   for (unsigned row = 0; row <= num_rows; row++)
   {
+    if (!row_needs_paint(row))
+    {
+      offset += m_bytes_per_line;
+      y += m_char_height;
+      continue;
+    }
+
     x = lx - offsetX;
     for (unsigned col = 0; col < m_bytes_per_line && offset < m_data_size; col++, offset++)
     {
@@ -524,6 +550,41 @@ void MemoryViewWidget::forceRefresh()
   viewport()->update();
 }
 
+void MemoryViewWidget::refreshChangedRows()
+{
+  if (!m_data)
+    return;
+
+  // The data pointer is the emulated memory itself, so comparing against the bytes from the last check is enough to
+  // find what the CPU has written since, without synchronizing with it. A torn read just means another repaint.
+  const u8* const data = static_cast<const u8*>(m_data) + m_start_offset;
+  const size_t size = m_end_offset - m_start_offset + 1;
+  if (m_visible_data_start_offset != m_start_offset || m_visible_data.size() != size)
+  {
+    m_visible_data_start_offset = m_start_offset;
+    m_visible_data.assign(data, data + size);
+    viewport()->update();
+    return;
+  }
+
+  unsigned row = 0;
+  for (size_t row_offset = 0; row_offset < size; row_offset += m_bytes_per_line, row++)
+  {
+    const size_t row_size = std::min<size_t>(m_bytes_per_line, size - row_offset);
+    if (std::memcmp(&m_visible_data[row_offset], data + row_offset, row_size) == 0)
+      continue;
+
+    std::memcpy(&m_visible_data[row_offset], data + row_offset, row_size);
+    viewport()->update(rowRect(row));
+  }
+}
+
+QRect MemoryViewWidget::rowRect(unsigned row) const
+{
+  // Row text is drawn with its baseline at (row + 2) * char_height, below the header line.
+  return QRect(0, static_cast<int>(row + 1) * m_char_height + 3, viewport()->width(), m_char_height + 2);
+}
+
 void MemoryViewWidget::adjustContent()
 {
   if (!m_data)
@@ -34,6 +34,10 @@ public:
   void saveCurrentData();
   void forceRefresh();
 
+  /// Repaints only the visible rows whose bytes differ from when they were last checked, for periodic refreshes
+  /// while the system is running.
+  void refreshChangedRows();
+
 Q_SIGNALS:
   void topAddressChanged(size_t address);
   void selectedAddressChanged(size_t address);
@@ -55,6 +59,7 @@ private:
   void expandCurrentDataToInclude(size_t offset);
   void adjustScrollToInclude(size_t offset);
   void adjustContent();
+  QRect rowRect(unsigned row) const;
   void notifySelectedAddressChanged();
 
   void* m_data;
@@ -82,4 +87,7 @@ private:
   EditCallback m_edit_callback = nullptr;
   std::vector<u8> m_last_data;
   size_t m_last_data_start_offset = 0;
+
+  std::vector<u8> m_visible_data;
+  size_t m_visible_data_start_offset = 0;
 };
@@ -285,6 +285,7 @@ void QtHost::ProcessShutdown()
   System::ProcessShutdown();
 
   // Ensure log is flushed.
+  Log::SetAsyncOutputParams(false);
   Log::SetFileOutputParams(false, nullptr);
 
   // Clean up CoInitializeEx() from VeryEarlyProcessStartup().
@@ -2855,6 +2856,16 @@ std::optional<DynamicHeapArray<u8>> Host::ReadResourceFile(std::string_view file
   return ret;
 }
 
+std::optional<FileSystem::MappedFile> Host::MapResourceFile(std::string_view filename, bool allow_override,
+                                                            Error* error)
+{
+  const std::string path = QtHost::GetResourcePath(filename, allow_override);
+  std::optional<FileSystem::MappedFile> ret = FileSystem::MapBinaryFile(path.c_str(), error);
+  if (!ret.has_value())
+    Error::AddPrefixFmt(error, "Failed to map resource file '{}': ", filename);
+  return ret;
+}
+
 std::optional<std::string> Host::ReadResourceFileToString(std::string_view filename, bool allow_override, Error* error)
 {
   const std::string path = QtHost::GetResourcePath(filename, allow_override);
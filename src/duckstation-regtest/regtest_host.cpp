@@ -2,21 +2,25 @@
 // SPDX-License-Identifier: CC-BY-NC-ND-4.0
 
 #include "core/achievements.h"
+#include "core/bios.h"
 #include "core/bus.h"
 #include "core/controller.h"
 #include "core/core_private.h"
+#include "core/cpu_code_cache.h"
 #include "core/cpu_core.h"
 #include "core/fullscreenui.h"
 #include "core/fullscreenui_widgets.h"
 #include "core/game_list.h"
 #include "core/gpu.h"
 #include "core/gpu_backend.h"
+#include "core/gpu_dump.h"
 #include "core/gpu_presenter.h"
 #include "core/gpu_thread.h"
 #include "core/host.h"
 #include "core/spu.h"
 #include "core/system.h"
 #include "core/system_private.h"
+#include "core/timing_event.h"
 
 #include "scmversion/scmversion.h"
 
@@ -29,10 +33,14 @@
 #include "common/assert.h"
 #include "common/crash_handler.h"
 #include "common/error.h"
+#include "common/event_trace.h"
+#include "common/fast_hash.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/memory_accounting.h"
 #include "common/memory_settings_interface.h"
 #include "common/path.h"
+#include "common/scoped_guard.h"
 #include "common/sha256_digest.h"
 #include "common/string_util.h"
 #include "common/task_queue.h"
@@ -42,9 +50,24 @@
 
 #include "fmt/format.h"
 
+#include <algorithm>
+#include <cerrno>
 #include <csignal>
 #include <cstdio>
 #include <ctime>
+#include <map>
+#include <vector>
+
+#ifdef _WIN32
+#include "common/windows_headers.h"
+#include <psapi.h>
+#else
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+extern char** environ;
+#endif
 
 LOG_CHANNEL(Host);
 
@@ -58,8 +81,24 @@ static void InitializeEarlyConsole();
 static void HookSignals();
 static bool SetFolders();
 static bool SetNewDataRoot(const std::string& filename);
+static bool LoadBatchList(Error* error);
+static bool SetupBatchShaderCache();
+static bool SetupShaderPackage();
+static void RemovePackagePipelineCaches();
+static int RunBatchWorkers(int argc, char* argv[]);
+static bool RunDisc(SystemBootParameters boot_params);
 static void DumpSystemStateHashes();
+static void DumpBlockProfile();
+static void DumpTimingEventStatistics();
+static void WriteThroughputResults();
+static u64 GetPeakMemoryUsage();
 static std::string GetFrameDumpPath(u32 frame);
+static std::string GetGameSubdirectory(std::string_view filename);
+static void SaveFrameDump(u32 frame_number, Image image);
+static bool RecordFrameHashes(u32 frame_number, const Image* display_image);
+static void RecordRAMHash(u32 frame_number);
+static void LoadReferenceHashes(const std::string& filename);
+static void WriteFrameHashes();
 static void ProcessCoreThreadEvents();
 static void GPUThreadEntryPoint();
 
@@ -71,7 +110,48 @@ struct RegTestHostState
   u32 blocking_cpu_events_pending = 0;
 };
 
+/// Point-in-time counters, the measured window is the difference between two of these.
+struct ThroughputSample
+{
+  Timer::Value time;
+  u64 core_thread_time;
+  u64 gpu_thread_time;
+  u32 frame_number;
+  u32 internal_frame_number;
+};
+
+static ThroughputSample GetThroughputSample();
+
+/// One line of the frame hash log. RAM is only hashed every dump interval frames.
+struct FrameHashRecord
+{
+  u64 vram_hash;
+  u64 display_hash;
+  std::optional<u64> ram_hash;
+};
+
+struct FrameHashState
+{
+  // GPU-side hashes are recorded on the GPU thread, RAM on the CPU thread. They're merged after shutdown.
+  std::vector<std::pair<u32, FrameHashRecord>> gpu_hashes;
+  std::vector<std::pair<u32, u64>> ram_hashes;
+  std::map<u32, FrameHashRecord> reference;
+  u32 gpu_mismatches = 0;
+  u32 ram_mismatches = 0;
+};
+
+#ifdef _WIN32
+using WorkerProcess = HANDLE;
+#else
+using WorkerProcess = pid_t;
+#endif
+
+static std::optional<WorkerProcess> StartWorkerProcess(const std::string& program_path,
+                                                       const std::vector<std::string>& args, Error* error);
+static bool WaitForWorkerProcess(WorkerProcess process);
+
 static RegTestHostState s_state;
+static FrameHashState s_frame_hash_state;
 ALIGN_TO_CACHE_LINE static TaskQueue s_async_task_queue;
 
 } // namespace RegTestHost
@@ -83,6 +163,21 @@ static u32 s_frames_to_run = 60 * 60;
 static u32 s_frames_remaining = 0;
 static u32 s_frame_dump_interval = 0;
 static std::string s_dump_base_directory;
+static u32 s_block_profile_count = 0;
+static bool s_timing_event_statistics = false;
+static u32 s_benchmark_passes = 0;
+static std::string s_throughput_output_path;
+static u32 s_throughput_warmup_frames = 60 * 10;
+static RegTestHost::ThroughputSample s_throughput_start = {};
+static std::string s_trace_output_path;
+static std::string s_input_replay_path;
+static bool s_frame_hashes = false;
+static std::string s_hash_reference_directory;
+static std::string s_batch_list_path;
+static std::vector<std::string> s_batch_discs;
+static u32 s_batch_jobs = 1;
+static std::optional<u32> s_batch_worker_index;
+static std::string s_shader_package_directory;
 
 bool RegTestHost::SetFolders()
 {
@@ -263,6 +358,13 @@ std::optional<DynamicHeapArray<u8>> Host::ReadResourceFile(std::string_view file
   return FileSystem::ReadBinaryFile(path.c_str(), error);
 }
 
+std::optional<FileSystem::MappedFile> Host::MapResourceFile(std::string_view filename, bool allow_override,
+                                                            Error* error)
+{
+  const std::string path(Path::Combine(EmuFolders::Resources, filename));
+  return FileSystem::MapBinaryFile(path.c_str(), error);
+}
+
 std::optional<std::string> Host::ReadResourceFileToString(std::string_view filename, bool allow_override, Error* error)
 {
   const std::string path(Path::Combine(EmuFolders::Resources, filename));
@@ -360,10 +462,40 @@ void Host::PumpMessagesOnCoreThread()
 {
   RegTestHost::ProcessCoreThreadEvents();
 
+  if (s_frame_hashes && !System::IsReplayingGPUDump())
+    RegTestHost::RecordRAMHash(System::GetFrameNumber());
+
   s_frames_remaining--;
+  if (!s_throughput_output_path.empty() && s_frames_remaining == s_frames_to_run)
+  {
+    INFO_LOG("Warm-up complete, measuring {} frames.", s_frames_to_run);
+    s_throughput_start = RegTestHost::GetThroughputSample();
+    if (s_timing_event_statistics)
+      TimingEvents::ResetStatistics();
+  }
+
   if (s_frames_remaining == 0)
   {
+    if (!s_throughput_output_path.empty())
+      RegTestHost::WriteThroughputResults();
     RegTestHost::DumpSystemStateHashes();
+    if (s_benchmark_passes > 0)
+    {
+      if (const GPUDump::Player* player = System::GetGPUDumpPlayer())
+        player->LogTimings();
+    }
+    if (s_block_profile_count > 0)
+      RegTestHost::DumpBlockProfile();
+    if (s_timing_event_statistics)
+      RegTestHost::DumpTimingEventStatistics();
+    if (!s_trace_output_path.empty())
+    {
+      EventTrace::StopRecording();
+
+      Error error;
+      if (!EventTrace::ExportChromeTrace(s_trace_output_path.c_str(), &error))
+        ERROR_LOG("Failed to write event trace to '{}': {}", s_trace_output_path, error.GetDescription());
+    }
     System::ShutdownSystem(false);
   }
 }
@@ -488,49 +620,38 @@ void Host::DestroyAuxiliaryRenderWindow(AuxiliaryRenderWindowHandle handle, s32*
 
 void Host::FrameDoneOnGPUThread(GPUBackend* gpu_backend, u32 frame_number)
 {
-  const GPUPresenter& presenter = gpu_backend->GetPresenter();
-  if (s_frame_dump_interval == 0 || (frame_number % s_frame_dump_interval) != 0 || !presenter.HasDisplayTexture())
-    return;
-
-  // Need to take a copy of the display texture.
-  GPUTexture* const read_texture = presenter.GetDisplayTexture();
-  const GSVector4i read_rect = presenter.GetDisplayTextureRect();
-  const u32 read_x = static_cast<u32>(read_rect.x);
-  const u32 read_y = static_cast<u32>(read_rect.y);
-  const u32 read_width = static_cast<u32>(read_rect.width());
-  const u32 read_height = static_cast<u32>(read_rect.height());
-  const ImageFormat read_format = GPUTexture::GetImageFormatForTextureFormat(read_texture->GetFormat());
-  if (read_format == ImageFormat::None)
-    return;
-
-  Image image(read_width, read_height, read_format);
-  std::unique_ptr<GPUDownloadTexture> dltex;
-  if (g_gpu_device->GetFeatures().memory_import)
+  bool dump_frame = (s_frame_dump_interval != 0 && (frame_number % s_frame_dump_interval) == 0);
+  if (s_frame_hashes)
   {
-    dltex = g_gpu_device->CreateDownloadTexture(read_width, read_height, read_texture->GetFormat(), image.GetPixels(),
-                                                image.GetStorageSize(), image.GetPitch());
+    // Interval is used for RAM hashes instead, frames are only dumped when they don't match the reference.
+    dump_frame = false;
   }
-  if (!dltex)
+  else if (!dump_frame)
   {
-    if (!(dltex = g_gpu_device->CreateDownloadTexture(read_width, read_height, read_texture->GetFormat())))
-    {
-      ERROR_LOG("Failed to create {}x{} {} download texture", read_width, read_height,
-                GPUTexture::GetFormatName(read_texture->GetFormat()));
-      return;
-    }
+    return;
   }
 
-  dltex->CopyFromTexture(0, 0, read_texture, read_x, read_y, read_width, read_height, 0, 0, !dltex->IsImported());
-  if (!dltex->ReadTexels(0, 0, read_width, read_height, image.GetPixels(), image.GetPitch()))
+  Image image;
+  Error error;
+  bool has_image = gpu_backend->GetPresenter().HasDisplayTexture();
+  if (has_image && !gpu_backend->GetPresenter().ReadDisplayTexture(&image, &error))
   {
-    ERROR_LOG("Failed to read {}x{} download texture", read_width, read_height);
-    gpu_backend->RestoreDeviceContext();
-    return;
+    ERROR_LOG("Failed to read display texture: {}", error.GetDescription());
+    has_image = false;
   }
 
   // no more GPU calls
   gpu_backend->RestoreDeviceContext();
 
+  if (s_frame_hashes)
+    dump_frame = !RegTestHost::RecordFrameHashes(frame_number, has_image ? &image : nullptr);
+
+  if (dump_frame && has_image)
+    RegTestHost::SaveFrameDump(frame_number, std::move(image));
+}
+
+void RegTestHost::SaveFrameDump(u32 frame_number, Image image)
+{
   Error error;
   const std::string path = RegTestHost::GetFrameDumpPath(frame_number);
   auto fp = FileSystem::OpenManagedCFile(path.c_str(), "wb", &error);
@@ -786,6 +907,304 @@ void RegTestHost::DumpSystemStateHashes()
                               std::span<const u8>(reinterpret_cast<const u8*>(g_vram), VRAM_SIZE))));
 }
 
+void RegTestHost::DumpBlockProfile()
+{
+  Error error;
+  const std::string path = Path::Combine(EmuFolders::DataRoot, "blockprofile.csv");
+  if (!CPU::CodeCache::DumpBlockProfile(path.c_str(), s_block_profile_count, &error))
+    ERROR_LOG("Failed to dump block profile: {}", error.GetDescription());
+}
+
+void RegTestHost::DumpTimingEventStatistics()
+{
+  Error error;
+  const std::string path = Path::Combine(EmuFolders::DataRoot, "eventstats.txt");
+  if (!TimingEvents::DumpStatistics(path.c_str(), &error))
+    ERROR_LOG("Failed to dump timing event statistics: {}", error.GetDescription());
+}
+
+bool RegTestHost::RecordFrameHashes(u32 frame_number, const Image* display_image)
+{
+  // Only the software renderer keeps g_vram up to date, for the other renderers it's the CPU-side copy.
+  FrameHashRecord record = {};
+  record.vram_hash = FastHash::Hash64(g_vram, VRAM_SIZE);
+  if (display_image)
+  {
+    const u32 row_size = display_image->GetWidth() * Image::GetPixelSize(display_image->GetFormat());
+    const u32 header[3] = {display_image->GetWidth(), display_image->GetHeight(),
+                           static_cast<u32>(display_image->GetFormat())};
+
+    FastHash::Hasher64 hasher;
+    hasher.Update(header, sizeof(header));
+    for (u32 y = 0; y < display_image->GetHeight(); y++)
+      hasher.Update(display_image->GetRowPixels(y), row_size);
+    record.display_hash = hasher.Final();
+  }
+
+  s_frame_hash_state.gpu_hashes.emplace_back(frame_number, record);
+
+  // Without a reference there's nothing to compare against, and nothing to dump.
+  if (s_frame_hash_state.reference.empty())
+    return true;
+
+  const auto it = s_frame_hash_state.reference.find(frame_number);
+  if (it != s_frame_hash_state.reference.end() && it->second.vram_hash == record.vram_hash &&
+      it->second.display_hash == record.display_hash)
+  {
+    return true;
+  }
+
+  WARNING_LOG("Frame {} does not match the reference.", frame_number);
+  s_frame_hash_state.gpu_mismatches++;
+  return false;
+}
+
+void RegTestHost::RecordRAMHash(u32 frame_number)
+{
+  static constexpr u32 DEFAULT_RAM_HASH_INTERVAL = 60;
+  const u32 interval = (s_frame_dump_interval > 0) ? s_frame_dump_interval : DEFAULT_RAM_HASH_INTERVAL;
+  if ((frame_number % interval) != 0)
+    return;
+
+  const u64 hash = FastHash::Hash64(Bus::g_ram, Bus::g_ram_size);
+  s_frame_hash_state.ram_hashes.emplace_back(frame_number, hash);
+
+  if (s_frame_hash_state.reference.empty())
+    return;
+
+  const auto it = s_frame_hash_state.reference.find(frame_number);
+  if (it == s_frame_hash_state.reference.end() || it->second.ram_hash != hash)
+  {
+    WARNING_LOG("RAM at frame {} does not match the reference.", frame_number);
+    s_frame_hash_state.ram_mismatches++;
+  }
+}
+
+void RegTestHost::LoadReferenceHashes(const std::string& filename)
+{
+  s_frame_hash_state = {};
+  if (s_hash_reference_directory.empty())
+    return;
+
+  Error error;
+  const std::string path = Path::Combine(Path::Combine(s_hash_reference_directory, GetGameSubdirectory(filename)),
+                                         "frame_hashes.txt");
+  const std::optional<std::string> data = FileSystem::ReadFileToString(path.c_str(), &error);
+  if (!data.has_value())
+  {
+    ERROR_LOG("Failed to read reference hashes from '{}': {}", path, error.GetDescription());
+    return;
+  }
+
+  for (const std::string_view line : StringUtil::SplitString(data.value(), '\n', true))
+  {
+    const std::string_view stripped_line = StringUtil::StripWhitespace(line);
+    if (stripped_line.empty() || stripped_line.starts_with('#'))
+      continue;
+
+    const std::vector<std::string_view> fields = StringUtil::SplitString(stripped_line, ' ', true);
+    const std::optional<u32> frame = (fields.size() == 4) ? StringUtil::FromChars<u32>(fields[0]) : std::nullopt;
+    const std::optional<u64> vram_hash = frame.has_value() ? StringUtil::FromChars<u64>(fields[1], 16) : std::nullopt;
+    const std::optional<u64> display_hash =
+      vram_hash.has_value() ? StringUtil::FromChars<u64>(fields[2], 16) : std::nullopt;
+    if (!display_hash.has_value())
+    {
+      WARNING_LOG("Malformed line in reference hashes: {}", stripped_line);
+      continue;
+    }
+
+    FrameHashRecord& record = s_frame_hash_state.reference[frame.value()];
+    record.vram_hash = vram_hash.value();
+    record.display_hash = display_hash.value();
+    record.ram_hash = (fields[3] != "-") ? StringUtil::FromChars<u64>(fields[3], 16) : std::nullopt;
+  }
+
+  INFO_LOG("Loaded {} reference frame hashes from '{}'.", s_frame_hash_state.reference.size(), path);
+}
+
+void RegTestHost::WriteFrameHashes()
+{
+  std::map<u32, FrameHashRecord> records;
+  for (const auto& [frame, record] : s_frame_hash_state.gpu_hashes)
+    records[frame] = record;
+  for (const auto& [frame, hash] : s_frame_hash_state.ram_hashes)
+    records[frame].ram_hash = hash;
+
+  std::string data;
+  data.reserve(records.size() * 56);
+  data.append("# frame vram display ram\n");
+  for (const auto& [frame, record] : records)
+  {
+    fmt::format_to(std::back_inserter(data), "{} {:016X} {:016X} ", frame, record.vram_hash, record.display_hash);
+    if (record.ram_hash.has_value())
+      fmt::format_to(std::back_inserter(data), "{:016X}\n", record.ram_hash.value());
+    else
+      data.append("-\n");
+  }
+
+  Error error;
+  const std::string path = Path::Combine(EmuFolders::DataRoot, "frame_hashes.txt");
+  if (!FileSystem::WriteStringToFile(path.c_str(), data, &error))
+    ERROR_LOG("Failed to write frame hashes to '{}': {}", path, error.GetDescription());
+
+  if (!s_frame_hash_state.reference.empty())
+  {
+    INFO_LOG("{} frames and {} RAM hashes did not match the reference.", s_frame_hash_state.gpu_mismatches,
+             s_frame_hash_state.ram_mismatches);
+  }
+}
+
+RegTestHost::ThroughputSample RegTestHost::GetThroughputSample()
+{
+  return ThroughputSample{
+    .time = Timer::GetCurrentValue(),
+    .core_thread_time = System::GetCoreThreadHandle().GetCPUTime(),
+    .gpu_thread_time = GPUThread::Internal::GetThreadHandle().GetCPUTime(),
+    .frame_number = System::GetFrameNumber(),
+    .internal_frame_number = System::GetInternalFrameNumber(),
+  };
+}
+
+u64 RegTestHost::GetPeakMemoryUsage()
+{
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS pmc = {};
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+    return 0;
+
+  return static_cast<u64>(pmc.PeakWorkingSetSize);
+#else
+  struct rusage usage = {};
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+
+#ifdef __APPLE__
+  // macOS reports bytes, everything else reports kilobytes.
+  return static_cast<u64>(usage.ru_maxrss);
+#else
+  return static_cast<u64>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+static std::string EscapeJSONString(std::string_view str)
+{
+  std::string ret;
+  ret.reserve(str.size());
+  for (const char ch : str)
+  {
+    switch (ch)
+    {
+      case '"':
+        ret.append("\\\"");
+        break;
+      case '\\':
+        ret.append("\\\\");
+        break;
+      case '\n':
+        ret.append("\\n");
+        break;
+      case '\r':
+        ret.append("\\r");
+        break;
+      case '\t':
+        ret.append("\\t");
+        break;
+      default:
+      {
+        if (static_cast<u8>(ch) < 0x20)
+          fmt::format_to(std::back_inserter(ret), "\\u{:04x}", static_cast<u8>(ch));
+        else
+          ret.push_back(ch);
+      }
+      break;
+    }
+  }
+
+  return ret;
+}
+
+void RegTestHost::WriteThroughputResults()
+{
+  const ThroughputSample end = GetThroughputSample();
+  const double elapsed_seconds = Timer::ConvertValueToSeconds(end.time - s_throughput_start.time);
+  const double frames = static_cast<double>(end.frame_number - s_throughput_start.frame_number);
+  const double internal_frames =
+    static_cast<double>(end.internal_frame_number - s_throughput_start.internal_frame_number);
+  const double vps = frames / elapsed_seconds;
+  const double fps = internal_frames / elapsed_seconds;
+  const double speed = vps / static_cast<double>(System::GetVideoFrameRate()) * 100.0;
+
+  // Same calculation as PerformanceCounters, but over the whole measured window rather than the last second.
+  const double thread_time_scale =
+    100.0 / (elapsed_seconds * static_cast<double>(Threading::GetThreadTicksPerSecond()));
+  const double core_thread_usage =
+    static_cast<double>(end.core_thread_time - s_throughput_start.core_thread_time) * thread_time_scale;
+  const double gpu_thread_usage =
+    static_cast<double>(end.gpu_thread_time - s_throughput_start.gpu_thread_time) * thread_time_scale;
+
+  const CPU::CodeCache::Statistics cc = CPU::CodeCache::GetStatistics();
+
+  std::string json;
+  fmt::format_to(std::back_inserter(json), "{{\n");
+  fmt::format_to(std::back_inserter(json), "  \"version\": \"{}\",\n", EscapeJSONString(g_scm_tag_str));
+  fmt::format_to(std::back_inserter(json), "  \"path\": \"{}\",\n", EscapeJSONString(System::GetGamePath()));
+  fmt::format_to(std::back_inserter(json), "  \"serial\": \"{}\",\n", EscapeJSONString(System::GetGameSerial()));
+  fmt::format_to(std::back_inserter(json), "  \"title\": \"{}\",\n", EscapeJSONString(System::GetGameTitle()));
+  fmt::format_to(std::back_inserter(json), "  \"input_recording\": \"{}\",\n", EscapeJSONString(s_input_replay_path));
+  fmt::format_to(std::back_inserter(json), "  \"cpu_execution_mode\": \"{}\",\n",
+                 Settings::GetCPUExecutionModeName(g_settings.cpu_execution_mode));
+  fmt::format_to(std::back_inserter(json), "  \"renderer\": \"{}\",\n",
+                 Settings::GetRendererName(g_settings.gpu_renderer));
+  fmt::format_to(std::back_inserter(json), "  \"warmup_frames\": {},\n", s_throughput_warmup_frames);
+  fmt::format_to(std::back_inserter(json), "  \"frames\": {},\n", s_frames_to_run);
+  fmt::format_to(std::back_inserter(json), "  \"elapsed_ms\": {:.3f},\n", elapsed_seconds * 1000.0);
+  fmt::format_to(std::back_inserter(json), "  \"vps\": {:.3f},\n", vps);
+  fmt::format_to(std::back_inserter(json), "  \"fps\": {:.3f},\n", fps);
+  fmt::format_to(std::back_inserter(json), "  \"speed\": {:.3f},\n", speed);
+  fmt::format_to(std::back_inserter(json), "  \"core_thread_usage\": {:.3f},\n", core_thread_usage);
+  fmt::format_to(std::back_inserter(json), "  \"gpu_thread_usage\": {:.3f},\n", gpu_thread_usage);
+  fmt::format_to(std::back_inserter(json), "  \"peak_rss_bytes\": {},\n", GetPeakMemoryUsage());
+  fmt::format_to(std::back_inserter(json), "  \"code_cache\": {{\n");
+  fmt::format_to(std::back_inserter(json), "    \"blocks\": {},\n", cc.num_blocks);
+  fmt::format_to(std::back_inserter(json), "    \"compiles\": {},\n", cc.num_compiles);
+  fmt::format_to(std::back_inserter(json), "    \"invalidations\": {},\n", cc.num_invalidations);
+  fmt::format_to(std::back_inserter(json), "    \"evictions\": {},\n", cc.num_evictions);
+  fmt::format_to(std::back_inserter(json), "    \"flushes\": {},\n", cc.num_flushes);
+  fmt::format_to(std::back_inserter(json), "    \"code_used\": {},\n", cc.code_used);
+  fmt::format_to(std::back_inserter(json), "    \"code_size\": {},\n", cc.code_size);
+  fmt::format_to(std::back_inserter(json), "    \"far_code_used\": {},\n", cc.far_code_used);
+  fmt::format_to(std::back_inserter(json), "    \"far_code_size\": {}\n", cc.far_code_size);
+  fmt::format_to(std::back_inserter(json), "  }},\n");
+  fmt::format_to(std::back_inserter(json), "  \"memory\": {{\n");
+  for (size_t i = 0; i < MemoryAccounting::NUM_CATEGORIES; i++)
+  {
+    const MemoryAccounting::Category category = static_cast<MemoryAccounting::Category>(i);
+    const MemoryAccounting::Usage usage = MemoryAccounting::Get(category);
+    fmt::format_to(std::back_inserter(json), "    \"{}\": {{\"host\": {}, \"gpu\": {}}},\n",
+                   MemoryAccounting::GetCategoryIdentifier(category), usage.host_bytes, usage.gpu_bytes);
+  }
+  const MemoryAccounting::Usage total_memory = MemoryAccounting::GetTotal();
+  fmt::format_to(std::back_inserter(json), "    \"total\": {{\"host\": {}, \"gpu\": {}}}\n", total_memory.host_bytes,
+                 total_memory.gpu_bytes);
+  fmt::format_to(std::back_inserter(json), "  }}\n");
+  fmt::format_to(std::back_inserter(json), "}}\n");
+
+  INFO_LOG("Throughput: {:.2f} VPS, {:.2f} FPS, {:.1f}% speed, CPU thread {:.1f}%, GPU thread {:.1f}%", vps, fps,
+           speed, core_thread_usage, gpu_thread_usage);
+
+  if (s_throughput_output_path == "-")
+  {
+    std::fputs(json.c_str(), stdout);
+    std::fflush(stdout);
+    return;
+  }
+
+  Error error;
+  if (!FileSystem::WriteStringToFile(s_throughput_output_path.c_str(), json, &error))
+    ERROR_LOG("Failed to write throughput results to '{}': {}", s_throughput_output_path, error.GetDescription());
+}
+
 void RegTestHost::InitializeEarlyConsole()
 {
   const bool was_console_enabled = Log::IsConsoleOutputEnabled();
@@ -819,8 +1238,28 @@ void RegTestHost::PrintCommandLineHelp(const char* progname)
   std::fprintf(stderr, "  -console: Enables console logging output.\n");
   std::fprintf(stderr, "  -pgxp: Enables PGXP.\n");
   std::fprintf(stderr, "  -pgxp-cpu: Forces PGXP CPU mode.\n");
-  std::fprintf(stderr, "  -renderer <renderer>: Sets the graphics renderer. Default to software.\n");
+  std::fprintf(stderr, "  -blockprofile <count>: Profiles recompiler blocks, dumping the top N to blockprofile.csv.\n");
+  std::fprintf(stderr, "  -eventstats: Counts timing event invocations and reschedules, writing eventstats.txt.\n");
+  std::fprintf(stderr, "  -renderer <renderer>: Sets the graphics renderer. Default to software. Null consumes\n"
+                       "    GPU commands and VRAM transfers without rendering anything.\n");
   std::fprintf(stderr, "  -upscale <multiplier>: Enables upscaled rendering at the specified multiplier.\n");
+  std::fprintf(stderr, "  -benchmark <passes>: Replays a GPU dump N times, logging per-packet timings.\n");
+  std::fprintf(stderr, "  -throughput <path>: Measures emulation throughput over -frames frames without frame\n"
+                       "    dumping, writing the results as JSON to path (- for stdout).\n");
+  std::fprintf(stderr, "  -warmup <frames>: Frames to run before measuring throughput. Defaults to 600.\n");
+  std::fprintf(stderr, "  -trace <path>: Records an event trace of the whole run, writing it as Chrome trace JSON.\n");
+  std::fprintf(stderr, "  -replay <path>: Loads the anchor state of an input recording after booting, and runs\n"
+                       "    until the end of the recording, replaying its input. With -throughput, the warm-up\n"
+                       "    frames are taken from the start of the recording.\n");
+  std::fprintf(stderr, "  -hashes: Writes VRAM and display hashes for every frame, and RAM hashes every\n"
+                       "    -dumpinterval frames (default 60), to frame_hashes.txt instead of dumping frames.\n");
+  std::fprintf(stderr, "  -hashref <dir>: Compares against the frame hashes in a previous -dumpdir, only dumping\n"
+                       "    frames that differ. Implies -hashes.\n");
+  std::fprintf(stderr, "  -batch <path>: Runs every disc listed in path, one per line, in a single process. Blank\n"
+                       "    lines and lines starting with # are ignored, relative paths are relative to the list.\n");
+  std::fprintf(stderr, "  -jobs <count>: Splits the -batch list across this many worker processes.\n");
+  std::fprintf(stderr, "  -shaderpackage <dir>: Writes every shader compiled to a package in dir, which can be\n"
+                       "    shipped in resources/shaderpackage. Existing packages in dir are added to.\n");
   std::fprintf(stderr, "  --: Signals that no more arguments will follow and the remaining\n"
                        "    parameters make up the filename. Use when the filename contains\n"
                        "    spaces or starts with a dash.\n");
@@ -959,6 +1398,146 @@ bool RegTestHost::ParseCommandLineParameters(int argc, char* argv[], std::option
         s_base_settings_interface.SetBoolValue("GPU", "PGXPCPU", true);
         continue;
       }
+      else if (CHECK_ARG_PARAM("-blockprofile"))
+      {
+        s_block_profile_count = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+        if (s_block_profile_count == 0)
+        {
+          ERROR_LOG("Invalid block profile count specified: {}", argv[i]);
+          return false;
+        }
+
+        INFO_LOG("Enabling recompiler block profiling.");
+        s_base_settings_interface.SetBoolValue("CPU", "RecompilerBlockProfiling", true);
+        continue;
+      }
+      else if (CHECK_ARG("-eventstats"))
+      {
+        INFO_LOG("Enabling timing event statistics.");
+        s_timing_event_statistics = true;
+        s_base_settings_interface.SetBoolValue("Debug", "TimingEventStatistics", true);
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-benchmark"))
+      {
+        s_benchmark_passes = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+        if (s_benchmark_passes == 0)
+        {
+          ERROR_LOG("Invalid benchmark pass count specified: {}", argv[i]);
+          return false;
+        }
+
+        // Run the backend on the CPU thread, otherwise the timings only cover queueing the commands.
+        INFO_LOG("Benchmarking GPU dump for {} passes.", s_benchmark_passes);
+        s_base_settings_interface.SetBoolValue("GPU", "UseThread", false);
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-throughput"))
+      {
+        s_throughput_output_path = argv[++i];
+        if (s_throughput_output_path.empty())
+        {
+          ERROR_LOG("Invalid throughput output path specified.");
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-warmup"))
+      {
+        const std::optional<u32> warmup = StringUtil::FromChars<u32>(argv[++i]);
+        if (!warmup.has_value())
+        {
+          ERROR_LOG("Invalid warm-up frame count specified: {}", argv[i]);
+          return false;
+        }
+
+        s_throughput_warmup_frames = warmup.value();
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-trace"))
+      {
+        s_trace_output_path = argv[++i];
+        if (s_trace_output_path.empty())
+        {
+          ERROR_LOG("Invalid trace output path specified.");
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-replay"))
+      {
+        s_input_replay_path = argv[++i];
+        if (s_input_replay_path.empty())
+        {
+          ERROR_LOG("Invalid input recording path specified.");
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG("-hashes"))
+      {
+        s_frame_hashes = true;
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-hashref"))
+      {
+        s_hash_reference_directory = argv[++i];
+        if (s_hash_reference_directory.empty())
+        {
+          ERROR_LOG("Invalid hash reference directory specified.");
+          return false;
+        }
+
+        s_frame_hashes = true;
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-batch"))
+      {
+        s_batch_list_path = argv[++i];
+        if (s_batch_list_path.empty())
+        {
+          ERROR_LOG("Invalid batch list path specified.");
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-jobs"))
+      {
+        s_batch_jobs = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+        if (s_batch_jobs == 0)
+        {
+          ERROR_LOG("Invalid job count specified: {}", argv[i]);
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-batch-worker"))
+      {
+        s_batch_worker_index = StringUtil::FromChars<u32>(argv[++i]);
+        if (!s_batch_worker_index.has_value())
+        {
+          ERROR_LOG("Invalid batch worker index specified: {}", argv[i]);
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-shaderpackage"))
+      {
+        s_shader_package_directory = argv[++i];
+        if (s_shader_package_directory.empty())
+        {
+          ERROR_LOG("Invalid shader package directory specified.");
+          return false;
+        }
+
+        continue;
+      }
       else if (CHECK_ARG("--"))
       {
         no_more_args = true;
@@ -979,6 +1558,44 @@ bool RegTestHost::ParseCommandLineParameters(int argc, char* argv[], std::option
     AutoBoot(autoboot)->path += argv[i];
   }
 
+  if (s_frame_hashes && s_dump_base_directory.empty())
+  {
+    ERROR_LOG("-hashes requires -dumpdir.");
+    return false;
+  }
+
+  if (!s_batch_list_path.empty())
+  {
+    if (autoboot)
+    {
+      ERROR_LOG("A boot path can't be used with -batch, add it to the list instead.");
+      return false;
+    }
+    else if (!s_throughput_output_path.empty() || !s_trace_output_path.empty() || !s_input_replay_path.empty())
+    {
+      // Every disc would write to the same file.
+      ERROR_LOG("-throughput, -trace and -replay can't be used with -batch.");
+      return false;
+    }
+    else if (s_batch_worker_index.value_or(0) >= s_batch_jobs)
+    {
+      ERROR_LOG("Batch worker index {} is out of range for {} jobs.", s_batch_worker_index.value(), s_batch_jobs);
+      return false;
+    }
+  }
+  else if (s_batch_jobs > 1 || s_batch_worker_index.has_value())
+  {
+    ERROR_LOG("-jobs requires -batch.");
+    return false;
+  }
+
+  if (!s_shader_package_directory.empty() && s_batch_jobs > 1)
+  {
+    // Workers can't share the cache files.
+    ERROR_LOG("-shaderpackage can't be used with -jobs.");
+    return false;
+  }
+
   return true;
 }
 
@@ -986,7 +1603,7 @@ bool RegTestHost::SetNewDataRoot(const std::string& filename)
 {
   if (!s_dump_base_directory.empty())
   {
-    std::string game_subdir = Path::SanitizeFileName(Path::GetFileTitle(filename));
+    std::string game_subdir = GetGameSubdirectory(filename);
     INFO_LOG("Writing to subdirectory '{}'", game_subdir);
 
     std::string dump_directory = Path::Combine(s_dump_base_directory, game_subdir);
@@ -1002,65 +1619,251 @@ bool RegTestHost::SetNewDataRoot(const std::string& filename)
     EmuFolders::DataRoot = std::move(dump_directory);
     s_base_settings_interface.SetBoolValue("Logging", "LogToFile", true);
     s_base_settings_interface.SetStringValue("Logging", "LogLevel", Settings::GetLogLevelName(Log::Level::Dev));
+
+    // In batch mode the previous disc's log is still open, and a new file is only opened when logging is enabled.
+    Log::SetFileOutputParams(false, nullptr);
     Settings::UpdateLogConfig(s_base_settings_interface);
   }
 
   return true;
 }
 
+std::string RegTestHost::GetGameSubdirectory(std::string_view filename)
+{
+  return Path::SanitizeFileName(Path::GetFileTitle(filename));
+}
+
 std::string RegTestHost::GetFrameDumpPath(u32 frame)
 {
   return Path::Combine(EmuFolders::DataRoot, fmt::format("frame_{:05d}.png", frame));
 }
 
-int main(int argc, char* argv[])
+bool RegTestHost::LoadBatchList(Error* error)
 {
-  CrashHandler::Install(&Bus::CleanupMemoryMap);
+  std::optional<std::string> list = FileSystem::ReadFileToString(s_batch_list_path.c_str(), error);
+  if (!list.has_value())
+    return false;
 
-  Error startup_error;
-  if (!System::PerformEarlyHardwareChecks(&startup_error) || !System::ProcessStartup(&startup_error))
+  const std::string_view list_directory = Path::GetDirectory(s_batch_list_path);
+  for (const std::string_view line : StringUtil::SplitString(list.value(), '\n', true))
   {
-    ERROR_LOG("ProcessStartup() failed: {}", startup_error.GetDescription());
-    return EXIT_FAILURE;
+    const std::string_view path = StringUtil::StripWhitespace(line);
+    if (path.empty() || path.starts_with('#'))
+      continue;
+
+    s_batch_discs.push_back(Path::IsAbsolute(path) ? std::string(path) : Path::Combine(list_directory, path));
   }
 
-  RegTestHost::InitializeEarlyConsole();
+  if (s_batch_discs.empty())
+  {
+    Error::SetStringView(error, "Batch list does not contain any discs.");
+    return false;
+  }
 
-  if (!RegTestHost::InitializeConfig())
-    return EXIT_FAILURE;
+  return true;
+}
 
-  std::optional<SystemBootParameters> autoboot;
-  if (!RegTestHost::ParseCommandLineParameters(argc, argv, autoboot))
-    return EXIT_FAILURE;
+bool RegTestHost::SetupBatchShaderCache()
+{
+  // The device is still recreated for every disc, but with the cache enabled only the first boot pays for compiling
+  // shaders. Each worker gets its own directory, since the cache files can't be shared between processes.
+  EmuFolders::Cache =
+    Path::Combine(EmuFolders::Cache, fmt::format("regtest_worker{}", s_batch_worker_index.value_or(0)));
+  if (!FileSystem::EnsureDirectoryExists(EmuFolders::Cache.c_str(), false))
+  {
+    ERROR_LOG("Failed to create cache directory '{}'", EmuFolders::Cache);
+    return false;
+  }
 
-  if (!autoboot || autoboot->path.empty())
+  s_base_settings_interface.SetBoolValue("GPU", "DisableShaderCache", false);
+  return true;
+}
+
+bool RegTestHost::SetupShaderPackage()
+{
+  // The package is just a shader cache, so the device fills it in as shaders get compiled. Anything which comes from
+  // an existing package is copied in too, so regenerating one never loses entries.
+  if (!FileSystem::EnsureDirectoryExists(s_shader_package_directory.c_str(), false))
   {
-    ERROR_LOG("No boot path specified.");
-    return EXIT_FAILURE;
+    ERROR_LOG("Failed to create shader package directory '{}'", s_shader_package_directory);
+    return false;
   }
 
-  if (!RegTestHost::SetNewDataRoot(autoboot->path))
-    return EXIT_FAILURE;
+  INFO_LOG("Writing shader package to '{}'...", s_shader_package_directory);
+  EmuFolders::Cache = s_shader_package_directory;
+  s_base_settings_interface.SetBoolValue("GPU", "DisableShaderCache", false);
+  return true;
+}
 
-  if (!System::CoreThreadInitialize(&startup_error))
+void RegTestHost::RemovePackagePipelineCaches()
+{
+  // Pipeline caches are specific to the driver they were built with, so they don't belong in the package.
+  FileSystem::FindResultsArray files;
+  FileSystem::FindFiles(s_shader_package_directory.c_str(), "*_pipelines*.bin", FILESYSTEM_FIND_FILES, &files);
+  for (const FILESYSTEM_FIND_DATA& fd : files)
   {
-    ERROR_LOG("CoreThreadInitialize() failed: {}", startup_error.GetDescription());
-    return EXIT_FAILURE;
+    if (!FileSystem::DeleteFile(fd.FileName.c_str()))
+      WARNING_LOG("Failed to remove pipeline cache '{}'", Path::GetFileName(fd.FileName));
   }
+}
 
-  // Only one async worker, keep the CPU usage down so we can parallelize execution of regtest itself.
-  RegTestHost::s_async_task_queue.SetWorkerCount(1);
+int RegTestHost::RunBatchWorkers(int argc, char* argv[])
+{
+  const std::string program_path = FileSystem::GetProgramPath();
 
-  RegTestHost::HookSignals();
-  s_gpu_thread.Start(&RegTestHost::GPUThreadEntryPoint);
+  // Workers get the same parameters, they pick their share of the list from the index.
+  std::vector<std::string> args;
+  args.reserve(static_cast<size_t>(argc) + 2);
+  args.emplace_back(program_path);
+  args.emplace_back("-batch-worker");
+  args.emplace_back();
+  for (int i = 1; i < argc; i++)
+    args.emplace_back(argv[i]);
+
+  const u32 num_workers = std::min(s_batch_jobs, static_cast<u32>(s_batch_discs.size()));
+  INFO_LOG("Running {} discs across {} workers...", s_batch_discs.size(), num_workers);
+
+  std::vector<WorkerProcess> workers;
+  workers.reserve(num_workers);
+  bool result = true;
+  for (u32 i = 0; i < num_workers; i++)
+  {
+    args[2] = fmt::format("{}", i);
+
+    Error error;
+    std::optional<WorkerProcess> worker = StartWorkerProcess(program_path, args, &error);
+    if (!worker.has_value())
+    {
+      ERROR_LOG("Failed to start worker {}: {}", i, error.GetDescription());
+      result = false;
+      break;
+    }
+
+    workers.push_back(worker.value());
+  }
+
+  for (size_t i = 0; i < workers.size(); i++)
+  {
+    if (!WaitForWorkerProcess(workers[i]))
+    {
+      ERROR_LOG("Worker {} failed.", i);
+      result = false;
+    }
+  }
+
+  return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#ifdef _WIN32
+
+std::optional<RegTestHost::WorkerProcess> RegTestHost::StartWorkerProcess(const std::string& program_path,
+                                                                         const std::vector<std::string>& args,
+                                                                         Error* error)
+{
+  // Quote everything, following the rules CommandLineToArgvW() uses to split it back up.
+  std::wstring command_line;
+  for (const std::string& arg : args)
+  {
+    if (!command_line.empty())
+      command_line.push_back(L' ');
+
+    command_line.push_back(L'"');
+    size_t num_backslashes = 0;
+    for (const wchar_t ch : StringUtil::UTF8StringToWideString(arg))
+    {
+      if (ch == L'\\')
+      {
+        num_backslashes++;
+        continue;
+      }
+
+      command_line.append((ch == L'"') ? (num_backslashes * 2 + 1) : num_backslashes, L'\\');
+      command_line.push_back(ch);
+      num_backslashes = 0;
+    }
+    command_line.append(num_backslashes * 2, L'\\');
+    command_line.push_back(L'"');
+  }
+
+  STARTUPINFOW si = {};
+  si.cb = sizeof(si);
+  PROCESS_INFORMATION pi = {};
+  if (!CreateProcessW(StringUtil::UTF8StringToWideString(program_path).c_str(), command_line.data(), nullptr, nullptr,
+                      FALSE, 0, nullptr, nullptr, &si, &pi))
+  {
+    Error::SetWin32(error, "CreateProcessW() failed: ", GetLastError());
+    return std::nullopt;
+  }
+
+  CloseHandle(pi.hThread);
+  return pi.hProcess;
+}
+
+bool RegTestHost::WaitForWorkerProcess(WorkerProcess process)
+{
+  DWORD exit_code = 0;
+  const bool result = (WaitForSingleObject(process, INFINITE) == WAIT_OBJECT_0 &&
+                       GetExitCodeProcess(process, &exit_code) && exit_code == 0);
+  CloseHandle(process);
+  return result;
+}
+
+#else
+
+std::optional<RegTestHost::WorkerProcess> RegTestHost::StartWorkerProcess(const std::string& program_path,
+                                                                         const std::vector<std::string>& args,
+                                                                         Error* error)
+{
+  std::vector<char*> argv;
+  argv.reserve(args.size() + 1);
+  for (const std::string& arg : args)
+    argv.push_back(const_cast<char*>(arg.c_str()));
+  argv.push_back(nullptr);
+
+  pid_t pid;
+  const int res = posix_spawn(&pid, program_path.c_str(), nullptr, nullptr, argv.data(), environ);
+  if (res != 0)
+  {
+    Error::SetErrno(error, "posix_spawn() failed: ", res);
+    return std::nullopt;
+  }
+
+  return pid;
+}
+
+bool RegTestHost::WaitForWorkerProcess(WorkerProcess process)
+{
+  int status;
+  while (waitpid(process, &status, 0) < 0)
+  {
+    if (errno != EINTR)
+      return false;
+  }
+
+  return (WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+#endif
+
+bool RegTestHost::RunDisc(SystemBootParameters boot_params)
+{
+  // GPU dumps and benchmark mode adjust these for the disc being run.
+  const u32 frames_to_run = s_frames_to_run;
+  const u32 frame_dump_interval = s_frame_dump_interval;
+  const ScopedGuard restore_frame_counts([frames_to_run, frame_dump_interval]() {
+    s_frames_to_run = frames_to_run;
+    s_frame_dump_interval = frame_dump_interval;
+  });
+
+  if (s_frame_hashes)
+    LoadReferenceHashes(boot_params.path);
 
   Error error;
-  int result = -1;
-  INFO_LOG("Trying to boot '{}'...", autoboot->path);
-  if (!System::BootSystem(std::move(autoboot.value()), &error))
+  INFO_LOG("Trying to boot '{}'...", boot_params.path);
+  if (!System::BootSystem(std::move(boot_params), &error))
   {
     ERROR_LOG("Failed to boot system: {}", error.GetDescription());
-    goto cleanup;
+    return false;
   }
 
   if (System::IsReplayingGPUDump() && !s_dump_base_directory.empty())
@@ -1070,12 +1873,66 @@ int main(int argc, char* argv[])
     s_frames_to_run = static_cast<u32>(System::GetGPUDumpFrameCount());
   }
 
+  if (!s_input_replay_path.empty())
+  {
+    if (!System::StartInputPlayback(s_input_replay_path.c_str(), &error))
+    {
+      ERROR_LOG("Failed to start input playback: {}", error.GetDescription());
+      System::ShutdownSystem(false);
+      return false;
+    }
+
+    // The recording decides how long the run is, warm-up included.
+    const u32 replay_frames = System::GetInputPlaybackFrameCount();
+    if (!s_throughput_output_path.empty())
+    {
+      if (replay_frames <= s_throughput_warmup_frames)
+      {
+        ERROR_LOG("Input recording is only {} frames, which doesn't cover {} warm-up frames.", replay_frames,
+                  s_throughput_warmup_frames);
+        System::ShutdownSystem(false);
+        return false;
+      }
+
+      s_frames_to_run = replay_frames - s_throughput_warmup_frames;
+    }
+    else
+    {
+      s_frames_to_run = replay_frames;
+    }
+  }
+
+  if (s_benchmark_passes > 0)
+  {
+    GPUDump::Player* const player = System::GetGPUDumpPlayer();
+    if (!player)
+    {
+      ERROR_LOG("Benchmark mode requires a GPU dump.");
+      System::ShutdownSystem(false);
+      return false;
+    }
+
+    // Frame dumps would dominate the timings.
+    s_frame_dump_interval = 0;
+    s_frames_to_run = static_cast<u32>(player->GetFrameCount()) * s_benchmark_passes;
+    player->SetTimingEnabled(true);
+  }
+
+  if (!s_throughput_output_path.empty())
+  {
+    // Frame dumps would dominate the timings, and the runner is already unthrottled.
+    INFO_LOG("Measuring throughput over {} frames after {} warm-up frames.", s_frames_to_run,
+             s_throughput_warmup_frames);
+    s_frame_dump_interval = 0;
+  }
+
   if (s_frame_dump_interval > 0)
   {
     if (s_dump_base_directory.empty())
     {
       ERROR_LOG("Dump directory not specified.");
-      goto cleanup;
+      System::ShutdownSystem(false);
+      return false;
     }
 
     INFO_LOG("Dumping every {}th frame to '{}'.", s_frame_dump_interval, s_dump_base_directory);
@@ -1083,23 +1940,138 @@ int main(int argc, char* argv[])
 
   INFO_LOG("Running for {} frames...", s_frames_to_run);
   s_frames_remaining = s_frames_to_run;
+  if (!s_throughput_output_path.empty())
+  {
+    s_frames_remaining += s_throughput_warmup_frames;
+    if (s_throughput_warmup_frames == 0)
+      s_throughput_start = RegTestHost::GetThroughputSample();
+  }
 
+  if (!s_trace_output_path.empty())
   {
-    const Timer::Value start_time = Timer::GetCurrentValue();
+    INFO_LOG("Recording event trace to '{}'.", s_trace_output_path);
+    EventTrace::StartRecording();
+  }
+
+  const Timer::Value start_time = Timer::GetCurrentValue();
+
+  System::Execute();
+
+  const Timer::Value elapsed_time = Timer::GetCurrentValue() - start_time;
+  const double elapsed_time_ms = Timer::ConvertValueToMilliseconds(elapsed_time);
+  INFO_LOG("Total execution time: {:.2f}ms, average frame time {:.2f}ms, {:.2f} FPS", elapsed_time_ms,
+           elapsed_time_ms / static_cast<double>(s_frames_to_run),
+           static_cast<double>(s_frames_to_run) / elapsed_time_ms * 1000.0);
 
-    System::Execute();
+  // The GPU thread is idle once the system has shut down, so all frames have been hashed.
+  if (s_frame_hashes)
+    WriteFrameHashes();
+
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  CrashHandler::Install(&Bus::CleanupMemoryMap);
 
-    const Timer::Value elapsed_time = Timer::GetCurrentValue() - start_time;
-    const double elapsed_time_ms = Timer::ConvertValueToMilliseconds(elapsed_time);
-    INFO_LOG("Total execution time: {:.2f}ms, average frame time {:.2f}ms, {:.2f} FPS", elapsed_time_ms,
-             elapsed_time_ms / static_cast<double>(s_frames_to_run),
-             static_cast<double>(s_frames_to_run) / elapsed_time_ms * 1000.0);
+  Error startup_error;
+  if (!System::PerformEarlyHardwareChecks(&startup_error) || !System::ProcessStartup(&startup_error))
+  {
+    ERROR_LOG("ProcessStartup() failed: {}", startup_error.GetDescription());
+    return EXIT_FAILURE;
+  }
+
+  RegTestHost::InitializeEarlyConsole();
+
+  if (!RegTestHost::InitializeConfig())
+    return EXIT_FAILURE;
+
+  std::optional<SystemBootParameters> autoboot;
+  if (!RegTestHost::ParseCommandLineParameters(argc, argv, autoboot))
+    return EXIT_FAILURE;
+
+  const bool batch = !s_batch_list_path.empty();
+  if (batch)
+  {
+    if (!RegTestHost::LoadBatchList(&startup_error))
+    {
+      ERROR_LOG("Failed to load batch list '{}': {}", s_batch_list_path, startup_error.GetDescription());
+      return EXIT_FAILURE;
+    }
+
+    if (s_batch_jobs > 1 && !s_batch_worker_index.has_value())
+    {
+      const int result = RegTestHost::RunBatchWorkers(argc, argv);
+      System::ProcessShutdown();
+      return result;
+    }
+
+    // The game database is already only parsed once per process, the BIOS and shaders need opting in.
+    BIOS::SetImageCacheEnabled(true);
+    if (!RegTestHost::SetupBatchShaderCache())
+      return EXIT_FAILURE;
+  }
+  else
+  {
+    if (!autoboot || autoboot->path.empty())
+    {
+      ERROR_LOG("No boot path specified.");
+      return EXIT_FAILURE;
+    }
+
+    if (!RegTestHost::SetNewDataRoot(autoboot->path))
+      return EXIT_FAILURE;
+  }
+
+  if (!s_shader_package_directory.empty() && !RegTestHost::SetupShaderPackage())
+    return EXIT_FAILURE;
+
+  if (!System::CoreThreadInitialize(&startup_error))
+  {
+    ERROR_LOG("CoreThreadInitialize() failed: {}", startup_error.GetDescription());
+    return EXIT_FAILURE;
   }
 
-  INFO_LOG("Exiting with success.");
-  result = 0;
+  // Only one async worker, keep the CPU usage down so we can parallelize execution of regtest itself.
+  RegTestHost::s_async_task_queue.SetWorkerCount(1);
+
+  RegTestHost::HookSignals();
+  s_gpu_thread.Start(&RegTestHost::GPUThreadEntryPoint);
+
+  int result = -1;
+  if (batch)
+  {
+    // Discs are dealt out round-robin, the list order is usually unrelated to how long each one takes.
+    const u32 worker_index = s_batch_worker_index.value_or(0);
+    std::vector<std::string_view> failed_discs;
+    u32 num_discs = 0;
+    for (size_t i = worker_index; i < s_batch_discs.size(); i += s_batch_jobs)
+    {
+      const std::string& path = s_batch_discs[i];
+      num_discs++;
+
+      SystemBootParameters boot_params;
+      boot_params.path = path;
+      if (!RegTestHost::SetNewDataRoot(path) || !RegTestHost::RunDisc(std::move(boot_params)))
+        failed_discs.push_back(path);
+
+      // Frame dumps for this disc have to land before switching directories.
+      RegTestHost::s_async_task_queue.WaitForAll();
+    }
+
+    for (const std::string_view path : failed_discs)
+      ERROR_LOG("Failed: {}", path);
+
+    INFO_LOG("Batch complete, {} of {} discs succeeded.", num_discs - static_cast<u32>(failed_discs.size()),
+             num_discs);
+    result = failed_discs.empty() ? 0 : -1;
+  }
+  else if (RegTestHost::RunDisc(std::move(autoboot.value())))
+  {
+    INFO_LOG("Exiting with success.");
+    result = 0;
+  }
 
-cleanup:
   if (s_gpu_thread.Joinable())
   {
     GPUThread::Internal::RequestShutdown();
@@ -1111,5 +2083,9 @@ cleanup:
   RegTestHost::ProcessCoreThreadEvents();
   System::CoreThreadShutdown();
   System::ProcessShutdown();
+
+  if (!s_shader_package_directory.empty())
+    RegTestHost::RemovePackagePipelineCaches();
+
   return result;
 }
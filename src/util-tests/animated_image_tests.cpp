@@ -6,6 +6,7 @@
 #include "common/error.h"
 
 #include <gtest/gtest.h>
+#include <cstring>
 #include <vector>
 
 namespace {
@@ -718,3 +719,57 @@ TEST_F(AnimatedImageTest, ResizeBetweenSingleAndMultipleFrames)
     EXPECT_EQ(img.GetPixels(0)[i], 0xFF000000u | i);
   }
 }
+
+TEST_F(AnimatedImageTest, StreamMatchesFullDecode)
+{
+  const u32 width = 16;
+  const u32 height = 12;
+  const u32 frames = 5;
+
+  AnimatedImage original = CreateTestImage(width, height, frames);
+  for (u32 f = 0; f < frames; f++)
+    original.SetDelay(f, {static_cast<u16>(f + 1), 60});
+
+  auto buffer = original.SaveToBuffer("test_stream.png");
+  ASSERT_TRUE(buffer.has_value());
+
+  // Window is smaller than the frame count, so the worker has to wait for the reader and loop around.
+  AnimatedImageStream stream;
+  Error error;
+  ASSERT_TRUE(stream.OpenBuffer("test_stream.png", std::move(buffer.value()), 2, &error)) << error.GetDescription();
+  EXPECT_EQ(stream.GetWidth(), width);
+  EXPECT_EQ(stream.GetHeight(), height);
+  EXPECT_EQ(stream.GetFrames(), frames);
+
+  for (u32 i = 0; i < frames * 2 + 1; i++)
+  {
+    const u32 f = i % frames;
+    AnimatedImage::FrameDelay delay;
+    const AnimatedImage::PixelType* pixels = stream.GetNextFrame(&delay, &error);
+    ASSERT_NE(pixels, nullptr) << error.GetDescription();
+    EXPECT_EQ(delay.numerator, f + 1);
+    EXPECT_EQ(delay.denominator, 60u);
+    EXPECT_EQ(std::memcmp(pixels, original.GetPixels(f), width * height * sizeof(u32)), 0) << "frame " << i;
+  }
+
+  stream.Close();
+  EXPECT_FALSE(stream.IsOpen());
+  EXPECT_EQ(stream.GetNextFrame(), nullptr);
+}
+
+TEST_F(AnimatedImageTest, StreamSingleFrame)
+{
+  AnimatedImage original = CreateTestImage(8, 8);
+  auto buffer = original.SaveToBuffer("test_still.png");
+  ASSERT_TRUE(buffer.has_value());
+
+  AnimatedImageStream stream;
+  ASSERT_TRUE(stream.OpenBuffer("test_still.png", std::move(buffer.value())));
+  EXPECT_EQ(stream.GetFrames(), 1u);
+
+  // Still images keep returning the same frame.
+  const AnimatedImage::PixelType* first = stream.GetNextFrame();
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(stream.GetNextFrame(), first);
+  EXPECT_EQ(std::memcmp(first, original.GetPixels(0), 8 * 8 * sizeof(u32)), 0);
+}
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "util/audio_resampler.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+static void TestProcess(u32 input_rate, u32 output_rate)
+{
+  PolyphaseResampler expected;
+  PolyphaseResampler actual;
+  ASSERT_TRUE(expected.Init(input_rate, output_rate));
+  ASSERT_TRUE(actual.Init(input_rate, output_rate));
+
+  std::mt19937 rng(0x12345678);
+  std::vector<s16> input(expected.GetMaxInputFrames() * PolyphaseResampler::NUM_CHANNELS);
+  std::vector<s16> expected_output(PolyphaseResampler::MAX_OUTPUT_FRAMES * PolyphaseResampler::NUM_CHANNELS);
+  std::vector<s16> actual_output(PolyphaseResampler::MAX_OUTPUT_FRAMES * PolyphaseResampler::NUM_CHANNELS);
+
+  // Varying block sizes leave the phase at different positions. Full-scale noise exercises the clamping.
+  for (u32 iteration = 0; iteration < 64; iteration++)
+  {
+    const u32 num_out_frames = (rng() % PolyphaseResampler::MAX_OUTPUT_FRAMES) + 1;
+    const u32 num_in_frames = expected.GetInputFramesForOutput(num_out_frames);
+    ASSERT_EQ(actual.GetInputFramesForOutput(num_out_frames), num_in_frames);
+    ASSERT_LE(num_in_frames, expected.GetMaxInputFrames());
+    for (u32 i = 0; i < num_in_frames * PolyphaseResampler::NUM_CHANNELS; i++)
+      input[i] = static_cast<s16>(rng());
+
+    expected.ProcessScalar(input.data(), num_in_frames, expected_output.data(), num_out_frames);
+    actual.Process(input.data(), num_in_frames, actual_output.data(), num_out_frames);
+    for (u32 i = 0; i < num_out_frames * PolyphaseResampler::NUM_CHANNELS; i++)
+      ASSERT_EQ(actual_output[i], expected_output[i]) << "sample " << i << " iteration " << iteration;
+  }
+}
+
+TEST(PolyphaseResampler, Upsample48000)
+{
+  TestProcess(44100, 48000);
+}
+
+TEST(PolyphaseResampler, Upsample96000)
+{
+  TestProcess(44100, 96000);
+}
+
+TEST(PolyphaseResampler, Downsample32000)
+{
+  TestProcess(44100, 32000);
+}
+
+TEST(PolyphaseResampler, PassesDC)
+{
+  PolyphaseResampler resampler;
+  ASSERT_TRUE(resampler.Init(44100, 48000));
+
+  std::vector<s16> input(resampler.GetMaxInputFrames() * PolyphaseResampler::NUM_CHANNELS);
+  std::vector<s16> output(PolyphaseResampler::MAX_OUTPUT_FRAMES * PolyphaseResampler::NUM_CHANNELS);
+  for (u32 i = 0; i < input.size(); i += PolyphaseResampler::NUM_CHANNELS)
+  {
+    input[i + 0] = 10000;
+    input[i + 1] = -10000;
+  }
+
+  // Skip past the silence the filter starts with.
+  for (u32 iteration = 0; iteration < 4; iteration++)
+  {
+    const u32 num_in_frames = resampler.GetInputFramesForOutput(PolyphaseResampler::MAX_OUTPUT_FRAMES);
+    resampler.Process(input.data(), num_in_frames, output.data(), PolyphaseResampler::MAX_OUTPUT_FRAMES);
+  }
+
+  for (u32 i = 0; i < output.size(); i += PolyphaseResampler::NUM_CHANNELS)
+  {
+    ASSERT_EQ(output[i + 0], 10000) << "frame " << (i / PolyphaseResampler::NUM_CHANNELS);
+    ASSERT_EQ(output[i + 1], -10000) << "frame " << (i / PolyphaseResampler::NUM_CHANNELS);
+  }
+}
+
+TEST(PolyphaseResampler, RejectsUnsupportedRatios)
+{
+  PolyphaseResampler resampler;
+  EXPECT_FALSE(resampler.Init(44100, 0));
+  EXPECT_FALSE(resampler.Init(44100, 8000));
+  EXPECT_FALSE(resampler.Init(44100, 44101));
+  EXPECT_FALSE(resampler.IsActive());
+}
@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "util/audio_ring_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <thread>
+
+static constexpr u32 NUM_CHANNELS = 2;
+
+TEST(AudioRingBuffer, WrapAround)
+{
+  AudioRingBuffer ring;
+  ring.Allocate(64, NUM_CHANNELS);
+  ASSERT_EQ(ring.GetWritableFrames(), 63u);
+
+  // Odd sizes move the positions across the end of the buffer at different offsets.
+  std::array<s16, 48 * NUM_CHANNELS> in;
+  std::array<s16, 48 * NUM_CHANNELS> out;
+  s16 next = 0;
+  for (u32 iteration = 0; iteration < 32; iteration++)
+  {
+    const u32 num_frames = 17 + (iteration % 31);
+    for (u32 i = 0; i < num_frames * NUM_CHANNELS; i++)
+      in[i] = next++;
+
+    ring.Write(in.data(), num_frames);
+    ASSERT_EQ(ring.GetReadableFrames(), num_frames);
+    ring.Read(out.data(), num_frames);
+    for (u32 i = 0; i < num_frames * NUM_CHANNELS; i++)
+      ASSERT_EQ(out[i], in[i]) << "sample " << i << " iteration " << iteration;
+
+    ASSERT_EQ(ring.GetBufferedFramesRelaxed(), 0u);
+  }
+}
+
+TEST(AudioRingBuffer, DiscardIsAppliedByConsumer)
+{
+  AudioRingBuffer ring;
+  ring.Allocate(64, NUM_CHANNELS);
+
+  std::array<s16, 32 * NUM_CHANNELS> in;
+  for (u32 i = 0; i < in.size(); i++)
+    in[i] = static_cast<s16>(i);
+  ring.Write(in.data(), 32);
+
+  // Nothing moves until the consumer next looks at the ring, and it can't skip more than has been written.
+  ring.RequestDiscard(8);
+  ASSERT_EQ(ring.GetBufferedFramesRelaxed(), 32u);
+  ASSERT_EQ(ring.GetReadableFrames(), 24u);
+
+  std::array<s16, NUM_CHANNELS> frame;
+  ring.Read(frame.data(), 1);
+  ASSERT_EQ(frame[0], 8 * NUM_CHANNELS);
+
+  ring.RequestDiscard(1000);
+  ASSERT_EQ(ring.GetReadableFrames(), 0u);
+  ASSERT_EQ(ring.GetWritableFrames(), 63u);
+}
+
+TEST(AudioRingBuffer, ProducerConsumerThreads)
+{
+  static constexpr u32 TOTAL_FRAMES = 1024 * 1024;
+  static constexpr u32 CHUNK_FRAMES = 37;
+
+  AudioRingBuffer ring;
+  ring.Allocate(256, NUM_CHANNELS);
+
+  std::thread producer([&ring]() {
+    std::array<s16, CHUNK_FRAMES * NUM_CHANNELS> chunk;
+    for (u32 frame = 0; frame < TOTAL_FRAMES;)
+    {
+      const u32 num_frames = std::min(CHUNK_FRAMES, TOTAL_FRAMES - frame);
+      if (ring.GetWritableFrames() < num_frames)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+
+      for (u32 i = 0; i < num_frames; i++)
+      {
+        chunk[i * NUM_CHANNELS + 0] = static_cast<s16>(frame + i);
+        chunk[i * NUM_CHANNELS + 1] = static_cast<s16>(~(frame + i));
+      }
+
+      ring.Write(chunk.data(), num_frames);
+      frame += num_frames;
+    }
+  });
+
+  std::array<s16, 64 * NUM_CHANNELS> out;
+  u32 mismatches = 0;
+  for (u32 frame = 0; frame < TOTAL_FRAMES;)
+  {
+    const u32 num_frames = std::min<u32>(ring.GetReadableFrames(), 64);
+    if (num_frames == 0)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+
+    ring.Read(out.data(), num_frames);
+    for (u32 i = 0; i < num_frames; i++)
+    {
+      mismatches += (out[i * NUM_CHANNELS + 0] != static_cast<s16>(frame + i));
+      mismatches += (out[i * NUM_CHANNELS + 1] != static_cast<s16>(~(frame + i)));
+    }
+    frame += num_frames;
+  }
+
+  producer.join();
+  ASSERT_EQ(mismatches, 0u);
+}
@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "util/compress_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+
+static CompressHelpers::ByteBuffer GenerateData(size_t size)
+{
+  // Runs of repeated bytes, so there's something to compress.
+  std::mt19937 rng(0x12345678);
+  CompressHelpers::ByteBuffer data(size);
+  for (size_t i = 0; i < size;)
+  {
+    const size_t run = std::min<size_t>((rng() % 64) + 1, size - i);
+    std::memset(data.data() + i, static_cast<u8>(rng()), run);
+    i += run;
+  }
+
+  return data;
+}
+
+static void TestRoundTrip(size_t size)
+{
+  const CompressHelpers::ByteBuffer data = GenerateData(size);
+  const CompressHelpers::OptionalByteBuffer compressed =
+    CompressHelpers::CompressToBufferMultithreaded(CompressHelpers::CompressType::Zstandard, data.cspan(), 1);
+  ASSERT_TRUE(compressed.has_value());
+
+  const std::optional<size_t> decompressed_size =
+    CompressHelpers::GetDecompressedSize(CompressHelpers::CompressType::Zstandard, compressed->cspan());
+  ASSERT_TRUE(decompressed_size.has_value());
+  ASSERT_EQ(decompressed_size.value(), size);
+
+  const CompressHelpers::OptionalByteBuffer decompressed =
+    CompressHelpers::DecompressBuffer(CompressHelpers::CompressType::Zstandard, compressed->cspan());
+  ASSERT_TRUE(decompressed.has_value());
+  ASSERT_EQ(decompressed->size(), size);
+  ASSERT_EQ(std::memcmp(decompressed->data(), data.data(), size), 0);
+}
+
+TEST(CompressHelpers, ZstdSingleChunk)
+{
+  TestRoundTrip(64 * 1024);
+}
+
+TEST(CompressHelpers, ZstdMultipleChunks)
+{
+  TestRoundTrip(5 * 1024 * 1024 + 12345);
+}
+
+TEST(CompressHelpers, ZstdSingleFrame)
+{
+  // Regular single frame output still decompresses into a caller-provided buffer.
+  const CompressHelpers::ByteBuffer data = GenerateData(3 * 1024 * 1024);
+  const CompressHelpers::OptionalByteBuffer compressed =
+    CompressHelpers::CompressToBuffer(CompressHelpers::CompressType::Zstandard, data.cspan(), 1);
+  ASSERT_TRUE(compressed.has_value());
+
+  CompressHelpers::ByteBuffer decompressed(data.size());
+  const std::optional<size_t> decompressed_size = CompressHelpers::DecompressBuffer(
+    decompressed.span(), CompressHelpers::CompressType::Zstandard, compressed->cspan(), data.size());
+  ASSERT_TRUE(decompressed_size.has_value());
+  ASSERT_EQ(decompressed_size.value(), data.size());
+  ASSERT_EQ(std::memcmp(decompressed.data(), data.data(), data.size()), 0);
+}
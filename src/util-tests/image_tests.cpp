@@ -7,6 +7,7 @@
 
 #include "gtest/gtest.h"
 
+#include <cstring>
 #include <type_traits>
 
 namespace {
@@ -277,6 +278,116 @@ TEST_F(ImageTest, RGB5A1ToRGBA8)
   EXPECT_EQ((*first_pixel & 0xFF000000u), 0xFF000000u);
 }
 
+static void SetBC1Block(Image& image, u32 block_x, u32 block_y, u16 color0, u16 color1, u32 indices)
+{
+  u8* block = image.GetRowPixels(block_y) + (block_x * 8);
+  std::memcpy(block, &color0, sizeof(color0));
+  std::memcpy(block + 2, &color1, sizeof(color1));
+  std::memcpy(block + 4, &indices, sizeof(indices));
+}
+
+static u32 GetRGBA8Pixel(const Image& image, u32 x, u32 y)
+{
+  u32 pixel;
+  std::memcpy(&pixel, image.GetRowPixels(y) + (x * sizeof(u32)), sizeof(pixel));
+  return pixel;
+}
+
+TEST_F(ImageTest, BC1ToRGBA8)
+{
+  // 3x2 blocks, with the last column and row only partially covering the image
+  Image bc1_image(10, 6, ImageFormat::BC1);
+  for (u32 by = 0; by < 2; by++)
+  {
+    // indices 0, 1, 2, 3 across each row
+    SetBC1Block(bc1_image, 0, by, 0xF800, 0x001F, 0xE4E4E4E4u);
+    SetBC1Block(bc1_image, 1, by, 0x07E0, 0x001F, 0xE4E4E4E4u);
+    SetBC1Block(bc1_image, 2, by, 0x001F, 0xF800, 0xE4E4E4E4u);
+  }
+
+  Error err;
+  std::optional<Image> rgba8_image = bc1_image.ConvertToRGBA8(&err);
+  ASSERT_TRUE(rgba8_image.has_value());
+  EXPECT_EQ(rgba8_image->GetWidth(), 10u);
+  EXPECT_EQ(rgba8_image->GetHeight(), 6u);
+
+  for (u32 y = 0; y < 6; y++)
+  {
+    EXPECT_EQ(GetRGBA8Pixel(rgba8_image.value(), 0, y), 0xFF0000FFu);
+    EXPECT_EQ(GetRGBA8Pixel(rgba8_image.value(), 1, y), 0xFFFF0000u);
+    EXPECT_EQ(GetRGBA8Pixel(rgba8_image.value(), 2, y), 0xFF5500AAu);
+    EXPECT_EQ(GetRGBA8Pixel(rgba8_image.value(), 3, y), 0xFFAA0055u);
+    EXPECT_EQ(GetRGBA8Pixel(rgba8_image.value(), 4, y), 0xFF00FF00u);
+
+    // color0 <= color1 selects three-colour mode, where index 3 is transparent
+    EXPECT_EQ(GetRGBA8Pixel(rgba8_image.value(), 8, y), 0xFFFF0000u);
+    EXPECT_EQ(GetRGBA8Pixel(rgba8_image.value(), 9, y), 0xFF0000FFu);
+  }
+}
+
+TEST_F(ImageTest, BC3ToRGBA8)
+{
+  Image bc3_image(4, 4, ImageFormat::BC3);
+  u8* block = bc3_image.GetPixels();
+
+  // alpha endpoints 255 and 0, with every pixel using index 1
+  const u8 alpha_block[8] = {0xFF, 0x00, 0x49, 0x92, 0x24, 0x49, 0x92, 0x24};
+  const u16 color0 = 0xF800;
+  const u16 color1 = 0x0000;
+  const u32 indices = 0;
+  std::memcpy(block, alpha_block, sizeof(alpha_block));
+  std::memcpy(block + 8, &color0, sizeof(color0));
+  std::memcpy(block + 10, &color1, sizeof(color1));
+  std::memcpy(block + 12, &indices, sizeof(indices));
+
+  Error err;
+  std::optional<Image> rgba8_image = bc3_image.ConvertToRGBA8(&err);
+  ASSERT_TRUE(rgba8_image.has_value());
+  for (u32 y = 0; y < 4; y++)
+  {
+    for (u32 x = 0; x < 4; x++)
+      EXPECT_EQ(GetRGBA8Pixel(rgba8_image.value(), x, y), 0x000000FFu);
+  }
+}
+
+TEST_F(ImageTest, LargeBC1ToRGBA8)
+{
+  // Large enough to be split across worker threads, every block should still land in the right place.
+  constexpr u32 blocks_wide = 130;
+  constexpr u32 blocks_high = 129;
+  Image bc1_image(blocks_wide * 4, blocks_high * 4, ImageFormat::BC1);
+  for (u32 by = 0; by < blocks_high; by++)
+  {
+    for (u32 bx = 0; bx < blocks_wide; bx++)
+      SetBC1Block(bc1_image, bx, by, static_cast<u16>(by * blocks_wide + bx + 1), 0, by * 0x9E3779B9u + bx);
+  }
+
+  Error err;
+  std::optional<Image> rgba8_image = bc1_image.ConvertToRGBA8(&err);
+  ASSERT_TRUE(rgba8_image.has_value());
+
+  for (u32 by = 0; by < blocks_high; by++)
+  {
+    for (u32 bx = 0; bx < blocks_wide; bx++)
+    {
+      Image block_image(4, 4, ImageFormat::BC1);
+      SetBC1Block(block_image, 0, 0, static_cast<u16>(by * blocks_wide + bx + 1), 0, by * 0x9E3779B9u + bx);
+      std::optional<Image> rgba8_block = block_image.ConvertToRGBA8(&err);
+      ASSERT_TRUE(rgba8_block.has_value());
+
+      for (u32 y = 0; y < 4; y++)
+      {
+        for (u32 x = 0; x < 4; x++)
+        {
+          ASSERT_EQ(GetRGBA8Pixel(rgba8_image.value(), bx * 4 + x, by * 4 + y),
+                    GetRGBA8Pixel(rgba8_block.value(), x, y))
+            << "block " << bx << "," << by;
+        }
+      }
+    }
+  }
+}
+
 // Test block sizes for compressed formats
 TEST_F(ImageTest, BlockSizes)
 {
@@ -518,3 +629,34 @@ TEST_F(ImageTest, Invalidate)
   EXPECT_EQ(img.GetFormat(), ImageFormat::None);
   EXPECT_EQ(img.GetPixels(), nullptr);
 }
+
+// Large PNGs are split into strips which are deflated on separate threads, check they still decode losslessly
+TEST_F(ImageTest, PNGParallelEncodeRoundTrip)
+{
+  Image img(640, 480, ImageFormat::RGBA8);
+  u32 seed = 0x12345678u;
+  for (u32 y = 0; y < img.GetHeight(); y++)
+  {
+    u32* row = reinterpret_cast<u32*>(img.GetRowPixels(y));
+    for (u32 x = 0; x < img.GetWidth(); x++)
+    {
+      // Mix of smooth gradients and noise, so every filter type gets picked somewhere
+      seed = seed * 1103515245u + 12345u;
+      row[x] = (x & 0xFFu) | ((y & 0xFFu) << 8) | (((x < 320) ? (seed >> 16) : (x ^ y)) & 0xFFu) << 16 |
+               ((y < 240) ? 0xFF000000u : ((seed >> 8) << 24));
+    }
+  }
+
+  for (const u8 quality : {u8(0), u8(20), Image::DEFAULT_SAVE_QUALITY, u8(100)})
+  {
+    std::optional<DynamicHeapArray<u8>> buffer = img.SaveToBuffer("test.png", quality);
+    ASSERT_TRUE(buffer.has_value());
+
+    Image loaded;
+    ASSERT_TRUE(loaded.LoadFromBuffer("test.png", buffer->cspan()));
+    ASSERT_EQ(loaded.GetWidth(), img.GetWidth());
+    ASSERT_EQ(loaded.GetHeight(), img.GetHeight());
+    for (u32 y = 0; y < img.GetHeight(); y++)
+      ASSERT_EQ(std::memcmp(loaded.GetRowPixels(y), img.GetRowPixels(y), img.GetWidth() * sizeof(u32)), 0);
+  }
+}
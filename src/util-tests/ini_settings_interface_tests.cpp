@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "util/ini_settings_interface.h"
+
+#include <gtest/gtest.h>
+
+TEST(INISettingsInterface, LookupsAreCaseInsensitive)
+{
+  INISettingsInterface si;
+  si.SetIntValue("Main", "Value", 5);
+  EXPECT_EQ(si.GetIntValue("main", "VALUE", 0), 5);
+  EXPECT_TRUE(si.ContainsValue("MAIN", "value"));
+  EXPECT_FALSE(si.ContainsValue("Main", "Other"));
+  EXPECT_FALSE(si.ContainsValue("Other", "Value"));
+  si.Clear();
+}
+
+TEST(INISettingsInterface, LookupsSeeModifications)
+{
+  INISettingsInterface si;
+  si.SetStringValue("Main", "Value", "first");
+  EXPECT_EQ(si.GetStringValue("Main", "Value"), "first");
+
+  si.SetStringValue("Main", "Value", "second");
+  EXPECT_EQ(si.GetStringValue("Main", "Value"), "second");
+
+  si.SetBoolValue("Other", "Flag", true);
+  EXPECT_TRUE(si.GetBoolValue("Other", "Flag", false));
+
+  si.DeleteValue("Main", "Value");
+  EXPECT_FALSE(si.ContainsValue("Main", "Value"));
+  EXPECT_TRUE(si.GetBoolValue("Other", "Flag", false));
+
+  si.ClearSection("Other");
+  EXPECT_FALSE(si.ContainsValue("Other", "Flag"));
+  si.Clear();
+}
+
+TEST(INISettingsInterface, StringListReturnsFirstValue)
+{
+  INISettingsInterface si;
+  si.SetStringList("Main", "List", {"a", "b", "c"});
+  EXPECT_EQ(si.GetStringValue("Main", "List"), "a");
+
+  si.RemoveFromStringList("Main", "List", "a");
+  EXPECT_EQ(si.GetStringValue("Main", "List"), "b");
+  si.Clear();
+}
@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "util/spu_reverb.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <random>
+
+TEST(SPUReverb, Downsample)
+{
+  std::mt19937 rng(0x12345678);
+  std::array<s16, SPUReverb::DOWNSAMPLE_READ_SIZE> samples;
+  for (u32 iteration = 0; iteration < 10000; iteration++)
+  {
+    // Full-scale noise, with some runs of the extremes to hit the clamping.
+    const bool extremes = (iteration % 4) == 0;
+    for (s16& sample : samples)
+      sample = extremes ? ((rng() & 1) ? 32767 : -32768) : static_cast<s16>(rng());
+
+    ASSERT_EQ(SPUReverb::Downsample(samples.data()), SPUReverb::DownsampleScalar(samples.data()))
+      << "iteration " << iteration;
+  }
+}
+
+TEST(SPUReverb, Upsample)
+{
+  std::mt19937 rng(0x87654321);
+  std::array<s16, SPUReverb::UPSAMPLE_TAPS> samples;
+  for (u32 iteration = 0; iteration < 10000; iteration++)
+  {
+    const bool extremes = (iteration % 4) == 0;
+    for (s16& sample : samples)
+      sample = extremes ? ((rng() & 1) ? 32767 : -32768) : static_cast<s16>(rng());
+
+    ASSERT_EQ(SPUReverb::Upsample(samples.data()), SPUReverb::UpsampleScalar(samples.data()))
+      << "iteration " << iteration;
+  }
+}
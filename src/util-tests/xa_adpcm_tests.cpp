@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "util/xa_adpcm.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <random>
+#include <vector>
+
+static std::vector<u8> GenerateSectorData(std::mt19937& rng)
+{
+  std::vector<u8> data(XAADPCM::NUM_CHUNKS * XAADPCM::CHUNK_SIZE_IN_BYTES);
+  for (u8& byte : data)
+    byte = static_cast<u8>(rng());
+
+  // Keep the filters in range, but cover all shift values including the reserved ones.
+  for (u32 chunk = 0; chunk < XAADPCM::NUM_CHUNKS; chunk++)
+  {
+    for (u32 i = 0; i < 16; i++)
+      data[chunk * XAADPCM::CHUNK_SIZE_IN_BYTES + i] = static_cast<u8>(((rng() % 4) << 4) | (rng() % 16));
+  }
+
+  return data;
+}
+
+static void TestUnpack(bool is_8bit)
+{
+  std::mt19937 rng(0x12345678);
+  for (u32 iteration = 0; iteration < 32; iteration++)
+  {
+    const std::vector<u8> data = GenerateSectorData(rng);
+
+    XAADPCM::UnpackedSector expected = {};
+    XAADPCM::UnpackedSector actual = {};
+    XAADPCM::UnpackSectorScalar(data.data(), is_8bit, &expected);
+    XAADPCM::UnpackSector(data.data(), is_8bit, &actual);
+
+    const u32 num_samples = is_8bit ? XAADPCM::SAMPLES_PER_SECTOR_8BIT : XAADPCM::SAMPLES_PER_SECTOR_4BIT;
+    for (u32 i = 0; i < num_samples; i++)
+      ASSERT_EQ(actual.samples[i], expected.samples[i]) << "sample " << i << " iteration " << iteration;
+
+    const u32 num_blocks = XAADPCM::NUM_CHUNKS * (is_8bit ? 4 : 8);
+    for (u32 i = 0; i < num_blocks; i++)
+      ASSERT_EQ(actual.filters[i], expected.filters[i]) << "block " << i << " iteration " << iteration;
+  }
+}
+
+static void TestResample(bool stereo, bool half_sample_rate)
+{
+  std::mt19937 rng(0x87654321);
+
+  XAADPCM::ResamplerState expected_state;
+  XAADPCM::ResamplerState actual_state;
+  expected_state.Reset();
+  actual_state.Reset();
+
+  std::array<u32, XAADPCM::MAX_RESAMPLED_FRAMES_PER_SECTOR> expected_frames;
+  std::array<u32, XAADPCM::MAX_RESAMPLED_FRAMES_PER_SECTOR> actual_frames;
+  std::array<s16, XAADPCM::SAMPLES_PER_SECTOR_4BIT> samples;
+
+  // Run several sectors through, so the state carried between them is covered too. Odd frame counts leave the
+  // step counter at different positions.
+  for (u32 iteration = 0; iteration < 16; iteration++)
+  {
+    // Full-scale noise exercises the clamping.
+    for (s16& sample : samples)
+      sample = static_cast<s16>(rng());
+
+    const u32 num_frames = (XAADPCM::SAMPLES_PER_SECTOR_4BIT >> (stereo ? 1 : 0)) - (rng() % 7);
+    const u32 expected_count = XAADPCM::ResampleSectorScalar(samples.data(), num_frames, stereo, half_sample_rate,
+                                                             expected_state, expected_frames.data());
+    const u32 actual_count = XAADPCM::ResampleSector(samples.data(), num_frames, stereo, half_sample_rate,
+                                                     actual_state, actual_frames.data());
+
+    ASSERT_EQ(actual_count, expected_count);
+    ASSERT_LE(actual_count, XAADPCM::MAX_RESAMPLED_FRAMES_PER_SECTOR);
+    for (u32 i = 0; i < expected_count; i++)
+      ASSERT_EQ(actual_frames[i], expected_frames[i]) << "frame " << i << " iteration " << iteration;
+
+    ASSERT_EQ(actual_state.p, expected_state.p);
+    ASSERT_EQ(actual_state.sixstep, expected_state.sixstep);
+    ASSERT_EQ(actual_state.ring_buffer, expected_state.ring_buffer);
+  }
+}
+
+TEST(XAADPCM, Unpack4Bit)
+{
+  TestUnpack(false);
+}
+
+TEST(XAADPCM, Unpack8Bit)
+{
+  TestUnpack(true);
+}
+
+TEST(XAADPCM, ResampleMono)
+{
+  TestResample(false, false);
+}
+
+TEST(XAADPCM, ResampleStereo)
+{
+  TestResample(true, false);
+}
+
+TEST(XAADPCM, ResampleHalfRateMono)
+{
+  TestResample(false, true);
+}
+
+TEST(XAADPCM, ResampleHalfRateStereo)
+{
+  TestResample(true, true);
+}
@@ -298,17 +298,17 @@ static void PNGSetErrorFunction(png_structp png_ptr, Error* error)
     [](png_structp png_ptr, png_const_charp message) { WARNING_LOG("libpng warning: {}", message); });
 }
 
-static bool PNGCommonLoader(AnimatedImage* image, png_structp png_ptr, png_infop info_ptr)
+static void PNGReadHeader(png_structp png_ptr, png_infop info_ptr, u32* width, u32* height, u32* num_frames)
 {
   png_read_info(png_ptr, info_ptr);
 
-  const u32 width = png_get_image_width(png_ptr, info_ptr);
-  const u32 height = png_get_image_height(png_ptr, info_ptr);
-  const u32 num_frames = png_get_num_frames(png_ptr, info_ptr);
+  *width = png_get_image_width(png_ptr, info_ptr);
+  *height = png_get_image_height(png_ptr, info_ptr);
+  *num_frames = png_get_num_frames(png_ptr, info_ptr);
   const png_byte color_type = png_get_color_type(png_ptr, info_ptr);
   const png_byte bit_depth = png_get_bit_depth(png_ptr, info_ptr);
 
-  if (num_frames == 0)
+  if (*num_frames == 0)
     png_error(png_ptr, "Image has zero frames");
 
   // Read any color_type into 8bit depth, RGBA format.
@@ -335,41 +335,46 @@ static bool PNGCommonLoader(AnimatedImage* image, png_structp png_ptr, png_infop
     png_set_gray_to_rgb(png_ptr);
 
   png_read_update_info(png_ptr, info_ptr);
+}
 
-  DebugAssert(num_frames > 0);
-  image->Resize(width, height, num_frames, {1, 10}, false);
-  if (num_frames > 1)
+static void PNGReadFrame(png_structp png_ptr, png_infop info_ptr, u32 width, u32 height, bool animated,
+                         AnimatedImage::FrameDelay* delay, AnimatedImage::PixelType* pixels)
+{
+  if (animated)
   {
-    for (u32 i = 0; i < num_frames; i++)
-    {
-      png_read_frame_head(png_ptr, info_ptr);
+    png_read_frame_head(png_ptr, info_ptr);
 
-      const u32 frame_width = png_get_next_frame_width(png_ptr, info_ptr);
-      const u32 frame_height = png_get_next_frame_height(png_ptr, info_ptr);
-      if (frame_width != width || frame_height != height)
-        png_error(png_ptr, "Frame size does not match image size");
+    const u32 frame_width = png_get_next_frame_width(png_ptr, info_ptr);
+    const u32 frame_height = png_get_next_frame_height(png_ptr, info_ptr);
+    if (frame_width != width || frame_height != height)
+      png_error(png_ptr, "Frame size does not match image size");
 
-      const u16 delay_num = static_cast<u16>(png_get_next_frame_delay_num(png_ptr, info_ptr));
-      const u16 delay_den = static_cast<u16>(png_get_next_frame_delay_den(png_ptr, info_ptr));
-      image->SetDelay(i, {delay_num, std::max<u16>(delay_den, 1)});
+    const u16 delay_num = static_cast<u16>(png_get_next_frame_delay_num(png_ptr, info_ptr));
+    const u16 delay_den = static_cast<u16>(png_get_next_frame_delay_den(png_ptr, info_ptr));
+    *delay = {delay_num, std::max<u16>(delay_den, 1)};
+  }
 
-      // TODO: blending/compose/etc.
-      const int num_passes = png_set_interlace_handling(png_ptr);
-      for (int pass = 0; pass < num_passes; pass++)
-      {
-        for (u32 y = 0; y < height; y++)
-          png_read_row(png_ptr, reinterpret_cast<png_bytep>(image->GetRowPixels(i, y)), nullptr);
-      }
-    }
+  // TODO: blending/compose/etc.
+  const int num_passes = png_set_interlace_handling(png_ptr);
+  for (int pass = 0; pass < num_passes; pass++)
+  {
+    for (u32 y = 0; y < height; y++)
+      png_read_row(png_ptr, reinterpret_cast<png_bytep>(pixels + y * width), nullptr);
   }
-  else
+}
+
+static bool PNGCommonLoader(AnimatedImage* image, png_structp png_ptr, png_infop info_ptr)
+{
+  u32 width, height, num_frames;
+  PNGReadHeader(png_ptr, info_ptr, &width, &height, &num_frames);
+
+  DebugAssert(num_frames > 0);
+  image->Resize(width, height, num_frames, {1, 10}, false);
+  for (u32 i = 0; i < num_frames; i++)
   {
-    const int num_passes = png_set_interlace_handling(png_ptr);
-    for (int pass = 0; pass < num_passes; pass++)
-    {
-      for (u32 y = 0; y < height; y++)
-        png_read_row(png_ptr, reinterpret_cast<png_bytep>(image->GetRowPixels(0, y)), nullptr);
-    }
+    AnimatedImage::FrameDelay delay = image->GetFrameDelay(i);
+    PNGReadFrame(png_ptr, info_ptr, width, height, (num_frames > 1), &delay, image->GetPixels(i));
+    image->SetDelay(i, delay);
   }
 
   return true;
@@ -586,3 +591,285 @@ bool PNGBufferSaver(const AnimatedImage& image, DynamicHeapArray<u8>* data, u8 q
   iodata.buffer->resize(iodata.buffer_pos);
   return true;
 }
+
+AnimatedImageStream::AnimatedImageStream() = default;
+
+AnimatedImageStream::~AnimatedImageStream()
+{
+  Close();
+}
+
+bool AnimatedImageStream::Open(const char* filename, u32 window_size /* = DEFAULT_WINDOW_SIZE */,
+                               Error* error /* = nullptr */)
+{
+  Close();
+
+  auto fp = FileSystem::OpenManagedCFile(filename, "rb", error);
+  if (!fp)
+    return false;
+
+  m_fp = fp.release();
+  return Start(filename, window_size, error);
+}
+
+bool AnimatedImageStream::OpenBuffer(std::string_view filename, DynamicHeapArray<u8> data,
+                                     u32 window_size /* = DEFAULT_WINDOW_SIZE */, Error* error /* = nullptr */)
+{
+  Close();
+
+  m_data = std::move(data);
+  return Start(filename, window_size, error);
+}
+
+bool AnimatedImageStream::Start(std::string_view filename, u32 window_size, Error* error)
+{
+  const std::string_view extension(Path::GetExtension(filename));
+  if (!StringUtil::EqualNoCase(extension, "png"))
+  {
+    Error::SetStringFmt(error, "Unknown extension '{}'", extension);
+    Close();
+    return false;
+  }
+
+  if (!OpenDecoder(error))
+  {
+    Close();
+    return false;
+  }
+
+  // need at least one more frame than the reader holds, otherwise there's nowhere to decode ahead into
+  const u32 frame_size = m_width * m_height;
+  m_slots.resize((m_frames > 1) ? std::clamp(window_size, 2u, m_frames) : 1u);
+  for (Slot& slot : m_slots)
+  {
+    slot.pixels.resize(frame_size);
+    slot.delay = {1, 10};
+  }
+
+  // still images are decoded once and never change
+  if (m_frames == 1)
+  {
+    if (!DecodeFrame(m_slots[0], error))
+    {
+      Close();
+      return false;
+    }
+
+    m_ready_slots = 1;
+    CloseDecoder();
+    return true;
+  }
+
+  m_thread = std::thread(&AnimatedImageStream::WorkerThreadEntryPoint, this);
+  return true;
+}
+
+void AnimatedImageStream::Close()
+{
+  if (m_thread.joinable())
+  {
+    {
+      std::unique_lock lock(m_mutex);
+      m_shutdown = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+  }
+
+  CloseDecoder();
+  if (m_fp)
+  {
+    std::fclose(m_fp);
+    m_fp = nullptr;
+  }
+
+  m_data.deallocate();
+  m_data_pos = 0;
+  m_width = 0;
+  m_height = 0;
+  m_frames = 0;
+  m_next_decode_frame = 0;
+  m_slots.clear();
+  m_read_slot = 0;
+  m_ready_slots = 0;
+  m_holding_slot = false;
+  m_shutdown = false;
+  m_failed = false;
+  m_error_description = {};
+}
+
+const AnimatedImage::PixelType* AnimatedImageStream::GetNextFrame(AnimatedImage::FrameDelay* delay /* = nullptr */,
+                                                                  Error* error /* = nullptr */)
+{
+  if (m_slots.empty())
+  {
+    Error::SetStringView(error, "Stream is not open.");
+    return nullptr;
+  }
+
+  if (!m_thread.joinable())
+  {
+    if (delay)
+      *delay = m_slots[0].delay;
+    return m_slots[0].pixels.data();
+  }
+
+  std::unique_lock lock(m_mutex);
+
+  // the previously returned frame can be decoded over now
+  if (m_holding_slot)
+  {
+    m_read_slot = (m_read_slot + 1) % static_cast<u32>(m_slots.size());
+    m_ready_slots--;
+    m_holding_slot = false;
+    m_cv.notify_all();
+  }
+
+  m_cv.wait(lock, [this]() { return (m_ready_slots > 0 || m_failed); });
+  if (m_ready_slots == 0)
+  {
+    Error::SetStringView(error, m_error_description);
+    return nullptr;
+  }
+
+  const Slot& slot = m_slots[m_read_slot];
+  m_holding_slot = true;
+  if (delay)
+    *delay = slot.delay;
+  return slot.pixels.data();
+}
+
+void AnimatedImageStream::WorkerThreadEntryPoint()
+{
+  std::unique_lock lock(m_mutex);
+  for (;;)
+  {
+    m_cv.wait(lock, [this]() { return (m_shutdown || m_ready_slots < static_cast<u32>(m_slots.size())); });
+    if (m_shutdown)
+      break;
+
+    // slots after the ready ones aren't touched by the reader, so no need to hold the lock while decoding
+    Slot& slot = m_slots[(m_read_slot + m_ready_slots) % static_cast<u32>(m_slots.size())];
+    lock.unlock();
+
+    Error error;
+    const bool result = DecodeFrame(slot, &error);
+
+    lock.lock();
+    if (!result)
+    {
+      ERROR_LOG("Failed to decode animated image frame: {}", error.GetDescription());
+      m_error_description = error.TakeDescription();
+      m_failed = true;
+      m_cv.notify_all();
+      break;
+    }
+
+    m_ready_slots++;
+    m_cv.notify_all();
+  }
+}
+
+bool AnimatedImageStream::OpenDecoder(Error* error)
+{
+  if (m_fp)
+  {
+    if (!FileSystem::FSeek64(m_fp, 0, SEEK_SET, error))
+      return false;
+  }
+  else
+  {
+    m_data_pos = 0;
+  }
+
+  png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+  if (!png_ptr)
+  {
+    Error::SetStringView(error, "png_create_read_struct() failed.");
+    return false;
+  }
+
+  png_infop info_ptr = png_create_info_struct(png_ptr);
+  if (!info_ptr)
+  {
+    Error::SetStringView(error, "png_create_info_struct() failed.");
+    png_destroy_read_struct(&png_ptr, nullptr, nullptr);
+    return false;
+  }
+
+  m_png_ptr = png_ptr;
+  m_info_ptr = info_ptr;
+
+  PNGSetErrorFunction(png_ptr, error);
+  if (setjmp(png_jmpbuf(png_ptr)))
+  {
+    CloseDecoder();
+    return false;
+  }
+
+  png_set_read_fn(png_ptr, this, [](png_structp png_ptr, png_bytep data_ptr, png_size_t size) {
+    AnimatedImageStream* const stream = static_cast<AnimatedImageStream*>(png_get_io_ptr(png_ptr));
+    if (stream->m_fp)
+    {
+      if (std::fread(data_ptr, size, 1, stream->m_fp) != 1)
+        png_error(png_ptr, "fread() failed");
+    }
+    else
+    {
+      const size_t read_size = std::min<size_t>(stream->m_data.size() - stream->m_data_pos, size);
+      if (read_size > 0)
+      {
+        std::memcpy(data_ptr, &stream->m_data[stream->m_data_pos], read_size);
+        stream->m_data_pos += read_size;
+      }
+    }
+  });
+
+  u32 width, height, num_frames;
+  PNGReadHeader(png_ptr, info_ptr, &width, &height, &num_frames);
+  if (m_width == 0)
+  {
+    m_width = width;
+    m_height = height;
+    m_frames = num_frames;
+  }
+  else if (width != m_width || height != m_height || num_frames != m_frames)
+  {
+    png_error(png_ptr, "Image changed while streaming");
+  }
+
+  m_next_decode_frame = 0;
+  return true;
+}
+
+void AnimatedImageStream::CloseDecoder()
+{
+  if (!m_png_ptr)
+    return;
+
+  png_structp png_ptr = m_png_ptr;
+  png_infop info_ptr = m_info_ptr;
+  png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+  m_png_ptr = nullptr;
+  m_info_ptr = nullptr;
+}
+
+bool AnimatedImageStream::DecodeFrame(Slot& slot, Error* error)
+{
+  // start over from the first frame after the last
+  if (m_next_decode_frame == m_frames)
+  {
+    CloseDecoder();
+    if (!OpenDecoder(error))
+      return false;
+  }
+
+  png_structp png_ptr = m_png_ptr;
+  PNGSetErrorFunction(png_ptr, error);
+  if (setjmp(png_jmpbuf(png_ptr)))
+    return false;
+
+  PNGReadFrame(png_ptr, m_info_ptr, m_width, m_height, (m_frames > 1), &slot.delay, slot.pixels.data());
+  m_next_decode_frame++;
+  return true;
+}
@@ -7,13 +7,21 @@
 #include "common/heap_array.h"
 #include "common/types.h"
 
+#include <condition_variable>
 #include <cstdio>
+#include <mutex>
 #include <optional>
 #include <span>
+#include <string>
 #include <string_view>
+#include <thread>
+#include <vector>
 
 class Error;
 
+struct png_struct_def;
+struct png_info_def;
+
 class AnimatedImage
 {
 public:
@@ -87,3 +95,70 @@ protected:
   PixelStorage m_pixels;
   FrameDelayStorage m_frame_delay;
 };
+
+/// Plays back an animated image without keeping every frame in memory. Only a small window of frames is decoded at a
+/// time, ahead of the reader on a worker thread, and decoding starts over from the first frame after the last.
+class AnimatedImageStream
+{
+public:
+  static constexpr u32 DEFAULT_WINDOW_SIZE = 3;
+
+  AnimatedImageStream();
+  ~AnimatedImageStream();
+
+  AnimatedImageStream(const AnimatedImageStream&) = delete;
+  AnimatedImageStream& operator=(const AnimatedImageStream&) = delete;
+
+  ALWAYS_INLINE bool IsOpen() const { return (m_width > 0 && m_height > 0); }
+  ALWAYS_INLINE u32 GetWidth() const { return m_width; }
+  ALWAYS_INLINE u32 GetHeight() const { return m_height; }
+  ALWAYS_INLINE u32 GetPitch() const { return (m_width * sizeof(AnimatedImage::PixelType)); }
+  ALWAYS_INLINE u32 GetFrames() const { return m_frames; }
+
+  /// The window is the number of decoded frames kept around, including the one last returned.
+  bool Open(const char* filename, u32 window_size = DEFAULT_WINDOW_SIZE, Error* error = nullptr);
+  bool OpenBuffer(std::string_view filename, DynamicHeapArray<u8> data, u32 window_size = DEFAULT_WINDOW_SIZE,
+                  Error* error = nullptr);
+  void Close();
+
+  /// Returns the next frame, waiting for the worker if it hasn't been decoded yet. The pixels stay valid until the
+  /// next call, or the stream is closed. Returns null if decoding failed.
+  const AnimatedImage::PixelType* GetNextFrame(AnimatedImage::FrameDelay* delay = nullptr, Error* error = nullptr);
+
+private:
+  struct Slot
+  {
+    AnimatedImage::PixelStorage pixels;
+    AnimatedImage::FrameDelay delay;
+  };
+
+  bool Start(std::string_view filename, u32 window_size, Error* error);
+  bool OpenDecoder(Error* error);
+  void CloseDecoder();
+  bool DecodeFrame(Slot& slot, Error* error);
+  void WorkerThreadEntryPoint();
+
+  std::FILE* m_fp = nullptr;
+  DynamicHeapArray<u8> m_data;
+  size_t m_data_pos = 0;
+
+  png_struct_def* m_png_ptr = nullptr;
+  png_info_def* m_info_ptr = nullptr;
+  u32 m_width = 0;
+  u32 m_height = 0;
+  u32 m_frames = 0;
+  u32 m_next_decode_frame = 0;
+
+  // Ring of decoded frames, the worker fills slots after the ready ones.
+  std::vector<Slot> m_slots;
+  u32 m_read_slot = 0;
+  u32 m_ready_slots = 0;
+  bool m_holding_slot = false;
+  bool m_shutdown = false;
+  bool m_failed = false;
+  std::string m_error_description;
+
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+};
@@ -0,0 +1,224 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "audio_resampler.h"
+
+#include "common/assert.h"
+#include "common/gsvector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <numeric>
+
+// Kaiser window shape. 8 gives around 80dB of stopband rejection, with a transition band of roughly 0.08 of the input
+// rate at this filter length. The cutoff is pulled in by half of that, so the band edge is fully attenuated.
+static constexpr double KAISER_BETA = 8.0;
+static constexpr double TRANSITION_HALF_WIDTH = 0.04;
+
+static constexpr u32 COEFFICIENT_SHIFT = 14;
+static constexpr s32 COEFFICIENT_ONE = 1 << COEFFICIENT_SHIFT;
+
+static double BesselI0(double x)
+{
+  double sum = 1.0;
+  double term = 1.0;
+  for (u32 k = 1; term > (sum * 1e-12); k++)
+  {
+    const double half_x_over_k = x / (2.0 * static_cast<double>(k));
+    term *= half_x_over_k * half_x_over_k;
+    sum += term;
+  }
+
+  return sum;
+}
+
+PolyphaseResampler::PolyphaseResampler() = default;
+
+PolyphaseResampler::~PolyphaseResampler() = default;
+
+bool PolyphaseResampler::Init(u32 input_rate, u32 output_rate)
+{
+  Destroy();
+
+  if (input_rate == 0 || output_rate == 0)
+    return false;
+
+  const u32 divisor = std::gcd(input_rate, output_rate);
+  const u32 num_phases = output_rate / divisor;
+  const u32 phase_step = input_rate / divisor;
+  if (num_phases > MAX_PHASES || phase_step > (num_phases * MAX_DECIMATION))
+    return false;
+
+  m_input_rate = input_rate;
+  m_output_rate = output_rate;
+  m_num_phases = num_phases;
+  m_phase_step = phase_step;
+
+  // Cutoff is relative to the input rate, and has to drop below the output nyquist when downsampling.
+  const double ratio = std::min(1.0, static_cast<double>(num_phases) / static_cast<double>(phase_step));
+  const double cutoff = (0.5 * ratio) - TRANSITION_HALF_WIDTH;
+  const double half_width = static_cast<double>(TAPS / 2);
+  const double window_scale = 1.0 / BesselI0(KAISER_BETA);
+
+  m_coefficients.resize(num_phases * TAPS);
+  for (u32 phase = 0; phase < num_phases; phase++)
+  {
+    // Output frame sits between taps TAPS/2-1 and TAPS/2, phase/L of the way along.
+    const double offset = static_cast<double>(TAPS / 2 - 1) + (static_cast<double>(phase) / num_phases);
+
+    std::array<double, TAPS> taps;
+    double sum = 0.0;
+    for (u32 i = 0; i < TAPS; i++)
+    {
+      const double x = static_cast<double>(i) - offset;
+      const double wx = x / half_width;
+      const double window = BesselI0(KAISER_BETA * std::sqrt(std::max(0.0, 1.0 - wx * wx))) * window_scale;
+      const double sx = 2.0 * std::numbers::pi * cutoff * x;
+      const double sinc = (x == 0.0) ? 1.0 : (std::sin(sx) / sx);
+      taps[i] = sinc * window;
+      sum += taps[i];
+    }
+
+    // Normalise each phase to unity gain, then put any rounding error on the largest tap so that DC passes through
+    // exactly. The sum of the magnitudes stays well under 4.0, so the 32-bit dot products can't overflow.
+    s16* const coefficients = &m_coefficients[phase * TAPS];
+    s32 fixed_sum = 0;
+    u32 largest = 0;
+    for (u32 i = 0; i < TAPS; i++)
+    {
+      coefficients[i] = static_cast<s16>(std::lround((taps[i] / sum) * COEFFICIENT_ONE));
+      fixed_sum += coefficients[i];
+      largest = (std::abs(coefficients[i]) > std::abs(coefficients[largest])) ? i : largest;
+    }
+    coefficients[largest] = static_cast<s16>(coefficients[largest] + (COEFFICIENT_ONE - fixed_sum));
+  }
+
+  for (DynamicHeapArray<s16, 16>& history : m_history)
+    history.resize(GetMaxInputFrames());
+
+  Reset();
+  return true;
+}
+
+void PolyphaseResampler::Destroy()
+{
+  m_coefficients.deallocate();
+  for (DynamicHeapArray<s16, 16>& history : m_history)
+    history.deallocate();
+  m_history_frames = 0;
+  m_input_rate = 0;
+  m_output_rate = 0;
+  m_num_phases = 0;
+  m_phase_step = 0;
+  m_phase = 0;
+}
+
+void PolyphaseResampler::Reset()
+{
+  // Prime with silence so the first output frame is centred on the first input frame.
+  for (DynamicHeapArray<s16, 16>& history : m_history)
+    std::memset(history.data(), 0, history.size_bytes());
+  m_history_frames = TAPS / 2 - 1;
+  m_phase = 0;
+}
+
+u32 PolyphaseResampler::GetInputFramesForOutput(u32 num_out_frames) const
+{
+  if (num_out_frames == 0)
+    return 0;
+
+  // The last output frame reads TAPS frames from where it starts.
+  const u32 last_start = (m_phase + (num_out_frames - 1) * m_phase_step) / m_num_phases;
+  const u32 required = last_start + TAPS;
+  return (required > m_history_frames) ? (required - m_history_frames) : 0;
+}
+
+u32 PolyphaseResampler::GetMaxInputFrames() const
+{
+  return ((m_num_phases - 1) + (MAX_OUTPUT_FRAMES - 1) * m_phase_step) / m_num_phases + TAPS;
+}
+
+template<bool USE_VECTOR>
+void PolyphaseResampler::ProcessImpl(const s16* in, u32 num_in_frames, s16* out, u32 num_out_frames)
+{
+  DebugAssert(num_out_frames <= MAX_OUTPUT_FRAMES && num_in_frames == GetInputFramesForOutput(num_out_frames));
+
+  s16* const left = m_history[0].data();
+  s16* const right = m_history[1].data();
+  for (u32 i = 0; i < num_in_frames; i++)
+  {
+    left[m_history_frames + i] = in[i * NUM_CHANNELS + 0];
+    right[m_history_frames + i] = in[i * NUM_CHANNELS + 1];
+  }
+
+  const u32 total_frames = m_history_frames + num_in_frames;
+  const u32 step_int = m_phase_step / m_num_phases;
+  const u32 step_frac = m_phase_step % m_num_phases;
+  u32 phase = m_phase;
+  u32 pos = 0;
+
+  for (u32 i = 0; i < num_out_frames; i++)
+  {
+    const s16* const coefficients = &m_coefficients[phase * TAPS];
+    s32 left_sum, right_sum;
+    if constexpr (USE_VECTOR)
+    {
+      GSVector4i left_acc = GSVector4i::zero();
+      GSVector4i right_acc = GSVector4i::zero();
+      for (u32 j = 0; j < TAPS; j += 8)
+      {
+        const GSVector4i coeffs = GSVector4i::load<true>(&coefficients[j]);
+        left_acc = left_acc.add32(GSVector4i::load<false>(&left[pos + j]).madd_s16(coeffs));
+        right_acc = right_acc.add32(GSVector4i::load<false>(&right[pos + j]).madd_s16(coeffs));
+      }
+
+      left_sum = left_acc.addv_s32();
+      right_sum = right_acc.addv_s32();
+    }
+    else
+    {
+      left_sum = 0;
+      right_sum = 0;
+      for (u32 j = 0; j < TAPS; j++)
+      {
+        left_sum += s32(coefficients[j]) * s32(left[pos + j]);
+        right_sum += s32(coefficients[j]) * s32(right[pos + j]);
+      }
+    }
+
+    constexpr s32 round = 1 << (COEFFICIENT_SHIFT - 1);
+    out[0] = static_cast<s16>(std::clamp<s32>((left_sum + round) >> COEFFICIENT_SHIFT, -32768, 32767));
+    out[1] = static_cast<s16>(std::clamp<s32>((right_sum + round) >> COEFFICIENT_SHIFT, -32768, 32767));
+    out += NUM_CHANNELS;
+
+    pos += step_int;
+    phase += step_frac;
+    if (phase >= m_num_phases)
+    {
+      phase -= m_num_phases;
+      pos++;
+    }
+  }
+
+  // Keep whatever the next frame still needs at the start of the history.
+  DebugAssert(pos <= total_frames);
+  m_history_frames = total_frames - pos;
+  m_phase = phase;
+  if (pos > 0 && m_history_frames > 0)
+  {
+    std::memmove(left, left + pos, m_history_frames * sizeof(s16));
+    std::memmove(right, right + pos, m_history_frames * sizeof(s16));
+  }
+}
+
+void PolyphaseResampler::Process(const s16* in, u32 num_in_frames, s16* out, u32 num_out_frames)
+{
+  ProcessImpl<true>(in, num_in_frames, out, num_out_frames);
+}
+
+void PolyphaseResampler::ProcessScalar(const s16* in, u32 num_in_frames, s16* out, u32 num_out_frames)
+{
+  ProcessImpl<false>(in, num_in_frames, out, num_out_frames);
+}
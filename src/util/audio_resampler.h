@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#pragma once
+
+#include "common/heap_array.h"
+#include "common/types.h"
+
+#include <array>
+
+/// Fixed-ratio polyphase FIR resampler, used to convert the stereo output to the device's sample rate. The rate ratio
+/// is reduced to out/in = L/M, and each output frame is a single TAPS-long dot product against one of L precomputed
+/// filter phases, so the cost per frame is the same regardless of the ratio.
+class PolyphaseResampler
+{
+public:
+  static constexpr u32 NUM_CHANNELS = 2;
+  static constexpr u32 TAPS = 64;
+  static constexpr u32 MAX_PHASES = 1024;
+  static constexpr u32 MAX_OUTPUT_FRAMES = 256;
+
+  // Downsampling by more than this would need a longer filter to keep the cutoff sharp.
+  static constexpr u32 MAX_DECIMATION = 4;
+
+  PolyphaseResampler();
+  ~PolyphaseResampler();
+
+  ALWAYS_INLINE bool IsActive() const { return (m_num_phases != 0); }
+  ALWAYS_INLINE u32 GetInputRate() const { return m_input_rate; }
+  ALWAYS_INLINE u32 GetOutputRate() const { return m_output_rate; }
+
+  /// Builds the filter for the given rates. Returns false if the ratio isn't supported.
+  bool Init(u32 input_rate, u32 output_rate);
+  void Destroy();
+
+  /// Clears the filter history.
+  void Reset();
+
+  /// Returns the number of input frames that must be passed to Process() to produce num_out_frames.
+  u32 GetInputFramesForOutput(u32 num_out_frames) const;
+
+  /// Largest value GetInputFramesForOutput() can return, for sizing buffers.
+  u32 GetMaxInputFrames() const;
+
+  /// Resamples interleaved frames. num_in_frames must be the value returned by GetInputFramesForOutput(), and
+  /// num_out_frames can be at most MAX_OUTPUT_FRAMES.
+  void Process(const s16* in, u32 num_in_frames, s16* out, u32 num_out_frames);
+  void ProcessScalar(const s16* in, u32 num_in_frames, s16* out, u32 num_out_frames);
+
+private:
+  template<bool USE_VECTOR>
+  void ProcessImpl(const s16* in, u32 num_in_frames, s16* out, u32 num_out_frames);
+
+  // Phases are stored consecutively, TAPS coefficients each, in 2.14 fixed point.
+  DynamicHeapArray<s16, 16> m_coefficients;
+
+  // Deinterleaved input, m_history_frames of which haven't been fully consumed yet.
+  std::array<DynamicHeapArray<s16, 16>, NUM_CHANNELS> m_history;
+  u32 m_history_frames = 0;
+
+  u32 m_input_rate = 0;
+  u32 m_output_rate = 0;
+
+  // L and M, and the phase of the next output frame in [0, L).
+  u32 m_num_phases = 0;
+  u32 m_phase_step = 0;
+  u32 m_phase = 0;
+};
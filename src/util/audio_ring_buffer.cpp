@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "audio_ring_buffer.h"
+
+#include "common/assert.h"
+#include "common/intrin.h"
+
+#include <algorithm>
+#include <cstring>
+
+AudioRingBuffer::AudioRingBuffer() = default;
+
+AudioRingBuffer::~AudioRingBuffer() = default;
+
+void AudioRingBuffer::Allocate(u32 num_frames, u32 num_channels)
+{
+  m_buffer = Common::make_unique_aligned_for_overwrite<SampleType[]>(VECTOR_ALIGNMENT, num_frames * num_channels);
+  m_size = num_frames;
+  m_num_channels = num_channels;
+  m_rpos.store(0, std::memory_order_relaxed);
+  m_wpos.store(0, std::memory_order_relaxed);
+  m_discard_request.store(0, std::memory_order_release);
+}
+
+void AudioRingBuffer::Destroy()
+{
+  m_buffer.reset();
+  m_size = 0;
+  m_num_channels = 0;
+  m_rpos.store(0, std::memory_order_relaxed);
+  m_wpos.store(0, std::memory_order_relaxed);
+  m_discard_request.store(0, std::memory_order_release);
+}
+
+u32 AudioRingBuffer::GetBufferedFramesRelaxed() const
+{
+  const u32 rpos = m_rpos.load(std::memory_order_relaxed);
+  const u32 wpos = m_wpos.load(std::memory_order_relaxed);
+  return (wpos + m_size - rpos) % m_size;
+}
+
+u32 AudioRingBuffer::GetWritableFrames() const
+{
+  // acquire pairs with the consumer's release, so it's finished reading anything we're about to overwrite
+  const u32 rpos = m_rpos.load(std::memory_order_acquire);
+  const u32 wpos = m_wpos.load(std::memory_order_relaxed);
+  return m_size - 1 - ((wpos + m_size - rpos) % m_size);
+}
+
+void AudioRingBuffer::Write(const SampleType* frames, u32 num_frames)
+{
+  DebugAssert(num_frames <= GetWritableFrames());
+
+  u32 wpos = m_wpos.load(std::memory_order_relaxed);
+
+  // wrapping around the end of the buffer?
+  if ((m_size - wpos) <= num_frames)
+  {
+    // needs to be written in two parts, start is zero when this chunk reaches exactly the end
+    const u32 end = m_size - wpos;
+    const u32 start = num_frames - end;
+    std::memcpy(&m_buffer[wpos * m_num_channels], frames, end * m_num_channels * sizeof(SampleType));
+    if (start > 0)
+      std::memcpy(&m_buffer[0], frames + end * m_num_channels, start * m_num_channels * sizeof(SampleType));
+
+    wpos = start;
+  }
+  else
+  {
+    // no split
+    std::memcpy(&m_buffer[wpos * m_num_channels], frames, num_frames * m_num_channels * sizeof(SampleType));
+    wpos += num_frames;
+  }
+
+  m_wpos.store(wpos, std::memory_order_release);
+}
+
+void AudioRingBuffer::RequestDiscard(u32 num_frames)
+{
+  m_discard_request.fetch_add(num_frames, std::memory_order_release);
+}
+
+u32 AudioRingBuffer::GetReadableFrames()
+{
+  // acquire pairs with the producer's release, so the frames it's written are visible
+  const u32 wpos = m_wpos.load(std::memory_order_acquire);
+  u32 rpos = m_rpos.load(std::memory_order_relaxed);
+  u32 available = (wpos + m_size - rpos) % m_size;
+
+  if (m_discard_request.load(std::memory_order_relaxed) != 0)
+  {
+    const u32 discard = std::min(m_discard_request.exchange(0, std::memory_order_acquire), available);
+    rpos = (rpos + discard) % m_size;
+    available -= discard;
+    m_rpos.store(rpos, std::memory_order_release);
+  }
+
+  return available;
+}
+
+void AudioRingBuffer::Read(SampleType* frames, u32 num_frames)
+{
+  u32 rpos = m_rpos.load(std::memory_order_relaxed);
+
+  // towards the end of the buffer
+  const u32 end = std::min(m_size - rpos, num_frames);
+  if (end > 0)
+  {
+    std::memcpy(frames, &m_buffer[rpos * m_num_channels], end * m_num_channels * sizeof(SampleType));
+    rpos += end;
+    rpos = (rpos == m_size) ? 0 : rpos;
+  }
+
+  // after wrapping around
+  const u32 start = num_frames - end;
+  if (start > 0)
+  {
+    std::memcpy(&frames[end * m_num_channels], &m_buffer[0], start * m_num_channels * sizeof(SampleType));
+    rpos = start;
+  }
+
+  m_rpos.store(rpos, std::memory_order_release);
+}
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#pragma once
+
+#include "common/align.h"
+#include "common/types.h"
+
+#include <atomic>
+
+/// Wait-free single-producer/single-consumer ring of interleaved frames, used to hand audio from the emulation thread
+/// to the backend's callback. Each position is only ever stored by its owning thread, and the two positions live on
+/// separate cache lines so that neither side's stores invalidate the other's line. One frame is always left empty so
+/// that a full ring can be told apart from an empty one.
+class AudioRingBuffer
+{
+public:
+  using SampleType = s16;
+
+  AudioRingBuffer();
+  ~AudioRingBuffer();
+
+  ALWAYS_INLINE u32 GetSize() const { return m_size; }
+  ALWAYS_INLINE bool IsAllocated() const { return (m_size != 0); }
+
+  /// Not thread safe, both sides must be stopped.
+  void Allocate(u32 num_frames, u32 num_channels);
+  void Destroy();
+
+  /// Number of frames in the ring. Can be called by either side, but may be stale by the time it returns.
+  u32 GetBufferedFramesRelaxed() const;
+
+  /// Producer side.
+  u32 GetWritableFrames() const;
+  void Write(const SampleType* frames, u32 num_frames);
+
+  /// Producer side. Asks the consumer to skip up to num_frames of the oldest frames before its next read, since the
+  /// producer can't move the read position itself.
+  void RequestDiscard(u32 num_frames);
+
+  /// Consumer side. Applies any pending discard first.
+  u32 GetReadableFrames();
+  void Read(SampleType* frames, u32 num_frames);
+
+private:
+  // shared, only written while both sides are stopped
+  Common::unique_aligned_ptr<SampleType[]> m_buffer;
+  u32 m_size = 0;
+  u32 m_num_channels = 0;
+
+  // owned by the consumer
+  ALIGN_TO_CACHE_LINE std::atomic<u32> m_rpos{0};
+
+  // owned by the producer
+  ALIGN_TO_CACHE_LINE std::atomic<u32> m_wpos{0};
+  std::atomic<u32> m_discard_request{0};
+};
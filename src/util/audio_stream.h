@@ -6,6 +6,7 @@
 #include "common/types.h"
 
 #include <memory>
+#include <optional>
 
 class Error;
 
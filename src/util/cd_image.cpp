@@ -10,8 +10,10 @@
 #include "common/log.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/threading.h"
 
 #include <array>
+#include <thread>
 
 LOG_CHANNEL(CDImage);
 
@@ -129,6 +131,18 @@ std::unique_ptr<CDImage> CDImage::Open(const char* path, bool allow_patches, Err
   return image;
 }
 
+void CDImage::OpenAsync(std::string path, bool allow_patches, OpenCallback callback)
+{
+  // Detached, so an abandoned open on slow storage doesn't hold up shutdown.
+  std::thread([path = std::move(path), allow_patches, callback = std::move(callback)]() {
+    Threading::SetNameOfCurrentThread("CDImage Open");
+
+    Error error;
+    std::unique_ptr<CDImage> image = Open(path.c_str(), allow_patches, &error);
+    callback(std::move(image), &error);
+  }).detach();
+}
+
 bool CDImage::HasOverlayablePatch(const char* path)
 {
   // Annoying handling because of storage access framework.
@@ -306,6 +320,35 @@ bool CDImage::ReadRawSector(void* buffer, SubChannelQ* subq)
   return true;
 }
 
+const u8* CDImage::ReadRawSectorInPlace(SubChannelQ* subq)
+{
+  if (m_position_in_index == m_current_index->length)
+  {
+    if (!Seek(m_position_on_disc))
+      return nullptr;
+  }
+
+  if (m_current_index->file_sector_size != RAW_SECTOR_SIZE)
+    return nullptr;
+
+  const u8* data = GetSectorPointerFromIndex(*m_current_index, m_position_in_index);
+  if (!data)
+    return nullptr;
+
+  if (subq && !ReadSubChannelQ(subq, *m_current_index, m_position_in_index))
+    return nullptr;
+
+  m_position_on_disc++;
+  m_position_in_index++;
+  m_position_in_track++;
+  return data;
+}
+
+const u8* CDImage::GetSectorPointerFromIndex(const Index& index, LBA lba_in_index)
+{
+  return nullptr;
+}
+
 bool CDImage::ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index)
 {
   GenerateSubChannelQ(subq, index, lba_in_index);
@@ -352,6 +395,15 @@ bool CDImage::IsPrecached() const
   return false;
 }
 
+bool CDImage::IsPrecachedCompressed() const
+{
+  return false;
+}
+
+void CDImage::SetDecompressionCacheSize(u32 size)
+{
+}
+
 s64 CDImage::GetSizeOnDisk() const
 {
   return -1;
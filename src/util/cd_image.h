@@ -9,6 +9,7 @@
 #include "common/types.h"
 
 #include <array>
+#include <functional>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -224,8 +225,16 @@ public:
   /// Returns true if an overlayable patch file exists for the specified image path.
   static bool HasOverlayablePatch(const char* path);
 
+  /// Callback for OpenAsync(), invoked on the worker thread. error is only meaningful if image is null.
+  using OpenCallback = std::function<void(std::unique_ptr<CDImage> image, Error* error)>;
+
+  /// Sets the file used to remember CHD header hashes between runs, so parent lookups can skip reading every file in
+  /// the directory. Without a path, the index is kept in memory only.
+  static void SetCHDHeaderIndexPath(std::string path);
+
   // Opening disc image.
   static std::unique_ptr<CDImage> Open(const char* path, bool allow_patches, Error* error);
+  static void OpenAsync(std::string path, bool allow_patches, OpenCallback callback);
   static std::unique_ptr<CDImage> OpenBinImage(const char* path, Error* error);
   static std::unique_ptr<CDImage> OpenCueSheetImage(const char* path, Error* error);
   static std::unique_ptr<CDImage> OpenCHDImage(const char* path, Error* error);
@@ -234,6 +243,8 @@ public:
   static std::unique_ptr<CDImage> OpenM3uImage(const char* path, bool apply_patches, Error* error);
   static std::unique_ptr<CDImage> OpenDeviceImage(const char* path, Error* error);
   static std::unique_ptr<CDImage> CreateMemoryImage(CDImage* image, ProgressCallback* progress, Error* error);
+  static std::unique_ptr<CDImage> CreateCompressedMemoryImage(CDImage* image, ProgressCallback* progress,
+                                                              Error* error);
   static std::unique_ptr<CDImage> OverlayPPFPatch(const char* path, std::unique_ptr<CDImage> parent_image,
                                                   Error* error);
 
@@ -286,12 +297,19 @@ public:
   // Reads sub-channel Q for the specified index+LBA.
   virtual bool ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index);
 
+  // Reads a raw sector without copying it, returning a pointer into the image's storage, and advances the position.
+  // Returns nullptr without advancing if the sector can't be addressed directly, use ReadRawSector() instead.
+  const u8* ReadRawSectorInPlace(SubChannelQ* subq);
+
   // Returns true if the image has replacement subchannel data.
   virtual bool HasSubchannelData() const;
 
   // Reads a single sector from an index.
   virtual bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) = 0;
 
+  // Returns a pointer to a raw sector in the image's backing storage, if it is kept in memory as-is.
+  virtual const u8* GetSectorPointerFromIndex(const Index& index, LBA lba_in_index);
+
   // Returns true if this image type has sub-images (e.g. m3u).
   virtual bool HasSubImages() const;
 
@@ -311,6 +329,12 @@ public:
   virtual PrecacheResult Precache(ProgressCallback* progress, Error* error);
   virtual bool IsPrecached() const;
 
+  // Returns true if the precached data is compressed, and has to be decompressed on read.
+  virtual bool IsPrecachedCompressed() const;
+
+  // Sets the memory budget for decompressed data in compressed formats. Must not be called while reads are in flight.
+  virtual void SetDecompressionCacheSize(u32 size);
+
   // Returns the size on disk of the image. This could be multiple files.
   // If this function returns -1, it means the size could not be computed.
   virtual s64 GetSizeOnDisk() const;
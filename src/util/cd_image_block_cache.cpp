@@ -0,0 +1,191 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "cd_image_block_cache.h"
+
+#include "common/assert.h"
+
+#include <limits>
+
+CDImageBlockCache::CDImageBlockCache() = default;
+
+CDImageBlockCache::~CDImageBlockCache()
+{
+  StopPrefetchThreads();
+}
+
+void CDImageBlockCache::Allocate(u32 block_size, u32 num_slots)
+{
+  StopPrefetchThreads();
+
+  m_buffer.resize(static_cast<size_t>(block_size) * num_slots);
+  m_slots.resize(num_slots);
+  for (u32 i = 0; i < num_slots; i++)
+  {
+    Slot& slot = m_slots[i];
+    slot.data = m_buffer.data() + static_cast<size_t>(block_size) * i;
+    slot.last_use = 0;
+    slot.key = INVALID_KEY;
+    slot.state = SlotState::Empty;
+  }
+
+  m_slot_map.clear();
+  m_slot_map.reserve(num_slots);
+  m_use_counter = 0;
+}
+
+void CDImageBlockCache::StartPrefetchThreads(std::vector<DecodeFunction> decoders)
+{
+  StopPrefetchThreads();
+
+  m_prefetch_shutdown = false;
+  m_prefetch_threads.reserve(decoders.size());
+  for (DecodeFunction& decode : decoders)
+    m_prefetch_threads.emplace_back([this, decode = std::move(decode)]() { PrefetchThreadEntryPoint(decode); });
+}
+
+void CDImageBlockCache::StopPrefetchThreads()
+{
+  if (m_prefetch_threads.empty())
+    return;
+
+  {
+    std::unique_lock lock(m_mutex);
+    m_prefetch_shutdown = true;
+    m_prefetch_cv.notify_all();
+  }
+
+  for (std::thread& thread : m_prefetch_threads)
+    thread.join();
+  m_prefetch_threads.clear();
+
+  // Anything still queued was never decoded.
+  for (const u32 slot_index : m_prefetch_queue)
+  {
+    Slot& slot = m_slots[slot_index];
+    m_slot_map.erase(slot.key);
+    slot.key = INVALID_KEY;
+    slot.state = SlotState::Empty;
+    slot.last_use = 0;
+  }
+  m_prefetch_queue.clear();
+}
+
+const u8* CDImageBlockCache::Lookup(u64 key, const DecodeFunction& decode)
+{
+  std::unique_lock lock(m_mutex);
+
+  u32 slot_index;
+  if (const auto it = m_slot_map.find(key); it != m_slot_map.end())
+  {
+    slot_index = it->second;
+
+    // Wait for the prefetch thread to finish with it, rather than decoding it twice.
+    m_prefetch_done_cv.wait(lock, [this, slot_index]() { return (m_slots[slot_index].state != SlotState::Pending); });
+  }
+  else
+  {
+    slot_index = AllocateSlot(key);
+  }
+
+  Slot& slot = m_slots[slot_index];
+  if (slot.state != SlotState::Ready)
+  {
+    // Not cached, or the prefetch failed. Keep the slot pending so it isn't touched while unlocked.
+    slot.state = SlotState::Pending;
+    lock.unlock();
+    const bool result = decode(key, slot.data);
+    lock.lock();
+
+    if (!result)
+    {
+      // data might have been partially written
+      slot.state = SlotState::Empty;
+      slot.key = INVALID_KEY;
+      m_slot_map.erase(key);
+      return nullptr;
+    }
+
+    slot.state = SlotState::Ready;
+  }
+
+  slot.last_use = ++m_use_counter;
+  return slot.data;
+}
+
+u32 CDImageBlockCache::AllocateSlot(u64 key)
+{
+  // Evict the least recently used slot that isn't being decoded. Empty slots have never been used.
+  u32 victim = 0;
+  u64 victim_last_use = std::numeric_limits<u64>::max();
+  for (u32 i = 0; i < static_cast<u32>(m_slots.size()); i++)
+  {
+    const Slot& slot = m_slots[i];
+    if (slot.state != SlotState::Pending && slot.last_use < victim_last_use)
+    {
+      victim = i;
+      victim_last_use = slot.last_use;
+    }
+  }
+
+  // There's always at least one slot free, prefetching never queues more than a fraction of the cache.
+  Slot& slot = m_slots[victim];
+  DebugAssert(slot.state != SlotState::Pending);
+  if (slot.key != INVALID_KEY)
+    m_slot_map.erase(slot.key);
+
+  slot.key = key;
+  slot.state = SlotState::Empty;
+  slot.last_use = 0;
+  m_slot_map.emplace(key, victim);
+  return victim;
+}
+
+void CDImageBlockCache::QueuePrefetch(std::span<const u64> keys)
+{
+  std::unique_lock lock(m_mutex);
+
+  bool queued = false;
+  for (const u64 key : keys)
+  {
+    if (m_slot_map.contains(key))
+      continue;
+
+    const u32 slot_index = AllocateSlot(key);
+
+    // Prefetched blocks are treated as just used, so they don't get evicted before being read.
+    Slot& slot = m_slots[slot_index];
+    slot.state = SlotState::Pending;
+    slot.last_use = m_use_counter;
+    m_prefetch_queue.push_back(slot_index);
+    queued = true;
+  }
+
+  if (queued)
+    m_prefetch_cv.notify_all();
+}
+
+void CDImageBlockCache::PrefetchThreadEntryPoint(const DecodeFunction& decode)
+{
+  std::unique_lock lock(m_mutex);
+  for (;;)
+  {
+    m_prefetch_cv.wait(lock, [this]() { return (m_prefetch_shutdown || !m_prefetch_queue.empty()); });
+    if (m_prefetch_shutdown)
+      break;
+
+    const u32 slot_index = m_prefetch_queue.front();
+    m_prefetch_queue.pop_front();
+
+    Slot& slot = m_slots[slot_index];
+    const u64 key = slot.key;
+    u8* const data = slot.data;
+    lock.unlock();
+    const bool result = decode(key, data);
+    lock.lock();
+
+    // On failure, the reading thread will retry it and report the error.
+    slot.state = result ? SlotState::Ready : SlotState::Empty;
+    m_prefetch_done_cv.notify_all();
+  }
+}
@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#pragma once
+
+#include "common/heap_array.h"
+#include "common/types.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/// Cache of decompressed blocks for compressed image formats, with optional prefetching on background threads.
+///
+/// Slots are only assigned and evicted by the reading thread, the prefetch threads only fill in slots that are
+/// pending. Blocks are identified by a key which is opaque to the cache, and passed back to the decoder.
+class CDImageBlockCache
+{
+public:
+  /// Decompresses the block identified by key into dst. Prefetch threads each have their own, since decoders
+  /// generally keep state which can't be shared.
+  using DecodeFunction = std::function<bool(u64 key, u8* dst)>;
+
+  CDImageBlockCache();
+  ~CDImageBlockCache();
+
+  ALWAYS_INLINE u32 GetSlotCount() const { return static_cast<u32>(m_slots.size()); }
+  ALWAYS_INLINE u32 GetPrefetchThreadCount() const { return static_cast<u32>(m_prefetch_threads.size()); }
+  ALWAYS_INLINE bool IsPrefetching() const { return !m_prefetch_threads.empty(); }
+
+  /// Stops prefetching, and discards any cached blocks.
+  void Allocate(u32 block_size, u32 num_slots);
+
+  /// Starts a prefetch thread for each decoder.
+  void StartPrefetchThreads(std::vector<DecodeFunction> decoders);
+  void StopPrefetchThreads();
+
+  /// Returns the decompressed block, waiting for it if it's being prefetched, or decoding it on the calling thread
+  /// if it isn't cached. Returns nullptr if it couldn't be decoded. The data is only valid until the next call.
+  const u8* Lookup(u64 key, const DecodeFunction& decode);
+
+  /// Queues blocks to be decoded in the background, skipping any which are already cached.
+  void QueuePrefetch(std::span<const u64> keys);
+
+private:
+  static constexpr u64 INVALID_KEY = static_cast<u64>(-1);
+
+  enum class SlotState : u8
+  {
+    Empty,
+    Pending,
+    Ready,
+  };
+
+  struct Slot
+  {
+    u8* data;
+    u64 last_use;
+    u64 key;
+    SlotState state;
+  };
+
+  u32 AllocateSlot(u64 key);
+  void PrefetchThreadEntryPoint(const DecodeFunction& decode);
+
+  DynamicHeapArray<u8, 16> m_buffer;
+  std::vector<Slot> m_slots;
+  std::unordered_map<u64, u32> m_slot_map;
+  u64 m_use_counter = 0;
+
+  std::mutex m_mutex;
+  std::condition_variable m_prefetch_cv;
+  std::condition_variable m_prefetch_done_cv;
+  std::deque<u32> m_prefetch_queue;
+  std::vector<std::thread> m_prefetch_threads;
+  bool m_prefetch_shutdown = false;
+};
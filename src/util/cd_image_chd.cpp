@@ -2,15 +2,19 @@
 // SPDX-License-Identifier: CC-BY-NC-ND-4.0
 
 #include "cd_image.h"
+#include "cd_image_block_cache.h"
 
 #include "common/align.h"
 #include "common/assert.h"
+#include "common/binary_reader_writer.h"
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/gsvector.h"
 #include "common/hash_combine.h"
+#include "common/heterogeneous_containers.h"
 #include "common/heap_array.h"
 #include "common/log.h"
+#include "common/memory_accounting.h"
 #include "common/path.h"
 #include "common/string_util.h"
 
@@ -19,6 +23,8 @@
 #include "libchdr/chd.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cerrno>
 #include <cstdio>
 #include <cstring>
@@ -52,8 +58,29 @@ static std::optional<CDImage::TrackMode> ParseTrackModeString(const std::string_
     return std::nullopt;
 }
 
-static std::vector<std::pair<std::string, chd_header>> s_chd_hash_cache; // <filename, header>
-static std::recursive_mutex s_chd_hash_cache_mutex;
+/// Identifying hashes of a CHD, remembered across runs so parent lookups don't have to read every header in the
+/// directory. Entries are keyed by path, and invalidated if the size or modification time changes.
+struct CHDHeaderIndexEntry
+{
+  s64 file_size;
+  s64 modification_time;
+  std::array<u8, CHD_MD5_BYTES> md5;
+  std::array<u8, CHD_SHA1_BYTES> sha1;
+};
+
+struct CHDHeaderIndex
+{
+  std::mutex mutex;
+  std::string path;
+  UnorderedStringMap<CHDHeaderIndexEntry> entries;
+  bool loaded = false;
+};
+
+static constexpr u32 CHD_HEADER_INDEX_SIGNATURE = 0x49444843; // CHDI
+static constexpr u32 CHD_HEADER_INDEX_VERSION = 1;
+static constexpr u32 MAX_PARENT_PROBE_THREADS = 8;
+
+static CHDHeaderIndex s_chd_header_index;
 
 class CDImageCHD : public CDImage
 {
@@ -67,6 +94,7 @@ public:
   bool HasSubchannelData() const override;
   PrecacheResult Precache(ProgressCallback* progress, Error* error) override;
   bool IsPrecached() const override;
+  void SetDecompressionCacheSize(u32 size) override;
   s64 GetSizeOnDisk() const override;
 
 protected:
@@ -76,26 +104,247 @@ private:
   static constexpr u32 CHD_CD_SECTOR_DATA_SIZE = 2352 + 96;
   static constexpr u32 CHD_CD_TRACK_ALIGNMENT = 4;
   static constexpr u32 MAX_PARENTS = 32; // Surely someone wouldn't be insane enough to go beyond this...
+  static constexpr u32 INVALID_HUNK = static_cast<u32>(-1);
+
+  // Once this many consecutive hunks have been read, the following hunks are decompressed ahead of time.
+  static constexpr u32 PREFETCH_SEQUENTIAL_HUNKS = 2;
+  static constexpr u32 PREFETCH_HUNK_COUNT = 8;
+  static constexpr u32 PREFETCH_THREAD_COUNT = 2;
+  static constexpr u32 MIN_CACHE_HUNKS_FOR_PREFETCH = PREFETCH_HUNK_COUNT * 4;
 
   chd_file* OpenCHD(std::string_view filename, FileSystem::ManagedCFilePtr fp, Error* error, u32 recursion_level);
   bool UpdateHunkBuffer(const Index& index, LBA lba_in_index, u32& hunk_offset);
+  bool LoadHunk(u32 hunk_index);
+
+  void StartPrefetchThreads();
 
   static void CopyAndSwap(void* dst_ptr, const u8* src_ptr);
 
   chd_file* m_chd = nullptr;
   u32 m_hunk_size = 0;
+  u32 m_hunk_count = 0;
   u32 m_sectors_per_hunk = 0;
 
-  DynamicHeapArray<u8, 16> m_hunk_buffer;
-  u32 m_current_hunk_index = static_cast<u32>(-1);
+  CDImageBlockCache m_hunk_cache;
+  const u8* m_current_hunk_data = nullptr;
+  u32 m_current_hunk_index = INVALID_HUNK;
+  u32 m_sequential_hunk_count = 0;
+
   bool m_precached = false;
 };
 } // namespace
 
+static void LoadCHDHeaderIndex()
+{
+  s_chd_header_index.loaded = true;
+  if (s_chd_header_index.path.empty())
+    return;
+
+  auto fp = FileSystem::OpenManagedCFile(s_chd_header_index.path.c_str(), "rb");
+  if (!fp)
+    return;
+
+  BinaryFileReader reader(fp.get());
+  u32 file_signature, file_version;
+  if (!reader.ReadU32(&file_signature) || !reader.ReadU32(&file_version) ||
+      file_signature != CHD_HEADER_INDEX_SIGNATURE || file_version != CHD_HEADER_INDEX_VERSION)
+  {
+    WARNING_LOG("CHD header index is corrupted or out of date.");
+    return;
+  }
+
+  while (!reader.IsAtEnd())
+  {
+    std::string path;
+    CHDHeaderIndexEntry entry;
+    if (!reader.ReadSizePrefixedString(&path) || !reader.ReadS64(&entry.file_size) ||
+        !reader.ReadS64(&entry.modification_time) || !reader.Read(entry.md5.data(), entry.md5.size()) ||
+        !reader.Read(entry.sha1.data(), entry.sha1.size()))
+    {
+      WARNING_LOG("CHD header index entry is corrupted.");
+      s_chd_header_index.entries.clear();
+      return;
+    }
+
+    s_chd_header_index.entries.insert_or_assign(std::move(path), entry);
+  }
+
+  DEV_LOG("Loaded {} entries from CHD header index.", s_chd_header_index.entries.size());
+}
+
+static void SaveCHDHeaderIndex()
+{
+  if (s_chd_header_index.path.empty())
+    return;
+
+  Error error;
+  FileSystem::AtomicRenamedFile fp = FileSystem::CreateAtomicRenamedFile(s_chd_header_index.path, &error);
+  if (!fp)
+  {
+    ERROR_LOG("Failed to create CHD header index: {}", error.GetDescription());
+    return;
+  }
+
+  BinaryFileWriter writer(fp.get());
+  writer.WriteU32(CHD_HEADER_INDEX_SIGNATURE);
+  writer.WriteU32(CHD_HEADER_INDEX_VERSION);
+  for (const auto& [path, entry] : s_chd_header_index.entries)
+  {
+    writer.WriteSizePrefixedString(path);
+    writer.WriteS64(entry.file_size);
+    writer.WriteS64(entry.modification_time);
+    writer.Write(entry.md5.data(), entry.md5.size());
+    writer.Write(entry.sha1.data(), entry.sha1.size());
+  }
+
+  if (!writer.Flush(&error) || !FileSystem::CommitAtomicRenamedFile(fp, &error))
+  {
+    ERROR_LOG("Failed to write CHD header index: {}", error.GetDescription());
+    FileSystem::DiscardAtomicRenamedFile(fp);
+  }
+}
+
+static bool IsMatchingParentEntry(const chd_header& header, const CHDHeaderIndexEntry& entry)
+{
+  chd_header parent_header = {};
+  std::memcpy(parent_header.md5, entry.md5.data(), entry.md5.size());
+  std::memcpy(parent_header.sha1, entry.sha1.data(), entry.sha1.size());
+  return chd_is_matching_parent(&header, &parent_header);
+}
+
+static std::optional<CHDHeaderIndexEntry> ReadCHDHeaderIndexEntry(const FILESYSTEM_FIND_DATA& fd)
+{
+  std::optional<CHDHeaderIndexEntry> ret;
+
+  chd_header header;
+  auto fp = FileSystem::OpenManagedSharedCFile(fd.FileName.c_str(), "rb", FileSystem::FileShareMode::DenyWrite);
+  if (!fp || chd_read_header_file(fp.get(), &header) != CHDERR_NONE)
+    return ret;
+
+  ret.emplace();
+  ret->file_size = fd.Size;
+  ret->modification_time = static_cast<s64>(fd.ModificationTime);
+  std::memcpy(ret->md5.data(), header.md5, ret->md5.size());
+  std::memcpy(ret->sha1.data(), header.sha1, ret->sha1.size());
+  return ret;
+}
+
+static std::string FindParentCHD(std::string_view filename, const chd_header& header)
+{
+  // Look for a chd with a matching sha1 in the same directory.
+  // Have to do *.* and filter on the extension manually because Linux is case sensitive.
+  const std::string_view parent_dir = Path::GetDirectory(filename);
+  FileSystem::FindResultsArray files;
+  FileSystem::FindFiles(std::string(parent_dir).c_str(), "*.*",
+                        FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_HIDDEN_FILES | FILESYSTEM_FIND_KEEP_ARRAY, &files);
+
+  std::vector<const FILESYSTEM_FIND_DATA*> to_probe;
+  {
+    const std::unique_lock lock(s_chd_header_index.mutex);
+    if (!s_chd_header_index.loaded)
+      LoadCHDHeaderIndex();
+
+    // Headers we've seen before, and that haven't changed since, don't need to be read again.
+    for (const FILESYSTEM_FIND_DATA& fd : files)
+    {
+      if (!StringUtil::EqualNoCase(Path::GetExtension(fd.FileName), "chd") || fd.FileName == filename)
+        continue;
+
+      const auto it = s_chd_header_index.entries.find(fd.FileName);
+      if (it == s_chd_header_index.entries.end() || it->second.file_size != fd.Size ||
+          it->second.modification_time != static_cast<s64>(fd.ModificationTime))
+      {
+        to_probe.push_back(&fd);
+        continue;
+      }
+
+      if (IsMatchingParentEntry(header, it->second))
+      {
+        VERBOSE_LOG("Found parent CHD '{}' in header index.", Path::GetFileName(fd.FileName));
+        return fd.FileName;
+      }
+    }
+  }
+
+  if (to_probe.empty())
+    return {};
+
+  // Reading headers is dominated by latency on network shares, so read several at once.
+  std::vector<std::optional<CHDHeaderIndexEntry>> probed(to_probe.size());
+  std::atomic<u32> next_probe{0};
+  std::atomic_bool found{false};
+  const auto probe_worker = [&to_probe, &probed, &next_probe, &found, &header]() {
+    while (!found.load(std::memory_order_relaxed))
+    {
+      const u32 idx = next_probe.fetch_add(1, std::memory_order_relaxed);
+      if (idx >= to_probe.size())
+        break;
+
+      probed[idx] = ReadCHDHeaderIndexEntry(*to_probe[idx]);
+      if (probed[idx].has_value() && IsMatchingParentEntry(header, probed[idx].value()))
+        found.store(true, std::memory_order_relaxed);
+    }
+  };
+
+  const u32 num_threads = std::min(static_cast<u32>(to_probe.size()), MAX_PARENT_PROBE_THREADS);
+  if (num_threads > 1)
+  {
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (u32 i = 1; i < num_threads; i++)
+      threads.emplace_back(probe_worker);
+    probe_worker();
+    for (std::thread& thread : threads)
+      thread.join();
+  }
+  else
+  {
+    probe_worker();
+  }
+
+  std::string ret;
+  const std::unique_lock lock(s_chd_header_index.mutex);
+  for (size_t i = 0; i < to_probe.size(); i++)
+  {
+    if (!probed[i].has_value())
+      continue;
+
+    if (ret.empty() && IsMatchingParentEntry(header, probed[i].value()))
+      ret = to_probe[i]->FileName;
+
+    s_chd_header_index.entries.insert_or_assign(to_probe[i]->FileName, probed[i].value());
+  }
+
+  // Drop anything from this directory that no longer exists while we're here.
+  const auto file_exists = [&files](const std::string& path) {
+    return std::any_of(files.begin(), files.end(),
+                       [&path](const FILESYSTEM_FIND_DATA& fd) { return fd.FileName == path; });
+  };
+  for (auto it = s_chd_header_index.entries.begin(); it != s_chd_header_index.entries.end();)
+  {
+    if (Path::GetDirectory(it->first) == parent_dir && !file_exists(it->first))
+    {
+      it = s_chd_header_index.entries.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  SaveCHDHeaderIndex();
+  return ret;
+}
+
 CDImageCHD::CDImageCHD() = default;
 
 CDImageCHD::~CDImageCHD()
 {
+  m_hunk_cache.StopPrefetchThreads();
+
+  if (m_precached)
+    MemoryAccounting::Add(MemoryAccounting::Category::CDPrecache, -GetSizeOnDisk(), 0);
+
   if (m_chd)
     chd_close(m_chd);
 }
@@ -135,79 +384,17 @@ chd_file* CDImageCHD::OpenCHD(std::string_view filename, FileSystem::ManagedCFil
     return nullptr;
   }
 
-  // Find a chd with a matching sha1 in the same directory.
-  // Have to do *.* and filter on the extension manually because Linux is case sensitive.
   chd_file* parent_chd = nullptr;
-  const std::string parent_dir(Path::GetDirectory(filename));
-  const std::unique_lock hash_cache_lock(s_chd_hash_cache_mutex);
-
-  // Memoize which hashes came from what files, to avoid reading them repeatedly.
-  for (auto it = s_chd_hash_cache.begin(); it != s_chd_hash_cache.end(); ++it)
+  const std::string parent_path = FindParentCHD(filename, header);
+  if (!parent_path.empty())
   {
-    if (!StringUtil::EqualNoCase(parent_dir, Path::GetDirectory(it->first)))
-      continue;
-
-    if (!chd_is_matching_parent(&header, &it->second))
-      continue;
-
-    // Re-check the header, it might have changed since we last opened.
-    chd_header parent_header;
-    auto parent_fp = FileSystem::OpenManagedSharedCFile(it->first.c_str(), "rb", FileSystem::FileShareMode::DenyWrite);
-    if (parent_fp && chd_read_header_file(parent_fp.get(), &parent_header) == CHDERR_NONE &&
-        chd_is_matching_parent(&header, &parent_header))
+    auto parent_fp =
+      FileSystem::OpenManagedSharedCFile(parent_path.c_str(), "rb", FileSystem::FileShareMode::DenyWrite);
+    if (parent_fp)
     {
-      // Need to take a copy of the string, because the parent might add to the list and invalidate the iterator.
-      const std::string filename_to_open = it->first;
-
-      // Match! Open this one.
-      parent_chd = OpenCHD(filename_to_open, std::move(parent_fp), error, recursion_level + 1);
-      if (parent_chd)
-      {
-        VERBOSE_LOG("Using parent CHD '{}' from cache for '{}'.", Path::GetFileName(filename_to_open),
-                    Path::GetFileName(filename));
-      }
-    }
-
-    // No point checking any others. Since we recursively call OpenCHD(), the iterator is invalidated anyway.
-    break;
-  }
-  if (!parent_chd)
-  {
-    // Look for files in the same directory as the chd.
-    FileSystem::FindResultsArray parent_files;
-    FileSystem::FindFiles(parent_dir.c_str(), "*.*",
-                          FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_HIDDEN_FILES | FILESYSTEM_FIND_KEEP_ARRAY,
-                          &parent_files);
-    for (FILESYSTEM_FIND_DATA& fd : parent_files)
-    {
-      if (StringUtil::EndsWithNoCase(Path::GetExtension(fd.FileName), ".chd"))
-        continue;
-
-      // Re-check the header, it might have changed since we last opened.
-      chd_header parent_header;
-      auto parent_fp =
-        FileSystem::OpenManagedSharedCFile(fd.FileName.c_str(), "rb", FileSystem::FileShareMode::DenyWrite);
-      if (!parent_fp || chd_read_header_file(parent_fp.get(), &parent_header) != CHDERR_NONE)
-        continue;
-
-      // Don't duplicate in the cache. But update it, in case the file changed.
-      auto cache_it = std::find_if(s_chd_hash_cache.begin(), s_chd_hash_cache.end(),
-                                   [&fd](const auto& it) { return it.first == fd.FileName; });
-      if (cache_it != s_chd_hash_cache.end())
-        std::memcpy(&cache_it->second, &parent_header, sizeof(parent_header));
-      else
-        s_chd_hash_cache.emplace_back(fd.FileName, parent_header);
-
-      if (!chd_is_matching_parent(&header, &parent_header))
-        continue;
-
-      // Match! Open this one.
-      parent_chd = OpenCHD(fd.FileName, std::move(parent_fp), error, recursion_level + 1);
+      parent_chd = OpenCHD(parent_path, std::move(parent_fp), error, recursion_level + 1);
       if (parent_chd)
-      {
-        VERBOSE_LOG("Using parent CHD '{}' for '{}'.", Path::GetFileName(fd.FileName), Path::GetFileName(filename));
-        break;
-      }
+        VERBOSE_LOG("Using parent CHD '{}' for '{}'.", Path::GetFileName(parent_path), Path::GetFileName(filename));
     }
   }
   if (!parent_chd)
@@ -257,8 +444,9 @@ bool CDImageCHD::Open(const char* filename, Error* error)
     return false;
   }
 
+  m_hunk_count = header->totalhunks;
   m_sectors_per_hunk = m_hunk_size / CHD_CD_SECTOR_DATA_SIZE;
-  m_hunk_buffer.resize(m_hunk_size);
+  m_hunk_cache.Allocate(m_hunk_size, 1);
   m_filename = filename;
 
   u32 disc_lba = 0;
@@ -425,7 +613,7 @@ bool CDImageCHD::ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_
     return false;
 
   u8 deinterleaved_subchannel_data[96];
-  const u8* raw_subchannel_data = &m_hunk_buffer[hunk_offset + RAW_SECTOR_SIZE];
+  const u8* raw_subchannel_data = &m_current_hunk_data[hunk_offset + RAW_SECTOR_SIZE];
   const u8* real_subchannel_data = raw_subchannel_data;
   if (index.submode == CDImage::SubchannelMode::RawInterleaved)
   {
@@ -467,7 +655,9 @@ CDImage::PrecacheResult CDImageCHD::Precache(ProgressCallback* progress, Error*
     return CDImage::PrecacheResult::ReadError;
   }
 
+  // The whole file is read into memory, including any parts that aren't sector data.
   m_precached = true;
+  MemoryAccounting::Add(MemoryAccounting::Category::CDPrecache, GetSizeOnDisk(), 0);
   return CDImage::PrecacheResult::Success;
 }
 
@@ -503,9 +693,9 @@ bool CDImageCHD::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
 
   // Audio data is in big-endian, so we have to swap it for little endian hosts...
   if (index.mode == TrackMode::Audio)
-    CopyAndSwap(buffer, &m_hunk_buffer[hunk_offset]);
+    CopyAndSwap(buffer, &m_current_hunk_data[hunk_offset]);
   else
-    std::memcpy(buffer, &m_hunk_buffer[hunk_offset], RAW_SECTOR_SIZE);
+    std::memcpy(buffer, &m_current_hunk_data[hunk_offset], RAW_SECTOR_SIZE);
 
   return true;
 }
@@ -520,20 +710,82 @@ ALWAYS_INLINE_RELEASE bool CDImageCHD::UpdateHunkBuffer(const Index& index, LBA
   if (m_current_hunk_index == hunk_index)
     return true;
 
-  const chd_error err = chd_read(m_chd, hunk_index, m_hunk_buffer.data());
-  if (err != CHDERR_NONE)
-  {
-    ERROR_LOG("chd_read({}) failed: {}", hunk_index, chd_error_string(err));
+  return LoadHunk(hunk_index);
+}
 
-    // data might have been partially written
-    m_current_hunk_index = static_cast<u32>(-1);
+bool CDImageCHD::LoadHunk(u32 hunk_index)
+{
+  m_sequential_hunk_count = (hunk_index == (m_current_hunk_index + 1)) ? (m_sequential_hunk_count + 1) : 0;
+  m_current_hunk_index = INVALID_HUNK;
+  m_current_hunk_data = m_hunk_cache.Lookup(hunk_index, [this](u64 key, u8* dst) {
+    const chd_error err = chd_read(m_chd, static_cast<u32>(key), dst);
+    if (err != CHDERR_NONE)
+    {
+      ERROR_LOG("chd_read({}) failed: {}", key, chd_error_string(err));
+      return false;
+    }
+
+    return true;
+  });
+  if (!m_current_hunk_data)
     return false;
-  }
 
   m_current_hunk_index = hunk_index;
+
+  if (m_sequential_hunk_count >= PREFETCH_SEQUENTIAL_HUNKS && m_hunk_cache.IsPrefetching())
+  {
+    std::array<u64, PREFETCH_HUNK_COUNT> keys;
+    u32 num_keys = 0;
+    for (u32 i = hunk_index + 1; i < m_hunk_count && num_keys < PREFETCH_HUNK_COUNT; i++)
+      keys[num_keys++] = i;
+    m_hunk_cache.QueuePrefetch(std::span<const u64>(keys.data(), num_keys));
+  }
+
   return true;
 }
 
+void CDImageCHD::SetDecompressionCacheSize(u32 size)
+{
+  const u32 num_slots = std::max(size / m_hunk_size, 1u);
+  if (num_slots == m_hunk_cache.GetSlotCount())
+    return;
+
+  m_hunk_cache.Allocate(m_hunk_size, num_slots);
+  m_current_hunk_data = nullptr;
+  m_current_hunk_index = INVALID_HUNK;
+  m_sequential_hunk_count = 0;
+  if (num_slots >= MIN_CACHE_HUNKS_FOR_PREFETCH)
+    StartPrefetchThreads();
+
+  DEV_LOG("Using {} hunk decompression cache ({} KB) with {} prefetch threads", num_slots,
+          (num_slots * m_hunk_size) / 1024, m_hunk_cache.GetPrefetchThreadCount());
+}
+
+void CDImageCHD::StartPrefetchThreads()
+{
+  // libchdr handles aren't thread safe, so each thread decompresses from its own.
+  std::vector<CDImageBlockCache::DecodeFunction> decoders;
+  for (u32 i = 0; i < PREFETCH_THREAD_COUNT; i++)
+  {
+    Error error;
+    auto fp =
+      FileSystem::OpenManagedSharedCFile(m_filename.c_str(), "rb", FileSystem::FileShareMode::DenyWrite, &error);
+    chd_file* chd = fp ? OpenCHD(m_filename, std::move(fp), &error, 0) : nullptr;
+    if (!chd)
+    {
+      WARNING_LOG("Failed to open CHD for prefetching: {}", error.GetDescription());
+      break;
+    }
+
+    // Closed when the thread exits. On failure, the reading thread will retry it and report the error.
+    decoders.emplace_back([chd = std::shared_ptr<chd_file>(chd, chd_close)](u64 key, u8* dst) {
+      return (chd_read(chd.get(), static_cast<u32>(key), dst) == CHDERR_NONE);
+    });
+  }
+
+  m_hunk_cache.StartPrefetchThreads(std::move(decoders));
+}
+
 s64 CDImageCHD::GetSizeOnDisk() const
 {
   return static_cast<s64>(chd_get_compressed_size(m_chd));
@@ -547,3 +799,14 @@ std::unique_ptr<CDImage> CDImage::OpenCHDImage(const char* path, Error* error)
 
   return image;
 }
+
+void CDImage::SetCHDHeaderIndexPath(std::string path)
+{
+  const std::unique_lock lock(s_chd_header_index.mutex);
+  if (s_chd_header_index.path == path)
+    return;
+
+  s_chd_header_index.path = std::move(path);
+  s_chd_header_index.entries.clear();
+  s_chd_header_index.loaded = false;
+}
@@ -11,6 +11,7 @@
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/memmap.h"
 #include "common/path.h"
 #include "common/string_util.h"
 
@@ -41,6 +42,12 @@ public:
 
   virtual bool Read(void* buffer, u64 offset, u32 size, Error* error) = 0;
 
+  /// Returns a pointer to the file data if it is mapped into memory, otherwise nullptr.
+  virtual const u8* GetMappedData(u64 offset, u32 size);
+
+  /// Hints that the whole of a mapped file will be read soon. Returns false if the file isn't mapped.
+  virtual bool PrefetchMappedData();
+
 protected:
   std::string m_filename;
 };
@@ -55,10 +62,18 @@ public:
   u64 GetDiskSize() override;
 
   bool Read(void* buffer, u64 offset, u32 size, Error* error) override;
+  const u8* GetMappedData(u64 offset, u32 size) override;
+  bool PrefetchMappedData() override;
+
+  /// Maps the file into memory, so sectors can be read without going through stdio.
+  bool Map(Error* error);
 
 private:
   FileSystem::ManagedCFilePtr m_file;
   u64 m_file_position = 0;
+
+  const u8* m_mapping = nullptr;
+  size_t m_mapping_size = 0;
 };
 
 class ECMTrackFileInterface final : public TrackFileInterface
@@ -144,12 +159,16 @@ public:
   bool OpenAndParseSingleFile(const char* path, Error* error);
 
   s64 GetSizeOnDisk() const override;
+  PrecacheResult Precache(ProgressCallback* progress, Error* error) override;
+  bool IsPrecached() const override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
+  const u8* GetSectorPointerFromIndex(const Index& index, LBA lba_in_index) override;
 
 private:
   std::vector<std::unique_ptr<TrackFileInterface>> m_files;
+  bool m_precached = false;
 };
 
 } // namespace
@@ -162,12 +181,57 @@ TrackFileInterface::TrackFileInterface(std::string filename) : m_filename(std::m
 
 TrackFileInterface::~TrackFileInterface() = default;
 
+const u8* TrackFileInterface::GetMappedData(u64 offset, u32 size)
+{
+  return nullptr;
+}
+
+bool TrackFileInterface::PrefetchMappedData()
+{
+  return false;
+}
+
 BinaryTrackFileInterface::BinaryTrackFileInterface(std::string filename, FileSystem::ManagedCFilePtr file)
   : TrackFileInterface(std::move(filename)), m_file(std::move(file))
 {
 }
 
-BinaryTrackFileInterface::~BinaryTrackFileInterface() = default;
+BinaryTrackFileInterface::~BinaryTrackFileInterface()
+{
+  if (m_mapping)
+    MemMap::UnmapFile(m_mapping, m_mapping_size);
+}
+
+bool BinaryTrackFileInterface::Map(Error* error)
+{
+  const s64 size = FileSystem::FSize64(m_file.get(), error);
+  if (size <= 0 || static_cast<u64>(size) > std::numeric_limits<size_t>::max())
+  {
+    Error::SetStringView(error, "File is empty or too large to map.");
+    return false;
+  }
+
+  m_mapping_size = static_cast<size_t>(size);
+  m_mapping = static_cast<const u8*>(MemMap::MapFileReadOnly(m_file.get(), m_mapping_size, error));
+  return (m_mapping != nullptr);
+}
+
+const u8* BinaryTrackFileInterface::GetMappedData(u64 offset, u32 size)
+{
+  if (!m_mapping || offset > m_mapping_size || size > (m_mapping_size - offset)) [[unlikely]]
+    return nullptr;
+
+  return m_mapping + offset;
+}
+
+bool BinaryTrackFileInterface::PrefetchMappedData()
+{
+  if (!m_mapping)
+    return false;
+
+  MemMap::PrefetchMappedRange(m_mapping, m_mapping_size);
+  return true;
+}
 
 std::unique_ptr<TrackFileInterface> TrackFileInterface::OpenBinaryFile(const std::string_view filename,
                                                                        const std::string& path, Error* error)
@@ -184,15 +248,33 @@ std::unique_ptr<TrackFileInterface> TrackFileInterface::OpenBinaryFile(const std
 
   // Check for ECM format.
   if (StringUtil::EndsWithNoCase(FileSystem::GetDisplayNameFromPath(path), ".ecm"))
+  {
     fi = ECMTrackFileInterface::Create(std::string(filename), std::move(file), error);
+  }
   else
-    fi = std::make_unique<BinaryTrackFileInterface>(std::string(filename), std::move(file));
+  {
+    std::unique_ptr<BinaryTrackFileInterface> bfi =
+      std::make_unique<BinaryTrackFileInterface>(std::string(filename), std::move(file));
+
+    // Falls back to stdio reads if the file can't be mapped, e.g. no address space on 32-bit hosts.
+    Error map_error;
+    if (!bfi->Map(&map_error))
+      DEV_LOG("Failed to map '{}': {}", FileSystem::GetDisplayNameFromPath(path), map_error.GetDescription());
+
+    fi = std::move(bfi);
+  }
 
   return fi;
 }
 
 bool BinaryTrackFileInterface::Read(void* buffer, u64 offset, u32 size, Error* error)
 {
+  if (const u8* data = GetMappedData(offset, size))
+  {
+    std::memcpy(buffer, data, size);
+    return true;
+  }
+
   if (m_file_position != offset)
   {
     if (!FileSystem::FSeek64(m_file.get(), static_cast<s64>(offset), SEEK_SET, error)) [[unlikely]]
@@ -881,6 +963,38 @@ bool CDImageCueSheet::ReadSectorFromIndex(void* buffer, const Index& index, LBA
   return true;
 }
 
+const u8* CDImageCueSheet::GetSectorPointerFromIndex(const Index& index, LBA lba_in_index)
+{
+  DebugAssert(index.file_index < m_files.size());
+
+  const u64 file_position = index.file_offset + (static_cast<u64>(lba_in_index) * index.file_sector_size);
+  return m_files[index.file_index]->GetMappedData(file_position, index.file_sector_size);
+}
+
+CDImage::PrecacheResult CDImageCueSheet::Precache(ProgressCallback* progress, Error* error)
+{
+  if (m_precached)
+    return PrecacheResult::Success;
+
+  // Mapped files only need paging in, which the OS can do in the background, instead of copying the whole image.
+  if (!std::all_of(m_files.begin(), m_files.end(),
+                   [](const std::unique_ptr<TrackFileInterface>& tf) { return tf->GetMappedData(0, 0) != nullptr; }))
+  {
+    return PrecacheResult::Unsupported;
+  }
+
+  for (const std::unique_ptr<TrackFileInterface>& tf : m_files)
+    tf->PrefetchMappedData();
+
+  m_precached = true;
+  return PrecacheResult::Success;
+}
+
+bool CDImageCueSheet::IsPrecached() const
+{
+  return m_precached;
+}
+
 s64 CDImageCueSheet::GetSizeOnDisk() const
 {
   // Doesn't include the cue.. but they're tiny anyway, whatever.
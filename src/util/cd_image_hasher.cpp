@@ -9,11 +9,20 @@
 #include "common/md5_digest.h"
 #include "common/progress_callback.h"
 #include "common/string_util.h"
+#include "common/threading.h"
 
 #include "fmt/format.h"
 
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 namespace CDImageHasher {
 
+static constexpr u32 READ_CHUNK_SECTORS = 64;
+static constexpr u32 READ_CHUNK_COUNT = 4;
+
 static bool ReadIndex(CDImage* image, u8 track, u8 index, MD5Digest* digest, ProgressCallback* progress_callback,
                       Error* error);
 static bool ReadTrack(CDImage* image, u8 track, MD5Digest* digest, ProgressCallback* progress_callback, Error* error);
@@ -35,26 +44,102 @@ bool CDImageHasher::ReadIndex(CDImage* image, u8 track, u8 index, MD5Digest* dig
     return false;
   }
 
-  std::array<u8, CDImage::RAW_SECTOR_SIZE> sector;
-  for (u32 lba = 0; lba < index_length; lba++)
+  // Reading (and decompressing) happens on another thread, so it overlaps with the digest update.
+  struct Chunk
   {
-    if ((lba % update_interval) == 0)
-      progress_callback->SetProgressValue(lba);
+    std::array<u8, CDImage::RAW_SECTOR_SIZE * READ_CHUNK_SECTORS> data;
+    u32 sectors;
+  };
+
+  std::unique_ptr<Chunk[]> chunks = std::make_unique<Chunk[]>(READ_CHUNK_COUNT);
+  std::mutex mutex;
+  std::condition_variable cv;
+  u32 chunks_read = 0;
+  u32 chunks_digested = 0;
+  bool read_failed = false;
+  bool stop_reading = false;
+  CDImage::LBA failed_lba = 0;
+
+  std::thread read_thread([&]() {
+    Threading::SetNameOfCurrentThread("CDImageHasher Read");
+
+    u32 remaining = index_length;
+    for (u32 chunk_index = 0; remaining > 0; chunk_index++)
+    {
+      {
+        std::unique_lock lock(mutex);
+        cv.wait(lock, [&]() { return stop_reading || (chunk_index - chunks_digested) < READ_CHUNK_COUNT; });
+        if (stop_reading)
+          return;
+      }
+
+      Chunk& chunk = chunks[chunk_index % READ_CHUNK_COUNT];
+      chunk.sectors = std::min(remaining, READ_CHUNK_SECTORS);
+      for (u32 i = 0; i < chunk.sectors; i++)
+      {
+        if (!image->ReadRawSector(&chunk.data[i * CDImage::RAW_SECTOR_SIZE], nullptr))
+        {
+          std::unique_lock lock(mutex);
+          failed_lba = image->GetPositionOnDisc();
+          read_failed = true;
+          cv.notify_all();
+          return;
+        }
+      }
+
+      remaining -= chunk.sectors;
+
+      std::unique_lock lock(mutex);
+      chunks_read++;
+      cv.notify_all();
+    }
+  });
 
-    if (progress_callback->IsCancelled())
-      return false;
+  bool result = true;
+  for (u32 lba = 0; lba < index_length;)
+  {
+    std::unique_lock lock(mutex);
+    cv.wait(lock, [&]() { return read_failed || chunks_read > chunks_digested; });
+    if (chunks_read == chunks_digested)
+    {
+      Error::SetStringFmt(error, "Failed to read sector {} from image", failed_lba);
+      result = false;
+      break;
+    }
+    lock.unlock();
 
-    if (!image->ReadRawSector(sector.data(), nullptr))
+    const Chunk& chunk = chunks[chunks_digested % READ_CHUNK_COUNT];
+    for (u32 i = 0; i < chunk.sectors; i++, lba++)
     {
-      Error::SetStringFmt(error, "Failed to read sector {} from image", image->GetPositionOnDisc());
-      return false;
+      if ((lba % update_interval) == 0)
+        progress_callback->SetProgressValue(lba);
+
+      digest->Update(&chunk.data[i * CDImage::RAW_SECTOR_SIZE], CDImage::RAW_SECTOR_SIZE);
+    }
+
+    lock.lock();
+    chunks_digested++;
+    cv.notify_all();
+    lock.unlock();
+
+    if (progress_callback->IsCancelled())
+    {
+      result = false;
+      break;
     }
+  }
 
-    digest->Update(sector);
+  {
+    std::unique_lock lock(mutex);
+    stop_reading = true;
+    cv.notify_all();
   }
+  read_thread.join();
 
-  progress_callback->SetProgressValue(index_length);
-  return true;
+  if (result)
+    progress_callback->SetProgressValue(index_length);
+
+  return result;
 }
 
 bool CDImageHasher::ReadTrack(CDImage* image, u8 track, MD5Digest* digest, ProgressCallback* progress_callback,
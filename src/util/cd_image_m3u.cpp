@@ -35,9 +35,11 @@ public:
   u32 GetCurrentSubImage() const override;
   std::string GetSubImageTitle(u32 index) const override;
   bool SwitchSubImage(u32 index, Error* error) override;
+  void SetDecompressionCacheSize(u32 size) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
+  const u8* GetSectorPointerFromIndex(const Index& index, LBA lba_in_index) override;
 
 private:
   struct Entry
@@ -50,6 +52,7 @@ private:
   std::vector<Entry> m_entries;
   std::unique_ptr<CDImage> m_current_image;
   u32 m_current_image_index = UINT32_C(0xFFFFFFFF);
+  u32 m_decompression_cache_size = 0;
   bool m_apply_patches = false;
 };
 
@@ -150,6 +153,9 @@ bool CDImageM3u::SwitchSubImage(u32 index, Error* error)
     return false;
   }
 
+  if (m_decompression_cache_size > 0)
+    new_image->SetDecompressionCacheSize(m_decompression_cache_size);
+
   CopyTOC(new_image.get());
   m_current_image = std::move(new_image);
   m_current_image_index = index;
@@ -168,11 +174,23 @@ std::string CDImageM3u::GetSubImageTitle(u32 index) const
   return ret;
 }
 
+void CDImageM3u::SetDecompressionCacheSize(u32 size)
+{
+  // Remembered for the other discs in the playlist.
+  m_decompression_cache_size = size;
+  m_current_image->SetDecompressionCacheSize(size);
+}
+
 bool CDImageM3u::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
 {
   return m_current_image->ReadSectorFromIndex(buffer, index, lba_in_index);
 }
 
+const u8* CDImageM3u::GetSectorPointerFromIndex(const Index& index, LBA lba_in_index)
+{
+  return m_current_image->GetSectorPointerFromIndex(index, lba_in_index);
+}
+
 bool CDImageM3u::ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index)
 {
   return m_current_image->ReadSubChannelQ(subq, index, lba_in_index);
@@ -6,11 +6,16 @@
 #include "common/assert.h"
 #include "common/error.h"
 #include "common/file_system.h"
+#include "common/heap_array.h"
 #include "common/log.h"
+#include "common/memory_accounting.h"
 #include "common/path.h"
 
+#include <zstd.h>
+
 #include <algorithm>
 #include <cerrno>
+#include <vector>
 
 LOG_CHANNEL(CDImage);
 
@@ -22,16 +27,38 @@ public:
   CDImageMemory();
   ~CDImageMemory() override;
 
-  bool CopyImage(CDImage* image, ProgressCallback* progress, Error* error);
+  bool CopyImage(CDImage* image, bool compress, ProgressCallback* progress, Error* error);
 
   bool IsPrecached() const override;
+  bool IsPrecachedCompressed() const override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
 
 private:
+  // Compressed images are stored in groups of sectors, small enough that decompressing one for a random read is
+  // cheap, but large enough for the compressor to find redundancy between sectors.
+  static constexpr u32 SECTORS_PER_GROUP = 16;
+  static constexpr u32 GROUP_SIZE = RAW_SECTOR_SIZE * SECTORS_PER_GROUP;
+  static constexpr int COMPRESSION_LEVEL = 1;
+  static constexpr u32 INVALID_GROUP = 0xFFFFFFFFu;
+
+  bool CopySectors(CDImage* image, ProgressCallback* progress, Error* error);
+  bool CompressSectors(CDImage* image, ProgressCallback* progress, Error* error);
+  bool LoadGroup(u32 group);
+
   u8* m_memory = nullptr;
   u32 m_memory_sectors = 0;
+
+  // Compressed storage. Group N occupies [m_group_offsets[N], m_group_offsets[N + 1]), and is stored uncompressed if
+  // that's the full size of the group.
+  std::vector<u8> m_compressed_data;
+  std::vector<u32> m_group_offsets;
+  DynamicHeapArray<u8> m_group_buffer;
+  ZSTD_DCtx* m_dctx = nullptr;
+  u32 m_current_group = INVALID_GROUP;
+
+  size_t m_accounted_memory = 0;
 };
 
 } // namespace
@@ -40,11 +67,14 @@ CDImageMemory::CDImageMemory() = default;
 
 CDImageMemory::~CDImageMemory()
 {
+  MemoryAccounting::Add(MemoryAccounting::Category::CDPrecache, -static_cast<s64>(m_accounted_memory), 0);
+  if (m_dctx)
+    ZSTD_freeDCtx(m_dctx);
   if (m_memory)
     std::free(m_memory);
 }
 
-bool CDImageMemory::CopyImage(CDImage* image, ProgressCallback* progress, Error* error)
+bool CDImageMemory::CopyImage(CDImage* image, bool compress, ProgressCallback* progress, Error* error)
 {
   // figure out the total number of sectors (not including blank pregaps)
   m_memory_sectors = 0;
@@ -62,6 +92,38 @@ bool CDImageMemory::CopyImage(CDImage* image, ProgressCallback* progress, Error*
     return false;
   }
 
+  if (!(compress ? CompressSectors(image, progress, error) : CopySectors(image, progress, error)))
+    return false;
+
+  for (u32 i = 1; i <= image->GetTrackCount(); i++)
+    m_tracks.push_back(image->GetTrack(i));
+
+  u32 current_offset = 0;
+  for (u32 i = 0; i < image->GetIndexCount(); i++)
+  {
+    Index new_index = image->GetIndex(i);
+    new_index.file_index = 0;
+    if (new_index.file_sector_size > 0)
+    {
+      new_index.file_offset = current_offset;
+      current_offset += new_index.length;
+    }
+    m_indices.push_back(new_index);
+  }
+
+  Assert(current_offset == m_memory_sectors);
+  m_filename = image->GetPath();
+  m_lba_count = image->GetLBACount();
+
+  m_accounted_memory = m_memory ? (static_cast<size_t>(RAW_SECTOR_SIZE) * static_cast<size_t>(m_memory_sectors)) :
+                                  (m_compressed_data.size() + m_group_buffer.size());
+  MemoryAccounting::Add(MemoryAccounting::Category::CDPrecache, static_cast<s64>(m_accounted_memory), 0);
+
+  return Seek(1, Position{0, 0, 0});
+}
+
+bool CDImageMemory::CopySectors(CDImage* image, ProgressCallback* progress, Error* error)
+{
   progress->FormatStatusText("Allocating memory for {} sectors...", m_memory_sectors);
 
   m_memory =
@@ -98,27 +160,129 @@ bool CDImageMemory::CopyImage(CDImage* image, ProgressCallback* progress, Error*
     }
   }
 
-  for (u32 i = 1; i <= image->GetTrackCount(); i++)
-    m_tracks.push_back(image->GetTrack(i));
+  return true;
+}
 
-  u32 current_offset = 0;
-  for (u32 i = 0; i < image->GetIndexCount(); i++)
+bool CDImageMemory::CompressSectors(CDImage* image, ProgressCallback* progress, Error* error)
+{
+  m_dctx = ZSTD_createDCtx();
+  ZSTD_CCtx* cctx = ZSTD_createCCtx();
+  if (!m_dctx || !cctx)
   {
-    Index new_index = image->GetIndex(i);
-    new_index.file_index = 0;
-    if (new_index.file_sector_size > 0)
+    Error::SetStringView(error, "Failed to create zstd context");
+    if (cctx)
+      ZSTD_freeCCtx(cctx);
+    return false;
+  }
+
+  progress->SetTitle("Preloading compressed CD image to RAM...");
+  progress->SetProgressRange(m_memory_sectors);
+  progress->SetProgressValue(0);
+
+  const u32 num_groups = (m_memory_sectors + SECTORS_PER_GROUP - 1) / SECTORS_PER_GROUP;
+  m_group_offsets.reserve(num_groups + 1);
+  m_group_buffer.resize(GROUP_SIZE);
+
+  // Disc data usually compresses to around half, start there to avoid repeated reallocations.
+  m_compressed_data.reserve((static_cast<size_t>(m_memory_sectors) * RAW_SECTOR_SIZE) / 2);
+
+  DynamicHeapArray<u8> compress_buffer(ZSTD_compressBound(GROUP_SIZE));
+  u32 sectors_read = 0;
+  u32 sectors_in_group = 0;
+  const auto flush_group = [this, cctx, &compress_buffer, &sectors_in_group, error]() {
+    const size_t group_size = sectors_in_group * RAW_SECTOR_SIZE;
+    const size_t compressed_size = ZSTD_compressCCtx(cctx, compress_buffer.data(), compress_buffer.size(),
+                                                     m_group_buffer.data(), group_size, COMPRESSION_LEVEL);
+    if (ZSTD_isError(compressed_size))
     {
-      new_index.file_offset = current_offset;
-      current_offset += new_index.length;
+      Error::SetStringFmt(error, "ZSTD_compressCCtx() failed: {}", ZSTD_getErrorName(compressed_size));
+      return false;
+    }
+
+    // Keep incompressible groups as-is, no point paying for decompression.
+    m_group_offsets.push_back(static_cast<u32>(m_compressed_data.size()));
+    if (compressed_size < group_size)
+      m_compressed_data.insert(m_compressed_data.end(), compress_buffer.data(),
+                               compress_buffer.data() + compressed_size);
+    else
+      m_compressed_data.insert(m_compressed_data.end(), m_group_buffer.data(), m_group_buffer.data() + group_size);
+
+    sectors_in_group = 0;
+    return true;
+  };
+
+  bool result = true;
+  for (u32 i = 0; i < image->GetIndexCount() && result; i++)
+  {
+    const Index& index = image->GetIndex(i);
+    if (index.file_sector_size == 0)
+      continue;
+
+    for (u32 lba = 0; lba < index.length; lba++)
+    {
+      if (!image->ReadSectorFromIndex(&m_group_buffer[sectors_in_group * RAW_SECTOR_SIZE], index, lba))
+      {
+        ERROR_LOG("Failed to read LBA {} in index {}", lba, i);
+        Error::SetStringFmt(error, "Failed to read LBA {} in index {}", lba, i);
+        result = false;
+        break;
+      }
+
+      sectors_in_group++;
+      sectors_read++;
+      if (sectors_in_group == SECTORS_PER_GROUP && !flush_group())
+      {
+        result = false;
+        break;
+      }
+
+      progress->SetProgressValue(sectors_read);
     }
-    m_indices.push_back(new_index);
   }
 
-  Assert(current_offset == m_memory_sectors);
-  m_filename = image->GetPath();
-  m_lba_count = image->GetLBACount();
+  if (result && sectors_in_group > 0)
+    result = flush_group();
 
-  return Seek(1, Position{0, 0, 0});
+  ZSTD_freeCCtx(cctx);
+  if (!result)
+    return false;
+
+  m_group_offsets.push_back(static_cast<u32>(m_compressed_data.size()));
+  m_compressed_data.shrink_to_fit();
+  DebugAssert(m_group_offsets.size() == (num_groups + 1));
+
+  INFO_LOG("Compressed {} sectors from {} MB to {} MB.", m_memory_sectors,
+           (static_cast<u64>(m_memory_sectors) * RAW_SECTOR_SIZE) / 1048576, m_compressed_data.size() / 1048576);
+  return true;
+}
+
+bool CDImageMemory::LoadGroup(u32 group)
+{
+  if (m_current_group == group)
+    return true;
+
+  const u32 group_sectors = std::min(m_memory_sectors - group * SECTORS_PER_GROUP, SECTORS_PER_GROUP);
+  const size_t group_size = group_sectors * RAW_SECTOR_SIZE;
+  const u8* src = &m_compressed_data[m_group_offsets[group]];
+  const size_t src_size = m_group_offsets[group + 1] - m_group_offsets[group];
+  if (src_size == group_size)
+  {
+    std::memcpy(m_group_buffer.data(), src, group_size);
+  }
+  else
+  {
+    const size_t result = ZSTD_decompressDCtx(m_dctx, m_group_buffer.data(), group_size, src, src_size);
+    if (ZSTD_isError(result) || result != group_size) [[unlikely]]
+    {
+      ERROR_LOG("Failed to decompress sector group {}: {}", group,
+                ZSTD_isError(result) ? ZSTD_getErrorName(result) : "size mismatch");
+      m_current_group = INVALID_GROUP;
+      return false;
+    }
+  }
+
+  m_current_group = group;
+  return true;
 }
 
 bool CDImageMemory::IsPrecached() const
@@ -126,6 +290,11 @@ bool CDImageMemory::IsPrecached() const
   return true;
 }
 
+bool CDImageMemory::IsPrecachedCompressed() const
+{
+  return (m_memory == nullptr);
+}
+
 bool CDImageMemory::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
 {
   DebugAssert(index.file_index == 0);
@@ -134,6 +303,17 @@ bool CDImageMemory::ReadSectorFromIndex(void* buffer, const Index& index, LBA lb
   if (sector_number >= m_memory_sectors)
     return false;
 
+  if (!m_memory)
+  {
+    // Sequential reads hit the same group, so the decompression cost is spread over the whole group.
+    const u32 group = static_cast<u32>(sector_number / SECTORS_PER_GROUP);
+    if (!LoadGroup(group))
+      return false;
+
+    std::memcpy(buffer, &m_group_buffer[(sector_number % SECTORS_PER_GROUP) * RAW_SECTOR_SIZE], RAW_SECTOR_SIZE);
+    return true;
+  }
+
   const size_t file_offset = static_cast<size_t>(sector_number) * static_cast<size_t>(RAW_SECTOR_SIZE);
   std::memcpy(buffer, &m_memory[file_offset], RAW_SECTOR_SIZE);
   return true;
@@ -142,7 +322,17 @@ bool CDImageMemory::ReadSectorFromIndex(void* buffer, const Index& index, LBA lb
 std::unique_ptr<CDImage> CDImage::CreateMemoryImage(CDImage* image, ProgressCallback* progress, Error* error)
 {
   std::unique_ptr<CDImageMemory> memory_image = std::make_unique<CDImageMemory>();
-  if (!memory_image->CopyImage(image, progress, error))
+  if (!memory_image->CopyImage(image, false, progress, error))
+    return {};
+
+  return memory_image;
+}
+
+std::unique_ptr<CDImage> CDImage::CreateCompressedMemoryImage(CDImage* image, ProgressCallback* progress,
+                                                              Error* error)
+{
+  std::unique_ptr<CDImageMemory> memory_image = std::make_unique<CDImageMemory>();
+  if (!memory_image->CopyImage(image, true, progress, error))
     return {};
 
   return memory_image;
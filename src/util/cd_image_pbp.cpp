@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: CC-BY-NC-ND-4.0
 
 #include "cd_image.h"
+#include "cd_image_block_cache.h"
 
 #include "common/assert.h"
 #include "common/error.h"
@@ -13,6 +14,7 @@
 #include "fmt/format.h"
 #include "zlib.h"
 
+#include <algorithm>
 #include <array>
 #include <cstdio>
 #include <cstring>
@@ -140,11 +142,19 @@ public:
   u32 GetCurrentSubImage() const override;
   bool SwitchSubImage(u32 index, Error* error) override;
   std::string GetSubImageTitle(u32 index) const override;
+  void SetDecompressionCacheSize(u32 size) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
 
 private:
+  static constexpr u32 INVALID_BLOCK = static_cast<u32>(-1);
+
+  // Once this many consecutive blocks have been read, the following blocks are inflated ahead of time.
+  static constexpr u32 PREFETCH_SEQUENTIAL_BLOCKS = 2;
+  static constexpr u32 PREFETCH_BLOCK_COUNT = 8;
+  static constexpr u32 MIN_CACHE_BLOCKS_FOR_PREFETCH = PREFETCH_BLOCK_COUNT * 4;
+
   struct BlockInfo
   {
     u32 offset; // Absolute offset from start of file
@@ -166,7 +176,16 @@ private:
   bool IsValidEboot(Error* error);
 
   bool InitDecompressionStream();
-  bool DecompressBlock(const BlockInfo& block_info);
+  bool LoadBlock(u32 block_index);
+
+  static bool DecompressBlock(std::FILE* fp, z_stream* stream, std::vector<u8>& compressed_block,
+                              const BlockInfo& block_info, u8* dst);
+
+  // Blocks are identified by file offset, so the cache is shared between discs.
+  static u64 GetBlockCacheKey(const BlockInfo& block_info);
+  static BlockInfo GetBlockInfoFromCacheKey(u64 key);
+
+  void StartPrefetchThread();
 
   bool OpenDisc(u32 index, Error* error);
 
@@ -188,8 +207,10 @@ private:
 
   std::array<TOCEntry, TOC_NUM_ENTRIES> m_toc;
 
-  u32 m_current_block = static_cast<u32>(-1);
-  std::array<u8, DECOMPRESSED_BLOCK_SIZE> m_decompressed_block;
+  CDImageBlockCache m_block_cache;
+  const u8* m_current_block_data = nullptr;
+  u32 m_current_block = INVALID_BLOCK;
+  u32 m_sequential_block_count = 0;
   std::vector<u8> m_compressed_block;
 
   z_stream m_inflate_stream;
@@ -198,6 +219,8 @@ private:
 
 CDImagePBP::~CDImagePBP()
 {
+  m_block_cache.StopPrefetchThreads();
+
   if (m_file)
     std::fclose(m_file);
 
@@ -500,11 +523,14 @@ bool CDImagePBP::OpenDisc(u32 index, Error* error)
     return false;
   }
 
-  m_current_block = static_cast<u32>(-1);
+  // Cached blocks are keyed by file offset, so they remain valid for the new disc.
+  m_current_block = INVALID_BLOCK;
+  m_current_block_data = nullptr;
+  m_sequential_block_count = 0;
   m_blockinfo_table.fill({});
   m_toc.fill({});
-  m_decompressed_block.fill(0x00);
-  m_compressed_block.clear();
+  if (m_block_cache.GetSlotCount() == 0)
+    m_block_cache.Allocate(DECOMPRESSED_BLOCK_SIZE, 1);
 
   // Go to ISO header
   const u32 iso_header_start = m_disc_offsets[index];
@@ -754,32 +780,30 @@ bool CDImagePBP::InitDecompressionStream()
   return ret == Z_OK;
 }
 
-bool CDImagePBP::DecompressBlock(const BlockInfo& block_info)
+bool CDImagePBP::DecompressBlock(std::FILE* fp, z_stream* stream, std::vector<u8>& compressed_block,
+                                 const BlockInfo& block_info, u8* dst)
 {
-  if (FileSystem::FSeek64(m_file, block_info.offset, SEEK_SET) != 0)
+  if (FileSystem::FSeek64(fp, block_info.offset, SEEK_SET) != 0)
     return false;
 
   // Compression level 0 has compressed size == decompressed size.
-  if (block_info.size == m_decompressed_block.size())
-  {
-    return (std::fread(m_decompressed_block.data(), sizeof(u8), m_decompressed_block.size(), m_file) ==
-            m_decompressed_block.size());
-  }
+  if (block_info.size == DECOMPRESSED_BLOCK_SIZE)
+    return (std::fread(dst, sizeof(u8), DECOMPRESSED_BLOCK_SIZE, fp) == DECOMPRESSED_BLOCK_SIZE);
 
-  m_compressed_block.resize(block_info.size);
+  compressed_block.resize(block_info.size);
 
-  if (std::fread(m_compressed_block.data(), sizeof(u8), m_compressed_block.size(), m_file) != m_compressed_block.size())
+  if (std::fread(compressed_block.data(), sizeof(u8), compressed_block.size(), fp) != compressed_block.size())
     return false;
 
-  m_inflate_stream.next_in = m_compressed_block.data();
-  m_inflate_stream.avail_in = static_cast<uInt>(m_compressed_block.size());
-  m_inflate_stream.next_out = m_decompressed_block.data();
-  m_inflate_stream.avail_out = static_cast<uInt>(m_decompressed_block.size());
+  stream->next_in = compressed_block.data();
+  stream->avail_in = static_cast<uInt>(compressed_block.size());
+  stream->next_out = dst;
+  stream->avail_out = DECOMPRESSED_BLOCK_SIZE;
 
-  if (inflateReset(&m_inflate_stream) != Z_OK)
+  if (inflateReset(stream) != Z_OK)
     return false;
 
-  int err = inflate(&m_inflate_stream, Z_FINISH);
+  int err = inflate(stream, Z_FINISH);
   if (err != Z_STREAM_END) [[unlikely]]
   {
     ERROR_LOG("Inflate error {}", err);
@@ -801,23 +825,125 @@ bool CDImagePBP::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
     return false;
   }
 
-  const BlockInfo& bi = m_blockinfo_table[requested_block];
+  if (m_current_block != requested_block && !LoadBlock(requested_block)) [[unlikely]]
+    return false;
+
+  std::memcpy(buffer, &m_current_block_data[offset_in_block], RAW_SECTOR_SIZE);
+  return true;
+}
+
+bool CDImagePBP::LoadBlock(u32 block_index)
+{
+  const BlockInfo& bi = m_blockinfo_table[block_index];
   if (bi.size == 0) [[unlikely]]
   {
-    ERROR_LOG("Requested block {} has size 0", requested_block);
+    ERROR_LOG("Requested block {} has size 0", block_index);
     return false;
   }
 
-  if (m_current_block != requested_block && !DecompressBlock(bi)) [[unlikely]]
+  m_sequential_block_count = (block_index == (m_current_block + 1)) ? (m_sequential_block_count + 1) : 0;
+  m_current_block = INVALID_BLOCK;
+  m_current_block_data = m_block_cache.Lookup(GetBlockCacheKey(bi), [this](u64 key, u8* dst) {
+    return DecompressBlock(m_file, &m_inflate_stream, m_compressed_block, GetBlockInfoFromCacheKey(key), dst);
+  });
+  if (!m_current_block_data)
   {
-    ERROR_LOG("Failed to decompress block {}", requested_block);
+    ERROR_LOG("Failed to decompress block {}", block_index);
     return false;
   }
 
-  std::memcpy(buffer, &m_decompressed_block[offset_in_block], RAW_SECTOR_SIZE);
+  m_current_block = block_index;
+
+  if (m_sequential_block_count >= PREFETCH_SEQUENTIAL_BLOCKS && m_block_cache.IsPrefetching())
+  {
+    std::array<u64, PREFETCH_BLOCK_COUNT> keys;
+    u32 num_keys = 0;
+    for (u32 i = block_index + 1; i < BLOCK_TABLE_NUM_ENTRIES && num_keys < PREFETCH_BLOCK_COUNT; i++)
+    {
+      if (m_blockinfo_table[i].size == 0)
+        break;
+
+      keys[num_keys++] = GetBlockCacheKey(m_blockinfo_table[i]);
+    }
+    m_block_cache.QueuePrefetch(std::span<const u64>(keys.data(), num_keys));
+  }
+
   return true;
 }
 
+u64 CDImagePBP::GetBlockCacheKey(const BlockInfo& block_info)
+{
+  return (static_cast<u64>(block_info.offset) << 32) | block_info.size;
+}
+
+CDImagePBP::BlockInfo CDImagePBP::GetBlockInfoFromCacheKey(u64 key)
+{
+  return BlockInfo{static_cast<u32>(key >> 32), static_cast<u16>(key)};
+}
+
+void CDImagePBP::SetDecompressionCacheSize(u32 size)
+{
+  const u32 num_slots = std::max(size / DECOMPRESSED_BLOCK_SIZE, 1u);
+  if (num_slots == m_block_cache.GetSlotCount())
+    return;
+
+  m_block_cache.Allocate(DECOMPRESSED_BLOCK_SIZE, num_slots);
+  m_current_block_data = nullptr;
+  m_current_block = INVALID_BLOCK;
+  m_sequential_block_count = 0;
+  if (num_slots >= MIN_CACHE_BLOCKS_FOR_PREFETCH)
+    StartPrefetchThread();
+
+  DEV_LOG("Using {} block decompression cache ({} KB){}", num_slots, (num_slots * DECOMPRESSED_BLOCK_SIZE) / 1024,
+          m_block_cache.IsPrefetching() ? " with prefetching" : "");
+}
+
+void CDImagePBP::StartPrefetchThread()
+{
+  // The prefetch thread needs its own file position and stream, so it reads through a separate handle.
+  struct PrefetchDecoder
+  {
+    ~PrefetchDecoder()
+    {
+      if (stream_initialized)
+        inflateEnd(&stream);
+      if (fp)
+        std::fclose(fp);
+    }
+
+    std::FILE* fp = nullptr;
+    z_stream stream = {};
+    bool stream_initialized = false;
+    std::vector<u8> compressed_block;
+  };
+
+  // zlib streams can't be moved once initialized, so it's set up in place.
+  Error error;
+  std::shared_ptr<PrefetchDecoder> decoder = std::make_shared<PrefetchDecoder>();
+  decoder->fp = FileSystem::OpenSharedCFile(m_filename.c_str(), "rb", FileSystem::FileShareMode::DenyWrite, &error);
+  if (!decoder->fp)
+  {
+    WARNING_LOG("Failed to open PBP for prefetching: {}", error.GetDescription());
+    return;
+  }
+
+  // Blocks are inflated on the reading thread if we can't prefetch them.
+  if (const int err = inflateInit2(&decoder->stream, -MAX_WBITS); err != Z_OK)
+  {
+    WARNING_LOG("Failed to initialize zlib stream for prefetching: {}", err);
+    return;
+  }
+  decoder->stream_initialized = true;
+
+  // On failure, the reading thread will retry it and report the error.
+  std::vector<CDImageBlockCache::DecodeFunction> decoders;
+  decoders.emplace_back([decoder = std::move(decoder)](u64 key, u8* dst) {
+    return DecompressBlock(decoder->fp, &decoder->stream, decoder->compressed_block, GetBlockInfoFromCacheKey(key),
+                           dst);
+  });
+  m_block_cache.StartPrefetchThreads(std::move(decoders));
+}
+
 #if defined(_DEBUG) || defined(_DEVEL)
 void CDImagePBP::PrintPBPHeaderInfo(const PBPHeader& pbp_header)
 {
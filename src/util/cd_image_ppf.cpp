@@ -41,6 +41,7 @@ public:
   std::string GetSubImageTitle(u32 index) const override;
 
   PrecacheResult Precache(ProgressCallback* progress, Error* error) override;
+  void SetDecompressionCacheSize(u32 size) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
@@ -467,6 +468,11 @@ CDImage::PrecacheResult CDImagePPF::Precache(ProgressCallback* progress, Error*
   return m_parent_image->Precache(progress, error);
 }
 
+void CDImagePPF::SetDecompressionCacheSize(u32 size)
+{
+  m_parent_image->SetDecompressionCacheSize(size);
+}
+
 bool CDImagePPF::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
 {
   DebugAssert(index.file_index == 0);
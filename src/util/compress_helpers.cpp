@@ -22,6 +22,10 @@
 #include <zstd.h>
 #include <zstd_errors.h>
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 LOG_CHANNEL(CompressHelpers);
 
 // TODO: Use streaming API to avoid mallocing the whole input buffer. But one read() call is probably still faster..
@@ -33,8 +37,26 @@ static const char* ZlibErrorToString(int res);
 static std::optional<size_t> GetDeflateDecompressedSize(std::span<const u8> data, Error* error);
 static bool DecompressDeflate(std::span<u8> dst, size_t uncompressed_size, std::span<const u8> data, Error* error);
 
+namespace {
+struct ZstdFrame
+{
+  std::span<const u8> data;
+  size_t decompressed_offset;
+  size_t decompressed_size;
+};
+} // namespace
+
+static constexpr size_t ZSTD_MT_CHUNK_SIZE = 1024 * 1024;
+static constexpr u32 MAX_WORKER_THREADS = 8;
+
+static u32 GetWorkerThreadCount(size_t num_items);
+template<typename T>
+static void ParallelFor(size_t num_items, const T& func);
+
+static bool GetZstdFrames(std::span<const u8> data, std::vector<ZstdFrame>* frames, Error* error);
 static std::optional<size_t> GetZstdDecompressedSize(std::span<const u8> data, Error* error);
 static bool DecompressZstd(std::span<u8> dst, size_t uncompressed_size, std::span<const u8> data, Error* error);
+static int GetZstdCompressionLevel(int clevel);
 
 template<typename T>
 static bool DecompressHelper(ByteBuffer& ret, CompressType type, T data, std::optional<size_t> decompressed_size,
@@ -128,17 +150,84 @@ bool CompressHelpers::DecompressDeflate(std::span<u8> dst, size_t uncompressed_s
   return true;
 }
 
-std::optional<size_t> CompressHelpers::GetZstdDecompressedSize(std::span<const u8> data, Error* error)
+u32 CompressHelpers::GetWorkerThreadCount(size_t num_items)
 {
-  const unsigned long long runtime_decompressed_size = ZSTD_getFrameContentSize(data.data(), data.size());
-  if (runtime_decompressed_size == ZSTD_CONTENTSIZE_UNKNOWN || runtime_decompressed_size == ZSTD_CONTENTSIZE_ERROR ||
-      runtime_decompressed_size >= std::numeric_limits<size_t>::max()) [[unlikely]]
+  const u32 num_threads = std::clamp(std::thread::hardware_concurrency(), 1u, MAX_WORKER_THREADS);
+  return static_cast<u32>(std::min<size_t>(num_threads, num_items));
+}
+
+template<typename T>
+void CompressHelpers::ParallelFor(size_t num_items, const T& func)
+{
+  std::atomic<size_t> next_item{0};
+  const auto worker = [&next_item, num_items, &func]() {
+    for (size_t i = next_item.fetch_add(1, std::memory_order_relaxed); i < num_items;
+         i = next_item.fetch_add(1, std::memory_order_relaxed))
+    {
+      func(i);
+    }
+  };
+
+  // Calling thread does its share too.
+  std::vector<std::thread> threads;
+  const u32 num_threads = GetWorkerThreadCount(num_items);
+  for (u32 i = 1; i < num_threads; i++)
+    threads.emplace_back(worker);
+  worker();
+  for (std::thread& thread : threads)
+    thread.join();
+}
+
+bool CompressHelpers::GetZstdFrames(std::span<const u8> data, std::vector<ZstdFrame>* frames, Error* error)
+{
+  size_t offset = 0;
+  size_t decompressed_offset = 0;
+  while (offset < data.size())
+  {
+    const std::span<const u8> remaining = data.subspan(offset);
+    const size_t frame_size = ZSTD_findFrameCompressedSize(remaining.data(), remaining.size());
+    const unsigned long long frame_decompressed_size = ZSTD_getFrameContentSize(remaining.data(), remaining.size());
+    if (ZSTD_isError(frame_size) || frame_decompressed_size == ZSTD_CONTENTSIZE_UNKNOWN ||
+        frame_decompressed_size == ZSTD_CONTENTSIZE_ERROR ||
+        frame_decompressed_size >= std::numeric_limits<size_t>::max()) [[unlikely]]
+    {
+      Error::SetStringFmt(error, "Failed to get uncompressed size of frame at offset {}.", offset);
+      return false;
+    }
+
+    if (frames)
+      frames->push_back(ZstdFrame{remaining.subspan(0, frame_size), decompressed_offset, frame_decompressed_size});
+
+    offset += frame_size;
+    decompressed_offset += static_cast<size_t>(frame_decompressed_size);
+  }
+
+  if (decompressed_offset == 0) [[unlikely]]
   {
     Error::SetStringView(error, "Failed to get uncompressed size.");
     return false;
   }
 
-  return static_cast<size_t>(runtime_decompressed_size);
+  return true;
+}
+
+std::optional<size_t> CompressHelpers::GetZstdDecompressedSize(std::span<const u8> data, Error* error)
+{
+  // Usually a single frame, but the multithreaded compressor writes one per chunk.
+  const unsigned long long runtime_decompressed_size = ZSTD_getFrameContentSize(data.data(), data.size());
+  const size_t frame_size = ZSTD_findFrameCompressedSize(data.data(), data.size());
+  if (!ZSTD_isError(frame_size) && frame_size == data.size() && runtime_decompressed_size != ZSTD_CONTENTSIZE_UNKNOWN &&
+      runtime_decompressed_size != ZSTD_CONTENTSIZE_ERROR &&
+      runtime_decompressed_size < std::numeric_limits<size_t>::max())
+  {
+    return static_cast<size_t>(runtime_decompressed_size);
+  }
+
+  std::vector<ZstdFrame> frames;
+  if (!GetZstdFrames(data, &frames, error))
+    return std::nullopt;
+
+  return frames.back().decompressed_offset + frames.back().decompressed_size;
 }
 
 bool CompressHelpers::DecompressZstd(std::span<u8> dst, size_t uncompressed_size, std::span<const u8> data,
@@ -150,6 +239,37 @@ bool CompressHelpers::DecompressZstd(std::span<u8> dst, size_t uncompressed_size
     return false;
   }
 
+  // Independent frames can be decompressed in parallel. Anything odd goes through the single-threaded path below.
+  std::vector<ZstdFrame> frames;
+  if (uncompressed_size > ZSTD_MT_CHUNK_SIZE && GetZstdFrames(data, &frames, nullptr) && frames.size() > 1 &&
+      (frames.back().decompressed_offset + frames.back().decompressed_size) == uncompressed_size)
+  {
+    std::vector<size_t> results(frames.size());
+    ParallelFor(frames.size(), [&frames, &results, dst](size_t i) {
+      const ZstdFrame& frame = frames[i];
+      results[i] = ZSTD_decompress(dst.data() + frame.decompressed_offset, frame.decompressed_size, frame.data.data(),
+                                   frame.data.size());
+    });
+
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+      if (ZSTD_isError(results[i])) [[unlikely]]
+      {
+        const char* errstr = ZSTD_getErrorString(ZSTD_getErrorCode(results[i]));
+        Error::SetStringFmt(error, "ZSTD_decompress() failed for frame {}: {}", i, errstr ? errstr : "<unknown>");
+        return false;
+      }
+      else if (results[i] != frames[i].decompressed_size) [[unlikely]]
+      {
+        Error::SetStringFmt(error, "ZSTD_decompress() only returned {} of {} bytes for frame {}.", results[i],
+                            frames[i].decompressed_size, i);
+        return false;
+      }
+    }
+
+    return true;
+  }
+
   const size_t result = ZSTD_decompress(dst.data(), dst.size(), data.data(), data.size());
   if (ZSTD_isError(result)) [[unlikely]]
   {
@@ -664,8 +784,8 @@ bool CompressHelpers::CompressHelper(ByteBuffer& ret, CompressType type, T data,
 
       ret.resize(compressed_size);
 
-      const size_t result = ZSTD_compress(ret.data(), compressed_size, data.data(), data.size(),
-                                          (clevel < 0) ? 0 : std::clamp(clevel, 1, 22));
+      const size_t result =
+        ZSTD_compress(ret.data(), compressed_size, data.data(), data.size(), GetZstdCompressionLevel(clevel));
       if (ZSTD_isError(result)) [[unlikely]]
       {
         const char* errstr = ZSTD_getErrorString(ZSTD_getErrorCode(result));
@@ -799,6 +919,55 @@ bool CompressHelpers::CompressToBuffer(ByteBuffer& dst, CompressType type, std::
   return CompressHelper(dst, type, data, clevel, error);
 }
 
+int CompressHelpers::GetZstdCompressionLevel(int clevel)
+{
+  return (clevel < 0) ? 0 : std::clamp(clevel, 1, 22);
+}
+
+CompressHelpers::OptionalByteBuffer CompressHelpers::CompressToBufferMultithreaded(CompressType type,
+                                                                                   std::span<const u8> data,
+                                                                                   int clevel, Error* error)
+{
+  const size_t num_chunks = (data.size() + ZSTD_MT_CHUNK_SIZE - 1) / ZSTD_MT_CHUNK_SIZE;
+  if (type != CompressType::Zstandard || num_chunks <= 1 || GetWorkerThreadCount(num_chunks) <= 1)
+    return CompressToBuffer(type, data, clevel, error);
+
+  // Each chunk gets its own frame, written to a separate buffer and joined afterwards.
+  const int zstd_level = GetZstdCompressionLevel(clevel);
+  const size_t chunk_bound = ZSTD_compressBound(ZSTD_MT_CHUNK_SIZE);
+  ByteBuffer chunk_buffers(chunk_bound * num_chunks);
+  std::vector<size_t> results(num_chunks);
+  ParallelFor(num_chunks, [&data, &chunk_buffers, &results, chunk_bound, zstd_level](size_t i) {
+    const std::span<const u8> chunk =
+      data.subspan(i * ZSTD_MT_CHUNK_SIZE, std::min(ZSTD_MT_CHUNK_SIZE, data.size() - (i * ZSTD_MT_CHUNK_SIZE)));
+    results[i] = ZSTD_compress(chunk_buffers.data() + (i * chunk_bound), chunk_bound, chunk.data(), chunk.size(),
+                               zstd_level);
+  });
+
+  size_t total_size = 0;
+  for (const size_t result : results)
+  {
+    if (ZSTD_isError(result)) [[unlikely]]
+    {
+      const char* errstr = ZSTD_getErrorString(ZSTD_getErrorCode(result));
+      Error::SetStringFmt(error, "ZSTD_compress() failed: {}", errstr ? errstr : "<unknown>");
+      return std::nullopt;
+    }
+
+    total_size += result;
+  }
+
+  OptionalByteBuffer ret = ByteBuffer(total_size);
+  size_t offset = 0;
+  for (size_t i = 0; i < num_chunks; i++)
+  {
+    std::memcpy(ret->data() + offset, chunk_buffers.data() + (i * chunk_bound), results[i]);
+    offset += results[i];
+  }
+
+  return ret;
+}
+
 bool CompressHelpers::CompressToBuffer(ByteBuffer& dst, CompressType type, ByteBuffer data, int clevel /*= -1*/,
                                        Error* error /*= nullptr*/)
 {
@@ -4,9 +4,11 @@
 #pragma once
 
 #include "common/heap_array.h"
+#include "common/types.h"
 
 #include <optional>
 #include <span>
+#include <string_view>
 
 class Error;
 
@@ -50,6 +52,13 @@ OptionalByteBuffer CompressToBuffer(CompressType type, OptionalByteBuffer data,
 bool CompressToBuffer(ByteBuffer& dst, CompressType type, std::span<const u8> data, int clevel = -1,
                       Error* error = nullptr);
 bool CompressToBuffer(ByteBuffer& dst, CompressType type, ByteBuffer data, int clevel = -1, Error* error = nullptr);
+
+/// Compresses the data as independent chunks across multiple threads. Only Zstandard supports this, other types are
+/// compressed on the calling thread. The result is a sequence of regular frames, so any of the decompress functions can
+/// read it, and will decompress the frames in parallel.
+OptionalByteBuffer CompressToBufferMultithreaded(CompressType type, std::span<const u8> data, int clevel = -1,
+                                                 Error* error = nullptr);
+
 bool CompressToFile(const char* path, std::span<const u8> data, int clevel = -1, bool atomic_write = true,
                     Error* error = nullptr);
 bool CompressToFile(CompressType type, const char* path, std::span<const u8> data, int clevel = -1,
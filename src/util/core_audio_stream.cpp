@@ -7,6 +7,7 @@
 #include "common/align.h"
 #include "common/assert.h"
 #include "common/error.h"
+#include "common/event_trace.h"
 #include "common/gsvector.h"
 #include "common/log.h"
 #include "common/settings_interface.h"
@@ -24,6 +25,16 @@ LOG_CHANNEL(AudioStream);
 
 static constexpr bool LOG_TIMESTRETCH_STATS = false;
 
+// Low latency mode nudges the playback rate by at most this much, which isn't audible as a pitch change. Speeds
+// further from 100% than this go through the stretcher instead.
+static constexpr float LOW_LATENCY_MAX_DRIFT = 0.005f;
+
+// How strongly the rate reacts to the buffer being away from the target, as a fraction of the target.
+static constexpr float LOW_LATENCY_RATE_GAIN = 0.005f;
+
+// Extra buffering added after an underrun is given back one chunk at a time after this long without another.
+static constexpr float LOW_LATENCY_MARGIN_DECAY_SECONDS = 5.0f;
+
 void AudioStreamParameters::Load(const SettingsInterface& si, const char* section)
 {
   stretch_mode =
@@ -33,6 +44,7 @@ void AudioStreamParameters::Load(const SettingsInterface& si, const char* sectio
   output_latency_ms = static_cast<u16>(std::min<u32>(
     si.GetUIntValue(section, "OutputLatencyMS", DEFAULT_OUTPUT_LATENCY_MS), std::numeric_limits<u16>::max()));
   output_latency_minimal = si.GetBoolValue(section, "OutputLatencyMinimal", DEFAULT_OUTPUT_LATENCY_MINIMAL);
+  low_latency = si.GetBoolValue(section, "LowLatency", DEFAULT_LOW_LATENCY);
   buffer_ms = static_cast<u16>(
     std::min<u32>(si.GetUIntValue(section, "BufferMS", DEFAULT_BUFFER_MS), std::numeric_limits<u16>::max()));
 
@@ -45,6 +57,8 @@ void AudioStreamParameters::Load(const SettingsInterface& si, const char* sectio
     si.GetUIntValue(section, "StretchOverlapMS", DEFAULT_STRETCH_OVERLAP), std::numeric_limits<u16>::max()));
   stretch_use_quickseek = si.GetBoolValue(section, "StretchUseQuickSeek", DEFAULT_STRETCH_USE_QUICKSEEK);
   stretch_use_aa_filter = si.GetBoolValue(section, "StretchUseAAFilter", DEFAULT_STRETCH_USE_AA_FILTER);
+
+  output_sample_rate = si.GetUIntValue(section, "OutputSampleRate", DEFAULT_OUTPUT_SAMPLE_RATE);
 }
 
 void AudioStreamParameters::Save(SettingsInterface& si, const char* section) const
@@ -53,12 +67,15 @@ void AudioStreamParameters::Save(SettingsInterface& si, const char* section) con
   si.SetUIntValue(section, "BufferMS", buffer_ms);
   si.SetUIntValue(section, "OutputLatencyMS", output_latency_ms);
   si.SetBoolValue(section, "OutputLatencyMinimal", output_latency_minimal);
+  si.SetBoolValue(section, "LowLatency", low_latency);
 
   si.SetUIntValue(section, "StretchSequenceLengthMS", stretch_sequence_length_ms);
   si.SetUIntValue(section, "StretchSeekWindowMS", stretch_seekwindow_ms);
   si.SetUIntValue(section, "StretchOverlapMS", stretch_overlap_ms);
   si.SetBoolValue(section, "StretchUseQuickSeek", stretch_use_quickseek);
   si.SetBoolValue(section, "StretchUseAAFilter", stretch_use_aa_filter);
+
+  si.SetUIntValue(section, "OutputSampleRate", output_sample_rate);
 }
 
 void AudioStreamParameters::Clear(SettingsInterface& si, const char* section)
@@ -68,12 +85,15 @@ void AudioStreamParameters::Clear(SettingsInterface& si, const char* section)
   si.DeleteValue(section, "BufferMS");
   si.DeleteValue(section, "OutputLatencyMS");
   si.DeleteValue(section, "OutputLatencyMinimal");
+  si.DeleteValue(section, "LowLatency");
 
   si.DeleteValue(section, "StretchSequenceLengthMS");
   si.DeleteValue(section, "StretchSeekWindowMS");
   si.DeleteValue(section, "StretchOverlapMS");
   si.DeleteValue(section, "StretchUseQuickSeek");
   si.DeleteValue(section, "StretchUseAAFilter");
+
+  si.DeleteValue(section, "OutputSampleRate");
 }
 
 bool AudioStreamParameters::operator!=(const AudioStreamParameters& rhs) const
@@ -100,6 +120,7 @@ bool CoreAudioStream::Initialize(AudioBackend backend, u32 sample_rate, const Au
   Destroy();
 
   m_sample_rate = sample_rate;
+  m_output_sample_rate = sample_rate;
   m_volume = 100;
   m_parameters = params;
   m_filling = false;
@@ -108,13 +129,32 @@ bool CoreAudioStream::Initialize(AudioBackend backend, u32 sample_rate, const Au
   AllocateBuffer();
   StretchAllocate();
 
-  const u32 output_latency_frames =
-    GetBufferSizeForMS(sample_rate, (params.output_latency_ms != 0) ? params.output_latency_ms : params.buffer_ms);
   if (backend != AudioBackend::Null)
   {
-    if (!(m_stream =
-            AudioStream::CreateStream(backend, sample_rate, NUM_CHANNELS, output_latency_frames,
-                                      params.output_latency_minimal, driver_name, device_name, this, true, error)))
+    // convert to the requested rate ourselves, rather than relying on the backend or the device to do it
+    if (params.output_sample_rate != 0 && params.output_sample_rate != sample_rate)
+    {
+      if (m_output_resampler.Init(sample_rate, params.output_sample_rate))
+      {
+        m_output_sample_rate = params.output_sample_rate;
+        m_output_resampler_buffer = Common::make_unique_aligned_for_overwrite<s16[]>(
+          VECTOR_ALIGNMENT, m_output_resampler.GetMaxInputFrames() * NUM_CHANNELS);
+        INFO_LOG("Resampling audio output from {}hz to {}hz.", sample_rate, m_output_sample_rate);
+      }
+      else
+      {
+        WARNING_LOG("Output sample rate of {}hz is not supported, using {}hz.", params.output_sample_rate,
+                    sample_rate);
+      }
+    }
+
+    const u32 output_latency_frames = GetBufferSizeForMS(
+      m_output_sample_rate, (params.output_latency_ms != 0) ? params.output_latency_ms : params.buffer_ms);
+
+    // low latency mode wants small callbacks, since the buffer target follows them
+    const bool output_latency_minimal = (params.output_latency_minimal || params.low_latency);
+    if (!(m_stream = AudioStream::CreateStream(backend, m_output_sample_rate, NUM_CHANNELS, output_latency_frames,
+                                               output_latency_minimal, driver_name, device_name, this, true, error)))
     {
       Destroy();
       return false;
@@ -198,7 +238,10 @@ void CoreAudioStream::Destroy()
   m_stream.reset();
   StretchDestroy();
   DestroyBuffer();
+  m_output_resampler.Destroy();
+  m_output_resampler_buffer.reset();
   m_sample_rate = 0;
+  m_output_sample_rate = 0;
   m_parameters = AudioStreamParameters();
   m_volume = 0;
   m_filling = false;
@@ -260,20 +303,114 @@ std::optional<AudioStretchMode> CoreAudioStream::ParseStretchMode(const char* na
 
 u32 CoreAudioStream::GetBufferedFramesRelaxed() const
 {
-  const u32 rpos = m_rpos.load(std::memory_order_relaxed);
-  const u32 wpos = m_wpos.load(std::memory_order_relaxed);
-  return (wpos + m_buffer_size - rpos) % m_buffer_size;
+  return m_buffer.GetBufferedFramesRelaxed();
+}
+
+CoreAudioStream::Statistics CoreAudioStream::GetAndResetStatistics()
+{
+  const u32 underrun_count = m_underrun_count.load(std::memory_order_relaxed);
+
+  Statistics ret;
+  ret.underrun_count = underrun_count - std::exchange(m_statistics_last_underrun_count, underrun_count);
+  ret.overrun_count = std::exchange(m_overrun_count, 0);
+  ret.buffered_frames = m_buffer.IsAllocated() ? m_buffer.GetBufferedFramesRelaxed() : 0;
+  ret.target_frames = m_target_buffer_size;
+  return ret;
 }
 
 void CoreAudioStream::ReadFrames(SampleType* samples, u32 num_frames)
 {
-  const u32 available_frames = GetBufferedFramesRelaxed();
+  // The callback runs on a thread owned by the backend, so it can only be named from here.
+  if (EventTrace::IsRecording())
+  {
+    EventTrace::SetThreadName("Audio");
+    EventTrace::Counter("Buffered Audio Frames", m_buffer.GetBufferedFramesRelaxed());
+  }
+  EventTrace::ScopedSpan span("Audio Mix");
+
+  if (m_parameters.low_latency)
+  {
+    // Track the largest recent request. It decays slowly, so an occasional large callback doesn't stick forever.
+    // The buffer target is in input frames, so scale the request when resampling to the device rate.
+    const u32 input_frames =
+      m_output_resampler.IsActive() ?
+        static_cast<u32>((static_cast<u64>(num_frames) * m_sample_rate + (m_output_sample_rate - 1)) /
+                         m_output_sample_rate) :
+        num_frames;
+    const u32 callback_frames = m_callback_frames.load(std::memory_order_relaxed);
+    m_callback_frames.store(std::max(input_frames, callback_frames - (callback_frames / 256)),
+                            std::memory_order_relaxed);
+  }
+
+  if (m_output_resampler.IsActive())
+  {
+    // Fixed size blocks keep the staging buffer small, and the cost per output frame constant.
+    SampleType* out_ptr = samples;
+    for (u32 remaining = num_frames; remaining > 0;)
+    {
+      const u32 out_frames = std::min(remaining, PolyphaseResampler::MAX_OUTPUT_FRAMES);
+      const u32 in_frames = m_output_resampler.GetInputFramesForOutput(out_frames);
+      if (in_frames > 0)
+        ReadInputFrames(m_output_resampler_buffer.get(), in_frames);
+
+      m_output_resampler.Process(m_output_resampler_buffer.get(), in_frames, out_ptr, out_frames);
+      out_ptr += out_frames * NUM_CHANNELS;
+      remaining -= out_frames;
+    }
+  }
+  else
+  {
+    ReadInputFrames(samples, num_frames);
+  }
+
+  if (m_volume != 100)
+  {
+    u32 num_samples = num_frames * NUM_CHANNELS;
+
+    const u32 aligned_samples = Common::AlignDownPow2(num_samples, 8);
+    num_samples -= aligned_samples;
+
+    const float volume_mult = static_cast<float>(m_volume) / 100.0f;
+    const GSVector4 volume_multv = GSVector4(volume_mult);
+    const SampleType* const aligned_samples_end = samples + aligned_samples;
+    for (; samples != aligned_samples_end; samples += 8)
+    {
+      GSVector4i iv = GSVector4i::load<false>(samples); // [0, 1, 2, 3, 4, 5, 6, 7]
+      GSVector4i iv1 = iv.upl16(iv);                    // [0, 0, 1, 1, 2, 2, 3, 3]
+      GSVector4i iv2 = iv.uph16(iv);                    // [4, 4, 5, 5, 6, 6, 7, 7]
+      iv1 = iv1.sra32<16>();                            // [0, 1, 2, 3]
+      iv2 = iv2.sra32<16>();                            // [4, 5, 6, 7]
+      GSVector4 fv1 = GSVector4(iv1);                   // [f0, f1, f2, f3]
+      GSVector4 fv2 = GSVector4(iv2);                   // [f4, f5, f6, f7]
+      fv1 = fv1 * volume_multv;                         // [f0, f1, f2, f3]
+      fv2 = fv2 * volume_multv;                         // [f4, f5, f6, f7]
+      iv1 = GSVector4i(fv1);                            // [0, 1, 2, 3]
+      iv2 = GSVector4i(fv2);                            // [4, 5, 6, 7]
+      iv = iv1.ps32(iv2);                               // [0, 1, 2, 3, 4, 5, 6, 7]
+      GSVector4i::store<false>(samples, iv);
+    }
+
+    while (num_samples > 0)
+    {
+      *samples = static_cast<s16>(std::clamp(static_cast<float>(*samples) * volume_mult, -32768.0f, 32767.0f));
+      samples++;
+      num_samples--;
+    }
+  }
+}
+
+void CoreAudioStream::ReadInputFrames(SampleType* samples, u32 num_frames)
+{
+  const u32 available_frames = m_buffer.GetReadableFrames();
   u32 frames_to_read = num_frames;
   u32 silence_frames = 0;
 
   if (m_filling)
   {
-    u32 toFill = m_buffer_size / ((m_parameters.stretch_mode != AudioStretchMode::TimeStretch) ? 32 : 400);
+    // Low latency mode only needs enough to satisfy one callback before resuming.
+    u32 toFill = m_parameters.low_latency ?
+                   num_frames :
+                   (m_buffer_size / ((m_parameters.stretch_mode != AudioStretchMode::TimeStretch) ? 32 : 400));
     toFill = GetAlignedBufferSize(toFill);
 
     if (available_frames < toFill)
@@ -293,37 +430,14 @@ void CoreAudioStream::ReadFrames(SampleType* samples, u32 num_frames)
     silence_frames = frames_to_read - available_frames;
     frames_to_read = available_frames;
     m_filling = true;
+    m_underrun_count.fetch_add(1, std::memory_order_relaxed);
 
     if (m_parameters.stretch_mode == AudioStretchMode::TimeStretch)
       StretchUnderrun();
   }
 
   if (frames_to_read > 0)
-  {
-    u32 rpos = m_rpos.load(std::memory_order_acquire);
-
-    u32 end = m_buffer_size - rpos;
-    if (end > frames_to_read)
-      end = frames_to_read;
-
-    // towards the end of the buffer
-    if (end > 0)
-    {
-      std::memcpy(samples, &m_buffer[rpos * NUM_CHANNELS], end * NUM_CHANNELS * sizeof(SampleType));
-      rpos += end;
-      rpos = (rpos == m_buffer_size) ? 0 : rpos;
-    }
-
-    // after wrapping around
-    const u32 start = frames_to_read - end;
-    if (start > 0)
-    {
-      std::memcpy(&samples[end * NUM_CHANNELS], &m_buffer[0], start * NUM_CHANNELS * sizeof(SampleType));
-      rpos = start;
-    }
-
-    m_rpos.store(rpos, std::memory_order_release);
-  }
+    m_buffer.Read(samples, frames_to_read);
 
   if (silence_frames > 0)
   {
@@ -358,83 +472,23 @@ void CoreAudioStream::ReadFrames(SampleType* samples, u32 num_frames)
       std::memset(samples + (frames_to_read * NUM_CHANNELS), 0, silence_frames * NUM_CHANNELS * sizeof(s16));
     }
   }
-
-  if (m_volume != 100)
-  {
-    u32 num_samples = num_frames * NUM_CHANNELS;
-
-    const u32 aligned_samples = Common::AlignDownPow2(num_samples, 8);
-    num_samples -= aligned_samples;
-
-    const float volume_mult = static_cast<float>(m_volume) / 100.0f;
-    const GSVector4 volume_multv = GSVector4(volume_mult);
-    const SampleType* const aligned_samples_end = samples + aligned_samples;
-    for (; samples != aligned_samples_end; samples += 8)
-    {
-      GSVector4i iv = GSVector4i::load<false>(samples); // [0, 1, 2, 3, 4, 5, 6, 7]
-      GSVector4i iv1 = iv.upl16(iv);                    // [0, 0, 1, 1, 2, 2, 3, 3]
-      GSVector4i iv2 = iv.uph16(iv);                    // [4, 4, 5, 5, 6, 6, 7, 7]
-      iv1 = iv1.sra32<16>();                            // [0, 1, 2, 3]
-      iv2 = iv2.sra32<16>();                            // [4, 5, 6, 7]
-      GSVector4 fv1 = GSVector4(iv1);                   // [f0, f1, f2, f3]
-      GSVector4 fv2 = GSVector4(iv2);                   // [f4, f5, f6, f7]
-      fv1 = fv1 * volume_multv;                         // [f0, f1, f2, f3]
-      fv2 = fv2 * volume_multv;                         // [f4, f5, f6, f7]
-      iv1 = GSVector4i(fv1);                            // [0, 1, 2, 3]
-      iv2 = GSVector4i(fv2);                            // [4, 5, 6, 7]
-      iv = iv1.ps32(iv2);                               // [0, 1, 2, 3, 4, 5, 6, 7]
-      GSVector4i::store<false>(samples, iv);
-    }
-
-    while (num_samples > 0)
-    {
-      *samples = static_cast<s16>(std::clamp(static_cast<float>(*samples) * volume_mult, -32768.0f, 32767.0f));
-      samples++;
-      num_samples--;
-    }
-  }
 }
 
 void CoreAudioStream::InternalWriteFrames(s16* data, u32 num_frames)
 {
-  const u32 free = m_buffer_size - GetBufferedFramesRelaxed();
-  if (free <= num_frames)
+  if (m_buffer.GetWritableFrames() < num_frames)
   {
+    // The consumer owns the read position, so a time stretch overrun can only ask it to skip ahead. This chunk
+    // doesn't fit either way.
+    m_overrun_count++;
     if (m_parameters.stretch_mode == AudioStretchMode::TimeStretch)
-    {
       StretchOverrun();
-    }
-    else
-    {
-      DEBUG_LOG("Buffer overrun, chunk dropped");
-      return;
-    }
-  }
-
-  u32 wpos = m_wpos.load(std::memory_order_acquire);
-
-  // wrapping around the end of the buffer?
-  if ((m_buffer_size - wpos) <= num_frames)
-  {
-    // needs to be written in two parts
-    const u32 end = m_buffer_size - wpos;
-    const u32 start = num_frames - end;
 
-    // start is zero when this chunk reaches exactly the end
-    std::memcpy(&m_buffer[wpos * NUM_CHANNELS], data, end * NUM_CHANNELS * sizeof(SampleType));
-    if (start > 0)
-      std::memcpy(&m_buffer[0], data + end * NUM_CHANNELS, start * NUM_CHANNELS * sizeof(SampleType));
-
-    wpos = start;
-  }
-  else
-  {
-    // no split
-    std::memcpy(&m_buffer[wpos * NUM_CHANNELS], data, num_frames * NUM_CHANNELS * sizeof(SampleType));
-    wpos += num_frames;
+    DEBUG_LOG("Buffer overrun, chunk dropped");
+    return;
   }
 
-  m_wpos.store(wpos, std::memory_order_release);
+  m_buffer.Write(data, num_frames);
 }
 
 void CoreAudioStream::AllocateBuffer()
@@ -447,9 +501,19 @@ void CoreAudioStream::AllocateBuffer()
   m_buffer_size = GetAlignedBufferSize(((m_parameters.buffer_ms * multiplier) * m_sample_rate) / 1000);
   m_target_buffer_size = GetAlignedBufferSize((m_sample_rate * m_parameters.buffer_ms) / 1000u);
 
-  m_buffer = Common::make_unique_aligned_for_overwrite<s16[]>(VECTOR_ALIGNMENT, m_buffer_size * NUM_CHANNELS);
+  m_buffer.Allocate(m_buffer_size, NUM_CHANNELS);
   m_staging_buffer = Common::make_unique_aligned_for_overwrite<s16[]>(VECTOR_ALIGNMENT, CHUNK_SIZE * NUM_CHANNELS);
   m_float_buffer = Common::make_unique_aligned_for_overwrite<float[]>(VECTOR_ALIGNMENT, CHUNK_SIZE * NUM_CHANNELS);
+  m_resample_buffer =
+    Common::make_unique_aligned_for_overwrite<s16[]>(VECTOR_ALIGNMENT, CHUNK_SIZE * 2 * NUM_CHANNELS);
+
+  m_callback_frames.store(0, std::memory_order_relaxed);
+  m_resample_position = 0;
+  m_resample_last_frame = {};
+  m_low_latency_margin = 0;
+  m_low_latency_last_underrun_count = m_underrun_count.load(std::memory_order_relaxed);
+  m_low_latency_margin_time = Timer::GetCurrentValue();
+  m_low_latency_stretching = false;
 
   DEV_LOG("Allocated buffer of {} frames for buffer of {} ms [stretch {}, target size {}].", m_buffer_size,
           m_parameters.buffer_ms, GetStretchModeName(m_parameters.stretch_mode), m_target_buffer_size);
@@ -459,10 +523,9 @@ void CoreAudioStream::DestroyBuffer()
 {
   m_staging_buffer.reset();
   m_float_buffer.reset();
-  m_buffer.reset();
+  m_resample_buffer.reset();
+  m_buffer.Destroy();
   m_buffer_size = 0;
-  m_wpos.store(0, std::memory_order_release);
-  m_rpos.store(0, std::memory_order_release);
 }
 
 void CoreAudioStream::EmptyBuffer()
@@ -474,7 +537,7 @@ void CoreAudioStream::EmptyBuffer()
       soundtouch_setTempo(m_soundtouch, m_nominal_rate);
   }
 
-  m_wpos.store(m_rpos.load(std::memory_order_acquire), std::memory_order_release);
+  m_buffer.RequestDiscard(m_buffer.GetBufferedFramesRelaxed());
 }
 
 void CoreAudioStream::SetNominalRate(float tempo)
@@ -593,6 +656,24 @@ void CoreAudioStream::EndWrite(u32 num_frames)
 
   m_staging_buffer_pos = 0;
 
+  if (m_parameters.low_latency)
+  {
+    const bool stretch = UseLowLatencyStretch();
+    if (stretch != m_low_latency_stretching)
+    {
+      // Anything left in the stretcher from the last time it was used is stale.
+      m_low_latency_stretching = stretch;
+      if (stretch)
+        EmptyStretchBuffers();
+    }
+
+    if (!stretch)
+    {
+      LowLatencyWriteChunk(m_staging_buffer.get());
+      return;
+    }
+  }
+
   if (!IsStretchEnabled())
   {
     InternalWriteFrames(m_staging_buffer.get(), CHUNK_SIZE);
@@ -603,6 +684,84 @@ void CoreAudioStream::EndWrite(u32 num_frames)
   StretchWriteBlock(m_float_buffer.get());
 }
 
+bool CoreAudioStream::UseLowLatencyStretch() const
+{
+  return (IsStretchEnabled() && std::abs(m_nominal_rate - 1.0f) > LOW_LATENCY_MAX_DRIFT);
+}
+
+u32 CoreAudioStream::GetLowLatencyTargetSize()
+{
+  // Back off after underruns, and slowly give the extra buffering back once things are stable again.
+  const u32 underrun_count = m_underrun_count.load(std::memory_order_relaxed);
+  const u64 now = Timer::GetCurrentValue();
+  if (underrun_count != m_low_latency_last_underrun_count)
+  {
+    m_low_latency_last_underrun_count = underrun_count;
+    m_low_latency_margin = std::min(m_low_latency_margin + CHUNK_SIZE, m_target_buffer_size);
+    m_low_latency_margin_time = now;
+    VERBOSE_LOG("Low latency underrun, margin increased to {} frames", m_low_latency_margin);
+  }
+  else if (m_low_latency_margin > 0 &&
+           Timer::ConvertValueToSeconds(now - m_low_latency_margin_time) >= LOW_LATENCY_MARGIN_DECAY_SECONDS)
+  {
+    m_low_latency_margin -= CHUNK_SIZE;
+    m_low_latency_margin_time = now;
+  }
+
+  // Enough for the largest callback the backend has made recently, plus the chunk we're about to write. The buffer
+  // size setting is the upper limit.
+  const u32 callback_frames = m_callback_frames.load(std::memory_order_relaxed);
+  return std::min(GetAlignedBufferSize(callback_frames + CHUNK_SIZE + m_low_latency_margin), m_target_buffer_size);
+}
+
+void CoreAudioStream::LowLatencyWriteChunk(const SampleType* samples)
+{
+  const u32 target_size = GetLowLatencyTargetSize();
+  const u32 buffered = GetBufferedFramesRelaxed();
+
+  // Too far ahead for rate control to catch up in a reasonable time, e.g. after the host stalled.
+  if (buffered > (target_size * 3))
+  {
+    DEBUG_LOG("Low latency buffer at {} frames with target {}, chunk dropped", buffered, target_size);
+    return;
+  }
+
+  // Consume input slightly faster when the buffer is above the target, and slower when it's below.
+  const float error =
+    (static_cast<float>(buffered) - static_cast<float>(target_size)) / static_cast<float>(target_size);
+  const float ratio = 1.0f + std::clamp(error * LOW_LATENCY_RATE_GAIN, -LOW_LATENCY_MAX_DRIFT, LOW_LATENCY_MAX_DRIFT);
+  const u32 step = static_cast<u32>(ratio * 65536.0f);
+
+  // Linear interpolation is plenty for a rate this close to 1:1, and doesn't add any latency.
+  SampleType* out = m_resample_buffer.get();
+  u32 out_frames = 0;
+  u32 pos = m_resample_position;
+  while ((pos >> 16) < CHUNK_SIZE)
+  {
+    const u32 index = pos >> 16;
+    const s32 frac = static_cast<s32>((pos & 0xFFFFu) >> 1);
+    const SampleType* const frame_a =
+      (index == 0) ? m_resample_last_frame.data() : &samples[(index - 1) * NUM_CHANNELS];
+    const SampleType* const frame_b = &samples[index * NUM_CHANNELS];
+    for (u32 i = 0; i < NUM_CHANNELS; i++)
+    {
+      out[i] = static_cast<SampleType>(
+        frame_a[i] + (((static_cast<s32>(frame_b[i]) - static_cast<s32>(frame_a[i])) * frac) >> 15));
+    }
+
+    out += NUM_CHANNELS;
+    out_frames++;
+    pos += step;
+  }
+
+  m_resample_position = pos - (CHUNK_SIZE << 16);
+  std::memcpy(m_resample_last_frame.data(), &samples[(CHUNK_SIZE - 1) * NUM_CHANNELS],
+              sizeof(SampleType) * NUM_CHANNELS);
+
+  DebugAssert(out_frames <= (CHUNK_SIZE * 2));
+  InternalWriteFrames(m_resample_buffer.get(), out_frames);
+}
+
 // Time stretching algorithm based on PCSX2 implementation.
 
 template<class T>
@@ -910,8 +1069,7 @@ void CoreAudioStream::StretchOverrun()
 
   // Drop two packets to give the time stretcher a bit more time to slow things down.
   // This prevents a cascading overrun situation where each overrun makes the next one more likely.
-  const u32 discard = CHUNK_SIZE * 2;
-  m_rpos.store((m_rpos.load(std::memory_order_acquire) + discard) % m_buffer_size, std::memory_order_release);
+  m_buffer.RequestDiscard(CHUNK_SIZE * 2);
 }
 
 void CoreAudioStream::EmptyStretchBuffers()
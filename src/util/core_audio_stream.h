@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include "audio_resampler.h"
+#include "audio_ring_buffer.h"
 #include "audio_stream.h"
 
 #include "common/align.h"
@@ -27,6 +29,7 @@ struct AudioStreamParameters
 {
   AudioStretchMode stretch_mode = DEFAULT_STRETCH_MODE;
   bool output_latency_minimal = DEFAULT_OUTPUT_LATENCY_MINIMAL;
+  bool low_latency = DEFAULT_LOW_LATENCY;
   u16 output_latency_ms = DEFAULT_OUTPUT_LATENCY_MS;
   u16 buffer_ms = DEFAULT_BUFFER_MS;
 
@@ -36,6 +39,8 @@ struct AudioStreamParameters
   bool stretch_use_quickseek = DEFAULT_STRETCH_USE_QUICKSEEK;
   bool stretch_use_aa_filter = DEFAULT_STRETCH_USE_AA_FILTER;
 
+  u32 output_sample_rate = DEFAULT_OUTPUT_SAMPLE_RATE;
+
   static constexpr AudioStretchMode DEFAULT_STRETCH_MODE = AudioStretchMode::TimeStretch;
 #ifndef __ANDROID__
   static constexpr u16 DEFAULT_BUFFER_MS = 50;
@@ -45,6 +50,7 @@ struct AudioStreamParameters
   static constexpr u16 DEFAULT_OUTPUT_LATENCY_MS = 20;
 #endif
   static constexpr bool DEFAULT_OUTPUT_LATENCY_MINIMAL = false;
+  static constexpr bool DEFAULT_LOW_LATENCY = false;
 
   static constexpr u16 DEFAULT_STRETCH_SEQUENCE_LENGTH = 30;
   static constexpr u16 DEFAULT_STRETCH_SEEKWINDOW = 20;
@@ -53,6 +59,9 @@ struct AudioStreamParameters
   static constexpr bool DEFAULT_STRETCH_USE_QUICKSEEK = false;
   static constexpr bool DEFAULT_STRETCH_USE_AA_FILTER = false;
 
+  /// Zero opens the device at the emulated rate, and leaves any conversion to the backend.
+  static constexpr u32 DEFAULT_OUTPUT_SAMPLE_RATE = 0;
+
   void Load(const SettingsInterface& si, const char* section);
   void Save(SettingsInterface& si, const char* section) const;
   void Clear(SettingsInterface& si, const char* section);
@@ -69,6 +78,14 @@ public:
   static constexpr u32 NUM_CHANNELS = 2;
   static constexpr u32 CHUNK_SIZE = 64;
 
+  struct Statistics
+  {
+    u32 underrun_count;
+    u32 overrun_count;
+    u32 buffered_frames;
+    u32 target_frames;
+  };
+
   CoreAudioStream();
   ~CoreAudioStream();
 
@@ -81,6 +98,7 @@ public:
   static std::optional<AudioStretchMode> ParseStretchMode(const char* name);
 
   ALWAYS_INLINE u32 GetSampleRate() const { return m_sample_rate; }
+  ALWAYS_INLINE u32 GetOutputSampleRate() const { return m_output_sample_rate; }
   ALWAYS_INLINE u32 GetBufferSize() const { return m_buffer_size; }
   ALWAYS_INLINE u32 GetTargetBufferSize() const { return m_target_buffer_size; }
   ALWAYS_INLINE u32 GetOutputVolume() const { return m_volume; }
@@ -89,6 +107,9 @@ public:
 
   u32 GetBufferedFramesRelaxed() const;
 
+  /// Returns the underrun/overrun counts since the last call, and the current fill level. Emulation thread only.
+  Statistics GetAndResetStatistics();
+
   /// Creation/destruction.
   bool Initialize(AudioBackend backend, u32 sample_rate, const AudioStreamParameters& params,
                   std::string_view driver_name, std::string_view device_name, Error* error);
@@ -135,13 +156,19 @@ private:
   void StretchUnderrun();
   void StretchOverrun();
 
+  bool UseLowLatencyStretch() const;
+  u32 GetLowLatencyTargetSize();
+  void LowLatencyWriteChunk(const SampleType* samples);
+
   float AddAndGetAverageTempo(float val);
   void UpdateStretchTempo();
 
   void ReadFrames(SampleType* samples, u32 num_frames) override;
+  void ReadInputFrames(SampleType* samples, u32 num_frames);
 
   std::unique_ptr<AudioStream> m_stream;
   u32 m_sample_rate = 0;
+  u32 m_output_sample_rate = 0;
   u32 m_volume = 0;
   AudioStreamParameters m_parameters;
   bool m_stretch_inactive = false;
@@ -149,7 +176,7 @@ private:
   bool m_paused = false;
 
   u32 m_buffer_size = 0;
-  Common::unique_aligned_ptr<s16[]> m_buffer;
+  AudioRingBuffer m_buffer;
 
   // temporary staging buffer, used for timestretching
   Common::unique_aligned_ptr<s16[]> m_staging_buffer;
@@ -157,8 +184,16 @@ private:
   // float buffer, soundtouch only accepts float samples as input
   Common::unique_aligned_ptr<float[]> m_float_buffer;
 
-  std::atomic<u32> m_rpos{0};
-  std::atomic<u32> m_wpos{0};
+  // output of the low latency resampler, which can produce slightly more frames than it's given
+  Common::unique_aligned_ptr<s16[]> m_resample_buffer;
+
+  // largest recent request from the backend, and number of underruns, updated from the audio thread
+  std::atomic<u32> m_callback_frames{0};
+  std::atomic<u32> m_underrun_count{0};
+
+  // only touched by the emulation thread
+  u32 m_overrun_count = 0;
+  u32 m_statistics_last_underrun_count = 0;
 
   void* m_soundtouch = nullptr;
 
@@ -175,4 +210,16 @@ private:
   u32 m_staging_buffer_pos = 0;
 
   std::array<float, AVERAGING_BUFFER_SIZE> m_average_fullness = {};
+
+  // low latency rate control, position is 16.16 fixed point relative to the last frame of the previous chunk
+  u32 m_resample_position = 0;
+  u32 m_low_latency_margin = 0;
+  u32 m_low_latency_last_underrun_count = 0;
+  u64 m_low_latency_margin_time = 0;
+  bool m_low_latency_stretching = false;
+  std::array<SampleType, NUM_CHANNELS> m_resample_last_frame = {};
+
+  // converts to the device rate when it differs, input frames are staged here before filtering
+  PolyphaseResampler m_output_resampler;
+  Common::unique_aligned_ptr<s16[]> m_output_resampler_buffer;
 };
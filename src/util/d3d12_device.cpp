@@ -472,6 +472,7 @@ void D3D12Device::MoveToNextCommandList()
   res.command_allocators[1]->Reset();
   res.command_lists[1]->Reset(res.command_allocators[1].Get(), nullptr);
   res.descriptor_allocator.Reset();
+  res.descriptor_groups.clear();
   if (res.sampler_allocator.ShouldReset())
     res.sampler_allocator.Reset();
 
@@ -479,16 +480,23 @@ void D3D12Device::MoveToNextCommandList()
   {
     // readback timestamp from the last time this cmdlist was used.
     // we don't need to worry about disjoint in dx12, the frequency is reliable within a single cmdlist.
+    const u32 num_queries = 2 + static_cast<u32>(res.timing_scopes.size()) * 2;
     const u32 offset = (m_current_command_list * (sizeof(u64) * NUM_TIMESTAMP_QUERIES_PER_CMDLIST));
-    const D3D12_RANGE read_range = {offset, offset + (sizeof(u64) * NUM_TIMESTAMP_QUERIES_PER_CMDLIST)};
+    const D3D12_RANGE read_range = {offset, offset + (sizeof(u64) * num_queries)};
     void* map;
     HRESULT hr = m_timestamp_query_buffer->Map(0, &read_range, &map);
     if (SUCCEEDED(hr))
     {
-      u64 timestamps[2];
-      std::memcpy(timestamps, static_cast<const u8*>(map) + offset, sizeof(timestamps));
+      std::array<u64, NUM_TIMESTAMP_QUERIES_PER_CMDLIST> timestamps;
+      std::memcpy(timestamps.data(), static_cast<const u8*>(map) + offset, sizeof(u64) * num_queries);
       m_accumulated_gpu_time +=
         static_cast<float>(static_cast<double>(timestamps[1] - timestamps[0]) / m_timestamp_frequency);
+      for (size_t i = 0; i < res.timing_scopes.size(); i++)
+      {
+        const u64 diff = timestamps[3 + i * 2] - timestamps[2 + i * 2];
+        AccumulateTimingScopeTime(res.timing_scopes[i],
+                                  static_cast<float>(static_cast<double>(diff) / m_timestamp_frequency));
+      }
 
       const D3D12_RANGE write_range = {};
       m_timestamp_query_buffer->Unmap(0, &write_range);
@@ -500,6 +508,7 @@ void D3D12Device::MoveToNextCommandList()
   }
 
   res.has_timestamp_query = m_gpu_timing_enabled;
+  res.timing_scopes.clear();
   if (m_gpu_timing_enabled)
   {
     res.command_lists[1]->EndQuery(m_timestamp_query_heap.Get(), D3D12_QUERY_TYPE_TIMESTAMP,
@@ -606,6 +615,7 @@ void D3D12Device::SubmitCommandList(bool wait_for_completion)
   CommandList& res = m_command_lists[m_current_command_list];
   HRESULT hr;
 
+  EndTimingScope();
   if (res.has_timestamp_query)
   {
     // write the timestamp back at the end of the cmdlist
@@ -613,7 +623,8 @@ void D3D12Device::SubmitCommandList(bool wait_for_completion)
                                    (m_current_command_list * NUM_TIMESTAMP_QUERIES_PER_CMDLIST) + 1);
     res.command_lists[1]->ResolveQueryData(m_timestamp_query_heap.Get(), D3D12_QUERY_TYPE_TIMESTAMP,
                                            m_current_command_list * NUM_TIMESTAMP_QUERIES_PER_CMDLIST,
-                                           NUM_TIMESTAMP_QUERIES_PER_CMDLIST, m_timestamp_query_buffer.Get(),
+                                           2 + static_cast<u32>(res.timing_scopes.size()) * 2,
+                                           m_timestamp_query_buffer.Get(),
                                            m_current_command_list * (sizeof(u64) * NUM_TIMESTAMP_QUERIES_PER_CMDLIST));
   }
 
@@ -795,6 +806,27 @@ float D3D12Device::GetAndResetAccumulatedGPUTime()
   return time;
 }
 
+bool D3D12Device::BeginTimingScopeQuery(const char* name)
+{
+  CommandList& res = m_command_lists[m_current_command_list];
+  if (!res.has_timestamp_query || res.timing_scopes.size() == MAX_TIMING_SCOPES_PER_CMDLIST)
+    return false;
+
+  res.command_lists[1]->EndQuery(m_timestamp_query_heap.Get(), D3D12_QUERY_TYPE_TIMESTAMP,
+                                 m_current_command_list * NUM_TIMESTAMP_QUERIES_PER_CMDLIST + 2 +
+                                   static_cast<u32>(res.timing_scopes.size()) * 2);
+  res.timing_scopes.push_back(name);
+  return true;
+}
+
+void D3D12Device::EndTimingScopeQuery()
+{
+  const CommandList& res = m_command_lists[m_current_command_list];
+  res.command_lists[1]->EndQuery(m_timestamp_query_heap.Get(), D3D12_QUERY_TYPE_TIMESTAMP,
+                                 m_current_command_list * NUM_TIMESTAMP_QUERIES_PER_CMDLIST + 2 +
+                                   static_cast<u32>(res.timing_scopes.size() - 1) * 2 + 1);
+}
+
 bool D3D12Device::SetGPUTimingEnabled(bool enabled)
 {
   m_gpu_timing_enabled = enabled && m_features.gpu_timing;
@@ -1344,6 +1376,7 @@ void D3D12Device::SetFeatures(D3D_FEATURE_LEVEL feature_level, CreateFlags creat
   m_features.gpu_timing = true;
   m_features.shader_cache = true;
   m_features.pipeline_cache = true;
+  m_features.threaded_pipeline_creation = true;
   m_features.prefer_unused_textures = true;
 
   m_features.raster_order_views = false;
@@ -2518,30 +2551,14 @@ bool D3D12Device::UpdateParametersForLayout(u32 dirty)
   constexpr u32 num_textures = GetActiveTexturesForLayout(layout);
   if (dirty & DIRTY_FLAG_TEXTURES && num_textures > 0)
   {
-    D3D12DescriptorAllocator& allocator = m_command_lists[m_current_command_list].descriptor_allocator;
+    const D3D12DescriptorHandle* src_handles[MAX_TEXTURE_SAMPLERS];
+    for (u32 i = 0; i < num_textures; i++)
+      src_handles[i] = m_current_textures[i] ? &m_current_textures[i]->GetSRVDescriptor() : &m_null_srv_descriptor;
+
     D3D12DescriptorHandle gpu_handle;
-    if (!allocator.Allocate(num_textures, &gpu_handle))
+    if (!LookupDescriptorGroup(&gpu_handle, src_handles, num_textures))
       return false;
 
-    if constexpr (num_textures == 1)
-    {
-      m_device->CopyDescriptorsSimple(
-        1, gpu_handle, m_current_textures[0] ? m_current_textures[0]->GetSRVDescriptor() : m_null_srv_descriptor,
-        D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-    }
-    else
-    {
-      D3D12_CPU_DESCRIPTOR_HANDLE src_handles[MAX_TEXTURE_SAMPLERS];
-      UINT src_sizes[MAX_TEXTURE_SAMPLERS];
-      for (u32 i = 0; i < num_textures; i++)
-      {
-        src_handles[i] = m_current_textures[i] ? m_current_textures[i]->GetSRVDescriptor() : m_null_srv_descriptor;
-        src_sizes[i] = 1;
-      }
-      m_device->CopyDescriptors(1, &gpu_handle.cpu_handle, &num_textures, num_textures, src_handles, src_sizes,
-                                D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-    }
-
     if constexpr (!IsComputeLayout(layout))
       cmdlist->SetGraphicsRootDescriptorTable(0, gpu_handle);
     else
@@ -2571,14 +2588,12 @@ bool D3D12Device::UpdateParametersForLayout(u32 dirty)
 
   if (dirty & DIRTY_FLAG_TEXTURES && layout == GPUPipeline::Layout::SingleTextureBufferAndPushConstants)
   {
-    D3D12DescriptorAllocator& allocator = m_command_lists[m_current_command_list].descriptor_allocator;
+    const D3D12DescriptorHandle* src_handle =
+      m_current_texture_buffer ? &m_current_texture_buffer->GetDescriptor() : &m_null_srv_descriptor;
     D3D12DescriptorHandle gpu_handle;
-    if (!allocator.Allocate(1, &gpu_handle))
+    if (!LookupDescriptorGroup(&gpu_handle, &src_handle, 1))
       return false;
 
-    m_device->CopyDescriptorsSimple(
-      1, gpu_handle, m_current_texture_buffer ? m_current_texture_buffer->GetDescriptor() : m_null_srv_descriptor,
-      D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
     cmdlist->SetGraphicsRootDescriptorTable(0, gpu_handle);
   }
 
@@ -2586,22 +2601,16 @@ bool D3D12Device::UpdateParametersForLayout(u32 dirty)
   {
     DebugAssert(m_current_render_pass_flags & GPUPipeline::BindRenderTargetsAsImages);
 
-    D3D12DescriptorAllocator& allocator = m_command_lists[m_current_command_list].descriptor_allocator;
-    D3D12DescriptorHandle gpu_handle;
-    if (!allocator.Allocate(MAX_IMAGE_RENDER_TARGETS, &gpu_handle))
-      return false;
-
-    D3D12_CPU_DESCRIPTOR_HANDLE src_handles[MAX_IMAGE_RENDER_TARGETS];
-    UINT src_sizes[MAX_IMAGE_RENDER_TARGETS];
-    const UINT dst_size = MAX_IMAGE_RENDER_TARGETS;
+    const D3D12DescriptorHandle* src_handles[MAX_IMAGE_RENDER_TARGETS];
     for (u32 i = 0; i < MAX_IMAGE_RENDER_TARGETS; i++)
     {
       src_handles[i] =
-        m_current_render_targets[i] ? m_current_render_targets[i]->GetUAVDescriptor() : m_null_uav_descriptor;
-      src_sizes[i] = 1;
+        m_current_render_targets[i] ? &m_current_render_targets[i]->GetUAVDescriptor() : &m_null_uav_descriptor;
     }
-    m_device->CopyDescriptors(1, &gpu_handle.cpu_handle, &dst_size, MAX_IMAGE_RENDER_TARGETS, src_handles, src_sizes,
-                              D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+    D3D12DescriptorHandle gpu_handle;
+    if (!LookupDescriptorGroup(&gpu_handle, src_handles, MAX_IMAGE_RENDER_TARGETS))
+      return false;
 
     constexpr u32 rov_param =
       IsComputeLayout(layout) ?
@@ -2621,6 +2630,58 @@ bool D3D12Device::UpdateParametersForLayout(u32 dirty)
   return true;
 }
 
+size_t D3D12Device::DescriptorGroupKeyHash::operator()(const DescriptorGroupKey& key) const
+{
+  size_t seed = 0;
+  hash_combine(seed, key.num_descriptors);
+  for (u32 i = 0; i < key.num_descriptors; i++)
+    hash_combine(seed, key.idx[i]);
+  return seed;
+}
+
+bool D3D12Device::LookupDescriptorGroup(D3D12DescriptorHandle* gpu_handle,
+                                        const D3D12DescriptorHandle* const* cpu_handles, u32 num_descriptors)
+{
+  DebugAssert(num_descriptors > 0 && num_descriptors <= MAX_TEXTURE_SAMPLERS);
+
+  DescriptorGroupKey key;
+  std::memset(&key, 0, sizeof(key));
+  key.num_descriptors = num_descriptors;
+  for (u32 i = 0; i < num_descriptors; i++)
+    key.idx[i] = cpu_handles[i]->index;
+
+  CommandList& cmdlist = m_command_lists[m_current_command_list];
+  const auto it = cmdlist.descriptor_groups.find(key);
+  if (it != cmdlist.descriptor_groups.end())
+  {
+    *gpu_handle = it->second;
+    return true;
+  }
+
+  if (!cmdlist.descriptor_allocator.Allocate(num_descriptors, gpu_handle))
+    return false;
+
+  if (num_descriptors == 1)
+  {
+    m_device->CopyDescriptorsSimple(1, *gpu_handle, *cpu_handles[0], D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+  }
+  else
+  {
+    D3D12_CPU_DESCRIPTOR_HANDLE src_handles[MAX_TEXTURE_SAMPLERS];
+    UINT src_sizes[MAX_TEXTURE_SAMPLERS];
+    for (u32 i = 0; i < num_descriptors; i++)
+    {
+      src_handles[i] = *cpu_handles[i];
+      src_sizes[i] = 1;
+    }
+    m_device->CopyDescriptors(1, &gpu_handle->cpu_handle, &num_descriptors, num_descriptors, src_handles, src_sizes,
+                              D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+  }
+
+  cmdlist.descriptor_groups.emplace(key, *gpu_handle);
+  return true;
+}
+
 bool D3D12Device::UpdateRootParameters(u32 dirty)
 {
   switch (m_current_pipeline_layout)
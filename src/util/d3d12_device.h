@@ -52,8 +52,9 @@ public:
   {
     NUM_COMMAND_LISTS = 3,
 
-    /// Start/End timestamp queries.
-    NUM_TIMESTAMP_QUERIES_PER_CMDLIST = 2,
+    /// Start/End timestamp queries, followed by a begin/end pair for each timing scope.
+    MAX_TIMING_SCOPES_PER_CMDLIST = 256,
+    NUM_TIMESTAMP_QUERIES_PER_CMDLIST = 2 + MAX_TIMING_SCOPES_PER_CMDLIST * 2,
   };
 
 public:
@@ -211,6 +212,9 @@ protected:
   bool CreatePipelineCache(const std::string& path, Error* error) override;
   bool GetPipelineCacheData(DynamicHeapArray<u8>* data, Error* error) override;
 
+  bool BeginTimingScopeQuery(const char* name) override;
+  void EndTimingScopeQuery() override;
+
 private:
   enum DIRTY_FLAG : u32
   {
@@ -226,6 +230,24 @@ private:
     ALL_DIRTY_STATE = DIRTY_FLAG_INITIAL | LAYOUT_DEPENDENT_DIRTY_STATE,
   };
 
+  /// Identifies a table of SRV/UAV descriptors copied to the shader-visible heap. Descriptor indices aren't reused
+  /// until the command list using them has finished, so tables can be shared by draws within a command list.
+  struct DescriptorGroupKey
+  {
+    u32 num_descriptors;
+    u32 idx[MAX_TEXTURE_SAMPLERS];
+
+    ALWAYS_INLINE bool operator==(const DescriptorGroupKey& rhs) const
+    {
+      return (std::memcmp(this, &rhs, sizeof(*this)) == 0);
+    }
+  };
+
+  struct DescriptorGroupKeyHash
+  {
+    size_t operator()(const DescriptorGroupKey& key) const;
+  };
+
   struct CommandList
   {
     // [0] - Init (upload) command buffer, [1] - draw command buffer
@@ -233,10 +255,12 @@ private:
     std::array<ComPtr<ID3D12GraphicsCommandList4>, 2> command_lists;
     D3D12DescriptorAllocator descriptor_allocator;
     D3D12GroupedSamplerAllocator<MAX_TEXTURE_SAMPLERS> sampler_allocator;
+    std::unordered_map<DescriptorGroupKey, D3D12DescriptorHandle, DescriptorGroupKeyHash> descriptor_groups;
     u64 fence_counter = 0;
     bool init_list_used = false;
     bool needs_fence_wait = false;
     bool has_timestamp_query = false;
+    std::vector<const char*> timing_scopes;
   };
 
   struct PIPELINE_CACHE_HEADER
@@ -295,6 +319,10 @@ private:
   bool UpdateParametersForLayout(u32 dirty);
   bool UpdateRootParameters(u32 dirty);
 
+  /// Returns a shader-visible copy of the descriptors, reusing an earlier copy made by the current command list.
+  bool LookupDescriptorGroup(D3D12DescriptorHandle* gpu_handle, const D3D12DescriptorHandle* const* cpu_handles,
+                             u32 num_descriptors);
+
   ComPtr<IDXGIAdapter1> m_adapter;
   ComPtr<ID3D12Device1> m_device;
   ComPtr<ID3D12CommandQueue> m_command_queue;
@@ -13,6 +13,7 @@
 #include "common/assert.h"
 #include "common/dynamic_library.h"
 #include "common/error.h"
+#include "common/event_trace.h"
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/path.h"
@@ -26,6 +27,10 @@
 
 #include "IconsEmoji.h"
 
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
 LOG_CHANNEL(GPUDevice);
 
 #ifdef _WIN32
@@ -419,8 +424,9 @@ std::optional<GPUDevice::AdapterInfoList> GPUDevice::GetAdapterListForAPI(Render
 }
 
 bool GPUDevice::Create(std::string_view adapter, CreateFlags create_flags, std::string_view shader_dump_path,
-                       std::string_view shader_cache_path, u32 shader_cache_version, const WindowInfo& wi,
-                       GPUVSyncMode vsync, const ExclusiveFullscreenMode* exclusive_fullscreen_mode,
+                       std::string_view shader_cache_path, std::string_view shader_package_path,
+                       u32 shader_cache_version, const WindowInfo& wi, GPUVSyncMode vsync,
+                       const ExclusiveFullscreenMode* exclusive_fullscreen_mode,
                        std::optional<bool> exclusive_fullscreen_control, Error* error)
 {
   m_debug_device = HasCreateFlag(create_flags, CreateFlags::EnableDebugDevice);
@@ -473,7 +479,7 @@ bool GPUDevice::Create(std::string_view adapter, CreateFlags create_flags, std::
   INFO_LOG("Graphics Driver Info:\n{}", GetDriverInfo());
 
   OpenShaderCache(HasCreateFlag(create_flags, CreateFlags::DisableShaderCache) ? std::string_view() : shader_cache_path,
-                  shader_cache_version);
+                  shader_package_path, shader_cache_version);
 
   if (!CreateResources(error))
   {
@@ -490,6 +496,7 @@ void GPUDevice::Destroy()
 
   PurgeTexturePool();
   DestroyResources();
+  WaitForBackgroundPipelineTasks();
   CloseShaderCache();
   DestroyDevice();
 }
@@ -515,8 +522,21 @@ void GPUDevice::DestroyMainSwapChain()
   m_main_swap_chain.reset();
 }
 
-void GPUDevice::OpenShaderCache(std::string_view base_path, u32 version)
+void GPUDevice::OpenShaderCache(std::string_view base_path, std::string_view package_path, u32 version)
 {
+  // Only bytecode is portable between drivers. The device's API version doesn't change what gets compiled, and
+  // binaries built for a higher feature level fail to load and are compiled from source instead.
+  if (m_features.shader_cache && !package_path.empty() &&
+      (m_render_api == RenderAPI::Vulkan || m_render_api == RenderAPI::D3D12 || m_render_api == RenderAPI::D3D11))
+  {
+    const std::string package_filename = Path::Combine(package_path, GetShaderCacheBaseName("shaders"));
+    if (FileSystem::FileExists(TinyString::from_format("{}.idx", package_filename).c_str()) &&
+        !m_shader_package.Open(package_filename, 0, version, true))
+    {
+      WARNING_LOG("Failed to open shader package '{}'", Path::GetFileName(package_filename));
+    }
+  }
+
   if (m_features.shader_cache && !base_path.empty())
   {
     const std::string basename = GetShaderCacheBaseName("shaders");
@@ -576,6 +596,7 @@ void GPUDevice::OpenShaderCache(std::string_view base_path, u32 version)
 void GPUDevice::CloseShaderCache()
 {
   m_shader_cache.Close();
+  m_shader_package.Close();
 
   if (!s_pipeline_cache_path.empty())
   {
@@ -764,29 +785,67 @@ void GPUDevice::InvalidateRenderTarget(GPUTexture* t)
   t->SetState(GPUTexture::State::Invalidated);
 }
 
+/// Shared by all devices, pipeline creation is bounded by the driver rather than by the number of cores after this.
+static constexpr u32 MAX_PIPELINE_THREADS = 8;
+
+static TaskQueue& GetPipelineTaskQueue()
+{
+  static TaskQueue queue;
+  static std::once_flag queue_once;
+  std::call_once(queue_once, []() {
+    // leave a core for the calling thread, it runs tasks too while it waits
+    const u32 num_threads = std::thread::hardware_concurrency();
+    queue.SetWorkerCount(std::clamp(num_threads - std::min(num_threads, 1u), 1u, MAX_PIPELINE_THREADS));
+  });
+  return queue;
+}
+
+void GPUDevice::SubmitPipelineTask(TaskQueue::Task task, TaskQueue::Group& group)
+{
+  if (!m_features.threaded_pipeline_creation)
+  {
+    task();
+    return;
+  }
+
+  GetPipelineTaskQueue().SubmitTask(std::move(task), TaskQueue::Priority::Interactive, &group);
+}
+
+void GPUDevice::WaitForPipelineTasks(TaskQueue::Group& group)
+{
+  if (m_features.threaded_pipeline_creation)
+    GetPipelineTaskQueue().WaitForAll(group);
+}
+
+void GPUDevice::QueueBackgroundPipelineTask(TaskQueue::Task task)
+{
+  GetPipelineTaskQueue().SubmitTask(std::move(task), TaskQueue::Priority::Background, &m_background_pipeline_tasks);
+}
+
+void GPUDevice::WaitForBackgroundPipelineTasks()
+{
+  GetPipelineTaskQueue().WaitForAll(m_background_pipeline_tasks);
+}
+
 std::unique_ptr<GPUShader> GPUDevice::CreateShader(GPUShaderStage stage, GPUShaderLanguage language,
                                                    std::string_view source, Error* error /* = nullptr */,
                                                    const char* entry_point /* = "main" */)
 {
+  EventTrace::ScopedSpan span("Create Shader");
+
   std::unique_ptr<GPUShader> shader;
-  if (!m_shader_cache.IsOpen())
+  if (!m_shader_cache.IsOpen() && !m_shader_package.IsOpen())
   {
+    m_shader_compile_count++;
     shader = CreateShaderFromSource(stage, language, source, entry_point, nullptr, error);
     return shader;
   }
 
-  const GPUShaderCache::CacheIndexKey key = m_shader_cache.GetCacheKey(stage, language, source, entry_point);
-  std::optional<GPUShaderCache::ShaderBinary> binary = m_shader_cache.Lookup(key);
-  if (binary.has_value())
-  {
-    shader = CreateShaderFromBinary(stage, binary->cspan(), error);
-    if (shader)
-      return shader;
+  const GPUShaderCache::CacheIndexKey key = GPUShaderCache::GetCacheKey(stage, language, source, entry_point);
+  if ((shader = CreateShaderFromCache(stage, key)))
+    return shader;
 
-    ERROR_LOG("Failed to create shader from binary (driver changed?). Clearing cache.");
-    m_shader_cache.Clear();
-    binary.reset();
-  }
+  m_shader_compile_count++;
 
   GPUShaderCache::ShaderBinary new_binary;
   shader = CreateShaderFromSource(stage, language, source, entry_point, &new_binary, error);
@@ -794,15 +853,51 @@ std::unique_ptr<GPUShader> GPUDevice::CreateShader(GPUShaderStage stage, GPUShad
     return shader;
 
   // Don't insert empty shaders into the cache...
-  if (!new_binary.empty())
+  if (m_shader_cache.IsOpen() && !new_binary.empty())
   {
-    if (!m_shader_cache.Insert(key, new_binary.data(), static_cast<u32>(new_binary.size())))
+    if (!m_shader_cache.Insert(key, std::move(new_binary)))
       m_shader_cache.Close();
   }
 
   return shader;
 }
 
+std::unique_ptr<GPUShader> GPUDevice::CreateShaderFromCache(GPUShaderStage stage,
+                                                            const GPUShaderCache::CacheIndexKey& key)
+{
+  std::unique_ptr<GPUShader> shader;
+  std::optional<GPUShaderCache::ShaderBinary> binary = m_shader_cache.Lookup(key);
+  if (binary.has_value())
+  {
+    shader = CreateShaderFromBinary(stage, binary->cspan(), nullptr);
+    if (shader)
+      return shader;
+
+    // Only this entry is dropped, the rest get replaced as they're looked up and the space is reclaimed on close.
+    ERROR_LOG("Failed to create shader from binary (driver changed?). Recompiling.");
+    m_shader_cache.Remove(key);
+    binary.reset();
+  }
+
+  if (m_shader_package.IsOpen() && (binary = m_shader_package.Lookup(key)).has_value())
+  {
+    shader = CreateShaderFromBinary(stage, binary->cspan(), nullptr);
+    if (shader)
+    {
+      // Copied into the regular cache, so that a package built from it includes everything this one did.
+      if (m_shader_cache.IsOpen() && !m_shader_cache.Insert(key, std::move(binary.value())))
+        m_shader_cache.Close();
+
+      return shader;
+    }
+
+    DEV_LOG("Shader package binary is not usable on this device, compiling from source.");
+    m_shader_package.Remove(key);
+  }
+
+  return shader;
+}
+
 std::optional<GPUDevice::ExclusiveFullscreenMode> GPUDevice::ExclusiveFullscreenMode::Parse(std::string_view str)
 {
   std::optional<ExclusiveFullscreenMode> ret;
@@ -1214,6 +1309,74 @@ float GPUDevice::GetAndResetAccumulatedGPUTime()
   return 0.0f;
 }
 
+static const char* InternTimingScopeName(std::string_view name)
+{
+  // Only touched from the GPU thread. Deque, so that existing entries don't move when new names are added.
+  static std::deque<std::string> s_names;
+  for (const std::string& it : s_names)
+  {
+    if (it == name)
+      return it.c_str();
+  }
+
+  return s_names.emplace_back(name).c_str();
+}
+
+void GPUDevice::BeginTimingScope(std::string_view name)
+{
+  if (!m_gpu_timing_enabled)
+    return;
+
+  const char* interned_name = InternTimingScopeName(name);
+  if (m_timing_scope_name)
+  {
+    if (m_timing_scope_name == interned_name)
+      return;
+
+    EndTimingScopeQuery();
+  }
+
+  m_timing_scope_name = BeginTimingScopeQuery(interned_name) ? interned_name : nullptr;
+}
+
+void GPUDevice::EndTimingScope()
+{
+  if (!m_timing_scope_name)
+    return;
+
+  EndTimingScopeQuery();
+  m_timing_scope_name = nullptr;
+}
+
+bool GPUDevice::BeginTimingScopeQuery(const char* name)
+{
+  return false;
+}
+
+void GPUDevice::EndTimingScopeQuery()
+{
+}
+
+void GPUDevice::AccumulateTimingScopeTime(const char* name, float time)
+{
+  for (TimingScopeTime& it : m_timing_scope_times)
+  {
+    if (it.name == name)
+    {
+      it.time += time;
+      return;
+    }
+  }
+
+  m_timing_scope_times.push_back(TimingScopeTime{name, time});
+}
+
+void GPUDevice::GetAndResetAccumulatedTimingScopeTimes(std::vector<TimingScopeTime>* times)
+{
+  times->clear();
+  times->swap(m_timing_scope_times);
+}
+
 void GPUDevice::ResetStatistics()
 {
   s_stats = {};
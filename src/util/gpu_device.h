@@ -11,10 +11,12 @@
 #include "common/gsvector.h"
 #include "common/heap_array.h"
 #include "common/small_string.h"
+#include "common/task_queue.h"
 #include "common/types.h"
 
 #include "fmt/base.h"
 
+#include <atomic>
 #include <cstring>
 #include <deque>
 #include <memory>
@@ -560,6 +562,7 @@ public:
     bool gpu_timing : 1;
     bool shader_cache : 1;
     bool pipeline_cache : 1;
+    bool threaded_pipeline_creation : 1;
     bool prefer_unused_textures : 1;
     bool raster_order_views : 1;
     bool dxt_textures : 1;
@@ -691,6 +694,9 @@ public:
   ALWAYS_INLINE u32 GetMaxTextureSize() const { return m_max_texture_size; }
   ALWAYS_INLINE u32 GetMaxMultisamples() const { return m_max_multisamples; }
 
+  /// Returns the base filename used for caches of the given type, e.g. "vulkan_shaders".
+  std::string GetShaderCacheBaseName(std::string_view type) const;
+
   ALWAYS_INLINE GPUSwapChain* GetMainSwapChain() const { return m_main_swap_chain.get(); }
   ALWAYS_INLINE bool HasMainSwapChain() const { return static_cast<bool>(m_main_swap_chain); }
 
@@ -700,9 +706,14 @@ public:
 
   ALWAYS_INLINE bool IsGPUTimingEnabled() const { return m_gpu_timing_enabled; }
 
+  /// Number of shaders that had to be compiled from source rather than coming from the cache.
+  ALWAYS_INLINE u32 GetShaderCompileCount() const { return m_shader_compile_count.load(std::memory_order_relaxed); }
+
+  /// The shader package is a read-only cache of prebuilt binaries, which is checked before compiling anything that
+  /// isn't in the regular shader cache.
   bool Create(std::string_view adapter, CreateFlags create_flags, std::string_view shader_dump_path,
-              std::string_view shader_cache_path, u32 shader_cache_version, const WindowInfo& wi, GPUVSyncMode vsync,
-              const ExclusiveFullscreenMode* exclusive_fullscreen_mode,
+              std::string_view shader_cache_path, std::string_view shader_package_path, u32 shader_cache_version,
+              const WindowInfo& wi, GPUVSyncMode vsync, const ExclusiveFullscreenMode* exclusive_fullscreen_mode,
               std::optional<bool> exclusive_fullscreen_control, Error* error);
   void Destroy();
 
@@ -765,11 +776,22 @@ public:
   /// Shader abstraction.
   std::unique_ptr<GPUShader> CreateShader(GPUShaderStage stage, GPUShaderLanguage language, std::string_view source,
                                           Error* error = nullptr, const char* entry_point = "main");
+
+  /// Creates a shader from the cached binary for a key returned by GPUShaderCache::GetCacheKey(), without needing the
+  /// source. Returns null if neither the shader cache nor the package has a binary that this device can use.
+  std::unique_ptr<GPUShader> CreateShaderFromCache(GPUShaderStage stage, const GPUShaderCache::CacheIndexKey& key);
+
   virtual std::unique_ptr<GPUPipeline> CreatePipeline(const GPUPipeline::GraphicsConfig& config,
                                                       Error* error = nullptr) = 0;
   virtual std::unique_ptr<GPUPipeline> CreatePipeline(const GPUPipeline::ComputeConfig& config,
                                                       Error* error = nullptr) = 0;
 
+  /// Queues a task which creates shaders and/or pipelines. If the device supports threaded pipeline creation, it runs
+  /// on a worker thread in parallel with other tasks, otherwise it runs immediately on the calling thread. Nothing
+  /// else may be done with the device until the group has been waited on.
+  void SubmitPipelineTask(TaskQueue::Task task, TaskQueue::Group& group);
+  void WaitForPipelineTasks(TaskQueue::Group& group);
+
 #ifdef ENABLE_GPU_OBJECT_NAMES
   /// Debug messaging.
   virtual void PushDebugGroup(const char* name) = 0;
@@ -860,6 +882,33 @@ public:
   /// Returns the amount of GPU time utilized since the last time this method was called.
   virtual float GetAndResetAccumulatedGPUTime();
 
+  /// Per-pass GPU time, sampled with timestamp queries around the work between Begin/EndTimingScope(). Only recorded
+  /// while GPU timing is enabled, and only by backends that support it. Scopes can't be nested: beginning a scope
+  /// closes the current one, unless it has the same name, in which case it carries on, so runs of the same pass only
+  /// cost one pair of queries. Any open scope is closed when the command buffer is submitted.
+  struct TimingScopeTime
+  {
+    const char* name; ///< Interned, valid for the lifetime of the process.
+    float time;       ///< Milliseconds.
+  };
+
+  /// Brackets the lifetime of the object in a timing scope.
+  class TimingScope
+  {
+  public:
+    explicit TimingScope(std::string_view name);
+    ~TimingScope();
+
+    TimingScope(const TimingScope&) = delete;
+    TimingScope& operator=(const TimingScope&) = delete;
+  };
+
+  void BeginTimingScope(std::string_view name);
+  void EndTimingScope();
+
+  /// Moves the time accumulated for each scope since the last call into times, in the order they were first seen.
+  void GetAndResetAccumulatedTimingScopeTimes(std::vector<TimingScopeTime>* times);
+
   ALWAYS_INLINE static Statistics& GetStatistics() { return s_stats; }
   static void ResetStatistics();
 
@@ -873,7 +922,6 @@ protected:
                                             std::optional<bool> exclusive_fullscreen_control, Error* error) = 0;
   virtual void DestroyDevice() = 0;
 
-  std::string GetShaderCacheBaseName(std::string_view type) const;
   virtual bool OpenPipelineCache(const std::string& path, Error* error);
   virtual bool CreatePipelineCache(const std::string& path, Error* error);
   virtual bool ReadPipelineCache(DynamicHeapArray<u8> data, Error* error);
@@ -888,6 +936,11 @@ protected:
 
   void TrimTexturePool();
 
+  /// Runs a low-priority task on the pipeline worker threads, e.g. to replace a quickly-created pipeline with an
+  /// optimized one. Backends must wait for these before destroying anything the tasks use.
+  void QueueBackgroundPipelineTask(TaskQueue::Task task);
+  void WaitForBackgroundPipelineTasks();
+
   bool CompileGLSLShaderToVulkanSpv(GPUShaderStage stage, GPUShaderLanguage source_language, std::string_view source,
                                     const char* entry_point, bool optimization, bool nonsemantic_debug_info,
                                     DynamicHeapArray<u8>* out_binary, Error* error);
@@ -902,6 +955,12 @@ protected:
 
   void SetDriverType(GPUDriverType type);
 
+  /// Backend hooks for timing scopes. Begin returns false if the scope can't be recorded, e.g. the query space for
+  /// this command buffer is exhausted, in which case End won't be called.
+  virtual bool BeginTimingScopeQuery(const char* name);
+  virtual void EndTimingScopeQuery();
+  void AccumulateTimingScopeTime(const char* name, float time);
+
   Features m_features = {};
   RenderAPI m_render_api = RenderAPI::None;
   u32 m_render_api_version = 0;
@@ -915,6 +974,9 @@ protected:
   GPUSampler* m_linear_sampler = nullptr;
 
   GPUShaderCache m_shader_cache;
+  GPUShaderCache m_shader_package;
+  std::atomic<u32> m_shader_compile_count{0};
+  TaskQueue::Group m_background_pipeline_tasks;
 
 private:
   static constexpr u32 MAX_TEXTURE_POOL_SIZE = 125;
@@ -957,7 +1019,7 @@ private:
   static AdapterInfoList WrapGetMetalAdapterList();
 #endif
 
-  void OpenShaderCache(std::string_view base_path, u32 version);
+  void OpenShaderCache(std::string_view base_path, std::string_view package_path, u32 version);
   void CloseShaderCache();
   bool CreateResources(Error* error);
   void DestroyResources();
@@ -972,6 +1034,9 @@ private:
   size_t m_pool_vram_usage = 0;
   u32 m_texture_pool_counter = 0;
 
+  std::vector<TimingScopeTime> m_timing_scope_times;
+  const char* m_timing_scope_name = nullptr;
+
 protected:
   static Statistics s_stats;
 
@@ -988,6 +1053,16 @@ ALWAYS_INLINE void GPUDevice::PooledTextureDeleter::operator()(GPUTexture* const
   g_gpu_device->RecycleTexture(std::unique_ptr<GPUTexture>(tex));
 }
 
+ALWAYS_INLINE GPUDevice::TimingScope::TimingScope(std::string_view name)
+{
+  g_gpu_device->BeginTimingScope(name);
+}
+
+ALWAYS_INLINE GPUDevice::TimingScope::~TimingScope()
+{
+  g_gpu_device->EndTimingScope();
+}
+
 // C preprocessor workarounds.
 #define GL_TOKEN_PASTE(x, y) x##y
 #define GL_TOKEN_PASTE2(x, y) GL_TOKEN_PASTE(x, y)
@@ -9,12 +9,16 @@
 #include "common/heap_array.h"
 #include "common/log.h"
 #include "common/md5_digest.h"
+#include "common/memory_accounting.h"
 #include "common/path.h"
+#include "common/threading.h"
 
 #include "fmt/format.h"
 
 #include "compress_helpers.h"
 
+#include <algorithm>
+
 LOG_CHANNEL(GPUDevice);
 
 #pragma pack(push, 1)
@@ -42,6 +46,32 @@ struct CacheIndexEntry
 
 static constexpr u32 EXPECTED_SIGNATURE = 0x434B5544; // DUKC
 
+// Blob files smaller than this are never compacted, it's not worth rewriting them.
+static constexpr u32 MIN_COMPACT_BLOB_SIZE = 4 * 1024 * 1024;
+
+// Compact once this fraction of the blob file belongs to entries which have been removed or replaced.
+static constexpr u32 COMPACT_GARBAGE_DIVISOR = 4;
+
+// When the live entries exceed this size, entries which weren't used in the session are dropped on close.
+static constexpr u32 MAX_BLOB_SIZE = 256 * 1024 * 1024;
+
+static CacheIndexEntry MakeIndexEntry(const GPUShaderCache::CacheIndexKey& key, u32 file_offset, u32 compressed_size,
+                                      u32 uncompressed_size)
+{
+  CacheIndexEntry entry = {};
+  entry.shader_type = key.shader_type;
+  entry.shader_language = key.shader_language;
+  entry.source_length = key.source_length;
+  entry.source_hash_low = key.source_hash_low;
+  entry.source_hash_high = key.source_hash_high;
+  entry.entry_point_low = key.entry_point_low;
+  entry.entry_point_high = key.entry_point_high;
+  entry.file_offset = file_offset;
+  entry.compressed_size = compressed_size;
+  entry.uncompressed_size = uncompressed_size;
+  return entry;
+}
+
 GPUShaderCache::GPUShaderCache() = default;
 
 GPUShaderCache::~GPUShaderCache()
@@ -67,18 +97,20 @@ std::size_t GPUShaderCache::CacheIndexEntryHash::operator()(const CacheIndexKey&
   return h;
 }
 
-bool GPUShaderCache::Open(std::string_view base_filename, u32 render_api_version, u32 cache_version)
+bool GPUShaderCache::Open(std::string_view base_filename, u32 render_api_version, u32 cache_version,
+                          bool read_only /* = false */)
 {
   m_base_filename = base_filename;
   m_render_api_version = render_api_version;
   m_version = cache_version;
+  m_read_only = read_only;
 
   if (base_filename.empty())
     return true;
 
   const std::string index_filename = fmt::format("{}.idx", m_base_filename);
   const std::string blob_filename = fmt::format("{}.bin", m_base_filename);
-  return ReadExisting(index_filename, blob_filename);
+  return ReadExisting(index_filename, blob_filename, read_only);
 }
 
 bool GPUShaderCache::Create()
@@ -90,6 +122,30 @@ bool GPUShaderCache::Create()
 
 void GPUShaderCache::Close()
 {
+  StopWriterThread();
+
+  // Reclaim the space from entries which were removed or replaced, e.g. after a driver update. If the cache has
+  // grown too large, anything that wasn't used this session goes too.
+  if (m_index_file && !m_read_only && m_blob_file_size >= MIN_COMPACT_BLOB_SIZE)
+  {
+    u64 live_size = 0;
+    for (const auto& [key, data] : m_index)
+      live_size += data.compressed_size;
+
+    const bool drop_unused = (live_size > MAX_BLOB_SIZE);
+    if (drop_unused || (m_blob_file_size - live_size) >= (m_blob_file_size / COMPACT_GARBAGE_DIVISOR))
+      Compact(drop_unused);
+  }
+
+  CloseFiles();
+}
+
+void GPUShaderCache::CloseFiles()
+{
+  m_blob_mapping.Unmap();
+  m_blob_file_size = 0;
+  m_write_failed = false;
+
   if (m_index_file)
   {
     std::fclose(m_index_file);
@@ -100,14 +156,28 @@ void GPUShaderCache::Close()
     std::fclose(m_blob_file);
     m_blob_file = nullptr;
   }
+
+  m_index.clear();
+  MemoryAccounting::Add(MemoryAccounting::Category::ShaderCache, -static_cast<s64>(m_accounted_memory), 0);
+  m_accounted_memory = 0;
+}
+
+void GPUShaderCache::UpdateMemoryAccounting()
+{
+  // Only the index is kept in memory, binaries are read from the blob file on lookup.
+  const size_t size = m_index.size() * (sizeof(CacheIndexKey) + sizeof(CacheIndexData));
+  MemoryAccounting::Add(MemoryAccounting::Category::ShaderCache,
+                        static_cast<s64>(size) - static_cast<s64>(m_accounted_memory), 0);
+  m_accounted_memory = size;
 }
 
 void GPUShaderCache::Clear()
 {
-  if (!IsOpen())
+  if (!IsOpen() || m_read_only)
     return;
 
-  Close();
+  StopWriterThread();
+  CloseFiles();
 
   WARNING_LOG("Clearing shader cache at {}.", Path::GetFileName(m_base_filename));
 
@@ -157,12 +227,14 @@ bool GPUShaderCache::CreateNew(const std::string& index_filename, const std::str
     return false;
   }
 
+  m_blob_file_size = 0;
   return true;
 }
 
-bool GPUShaderCache::ReadExisting(const std::string& index_filename, const std::string& blob_filename)
+bool GPUShaderCache::ReadExisting(const std::string& index_filename, const std::string& blob_filename,
+                                  bool read_only)
 {
-  m_index_file = FileSystem::OpenCFile(index_filename.c_str(), "r+b");
+  m_index_file = FileSystem::OpenCFile(index_filename.c_str(), read_only ? "rb" : "r+b");
   if (!m_index_file)
   {
     // special case here: when there's a sharing violation (i.e. two instances running),
@@ -178,7 +250,8 @@ bool GPUShaderCache::ReadExisting(const std::string& index_filename, const std::
 
   CacheFileHeader file_header;
   if (std::fread(&file_header, sizeof(file_header), 1, m_index_file) != 1 ||
-      file_header.signature != EXPECTED_SIGNATURE || file_header.render_api_version != m_render_api_version ||
+      file_header.signature != EXPECTED_SIGNATURE ||
+      (m_render_api_version != 0 && file_header.render_api_version != m_render_api_version) ||
       file_header.cache_version != m_version) [[unlikely]]
   {
     ERROR_LOG("Bad file/data version in '{}'", Path::GetFileName(index_filename));
@@ -187,7 +260,7 @@ bool GPUShaderCache::ReadExisting(const std::string& index_filename, const std::
     return false;
   }
 
-  m_blob_file = FileSystem::OpenCFile(blob_filename.c_str(), "a+b");
+  m_blob_file = FileSystem::OpenCFile(blob_filename.c_str(), read_only ? "rb" : "a+b");
   if (!m_blob_file) [[unlikely]]
   {
     ERROR_LOG("Blob file '{}' is missing", Path::GetFileName(blob_filename));
@@ -217,17 +290,25 @@ bool GPUShaderCache::ReadExisting(const std::string& index_filename, const std::
       return false;
     }
 
+    // entries which were removed and later recompiled appear more than once, the last one wins
     const CacheIndexKey key{entry.shader_type,     entry.shader_language, {},
                             entry.source_length,   entry.source_hash_low, entry.source_hash_high,
                             entry.entry_point_low, entry.entry_point_high};
-    const CacheIndexData data{entry.file_offset, entry.compressed_size, entry.uncompressed_size};
-    m_index.emplace(key, data);
+    const CacheIndexData data{entry.file_offset, entry.compressed_size, entry.uncompressed_size, false};
+    m_index.insert_or_assign(key, data);
   }
 
   // ensure we don't write before seeking
   std::fseek(m_index_file, 0, SEEK_END);
 
+  // Existing entries are decompressed straight from the mapping, anything appended later is read from the file.
+  Error error;
+  m_blob_file_size = blob_file_size;
+  if (!m_blob_mapping.Map(m_blob_file, &error))
+    WARNING_LOG("Failed to map blob file '{}': {}", Path::GetFileName(blob_filename), error.GetDescription());
+
   DEV_LOG("Read {} entries from '{}'", m_index.size(), Path::GetFileName(index_filename));
+  UpdateMemoryAccounting();
   return true;
 }
 
@@ -264,77 +345,260 @@ GPUShaderCache::CacheIndexKey GPUShaderCache::GetCacheKey(GPUShaderStage stage,
   return key;
 }
 
+std::span<const u8> GPUShaderCache::ReadCompressedData(const CacheIndexData& data, DynamicHeapArray<u8>& buffer)
+{
+  if ((static_cast<size_t>(data.file_offset) + data.compressed_size) <= m_blob_mapping.size())
+    return m_blob_mapping.cspan().subspan(data.file_offset, data.compressed_size);
+
+  std::unique_lock lock(m_file_mutex);
+  buffer.resize(data.compressed_size);
+  if (!m_blob_file || std::fseek(m_blob_file, data.file_offset, SEEK_SET) != 0 ||
+      std::fread(buffer.data(), data.compressed_size, 1, m_blob_file) != 1) [[unlikely]]
+  {
+    return {};
+  }
+
+  return buffer.cspan();
+}
+
 std::optional<GPUShaderCache::ShaderBinary> GPUShaderCache::Lookup(const CacheIndexKey& key)
 {
   std::optional<ShaderBinary> ret;
 
-  auto iter = m_index.find(key);
-  if (iter != m_index.end())
+  CacheIndexData data;
   {
-    DynamicHeapArray<u8> compressed_data(iter->second.compressed_size);
+    std::unique_lock lock(m_mutex);
 
-    if (std::fseek(m_blob_file, iter->second.file_offset, SEEK_SET) != 0 ||
-        std::fread(compressed_data.data(), iter->second.compressed_size, 1, m_blob_file) != 1) [[unlikely]]
-    {
-      ERROR_LOG("Read {} byte {} shader from file failed", iter->second.compressed_size,
-                GPUShader::GetStageName(static_cast<GPUShaderStage>(key.shader_type)));
-    }
-    else
+    // binaries which haven't been written yet are still in the queue
+    for (const PendingWrite& pw : m_pending_writes)
     {
-      Error error;
-      ret = CompressHelpers::DecompressBuffer(CompressHelpers::CompressType::Zstandard,
-                                              CompressHelpers::OptionalByteBuffer(std::move(compressed_data)),
-                                              iter->second.uncompressed_size, &error);
-      if (!ret.has_value()) [[unlikely]]
-        ERROR_LOG("Failed to decompress shader: {}", error.GetDescription());
+      if (pw.key == key)
+      {
+        ret = pw.binary;
+        return ret;
+      }
     }
+
+    auto iter = m_index.find(key);
+    if (iter == m_index.end())
+      return ret;
+
+    iter->second.used = true;
+    data = iter->second;
   }
 
+  DynamicHeapArray<u8> buffer;
+  const std::span<const u8> compressed_data = ReadCompressedData(data, buffer);
+  if (compressed_data.empty()) [[unlikely]]
+  {
+    ERROR_LOG("Read {} byte {} shader from file failed", data.compressed_size,
+              GPUShader::GetStageName(static_cast<GPUShaderStage>(key.shader_type)));
+    return ret;
+  }
+
+  Error error;
+  ret = CompressHelpers::DecompressBuffer(CompressHelpers::CompressType::Zstandard, compressed_data,
+                                          data.uncompressed_size, &error);
+  if (!ret.has_value()) [[unlikely]]
+    ERROR_LOG("Failed to decompress shader: {}", error.GetDescription());
+
   return ret;
 }
 
-bool GPUShaderCache::Insert(const CacheIndexKey& key, const void* data, u32 data_size)
+bool GPUShaderCache::Insert(const CacheIndexKey& key, ShaderBinary binary)
+{
+  std::unique_lock lock(m_mutex);
+  if (!m_blob_file || m_read_only || m_write_failed)
+    return false;
+
+  m_pending_writes.push_back(PendingWrite{key, std::move(binary)});
+  if (!m_writer_thread.joinable())
+    m_writer_thread = std::thread(&GPUShaderCache::WriterThreadEntryPoint, this);
+  else
+    m_writer_cv.notify_one();
+
+  return true;
+}
+
+void GPUShaderCache::Remove(const CacheIndexKey& key)
+{
+  std::unique_lock lock(m_mutex);
+  m_index.erase(key);
+  UpdateMemoryAccounting();
+}
+
+void GPUShaderCache::StopWriterThread()
+{
+  if (!m_writer_thread.joinable())
+    return;
+
+  {
+    std::unique_lock lock(m_mutex);
+    m_writer_shutdown = true;
+    m_writer_cv.notify_one();
+  }
+
+  m_writer_thread.join();
+  m_writer_shutdown = false;
+}
+
+void GPUShaderCache::WriterThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Shader Cache Writer");
+
+  std::unique_lock lock(m_mutex);
+  for (;;)
+  {
+    m_writer_cv.wait(lock, [this]() { return (m_writer_shutdown || !m_pending_writes.empty()); });
+
+    // everything queued gets written before shutting down
+    if (m_pending_writes.empty())
+      break;
+
+    // the entry stays in the queue until it's in the index, so lookups keep finding it
+    const PendingWrite& pw = m_pending_writes.front();
+    lock.unlock();
+    const bool result = WriteEntry(pw.key, pw.binary);
+    lock.lock();
+
+    if (!result) [[unlikely]]
+    {
+      // the next insert will fail, which closes the cache
+      m_write_failed = true;
+      m_pending_writes.clear();
+      continue;
+    }
+
+    m_pending_writes.pop_front();
+  }
+}
+
+bool GPUShaderCache::WriteEntry(const CacheIndexKey& key, const ShaderBinary& binary)
 {
   Error error;
   CompressHelpers::OptionalByteBuffer compress_buffer =
-    CompressHelpers::CompressToBuffer(CompressHelpers::CompressType::Zstandard, data, data_size, -1, &error);
+    CompressHelpers::CompressToBuffer(CompressHelpers::CompressType::Zstandard, binary.cspan(), -1, &error);
   if (!compress_buffer.has_value()) [[unlikely]]
   {
     ERROR_LOG("Failed to compress shader: {}", error.GetDescription());
     return false;
   }
 
-  if (!m_blob_file || std::fseek(m_blob_file, 0, SEEK_END) != 0)
-    return false;
-
-  CacheIndexData idata;
-  idata.file_offset = static_cast<u32>(std::ftell(m_blob_file));
-  idata.compressed_size = static_cast<u32>(compress_buffer->size());
-  idata.uncompressed_size = data_size;
+  // the blob file is only shared with lookups which aren't covered by the mapping
+  CacheIndexData data;
+  {
+    std::unique_lock lock(m_file_mutex);
+    if (std::fseek(m_blob_file, 0, SEEK_END) != 0)
+      return false;
 
-  CacheIndexEntry entry = {};
-  entry.shader_type = static_cast<u8>(key.shader_type);
-  entry.shader_language = static_cast<u8>(key.shader_language);
-  entry.source_length = key.source_length;
-  entry.source_hash_low = key.source_hash_low;
-  entry.source_hash_high = key.source_hash_high;
-  entry.entry_point_low = key.entry_point_low;
-  entry.entry_point_high = key.entry_point_high;
-  entry.file_offset = idata.file_offset;
-  entry.compressed_size = idata.compressed_size;
-  entry.uncompressed_size = idata.uncompressed_size;
+    data.file_offset = static_cast<u32>(std::ftell(m_blob_file));
+    data.compressed_size = static_cast<u32>(compress_buffer->size());
+    data.uncompressed_size = static_cast<u32>(binary.size());
+    data.used = true;
 
-  if (std::fwrite(compress_buffer->data(), compress_buffer->size(), 1, m_blob_file) != 1 ||
-      std::fflush(m_blob_file) != 0 || std::fwrite(&entry, sizeof(entry), 1, m_index_file) != 1 ||
-      std::fflush(m_index_file) != 0) [[unlikely]]
-  {
-    ERROR_LOG("Failed to write {} byte {} shader blob to file", data_size,
-              GPUShader::GetStageName(static_cast<GPUShaderStage>(key.shader_type)));
-    return false;
+    const CacheIndexEntry entry = MakeIndexEntry(key, data.file_offset, data.compressed_size, data.uncompressed_size);
+    if (std::fwrite(compress_buffer->data(), compress_buffer->size(), 1, m_blob_file) != 1 ||
+        std::fflush(m_blob_file) != 0 || std::fwrite(&entry, sizeof(entry), 1, m_index_file) != 1 ||
+        std::fflush(m_index_file) != 0) [[unlikely]]
+    {
+      ERROR_LOG("Failed to write {} byte {} shader blob to file", binary.size(),
+                GPUShader::GetStageName(static_cast<GPUShaderStage>(key.shader_type)));
+      return false;
+    }
   }
 
   DEV_LOG("Cached compressed {} shader: {} -> {} bytes",
-          GPUShader::GetStageName(static_cast<GPUShaderStage>(key.shader_type)), data_size, compress_buffer->size());
-  m_index.emplace(key, idata);
+          GPUShader::GetStageName(static_cast<GPUShaderStage>(key.shader_type)), binary.size(),
+          compress_buffer->size());
+
+  std::unique_lock lock(m_mutex);
+  m_index.insert_or_assign(key, data);
+  m_blob_file_size = data.file_offset + data.compressed_size;
+  UpdateMemoryAccounting();
   return true;
 }
+
+void GPUShaderCache::Compact(bool drop_unused)
+{
+  std::vector<std::pair<CacheIndexKey, CacheIndexData>> entries;
+  entries.reserve(m_index.size());
+  for (const auto& [key, data] : m_index)
+  {
+    if (!drop_unused || data.used)
+      entries.emplace_back(key, data);
+  }
+
+  // keep the file order, so the old blob is read sequentially
+  std::sort(entries.begin(), entries.end(),
+            [](const auto& lhs, const auto& rhs) { return (lhs.second.file_offset < rhs.second.file_offset); });
+
+  const std::string index_filename = fmt::format("{}.idx", m_base_filename);
+  const std::string blob_filename = fmt::format("{}.bin", m_base_filename);
+  const std::string new_index_filename = fmt::format("{}.idx.tmp", m_base_filename);
+  const std::string new_blob_filename = fmt::format("{}.bin.tmp", m_base_filename);
+
+  Error error;
+  FileSystem::ManagedCFilePtr new_index_file = FileSystem::OpenManagedCFile(new_index_filename.c_str(), "wb", &error);
+  FileSystem::ManagedCFilePtr new_blob_file =
+    new_index_file ? FileSystem::OpenManagedCFile(new_blob_filename.c_str(), "wb", &error) : nullptr;
+  if (!new_blob_file)
+  {
+    ERROR_LOG("Failed to open files for compacting shader cache: {}", error.GetDescription());
+    new_index_file.reset();
+    FileSystem::DeleteFile(new_index_filename.c_str());
+    return;
+  }
+
+  const CacheFileHeader file_header = {
+    .signature = EXPECTED_SIGNATURE, .render_api_version = m_render_api_version, .cache_version = m_version};
+  bool result = (std::fwrite(&file_header, sizeof(file_header), 1, new_index_file.get()) == 1);
+
+  DynamicHeapArray<u8> buffer;
+  u32 new_blob_size = 0;
+  for (const auto& [key, data] : entries)
+  {
+    if (!result)
+      break;
+
+    const std::span<const u8> compressed_data = ReadCompressedData(data, buffer);
+    const CacheIndexEntry entry = MakeIndexEntry(key, new_blob_size, data.compressed_size, data.uncompressed_size);
+    result = (!compressed_data.empty() &&
+              std::fwrite(compressed_data.data(), compressed_data.size(), 1, new_blob_file.get()) == 1 &&
+              std::fwrite(&entry, sizeof(entry), 1, new_index_file.get()) == 1);
+    new_blob_size += data.compressed_size;
+  }
+
+  result = (result && std::fflush(new_index_file.get()) == 0 && std::fflush(new_blob_file.get()) == 0);
+  new_index_file.reset();
+  new_blob_file.reset();
+
+  const u32 old_blob_size = m_blob_file_size;
+  if (result)
+  {
+    // the old files have to be closed and unmapped before they can be replaced
+    CloseFiles();
+
+    if (!FileSystem::RenamePath(new_blob_filename.c_str(), blob_filename.c_str(), &error) ||
+        !FileSystem::RenamePath(new_index_filename.c_str(), index_filename.c_str(), &error))
+    {
+      // a half-replaced cache can't be used, so start from scratch next time
+      ERROR_LOG("Failed to replace shader cache files: {}", error.GetDescription());
+      FileSystem::DeleteFile(index_filename.c_str());
+      FileSystem::DeleteFile(blob_filename.c_str());
+      result = false;
+    }
+  }
+  else
+  {
+    ERROR_LOG("Failed to write compacted shader cache.");
+  }
+
+  FileSystem::DeleteFile(new_index_filename.c_str());
+  FileSystem::DeleteFile(new_blob_filename.c_str());
+
+  if (result)
+  {
+    INFO_LOG("Compacted shader cache '{}' from {} to {} bytes ({} entries).", Path::GetFileName(m_base_filename),
+             old_blob_size, new_blob_size, entries.size());
+  }
+}
@@ -3,19 +3,28 @@
 
 #pragma once
 
+#include "common/file_system.h"
 #include "common/hash_combine.h"
 #include "common/heap_array.h"
 #include "common/types.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 enum class GPUShaderStage : u8;
 enum class GPUShaderLanguage : u8;
 
+/// Index of compiled shader binaries, keyed by source hash. Binaries for entries that existed when the cache was
+/// opened are decompressed straight out of a mapping of the blob file, new entries are compressed and appended by a
+/// background thread so that compiling never waits on the disk. Safe to use from multiple threads.
 class GPUShaderCache
 {
 public:
@@ -50,7 +59,9 @@ public:
 
   bool IsOpen() const { return (m_index_file != nullptr); }
 
-  bool Open(std::string_view base_filename, u32 render_api_version, u32 cache_version);
+  /// Read-only caches are never written to or compacted, and are used for the shader package shipped with release
+  /// builds. A render API version of zero accepts a cache written for any version.
+  bool Open(std::string_view base_filename, u32 render_api_version, u32 cache_version, bool read_only = false);
   bool Create();
   void Close();
 
@@ -58,7 +69,13 @@ public:
                                    std::string_view entry_point);
 
   std::optional<ShaderBinary> Lookup(const CacheIndexKey& key);
-  bool Insert(const CacheIndexKey& key, const void* data, u32 data_size);
+
+  /// Queues a binary to be written. Returns false if an earlier write failed, and the cache should be closed.
+  bool Insert(const CacheIndexKey& key, ShaderBinary binary);
+
+  /// Drops an entry which could not be used, e.g. because the driver changed. The space is reclaimed on compaction.
+  void Remove(const CacheIndexKey& key);
+
   void Clear();
 
 private:
@@ -67,12 +84,28 @@ private:
     u32 file_offset;
     u32 compressed_size;
     u32 uncompressed_size;
+    bool used;
+  };
+
+  struct PendingWrite
+  {
+    CacheIndexKey key;
+    ShaderBinary binary;
   };
 
   using CacheIndex = std::unordered_map<CacheIndexKey, CacheIndexData, CacheIndexEntryHash>;
 
   bool CreateNew(const std::string& index_filename, const std::string& blob_filename);
-  bool ReadExisting(const std::string& index_filename, const std::string& blob_filename);
+  bool ReadExisting(const std::string& index_filename, const std::string& blob_filename, bool read_only);
+  void CloseFiles();
+  void UpdateMemoryAccounting();
+
+  void WriterThreadEntryPoint();
+  bool WriteEntry(const CacheIndexKey& key, const ShaderBinary& binary);
+  void StopWriterThread();
+
+  std::span<const u8> ReadCompressedData(const CacheIndexData& data, DynamicHeapArray<u8>& buffer);
+  void Compact(bool drop_unused);
 
   CacheIndex m_index;
 
@@ -82,4 +115,18 @@ private:
 
   std::FILE* m_index_file = nullptr;
   std::FILE* m_blob_file = nullptr;
+  FileSystem::MappedFile m_blob_mapping;
+  u32 m_blob_file_size = 0;
+
+  // Protects the index and write queue. File access has its own lock, so queueing doesn't wait on writes.
+  std::mutex m_mutex;
+  std::mutex m_file_mutex;
+  std::condition_variable m_writer_cv;
+  std::deque<PendingWrite> m_pending_writes;
+  std::thread m_writer_thread;
+  bool m_writer_shutdown = false;
+  bool m_write_failed = false;
+  bool m_read_only = false;
+
+  size_t m_accounted_memory = 0;
 };
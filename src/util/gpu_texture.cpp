@@ -9,6 +9,7 @@
 #include "common/assert.h"
 #include "common/bitutils.h"
 #include "common/error.h"
+#include "common/memory_accounting.h"
 #include "common/string_util.h"
 
 GPUTexture::GPUTexture(u16 width, u16 height, u8 layers, u8 levels, u8 samples, Type type, GPUTextureFormat format,
@@ -17,11 +18,13 @@ GPUTexture::GPUTexture(u16 width, u16 height, u8 layers, u8 levels, u8 samples,
     m_format(format), m_flags(flags)
 {
   GPUDevice::s_total_vram_usage += GetVRAMUsage();
+  MemoryAccounting::Add(MemoryAccounting::Category::GPUTextures, 0, static_cast<s64>(GetVRAMUsage()));
 }
 
 GPUTexture::~GPUTexture()
 {
   GPUDevice::s_total_vram_usage -= GetVRAMUsage();
+  MemoryAccounting::Add(MemoryAccounting::Category::GPUTextures, 0, -static_cast<s64>(GetVRAMUsage()));
 }
 
 const char* GPUTexture::GetFormatName(GPUTextureFormat format)
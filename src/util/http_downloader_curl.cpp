@@ -20,6 +20,9 @@
 
 LOG_CHANNEL(HTTPDownloader);
 
+// Requests to the same host share connections, and are multiplexed over one connection with HTTP/2.
+static constexpr long MAX_CONNECTIONS_PER_HOST = 4;
+
 namespace {
 class HTTPDownloaderCurl final : public HTTPDownloader
 {
@@ -131,6 +134,9 @@ bool HTTPDownloaderCurl::Initialize(std::string user_agent, Error* error)
     return false;
   }
 
+  curl_multi_setopt(m_multi_handle, CURLMOPT_PIPELINING, static_cast<long>(CURLPIPE_MULTIPLEX));
+  curl_multi_setopt(m_multi_handle, CURLMOPT_MAX_HOST_CONNECTIONS, MAX_CONNECTIONS_PER_HOST);
+
   m_user_agent = std::move(user_agent);
 
   // Start the worker thread
@@ -141,21 +147,21 @@ bool HTTPDownloaderCurl::Initialize(std::string user_agent, Error* error)
 size_t HTTPDownloaderCurl::WriteCallback(char* ptr, size_t size, size_t nmemb, void* userdata)
 {
   Request* req = static_cast<Request*>(userdata);
-  const size_t current_size = req->data.size();
-  const size_t transfer_size = size * nmemb;
-  const size_t new_size = current_size + transfer_size;
-  req->data.resize(new_size);
-  req->start_time = Timer::GetCurrentValue();
-  std::memcpy(&req->data[current_size], ptr, transfer_size);
-
   if (req->content_length == 0)
   {
+    // allocate the whole response up front, instead of growing it for every chunk
     curl_off_t length;
-    if (curl_easy_getinfo(req->handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length) == CURLE_OK)
+    if (curl_easy_getinfo(req->handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length) == CURLE_OK && length > 0)
+    {
       req->content_length = static_cast<u32>(length);
+      req->data.reserve(req->content_length);
+    }
   }
 
-  return nmemb;
+  const size_t transfer_size = size * nmemb;
+  req->data.insert(req->data.end(), reinterpret_cast<const u8*>(ptr), reinterpret_cast<const u8*>(ptr) + transfer_size);
+  req->start_time = Timer::GetCurrentValue();
+  return transfer_size;
 }
 
 HTTPDownloader::Request* HTTPDownloaderCurl::InternalCreateRequest()
@@ -290,6 +296,11 @@ bool HTTPDownloaderCurl::StartRequest(HTTPDownloader::Request* request)
   curl_easy_setopt(req->handle, CURLOPT_NOSIGNAL, 1L);
   curl_easy_setopt(req->handle, CURLOPT_PRIVATE, req);
   curl_easy_setopt(req->handle, CURLOPT_FOLLOWLOCATION, 1L);
+  curl_easy_setopt(req->handle, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
+  curl_easy_setopt(req->handle, CURLOPT_ACCEPT_ENCODING, "");
+
+  // wait for an existing connection to the host to be multiplexed, rather than opening another
+  curl_easy_setopt(req->handle, CURLOPT_PIPEWAIT, 1L);
 
   if (request->type == Request::Type::Post)
   {
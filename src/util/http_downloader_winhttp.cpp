@@ -80,6 +80,11 @@ bool HTTPDownloaderWinHttp::Initialize(std::string user_agent, Error* error)
     return false;
   }
 
+  // Requires Windows 10 1607, older versions stay on HTTP/1.1.
+  DWORD protocol_flags = WINHTTP_PROTOCOL_FLAG_HTTP2;
+  if (!WinHttpSetOption(m_hSession, WINHTTP_OPTION_ENABLE_HTTP_PROTOCOL, &protocol_flags, sizeof(protocol_flags)))
+    DEV_LOG("HTTP/2 is not available: {}", GetLastError());
+
   const DWORD notification_flags = WINHTTP_CALLBACK_FLAG_ALL_COMPLETIONS | WINHTTP_CALLBACK_FLAG_REQUEST_ERROR |
                                    WINHTTP_CALLBACK_FLAG_HANDLES | WINHTTP_CALLBACK_FLAG_SECURE_FAILURE;
   if (WinHttpSetStatusCallback(m_hSession, HTTPStatusCallback, notification_flags, NULL) ==
@@ -16,12 +16,20 @@
 #include "common/path.h"
 #include "common/scoped_guard.h"
 #include "common/string_util.h"
+#include "common/task_queue.h"
 
 #include <jpeglib.h>
 #include <plutosvg.h>
 #include <png.h>
 #include <webp/decode.h>
 #include <webp/encode.h>
+#include <zlib.h>
+
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 // clang-format off
 #ifdef _MSC_VER
@@ -79,6 +87,20 @@ static const FormatHandler* GetFormatHandler(std::string_view extension)
   return nullptr;
 }
 
+/// Shared by batch saves, parallel PNG encoding and block decompression. Nested waits run queued tasks on the waiting
+/// thread, so encodes started from a batch can split themselves up further without deadlocking.
+static constexpr u32 MAX_ENCODE_THREADS = 8;
+
+static TaskQueue& GetEncodeQueue()
+{
+  static TaskQueue queue;
+  static std::once_flag queue_once;
+  std::call_once(queue_once, []() {
+    queue.SetWorkerCount(std::clamp(std::thread::hardware_concurrency(), 1u, MAX_ENCODE_THREADS));
+  });
+  return queue;
+}
+
 static void SwapBGRAToRGBA(void* RESTRICT pixels_out, u32 pixels_out_pitch, const void* RESTRICT pixels_in,
                            u32 pixels_in_pitch, u32 width, u32 height);
 
@@ -448,6 +470,26 @@ bool Image::SaveToFile(std::string_view filename, std::FILE* fp, u8 quality /* =
   return true;
 }
 
+u32 Image::SaveToFiles(std::span<const FileSaveRequest> requests)
+{
+  TaskQueue& queue = GetEncodeQueue();
+  TaskQueue::Group group;
+  std::atomic<u32> saved{0};
+
+  for (const FileSaveRequest& request : requests)
+  {
+    queue.SubmitTask(
+      [&request, &saved]() {
+        if (request.image->SaveToFile(request.filename, request.quality, request.error))
+          saved.fetch_add(1, std::memory_order_relaxed);
+      },
+      TaskQueue::Priority::Interactive, &group);
+  }
+
+  queue.WaitForAll(group);
+  return saved.load(std::memory_order_relaxed);
+}
+
 std::optional<DynamicHeapArray<u8>> Image::SaveToBuffer(std::string_view filename,
                                                         u8 quality /* = DEFAULT_SAVE_QUALITY */,
                                                         Error* error /* = nullptr */) const
@@ -510,64 +552,215 @@ void SwapBGRAToRGBA(void* pixels_out, u32 pixels_out_pitch, const void* pixels_i
   }
 }
 
+namespace {
+constexpr u32 BC_BLOCK_SIZE = 4;
+constexpr u32 BC_BLOCK_PIXELS = BC_BLOCK_SIZE * BC_BLOCK_SIZE;
+
+/// Images with fewer blocks than this are decoded on the calling thread, it's not worth splitting them up.
+constexpr u32 MIN_BLOCKS_PER_DECODE_TASK = 4096;
+
+#ifdef CPU_ARCH_SIMD
+
+/// Byte shuffles which look up a row of four 2-bit colour indices in a palette of four RGBA8 colours.
+alignas(16) constexpr auto s_bc_color_row_shuffles = []() {
+  std::array<std::array<u8, 16>, 256> ret = {};
+  for (u32 indices = 0; indices < 256; indices++)
+  {
+    for (u32 i = 0; i < 4; i++)
+    {
+      for (u32 byte = 0; byte < 4; byte++)
+        ret[indices][i * 4 + byte] = static_cast<u8>((((indices >> (i * 2)) & 3) * 4) + byte);
+    }
+  }
+  return ret;
+}();
+
+#endif
+
+} // namespace
+
+ALWAYS_INLINE static u32 PackBCColor(u32 r, u32 g, u32 b, u32 a)
+{
+  return r | (g << 8) | (b << 16) | (a << 24);
+}
+
+/// Expands the two RGB565 endpoints of a colour block, and interpolates the other two palette entries.
+static void DecodeBCColorPalette(const u8* block, bool allow_punchthrough, u32* palette)
+{
+  u16 color0, color1;
+  std::memcpy(&color0, block, sizeof(color0));
+  std::memcpy(&color1, block + 2, sizeof(color1));
+
+  // Rounds the same way as the reference decoder.
+  static constexpr auto expand5 = [](u32 v) { const u32 t = v * 255 + 16; return ((t / 32) + t) / 32; };
+  static constexpr auto expand6 = [](u32 v) { const u32 t = v * 255 + 32; return ((t / 64) + t) / 64; };
+  const u32 r0 = expand5(color0 >> 11), g0 = expand6((color0 >> 5) & 0x3F), b0 = expand5(color0 & 0x1F);
+  const u32 r1 = expand5(color1 >> 11), g1 = expand6((color1 >> 5) & 0x3F), b1 = expand5(color1 & 0x1F);
+
+  palette[0] = PackBCColor(r0, g0, b0, 255);
+  palette[1] = PackBCColor(r1, g1, b1, 255);
+  if (!allow_punchthrough || color0 > color1)
+  {
+    palette[2] = PackBCColor((2 * r0 + r1) / 3, (2 * g0 + g1) / 3, (2 * b0 + b1) / 3, 255);
+    palette[3] = PackBCColor((r0 + 2 * r1) / 3, (g0 + 2 * g1) / 3, (b0 + 2 * b1) / 3, 255);
+  }
+  else
+  {
+    // Index 3 is transparent black in three-colour mode, same as GPUs sample it.
+    palette[2] = PackBCColor((r0 + r1) / 2, (g0 + g1) / 2, (b0 + b1) / 2, 255);
+    palette[3] = 0;
+  }
+}
+
+/// Decodes the colour half of a BC1/2/3 block. If alpha is provided, it replaces the palette's alpha.
+static void DecodeBCColorBlock(const u8* block, bool allow_punchthrough, const u8* alpha, u32* pixels)
+{
+  alignas(16) u32 palette[4];
+  DecodeBCColorPalette(block, allow_punchthrough, palette);
+
+  u32 indices;
+  std::memcpy(&indices, block + 4, sizeof(indices));
+
+#ifdef CPU_ARCH_SIMD
+  const GSVector4i vpalette = GSVector4i::load<true>(palette);
+  for (u32 row = 0; row < BC_BLOCK_SIZE; row++)
+  {
+    const u32 row_indices = (indices >> (row * 8)) & 0xFF;
+    GSVector4i vrow = vpalette.shuffle8(GSVector4i::load<true>(s_bc_color_row_shuffles[row_indices].data()));
+    if (alpha)
+    {
+      const GSVector4i valpha = GSVector4i::load32(&alpha[row * BC_BLOCK_SIZE]).u8to32().sll32<24>();
+      vrow = (vrow & GSVector4i::cxpr(0x00FFFFFF)) | valpha;
+    }
+
+    GSVector4i::store<false>(&pixels[row * BC_BLOCK_SIZE], vrow);
+  }
+#else
+  for (u32 i = 0; i < BC_BLOCK_PIXELS; i++)
+  {
+    const u32 color = palette[(indices >> (i * 2)) & 3];
+    pixels[i] = alpha ? ((color & 0x00FFFFFFu) | (ZeroExtend32(alpha[i]) << 24)) : color;
+  }
+#endif
+}
+
+/// Decodes the interpolated alpha half of a BC3 block.
+static void DecodeBC3AlphaBlock(const u8* block, u8* alpha)
+{
+  const u32 alpha0 = block[0];
+  const u32 alpha1 = block[1];
+
+  u8 palette[8];
+  palette[0] = static_cast<u8>(alpha0);
+  palette[1] = static_cast<u8>(alpha1);
+  if (alpha0 > alpha1)
+  {
+    for (u32 i = 2; i < 8; i++)
+      palette[i] = static_cast<u8>(((8 - i) * alpha0 + (i - 1) * alpha1) / 7);
+  }
+  else
+  {
+    for (u32 i = 2; i < 6; i++)
+      palette[i] = static_cast<u8>(((6 - i) * alpha0 + (i - 1) * alpha1) / 5);
+    palette[6] = 0;
+    palette[7] = 255;
+  }
+
+  // 48 bits of 3-bit indices, handled as two halves of 24 bits.
+  for (u32 half = 0; half < 2; half++)
+  {
+    const u8* src = block + 2 + (half * 3);
+    const u32 indices = ZeroExtend32(src[0]) | (ZeroExtend32(src[1]) << 8) | (ZeroExtend32(src[2]) << 16);
+    for (u32 i = 0; i < 8; i++)
+      alpha[half * 8 + i] = palette[(indices >> (i * 3)) & 7];
+  }
+}
+
 template<ImageFormat format>
-static void DecompressBC(void* RESTRICT pixels_out, u32 pixels_out_pitch, const void* RESTRICT pixels_in,
-                         u32 pixels_in_pitch, u32 width, u32 height)
+static void DecodeBCBlock(const u8* block, u32* pixels)
 {
-  constexpr u32 BC_BLOCK_SIZE = 4;
-  constexpr u32 BC_BLOCK_BYTES = 16;
+  if constexpr (format == ImageFormat::BC1)
+  {
+    DecodeBCColorBlock(block, true, nullptr, pixels);
+  }
+  else if constexpr (format == ImageFormat::BC2)
+  {
+    alignas(16) u8 alpha[BC_BLOCK_PIXELS];
+    for (u32 i = 0; i < BC_BLOCK_PIXELS; i++)
+      alpha[i] = static_cast<u8>(((block[i / 2] >> ((i & 1) * 4)) & 0xF) * 17);
+    DecodeBCColorBlock(block + 8, false, alpha, pixels);
+  }
+  else if constexpr (format == ImageFormat::BC3)
+  {
+    alignas(16) u8 alpha[BC_BLOCK_PIXELS];
+    DecodeBC3AlphaBlock(block, alpha);
+    DecodeBCColorBlock(block + 8, false, alpha, pixels);
+  }
+  else if constexpr (format == ImageFormat::BC7)
+  {
+    bc7decomp::unpack_bc7(block, reinterpret_cast<bc7decomp::color_rgba*>(pixels));
+  }
+}
 
-  const u32 blocks_wide = Common::AlignUpPow2(width, 4) / 4;
-  const u32 blocks_high = Common::AlignUpPow2(height, 4) / 4;
-  for (u32 y = 0; y < blocks_high; y++)
+template<ImageFormat format>
+static void DecompressBCRows(void* RESTRICT pixels_out, u32 pixels_out_pitch, const void* RESTRICT pixels_in,
+                             u32 pixels_in_pitch, u32 width, u32 height, u32 start_block_row, u32 end_block_row)
+{
+  constexpr u32 BC_BLOCK_BYTES = (format == ImageFormat::BC1) ? 8 : 16;
+
+  const u32 blocks_wide = Common::AlignUpPow2(width, BC_BLOCK_SIZE) / BC_BLOCK_SIZE;
+  for (u32 y = start_block_row; y < end_block_row; y++)
   {
     const u8* block_in = static_cast<const u8*>(pixels_in) + (y * pixels_in_pitch);
+    u8* row_out = static_cast<u8*>(pixels_out) + (y * BC_BLOCK_SIZE * pixels_out_pitch);
+    const u32 rows = std::min(height - (y * BC_BLOCK_SIZE), BC_BLOCK_SIZE);
     for (u32 x = 0; x < blocks_wide; x++, block_in += BC_BLOCK_BYTES)
     {
-      // decompress block
-      switch (format)
-      {
-        case ImageFormat::BC1:
-        {
-          DecompressBlockBC1(x * BC_BLOCK_SIZE, y * BC_BLOCK_SIZE, pixels_out_pitch, block_in,
-                             static_cast<unsigned char*>(pixels_out));
-        }
-        break;
-        case ImageFormat::BC2:
-        {
-          DecompressBlockBC2(x * BC_BLOCK_SIZE, y * BC_BLOCK_SIZE, pixels_out_pitch, block_in,
-                             static_cast<unsigned char*>(pixels_out));
-        }
-        break;
-        case ImageFormat::BC3:
-        {
-          DecompressBlockBC3(x * BC_BLOCK_SIZE, y * BC_BLOCK_SIZE, pixels_out_pitch, block_in,
-                             static_cast<unsigned char*>(pixels_out));
-        }
-        break;
+      alignas(16) u32 block_pixels[BC_BLOCK_PIXELS];
+      DecodeBCBlock<format>(block_in, block_pixels);
 
-        case ImageFormat::BC7:
-        {
-          u32 block_pixels_out[BC_BLOCK_SIZE * BC_BLOCK_SIZE];
-          bc7decomp::unpack_bc7(block_in, reinterpret_cast<bc7decomp::color_rgba*>(block_pixels_out));
-
-          // and write it to the new image
-          const u32* RESTRICT copy_in_ptr = block_pixels_out;
-          u8* RESTRICT copy_out_ptr =
-            static_cast<u8*>(pixels_out) + (y * BC_BLOCK_SIZE * pixels_out_pitch) + (x * BC_BLOCK_SIZE * sizeof(u32));
-          for (u32 sy = 0; sy < 4; sy++)
-          {
-            std::memcpy(copy_out_ptr, copy_in_ptr, sizeof(u32) * BC_BLOCK_SIZE);
-            copy_in_ptr += BC_BLOCK_SIZE;
-            copy_out_ptr += pixels_out_pitch;
-          }
-        }
-        break;
+      // edge blocks only partially cover the image
+      const u32 columns = std::min(width - (x * BC_BLOCK_SIZE), BC_BLOCK_SIZE);
+      u8* RESTRICT copy_out_ptr = row_out + (x * BC_BLOCK_SIZE * sizeof(u32));
+      for (u32 sy = 0; sy < rows; sy++)
+      {
+        std::memcpy(copy_out_ptr, &block_pixels[sy * BC_BLOCK_SIZE], sizeof(u32) * columns);
+        copy_out_ptr += pixels_out_pitch;
       }
     }
   }
 }
 
+template<ImageFormat format>
+static void DecompressBC(void* RESTRICT pixels_out, u32 pixels_out_pitch, const void* RESTRICT pixels_in,
+                         u32 pixels_in_pitch, u32 width, u32 height)
+{
+  const u32 blocks_wide = Common::AlignUpPow2(width, BC_BLOCK_SIZE) / BC_BLOCK_SIZE;
+  const u32 blocks_high = Common::AlignUpPow2(height, BC_BLOCK_SIZE) / BC_BLOCK_SIZE;
+  const u32 rows_per_task = std::max(MIN_BLOCKS_PER_DECODE_TASK / std::max(blocks_wide, 1u), 1u);
+  if (blocks_high <= rows_per_task)
+  {
+    DecompressBCRows<format>(pixels_out, pixels_out_pitch, pixels_in, pixels_in_pitch, width, height, 0, blocks_high);
+    return;
+  }
+
+  // Block rows are independent, so large images get split across the encode workers.
+  TaskQueue& queue = GetEncodeQueue();
+  TaskQueue::Group group;
+  for (u32 start_row = 0; start_row < blocks_high; start_row += rows_per_task)
+  {
+    const u32 end_row = std::min(start_row + rows_per_task, blocks_high);
+    queue.SubmitTask(
+      [=]() {
+        DecompressBCRows<format>(pixels_out, pixels_out_pitch, pixels_in, pixels_in_pitch, width, height, start_row,
+                                 end_row);
+      },
+      TaskQueue::Priority::Interactive, &group);
+  }
+
+  queue.WaitForAll(group);
+}
+
 std::optional<Image> Image::ConvertToRGBA8(Error* error) const
 {
   std::optional<Image> ret;
@@ -999,7 +1192,11 @@ bool PNGBufferLoader(Image* image, std::span<const u8> data, Error* error)
 
 static void PNGSaveCommon(const Image& image, png_structp png_ptr, png_infop info_ptr, u8 quality)
 {
-  png_set_compression_level(png_ptr, std::clamp(quality / 10, 0, 9));
+  // At low levels the adaptive filter heuristic costs more time than it saves space, so use a fixed filter.
+  const int level = std::clamp(quality / 10, 0, 9);
+  png_set_compression_level(png_ptr, level);
+  if (level <= 3)
+    png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_SUB);
   png_set_IHDR(png_ptr, info_ptr, image.GetWidth(), image.GetHeight(), 8, PNG_COLOR_TYPE_RGBA, PNG_INTERLACE_NONE,
                PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
   png_write_info(png_ptr, info_ptr);
@@ -1010,8 +1207,309 @@ static void PNGSaveCommon(const Image& image, png_structp png_ptr, png_infop inf
   png_write_end(png_ptr, nullptr);
 }
 
+// Images are split into strips of roughly this much filtered data, which are filtered and deflated on the encode
+// queue. Anything that fits in a single strip goes through libpng instead.
+static constexpr size_t PNG_PARALLEL_STRIP_SIZE = 256 * 1024;
+static constexpr u32 PNG_PARALLEL_MAX_STRIPS = 64;
+static constexpr u32 PNG_DEFLATE_WINDOW_SIZE = 32768;
+static constexpr u32 PNG_BYTES_PER_PIXEL = 4;
+
+static u32 PNGGetStripRows(const Image& image)
+{
+  const size_t filtered_pitch = image.GetWidth() * PNG_BYTES_PER_PIXEL + 1;
+  const u32 rows = static_cast<u32>(std::max<size_t>(PNG_PARALLEL_STRIP_SIZE / filtered_pitch, 1));
+  return std::max(rows, (image.GetHeight() + PNG_PARALLEL_MAX_STRIPS - 1) / PNG_PARALLEL_MAX_STRIPS);
+}
+
+static bool PNGShouldEncodeParallel(const Image& image)
+{
+  return (image.GetHeight() > PNGGetStripRows(image));
+}
+
+ALWAYS_INLINE static u8 PNGPaethPredictor(u8 a, u8 b, u8 c)
+{
+  const int p = static_cast<int>(a) + static_cast<int>(b) - static_cast<int>(c);
+  const int pa = std::abs(p - a);
+  const int pb = std::abs(p - b);
+  const int pc = std::abs(p - c);
+  return (pa <= pb && pa <= pc) ? a : ((pb <= pc) ? b : c);
+}
+
+static void PNGFilterRow(u8* RESTRICT out, const u8* RESTRICT row, const u8* RESTRICT prev, u32 row_size, u8 filter)
+{
+  static constexpr u32 bpp = PNG_BYTES_PER_PIXEL;
+
+  *(out++) = filter;
+  switch (filter)
+  {
+    case PNG_FILTER_VALUE_NONE:
+    {
+      std::memcpy(out, row, row_size);
+    }
+    break;
+
+    case PNG_FILTER_VALUE_SUB:
+    {
+      std::memcpy(out, row, bpp);
+      for (u32 i = bpp; i < row_size; i++)
+        out[i] = row[i] - row[i - bpp];
+    }
+    break;
+
+    case PNG_FILTER_VALUE_UP:
+    {
+      for (u32 i = 0; i < row_size; i++)
+        out[i] = row[i] - prev[i];
+    }
+    break;
+
+    case PNG_FILTER_VALUE_AVG:
+    {
+      for (u32 i = 0; i < bpp; i++)
+        out[i] = row[i] - (prev[i] >> 1);
+      for (u32 i = bpp; i < row_size; i++)
+        out[i] = row[i] - static_cast<u8>((static_cast<u32>(row[i - bpp]) + prev[i]) >> 1);
+    }
+    break;
+
+    case PNG_FILTER_VALUE_PAETH:
+    {
+      for (u32 i = 0; i < bpp; i++)
+        out[i] = row[i] - prev[i];
+      for (u32 i = bpp; i < row_size; i++)
+        out[i] = row[i] - PNGPaethPredictor(row[i - bpp], prev[i], prev[i - bpp]);
+    }
+    break;
+
+      DefaultCaseIsUnreachable();
+  }
+}
+
+/// Picks the filter with the lowest sum of absolute differences for each row, the same heuristic libpng uses.
+static void PNGFilterRows(const Image& image, u32 start_row, u32 end_row, u8* out, const u8* zero_row, int level)
+{
+  const u32 row_size = image.GetWidth() * PNG_BYTES_PER_PIXEL;
+  const u32 filtered_pitch = row_size + 1;
+
+  DynamicHeapArray<u8> trial;
+  if (level > 3)
+    trial.resize(filtered_pitch);
+
+  for (u32 y = start_row; y < end_row; y++, out += filtered_pitch)
+  {
+    const u8* row = image.GetRowPixels(y);
+    const u8* prev = (y > 0) ? image.GetRowPixels(y - 1) : zero_row;
+    if (level <= 3)
+    {
+      PNGFilterRow(out, row, prev, row_size, PNG_FILTER_VALUE_SUB);
+      continue;
+    }
+
+    u64 best_cost = std::numeric_limits<u64>::max();
+    for (u8 filter = PNG_FILTER_VALUE_NONE; filter <= PNG_FILTER_VALUE_PAETH; filter++)
+    {
+      PNGFilterRow(trial.data(), row, prev, row_size, filter);
+
+      u64 cost = 0;
+      for (u32 i = 1; i < filtered_pitch; i++)
+        cost += static_cast<u32>(std::abs(static_cast<int>(static_cast<s8>(trial[i]))));
+
+      if (cost < best_cost)
+      {
+        best_cost = cost;
+        std::memcpy(out, trial.data(), filtered_pitch);
+      }
+    }
+  }
+}
+
+/// Writes a PNG with a single zlib stream, where each strip is deflated independently, primed with the end of the
+/// previous strip as a dictionary, and ended with a sync flush so the raw deflate data can simply be concatenated.
+static bool PNGEncodeParallel(const Image& image, u8 quality, DynamicHeapArray<u8>* data, Error* error)
+{
+  struct Strip
+  {
+    u32 start_row;
+    u32 end_row;
+    uLong adler;
+    DynamicHeapArray<u8> deflated;
+    const char* error;
+  };
+
+  const int level = std::clamp(quality / 10, 0, 9);
+  const u32 width = image.GetWidth();
+  const u32 height = image.GetHeight();
+  const u32 filtered_pitch = width * PNG_BYTES_PER_PIXEL + 1;
+  const u32 strip_rows = PNGGetStripRows(image);
+  const u32 num_strips = (height + strip_rows - 1) / strip_rows;
+
+  DynamicHeapArray<u8> filtered(static_cast<size_t>(filtered_pitch) * height);
+  DynamicHeapArray<u8> zero_row(width * PNG_BYTES_PER_PIXEL);
+  std::memset(zero_row.data(), 0, zero_row.size());
+
+  std::vector<Strip> strips(num_strips);
+  for (u32 i = 0; i < num_strips; i++)
+  {
+    strips[i].start_row = i * strip_rows;
+    strips[i].end_row = std::min(strips[i].start_row + strip_rows, height);
+    strips[i].error = nullptr;
+  }
+
+  TaskQueue& queue = GetEncodeQueue();
+  TaskQueue::Group group;
+
+  // Filtering needs the unfiltered previous row, so every strip can be filtered independently. Deflating needs the
+  // filtered end of the previous strip for its dictionary, so it has to wait until all the filtering is done.
+  for (Strip& strip : strips)
+  {
+    queue.SubmitTask(
+      [&image, &strip, &filtered, &zero_row, filtered_pitch, level]() {
+        const size_t offset = static_cast<size_t>(strip.start_row) * filtered_pitch;
+        PNGFilterRows(image, strip.start_row, strip.end_row, &filtered[offset], zero_row.data(), level);
+      },
+      TaskQueue::Priority::Interactive, &group);
+  }
+  queue.WaitForAll(group);
+
+  for (u32 i = 0; i < num_strips; i++)
+  {
+    queue.SubmitTask(
+      [&strip = strips[i], &filtered, filtered_pitch, level, last = (i == (num_strips - 1))]() {
+        const size_t start = static_cast<size_t>(strip.start_row) * filtered_pitch;
+        const uInt size = static_cast<uInt>((strip.end_row - strip.start_row) * filtered_pitch);
+        strip.adler = adler32(adler32(0, nullptr, 0), &filtered[start], size);
+
+        z_stream zs = {};
+        if (deflateInit2(&zs, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+          strip.error = "deflateInit2() failed.";
+          return;
+        }
+
+        ScopedGuard zs_guard([&zs]() { deflateEnd(&zs); });
+
+        if (start > 0)
+        {
+          const uInt dict_size = static_cast<uInt>(std::min<size_t>(start, PNG_DEFLATE_WINDOW_SIZE));
+          if (deflateSetDictionary(&zs, &filtered[start - dict_size], dict_size) != Z_OK)
+          {
+            strip.error = "deflateSetDictionary() failed.";
+            return;
+          }
+        }
+
+        // Leave room for the sync flush marker, which deflateBound() doesn't account for.
+        strip.deflated.resize(deflateBound(&zs, size) + 16);
+        zs.next_in = &filtered[start];
+        zs.avail_in = size;
+        zs.next_out = strip.deflated.data();
+        zs.avail_out = static_cast<uInt>(strip.deflated.size());
+
+        const int res = deflate(&zs, last ? Z_FINISH : Z_SYNC_FLUSH);
+        if ((last && res != Z_STREAM_END) || (!last && (res != Z_OK || zs.avail_in != 0 || zs.avail_out == 0)))
+        {
+          strip.error = "deflate() failed.";
+          return;
+        }
+
+        strip.deflated.resize(strip.deflated.size() - zs.avail_out);
+      },
+      TaskQueue::Priority::Interactive, &group);
+  }
+  queue.WaitForAll(group);
+
+  size_t idat_size = 2 + 4;
+  uLong adler = adler32(0, nullptr, 0);
+  for (const Strip& strip : strips)
+  {
+    if (strip.error)
+    {
+      Error::SetStringView(error, strip.error);
+      return false;
+    }
+
+    idat_size += strip.deflated.size();
+    adler = adler32_combine(adler, strip.adler, (strip.end_row - strip.start_row) * filtered_pitch);
+  }
+  if (idat_size > static_cast<size_t>(std::numeric_limits<s32>::max()))
+  {
+    Error::SetStringFmt(error, "Compressed data for {}x{} image is too large.", width, height);
+    return false;
+  }
+
+  static constexpr u8 signature[] = {0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A};
+  static constexpr size_t chunk_overhead = 4 + 4 + 4;
+  static constexpr u32 ihdr_size = 13;
+  data->resize(sizeof(signature) + (chunk_overhead + ihdr_size) + (chunk_overhead + idat_size) + chunk_overhead);
+
+  u8* ptr = data->data();
+  u8* chunk_start = nullptr;
+  const auto write = [&ptr](const void* src, size_t size) {
+    std::memcpy(ptr, src, size);
+    ptr += size;
+  };
+  const auto write_be32 = [&ptr](u32 value) {
+    const u8 bytes[4] = {static_cast<u8>(value >> 24), static_cast<u8>(value >> 16), static_cast<u8>(value >> 8),
+                         static_cast<u8>(value)};
+    std::memcpy(ptr, bytes, sizeof(bytes));
+    ptr += sizeof(bytes);
+  };
+  const auto begin_chunk = [&](const char* type, u32 size) {
+    write_be32(size);
+    chunk_start = ptr;
+    write(type, 4);
+  };
+  const auto end_chunk = [&]() {
+    write_be32(static_cast<u32>(crc32(crc32(0, nullptr, 0), chunk_start, static_cast<uInt>(ptr - chunk_start))));
+  };
+
+  write(signature, sizeof(signature));
+
+  begin_chunk("IHDR", ihdr_size);
+  write_be32(width);
+  write_be32(height);
+  static constexpr u8 ihdr_format[] = {8, PNG_COLOR_TYPE_RGBA, PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE,
+                                       PNG_INTERLACE_NONE};
+  write(ihdr_format, sizeof(ihdr_format));
+  end_chunk();
+
+  // zlib header, the level bits are only informational.
+  const u8 cmf = 0x78;
+  u8 flg = static_cast<u8>(((level < 2) ? 0 : ((level < 6) ? 1 : ((level == 6) ? 2 : 3))) << 6);
+  flg += static_cast<u8>(31 - (((cmf << 8) | flg) % 31));
+
+  begin_chunk("IDAT", static_cast<u32>(idat_size));
+  write(&cmf, sizeof(cmf));
+  write(&flg, sizeof(flg));
+  for (const Strip& strip : strips)
+    write(strip.deflated.data(), strip.deflated.size());
+  write_be32(static_cast<u32>(adler));
+  end_chunk();
+
+  begin_chunk("IEND", 0);
+  end_chunk();
+
+  DebugAssert(ptr == (data->data() + data->size()));
+  return true;
+}
+
 bool PNGFileSaver(const Image& image, std::string_view filename, std::FILE* fp, u8 quality, Error* error)
 {
+  if (PNGShouldEncodeParallel(image))
+  {
+    DynamicHeapArray<u8> buffer;
+    if (!PNGEncodeParallel(image, quality, &buffer, error))
+      return false;
+
+    if (std::fwrite(buffer.data(), buffer.size(), 1, fp) != 1)
+    {
+      Error::SetErrno(error, "fwrite() failed: ", errno);
+      return false;
+    }
+
+    return true;
+  }
+
   png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
   png_infop info_ptr = nullptr;
   if (!png_ptr)
@@ -1050,6 +1548,9 @@ bool PNGFileSaver(const Image& image, std::string_view filename, std::FILE* fp,
 
 bool PNGBufferSaver(const Image& image, DynamicHeapArray<u8>* data, u8 quality, Error* error)
 {
+  if (PNGShouldEncodeParallel(image))
+    return PNGEncodeParallel(image, quality, data, error);
+
   png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
   png_infop info_ptr = nullptr;
   if (!png_ptr)
@@ -1446,19 +1947,46 @@ bool WebPBufferLoader(Image* image, std::span<const u8> data, Error* error)
 
 bool WebPBufferSaver(const Image& image, DynamicHeapArray<u8>* data, u8 quality, Error* error)
 {
-  u8* encoded_data;
-  const size_t encoded_size =
-    WebPEncodeRGBA(reinterpret_cast<const u8*>(image.GetPixels()), image.GetWidth(), image.GetHeight(),
-                   image.GetPitch(), static_cast<float>(quality), &encoded_data);
-  if (encoded_size == 0)
+  WebPConfig config;
+  WebPPicture picture;
+  if (!WebPConfigPreset(&config, WEBP_PRESET_DEFAULT, static_cast<float>(quality)) || !WebPPictureInit(&picture))
+  {
+    Error::SetStringView(error, "Failed to initialize WebP encoder.");
+    return false;
+  }
+
+  // Lets libwebp split analysis and alpha encoding across its own threads.
+  config.thread_level = 1;
+
+  picture.use_argb = 1;
+  picture.width = static_cast<int>(image.GetWidth());
+  picture.height = static_cast<int>(image.GetHeight());
+  if (!WebPPictureImportRGBA(&picture, image.GetPixels(), static_cast<int>(image.GetPitch())))
+  {
+    Error::SetStringFmt(error, "WebPPictureImportRGBA() for {}x{} failed.", image.GetWidth(), image.GetHeight());
+    WebPPictureFree(&picture);
+    return false;
+  }
+
+  WebPMemoryWriter writer;
+  WebPMemoryWriterInit(&writer);
+  picture.writer = WebPMemoryWrite;
+  picture.custom_ptr = &writer;
+
+  const bool result = WebPEncode(&config, &picture);
+  const WebPEncodingError encode_error = picture.error_code;
+  WebPPictureFree(&picture);
+  if (!result)
   {
-    Error::SetStringFmt(error, "WebPEncodeRGBA() for {}x{} failed.", image.GetWidth(), image.GetHeight());
+    Error::SetStringFmt(error, "WebPEncode() for {}x{} failed: {}", image.GetWidth(), image.GetHeight(),
+                        static_cast<int>(encode_error));
+    WebPMemoryWriterClear(&writer);
     return false;
   }
 
-  data->resize(encoded_size);
-  std::memcpy(data->data(), encoded_data, encoded_size);
-  WebPFree(encoded_data);
+  data->resize(writer.size);
+  std::memcpy(data->data(), writer.mem, writer.size);
+  WebPMemoryWriterClear(&writer);
   return true;
 }
 
@@ -98,6 +98,19 @@ public:
   std::optional<DynamicHeapArray<u8>> SaveToBuffer(std::string_view filename, u8 quality = DEFAULT_SAVE_QUALITY,
                                                    Error* error = nullptr) const;
 
+  /// Describes one image to be written by SaveToFiles().
+  struct FileSaveRequest
+  {
+    const Image* image;
+    const char* filename;
+    u8 quality = DEFAULT_SAVE_QUALITY;
+    Error* error = nullptr;
+  };
+
+  /// Encodes and writes several images at once, overlapping their encoding across the image encode threads.
+  /// Returns the number of images which were saved, failures are reported through each request's error.
+  static u32 SaveToFiles(std::span<const FileSaveRequest> requests);
+
   std::optional<Image> ConvertToRGBA8(Error* error = nullptr) const;
 
   static bool ConvertToRGBA8(void* RESTRICT pixels_out, u32 pixels_out_pitch, const void* RESTRICT pixels_in,
@@ -21,8 +21,10 @@
 #include "common/bitutils.h"
 #include "common/easing.h"
 #include "common/error.h"
+#include "common/fast_hash.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/memory_accounting.h"
 #include "common/string_util.h"
 #include "common/thirdparty/usb_key_code_data.h"
 #include "common/threading.h"
@@ -94,7 +96,9 @@ static void ReloadFontDataIfActive();
 static bool CreateFontAtlas(Error* error);
 static bool CompilePipelines(Error* error);
 static void RenderDrawLists(u32 window_width, u32 window_height, WindowInfo::PreRotation prerotation);
-static void UpdateTextures();
+static bool UpdateTextures();
+static u64 HashDrawLists();
+static void UpdateFontMemoryAccounting();
 static void SetCommonIOOptions(ImGuiIO& io, ImGuiPlatformIO& pio);
 static void SetImKeyState(ImGuiIO& io, ImGuiKey imkey, bool pressed);
 static const char* GetClipboardTextImpl(ImGuiContext* ctx);
@@ -115,6 +119,14 @@ static std::optional<ImGuiKey> MapHostKeyEventToImGuiKey(u32 key);
 static constexpr float OSD_FADE_IN_TIME = 0.1f;
 static constexpr float OSD_FADE_OUT_TIME = 0.4f;
 
+/// Glyphs are rasterized on first use. Once the atlas reaches this size, sizes which haven't been drawn recently are
+/// evicted and the atlas repacked, instead of it growing to ImGui's default of 8192x8192.
+static constexpr int FONT_ATLAS_MAX_SIZE = 4096;
+
+/// Atlas updates are merged into a single upload of their bounding rectangle when that doesn't cover many more texels
+/// than the individual rectangles, which saves a lot of small uploads when a screen full of new glyphs is drawn.
+static constexpr int FONT_ATLAS_MERGE_UPDATE_AREA_RATIO = 2;
+
 static constexpr std::array<const char*, static_cast<size_t>(TextFont::MaxCount)> TEXT_FONT_NAMES = {{
   "Roboto-VariableFont_wdth,wght.ttf", // Default
   "NotoSansSC-VariableFont_wght.ttf",  // Chinese
@@ -148,6 +160,10 @@ struct ALIGN_TO_CACHE_LINE State
   // Owned by GPU thread
   ALIGN_TO_CACHE_LINE Timer::Value last_render_time = 0;
 
+  // Zero if the draw lists could look different each time they're rendered.
+  u64 draw_lists_hash = 0;
+  u64 last_rendered_draw_lists_hash = 0;
+
   float global_scale = 0.0f;
   float window_width = 0.0f;
   float window_height = 0.0f;
@@ -271,6 +287,8 @@ void ImGuiManager::Shutdown(bool preserve_fsui_state)
     ImGui::DestroyContext(s_state.imgui_context);
     s_state.imgui_context = nullptr;
   }
+
+  UpdateFontMemoryAccounting();
 }
 
 ImGuiContext* ImGuiManager::GetMainContext()
@@ -295,6 +313,9 @@ float ImGuiManager::GetWindowHeight()
 
 void ImGuiManager::WindowResized(GPUTextureFormat format, float width, float height)
 {
+  // swap chain may have been recreated
+  s_state.last_rendered_draw_lists_hash = 0;
+
   if (s_state.window_format != format) [[unlikely]]
   {
     Error error;
@@ -435,7 +456,46 @@ void ImGuiManager::CreateDrawLists()
 {
   ImGui::EndFrame();
   ImGui::Render();
-  UpdateTextures();
+
+  const bool textures_changed = UpdateTextures();
+  s_state.draw_lists_hash = textures_changed ? 0 : HashDrawLists();
+}
+
+u64 ImGuiManager::HashDrawLists()
+{
+  const ImDrawData* draw_data = ImGui::GetDrawData();
+
+  FastHash::Hasher64 hasher;
+  hasher.Update(&draw_data->DisplayPos, sizeof(draw_data->DisplayPos));
+  hasher.Update(&draw_data->DisplaySize, sizeof(draw_data->DisplaySize));
+
+  for (const ImDrawList* cmd_list : draw_data->CmdLists)
+  {
+    hasher.Update(cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.size_in_bytes());
+    hasher.Update(cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.size_in_bytes());
+
+    for (const ImDrawCmd& cmd : cmd_list->CmdBuffer)
+    {
+      // callbacks can draw anything, e.g. the shader background
+      if (cmd.UserCallback)
+        return 0;
+
+      const ImTextureID tex_id = cmd.GetTexID();
+      hasher.Update(&cmd.ClipRect, sizeof(cmd.ClipRect));
+      hasher.Update(&tex_id, sizeof(tex_id));
+      hasher.Update(&cmd.VtxOffset, sizeof(cmd.VtxOffset));
+      hasher.Update(&cmd.IdxOffset, sizeof(cmd.IdxOffset));
+      hasher.Update(&cmd.ElemCount, sizeof(cmd.ElemCount));
+    }
+  }
+
+  // zero means "always render"
+  return std::max<u64>(hasher.Final(), 1);
+}
+
+bool ImGuiManager::AreDrawListsUnchanged()
+{
+  return (s_state.draw_lists_hash != 0 && s_state.draw_lists_hash == s_state.last_rendered_draw_lists_hash);
 }
 
 void ImGuiManager::RenderDrawLists(u32 window_width, u32 window_height, WindowInfo::PreRotation prerotation)
@@ -444,6 +504,7 @@ void ImGuiManager::RenderDrawLists(u32 window_width, u32 window_height, WindowIn
   if (draw_data->CmdListsCount == 0)
     return;
 
+  const GPUDevice::TimingScope timing_scope("ImGui");
   const GSVector2i window_size = GSVector2i(static_cast<s32>(window_width), static_cast<s32>(window_height));
   const u32 post_rotated_width =
     WindowInfo::ShouldSwapDimensionsForPreRotation(prerotation) ? window_height : window_width;
@@ -509,16 +570,20 @@ void ImGuiManager::RenderDrawLists(u32 window_width, u32 window_height, WindowIn
 
 void ImGuiManager::RenderDrawLists(GPUSwapChain* swap_chain)
 {
+  s_state.last_rendered_draw_lists_hash = s_state.draw_lists_hash;
   RenderDrawLists(swap_chain->GetWidth(), swap_chain->GetHeight(), swap_chain->GetPreRotation());
 }
 
 void ImGuiManager::RenderDrawLists(GPUTexture* texture)
 {
+  // swap chain gets something else, e.g. a transition
+  s_state.last_rendered_draw_lists_hash = 0;
   RenderDrawLists(texture->GetWidth(), texture->GetHeight(), WindowInfo::PreRotation::Identity);
 }
 
-void ImGuiManager::UpdateTextures()
+bool ImGuiManager::UpdateTextures()
 {
+  bool changed = false;
   for (ImTextureData* const tex : s_state.imgui_context->IO.Fonts->TexList)
   {
     switch (tex->Status)
@@ -540,14 +605,25 @@ void ImGuiManager::UpdateTextures()
 
         tex->SetTexID(reinterpret_cast<ImTextureID>(gtex.release()));
         tex->Status = ImTextureStatus_OK;
+        changed = true;
       }
       break;
 
       case ImTextureStatus_WantUpdates:
       {
-        // TODO: Do we want to just update the whole dirty area? Probably need a heuristic...
         GPUTexture* const gtex = reinterpret_cast<GPUTexture*>(tex->GetTexID());
+
+        int updates_area = 0;
         for (const ImTextureRect& rc : tex->Updates)
+          updates_area += static_cast<int>(rc.w) * static_cast<int>(rc.h);
+
+        const ImTextureRect& merged_rc = tex->UpdateRect;
+        const std::span<const ImTextureRect> updates =
+          (tex->Updates.Size > 1 && (static_cast<int>(merged_rc.w) * static_cast<int>(merged_rc.h)) <=
+                                      (updates_area * FONT_ATLAS_MERGE_UPDATE_AREA_RATIO)) ?
+            std::span<const ImTextureRect>(&merged_rc, 1) :
+            std::span<const ImTextureRect>(tex->Updates.Data, static_cast<size_t>(tex->Updates.Size));
+        for (const ImTextureRect& rc : updates)
         {
           DEBUG_LOG("Update {}x{} @ {},{} in {}x{} ImGui texture", rc.w, rc.h, rc.x, rc.y, tex->Width, tex->Height);
           if (!gtex->Update(rc.x, rc.y, rc.w, rc.h, tex->GetPixelsAt(rc.x, rc.y), tex->GetPitch())) [[unlikely]]
@@ -559,6 +635,7 @@ void ImGuiManager::UpdateTextures()
 
         // Updates is cleared by ImGui NewFrame.
         tex->Status = ImTextureStatus_OK;
+        changed = true;
       }
       break;
 
@@ -573,6 +650,7 @@ void ImGuiManager::UpdateTextures()
 
         tex->SetTexID(nullptr);
         tex->Status = ImTextureStatus_Destroyed;
+        changed = true;
       }
       break;
 
@@ -582,6 +660,32 @@ void ImGuiManager::UpdateTextures()
         continue;
     }
   }
+
+  UpdateFontMemoryAccounting();
+  return changed;
+}
+
+void ImGuiManager::UpdateFontMemoryAccounting()
+{
+  // Font files are kept loaded across context recreation, the atlas only exists while there is a context.
+  size_t host_bytes = s_state.fixed_font_data.size() + s_state.icon_fa_font_data.size() +
+                      s_state.icon_pf_font_data.size() + s_state.emoji_font_data.size();
+  for (const DynamicHeapArray<u8>& data : s_state.text_fonts_data)
+    host_bytes += data.size();
+
+  size_t gpu_bytes = 0;
+  if (s_state.imgui_context)
+  {
+    for (const ImTextureData* const tex : s_state.imgui_context->IO.Fonts->TexList)
+    {
+      if (tex->Pixels)
+        host_bytes += static_cast<size_t>(tex->GetSizeInBytes());
+      if (tex->Status == ImTextureStatus_OK && tex->GetTexID())
+        gpu_bytes += reinterpret_cast<const GPUTexture*>(tex->GetTexID())->GetVRAMUsage();
+    }
+  }
+
+  MemoryAccounting::Set(MemoryAccounting::Category::Fonts, host_bytes, gpu_bytes);
 }
 
 void ImGuiManager::SetStyle(ImGuiStyle& style, float scale)
@@ -717,6 +821,8 @@ bool ImGuiManager::CreateFontAtlas(Error* error)
 
   ImGuiIO& io = ImGui::GetIO();
   io.Fonts->Clear();
+  io.Fonts->TexMaxWidth = FONT_ATLAS_MAX_SIZE;
+  io.Fonts->TexMaxHeight = FONT_ATLAS_MAX_SIZE;
 
   const float default_text_size = GetOSDFontSize();
   const float default_text_weight = 400.0f;
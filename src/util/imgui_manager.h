@@ -118,6 +118,10 @@ void NewFrame(u64 current_time);
 /// Creates the draw list for the frame, akin to ImGui::Render().
 void CreateDrawLists();
 
+/// Returns true if the draw lists from CreateDrawLists() would render the same image as the last ones which were
+/// rendered to the swap chain. Draw lists containing callbacks or texture uploads never count as unchanged.
+bool AreDrawListsUnchanged();
+
 /// Renders ImGui screen elements. Call before EndPresent().
 void RenderDrawLists(GPUSwapChain* swap_chain);
 void RenderDrawLists(GPUTexture* texture);
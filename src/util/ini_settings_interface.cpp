@@ -52,6 +52,7 @@ bool INISettingsInterface::Load(Error* error /* = nullptr */)
   auto fp = FileSystem::OpenManagedCFile(m_path.c_str(), "rb", error);
   if (fp)
   {
+    InvalidateValueIndex();
     err = m_ini.LoadFile(fp.get());
     if (err != SI_OK)
       Error::SetStringFmt(error, "INI LoadFile() failed: {}", static_cast<int>(err));
@@ -64,6 +65,7 @@ bool INISettingsInterface::Load(Error* error /* = nullptr */)
 bool INISettingsInterface::Load(std::string new_path, Error* error /*= nullptr*/)
 {
   m_path = std::move(new_path);
+  InvalidateValueIndex();
   m_ini.Reset();
   return Load(error);
 }
@@ -106,6 +108,7 @@ bool INISettingsInterface::Save(Error* error /* = nullptr */)
 
 void INISettingsInterface::Clear()
 {
+  InvalidateValueIndex();
   m_ini.Reset();
 }
 
@@ -116,7 +119,7 @@ bool INISettingsInterface::IsEmpty()
 
 bool INISettingsInterface::GetIntValue(const char* section, const char* key, s32* value) const
 {
-  const char* str_value = m_ini.GetValue(section, key);
+  const char* str_value = FindValue(section, key);
   if (!str_value)
     return false;
 
@@ -130,7 +133,7 @@ bool INISettingsInterface::GetIntValue(const char* section, const char* key, s32
 
 bool INISettingsInterface::GetUIntValue(const char* section, const char* key, u32* value) const
 {
-  const char* str_value = m_ini.GetValue(section, key);
+  const char* str_value = FindValue(section, key);
   if (!str_value)
     return false;
 
@@ -144,7 +147,7 @@ bool INISettingsInterface::GetUIntValue(const char* section, const char* key, u3
 
 bool INISettingsInterface::GetFloatValue(const char* section, const char* key, float* value) const
 {
-  const char* str_value = m_ini.GetValue(section, key);
+  const char* str_value = FindValue(section, key);
   if (!str_value)
     return false;
 
@@ -158,7 +161,7 @@ bool INISettingsInterface::GetFloatValue(const char* section, const char* key, f
 
 bool INISettingsInterface::GetDoubleValue(const char* section, const char* key, double* value) const
 {
-  const char* str_value = m_ini.GetValue(section, key);
+  const char* str_value = FindValue(section, key);
   if (!str_value)
     return false;
 
@@ -172,7 +175,7 @@ bool INISettingsInterface::GetDoubleValue(const char* section, const char* key,
 
 bool INISettingsInterface::GetBoolValue(const char* section, const char* key, bool* value) const
 {
-  const char* str_value = m_ini.GetValue(section, key);
+  const char* str_value = FindValue(section, key);
   if (!str_value)
     return false;
 
@@ -186,7 +189,7 @@ bool INISettingsInterface::GetBoolValue(const char* section, const char* key, bo
 
 bool INISettingsInterface::GetStringValue(const char* section, const char* key, std::string* value) const
 {
-  const char* str_value = m_ini.GetValue(section, key);
+  const char* str_value = FindValue(section, key);
   if (!str_value)
     return false;
 
@@ -196,7 +199,7 @@ bool INISettingsInterface::GetStringValue(const char* section, const char* key,
 
 bool INISettingsInterface::GetStringValue(const char* section, const char* key, SmallStringBase* value) const
 {
-  const char* str_value = m_ini.GetValue(section, key);
+  const char* str_value = FindValue(section, key);
   if (!str_value)
     return false;
 
@@ -207,77 +210,85 @@ bool INISettingsInterface::GetStringValue(const char* section, const char* key,
 void INISettingsInterface::SetIntValue(const char* section, const char* key, s32 value)
 {
   s32 current_value;
-  if (GetIntValue(key, section, &current_value) && current_value == value)
+  if (GetIntValue(section, key, &current_value) && current_value == value)
     return;
 
   m_dirty = true;
+  InvalidateValueIndex();
   m_ini.SetValue(section, key, StringUtil::ToChars(value).c_str(), nullptr, true);
 }
 
 void INISettingsInterface::SetUIntValue(const char* section, const char* key, u32 value)
 {
   u32 current_value;
-  if (GetUIntValue(key, section, &current_value) && current_value == value)
+  if (GetUIntValue(section, key, &current_value) && current_value == value)
     return;
 
   m_dirty = true;
+  InvalidateValueIndex();
   m_ini.SetValue(section, key, StringUtil::ToChars(value).c_str(), nullptr, true);
 }
 
 void INISettingsInterface::SetFloatValue(const char* section, const char* key, float value)
 {
   float current_value;
-  if (GetFloatValue(key, section, &current_value) && current_value == value)
+  if (GetFloatValue(section, key, &current_value) && current_value == value)
     return;
 
   m_dirty = true;
+  InvalidateValueIndex();
   m_ini.SetValue(section, key, StringUtil::ToChars(value).c_str(), nullptr, true);
 }
 
 void INISettingsInterface::SetDoubleValue(const char* section, const char* key, double value)
 {
   double current_value;
-  if (GetDoubleValue(key, section, &current_value) && current_value == value)
+  if (GetDoubleValue(section, key, &current_value) && current_value == value)
     return;
 
   m_dirty = true;
+  InvalidateValueIndex();
   m_ini.SetValue(section, key, StringUtil::ToChars(value).c_str(), nullptr, true);
 }
 
 void INISettingsInterface::SetBoolValue(const char* section, const char* key, bool value)
 {
   bool current_value;
-  if (GetBoolValue(key, section, &current_value) && current_value == value)
+  if (GetBoolValue(section, key, &current_value) && current_value == value)
     return;
 
   m_dirty = true;
+  InvalidateValueIndex();
   m_ini.SetBoolValue(section, key, value, nullptr, true);
 }
 
 void INISettingsInterface::SetStringValue(const char* section, const char* key, const char* value)
 {
-  const char* current_value = m_ini.GetValue(section, key);
+  const char* current_value = FindValue(section, key);
   if (current_value && std::strcmp(current_value, value) == 0)
     return;
 
   m_dirty = true;
+  InvalidateValueIndex();
   m_ini.SetValue(section, key, value, nullptr, true);
 }
 
 bool INISettingsInterface::ContainsValue(const char* section, const char* key) const
 {
-  return (m_ini.GetValue(section, key, nullptr) != nullptr);
+  return (FindValue(section, key) != nullptr);
 }
 
 void INISettingsInterface::DeleteValue(const char* section, const char* key)
 {
   m_dirty = true;
+  InvalidateValueIndex();
   m_ini.Delete(section, key);
 }
 
 void INISettingsInterface::ClearSection(const char* section)
 {
   m_dirty = true;
+  InvalidateValueIndex();
   m_ini.Delete(section, nullptr);
   m_ini.SetValue(section, nullptr, nullptr);
 }
@@ -288,6 +299,7 @@ void INISettingsInterface::RemoveSection(const char* section)
     return;
 
   m_dirty = true;
+  InvalidateValueIndex();
   m_ini.Delete(section, nullptr);
 }
 
@@ -301,6 +313,7 @@ void INISettingsInterface::RemoveEmptySections()
       continue;
 
     m_dirty = true;
+    InvalidateValueIndex();
     m_ini.Delete(entry.pItem, nullptr);
   }
 }
@@ -321,6 +334,7 @@ std::vector<std::string> INISettingsInterface::GetStringList(const char* section
 void INISettingsInterface::SetStringList(const char* section, const char* key, const std::vector<std::string>& items)
 {
   m_dirty = true;
+  InvalidateValueIndex();
   m_ini.Delete(section, key);
 
   for (const std::string& sv : items)
@@ -330,6 +344,7 @@ void INISettingsInterface::SetStringList(const char* section, const char* key, c
 bool INISettingsInterface::RemoveFromStringList(const char* section, const char* key, const char* item)
 {
   m_dirty = true;
+  InvalidateValueIndex();
   return m_ini.DeleteValue(section, key, item, true);
 }
 
@@ -344,6 +359,7 @@ bool INISettingsInterface::AddToStringList(const char* section, const char* key,
   }
 
   m_dirty = true;
+  InvalidateValueIndex();
   m_ini.SetValue(section, key, item, nullptr, false);
   return true;
 }
@@ -380,7 +396,70 @@ std::vector<std::pair<std::string, std::string>> INISettingsInterface::GetKeyVal
 void INISettingsInterface::SetKeyValueList(const char* section,
                                            const std::vector<std::pair<std::string, std::string>>& items)
 {
+  InvalidateValueIndex();
   m_ini.Delete(section, nullptr);
   for (const std::pair<std::string, std::string>& item : items)
     m_ini.SetValue(section, item.first.c_str(), item.second.c_str(), nullptr, false);
 }
+
+std::size_t INISettingsInterface::ValueIndexKeyHash::operator()(const ValueIndexKey& key) const
+{
+  // FNV-1a, with ASCII case folded to match the storage.
+  u64 hash = 0xCBF29CE484222325ULL;
+  const auto hash_string = [&hash](std::string_view str) {
+    for (const char ch : str)
+    {
+      hash ^= static_cast<u8>((ch >= 'A' && ch <= 'Z') ? (ch | 0x20) : ch);
+      hash *= 0x100000001B3ULL;
+    }
+  };
+  hash_string(key.section);
+  hash = (hash ^ 0xFFu) * 0x100000001B3ULL;
+  hash_string(key.key);
+  return static_cast<std::size_t>(hash);
+}
+
+bool INISettingsInterface::ValueIndexKeyEqual::operator()(const ValueIndexKey& lhs, const ValueIndexKey& rhs) const
+{
+  return (StringUtil::EqualNoCase(lhs.key, rhs.key) && StringUtil::EqualNoCase(lhs.section, rhs.section));
+}
+
+const char* INISettingsInterface::FindValue(const char* section, const char* key) const
+{
+  if (!m_value_index_valid.load(std::memory_order_acquire))
+    BuildValueIndex();
+
+  const auto it = m_value_index.find(ValueIndexKey{section, key});
+  return (it != m_value_index.end()) ? it->second : nullptr;
+}
+
+void INISettingsInterface::BuildValueIndex() const
+{
+  // lookups can come from multiple threads, modifications can't
+  std::unique_lock lock(m_value_index_mutex);
+  if (m_value_index_valid.load(std::memory_order_relaxed))
+    return;
+
+  m_value_index.clear();
+  m_value_index.reserve(static_cast<size_t>(m_ini.GetKeyCount()));
+
+  std::list<IniStorage::Entry> sections;
+  m_ini.GetAllSections(sections);
+  for (const IniStorage::Entry& section : sections)
+  {
+    const IniStorage::TKeyVal* keys = m_ini.GetSection(section.pItem);
+    if (!keys)
+      continue;
+
+    // keys with multiple values are ordered, the first is what GetValue() would return
+    for (const auto& [key, value] : *keys)
+      m_value_index.emplace(ValueIndexKey{section.pItem, key.pItem}, value);
+  }
+
+  m_value_index_valid.store(true, std::memory_order_release);
+}
+
+void INISettingsInterface::InvalidateValueIndex()
+{
+  m_value_index_valid.store(false, std::memory_order_relaxed);
+}
@@ -10,6 +10,11 @@
 #endif
 #include "SimpleIni.h"
 
+#include <atomic>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
 class INISettingsInterface final : public SettingsInterface
 {
 public:
@@ -68,7 +73,33 @@ public:
 private:
   using IniStorage = CSimpleIniCaseA;
 
+  struct ValueIndexKey
+  {
+    std::string_view section;
+    std::string_view key;
+  };
+  struct ValueIndexKeyHash
+  {
+    std::size_t operator()(const ValueIndexKey& key) const;
+  };
+  struct ValueIndexKeyEqual
+  {
+    bool operator()(const ValueIndexKey& lhs, const ValueIndexKey& rhs) const;
+  };
+
+  /// Flat map of every value, so lookups are a single hash instead of two case-insensitive tree searches. Points into
+  /// the ini storage, so it's thrown away on any modification and rebuilt by the next lookup.
+  using ValueIndex = std::unordered_map<ValueIndexKey, const char*, ValueIndexKeyHash, ValueIndexKeyEqual>;
+
+  const char* FindValue(const char* section, const char* key) const;
+  void BuildValueIndex() const;
+  void InvalidateValueIndex();
+
   std::string m_path;
   IniStorage m_ini;
   bool m_dirty = false;
+
+  mutable std::mutex m_value_index_mutex;
+  mutable ValueIndex m_value_index;
+  mutable std::atomic_bool m_value_index_valid{false};
 };
@@ -21,6 +21,7 @@
 #include "common/path.h"
 #include "common/string_util.h"
 #include "common/thirdparty/SmallVector.h"
+#include "common/threading.h"
 #include "common/timer.h"
 
 #include "IconsFontAwesome.h"
@@ -31,6 +32,7 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
 #include <memory>
 #include <mutex>
 #include <sstream>
@@ -61,6 +63,16 @@ enum : u32
 /// Delay before showing any controller connected notifications after startup.
 static constexpr float DEVICE_CONNECTED_NOTIFICATION_DELAY = 5.0f;
 
+/// How often the polling thread polls the sources, if enabled.
+static constexpr double POLLING_THREAD_INTERVAL_SECONDS = 0.001;
+
+/// Size of the queues between the polling thread and the core thread.
+static constexpr u32 POLLING_THREAD_EVENT_QUEUE_SIZE = 1024;
+static constexpr u32 POLLING_THREAD_EFFECT_QUEUE_SIZE = 256;
+
+/// Sources aren't polled if the core thread hasn't caught up, and can hold on to their events until it has.
+static constexpr u32 POLLING_THREAD_MIN_FREE_EVENTS = 256;
+
 // ------------------------------------------------------------------------
 // Binding Type
 // ------------------------------------------------------------------------
@@ -78,6 +90,85 @@ struct InputBinding
   u8 num_keys = 0;
   u8 full_mask = 0;
   u8 current_mask = 0;
+  bool is_pad_binding = false;
+};
+
+/// Event from a late input poll, which still has to be sent to the non-pad bindings.
+struct DeferredInputEvent
+{
+  InputBindingKey key;
+  float value;
+  bool skip_button_handlers;
+};
+
+/// Event from a source polled on the polling thread, which still has to be dispatched on the core thread.
+struct PolledInputEvent
+{
+  InputBindingKey key;
+  float value;
+  GenericInputBinding generic_key;
+};
+
+/// Rumble/LED update from the core thread, which is sent to the device on the polling thread.
+struct QueuedEffectUpdate
+{
+  enum class Type : u8
+  {
+    Motor,
+    DualMotor,
+    LED,
+  };
+
+  InputSource* source;
+  std::array<InputBindingKey, 2> keys;
+  std::array<float, 2> intensities;
+  Type type;
+};
+
+/// Fixed-size single producer/single consumer queue, for passing data between the core and polling threads.
+template<typename T, u32 SIZE>
+class SPSCQueue
+{
+  static_assert(std::has_single_bit(SIZE));
+
+public:
+  /// Only valid when called from the producer.
+  ALWAYS_INLINE u32 GetFreeSpace() const
+  {
+    return SIZE - (m_write_pos.load(std::memory_order_relaxed) - m_read_pos.load(std::memory_order_acquire));
+  }
+
+  ALWAYS_INLINE bool IsEmpty() const
+  {
+    return (m_read_pos.load(std::memory_order_relaxed) == m_write_pos.load(std::memory_order_acquire));
+  }
+
+  bool Push(const T& item)
+  {
+    const u32 write_pos = m_write_pos.load(std::memory_order_relaxed);
+    if ((write_pos - m_read_pos.load(std::memory_order_acquire)) == SIZE)
+      return false;
+
+    m_items[write_pos % SIZE] = item;
+    m_write_pos.store(write_pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool Pop(T* item)
+  {
+    const u32 read_pos = m_read_pos.load(std::memory_order_relaxed);
+    if (read_pos == m_write_pos.load(std::memory_order_acquire))
+      return false;
+
+    *item = m_items[read_pos % SIZE];
+    m_read_pos.store(read_pos + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::array<T, SIZE> m_items;
+  ALIGN_TO_CACHE_LINE std::atomic<u32> m_read_pos{0};
+  ALIGN_TO_CACHE_LINE std::atomic<u32> m_write_pos{0};
 };
 
 struct PadVibrationBinding
@@ -147,9 +238,24 @@ static std::vector<std::string_view> SplitChord(std::string_view binding);
 static bool SplitBinding(std::string_view binding, std::string_view* source, std::string_view* sub_binding);
 static void PrettifyInputBindingPart(std::string_view binding, BindingIconMappingFunction mapper, SmallString& ret,
                                      bool& changed);
-static void AddBindings(const std::vector<std::string>& bindings, const InputEventHandler& handler);
+static void AddBindings(const std::vector<std::string>& bindings, const InputEventHandler& handler,
+                        bool is_pad_binding = false);
+static void InternalAddBinding(std::string_view binding, const InputEventHandler& handler, bool is_pad_binding);
+static bool ShouldDispatchBinding(const InputBinding* binding);
+static void DispatchDeferredEvents();
 static void UpdatePointerCount();
 
+static bool IsPolledOnPollingThread(u32 source_index);
+static void StartPollingThread();
+static void StopPollingThread();
+static void PollingThreadEntryPoint();
+static void DispatchPolledEvents();
+static void UpdateMotorState(InputSource* source, InputBindingKey key, float intensity);
+static void UpdateMotorState(InputSource* source, InputBindingKey large_key, InputBindingKey small_key,
+                             float large_intensity, float small_intensity);
+static void UpdateLEDState(InputSource* source, InputBindingKey key, float intensity);
+static void ApplyEffectUpdate(const QueuedEffectUpdate& update);
+
 static bool IsAxisHandler(const InputEventHandler& handler);
 static float ApplySingleBindingScale(float sensitivity, float deadzone, float value);
 
@@ -223,6 +329,17 @@ struct ALIGN_TO_CACHE_LINE State
   std::vector<std::pair<u32, PointerMoveCallback>> pointer_move_callbacks;
   std::recursive_mutex mutex;
 
+  // Set while polling for a pad read. Non-pad bindings aren't safe to fire in the middle of a frame.
+  bool late_polling = false;
+  bool dispatching_deferred_events = false;
+  std::vector<DeferredInputEvent> deferred_events;
+
+  // Optional thread which polls the sources. While it's running, sources are only accessed with the mutex held.
+  Threading::Thread polling_thread;
+  std::atomic_bool polling_thread_running{false};
+  SPSCQueue<PolledInputEvent, POLLING_THREAD_EVENT_QUEUE_SIZE> polled_events;
+  SPSCQueue<QueuedEffectUpdate, POLLING_THREAD_EFFECT_QUEUE_SIZE> effect_updates;
+
   // Hooks/intercepting (for setting bindings)
   InputInterceptHook::Callback event_intercept_callback;
 
@@ -256,6 +373,9 @@ struct ALIGN_TO_CACHE_LINE State
 
 static State s_state;
 
+/// Set on the polling thread, so callbacks from sources know to hand their work to the core thread.
+static thread_local bool s_is_polling_thread = false;
+
 static constexpr const std::array s_key_code_data = {
 #if defined(_WIN32)
 #define KEY_ENTRY(ename, usb, evdev, xkb, win, mac, name, icon_name) KeyCodeData{usb, win, name, icon_name},
@@ -602,13 +722,19 @@ void InputManager::PrettifyInputBindingPart(const std::string_view binding, Bind
   ret.append(binding);
 }
 
-void InputManager::AddBindings(const std::vector<std::string>& bindings, const InputEventHandler& handler)
+void InputManager::AddBindings(const std::vector<std::string>& bindings, const InputEventHandler& handler,
+                               bool is_pad_binding)
 {
   for (const std::string& binding : bindings)
-    AddBinding(binding, handler);
+    InternalAddBinding(binding, handler, is_pad_binding);
 }
 
 void InputManager::AddBinding(std::string_view binding, const InputEventHandler& handler)
+{
+  InternalAddBinding(binding, handler, false);
+}
+
+void InputManager::InternalAddBinding(std::string_view binding, const InputEventHandler& handler, bool is_pad_binding)
 {
   std::shared_ptr<InputBinding> ibinding;
   const std::vector<std::string_view> chord_bindings(SplitChord(binding));
@@ -627,6 +753,7 @@ void InputManager::AddBinding(std::string_view binding, const InputEventHandler&
     {
       ibinding = std::make_shared<InputBinding>();
       ibinding->handler = handler;
+      ibinding->is_pad_binding = is_pad_binding;
     }
 
     if (ibinding->num_keys == MAX_KEYS_PER_BINDING)
@@ -993,7 +1120,8 @@ void InputManager::AddPadBindings(const SettingsInterface& si, const std::string
                         Controller* c = System::GetController(pad_index);
                         if (c)
                           c->SetBindState(bind_index, ApplySingleBindingScale(sensitivity, deadzone, value));
-                      }});
+                      }},
+                      true);
         }
       }
       break;
@@ -1169,6 +1297,14 @@ bool InputManager::ShouldMaskBackgroundInput(InputBindingKey key)
 
 void InputManager::InvokeEvents(InputBindingKey key, float value, GenericInputBinding generic_key)
 {
+  if (s_is_polling_thread) [[unlikely]]
+  {
+    // handlers can only run on the core thread
+    if (!s_state.polled_events.Push(PolledInputEvent{key, value, generic_key}))
+      WARNING_LOG("Polled event queue is full, dropping event.");
+    return;
+  }
+
   if (DoEventHook(key, value))
     return;
 
@@ -1180,6 +1316,33 @@ void InputManager::InvokeEvents(InputBindingKey key, float value, GenericInputBi
   const bool skip_button_handlers = PreprocessEvent(key, value, generic_key);
 
   ProcessEvent(key, value, skip_button_handlers);
+
+  // everything else gets the event with the next full poll
+  if (s_state.late_polling) [[unlikely]]
+    s_state.deferred_events.push_back(DeferredInputEvent{key, value, skip_button_handlers});
+}
+
+ALWAYS_INLINE_RELEASE bool InputManager::ShouldDispatchBinding(const InputBinding* binding)
+{
+  if (s_state.late_polling) [[unlikely]]
+    return binding->is_pad_binding;
+  else if (s_state.dispatching_deferred_events) [[unlikely]]
+    return !binding->is_pad_binding;
+  else
+    return true;
+}
+
+void InputManager::DispatchDeferredEvents()
+{
+  s_state.dispatching_deferred_events = true;
+
+  // bindings can reload while we're dispatching, so don't hold on to the vector
+  std::vector<DeferredInputEvent> events = std::move(s_state.deferred_events);
+  s_state.deferred_events = {};
+  for (const DeferredInputEvent& event : events)
+    ProcessEvent(event.key, event.value, event.skip_button_handlers);
+
+  s_state.dispatching_deferred_events = false;
 }
 
 bool InputManager::ProcessEvent(InputBindingKey key, float value, bool skip_button_handlers)
@@ -1195,6 +1358,8 @@ bool InputManager::ProcessEvent(InputBindingKey key, float value, bool skip_butt
   for (auto it = range.first; it != range.second; ++it)
   {
     InputBinding* binding = it->second.get();
+    if (!ShouldDispatchBinding(binding))
+      continue;
 
     // find the key which matches us
     for (u32 i = 0; i < binding->num_keys; i++)
@@ -1362,7 +1527,8 @@ void InputManager::ClearBindStateFromSource(InputBindingKey key)
 
 void InputManager::SynchronizeBindingHandlerState()
 {
-  // should be called on the main thread, so no need to lock
+  // should be called on the main thread, but the polling thread could be using the sources
+  std::unique_lock lock(s_state.mutex);
   for (const auto& [key, binding] : s_state.binding_map)
   {
     // ignore hotkeys
@@ -1510,6 +1676,12 @@ std::pair<float, float> InputManager::GetPointerAbsolutePosition(u32 index)
 
 void InputManager::UpdatePointerAbsolutePosition(u32 index, float x, float y, bool raw_input)
 {
+  if (s_is_polling_thread) [[unlikely]]
+  {
+    Host::RunOnCoreThread([index, x, y, raw_input]() { UpdatePointerAbsolutePosition(index, x, y, raw_input); });
+    return;
+  }
+
   if (index >= MAX_POINTER_DEVICES || (s_state.relative_mouse_mode_active && !raw_input)) [[unlikely]]
     return;
 
@@ -1534,6 +1706,12 @@ void InputManager::ResetPointerRelativeDelta(u32 index)
 
 void InputManager::UpdatePointerPositionRelativeDelta(u32 index, InputPointerAxis axis, float d)
 {
+  if (s_is_polling_thread) [[unlikely]]
+  {
+    Host::RunOnCoreThread([index, axis, d]() { UpdatePointerPositionRelativeDelta(index, axis, d); });
+    return;
+  }
+
   DebugAssert(axis <= InputPointerAxis::Y);
   if (index >= MAX_POINTER_DEVICES || !s_state.relative_mouse_mode_active)
     return;
@@ -1553,6 +1731,12 @@ void InputManager::UpdatePointerPositionRelativeDelta(u32 index, InputPointerAxi
 
 void InputManager::UpdatePointerWheelRelativeDelta(u32 index, InputPointerAxis axis, float d)
 {
+  if (s_is_polling_thread) [[unlikely]]
+  {
+    Host::RunOnCoreThread([index, axis, d]() { UpdatePointerWheelRelativeDelta(index, axis, d); });
+    return;
+  }
+
   DebugAssert(axis >= InputPointerAxis::WheelX && axis <= InputPointerAxis::WheelY);
   if (index >= MAX_POINTER_DEVICES)
     return;
@@ -1873,6 +2057,14 @@ std::vector<std::string> InputManager::GetInputProfileNames()
 void InputManager::OnInputDeviceConnected(InputBindingKey key, std::string_view identifier,
                                           std::string_view device_name)
 {
+  if (s_is_polling_thread) [[unlikely]]
+  {
+    Host::RunOnCoreThread([key, identifier = std::string(identifier), device_name = std::string(device_name)]() {
+      OnInputDeviceConnected(key, identifier, device_name);
+    });
+    return;
+  }
+
   INFO_LOG("Device '{}' connected: '{}'", identifier, device_name);
   SynchronizePadEffectBindings(key);
   Host::OnInputDeviceConnected(key, identifier, device_name);
@@ -1887,6 +2079,13 @@ void InputManager::OnInputDeviceConnected(InputBindingKey key, std::string_view
 
 void InputManager::OnInputDeviceDisconnected(InputBindingKey key, std::string_view identifier)
 {
+  if (s_is_polling_thread) [[unlikely]]
+  {
+    Host::RunOnCoreThread(
+      [key, identifier = std::string(identifier)]() { OnInputDeviceDisconnected(key, identifier); });
+    return;
+  }
+
   INFO_LOG("Device '{}' disconnected", identifier);
   Host::OnInputDeviceDisconnected(key, identifier);
 
@@ -1910,6 +2109,7 @@ void InputManager::OnInputDeviceDisconnected(InputBindingKey key, std::string_vi
 std::unique_ptr<ForceFeedbackDevice> InputManager::CreateForceFeedbackDevice(const std::string_view device,
                                                                              Error* error)
 {
+  std::unique_lock lock(s_state.mutex);
   for (u32 i = FIRST_EXTERNAL_INPUT_SOURCE; i < LAST_EXTERNAL_INPUT_SOURCE; i++)
   {
     if (s_state.input_sources[i] && s_state.input_sources[i]->ContainsDevice(device))
@@ -1943,7 +2143,7 @@ void InputManager::InternalPauseVibration()
   {
     // we deliberately don't zero the intensity here, so it can resume later
     binding.last_update_time = 0;
-    binding.source->UpdateMotorState(binding.binding, 0.0f);
+    UpdateMotorState(binding.source, binding.binding, 0.0f);
   }
 }
 
@@ -1990,11 +2190,11 @@ void InputManager::UpdateContinuedVibration()
                   static_cast<u32>(binding.binding.source_index), motor_intensities_mask, motor_intensities[0],
                   motor_intensities[1]);
     if (motor_intensities_mask == 0b11)
-      binding.source->UpdateMotorState(motor_keys[0], motor_keys[1], motor_intensities[0], motor_intensities[1]);
+      UpdateMotorState(binding.source, motor_keys[0], motor_keys[1], motor_intensities[0], motor_intensities[1]);
     else if (motor_intensities_mask == 0b01)
-      binding.source->UpdateMotorState(motor_keys[0], motor_intensities[0]);
+      UpdateMotorState(binding.source, motor_keys[0], motor_intensities[0]);
     else // if (motor_intensities_mask == 0b10)
-      binding.source->UpdateMotorState(motor_keys[1], motor_intensities[1]);
+      UpdateMotorState(binding.source, motor_keys[1], motor_intensities[1]);
   }
 }
 
@@ -2010,7 +2210,7 @@ void InputManager::SetPadLEDState(u32 pad_index, float intensity)
       continue;
 
     pad.last_intensity = intensity;
-    pad.source->UpdateLEDState(pad.binding, intensity);
+    UpdateLEDState(pad.source, pad.binding, intensity);
   }
 }
 
@@ -2022,7 +2222,59 @@ void InputManager::InternalClearEffects()
       continue;
 
     pad.last_intensity = 0.0f;
-    pad.source->UpdateLEDState(pad.binding, 0.0f);
+    UpdateLEDState(pad.source, pad.binding, 0.0f);
+  }
+}
+
+void InputManager::UpdateMotorState(InputSource* source, InputBindingKey key, float intensity)
+{
+  if (!s_state.polling_thread.Joinable() ||
+      !s_state.effect_updates.Push(QueuedEffectUpdate{source, {key}, {intensity}, QueuedEffectUpdate::Type::Motor}))
+  {
+    std::unique_lock lock(s_state.mutex);
+    source->UpdateMotorState(key, intensity);
+  }
+}
+
+void InputManager::UpdateMotorState(InputSource* source, InputBindingKey large_key, InputBindingKey small_key,
+                                    float large_intensity, float small_intensity)
+{
+  if (!s_state.polling_thread.Joinable() ||
+      !s_state.effect_updates.Push(QueuedEffectUpdate{
+        source, {large_key, small_key}, {large_intensity, small_intensity}, QueuedEffectUpdate::Type::DualMotor}))
+  {
+    std::unique_lock lock(s_state.mutex);
+    source->UpdateMotorState(large_key, small_key, large_intensity, small_intensity);
+  }
+}
+
+void InputManager::UpdateLEDState(InputSource* source, InputBindingKey key, float intensity)
+{
+  if (!s_state.polling_thread.Joinable() ||
+      !s_state.effect_updates.Push(QueuedEffectUpdate{source, {key}, {intensity}, QueuedEffectUpdate::Type::LED}))
+  {
+    std::unique_lock lock(s_state.mutex);
+    source->UpdateLEDState(key, intensity);
+  }
+}
+
+void InputManager::ApplyEffectUpdate(const QueuedEffectUpdate& update)
+{
+  switch (update.type)
+  {
+    case QueuedEffectUpdate::Type::Motor:
+      update.source->UpdateMotorState(update.keys[0], update.intensities[0]);
+      break;
+
+    case QueuedEffectUpdate::Type::DualMotor:
+      update.source->UpdateMotorState(update.keys[0], update.keys[1], update.intensities[0], update.intensities[1]);
+      break;
+
+    case QueuedEffectUpdate::Type::LED:
+      update.source->UpdateLEDState(update.keys[0], update.intensities[0]);
+      break;
+
+      DefaultCaseIsUnreachable();
   }
 }
 
@@ -2305,6 +2557,8 @@ void InputManager::ReloadDevices()
 
 void InputManager::CloseSources()
 {
+  StopPollingThread();
+
   std::unique_lock lock(s_state.mutex);
 
   for (u32 i = FIRST_EXTERNAL_INPUT_SOURCE; i < LAST_EXTERNAL_INPUT_SOURCE; i++)
@@ -2323,9 +2577,16 @@ void InputManager::CloseSources()
 
 void InputManager::PollSources()
 {
+  if (!s_state.deferred_events.empty()) [[unlikely]]
+    DispatchDeferredEvents();
+
+  // also picks up anything left over from a polling thread which has since been stopped
+  DispatchPolledEvents();
+
+  const bool has_polling_thread = s_state.polling_thread.Joinable();
   for (u32 i = FIRST_EXTERNAL_INPUT_SOURCE; i < LAST_EXTERNAL_INPUT_SOURCE; i++)
   {
-    if (s_state.input_sources[i])
+    if (s_state.input_sources[i] && !(has_polling_thread && IsPolledOnPollingThread(i)))
       s_state.input_sources[i]->PollEvents();
   }
 
@@ -2339,6 +2600,103 @@ void InputManager::PollSources()
   }
 }
 
+void InputManager::PollSourcesForPadRead()
+{
+  // Only the external sources are polled, pointer deltas and macros stay once per frame.
+  s_state.late_polling = true;
+  DispatchPolledEvents();
+
+  const bool has_polling_thread = s_state.polling_thread.Joinable();
+  for (u32 i = FIRST_EXTERNAL_INPUT_SOURCE; i < LAST_EXTERNAL_INPUT_SOURCE; i++)
+  {
+    if (s_state.input_sources[i] && !(has_polling_thread && IsPolledOnPollingThread(i)))
+      s_state.input_sources[i]->PollEvents();
+  }
+  s_state.late_polling = false;
+}
+
+bool InputManager::IsPolledOnPollingThread(u32 source_index)
+{
+  // Raw input messages go to the window's thread, so that has to stay on the core thread.
+#ifdef _WIN32
+  return (source_index != static_cast<u32>(InputSourceType::RawInput));
+#else
+  return true;
+#endif
+}
+
+void InputManager::StartPollingThread()
+{
+  DebugAssert(!s_state.polling_thread.Joinable());
+
+  // anything left over refers to sources which may no longer exist
+  QueuedEffectUpdate update;
+  while (s_state.effect_updates.Pop(&update))
+    ;
+
+  INFO_LOG("Starting input polling thread.");
+  s_state.polling_thread_running.store(true, std::memory_order_release);
+  s_state.polling_thread.Start(&PollingThreadEntryPoint);
+}
+
+void InputManager::StopPollingThread()
+{
+  if (!s_state.polling_thread.Joinable())
+    return;
+
+  INFO_LOG("Stopping input polling thread.");
+  s_state.polling_thread_running.store(false, std::memory_order_release);
+  s_state.polling_thread.Join();
+
+  // send any effects which didn't make it
+  std::unique_lock lock(s_state.mutex);
+  QueuedEffectUpdate update;
+  while (s_state.effect_updates.Pop(&update))
+    ApplyEffectUpdate(update);
+}
+
+void InputManager::PollingThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Input Polling Thread");
+  s_is_polling_thread = true;
+
+  const Timer::Value interval = Timer::ConvertSecondsToValue(POLLING_THREAD_INTERVAL_SECONDS);
+  Timer::Value next_poll_time = Timer::GetCurrentValue();
+  while (s_state.polling_thread_running.load(std::memory_order_acquire))
+  {
+    {
+      std::unique_lock lock(s_state.mutex);
+
+      QueuedEffectUpdate update;
+      while (s_state.effect_updates.Pop(&update))
+        ApplyEffectUpdate(update);
+
+      // if the core thread is stalled, leave events with the sources rather than risk dropping them
+      if (s_state.polled_events.GetFreeSpace() >= POLLING_THREAD_MIN_FREE_EVENTS)
+      {
+        for (u32 i = FIRST_EXTERNAL_INPUT_SOURCE; i < LAST_EXTERNAL_INPUT_SOURCE; i++)
+        {
+          if (s_state.input_sources[i] && IsPolledOnPollingThread(i))
+            s_state.input_sources[i]->PollEvents();
+        }
+      }
+    }
+
+    // don't try to catch up after a long stall
+    next_poll_time = std::max(next_poll_time + interval, Timer::GetCurrentValue());
+    Timer::SleepUntil(next_poll_time, false);
+  }
+
+  s_is_polling_thread = false;
+}
+
+void InputManager::DispatchPolledEvents()
+{
+  PolledInputEvent event;
+  while (s_state.polled_events.Pop(&event))
+    InvokeEvents(event.key, event.value, event.generic_key);
+}
+
 InputManager::DeviceList InputManager::EnumerateDevices()
 {
   std::unique_lock lock(s_state.mutex);
@@ -2510,6 +2868,9 @@ void InputManager::ReloadSourcesAndBindings(const SettingsInterface& sources_si,
                                             const SettingsInterface& hotkey_binding_si,
                                             std::unique_lock<std::mutex>& settings_lock)
 {
+  // sources can't change under the polling thread
+  StopPollingThread();
+
   std::unique_lock lock(s_state.mutex);
 
 #ifdef _WIN32
@@ -2542,6 +2903,18 @@ void InputManager::ReloadSourcesAndBindings(const SettingsInterface& sources_si,
 
   InternalReloadBindings(binding_si, hotkey_binding_si);
   UpdateRelativeMouseMode();
+
+  if (sources_si.GetBoolValue("InputSources", "PollingThread", false))
+  {
+    for (u32 i = FIRST_EXTERNAL_INPUT_SOURCE; i < LAST_EXTERNAL_INPUT_SOURCE; i++)
+    {
+      if (s_state.input_sources[i] && IsPolledOnPollingThread(i))
+      {
+        StartPollingThread();
+        break;
+      }
+    }
+  }
 }
 
 #ifdef _WIN32
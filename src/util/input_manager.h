@@ -288,9 +288,14 @@ void ReloadSourcesAndBindings(const SettingsInterface& sources_si, const Setting
 /// Shuts down any enabled input sources.
 void CloseSources();
 
-/// Polls input sources for events (e.g. external controllers).
+/// Polls input sources for events (e.g. external controllers). If the polling thread is enabled
+/// (InputSources/PollingThread), this dispatches the events it has collected instead.
 void PollSources();
 
+/// Polls input sources again just before the emulated pad is read, to cut latency. Only pad bindings are updated
+/// immediately, events for anything else (e.g. hotkeys) are held back until the next PollSources().
+void PollSourcesForPadRead();
+
 /// Returns true if any bindings exist for the specified key.
 /// Can be safely called on another thread.
 bool HasAnyBindingsForKey(InputBindingKey key);
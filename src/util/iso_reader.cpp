@@ -45,6 +45,14 @@ bool IsoReader::Open(CDImage* image, u32 track_number, Error* error)
 
 bool IsoReader::ReadSector(std::span<u8, SECTOR_SIZE> buf, u32 lsn, Error* error)
 {
+  return ReadExtent(lsn, 1, ReadMode::Data, buf, error);
+}
+
+bool IsoReader::ReadExtent(u32 lsn, u32 num_sectors, ReadMode read_mode, std::span<u8> dst, Error* error)
+{
+  const u32 sector_size = GetReadModeSectorSize(read_mode);
+  DebugAssert(dst.size() >= (static_cast<size_t>(num_sectors) * sector_size));
+
   if (!m_image->Seek(m_track_number, lsn))
   {
     Error::SetStringFmt(error, "Failed to seek to LSN #{}", lsn);
@@ -52,16 +60,34 @@ bool IsoReader::ReadSector(std::span<u8, SECTOR_SIZE> buf, u32 lsn, Error* error
   }
 
   std::array<u8, CDImage::RAW_SECTOR_SIZE> raw_sector;
-  std::span<const u8> sector_data;
-  if (!m_image->ReadRawSector(raw_sector.data(), nullptr) ||
-      (sector_data = ExtractSectorData(raw_sector, ReadMode::Data, error)).empty())
+  u8* dst_ptr = dst.data();
+  for (u32 i = 0; i < num_sectors; i++)
   {
-    Error::SetStringFmt(error, "Failed to read LSN #{}: ", lsn);
-    return false;
+    // Mapped images hand out the sector directly, so only the extracted data gets copied.
+    const u8* raw_ptr = m_image->ReadRawSectorInPlace(nullptr);
+    if (!raw_ptr)
+    {
+      if (!m_image->ReadRawSector(raw_sector.data(), nullptr))
+      {
+        Error::SetStringFmt(error, "Failed to read LSN #{}", lsn + i);
+        return false;
+      }
+
+      raw_ptr = raw_sector.data();
+    }
+
+    const std::span<const u8> sector_data =
+      ExtractSectorData(std::span<const u8>(raw_ptr, CDImage::RAW_SECTOR_SIZE), read_mode, error);
+    if (sector_data.empty())
+    {
+      Error::AddPrefixFmt(error, "Failed to read LSN #{}: ", lsn + i);
+      return false;
+    }
+
+    std::memcpy(dst_ptr, sector_data.data(), sector_size);
+    dst_ptr += sector_size;
   }
 
-  Assert(buf.size() == SECTOR_SIZE);
-  std::memcpy(buf.data(), sector_data.data(), SECTOR_SIZE);
   return true;
 }
 
@@ -442,32 +468,12 @@ bool IsoReader::ReadFile(const ISODirectoryEntry& de, std::vector<u8>* data, Rea
     return true;
   }
 
-  if (!m_image->Seek(1, de.location_le))
-  {
-    Error::SetStringFmt(error, "Failed to seek to LSN #{}", de.location_le);
-    return false;
-  }
-
   // NOTE: ISO uses 2048 byte "sectors" in the directory listing regardless of the file mode.
   const u32 sector_size = GetReadModeSectorSize(read_mode);
   const u32 num_sectors = de.GetSizeInSectors();
   data->resize(num_sectors * sector_size);
-
-  std::array<u8, CDImage::RAW_SECTOR_SIZE> raw_sector;
-  size_t data_offset = 0;
-  for (u32 i = 0; i < num_sectors; i++)
-  {
-    std::span<const u8> sector_data;
-    if (!m_image->ReadRawSector(raw_sector.data(), nullptr) ||
-        (sector_data = ExtractSectorData(raw_sector, read_mode, error)).empty())
-    {
-      Error::AddPrefixFmt(error, "Failed to read LSN #{}", de.location_le + i);
-      return false;
-    }
-
-    std::memcpy(data->data() + data_offset, sector_data.data(), sector_data.size());
-    data_offset += sector_data.size();
-  }
+  if (!ReadExtent(de.location_le, num_sectors, read_mode, *data, error))
+    return false;
 
   // only shrink for data read mode
   if (read_mode == ReadMode::Data)
@@ -501,38 +507,30 @@ bool IsoReader::WriteFileToStream(const ISODirectoryEntry& de, std::FILE* fp, Re
   if (de.length_le == 0)
     return FileSystem::FTruncate64(fp, 0, error);
 
-  if (!m_image->Seek(1, de.location_le))
-  {
-    Error::SetStringFmt(error, "Failed to seek to LSN #{}", de.location_le);
-    return false;
-  }
-
   if (progress)
   {
     progress->SetProgressRange(de.length_le);
     progress->SetProgressValue(0);
   }
 
+  // Read in chunks, rather than writing each sector individually.
+  static constexpr u32 CHUNK_SECTORS = 32;
   const u32 num_sectors = de.GetSizeInSectors();
-
-  std::array<u8, CDImage::RAW_SECTOR_SIZE> raw_sector;
+  const u32 sector_size = GetReadModeSectorSize(read_mode);
+  std::vector<u8> chunk(CHUNK_SECTORS * sector_size);
   u32 file_pos = 0;
 
-  for (u32 i = 0; i < num_sectors; i++)
+  for (u32 i = 0; i < num_sectors; i += CHUNK_SECTORS)
   {
-    std::span<const u8> sector_data;
-    if (!m_image->ReadRawSector(raw_sector.data(), nullptr) ||
-        (sector_data = ExtractSectorData(raw_sector, read_mode, error)).empty())
-    {
-      Error::AddPrefixFmt(error, "Failed to read LSN #{}", de.location_le + i);
+    const u32 chunk_sectors = std::min(num_sectors - i, CHUNK_SECTORS);
+    if (!ReadExtent(de.location_le + i, chunk_sectors, read_mode, chunk, error))
       return false;
-    }
 
     // only shrink for data mode
-    const u32 write_size = (read_mode == ReadMode::Data) ?
-                             std::min<u32>(de.length_le - file_pos, static_cast<u32>(sector_data.size())) :
-                             static_cast<u32>(sector_data.size());
-    if (std::fwrite(sector_data.data(), write_size, 1, fp) != 1)
+    const u32 chunk_size = chunk_sectors * sector_size;
+    const u32 write_size =
+      (read_mode == ReadMode::Data) ? std::min<u32>(de.length_le - file_pos, chunk_size) : chunk_size;
+    if (std::fwrite(chunk.data(), write_size, 1, fp) != 1)
     {
       Error::SetErrno(error, "fwrite() failed: ", errno);
       return false;
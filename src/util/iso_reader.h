@@ -176,6 +176,9 @@ public:
   bool ReadFile(std::string_view path, std::vector<u8>* data, ReadMode read_mode, Error* error = nullptr);
   bool ReadFile(const ISODirectoryEntry& de, std::vector<u8>* data, ReadMode read_mode, Error* error = nullptr);
 
+  /// Reads a contiguous run of sectors, storing GetReadModeSectorSize() bytes per sector in dst.
+  bool ReadExtent(u32 lsn, u32 num_sectors, ReadMode read_mode, std::span<u8> dst, Error* error = nullptr);
+
   bool WriteFileToStream(std::string_view path, std::FILE* fp, ReadMode read_mode, Error* error = nullptr,
                          ProgressCallback* progress = nullptr);
   bool WriteFileToStream(const ISODirectoryEntry& de, std::FILE* fp, ReadMode read_mode, Error* error = nullptr,
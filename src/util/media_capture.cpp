@@ -28,6 +28,7 @@
 #include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 #ifdef _WIN32
 #include "common/windows_headers.h"
@@ -82,7 +83,8 @@ class ALIGN_TO_CACHE_LINE MediaCaptureBase : public MediaCapture
 {
 public:
   static constexpr u32 NUM_FRAMES_IN_FLIGHT = 3;
-  static constexpr u32 MAX_PENDING_FRAMES = NUM_FRAMES_IN_FLIGHT * 2;
+  static constexpr u32 MIN_PENDING_FRAMES = NUM_FRAMES_IN_FLIGHT * 2;
+  static constexpr u32 MAX_PENDING_FRAMES = 60;
   static constexpr u32 AUDIO_CHANNELS = 2;
 
   virtual ~MediaCaptureBase() override;
@@ -98,11 +100,18 @@ public:
   u32 GetVideoHeight() const override final;
   float GetVideoFPS() const override final;
 
+  void SetVideoQueueOptions(u32 depth, bool drop_frames) override final;
+  u32 GetVideoQueueDepth() const override final;
+  u32 GetVideoQueueFill() const override final;
+  u32 GetDroppedVideoFrames() const override final;
+
   float GetCaptureThreadUsage() const override final;
   float GetCaptureThreadTime() const override final;
   void UpdateCaptureThreadUsage(double pct_divider, double time_divider) override final;
 
   GPUTexture* GetRenderTexture() override final;
+  PlanarFormat GetPlanarFormat() const override final;
+  GPUTexture* GetPlanarRenderTexture() override final;
   bool DeliverVideoFrame(GPUTexture* stex) override final;
   bool DeliverAudioFrames(const s16* frames, u32 num_frames) override final;
   bool EndCapture(Error* error) override final;
@@ -135,6 +144,9 @@ protected:
   void StopEncoderThread(std::unique_lock<std::mutex>& lock);
   void DeleteOutputFile();
 
+  /// Copies the luma and chroma planes out of a frame that was converted on the GPU.
+  void CopyPlanarFrame(const PendingFrame& pf, u8* const* planes, const u32* strides) const;
+
   virtual void ClearState();
   virtual bool SendFrame(const PendingFrame& pf, Error* error) = 0;
   virtual bool ProcessAudioPackets(s64 video_pts, Error* error) = 0;
@@ -156,6 +168,8 @@ protected:
   float m_video_fps = 0;
   s64 m_next_video_pts = 0;
   std::unique_ptr<GPUTexture> m_render_texture;
+  std::unique_ptr<GPUTexture> m_planar_render_texture;
+  PlanarFormat m_planar_format = PlanarFormat::None;
 
   s64 m_next_audio_pts = 0;
   u32 m_audio_frame_pos = 0;
@@ -168,7 +182,10 @@ protected:
 
   std::condition_variable m_frame_ready_cv;
   std::condition_variable m_frame_encoded_cv;
-  std::array<PendingFrame, MAX_PENDING_FRAMES> m_pending_frames = {};
+  std::vector<PendingFrame> m_pending_frames;
+  u32 m_max_pending_frames = MIN_PENDING_FRAMES;
+  bool m_drop_frames_when_full = false;
+  std::atomic<u32> m_dropped_video_frames{0};
   u32 m_pending_frames_pos = 0;
   u32 m_frames_pending_map = 0;
   u32 m_frames_map_consume_pos = 0;
@@ -209,11 +226,12 @@ bool MediaCaptureBase::BeginCapture(float fps, float aspect, u32 width, u32 heig
   }
 
   m_path = std::move(path);
+  m_pending_frames.resize(m_max_pending_frames);
   m_capturing.store(true, std::memory_order_release);
 
   // allocate audio buffer, dynamic based on sample rate
   if (capture_audio)
-    m_audio_buffer.resize(sample_rate * MAX_PENDING_FRAMES * AUDIO_CHANNELS);
+    m_audio_buffer.resize(sample_rate * m_max_pending_frames * AUDIO_CHANNELS);
 
   INFO_LOG("Initializing capture:");
   if (capture_video)
@@ -254,6 +272,28 @@ GPUTexture* MediaCaptureBase::GetRenderTexture()
   return m_render_texture.get();
 }
 
+MediaCapture::PlanarFormat MediaCaptureBase::GetPlanarFormat() const
+{
+  return m_planar_format;
+}
+
+GPUTexture* MediaCaptureBase::GetPlanarRenderTexture()
+{
+  if (m_planar_render_texture) [[likely]]
+    return m_planar_render_texture.get();
+
+  const u32 height = m_video_height + (m_video_height / 2);
+  m_planar_render_texture = g_gpu_device->CreateTexture(m_video_width, height, 1, 1, 1, GPUTexture::Type::RenderTarget,
+                                                        GPUTextureFormat::R8, GPUTexture::Flags::None);
+  if (!m_planar_render_texture) [[unlikely]]
+  {
+    ERROR_LOG("Failed to create {}x{} planar render texture.", m_video_width, height);
+    return nullptr;
+  }
+
+  return m_planar_render_texture.get();
+}
+
 bool MediaCaptureBase::DeliverVideoFrame(GPUTexture* stex)
 {
   std::unique_lock lock(m_lock);
@@ -271,11 +311,20 @@ bool MediaCaptureBase::DeliverVideoFrame(GPUTexture* stex)
   DebugAssert(pf.state != PendingFrame::State::NeedsMap);
   if (pf.state == PendingFrame::State::NeedsEncoding)
   {
+    if (m_drop_frames_when_full)
+    {
+      // Don't stall the GPU thread. The PTS still advances, so the previous frame is shown for longer instead, and
+      // the video doesn't drift from the audio.
+      m_next_video_pts++;
+      m_dropped_video_frames.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+
     m_frame_encoded_cv.wait(lock, [&pf]() { return pf.state == PendingFrame::State::Unused; });
   }
 
   if (!pf.tex || pf.tex->GetWidth() != static_cast<u32>(stex->GetWidth()) ||
-      pf.tex->GetHeight() != static_cast<u32>(stex->GetHeight()))
+      pf.tex->GetHeight() != static_cast<u32>(stex->GetHeight()) || pf.tex->GetFormat() != stex->GetFormat())
   {
     pf.tex.reset();
     pf.tex = g_gpu_device->CreateDownloadTexture(stex->GetWidth(), stex->GetHeight(), stex->GetFormat());
@@ -288,11 +337,11 @@ bool MediaCaptureBase::DeliverVideoFrame(GPUTexture* stex)
     GL_OBJECT_NAME_FMT(pf.tex, "MediaCapture {}x{} Download Texture", stex->GetWidth(), stex->GetHeight());
   }
 
-  pf.tex->CopyFromTexture(0, 0, stex, 0, 0, m_video_width, m_video_height, 0, 0);
+  pf.tex->CopyFromTexture(0, 0, stex, 0, 0, stex->GetWidth(), stex->GetHeight(), 0, 0);
   pf.pts = m_next_video_pts++;
   pf.state = PendingFrame::State::NeedsMap;
 
-  m_pending_frames_pos = (m_pending_frames_pos + 1) % MAX_PENDING_FRAMES;
+  m_pending_frames_pos = (m_pending_frames_pos + 1) % m_max_pending_frames;
   m_frames_pending_map++;
   return true;
 }
@@ -313,14 +362,14 @@ void MediaCaptureBase::ProcessFramePendingMap(std::unique_lock<std::mutex>& lock
 
   // Even if the map failed, we need to kick it to the encode thread anyway, because
   // otherwise our queue indices will get desynchronized.
-  if (!pf.tex->Map(0, 0, m_video_width, m_video_height))
+  if (!pf.tex->Map(0, 0, pf.tex->GetWidth(), pf.tex->GetHeight()))
     WARNING_LOG("Failed to map previously flushed frame.");
 
   lock.lock();
 
   // Kick to encoder thread!
   pf.state = PendingFrame::State::NeedsEncoding;
-  m_frames_map_consume_pos = (m_frames_map_consume_pos + 1) % MAX_PENDING_FRAMES;
+  m_frames_map_consume_pos = (m_frames_map_consume_pos + 1) % m_max_pending_frames;
   m_frames_pending_map--;
   m_frames_pending_encode++;
   m_frame_ready_cv.notify_one();
@@ -366,7 +415,7 @@ void MediaCaptureBase::EncoderThreadEntryPoint()
 
     // Done with this frame! Wait for the next.
     pf.state = PendingFrame::State::Unused;
-    m_frames_encode_consume_pos = (m_frames_encode_consume_pos + 1) % MAX_PENDING_FRAMES;
+    m_frames_encode_consume_pos = (m_frames_encode_consume_pos + 1) % m_max_pending_frames;
     m_frames_pending_encode--;
     m_frame_encoded_cv.notify_all();
   }
@@ -448,7 +497,7 @@ bool MediaCaptureBase::DeliverAudioFrames(const s16* frames, u32 num_frames)
 
     PendingFrame& pf = m_pending_frames[m_pending_frames_pos];
     pf.state = PendingFrame::State::NeedsEncoding;
-    m_pending_frames_pos = (m_pending_frames_pos + 1) % MAX_PENDING_FRAMES;
+    m_pending_frames_pos = (m_pending_frames_pos + 1) % m_max_pending_frames;
 
     m_frames_pending_encode++;
     m_frame_ready_cv.notify_one();
@@ -475,7 +524,7 @@ void MediaCaptureBase::ClearState()
   m_next_video_pts = 0;
   m_next_audio_pts = 0;
 
-  m_pending_frames = {};
+  m_pending_frames.clear();
   m_pending_frames_pos = 0;
   m_frames_pending_map = 0;
   m_frames_map_consume_pos = 0;
@@ -490,11 +539,45 @@ void MediaCaptureBase::ClearState()
   m_audio_buffer.deallocate();
 
   m_encoding_error.store(false, std::memory_order_release);
+  m_dropped_video_frames.store(0, std::memory_order_relaxed);
+  m_planar_format = PlanarFormat::None;
+}
+
+void MediaCaptureBase::CopyPlanarFrame(const PendingFrame& pf, u8* const* planes, const u32* strides) const
+{
+  const u8* src = pf.tex->GetMapPointer();
+  const u32 src_pitch = pf.tex->GetMapPitch();
+  const u32 chroma_width = m_video_width / 2;
+  const u32 chroma_height = m_video_height / 2;
+
+  for (u32 row = 0; row < m_video_height; row++, src += src_pitch)
+    std::memcpy(planes[0] + row * strides[0], src, m_video_width);
+
+  if (m_planar_format == PlanarFormat::NV12)
+  {
+    for (u32 row = 0; row < chroma_height; row++, src += src_pitch)
+      std::memcpy(planes[1] + row * strides[1], src, m_video_width);
+  }
+  else
+  {
+    // Each texture row holds two consecutive rows of the U or V plane.
+    for (u32 plane = 1; plane <= 2; plane++)
+    {
+      for (u32 row = 0; row < chroma_height; row += 2, src += src_pitch)
+      {
+        std::memcpy(planes[plane] + row * strides[plane], src, chroma_width);
+        std::memcpy(planes[plane] + (row + 1) * strides[plane], src + chroma_width, chroma_width);
+      }
+    }
+  }
 }
 
 bool MediaCaptureBase::EndCapture(Error* error)
 {
   std::unique_lock lock(m_lock);
+  if (const u32 dropped_frames = m_dropped_video_frames.load(std::memory_order_relaxed); dropped_frames > 0)
+    WARNING_LOG("{} video frames were dropped because the encoder could not keep up.", dropped_frames);
+
   if (!InternalEndCapture(lock, error))
   {
     DeleteOutputFile();
@@ -554,6 +637,29 @@ float MediaCaptureBase::GetVideoFPS() const
   return m_video_fps;
 }
 
+void MediaCaptureBase::SetVideoQueueOptions(u32 depth, bool drop_frames)
+{
+  DebugAssert(!m_capturing.load(std::memory_order_acquire));
+  m_max_pending_frames = std::clamp(depth, MIN_PENDING_FRAMES, MAX_PENDING_FRAMES);
+  m_drop_frames_when_full = drop_frames;
+}
+
+u32 MediaCaptureBase::GetVideoQueueDepth() const
+{
+  return m_max_pending_frames;
+}
+
+u32 MediaCaptureBase::GetVideoQueueFill() const
+{
+  std::unique_lock lock(m_lock);
+  return m_frames_pending_map + m_frames_pending_encode;
+}
+
+u32 MediaCaptureBase::GetDroppedVideoFrames() const
+{
+  return m_dropped_video_frames.load(std::memory_order_relaxed);
+}
+
 float MediaCaptureBase::GetCaptureThreadUsage() const
 {
   return m_encoder_thread_usage;
@@ -885,6 +991,9 @@ bool MediaCaptureMF::InternalBeginCapture(float fps, float aspect, u32 sample_ra
 
     m_video_sample_duration = ConvertFrequencyToMFDurationUnits(fps);
 
+    // The YUV transform's output type is still needed to configure the encoder, even if the GPU does the conversion.
+    m_planar_format = PlanarFormat::NV12;
+
     ComPtr<IMFMediaType> yuv_media_type;
     if (!(m_video_yuv_transform =
             CreateVideoYUVTransform(&yuv_media_type, frame_rate_numerator, FRAME_RATE_DENOMERATOR, error)) ||
@@ -1310,8 +1419,10 @@ void MediaCaptureMF::ClearState()
 
 bool MediaCaptureMF::SendFrame(const PendingFrame& pf, Error* error)
 {
-  const u32 buffer_stride = m_video_width * sizeof(u32);
-  const u32 buffer_size = buffer_stride * m_video_height;
+  const bool planar = (m_planar_format != PlanarFormat::None);
+  const u32 buffer_stride = planar ? m_video_width : (m_video_width * sizeof(u32));
+  const u32 buffer_size = planar ? (buffer_stride * (m_video_height + (m_video_height / 2))) :
+                                   (buffer_stride * m_video_height);
 
   HRESULT hr;
   ComPtr<IMFMediaBuffer> buffer;
@@ -1328,8 +1439,17 @@ bool MediaCaptureMF::SendFrame(const PendingFrame& pf, Error* error)
     return false;
   }
 
-  ConvertVideoFrame(buffer_data, buffer_stride, pf.tex->GetMapPointer(), pf.tex->GetMapPitch(), m_video_width,
-                    m_video_height);
+  if (planar)
+  {
+    u8* const planes[2] = {buffer_data, buffer_data + buffer_stride * m_video_height};
+    const u32 strides[2] = {buffer_stride, buffer_stride};
+    CopyPlanarFrame(pf, planes, strides);
+  }
+  else
+  {
+    ConvertVideoFrame(buffer_data, buffer_stride, pf.tex->GetMapPointer(), pf.tex->GetMapPitch(), m_video_width,
+                      m_video_height);
+  }
   buffer->Unlock();
 
   if (FAILED(hr = buffer->SetCurrentLength(buffer_size))) [[unlikely]]
@@ -1367,6 +1487,13 @@ bool MediaCaptureMF::SendFrame(const PendingFrame& pf, Error* error)
     return false;
   }
 
+  // Already NV12 if it was converted on the GPU, so it can go straight to the encoder.
+  if (planar)
+  {
+    m_pending_video_samples.push_back(std::move(sample));
+    return m_video_encode_event_generator ? ProcessVideoEvents(error) : ProcessVideoOutputSamples(error);
+  }
+
   //////////////////////////////////////////////////////////////////////////
   // RGB -> YUV
   //////////////////////////////////////////////////////////////////////////
@@ -1925,6 +2052,7 @@ private:
 
   bool IsUsingHardwareVideoEncoding();
 
+  bool ConvertVideoFrame(const PendingFrame& pf, Error* error);
   bool ReceivePackets(AVCodecContext* codec_context, AVStream* stream, AVPacket* packet, Error* error);
 
   AVFormatContext* m_format_context = nullptr;
@@ -1933,6 +2061,7 @@ private:
   AVStream* m_video_stream = nullptr;
   AVFrame* m_converted_video_frame = nullptr; // YUV
   AVFrame* m_hw_video_frame = nullptr;
+  bool m_upload_from_readback = false;
   AVPacket* m_video_packet = nullptr;
   SwsContext* m_sws_context = nullptr;
   AVDictionary* m_video_codec_arguments = nullptr;
@@ -2207,17 +2336,20 @@ bool MediaCaptureFFmpeg::InternalBeginCapture(float fps, float aspect, u32 sampl
 
     // Select output pixel format.
     AVPixelFormat request_pix_fmt = AV_PIX_FMT_YUV420P;
+    bool pix_fmt_overridden = false;
     if (const AVDictionaryEntry* de = wrap_av_dict_get(m_video_codec_arguments, "pixel_format", nullptr, 0))
     {
       const AVPixelFormat de_fmt = wrap_av_get_pix_fmt(de->value);
       request_pix_fmt = (de_fmt != AV_PIX_FMT_NONE) ? de_fmt : request_pix_fmt;
+      pix_fmt_overridden = (de_fmt != AV_PIX_FMT_NONE);
       if (de_fmt == AV_PIX_FMT_NONE)
         WARNING_LOG("Invalid pixel format override: {}", de->value);
     }
 
-    // Can we use hardware encoding?
+    // Can we use hardware encoding? Hardware frames all take NV12 natively, which the GPU conversion also
+    // produces in exactly the layout the upload wants.
     const AVCodecHWConfig* hwconfig = wrap_avcodec_get_hw_config(vcodec, 0);
-    AVPixelFormat sw_pix_fmt = request_pix_fmt;
+    AVPixelFormat sw_pix_fmt = (hwconfig && !pix_fmt_overridden) ? AV_PIX_FMT_NV12 : request_pix_fmt;
     if (hwconfig)
     {
       // Can't do this test for hardware codecs, because they don't list the software formats as inputs.
@@ -2312,6 +2444,15 @@ bool MediaCaptureFFmpeg::InternalBeginCapture(float fps, float aspect, u32 sampl
       m_video_codec_context->pix_fmt = sw_pix_fmt;
     }
 
+    // Let the GPU produce 4:2:0 frames directly when that's what the encoder wants, instead of going through swscale.
+    // The conversion uses the same BT.601 limited range coefficients as swscale's defaults.
+    if (sw_pix_fmt == AV_PIX_FMT_NV12 || sw_pix_fmt == AV_PIX_FMT_YUV420P)
+    {
+      m_planar_format = (sw_pix_fmt == AV_PIX_FMT_NV12) ? PlanarFormat::NV12 : PlanarFormat::I420;
+      m_video_codec_context->color_range = AVCOL_RANGE_MPEG;
+      m_video_codec_context->colorspace = AVCOL_SPC_SMPTE170M;
+    }
+
     if (output_format->flags & AVFMT_GLOBALHEADER)
       m_video_codec_context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
 
@@ -2333,11 +2474,17 @@ bool MediaCaptureFFmpeg::InternalBeginCapture(float fps, float aspect, u32 sampl
     m_converted_video_frame->format = sw_pix_fmt;
     m_converted_video_frame->width = m_video_codec_context->width;
     m_converted_video_frame->height = m_video_codec_context->height;
-    res = wrap_av_frame_get_buffer(m_converted_video_frame, 0);
-    if (res < 0)
+
+    // NV12 frames for hardware encoders are uploaded straight from the mapped readback, so they need no buffer.
+    m_upload_from_readback = (IsUsingHardwareVideoEncoding() && m_planar_format == PlanarFormat::NV12);
+    if (!m_upload_from_readback)
     {
-      SetAVError(error, "av_frame_get_buffer() for converted frame failed: ", res);
-      return false;
+      res = wrap_av_frame_get_buffer(m_converted_video_frame, 0);
+      if (res < 0)
+      {
+        SetAVError(error, "av_frame_get_buffer() for converted frame failed: ", res);
+        return false;
+      }
     }
 
     if (IsUsingHardwareVideoEncoding())
@@ -2633,6 +2780,7 @@ void MediaCaptureFFmpeg::ClearState()
     wrap_av_frame_free(&m_converted_video_frame);
   if (m_hw_video_frame)
     wrap_av_frame_free(&m_hw_video_frame);
+  m_upload_from_readback = false;
   if (m_video_hw_frames)
     wrap_av_buffer_unref(&m_video_hw_frames);
   if (m_video_hw_context)
@@ -2696,7 +2844,7 @@ bool MediaCaptureFFmpeg::ReceivePackets(AVCodecContext* codec_context, AVStream*
   return true;
 }
 
-bool MediaCaptureFFmpeg::SendFrame(const PendingFrame& pf, Error* error)
+bool MediaCaptureFFmpeg::ConvertVideoFrame(const PendingFrame& pf, Error* error)
 {
   const u8* source_ptr = pf.tex->GetMapPointer();
   const int source_width = static_cast<int>(pf.tex->GetWidth());
@@ -2710,9 +2858,6 @@ bool MediaCaptureFFmpeg::SendFrame(const PendingFrame& pf, Error* error)
     source_pitch = -source_pitch;
   }
 
-  // In case a previous frame is still using the frame.
-  wrap_av_frame_make_writable(m_converted_video_frame);
-
   m_sws_context = wrap_sws_getCachedContext(m_sws_context, source_width, source_height, m_video_pixel_format,
                                             m_converted_video_frame->width, m_converted_video_frame->height,
                                             static_cast<AVPixelFormat>(m_converted_video_frame->format), SWS_BICUBIC,
@@ -2725,6 +2870,37 @@ bool MediaCaptureFFmpeg::SendFrame(const PendingFrame& pf, Error* error)
 
   wrap_sws_scale(m_sws_context, reinterpret_cast<const u8**>(&source_ptr), &source_pitch, 0, source_height,
                  m_converted_video_frame->data, m_converted_video_frame->linesize);
+  return true;
+}
+
+bool MediaCaptureFFmpeg::SendFrame(const PendingFrame& pf, Error* error)
+{
+  if (m_upload_from_readback)
+  {
+    // The transfer below is the only copy, the frame memory doesn't need to outlive it.
+    const u32 pitch = pf.tex->GetMapPitch();
+    m_converted_video_frame->data[0] = const_cast<u8*>(pf.tex->GetMapPointer());
+    m_converted_video_frame->data[1] = m_converted_video_frame->data[0] + pitch * m_video_height;
+    m_converted_video_frame->linesize[0] = static_cast<int>(pitch);
+    m_converted_video_frame->linesize[1] = static_cast<int>(pitch);
+  }
+  else
+  {
+    // In case a previous frame is still using the frame.
+    wrap_av_frame_make_writable(m_converted_video_frame);
+
+    if (m_planar_format != PlanarFormat::None)
+    {
+      const u32 strides[3] = {static_cast<u32>(m_converted_video_frame->linesize[0]),
+                              static_cast<u32>(m_converted_video_frame->linesize[1]),
+                              static_cast<u32>(m_converted_video_frame->linesize[2])};
+      CopyPlanarFrame(pf, m_converted_video_frame->data, strides);
+    }
+    else if (!ConvertVideoFrame(pf, error))
+    {
+      return false;
+    }
+  }
 
   AVFrame* frame_to_send = m_converted_video_frame;
   if (IsUsingHardwareVideoEncoding())
@@ -35,6 +35,16 @@ public:
   using CodecName = std::pair<std::string, std::string>; // configname,longname
   using CodecList = std::vector<CodecName>;
 
+  /// YUV layouts which the GPU can convert frames to before they are downloaded. Both are packed into a single R8
+  /// texture of width x (height * 3 / 2), with the luma plane in the first height rows. NV12 follows it with
+  /// interleaved U/V rows, I420 with the U then V planes, two half-width chroma rows to each texture row.
+  enum class PlanarFormat : u8
+  {
+    None,
+    NV12,
+    I420,
+  };
+
   static std::optional<MediaCaptureBackend> ParseBackendName(const char* str);
   static const char* GetBackendName(MediaCaptureBackend backend);
   static const char* GetBackendDisplayName(MediaCaptureBackend backend);
@@ -66,11 +76,27 @@ public:
   /// Returns the elapsed time in seconds.
   virtual time_t GetElapsedTime() const = 0;
 
+  /// Sets how many frames can be queued between the GPU and the encoder, and whether frames are dropped instead of
+  /// waiting for the encoder when the queue is full. Must be called before BeginCapture().
+  virtual void SetVideoQueueOptions(u32 depth, bool drop_frames) = 0;
+
+  /// Returns the number of frames waiting to be read back or encoded, out of the queue depth.
+  virtual u32 GetVideoQueueDepth() const = 0;
+  virtual u32 GetVideoQueueFill() const = 0;
+
+  /// Returns the number of frames which were dropped because the encoder fell behind.
+  virtual u32 GetDroppedVideoFrames() const = 0;
+
   virtual float GetCaptureThreadUsage() const = 0;
   virtual float GetCaptureThreadTime() const = 0;
   virtual void UpdateCaptureThreadUsage(double pct_divider, double time_divider) = 0;
 
   virtual GPUTexture* GetRenderTexture() = 0;
+
+  /// Returns the layout the encoder takes frames in, if None, the render texture is delivered directly.
+  virtual PlanarFormat GetPlanarFormat() const = 0;
+  virtual GPUTexture* GetPlanarRenderTexture() = 0;
+
   virtual bool DeliverVideoFrame(GPUTexture* stex) = 0;
   virtual bool DeliverAudioFrames(const s16* frames, u32 num_frames) = 0;
   virtual void Flush() = 0;
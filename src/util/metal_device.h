@@ -400,6 +400,7 @@ private:
 
   void PreDrawCheck();
   void SetInitialEncoderState();
+  void FlushTextureSamplerBindings();
   void PushRenderUniformBuffer(const void* data, u32 data_size);
   void SubmitDrawIndexedWithBarrier(u32 index_count, u32 base_index, u32 base_vertex, DrawBarrier type);
   void SetViewportInRenderEncoder();
@@ -423,6 +424,7 @@ private:
   std::deque<std::pair<u64, id>> m_cleanup_objects; // [fence_counter, object]
 
   DepthStateMap m_depth_states;
+  std::mutex m_depth_states_mutex;
 
   MetalStreamBuffer m_vertex_buffer;
   MetalStreamBuffer m_index_buffer;
@@ -454,6 +456,8 @@ private:
 
   std::array<id<MTLTexture>, MAX_TEXTURE_SAMPLERS> m_current_textures = {};
   std::array<id<MTLSamplerState>, MAX_TEXTURE_SAMPLERS> m_current_samplers = {};
+  u32 m_dirty_textures = 0; // bitmask of slots changed since the last render encoder bind
+  u32 m_dirty_samplers = 0;
   id<MTLBuffer> m_current_ssbo = nil;
   GSVector4i m_current_viewport = {};
   GSVector4i m_current_scissor = {};
@@ -18,6 +18,7 @@
 #include "fmt/format.h"
 
 #include <array>
+#include <bit>
 #include <mach/mach_time.h>
 #include <pthread.h>
 
@@ -408,6 +409,7 @@ void MetalDevice::SetFeatures(CreateFlags create_flags)
   m_features.timed_present = true;
   m_features.shader_cache = true;
   m_features.pipeline_cache = false;
+  m_features.threaded_pipeline_creation = true;
   m_features.prefer_unused_textures = true;
 
   // Same feature bit for both.
@@ -859,7 +861,12 @@ std::unique_ptr<GPUPipeline> MetalDevice::CreatePipeline(const GPUPipeline::Grap
     desc.inputPrimitiveTopology = primitive_classes[static_cast<u8>(config.primitive)];
 
     // Depth state
-    id<MTLDepthStencilState> depth = GetDepthState(config.depth);
+    id<MTLDepthStencilState> depth;
+    {
+      // pipelines can be created on multiple threads at once
+      const std::unique_lock lock(m_depth_states_mutex);
+      depth = GetDepthState(config.depth);
+    }
     if (depth == nil)
       return {};
 
@@ -1967,11 +1974,12 @@ void MetalDevice::SetTextureSampler(u32 slot, GPUTexture* texture, GPUSampler* s
     static_cast<MetalTexture*>(texture)->SetUseFenceCounter(m_current_fence_counter);
   }
 
+  // Render pass bindings are deferred until the next draw, and changed slots are set with one call per range.
   if (m_current_textures[slot] != T)
   {
     m_current_textures[slot] = T;
     if (InRenderPass())
-      [m_render_encoder setFragmentTexture:T atIndex:slot];
+      m_dirty_textures |= (1u << slot);
     else if (InComputePass())
       [m_compute_encoder setTexture:T atIndex:slot];
   }
@@ -1981,9 +1989,28 @@ void MetalDevice::SetTextureSampler(u32 slot, GPUTexture* texture, GPUSampler* s
   {
     m_current_samplers[slot] = S;
     if (InRenderPass())
-      [m_render_encoder setFragmentSamplerState:S atIndex:slot];
+      m_dirty_samplers |= (1u << slot);
     else if (InComputePass())
-      [m_compute_encoder setTexture:T atIndex:slot];
+      [m_compute_encoder setSamplerState:S atIndex:slot];
+  }
+}
+
+void MetalDevice::FlushTextureSamplerBindings()
+{
+  if (m_dirty_textures != 0)
+  {
+    const u32 first = std::countr_zero(m_dirty_textures);
+    const u32 count = std::bit_width(m_dirty_textures) - first;
+    [m_render_encoder setFragmentTextures:&m_current_textures[first] withRange:NSMakeRange(first, count)];
+    m_dirty_textures = 0;
+  }
+
+  if (m_dirty_samplers != 0)
+  {
+    const u32 first = std::countr_zero(m_dirty_samplers);
+    const u32 count = std::bit_width(m_dirty_samplers) - first;
+    [m_render_encoder setFragmentSamplerStates:&m_current_samplers[first] withRange:NSMakeRange(first, count)];
+    m_dirty_samplers = 0;
   }
 }
 
@@ -2007,7 +2034,7 @@ void MetalDevice::UnbindTexture(MetalTexture* tex)
     {
       m_current_textures[i] = nil;
       if (InRenderPass())
-        [m_render_encoder setFragmentTexture:nil atIndex:i];
+        m_dirty_textures |= (1u << i);
       else if (InComputePass())
         [m_compute_encoder setTexture:nil atIndex:0];
     }
@@ -2269,6 +2296,8 @@ void MetalDevice::SetInitialEncoderState()
     [m_render_encoder setRenderPipelineState:m_current_pipeline->GetRenderPipelineState()];
   [m_render_encoder setFragmentTextures:m_current_textures.data() withRange:NSMakeRange(0, MAX_TEXTURE_SAMPLERS)];
   [m_render_encoder setFragmentSamplerStates:m_current_samplers.data() withRange:NSMakeRange(0, MAX_TEXTURE_SAMPLERS)];
+  m_dirty_textures = 0;
+  m_dirty_samplers = 0;
 
   if (!m_features.framebuffer_fetch && (m_current_render_pass_flags & GPUPipeline::ColorFeedbackLoop))
   {
@@ -2305,6 +2334,9 @@ void MetalDevice::PreDrawCheck()
 
     BeginRenderPass();
   }
+
+  if ((m_dirty_textures | m_dirty_samplers) != 0)
+    FlushTextureSamplerBindings();
 }
 
 void MetalDevice::PushRenderUniformBuffer(const void* data, u32 data_size)
@@ -699,8 +699,49 @@ void OpenGLDevice::DestroyFramebuffer(GLuint fbo)
     glDeleteFramebuffers(1, &fbo);
 }
 
+bool OpenGLDevice::CreateSharedStreamBuffers()
+{
+  const u32 total_size = VERTEX_BUFFER_SIZE + INDEX_BUFFER_SIZE + UNIFORM_BUFFER_SIZE + PUSH_CONSTANT_BUFFER_SIZE +
+                         (m_disable_pbo ? 0 : TEXTURE_STREAM_BUFFER_SIZE) + (m_uniform_buffer_alignment * 5);
+
+  Error error;
+  if (!(m_shared_stream_buffer = OpenGLSharedStreamBuffer::Create(total_size, &error)))
+  {
+    WARNING_LOG("Failed to create shared stream buffer, using separate buffers: {}", error.GetDescription());
+    return false;
+  }
+
+  const u32 alignment = m_uniform_buffer_alignment;
+  if (!(m_vertex_buffer = m_shared_stream_buffer->CreateStream(GL_ARRAY_BUFFER, VERTEX_BUFFER_SIZE, alignment)) ||
+      !(m_index_buffer = m_shared_stream_buffer->CreateStream(GL_ELEMENT_ARRAY_BUFFER, INDEX_BUFFER_SIZE, alignment)) ||
+      !(m_uniform_buffer = m_shared_stream_buffer->CreateStream(GL_UNIFORM_BUFFER, UNIFORM_BUFFER_SIZE, alignment)) ||
+      !(m_push_constant_buffer =
+          m_shared_stream_buffer->CreateStream(GL_UNIFORM_BUFFER, PUSH_CONSTANT_BUFFER_SIZE, alignment)) ||
+      (!m_disable_pbo && !(m_texture_stream_buffer = m_shared_stream_buffer->CreateStream(
+                             GL_PIXEL_UNPACK_BUFFER, TEXTURE_STREAM_BUFFER_SIZE, alignment)))) [[unlikely]]
+  {
+    ERROR_LOG("Failed to allocate streams from shared buffer.");
+    m_texture_stream_buffer.reset();
+    m_push_constant_buffer.reset();
+    m_uniform_buffer.reset();
+    m_index_buffer.reset();
+    m_vertex_buffer.reset();
+    m_shared_stream_buffer.reset();
+    return false;
+  }
+
+  return true;
+}
+
 bool OpenGLDevice::CreateBuffers()
 {
+  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, reinterpret_cast<GLint*>(&m_uniform_buffer_alignment));
+  m_uniform_buffer_alignment = std::max<GLuint>(m_uniform_buffer_alignment, 16);
+
+  // One persistent buffer means fewer binds and fences, fall back to separate buffers without buffer_storage.
+  if (OpenGLSharedStreamBuffer::IsSupported() && CreateSharedStreamBuffers())
+    return CreateFramebuffers();
+
   if (!(m_vertex_buffer = OpenGLStreamBuffer::Create(GL_ARRAY_BUFFER, VERTEX_BUFFER_SIZE)) ||
       !(m_index_buffer = OpenGLStreamBuffer::Create(GL_ELEMENT_ARRAY_BUFFER, INDEX_BUFFER_SIZE)) ||
       !(m_uniform_buffer = OpenGLStreamBuffer::Create(GL_UNIFORM_BUFFER, UNIFORM_BUFFER_SIZE)) ||
@@ -715,9 +756,6 @@ bool OpenGLDevice::CreateBuffers()
   GL_OBJECT_NAME(m_uniform_buffer, "Device Uniform Buffer");
   GL_OBJECT_NAME(m_push_constant_buffer, "Device Push Constant Buffer");
 
-  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, reinterpret_cast<GLint*>(&m_uniform_buffer_alignment));
-  m_uniform_buffer_alignment = std::max<GLuint>(m_uniform_buffer_alignment, 16);
-
   if (!m_disable_pbo)
   {
     if (!(m_texture_stream_buffer = OpenGLStreamBuffer::Create(GL_PIXEL_UNPACK_BUFFER, TEXTURE_STREAM_BUFFER_SIZE)))
@@ -733,6 +771,11 @@ bool OpenGLDevice::CreateBuffers()
     GL_OBJECT_NAME(m_texture_stream_buffer, "Device Texture Stream Buffer");
   }
 
+  return CreateFramebuffers();
+}
+
+bool OpenGLDevice::CreateFramebuffers()
+{
   GLuint fbos[2];
   glGetError();
   glGenFramebuffers(static_cast<GLsizei>(std::size(fbos)), fbos);
@@ -758,6 +801,7 @@ void OpenGLDevice::DestroyBuffers()
   m_uniform_buffer.reset();
   m_index_buffer.reset();
   m_vertex_buffer.reset();
+  m_shared_stream_buffer.reset();
 }
 
 GPUDevice::PresentResult OpenGLDevice::BeginPresent(GPUSwapChain* swap_chain, u32 clear_color)
@@ -791,6 +835,7 @@ void OpenGLDevice::EndPresent(GPUSwapChain* swap_chain, bool explicit_present, u
   DebugAssert(!explicit_present && present_time == 0);
   DebugAssert(m_current_fbo == 0);
 
+  EndTimingScope();
   if (swap_chain == m_main_swap_chain.get() && m_gpu_timing_enabled)
   {
     PopTimestampQuery();
@@ -817,6 +862,20 @@ void OpenGLDevice::CreateTimestampQueries()
 
   GenQueries(static_cast<u32>(m_timestamp_queries.size()), m_timestamp_queries.data());
   StartTimestampQuery();
+
+  // Not all drivers implement timestamp counters, particularly on GLES, where they're optional.
+  GLint counter_bits = 0;
+  (gles ? glGetQueryivEXT : glGetQueryiv)(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &counter_bits);
+  if (counter_bits > 0)
+  {
+    m_timing_scope_queries.resize(NUM_TIMING_SCOPE_QUERIES);
+    for (TimingScopeQuery& it : m_timing_scope_queries)
+      GenQueries(static_cast<u32>(it.queries.size()), it.queries.data());
+  }
+  else
+  {
+    WARNING_LOG("GL_TIMESTAMP queries are not supported, GPU timing scopes will not be available.");
+  }
 }
 
 void OpenGLDevice::DestroyTimestampQueries()
@@ -827,6 +886,14 @@ void OpenGLDevice::DestroyTimestampQueries()
   const bool gles = m_gl_context->IsGLES();
   const auto DeleteQueries = gles ? glDeleteQueriesEXT : glDeleteQueries;
 
+  EndTimingScope();
+  for (TimingScopeQuery& it : m_timing_scope_queries)
+    DeleteQueries(static_cast<u32>(it.queries.size()), it.queries.data());
+  m_timing_scope_queries.clear();
+  m_read_timing_scope_query = 0;
+  m_write_timing_scope_query = 0;
+  m_waiting_timing_scope_queries = 0;
+
   if (m_timestamp_query_started)
   {
     const auto EndQuery = gles ? glEndQueryEXT : glEndQuery;
@@ -858,6 +925,8 @@ void OpenGLDevice::PopTimestampQuery()
       m_write_timestamp_query = 0;
       m_waiting_timestamp_queries = 0;
       m_timestamp_query_started = false;
+      m_read_timing_scope_query = m_write_timing_scope_query;
+      m_waiting_timing_scope_queries = 0;
     }
   }
 
@@ -876,6 +945,49 @@ void OpenGLDevice::PopTimestampQuery()
     m_read_timestamp_query = (m_read_timestamp_query + 1) % NUM_TIMESTAMP_QUERIES;
     m_waiting_timestamp_queries--;
   }
+
+  PopTimingScopeQueries();
+}
+
+void OpenGLDevice::PopTimingScopeQueries()
+{
+  const bool gles = IsGLES();
+  const auto GetQueryObjectiv = gles ? glGetQueryObjectivEXT : glGetQueryObjectiv;
+  const auto GetQueryObjectui64v = gles ? glGetQueryObjectui64vEXT : glGetQueryObjectui64v;
+  while (m_waiting_timing_scope_queries > 0)
+  {
+    const TimingScopeQuery& it = m_timing_scope_queries[m_read_timing_scope_query];
+    GLint available = 0;
+    GetQueryObjectiv(it.queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+      break;
+
+    u64 start = 0, end = 0;
+    GetQueryObjectui64v(it.queries[0], GL_QUERY_RESULT, &start);
+    GetQueryObjectui64v(it.queries[1], GL_QUERY_RESULT, &end);
+    AccumulateTimingScopeTime(it.name, static_cast<float>(static_cast<double>(end - start) / 1000000.0));
+    m_read_timing_scope_query = (m_read_timing_scope_query + 1) % NUM_TIMING_SCOPE_QUERIES;
+    m_waiting_timing_scope_queries--;
+  }
+}
+
+bool OpenGLDevice::BeginTimingScopeQuery(const char* name)
+{
+  if (m_timing_scope_queries.empty() || m_waiting_timing_scope_queries == NUM_TIMING_SCOPE_QUERIES)
+    return false;
+
+  TimingScopeQuery& it = m_timing_scope_queries[m_write_timing_scope_query];
+  (IsGLES() ? glQueryCounterEXT : glQueryCounter)(it.queries[0], GL_TIMESTAMP);
+  it.name = name;
+  return true;
+}
+
+void OpenGLDevice::EndTimingScopeQuery()
+{
+  TimingScopeQuery& it = m_timing_scope_queries[m_write_timing_scope_query];
+  (IsGLES() ? glQueryCounterEXT : glQueryCounter)(it.queries[1], GL_TIMESTAMP);
+  m_write_timing_scope_query = (m_write_timing_scope_query + 1) % NUM_TIMING_SCOPE_QUERIES;
+  m_waiting_timing_scope_queries++;
 }
 
 void OpenGLDevice::StartTimestampQuery()
@@ -1020,6 +1132,8 @@ void OpenGLDevice::UnbindPipeline(const OpenGLPipeline* pl)
 void OpenGLDevice::Draw(u32 vertex_count, u32 base_vertex)
 {
   s_stats.num_draws++;
+  if (m_shared_stream_buffer)
+    m_shared_stream_buffer->MarkUsed();
 
   if (glDrawElementsBaseVertex) [[likely]]
   {
@@ -1041,6 +1155,8 @@ void OpenGLDevice::DrawWithPushConstants(u32 vertex_count, u32 base_vertex, cons
 void OpenGLDevice::DrawIndexed(u32 index_count, u32 base_index, u32 base_vertex)
 {
   s_stats.num_draws++;
+  if (m_shared_stream_buffer)
+    m_shared_stream_buffer->MarkUsed();
 
   if (glDrawElementsBaseVertex) [[likely]]
   {
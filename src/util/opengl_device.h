@@ -18,6 +18,7 @@
 #include <tuple>
 
 class OpenGLPipeline;
+class OpenGLSharedStreamBuffer;
 class OpenGLStreamBuffer;
 class OpenGLTexture;
 class OpenGLDownloadTexture;
@@ -155,8 +156,12 @@ protected:
   bool CreatePipelineCache(const std::string& path, Error* error) override;
   bool ClosePipelineCache(const std::string& path, Error* error) override;
 
+  bool BeginTimingScopeQuery(const char* name) override;
+  void EndTimingScopeQuery() override;
+
 private:
   static constexpr u8 NUM_TIMESTAMP_QUERIES = 3;
+  static constexpr u32 NUM_TIMING_SCOPE_QUERIES = 512;
 
   static constexpr GLenum UPDATE_TEXTURE_UNIT = GL_TEXTURE8;
 
@@ -168,6 +173,8 @@ private:
 
   bool CheckFeatures(CreateFlags create_flags);
   bool CreateBuffers();
+  bool CreateSharedStreamBuffers();
+  bool CreateFramebuffers();
   void DestroyBuffers();
 
   s32 IsRenderTargetBound(const GPUTexture* tex) const;
@@ -183,6 +190,7 @@ private:
   void PopTimestampQuery();
   void StartTimestampQuery();
   void EndTimestampQuery();
+  void PopTimingScopeQueries();
 
   GLuint CreateProgramFromPipelineCache(const OpenGLPipeline::ProgramCacheItem& it,
                                         const GPUPipeline::GraphicsConfig& plconfig);
@@ -197,6 +205,7 @@ private:
 
   std::unique_ptr<OpenGLContext> m_gl_context;
 
+  std::unique_ptr<OpenGLSharedStreamBuffer> m_shared_stream_buffer;
   std::unique_ptr<OpenGLStreamBuffer> m_vertex_buffer;
   std::unique_ptr<OpenGLStreamBuffer> m_index_buffer;
   std::unique_ptr<OpenGLStreamBuffer> m_uniform_buffer;
@@ -239,6 +248,17 @@ private:
   u8 m_waiting_timestamp_queries = 0;
   bool m_timestamp_query_started = false;
 
+  // Timing scopes use GL_TIMESTAMP counters, since GL_TIME_ELAPSED queries can't overlap the frame query.
+  struct TimingScopeQuery
+  {
+    const char* name;
+    std::array<GLuint, 2> queries;
+  };
+  std::vector<TimingScopeQuery> m_timing_scope_queries;
+  u32 m_read_timing_scope_query = 0;
+  u32 m_write_timing_scope_query = 0;
+  u32 m_waiting_timing_scope_queries = 0;
+
   std::FILE* m_pipeline_disk_cache_file = nullptr;
 #ifdef HAS_POSIX_FILE_LOCK
   FileSystem::POSIXLock m_pipeline_disk_cache_file_lock;
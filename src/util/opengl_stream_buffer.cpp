@@ -475,6 +475,114 @@ private:
   bool m_coherent;
 };
 
+// Region of an OpenGLSharedStreamBuffer. Blocks are tracked the same way as SyncingStreamBuffer, but with the shared
+// fence counters, so finishing blocks in several streams at once only needs one fence, and one wait retires them all.
+class SharedStreamBuffer final : public OpenGLStreamBuffer
+{
+public:
+  enum : u32
+  {
+    NUM_SYNC_POINTS = 16
+  };
+
+  SharedStreamBuffer(OpenGLSharedStreamBuffer* parent, GLenum target, u32 offset, u32 size)
+    : OpenGLStreamBuffer(target, parent->GetGLBufferId(), size), m_parent(parent), m_offset(offset),
+      m_bytes_per_block(size / NUM_SYNC_POINTS)
+  {
+  }
+
+  ~SharedStreamBuffer() override
+  {
+    // the buffer belongs to the parent
+    m_buffer_id = 0;
+  }
+
+  MappingResult Map(u32 alignment, u32 min_size) override
+  {
+    m_position = GetAlignedPosition(m_position, alignment);
+    AllocateSpace(alignment, min_size);
+    DebugAssert((m_position + min_size) <= (m_available_block_index * m_bytes_per_block));
+
+    const u32 buffer_offset = m_offset + m_position;
+    const u32 free_space_in_block = ((m_available_block_index * m_bytes_per_block) - m_position);
+    return MappingResult{static_cast<void*>(m_parent->GetMappedPointer() + buffer_offset), buffer_offset,
+                         buffer_offset / alignment, free_space_in_block / alignment};
+  }
+
+  u32 Unmap(u32 used_size) override
+  {
+    DebugAssert((m_position + used_size) <= m_size);
+
+    // pixel unpacks are issued straight after, without a draw
+    m_parent->MarkUsed();
+
+    const u32 prev_position = m_offset + m_position;
+    m_position += used_size;
+    return prev_position;
+  }
+
+  u32 GetChunkSize() const override { return m_bytes_per_block; }
+
+private:
+  // Offsets are aligned within the whole buffer, since they're turned into base vertices/indices.
+  ALWAYS_INLINE u32 GetAlignedPosition(u32 position, u32 alignment) const
+  {
+    return static_cast<u32>(Common::AlignUp(m_offset + position, alignment)) - m_offset;
+  }
+
+  ALWAYS_INLINE u32 GetSyncIndexForOffset(u32 offset) { return offset / m_bytes_per_block; }
+
+  void AddSyncsForOffset(u32 offset)
+  {
+    const u32 end = GetSyncIndexForOffset(offset);
+    if (m_used_block_index >= end)
+      return;
+
+    const u64 fence = m_parent->GetFenceForPendingWork();
+    for (; m_used_block_index < end; m_used_block_index++)
+      m_block_fences[m_used_block_index] = fence;
+  }
+
+  void WaitForBlock(u32 index)
+  {
+    m_parent->WaitForFence(m_block_fences[index]);
+    m_block_fences[index] = 0;
+  }
+
+  void EnsureSyncsWaitedForOffset(u32 offset)
+  {
+    const u32 end = std::min<u32>(GetSyncIndexForOffset(offset) + 1, NUM_SYNC_POINTS);
+    for (; m_available_block_index < end; m_available_block_index++)
+      WaitForBlock(m_available_block_index);
+  }
+
+  void AllocateSpace(u32 alignment, u32 size)
+  {
+    AddSyncsForOffset(m_position);
+    EnsureSyncsWaitedForOffset(m_position + size);
+
+    if ((m_position + size) > m_size)
+    {
+      AddSyncsForOffset(m_size);
+
+      m_position = GetAlignedPosition(0, alignment);
+      WaitForBlock(0);
+      m_available_block_index = 1;
+
+      EnsureSyncsWaitedForOffset(m_position + size);
+      m_used_block_index = 0;
+    }
+  }
+
+  OpenGLSharedStreamBuffer* m_parent;
+  u32 m_offset;
+  u32 m_position = 0;
+  u32 m_used_block_index = 0;
+  u32 m_available_block_index = NUM_SYNC_POINTS;
+  u32 m_bytes_per_block;
+  std::array<u64, NUM_SYNC_POINTS> m_block_fences{};
+};
+
 } // namespace
 
 std::unique_ptr<OpenGLStreamBuffer> OpenGLStreamBuffer::Create(GLenum target, u32 size, Error* error /* = nullptr */)
@@ -531,3 +639,98 @@ std::unique_ptr<OpenGLStreamBuffer> OpenGLStreamBuffer::Create(GLenum target, u3
   return BufferDataStreamBuffer::Create(target, size, error);
 #endif
 }
+
+OpenGLSharedStreamBuffer::OpenGLSharedStreamBuffer(GLuint buffer_id, u8* mapped_ptr, u32 size)
+  : m_buffer_id(buffer_id), m_mapped_ptr(mapped_ptr), m_size(size)
+{
+}
+
+OpenGLSharedStreamBuffer::~OpenGLSharedStreamBuffer()
+{
+  for (const auto& [counter, sync] : m_fences)
+    glDeleteSync(sync);
+
+  glBindBuffer(GL_ARRAY_BUFFER, m_buffer_id);
+  glUnmapBuffer(GL_ARRAY_BUFFER);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glDeleteBuffers(1, &m_buffer_id);
+}
+
+bool OpenGLSharedStreamBuffer::IsSupported()
+{
+  return (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage || GLAD_GL_EXT_buffer_storage);
+}
+
+std::unique_ptr<OpenGLSharedStreamBuffer> OpenGLSharedStreamBuffer::Create(u32 size, Error* error /* = nullptr */)
+{
+  glGetError();
+
+  GLuint buffer_id;
+  glGenBuffers(1, &buffer_id);
+  glBindBuffer(GL_ARRAY_BUFFER, buffer_id);
+
+  static constexpr u32 flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+  if (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage)
+    glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+  else if (GLAD_GL_EXT_buffer_storage)
+    glBufferStorageEXT(GL_ARRAY_BUFFER, size, nullptr, flags);
+
+  u8* mapped_ptr = nullptr;
+  GLenum err = glGetError();
+  if (err == GL_NO_ERROR)
+  {
+    mapped_ptr = static_cast<u8*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+    err = glGetError();
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  if (!mapped_ptr || err != GL_NO_ERROR) [[unlikely]]
+  {
+    Error::SetStringFmt(error, "Failed to create shared buffer: 0x{:X}", err);
+    glDeleteBuffers(1, &buffer_id);
+    return {};
+  }
+
+  DEV_LOG("Using {} byte shared stream buffer.", size);
+  return std::unique_ptr<OpenGLSharedStreamBuffer>(new OpenGLSharedStreamBuffer(buffer_id, mapped_ptr, size));
+}
+
+std::unique_ptr<OpenGLStreamBuffer> OpenGLSharedStreamBuffer::CreateStream(GLenum target, u32 size, u32 alignment)
+{
+  const u32 offset = Common::AlignUp(m_allocated_size, alignment);
+  if ((offset + size) > m_size) [[unlikely]]
+    return {};
+
+  m_allocated_size = offset + size;
+  return std::make_unique<SharedStreamBuffer>(this, target, offset, size);
+}
+
+u64 OpenGLSharedStreamBuffer::GetFenceForPendingWork()
+{
+  if (m_used_since_fence)
+  {
+    m_fences.emplace_back(m_next_fence_counter++, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    m_used_since_fence = false;
+  }
+
+  return m_next_fence_counter - 1;
+}
+
+void OpenGLSharedStreamBuffer::WaitForFence(u64 counter)
+{
+  if (m_completed_fence_counter >= counter)
+    return;
+
+  // Counters are sequential, so the fence is at a known position in the queue.
+  DebugAssert(!m_fences.empty() && counter >= m_fences.front().first);
+  const size_t index = static_cast<size_t>(counter - m_fences.front().first);
+  DebugAssert(index < m_fences.size() && m_fences[index].first == counter);
+  glClientWaitSync(m_fences[index].second, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+
+  // everything before it has finished too
+  for (size_t i = 0; i <= index; i++)
+    glDeleteSync(m_fences[i].second);
+  m_fences.erase(m_fences.begin(), m_fences.begin() + static_cast<std::ptrdiff_t>(index + 1));
+  m_completed_fence_counter = counter;
+}
@@ -7,9 +7,11 @@
 
 #include "common/types.h"
 
+#include <deque>
 #include <memory>
 #include <string_view>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 class Error;
@@ -55,3 +57,44 @@ protected:
   GLuint m_buffer_id;
   u32 m_size;
 };
+
+/// A single persistent, coherently-mapped buffer which the device's streams are carved out of. Vertex, index, uniform
+/// and texture upload data then all live in one buffer object, and the streams share one timeline of fences instead of
+/// each keeping their own.
+class OpenGLSharedStreamBuffer
+{
+public:
+  ~OpenGLSharedStreamBuffer();
+
+  ALWAYS_INLINE GLuint GetGLBufferId() const { return m_buffer_id; }
+  ALWAYS_INLINE u8* GetMappedPointer() const { return m_mapped_ptr; }
+
+  /// Has to be called after issuing commands which read from the buffer, so the next fence covers them.
+  ALWAYS_INLINE void MarkUsed() { m_used_since_fence = true; }
+
+  /// Allocates a stream from the remaining space. The stream must be destroyed before this buffer.
+  std::unique_ptr<OpenGLStreamBuffer> CreateStream(GLenum target, u32 size, u32 alignment);
+
+  /// Returns a fence counter which, once completed, guarantees all work issued so far has finished. Only creates a
+  /// fence if commands have been issued since the last one.
+  u64 GetFenceForPendingWork();
+
+  /// Waits for the specified fence, and retires every fence before it.
+  void WaitForFence(u64 counter);
+
+  static bool IsSupported();
+  static std::unique_ptr<OpenGLSharedStreamBuffer> Create(u32 size, Error* error = nullptr);
+
+private:
+  OpenGLSharedStreamBuffer(GLuint buffer_id, u8* mapped_ptr, u32 size);
+
+  GLuint m_buffer_id;
+  u8* m_mapped_ptr;
+  u32 m_size;
+  u32 m_allocated_size = 0;
+
+  std::deque<std::pair<u64, GLsync>> m_fences;
+  u64 m_next_fence_counter = 1;
+  u64 m_completed_fence_counter = 0;
+  bool m_used_since_fence = false;
+};
@@ -24,6 +24,7 @@
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/memory_settings_interface.h"
 #include "common/path.h"
 #include "common/progress_callback.h"
 #include "common/small_string.h"
@@ -31,6 +32,9 @@
 #include "common/timer.h"
 #include "fmt/format.h"
 
+#include <atomic>
+#include <condition_variable>
+
 LOG_CHANNEL(PostProcessing);
 
 namespace PostProcessing {
@@ -45,6 +49,28 @@ static void CopyStageConfig(SettingsInterface& si, const char* section, u32 old_
 static void SwapStageConfig(SettingsInterface& si, const char* section, u32 lhs_index, u32 rhs_index);
 static std::unique_ptr<Shader> TryLoadingShader(const std::string& shader_name, bool only_config, Error* error);
 
+/// Stages being loaded on a worker thread. Shared with the task, so the chain can drop it without waiting.
+struct Chain::PendingLoad
+{
+  void Run(const char* section);
+  void Wait();
+
+  // copy of the stage sections, since the worker can't hold the settings lock
+  MemorySettingsInterface settings;
+  std::vector<std::string> stage_names;
+  u32 prepare_width = 0;
+  u32 prepare_height = 0;
+
+  std::vector<std::unique_ptr<Shader>> stages;
+  Error error;
+  bool failed = false;
+
+  std::atomic_bool cancelled{false};
+  std::atomic_bool done{false};
+  std::mutex done_mutex;
+  std::condition_variable done_cv;
+};
+
 Timer::Value Chain::s_start_time;
 
 } // namespace PostProcessing
@@ -425,19 +451,125 @@ PostProcessing::Chain::Chain(const char* section) : m_section(section)
     s_start_time = Timer::GetCurrentValue();
 }
 
-PostProcessing::Chain::~Chain() = default;
+PostProcessing::Chain::~Chain()
+{
+  // the worker reads from the GPU device, so it has to be finished before the device can go away
+  CancelPendingLoad();
+}
 
 GPUTexture* PostProcessing::Chain::GetTextureUnusedAtEndOfChain() const
 {
-  return (m_stages.size() % 2) ? m_output_texture.get() :
+  return (m_passes.size() % 2) ? m_output_texture.get() :
                                  (m_intermediate_texture ? m_intermediate_texture.get() : m_input_texture.get());
 }
 
-bool PostProcessing::Chain::IsActive() const
+bool PostProcessing::Chain::IsActive()
 {
+  if (m_pending_load && m_pending_load->done.load(std::memory_order_acquire))
+    FinishPendingLoad();
+
   return m_enabled && !m_stages.empty();
 }
 
+void PostProcessing::Chain::PendingLoad::Run(const char* section)
+{
+  for (u32 i = 0; i < static_cast<u32>(stage_names.size()); i++)
+  {
+    if (cancelled.load(std::memory_order_acquire))
+      break;
+
+    std::unique_ptr<Shader> shader = TryLoadingShader(stage_names[i], false, &error);
+    if (!shader)
+    {
+      failed = true;
+      break;
+    }
+
+    shader->LoadOptions(settings, GetStageConfigSection(section, i));
+    shader->SetEnabled(Config::IsStageEnabled(settings, section, i));
+    shader->SetFinalStage(false);
+
+    // get the parsing and code generation out of the way, so only pipeline creation is left for the GPU thread
+    if (prepare_width > 0 && !shader->PreparePipeline(prepare_width, prepare_height, &error))
+    {
+      ERROR_LOG("Failed to prepare post-processing shader '{}':\n{}", stage_names[i], error.GetDescription());
+      failed = true;
+      break;
+    }
+
+    stages.push_back(std::move(shader));
+  }
+
+  {
+    std::unique_lock lock(done_mutex);
+    done.store(true, std::memory_order_release);
+  }
+  done_cv.notify_all();
+}
+
+void PostProcessing::Chain::PendingLoad::Wait()
+{
+  std::unique_lock lock(done_mutex);
+  done_cv.wait(lock, [this]() { return done.load(std::memory_order_acquire); });
+}
+
+void PostProcessing::Chain::CancelPendingLoad()
+{
+  if (!m_pending_load)
+    return;
+
+  m_pending_load->cancelled.store(true, std::memory_order_release);
+  m_pending_load->Wait();
+  m_pending_load.reset();
+}
+
+void PostProcessing::Chain::FinishPendingLoad()
+{
+  const std::shared_ptr<PendingLoad> load = std::move(m_pending_load);
+  if (load->failed)
+  {
+    ClearStagesWithError(load->error);
+    return;
+  }
+
+  DestroyTextures();
+  m_stages = std::move(load->stages);
+
+  u32 enabled_stage_count = 0;
+  Shader* last_enabled_stage = nullptr;
+  m_wants_depth_buffer = false;
+  m_wants_unscaled_input = false;
+  for (const std::unique_ptr<Shader>& shader : m_stages)
+  {
+    if (shader->IsEnabled())
+    {
+      enabled_stage_count++;
+      last_enabled_stage = shader.get();
+    }
+
+    // depth usage for FX shaders is only known once they're compiled, which CheckTargets() redoes
+    m_wants_depth_buffer |= shader->WantsDepthBuffer();
+    m_wants_unscaled_input |= shader->WantsUnscaledInput();
+  }
+
+  DEV_LOG("Loaded {} post-processing stages ({} enabled).", m_stages.size(), enabled_stage_count);
+  if (last_enabled_stage)
+  {
+    last_enabled_stage->SetFinalStage(true);
+  }
+  else
+  {
+    WARNING_LOG("All post-processing stages are currently disabled.");
+    m_enabled = false;
+  }
+
+  m_needs_depth_buffer = m_enabled && m_wants_depth_buffer;
+  if (m_wants_depth_buffer)
+    DEV_LOG("Depth buffer is needed.");
+
+  s_start_time = Timer::GetCurrentValue();
+}
+
 void PostProcessing::Chain::ClearStagesWithError(const Error& error)
 {
   std::string msg = error.GetDescription();
@@ -448,163 +580,87 @@ void PostProcessing::Chain::ClearStagesWithError(const Error& error)
                           TRANSLATE_STR("OSDMessage", "Failed to load post-processing chain."), std::move(msg));
   DestroyTextures();
   m_stages.clear();
+  m_passes_dirty = true;
 }
 
 void PostProcessing::Chain::LoadStages(std::unique_lock<std::mutex>& settings_lock, const SettingsInterface& si,
                                        bool preload_swap_chain_size)
 {
-  m_stages.clear();
-  DestroyTextures();
+  // anything still loading is out of date now
+  CancelPendingLoad();
 
   m_enabled = Config::IsEnabled(si, m_section);
-  m_wants_depth_buffer = false;
-  m_wants_unscaled_input = false;
 
   const u32 stage_count = Config::GetStageCount(si, m_section);
   if (stage_count == 0)
+  {
+    DestroyTextures();
+    m_stages.clear();
+    m_wants_depth_buffer = false;
+    m_wants_unscaled_input = false;
+    m_needs_depth_buffer = false;
     return;
+  }
 
-  Error error;
-  FullscreenUI::LoadingScreenProgressCallback progress;
-  progress.SetTitle("Loading Post-Processing Shaders...");
-  progress.SetProgressRange(stage_count);
-
-  u32 enabled_stage_count = 0;
-  u32 last_enabled_stage = std::numeric_limits<u32>::max();
+  std::shared_ptr<PendingLoad> load = std::make_shared<PendingLoad>();
+  load->stage_names.reserve(stage_count);
   for (u32 i = 0; i < stage_count; i++)
   {
     std::string stage_name = Config::GetStageShaderName(si, m_section, i);
     if (stage_name.empty())
     {
+      Error error;
       error.SetString(fmt::format("No stage name in stage {}.", i + 1));
       ClearStagesWithError(error);
       return;
     }
 
-    settings_lock.unlock();
-    progress.FormatStatusText("Loading shader {}...", stage_name);
-
-    std::unique_ptr<Shader> shader = TryLoadingShader(stage_name, false, &error);
-    if (!shader)
-    {
-      ClearStagesWithError(error);
-      return;
-    }
-
-    progress.IncrementProgressValue();
-
-    settings_lock.lock();
-    shader->LoadOptions(si, GetStageConfigSection(m_section, i));
-
-    const bool stage_enabled = Config::IsStageEnabled(si, m_section, i);
-    shader->SetEnabled(stage_enabled);
-    shader->SetFinalStage(false);
-    enabled_stage_count += BoolToUInt32(stage_enabled);
-    if (stage_enabled)
-      last_enabled_stage = i;
-
-    m_stages.push_back(std::move(shader));
+    const TinyString stage_section = GetStageConfigSection(m_section, i);
+    load->settings.SetKeyValueList(stage_section, si.GetKeyValueList(stage_section));
+    load->stage_names.push_back(std::move(stage_name));
   }
 
-  if (stage_count > 0)
-  {
-    DEV_LOG("Loaded {} post-processing stages ({} enabled).", stage_count, enabled_stage_count);
-    if (enabled_stage_count == 0)
-    {
-      WARNING_LOG("All post-processing stages are currently disabled.");
-      m_enabled = false;
-    }
-    else
-    {
-      m_stages[last_enabled_stage]->SetFinalStage(true);
-    }
-  }
-
-  // precompile shaders
+  // the size has to be known up front for shaders to be prepared on the worker, the swap chain is the best guess
   if (preload_swap_chain_size && g_gpu_device && g_gpu_device->HasMainSwapChain())
   {
     const GPUSwapChain* swap_chain = g_gpu_device->GetMainSwapChain();
-    CheckTargets(swap_chain->GetWidth(), swap_chain->GetHeight(), swap_chain->GetFormat(), swap_chain->GetWidth(),
-                 swap_chain->GetHeight(), swap_chain->GetWidth(), swap_chain->GetHeight(), &progress);
+    load->prepare_width = swap_chain->GetWidth();
+    load->prepare_height = swap_chain->GetHeight();
   }
 
-  // must be down here, because we need to compile first, triggered by CheckTargets()
-  for (std::unique_ptr<Shader>& shader : m_stages)
-  {
-    m_wants_depth_buffer |= shader->WantsDepthBuffer();
-    m_wants_unscaled_input |= shader->WantsUnscaledInput();
-  }
-  m_needs_depth_buffer = m_enabled && m_wants_depth_buffer;
-  if (m_wants_depth_buffer)
-    DEV_LOG("Depth buffer is needed.");
-
-  // can't close/redraw with settings lock held because big picture
-  settings_lock.unlock();
-  progress.Close();
-  settings_lock.lock();
+  DEV_LOG("Loading {} post-processing stages in the background.", stage_count);
+  m_pending_load = load;
+  Host::QueueAsyncTask([load = std::move(load), section = m_section]() { load->Run(section); });
 }
 
 void PostProcessing::Chain::UpdateSettings(std::unique_lock<std::mutex>& settings_lock, const SettingsInterface& si)
 {
-  m_enabled = Config::IsEnabled(si, m_section);
-
+  // new or different shaders have to be loaded first, which happens in the background
   const u32 stage_count = Config::GetStageCount(si, m_section);
-  if (stage_count == 0)
+  bool needs_load = (m_pending_load || stage_count == 0 || stage_count != m_stages.size());
+  for (u32 i = 0; i < stage_count && !needs_load; i++)
+    needs_load = (Config::GetStageShaderName(si, m_section, i) != m_stages[i]->GetName());
+  if (needs_load)
   {
-    m_stages.clear();
+    LoadStages(settings_lock, si, true);
     return;
   }
 
-  Error error;
-
-  m_stages.resize(stage_count);
+  m_enabled = Config::IsEnabled(si, m_section);
+  m_passes_dirty = true;
 
   FullscreenUI::LoadingScreenProgressCallback progress;
   progress.SetTitle("Loading Post-Processing Shaders...");
   progress.SetProgressRange(stage_count);
 
-  const GPUTextureFormat prev_format = m_target_format;
   m_wants_depth_buffer = false;
 
-  const u32 prev_enabled_stage_count = static_cast<u32>(std::ranges::count_if(
-    m_stages, [](const std::unique_ptr<Shader>& shader) { return (shader && shader->IsEnabled()); }));
+  const u32 prev_enabled_stage_count = static_cast<u32>(
+    std::ranges::count_if(m_stages, [](const std::unique_ptr<Shader>& shader) { return shader->IsEnabled(); }));
   u32 enabled_stage_count = 0;
   u32 last_enabled_stage = 0;
   for (u32 i = 0; i < stage_count; i++)
   {
-    std::string stage_name = Config::GetStageShaderName(si, m_section, i);
-    if (stage_name.empty())
-    {
-      error.SetString(fmt::format("No stage name in stage {}.", i + 1));
-      ClearStagesWithError(error);
-      return;
-    }
-
-    if (!m_stages[i] || stage_name != m_stages[i]->GetName())
-    {
-      if (i < m_stages.size())
-        m_stages[i].reset();
-
-      // Force recompile.
-      m_target_format = GPUTextureFormat::Unknown;
-
-      settings_lock.unlock();
-
-      std::unique_ptr<Shader> shader = TryLoadingShader(stage_name, false, &error);
-      if (!shader)
-      {
-        ClearStagesWithError(error);
-        return;
-      }
-
-      if (i < m_stages.size())
-        m_stages[i] = std::move(shader);
-      else
-        m_stages.push_back(std::move(shader));
-
-      settings_lock.lock();
-    }
-
     m_stages[i]->LoadOptions(si, GetStageConfigSection(m_section, i));
 
     const bool stage_enabled = Config::IsStageEnabled(si, m_section, i);
@@ -615,7 +671,7 @@ void PostProcessing::Chain::UpdateSettings(std::unique_lock<std::mutex>& setting
       last_enabled_stage = i;
   }
 
-  if (prev_format != GPUTextureFormat::Unknown)
+  if (m_target_format != GPUTextureFormat::Unknown)
   {
     // if the number of enabled stages changed, this will affect the target size for unscaled shaders
     const u32 prev_source_width = m_source_width;
@@ -623,23 +679,20 @@ void PostProcessing::Chain::UpdateSettings(std::unique_lock<std::mutex>& setting
     if (enabled_stage_count != prev_enabled_stage_count)
       m_source_width = m_source_height = 0;
 
-    CheckTargets(prev_source_width, prev_source_height, prev_format, m_target_width, m_target_height, m_viewport_width,
-                 m_viewport_height, &progress);
+    CheckTargets(prev_source_width, prev_source_height, m_target_format, m_target_width, m_target_height,
+                 m_viewport_width, m_viewport_height, &progress);
   }
 
-  if (stage_count > 0)
+  s_start_time = Timer::GetCurrentValue();
+  DEV_LOG("Updated {} post-processing stages ({} enabled).", stage_count, enabled_stage_count);
+  if (enabled_stage_count == 0)
   {
-    s_start_time = Timer::GetCurrentValue();
-    DEV_LOG("Loaded {} post-processing stages ({} enabled).", stage_count, enabled_stage_count);
-    if (enabled_stage_count == 0)
-    {
-      WARNING_LOG("All post-processing stages are currently disabled.");
-      m_enabled = false;
-    }
-    else
-    {
-      m_stages[last_enabled_stage]->SetFinalStage(true);
-    }
+    WARNING_LOG("All post-processing stages are currently disabled.");
+    m_enabled = false;
+  }
+  else
+  {
+    m_stages[last_enabled_stage]->SetFinalStage(true);
   }
 
   // must be down here, because we need to compile first, triggered by CheckTargets()
@@ -657,7 +710,7 @@ void PostProcessing::Chain::UpdateSettings(std::unique_lock<std::mutex>& setting
 
 void PostProcessing::Chain::Toggle()
 {
-  if (m_stages.empty())
+  if (m_stages.empty() && !m_pending_load)
   {
     Host::AddIconOSDMessage(OSDMessageType::Quick, "PostProcessing", ICON_FA_PAINT_ROLLER,
                             TRANSLATE_STR("OSDMessage", "No post-processing shaders are selected."));
@@ -691,6 +744,9 @@ bool PostProcessing::Chain::CheckTargets(u32 source_width, u32 source_height, GP
       m_source_height == source_height && m_viewport_width == viewport_width && m_viewport_height == viewport_height &&
       m_target_format == target_format)
   {
+    if (m_passes_dirty)
+      UpdatePasses();
+
     return true;
   }
 
@@ -802,14 +858,69 @@ bool PostProcessing::Chain::CheckTargets(u32 source_width, u32 source_height, GP
   m_target_height = target_height;
   m_target_format = target_format;
   m_needs_depth_buffer = m_enabled && m_wants_depth_buffer;
+  UpdatePasses();
   return true;
 }
 
+void PostProcessing::Chain::UpdatePasses()
+{
+  m_passes.clear();
+  m_fused_stages.clear();
+  m_passes_dirty = false;
+
+  std::vector<const GLSLShader*> group;
+  const auto flush_group = [this, &group]() {
+    if (group.size() > 1)
+    {
+      Error error;
+      std::unique_ptr<GLSLShader> fused = GLSLShader::CreateFused(group);
+      if (fused->CompilePipeline(m_target_format, m_target_width, m_target_height, &error, nullptr))
+      {
+        DEV_LOG("Fused post-processing stages '{}' into one pass.", fused->GetName());
+        m_passes.push_back(fused.get());
+        m_fused_stages.push_back(std::move(fused));
+        group.clear();
+        return;
+      }
+
+      WARNING_LOG("Failed to compile fused post-processing pass '{}', running stages separately: {}", fused->GetName(),
+                  error.GetDescription());
+    }
+
+    for (const GLSLShader* stage : group)
+      m_passes.push_back(const_cast<GLSLShader*>(stage));
+    group.clear();
+  };
+
+  for (const std::unique_ptr<Shader>& stage : m_stages)
+  {
+    if (!stage->IsEnabled())
+      continue;
+
+    // Fusable stages join the pass of the GLSL stage before them, anything else starts a new pass.
+    if (stage->GetType() == ShaderType::GLSL)
+    {
+      const GLSLShader* const glsl_stage = static_cast<const GLSLShader*>(stage.get());
+      if (group.empty() || !glsl_stage->IsFusable())
+        flush_group();
+
+      group.push_back(glsl_stage);
+      continue;
+    }
+
+    flush_group();
+    m_passes.push_back(stage.get());
+  }
+
+  flush_group();
+}
+
 void PostProcessing::Chain::DestroyTextures()
 {
   m_target_format = GPUTextureFormat::Unknown;
   m_target_width = 0;
   m_target_height = 0;
+  m_passes_dirty = true;
 
   g_gpu_device->RecycleTexture(std::move(m_output_texture));
   g_gpu_device->RecycleTexture(std::move(m_intermediate_texture));
@@ -829,21 +940,23 @@ GPUDevice::PresentResult PostProcessing::Chain::Apply(GPUTexture* input_color, G
   if (input_depth)
     input_depth->MakeReadyForSampling();
 
+  if (m_passes_dirty) [[unlikely]]
+    UpdatePasses();
+
   const float time = static_cast<float>(Timer::ConvertValueToSeconds(Timer::GetCurrentValue() - s_start_time));
-  for (const std::unique_ptr<Shader>& stage : m_stages)
+  for (Shader* const stage : m_passes)
   {
-    if (!stage->IsEnabled())
-      continue;
-
+    const bool final_pass = (stage == m_passes.back());
+    const GPUDevice::TimingScope timing_scope(stage->GetName());
     if (const GPUDevice::PresentResult pres = stage->Apply(
-          original_color, input_color, input_depth, stage->IsFinalStage() ? final_target : output, final_rect,
-          orig_width, orig_height, native_width, native_height, m_target_width, m_target_height, time);
+          original_color, input_color, input_depth, final_pass ? final_target : output, final_rect, orig_width,
+          orig_height, native_width, native_height, m_target_width, m_target_height, time);
         pres != GPUDevice::PresentResult::OK)
     {
       return pres;
     }
 
-    if (!stage->IsFinalStage())
+    if (!final_pass)
     {
       output->MakeReadyForSampling();
       input_color = output;
@@ -133,13 +133,21 @@ public:
   ALWAYS_INLINE GPUTexture* GetInputTexture() const { return m_input_texture.get(); }
   ALWAYS_INLINE GPUTexture* GetOutputTexture() const { return m_output_texture.get(); }
 
-  /// Returns either the input or output texture, whichever isn't the destination after the final pass.
+  /// Returns either the input or output texture, whichever isn't the source of the final pass.
   GPUTexture* GetTextureUnusedAtEndOfChain() const;
 
-  bool IsActive() const;
+  /// Returns true if stages are still being loaded in the background. The previous stages are used until then.
+  ALWAYS_INLINE bool IsLoading() const { return static_cast<bool>(m_pending_load); }
+
+  /// Returns true if post-processing is enabled in the chain, regardless of whether any stages have loaded yet.
+  ALWAYS_INLINE bool IsEnabled() const { return m_enabled; }
+
+  /// Also swaps in the stages from a background load, if it has completed.
+  bool IsActive();
 
   void UpdateSettings(std::unique_lock<std::mutex>& settings_lock, const SettingsInterface& si);
 
+  /// Loads the stages on a worker thread, the current stages stay active until they are ready.
   void LoadStages(std::unique_lock<std::mutex>& settings_lock, const SettingsInterface& si,
                   bool preload_swap_chain_size);
 
@@ -154,9 +162,16 @@ public:
                                  s32 native_height);
 
 private:
+  struct PendingLoad;
+
   void ClearStagesWithError(const Error& error);
+  void CancelPendingLoad();
+  void FinishPendingLoad();
   void DestroyTextures();
 
+  /// Works out which passes are run for the enabled stages, merging consecutive GLSL stages where possible.
+  void UpdatePasses();
+
   const char* m_section;
 
   u32 m_source_width = 0;
@@ -170,8 +185,12 @@ private:
   bool m_wants_depth_buffer = false;
   bool m_needs_depth_buffer = false;
   bool m_wants_unscaled_input = false;
+  bool m_passes_dirty = true;
 
   std::vector<std::unique_ptr<PostProcessing::Shader>> m_stages;
+  std::vector<std::unique_ptr<PostProcessing::Shader>> m_fused_stages;
+  std::vector<PostProcessing::Shader*> m_passes;
+  std::shared_ptr<PendingLoad> m_pending_load;
   std::unique_ptr<GPUTexture> m_input_texture;
   std::unique_ptr<GPUTexture> m_intermediate_texture;
   std::unique_ptr<GPUTexture> m_output_texture;
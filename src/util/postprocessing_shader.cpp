@@ -118,6 +118,11 @@ bool PostProcessing::Shader::ResizeTargets(u32 source_width, u32 source_height,
   return true;
 }
 
+bool PostProcessing::Shader::PreparePipeline(u32 width, u32 height, Error* error)
+{
+  return true;
+}
+
 PostProcessing::ShaderOption* PostProcessing::Shader::GetOptionByName(std::string_view name)
 {
   for (ShaderOption& option : m_options)
@@ -47,9 +47,15 @@ public:
   const ShaderOption* GetOptionByName(std::string_view name) const;
   ShaderOption* GetOptionByName(std::string_view name);
 
+  virtual ShaderType GetType() const = 0;
+
   virtual bool ResizeTargets(u32 source_width, u32 source_height, GPUTextureFormat target_format, u32 target_width,
                              u32 target_height, u32 viewport_width, u32 viewport_height, Error* error);
 
+  /// Does the part of CompilePipeline() which doesn't touch the GPU device, i.e. parsing and code generation.
+  /// Safe to call from a worker thread, CompilePipeline() picks up the results if the size still matches.
+  virtual bool PreparePipeline(u32 width, u32 height, Error* error);
+
   virtual bool CompilePipeline(GPUTextureFormat format, u32 width, u32 height, Error* error,
                                ProgressCallback* progress) = 0;
 
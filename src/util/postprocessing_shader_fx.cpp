@@ -7,7 +7,6 @@
 #include "shadergen.h"
 
 // TODO: Remove me
-#include "core/gpu_thread.h"
 #include "core/host.h"
 #include "core/settings.h"
 
@@ -73,8 +72,9 @@ static std::tuple<std::unique_ptr<reshadefx::codegen>, GPUShaderLanguage> Create
                            GPUShaderLanguage::SPV);
   }
 
-  // Should have a GPU device and be on the GPU thread.
-  Assert(GPUThread::IsOnThread() && g_gpu_device);
+  // Should have a GPU device. Only its properties are read, so this can also run on a worker thread while the
+  // GPU thread keeps the device alive.
+  Assert(g_gpu_device);
 
   const bool debug_info = g_gpu_device->IsDebugDevice();
   const RenderAPI rapi = g_gpu_device->GetRenderAPI();
@@ -318,6 +318,11 @@ PostProcessing::ReShadeFXShader::~ReShadeFXShader()
     g_gpu_device->RecycleTexture(std::move(tex.texture));
 }
 
+PostProcessing::ShaderType PostProcessing::ReShadeFXShader::GetType() const
+{
+  return ShaderType::Reshade;
+}
+
 bool PostProcessing::ReShadeFXShader::LoadFromFile(std::string name, std::string filename, bool only_config,
                                                    Error* error)
 {
@@ -345,9 +350,9 @@ bool PostProcessing::ReShadeFXShader::LoadFromString(std::string name, std::stri
 
   // TODO: This could use spv, it's probably fastest.
   const auto& [cg, cg_language] = CreateRFXCodegen(only_config, error);
-  if (!cg || !CreateModule(only_config ? DEFAULT_BUFFER_WIDTH : g_gpu_device->GetMainSwapChain()->GetWidth(),
-                           only_config ? DEFAULT_BUFFER_HEIGHT : g_gpu_device->GetMainSwapChain()->GetHeight(),
-                           cg.get(), cg_language, std::move(code), error))
+  // The real buffer size isn't known until the pipeline is compiled, and the swap chain can't be queried off the GPU
+  // thread, so the module used for validation and options always uses the default size.
+  if (!cg || !CreateModule(DEFAULT_BUFFER_WIDTH, DEFAULT_BUFFER_HEIGHT, cg.get(), cg_language, std::move(code), error))
   {
     return false;
   }
@@ -1427,17 +1432,15 @@ GPUTexture* PostProcessing::ReShadeFXShader::GetTextureByID(TextureID id, GPUTex
   return m_textures[static_cast<size_t>(id)].texture.get();
 }
 
-bool PostProcessing::ReShadeFXShader::CompilePipeline(GPUTextureFormat format, u32 width, u32 height, Error* error,
-                                                      ProgressCallback* progress)
+bool PostProcessing::ReShadeFXShader::CreatePipelineModule(u32 width, u32 height,
+                                                           std::unique_ptr<reshadefx::codegen>* cg,
+                                                           GPUShaderLanguage* cg_language, Error* error)
 {
-  m_textures.clear();
-  m_passes.clear();
-  m_wants_depth_buffer = false;
-
   std::string fxcode;
   if (!PreprocessorReadFileCallback(m_filename, fxcode))
   {
     ERROR_LOG("Failed to re-read shader for pipeline: '{}'", m_filename);
+    Error::SetStringFmt(error, "Failed to re-read shader '{}'.", m_filename);
     return false;
   }
 
@@ -1445,16 +1448,54 @@ bool PostProcessing::ReShadeFXShader::CompilePipeline(GPUTextureFormat format, u
   if (fxcode.empty() || fxcode.back() != '\n')
     fxcode.push_back('\n');
 
-  const auto& [cg, cg_language] = CreateRFXCodegen(false, error);
-  if (!cg)
+  std::tie(*cg, *cg_language) = CreateRFXCodegen(false, error);
+  if (!*cg)
     return false;
 
-  if (!CreateModule(width, height, cg.get(), cg_language, std::move(fxcode), error))
+  if (!CreateModule(width, height, cg->get(), *cg_language, std::move(fxcode), error))
   {
     Error::AddPrefix(error, "Failed to create module: ");
     return false;
   }
 
+  return true;
+}
+
+bool PostProcessing::ReShadeFXShader::PreparePipeline(u32 width, u32 height, Error* error)
+{
+  m_prepared_codegen.reset();
+  if (!CreatePipelineModule(width, height, &m_prepared_codegen, &m_prepared_language, error))
+  {
+    m_prepared_codegen.reset();
+    return false;
+  }
+
+  m_prepared_width = width;
+  m_prepared_height = height;
+  return true;
+}
+bool PostProcessing::ReShadeFXShader::CompilePipeline(GPUTextureFormat format, u32 width, u32 height, Error* error,
+                                                      ProgressCallback* progress)
+{
+  m_textures.clear();
+  m_passes.clear();
+  m_wants_depth_buffer = false;
+
+  // reuse the module from PreparePipeline() if it was generated for this size
+  std::unique_ptr<reshadefx::codegen> cg;
+  GPUShaderLanguage cg_language;
+  if (m_prepared_codegen && m_prepared_width == width && m_prepared_height == height)
+  {
+    cg = std::move(m_prepared_codegen);
+    cg_language = m_prepared_language;
+  }
+  else
+  {
+    m_prepared_codegen.reset();
+    if (!CreatePipelineModule(width, height, &cg, &cg_language, error))
+      return false;
+  }
+
   const reshadefx::effect_module& mod = cg->module();
   DebugAssert(!mod.techniques.empty());
 
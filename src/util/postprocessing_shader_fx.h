@@ -30,9 +30,12 @@ public:
   bool LoadFromFile(std::string name, std::string filename, bool only_config, Error* error);
   bool LoadFromString(std::string name, std::string filename, std::string code, bool only_config, Error* error);
 
+  ShaderType GetType() const override;
+
   bool ResizeTargets(u32 source_width, u32 source_height, GPUTextureFormat target_format, u32 target_width,
                      u32 target_height, u32 viewport_width, u32 viewport_height, Error* error) override;
 
+  bool PreparePipeline(u32 width, u32 height, Error* error) override;
   bool CompilePipeline(GPUTextureFormat format, u32 width, u32 height, Error* error,
                        ProgressCallback* progress) override;
 
@@ -100,6 +103,8 @@ private:
     ShaderOption::ValueVector value;
   };
 
+  bool CreatePipelineModule(u32 width, u32 height, std::unique_ptr<reshadefx::codegen>* cg,
+                            GPUShaderLanguage* cg_language, Error* error);
   bool CreateModule(s32 buffer_width, s32 buffer_height, reshadefx::codegen* cg, GPUShaderLanguage cg_language,
                     std::string code, Error* error);
   bool CreateOptions(const reshadefx::effect_module& mod, Error* error);
@@ -146,6 +151,12 @@ private:
 #endif
   };
 
+  // Module generated by PreparePipeline(), consumed by the next CompilePipeline() at the same size.
+  std::unique_ptr<reshadefx::codegen> m_prepared_codegen;
+  GPUShaderLanguage m_prepared_language = GPUShaderLanguage::None;
+  u32 m_prepared_width = 0;
+  u32 m_prepared_height = 0;
+
   std::vector<Pass> m_passes;
   std::vector<Texture> m_textures;
   std::vector<SourceOption> m_source_options;
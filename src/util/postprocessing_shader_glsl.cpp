@@ -4,12 +4,16 @@
 #include "postprocessing_shader_glsl.h"
 #include "shadergen.h"
 
+#include "common/assert.h"
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/string_util.h"
 
+#include "fmt/format.h"
+
 #include <cctype>
 #include <cstring>
+#include <iterator>
 #include <sstream>
 
 LOG_CHANNEL(PostProcessing);
@@ -53,10 +57,71 @@ bool PostProcessing::GLSLShader::LoadFromString(std::string name, std::string co
   m_name = std::move(name);
   m_code = std::move(code);
   m_options.clear();
+  m_fusable = false;
   LoadOptions();
   return true;
 }
 
+std::unique_ptr<PostProcessing::GLSLShader>
+PostProcessing::GLSLShader::CreateFused(std::span<const GLSLShader* const> stages)
+{
+  DebugAssert(stages.size() > 1);
+
+  // Each stage's main() and options are renamed, so they can't clash with each other. SetOutput() and Sample() are
+  // redirected to pass the colour between stages instead of the render target and texture.
+  std::string name;
+  std::string code = "float4 s_fused_input;\nfloat4 s_fused_output;\n"
+                     "#define SetOutput(color) (s_fused_output = (color))\n\n";
+  std::vector<ShaderOption> options;
+  for (size_t i = 0; i < stages.size(); i++)
+  {
+    const GLSLShader* const stage = stages[i];
+    fmt::format_to(std::back_inserter(name), "{}{}", (i > 0) ? " + " : "", stage->GetName());
+
+    if (i > 0)
+      code += "#define Sample() (s_fused_input)\n";
+    fmt::format_to(std::back_inserter(code), "#define main fused_stage{}_main\n", i);
+    for (const ShaderOption& option : stage->GetOptions())
+    {
+      ShaderOption& fused_option = options.emplace_back(option);
+      fused_option.name = fmt::format("s{}_{}", i, option.name);
+      fmt::format_to(std::back_inserter(code), "#define {} {}\n", option.name, fused_option.name);
+    }
+
+    code += stage->GetCode();
+    code += "\n";
+
+    for (const ShaderOption& option : stage->GetOptions())
+      fmt::format_to(std::back_inserter(code), "#undef {}\n", option.name);
+    code += "#undef main\n";
+    if (i > 0)
+      code += "#undef Sample\n";
+    code += "\n";
+  }
+
+  code += "#undef SetOutput\n\nvoid main()\n{\n  s_fused_output = float4(0.0, 0.0, 0.0, 1.0);\n";
+  for (size_t i = 0; i < stages.size(); i++)
+  {
+    if (i > 0)
+      code += "  s_fused_input = s_fused_output;\n";
+    fmt::format_to(std::back_inserter(code), "  fused_stage{}_main();\n", i);
+  }
+  code += "  o_col0 = s_fused_output;\n}\n";
+
+  std::unique_ptr<GLSLShader> shader = std::make_unique<GLSLShader>();
+  shader->m_name = std::move(name);
+  shader->m_code = std::move(code);
+  shader->m_options = std::move(options);
+  shader->m_fused_stages.assign(stages.begin(), stages.end());
+  shader->m_enabled = true;
+  return shader;
+}
+
+PostProcessing::ShaderType PostProcessing::GLSLShader::GetType() const
+{
+  return ShaderType::GLSL;
+}
+
 u32 PostProcessing::GLSLShader::GetUniformsSize() const
 {
   // lazy packing. todo improve.
@@ -103,11 +168,23 @@ void PostProcessing::GLSLShader::FillUniformBuffer(void* buffer, s32 viewport_x,
   common->upscale_multiplier = static_cast<float>(original_width) / static_cast<float>(native_width);
   common->time = time;
 
+  // fused passes pick up the current values from the stages they were built from
   u8* option_values = reinterpret_cast<u8*>(common + 1);
-  for (const ShaderOption& option : m_options)
+  const auto write_options = [&option_values](const OptionList& options) {
+    for (const ShaderOption& option : options)
+    {
+      std::memcpy(option_values, option.value.data(), sizeof(ShaderOption::ValueVector));
+      option_values += sizeof(ShaderOption::ValueVector);
+    }
+  };
+  if (m_fused_stages.empty())
+  {
+    write_options(m_options);
+  }
+  else
   {
-    std::memcpy(option_values, option.value.data(), sizeof(ShaderOption::ValueVector));
-    option_values += sizeof(ShaderOption::ValueVector);
+    for (const GLSLShader* stage : m_fused_stages)
+      write_options(stage->m_options);
   }
 }
 
@@ -252,7 +329,9 @@ void PostProcessing::GLSLShader::LoadOptions()
 
           // New section!
           std::string_view sub = line_view.substr(1, endpos - 1);
-          if (sub == "OptionBool")
+          if (sub == "Fusable")
+            m_fusable = true;
+          else if (sub == "OptionBool")
             current_option.type = ShaderOption::Type::Bool;
           else if (sub == "OptionRangeFloat")
             current_option.type = ShaderOption::Type::Float;
@@ -5,6 +5,8 @@
 
 #include "postprocessing_shader.h"
 
+#include <span>
+
 namespace PostProcessing {
 
 class GLSLShader final : public Shader
@@ -16,9 +18,20 @@ public:
 
   ALWAYS_INLINE const std::string& GetCode() const { return m_code; }
 
+  /// Fusable shaders are marked with [Fusable] in their configuration block. They only read their input through
+  /// Sample(), and define nothing but main(), so they can be run in the same pass as the stage before them.
+  ALWAYS_INLINE bool IsFusable() const { return m_fusable; }
+
   bool LoadFromFile(std::string name, const char* filename, Error* error);
   bool LoadFromString(std::string name, std::string code, Error* error);
 
+  /// Creates a single pass which runs each of the stages in turn, with every stage after the first reading the
+  /// previous stage's colour instead of a texture. Option values are read from the stages when drawing, so they
+  /// must outlive the returned shader.
+  static std::unique_ptr<GLSLShader> CreateFused(std::span<const GLSLShader* const> stages);
+
+  ShaderType GetType() const override;
+
   bool CompilePipeline(GPUTextureFormat format, u32 width, u32 height, Error* error,
                        ProgressCallback* progress) override;
 
@@ -54,6 +67,8 @@ private:
                          s32 native_height, float time) const;
 
   std::string m_code;
+  std::vector<const GLSLShader*> m_fused_stages;
+  bool m_fusable = false;
 
   std::unique_ptr<GPUPipeline> m_pipeline;
   std::unique_ptr<GPUSampler> m_sampler;
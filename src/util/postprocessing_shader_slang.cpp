@@ -768,6 +768,11 @@ PostProcessing::SlangShader::~SlangShader()
   }
 }
 
+PostProcessing::ShaderType PostProcessing::SlangShader::GetType() const
+{
+  return ShaderType::Slang;
+}
+
 bool PostProcessing::SlangShader::LoadFromFile(std::string name, const char* path, Error* error)
 {
   std::optional<std::string> code = FileSystem::ReadFileToString(path, error);
@@ -1726,6 +1731,17 @@ std::optional<PostProcessing::SlangShader::Uniform> PostProcessing::SlangShader:
   return Uniform{BuiltinUniform::Zero, 0, push_constant, size, offset};
 }
 
+bool PostProcessing::SlangShader::PreparePipeline(u32 width, u32 height, Error* error)
+{
+  // SPIR-V compilation and reflection doesn't depend on the output format, so it can be done ahead of time.
+  for (Pass& pass : m_passes)
+  {
+    if (!pass.is_reflected && !ReflectPass(pass, error))
+      return false;
+  }
+
+  return true;
+}
 bool PostProcessing::SlangShader::CompilePipeline(GPUTextureFormat format, u32 width, u32 height, Error* error,
                                                   ProgressCallback* progress)
 {
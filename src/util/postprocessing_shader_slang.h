@@ -30,8 +30,11 @@ public:
   bool LoadFromFile(std::string name, const char* path, Error* error);
   bool LoadFromString(std::string name, std::string_view path, std::string_view code, Error* error);
 
+  ShaderType GetType() const override;
+
   bool ResizeTargets(u32 source_width, u32 source_height, GPUTextureFormat target_format, u32 target_width,
                      u32 target_height, u32 viewport_width, u32 viewport_height, Error* error) override;
+  bool PreparePipeline(u32 width, u32 height, Error* error) override;
   bool CompilePipeline(GPUTextureFormat format, u32 width, u32 height, Error* error,
                        ProgressCallback* progress) override;
   GPUDevice::PresentResult Apply(GPUTexture* original_color, GPUTexture* input_color, GPUTexture* input_depth,
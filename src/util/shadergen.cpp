@@ -463,7 +463,8 @@ void ShaderGen::DeclareTextureBuffer(std::stringstream& ss, const char* name, u3
 }
 
 void ShaderGen::DeclareImage(std::stringstream& ss, const char* name, u32 index, bool is_float /* = false */,
-                             bool is_int /* = false */, bool is_unsigned /* = false */) const
+                             bool is_int /* = false */, bool is_unsigned /* = false */,
+                             bool rasterizer_ordered /* = true */) const
 {
   if (m_glsl)
   {
@@ -477,7 +478,7 @@ void ShaderGen::DeclareImage(std::stringstream& ss, const char* name, u32 index,
   }
   else
   {
-    ss << "RasterizerOrderedTexture2D<"
+    ss << (rasterizer_ordered ? "RasterizerOrderedTexture2D<" : "RWTexture2D<")
        << (is_int ? (is_unsigned ? "uint4" : "int4") : (is_float ? "float4" : "unorm float4")) << "> " << name
        << " : register(u" << index << ");\n";
   }
@@ -849,6 +850,32 @@ void ShaderGen::DeclareFragmentEntryPoint(
   }
 }
 
+void ShaderGen::DeclareComputeEntryPoint(std::stringstream& ss, u32 local_size_x, u32 local_size_y,
+                                         u32 local_size_z /* = 1 */) const
+{
+  if (m_glsl)
+  {
+    ss << "#define STORE_IMAGE(name, coords, value) imageStore(name, ivec2(coords), value)\n";
+    ss << "#define GROUP_MEMORY_BARRIER() memoryBarrierShared(); barrier()\n";
+    ss << "#define c_global_id gl_GlobalInvocationID\n";
+    ss << "#define c_local_id gl_LocalInvocationID\n";
+    ss << "#define c_group_id gl_WorkGroupID\n";
+    ss << "\n";
+    ss << "layout(local_size_x = " << local_size_x << ", local_size_y = " << local_size_y
+       << ", local_size_z = " << local_size_z << ") in;\n";
+    ss << "void main()\n";
+  }
+  else
+  {
+    ss << "#define STORE_IMAGE(name, coords, value) name[uint2(coords)] = value\n";
+    ss << "#define GROUP_MEMORY_BARRIER() GroupMemoryBarrierWithGroupSync()\n";
+    ss << "\n";
+    ss << "[numthreads(" << local_size_x << ", " << local_size_y << ", " << local_size_z << ")]\n";
+    ss << "void main(uint3 c_global_id : SV_DispatchThreadID, uint3 c_local_id : SV_GroupThreadID,\n"
+          "          uint3 c_group_id : SV_GroupID)";
+  }
+}
+
 std::string ShaderGen::GeneratePassthroughVertexShader() const
 {
   std::stringstream ss;
@@ -52,7 +52,7 @@ public:
                       bool is_int = false, bool is_unsigned = false) const;
   void DeclareTextureBuffer(std::stringstream& ss, const char* name, u32 index, bool is_int, bool is_unsigned) const;
   void DeclareImage(std::stringstream& ss, const char* name, u32 index, bool is_float = false, bool is_int = false,
-                    bool is_unsigned = false) const;
+                    bool is_unsigned = false, bool rasterizer_ordered = true) const;
   void DeclareVertexEntryPoint(std::stringstream& ss, const std::initializer_list<const char*>& attributes,
                                u32 num_color_outputs, u32 num_texcoord_outputs,
                                const std::initializer_list<std::pair<const char*, const char*>>& additional_outputs,
@@ -65,6 +65,7 @@ public:
                             bool depth_output = false, bool msaa = false, bool ssaa = false,
                             bool declare_sample_id = false, bool noperspective_color = false,
                             bool feedback_loop = false, bool rov = false) const;
+  void DeclareComputeEntryPoint(std::stringstream& ss, u32 local_size_x, u32 local_size_y, u32 local_size_z = 1) const;
 
 protected:
   RenderAPI m_render_api;
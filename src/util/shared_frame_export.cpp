@@ -0,0 +1,194 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "shared_frame_export.h"
+#include "gpu_device.h"
+
+#include "common/align.h"
+#include "common/error.h"
+#include "common/memmap.h"
+
+#include <new>
+#include <utility>
+
+// D3D12 needs rows of texture copies aligned to 256 bytes, the other APIs are less strict.
+static constexpr u32 PITCH_ALIGNMENT = 256;
+
+SharedFrameExport::SharedFrameExport() : m_name(MemMap::GetFileMappingName("duckstation_frames"))
+{
+}
+
+SharedFrameExport::~SharedFrameExport()
+{
+  DestroyMapping();
+}
+
+SharedFrameExport::PixelFormat SharedFrameExport::GetPixelFormat(GPUTextureFormat format)
+{
+  switch (format)
+  {
+      // clang-format off
+    case GPUTextureFormat::RGBA8: return PixelFormat::RGBA8;
+    case GPUTextureFormat::BGRA8: return PixelFormat::BGRA8;
+    case GPUTextureFormat::RGB565: return PixelFormat::RGB565;
+    case GPUTextureFormat::RGB5A1: return PixelFormat::RGB5A1;
+    case GPUTextureFormat::A1BGR5: return PixelFormat::A1BGR5;
+    default: return PixelFormat::None;
+      // clang-format on
+  }
+}
+
+SharedFrameExport::SlotHeader* SharedFrameExport::GetSlotHeader(u32 slot) const
+{
+  return reinterpret_cast<SlotHeader*>(m_base + HOST_PAGE_SIZE + slot * m_slot_size);
+}
+
+u8* SharedFrameExport::GetSlotPixels(u32 slot) const
+{
+  return m_base + HOST_PAGE_SIZE + slot * m_slot_size + HOST_PAGE_SIZE;
+}
+
+bool SharedFrameExport::CreateMapping(u32 slot_data_size, Error* error)
+{
+  DestroyMapping();
+
+  // Headers get a page to themselves, so the pixels are page aligned and can be imported by the GPU.
+  const u32 data_size = Common::AlignUpPow2(slot_data_size, HOST_PAGE_SIZE);
+  const u32 slot_size = HOST_PAGE_SIZE + data_size;
+  const size_t mapping_size = HOST_PAGE_SIZE + static_cast<size_t>(slot_size) * SLOT_COUNT;
+
+  // Clean up anything left behind by a process which crashed with the same ID.
+  MemMap::DeleteSharedMemory(m_name.c_str());
+
+  m_handle = MemMap::CreateSharedMemory(m_name.c_str(), mapping_size, error);
+  if (!m_handle)
+  {
+    Error::AddPrefixFmt(error, "Failed to create shared memory '{}': ", m_name);
+    return false;
+  }
+
+  m_base = static_cast<u8*>(MemMap::MapSharedMemory(m_handle, 0, nullptr, mapping_size, PageProtect::ReadWrite));
+  if (!m_base)
+  {
+    Error::SetStringFmt(error, "Failed to map {} bytes of shared memory.", mapping_size);
+    MemMap::DestroySharedMemory(m_handle);
+    MemMap::DeleteSharedMemory(m_name.c_str());
+    m_handle = nullptr;
+    return false;
+  }
+
+  m_mapping_size = mapping_size;
+  m_slot_size = slot_size;
+  m_slot_data_size = data_size;
+
+  Header* const header = new (m_base) Header();
+  header->magic = MAGIC;
+  header->version = VERSION;
+  header->slot_count = SLOT_COUNT;
+  header->slot_offset = HOST_PAGE_SIZE;
+  header->slot_size = slot_size;
+  for (u32 i = 0; i < SLOT_COUNT; i++)
+    new (GetSlotHeader(i)) SlotHeader();
+
+  return true;
+}
+
+void SharedFrameExport::DestroyMapping()
+{
+  m_download_textures = {};
+  m_pending_slot = -1;
+  if (!m_base)
+    return;
+
+  // Readers which still have it open need to know that no more frames are coming.
+  reinterpret_cast<Header*>(m_base)->closed.store(1, std::memory_order_release);
+
+  MemMap::UnmapSharedMemory(m_base, m_mapping_size);
+  MemMap::DestroySharedMemory(m_handle);
+  MemMap::DeleteSharedMemory(m_name.c_str());
+  m_base = nullptr;
+  m_handle = nullptr;
+  m_mapping_size = 0;
+  m_slot_size = 0;
+  m_slot_data_size = 0;
+}
+
+void SharedFrameExport::PublishPendingFrame()
+{
+  if (m_pending_slot < 0)
+    return;
+
+  const u32 slot = static_cast<u32>(std::exchange(m_pending_slot, -1));
+  SlotHeader* const slot_header = GetSlotHeader(slot);
+  GPUDownloadTexture* const dltex = m_download_textures[slot].get();
+  if (dltex->IsImported())
+  {
+    if (dltex->NeedsFlush())
+      dltex->Flush();
+  }
+  else if (!dltex->ReadTexels(0, 0, slot_header->width, slot_header->height, GetSlotPixels(slot), slot_header->pitch))
+  {
+    return;
+  }
+
+  const u64 sequence = m_next_sequence++;
+  slot_header->sequence.store(sequence, std::memory_order_release);
+  reinterpret_cast<Header*>(m_base)->sequence.store(sequence, std::memory_order_release);
+}
+
+bool SharedFrameExport::SubmitFrame(GPUTexture* texture, u32 x, u32 y, u32 width, u32 height, u32 frame_number,
+                                    float pixel_aspect_ratio, Error* error)
+{
+  const GPUTextureFormat texture_format = texture->GetFormat();
+  const PixelFormat format = GetPixelFormat(texture_format);
+  if (format == PixelFormat::None)
+  {
+    Error::SetStringFmt(error, "Display texture format {} can't be exported.",
+                        GPUTexture::GetFormatName(texture_format));
+    return false;
+  }
+
+  // The previous frame's download has had a frame to complete by now.
+  if (m_base)
+    PublishPendingFrame();
+
+  const u32 pitch = Common::AlignUpPow2(width * GPUTexture::GetPixelSize(texture_format), PITCH_ALIGNMENT);
+  const u32 data_size = pitch * height;
+  if (data_size > m_slot_data_size && !CreateMapping(data_size, error))
+    return false;
+
+  // Readers reject the slot until it's published again.
+  const u32 slot = static_cast<u32>(m_next_sequence % SLOT_COUNT);
+  SlotHeader* const slot_header = GetSlotHeader(slot);
+  slot_header->sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  std::unique_ptr<GPUDownloadTexture>& dltex = m_download_textures[slot];
+  if (!dltex || dltex->GetWidth() != width || dltex->GetHeight() != height || dltex->GetFormat() != texture_format)
+  {
+    // If the memory can be imported, the GPU writes straight into the slot.
+    dltex.reset();
+    if (g_gpu_device->GetFeatures().memory_import)
+    {
+      dltex = g_gpu_device->CreateDownloadTexture(width, height, texture_format, GetSlotPixels(slot),
+                                                  m_slot_data_size, pitch);
+    }
+    if (!dltex && !(dltex = g_gpu_device->CreateDownloadTexture(width, height, texture_format, error)))
+    {
+      Error::AddPrefixFmt(error, "Failed to create {}x{} download texture: ", width, height);
+      return false;
+    }
+  }
+
+  dltex->CopyFromTexture(0, 0, texture, x, y, width, height, 0, 0, !dltex->IsImported());
+
+  slot_header->frame_number = frame_number;
+  slot_header->pixel_offset = HOST_PAGE_SIZE;
+  slot_header->width = width;
+  slot_header->height = height;
+  slot_header->pitch = pitch;
+  slot_header->format = format;
+  slot_header->pixel_aspect_ratio = pixel_aspect_ratio;
+  m_pending_slot = static_cast<s32>(slot);
+  return true;
+}
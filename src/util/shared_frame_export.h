@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#pragma once
+
+#include "common/types.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+
+enum class GPUTextureFormat : u8;
+
+class Error;
+class GPUTexture;
+class GPUDownloadTexture;
+
+/// Publishes frames into a named shared memory region, so capture and streaming tools on the same machine can read
+/// them directly instead of capturing the window.
+///
+/// The region starts with a Header, followed by slot_count slots of slot_size bytes each, starting at slot_offset.
+/// Each slot begins with a SlotHeader, and its pixels start pixel_offset bytes from the beginning of the slot. All
+/// values are in host byte order. Frames are written to the slots in turn, and each frame gets a sequence number one
+/// greater than the last, starting at 1. To read the most recent frame:
+///
+///   1. Load Header::sequence with acquire ordering. Zero means no frame has been written yet.
+///   2. Load SlotHeader::sequence of slot (sequence % slot_count) with acquire ordering. If it is different, the
+///      slot is being rewritten, start again.
+///   3. Copy the slot header fields and pixels, issue an acquire fence, and load SlotHeader::sequence again. If it
+///      changed, the frame was overwritten while it was being copied, and should be discarded.
+///
+/// When Header::closed is non-zero the writer has gone away, or replaced the region with a larger one, and it should
+/// be opened again by name.
+class SharedFrameExport
+{
+public:
+  static constexpr u32 MAGIC = 0x58465344; // DSFX
+  static constexpr u32 VERSION = 1;
+  static constexpr u32 SLOT_COUNT = 3;
+
+  enum class PixelFormat : u32
+  {
+    None = 0,
+    RGBA8 = 1,
+    BGRA8 = 2,
+    RGB565 = 3,
+    RGB5A1 = 4,
+    A1BGR5 = 5,
+  };
+
+  struct Header
+  {
+    u32 magic;
+    u32 version;
+    u32 slot_count;
+    u32 slot_offset;
+    u32 slot_size;
+    std::atomic<u32> closed;
+    std::atomic<u64> sequence;
+  };
+
+  struct SlotHeader
+  {
+    std::atomic<u64> sequence; // zero while the slot is being written
+    u32 frame_number;
+    u32 pixel_offset;
+    u32 width;
+    u32 height;
+    u32 pitch;
+    PixelFormat format;
+    float pixel_aspect_ratio;
+    u32 reserved;
+  };
+
+  static_assert(std::atomic<u32>::is_always_lock_free && std::atomic<u64>::is_always_lock_free,
+                "Atomics in shared memory must be lock-free.");
+
+  SharedFrameExport();
+  ~SharedFrameExport();
+
+  /// Name of the shared memory region, which includes the process ID so that multiple instances don't collide.
+  ALWAYS_INLINE const std::string& GetName() const { return m_name; }
+
+  /// Returns the exported pixel format for a texture format, or None if frames in that format can't be exported.
+  static PixelFormat GetPixelFormat(GPUTextureFormat format);
+
+  /// Queues a download of the specified region of the texture, and publishes the previous frame. Frames appear one
+  /// frame late, so the download has had a frame's worth of time to complete, and the GPU isn't stalled for it.
+  bool SubmitFrame(GPUTexture* texture, u32 x, u32 y, u32 width, u32 height, u32 frame_number,
+                   float pixel_aspect_ratio, Error* error);
+
+private:
+  bool CreateMapping(u32 slot_data_size, Error* error);
+  void DestroyMapping();
+  void PublishPendingFrame();
+
+  SlotHeader* GetSlotHeader(u32 slot) const;
+  u8* GetSlotPixels(u32 slot) const;
+
+  std::string m_name;
+  void* m_handle = nullptr;
+  u8* m_base = nullptr;
+  size_t m_mapping_size = 0;
+  u32 m_slot_size = 0;
+  u32 m_slot_data_size = 0;
+
+  std::array<std::unique_ptr<GPUDownloadTexture>, SLOT_COUNT> m_download_textures;
+  u64 m_next_sequence = 1;
+  s32 m_pending_slot = -1;
+};
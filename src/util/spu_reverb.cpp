@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "spu_reverb.h"
+
+#include "common/gsvector.h"
+
+#include <algorithm>
+#include <array>
+
+namespace SPUReverb {
+
+// From PSX-SPX:
+// Input and output to/from the reverb unit is resampled using a 39-tap FIR filter with the following coefficients.
+static constexpr std::array<s16, DOWNSAMPLE_TAPS> s_filter_coefficients = {
+  -0x0001, 0x0000,  0x0002, 0x0000,  -0x000A, 0x0000,  0x0023, 0x0000,  -0x0067, 0x0000,
+  0x010A,  0x0000,  -0x0268, 0x0000, 0x0534,  0x0000,  -0x0B90, 0x0000, 0x2806,  0x4000,
+  0x2806,  0x0000,  -0x0B90, 0x0000, 0x0534,  0x0000,  -0x0268, 0x0000, 0x010A,  0x0000,
+  -0x0067, 0x0000,  0x0023, 0x0000,  -0x000A, 0x0000,  0x0002, 0x0000,  -0x0001};
+
+// Same coefficients padded to a multiple of the vector size, so multiply-adds can cover all of the taps.
+alignas(VECTOR_ALIGNMENT) static constexpr std::array<s16, DOWNSAMPLE_READ_SIZE> s_downsample_coefficients = []() {
+  std::array<s16, DOWNSAMPLE_READ_SIZE> ret = {};
+  for (u32 i = 0; i < DOWNSAMPLE_TAPS; i++)
+    ret[i] = s_filter_coefficients[i];
+  return ret;
+}();
+
+// The output is calculated at 22050hz, so upsampling only uses the even taps, without the centre.
+alignas(VECTOR_ALIGNMENT) static constexpr std::array<s16, UPSAMPLE_TAPS> s_upsample_coefficients = []() {
+  std::array<s16, UPSAMPLE_TAPS> ret = {};
+  for (u32 i = 0; i < UPSAMPLE_TAPS; i++)
+    ret[i] = s_filter_coefficients[i * 2];
+  return ret;
+}();
+
+} // namespace SPUReverb
+
+s16 SPUReverb::DownsampleScalar(const s16* samples)
+{
+  s32 acc = 0;
+  for (u32 i = 0; i < DOWNSAMPLE_TAPS; i++)
+    acc += s32(s_filter_coefficients[i]) * s32(samples[i]);
+
+  return static_cast<s16>(std::clamp<s32>(acc >> 15, -32768, 32767));
+}
+
+s16 SPUReverb::Downsample(const s16* samples)
+{
+  // Multiply-add sums adjacent taps, so the zero odd taps and the centre cost nothing extra. The largest possible sum
+  // of the coefficient magnitudes times 0x8000 is well under 2^31, so none of the partial sums can overflow.
+  GSVector4i acc = GSVector4i::load<false>(&samples[0]).madd_s16(GSVector4i::load<true>(&s_downsample_coefficients[0]));
+  acc = acc.add32(GSVector4i::load<false>(&samples[8]).madd_s16(GSVector4i::load<true>(&s_downsample_coefficients[8])));
+  acc =
+    acc.add32(GSVector4i::load<false>(&samples[16]).madd_s16(GSVector4i::load<true>(&s_downsample_coefficients[16])));
+  acc =
+    acc.add32(GSVector4i::load<false>(&samples[24]).madd_s16(GSVector4i::load<true>(&s_downsample_coefficients[24])));
+  acc =
+    acc.add32(GSVector4i::load<false>(&samples[32]).madd_s16(GSVector4i::load<true>(&s_downsample_coefficients[32])));
+
+  return static_cast<s16>(std::clamp<s32>(acc.addv_s32() >> 15, -32768, 32767));
+}
+
+s16 SPUReverb::UpsampleScalar(const s16* samples)
+{
+  s32 acc = 0;
+  for (u32 i = 0; i < UPSAMPLE_TAPS; i++)
+    acc += s32(s_upsample_coefficients[i]) * s32(samples[i]);
+
+  // Only every other sample is present, so the gain is doubled.
+  return static_cast<s16>(std::clamp<s32>(acc >> 14, -32768, 32767));
+}
+
+s16 SPUReverb::Upsample(const s16* samples)
+{
+  GSVector4i acc = GSVector4i::load<false>(&samples[0]).madd_s16(GSVector4i::load<true>(&s_upsample_coefficients[0]));
+  acc = acc.add32(GSVector4i::load<false>(&samples[8]).madd_s16(GSVector4i::load<true>(&s_upsample_coefficients[8])));
+  acc = acc.add32(
+    GSVector4i::loadl<false>(&samples[16]).madd_s16(GSVector4i::loadl<true>(&s_upsample_coefficients[16])));
+
+  return static_cast<s16>(std::clamp<s32>(acc.addv_s32() >> 14, -32768, 32767));
+}
@@ -0,0 +1,29 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#pragma once
+
+#include "common/types.h"
+
+/// Half-band FIR filters used to resample SPU reverb input and output between 44100hz and 22050hz.
+namespace SPUReverb {
+
+enum : u32
+{
+  DOWNSAMPLE_TAPS = 39,
+  UPSAMPLE_TAPS = 20,
+
+  // The vector path reads one sample past the last tap, which is multiplied by zero.
+  DOWNSAMPLE_READ_SIZE = DOWNSAMPLE_TAPS + 1,
+};
+
+/// Filters DOWNSAMPLE_TAPS consecutive 44100hz samples to a single 22050hz sample. Odd taps other than the centre are
+/// zero, so they're skipped. samples must have DOWNSAMPLE_READ_SIZE readable entries.
+s16 Downsample(const s16* samples);
+s16 DownsampleScalar(const s16* samples);
+
+/// Interpolates the missing 44100hz sample from UPSAMPLE_TAPS consecutive 22050hz samples.
+s16 Upsample(const s16* samples);
+s16 UpsampleScalar(const s16* samples);
+
+} // namespace SPUReverb
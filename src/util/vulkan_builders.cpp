@@ -333,6 +333,71 @@ VkPipeline Vulkan::GraphicsPipelineBuilder::Create(VkDevice device, VkPipelineCa
   return pipeline;
 }
 
+VkPipeline Vulkan::GraphicsPipelineBuilder::CreateLibrary(VkDevice device, VkPipelineCache pipeline_cache,
+                                                          VkGraphicsPipelineLibraryFlagsEXT parts, Error* error)
+{
+  // Stages from other parts aren't allowed in the library.
+  VkShaderStageFlags allowed_stages = 0;
+  if (parts & VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT)
+    allowed_stages |= VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_GEOMETRY_BIT;
+  if (parts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT)
+    allowed_stages |= VK_SHADER_STAGE_FRAGMENT_BIT;
+
+  std::array<VkPipelineShaderStageCreateInfo, MAX_SHADER_STAGES> stages;
+  u32 num_stages = 0;
+  for (u32 i = 0; i < m_ci.stageCount; i++)
+  {
+    if (m_shader_stages[i].stage & allowed_stages)
+      stages[num_stages++] = m_shader_stages[i];
+  }
+
+  const VkGraphicsPipelineLibraryCreateInfoEXT library_ci = {
+    VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT, m_ci.pNext, parts};
+
+  VkGraphicsPipelineCreateInfo ci = m_ci;
+  ci.pNext = &library_ci;
+  ci.flags |= VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+  ci.stageCount = num_stages;
+  ci.pStages = (num_stages > 0) ? stages.data() : nullptr;
+
+  VkPipeline pipeline;
+  VkResult res = vkCreateGraphicsPipelines(device, pipeline_cache, 1, &ci, nullptr, &pipeline);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vkCreateGraphicsPipelines() for library failed: ");
+    SetErrorObject(error, "vkCreateGraphicsPipelines() for library failed: ", res);
+    return VK_NULL_HANDLE;
+  }
+
+  return pipeline;
+}
+
+VkPipeline Vulkan::GraphicsPipelineBuilder::LinkLibraries(VkDevice device, VkPipelineCache pipeline_cache,
+                                                          VkPipelineLayout layout,
+                                                          std::span<const VkPipeline> libraries, bool optimize,
+                                                          Error* error)
+{
+  const VkPipelineLibraryCreateInfoKHR library_ci = {VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR, nullptr,
+                                                     static_cast<u32>(libraries.size()), libraries.data()};
+
+  VkGraphicsPipelineCreateInfo ci = {};
+  ci.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+  ci.pNext = &library_ci;
+  ci.flags = optimize ? VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT : 0;
+  ci.layout = layout;
+
+  VkPipeline pipeline;
+  VkResult res = vkCreateGraphicsPipelines(device, pipeline_cache, 1, &ci, nullptr, &pipeline);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vkCreateGraphicsPipelines() for linking failed: ");
+    SetErrorObject(error, "vkCreateGraphicsPipelines() for linking failed: ", res);
+    return VK_NULL_HANDLE;
+  }
+
+  return pipeline;
+}
+
 void Vulkan::GraphicsPipelineBuilder::SetShaderStage(VkShaderStageFlagBits stage, VkShaderModule module,
                                                      const char* entry_point)
 {
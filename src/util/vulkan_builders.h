@@ -10,6 +10,7 @@
 #include "common/string_util.h"
 
 #include <array>
+#include <span>
 #include <string_view>
 
 class Error;
@@ -96,6 +97,16 @@ public:
 
   VkPipeline Create(VkDevice device, VkPipelineCache pipeline_cache, bool clear, Error* error);
 
+  /// Creates a pipeline library (VK_EXT_graphics_pipeline_library) from the subset of the state given by parts.
+  /// Only the shader stages which belong to those parts are included. Libraries retain the information needed to
+  /// link them with optimization later.
+  VkPipeline CreateLibrary(VkDevice device, VkPipelineCache pipeline_cache, VkGraphicsPipelineLibraryFlagsEXT parts,
+                           Error* error);
+
+  /// Links a full set of libraries into a pipeline. Without optimization this is fast, but the pipeline is slower.
+  static VkPipeline LinkLibraries(VkDevice device, VkPipelineCache pipeline_cache, VkPipelineLayout layout,
+                                  std::span<const VkPipeline> libraries, bool optimize, Error* error);
+
   void SetShaderStage(VkShaderStageFlagBits stage, VkShaderModule module, const char* entry_point);
   void SetVertexShader(VkShaderModule module) { SetShaderStage(VK_SHADER_STAGE_VERTEX_BIT, module, "main"); }
   void SetGeometryShader(VkShaderModule module) { SetShaderStage(VK_SHADER_STAGE_GEOMETRY_BIT, module, "main"); }
@@ -197,6 +197,10 @@ bool VulkanDevice::EnableOptionalDeviceExtensions(VkPhysicalDevice physical_devi
     VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_4_FEATURES, nullptr, VK_FALSE};
   VkPhysicalDeviceMaintenance5FeaturesKHR maintenance5_features = {
     VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_5_FEATURES_KHR, nullptr, VK_FALSE};
+  VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphics_pipeline_library_feature = {
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT, nullptr, VK_FALSE};
+  VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timeline_semaphore_feature = {
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR, nullptr, VK_FALSE};
 
   // add in optional feature structs
   // Gate most of the extension checks behind a Vulkan 1.1 device, so we don't have to deal with situations where
@@ -239,6 +243,17 @@ bool VulkanDevice::EnableOptionalDeviceExtensions(VkPhysicalDevice physical_devi
         Vulkan::AddPointerToChain(&features2, &maintenance5_features);
       }
     }
+    if (SupportsExtension(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+        SupportsExtension(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME))
+    {
+      m_optional_extensions.vk_ext_graphics_pipeline_library = true;
+      Vulkan::AddPointerToChain(&features2, &graphics_pipeline_library_feature);
+    }
+    if (SupportsExtension(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+    {
+      m_optional_extensions.vk_khr_timeline_semaphore = true;
+      Vulkan::AddPointerToChain(&features2, &timeline_semaphore_feature);
+    }
   }
 
   // don't bother querying if we're not actually looking at any features
@@ -259,12 +274,17 @@ bool VulkanDevice::EnableOptionalDeviceExtensions(VkPhysicalDevice physical_devi
   m_optional_extensions.vk_khr_maintenance4 &= (maintenance4_features.maintenance4 == VK_TRUE);
   m_optional_extensions.vk_khr_maintenance5 &=
     (m_optional_extensions.vk_khr_dynamic_rendering && maintenance5_features.maintenance5 == VK_TRUE);
+  m_optional_extensions.vk_ext_graphics_pipeline_library &=
+    (graphics_pipeline_library_feature.graphicsPipelineLibrary == VK_TRUE);
+  m_optional_extensions.vk_khr_timeline_semaphore &= (timeline_semaphore_feature.timelineSemaphore == VK_TRUE);
 
   VkPhysicalDeviceProperties2 properties2 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, nullptr, {}};
   VkPhysicalDevicePushDescriptorPropertiesKHR push_descriptor_properties = {
     VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR, nullptr, 0u};
   VkPhysicalDeviceExternalMemoryHostPropertiesEXT external_memory_host_properties = {
     VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT, nullptr, 0};
+  VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT graphics_pipeline_library_properties = {
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT, nullptr, VK_FALSE, VK_FALSE};
 
   if (SupportsExtension(VK_KHR_DRIVER_PROPERTIES_EXTENSION_NAME))
   {
@@ -285,6 +305,9 @@ bool VulkanDevice::EnableOptionalDeviceExtensions(VkPhysicalDevice physical_devi
     Vulkan::AddPointerToChain(&properties2, &external_memory_host_properties);
   }
 
+  if (m_optional_extensions.vk_ext_graphics_pipeline_library)
+    Vulkan::AddPointerToChain(&properties2, &graphics_pipeline_library_properties);
+
   // don't bother querying if we're not actually looking at any features
   if (vkGetPhysicalDeviceProperties2 && properties2.pNext)
     vkGetPhysicalDeviceProperties2(physical_device, &properties2);
@@ -299,6 +322,10 @@ bool VulkanDevice::EnableOptionalDeviceExtensions(VkPhysicalDevice physical_devi
   m_optional_extensions.vk_ext_external_memory_host &=
     (external_memory_host_properties.minImportedHostPointerAlignment <= HOST_PAGE_SIZE);
 
+  // pipeline libraries are only worth it if linking them is quick, otherwise we might as well compile the whole thing
+  m_optional_extensions.vk_ext_graphics_pipeline_library &=
+    (graphics_pipeline_library_properties.graphicsPipelineLibraryFastLinking == VK_TRUE);
+
   if (m_driver_type == GPUDriverType::QualcommProprietary || m_driver_type == GPUDriverType::ARMProprietary ||
       m_driver_type == GPUDriverType::ImaginationProprietary)
   {
@@ -382,6 +409,15 @@ bool VulkanDevice::EnableOptionalDeviceExtensions(VkPhysicalDevice physical_devi
     if (m_optional_extensions.vk_khr_maintenance5)
       AddExtension(VK_KHR_MAINTENANCE_5_EXTENSION_NAME);
 
+    if (m_optional_extensions.vk_ext_graphics_pipeline_library)
+    {
+      AddExtension(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+      AddExtension(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+    }
+
+    if (m_optional_extensions.vk_khr_timeline_semaphore)
+      AddExtension(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+
     // Driver support for swapchain maintenance is a mess... try KHR first, then EXT.
     m_optional_extensions.vk_khr_swapchain_maintenance1 =
       enable_surface && VulkanLoader::GetOptionalExtensions().vk_khr_surface_maintenance1 &&
@@ -406,6 +442,7 @@ bool VulkanDevice::EnableOptionalDeviceExtensions(VkPhysicalDevice physical_devi
 
   LOG_EXT("VK_EXT_external_memory_host", vk_ext_external_memory_host);
   LOG_EXT("VK_EXT_fragment_shader_interlock", vk_ext_fragment_shader_interlock);
+  LOG_EXT("VK_EXT_graphics_pipeline_library", vk_ext_graphics_pipeline_library);
   LOG_EXT("VK_EXT_memory_budget", vk_ext_memory_budget);
   LOG_EXT("VK_EXT_rasterization_order_attachment_access", vk_ext_rasterization_order_attachment_access);
   LOG_EXT("VK_KHR_driver_properties", vk_khr_driver_properties);
@@ -415,6 +452,7 @@ bool VulkanDevice::EnableOptionalDeviceExtensions(VkPhysicalDevice physical_devi
   LOG_EXT("VK_KHR_maintenance5", vk_khr_maintenance5);
   LOG_EXT("VK_KHR_push_descriptor", vk_khr_push_descriptor);
   LOG_EXT("VK_KHR_swapchain_maintenance1", vk_khr_swapchain_maintenance1);
+  LOG_EXT("VK_KHR_timeline_semaphore", vk_khr_timeline_semaphore);
 
 #ifdef _WIN32
   m_optional_extensions.vk_ext_full_screen_exclusive =
@@ -490,6 +528,24 @@ bool VulkanDevice::CreateDevice(VkPhysicalDevice physical_device, VkSurfaceKHR s
     return false;
   }
 
+  // A transfer-only family is usually backed by a DMA engine, which can copy while the graphics queue is busy.
+  // Uploads don't use offsets the driver would have to be told about, but require full texel granularity anyway.
+  m_transfer_queue_family_index = queue_family_count;
+  for (u32 i = 0; i < queue_family_count; i++)
+  {
+    const VkQueueFamilyProperties& props = queue_family_properties[i];
+    if ((props.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT)) !=
+          VK_QUEUE_TRANSFER_BIT ||
+        props.queueCount == 0 || props.minImageTransferGranularity.width != 1 ||
+        props.minImageTransferGranularity.height != 1 || props.minImageTransferGranularity.depth != 1)
+    {
+      continue;
+    }
+
+    m_transfer_queue_family_index = i;
+    break;
+  }
+
   VkDeviceCreateInfo device_info = {};
   device_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
   device_info.pNext = nullptr;
@@ -497,7 +553,7 @@ bool VulkanDevice::CreateDevice(VkPhysicalDevice physical_device, VkSurfaceKHR s
   device_info.queueCreateInfoCount = 0;
 
   static constexpr float queue_priorities[] = {1.0f};
-  std::array<VkDeviceQueueCreateInfo, 2> queue_infos;
+  std::array<VkDeviceQueueCreateInfo, 3> queue_infos;
   VkDeviceQueueCreateInfo& graphics_queue_info = queue_infos[device_info.queueCreateInfoCount++];
   graphics_queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
   graphics_queue_info.pNext = nullptr;
@@ -517,6 +573,17 @@ bool VulkanDevice::CreateDevice(VkPhysicalDevice physical_device, VkSurfaceKHR s
     present_queue_info.pQueuePriorities = queue_priorities;
   }
 
+  if (m_transfer_queue_family_index != queue_family_count)
+  {
+    VkDeviceQueueCreateInfo& transfer_queue_info = queue_infos[device_info.queueCreateInfoCount++];
+    transfer_queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    transfer_queue_info.pNext = nullptr;
+    transfer_queue_info.flags = 0;
+    transfer_queue_info.queueFamilyIndex = m_transfer_queue_family_index;
+    transfer_queue_info.queueCount = 1;
+    transfer_queue_info.pQueuePriorities = queue_priorities;
+  }
+
   device_info.pQueueCreateInfos = queue_infos.data();
 
   u32 extension_count = 0;
@@ -568,6 +635,10 @@ bool VulkanDevice::CreateDevice(VkPhysicalDevice physical_device, VkSurfaceKHR s
     VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_4_FEATURES, nullptr, VK_TRUE};
   VkPhysicalDeviceMaintenance5FeaturesKHR maintenance5_features = {
     VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_5_FEATURES_KHR, nullptr, VK_TRUE};
+  VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphics_pipeline_library_feature = {
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT, nullptr, VK_TRUE};
+  VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timeline_semaphore_feature = {
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR, nullptr, VK_TRUE};
 
   if (m_optional_extensions.vk_ext_rasterization_order_attachment_access)
     Vulkan::AddPointerToChain(&device_info, &rasterization_order_access_feature);
@@ -587,6 +658,10 @@ bool VulkanDevice::CreateDevice(VkPhysicalDevice physical_device, VkSurfaceKHR s
     if (m_optional_extensions.vk_khr_maintenance5)
       Vulkan::AddPointerToChain(&device_info, &maintenance5_features);
   }
+  if (m_optional_extensions.vk_ext_graphics_pipeline_library)
+    Vulkan::AddPointerToChain(&device_info, &graphics_pipeline_library_feature);
+  if (m_optional_extensions.vk_khr_timeline_semaphore)
+    Vulkan::AddPointerToChain(&device_info, &timeline_semaphore_feature);
 
   VkDevice device;
   res = vkCreateDevice(physical_device, &device_info, nullptr, &device);
@@ -610,11 +685,19 @@ bool VulkanDevice::CreateDevice(VkPhysicalDevice physical_device, VkSurfaceKHR s
     return false;
   }
 
+  // Don't want to find out we can't wait after submitting.
+  m_optional_extensions.vk_khr_timeline_semaphore &= (vkWaitSemaphoresKHR != nullptr);
+
   // Grab the graphics and present queues.
   m_device = device;
   vkGetDeviceQueue(m_device, m_graphics_queue_family_index, 0, &m_graphics_queue);
   if (surface)
     vkGetDeviceQueue(m_device, m_present_queue_family_index, 0, &m_present_queue);
+  if (m_transfer_queue_family_index != queue_family_count)
+  {
+    vkGetDeviceQueue(m_device, m_transfer_queue_family_index, 0, &m_transfer_queue);
+    INFO_LOG("Using queue family {} for transfers.", m_transfer_queue_family_index);
+  }
 
   m_features.gpu_timing = (m_device_properties.limits.timestampComputeAndGraphics != 0 &&
                            queue_family_properties[m_graphics_queue_family_index].timestampValidBits > 0 &&
@@ -723,6 +806,20 @@ bool VulkanDevice::CreateCommandBuffers()
 {
   VkResult res;
 
+  if (m_optional_extensions.vk_khr_timeline_semaphore)
+  {
+    const VkSemaphoreTypeCreateInfoKHR type_info = {VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR, nullptr,
+                                                    VK_SEMAPHORE_TYPE_TIMELINE_KHR, m_completed_fence_counter};
+    const VkSemaphoreCreateInfo semaphore_info = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, &type_info, 0};
+    res = vkCreateSemaphore(m_device, &semaphore_info, nullptr, &m_timeline_semaphore);
+    if (res != VK_SUCCESS)
+    {
+      LOG_VULKAN_ERROR(res, "vkCreateSemaphore failed: ");
+      return false;
+    }
+    Vulkan::SetObjectName(m_device, m_timeline_semaphore, "Timeline Semaphore");
+  }
+
   u32 frame_index = 0;
   for (CommandBuffer& resources : m_frame_resources)
   {
@@ -753,15 +850,50 @@ bool VulkanDevice::CreateCommandBuffers()
                             TinyString::from_format("Frame {} {}Command Buffer", frame_index, (i == 0) ? "Init" : ""));
     }
 
-    VkFenceCreateInfo fence_info = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, nullptr, VK_FENCE_CREATE_SIGNALED_BIT};
+    if (m_timeline_semaphore == VK_NULL_HANDLE)
+    {
+      VkFenceCreateInfo fence_info = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, nullptr, VK_FENCE_CREATE_SIGNALED_BIT};
 
-    res = vkCreateFence(m_device, &fence_info, nullptr, &resources.fence);
-    if (res != VK_SUCCESS)
+      res = vkCreateFence(m_device, &fence_info, nullptr, &resources.fence);
+      if (res != VK_SUCCESS)
+      {
+        LOG_VULKAN_ERROR(res, "vkCreateFence failed: ");
+        return false;
+      }
+      Vulkan::SetObjectName(m_device, resources.fence, TinyString::from_format("Frame Fence {}", frame_index));
+    }
+
+    if (m_transfer_queue != VK_NULL_HANDLE)
     {
-      LOG_VULKAN_ERROR(res, "vkCreateFence failed: ");
-      return false;
+      const VkCommandPoolCreateInfo transfer_pool_info = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO, nullptr, 0,
+                                                          m_transfer_queue_family_index};
+      res = vkCreateCommandPool(m_device, &transfer_pool_info, nullptr, &resources.transfer_command_pool);
+      if (res != VK_SUCCESS)
+      {
+        LOG_VULKAN_ERROR(res, "vkCreateCommandPool failed: ");
+        return false;
+      }
+
+      const VkCommandBufferAllocateInfo transfer_buffer_info = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                                                                nullptr, resources.transfer_command_pool,
+                                                                VK_COMMAND_BUFFER_LEVEL_PRIMARY, 1};
+      res = vkAllocateCommandBuffers(m_device, &transfer_buffer_info, &resources.transfer_command_buffer);
+      if (res != VK_SUCCESS)
+      {
+        LOG_VULKAN_ERROR(res, "vkAllocateCommandBuffers failed: ");
+        return false;
+      }
+      Vulkan::SetObjectName(m_device, resources.transfer_command_buffer,
+                            TinyString::from_format("Frame {} Transfer Command Buffer", frame_index));
+
+      const VkSemaphoreCreateInfo semaphore_info = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, nullptr, 0};
+      res = vkCreateSemaphore(m_device, &semaphore_info, nullptr, &resources.transfer_semaphore);
+      if (res != VK_SUCCESS)
+      {
+        LOG_VULKAN_ERROR(res, "vkCreateSemaphore failed: ");
+        return false;
+      }
     }
-    Vulkan::SetObjectName(m_device, resources.fence, TinyString::from_format("Frame Fence {}", frame_index));
 
     u32 num_pools = 0;
     VkDescriptorPoolSize pool_sizes[2];
@@ -806,6 +938,18 @@ void VulkanDevice::DestroyCommandBuffers()
     }
     if (resources.command_pool != VK_NULL_HANDLE)
       vkDestroyCommandPool(m_device, resources.command_pool, nullptr);
+    if (resources.transfer_semaphore != VK_NULL_HANDLE)
+      vkDestroySemaphore(m_device, resources.transfer_semaphore, nullptr);
+    if (resources.transfer_command_buffer != VK_NULL_HANDLE)
+      vkFreeCommandBuffers(m_device, resources.transfer_command_pool, 1, &resources.transfer_command_buffer);
+    if (resources.transfer_command_pool != VK_NULL_HANDLE)
+      vkDestroyCommandPool(m_device, resources.transfer_command_pool, nullptr);
+  }
+
+  if (m_timeline_semaphore != VK_NULL_HANDLE)
+  {
+    vkDestroySemaphore(m_device, m_timeline_semaphore, nullptr);
+    m_timeline_semaphore = VK_NULL_HANDLE;
   }
 }
 
@@ -834,7 +978,8 @@ bool VulkanDevice::CreatePersistentDescriptorPool()
   if (m_features.gpu_timing)
   {
     const VkQueryPoolCreateInfo query_create_info = {
-      VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, nullptr, 0, VK_QUERY_TYPE_TIMESTAMP, NUM_COMMAND_BUFFERS * 4, 0};
+      VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, nullptr, 0, VK_QUERY_TYPE_TIMESTAMP,
+      NUM_COMMAND_BUFFERS * NUM_TIMESTAMP_QUERIES_PER_COMMAND_BUFFER, 0};
     res = vkCreateQueryPool(m_device, &query_create_info, nullptr, &m_timestamp_query_pool);
     if (res != VK_SUCCESS)
     {
@@ -874,6 +1019,30 @@ size_t VulkanDevice::RenderPassCacheKeyHash::operator()(const RenderPassCacheKey
     return XXH32(&rhs, sizeof(rhs), 0x1337);
 }
 
+bool VulkanDevice::PipelineLibraryKey::operator==(const PipelineLibraryKey& rhs) const
+{
+  return (part == rhs.part && state_hash_low == rhs.state_hash_low && state_hash_high == rhs.state_hash_high);
+}
+
+bool VulkanDevice::DescriptorSetCacheKey::operator==(const DescriptorSetCacheKey& rhs) const
+{
+  return (std::memcmp(this, &rhs, sizeof(*this)) == 0);
+}
+
+size_t VulkanDevice::DescriptorSetCacheKeyHash::operator()(const DescriptorSetCacheKey& rhs) const
+{
+  if constexpr (sizeof(void*) == 8)
+    return XXH3_64bits(&rhs, sizeof(rhs));
+  else
+    return XXH32(&rhs, sizeof(rhs), 0x1337);
+}
+
+size_t VulkanDevice::PipelineLibraryKeyHash::operator()(const PipelineLibraryKey& rhs) const
+{
+  // already a hash
+  return static_cast<size_t>(rhs.state_hash_low ^ rhs.part);
+}
+
 VkRenderPass VulkanDevice::GetRenderPass(const GPUPipeline::GraphicsConfig& config)
 {
   RenderPassCacheKey key;
@@ -1005,6 +1174,22 @@ VkCommandBuffer VulkanDevice::GetCurrentInitCommandBuffer()
   return buf;
 }
 
+VkCommandBuffer VulkanDevice::GetCurrentTransferCommandBuffer()
+{
+  DebugAssert(m_transfer_queue != VK_NULL_HANDLE);
+
+  CommandBuffer& res = m_frame_resources[m_current_frame];
+  VkCommandBuffer buf = res.transfer_command_buffer;
+  if (res.transfer_buffer_used)
+    return buf;
+
+  VkCommandBufferBeginInfo bi{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, nullptr,
+                              VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr};
+  vkBeginCommandBuffer(buf, &bi);
+  res.transfer_buffer_used = true;
+  return buf;
+}
+
 VkDescriptorSet VulkanDevice::AllocateDescriptorSet(VkDescriptorSetLayout set_layout)
 {
   CommandBuffer& fres = m_frame_resources[m_current_frame];
@@ -1084,6 +1269,27 @@ bool VulkanDevice::SetGPUTimingEnabled(bool enabled)
   return (enabled == m_gpu_timing_enabled);
 }
 
+bool VulkanDevice::BeginTimingScopeQuery(const char* name)
+{
+  CommandBuffer& resources = m_frame_resources[m_current_frame];
+  if (!resources.timestamp_written || resources.timing_scopes.size() == MAX_TIMING_SCOPES_PER_COMMAND_BUFFER)
+    return false;
+
+  const u32 query = m_current_frame * NUM_TIMESTAMP_QUERIES_PER_COMMAND_BUFFER + 2 +
+                    static_cast<u32>(resources.timing_scopes.size()) * 2;
+  vkCmdWriteTimestamp(m_current_command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, m_timestamp_query_pool, query);
+  resources.timing_scopes.push_back(name);
+  return true;
+}
+
+void VulkanDevice::EndTimingScopeQuery()
+{
+  const CommandBuffer& resources = m_frame_resources[m_current_frame];
+  const u32 query = m_current_frame * NUM_TIMESTAMP_QUERIES_PER_COMMAND_BUFFER + 2 +
+                    static_cast<u32>(resources.timing_scopes.size() - 1) * 2 + 1;
+  vkCmdWriteTimestamp(m_current_command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, m_timestamp_query_pool, query);
+}
+
 void VulkanDevice::WaitForCommandBufferCompletion(u32 index)
 {
   if (m_device_was_lost)
@@ -1094,7 +1300,18 @@ void VulkanDevice::WaitForCommandBufferCompletion(u32 index)
   u32 timeouts = 0;
   for (;;)
   {
-    VkResult res = vkWaitForFences(m_device, 1, &m_frame_resources[index].fence, VK_TRUE, UINT64_MAX);
+    VkResult res;
+    if (m_timeline_semaphore != VK_NULL_HANDLE)
+    {
+      // Returns straight away if the GPU has already got this far.
+      const VkSemaphoreWaitInfoKHR wait_info = {VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR, nullptr, 0, 1,
+                                                &m_timeline_semaphore, &m_frame_resources[index].fence_counter};
+      res = vkWaitSemaphoresKHR(m_device, &wait_info, UINT64_MAX);
+    }
+    else
+    {
+      res = vkWaitForFences(m_device, 1, &m_frame_resources[index].fence, VK_TRUE, UINT64_MAX);
+    }
     if (res == VK_SUCCESS)
       break;
 
@@ -1123,19 +1340,26 @@ void VulkanDevice::WaitForCommandBufferCompletion(u32 index)
 
     if (m_gpu_timing_enabled && resources.timestamp_written)
     {
-      std::array<u64, 2> timestamps;
-      VkResult res =
-        vkGetQueryPoolResults(m_device, m_timestamp_query_pool, index * 2, static_cast<u32>(timestamps.size()),
-                              sizeof(u64) * timestamps.size(), timestamps.data(), sizeof(u64), VK_QUERY_RESULT_64_BIT);
+      std::array<u64, NUM_TIMESTAMP_QUERIES_PER_COMMAND_BUFFER> timestamps;
+      const u32 num_queries = 2 + static_cast<u32>(resources.timing_scopes.size()) * 2;
+      VkResult res = vkGetQueryPoolResults(
+        m_device, m_timestamp_query_pool, cleanup_index * NUM_TIMESTAMP_QUERIES_PER_COMMAND_BUFFER, num_queries,
+        sizeof(u64) * num_queries, timestamps.data(), sizeof(u64), VK_QUERY_RESULT_64_BIT);
       if (res == VK_SUCCESS)
       {
         // if we didn't write the timestamp at the start of the cmdbuffer (just enabled timing), the first TS will be
         // zero
         if (timestamps[0] > 0 && m_gpu_timing_enabled)
         {
-          const double ns_diff =
-            (timestamps[1] - timestamps[0]) * static_cast<double>(m_device_properties.limits.timestampPeriod);
+          const double period = static_cast<double>(m_device_properties.limits.timestampPeriod);
+          const double ns_diff = (timestamps[1] - timestamps[0]) * period;
           m_accumulated_gpu_time += static_cast<float>(ns_diff / 1000000.0);
+
+          for (size_t i = 0; i < resources.timing_scopes.size(); i++)
+          {
+            const double scope_ns_diff = (timestamps[3 + i * 2] - timestamps[2 + i * 2]) * period;
+            AccumulateTimingScopeTime(resources.timing_scopes[i], static_cast<float>(scope_ns_diff / 1000000.0));
+          }
         }
       }
       else
@@ -1164,6 +1388,7 @@ void VulkanDevice::EndAndSubmitCommandBuffer(VulkanSwapChain* present_swap_chain
     return;
 
   CommandBuffer& resources = m_frame_resources[m_current_frame];
+  EndTimingScope();
 
   // End the current command buffer.
   VkResult res;
@@ -1180,7 +1405,7 @@ void VulkanDevice::EndAndSubmitCommandBuffer(VulkanSwapChain* present_swap_chain
   if (m_gpu_timing_enabled && resources.timestamp_written)
   {
     vkCmdWriteTimestamp(m_current_command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, m_timestamp_query_pool,
-                        m_current_frame * 2 + 1);
+                        m_current_frame * NUM_TIMESTAMP_QUERIES_PER_COMMAND_BUFFER + 1);
   }
 
   res = vkEndCommandBuffer(resources.command_buffers[1]);
@@ -1190,7 +1415,40 @@ void VulkanDevice::EndAndSubmitCommandBuffer(VulkanSwapChain* present_swap_chain
     Panic("Failed to end command buffer");
   }
 
-  uint32_t wait_bits = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  // Uploads go first, so the copies can overlap with whatever the graphics queue is still working on.
+  std::array<VkSemaphore, 2> wait_semaphores;
+  std::array<VkPipelineStageFlags, 2> wait_stages;
+  u32 num_wait_semaphores = 0;
+  if (resources.transfer_buffer_used)
+  {
+    res = vkEndCommandBuffer(resources.transfer_command_buffer);
+    if (res != VK_SUCCESS)
+    {
+      LOG_VULKAN_ERROR(res, "vkEndCommandBuffer failed: ");
+      Panic("Failed to end command buffer");
+    }
+
+    const VkSubmitInfo transfer_submit_info = {VK_STRUCTURE_TYPE_SUBMIT_INFO,
+                                               nullptr,
+                                               0u,
+                                               nullptr,
+                                               nullptr,
+                                               1u,
+                                               &resources.transfer_command_buffer,
+                                               1u,
+                                               &resources.transfer_semaphore};
+    res = vkQueueSubmit(m_transfer_queue, 1, &transfer_submit_info, VK_NULL_HANDLE);
+    if (res != VK_SUCCESS)
+    {
+      LOG_VULKAN_ERROR(res, "vkQueueSubmit for transfer queue failed: ");
+      m_device_was_lost = true;
+      return;
+    }
+
+    wait_semaphores[num_wait_semaphores] = resources.transfer_semaphore;
+    wait_stages[num_wait_semaphores++] = TRANSFER_QUEUE_WAIT_STAGES;
+  }
+
   VkSubmitInfo submit_info = {VK_STRUCTURE_TYPE_SUBMIT_INFO,
                               nullptr,
                               0u,
@@ -1202,14 +1460,44 @@ void VulkanDevice::EndAndSubmitCommandBuffer(VulkanSwapChain* present_swap_chain
                               0u,
                               nullptr};
 
+  // Binary semaphores ignore their entry in the signal value array.
+  std::array<VkSemaphore, 2> signal_semaphores;
+  std::array<u64, 2> signal_values;
+  u32 num_signal_semaphores = 0;
+  if (m_timeline_semaphore != VK_NULL_HANDLE)
+  {
+    signal_semaphores[num_signal_semaphores] = m_timeline_semaphore;
+    signal_values[num_signal_semaphores++] = resources.fence_counter;
+  }
+
   if (present_swap_chain)
   {
-    submit_info.pWaitSemaphores = present_swap_chain->GetImageAcquireSemaphorePtr();
-    submit_info.waitSemaphoreCount = 1;
-    submit_info.pWaitDstStageMask = &wait_bits;
+    wait_semaphores[num_wait_semaphores] = *present_swap_chain->GetImageAcquireSemaphorePtr();
+    wait_stages[num_wait_semaphores++] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+
+    signal_semaphores[num_signal_semaphores] = *present_swap_chain->GetPresentSemaphorePtr();
+    signal_values[num_signal_semaphores++] = 0;
+  }
+
+  if (num_signal_semaphores > 0)
+  {
+    submit_info.signalSemaphoreCount = num_signal_semaphores;
+    submit_info.pSignalSemaphores = signal_semaphores.data();
+  }
 
-    submit_info.pSignalSemaphores = present_swap_chain->GetPresentSemaphorePtr();
-    submit_info.signalSemaphoreCount = 1;
+  VkTimelineSemaphoreSubmitInfoKHR timeline_submit_info;
+  if (m_timeline_semaphore != VK_NULL_HANDLE)
+  {
+    timeline_submit_info = {VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR, nullptr, 0, nullptr,
+                            num_signal_semaphores, signal_values.data()};
+    submit_info.pNext = &timeline_submit_info;
+  }
+
+  if (num_wait_semaphores > 0)
+  {
+    submit_info.waitSemaphoreCount = num_wait_semaphores;
+    submit_info.pWaitSemaphores = wait_semaphores.data();
+    submit_info.pWaitDstStageMask = wait_stages.data();
   }
 
   res = vkQueueSubmit(m_graphics_queue, 1, &submit_info, resources.fence);
@@ -1265,14 +1553,25 @@ void VulkanDevice::BeginCommandBuffer(u32 index)
     WaitForCommandBufferCompletion(index);
 
   // Reset fence to unsignaled before starting.
-  VkResult res = vkResetFences(m_device, 1, &resources.fence);
-  if (res != VK_SUCCESS)
-    LOG_VULKAN_ERROR(res, "vkResetFences failed: ");
+  VkResult res;
+  if (resources.fence != VK_NULL_HANDLE)
+  {
+    res = vkResetFences(m_device, 1, &resources.fence);
+    if (res != VK_SUCCESS)
+      LOG_VULKAN_ERROR(res, "vkResetFences failed: ");
+  }
 
   // Reset command pools to beginning since we can re-use the memory now
   res = vkResetCommandPool(m_device, resources.command_pool, 0);
   if (res != VK_SUCCESS)
     LOG_VULKAN_ERROR(res, "vkResetCommandPool failed: ");
+  if (resources.transfer_buffer_used)
+  {
+    resources.transfer_buffer_used = false;
+    res = vkResetCommandPool(m_device, resources.transfer_command_pool, 0);
+    if (res != VK_SUCCESS)
+      LOG_VULKAN_ERROR(res, "vkResetCommandPool failed: ");
+  }
 
   // Enable commands to be recorded to the two buffers again.
   VkCommandBufferBeginInfo begin_info = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, nullptr,
@@ -1282,6 +1581,7 @@ void VulkanDevice::BeginCommandBuffer(u32 index)
     LOG_VULKAN_ERROR(res, "vkBeginCommandBuffer failed: ");
 
   // Also can do the same for the descriptor pools
+  resources.descriptor_set_cache.clear();
   if (resources.needs_descriptor_pool_reset)
   {
     resources.needs_descriptor_pool_reset = false;
@@ -1292,14 +1592,16 @@ void VulkanDevice::BeginCommandBuffer(u32 index)
 
   if (m_gpu_timing_enabled)
   {
-    vkCmdResetQueryPool(resources.command_buffers[1], m_timestamp_query_pool, index * 2, 2);
+    vkCmdResetQueryPool(resources.command_buffers[1], m_timestamp_query_pool,
+                        index * NUM_TIMESTAMP_QUERIES_PER_COMMAND_BUFFER, NUM_TIMESTAMP_QUERIES_PER_COMMAND_BUFFER);
     vkCmdWriteTimestamp(resources.command_buffers[1], VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, m_timestamp_query_pool,
-                        index * 2);
+                        index * NUM_TIMESTAMP_QUERIES_PER_COMMAND_BUFFER);
   }
 
   resources.fence_counter = m_next_fence_counter++;
   resources.init_buffer_used = false;
   resources.timestamp_written = m_gpu_timing_enabled;
+  resources.timing_scopes.clear();
 
   m_current_frame = index;
   m_current_command_buffer = resources.command_buffers[1];
@@ -1659,6 +1961,7 @@ void VulkanDevice::DestroyDevice()
   DestroyBuffers();
 
   DestroyPersistentDescriptorPool();
+  DestroyPipelineLibraries();
   DestroyPipelineLayouts();
   DestroyCommandBuffers();
   DestroyAllocator();
@@ -2015,6 +2318,7 @@ void VulkanDevice::SetFeatures(CreateFlags create_flags, VkPhysicalDevice physic
   m_features.timed_present = false;
   m_features.shader_cache = true;
   m_features.pipeline_cache = true;
+  m_features.threaded_pipeline_creation = true;
   m_features.prefer_unused_textures = true;
   m_features.raster_order_views =
     (!HasCreateFlag(create_flags, CreateFlags::DisableRasterOrderViews) && vk_features.fragmentStoresAndAtomics &&
@@ -3066,6 +3370,7 @@ void VulkanDevice::SetPipeline(GPUPipeline* pipeline)
     if (!m_current_pipeline)
       return;
 
+    m_current_pipeline->CheckForOptimizedPipeline();
     SetInitialPipelineState();
     return;
   }
@@ -3075,6 +3380,7 @@ void VulkanDevice::SetPipeline(GPUPipeline* pipeline)
   }
 
   m_current_pipeline = static_cast<VulkanPipeline*>(pipeline);
+  m_current_pipeline->CheckForOptimizedPipeline();
 
   vkCmdBindPipeline(m_current_command_buffer,
                     IsComputeLayout(m_current_pipeline->GetLayout()) ? VK_PIPELINE_BIND_POINT_COMPUTE :
@@ -3406,21 +3712,33 @@ bool VulkanDevice::UpdateDescriptorSetsForLayout(u32 dirty)
     }
     else
     {
-      VkDescriptorSet tds = AllocateDescriptorSet(m_multi_texture_ds_layout);
-      if (tds == VK_NULL_HANDLE)
-        return false;
-
-      ds[num_ds++] = tds;
-
+      DescriptorSetCacheKey key;
+      std::memset(&key, 0, sizeof(key));
+      key.set_layout = m_multi_texture_ds_layout;
       for (u32 i = 0; i < MAX_TEXTURE_SAMPLERS; i++)
       {
         VulkanTexture* const tex =
           m_current_textures[i] ? m_current_textures[i] : static_cast<VulkanTexture*>(m_empty_texture.get());
         DebugAssert(tex && m_current_samplers[i] != VK_NULL_HANDLE);
-        dsub.AddCombinedImageSamplerDescriptorWrite(tds, i, tex->GetView(), m_current_samplers[i], tex->GetVkLayout());
+        key.views[i] = tex->GetView();
+        key.samplers[i] = m_current_samplers[i];
+        key.image_layouts[i] = tex->GetVkLayout();
       }
 
-      dsub.Update(m_device, false);
+      bool needs_update;
+      VkDescriptorSet tds = GetCachedDescriptorSet(key, &needs_update);
+      if (tds == VK_NULL_HANDLE)
+        return false;
+
+      ds[num_ds++] = tds;
+
+      if (needs_update)
+      {
+        for (u32 i = 0; i < MAX_TEXTURE_SAMPLERS; i++)
+          dsub.AddCombinedImageSamplerDescriptorWrite(tds, i, key.views[i], key.samplers[i], key.image_layouts[i]);
+
+        dsub.Update(m_device, false);
+      }
     }
   }
 
@@ -3429,41 +3747,59 @@ bool VulkanDevice::UpdateDescriptorSetsForLayout(u32 dirty)
        (dirty & DIRTY_FLAG_PIPELINE_LAYOUT &&
         (m_current_render_pass_flags & (GPUPipeline::ColorFeedbackLoop | GPUPipeline::BindRenderTargetsAsImages)))))
   {
+    DescriptorSetCacheKey key;
+    std::memset(&key, 0, sizeof(key));
+
     if (m_current_render_pass_flags & GPUPipeline::BindRenderTargetsAsImages)
     {
-      VkDescriptorSet ids = AllocateDescriptorSet(m_image_ds_layout);
-      if (ids == VK_NULL_HANDLE)
-        return false;
-
-      ds[num_ds++] = ids;
-
-      Vulkan::DescriptorSetUpdateBuilder dsub;
+      key.set_layout = m_image_ds_layout;
       for (u32 i = 0; i < m_num_current_render_targets; i++)
       {
-        dsub.AddStorageImageDescriptorWrite(ids, i, m_current_render_targets[i]->GetView(),
-                                            m_current_render_targets[i]->GetVkLayout());
+        key.views[i] = m_current_render_targets[i]->GetView();
+        key.image_layouts[i] = m_current_render_targets[i]->GetVkLayout();
       }
 
       // Annoyingly, have to update all slots...
-      const VkImageView null_view = static_cast<VulkanTexture*>(m_empty_texture.get())->GetView();
-      const VkImageLayout null_layout = static_cast<VulkanTexture*>(m_empty_texture.get())->GetVkLayout();
       for (u32 i = m_num_current_render_targets; i < MAX_IMAGE_RENDER_TARGETS; i++)
-        dsub.AddStorageImageDescriptorWrite(ids, i, null_view, null_layout);
+      {
+        key.views[i] = static_cast<VulkanTexture*>(m_empty_texture.get())->GetView();
+        key.image_layouts[i] = static_cast<VulkanTexture*>(m_empty_texture.get())->GetVkLayout();
+      }
 
-      dsub.Update(m_device, false);
+      bool needs_update;
+      VkDescriptorSet ids = GetCachedDescriptorSet(key, &needs_update);
+      if (ids == VK_NULL_HANDLE)
+        return false;
+
+      ds[num_ds++] = ids;
+
+      if (needs_update)
+      {
+        Vulkan::DescriptorSetUpdateBuilder dsub;
+        for (u32 i = 0; i < MAX_IMAGE_RENDER_TARGETS; i++)
+          dsub.AddStorageImageDescriptorWrite(ids, i, key.views[i], key.image_layouts[i]);
+        dsub.Update(m_device, false);
+      }
     }
     else
     {
-      VkDescriptorSet ids = AllocateDescriptorSet(m_feedback_loop_ds_layout);
+      key.set_layout = m_feedback_loop_ds_layout;
+      key.views[0] = m_current_render_targets[0]->GetView();
+      key.image_layouts[0] = m_current_render_targets[0]->GetVkLayout();
+
+      bool needs_update;
+      VkDescriptorSet ids = GetCachedDescriptorSet(key, &needs_update);
       if (ids == VK_NULL_HANDLE)
         return false;
 
       ds[num_ds++] = ids;
 
-      Vulkan::DescriptorSetUpdateBuilder dsub;
-      dsub.AddInputAttachmentDescriptorWrite(ids, 0, m_current_render_targets[0]->GetView(),
-                                             m_current_render_targets[0]->GetVkLayout());
-      dsub.Update(m_device, false);
+      if (needs_update)
+      {
+        Vulkan::DescriptorSetUpdateBuilder dsub;
+        dsub.AddInputAttachmentDescriptorWrite(ids, 0, key.views[0], key.image_layouts[0]);
+        dsub.Update(m_device, false);
+      }
     }
   }
 
@@ -3475,6 +3811,24 @@ bool VulkanDevice::UpdateDescriptorSetsForLayout(u32 dirty)
   return true;
 }
 
+VkDescriptorSet VulkanDevice::GetCachedDescriptorSet(const DescriptorSetCacheKey& key, bool* needs_update)
+{
+  CommandBuffer& fres = m_frame_resources[m_current_frame];
+  const auto it = fres.descriptor_set_cache.find(key);
+  if (it != fres.descriptor_set_cache.end())
+  {
+    *needs_update = false;
+    return it->second;
+  }
+
+  const VkDescriptorSet ds = AllocateDescriptorSet(key.set_layout);
+  if (ds != VK_NULL_HANDLE)
+    fres.descriptor_set_cache.emplace(key, ds);
+
+  *needs_update = true;
+  return ds;
+}
+
 bool VulkanDevice::UpdateDescriptorSets(u32 dirty)
 {
   switch (m_current_pipeline_layout)
@@ -17,6 +17,7 @@
 #include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -29,6 +30,10 @@ class VulkanDownloadTexture;
 
 struct VK_PIPELINE_CACHE_HEADER;
 
+namespace Vulkan {
+class GraphicsPipelineBuilder;
+}
+
 class VulkanDevice final : public GPUDevice
 {
 public:
@@ -38,6 +43,10 @@ public:
   enum : u32
   {
     NUM_COMMAND_BUFFERS = 3,
+
+    /// Start/end of the command buffer, followed by a begin/end pair for each timing scope.
+    MAX_TIMING_SCOPES_PER_COMMAND_BUFFER = 256,
+    NUM_TIMESTAMP_QUERIES_PER_COMMAND_BUFFER = 2 + MAX_TIMING_SCOPES_PER_COMMAND_BUFFER * 2,
   };
 
   struct OptionalExtensions
@@ -45,6 +54,7 @@ public:
     bool vk_ext_external_memory_host : 1;
     bool vk_ext_fragment_shader_interlock : 1;
     bool vk_ext_full_screen_exclusive : 1;
+    bool vk_ext_graphics_pipeline_library : 1;
     bool vk_ext_memory_budget : 1;
     bool vk_ext_rasterization_order_attachment_access : 1;
     bool vk_khr_driver_properties : 1;
@@ -55,6 +65,7 @@ public:
     bool vk_khr_push_descriptor : 1;
     bool vk_khr_shader_non_semantic_info : 1;
     bool vk_khr_swapchain_maintenance1 : 1;
+    bool vk_khr_timeline_semaphore : 1;
   };
 
   using ExtensionList = std::vector<const char*>;
@@ -156,6 +167,8 @@ public:
   ALWAYS_INLINE VkPhysicalDevice GetVulkanPhysicalDevice() const { return m_physical_device; }
   ALWAYS_INLINE u32 GetGraphicsQueueFamilyIndex() const { return m_graphics_queue_family_index; }
   ALWAYS_INLINE u32 GetPresentQueueFamilyIndex() const { return m_present_queue_family_index; }
+  ALWAYS_INLINE u32 GetTransferQueueFamilyIndex() const { return m_transfer_queue_family_index; }
+  ALWAYS_INLINE bool HasTransferQueue() const { return (m_transfer_queue != VK_NULL_HANDLE); }
   ALWAYS_INLINE const OptionalExtensions& GetOptionalExtensions() const { return m_optional_extensions; }
 
   // Helpers for getting constants
@@ -185,6 +198,15 @@ public:
   ALWAYS_INLINE VulkanStreamBuffer& GetTextureUploadBuffer() { return m_texture_upload_buffer; }
   VkCommandBuffer GetCurrentInitCommandBuffer();
 
+  /// Returns a command buffer for the dedicated transfer queue, which is submitted before the current command buffer.
+  /// Images written by it have to be released to the graphics queue, and acquired in the init command buffer with
+  /// TRANSFER_QUEUE_WAIT_STAGES as the source stages.
+  VkCommandBuffer GetCurrentTransferCommandBuffer();
+
+  /// Stages of the current command buffer which wait for the transfer queue.
+  static constexpr VkPipelineStageFlags TRANSFER_QUEUE_WAIT_STAGES =
+    VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
   /// Allocates a descriptor set from the pool reserved for the current frame.
   VkDescriptorSet AllocateDescriptorSet(VkDescriptorSetLayout set_layout);
 
@@ -246,6 +268,9 @@ protected:
   bool CreatePipelineCache(const std::string& path, Error* error) override;
   bool GetPipelineCacheData(DynamicHeapArray<u8>* data, Error* error) override;
 
+  bool BeginTimingScopeQuery(const char* name) override;
+  void EndTimingScopeQuery() override;
+
 private:
   enum DIRTY_FLAG : u32
   {
@@ -294,6 +319,39 @@ private:
     size_t operator()(const RenderPassCacheKey& rhs) const;
   };
 
+  /// Identifies a pipeline library by the part of the pipeline it contains, and a hash of the state for that part.
+  struct PipelineLibraryKey
+  {
+    VkGraphicsPipelineLibraryFlagsEXT part;
+    u32 pad;
+    u64 state_hash_low;
+    u64 state_hash_high;
+
+    bool operator==(const PipelineLibraryKey& rhs) const;
+  };
+
+  struct PipelineLibraryKeyHash
+  {
+    size_t operator()(const PipelineLibraryKey& rhs) const;
+  };
+
+  /// Descriptor sets only need to be written once per command buffer for each set of bindings, since the pool is
+  /// reset at the same time as the command buffer.
+  struct DescriptorSetCacheKey
+  {
+    VkDescriptorSetLayout set_layout;
+    std::array<VkImageView, MAX_TEXTURE_SAMPLERS> views;
+    std::array<VkSampler, MAX_TEXTURE_SAMPLERS> samplers;
+    std::array<VkImageLayout, MAX_TEXTURE_SAMPLERS> image_layouts;
+
+    bool operator==(const DescriptorSetCacheKey& rhs) const;
+  };
+
+  struct DescriptorSetCacheKeyHash
+  {
+    size_t operator()(const DescriptorSetCacheKey& rhs) const;
+  };
+
   struct CommandBuffer
   {
     // [0] - Init (upload) command buffer, [1] - draw command buffer
@@ -305,6 +363,15 @@ private:
     bool init_buffer_used = false;
     bool needs_descriptor_pool_reset = false;
     bool timestamp_written = false;
+    std::vector<const char*> timing_scopes;
+
+    // Only created when there's a dedicated transfer queue.
+    VkCommandPool transfer_command_pool = VK_NULL_HANDLE;
+    VkCommandBuffer transfer_command_buffer = VK_NULL_HANDLE;
+    VkSemaphore transfer_semaphore = VK_NULL_HANDLE;
+    bool transfer_buffer_used = false;
+
+    std::unordered_map<DescriptorSetCacheKey, VkDescriptorSet, DescriptorSetCacheKeyHash> descriptor_set_cache;
   };
 
   using CleanupObjectFunction = void (*)(VulkanDevice& dev, void* obj);
@@ -357,9 +424,20 @@ private:
   bool UpdateDescriptorSetsForLayout(u32 dirty);
   bool UpdateDescriptorSets(u32 dirty);
 
+  /// Returns a descriptor set for the current command buffer with the given bindings. The caller has to write the
+  /// descriptors if needs_update is set.
+  VkDescriptorSet GetCachedDescriptorSet(const DescriptorSetCacheKey& key, bool* needs_update);
+
   void BeginSwapChainRenderPass(VulkanSwapChain* swap_chain, u32 clear_color);
 
   VkRenderPass CreateCachedRenderPass(RenderPassCacheKey key);
+
+  /// Fast-links a pipeline from libraries, and queues linking it again with optimization in the background.
+  std::unique_ptr<GPUPipeline> CreateLinkedPipeline(const GPUPipeline::GraphicsConfig& config,
+                                                    Vulkan::GraphicsPipelineBuilder& gpb, VkPipelineLayout layout,
+                                                    VkRenderPass render_pass, u8 vertices_per_primitive, Error* error);
+  VkPipeline GetPipelineLibrary(Vulkan::GraphicsPipelineBuilder& gpb, const PipelineLibraryKey& key, Error* error);
+  void DestroyPipelineLibraries();
   static VkFramebuffer CreateFramebuffer(GPUTexture* const* rts, u32 num_rts, GPUTexture* ds, u32 flags);
   static void DestroyFramebuffer(VkFramebuffer fbo);
 
@@ -381,6 +459,11 @@ private:
   VkQueue m_present_queue = VK_NULL_HANDLE;
   u32 m_graphics_queue_family_index = 0;
   u32 m_present_queue_family_index = 0;
+  VkQueue m_transfer_queue = VK_NULL_HANDLE;
+
+  // Signalled with each command buffer's fence counter when available, replacing the per-command-buffer fences.
+  VkSemaphore m_timeline_semaphore = VK_NULL_HANDLE;
+  u32 m_transfer_queue_family_index = 0;
 
   VkDescriptorPool m_global_descriptor_pool = VK_NULL_HANDLE;
 
@@ -426,6 +509,9 @@ private:
   VkQueryPool m_timestamp_query_pool = VK_NULL_HANDLE;
 
   std::unordered_map<RenderPassCacheKey, VkRenderPass, RenderPassCacheKeyHash> m_render_pass_cache;
+  std::mutex m_render_pass_cache_mutex;
+  std::unordered_map<PipelineLibraryKey, VkPipeline, PipelineLibraryKeyHash> m_pipeline_libraries;
+  std::mutex m_pipeline_libraries_mutex;
   GPUFramebufferManager<VkFramebuffer, CreateFramebuffer, DestroyFramebuffer> m_framebuffer_manager;
   VkPipelineCache m_pipeline_cache = VK_NULL_HANDLE;
 
@@ -249,6 +249,9 @@ VULKAN_DEVICE_ENTRY_POINT(vkCmdPushDescriptorSetKHR, false)
 // VK_KHR_swapchain_maintenance1
 VULKAN_DEVICE_ENTRY_POINT(vkReleaseSwapchainImagesKHR, false)
 
+// VK_KHR_timeline_semaphore
+VULKAN_DEVICE_ENTRY_POINT(vkWaitSemaphoresKHR, false)
+
 // VK_EXT_external_memory_host
 VULKAN_DEVICE_ENTRY_POINT(vkGetMemoryHostPointerPropertiesEXT, false)
 
@@ -8,12 +8,14 @@
 #include "common/align.h"
 #include "common/assert.h"
 #include "common/error.h"
+#include "common/fast_hash.h"
 #include "common/heap_array.h"
 #include "common/log.h"
 
 LOG_CHANNEL(GPUDevice);
 
-VulkanShader::VulkanShader(GPUShaderStage stage, VkShaderModule mod) : GPUShader(stage), m_module(mod)
+VulkanShader::VulkanShader(GPUShaderStage stage, VkShaderModule mod, u64 code_hash)
+  : GPUShader(stage), m_module(mod), m_code_hash(code_hash)
 {
 }
 
@@ -55,7 +57,10 @@ std::unique_ptr<GPUShader> VulkanDevice::CreateShaderFromBinary(GPUShaderStage s
     return {};
   }
 
-  return std::unique_ptr<GPUShader>(new VulkanShader(stage, mod));
+  // only needed to find pipeline libraries
+  const u64 code_hash = m_optional_extensions.vk_ext_graphics_pipeline_library ? FastHash::Hash64(data) : 0;
+
+  return std::unique_ptr<GPUShader>(new VulkanShader(stage, mod, code_hash));
 }
 
 std::unique_ptr<GPUShader> VulkanDevice::CreateShaderFromSource(GPUShaderStage stage, GPUShaderLanguage language,
@@ -113,6 +118,29 @@ VulkanPipeline::~VulkanPipeline()
   dev.DeferPipelineDestruction(m_pipeline);
 }
 
+VulkanPipeline::OptimizedPipeline::~OptimizedPipeline()
+{
+  // not swapped in, the pipeline was destroyed before the link finished
+  if (const VkPipeline optimized = pipeline.load(std::memory_order_relaxed); optimized != VK_NULL_HANDLE)
+    vkDestroyPipeline(VulkanDevice::GetInstance().GetVulkanDevice(), optimized, nullptr);
+}
+
+void VulkanPipeline::ReplaceWithOptimizedPipeline()
+{
+  if (!m_optimized_pipeline->done.load(std::memory_order_acquire))
+    return;
+
+  // the fast-linked pipeline could still be in use by the GPU
+  const VkPipeline optimized = m_optimized_pipeline->pipeline.exchange(VK_NULL_HANDLE, std::memory_order_relaxed);
+  if (optimized != VK_NULL_HANDLE)
+  {
+    VulkanDevice::GetInstance().DeferPipelineDestruction(m_pipeline);
+    m_pipeline = optimized;
+  }
+
+  m_optimized_pipeline.reset();
+}
+
 #ifdef ENABLE_GPU_OBJECT_NAMES
 
 void VulkanPipeline::SetDebugName(std::string_view name)
@@ -241,8 +269,9 @@ std::unique_ptr<GPUPipeline> VulkanDevice::CreatePipeline(const GPUPipeline::Gra
   gpb.AddDynamicState(VK_DYNAMIC_STATE_VIEWPORT);
   gpb.AddDynamicState(VK_DYNAMIC_STATE_SCISSOR);
 
-  gpb.SetPipelineLayout(m_pipeline_layouts[static_cast<size_t>(GetPipelineLayoutType(config.render_pass_flags))]
-                                          [static_cast<size_t>(config.layout)]);
+  const VkPipelineLayout layout = m_pipeline_layouts[static_cast<size_t>(GetPipelineLayoutType(
+    config.render_pass_flags))][static_cast<size_t>(config.layout)];
+  gpb.SetPipelineLayout(layout);
 
   if ((config.render_pass_flags & GPUPipeline::ColorFeedbackLoopActive) &&
       m_optional_extensions.vk_ext_rasterization_order_attachment_access)
@@ -251,6 +280,7 @@ std::unique_ptr<GPUPipeline> VulkanDevice::CreatePipeline(const GPUPipeline::Gra
     gpb.AddBlendFlags(VK_PIPELINE_COLOR_BLEND_STATE_CREATE_RASTERIZATION_ORDER_ATTACHMENT_ACCESS_BIT_EXT);
   }
 
+  VkRenderPass render_pass = VK_NULL_HANDLE;
   if (m_optional_extensions.vk_khr_dynamic_rendering && (m_optional_extensions.vk_khr_dynamic_rendering_local_read ||
                                                          !(config.render_pass_flags & GPUPipeline::ColorFeedbackLoop)))
   {
@@ -280,11 +310,16 @@ std::unique_ptr<GPUPipeline> VulkanDevice::CreatePipeline(const GPUPipeline::Gra
   }
   else
   {
-    const VkRenderPass render_pass = GetRenderPass(config);
+    // pipelines can be created on multiple threads at once
+    const std::unique_lock lock(m_render_pass_cache_mutex);
+    render_pass = GetRenderPass(config);
     DebugAssert(render_pass != VK_NULL_HANDLE);
     gpb.SetRenderPass(render_pass, 0);
   }
 
+  if (m_optional_extensions.vk_ext_graphics_pipeline_library)
+    return CreateLinkedPipeline(config, gpb, layout, render_pass, static_cast<u8>(vertices_per_primitive), error);
+
   const VkPipeline pipeline = gpb.Create(m_device, m_pipeline_cache, false, error);
   if (!pipeline)
     return {};
@@ -293,6 +328,138 @@ std::unique_ptr<GPUPipeline> VulkanDevice::CreatePipeline(const GPUPipeline::Gra
     new VulkanPipeline(pipeline, config.layout, static_cast<u8>(vertices_per_primitive), config.render_pass_flags));
 }
 
+std::unique_ptr<GPUPipeline> VulkanDevice::CreateLinkedPipeline(const GPUPipeline::GraphicsConfig& config,
+                                                                Vulkan::GraphicsPipelineBuilder& gpb,
+                                                                VkPipelineLayout layout, VkRenderPass render_pass,
+                                                                u8 vertices_per_primitive, Error* error)
+{
+  // Anything which affects more than one part has to be included in each of their keys.
+  struct TargetState
+  {
+    VkRenderPass render_pass;
+    GPUTextureFormat color_formats[MAX_RENDER_TARGETS];
+    GPUTextureFormat depth_format;
+    GPUPipeline::RenderPassFlag render_pass_flags;
+  };
+  TargetState target;
+  std::memset(&target, 0, sizeof(target));
+  target.render_pass = render_pass;
+  std::memcpy(target.color_formats, config.color_formats, sizeof(target.color_formats));
+  target.depth_format = config.depth_format;
+  target.render_pass_flags = config.render_pass_flags;
+
+  const auto make_key = [](VkGraphicsPipelineLibraryFlagsEXT part, const FastHash::Hasher128& hasher) {
+    const FastHash::Hash128 hash = hasher.Final();
+    return PipelineLibraryKey{part, 0, hash.low, hash.high};
+  };
+
+  std::array<PipelineLibraryKey, 4> keys;
+  {
+    FastHash::Hasher128 hasher;
+    for (const GPUPipeline::VertexAttribute& va : config.input_layout.vertex_attributes)
+      hasher.Update(&va.key, sizeof(va.key));
+    hasher.Update(&config.input_layout.vertex_stride, sizeof(config.input_layout.vertex_stride));
+    hasher.Update(&config.primitive, sizeof(config.primitive));
+    keys[0] = make_key(VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT, hasher);
+  }
+  {
+    const u64 vs_hash = static_cast<const VulkanShader*>(config.vertex_shader)->GetCodeHash();
+    const u64 gs_hash =
+      config.geometry_shader ? static_cast<const VulkanShader*>(config.geometry_shader)->GetCodeHash() : 0;
+    FastHash::Hasher128 hasher;
+    hasher.Update(&vs_hash, sizeof(vs_hash));
+    hasher.Update(&gs_hash, sizeof(gs_hash));
+    hasher.Update(&layout, sizeof(layout));
+    hasher.Update(&config.rasterization.key, sizeof(config.rasterization.key));
+    hasher.Update(&target, sizeof(target));
+    keys[1] = make_key(VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT, hasher);
+  }
+  {
+    const u64 fs_hash = static_cast<const VulkanShader*>(config.fragment_shader)->GetCodeHash();
+    FastHash::Hasher128 hasher;
+    hasher.Update(&fs_hash, sizeof(fs_hash));
+    hasher.Update(&layout, sizeof(layout));
+    hasher.Update(&config.depth.key, sizeof(config.depth.key));
+    hasher.Update(&config.rasterization.key, sizeof(config.rasterization.key));
+    hasher.Update(&target, sizeof(target));
+    keys[2] = make_key(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT, hasher);
+  }
+  {
+    FastHash::Hasher128 hasher;
+    hasher.Update(&config.blend.key, sizeof(config.blend.key));
+    hasher.Update(&config.rasterization.key, sizeof(config.rasterization.key));
+    hasher.Update(&target, sizeof(target));
+    keys[3] = make_key(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT, hasher);
+  }
+
+  std::array<VkPipeline, 4> libraries;
+  for (size_t i = 0; i < keys.size(); i++)
+  {
+    if ((libraries[i] = GetPipelineLibrary(gpb, keys[i], error)) == VK_NULL_HANDLE)
+      return {};
+  }
+
+  const VkPipeline pipeline =
+    Vulkan::GraphicsPipelineBuilder::LinkLibraries(m_device, m_pipeline_cache, layout, libraries, false, error);
+  if (!pipeline)
+    return {};
+
+  // Libraries live until the device is destroyed, so the link can safely outlive the pipeline.
+  std::unique_ptr<VulkanPipeline> ret(
+    new VulkanPipeline(pipeline, config.layout, vertices_per_primitive, config.render_pass_flags));
+  ret->m_optimized_pipeline = std::make_shared<VulkanPipeline::OptimizedPipeline>();
+  QueueBackgroundPipelineTask(
+    [this, optimized = ret->m_optimized_pipeline, layout, libraries]() {
+      // don't bother if the pipeline has already been thrown away
+      if (optimized.use_count() > 1)
+      {
+        Error link_error;
+        const VkPipeline optimized_pipeline = Vulkan::GraphicsPipelineBuilder::LinkLibraries(
+          m_device, m_pipeline_cache, layout, libraries, true, &link_error);
+        if (optimized_pipeline == VK_NULL_HANDLE)
+          WARNING_LOG("Failed to link optimized pipeline: {}", link_error.GetDescription());
+        optimized->pipeline.store(optimized_pipeline, std::memory_order_relaxed);
+      }
+
+      optimized->done.store(true, std::memory_order_release);
+    });
+
+  return ret;
+}
+
+VkPipeline VulkanDevice::GetPipelineLibrary(Vulkan::GraphicsPipelineBuilder& gpb, const PipelineLibraryKey& key,
+                                            Error* error)
+{
+  {
+    const std::unique_lock lock(m_pipeline_libraries_mutex);
+    const auto it = m_pipeline_libraries.find(key);
+    if (it != m_pipeline_libraries.end())
+      return it->second;
+  }
+
+  // created outside the lock, so other threads aren't held up
+  const VkPipeline library = gpb.CreateLibrary(m_device, m_pipeline_cache, key.part, error);
+  if (library == VK_NULL_HANDLE)
+    return VK_NULL_HANDLE;
+
+  const std::unique_lock lock(m_pipeline_libraries_mutex);
+  const auto [it, inserted] = m_pipeline_libraries.emplace(key, library);
+  if (!inserted)
+  {
+    // another thread beat us to it
+    vkDestroyPipeline(m_device, library, nullptr);
+  }
+
+  return it->second;
+}
+
+void VulkanDevice::DestroyPipelineLibraries()
+{
+  for (const auto& [key, library] : m_pipeline_libraries)
+    vkDestroyPipeline(m_device, library, nullptr);
+  m_pipeline_libraries.clear();
+}
+
 std::unique_ptr<GPUPipeline> VulkanDevice::CreatePipeline(const GPUPipeline::ComputeConfig& config, Error* error)
 {
   Vulkan::ComputePipelineBuilder cpb;
@@ -4,6 +4,9 @@
 #include "gpu_device.h"
 #include "vulkan_headers.h"
 
+#include <atomic>
+#include <memory>
+
 class VulkanDevice;
 
 class VulkanShader final : public GPUShader
@@ -14,15 +17,19 @@ public:
   ~VulkanShader() override;
 
   ALWAYS_INLINE VkShaderModule GetModule() const { return m_module; }
+  ALWAYS_INLINE u64 GetCodeHash() const { return m_code_hash; }
 
 #ifdef ENABLE_GPU_OBJECT_NAMES
   void SetDebugName(std::string_view name) override;
 #endif
 
 private:
-  VulkanShader(GPUShaderStage stage, VkShaderModule mod);
+  VulkanShader(GPUShaderStage stage, VkShaderModule mod, u64 code_hash);
 
   VkShaderModule m_module;
+
+  // Identifies the code for pipeline library lookups, module handles can be reused once they're destroyed.
+  u64 m_code_hash;
 };
 
 class VulkanPipeline final : public GPUPipeline
@@ -37,14 +44,33 @@ public:
   ALWAYS_INLINE u8 GetVerticesPerPrimitive() const { return m_vertices_per_primitive; }
   ALWAYS_INLINE RenderPassFlag GetRenderPassFlags() const { return m_render_pass_flags; }
 
+  /// Switches to the optimized pipeline if it has finished compiling. Only call when the pipeline is being bound.
+  ALWAYS_INLINE void CheckForOptimizedPipeline()
+  {
+    if (m_optimized_pipeline) [[unlikely]]
+      ReplaceWithOptimizedPipeline();
+  }
+
 #ifdef ENABLE_GPU_OBJECT_NAMES
   void SetDebugName(std::string_view name) override;
 #endif
 
 private:
+  /// Result of linking a fast-linked pipeline's libraries again with optimization, filled in by a worker thread.
+  struct OptimizedPipeline
+  {
+    ~OptimizedPipeline();
+
+    std::atomic<VkPipeline> pipeline{VK_NULL_HANDLE};
+    std::atomic_bool done{false};
+  };
+
   VulkanPipeline(VkPipeline pipeline, Layout layout, u8 vertices_per_primitive, RenderPassFlag render_pass_flags);
 
+  void ReplaceWithOptimizedPipeline();
+
   VkPipeline m_pipeline;
+  std::shared_ptr<OptimizedPipeline> m_optimized_pipeline;
   Layout m_layout;
   u8 m_vertices_per_primitive;
   RenderPassFlag m_render_pass_flags;
@@ -311,6 +311,18 @@ bool VulkanTexture::Update(u32 x, u32 y, u32 width, u32 height, const void* data
     buffer = AllocateUploadStagingBuffer(data, pitch, upload_pitch, width, height, required_size);
     if (buffer == VK_NULL_HANDLE)
       return false;
+
+    // New textures like replacements don't have anything to wait for, so they can be written without holding up
+    // the graphics queue. Partial uploads and mipmapped textures stay on the graphics queue, ownership is tracked
+    // for the whole image.
+    if (dev.HasTransferQueue() && m_type == Type::Texture && m_layout == Layout::Undefined && m_layers == 1 &&
+        m_levels == 1 && x == 0 && y == 0 && width == m_width && height == m_height)
+    {
+      GPUDevice::GetStatistics().buffer_streamed += required_size;
+      GPUDevice::GetStatistics().num_uploads++;
+      UpdateOnTransferQueue(upload_pitch, buffer);
+      return true;
+    }
   }
   else
   {
@@ -353,6 +365,34 @@ bool VulkanTexture::Update(u32 x, u32 y, u32 width, u32 height, const void* data
   return true;
 }
 
+void VulkanTexture::UpdateOnTransferQueue(u32 pitch, VkBuffer buffer)
+{
+  VulkanDevice& dev = VulkanDevice::GetInstance();
+  const VkCommandBuffer transfer_cmdbuf = dev.GetCurrentTransferCommandBuffer();
+  TransitionToLayout(transfer_cmdbuf, Layout::TransferDst);
+  UpdateFromBuffer(transfer_cmdbuf, 0, 0, m_width, m_height, 0, 0, pitch, buffer, 0);
+
+  // The release and acquire barriers have to match, other than the access masks.
+  VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                                  nullptr,
+                                  VK_ACCESS_TRANSFER_WRITE_BIT,
+                                  0,
+                                  VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                  VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                  dev.GetTransferQueueFamilyIndex(),
+                                  dev.GetGraphicsQueueFamilyIndex(),
+                                  m_image,
+                                  {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 1u, 0u, 1u}};
+  vkCmdPipelineBarrier(transfer_cmdbuf, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0,
+                       nullptr, 0, nullptr, 1, &barrier);
+
+  barrier.srcAccessMask = 0;
+  barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  vkCmdPipelineBarrier(dev.GetCurrentInitCommandBuffer(), VulkanDevice::TRANSFER_QUEUE_WAIT_STAGES,
+                       VulkanDevice::TRANSFER_QUEUE_WAIT_STAGES, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+  m_layout = Layout::ShaderReadOnly;
+}
+
 bool VulkanTexture::Map(void** map, u32* map_stride, u32 x, u32 y, u32 width, u32 height, u32 layer, u32 level)
 {
   // TODO: linear textures for dynamic?
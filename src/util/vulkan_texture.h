@@ -92,6 +92,9 @@ private:
   void UpdateFromBuffer(VkCommandBuffer cmdbuf, u32 x, u32 y, u32 width, u32 height, u32 layer, u32 level, u32 pitch,
                         VkBuffer buffer, u32 buffer_offset);
 
+  /// Writes the whole of a new single-level texture on the transfer queue, then hands it over to the graphics queue.
+  void UpdateOnTransferQueue(u32 pitch, VkBuffer buffer);
+
   VkImage m_image = VK_NULL_HANDLE;
   VmaAllocation m_allocation = VK_NULL_HANDLE;
   VkImageView m_view = VK_NULL_HANDLE;
@@ -0,0 +1,559 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "xa_adpcm.h"
+
+#include "common/bitutils.h"
+#include "common/gsvector.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace XAADPCM {
+
+static constexpr u32 ZIGZAG_TABLE_SIZE = 29;
+static constexpr u32 HALF_RATE_TABLE_SIZE = 25;
+static constexpr u32 NUM_RESAMPLE_TABLES = 7;
+
+// Padded table size for the vector paths, the extra taps are zero.
+static constexpr u32 PADDED_TABLE_SIZE = 32;
+
+static constexpr std::array<std::array<s16, ZIGZAG_TABLE_SIZE>, NUM_RESAMPLE_TABLES> s_zigzag_tables = {
+  {{0,      0x0,     0x0,     0x0,    0x0,     -0x0002, 0x000A,  -0x0022, 0x0041, -0x0054,
+    0x0034, 0x0009,  -0x010A, 0x0400, -0x0A78, 0x234C,  0x6794,  -0x1780, 0x0BCD, -0x0623,
+    0x0350, -0x016D, 0x006B,  0x000A, -0x0010, 0x0011,  -0x0008, 0x0003,  -0x0001},
+   {0,       0x0,    0x0,     -0x0002, 0x0,    0x0003,  -0x0013, 0x003C,  -0x004B, 0x00A2,
+    -0x00E3, 0x0132, -0x0043, -0x0267, 0x0C9D, 0x74BB,  -0x11B4, 0x09B8,  -0x05BF, 0x0372,
+    -0x01A8, 0x00A6, -0x001B, 0x0005,  0x0006, -0x0008, 0x0003,  -0x0001, 0x0},
+   {0,      0x0,     -0x0001, 0x0003,  -0x0002, -0x0005, 0x001F,  -0x004A, 0x00B3, -0x0192,
+    0x02B1, -0x039E, 0x04F8,  -0x05A6, 0x7939,  -0x05A6, 0x04F8,  -0x039E, 0x02B1, -0x0192,
+    0x00B3, -0x004A, 0x001F,  -0x0005, -0x0002, 0x0003,  -0x0001, 0x0,     0x0},
+   {0,       -0x0001, 0x0003,  -0x0008, 0x0006, 0x0005,  -0x001B, 0x00A6, -0x01A8, 0x0372,
+    -0x05BF, 0x09B8,  -0x11B4, 0x74BB,  0x0C9D, -0x0267, -0x0043, 0x0132, -0x00E3, 0x00A2,
+    -0x004B, 0x003C,  -0x0013, 0x0003,  0x0,    -0x0002, 0x0,     0x0,    0x0},
+   {-0x0001, 0x0003,  -0x0008, 0x0011,  -0x0010, 0x000A, 0x006B,  -0x016D, 0x0350, -0x0623,
+    0x0BCD,  -0x1780, 0x6794,  0x234C,  -0x0A78, 0x0400, -0x010A, 0x0009,  0x0034, -0x0054,
+    0x0041,  -0x0022, 0x000A,  -0x0001, 0x0,     0x0001, 0x0,     0x0,     0x0},
+   {0x0002,  -0x0008, 0x0010,  -0x0023, 0x002B, 0x001A,  -0x00EB, 0x027B,  -0x0548, 0x0AFA,
+    -0x16FA, 0x53E0,  0x3C07,  -0x1249, 0x080E, -0x0347, 0x015B,  -0x0044, -0x0017, 0x0046,
+    -0x0023, 0x0011,  -0x0005, 0x0,     0x0,    0x0,     0x0,     0x0,     0x0},
+   {-0x0005, 0x0011,  -0x0023, 0x0046, -0x0017, -0x0044, 0x015B,  -0x0347, 0x080E, -0x1249,
+    0x3C07,  0x53E0,  -0x16FA, 0x0AFA, -0x0548, 0x027B,  -0x00EB, 0x001A,  0x002B, -0x0023,
+    0x0010,  -0x0008, 0x0002,  0x0,    0x0,     0x0,     0x0,     0x0,     0x0}}};
+
+// Weights originally from Mednafen's interpolator. It's unclear where these came from, perhaps it was calculated
+// somehow. This doesn't appear to use a zigzag pattern like psx-spx suggests, therefore it is restricted to only
+// 18900hz resampling. Duplicating the 18900hz samples to 37800hz sounds even more awful than lower sample rate audio
+// should, with a big spike at ~16KHz, especially with music in FMVs. Fortunately, few games actually use 18900hz XA.
+static constexpr std::array<std::array<s16, HALF_RATE_TABLE_SIZE>, NUM_RESAMPLE_TABLES> s_half_rate_tables = {{
+  {{0x0,     -0x5,  0x11,   -0x23, 0x46,  -0x17, -0x44, 0x15b, -0x347, 0x80e, -0x1249, 0x3c07, 0x53e0,
+    -0x16fa, 0xafa, -0x548, 0x27b, -0xeb, 0x1a,  0x2b,  -0x23, 0x10,   -0x8,  0x2,     0x0}},
+  {{0x0,     -0x2,  0xa,    -0x22, 0x41,   -0x54, 0x34, 0x9,   -0x10a, 0x400, -0xa78, 0x234c, 0x6794,
+    -0x1780, 0xbcd, -0x623, 0x350, -0x16d, 0x6b,  0xa,  -0x10, 0x11,   -0x8,  0x3,    -0x1}},
+  {{-0x2,    0x0,   0x3,    -0x13, 0x3c,   -0x4b, 0xa2,  -0xe3, 0x132, -0x43, -0x267, 0xc9d, 0x74bb,
+    -0x11b4, 0x9b8, -0x5bf, 0x372, -0x1a8, 0xa6,  -0x1b, 0x5,   0x6,   -0x8,  0x3,    -0x1}},
+  {{-0x1,   0x3,   -0x2,   -0x5,  0x1f,   -0x4a, 0xb3,  -0x192, 0x2b1, -0x39e, 0x4f8, -0x5a6, 0x7939,
+    -0x5a6, 0x4f8, -0x39e, 0x2b1, -0x192, 0xb3,  -0x4a, 0x1f,   -0x5,  -0x2,   0x3,   -0x1}},
+  {{-0x1,  0x3,    -0x8,  0x6,   0x5,   -0x1b, 0xa6,  -0x1a8, 0x372, -0x5bf, 0x9b8, -0x11b4, 0x74bb,
+    0xc9d, -0x267, -0x43, 0x132, -0xe3, 0xa2,  -0x4b, 0x3c,   -0x13, 0x3,    0x0,   -0x2}},
+  {{-0x1,   0x3,    -0x8,  0x11,   -0x10, 0xa,  0x6b,  -0x16d, 0x350, -0x623, 0xbcd, -0x1780, 0x6794,
+    0x234c, -0xa78, 0x400, -0x10a, 0x9,   0x34, -0x54, 0x41,   -0x22, 0xa,    -0x2,  0x0}},
+  {{0x0,    0x2,     -0x8,  0x10,   -0x23, 0x2b,  0x1a,  -0xeb, 0x27b, -0x548, 0xafa, -0x16fa, 0x53e0,
+    0x3c07, -0x1249, 0x80e, -0x347, 0x15b, -0x44, -0x17, 0x46,  -0x23, 0x11,   -0x5,  0x0}},
+}};
+
+template<bool IS_STEREO, bool IS_8BIT>
+static void DecodeSectorImpl(const UnpackedSector& in, DecoderState& state, s16* samples);
+
+template<bool STEREO>
+static u32 ResampleScalar(const s16* frames_in, u32 num_frames_in, ResamplerState& state, u32* frames_out);
+template<bool STEREO>
+static u32 ResampleHalfRateScalar(const s16* frames_in, u32 num_frames_in, ResamplerState& state, u32* frames_out);
+
+#ifdef CPU_ARCH_SIMD
+template<bool STEREO>
+static u32 ResampleVector(const s16* frames_in, u32 num_frames_in, ResamplerState& state, u32* frames_out);
+template<bool STEREO>
+static u32 ResampleHalfRateVector(const s16* frames_in, u32 num_frames_in, ResamplerState& state, u32* frames_out);
+#endif
+
+} // namespace XAADPCM
+
+void XAADPCM::ResamplerState::Reset()
+{
+  for (std::array<s16, RESAMPLE_RING_BUFFER_SIZE>& rb : ring_buffer)
+    rb.fill(0);
+  p = 0;
+  sixstep = 6;
+}
+
+ALWAYS_INLINE static u32 PackFrame(s16 left, s16 right)
+{
+  return ZeroExtend32(static_cast<u16>(left)) | (ZeroExtend32(static_cast<u16>(right)) << 16);
+}
+
+ALWAYS_INLINE static u8 GetBlockShift(u8 header)
+{
+  // For both 4bit and 8bit ADPCM, reserved shift values 13..15 will act same as shift=9).
+  const u8 shift_value = header & 0x0F;
+  return (shift_value > 12) ? 9 : shift_value;
+}
+
+void XAADPCM::UnpackSectorScalar(const u8* data, bool is_8bit, UnpackedSector* out)
+{
+  const u32 num_blocks = is_8bit ? 4 : 8;
+
+  const u8* chunk_ptr = data;
+  s16* out_samples = out->samples.data();
+  u8* out_filters = out->filters.data();
+  for (u32 chunk = 0; chunk < NUM_CHUNKS; chunk++)
+  {
+    const u8* headers_ptr = chunk_ptr + 4;
+    const u8* words_ptr = chunk_ptr + 16;
+
+    for (u32 block = 0; block < num_blocks; block++)
+    {
+      const u8 header = headers_ptr[block];
+      const u8 shift = GetBlockShift(header);
+      *(out_filters++) = header >> 4;
+
+      for (u32 word = 0; word < WORDS_PER_BLOCK; word++)
+      {
+        // NOTE: assumes LE
+        u32 word_data;
+        std::memcpy(&word_data, &words_ptr[word * sizeof(u32)], sizeof(word_data));
+
+        const u32 nibble = is_8bit ? ((word_data >> (block * 8)) & 0xFF) : ((word_data >> (block * 4)) & 0x0F);
+        *(out_samples++) = static_cast<s16>(Truncate16(nibble << (is_8bit ? 8 : 12))) >> shift;
+      }
+    }
+
+    chunk_ptr += CHUNK_SIZE_IN_BYTES;
+  }
+}
+
+#ifdef CPU_ARCH_SIMD
+
+void XAADPCM::UnpackSector(const u8* data, bool is_8bit, UnpackedSector* out)
+{
+  const u32 num_blocks = is_8bit ? 4 : 8;
+  const u32 sample_bits = is_8bit ? 8 : 4;
+  const GSVector4i top_mask = GSVector4i::cxpr(is_8bit ? static_cast<s32>(0xFF000000) : static_cast<s32>(0xF0000000));
+
+  const u8* chunk_ptr = data;
+  s16* out_samples = out->samples.data();
+  u8* out_filters = out->filters.data();
+  for (u32 chunk = 0; chunk < NUM_CHUNKS; chunk++)
+  {
+    const u8* headers_ptr = chunk_ptr + 4;
+    const u8* words_ptr = chunk_ptr + 16;
+
+    // 28 words, 7 vectors.
+    GSVector4i words[WORDS_PER_BLOCK / 4];
+    for (u32 i = 0; i < std::size(words); i++)
+      words[i] = GSVector4i::load<false>(words_ptr + i * sizeof(GSVector4i));
+
+    for (u32 block = 0; block < num_blocks; block++)
+    {
+      const u8 header = headers_ptr[block];
+      const s32 shift = GetBlockShift(header);
+      *(out_filters++) = header >> 4;
+
+      // Move the sample to the top of each word, discard the other samples, then shift it back down with sign
+      // extension. Shifting by the extra 16 bits produces the same value as the shift on the 16-bit sample.
+      const s32 left_shift = 32 - sample_bits * (block + 1);
+      const s32 right_shift = 16 + shift;
+      const auto extract = [&top_mask, left_shift, right_shift](const GSVector4i& v) {
+        return (v.sll32(left_shift) & top_mask).sra32(right_shift);
+      };
+      const GSVector4i s0 = extract(words[0]);
+      const GSVector4i s1 = extract(words[1]);
+      const GSVector4i s2 = extract(words[2]);
+      const GSVector4i s3 = extract(words[3]);
+      const GSVector4i s4 = extract(words[4]);
+      const GSVector4i s5 = extract(words[5]);
+      const GSVector4i s6 = extract(words[6]);
+
+      GSVector4i::store<false>(out_samples, s0.ps32(s1));
+      GSVector4i::store<false>(out_samples + 8, s2.ps32(s3));
+      GSVector4i::store<false>(out_samples + 16, s4.ps32(s5));
+      GSVector4i::storel<false>(out_samples + 24, s6.ps32());
+      out_samples += WORDS_PER_BLOCK;
+    }
+
+    chunk_ptr += CHUNK_SIZE_IN_BYTES;
+  }
+}
+
+#else
+
+void XAADPCM::UnpackSector(const u8* data, bool is_8bit, UnpackedSector* out)
+{
+  UnpackSectorScalar(data, is_8bit, out);
+}
+
+#endif
+
+template<bool IS_STEREO, bool IS_8BIT>
+void XAADPCM::DecodeSectorImpl(const UnpackedSector& in, DecoderState& state, s16* samples)
+{
+  static constexpr std::array<s8, 16> filter_table_pos = {{0, 60, 115, 98, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+  static constexpr std::array<s8, 16> filter_table_neg = {{0, 0, -52, -55, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+
+  // The data layout is annoying here. Each word of data is interleaved with the other blocks, requiring multiple
+  // passes to decode the whole chunk. Unpacking has already deinterleaved it, and applied the shifts.
+  constexpr u32 SAMPLES_PER_CHUNK = WORDS_PER_BLOCK * (IS_8BIT ? 4 : 8);
+  constexpr u32 NUM_BLOCKS = IS_8BIT ? 4 : 8;
+
+  const s16* in_samples_ptr = in.samples.data();
+  const u8* filters_ptr = in.filters.data();
+  for (u32 i = 0; i < NUM_CHUNKS; i++)
+  {
+    for (u32 block = 0; block < NUM_BLOCKS; block++)
+    {
+      const u8 filter = *(filters_ptr++);
+      const s32 filter_pos = filter_table_pos[filter];
+      const s32 filter_neg = filter_table_neg[filter];
+
+      s16* out_samples_ptr =
+        IS_STEREO ? &samples[(block / 2) * (WORDS_PER_BLOCK * 2) + (block % 2)] : &samples[block * WORDS_PER_BLOCK];
+      constexpr u32 out_samples_increment = IS_STEREO ? 2 : 1;
+
+      // mix in previous values
+      s32* prev = IS_STEREO ? &state[(block & 1) * 2] : &state[0];
+      for (u32 word = 0; word < WORDS_PER_BLOCK; word++)
+      {
+        const s16 sample = *(in_samples_ptr++);
+        const s32 interp_sample = std::clamp<s32>(
+          static_cast<s32>(sample) + ((prev[0] * filter_pos) >> 6) + ((prev[1] * filter_neg) >> 6), -32768, 32767);
+
+        // update previous values
+        prev[1] = prev[0];
+        prev[0] = interp_sample;
+
+        *out_samples_ptr = static_cast<s16>(interp_sample);
+        out_samples_ptr += out_samples_increment;
+      }
+    }
+
+    samples += SAMPLES_PER_CHUNK;
+  }
+}
+
+void XAADPCM::DecodeSector(const UnpackedSector& in, bool stereo, bool is_8bit, DecoderState& state, s16* samples)
+{
+  if (is_8bit)
+  {
+    if (stereo)
+      DecodeSectorImpl<true, true>(in, state, samples);
+    else
+      DecodeSectorImpl<false, true>(in, state, samples);
+  }
+  else
+  {
+    if (stereo)
+      DecodeSectorImpl<true, false>(in, state, samples);
+    else
+      DecodeSectorImpl<false, false>(in, state, samples);
+  }
+}
+
+template<bool STEREO>
+u32 XAADPCM::ResampleScalar(const s16* frames_in, u32 num_frames_in, ResamplerState& state, u32* frames_out)
+{
+  static constexpr auto zigzag_interpolate = [](const s16* ringbuf, u32 table_index, u32 p) -> s16 {
+    const s16* table = s_zigzag_tables[table_index].data();
+    s32 sum = 0;
+    for (u32 i = 0; i < ZIGZAG_TABLE_SIZE; i++)
+      sum += (static_cast<s32>(ringbuf[(p - i) & 0x1F]) * static_cast<s32>(table[i])) >> 15;
+
+    return static_cast<s16>(std::clamp<s32>(sum, -0x8000, 0x7FFF));
+  };
+
+  s16* const left_ringbuf = state.ring_buffer[0].data();
+  [[maybe_unused]] s16* const right_ringbuf = state.ring_buffer[1].data();
+  u32 p = state.p;
+  u32 sixstep = state.sixstep;
+  u32 num_frames_out = 0;
+
+  for (u32 in_sample_index = 0; in_sample_index < num_frames_in; in_sample_index++)
+  {
+    left_ringbuf[p] = *(frames_in++);
+    if constexpr (STEREO)
+      right_ringbuf[p] = *(frames_in++);
+    p = (p + 1) % 32;
+    sixstep--;
+
+    if (sixstep == 0)
+    {
+      sixstep = 6;
+      for (u32 j = 0; j < NUM_RESAMPLE_TABLES; j++)
+      {
+        const s16 left_interp = zigzag_interpolate(left_ringbuf, j, p);
+        const s16 right_interp = STEREO ? zigzag_interpolate(right_ringbuf, j, p) : left_interp;
+        frames_out[num_frames_out++] = PackFrame(left_interp, right_interp);
+      }
+    }
+  }
+
+  state.p = Truncate8(p);
+  state.sixstep = Truncate8(sixstep);
+  return num_frames_out;
+}
+
+template<bool STEREO>
+u32 XAADPCM::ResampleHalfRateScalar(const s16* frames_in, u32 num_frames_in, ResamplerState& state, u32* frames_out)
+{
+  static constexpr auto interpolate = [](const s16* ringbuf, u32 table_index, u32 p) -> s16 {
+    const s16* table = s_half_rate_tables[table_index].data();
+    s32 sum = 0;
+    for (u32 i = 0; i < HALF_RATE_TABLE_SIZE; i++)
+      sum += (static_cast<s32>(ringbuf[(p + 32 - 25 + i) & 0x1F]) * static_cast<s32>(table[i]));
+
+    return static_cast<s16>(std::clamp<s32>(sum >> 15, -0x8000, 0x7FFF));
+  };
+
+  s16* const left_ringbuf = state.ring_buffer[0].data();
+  [[maybe_unused]] s16* const right_ringbuf = state.ring_buffer[1].data();
+  u32 p = state.p;
+  u32 sixstep = state.sixstep;
+  u32 num_frames_out = 0;
+
+  for (u32 in_sample_index = 0; in_sample_index < num_frames_in;)
+  {
+    if (sixstep >= 7)
+    {
+      sixstep -= 7;
+      p = (p + 1) % 32;
+
+      left_ringbuf[p] = *(frames_in++);
+      if constexpr (STEREO)
+        right_ringbuf[p] = *(frames_in++);
+
+      in_sample_index++;
+    }
+
+    const s16 left_interp = interpolate(left_ringbuf, sixstep, p);
+    const s16 right_interp = STEREO ? interpolate(right_ringbuf, sixstep, p) : left_interp;
+    frames_out[num_frames_out++] = PackFrame(left_interp, right_interp);
+    sixstep += 3;
+  }
+
+  state.p = Truncate8(p);
+  state.sixstep = Truncate8(sixstep);
+  return num_frames_out;
+}
+
+u32 XAADPCM::ResampleSectorScalar(const s16* frames_in, u32 num_frames_in, bool stereo, bool half_sample_rate,
+                                  ResamplerState& state, u32* frames_out)
+{
+  if (stereo)
+  {
+    return half_sample_rate ? ResampleHalfRateScalar<true>(frames_in, num_frames_in, state, frames_out) :
+                              ResampleScalar<true>(frames_in, num_frames_in, state, frames_out);
+  }
+  else
+  {
+    return half_sample_rate ? ResampleHalfRateScalar<false>(frames_in, num_frames_in, state, frames_out) :
+                              ResampleScalar<false>(frames_in, num_frames_in, state, frames_out);
+  }
+}
+
+#ifdef CPU_ARCH_SIMD
+
+namespace XAADPCM {
+namespace {
+
+// The ring buffer is duplicated at +32, so any window of taps can be read contiguously without wrapping.
+struct LinearRingBuffer
+{
+  alignas(VECTOR_ALIGNMENT) std::array<s16, RESAMPLE_RING_BUFFER_SIZE * 2> data;
+
+  ALWAYS_INLINE void Load(const std::array<s16, RESAMPLE_RING_BUFFER_SIZE>& rb)
+  {
+    std::memcpy(&data[0], rb.data(), sizeof(rb));
+    std::memcpy(&data[RESAMPLE_RING_BUFFER_SIZE], rb.data(), sizeof(rb));
+  }
+
+  ALWAYS_INLINE void Store(std::array<s16, RESAMPLE_RING_BUFFER_SIZE>& rb) const
+  {
+    std::memcpy(rb.data(), &data[0], sizeof(rb));
+  }
+
+  ALWAYS_INLINE void Write(u32 p, s16 value)
+  {
+    data[p] = value;
+    data[p + RESAMPLE_RING_BUFFER_SIZE] = value;
+  }
+};
+
+// Zigzag taps are applied backwards from the write position, so the tables are reversed to match the window order.
+struct ZigzagVectorTables
+{
+  alignas(VECTOR_ALIGNMENT) std::array<std::array<s32, PADDED_TABLE_SIZE>, NUM_RESAMPLE_TABLES> tables;
+};
+
+struct HalfRateVectorTables
+{
+  alignas(VECTOR_ALIGNMENT) std::array<std::array<s16, PADDED_TABLE_SIZE>, NUM_RESAMPLE_TABLES> tables;
+};
+
+} // namespace
+
+static constexpr ZigzagVectorTables s_zigzag_vector_tables = []() {
+  ZigzagVectorTables ret = {};
+  for (u32 i = 0; i < NUM_RESAMPLE_TABLES; i++)
+  {
+    for (u32 j = 0; j < ZIGZAG_TABLE_SIZE; j++)
+      ret.tables[i][j] = s_zigzag_tables[i][(ZIGZAG_TABLE_SIZE - 1) - j];
+  }
+  return ret;
+}();
+
+static constexpr HalfRateVectorTables s_half_rate_vector_tables = []() {
+  HalfRateVectorTables ret = {};
+  for (u32 i = 0; i < NUM_RESAMPLE_TABLES; i++)
+  {
+    for (u32 j = 0; j < HALF_RATE_TABLE_SIZE; j++)
+      ret.tables[i][j] = s_half_rate_tables[i][j];
+  }
+  return ret;
+}();
+
+} // namespace XAADPCM
+
+template<bool STEREO>
+u32 XAADPCM::ResampleVector(const s16* frames_in, u32 num_frames_in, ResamplerState& state, u32* frames_out)
+{
+  // Each product is shifted individually before summing, so this has to be done in 32-bit lanes.
+  static constexpr auto zigzag_interpolate = [](const s16* window, const s32* table) -> s16 {
+    GSVector4i sum = GSVector4i::zero();
+    for (u32 i = 0; i < PADDED_TABLE_SIZE; i += 4)
+    {
+      const GSVector4i samples = GSVector4i::loadl<false>(&window[i]).s16to32();
+      sum = sum.add32(samples.mul32l(GSVector4i::load<true>(&table[i])).sra32<15>());
+    }
+
+    return static_cast<s16>(std::clamp<s32>(sum.addv_s32(), -0x8000, 0x7FFF));
+  };
+
+  LinearRingBuffer left_ringbuf, right_ringbuf;
+  left_ringbuf.Load(state.ring_buffer[0]);
+  if constexpr (STEREO)
+    right_ringbuf.Load(state.ring_buffer[1]);
+
+  u32 p = state.p;
+  u32 sixstep = state.sixstep;
+  u32 num_frames_out = 0;
+
+  for (u32 in_sample_index = 0; in_sample_index < num_frames_in; in_sample_index++)
+  {
+    left_ringbuf.Write(p, *(frames_in++));
+    if constexpr (STEREO)
+      right_ringbuf.Write(p, *(frames_in++));
+    p = (p + 1) % 32;
+    sixstep--;
+
+    if (sixstep == 0)
+    {
+      sixstep = 6;
+
+      // Taps cover p-28 through p, plus three zero taps.
+      const u32 window_start = (p - (ZIGZAG_TABLE_SIZE - 1)) % 32;
+      for (u32 j = 0; j < NUM_RESAMPLE_TABLES; j++)
+      {
+        const s32* table = s_zigzag_vector_tables.tables[j].data();
+        const s16 left_interp = zigzag_interpolate(&left_ringbuf.data[window_start], table);
+        const s16 right_interp = STEREO ? zigzag_interpolate(&right_ringbuf.data[window_start], table) : left_interp;
+        frames_out[num_frames_out++] = PackFrame(left_interp, right_interp);
+      }
+    }
+  }
+
+  left_ringbuf.Store(state.ring_buffer[0]);
+  if constexpr (STEREO)
+    right_ringbuf.Store(state.ring_buffer[1]);
+
+  state.p = Truncate8(p);
+  state.sixstep = Truncate8(sixstep);
+  return num_frames_out;
+}
+
+template<bool STEREO>
+u32 XAADPCM::ResampleHalfRateVector(const s16* frames_in, u32 num_frames_in, ResamplerState& state, u32* frames_out)
+{
+  // Products are summed before shifting, so pairs can be multiply-added. The tables never contain -32768, so this
+  // can't overflow differently to the scalar sum.
+  static constexpr auto interpolate = [](const s16* window, const s16* table) -> s16 {
+    GSVector4i sum = GSVector4i::zero();
+    for (u32 i = 0; i < PADDED_TABLE_SIZE; i += 8)
+      sum = sum.add32(GSVector4i::load<false>(&window[i]).madd_s16(GSVector4i::load<true>(&table[i])));
+
+    return static_cast<s16>(std::clamp<s32>(sum.addv_s32() >> 15, -0x8000, 0x7FFF));
+  };
+
+  LinearRingBuffer left_ringbuf, right_ringbuf;
+  left_ringbuf.Load(state.ring_buffer[0]);
+  if constexpr (STEREO)
+    right_ringbuf.Load(state.ring_buffer[1]);
+
+  u32 p = state.p;
+  u32 sixstep = state.sixstep;
+  u32 num_frames_out = 0;
+
+  for (u32 in_sample_index = 0; in_sample_index < num_frames_in;)
+  {
+    if (sixstep >= 7)
+    {
+      sixstep -= 7;
+      p = (p + 1) % 32;
+
+      left_ringbuf.Write(p, *(frames_in++));
+      if constexpr (STEREO)
+        right_ringbuf.Write(p, *(frames_in++));
+
+      in_sample_index++;
+    }
+
+    // Taps cover p-24 through p, plus seven zero taps.
+    const u32 window_start = (p + 32 - HALF_RATE_TABLE_SIZE) % 32;
+    const s16* table = s_half_rate_vector_tables.tables[sixstep].data();
+    const s16 left_interp = interpolate(&left_ringbuf.data[window_start], table);
+    const s16 right_interp = STEREO ? interpolate(&right_ringbuf.data[window_start], table) : left_interp;
+    frames_out[num_frames_out++] = PackFrame(left_interp, right_interp);
+    sixstep += 3;
+  }
+
+  left_ringbuf.Store(state.ring_buffer[0]);
+  if constexpr (STEREO)
+    right_ringbuf.Store(state.ring_buffer[1]);
+
+  state.p = Truncate8(p);
+  state.sixstep = Truncate8(sixstep);
+  return num_frames_out;
+}
+
+u32 XAADPCM::ResampleSector(const s16* frames_in, u32 num_frames_in, bool stereo, bool half_sample_rate,
+                            ResamplerState& state, u32* frames_out)
+{
+  if (stereo)
+  {
+    return half_sample_rate ? ResampleHalfRateVector<true>(frames_in, num_frames_in, state, frames_out) :
+                              ResampleVector<true>(frames_in, num_frames_in, state, frames_out);
+  }
+  else
+  {
+    return half_sample_rate ? ResampleHalfRateVector<false>(frames_in, num_frames_in, state, frames_out) :
+                              ResampleVector<false>(frames_in, num_frames_in, state, frames_out);
+  }
+}
+
+#else
+
+u32 XAADPCM::ResampleSector(const s16* frames_in, u32 num_frames_in, bool stereo, bool half_sample_rate,
+                            ResamplerState& state, u32* frames_out)
+{
+  return ResampleSectorScalar(frames_in, num_frames_in, stereo, half_sample_rate, state, frames_out);
+}
+
+#endif
@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#pragma once
+
+#include "common/types.h"
+
+#include <array>
+
+/// CD-XA ADPCM audio decoding and resampling to 44100hz.
+namespace XAADPCM {
+
+enum : u32
+{
+  NUM_CHUNKS = 18,
+  CHUNK_SIZE_IN_BYTES = 128,
+  WORDS_PER_BLOCK = 28,
+  MAX_BLOCKS_PER_CHUNK = 8,
+  SAMPLES_PER_SECTOR_4BIT = 4032, // 28 words * 8 nibbles per word * 18 chunks
+  SAMPLES_PER_SECTOR_8BIT = 2016, // 28 words * 4 bytes per word * 18 chunks
+  RESAMPLE_RING_BUFFER_SIZE = 32,
+
+  // 18900hz sectors produce the most output, 7 frames for every 3 input frames.
+  MAX_RESAMPLED_FRAMES_PER_SECTOR = (SAMPLES_PER_SECTOR_4BIT / 3) * 7 + 7,
+};
+
+/// Sector with the block shifts applied, but not yet filtered. This doesn't depend on any decoder state, so it can be
+/// done ahead of time. Samples and filters are stored in decode order, i.e. chunk, block, word.
+struct UnpackedSector
+{
+  std::array<s16, NUM_CHUNKS * MAX_BLOCKS_PER_CHUNK * WORDS_PER_BLOCK> samples;
+  std::array<u8, NUM_CHUNKS * MAX_BLOCKS_PER_CHUNK> filters;
+};
+
+/// ADPCM filter history, two samples per channel.
+using DecoderState = std::array<s32, 4>;
+
+struct ResamplerState
+{
+  std::array<std::array<s16, RESAMPLE_RING_BUFFER_SIZE>, 2> ring_buffer;
+  u8 p;
+  u8 sixstep;
+
+  void Reset();
+};
+
+/// Unpacks the ADPCM chunks of a sector. data points to the first chunk, after the subheader.
+void UnpackSector(const u8* data, bool is_8bit, UnpackedSector* out);
+void UnpackSectorScalar(const u8* data, bool is_8bit, UnpackedSector* out);
+
+/// Applies the ADPCM filters, producing interleaved samples. The filter is recursive, so this is always scalar.
+void DecodeSector(const UnpackedSector& in, bool stereo, bool is_8bit, DecoderState& state, s16* samples);
+
+/// Resamples decoded frames to 44100hz, writing packed frames with left in the low 16 bits. Returns the frame count.
+u32 ResampleSector(const s16* frames_in, u32 num_frames_in, bool stereo, bool half_sample_rate, ResamplerState& state,
+                   u32* frames_out);
+u32 ResampleSectorScalar(const s16* frames_in, u32 num_frames_in, bool stereo, bool half_sample_rate,
+                         ResamplerState& state, u32* frames_out);
+
+} // namespace XAADPCM